@@ -0,0 +1,21 @@
+# Find Snappy
+
+find_path(
+	SNAPPY_INCLUDE_DIR
+	NAMES snappy.h
+	PATH_SUFFIXES snappy
+    DOC "Snappy include directory"
+)
+
+find_library(
+	SNAPPY_LIBRARY
+	NAMES snappy
+    DOC "Snappy library"
+)
+
+set(SNAPPY_INCLUDE_DIRS ${SNAPPY_INCLUDE_DIR})
+set(SNAPPY_LIBRARIES ${SNAPPY_LIBRARY})
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(snappy DEFAULT_MSG
+	SNAPPY_LIBRARY SNAPPY_INCLUDE_DIR)
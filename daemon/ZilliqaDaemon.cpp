@@ -28,9 +28,11 @@ const string SYNCTYPE_OPT = "--synctype";
 const char* synctype_descr =
     "0(default) for no, 1 for new, 2 for normal, 3 for ds, 4 for lookup, 5 "
     "for node recovery, 6 for new lookup , 7 for ds guard node sync and 8 "
-    "for offline validation of DB";
+    "for offline validation of DB, 9 for light sync of block headers only";
 
 const string SUSPEND_LAUNCH = "SUSPEND_LAUNCH";
+const string WARM_RESTART = "WARM_RESTART";
+const unsigned int WARM_RESTART_MAX_AGE_IN_SECONDS = 300;
 const string upload_incr_DB_script = "upload_incr_DB.py";
 const string download_incr_DB_script = "download_incr_DB.py";
 const string auto_backup_script = "auto_backup.py";
@@ -45,7 +47,8 @@ enum SyncType : unsigned int {
   RECOVERY_ALL_SYNC,
   NEW_LOOKUP_SYNC,
   GUARD_DS_SYNC,
-  DB_VERIF  // Deprecated
+  DB_VERIF,  // Deprecated
+  LIGHT_SYNC
 };
 
 ZilliqaDaemon::ZilliqaDaemon(int argc, const char* argv[], std::ofstream& log)
@@ -56,7 +59,8 @@ ZilliqaDaemon::ZilliqaDaemon(int argc, const char* argv[], std::ofstream& log)
       m_recovery(0),
       m_nodeIndex(0),
       m_syncType(0),
-      m_cseed(false) {
+      m_cseed(false),
+      m_warmLaunch(false) {
   if (ReadInputs(argc, argv) != SUCCESS) {
     ZilliqaDaemon::LOG(m_log, "Failed to read inputs.");
     exit(EXIT_FAILURE);
@@ -215,7 +219,10 @@ vector<pid_t> ZilliqaDaemon::GetProcIdByName(const string& procName) {
                 space_pos = (string::npos == fullLine.find('\0'))
                                 ? fullLine.size()
                                 : fullLine.find('\0');
-                m_syncType = stoi(fullLine.substr(0, space_pos));
+                // A warm launch keeps the sync type for the next cold one
+                if (!m_warmLaunch) {
+                  m_syncType = stoi(fullLine.substr(0, space_pos));
+                }
                 fullLine = fullLine.substr(space_pos + 1);
                 continue;
               }
@@ -230,9 +237,27 @@ vector<pid_t> ZilliqaDaemon::GetProcIdByName(const string& procName) {
   return result;
 }
 
+bool ZilliqaDaemon::IsPersistenceWarm() {
+  struct stat marker {};
+  if (stat((m_curPath + WARM_RESTART).c_str(), &marker) != 0) {
+    return false;
+  }
+
+  const time_t age = time(nullptr) - marker.st_mtime;
+  ZilliqaDaemon::LOG(m_log, WARM_RESTART + " written " + to_string(age) +
+                                " seconds ago");
+  return age >= 0 && age <= WARM_RESTART_MAX_AGE_IN_SECONDS;
+}
+
 void ZilliqaDaemon::StartNewProcess() {
   KillProcess();
 
+  // Decided before the fork, as the sync type of the launched process is read
+  // back by this process
+  m_warmLaunch = !m_cseed && m_nodeType != "lookup" &&
+                 !ifstream(m_curPath + SUSPEND_LAUNCH).good() &&
+                 IsPersistenceWarm();
+
   ZilliqaDaemon::LOG(m_log, "Create new Zilliqa process...");
   signal(SIGCHLD, SIG_IGN);
 
@@ -271,6 +296,15 @@ void ZilliqaDaemon::StartNewProcess() {
       }
 
       strSyncType = to_string(NEW_LOOKUP_SYNC);
+    } else if (m_warmLaunch && !bSuspend) {
+      // The previous process had an epoch on disk moments ago, so the new one
+      // recovers from the persistence and only fetches the blocks it missed,
+      // instead of downloading and replaying it all again
+      strSyncType = to_string(NO_SYNC);
+      m_recovery = 1;
+      ZilliqaDaemon::LOG(m_log, "Warm restart from the persistence, set "
+                                "syncType = " +
+                                    strSyncType + ", recovery = 1");
     } else {
       /// For recover-all scenario, a SUSPEND_LAUNCH file wil be created prior
       /// to Zilliqa process being killed. Thus, we can use the variable
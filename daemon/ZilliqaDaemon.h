@@ -56,10 +56,12 @@ class ZilliqaDaemon {
   int m_port, m_recovery, m_nodeIndex;
   unsigned int m_syncType;
   bool m_cseed;
+  bool m_warmLaunch;
 
   static std::string CurrentTimeStamp();
   static std::string Execute(const std::string& cmd);
   bool DownloadPersistenceFromS3();
+  bool IsPersistenceWarm();
 
   std::vector<pid_t> GetProcIdByName(const std::string& procName);
   void StartNewProcess();
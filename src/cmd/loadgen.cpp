@@ -0,0 +1,477 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/program_options.hpp>
+#include "jsonrpccpp/client.h"
+#include "jsonrpccpp/client/connectors/httpclient.h"
+
+#include <Schnorr.h>
+#include "libData/AccountData/Account.h"
+#include "libData/AccountData/Address.h"
+#include "libData/AccountData/Transaction.h"
+#include "libServer/AddressChecksum.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/SWInfo.h"
+
+namespace po = boost::program_options;
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+#define ERROR_UNEXPECTED -3
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+struct Sender {
+  PairOfKey m_keyPair;
+  Address m_address;
+  uint64_t m_nextNonce;
+};
+
+struct Options {
+  string m_url;
+  double m_tps;
+  unsigned int m_rampSeconds;
+  unsigned int m_durationSeconds;
+  unsigned int m_drainSeconds;
+  unsigned int m_threads;
+  unsigned int m_contractPercent;
+  unsigned int m_gapPercent;
+  string m_contract;
+  string m_callData;
+  uint64_t m_contractGasLimit;
+  unsigned int m_pollMs;
+};
+
+/// Transactions sent and not yet seen in a Tx block, and the delays from send
+/// to confirmation of those that were
+class LatencyTracker {
+ public:
+  void Sent(const string& tranID) {
+    lock_guard<mutex> g(m_mutex);
+    m_pending.emplace(tranID, Clock::now());
+  }
+
+  void Confirmed(const string& tranID) {
+    lock_guard<mutex> g(m_mutex);
+    auto it = m_pending.find(tranID);
+    if (it == m_pending.end()) {
+      return;
+    }
+    m_latenciesMs.push_back(
+        chrono::duration_cast<chrono::milliseconds>(Clock::now() - it->second)
+            .count());
+    m_pending.erase(it);
+  }
+
+  vector<string> GetPending() {
+    lock_guard<mutex> g(m_mutex);
+    vector<string> pending;
+    pending.reserve(m_pending.size());
+    for (const auto& entry : m_pending) {
+      pending.push_back(entry.first);
+    }
+    return pending;
+  }
+
+  size_t GetPendingCount() {
+    lock_guard<mutex> g(m_mutex);
+    return m_pending.size();
+  }
+
+  /// Returns the number of confirmed ones, and their p50, p90 and p99 delays
+  size_t GetPercentiles(uint64_t& p50, uint64_t& p90, uint64_t& p99) {
+    vector<uint64_t> latencies;
+    {
+      lock_guard<mutex> g(m_mutex);
+      latencies = m_latenciesMs;
+    }
+    p50 = p90 = p99 = 0;
+    if (latencies.empty()) {
+      return 0;
+    }
+    sort(latencies.begin(), latencies.end());
+    auto at = [&latencies](unsigned int percent) {
+      return latencies[(latencies.size() - 1) * percent / 100];
+    };
+    p50 = at(50);
+    p90 = at(90);
+    p99 = at(99);
+    return latencies.size();
+  }
+
+ private:
+  mutex m_mutex;
+  unordered_map<string, Clock::time_point> m_pending;
+  vector<uint64_t> m_latenciesMs;
+};
+
+bool GetSenderKeys(const string& keysFile, vector<Sender>& senders) {
+  vector<string> privKeys;
+  if (keysFile.empty()) {
+    privKeys = GENESIS_KEYS;
+  } else {
+    ifstream file(keysFile);
+    if (!file) {
+      cerr << "Cannot open " << keysFile << endl;
+      return false;
+    }
+    string line;
+    while (getline(file, line)) {
+      if (!line.empty()) {
+        privKeys.push_back(line);
+      }
+    }
+  }
+
+  for (const auto& privKeyHexStr : privKeys) {
+    bytes out;
+    if (!DataConversion::HexStrToUint8Vec(privKeyHexStr, out)) {
+      cerr << "Invalid private key " << privKeyHexStr << endl;
+      return false;
+    }
+    PrivKey privKey{out, 0};
+    PubKey pubKey{privKey};
+    senders.push_back(
+        {{privKey, pubKey}, Account::GetAddressFromPublicKey(pubKey), 0});
+  }
+  return !senders.empty();
+}
+
+bool FetchNonce(jsonrpc::Client& client, Sender& sender) {
+  Json::Value params(Json::arrayValue);
+  params.append(sender.m_address.hex());
+  try {
+    const Json::Value balance = client.CallMethod("GetBalance", params);
+    sender.m_nextNonce = balance["nonce"].asUInt64() + 1;
+  } catch (jsonrpc::JsonRpcException& e) {
+    cerr << "GetBalance " << sender.m_address.hex() << " failed: " << e.what()
+         << endl;
+    return false;
+  }
+  return true;
+}
+
+Json::Value TransactionToJson(const Transaction& txn) {
+  Json::Value json;
+  string pubKey, signature;
+  DataConversion::SerializableToHexStr(txn.GetSenderPubKey(), pubKey);
+  DataConversion::SerializableToHexStr(txn.GetSignature(), signature);
+
+  json["version"] = txn.GetVersion();
+  json["nonce"] = static_cast<Json::UInt64>(txn.GetNonce());
+  json["toAddr"] = AddressChecksum::GetCheckSumedAddress(txn.GetToAddr().hex());
+  json["amount"] = txn.GetAmount().convert_to<string>();
+  json["pubKey"] = pubKey;
+  json["gasPrice"] = txn.GetGasPrice().convert_to<string>();
+  json["gasLimit"] = to_string(txn.GetGasLimit());
+  json["code"] = DataConversion::CharArrayToString(txn.GetCode());
+  json["data"] = DataConversion::CharArrayToString(txn.GetData());
+  json["signature"] = signature;
+  return json;
+}
+
+/// Sends txn, and returns whether the lookup accepted it
+bool Send(jsonrpc::Client& client, const Transaction& txn,
+          LatencyTracker& tracker) {
+  Json::Value params(Json::arrayValue);
+  params.append(TransactionToJson(txn));
+  try {
+    const Json::Value ret = client.CallMethod("CreateTransaction", params);
+    if (!ret.isMember("TranID")) {
+      return false;
+    }
+    tracker.Sent(ret["TranID"].asString());
+  } catch (jsonrpc::JsonRpcException& e) {
+    return false;
+  }
+  return true;
+}
+
+/// The number of transactions due from a thread sending at tps ramped up
+/// linearly over rampSeconds, after elapsedSeconds
+double DueCount(double tps, double rampSeconds, double elapsedSeconds) {
+  if (elapsedSeconds < rampSeconds) {
+    return tps * elapsedSeconds * elapsedSeconds / (2 * rampSeconds);
+  }
+  return tps * (elapsedSeconds - rampSeconds / 2);
+}
+
+void RunSender(const Options& options, unsigned int thread,
+               vector<Sender>& senders, Clock::time_point start,
+               LatencyTracker& tracker, atomic<uint64_t>& sent,
+               atomic<uint64_t>& rejected) {
+  // Each thread signs for its own accounts, so the nonces need no lock
+  vector<Sender*> mine;
+  for (unsigned int i = thread; i < senders.size(); i += options.m_threads) {
+    mine.push_back(&senders[i]);
+  }
+  if (mine.empty()) {
+    return;
+  }
+
+  jsonrpc::HttpClient httpClient(options.m_url);
+  jsonrpc::Client client(httpClient);
+
+  Address contract;
+  if (!options.m_contract.empty()) {
+    bytes contractBytes;
+    if (DataConversion::HexStrToUint8Vec(options.m_contract, contractBytes)) {
+      contract = Address(contractBytes);
+    }
+  }
+  const bytes callData = DataConversion::StringToCharArray(options.m_callData);
+  const uint32_t version = DataConversion::Pack(CHAIN_ID, TRANSACTION_VERSION);
+  const Address payee =
+      Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second);
+
+  mt19937 rng(random_device{}());
+  uniform_int_distribution<unsigned int> percent(0, 99);
+  const double threadTps = options.m_tps / options.m_threads;
+  const auto end = start + chrono::seconds(options.m_durationSeconds);
+  uint64_t threadSent = 0;
+  size_t next = 0;
+
+  while (Clock::now() < end) {
+    const double elapsed =
+        chrono::duration<double>(Clock::now() - start).count();
+    if (threadSent >= DueCount(threadTps, options.m_rampSeconds, elapsed)) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+      continue;
+    }
+
+    Sender& sender = *mine[next++ % mine.size()];
+    const unsigned int pick = percent(rng);
+    vector<Transaction> txns;
+    if (pick < options.m_contractPercent && contract != Address()) {
+      txns.emplace_back(version, sender.m_nextNonce++, contract,
+                        sender.m_keyPair, 0, GAS_PRICE_MIN_VALUE,
+                        options.m_contractGasLimit, bytes{}, callData);
+    } else if (pick < options.m_contractPercent + options.m_gapPercent) {
+      // The later nonce goes first, so that it waits on a gap until the
+      // earlier one arrives
+      txns.emplace_back(version, sender.m_nextNonce + 1, payee,
+                        sender.m_keyPair, 1, GAS_PRICE_MIN_VALUE, 1);
+      txns.emplace_back(version, sender.m_nextNonce, payee, sender.m_keyPair,
+                        1, GAS_PRICE_MIN_VALUE, 1);
+      sender.m_nextNonce += 2;
+    } else {
+      txns.emplace_back(version, sender.m_nextNonce++, payee,
+                        sender.m_keyPair, 1, GAS_PRICE_MIN_VALUE, 1);
+    }
+
+    for (const auto& txn : txns) {
+      if (!Send(client, txn, tracker)) {
+        rejected++;
+      }
+      sent++;
+      threadSent++;
+    }
+  }
+}
+
+/// Polls the lookup for the pending transactions until stop is set
+void RunConfirmer(const Options& options, LatencyTracker& tracker,
+                  const atomic<bool>& stop) {
+  jsonrpc::HttpClient httpClient(options.m_url);
+  jsonrpc::Client client(httpClient);
+
+  while (!stop) {
+    for (const auto& tranID : tracker.GetPending()) {
+      if (stop) {
+        break;
+      }
+      Json::Value params(Json::arrayValue);
+      params.append(tranID);
+      try {
+        // Only found once in a Tx block
+        client.CallMethod("GetTransaction", params);
+        tracker.Confirmed(tranID);
+      } catch (jsonrpc::JsonRpcException& e) {
+      }
+    }
+    this_thread::sleep_for(chrono::milliseconds(options.m_pollMs));
+  }
+}
+
+void Report(double elapsedSeconds, uint64_t sent, uint64_t rejected,
+            LatencyTracker& tracker) {
+  uint64_t p50 = 0, p90 = 0, p99 = 0;
+  const size_t confirmed = tracker.GetPercentiles(p50, p90, p99);
+  cout << "[" << static_cast<uint64_t>(elapsedSeconds) << "s] sent " << sent
+       << " rejected " << rejected << " confirmed " << confirmed
+       << " pending " << tracker.GetPendingCount() << " sent/s "
+       << (elapsedSeconds > 0 ? sent / elapsedSeconds : 0)
+       << " latency ms p50 " << p50 << " p90 " << p90 << " p99 " << p99
+       << endl;
+}
+
+void description() {
+  cout << endl << "Description:\n";
+  cout << "\tSend signed transactions to a lookup through its JSON-RPC at a "
+          "target rate, ramped up linearly, and report how many are "
+          "confirmed and how long they take to be\n";
+  cout << "\tThe senders are the genesis accounts (constants.xml) unless a "
+          "file of private keys is given\n";
+  cout << "\tThe workload mixes payments, contract calls and pairs of "
+          "transactions sent with their nonces swapped\n";
+}
+
+int main(int argc, char** argv) {
+  try {
+    Options options;
+    string keysFile;
+
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "url,u",
+        po::value<string>(&options.m_url)->default_value(
+            "http://127.0.0.1:4201"),
+        "JSON-RPC endpoint of the lookup")(
+        "tps,t", po::value<double>(&options.m_tps)->default_value(100),
+        "Target transactions per second")(
+        "ramp,r",
+        po::value<unsigned int>(&options.m_rampSeconds)->default_value(0),
+        "Seconds to ramp up linearly to the target")(
+        "duration,d",
+        po::value<unsigned int>(&options.m_durationSeconds)->default_value(60),
+        "Seconds to send for")(
+        "drain",
+        po::value<unsigned int>(&options.m_drainSeconds)->default_value(120),
+        "Seconds to wait for confirmations after the last send")(
+        "threads,j",
+        po::value<unsigned int>(&options.m_threads)
+            ->default_value(max(1u, thread::hardware_concurrency())),
+        "Threads signing and sending")(
+        "keys,k", po::value<string>(&keysFile),
+        "File of sender private keys, one per line (default to the genesis "
+        "keys)")(
+        "contract,c", po::value<string>(&options.m_contract),
+        "Address of the contract to call")(
+        "calldata",
+        po::value<string>(&options.m_callData)
+            ->default_value(R"({"_tag":"Ping","params":[]})"),
+        "Data of the contract calls")(
+        "contractgas",
+        po::value<uint64_t>(&options.m_contractGasLimit)->default_value(10000),
+        "Gas limit of the contract calls")(
+        "contractpct",
+        po::value<unsigned int>(&options.m_contractPercent)->default_value(0),
+        "Percent of contract calls")(
+        "gappct",
+        po::value<unsigned int>(&options.m_gapPercent)->default_value(0),
+        "Percent of transaction pairs sent with their nonces swapped")(
+        "poll",
+        po::value<unsigned int>(&options.m_pollMs)->default_value(1000),
+        "Milliseconds between confirmation polls");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+      po::notify(vm);
+
+      if (vm.count("help")) {
+        SWInfo::LogBrandBugReport();
+        description();
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      if (options.m_tps <= 0 || options.m_threads == 0 ||
+          options.m_contractPercent + options.m_gapPercent > 100) {
+        description();
+        return ERROR_IN_COMMAND_LINE;
+      }
+    } catch (boost::program_options::error& e) {
+      SWInfo::LogBrandBugReport();
+      cerr << "ERROR: " << e.what() << endl << endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    vector<Sender> senders;
+    if (!GetSenderKeys(keysFile, senders)) {
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    {
+      jsonrpc::HttpClient httpClient(options.m_url);
+      jsonrpc::Client client(httpClient);
+      for (auto& sender : senders) {
+        if (!FetchNonce(client, sender)) {
+          return ERROR_UNEXPECTED;
+        }
+      }
+    }
+
+    cout << "Senders: " << senders.size() << " threads: " << options.m_threads
+         << " target tps: " << options.m_tps << endl;
+
+    LatencyTracker tracker;
+    atomic<uint64_t> sent{0}, rejected{0};
+    atomic<bool> stopConfirmer{false};
+    const auto start = Clock::now();
+
+    thread confirmer(RunConfirmer, std::cref(options), std::ref(tracker),
+                     std::cref(stopConfirmer));
+    vector<thread> threads;
+    for (unsigned int i = 0; i < options.m_threads; i++) {
+      threads.emplace_back(RunSender, std::cref(options), i,
+                           std::ref(senders), start, std::ref(tracker),
+                           std::ref(sent), std::ref(rejected));
+    }
+
+    const auto drainEnd =
+        start + chrono::seconds(options.m_durationSeconds +
+                                options.m_drainSeconds);
+    while (Clock::now() < drainEnd) {
+      this_thread::sleep_for(chrono::seconds(5));
+      Report(chrono::duration<double>(Clock::now() - start).count(), sent,
+             rejected, tracker);
+      if (Clock::now() > start + chrono::seconds(options.m_durationSeconds) &&
+          tracker.GetPendingCount() == 0) {
+        break;
+      }
+    }
+
+    for (auto& t : threads) {
+      t.join();
+    }
+    stopConfirmer = true;
+    confirmer.join();
+
+    Report(chrono::duration<double>(Clock::now() - start).count(), sent,
+           rejected, tracker);
+  } catch (exception& e) {
+    cerr << "Unhandled Exception reached the top of main: " << e.what()
+         << ", application will now exit" << endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+  return SUCCESS;
+}
@@ -20,12 +20,17 @@
 
 #include <arpa/inet.h>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <thread>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/program_options.hpp>
 
 #include "depends/NAT/nat.h"
+#include "libNetwork/MessageCapture.h"
+#include "libNetwork/MessagePool.h"
 #include "libNetwork/P2PComm.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/HardwareSpecification.h"
@@ -43,6 +48,53 @@ using namespace boost::multiprecision;
 
 namespace po = boost::program_options;
 
+/// Feeds the messages of a capture file to the node, keeping their recorded
+/// spacing divided by speed (no waits if speed is 0), then waits for the node
+/// to process them. Nothing is sent to the network meanwhile.
+static int ReplayCapture(Zilliqa& zilliqa, const string& path, double speed) {
+  MessageCaptureReader reader;
+  if (!reader.Open(path)) {
+    return ERROR_IN_COMMAND_LINE;
+  }
+
+  atomic<uint64_t> dropped{0};
+  P2PComm::GetInstance().SetSendInterceptor(
+      [&dropped](const Peer&, const bytes&) { dropped++; });
+
+  LOG_GENERAL(INFO, "Replaying " << path << " at speed " << speed);
+  const auto start = chrono::steady_clock::now();
+  MessageCapture::Record record;
+  uint64_t count = 0;
+  while (reader.Next(record)) {
+    if (speed > 0) {
+      this_thread::sleep_until(
+          start + chrono::microseconds(static_cast<uint64_t>(
+                      static_cast<double>(record.m_offsetMicros) / speed)));
+    }
+    zilliqa.Dispatch(
+        MessagePool::GetInstance().Acquire(record.m_message, record.m_from));
+    count++;
+  }
+  const auto fed = chrono::steady_clock::now();
+
+  while (zilliqa.GetPendingMessageBytes() > 0) {
+    this_thread::sleep_for(chrono::milliseconds(10));
+  }
+  const auto done = chrono::steady_clock::now();
+
+  LOG_GENERAL(
+      INFO,
+      "Replayed " << count << " messages, fed in "
+                  << chrono::duration_cast<chrono::milliseconds>(fed - start)
+                         .count()
+                  << " ms, processed in "
+                  << chrono::duration_cast<chrono::milliseconds>(done - start)
+                         .count()
+                  << " ms, " << dropped << " outgoing messages dropped");
+  P2PComm::GetInstance().SetSendInterceptor(nullptr);
+  return SUCCESS;
+}
+
 int main(int argc, const char* argv[]) {
   try {
     Peer my_network_info;
@@ -56,10 +108,14 @@ int main(int argc, const char* argv[]) {
     unique_ptr<NAT> nt;
     uint128_t ip;
     unsigned int syncType = 0;
+    string capturePath;
+    string replayPath;
+    double replaySpeed = 1.0;
     const char* synctype_descr =
         "0(default) for no, 1 for new, 2 for normal, 3 for ds, 4 for lookup, 5 "
         "for node recovery, 6 for new lookup , 7 for ds guard node sync and 8 "
-        "for offline validation of DB";
+        "for offline validation of DB, 9 for light sync of block headers "
+        "only";
     po::options_description desc("Options");
 
     desc.add_options()("help,h", "Print help messages")(
@@ -76,7 +132,15 @@ int main(int argc, const char* argv[]) {
         "recovery,r", "Runs in recovery mode if set")(
         "logpath,g", po::value<string>(&logpath),
         "customized log path, could be relative path (e.g., \"./logs/\"), or "
-        "absolute path (e.g., \"/usr/local/test/logs/\")");
+        "absolute path (e.g., \"/usr/local/test/logs/\")")(
+        "capture", po::value<string>(&capturePath),
+        "Records the incoming messages to the given file")(
+        "replay", po::value<string>(&replayPath),
+        "Feeds the messages of the given capture file to the node instead of "
+        "listening, then exits")(
+        "replayspeed", po::value<double>(&replaySpeed),
+        "Speed of the replay relative to the capture (default 1), 0 for no "
+        "waits between messages");
 
     po::variables_map vm;
     try {
@@ -105,7 +169,7 @@ int main(int argc, const char* argv[]) {
         return ERROR_IN_COMMAND_LINE;
       }
 
-      if (syncType > 8) {
+      if (syncType >= SyncType::SYNC_TYPE_COUNT) {
         SWInfo::LogBrandBugReport();
         std::cerr << "Invalid synctype '" << syncType
                   << "', please select: " << synctype_descr << "." << endl;
@@ -122,6 +186,12 @@ int main(int argc, const char* argv[]) {
         }
       }
 
+      if (replaySpeed < 0) {
+        SWInfo::LogBrandBugReport();
+        std::cerr << "Invalid replay speed " << replaySpeed << endl;
+        return ERROR_IN_COMMAND_LINE;
+      }
+
       if ((port < 0) || (port > 65535)) {
         SWInfo::LogBrandBugReport();
         std::cerr << "Invalid or missing port number" << endl;
@@ -141,6 +211,7 @@ int main(int argc, const char* argv[]) {
     INIT_FILE_LOGGER("zilliqa", logpath.c_str());
     INIT_STATE_LOGGER("state", logpath.c_str());
     INIT_EPOCHINFO_LOGGER("epochinfo", logpath.c_str());
+    INIT_ASYNC_LOGGER(LOG_ASYNC_BUFFER_SIZE);
 
     LOG_GENERAL(INFO, ZILLIQA_BRAND);
 
@@ -190,7 +261,22 @@ int main(int argc, const char* argv[]) {
 
     Zilliqa zilliqa(make_pair(privkey, pubkey), my_network_info,
                     (SyncType)syncType, vm.count("recovery"));
-    auto dispatcher = [&zilliqa](pair<bytes, Peer>* message) mutable -> void {
+
+    if (!replayPath.empty()) {
+      return ReplayCapture(zilliqa, replayPath, replaySpeed);
+    }
+
+    MessageCaptureWriter capture;
+    if (!capturePath.empty() && !capture.Open(capturePath)) {
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    const bool capturing = !capturePath.empty();
+    auto dispatcher = [&zilliqa, &capture, capturing](
+                          pair<bytes, Peer>* message) mutable -> void {
+      if (capturing) {
+        capture.Record(message->first, message->second);
+      }
       zilliqa.Dispatch(message);
     };
 
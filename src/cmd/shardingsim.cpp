@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <Schnorr.h>
+#include "common/Constants.h"
+#include "libDirectoryService/ShardingOrder.h"
+#include "libUtils/SWInfo.h"
+#include "libUtils/ShardSizeCalculator.h"
+
+namespace po = boost::program_options;
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+#define ERROR_UNEXPECTED -3
+
+using namespace std;
+using Clock = chrono::steady_clock;
+using PoWSolutions = vector<pair<array<unsigned char, POW_SIZE>, PubKey>>;
+
+struct Options {
+  uint32_t m_nodesFrom;
+  uint32_t m_nodesTo;
+  uint32_t m_nodesStep;
+  uint32_t m_shardSize;
+  uint32_t m_toleranceLo;
+  uint32_t m_toleranceHi;
+  uint32_t m_maxShardNodes;
+  uint32_t m_maxSearchShards;
+  unsigned int m_threads;
+  unsigned int m_runs;
+  unsigned int m_seed;
+};
+
+struct Balance {
+  size_t m_shards{0};
+  uint32_t m_min{0};
+  uint32_t m_max{0};
+  double m_mean{0};
+  double m_stddev{0};
+  uint32_t m_unsharded{0};
+};
+
+double ElapsedMs(const Clock::time_point& start) {
+  return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+/// Fills the shards in the order of the nodes, as ComputeSharding does, and
+/// returns the sizes they end up with
+Balance AssignNodes(const vector<uint32_t>& shardCounts,
+                    const uint32_t numOrderedNodes,
+                    const uint32_t numNodesForSharding) {
+  Balance balance;
+  vector<uint32_t> sizes;
+  uint32_t left = min(numOrderedNodes, numNodesForSharding);
+  for (const auto& count : shardCounts) {
+    sizes.emplace_back(min(count, left));
+    left -= sizes.back();
+  }
+  if (sizes.empty()) {
+    balance.m_unsharded = numNodesForSharding;
+    return balance;
+  }
+
+  balance.m_shards = sizes.size();
+  balance.m_min = *min_element(sizes.begin(), sizes.end());
+  balance.m_max = *max_element(sizes.begin(), sizes.end());
+  uint64_t total = 0;
+  for (const auto& size : sizes) {
+    total += size;
+  }
+  balance.m_mean = static_cast<double>(total) / sizes.size();
+  double variance = 0;
+  for (const auto& size : sizes) {
+    variance += (size - balance.m_mean) * (size - balance.m_mean);
+  }
+  balance.m_stddev = sqrt(variance / sizes.size());
+  balance.m_unsharded = numNodesForSharding - total;
+  return balance;
+}
+
+void PrintHeader() {
+  cout << left << setw(8) << "Nodes" << setw(9) << "Sharded" << setw(7)
+       << "Size" << setw(10) << "Counts" << setw(12) << "CountsMs"
+       << setw(12) << "OrderMs" << setw(8) << "Shards" << setw(7) << "Min"
+       << setw(7) << "Max" << setw(9) << "Mean" << setw(9) << "Stddev"
+       << "Unsharded" << endl;
+}
+
+void PrintRow(const uint32_t numNodes, const uint32_t numNodesForSharding,
+              const uint32_t shardSize, const string& counts,
+              const double countsMs, const double orderMs,
+              const Balance& balance) {
+  cout << left << setw(8) << numNodes << setw(9) << numNodesForSharding
+       << setw(7) << shardSize << setw(10) << counts << fixed
+       << setprecision(3) << setw(12) << countsMs << setw(12) << orderMs
+       << setw(8) << balance.m_shards << setw(7) << balance.m_min << setw(7)
+       << balance.m_max << setprecision(1) << setw(9) << balance.m_mean
+       << setw(9) << balance.m_stddev << balance.m_unsharded << endl;
+}
+
+void Simulate(const Options& options, const uint32_t numNodes,
+              mt19937& generator) {
+  // Synthetic miners, of which only the PoW results decide the order
+  PoWSolutions powSolns(numNodes);
+  uniform_int_distribution<unsigned int> byte(0, 255);
+  for (auto& soln : powSolns) {
+    for (auto& b : soln.first) {
+      b = byte(generator);
+    }
+  }
+  bytes lastBlockHash(BLOCK_HASH_SIZE);
+  for (auto& b : lastBlockHash) {
+    b = byte(generator);
+  }
+
+  const uint32_t numNodesForSharding = min(numNodes, options.m_maxShardNodes);
+  const uint32_t shardSize =
+      options.m_shardSize > 0
+          ? options.m_shardSize
+          : ShardSizeCalculator::CalculateShardSize(numNodesForSharding);
+
+  double orderMs = 0;
+  uint32_t numOrderedNodes = 0;
+  for (unsigned int run = 0; run < options.m_runs; run++) {
+    const auto start = Clock::now();
+    numOrderedNodes =
+        OrderPoWsForSharding(lastBlockHash, powSolns, options.m_threads)
+            .size();
+    orderMs += ElapsedMs(start);
+  }
+  orderMs /= options.m_runs;
+
+  auto runCounts = [&](const string& name,
+                       decltype(&ShardSizeCalculator::GenerateShardCounts)
+                           generate) {
+    vector<uint32_t> shardCounts;
+    double countsMs = 0;
+    for (unsigned int run = 0; run < options.m_runs; run++) {
+      shardCounts.clear();
+      const auto start = Clock::now();
+      generate(shardSize, options.m_toleranceLo, options.m_toleranceHi,
+               numNodesForSharding, shardCounts);
+      countsMs += ElapsedMs(start);
+    }
+    PrintRow(numNodes, numNodesForSharding, shardSize, name,
+             countsMs / options.m_runs, orderMs,
+             AssignNodes(shardCounts, numOrderedNodes, numNodesForSharding));
+  };
+
+  // The search of GenerateShardCounts is exponential in the shards
+  const uint32_t shardThresholdLo =
+      shardSize > options.m_toleranceLo ? shardSize - options.m_toleranceLo
+                                        : 1;
+  if (numNodesForSharding / shardThresholdLo <= options.m_maxSearchShards) {
+    runCounts("search", &ShardSizeCalculator::GenerateShardCounts);
+  } else {
+    cout << left << setw(8) << numNodes << setw(9) << numNodesForSharding
+         << setw(7) << shardSize << setw(10) << "search"
+         << "skipped, more than " << options.m_maxSearchShards << " shards"
+         << endl;
+  }
+  runCounts("balanced", &ShardSizeCalculator::GenerateBalancedShardCounts);
+}
+
+void description() {
+  cout << endl << "Description:\n";
+  cout << "\tRuns the shard size and count calculation and the ordering of "
+          "ComputeSharding over synthetic miner populations\n";
+  cout << "\tReports the time they take and the sizes of the resulting "
+          "shards\n";
+  cout << "\tThe counts are generated both with the search used by the DS "
+          "committee and with the balanced calculation\n";
+}
+
+int main(int argc, char** argv) {
+  try {
+    Options options;
+
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "from,f",
+        po::value<uint32_t>(&options.m_nodesFrom)->default_value(10000),
+        "Smallest miner population")(
+        "to,t", po::value<uint32_t>(&options.m_nodesTo)->default_value(100000),
+        "Largest miner population")(
+        "step,s",
+        po::value<uint32_t>(&options.m_nodesStep)->default_value(10000),
+        "Step between populations")(
+        "shardsize",
+        po::value<uint32_t>(&options.m_shardSize)->default_value(0),
+        "Shard size (default to CalculateShardSize of the sharded nodes)")(
+        "lo",
+        po::value<uint32_t>(&options.m_toleranceLo)
+            ->default_value(SHARD_SIZE_TOLERANCE_LO),
+        "Shard size tolerance below")(
+        "hi",
+        po::value<uint32_t>(&options.m_toleranceHi)
+            ->default_value(SHARD_SIZE_TOLERANCE_HI),
+        "Shard size tolerance above")(
+        "maxnodes",
+        po::value<uint32_t>(&options.m_maxShardNodes)
+            ->default_value(MAX_SHARD_NODE_NUM),
+        "Most nodes sharded, as MAX_SHARD_NODE_NUM")(
+        "maxsearch",
+        po::value<uint32_t>(&options.m_maxSearchShards)->default_value(18),
+        "Most shards to run the exponential search for")(
+        "threads,j",
+        po::value<unsigned int>(&options.m_threads)
+            ->default_value(POW_VERIFY_THREADS),
+        "Threads ordering the nodes, as POW_VERIFY_THREADS")(
+        "runs,r", po::value<unsigned int>(&options.m_runs)->default_value(3),
+        "Runs averaged for the times")(
+        "seed", po::value<unsigned int>(&options.m_seed)->default_value(1),
+        "Seed of the synthetic PoW results");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+      po::notify(vm);
+
+      if (vm.count("help")) {
+        SWInfo::LogBrandBugReport();
+        description();
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      if (options.m_nodesStep == 0 || options.m_runs == 0 ||
+          options.m_nodesFrom > options.m_nodesTo) {
+        description();
+        return ERROR_IN_COMMAND_LINE;
+      }
+    } catch (boost::program_options::error& e) {
+      SWInfo::LogBrandBugReport();
+      cerr << "ERROR: " << e.what() << endl << endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    mt19937 generator(options.m_seed);
+    PrintHeader();
+    for (uint64_t numNodes = options.m_nodesFrom; numNodes <= options.m_nodesTo;
+         numNodes += options.m_nodesStep) {
+      Simulate(options, numNodes, generator);
+    }
+  } catch (exception& e) {
+    cerr << "Unhandled Exception reached the top of main: " << e.what()
+         << ", application will now exit" << endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+  return SUCCESS;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <string>
+
+#include <boost/program_options.hpp>
+
+#include "common/Constants.h"
+#include "libPersistence/Snapshot.h"
+#include "libUtils/Logger.h"
+#include "libUtils/SWInfo.h"
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+#define ERROR_IN_SNAPSHOT -3
+
+namespace po = boost::program_options;
+using namespace std;
+
+void description() {
+  std::cout << endl << "Description:\n";
+  std::cout << "\tExports the persistence of a stopped node to a snapshot, "
+               "or imports one into an empty persistence, without replaying "
+               "any block."
+            << endl;
+}
+
+int main(int argc, const char* argv[]) {
+  try {
+    string exportDir, importDir, verifyDir;
+    string persistenceDir = STORAGE_PATH + PERSISTENCE_PATH;
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "export,e", po::value<string>(&exportDir),
+        "Snapshot directory to export the persistence to")(
+        "import,i", po::value<string>(&importDir),
+        "Snapshot directory to import the persistence from")(
+        "verify,v", po::value<string>(&verifyDir),
+        "Snapshot directory to check the chunks of")(
+        "persistence,p", po::value<string>(&persistenceDir),
+        "Persistence directory (default: persistence under STORAGE_PATH)");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+
+      /** --help option
+       */
+      if (vm.count("help")) {
+        SWInfo::LogBrandBugReport();
+        description();
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      po::notify(vm);
+
+      if (vm.count("export") + vm.count("import") + vm.count("verify") != 1) {
+        throw po::error("Exactly one of export, import or verify is needed");
+      }
+    } catch (boost::program_options::error& e) {
+      SWInfo::LogBrandBugReport();
+      cerr << "ERROR: " << e.what() << endl << endl;
+      cout << desc;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    INIT_STDOUT_LOGGER();
+
+    bool result = false;
+    if (!exportDir.empty()) {
+      result = Snapshot::Export(persistenceDir, exportDir);
+    } else if (!importDir.empty()) {
+      result = Snapshot::Import(importDir, persistenceDir);
+    } else {
+      result = Snapshot::Verify(verifyDir);
+    }
+
+    if (!result) {
+      cerr << "Snapshot failed, see the log for details" << endl;
+      return ERROR_IN_SNAPSHOT;
+    }
+    cout << "Snapshot done" << endl;
+  } catch (exception& e) {
+    cerr << "Unhandled Exception reached the top of main: " << e.what()
+         << ", application will now exit" << endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+  return SUCCESS;
+}
@@ -15,6 +15,11 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <iostream>
+#include <string>
+
+#include <boost/program_options.hpp>
+
 #include "libMediator/Mediator.h"
 #include "libNetwork/Guard.h"
 #include "libPersistence/BlockStorage.h"
@@ -24,8 +29,53 @@
 /// Should be run from a folder with dsnodes.xml and constants.xml and a folder
 /// named "persistence" consisting of the persistence
 
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+
+namespace po = boost::program_options;
 using namespace std;
-int main() {
+
+void description() {
+  std::cout << endl << "Description:\n";
+  std::cout << "\tValidates the persistence of a stopped node. With a "
+               "checkpoint file, an interrupted run resumes where it stopped."
+            << endl;
+}
+
+int main(int argc, const char* argv[]) {
+  uint64_t fromBlockNum = 0;
+  uint64_t toBlockNum = UINT64_MAX;
+  string checkpointFile;
+  po::options_description desc("Options");
+
+  desc.add_options()("help,h", "Print help messages")(
+      "from,f", po::value<uint64_t>(&fromBlockNum),
+      "First Tx block to validate (default: the checkpoint, else 0)")(
+      "to,t", po::value<uint64_t>(&toBlockNum),
+      "Last Tx block to validate (default: the latest)")(
+      "checkpoint,c", po::value<string>(&checkpointFile),
+      "File keeping the next Tx block to validate");
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+
+    if (vm.count("help")) {
+      description();
+      cout << desc << endl;
+      return SUCCESS;
+    }
+    po::notify(vm);
+
+    if (fromBlockNum > toBlockNum) {
+      throw po::error("from must not be above to");
+    }
+  } catch (boost::program_options::error& e) {
+    cerr << "ERROR: " << e.what() << endl << endl;
+    cout << desc;
+    return ERROR_IN_COMMAND_LINE;
+  }
+
   PairOfKey key;  // Dummy to initate mediator
   Peer peer;
 
@@ -57,7 +107,7 @@ int main() {
   }
   mediator.RegisterColleagues(nullptr, &node, nullptr, vd.get());
 
-  if (node.CheckIntegrity(true)) {
+  if (node.CheckIntegrity(true, fromBlockNum, toBlockNum, checkpointFile)) {
     cout << "Validation Success";
   } else {
     cout << "Validation Failure";
@@ -67,12 +67,85 @@ const vector<string> ReadAccountsFromConstantsFile(const string& propName) {
   return result;
 }
 
+const map<string, LevelDBProfile> ReadLevelDBProfiles() {
+  auto pt = PTree::GetInstance();
+  map<string, LevelDBProfile> result;
+  auto profiles = pt.get_child_optional("node.leveldb_profiles");
+  if (!profiles) {
+    return result;
+  }
+  for (auto& entry : *profiles) {
+    if (entry.first != "profile") {
+      continue;
+    }
+    LevelDBProfile profile;
+    profile.m_bloomBitsPerKey = entry.second.get<unsigned int>(
+        "bloom_bits_per_key", profile.m_bloomBitsPerKey);
+    profile.m_blockSizeInKB = entry.second.get<unsigned int>(
+        "block_size_in_kb", profile.m_blockSizeInKB);
+    profile.m_compression =
+        entry.second.get<string>("compression",
+                                 profile.m_compression ? "true" : "false") ==
+        "true";
+    profile.m_blockCacheSizeInMB = entry.second.get<unsigned int>(
+        "block_cache_size_in_mb", profile.m_blockCacheSizeInMB);
+    profile.m_binaryKeys =
+        entry.second.get<string>("binary_keys",
+                                 profile.m_binaryKeys ? "true" : "false") ==
+        "true";
+    result[entry.second.get<string>("db")] = profile;
+  }
+  return result;
+}
+
+const map<string, unsigned int> ReadRpcMethodLimits() {
+  auto pt = PTree::GetInstance();
+  map<string, unsigned int> result;
+  auto limits = pt.get_child_optional("node.rpc_method_limits");
+  if (!limits) {
+    return result;
+  }
+  for (auto& entry : *limits) {
+    if (entry.first != "limit") {
+      continue;
+    }
+    result[entry.second.get<string>("method")] =
+        entry.second.get<unsigned int>("max_concurrent");
+  }
+  return result;
+}
+
+const map<string, string> ReadThreadAffinityGroups() {
+  auto pt = PTree::GetInstance();
+  map<string, string> result;
+  auto groups = pt.get_child_optional("node.thread_affinity");
+  if (!groups) {
+    return result;
+  }
+  for (auto& entry : *groups) {
+    if (entry.first != "group") {
+      continue;
+    }
+    result[entry.second.get<string>("name")] =
+        entry.second.get<string>("cores");
+  }
+  return result;
+}
+
 // General constants
 const unsigned int DEBUG_LEVEL{ReadConstantNumeric("DEBUG_LEVEL")};
 const bool ENABLE_DO_REJOIN{ReadConstantString("ENABLE_DO_REJOIN") == "true"};
 const bool LOOKUP_NODE_MODE{ReadConstantString("LOOKUP_NODE_MODE") == "true"};
 const unsigned int MAX_ENTRIES_FOR_DIAGNOSTIC_DATA{
     ReadConstantNumeric("MAX_ENTRIES_FOR_DIAGNOSTIC_DATA")};
+const unsigned int DETACHED_IDLE_THREADS{
+    ReadConstantNumeric("DETACHED_IDLE_THREADS")};
+const unsigned int DETACHED_IDLE_TIMEOUT_IN_SECONDS{
+    ReadConstantNumeric("DETACHED_IDLE_TIMEOUT_IN_SECONDS")};
+const unsigned int DETACHED_PERSISTENCE_THREADS{
+    ReadConstantNumeric("DETACHED_PERSISTENCE_THREADS")};
+const unsigned int LOG_ASYNC_BUFFER_SIZE{
+    ReadConstantNumeric("LOG_ASYNC_BUFFER_SIZE")};
 const uint16_t CHAIN_ID{(uint16_t)ReadConstantNumeric("CHAIN_ID")};
 const string GENESIS_PUBKEY{
     ReadConstantString("GENESIS_PUBKEY", "node.general.")};
@@ -113,6 +186,18 @@ const unsigned int SEED_TXN_COLLECTION_TIME_IN_SEC{
     ReadConstantNumeric("SEED_TXN_COLLECTION_TIME_IN_SEC", "node.seed.")};
 const unsigned int TXN_STORAGE_LIMIT{
     ReadConstantNumeric("TXN_STORAGE_LIMIT", "node.seed.")};
+const unsigned int TXN_STORAGE_MEMORY_LIMIT_IN_MB{
+    ReadConstantNumeric("TXN_STORAGE_MEMORY_LIMIT_IN_MB", "node.seed.")};
+const unsigned int SEED_RESPONSE_CACHE_SIZE_IN_MB{
+    ReadConstantNumeric("SEED_RESPONSE_CACHE_SIZE_IN_MB", "node.seed.")};
+const bool SEED_SUBSCRIBE_TO_LOOKUP{
+    ReadConstantString("SEED_SUBSCRIBE_TO_LOOKUP", "node.seed.") == "true"};
+const unsigned int SEED_SUBSCRIPTION_TTL_IN_SEC{
+    ReadConstantNumeric("SEED_SUBSCRIPTION_TTL_IN_SEC", "node.seed.")};
+const unsigned int LOOKUP_MAX_SEED_SUBSCRIBERS{
+    ReadConstantNumeric("LOOKUP_MAX_SEED_SUBSCRIBERS", "node.seed.")};
+const unsigned int STATE_EXPORT_CHUNK_ACCOUNTS{
+    ReadConstantNumeric("STATE_EXPORT_CHUNK_ACCOUNTS", "node.seed.")};
 // Consensus constants
 const unsigned int COMMIT_WINDOW_IN_SECONDS{
     ReadConstantNumeric("COMMIT_WINDOW_IN_SECONDS", "node.consensus.")};
@@ -126,6 +211,16 @@ const unsigned int SHARD_NUM_CONSENSUS_SUBSETS{
     ReadConstantNumeric("SHARD_NUM_CONSENSUS_SUBSETS", "node.consensus.")};
 const unsigned int COMMIT_TOLERANCE_PERCENT{
     ReadConstantNumeric("COMMIT_TOLERANCE_PERCENT", "node.consensus.")};
+const unsigned int COMMIT_POOL_SIZE{
+    ReadConstantNumeric("COMMIT_POOL_SIZE", "node.consensus.")};
+const bool ENABLE_FINALBLOCK_PREDISTRIBUTION{ReadConstantString(
+    "ENABLE_FINALBLOCK_PREDISTRIBUTION", "node.consensus.") == "true"};
+const unsigned int FINALBLOCK_PROPOSAL_WAIT_IN_MS{
+    ReadConstantNumeric("FINALBLOCK_PROPOSAL_WAIT_IN_MS", "node.consensus.")};
+const unsigned int VERIFIED_COSIG_CACHE_SIZE{
+    ReadConstantNumeric("VERIFIED_COSIG_CACHE_SIZE", "node.consensus.")};
+const unsigned int MICROBLOCK_VERIFY_THREADS{
+    ReadConstantNumeric("MICROBLOCK_VERIFY_THREADS", "node.consensus.")};
 
 // Data sharing constants
 const bool BROADCAST_TREEBASED_CLUSTER_MODE{
@@ -139,12 +234,18 @@ const unsigned int NUM_NODES_TO_SEND_LOOKUP{
     ReadConstantNumeric("NUM_NODES_TO_SEND_LOOKUP", "node.data_sharing.")};
 const unsigned int NUM_OF_TREEBASED_CHILD_CLUSTERS{ReadConstantNumeric(
     "NUM_OF_TREEBASED_CHILD_CLUSTERS", "node.data_sharing.")};
+const unsigned int BROADCAST_REGION_PREFIX_BITS{
+    ReadConstantNumeric("BROADCAST_REGION_PREFIX_BITS", "node.data_sharing.")};
 const unsigned int POW_PACKET_SENDERS{
     ReadConstantNumeric("POW_PACKET_SENDERS", "node.data_sharing.")};
 const unsigned int TX_SHARING_CLUSTER_SIZE{
     ReadConstantNumeric("TX_SHARING_CLUSTER_SIZE", "node.data_sharing.")};
 const unsigned int NUM_SHARE_PENDING_TXNS{
     (ReadConstantNumeric("NUM_SHARE_PENDING_TXNS", "node.data_sharing."))};
+const bool COMPACT_MBNFORWARD_RELAY{ReadConstantString(
+    "COMPACT_MBNFORWARD_RELAY", "node.data_sharing.") == "true"};
+const unsigned int COMPACT_RELAY_TXN_CACHE_SIZE_IN_MB{ReadConstantNumeric(
+    "COMPACT_RELAY_TXN_CACHE_SIZE_IN_MB", "node.data_sharing.")};
 
 // Dispatcher constants
 const string TXN_PATH{ReadConstantString("TXN_PATH", "node.dispatcher.")};
@@ -160,6 +261,10 @@ const unsigned int ANNOUNCEMENT_DELAY_IN_MS{
     ReadConstantNumeric("ANNOUNCEMENT_DELAY_IN_MS", "node.epoch_timing.")};
 const unsigned int LOOKUP_DELAY_SEND_TXNPACKET_IN_MS{ReadConstantNumeric(
     "LOOKUP_DELAY_SEND_TXNPACKET_IN_MS", "node.epoch_timing.")};
+const unsigned int LOOKUP_TXN_STREAM_INTERVAL_IN_MS{ReadConstantNumeric(
+    "LOOKUP_TXN_STREAM_INTERVAL_IN_MS", "node.epoch_timing.")};
+const unsigned int LOOKUP_TXN_PACKET_SIZE{
+    ReadConstantNumeric("LOOKUP_TXN_PACKET_SIZE", "node.epoch_timing.")};
 const unsigned int MICROBLOCK_TIMEOUT{
     ReadConstantNumeric("MICROBLOCK_TIMEOUT", "node.epoch_timing.")};
 const unsigned int NEW_NODE_SYNC_INTERVAL{
@@ -170,6 +275,10 @@ const unsigned int POW_WINDOW_IN_SECONDS{
     ReadConstantNumeric("POW_WINDOW_IN_SECONDS", "node.epoch_timing.")};
 const unsigned int POWPACKETSUBMISSION_WINDOW_IN_SECONDS{ReadConstantNumeric(
     "POWPACKETSUBMISSION_WINDOW_IN_SECONDS", "node.epoch_timing.")};
+const unsigned int POW_EARLY_CLOSE_PERCENT{
+    ReadConstantNumeric("POW_EARLY_CLOSE_PERCENT", "node.epoch_timing.")};
+const unsigned int POW_EARLY_CLOSE_IDLE_IN_SECONDS{ReadConstantNumeric(
+    "POW_EARLY_CLOSE_IDLE_IN_SECONDS", "node.epoch_timing.")};
 const unsigned int RECOVERY_SYNC_TIMEOUT{
     ReadConstantNumeric("RECOVERY_SYNC_TIMEOUT", "node.epoch_timing.")};
 const unsigned int TX_DISTRIBUTE_TIME_IN_MS{
@@ -184,6 +293,18 @@ const unsigned int RETRY_REJOINING_TIMEOUT{
     ReadConstantNumeric("RETRY_REJOINING_TIMEOUT", "node.epoch_timing.")};
 const unsigned int RETRY_GETSTATEDELTAS_COUNT{
     ReadConstantNumeric("RETRY_GETSTATEDELTAS_COUNT", "node.epoch_timing.")};
+const unsigned int TXBLOCK_DOWNLOAD_MAX_CHUNKS{
+    ReadConstantNumeric("TXBLOCK_DOWNLOAD_MAX_CHUNKS", "node.epoch_timing.")};
+const unsigned int TXBLOCK_DOWNLOAD_CHUNK_SIZE{
+    ReadConstantNumeric("TXBLOCK_DOWNLOAD_CHUNK_SIZE", "node.epoch_timing.")};
+const unsigned int TXBLOCK_DOWNLOAD_TIMEOUT_IN_SECONDS{ReadConstantNumeric(
+    "TXBLOCK_DOWNLOAD_TIMEOUT_IN_SECONDS", "node.epoch_timing.")};
+const unsigned int TXBLOCK_DOWNLOAD_RETRY_COUNT{
+    ReadConstantNumeric("TXBLOCK_DOWNLOAD_RETRY_COUNT", "node.epoch_timing.")};
+const unsigned int STATEDELTA_FETCH_WINDOW{
+    ReadConstantNumeric("STATEDELTA_FETCH_WINDOW", "node.epoch_timing.")};
+const unsigned int STATEDELTA_FETCH_IN_FLIGHT{
+    ReadConstantNumeric("STATEDELTA_FETCH_IN_FLIGHT", "node.epoch_timing.")};
 const unsigned int MAX_FETCHMISSINGMBS_NUM{
     ReadConstantNumeric("MAX_FETCHMISSINGMBS_NUM", "node.epoch_timing.")};
 const unsigned int LAST_N_TXBLKS_TOCHECK_FOR_MISSINGMBS{ReadConstantNumeric(
@@ -269,9 +390,27 @@ const bool SIGN_VERIFY_EMPTY_MSGTYP{
 const bool SIGN_VERIFY_NONEMPTY_MSGTYP{
     ReadConstantString("SIGN_VERIFY_NONEMPTY_MSGTYP", "node.gossip.") ==
     "true"};
+const bool ENABLE_RUMOR_BATCHING{
+    ReadConstantString("ENABLE_RUMOR_BATCHING", "node.gossip.") == "true"};
+const unsigned int MAX_RUMOR_BATCH_SIZE_IN_BYTES{
+    ReadConstantNumeric("MAX_RUMOR_BATCH_SIZE_IN_BYTES", "node.gossip.")};
+const bool ENABLE_GOSSIP_BATCH_VERIFY{
+    ReadConstantString("ENABLE_GOSSIP_BATCH_VERIFY", "node.gossip.") == "true"};
+const unsigned int GOSSIP_VERIFY_NUM_THREADS{
+    ReadConstantNumeric("GOSSIP_VERIFY_NUM_THREADS", "node.gossip.")};
+const unsigned int GOSSIP_VERIFY_BATCH_SIZE{
+    ReadConstantNumeric("GOSSIP_VERIFY_BATCH_SIZE", "node.gossip.")};
+const unsigned int GOSSIP_VERIFY_WINDOW_IN_MS{
+    ReadConstantNumeric("GOSSIP_VERIFY_WINDOW_IN_MS", "node.gossip.")};
 
 // GPU mining constants
 const string GPU_TO_USE{ReadConstantString("GPU_TO_USE", "node.gpu.")};
+const string OPENCL_GPU_TO_USE{
+    ReadConstantString("OPENCL_GPU_TO_USE", "node.gpu.")};
+const string CUDA_GPU_TO_USE{
+    ReadConstantString("CUDA_GPU_TO_USE", "node.gpu.")};
+const unsigned int GPU_NONCE_RANGE_IN_MS{
+    ReadConstantNumeric("GPU_NONCE_RANGE_IN_MS", "node.gpu.")};
 const unsigned int OPENCL_LOCAL_WORK_SIZE{
     ReadConstantNumeric("LOCAL_WORK_SIZE", "node.gpu.opencl.")};
 const unsigned int OPENCL_GLOBAL_WORK_SIZE_MULTIPLIER{
@@ -312,6 +451,36 @@ const bool ENABLE_STATUS_RPC{
     ReadConstantString("ENABLE_STATUS_RPC", "node.jsonrpc.") == "true"};
 const unsigned int NUM_SHARD_PEER_TO_REVEAL{
     ReadConstantNumeric("NUM_SHARD_PEER_TO_REVEAL", "node.jsonrpc.")};
+const unsigned int CONTRACT_STATE_PAGE_SIZE_MAX{
+    ReadConstantNumeric("CONTRACT_STATE_PAGE_SIZE_MAX", "node.jsonrpc.")};
+const unsigned int TXN_HISTORY_PAGE_SIZE_MAX{
+    ReadConstantNumeric("TXN_HISTORY_PAGE_SIZE_MAX", "node.jsonrpc.")};
+const unsigned int TXBLOCK_RANGE_SIZE_MAX{
+    ReadConstantNumeric("TXBLOCK_RANGE_SIZE_MAX", "node.jsonrpc.")};
+const unsigned int TXBLOCK_RANGE_RESPONSE_BYTES_MAX{
+    ReadConstantNumeric("TXBLOCK_RANGE_RESPONSE_BYTES_MAX", "node.jsonrpc.")};
+const unsigned int EVENT_LOG_RANGE_SIZE_MAX{
+    ReadConstantNumeric("EVENT_LOG_RANGE_SIZE_MAX", "node.jsonrpc.")};
+const unsigned int LOOKUP_RESPONSE_CACHE_SIZE{
+    ReadConstantNumeric("LOOKUP_RESPONSE_CACHE_SIZE", "node.jsonrpc.")};
+const unsigned int LOOKUP_RPC_THREADS{
+    ReadConstantNumeric("LOOKUP_RPC_THREADS", "node.jsonrpc.")};
+const unsigned int LOOKUP_RPC_CONNECTION_TIMEOUT_IN_SECONDS{ReadConstantNumeric(
+    "LOOKUP_RPC_CONNECTION_TIMEOUT_IN_SECONDS", "node.jsonrpc.")};
+const double CREATE_TXN_RATE_PER_CLIENT{
+    ReadConstantDouble("CREATE_TXN_RATE_PER_CLIENT", "node.jsonrpc.")};
+const unsigned int CREATE_TXN_BURST_PER_CLIENT{
+    ReadConstantNumeric("CREATE_TXN_BURST_PER_CLIENT", "node.jsonrpc.")};
+const double CREATE_TXN_RATE_PER_SENDER{
+    ReadConstantDouble("CREATE_TXN_RATE_PER_SENDER", "node.jsonrpc.")};
+const unsigned int CREATE_TXN_BURST_PER_SENDER{
+    ReadConstantNumeric("CREATE_TXN_BURST_PER_SENDER", "node.jsonrpc.")};
+const bool ENABLE_PROTO_RPC{
+    ReadConstantString("ENABLE_PROTO_RPC", "node.jsonrpc.") == "true"};
+const unsigned int PROTO_RPC_PORT{
+    ReadConstantNumeric("PROTO_RPC_PORT", "node.jsonrpc.")};
+const unsigned int PROTO_RPC_MAX_CONNECTIONS{
+    ReadConstantNumeric("PROTO_RPC_MAX_CONNECTIONS", "node.jsonrpc.")};
 const std::string SCILLA_IPC_SOCKET_PATH{
     ReadConstantString("SCILLA_IPC_SOCKET_PATH", "node.jsonrpc.")};
 bool ENABLE_WEBSOCKET{ReadConstantString("ENABLE_WEBSOCKET", "node.jsonrpc.") ==
@@ -338,6 +507,8 @@ const unsigned int BROADCAST_INTERVAL{
     ReadConstantNumeric("BROADCAST_INTERVAL", "node.p2pcomm.")};
 const unsigned int BROADCAST_EXPIRY{
     ReadConstantNumeric("BROADCAST_EXPIRY", "node.p2pcomm.")};
+const unsigned int P2P_RECEIVE_THREADS{
+    ReadConstantNumeric("P2P_RECEIVE_THREADS", "node.p2pcomm.")};
 const unsigned int FETCH_LOOKUP_MSG_MAX_RETRY{
     ReadConstantNumeric("FETCH_LOOKUP_MSG_MAX_RETRY", "node.p2pcomm.")};
 const uint32_t MAXMESSAGE{ReadConstantNumeric("MAXMESSAGE", "node.p2pcomm.")};
@@ -349,6 +520,22 @@ const unsigned int PUMPMESSAGE_MILLISECONDS{
     ReadConstantNumeric("PUMPMESSAGE_MILLISECONDS", "node.p2pcomm.")};
 const unsigned int SENDQUEUE_SIZE{
     ReadConstantNumeric("SENDQUEUE_SIZE", "node.p2pcomm.")};
+const unsigned int SEND_COALESCE_MAX_BYTES{
+    ReadConstantNumeric("SEND_COALESCE_MAX_BYTES", "node.p2pcomm.")};
+const bool ENABLE_ASYNC_SEND{
+    ReadConstantString("ENABLE_ASYNC_SEND", "node.p2pcomm.") == "true"};
+const unsigned int ASYNC_SEND_MIN_BYTES{
+    ReadConstantNumeric("ASYNC_SEND_MIN_BYTES", "node.p2pcomm.")};
+const unsigned int EGRESS_BULK_RATE_IN_BYTES_PER_SEC{
+    ReadConstantNumeric("EGRESS_BULK_RATE_IN_BYTES_PER_SEC", "node.p2pcomm.")};
+const unsigned int EGRESS_BULK_BURST_IN_BYTES{
+    ReadConstantNumeric("EGRESS_BULK_BURST_IN_BYTES", "node.p2pcomm.")};
+const unsigned int PEER_HEALTH_FAILURE_THRESHOLD{
+    ReadConstantNumeric("PEER_HEALTH_FAILURE_THRESHOLD", "node.p2pcomm.")};
+const unsigned int PEER_HEALTH_MIN_BACKOFF_IN_MS{
+    ReadConstantNumeric("PEER_HEALTH_MIN_BACKOFF_IN_MS", "node.p2pcomm.")};
+const unsigned int PEER_HEALTH_MAX_BACKOFF_IN_MS{
+    ReadConstantNumeric("PEER_HEALTH_MAX_BACKOFF_IN_MS", "node.p2pcomm.")};
 const unsigned int MAX_GOSSIP_MSG_SIZE_IN_BYTES{
     ReadConstantNumeric("MAX_GOSSIP_MSG_SIZE_IN_BYTES", "node.p2pcomm.")};
 const unsigned int MIN_READ_WATERMARK_IN_BYTES{
@@ -361,12 +548,31 @@ const unsigned int MAX_PEER_CONNECTION{
     ReadConstantNumeric("MAX_PEER_CONNECTION", "node.p2pcomm.")};
 const unsigned int MAX_WHITELISTREQ_LIMIT{
     ReadConstantNumeric("MAX_WHITELISTREQ_LIMIT", "node.p2pcomm.")};
+const bool ENABLE_CONNECTION_POOL{
+    ReadConstantString("ENABLE_CONNECTION_POOL", "node.p2pcomm.") == "true"};
+const unsigned int CONNECTION_POOL_MAX_PER_PEER{
+    ReadConstantNumeric("CONNECTION_POOL_MAX_PER_PEER", "node.p2pcomm.")};
+const unsigned int CONNECTION_POOL_IDLE_TIMEOUT{
+    ReadConstantNumeric("CONNECTION_POOL_IDLE_TIMEOUT", "node.p2pcomm.")};
+const unsigned int CONNECTION_POOL_WAIT_MILLISECONDS{
+    ReadConstantNumeric("CONNECTION_POOL_WAIT_MILLISECONDS", "node.p2pcomm.")};
+const bool ENABLE_MESSAGE_COMPRESSION{ReadConstantString(
+    "ENABLE_MESSAGE_COMPRESSION", "node.p2pcomm.") == "true"};
+const unsigned int MESSAGE_COMPRESSION_THRESHOLD_IN_BYTES{ReadConstantNumeric(
+    "MESSAGE_COMPRESSION_THRESHOLD_IN_BYTES", "node.p2pcomm.")};
+const unsigned int MESSAGE_COMPRESSION_MIN_SAVING_PERCENT{ReadConstantNumeric(
+    "MESSAGE_COMPRESSION_MIN_SAVING_PERCENT", "node.p2pcomm.")};
 
 // PoW constants
 const bool CUDA_GPU_MINE{ReadConstantString("CUDA_GPU_MINE", "node.pow.") ==
                          "true"};
 const bool FULL_DATASET_MINE{
     ReadConstantString("FULL_DATASET_MINE", "node.pow.") == "true"};
+const string DAG_STORE_DIR{ReadConstantString("DAG_STORE_DIR", "node.pow.")};
+const unsigned int CPU_MINE_THREADS{
+    ReadConstantNumeric("CPU_MINE_THREADS", "node.pow.")};
+const bool CPU_MINE_PIN_THREADS{
+    ReadConstantString("CPU_MINE_PIN_THREADS", "node.pow.") == "true"};
 const bool OPENCL_GPU_MINE{ReadConstantString("OPENCL_GPU_MINE", "node.pow.") ==
                            "true"};
 const bool REMOTE_MINE{ReadConstantString("REMOTE_MINE", "node.pow.") ==
@@ -377,10 +583,16 @@ const unsigned int MAX_RETRY_SEND_POW_TIME{
     ReadConstantNumeric("MAX_RETRY_SEND_POW_TIME", "node.pow.")};
 const unsigned int CHECK_MINING_RESULT_INTERVAL{
     ReadConstantNumeric("CHECK_MINING_RESULT_INTERVAL", "node.pow.")};
+const unsigned int REMOTE_MINE_PUSH_PORT{
+    ReadConstantNumeric("REMOTE_MINE_PUSH_PORT", "node.pow.")};
 const bool GETWORK_SERVER_MINE{
     ReadConstantString("GETWORK_SERVER_MINE", "node.pow.") == "true"};
 const unsigned int GETWORK_SERVER_PORT{
     ReadConstantNumeric("GETWORK_SERVER_PORT", "node.pow.")};
+const unsigned int GETWORK_LONG_POLL_TIMEOUT{
+    ReadConstantNumeric("GETWORK_LONG_POLL_TIMEOUT", "node.pow.")};
+const unsigned int GETWORK_STRATUM_PORT{
+    ReadConstantNumeric("GETWORK_STRATUM_PORT", "node.pow.")};
 const unsigned int DS_POW_DIFFICULTY{
     ReadConstantNumeric("DS_POW_DIFFICULTY", "node.pow.")};
 const unsigned int POW_DIFFICULTY{
@@ -391,6 +603,8 @@ const unsigned int POW_BOUNDARY_N_DIVIDED_START{
     ReadConstantNumeric("POW_BOUNDARY_N_DIVIDED_START", "node.pow.")};
 const unsigned int POW_SUBMISSION_LIMIT{
     ReadConstantNumeric("POW_SUBMISSION_LIMIT", "node.pow.")};
+const unsigned int POW_VERIFY_THREADS{
+    ReadConstantNumeric("POW_VERIFY_THREADS", "node.pow.")};
 const unsigned int NUM_FINAL_BLOCK_PER_POW{
     ReadConstantNumeric("NUM_FINAL_BLOCK_PER_POW", "node.pow.")};
 const unsigned int POW_CHANGE_TO_ADJ_DIFF{
@@ -434,6 +648,12 @@ const string UPGRADE_HOST_REPO{
 const bool RECOVERY_TRIM_INCOMPLETED_BLOCK{
     ReadConstantString("RECOVERY_TRIM_INCOMPLETED_BLOCK", "node.recovery.") ==
     "true"};
+const unsigned int RETRIEVER_THREADS{
+    ReadConstantNumeric("RETRIEVER_THREADS", "node.recovery.")};
+const unsigned int SNAPSHOT_THREADS{
+    ReadConstantNumeric("SNAPSHOT_THREADS", "node.recovery.")};
+const unsigned int SNAPSHOT_CHUNK_SIZE_IN_MB{
+    ReadConstantNumeric("SNAPSHOT_CHUNK_SIZE_IN_MB", "node.recovery.")};
 const bool REJOIN_NODE_NOT_IN_NETWORK{
     ReadConstantString("REJOIN_NODE_NOT_IN_NETWORK", "node.recovery.") ==
     "true"};
@@ -487,11 +707,39 @@ const string FIELDS_MAP_DEPTH_INDICATOR{
     ReadConstantString("FIELDS_MAP_DEPTH_INDICATOR", "node.smart_contract.")};
 const bool LOG_SC{ReadConstantString("LOG_SC", "node.smart_contract.") ==
                   "true"};
+const bool CONTRACT_STATE_HASH_TREE{ReadConstantString(
+    "CONTRACT_STATE_HASH_TREE", "node.smart_contract.") == "true"};
+const bool ENABLE_SCILLA_SERVER{ReadConstantString(
+    "ENABLE_SCILLA_SERVER", "node.smart_contract.") == "true"};
+const string SCILLA_SERVER_BINARY{
+    ReadConstantString("SCILLA_SERVER_BINARY", "node.smart_contract.")};
+const string SCILLA_SERVER_SOCKET_PATH{
+    ReadConstantString("SCILLA_SERVER_SOCKET_PATH", "node.smart_contract.")};
+const unsigned int SCILLA_SERVER_POOL_SIZE{
+    ReadConstantNumeric("SCILLA_SERVER_POOL_SIZE", "node.smart_contract.")};
+const bool SCILLA_MEM_FILES{
+    ReadConstantString("SCILLA_MEM_FILES", "node.smart_contract.") == "true"};
+const bool SCILLA_CHECKER_CACHE{ReadConstantString(
+    "SCILLA_CHECKER_CACHE", "node.smart_contract.") == "true"};
 
 // Test constants
 const bool ENABLE_CHECK_PERFORMANCE_LOG{
     ReadConstantString("ENABLE_CHECK_PERFORMANCE_LOG", "node.tests.") ==
     "true"};
+const bool ENABLE_MESSAGE_STATS{
+    ReadConstantString("ENABLE_MESSAGE_STATS", "node.tests.") == "true"};
+const bool ENABLE_MEMORY_STATS{
+    ReadConstantString("ENABLE_MEMORY_STATS", "node.tests.") == "true"};
+const bool ENABLE_TRAFFIC_STATS{
+    ReadConstantString("ENABLE_TRAFFIC_STATS", "node.tests.") == "true"};
+const bool ENABLE_CONSENSUS_TRACE{
+    ReadConstantString("ENABLE_CONSENSUS_TRACE", "node.tests.") == "true"};
+const bool ENABLE_EPOCH_PERF{
+    ReadConstantString("ENABLE_EPOCH_PERF", "node.tests.") == "true"};
+const unsigned int PROFILER_SAMPLES_PER_SECOND{
+    ReadConstantNumeric("PROFILER_SAMPLES_PER_SECOND", "node.tests.")};
+const unsigned int PROFILER_MAX_WINDOW_IN_SECONDS{
+    ReadConstantNumeric("PROFILER_MAX_WINDOW_IN_SECONDS", "node.tests.")};
 #ifdef FALLBACK_TEST
 const unsigned int FALLBACK_TEST_EPOCH{
     ReadConstantNumeric("FALLBACK_TEST_EPOCH", "node.tests.")};
@@ -508,6 +756,8 @@ const unsigned int PREGEN_ACCOUNT_TIMES{
     ReadConstantNumeric("PREGEN_ACCOUNT_TIMES", "node.tests.")};
 const string PREGENED_ACCOUNTS_FILE{
     ReadConstantString("PREGENED_ACCOUNTS_FILE", "node.tests.")};
+const string GENESIS_ACCOUNTS_FILE{
+    ReadConstantString("GENESIS_ACCOUNTS_FILE", "node.tests.")};
 
 // Transaction constants
 const uint128_t TOTAL_COINBASE_REWARD{
@@ -532,6 +782,18 @@ const unsigned int SYS_TIMESTAMP_VARIANCE_IN_SECONDS{ReadConstantNumeric(
     "SYS_TIMESTAMP_VARIANCE_IN_SECONDS", "node.transactions.")};
 const unsigned int TXN_MISORDER_TOLERANCE_IN_PERCENT{ReadConstantNumeric(
     "TXN_MISORDER_TOLERANCE_IN_PERCENT", "node.transactions.")};
+const bool BINARY_TXN_RECEIPTS{
+    ReadConstantString("BINARY_TXN_RECEIPTS", "node.transactions.") == "true"};
+const bool SPECULATIVE_TXN_PROCESSING{ReadConstantString(
+    "SPECULATIVE_TXN_PROCESSING", "node.transactions.") == "true"};
+const unsigned int TXN_EXECUTION_THREADS{
+    ReadConstantNumeric("TXN_EXECUTION_THREADS", "node.transactions.")};
+const bool DS_PARALLEL_CONTRACT_CALLS{ReadConstantString(
+    "DS_PARALLEL_CONTRACT_CALLS", "node.transactions.") == "true"};
+const unsigned int TXN_VERIFY_THREADS{
+    ReadConstantNumeric("TXN_VERIFY_THREADS", "node.transactions.")};
+const bool LOOKUP_TXN_PACKET_ATTESTATION{ReadConstantString(
+    "LOOKUP_TXN_PACKET_ATTESTATION", "node.transactions.") == "true"};
 const unsigned int PACKET_EPOCH_LATE_ALLOW{
     ReadConstantNumeric("PACKET_EPOCH_LATE_ALLOW", "node.transactions.")};
 const unsigned int PACKET_BYTESIZE_LIMIT{
@@ -540,6 +802,53 @@ const unsigned int SMALL_TXN_SIZE{
     ReadConstantNumeric("SMALL_TXN_SIZE", "node.transactions.")};
 const unsigned int ACCOUNT_IO_BATCH_SIZE{
     ReadConstantNumeric("ACCOUNT_IO_BATCH_SIZE", "node.transactions.")};
+const unsigned int ACCOUNT_READ_VIEW_SIZE{
+    ReadConstantNumeric("ACCOUNT_READ_VIEW_SIZE", "node.transactions.")};
+const unsigned int LOOKUP_NONCE_GAP_LIMIT{
+    ReadConstantNumeric("LOOKUP_NONCE_GAP_LIMIT", "node.transactions.")};
+const unsigned int STATE_TRIE_NODE_CACHE_SIZE_IN_MB{ReadConstantNumeric(
+    "STATE_TRIE_NODE_CACHE_SIZE_IN_MB", "node.transactions.")};
+const unsigned int LEVELDB_BLOCK_CACHE_SIZE_IN_MB{ReadConstantNumeric(
+    "LEVELDB_BLOCK_CACHE_SIZE_IN_MB", "node.transactions.")};
+const unsigned int LEVELDB_WRITE_BUFFER_SIZE_IN_MB{ReadConstantNumeric(
+    "LEVELDB_WRITE_BUFFER_SIZE_IN_MB", "node.transactions.")};
+const unsigned int LEVELDB_MAX_OPEN_FILES{
+    ReadConstantNumeric("LEVELDB_MAX_OPEN_FILES", "node.transactions.")};
+const unsigned int LEVELDB_KEY_MIGRATION_BATCH_SIZE{ReadConstantNumeric(
+    "LEVELDB_KEY_MIGRATION_BATCH_SIZE", "node.transactions.")};
+const unsigned int BLOCKSTORAGE_CACHE_SIZE_IN_MB{
+    ReadConstantNumeric("BLOCKSTORAGE_CACHE_SIZE_IN_MB", "node.transactions.")};
+const unsigned int CONTRACT_CODE_CACHE_SIZE_IN_MB{ReadConstantNumeric(
+    "CONTRACT_CODE_CACHE_SIZE_IN_MB", "node.transactions.")};
+const unsigned int BLOCKCHAIN_OLDER_BLOCKS_SIZE{
+    ReadConstantNumeric("BLOCKCHAIN_OLDER_BLOCKS_SIZE", "node.transactions.")};
+const unsigned int TX_BODY_WRITE_QUEUE_SIZE{
+    ReadConstantNumeric("TX_BODY_WRITE_QUEUE_SIZE", "node.transactions.")};
+const unsigned int TX_BODY_RETENTION_DS_EPOCHS{
+    ReadConstantNumeric("TX_BODY_RETENTION_DS_EPOCHS", "node.transactions.")};
+const bool ENABLE_TXN_HISTORY_INDEX{ReadConstantString(
+    "ENABLE_TXN_HISTORY_INDEX", "node.transactions.") == "true"};
+const bool ENABLE_EVENT_BLOOM_INDEX{ReadConstantString(
+    "ENABLE_EVENT_BLOOM_INDEX", "node.transactions.") == "true"};
+const unsigned int COSIGS_REWARDS_MAX_BLOCKS_PER_REQUEST{ReadConstantNumeric(
+    "COSIGS_REWARDS_MAX_BLOCKS_PER_REQUEST", "node.transactions.")};
+const unsigned int CHECKPOINT_INTERVAL_IN_EPOCHS{
+    ReadConstantNumeric("CHECKPOINT_INTERVAL_IN_EPOCHS", "node.transactions.")};
+const unsigned int CHECKPOINT_KEEP_COUNT{
+    ReadConstantNumeric("CHECKPOINT_KEEP_COUNT", "node.transactions.")};
+const map<string, LevelDBProfile> LEVELDB_PROFILES{ReadLevelDBProfiles()};
+const map<string, unsigned int> LOOKUP_RPC_METHOD_LIMITS{
+    ReadRpcMethodLimits()};
+const map<string, string> THREAD_AFFINITY_GROUPS{ReadThreadAffinityGroups()};
+const unsigned int TXN_POOL_MEMORY_LIMIT_IN_MB{
+    ReadConstantNumeric("TXN_POOL_MEMORY_LIMIT_IN_MB", "node.transactions.")};
+const unsigned int STATE_TRIE_UPDATE_THREADS{
+    ReadConstantNumeric("STATE_TRIE_UPDATE_THREADS", "node.transactions.")};
+const bool ENABLE_PENDING_TXN_PERSISTENCE{ReadConstantString(
+    "ENABLE_PENDING_TXN_PERSISTENCE", "node.transactions.") == "true"};
+const unsigned int PENDING_TXN_COMPACTION_INTERVAL_IN_EPOCHS{
+    ReadConstantNumeric("PENDING_TXN_COMPACTION_INTERVAL_IN_EPOCHS",
+                        "node.transactions.")};
 const bool ENABLE_REPOPULATE{
     ReadConstantString("ENABLE_REPOPULATE", "node.transactions.") == "true"};
 const unsigned int REPOPULATE_STATE_PER_N_DS{
@@ -18,6 +18,9 @@
 #ifndef ZILLIQA_SRC_COMMON_CONSTANTS_H_
 #define ZILLIQA_SRC_COMMON_CONSTANTS_H_
 
+#include <map>
+#include <string>
+
 #include "depends/common/FixedHash.h"
 
 using BlockHash = dev::h256;
@@ -87,10 +90,22 @@ enum SyncType : unsigned int {
   RECOVERY_ALL_SYNC,
   NEW_LOOKUP_SYNC,
   GUARD_DS_SYNC,
-  DB_VERIF,  // Deprecated
+  DB_VERIF,    // Deprecated
+  LIGHT_SYNC,  // DS and tx block headers only, for non-validating observers
   SYNC_TYPE_COUNT
 };
 
+// LevelDB tuning of one database, see leveldb_profiles in constants.xml
+struct LevelDBProfile {
+  unsigned int m_bloomBitsPerKey{0};
+  unsigned int m_blockSizeInKB{4};
+  bool m_compression{true};
+  /// 0 for the block cache shared by all the databases
+  unsigned int m_blockCacheSizeInMB{0};
+  /// Raw hash and big-endian block number keys instead of hex and decimal
+  bool m_binaryKeys{false};
+};
+
 namespace Contract {
 using VName = std::string;
 using Mutable = bool;
@@ -109,6 +124,7 @@ const std::string RAND2_GENESIS =
 
 const std::string REMOTE_TEST_DIR = "zilliqa-test";
 const std::string PERSISTENCE_PATH = "/persistence";
+const std::string CHECKPOINT_PATH = "/checkpoints";
 const std::string STATEDELTAFROMS3_PATH = "/StateDeltaFromS3";
 const std::string TX_BODY_SUBDIR = "txBodies";
 
@@ -118,6 +134,10 @@ const std::string DS_BACKUP_MSG = "DS BACKUP NOW";
 
 const std::string dsNodeFile = "dsnodes.xml";
 
+// Read by the daemon, which restarts the process from the persistence while
+// the file is fresh
+const std::string WARM_RESTART_FILE = "WARM_RESTART";
+
 const char SCILLA_INDEX_SEPARATOR = 0x16;
 
 const float ONE_HUNDRED_PERCENT = 100.f;
@@ -129,6 +149,10 @@ extern const unsigned int DEBUG_LEVEL;
 extern const bool ENABLE_DO_REJOIN;
 extern const bool LOOKUP_NODE_MODE;
 extern const unsigned int MAX_ENTRIES_FOR_DIAGNOSTIC_DATA;
+extern const unsigned int DETACHED_IDLE_THREADS;
+extern const unsigned int DETACHED_IDLE_TIMEOUT_IN_SECONDS;
+extern const unsigned int DETACHED_PERSISTENCE_THREADS;
+extern const unsigned int LOG_ASYNC_BUFFER_SIZE;
 extern const uint16_t CHAIN_ID;
 extern const std::string GENESIS_PUBKEY;
 extern const unsigned int UPGRADE_TARGET_DS_NUM;
@@ -152,6 +176,12 @@ extern const unsigned int CONTRACT_STATE_VERSION;
 extern const bool ARCHIVAL_LOOKUP;
 extern const unsigned int SEED_TXN_COLLECTION_TIME_IN_SEC;
 extern const unsigned int TXN_STORAGE_LIMIT;
+extern const unsigned int TXN_STORAGE_MEMORY_LIMIT_IN_MB;
+extern const unsigned int SEED_RESPONSE_CACHE_SIZE_IN_MB;
+extern const bool SEED_SUBSCRIBE_TO_LOOKUP;
+extern const unsigned int SEED_SUBSCRIPTION_TTL_IN_SEC;
+extern const unsigned int LOOKUP_MAX_SEED_SUBSCRIBERS;
+extern const unsigned int STATE_EXPORT_CHUNK_ACCOUNTS;
 
 // Consensus constants
 extern const unsigned int COMMIT_WINDOW_IN_SECONDS;
@@ -160,6 +190,11 @@ extern const unsigned int CONSENSUS_OBJECT_TIMEOUT;
 extern const unsigned int DS_NUM_CONSENSUS_SUBSETS;
 extern const unsigned int SHARD_NUM_CONSENSUS_SUBSETS;
 extern const unsigned int COMMIT_TOLERANCE_PERCENT;
+extern const unsigned int COMMIT_POOL_SIZE;
+extern const bool ENABLE_FINALBLOCK_PREDISTRIBUTION;
+extern const unsigned int FINALBLOCK_PROPOSAL_WAIT_IN_MS;
+extern const unsigned int VERIFIED_COSIG_CACHE_SIZE;
+extern const unsigned int MICROBLOCK_VERIFY_THREADS;
 
 // Data sharing constants
 extern const bool BROADCAST_TREEBASED_CLUSTER_MODE;
@@ -167,9 +202,12 @@ extern const unsigned int MULTICAST_CLUSTER_SIZE;
 extern const unsigned int NUM_FORWARDED_BLOCK_RECEIVERS_PER_SHARD;
 extern const unsigned int NUM_NODES_TO_SEND_LOOKUP;
 extern const unsigned int NUM_OF_TREEBASED_CHILD_CLUSTERS;
+extern const unsigned int BROADCAST_REGION_PREFIX_BITS;
 extern const unsigned int POW_PACKET_SENDERS;
 extern const unsigned int TX_SHARING_CLUSTER_SIZE;
 extern const unsigned int NUM_SHARE_PENDING_TXNS;
+extern const bool COMPACT_MBNFORWARD_RELAY;
+extern const unsigned int COMPACT_RELAY_TXN_CACHE_SIZE_IN_MB;
 
 // Dispatcher constants
 extern const bool USE_REMOTE_TXN_CREATOR;
@@ -180,11 +218,15 @@ extern const unsigned int DELAY_FIRSTXNEPOCH_IN_MS;
 extern const unsigned int FETCHING_MISSING_DATA_TIMEOUT;
 extern const unsigned int ANNOUNCEMENT_DELAY_IN_MS;
 extern const unsigned int LOOKUP_DELAY_SEND_TXNPACKET_IN_MS;
+extern const unsigned int LOOKUP_TXN_STREAM_INTERVAL_IN_MS;
+extern const unsigned int LOOKUP_TXN_PACKET_SIZE;
 extern const unsigned int MICROBLOCK_TIMEOUT;
 extern const unsigned int NEW_NODE_SYNC_INTERVAL;
 extern const unsigned int POW_SUBMISSION_TIMEOUT;
 extern const unsigned int POW_WINDOW_IN_SECONDS;
 extern const unsigned int POWPACKETSUBMISSION_WINDOW_IN_SECONDS;
+extern const unsigned int POW_EARLY_CLOSE_PERCENT;
+extern const unsigned int POW_EARLY_CLOSE_IDLE_IN_SECONDS;
 extern const unsigned int RECOVERY_SYNC_TIMEOUT;
 extern const unsigned int TX_DISTRIBUTE_TIME_IN_MS;
 extern const unsigned int NEW_LOOKUP_SYNC_DELAY_IN_SECONDS;
@@ -192,6 +234,12 @@ extern const unsigned int GETSHARD_TIMEOUT_IN_SECONDS;
 extern const unsigned int GETSTATEDELTAS_TIMEOUT_IN_SECONDS;
 extern const unsigned int RETRY_REJOINING_TIMEOUT;
 extern const unsigned int RETRY_GETSTATEDELTAS_COUNT;
+extern const unsigned int TXBLOCK_DOWNLOAD_MAX_CHUNKS;
+extern const unsigned int TXBLOCK_DOWNLOAD_CHUNK_SIZE;
+extern const unsigned int TXBLOCK_DOWNLOAD_TIMEOUT_IN_SECONDS;
+extern const unsigned int TXBLOCK_DOWNLOAD_RETRY_COUNT;
+extern const unsigned int STATEDELTA_FETCH_WINDOW;
+extern const unsigned int STATEDELTA_FETCH_IN_FLIGHT;
 extern const unsigned int MAX_FETCHMISSINGMBS_NUM;
 extern const unsigned int LAST_N_TXBLKS_TOCHECK_FOR_MISSINGMBS;
 extern const unsigned int REMOVENODEFROMBLACKLIST_DELAY_IN_SECONDS;
@@ -236,9 +284,18 @@ extern const unsigned int SIMULATED_NETWORK_DELAY_IN_MS;
 extern const unsigned int KEEP_RAWMSG_FROM_LAST_N_ROUNDS;
 extern const bool SIGN_VERIFY_EMPTY_MSGTYP;
 extern const bool SIGN_VERIFY_NONEMPTY_MSGTYP;
+extern const bool ENABLE_RUMOR_BATCHING;
+extern const unsigned int MAX_RUMOR_BATCH_SIZE_IN_BYTES;
+extern const bool ENABLE_GOSSIP_BATCH_VERIFY;
+extern const unsigned int GOSSIP_VERIFY_NUM_THREADS;
+extern const unsigned int GOSSIP_VERIFY_BATCH_SIZE;
+extern const unsigned int GOSSIP_VERIFY_WINDOW_IN_MS;
 
 // GPU mining constants
 extern const std::string GPU_TO_USE;
+extern const std::string OPENCL_GPU_TO_USE;
+extern const std::string CUDA_GPU_TO_USE;
+extern const unsigned int GPU_NONCE_RANGE_IN_MS;
 extern const unsigned int OPENCL_LOCAL_WORK_SIZE;
 extern const unsigned int OPENCL_GLOBAL_WORK_SIZE_MULTIPLIER;
 extern const unsigned int OPENCL_START_EPOCH;
@@ -263,6 +320,21 @@ extern const unsigned int STATUS_RPC_PORT;
 extern const std::string IP_TO_BIND;  // Only for non-lookup nodes
 extern const bool ENABLE_STATUS_RPC;  //
 extern const unsigned int NUM_SHARD_PEER_TO_REVEAL;
+extern const unsigned int CONTRACT_STATE_PAGE_SIZE_MAX;
+extern const unsigned int TXN_HISTORY_PAGE_SIZE_MAX;
+extern const unsigned int TXBLOCK_RANGE_SIZE_MAX;
+extern const unsigned int TXBLOCK_RANGE_RESPONSE_BYTES_MAX;
+extern const unsigned int EVENT_LOG_RANGE_SIZE_MAX;
+extern const unsigned int LOOKUP_RESPONSE_CACHE_SIZE;
+extern const unsigned int LOOKUP_RPC_THREADS;
+extern const unsigned int LOOKUP_RPC_CONNECTION_TIMEOUT_IN_SECONDS;
+extern const double CREATE_TXN_RATE_PER_CLIENT;
+extern const unsigned int CREATE_TXN_BURST_PER_CLIENT;
+extern const double CREATE_TXN_RATE_PER_SENDER;
+extern const unsigned int CREATE_TXN_BURST_PER_SENDER;
+extern const bool ENABLE_PROTO_RPC;
+extern const unsigned int PROTO_RPC_PORT;
+extern const unsigned int PROTO_RPC_MAX_CONNECTIONS;
 extern const std::string SCILLA_IPC_SOCKET_PATH;
 extern bool ENABLE_WEBSOCKET;
 extern const unsigned int WEBSOCKET_PORT;
@@ -278,34 +350,57 @@ extern const unsigned int SHARD_SIZE_TOLERANCE_HI;
 // P2PComm constants
 extern const unsigned int BROADCAST_INTERVAL;
 extern const unsigned int BROADCAST_EXPIRY;
+extern const unsigned int P2P_RECEIVE_THREADS;
 extern const unsigned int FETCH_LOOKUP_MSG_MAX_RETRY;
 extern const uint32_t MAXMESSAGE;
 extern const unsigned int MAXRETRYCONN;
 extern const unsigned int MSGQUEUE_SIZE;
 extern const unsigned int PUMPMESSAGE_MILLISECONDS;
 extern const unsigned int SENDQUEUE_SIZE;
+extern const unsigned int SEND_COALESCE_MAX_BYTES;
+extern const bool ENABLE_ASYNC_SEND;
+extern const unsigned int ASYNC_SEND_MIN_BYTES;
+extern const unsigned int EGRESS_BULK_RATE_IN_BYTES_PER_SEC;
+extern const unsigned int EGRESS_BULK_BURST_IN_BYTES;
+extern const unsigned int PEER_HEALTH_FAILURE_THRESHOLD;
+extern const unsigned int PEER_HEALTH_MIN_BACKOFF_IN_MS;
+extern const unsigned int PEER_HEALTH_MAX_BACKOFF_IN_MS;
 extern const unsigned int MAX_GOSSIP_MSG_SIZE_IN_BYTES;
 extern const unsigned int MIN_READ_WATERMARK_IN_BYTES;
 extern const unsigned int MAX_READ_WATERMARK_IN_BYTES;
 extern const unsigned int BLACKLIST_NUM_TO_POP;
 extern const unsigned int MAX_PEER_CONNECTION;
 extern const unsigned int MAX_WHITELISTREQ_LIMIT;
+extern const bool ENABLE_CONNECTION_POOL;
+extern const unsigned int CONNECTION_POOL_MAX_PER_PEER;
+extern const unsigned int CONNECTION_POOL_IDLE_TIMEOUT;
+extern const unsigned int CONNECTION_POOL_WAIT_MILLISECONDS;
+extern const bool ENABLE_MESSAGE_COMPRESSION;
+extern const unsigned int MESSAGE_COMPRESSION_THRESHOLD_IN_BYTES;
+extern const unsigned int MESSAGE_COMPRESSION_MIN_SAVING_PERCENT;
 
 // PoW constants
 extern const bool CUDA_GPU_MINE;
 extern const bool FULL_DATASET_MINE;
+extern const std::string DAG_STORE_DIR;
+extern const unsigned int CPU_MINE_THREADS;
+extern const bool CPU_MINE_PIN_THREADS;
 extern const bool OPENCL_GPU_MINE;
 extern const bool REMOTE_MINE;
 extern const std::string MINING_PROXY_URL;
 extern const unsigned int MAX_RETRY_SEND_POW_TIME;
 extern const unsigned int CHECK_MINING_RESULT_INTERVAL;
+extern const unsigned int REMOTE_MINE_PUSH_PORT;
 extern const bool GETWORK_SERVER_MINE;
 extern const unsigned int GETWORK_SERVER_PORT;
+extern const unsigned int GETWORK_LONG_POLL_TIMEOUT;
+extern const unsigned int GETWORK_STRATUM_PORT;
 extern const unsigned int DS_POW_DIFFICULTY;
 extern const unsigned int POW_DIFFICULTY;
 extern const unsigned int POW_BOUNDARY_N_DIVIDED;
 extern const unsigned int POW_BOUNDARY_N_DIVIDED_START;
 extern const unsigned int POW_SUBMISSION_LIMIT;
+extern const unsigned int POW_VERIFY_THREADS;
 extern const unsigned int NUM_FINAL_BLOCK_PER_POW;
 extern const unsigned int POW_CHANGE_TO_ADJ_DIFF;
 extern const unsigned int POW_CHANGE_TO_ADJ_DS_DIFF;
@@ -328,6 +423,9 @@ extern const unsigned int TERMINATION_COUNTDOWN_IN_SECONDS;
 extern const std::string UPGRADE_HOST_ACCOUNT;
 extern const std::string UPGRADE_HOST_REPO;
 extern const bool RECOVERY_TRIM_INCOMPLETED_BLOCK;
+extern const unsigned int RETRIEVER_THREADS;
+extern const unsigned int SNAPSHOT_THREADS;
+extern const unsigned int SNAPSHOT_CHUNK_SIZE_IN_MB;
 extern const bool REJOIN_NODE_NOT_IN_NETWORK;
 extern const unsigned int RESUME_BLACKLIST_DELAY_IN_SECONDS;
 extern const unsigned int INCRDB_DSNUMS_WITH_STATEDELTAS;
@@ -350,9 +448,23 @@ extern const std::string INPUT_CODE;
 extern const bool ENABLE_SCILLA_MULTI_VERSION;
 extern const std::string FIELDS_MAP_DEPTH_INDICATOR;
 extern const bool LOG_SC;
+extern const bool CONTRACT_STATE_HASH_TREE;
+extern const bool ENABLE_SCILLA_SERVER;
+extern const std::string SCILLA_SERVER_BINARY;
+extern const std::string SCILLA_SERVER_SOCKET_PATH;
+extern const unsigned int SCILLA_SERVER_POOL_SIZE;
+extern const bool SCILLA_MEM_FILES;
+extern const bool SCILLA_CHECKER_CACHE;
 
 // Test constants
 extern const bool ENABLE_CHECK_PERFORMANCE_LOG;
+extern const bool ENABLE_MESSAGE_STATS;
+extern const bool ENABLE_MEMORY_STATS;
+extern const bool ENABLE_TRAFFIC_STATS;
+extern const bool ENABLE_CONSENSUS_TRACE;
+extern const bool ENABLE_EPOCH_PERF;
+extern const unsigned int PROFILER_SAMPLES_PER_SECOND;
+extern const unsigned int PROFILER_MAX_WINDOW_IN_SECONDS;
 #ifdef FALLBACK_TEST
 extern const unsigned int FALLBACK_TEST_EPOCH;
 #endif  // FALLBACK_TEST
@@ -362,6 +474,7 @@ extern const bool UPDATE_PREGENED_ACCOUNTS;
 extern const unsigned int NUM_ACCOUNTS_PREGENERATE;
 extern const unsigned int PREGEN_ACCOUNT_TIMES;
 extern const std::string PREGENED_ACCOUNTS_FILE;
+extern const std::string GENESIS_ACCOUNTS_FILE;
 
 // Transaction constants
 extern const uint128_t TOTAL_COINBASE_REWARD;
@@ -375,10 +488,40 @@ extern const unsigned int SCILLA_CHECKER_INVOKE_GAS;
 extern const unsigned int SCILLA_RUNNER_INVOKE_GAS;
 extern const unsigned int SYS_TIMESTAMP_VARIANCE_IN_SECONDS;
 extern const unsigned int TXN_MISORDER_TOLERANCE_IN_PERCENT;
+extern const bool BINARY_TXN_RECEIPTS;
+extern const bool SPECULATIVE_TXN_PROCESSING;
+extern const unsigned int TXN_EXECUTION_THREADS;
+extern const bool DS_PARALLEL_CONTRACT_CALLS;
+extern const unsigned int TXN_VERIFY_THREADS;
+extern const bool LOOKUP_TXN_PACKET_ATTESTATION;
 extern const unsigned int PACKET_EPOCH_LATE_ALLOW;
 extern const unsigned int PACKET_BYTESIZE_LIMIT;
 extern const unsigned int SMALL_TXN_SIZE;
 extern const unsigned int ACCOUNT_IO_BATCH_SIZE;
+extern const unsigned int ACCOUNT_READ_VIEW_SIZE;
+extern const unsigned int LOOKUP_NONCE_GAP_LIMIT;
+extern const unsigned int STATE_TRIE_NODE_CACHE_SIZE_IN_MB;
+extern const unsigned int LEVELDB_BLOCK_CACHE_SIZE_IN_MB;
+extern const unsigned int LEVELDB_WRITE_BUFFER_SIZE_IN_MB;
+extern const unsigned int LEVELDB_MAX_OPEN_FILES;
+extern const unsigned int LEVELDB_KEY_MIGRATION_BATCH_SIZE;
+extern const unsigned int BLOCKSTORAGE_CACHE_SIZE_IN_MB;
+extern const unsigned int CONTRACT_CODE_CACHE_SIZE_IN_MB;
+extern const unsigned int BLOCKCHAIN_OLDER_BLOCKS_SIZE;
+extern const unsigned int TX_BODY_WRITE_QUEUE_SIZE;
+extern const unsigned int TX_BODY_RETENTION_DS_EPOCHS;
+extern const bool ENABLE_TXN_HISTORY_INDEX;
+extern const bool ENABLE_EVENT_BLOOM_INDEX;
+extern const unsigned int COSIGS_REWARDS_MAX_BLOCKS_PER_REQUEST;
+extern const unsigned int CHECKPOINT_INTERVAL_IN_EPOCHS;
+extern const unsigned int CHECKPOINT_KEEP_COUNT;
+extern const std::map<std::string, LevelDBProfile> LEVELDB_PROFILES;
+extern const std::map<std::string, unsigned int> LOOKUP_RPC_METHOD_LIMITS;
+extern const std::map<std::string, std::string> THREAD_AFFINITY_GROUPS;
+extern const unsigned int TXN_POOL_MEMORY_LIMIT_IN_MB;
+extern const unsigned int STATE_TRIE_UPDATE_THREADS;
+extern const bool ENABLE_PENDING_TXN_PERSISTENCE;
+extern const unsigned int PENDING_TXN_COMPACTION_INTERVAL_IN_EPOCHS;
 extern const bool ENABLE_REPOPULATE;
 extern const unsigned int REPOPULATE_STATE_PER_N_DS;
 extern const unsigned int REPOPULATE_STATE_IN_DS;
@@ -87,9 +87,11 @@ static const std::string LookupInstructionStrings[]{
     MAKE_LITERAL_STRING(VCGETLATESTDSTXBLOCK),
     MAKE_LITERAL_STRING(FORWARDTXN),
     MAKE_LITERAL_STRING(GETGUARDNODENETWORKINFOUPDATE),
-    MAKE_LITERAL_STRING(SETHISTORICALDB)};
+    MAKE_LITERAL_STRING(SETHISTORICALDB),
+    MAKE_LITERAL_STRING(GETCOSIGSREWARDSFROMSEED),
+    MAKE_LITERAL_STRING(SUBSCRIBESEED)};
 
-static_assert(ARRAY_SIZE(LookupInstructionStrings) == SETHISTORICALDB + 1,
+static_assert(ARRAY_SIZE(LookupInstructionStrings) == SUBSCRIBESEED + 1,
               "LookupInstructionStrings definition is not correct");
 
 static const std::string *MessageTypeInstructionStrings[]{
@@ -42,6 +42,7 @@ enum DSInstructionType : unsigned char {
   POWPACKETSUBMISSION = 0x07,
   NEWDSGUARDIDENTITY = 0x08,
   SETCOSIGSREWARDSFROMSEED = 0x09,
+  FINALBLOCKPROPOSAL = 0x0A,
 };
 
 enum NodeInstructionType : unsigned char {
@@ -94,7 +95,8 @@ enum LookupInstructionType : unsigned char {
   FORWARDTXN = 0x1C,
   GETGUARDNODENETWORKINFOUPDATE = 0x1D,
   SETHISTORICALDB = 0x1E,
-  GETCOSIGSREWARDSFROMSEED = 0x1F
+  GETCOSIGSREWARDSFROMSEED = 0x1F,
+  SUBSCRIBESEED = 0x20
 };
 
 enum TxSharingMode : unsigned char {
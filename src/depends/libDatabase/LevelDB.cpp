@@ -15,9 +15,16 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include <boost/filesystem.hpp>
+#include <leveldb/cache.h>
+#include <leveldb/filter_policy.h>
 
 #include "LevelDB.h"
 #include "common/Constants.h"
@@ -27,6 +34,112 @@
 
 using namespace std;
 
+namespace
+{
+/// Written in the directory of a database once all its keys are binary, as
+/// older versions cannot read such a database
+const string KEY_FORMAT_FILE = "KEYFORMAT";
+const string BINARY_KEY_FORMAT_VERSION = "1";
+
+/// Times Checkpoint starts over when a compaction changes the files under it
+const unsigned int CHECKPOINT_ATTEMPTS = 5;
+
+/// Table files are never modified once written
+bool IsTableFile(const string & name)
+{
+    const auto dot = name.rfind('.');
+    return dot != string::npos && (name.substr(dot) == ".ldb" || name.substr(dot) == ".sst");
+}
+
+bool IsHexKey(const leveldb::Slice & key)
+{
+    if (key.size() != 64)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < key.size(); i++)
+    {
+        if (!isxdigit(static_cast<unsigned char>(key.data()[i])))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Decimal block numbers fit in 20 digits, so that a binary hash never
+/// passes as one, nor does a binary number below 0x3030303030303030
+bool IsDecimalKey(const leveldb::Slice & key)
+{
+    if (key.empty() || key.size() > 20)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < key.size(); i++)
+    {
+        if (!isdigit(static_cast<unsigned char>(key.data()[i])))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+leveldb::Options LevelDB::GetOpenOptions(const string& dbName)
+{
+    // One block cache for all the databases, so that their memory is bounded
+    // by the data being read rather than by how many databases there are
+    static const shared_ptr<leveldb::Cache> sharedCache(
+        LEVELDB_BLOCK_CACHE_SIZE_IN_MB > 0
+            ? leveldb::NewLRUCache(static_cast<size_t>(LEVELDB_BLOCK_CACHE_SIZE_IN_MB) * 1024 * 1024)
+            : nullptr);
+
+    leveldb::Options options;
+    options.max_open_files = LEVELDB_MAX_OPEN_FILES;
+    options.write_buffer_size = static_cast<size_t>(LEVELDB_WRITE_BUFFER_SIZE_IN_MB) * 1024 * 1024;
+    options.block_cache = sharedCache.get();
+    options.create_if_missing = true;
+
+    auto it = LEVELDB_PROFILES.find(dbName);
+    if (it == LEVELDB_PROFILES.end())
+    {
+        return options;
+    }
+    const LevelDBProfile& profile = it->second;
+    options.block_size = static_cast<size_t>(profile.m_blockSizeInKB) * 1024;
+    options.compression = profile.m_compression ? leveldb::kSnappyCompression : leveldb::kNoCompression;
+
+    // The filter policy and cache of a profile have to outlive every database
+    // opened with them, including reopened ones
+    struct ProfileResources
+    {
+        unique_ptr<leveldb::Cache> m_cache;
+        unique_ptr<const leveldb::FilterPolicy> m_filterPolicy;
+    };
+    static mutex mutexResources;
+    static map<string, ProfileResources> resources;
+
+    lock_guard<mutex> g(mutexResources);
+    auto& res = resources[dbName];
+    if (profile.m_bloomBitsPerKey > 0)
+    {
+        if (!res.m_filterPolicy)
+        {
+            res.m_filterPolicy.reset(leveldb::NewBloomFilterPolicy(profile.m_bloomBitsPerKey));
+        }
+        options.filter_policy = res.m_filterPolicy.get();
+    }
+    if (profile.m_blockCacheSizeInMB > 0)
+    {
+        if (!res.m_cache)
+        {
+            res.m_cache.reset(leveldb::NewLRUCache(static_cast<size_t>(profile.m_blockCacheSizeInMB) * 1024 * 1024));
+        }
+        options.block_cache = res.m_cache.get();
+    }
+    return options;
+}
 
 LevelDB::LevelDB(const string& dbName, const string& path, const string& subdirectory)
 {
@@ -40,17 +153,14 @@ LevelDB::LevelDB(const string& dbName, const string& path, const string& subdire
         return;
     }
 
-    leveldb::Options options;
-    options.max_open_files = 256;
-    options.create_if_missing = true;
+    leveldb::Options options = GetOpenOptions(this->m_dbName);
 
     leveldb::DB* db;
     leveldb::Status status;
 
     if(m_subdirectory.empty())
     {
-        status = leveldb::DB::Open(options, path + "/" + this->m_dbName, &db);
-        LOG_GENERAL(INFO, path + "/" + this->m_dbName);
+        m_dbPath = path + "/" + this->m_dbName;
     }
     else
     {
@@ -58,18 +168,19 @@ LevelDB::LevelDB(const string& dbName, const string& path, const string& subdire
         {
             boost::filesystem::create_directories(path + "/" + this->m_subdirectory);
         }
-        status = leveldb::DB::Open(options, 
-            path + "/" + this->m_subdirectory + "/" + this->m_dbName,
-            &db);
-        LOG_GENERAL(INFO, path + "/" + this->m_subdirectory + "/" + this->m_dbName);
+        m_dbPath = path + "/" + this->m_subdirectory + "/" + this->m_dbName;
     }
+    status = leveldb::DB::Open(options, m_dbPath, &db);
+    LOG_GENERAL(INFO, m_dbPath);
 
     if(!status.ok())
     {
         LOG_GENERAL(WARNING, "LevelDB status is not OK. "<<status.ToString());
+        return;
     }
 
     m_db.reset(db);
+    InitKeyFormat();
 }
 
 LevelDB::LevelDB(const std::string & dbName, const std::string& subdirectory, bool diagnostic)
@@ -77,9 +188,7 @@ LevelDB::LevelDB(const std::string & dbName, const std::string& subdirectory, bo
     this->m_subdirectory = subdirectory;
     this->m_dbName = dbName;
 
-    leveldb::Options options;
-    options.max_open_files = 256;
-    options.create_if_missing = true;
+    leveldb::Options options = GetOpenOptions(this->m_dbName);
 
     leveldb::DB* db;
     leveldb::Status status;
@@ -94,7 +203,8 @@ LevelDB::LevelDB(const std::string & dbName, const std::string& subdirectory, bo
         boost::filesystem::create_directories(db_path);
     }
 
-    status = leveldb::DB::Open(options, db_path + "/" + this->m_dbName, &db);
+    m_dbPath = db_path + "/" + this->m_dbName;
+    status = leveldb::DB::Open(options, m_dbPath, &db);
     if(!status.ok())
     {
         // throw exception();
@@ -102,6 +212,39 @@ LevelDB::LevelDB(const std::string & dbName, const std::string& subdirectory, bo
     }
 
     m_db.reset(db);
+    InitKeyFormat();
+}
+
+void LevelDB::InitKeyFormat()
+{
+    m_keyFormat = HEX_KEYS;
+
+    auto profile = LEVELDB_PROFILES.find(m_dbName);
+    if (!m_db || profile == LEVELDB_PROFILES.end() || !profile->second.m_binaryKeys)
+    {
+        return;
+    }
+
+    const string keyFormatFile = m_dbPath + "/" + KEY_FORMAT_FILE;
+    string version;
+    ifstream(keyFormatFile) >> version;
+    if (version == BINARY_KEY_FORMAT_VERSION)
+    {
+        m_keyFormat = BINARY_KEYS;
+        return;
+    }
+
+    unique_ptr<leveldb::Iterator> it(m_db->NewIterator(leveldb::ReadOptions()));
+    it->SeekToFirst();
+    if (it->Valid())
+    {
+        LOG_GENERAL(INFO, m_dbName << " has hex keys to migrate");
+        m_keyFormat = MIGRATING_KEYS;
+        return;
+    }
+
+    ofstream(keyFormatFile) << BINARY_KEY_FORMAT_VERSION;
+    m_keyFormat = BINARY_KEYS;
 }
 
 leveldb::Slice toSlice(boost::multiprecision::uint256_t num)
@@ -124,6 +267,92 @@ string LevelDB::GetDBName()
         }
 }
 
+bool LevelDB::Checkpoint(const string & persistencePath) const
+{
+    namespace fs = boost::filesystem;
+
+    if (!m_db)
+    {
+        return false;
+    }
+
+    const fs::path dstPath = fs::path(persistencePath) / m_subdirectory / m_dbName;
+
+    // The manifest, logs and CURRENT are copied before the tables are listed,
+    // so that every table the copied manifest refers to is linked unless a
+    // compaction deletes it meanwhile. Opening the copy finds that, and the
+    // checkpoint is then made again.
+    for (unsigned int attempt = 0; attempt < CHECKPOINT_ATTEMPTS; attempt++)
+    {
+        boost::system::error_code ec;
+        fs::remove_all(dstPath, ec);
+        fs::create_directories(dstPath, ec);
+        if (ec)
+        {
+            LOG_GENERAL(WARNING, "Failed to create " << dstPath.string() << " error: " << ec.message());
+            return false;
+        }
+
+        for (fs::directory_iterator it(m_dbPath, ec), end; !ec && it != end; it.increment(ec))
+        {
+            const string name = it->path().filename().string();
+            if (name == "LOCK" || name == "LOG" || name == "LOG.old" || IsTableFile(name))
+            {
+                continue;
+            }
+            fs::copy_file(it->path(), dstPath / name, ec);
+        }
+        if (ec)
+        {
+            LOG_GENERAL(INFO, "Checkpoint of " << m_dbName << " attempt " << attempt << " error: " << ec.message());
+            continue;
+        }
+
+        for (fs::directory_iterator it(m_dbPath, ec), end; !ec && it != end; it.increment(ec))
+        {
+            const string name = it->path().filename().string();
+            if (!IsTableFile(name))
+            {
+                continue;
+            }
+            fs::create_hard_link(it->path(), dstPath / name, ec);
+            if (ec == boost::system::errc::no_such_file_or_directory)
+            {
+                // Compacted away, the open below tells if it was needed
+                ec.clear();
+            }
+            else if (ec)
+            {
+                // Linking fails across file systems
+                ec.clear();
+                fs::copy_file(it->path(), dstPath / name, ec);
+            }
+        }
+
+        if (ec)
+        {
+            LOG_GENERAL(INFO, "Checkpoint of " << m_dbName << " attempt " << attempt << " error: " << ec.message());
+            continue;
+        }
+
+        leveldb::Options options = GetOpenOptions(m_dbName);
+        options.create_if_missing = false;
+        leveldb::DB* db = nullptr;
+        const leveldb::Status status = leveldb::DB::Open(options, dstPath.string(), &db);
+        delete db;
+        if (status.ok())
+        {
+            return true;
+        }
+        LOG_GENERAL(INFO, "Checkpoint of " << m_dbName << " attempt " << attempt << " does not open: " << status.ToString());
+    }
+
+    LOG_GENERAL(WARNING, "Failed to checkpoint " << m_dbName);
+    boost::system::error_code ec;
+    fs::remove_all(dstPath, ec);
+    return false;
+}
+
 string LevelDB::Lookup(const std::string & key) const
 {
     string value;
@@ -137,12 +366,72 @@ string LevelDB::Lookup(const std::string & key) const
     return value;
 }
 
+string LevelDB::HexKey(const dev::h256 & key)
+{
+    return key.hex();
+}
+
+string LevelDB::HexKey(const boost::multiprecision::uint256_t & blockNum)
+{
+    return blockNum.convert_to<string>();
+}
+
+string LevelDB::BinaryKey(const dev::h256 & key)
+{
+    return string(reinterpret_cast<const char*>(key.data()), key.size);
+}
+
+string LevelDB::BinaryKey(const boost::multiprecision::uint256_t & blockNum)
+{
+    // Fixed width and big-endian, so that keys sort as the block numbers do
+    string key(sizeof(uint64_t), '\0');
+    dev::toBigEndian(blockNum.convert_to<uint64_t>(), key);
+    return key;
+}
+
+template <typename Key>
+string LevelDB::GetKey(const Key & key) const
+{
+    return m_keyFormat == HEX_KEYS ? HexKey(key) : BinaryKey(key);
+}
+
+template <typename Key>
+bool LevelDB::Get(const Key & key, string & value) const
+{
+    if (m_keyFormat != MIGRATING_KEYS)
+    {
+        return m_db->Get(leveldb::ReadOptions(), GetKey(key), &value).ok();
+    }
+
+    shared_lock<shared_timed_mutex> g(m_mutexKeyMigration);
+    return m_db->Get(leveldb::ReadOptions(), BinaryKey(key), &value).ok() ||
+           m_db->Get(leveldb::ReadOptions(), HexKey(key), &value).ok();
+}
+
+template <typename Key>
+int LevelDB::Put(const Key & key, const leveldb::Slice & value)
+{
+    leveldb::WriteBatch batch;
+    BatchPut(batch, key, value);
+    return Write(batch) ? 0 : -1;
+}
+
+template <typename Key>
+int LevelDB::Delete(const Key & key)
+{
+    leveldb::WriteBatch batch;
+    batch.Delete(GetKey(key));
+    if (m_keyFormat == MIGRATING_KEYS)
+    {
+        batch.Delete(HexKey(key));
+    }
+    return Write(batch) ? 0 : -1;
+}
+
 string LevelDB::Lookup(const boost::multiprecision::uint256_t & blockNum) const
 {
     string value;
-    leveldb::Status s = m_db->Get(leveldb::ReadOptions(), blockNum.convert_to<string>(), &value);
-
-    if (!s.ok())
+    if (!Get(blockNum, value))
     {
         // TODO
         return "";
@@ -154,22 +443,18 @@ string LevelDB::Lookup(const boost::multiprecision::uint256_t & blockNum) const
 string LevelDB::Lookup(const boost::multiprecision::uint256_t & blockNum, bool &found) const
 {
     string value;
-    leveldb::Status s = m_db->Get(leveldb::ReadOptions(), blockNum.convert_to<string>(), &value);
-
-    if (!s.ok())
+    found = Get(blockNum, value);
+    if (!found)
     {
-        found = false;
         return "";
     }
-    found = true;
     return value;
 }
 
 string LevelDB::Lookup(const dev::h256 & key) const
 {
     string value;
-    leveldb::Status s = m_db->Get(leveldb::ReadOptions(), leveldb::Slice(key.hex()), &value);
-    if (!s.ok())
+    if (!Get(key, value))
     {
         // TODO
         return "";
@@ -205,32 +490,13 @@ int LevelDB::Insert(const dev::h256 & key, dev::bytesConstRef value)
 int LevelDB::Insert(const boost::multiprecision::uint256_t & blockNum,
                     const vector<unsigned char> & body)
 {
-    leveldb::Status s = m_db->Put(leveldb::WriteOptions(),
-                                  leveldb::Slice(blockNum.convert_to<string>()),
-                                  leveldb::Slice(vector_ref<const unsigned char>(&body[0],
-                                                                                 body.size())));
-
-    if (!s.ok())
-    {
-        return -1;
-    }
-
-    return 0;
+    return Put(blockNum, leveldb::Slice(vector_ref<const unsigned char>(&body[0], body.size())));
 }
 
 int LevelDB::Insert(const boost::multiprecision::uint256_t & blockNum,
                     const std::string & body)
 {
-    leveldb::Status s = m_db->Put(leveldb::WriteOptions(),
-                                  leveldb::Slice(blockNum.convert_to<string>()),
-                                  leveldb::Slice(body.c_str(), body.size()));
-
-    if (!s.ok())
-    {
-        return -1;
-    }
-
-    return 0;
+    return Put(blockNum, leveldb::Slice(body.c_str(), body.size()));
 }
 
 int LevelDB::Insert(const string & key, const vector<unsigned char> & body)
@@ -264,15 +530,7 @@ int LevelDB::Insert(const dev::h256 & key, const string & value)
 
 int LevelDB::Insert(const dev::h256 & key, const vector<unsigned char> & body)
 {
-    leveldb::Status s = m_db->Put(leveldb::WriteOptions(), leveldb::Slice(key.hex()),
-                                  leveldb::Slice(vector_ref<const unsigned char>(&body[0],
-                                                                                 body.size())));
-    if (!s.ok())
-    {
-        return -1;
-    }
-
-    return 0;
+    return Put(key, leveldb::Slice(vector_ref<const unsigned char>(&body[0], body.size())));
 }
 
 int LevelDB::Insert(const leveldb::Slice & key, const leveldb::Slice & value)
@@ -295,8 +553,8 @@ int LevelDB::BatchInsert(std::unordered_map<dev::h256, std::pair<std::string, un
     {
         if (i.second.second)
         {
-            batch.Put(leveldb::Slice(i.first.hex()),
-                      leveldb::Slice(i.second.first.data(), i.second.first.size()));
+            BatchPut(batch, i.first,
+                     leveldb::Slice(i.second.first.data(), i.second.first.size()));
         }
     }
 
@@ -310,9 +568,7 @@ int LevelDB::BatchInsert(std::unordered_map<dev::h256, std::pair<std::string, un
         }
     }
 
-    ldb::Status s = m_db->Write(leveldb::WriteOptions(), &batch);
-
-    if (!s.ok())
+    if (!Write(batch))
     {
         return -1;
     }
@@ -362,8 +618,18 @@ bool LevelDB::Exists(const std::string & key) const
 
 int LevelDB::DeleteKey(const dev::h256 & key)
 {
-    leveldb::Status s = m_db->Delete(leveldb::WriteOptions(), ldb::Slice(key.hex()));
-    if (!s.ok())
+    return Delete(key);
+}
+
+int LevelDB::DeleteKey(const boost::multiprecision::uint256_t & blockNum)
+{
+    return Delete(blockNum);
+}
+
+int LevelDB::DeleteKey(const std::string & key)
+{
+    leveldb::Status s = m_db->Delete(leveldb::WriteOptions(), ldb::Slice(key));
+    if(!s.ok())
     {
         return -1;
     }
@@ -371,26 +637,158 @@ int LevelDB::DeleteKey(const dev::h256 & key)
     return 0;
 }
 
-int LevelDB::DeleteKey(const boost::multiprecision::uint256_t & blockNum)
+void LevelDB::BatchPut(leveldb::WriteBatch & batch, const dev::h256 & key,
+                       const leveldb::Slice & value) const
 {
-    leveldb::Status s = m_db->Delete(leveldb::WriteOptions(), ldb::Slice(blockNum.convert_to<string>()));
-    if (!s.ok())
+    batch.Put(GetKey(key), value);
+    if (m_keyFormat == MIGRATING_KEYS)
     {
-        return -1;
+        batch.Delete(HexKey(key));
     }
+}
 
-    return 0;
+void LevelDB::BatchPut(leveldb::WriteBatch & batch,
+                       const boost::multiprecision::uint256_t & blockNum,
+                       const leveldb::Slice & value) const
+{
+    batch.Put(GetKey(blockNum), value);
+    if (m_keyFormat == MIGRATING_KEYS)
+    {
+        batch.Delete(HexKey(blockNum));
+    }
 }
 
-int LevelDB::DeleteKey(const std::string & key)
+bool LevelDB::Write(leveldb::WriteBatch & batch)
 {
-    leveldb::Status s = m_db->Delete(leveldb::WriteOptions(), ldb::Slice(key));
-    if(!s.ok())
+    if (m_keyFormat != MIGRATING_KEYS)
     {
-        return -1;
+        return m_db->Write(leveldb::WriteOptions(), &batch).ok();
     }
 
-    return 0;
+    shared_lock<shared_timed_mutex> g(m_mutexKeyMigration);
+    return m_db->Write(leveldb::WriteOptions(), &batch).ok();
+}
+
+bool LevelDB::DecodeKey(const leveldb::Slice & key, dev::h256 & hash)
+{
+    if (key.size() == dev::h256::size)
+    {
+        hash = dev::h256(dev::bytesConstRef(reinterpret_cast<const unsigned char*>(key.data()),
+                                            key.size()));
+        return true;
+    }
+    if (IsHexKey(key))
+    {
+        hash = dev::h256(key.ToString());
+        return true;
+    }
+    return false;
+}
+
+bool LevelDB::DecodeKey(const leveldb::Slice & key, uint64_t & blockNum)
+{
+    if (IsDecimalKey(key))
+    {
+        try
+        {
+            blockNum = stoull(key.ToString());
+            return true;
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+    if (key.size() == sizeof(uint64_t))
+    {
+        blockNum = dev::fromBigEndian<uint64_t>(key.ToString());
+        return true;
+    }
+    return false;
+}
+
+bool LevelDB::IsMigratingKeys() const
+{
+    return m_keyFormat == MIGRATING_KEYS;
+}
+
+bool LevelDB::IsBinaryKeys() const
+{
+    return m_keyFormat == BINARY_KEYS;
+}
+
+bool LevelDB::MigrateKeys()
+{
+    LOG_MARKER();
+
+    // No hex key is written while migrating, so that the ones after the last
+    // key rewritten are the only ones left
+    string nextKey;
+    uint64_t migrated = 0;
+
+    while (m_keyFormat == MIGRATING_KEYS)
+    {
+        unique_lock<shared_timed_mutex> g(m_mutexKeyMigration);
+        shared_ptr<leveldb::DB> db = m_db;
+
+        leveldb::WriteBatch batch;
+        unique_ptr<leveldb::Iterator> it(db->NewIterator(leveldb::ReadOptions()));
+        unsigned int scanned = 0;
+        for (it->Seek(nextKey); it->Valid() && scanned < LEVELDB_KEY_MIGRATION_BATCH_SIZE;
+             it->Next(), scanned++)
+        {
+            const leveldb::Slice key = it->key();
+            string binaryKey;
+            if (IsHexKey(key))
+            {
+                binaryKey = BinaryKey(dev::h256(key.ToString()));
+            }
+            else if (IsDecimalKey(key))
+            {
+                uint64_t blockNum = 0;
+                if (!DecodeKey(key, blockNum))
+                {
+                    continue;
+                }
+                binaryKey = BinaryKey(blockNum);
+            }
+            else
+            {
+                continue;
+            }
+
+            // A binary key written since the database was opened is newer
+            string value;
+            if (!db->Get(leveldb::ReadOptions(), binaryKey, &value).ok())
+            {
+                batch.Put(binaryKey, it->value());
+            }
+            batch.Delete(key);
+            migrated++;
+        }
+
+        const bool done = !it->Valid();
+        if (!done)
+        {
+            nextKey = it->key().ToString();
+        }
+        it.reset();
+
+        if (!db->Write(leveldb::WriteOptions(), &batch).ok())
+        {
+            LOG_GENERAL(WARNING, "Failed to migrate the keys of " << m_dbName);
+            return false;
+        }
+
+        if (done)
+        {
+            ofstream(m_dbPath + "/" + KEY_FORMAT_FILE) << BINARY_KEY_FORMAT_VERSION;
+            m_keyFormat = BINARY_KEYS;
+            LOG_GENERAL(INFO, "Migrated " << migrated << " keys of " << m_dbName);
+        }
+    }
+
+    return true;
 }
 
 int LevelDB::DeleteDB()
@@ -421,9 +819,7 @@ bool LevelDB::RefreshDB()
 {
     m_db.reset();
 
-    leveldb::Options options;
-    options.max_open_files = 256;
-    options.create_if_missing = true;
+    leveldb::Options options = GetOpenOptions(this->m_dbName);
 
     leveldb::DB* db;
 
@@ -436,6 +832,7 @@ bool LevelDB::RefreshDB()
     }
 
     m_db.reset(db);
+    InitKeyFormat();
     return true;
 }
 
@@ -465,9 +862,7 @@ bool LevelDB::ResetDBForNormalNode()
     {
         boost::filesystem::remove_all(STORAGE_PATH + PERSISTENCE_PATH + "/" + this->m_dbName);
 
-        leveldb::Options options;
-        options.max_open_files = 256;
-        options.create_if_missing = true;
+        leveldb::Options options = GetOpenOptions(this->m_dbName);
 
         leveldb::DB* db;
 
@@ -479,6 +874,7 @@ bool LevelDB::ResetDBForNormalNode()
         }
 
         m_db.reset(db);
+        InitKeyFormat();
         return true;
     }
     else if(this->m_subdirectory.size())
@@ -509,9 +905,7 @@ bool LevelDB::ResetDBForLookupNode()
     {
         boost::filesystem::remove_all(STORAGE_PATH + PERSISTENCE_PATH + "/" + this->m_dbName);
 
-        leveldb::Options options;
-        options.max_open_files = 256;
-        options.create_if_missing = true;
+        leveldb::Options options = GetOpenOptions(this->m_dbName);
 
         leveldb::DB* db;
 
@@ -523,6 +917,7 @@ bool LevelDB::ResetDBForLookupNode()
         }
 
         m_db.reset(db);
+        InitKeyFormat();
         return true;
     }
     return false;
@@ -19,12 +19,15 @@
 #ifndef __LEVELDB_H__
 #define __LEVELDB_H__
 
+#include <atomic>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include <leveldb/db.h>
+#include <leveldb/write_batch.h>
 
 #include "depends/common/Common.h"
 #include "depends/common/FixedHash.h"
@@ -41,6 +44,38 @@ class LevelDB
 
     std::shared_ptr<leveldb::DB> m_db;
 
+    /// Directory the database was opened in
+    std::string m_dbPath;
+
+    /// Format of the dev::h256 and block number keys: hex and decimal strings,
+    /// or raw hashes and 8-byte big-endian numbers if LEVELDB_PROFILES says so
+    enum KeyFormat : uint8_t
+    {
+        HEX_KEYS,
+        /// Binary keys are written, and the hex keys left are still read
+        /// until MigrateKeys has rewritten them all
+        MIGRATING_KEYS,
+        BINARY_KEYS
+    };
+    std::atomic<uint8_t> m_keyFormat{HEX_KEYS};
+
+    /// Held exclusively by each batch of MigrateKeys, and shared by lookups
+    /// and writes while keys are migrating
+    mutable std::shared_timed_mutex m_mutexKeyMigration;
+
+    /// Sets m_keyFormat for the just opened m_db
+    void InitKeyFormat();
+
+    static std::string HexKey(const dev::h256 & key);
+    static std::string HexKey(const boost::multiprecision::uint256_t & blockNum);
+    static std::string BinaryKey(const dev::h256 & key);
+    static std::string BinaryKey(const boost::multiprecision::uint256_t & blockNum);
+
+    template <typename Key> std::string GetKey(const Key & key) const;
+    template <typename Key> bool Get(const Key & key, std::string & value) const;
+    template <typename Key> int Put(const Key & key, const leveldb::Slice & value);
+    template <typename Key> int Delete(const Key & key);
+
 public:
 
     /// Constructor.
@@ -49,12 +84,21 @@ public:
     /// Destructor.
     ~LevelDB() = default;
 
+    /// Options the database dbName is opened with: one block cache shared by
+    /// all databases, tuned by its entry in LEVELDB_PROFILES if it has one
+    static leveldb::Options GetOpenOptions(const std::string& dbName);
+
     /// Returns the reference to the leveldb database instance.
     std::shared_ptr<leveldb::DB> GetDB();
 
     /// Returns the DB Name
     std::string GetDBName();
 
+    /// Writes a copy of the database under persistencePath, in the layout of
+    /// PERSISTENCE_PATH, that opens while this one stays in use. The tables
+    /// are hard-linked, so that the copy takes little time or space.
+    bool Checkpoint(const std::string & persistencePath) const;
+
     /// Returns the value at the specified key.
     std::string Lookup(const std::string & key) const;
 
@@ -116,6 +160,33 @@ public:
     /// Deletes the value at the specified key.
     int DeleteKey(const std::string & key);
 
+    /// Adds the write of value at key to batch, in the key format of this
+    /// database. The batch is to be applied with Write.
+    void BatchPut(leveldb::WriteBatch & batch, const dev::h256 & key,
+                  const leveldb::Slice & value) const;
+    void BatchPut(leveldb::WriteBatch & batch,
+                  const boost::multiprecision::uint256_t & blockNum,
+                  const leveldb::Slice & value) const;
+
+    /// Applies batch to the database.
+    bool Write(leveldb::WriteBatch & batch);
+
+    /// Parses a dev::h256 or block number key read through an iterator, in
+    /// either key format.
+    static bool DecodeKey(const leveldb::Slice & key, dev::h256 & hash);
+    static bool DecodeKey(const leveldb::Slice & key, uint64_t & blockNum);
+
+    /// Returns true if hex keys are left for MigrateKeys to rewrite.
+    bool IsMigratingKeys() const;
+
+    /// Returns true if all the keys are binary, so that an iterator visits
+    /// the block numbers in order.
+    bool IsBinaryKeys() const;
+
+    /// Rewrites the hex keys left in binary format, in batches so that the
+    /// database stays usable meanwhile. Returns once all of them are.
+    bool MigrateKeys();
+
     /// Deletes the entire database.
     int DeleteDB();
     int DeleteDBForNormalNode();
@@ -103,8 +103,9 @@ namespace dev
     bool MemoryDB::kill(h256 const& _h)
     {
 // #if DEV_GUARDED_DB
-        // ReadGuard l(x_this);
-        shared_lock<shared_timed_mutex> lock(x_this);
+        // WriteGuard l(x_this);
+        // The reference count is written, so the trie can kill nodes from many threads
+        unique_lock<shared_timed_mutex> lock(x_this);
 // #endif
         if (m_main.count(_h))
         {
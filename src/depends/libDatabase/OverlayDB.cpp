@@ -35,13 +35,38 @@ namespace dev
 	void OverlayDB::ResetDB()
 	{
 		m_levelDB.ResetDB();
+		if (m_nodeCache)
+			m_nodeCache->Clear();
 	}
 
 	bool OverlayDB::RefreshDB()
 	{
+		if (m_nodeCache)
+			m_nodeCache->Clear();
 		return m_levelDB.RefreshDB();
 	}
 
+	void OverlayDB::EnableNodeCache(size_t cacheSizeInBytes)
+	{
+		if (cacheSizeInBytes == 0)
+			m_nodeCache.reset();
+		else
+			m_nodeCache.reset(new TrieNodeCache(cacheSizeInBytes));
+	}
+
+	std::string OverlayDB::lookupLevelDB(h256 const& _h) const
+	{
+		std::string ret;
+		if (m_nodeCache && m_nodeCache->Lookup(_h, ret))
+			return ret;
+
+		ret = m_levelDB.Lookup(_h);
+		if (m_nodeCache)
+			m_nodeCache->Insert(_h, ret);
+
+		return ret;
+	}
+
 	void OverlayDB::commit()
 	{
 	// #if DEV_GUARDED_DB
@@ -88,7 +113,7 @@ namespace dev
 		std::string ret = MemoryDB::lookup(_h);
 	
 		if (ret.empty())
-			ret = m_levelDB.Lookup(_h);
+			ret = lookupLevelDB(_h);
 	
 		return ret;
 	}
@@ -98,6 +123,10 @@ namespace dev
 		if (MemoryDB::exists(_h))
 			return true;
 
+		std::string ret;
+		if (m_nodeCache && m_nodeCache->Lookup(_h, ret))
+			return true;
+
 		return m_levelDB.Exists(_h);
 	}
 
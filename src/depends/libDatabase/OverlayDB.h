@@ -26,6 +26,7 @@
 #include "depends/common/RLP.h"
 #include "LevelDB.h"
 #include "MemoryDB.h"
+#include "TrieNodeCache.h"
 
 namespace dev
 {
@@ -48,10 +49,18 @@ namespace dev
 
 		bytes lookupAux(h256 const& _h) const;
 
+		/// Caches up to cacheSizeInBytes of the nodes read from LevelDB.
+		/// Passing 0 removes the cache.
+		void EnableNodeCache(size_t cacheSizeInBytes);
+		TrieNodeCache * GetNodeCache() const { return m_nodeCache.get(); }
+
 	private:
 		using MemoryDB::clear;
 
+		std::string lookupLevelDB(h256 const& _h) const;
+
 		LevelDB m_levelDB;
+		std::unique_ptr<TrieNodeCache> m_nodeCache;
 	};
 }
 
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TrieNodeCache.h"
+
+using namespace std;
+
+namespace dev
+{
+    TrieNodeCache::TrieNodeCache(size_t capacityInBytes):
+        m_capacityInBytes(capacityInBytes)
+    {
+    }
+
+    size_t TrieNodeCache::EntrySize(const string& node)
+    {
+        // Rough cost of the key, the node and the list and map bookkeeping
+        return node.size() + 2 * h256::size + 64;
+    }
+
+    bool TrieNodeCache::Lookup(h256 const& _h, string& node)
+    {
+        if (m_capacityInBytes == 0)
+        {
+            return false;
+        }
+
+        lock_guard<mutex> g(m_mutex);
+        auto it = m_entries.find(_h);
+        if (it == m_entries.end())
+        {
+            m_misses++;
+            return false;
+        }
+        m_recency.splice(m_recency.begin(), m_recency, it->second);
+        node = it->second->second;
+        m_hits++;
+        return true;
+    }
+
+    void TrieNodeCache::Insert(h256 const& _h, string const& node)
+    {
+        const size_t entrySize = EntrySize(node);
+        if (node.empty() || entrySize > m_capacityInBytes)
+        {
+            return;
+        }
+
+        lock_guard<mutex> g(m_mutex);
+        if (m_entries.find(_h) != m_entries.end())
+        {
+            return;
+        }
+        m_recency.emplace_front(_h, node);
+        m_entries.emplace(_h, m_recency.begin());
+        m_sizeInBytes += entrySize;
+
+        while (m_sizeInBytes > m_capacityInBytes)
+        {
+            m_sizeInBytes -= EntrySize(m_recency.back().second);
+            m_entries.erase(m_recency.back().first);
+            m_recency.pop_back();
+        }
+    }
+
+    void TrieNodeCache::Clear()
+    {
+        lock_guard<mutex> g(m_mutex);
+        m_entries.clear();
+        m_recency.clear();
+        m_sizeInBytes = 0;
+    }
+
+    size_t TrieNodeCache::GetSizeInBytes() const
+    {
+        lock_guard<mutex> g(m_mutex);
+        return m_sizeInBytes;
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TRIENODECACHE_H__
+#define __TRIENODECACHE_H__
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "depends/common/FixedHash.h"
+
+namespace dev
+{
+    /// Least recently used cache of trie nodes read from LevelDB.
+    /// Nodes are keyed by their hash, so a cached node never goes stale.
+    /// The cache is bounded by the bytes the nodes take up.
+    class TrieNodeCache
+    {
+        using Entry = std::pair<h256, std::string>;
+
+        const size_t m_capacityInBytes;
+        size_t m_sizeInBytes{0};
+        mutable std::mutex m_mutex;
+        std::list<Entry> m_recency;  // most recently used first
+        std::unordered_map<h256, std::list<Entry>::iterator> m_entries;
+
+        std::atomic<uint64_t> m_hits{0};
+        std::atomic<uint64_t> m_misses{0};
+
+        static size_t EntrySize(const std::string& node);
+
+    public:
+        /// A capacity of 0 disables caching.
+        explicit TrieNodeCache(size_t capacityInBytes);
+
+        TrieNodeCache(TrieNodeCache const&) = delete;
+        void operator=(TrieNodeCache const&) = delete;
+
+        /// Copies the node into node. Returns false if it is not cached.
+        bool Lookup(h256 const& _h, std::string& node);
+
+        /// Caches the node read from the database.
+        void Insert(h256 const& _h, std::string const& node);
+
+        /// Drops all cached nodes.
+        void Clear();
+
+        uint64_t GetHits() const { return m_hits; }
+        uint64_t GetMisses() const { return m_misses; }
+        size_t GetSizeInBytes() const;
+    };
+}
+
+#endif // __TRIENODECACHE_H__
@@ -19,7 +19,14 @@
 #ifndef __TRIEDB_H__
 #define __TRIEDB_H__
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <exception>
 #include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "depends/common/Exceptions.h"
 #include "depends/common/SHA3.h"
@@ -124,6 +131,10 @@ namespace dev
         }
 
         std::string at(bytesConstRef _key) const;
+        /// Returns the nodes on the path of _key, from the root node down, which are the ones
+        /// stored by hash. A trie over just these nodes with the same root gives the same at(_key),
+        /// so they prove the value of _key, or that it is absent, against root().
+        std::vector<bytes> getProof(bytesConstRef _key) const;
 
         void insert(bytes const& _key, bytes const& _value)
         {
@@ -142,6 +153,16 @@ namespace dev
 
         void insert(bytesConstRef _key, bytesConstRef _value);
 
+        /// Same result as calling insert() on each entry in order. Once the root is a
+        /// branch node, the entries under each of its 16 children are merged on up to
+        /// _numThreads threads and the new children are joined at the root.
+        void insertBatch(std::vector<std::pair<bytesConstRef, bytesConstRef>> const& _entries, unsigned _numThreads);
+
+        /// Same result as insertBatch() into an empty trie, but built bottom up so that each
+        /// node is hashed and written once. Returns false, leaving the trie as it is, unless
+        /// the trie is empty and the keys strictly increase.
+        bool buildSorted(std::vector<std::pair<bytesConstRef, bytesConstRef>> const& _entries);
+
         void remove(bytes const& _key) { remove(&_key); }
         void remove(bytesConstRef _key);
 
@@ -325,6 +346,24 @@ namespace dev
         bool isTwoItemNode(RLP const& _n) const;
         std::string deref(RLP const& _n) const;
 
+        // Smaller batches are not worth the threads.
+        static const size_t c_minParallelBatch = 256;
+
+        bool isBranchRoot() const
+        {
+            std::string rootValue = node(m_root);
+            RLP r(rootValue);
+            return r.isList() && r.itemCount() == 17;
+        }
+
+        // Merges the entries at _indices into child _i of the root branch _root.
+        // Every new node of 32 bytes or more is put into the DB, just like insert().
+        bytes mergeChild(RLP const& _root, byte _i, std::vector<std::pair<bytesConstRef, bytesConstRef>> const& _entries, std::vector<size_t> const& _indices);
+
+        // Returns the node holding the sorted entries [_begin, _end), which share their
+        // first _depth nibbles, after putting its descendants of 32 bytes or more into the DB.
+        bytes buildNode(std::vector<std::pair<bytesConstRef, bytesConstRef>> const& _entries, size_t _begin, size_t _end, unsigned _depth);
+
         std::string node(h256 const& _h) const { return m_db->lookup(_h); }
 
         // These are low-level node insertion functions that just go straight through into the DB.
@@ -384,7 +423,24 @@ namespace dev
         {
             insert(_k, bytesConstRef(&_value));
         }
+        void insertBatch(std::vector<std::pair<KeyType, bytes>> const& _entries, unsigned _numThreads)
+        {
+            std::vector<std::pair<bytesConstRef, bytesConstRef>> entries;
+            entries.reserve(_entries.size());
+            for (auto const& e: _entries)
+                entries.emplace_back(bytesConstRef((byte const*)&e.first, sizeof(KeyType)), bytesConstRef(&e.second));
+            Generic::insertBatch(entries, _numThreads);
+        }
+        bool buildSorted(std::vector<std::pair<KeyType, bytes>> const& _entries)
+        {
+            std::vector<std::pair<bytesConstRef, bytesConstRef>> entries;
+            entries.reserve(_entries.size());
+            for (auto const& e: _entries)
+                entries.emplace_back(bytesConstRef((byte const*)&e.first, sizeof(KeyType)), bytesConstRef(&e.second));
+            return Generic::buildSorted(entries);
+        }
         void remove(KeyType _k) { Generic::remove(bytesConstRef((byte const*)&_k, sizeof(KeyType))); }
+        std::vector<bytes> getProof(KeyType _k) const { return Generic::getProof(bytesConstRef((byte const*)&_k, sizeof(KeyType))); }
 
         class iterator: public Generic::iterator
         {
@@ -868,6 +924,164 @@ namespace dev
         m_root = forceInsertNode(&b);
     }
 
+    template <class DB> void GenericTrieDB<DB>::insertBatch(std::vector<std::pair<bytesConstRef, bytesConstRef>> const& _entries, unsigned _numThreads)
+    {
+        // The subtrees are only independent below a branch node at the root
+        size_t next = 0;
+        for (; next < _entries.size(); ++next)
+        {
+            if (_numThreads > 1 && _entries.size() - next >= c_minParallelBatch && isBranchRoot())
+                break;
+            insert(_entries[next].first, _entries[next].second);
+        }
+        if (next == _entries.size())
+            return;
+
+        // Split by first nibble, keeping the order within each child
+        std::array<std::vector<size_t>, 16> partitions;
+        for (size_t i = next; i < _entries.size(); ++i)
+        {
+            if (_entries[i].first.empty())
+            {
+                // A value on the root itself; nothing to gain, keep it simple
+                for (size_t j = next; j < _entries.size(); ++j)
+                    insert(_entries[j].first, _entries[j].second);
+                return;
+            }
+            partitions[_entries[i].first[0] >> 4].push_back(i);
+        }
+
+        std::string rootValue = node(m_root);
+        RLP root(rootValue);
+        std::array<bytes, 16> children;
+        std::atomic<unsigned> nextChild{0};
+        const unsigned numThreads = std::min(_numThreads, 16u);
+        std::vector<std::exception_ptr> errors(numThreads);
+
+        auto worker = [&](unsigned _t)
+        {
+            try
+            {
+                for (unsigned i = nextChild++; i < 16; i = nextChild++)
+                    if (!partitions[i].empty())
+                        children[i] = mergeChild(root, i, _entries, partitions[i]);
+            }
+            catch (...)
+            {
+                errors[_t] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < numThreads; ++t)
+            threads.emplace_back(worker, t);
+        worker(0);
+        for (auto& t: threads)
+            t.join();
+        for (auto const& e: errors)
+            if (e)
+                std::rethrow_exception(e);
+
+        RLPStream r(17);
+        for (byte i = 0; i < 16; ++i)
+            if (partitions[i].empty())
+                r.append(root[i]);
+            else if (children[i].size() < 32)
+                r.appendRaw(children[i]);
+            else
+                r.append(sha3(children[i]));	// already in the DB
+        r.append(root[16]);
+
+        bytes b = r.out();
+        forceKillNode(m_root);
+        m_root = forceInsertNode(&b);
+    }
+
+    template <class DB> bool GenericTrieDB<DB>::buildSorted(std::vector<std::pair<bytesConstRef, bytesConstRef>> const& _entries)
+    {
+        if (!isEmpty())
+            return false;
+        for (size_t i = 1; i < _entries.size(); ++i)
+        {
+            auto const& a = _entries[i - 1].first;
+            auto const& b = _entries[i].first;
+            if (!std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end()))
+                return false;
+        }
+        if (_entries.empty())
+            return true;
+
+        bytes b = buildNode(_entries, 0, _entries.size(), 0);
+        // The root is always looked up by hash, whatever its size
+        forceKillNode(m_root);
+        m_root = forceInsertNode(&b);
+        return true;
+    }
+
+    template <class DB> bytes GenericTrieDB<DB>::buildNode(std::vector<std::pair<bytesConstRef, bytesConstRef>> const& _entries, size_t _begin, size_t _end, unsigned _depth)
+    {
+        NibbleSlice first = NibbleSlice(_entries[_begin].first).mid(_depth);
+        if (_end - _begin == 1)
+            return rlpList(hexPrefixEncode(first, true), _entries[_begin].second);
+
+        // Sorted, so the prefix shared by the first and last keys is shared by all of them
+        unsigned shared = first.shared(NibbleSlice(_entries[_end - 1].first).mid(_depth));
+        if (shared > 0)
+        {
+            RLPStream s(2);
+            s << hexPrefixEncode(first, false, 0, shared);
+            streamNode(s, buildNode(_entries, _begin, _end, _depth + shared));
+            return s.out();
+        }
+
+        // A key ending here sorts first and is the value of the branch
+        size_t next = _begin;
+        bytesConstRef value;
+        if (first.empty())
+            value = _entries[next++].second;
+
+        RLPStream s(17);
+        for (unsigned n = 0; n < 16; ++n)
+        {
+            size_t end = next;
+            while (end < _end && NibbleSlice(_entries[end].first)[_depth] == n)
+                ++end;
+            if (end == next)
+                s << "";
+            else
+                streamNode(s, buildNode(_entries, next, end, _depth + 1));
+            next = end;
+        }
+        s << value;
+        return s.out();
+    }
+
+    template <class DB> bytes GenericTrieDB<DB>::mergeChild(RLP const& _root, byte _i, std::vector<std::pair<bytesConstRef, bytesConstRef>> const& _entries, std::vector<size_t> const& _indices)
+    {
+        RLP child = _root[_i];
+        bytes cur;
+        bool inLine = true;
+        if (!child.isList() && !child.isEmpty())
+        {
+            cur = asBytes(node(child.toHash<h256>()));
+            inLine = false;
+        }
+        else
+            cur = child.data().toBytes();
+
+        for (size_t i: _indices)
+        {
+            auto const& e = _entries[i];
+            bytes b = mergeAt(RLP(cur), NibbleSlice(e.first).mid(1), e.second, inLine);
+            inLine = b.size() < 32;
+            if (!inLine)
+                forceInsertNode(&b);
+            cur = std::move(b);
+        }
+
+        return cur;
+    }
+
     template <class DB> std::string GenericTrieDB<DB>::at(bytesConstRef _key) const
     {
         return atAux(RLP(node(m_root)), _key);
@@ -912,6 +1126,48 @@ namespace dev
         }
     }
 
+    template <class DB> std::vector<bytes> GenericTrieDB<DB>::getProof(bytesConstRef _key) const
+    {
+        std::vector<bytes> ret;
+        std::string here = node(m_root);
+        NibbleSlice key = _key;
+        bool inlined = false;
+        while (true)
+        {
+            // Inlined nodes are part of their parent's data already
+            if (!inlined && !here.empty())
+                ret.push_back(asBytes(here));
+
+            RLP r(here);
+            if (r.isEmpty() || r.isNull() || !r.isList())
+                break;
+
+            RLP next;
+            if (r.itemCount() == 2)
+            {
+                auto k = keyOf(r);
+                if (isLeaf(r) || !key.contains(k))
+                    // the leaf or the end of the path, whether or not it is us
+                    break;
+                key = key.mid(k.size());
+                next = r[1];
+            }
+            else if (r.itemCount() == 17)
+            {
+                if (key.size() == 0 || r[key[0]].isEmpty())
+                    break;
+                next = r[key[0]];
+                key = key.mid(1);
+            }
+            else
+                break;
+
+            inlined = next.isList();
+            here = deref(next);
+        }
+        return ret;
+    }
+
     template <class DB> bytes GenericTrieDB<DB>::mergeAt(RLP const& _orig, NibbleSlice _k, bytesConstRef _v, bool _inLine)
     {
         return mergeAt(_orig, sha3(_orig.data()), _k, _v, _inLine);
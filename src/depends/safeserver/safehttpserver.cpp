@@ -8,6 +8,8 @@
  ************************************************************************/
 
 #include "safehttpserver.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
 #include <cstdlib>
 #include <sstream>
 #include <iostream>
@@ -27,10 +29,30 @@ struct mhd_coninfo {
         int code;
 };
 
-SafeHttpServer::SafeHttpServer(int port, const std::string &sslcert, const std::string &sslkey, int threads) :
+thread_local std::string SafeHttpServer::clientAddress;
+
+namespace
+{
+    string GetConnectionAddress(MHD_Connection *connection)
+    {
+        const union MHD_ConnectionInfo *info = MHD_get_connection_info(connection, MHD_CONNECTION_INFO_CLIENT_ADDRESS);
+        if (info == NULL || info->client_addr == NULL)
+            return "";
+        char address[INET6_ADDRSTRLEN] = {0};
+        const struct sockaddr *addr = info->client_addr;
+        if (addr->sa_family == AF_INET)
+            inet_ntop(AF_INET, &reinterpret_cast<const struct sockaddr_in*>(addr)->sin_addr, address, sizeof(address));
+        else if (addr->sa_family == AF_INET6)
+            inet_ntop(AF_INET6, &reinterpret_cast<const struct sockaddr_in6*>(addr)->sin6_addr, address, sizeof(address));
+        return address;
+    }
+}
+
+SafeHttpServer::SafeHttpServer(int port, const std::string &sslcert, const std::string &sslkey, int threads, unsigned int timeout) :
     AbstractServerConnector(),
     port(port),
     threads(threads),
+    timeout(timeout),
     running(false),
     path_sslcert(sslcert),
     path_sslkey(sslkey),
@@ -58,7 +80,7 @@ bool SafeHttpServer::StartListening()
                 SpecificationParser::GetFileContent(this->path_sslcert, this->sslcert);
                 SpecificationParser::GetFileContent(this->path_sslkey, this->sslkey);
 
-                this->daemon = MHD_start_daemon(MHD_USE_SSL | MHD_USE_SELECT_INTERNALLY, this->port, NULL, NULL, SafeHttpServer::callback, this, MHD_OPTION_HTTPS_MEM_KEY, this->sslkey.c_str(), MHD_OPTION_HTTPS_MEM_CERT, this->sslcert.c_str(), MHD_OPTION_THREAD_POOL_SIZE, this->threads, MHD_OPTION_END);
+                this->daemon = MHD_start_daemon(MHD_USE_SSL | MHD_USE_SELECT_INTERNALLY, this->port, NULL, NULL, SafeHttpServer::callback, this, MHD_OPTION_HTTPS_MEM_KEY, this->sslkey.c_str(), MHD_OPTION_HTTPS_MEM_CERT, this->sslcert.c_str(), MHD_OPTION_THREAD_POOL_SIZE, this->threads, MHD_OPTION_CONNECTION_TIMEOUT, this->timeout, MHD_OPTION_END);
             }
             catch (JsonRpcException& ex)
             {
@@ -67,7 +89,7 @@ bool SafeHttpServer::StartListening()
         }
         else
         {
-            this->daemon = MHD_start_daemon(MHD_USE_SELECT_INTERNALLY, this->port, NULL, NULL, SafeHttpServer::callback, this,   MHD_OPTION_THREAD_POOL_SIZE, this->threads, MHD_OPTION_END);
+            this->daemon = MHD_start_daemon(MHD_USE_SELECT_INTERNALLY, this->port, NULL, NULL, SafeHttpServer::callback, this,   MHD_OPTION_THREAD_POOL_SIZE, this->threads, MHD_OPTION_CONNECTION_TIMEOUT, this->timeout, MHD_OPTION_END);
         }
         if (this->daemon != NULL)
             this->running = true;
@@ -114,6 +136,11 @@ bool SafeHttpServer::SendOptionsResponse(void* addInfo)
     return ret == MHD_YES;
 }
 
+const std::string& SafeHttpServer::GetClientAddress()
+{
+    return clientAddress;
+}
+
 void SafeHttpServer::SetUrlHandler(const string &url, IClientConnectionHandler *handler)
 {
     this->urlhandler[url] = handler;
@@ -153,7 +180,9 @@ int SafeHttpServer::callback(void *cls, MHD_Connection *connection, const char *
             else
             {
                 client_connection->code = MHD_HTTP_OK;
+                clientAddress = GetConnectionAddress(connection);
                 handler->HandleRequest(client_connection->request.str(), response);
+                clientAddress.clear();
                 client_connection->server->SendResponse(response, client_connection);
             }
         }
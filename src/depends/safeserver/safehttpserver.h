@@ -26,6 +26,7 @@ typedef intptr_t ssize_t;
 #endif
 
 #include <map>
+#include <string>
 #include <microhttpd.h>
 #include "jsonrpccpp/server/abstractserverconnector.h"
 
@@ -46,8 +47,10 @@ namespace jsonrpc
              * @param port on which the server is listening
              * @param enableSpecification - defines if the specification is returned in case of a GET request
              * @param sslcert - defines the path to a SSL certificate, if this path is != "", then SSL/HTTPS is used with the given certificate.
+             * @param threads - size of the thread pool serving the connections
+             * @param timeout - seconds after which an idle kept-alive connection is closed, 0 to never close it
              */
-            SafeHttpServer(int port, const std::string& sslcert = "", const std::string& sslkey = "", int threads = 50);
+            SafeHttpServer(int port, const std::string& sslcert = "", const std::string& sslkey = "", int threads = 50, unsigned int timeout = 0);
 
             virtual bool StartListening();
             virtual bool StopListening();
@@ -58,9 +61,15 @@ namespace jsonrpc
 
             void SetUrlHandler(const std::string &url, IClientConnectionHandler *handler);
 
+            /**
+             * @brief IP of the client whose request the calling thread is handling, or "" outside of a request
+             */
+            static const std::string& GetClientAddress();
+
         private:
             int port;
             int threads;
+            unsigned int timeout;
             bool running;
             std::string path_sslcert;
             std::string path_sslkey;
@@ -75,6 +84,8 @@ namespace jsonrpc
 
             IClientConnectionHandler* GetHandler(const std::string &url);
 
+            static thread_local std::string clientAddress;
+
     };
 
 } /* namespace jsonrpc */
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "libPersistence/BlockStorage.h"
+
+std::string getCsvHeader() {
+  return "Tx Epoch,DS Epoch,PoW (us),DS Block Consensus (us),Txn Processing "
+         "(us),MicroBlock Consensus (us),Final Block Consensus (us),Commit "
+         "(us),Txns,Bytes Sent";
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "[USAGE] " << argv[0] << " <output csv filename> [db path]"
+              << std::endl;
+    return -1;
+  }
+
+  std::string path = "./";
+  if (argc == 3) {
+    path = std::string(argv[2]);
+    path += (path.back() == '/' ? "" : "/");
+  }
+
+  BlockStorage& bs = BlockStorage::GetBlockStorage(path, true);
+
+  std::map<uint64_t, DiagnosticDataEpochPerf> diagnosticDataMap;
+  bs.GetDiagnosticDataEpochPerf(diagnosticDataMap);
+  if (diagnosticDataMap.empty()) {
+    std::cout << "Nothing to read in the Diagnostic DB" << std::endl;
+    return 0;
+  }
+
+  // Write to csv file.
+  std::ofstream out(argv[1]);
+  out << getCsvHeader() << std::endl;
+  for (auto const& it : diagnosticDataMap) {
+    auto const& entry = it.second;
+    out << it.first << "," << entry.dsBlockNum << "," << entry.powTime << ","
+        << entry.dsBlockConsensusTime << "," << entry.txnProcessingTime << ","
+        << entry.microBlockConsensusTime << ","
+        << entry.finalBlockConsensusTime << "," << entry.commitTime << ","
+        << entry.txnCount << "," << entry.bytesSent << std::endl;
+  }
+
+  out.close();
+
+  return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <MultiSig.h>
+#include <algorithm>
+
+#include "AggregatedPubKeyCache.h"
+#include "common/Constants.h"
+#include "libCrypto/Sha2.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace {
+const unsigned char COMPRESSED_EVEN_Y = 0x02;
+const unsigned char COMPRESSED_ODD_Y = 0x03;
+}  // namespace
+
+AggregatedPubKeyCache& AggregatedPubKeyCache::GetInstance() {
+  static AggregatedPubKeyCache instance;
+  return instance;
+}
+
+bytes AggregatedPubKeyCache::GetCommitteeID(const vector<PubKey>& committee) {
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  bytes serialized;
+  for (const auto& key : committee) {
+    serialized.clear();
+    key.Serialize(serialized, 0);
+    sha2.Update(serialized);
+  }
+  return sha2.Finalize();
+}
+
+bool AggregatedPubKeyCache::NegateKey(const PubKey& key, PubKey& negatedKey) {
+  // Negating a point only flips the parity of y, which in the compressed
+  // encoding is the prefix byte
+  bytes serialized;
+  if (key.Serialize(serialized, 0) != PUB_KEY_SIZE) {
+    return false;
+  }
+
+  if (serialized.at(0) == COMPRESSED_EVEN_Y) {
+    serialized.at(0) = COMPRESSED_ODD_Y;
+  } else if (serialized.at(0) == COMPRESSED_ODD_Y) {
+    serialized.at(0) = COMPRESSED_EVEN_Y;
+  } else {
+    return false;
+  }
+
+  return negatedKey.Deserialize(serialized, 0);
+}
+
+shared_ptr<const AggregatedPubKeyCache::Committee>
+AggregatedPubKeyCache::GetCommittee(const vector<PubKey>& committee) {
+  const bytes committeeID = GetCommitteeID(committee);
+
+  {
+    lock_guard<mutex> g(m_mutex);
+    auto it = m_committees.find(committeeID);
+    if (it != m_committees.end()) {
+      return it->second;
+    }
+  }
+
+  auto entry = make_shared<Committee>();
+  entry->m_fullAggregate = MultiSig::AggregatePubKeys(committee);
+  if (entry->m_fullAggregate == nullptr) {
+    return nullptr;
+  }
+
+  entry->m_negatedKeys.resize(committee.size());
+  for (unsigned int i = 0; i < committee.size(); i++) {
+    if (!NegateKey(committee.at(i), entry->m_negatedKeys.at(i))) {
+      LOG_GENERAL(WARNING, "Failed to negate key " << committee.at(i));
+      return nullptr;
+    }
+  }
+
+  lock_guard<mutex> g(m_mutex);
+  if (m_committees.emplace(committeeID, entry).second) {
+    m_insertionOrder.emplace_back(committeeID);
+    if (m_insertionOrder.size() > MAX_COMMITTEES) {
+      m_committees.erase(m_insertionOrder.front());
+      m_insertionOrder.pop_front();
+    }
+  }
+  return entry;
+}
+
+shared_ptr<PubKey> AggregatedPubKeyCache::AggregatePubKeys(
+    const vector<PubKey>& committee, const Bitmap& bitmap) {
+  if (committee.size() != bitmap.size() || committee.empty()) {
+    LOG_GENERAL(WARNING, "Mismatch: committee size = "
+                             << committee.size()
+                             << ", bitmap size = " << bitmap.size());
+    return nullptr;
+  }
+
+  const unsigned int numSigners = bitmap.count();
+  const unsigned int numMissing = bitmap.size() - numSigners;
+
+  // Below this point adding up the signers directly is no more expensive
+  if (numSigners > numMissing + 1) {
+    auto entry = GetCommittee(committee);
+    if (entry != nullptr) {
+      if (numMissing == 0) {
+        return make_shared<PubKey>(*entry->m_fullAggregate);
+      }
+
+      vector<PubKey> keys = {*entry->m_fullAggregate};
+      for (unsigned int i = 0; i < bitmap.size(); i++) {
+        if (!bitmap.at(i)) {
+          keys.emplace_back(entry->m_negatedKeys.at(i));
+        }
+      }
+      return MultiSig::AggregatePubKeys(keys);
+    }
+    LOG_GENERAL(WARNING, "Falling back to direct aggregation");
+  }
+
+  vector<PubKey> keys;
+  keys.reserve(numSigners);
+  for (size_t i = bitmap.find_first(); i != Bitmap::npos;
+       i = bitmap.find_next(i)) {
+    keys.emplace_back(committee.at(i));
+  }
+  return MultiSig::AggregatePubKeys(keys);
+}
+
+void AggregatedPubKeyCache::Clear() {
+  lock_guard<mutex> g(m_mutex);
+  m_committees.clear();
+  m_insertionOrder.clear();
+}
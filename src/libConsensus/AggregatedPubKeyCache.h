@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBCONSENSUS_AGGREGATEDPUBKEYCACHE_H_
+#define ZILLIQA_SRC_LIBCONSENSUS_AGGREGATEDPUBKEYCACHE_H_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <Schnorr.h>
+
+#include "libUtils/Bitmap.h"
+
+/// Derives the aggregated public key of a cosignature bitmap from a cached
+/// aggregate of the whole committee, by adding the negated keys of the
+/// members that did not sign. Blocks signed by the same committee then cost
+/// one point addition per missing signer instead of one per signer.
+class AggregatedPubKeyCache {
+  static const unsigned int MAX_COMMITTEES = 16;
+
+  struct Committee {
+    std::shared_ptr<PubKey> m_fullAggregate;
+    std::vector<PubKey> m_negatedKeys;
+  };
+
+  std::mutex m_mutex;
+  std::map<bytes, std::shared_ptr<const Committee>> m_committees;
+  std::deque<bytes> m_insertionOrder;
+
+  AggregatedPubKeyCache() = default;
+  ~AggregatedPubKeyCache() = default;
+
+  // Singleton should not implement these
+  AggregatedPubKeyCache(AggregatedPubKeyCache const&) = delete;
+  void operator=(AggregatedPubKeyCache const&) = delete;
+
+  std::shared_ptr<const Committee> GetCommittee(
+      const std::vector<PubKey>& committee);
+  static bytes GetCommitteeID(const std::vector<PubKey>& committee);
+  static bool NegateKey(const PubKey& key, PubKey& negatedKey);
+
+ public:
+  /// Returns the singleton instance.
+  static AggregatedPubKeyCache& GetInstance();
+
+  /// Returns the aggregate of the committee keys selected by the bitmap, or
+  /// nullptr if the sizes mismatch or aggregation fails.
+  std::shared_ptr<PubKey> AggregatePubKeys(const std::vector<PubKey>& committee,
+                                           const Bitmap& bitmap);
+
+  /// Drops all cached committees.
+  void Clear();
+};
+
+#endif  // ZILLIQA_SRC_LIBCONSENSUS_AGGREGATEDPUBKEYCACHE_H_
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CommitPool.h"
+#include "common/Constants.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+CommitPool::CommitPool(unsigned int capacity) : m_capacity(capacity) {
+  if (m_capacity > 0) {
+    m_thread = thread([this]() { Fill(); });
+  }
+}
+
+CommitPool::~CommitPool() {
+  {
+    lock_guard<mutex> g(m_mutex);
+    m_stopped = true;
+  }
+  m_cv.notify_all();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+CommitPool& CommitPool::GetInstance() {
+  static CommitPool pool(COMMIT_POOL_SIZE);
+  return pool;
+}
+
+CommitPool::Commit CommitPool::GenerateCommit() {
+  auto secret = make_shared<CommitSecret>();
+  auto point = make_shared<CommitPoint>(*secret);
+  return make_pair(secret, point);
+}
+
+void CommitPool::Fill() {
+  unique_lock<mutex> lock(m_mutex);
+  while (true) {
+    m_cv.wait(lock, [this] {
+      return m_stopped || (m_commits.size() < m_capacity);
+    });
+    if (m_stopped) {
+      return;
+    }
+
+    // Point multiplication happens outside the lock
+    lock.unlock();
+    Commit commit = GenerateCommit();
+    lock.lock();
+
+    if (!commit.first->Initialized() || !commit.second->Initialized()) {
+      LOG_GENERAL(WARNING, "Commit generation failed");
+      continue;
+    }
+    m_commits.emplace_back(move(commit));
+  }
+}
+
+CommitPool::Commit CommitPool::GetCommit() {
+  {
+    lock_guard<mutex> g(m_mutex);
+    if (!m_commits.empty()) {
+      // Taking the pair out of the pool guarantees it is never reused
+      Commit commit = move(m_commits.front());
+      m_commits.pop_front();
+      m_cv.notify_one();
+      return commit;
+    }
+  }
+
+  return GenerateCommit();
+}
+
+size_t CommitPool::Size() {
+  lock_guard<mutex> g(m_mutex);
+  return m_commits.size();
+}
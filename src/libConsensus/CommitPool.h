@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBCONSENSUS_COMMITPOOL_H_
+#define ZILLIQA_SRC_LIBCONSENSUS_COMMITPOOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <MultiSig.h>
+
+/// Keeps a number of commit secret/point pairs ready ahead of time, so that
+/// consensus nodes do not generate them on the critical path. Every pair is
+/// handed out exactly once; the background thread tops the pool up again.
+class CommitPool {
+ public:
+  using Commit =
+      std::pair<std::shared_ptr<CommitSecret>, std::shared_ptr<CommitPoint>>;
+
+ private:
+  const unsigned int m_capacity;
+  std::deque<Commit> m_commits;
+  bool m_stopped{false};
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::thread m_thread;
+
+  explicit CommitPool(unsigned int capacity);
+  ~CommitPool();
+
+  // Singleton should not implement these
+  CommitPool(CommitPool const&) = delete;
+  void operator=(CommitPool const&) = delete;
+
+  void Fill();
+  static Commit GenerateCommit();
+
+ public:
+  /// Returns the singleton instance.
+  static CommitPool& GetInstance();
+
+  /// Removes a precomputed pair from the pool, or generates one on the spot
+  /// if the pool is empty or disabled.
+  Commit GetCommit();
+
+  /// Returns the number of pairs currently available.
+  size_t Size();
+};
+
+#endif  // ZILLIQA_SRC_LIBCONSENSUS_COMMITPOOL_H_
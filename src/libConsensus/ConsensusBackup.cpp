@@ -17,7 +17,9 @@
 
 #include "ConsensusBackup.h"
 
+#include <tuple>
 #include <utility>
+#include "CommitPool.h"
 #include "common/Constants.h"
 #include "common/Messages.h"
 #include "libMessage/Messenger.h"
@@ -25,6 +27,7 @@
 #include "libUtils/BitVector.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/Logger.h"
+#include "libUtils/TraceRecorder.h"
 
 using namespace std;
 
@@ -168,8 +171,7 @@ bool ConsensusBackup::GenerateCommitMessage(bytes& commit,
 
   // Generate new commit
   // ===================
-  m_commitSecret.reset(new CommitSecret());
-  m_commitPoint.reset(new CommitPoint(*m_commitSecret));
+  tie(m_commitSecret, m_commitPoint) = CommitPool::GetInstance().GetCommit();
 
   // Assemble commit message body
   // ============================
@@ -428,6 +430,8 @@ bool ConsensusBackup::ProcessMessage(const bytes& message, unsigned int offset,
   // [consensus message]
 
   bool result = false;
+  const uint64_t startInMicro =
+      ENABLE_CONSENSUS_TRACE ? TraceRecorder::NowInMicro() : 0;
 
   switch (message.at(offset)) {
     case ConsensusMessageType::ANNOUNCE:
@@ -453,6 +457,8 @@ bool ConsensusBackup::ProcessMessage(const bytes& message, unsigned int offset,
                   "Unknown msg type " << (unsigned int)message.at(offset));
   }
 
+  TraceMessage(message.at(offset), startInMicro, result);
+
   return result;
 }
 
@@ -16,6 +16,7 @@
  */
 
 #include "ConsensusCommon.h"
+#include "AggregatedPubKeyCache.h"
 #include "common/Constants.h"
 #include "common/Messages.h"
 #pragma GCC diagnostic push
@@ -27,12 +28,20 @@
 #include "libUtils/BitVector.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/Logger.h"
+#include "libUtils/TraceRecorder.h"
 
 #define MAKE_LITERAL_PAIR(s) \
   { s, #s }
 
 using namespace std;
 
+namespace {
+// Tracks of a consensus session in the trace; subsets follow these
+const uint32_t TRACE_TRACK_STATE = 0;
+const uint32_t TRACE_TRACK_MESSAGE = 1;
+const uint32_t TRACE_TRACK_SUBSET_BASE = 2;
+}  // namespace
+
 map<ConsensusCommon::ConsensusErrorCode, std::string>
     ConsensusCommon::CONSENSUSERRORMSG = {
         MAKE_LITERAL_PAIR(NO_ERROR),
@@ -80,7 +89,17 @@ ConsensusCommon::ConsensusCommon(uint32_t consensus_id, uint64_t block_number,
       m_committee(committee),
       m_classByte(class_byte),
       m_insByte(ins_byte),
-      m_responseMap(committee.size(), false) {}
+      m_responseMap(committee.size(), false) {
+  if (ENABLE_CONSENSUS_TRACE) {
+    m_traceStateStart = TraceRecorder::NowInMicro();
+    TraceRecorder& tracer = TraceRecorder::GetInstance();
+    tracer.SetProcessName(consensus_id,
+                          "Consensus " + to_string(consensus_id) + " (block " +
+                              to_string(block_number) + ")");
+    tracer.SetThreadName(consensus_id, TRACE_TRACK_STATE, "state");
+    tracer.SetThreadName(consensus_id, TRACE_TRACK_MESSAGE, "messages");
+  }
+}
 
 ConsensusCommon::~ConsensusCommon() {}
 
@@ -114,17 +133,15 @@ bool ConsensusCommon::VerifyMessage(const bytes& msg, unsigned int offset,
   return result;
 }
 
-PubKey ConsensusCommon::AggregateKeys(const vector<bool>& peer_map) {
+PubKey ConsensusCommon::AggregateKeys(const Bitmap& peer_map) {
   LOG_MARKER();
 
   vector<PubKey> keys;
-  DequeOfNode::const_iterator j = m_committee.begin();
-  for (unsigned int i = 0; i < peer_map.size(); ++i, ++j) {
-    if (peer_map.at(i)) {
-      keys.emplace_back(j->first);
-    }
+  for (const auto& node : m_committee) {
+    keys.emplace_back(node.first);
   }
-  shared_ptr<PubKey> result = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<PubKey> result =
+      AggregatedPubKeyCache::GetInstance().AggregatePubKeys(keys, peer_map);
   if (result == nullptr) {
     return PubKey();
   }
@@ -276,7 +293,7 @@ const Signature& ConsensusCommon::GetCS1() const {
   return m_CS1;
 }
 
-const vector<bool>& ConsensusCommon::GetB1() const {
+const Bitmap& ConsensusCommon::GetB1() const {
   if (m_state != DONE) {
     LOG_GENERAL(WARNING, "GetB1 called before DONE");
   }
@@ -292,7 +309,7 @@ const Signature& ConsensusCommon::GetCS2() const {
   return m_CS2;
 }
 
-const vector<bool>& ConsensusCommon::GetB2() const {
+const Bitmap& ConsensusCommon::GetB2() const {
   if (m_state != DONE) {
     LOG_GENERAL(WARNING, "GetB2 called before DONE");
   }
@@ -345,6 +362,15 @@ map<ConsensusCommon::State, string> ConsensusCommon::ConsensusStateStrings = {
     MAKE_LITERAL_PAIR(DONE),
     MAKE_LITERAL_PAIR(ERROR)};
 
+map<ConsensusCommon::ConsensusMessageType, string>
+    ConsensusCommon::ConsensusMessageTypeStrings = {
+        MAKE_LITERAL_PAIR(ANNOUNCE),       MAKE_LITERAL_PAIR(COMMIT),
+        MAKE_LITERAL_PAIR(CHALLENGE),      MAKE_LITERAL_PAIR(RESPONSE),
+        MAKE_LITERAL_PAIR(COLLECTIVESIG),  MAKE_LITERAL_PAIR(FINALCOMMIT),
+        MAKE_LITERAL_PAIR(FINALCHALLENGE), MAKE_LITERAL_PAIR(FINALRESPONSE),
+        MAKE_LITERAL_PAIR(FINALCOLLECTIVESIG),
+        MAKE_LITERAL_PAIR(COMMITFAILURE),  MAKE_LITERAL_PAIR(CONSENSUSFAILURE)};
+
 string ConsensusCommon::GetStateString() const {
   if (ConsensusStateStrings.find(m_state) == ConsensusStateStrings.end()) {
     return "UNKNOWN";
@@ -360,3 +386,59 @@ string ConsensusCommon::GetStateString(const State state) const {
     return ConsensusStateStrings.at(state);
   }
 }
+
+void ConsensusCommon::TraceStateChange() {
+  if (!ENABLE_CONSENSUS_TRACE) {
+    return;
+  }
+
+  lock_guard<mutex> g(m_mutexTrace);
+  const State state = m_state;
+  if (state == m_traceState) {
+    return;
+  }
+
+  const uint64_t now = TraceRecorder::NowInMicro();
+  TraceRecorder::GetInstance().Complete(
+      GetStateString(m_traceState), "state", m_consensusID, TRACE_TRACK_STATE,
+      m_traceStateStart, now - m_traceStateStart);
+  if (state == DONE || state == ERROR) {
+    TraceRecorder::GetInstance().Instant(GetStateString(state), "state",
+                                         m_consensusID, TRACE_TRACK_STATE, now);
+  }
+
+  m_traceState = state;
+  m_traceStateStart = now;
+}
+
+void ConsensusCommon::TraceMessage(unsigned char msgType,
+                                   uint64_t startInMicro, bool result) {
+  if (!ENABLE_CONSENSUS_TRACE) {
+    return;
+  }
+
+  auto it = ConsensusMessageTypeStrings.find(
+      static_cast<ConsensusMessageType>(msgType));
+  Json::Value args;
+  args["result"] = result;
+  TraceRecorder::GetInstance().Complete(
+      (it == ConsensusMessageTypeStrings.end()) ? "UNKNOWN" : it->second,
+      "message", m_consensusID, TRACE_TRACK_MESSAGE, startInMicro,
+      TraceRecorder::NowInMicro() - startInMicro, args);
+
+  TraceStateChange();
+}
+
+void ConsensusCommon::TraceSubsetEnded(uint16_t subsetID, State subsetState) {
+  if (!ENABLE_CONSENSUS_TRACE) {
+    return;
+  }
+
+  const uint32_t tid = TRACE_TRACK_SUBSET_BASE + subsetID;
+  Json::Value args;
+  args["state"] = GetStateString(subsetState);
+  TraceRecorder& tracer = TraceRecorder::GetInstance();
+  tracer.SetThreadName(m_consensusID, tid, "subset " + to_string(subsetID));
+  tracer.Instant("SUBSET_ENDED", "subset", m_consensusID, tid,
+                 TraceRecorder::NowInMicro(), args);
+}
@@ -27,6 +27,7 @@
 
 #include <MultiSig.h>
 #include "libNetwork/ShardStruct.h"
+#include "libUtils/Bitmap.h"
 #include "libUtils/TimeLockedFunction.h"
 
 struct ChallengeSubsetInfo {
@@ -144,19 +145,19 @@ class ConsensusCommon {
   Signature m_collectiveSig;
 
   /// Response map for the generated collective signature
-  std::vector<bool> m_responseMap;
+  Bitmap m_responseMap;
 
   /// Co-sig for first round
   Signature m_CS1;
 
   /// Co-sig bitmap for first round
-  std::vector<bool> m_B1;
+  Bitmap m_B1;
 
   /// Co-sig for second round
   Signature m_CS2;
 
   /// Co-sig bitmap for second round
-  std::vector<bool> m_B2;
+  Bitmap m_B2;
 
   /// Generated commit secret
   std::shared_ptr<CommitSecret> m_commitSecret;
@@ -164,6 +165,13 @@ class ConsensusCommon {
   /// Generated commit point
   std::shared_ptr<CommitPoint> m_commitPoint;
 
+  /// Guards the consensus trace bookkeeping below
+  std::mutex m_mutexTrace;
+
+  /// Last state written to the consensus trace and when it was entered
+  State m_traceState{INITIAL};
+  uint64_t m_traceStateStart{0};
+
   /// Constructor.
   ConsensusCommon(uint32_t consensus_id, uint64_t block_number,
                   const bytes& block_hash, uint16_t my_id,
@@ -182,7 +190,7 @@ class ConsensusCommon {
                      const Signature& toverify, uint16_t peer_id);
 
   /// Aggregates public keys according to the response map.
-  PubKey AggregateKeys(const std::vector<bool>& peer_map);
+  PubKey AggregateKeys(const Bitmap& peer_map);
 
   /// Aggregates the list of received commits.
   CommitPoint AggregateCommits(const std::vector<CommitPoint>& commits);
@@ -200,6 +208,15 @@ class ConsensusCommon {
 
   PairOfNode GetCommitteeMember(const unsigned int index);
 
+  /// Closes the trace span of the previous state if the state has changed.
+  void TraceStateChange();
+
+  /// Traces the processing of a received consensus message.
+  void TraceMessage(unsigned char msgType, uint64_t startInMicro, bool result);
+
+  /// Traces the end of a consensus subset.
+  void TraceSubsetEnded(uint16_t subsetID, State subsetState);
+
  public:
   /// Consensus message processing function
   virtual bool ProcessMessage([[gnu::unused]] const bytes& message,
@@ -236,13 +253,13 @@ class ConsensusCommon {
   const Signature& GetCS1() const;
 
   /// Returns the co-sig bitmap for first round
-  const std::vector<bool>& GetB1() const;
+  const Bitmap& GetB1() const;
 
   /// Returns the co-sig for second round
   const Signature& GetCS2() const;
 
   /// Returns the co-sig bitmap for second round
-  const std::vector<bool>& GetB2() const;
+  const Bitmap& GetB2() const;
 
   /// Returns the fraction of the shard required to achieve consensus
   static unsigned int NumForConsensus(unsigned int shardSize);
@@ -260,6 +277,8 @@ class ConsensusCommon {
 
  private:
   static std::map<State, std::string> ConsensusStateStrings;
+  static std::map<ConsensusMessageType, std::string>
+      ConsensusMessageTypeStrings;
 };
 
 #endif  // ZILLIQA_SRC_LIBCONSENSUS_CONSENSUSCOMMON_H_
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "ConsensusLatencyTracker.h"
+
+using namespace std;
+
+ConsensusLatencyTracker& ConsensusLatencyTracker::GetInstance() {
+  static ConsensusLatencyTracker tracker;
+  return tracker;
+}
+
+void ConsensusLatencyTracker::RecordCommitLatency(const PubKey& member,
+                                                  unsigned int latencyInMs) {
+  lock_guard<mutex> g(m_mutex);
+  MemberStats& stats = m_members[member];
+  if (!stats.m_hasLatency) {
+    stats.m_avgLatencyInMs = latencyInMs;
+    stats.m_hasLatency = true;
+  } else {
+    stats.m_avgLatencyInMs += LATENCY_SMOOTHING *
+                              (static_cast<double>(latencyInMs) -
+                               stats.m_avgLatencyInMs);
+  }
+}
+
+void ConsensusLatencyTracker::SetCosigPerformance(
+    const map<PubKey, uint32_t>& performance, uint32_t maxCoSigs) {
+  if (maxCoSigs == 0) {
+    return;
+  }
+
+  lock_guard<mutex> g(m_mutex);
+  for (const auto& member : performance) {
+    m_members[member.first].m_cosigRatio =
+        min(1.0, static_cast<double>(member.second) / maxCoSigs);
+  }
+}
+
+double ConsensusLatencyTracker::GetScore(const PubKey& member,
+                                         unsigned int fallbackLatencyInMs) {
+  lock_guard<mutex> g(m_mutex);
+  auto it = m_members.find(member);
+  if (it == m_members.end()) {
+    return fallbackLatencyInMs;
+  }
+
+  const MemberStats& stats = it->second;
+  const double latency = stats.m_hasLatency ? stats.m_avgLatencyInMs
+                                            : fallbackLatencyInMs;
+  // A member that missed every co-signature counts as twice as slow
+  return latency * (2.0 - stats.m_cosigRatio);
+}
+
+void ConsensusLatencyTracker::Clear() {
+  lock_guard<mutex> g(m_mutex);
+  m_members.clear();
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBCONSENSUS_CONSENSUSLATENCYTRACKER_H_
+#define ZILLIQA_SRC_LIBCONSENSUS_CONSENSUSLATENCYTRACKER_H_
+
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include <Schnorr.h>
+
+/// Remembers how quickly each committee member commits across consensus
+/// rounds, so the leader can put the fastest members into the first subset.
+class ConsensusLatencyTracker {
+  // Weight of the newest sample in the moving average
+  static constexpr double LATENCY_SMOOTHING = 0.2;
+
+  struct MemberStats {
+    double m_avgLatencyInMs{0};
+    bool m_hasLatency{false};
+    double m_cosigRatio{1};
+  };
+
+  std::mutex m_mutex;
+  std::unordered_map<PubKey, MemberStats> m_members;
+
+  ConsensusLatencyTracker() = default;
+  ~ConsensusLatencyTracker() = default;
+
+  // Singleton should not implement these
+  ConsensusLatencyTracker(ConsensusLatencyTracker const&) = delete;
+  void operator=(ConsensusLatencyTracker const&) = delete;
+
+ public:
+  /// Returns the singleton instance.
+  static ConsensusLatencyTracker& GetInstance();
+
+  /// Adds the time between the announcement (or collective signature) and
+  /// the member's commit to its moving average.
+  void RecordCommitLatency(const PubKey& member, unsigned int latencyInMs);
+
+  /// Updates the share of co-signatures each member contributed in the last
+  /// DS epoch (see DirectoryService::SaveDSPerformance).
+  void SetCosigPerformance(const std::map<PubKey, uint32_t>& performance,
+                           uint32_t maxCoSigs);
+
+  /// Returns the expected commit latency of the member, inflated for members
+  /// that often miss co-signatures. Lower is better. Members without history
+  /// get fallbackLatencyInMs.
+  double GetScore(const PubKey& member, unsigned int fallbackLatencyInMs);
+
+  /// Forgets all members.
+  void Clear();
+};
+
+#endif  // ZILLIQA_SRC_LIBCONSENSUS_CONSENSUSLATENCYTRACKER_H_
@@ -17,7 +17,11 @@
 
 #include "ConsensusLeader.h"
 
+#include <algorithm>
+#include <tuple>
 #include <utility>
+#include "CommitPool.h"
+#include "ConsensusLatencyTracker.h"
 #include "common/Constants.h"
 #include "common/Messages.h"
 #include "libMessage/Messenger.h"
@@ -27,6 +31,7 @@
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
+#include "libUtils/TraceRecorder.h"
 
 using namespace std;
 
@@ -110,6 +115,19 @@ void ConsensusLeader::GenerateConsensusSubsets() {
       peersWhoCommitted.push_back(index);
     }
   }
+
+  // Order by how fast each peer has been committing so far, so that the first
+  // subset is made up of the peers most likely to respond quickly
+  const unsigned int elapsedInMs = GetElapsedTimeInMs();
+  vector<double> scores(m_committee.size(), 0);
+  for (auto index : peersWhoCommitted) {
+    scores.at(index) = ConsensusLatencyTracker::GetInstance().GetScore(
+        m_committee.at(index).first, elapsedInMs);
+  }
+  stable_sort(peersWhoCommitted.begin(), peersWhoCommitted.end(),
+              [&scores](unsigned int a, unsigned int b) {
+                return scores.at(a) < scores.at(b);
+              });
   // Generate m_numOfSubsets lists (= subsets of peersWhoCommitted)
   // If we have exactly the minimum num required for consensus, no point making
   // more than 1 subset
@@ -126,20 +144,20 @@ void ConsensusLeader::GenerateConsensusSubsets() {
   for (unsigned int i = 0; i < numSubsets; i++) {
     ConsensusSubset& subset = m_consensusSubsets.at(i);
     subset.commitMap.resize(m_committee.size());
-    fill(subset.commitMap.begin(), subset.commitMap.end(), false);
+    subset.commitMap.reset();
     subset.commitPointMap.resize(m_committee.size());
     subset.commitPoints.clear();
     subset.responseCounter = 0;
     subset.responseDataMap.resize(m_committee.size());
     subset.responseMap.resize(m_committee.size());
-    fill(subset.responseMap.begin(), subset.responseMap.end(), false);
+    subset.responseMap.reset();
     subset.responseData.clear();
 
     subset.state = m_state;
     // add myself to subset commit map always
     subset.commitPointMap.at(m_myID) = m_commitPointMap.at(m_myID);
     subset.commitPoints.emplace_back(m_commitPointMap.at(m_myID));
-    subset.commitMap.at(m_myID) = true;
+    subset.commitMap.set(m_myID);
 
     // If DS consensus, then first subset should be of dsguard commits only.
     // Fill in from rest if commits from dsguards < m_numForConsensus
@@ -150,7 +168,7 @@ void ConsensusLeader::GenerateConsensusSubsets() {
         if (index < Guard::GetInstance().GetNumOfDSGuard()) {
           subset.commitPointMap.at(index) = m_commitPointMap.at(index);
           subset.commitPoints.emplace_back(m_commitPointMap.at(index));
-          subset.commitMap.at(index) = true;
+          subset.commitMap.set(index);
           subsetPeers++;
           if (subsetPeers == m_numForConsensus) {
             // got all dsguards commit
@@ -174,7 +192,7 @@ void ConsensusLeader::GenerateConsensusSubsets() {
         for (auto index : nondsguardIndexes) {
           subset.commitPointMap.at(index) = m_commitPointMap.at(index);
           subset.commitPoints.emplace_back(m_commitPointMap.at(index));
-          subset.commitMap.at(index) = true;
+          subset.commitMap.set(index);
           if (++subsetPeers >= m_numForConsensus) {
             break;
           }
@@ -187,7 +205,7 @@ void ConsensusLeader::GenerateConsensusSubsets() {
         unsigned int index = peersWhoCommitted.at(j);
         subset.commitPointMap.at(index) = m_commitPointMap.at(index);
         subset.commitPoints.emplace_back(m_commitPointMap.at(index));
-        subset.commitMap.at(index) = true;
+        subset.commitMap.set(index);
       }
     }
 
@@ -244,7 +262,7 @@ bool ConsensusLeader::StartConsensusSubsets() {
     Response r(*m_commitSecret, subset.challenge, m_myPrivKey);
     subset.responseData.emplace_back(r);
     subset.responseDataMap.at(m_myID) = r;
-    subset.responseMap.at(m_myID) = true;
+    subset.responseMap.set(m_myID);
     subset.responseCounter = 1;
   }
 
@@ -268,6 +286,12 @@ bool ConsensusLeader::StartConsensusSubsets() {
   return true;
 }
 
+unsigned int ConsensusLeader::GetElapsedTimeInMs() const {
+  return chrono::duration_cast<chrono::milliseconds>(
+             chrono::steady_clock::now() - m_roundStartTime)
+      .count();
+}
+
 void ConsensusLeader::LogResponsesStats(unsigned int subsetID) {
   if (m_DS && GUARD_MODE) {
     LOG_MARKER();
@@ -292,6 +316,7 @@ void ConsensusLeader::LogResponsesStats(unsigned int subsetID) {
 void ConsensusLeader::SubsetEnded(uint16_t subsetID) {
   LOG_MARKER();
   ConsensusSubset& subset = m_consensusSubsets.at(subsetID);
+  TraceSubsetEnded(subsetID, subset.state);
   if (subset.state == COLLECTIVESIG_DONE || subset.state == DONE) {
     // We've achieved consensus!
     LOG_GENERAL(INFO, "[Subset " << subsetID << "] Subset DONE");
@@ -328,8 +353,6 @@ bool ConsensusLeader::ProcessMessageCommitCore(
     [[gnu::unused]] State nextstate, const Peer& from) {
   LOG_MARKER();
 
-  lock_guard<mutex> g(m_mutex);
-
   // Initial checks
   // ==============
 
@@ -338,6 +361,8 @@ bool ConsensusLeader::ProcessMessageCommitCore(
   }
 
   // Extract and check commit message body
+  // The signature is verified without holding m_mutex so that commits from
+  // different backups are checked in parallel by the message pool threads
   // =====================================
 
   uint16_t backupID = 0;
@@ -360,11 +385,6 @@ bool ConsensusLeader::ProcessMessageCommitCore(
     return false;
   }
 
-  if (m_commitMap.at(backupID)) {
-    LOG_GENERAL(WARNING, "Backup already sent commit");
-    return false;
-  }
-
   // Check the commit
   if (!commitPoint.Initialized()) {
     LOG_GENERAL(WARNING, "Invalid commit");
@@ -388,17 +408,27 @@ bool ConsensusLeader::ProcessMessageCommitCore(
   // Update internal state
   // =====================
 
+  lock_guard<mutex> g(m_mutex);
+
   if (!CheckState(action)) {
     return false;
   }
 
+  if (m_commitMap.at(backupID)) {
+    LOG_GENERAL(WARNING, "Backup already sent commit");
+    return false;
+  }
+
   // 33-byte commit
   m_commitPoints.emplace_back(commitPoint);
   m_commitPointMap.at(backupID) = commitPoint;
-  m_commitMap.at(backupID) = true;
+  m_commitMap.set(backupID);
 
   m_commitCounter++;
 
+  ConsensusLatencyTracker::GetInstance().RecordCommitLatency(
+      m_committee.at(backupID).first, GetElapsedTimeInMs());
+
   if (m_commitCounter % 10 == 0) {
     LOG_GENERAL(INFO, "Received commits = " << m_commitCounter << " / "
                                             << m_numForConsensus);
@@ -407,7 +437,7 @@ bool ConsensusLeader::ProcessMessageCommitCore(
   // Redundant commits
   if (m_commitCounter > m_numForConsensus) {
     m_commitRedundantPointMap.at(backupID) = commitPoint;
-    m_commitRedundantMap.at(backupID) = true;
+    m_commitRedundantMap.set(backupID);
     m_commitRedundantCounter++;
   }
 
@@ -552,6 +582,37 @@ bool ConsensusLeader::GenerateChallengeMessage(bytes& challenge,
   return true;
 }
 
+bool ConsensusLeader::CheckResponseAllowed(uint16_t subsetID,
+                                           uint16_t backupID, Action action) {
+  // Check subset state
+  if (!CheckStateSubset(subsetID, action)) {
+    return false;
+  }
+
+  const ConsensusSubset& subset = m_consensusSubsets.at(subsetID);
+
+  // Check the backup id
+  if (backupID >= subset.responseDataMap.size()) {
+    LOG_GENERAL(WARNING, "[Subset " << subsetID << "] Backup ID " << backupID
+                                    << " >= " << subset.responseDataMap.size());
+    return false;
+  }
+
+  if (!subset.commitMap.at(backupID)) {
+    LOG_GENERAL(WARNING, "[Subset " << subsetID << "] [Backup " << backupID
+                                    << "] Didn't commit");
+    return false;
+  }
+
+  if (subset.responseMap.at(backupID)) {
+    LOG_GENERAL(WARNING, "[Subset " << subsetID << "] [Backup " << backupID
+                                    << "] Already responded");
+    return false;
+  }
+
+  return true;
+}
+
 bool ConsensusLeader::ProcessMessageResponseCore(
     const bytes& response, unsigned int offset, Action action,
     ConsensusMessageType returnmsgtype, State nextstate, const Peer& from) {
@@ -592,37 +653,22 @@ bool ConsensusLeader::ProcessMessageResponseCore(
   }
 
   for (unsigned int subsetID = 0; subsetID < subsetInfo.size(); subsetID++) {
-    // Check subset state
-    if (!CheckStateSubset(subsetID, action)) {
-      continue;
-    }
-
-    ConsensusSubset& subset = m_consensusSubsets.at(subsetID);
-
-    // Check the backup id
-    if (backupID >= subset.responseDataMap.size()) {
-      LOG_GENERAL(WARNING, "[Subset "
-                               << subsetID << "] Backup ID " << backupID
-                               << " >= " << subset.responseDataMap.size());
-      continue;
-    }
-
-    if (!subset.commitMap.at(backupID)) {
-      LOG_GENERAL(WARNING, "[Subset " << subsetID << "] [Backup " << backupID
-                                      << "] Didn't commit");
-      continue;
-    }
-
-    if (subset.responseMap.at(backupID)) {
-      LOG_GENERAL(WARNING, "[Subset " << subsetID << "] [Backup " << backupID
-                                      << "] Already responded");
-      continue;
+    // Take a copy of what the response is verified against, so that the
+    // verification itself runs without holding m_mutex
+    Challenge challenge;
+    CommitPoint commitPoint;
+    {
+      lock_guard<mutex> g(m_mutex);
+      if (!CheckResponseAllowed(subsetID, backupID, action)) {
+        continue;
+      }
+      challenge = m_consensusSubsets.at(subsetID).challenge;
+      commitPoint = m_consensusSubsets.at(subsetID).commitPointMap.at(backupID);
     }
 
-    if (!MultiSig::VerifyResponse(subsetInfo.at(subsetID).response,
-                                  subset.challenge,
+    if (!MultiSig::VerifyResponse(subsetInfo.at(subsetID).response, challenge,
                                   GetCommitteeMember(backupID).first,
-                                  subset.commitPointMap.at(backupID))) {
+                                  commitPoint)) {
       LOG_GENERAL(WARNING, "[Subset " << subsetID << "] [Backup " << backupID
                                       << "] Invalid response");
       continue;
@@ -636,14 +682,17 @@ bool ConsensusLeader::ProcessMessageResponseCore(
       return false;
     }
 
-    if (!CheckStateSubset(subsetID, action)) {
-      return false;
+    // Another response from this backup may have been recorded meanwhile
+    if (!CheckResponseAllowed(subsetID, backupID, action)) {
+      continue;
     }
 
+    ConsensusSubset& subset = m_consensusSubsets.at(subsetID);
+
     // 32-byte response
     subset.responseData.emplace_back(subsetInfo.at(subsetID).response);
     subset.responseDataMap.at(backupID) = subsetInfo.at(subsetID).response;
-    subset.responseMap.at(backupID) = true;
+    subset.responseMap.set(backupID);
     subset.responseCounter++;
 
     if (subset.responseCounter % 10 == 0) {
@@ -684,13 +733,14 @@ bool ConsensusLeader::ProcessMessageResponseCore(
         m_B1 = subset.responseMap;
 
         // reset settings for second round of consensus
+        m_roundStartTime = chrono::steady_clock::now();
         m_commitMap.resize(m_committee.size());
-        fill(m_commitMap.begin(), m_commitMap.end(), false);
+        m_commitMap.reset();
         m_commitPointMap.resize(m_committee.size());
         m_commitPoints.clear();
 
         // Add the leader to the commits
-        m_commitMap.at(m_myID) = true;
+        m_commitMap.set(m_myID);
         m_commitPoints.emplace_back(*m_commitPoint);
         m_commitPointMap.at(m_myID) = *m_commitPoint;
         m_commitCounter = 1;
@@ -699,7 +749,7 @@ bool ConsensusLeader::ProcessMessageResponseCore(
         m_commitFailureMap.clear();
 
         m_commitRedundantCounter = 0;
-        fill(m_commitRedundantMap.begin(), m_commitRedundantMap.end(), false);
+        m_commitRedundantMap.reset();
 
       } else {
         // Save the collective sig over the second round
@@ -863,11 +913,10 @@ ConsensusLeader::ConsensusLeader(
   m_nodeCommitFailureHandlerFunc = move(nodeCommitFailureHandlerFunc);
   m_shardCommitFailureHandlerFunc = move(shardCommitFailureHandlerFunc);
 
-  m_commitSecret.reset(new CommitSecret());
-  m_commitPoint.reset(new CommitPoint(*m_commitSecret));
+  tie(m_commitSecret, m_commitPoint) = CommitPool::GetInstance().GetCommit();
 
   // Add the leader to the commits
-  m_commitMap.at(m_myID) = true;
+  m_commitMap.set(m_myID);
   m_commitPoints.emplace_back(*m_commitPoint);
   m_commitPointMap.at(m_myID) = *m_commitPoint;
   m_commitCounter = 1;
@@ -923,8 +972,10 @@ bool ConsensusLeader::StartConsensus(
   // =====================
 
   m_state = ANNOUNCE_DONE;
+  m_roundStartTime = chrono::steady_clock::now();
   m_commitRedundantCounter = 0;
   m_commitFailureCounter = 0;
+  TraceStateChange();
 
   // Multicast to all nodes in the committee
   // =======================================
@@ -969,6 +1020,7 @@ bool ConsensusLeader::StartConsensus(
         GenerateConsensusSubsets();
         StartConsensusSubsets();
       }
+      TraceStateChange();
     };
     DetachedFunction(1, func);
   }
@@ -984,6 +1036,8 @@ bool ConsensusLeader::ProcessMessage(const bytes& message, unsigned int offset,
   // [consensus message]
 
   bool result = false;
+  const uint64_t startInMicro =
+      ENABLE_CONSENSUS_TRACE ? TraceRecorder::NowInMicro() : 0;
 
   switch (message.at(offset)) {
     case ConsensusMessageType::COMMIT:
@@ -1006,6 +1060,8 @@ bool ConsensusLeader::ProcessMessage(const bytes& message, unsigned int offset,
                   "Unknown msg type " << (unsigned int)message.at(offset));
   }
 
+  TraceMessage(message.at(offset), startInMicro, result);
+
   return result;
 }
 
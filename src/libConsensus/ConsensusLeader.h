@@ -18,6 +18,7 @@
 #ifndef ZILLIQA_SRC_LIBCONSENSUS_CONSENSUSLEADER_H_
 #define ZILLIQA_SRC_LIBCONSENSUS_CONSENSUSLEADER_H_
 
+#include <chrono>
 #include <deque>
 #include <functional>
 #include <memory>
@@ -64,13 +65,13 @@ class ConsensusLeader : public ConsensusCommon {
   bool m_sufficientCommitsReceived;
   unsigned int m_sufficientCommitsNumForSubsets;
 
-  std::vector<bool> m_commitMap;
+  Bitmap m_commitMap;
   std::vector<CommitPoint>
       m_commitPointMap;  // ordered list of commits of size = committee size
   std::vector<CommitPoint> m_commitPoints;  // unordered list of commits of size
                                             // = 2/3 of committee size + 1
   unsigned int m_commitRedundantCounter;
-  std::vector<bool> m_commitRedundantMap;
+  Bitmap m_commitRedundantMap;
   std::vector<CommitPoint>
       m_commitRedundantPointMap;  // ordered list of redundant commits of size =
                                   // 1/3 of committee size
@@ -82,7 +83,7 @@ class ConsensusLeader : public ConsensusCommon {
 
   // Tracking data for each consensus subset
   struct ConsensusSubset {
-    std::vector<bool> commitMap;
+    Bitmap commitMap;
     std::vector<CommitPoint> commitPointMap;  // Ordered list of commits of
                                               // fixed size = committee size
     std::vector<CommitPoint> commitPoints;
@@ -91,7 +92,7 @@ class ConsensusLeader : public ConsensusCommon {
     std::vector<Response> responseDataMap;  // Ordered list of responses of
                                             // fixed size = committee size
     /// Response map for the generated collective signature
-    std::vector<bool> responseMap;
+    Bitmap responseMap;
     std::vector<Response> responseData;
     Signature collectiveSig;
     State state{};  // Subset consensus state
@@ -99,16 +100,23 @@ class ConsensusLeader : public ConsensusCommon {
   std::vector<ConsensusSubset> m_consensusSubsets;
   unsigned int m_numSubsetsRunning;
 
+  // Time the announcement (or the first round's collective signature) was
+  // sent, used to measure how fast each backup commits
+  std::chrono::steady_clock::time_point m_roundStartTime;
+
   NodeCommitFailureHandlerFunc m_nodeCommitFailureHandlerFunc;
   ShardCommitFailureHandlerFunc m_shardCommitFailureHandlerFunc;
 
   // Internal functions
   bool CheckState(Action action);
   bool CheckStateSubset(uint16_t subsetID, Action action);
+  bool CheckResponseAllowed(uint16_t subsetID, uint16_t backupID,
+                            Action action);
   void SetStateSubset(uint16_t subsetID, State newState);
   void GenerateConsensusSubsets();
   bool StartConsensusSubsets();
   void SubsetEnded(uint16_t subsetID);
+  unsigned int GetElapsedTimeInMs() const;
   bool ProcessMessageCommitCore(const bytes& commit, unsigned int offset,
                                 Action action,
                                 ConsensusMessageType returnmsgtype,
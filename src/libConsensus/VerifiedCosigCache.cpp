@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <MultiSig.h>
+#include <algorithm>
+
+#include "VerifiedCosigCache.h"
+#include "common/Constants.h"
+#include "libCrypto/Sha2.h"
+#include "libUtils/BitVector.h"
+
+using namespace std;
+
+VerifiedCosigCache::VerifiedCosigCache(unsigned int capacity)
+    : m_capacity(capacity) {}
+
+VerifiedCosigCache& VerifiedCosigCache::GetInstance() {
+  static VerifiedCosigCache instance(VERIFIED_COSIG_CACHE_SIZE);
+  return instance;
+}
+
+VerifiedCosigCache::Digest VerifiedCosigCache::GetDigest(
+    const bytes& message, unsigned int offset, unsigned int size,
+    const Signature& cs2, const Bitmap& b2, const PubKey& aggregatedKey) {
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  sha2.Update(message, offset, size);
+
+  bytes serialized;
+  cs2.Serialize(serialized, 0);
+  BitVector::SetBitVector(serialized, serialized.size(), b2);
+  aggregatedKey.Serialize(serialized, serialized.size());
+  sha2.Update(serialized);
+
+  const bytes hash = sha2.Finalize();
+  Digest digest{};
+  copy_n(hash.begin(), min<size_t>(hash.size(), DIGEST_SIZE), digest.begin());
+  return digest;
+}
+
+bool VerifiedCosigCache::Contains(const Digest& digest) {
+  lock_guard<mutex> g(m_mutex);
+  auto it = m_entries.find(digest);
+  if (it == m_entries.end()) {
+    return false;
+  }
+  m_recency.splice(m_recency.begin(), m_recency, it->second);
+  return true;
+}
+
+void VerifiedCosigCache::Insert(const Digest& digest) {
+  lock_guard<mutex> g(m_mutex);
+  if (m_entries.find(digest) != m_entries.end()) {
+    return;
+  }
+  m_recency.push_front(digest);
+  m_entries.emplace(digest, m_recency.begin());
+  if (m_recency.size() > m_capacity) {
+    m_entries.erase(m_recency.back());
+    m_recency.pop_back();
+  }
+}
+
+bool VerifiedCosigCache::MultiSigVerify(const bytes& message,
+                                        unsigned int offset, unsigned int size,
+                                        const Signature& cs2, const Bitmap& b2,
+                                        const PubKey& aggregatedKey) {
+  if (m_capacity == 0) {
+    return MultiSig::MultiSigVerify(message, offset, size, cs2, aggregatedKey);
+  }
+
+  const Digest digest =
+      GetDigest(message, offset, size, cs2, b2, aggregatedKey);
+  if (Contains(digest)) {
+    return true;
+  }
+
+  if (!MultiSig::MultiSigVerify(message, offset, size, cs2, aggregatedKey)) {
+    return false;
+  }
+
+  Insert(digest);
+  return true;
+}
+
+size_t VerifiedCosigCache::Size() {
+  lock_guard<mutex> g(m_mutex);
+  return m_entries.size();
+}
+
+void VerifiedCosigCache::Clear() {
+  lock_guard<mutex> g(m_mutex);
+  m_entries.clear();
+  m_recency.clear();
+}
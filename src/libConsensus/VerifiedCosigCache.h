@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBCONSENSUS_VERIFIEDCOSIGCACHE_H_
+#define ZILLIQA_SRC_LIBCONSENSUS_VERIFIEDCOSIGCACHE_H_
+
+#include <array>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include <Schnorr.h>
+
+#include "libUtils/Bitmap.h"
+
+/// Remembers the block cosignatures that passed verification, so copies of
+/// the same block arriving from other senders skip MultiSigVerify. Entries
+/// are keyed by a digest of the signed message (header, CS1 and B1), CS2, B2
+/// and the aggregated key, and the least recently used entry is evicted once
+/// the cache is full. Failed verifications are never cached.
+class VerifiedCosigCache {
+  static const unsigned int DIGEST_SIZE = 32;
+  using Digest = std::array<unsigned char, DIGEST_SIZE>;
+
+  struct DigestHash {
+    std::size_t operator()(const Digest& d) const {
+      // The digest is already uniformly distributed
+      std::size_t h;
+      std::memcpy(&h, d.data(), sizeof(h));
+      return h;
+    }
+  };
+
+  const unsigned int m_capacity;
+  std::mutex m_mutex;
+  std::list<Digest> m_recency;  // most recently used first
+  std::unordered_map<Digest, std::list<Digest>::iterator, DigestHash>
+      m_entries;
+
+  static Digest GetDigest(const bytes& message, unsigned int offset,
+                          unsigned int size, const Signature& cs2,
+                          const Bitmap& b2, const PubKey& aggregatedKey);
+  bool Contains(const Digest& digest);
+  void Insert(const Digest& digest);
+
+ public:
+  /// A capacity of 0 disables caching.
+  explicit VerifiedCosigCache(unsigned int capacity);
+
+  // Singleton should not implement these
+  VerifiedCosigCache(VerifiedCosigCache const&) = delete;
+  void operator=(VerifiedCosigCache const&) = delete;
+
+  /// Returns the instance shared by the block receive paths.
+  static VerifiedCosigCache& GetInstance();
+
+  /// Same as MultiSig::MultiSigVerify, but returns immediately for a tuple
+  /// that was verified before.
+  bool MultiSigVerify(const bytes& message, unsigned int offset,
+                      unsigned int size, const Signature& cs2,
+                      const Bitmap& b2, const PubKey& aggregatedKey);
+
+  /// Returns the number of cached entries.
+  size_t Size();
+
+  /// Drops all cached entries.
+  void Clear();
+};
+
+#endif  // ZILLIQA_SRC_LIBCONSENSUS_VERIFIEDCOSIGCACHE_H_
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBCRYPTO_PUBKEYHASH_H_
+#define ZILLIQA_SRC_LIBCRYPTO_PUBKEYHASH_H_
+
+#include <Schnorr.h>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+/// Hashes a PubKey using a 64-bit fingerprint of its compressed form. The x
+/// coordinate is already uniformly distributed, so its first 8 bytes mixed
+/// with the parity prefix are enough, and a lookup costs one serialization
+/// instead of one per comparison of an ordered map.
+struct PubKeyHash {
+  static uint64_t Fingerprint(const PubKey& pubKey) {
+    static thread_local bytes buffer;
+    buffer.clear();
+    pubKey.Serialize(buffer, 0);
+
+    uint64_t fingerprint = 0;
+    for (unsigned int i = 1; i < buffer.size() && i <= sizeof(uint64_t); ++i) {
+      fingerprint = (fingerprint << 8) | buffer[i];
+    }
+    if (!buffer.empty()) {
+      fingerprint ^= static_cast<uint64_t>(buffer[0]) << 56;
+    }
+    return fingerprint;
+  }
+
+  std::size_t operator()(const PubKey& pubKey) const {
+    return static_cast<std::size_t>(Fingerprint(pubKey));
+  }
+};
+
+/// Unordered containers keyed on PubKey, for bookkeeping that never depends
+/// on the order of the keys
+template <typename T>
+using PubKeyHashMap = std::unordered_map<PubKey, T, PubKeyHash>;
+using PubKeyHashSet = std::unordered_set<PubKey, PubKeyHash>;
+
+#endif  // ZILLIQA_SRC_LIBCRYPTO_PUBKEYHASH_H_
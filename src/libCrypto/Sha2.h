@@ -29,14 +29,16 @@ class HashType {
   static const unsigned int HASH_VARIANT_512 = 512;
 };
 
-/// Implements SHA2 hash algorithm.
+/// Implements SHA2 hash algorithm. OpenSSL picks the SHA-NI or ARMv8
+/// crypto extension code at runtime when the CPU has it.
 template <unsigned int SIZE>
 class SHA2 {
-  static const unsigned int HASH_OUTPUT_SIZE = SIZE / 8;
   SHA256_CTX m_context{};
   bytes output;
 
  public:
+  static const unsigned int HASH_OUTPUT_SIZE = SIZE / 8;
+
   /// Constructor.
   SHA2() : output(HASH_OUTPUT_SIZE) {
     if (SIZE != HashType::HASH_VARIANT_256) {
@@ -70,6 +72,11 @@ class SHA2 {
     SHA256_Update(&m_context, input.data() + offset, size);
   }
 
+  /// Hash update function.
+  void Update(const uint8_t* input, size_t size) {
+    SHA256_Update(&m_context, input, size);
+  }
+
   /// Resets the algorithm.
   void Reset() { SHA256_Init(&m_context); }
 
@@ -84,6 +91,29 @@ class SHA2 {
     }
     return output;
   }
+
+  /// Hash finalize function, writing the HASH_OUTPUT_SIZE bytes to dst.
+  void Finalize(uint8_t* dst) { SHA256_Final(dst, &m_context); }
+
+  /// Hashes size bytes of input into the HASH_OUTPUT_SIZE bytes of dst.
+  static void Hash(const uint8_t* input, size_t size, uint8_t* dst) {
+    SHA256_CTX context;
+    SHA256_Init(&context);
+    SHA256_Update(&context, input, size);
+    SHA256_Final(dst, &context);
+  }
+
+  /// Hashes each of inputs on its own, writing the digests one after the
+  /// other in dst, which must hold inputs.size() * HASH_OUTPUT_SIZE bytes.
+  static void HashMany(const std::vector<bytes>& inputs, uint8_t* dst) {
+    SHA256_CTX context;
+    for (const auto& input : inputs) {
+      SHA256_Init(&context);
+      SHA256_Update(&context, input.data(), input.size());
+      SHA256_Final(dst, &context);
+      dst += HASH_OUTPUT_SIZE;
+    }
+  }
 };
 
 #endif  // ZILLIQA_SRC_LIBCRYPTO_SHA2_H_
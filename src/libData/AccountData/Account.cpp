@@ -293,6 +293,28 @@ bool Account::FetchStateJson(Json::Value& root, const string& vname,
   return true;
 }
 
+bool Account::FetchStateJsonPage(Json::Value& root, const string& startAfter,
+                                 unsigned int pageSize,
+                                 string& nextStartAfter) const {
+  if (!isContract()) {
+    LOG_GENERAL(WARNING,
+                "Not contract account, why call Account::FetchStateJsonPage!");
+    return false;
+  }
+
+  if (!ContractStorage2::GetContractStorage().FetchStateJsonPageForContract(
+          root, GetAddress(), startAfter, pageSize, nextStartAfter)) {
+    LOG_GENERAL(WARNING,
+                "ContractStorage2::FetchStateJsonPageForContract failed");
+    return false;
+  }
+
+  if (startAfter.empty()) {
+    root["_balance"] = GetBalance().convert_to<string>();
+  }
+  return true;
+}
+
 Address Account::GetAddressFromPublicKey(const PubKey& pubKey) {
   Address address;
 
@@ -182,6 +182,13 @@ class Account : public AccountBase {
                       const std::vector<std::string>& indices = {},
                       bool temp = false) const;
 
+  /// Fetches one page of the committed states, see
+  /// ContractStorage2::FetchStateJsonPageForContract. The first page also
+  /// has the balance.
+  bool FetchStateJsonPage(Json::Value& root, const std::string& startAfter,
+                          unsigned int pageSize,
+                          std::string& nextStartAfter) const;
+
   /// Computes an account address from a specified PubKey.
   static Address GetAddressFromPublicKey(const PubKey& pubKey);
 
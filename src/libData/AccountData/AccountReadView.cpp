@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <mutex>
+
+#include "AccountReadView.h"
+
+using namespace std;
+
+AccountReadView::AccountReadView(unsigned int capacity)
+    : m_capacityPerStripe(max(capacity / NUM_STRIPES, 1u)) {}
+
+AccountReadView::Stripe& AccountReadView::GetStripe(const Address& address) {
+  return m_stripes[address[ACC_ADDR_SIZE - 1] % NUM_STRIPES];
+}
+
+const AccountReadView::Stripe& AccountReadView::GetStripe(
+    const Address& address) const {
+  return m_stripes[address[ACC_ADDR_SIZE - 1] % NUM_STRIPES];
+}
+
+bool AccountReadView::Get(const Address& address, Account& account) const {
+  const Stripe& stripe = GetStripe(address);
+  shared_lock<shared_timed_mutex> lock(stripe.m_mutex);
+
+  auto it = stripe.m_accounts.find(address);
+  if (it == stripe.m_accounts.end()) {
+    return false;
+  }
+  account = it->second;
+  return true;
+}
+
+void AccountReadView::Put(const Address& address, const Account& account) {
+  Stripe& stripe = GetStripe(address);
+  unique_lock<shared_timed_mutex> lock(stripe.m_mutex);
+
+  auto it = stripe.m_accounts.find(address);
+  if (it != stripe.m_accounts.end()) {
+    it->second = account;
+    return;
+  }
+  if (stripe.m_accounts.size() >= m_capacityPerStripe) {
+    stripe.m_accounts.clear();
+  }
+  stripe.m_accounts.emplace(address, account);
+}
+
+void AccountReadView::Remove(const Address& address) {
+  Stripe& stripe = GetStripe(address);
+  unique_lock<shared_timed_mutex> lock(stripe.m_mutex);
+  stripe.m_accounts.erase(address);
+}
+
+void AccountReadView::Clear() {
+  for (auto& stripe : m_stripes) {
+    unique_lock<shared_timed_mutex> lock(stripe.m_mutex);
+    stripe.m_accounts.clear();
+  }
+}
+
+size_t AccountReadView::Size() const {
+  size_t size = 0;
+  for (const auto& stripe : m_stripes) {
+    shared_lock<shared_timed_mutex> lock(stripe.m_mutex);
+    size += stripe.m_accounts.size();
+  }
+  return size;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_ACCOUNTREADVIEW_H_
+#define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_ACCOUNTREADVIEW_H_
+
+#include <array>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "Account.h"
+#include "Address.h"
+
+/// Copies of committed accounts, for reads that should not wait while a block
+/// is applied to the account store or written to disk.
+/// An entry is only ever replaced by the next committed copy or dropped, so a
+/// copy found here is never older than the committed state. Addresses are
+/// split over independently locked stripes, and a full stripe is emptied
+/// before taking a new address.
+class AccountReadView {
+  static const unsigned int NUM_STRIPES = 16;
+
+  struct Stripe {
+    mutable std::shared_timed_mutex m_mutex;
+    std::unordered_map<Address, Account> m_accounts;
+  };
+
+  std::array<Stripe, NUM_STRIPES> m_stripes;
+  const unsigned int m_capacityPerStripe;
+
+  Stripe& GetStripe(const Address& address);
+  const Stripe& GetStripe(const Address& address) const;
+
+ public:
+  explicit AccountReadView(unsigned int capacity);
+
+  /// Copies the account into account. Returns false if there is no copy.
+  bool Get(const Address& address, Account& account) const;
+
+  /// Stores the committed copy of the account.
+  void Put(const Address& address, const Account& account);
+
+  /// Drops the copy of the account.
+  void Remove(const Address& address);
+
+  /// Drops all copies.
+  void Clear();
+
+  std::size_t Size() const;
+};
+
+#endif  // ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_ACCOUNTREADVIEW_H_
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "AccountSnapshot.h"
+
+using namespace std;
+
+AccountSnapshot::AccountSnapshot(unsigned int capacity)
+    : m_capacityPerBucket(max(capacity / NUM_BUCKETS, 1u)) {
+  for (auto& bucket : m_buckets) {
+    bucket = make_shared<const Bucket>();
+  }
+}
+
+unsigned int AccountSnapshot::GetBucketIndex(const Address& address) {
+  return address[ACC_ADDR_SIZE - 1] % NUM_BUCKETS;
+}
+
+bool AccountSnapshot::Get(const Address& address, Entry& entry) const {
+  const auto bucket = atomic_load(&m_buckets[GetBucketIndex(address)]);
+
+  auto it = bucket->find(address);
+  if (it == bucket->end()) {
+    return false;
+  }
+  entry = it->second;
+  return true;
+}
+
+void AccountSnapshot::Offer(const Address& address, const Entry& entry,
+                           uint64_t version) {
+  lock_guard<mutex> g(m_mutexStaged);
+  if (version != m_version ||
+      m_offers.size() >= m_capacityPerBucket * NUM_BUCKETS) {
+    return;
+  }
+  m_offers.emplace_back(address, entry);
+}
+
+void AccountSnapshot::Update(const Address& address, const Entry& entry) {
+  lock_guard<mutex> g(m_mutexStaged);
+  m_stagedRemovals.erase(address);
+  m_stagedUpdates[address] = entry;
+}
+
+void AccountSnapshot::Remove(const Address& address) {
+  lock_guard<mutex> g(m_mutexStaged);
+  m_stagedUpdates.erase(address);
+  m_stagedRemovals.insert(address);
+}
+
+void AccountSnapshot::Publish() {
+  lock_guard<mutex> g(m_mutexStaged);
+
+  // Copies of the buckets touched, made on first use
+  array<shared_ptr<Bucket>, NUM_BUCKETS> copies;
+  const auto getCopy = [this, &copies](const Address& address) -> Bucket& {
+    const unsigned int index = GetBucketIndex(address);
+    if (!copies[index]) {
+      copies[index] = make_shared<Bucket>(*atomic_load(&m_buckets[index]));
+    }
+    return *copies[index];
+  };
+
+  // The staged changes come after the offers, which may be older
+  for (const auto& offer : m_offers) {
+    getCopy(offer.first)[offer.first] = offer.second;
+  }
+  for (const auto& update : m_stagedUpdates) {
+    getCopy(update.first)[update.first] = update.second;
+  }
+  for (const auto& address : m_stagedRemovals) {
+    const unsigned int index = GetBucketIndex(address);
+    if (copies[index] || atomic_load(&m_buckets[index])->count(address) > 0) {
+      getCopy(address).erase(address);
+    }
+  }
+
+  for (unsigned int i = 0; i < NUM_BUCKETS; i++) {
+    if (!copies[i]) {
+      continue;
+    }
+    // A full bucket is emptied down to the accounts just committed
+    if (copies[i]->size() > m_capacityPerBucket) {
+      auto& bucket = *copies[i];
+      for (auto it = bucket.begin();
+           it != bucket.end() && bucket.size() > m_capacityPerBucket;) {
+        it = m_stagedUpdates.count(it->first) ? next(it) : bucket.erase(it);
+      }
+    }
+    atomic_store(&m_buckets[i], shared_ptr<const Bucket>(move(copies[i])));
+  }
+  m_version++;
+
+  {
+    lock_guard<mutex> g2(m_mutexPending);
+    for (const auto& update : m_stagedUpdates) {
+      auto it = m_pendingNonces.find(update.first);
+      if (it != m_pendingNonces.end() &&
+          it->second <= update.second.m_nonce) {
+        m_pendingNonces.erase(it);
+      }
+    }
+    for (const auto& address : m_stagedRemovals) {
+      m_pendingNonces.erase(address);
+    }
+  }
+
+  m_stagedUpdates.clear();
+  m_stagedRemovals.clear();
+  m_offers.clear();
+}
+
+void AccountSnapshot::Clear() {
+  {
+    lock_guard<mutex> g(m_mutexStaged);
+    m_stagedUpdates.clear();
+    m_stagedRemovals.clear();
+    m_offers.clear();
+    for (auto& bucket : m_buckets) {
+      atomic_store(&bucket, make_shared<const Bucket>());
+    }
+    m_version++;
+  }
+
+  lock_guard<mutex> g(m_mutexPending);
+  m_pendingNonces.clear();
+}
+
+void AccountSnapshot::AdmitNonce(const Address& address, uint64_t nonce) {
+  lock_guard<mutex> g(m_mutexPending);
+  auto it = m_pendingNonces.find(address);
+  if (it != m_pendingNonces.end()) {
+    it->second = max(it->second, nonce);
+    return;
+  }
+  // Senders whose txns never commit would otherwise stay forever
+  if (m_pendingNonces.size() >= m_capacityPerBucket * NUM_BUCKETS) {
+    m_pendingNonces.clear();
+  }
+  m_pendingNonces.emplace(address, nonce);
+}
+
+uint64_t AccountSnapshot::GetPendingNonce(const Address& address,
+                                          uint64_t committedNonce) const {
+  lock_guard<mutex> g(m_mutexPending);
+  auto it = m_pendingNonces.find(address);
+  return it == m_pendingNonces.end() ? committedNonce
+                                     : max(it->second, committedNonce);
+}
+
+size_t AccountSnapshot::Size() const {
+  size_t size = 0;
+  for (const auto& bucket : m_buckets) {
+    size += atomic_load(&bucket)->size();
+  }
+  return size;
+}
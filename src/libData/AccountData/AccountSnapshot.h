@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_ACCOUNTSNAPSHOT_H_
+#define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_ACCOUNTSNAPSHOT_H_
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include "Address.h"
+
+/// Balances and nonces of committed accounts, for the admission checks of
+/// incoming transactions. Readers take the buckets last published without
+/// any lock; the committing thread stages the changes of a commit and
+/// publishes copies of the buckets they touch once the commit is in.
+/// The highest nonce admitted per sender since is tracked on top.
+class AccountSnapshot {
+ public:
+  struct Entry {
+    boost::multiprecision::uint128_t m_balance;
+    uint64_t m_nonce;
+  };
+
+  explicit AccountSnapshot(unsigned int capacity);
+
+  /// Returns false if the account is not in the snapshot.
+  bool Get(const Address& address, Entry& entry) const;
+
+  /// Number of snapshots published so far.
+  uint64_t GetVersion() const { return m_version; }
+
+  /// Offers the entry read from the committed state while the snapshot was
+  /// at version. It is taken in at the next Publish if none came in between.
+  void Offer(const Address& address, const Entry& entry, uint64_t version);
+
+  /// Stages the committed entry of the account for the next Publish.
+  void Update(const Address& address, const Entry& entry);
+
+  /// Stages the removal of the account for the next Publish.
+  void Remove(const Address& address);
+
+  /// Publishes the staged changes and offers.
+  void Publish();
+
+  /// Drops all entries and pending nonces.
+  void Clear();
+
+  /// Records a nonce admitted for the sender.
+  void AdmitNonce(const Address& address, uint64_t nonce);
+
+  /// The highest nonce admitted for the sender, or else committedNonce.
+  uint64_t GetPendingNonce(const Address& address,
+                           uint64_t committedNonce) const;
+
+  std::size_t Size() const;
+
+ private:
+  static const unsigned int NUM_BUCKETS = 64;
+
+  using Bucket = std::unordered_map<Address, Entry>;
+
+  static unsigned int GetBucketIndex(const Address& address);
+
+  std::array<std::shared_ptr<const Bucket>, NUM_BUCKETS> m_buckets;
+  const unsigned int m_capacityPerBucket;
+  std::atomic<uint64_t> m_version{0};
+
+  mutable std::mutex m_mutexStaged;
+  std::map<Address, Entry> m_stagedUpdates;
+  std::set<Address> m_stagedRemovals;
+  std::vector<std::pair<Address, Entry>> m_offers;
+
+  mutable std::mutex m_mutexPending;
+  std::unordered_map<Address, uint64_t> m_pendingNonces;
+};
+
+#endif  // ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_ACCOUNTSNAPSHOT_H_
@@ -27,6 +27,8 @@
 #include "libPersistence/ScillaMessage.pb.h"
 #pragma GCC diagnostic pop
 #include "libServer/ScillaIPCServer.h"
+#include "libUtils/EpochPerf.h"
+#include "libUtils/MemFile.h"
 #include "libUtils/SysCommand.h"
 
 using namespace std;
@@ -34,9 +36,18 @@ using namespace dev;
 using namespace boost::multiprecision;
 using namespace Contract;
 
-AccountStore::AccountStore() {
+AccountStore::AccountStore()
+    : m_readView(ACCOUNT_READ_VIEW_SIZE), m_snapshot(ACCOUNT_READ_VIEW_SIZE) {
   m_accountStoreTemp = make_unique<AccountStoreTemp>(*this);
 
+  m_db.EnableNodeCache(static_cast<size_t>(STATE_TRIE_NODE_CACHE_SIZE_IN_MB) *
+                       1024 * 1024);
+
+  if (TXN_EXECUTION_THREADS > 1) {
+    m_txnExecutionPool =
+        make_unique<ThreadPool>(TXN_EXECUTION_THREADS, "TxnExecution");
+  }
+
   /// Scilla IPC Server
   if (ENABLE_SC) {
     /// remove previous file path
@@ -55,6 +66,37 @@ AccountStore::AccountStore() {
         LOG_GENERAL(WARNING, "Scilla IPC Server couldn't start")
       }
     }
+
+    // Contract calls run in parallel need their own scilla files, which only
+    // memfds keep apart
+    if (DS_PARALLEL_CONTRACT_CALLS && (m_txnExecutionPool != nullptr) &&
+        SCILLA_MEM_FILES && MemFile("probe").IsOpen()) {
+      m_scratchIPCs.resize(TXN_EXECUTION_THREADS);
+      for (unsigned int i = 0; i < m_scratchIPCs.size(); i++) {
+        auto& ipc = m_scratchIPCs.at(i);
+        ipc.m_socketPath = SCILLA_IPC_SOCKET_PATH + "." + to_string(i);
+        boost::filesystem::remove_all(ipc.m_socketPath);
+        ipc.m_connector =
+            make_unique<jsonrpc::UnixDomainSocketServer>(ipc.m_socketPath);
+        ipc.m_server = make_shared<ScillaIPCServer>(*ipc.m_connector);
+        if (!ipc.m_server->StartListening()) {
+          LOG_GENERAL(WARNING, "Scilla IPC Server couldn't start on "
+                                   << ipc.m_socketPath
+                                   << ", contract calls run serially");
+          for (unsigned int j = 0; j < i; j++) {
+            m_scratchIPCs.at(j).m_server->StopListening();
+          }
+          m_scratchIPCs.clear();
+          break;
+        }
+        m_freeScratchIPCs.emplace_back(i);
+      }
+    } else if (DS_PARALLEL_CONTRACT_CALLS) {
+      LOG_GENERAL(WARNING,
+                  "DS_PARALLEL_CONTRACT_CALLS needs TXN_EXECUTION_THREADS > 1 "
+                  "and memfd support for SCILLA_MEM_FILES, contract calls "
+                  "run serially");
+    }
   }
 }
 
@@ -63,6 +105,9 @@ AccountStore::~AccountStore() {
   if (m_scillaIPCServer != nullptr) {
     m_scillaIPCServer->StopListening();
   }
+  for (auto& ipc : m_scratchIPCs) {
+    ipc.m_server->StopListening();
+  }
 }
 
 void AccountStore::Init() {
@@ -88,6 +133,11 @@ void AccountStore::InitSoft() {
 
   AccountStoreTrie<OverlayDB, unordered_map<Address, Account>>::Init();
 
+  m_readView.Clear();
+  m_snapshot.Clear();
+  m_readViewPending.clear();
+  m_committedVersion++;
+
   InitRevertibles();
 
   InitTemp();
@@ -105,6 +155,8 @@ void AccountStore::InitTemp() {
   lock_guard<mutex> g(m_mutexDelta);
 
   m_accountStoreTemp->Init();
+  m_accountStoreTemp->TakeTouchedAddresses();
+  m_deltaEntries.clear();
   m_stateDeltaSerialized.clear();
 
   ContractStorage2::GetContractStorage().InitTempState(true);
@@ -134,6 +186,16 @@ bool AccountStore::Serialize(bytes& src, unsigned int offset) const {
                                                                        offset);
 }
 
+bool AccountStore::SerializeChunk(bytes& dst, unsigned int offset,
+                                  const Address& cursor,
+                                  unsigned int maxAccounts, Address& next,
+                                  bool& more, dev::h256& root) const {
+  shared_lock<shared_timed_mutex> lock(m_mutexPrimary);
+  return AccountStoreTrie<dev::OverlayDB,
+                          std::unordered_map<Address, Account>>::
+      SerializeChunk(dst, offset, cursor, maxAccounts, next, more, root);
+}
+
 bool AccountStore::Deserialize(const bytes& src, unsigned int offset) {
   LOG_MARKER();
 
@@ -141,6 +203,24 @@ bool AccountStore::Deserialize(const bytes& src, unsigned int offset) {
 
   unique_lock<shared_timed_mutex> g(m_mutexPrimary);
 
+  bool ret = Messenger::GetAccountStore(src, offset, *this);
+
+  // The read view was emptied by Init and fills up again on reads
+  m_readViewPending.clear();
+
+  if (!ret) {
+    LOG_GENERAL(WARNING, "Messenger::GetAccountStore failed.");
+    return false;
+  }
+
+  return true;
+}
+
+bool AccountStore::DeserializeChunk(const bytes& src, unsigned int offset) {
+  LOG_MARKER();
+
+  unique_lock<shared_timed_mutex> g(m_mutexPrimary);
+
   if (!Messenger::GetAccountStore(src, offset, *this)) {
     LOG_GENERAL(WARNING, "Messenger::GetAccountStore failed.");
     return false;
@@ -156,17 +236,67 @@ bool AccountStore::SerializeDelta() {
   shared_lock<shared_timed_mutex> g2(m_mutexPrimary, defer_lock);
   lock(g, g2);
 
+  UpdateDeltaEntries();
+
+  LOG_GENERAL(INFO, "Account deltas to serialize: "
+                        << m_accountStoreTemp->GetNumOfAccounts());
+
   m_stateDeltaSerialized.clear();
 
-  if (!Messenger::SetAccountStoreDelta(m_stateDeltaSerialized, 0,
-                                       *m_accountStoreTemp, *this)) {
-    LOG_GENERAL(WARNING, "Messenger::SetAccountStoreDelta failed.");
-    return false;
+  // The delta lists the accounts in address order
+  for (const auto* entry :
+       m_accountStoreTemp->GetAddressToAccount()->GetSortedEntries()) {
+    const Address& address = entry->first;
+    const Account& account = entry->second;
+
+    // Contract deltas depend on the contract storage, so they are always
+    // encoded here
+    auto it = m_deltaEntries.find(address);
+    if ((it != m_deltaEntries.end()) && !account.isContract() &&
+        (it->second.m_committedVersion == m_committedVersion) &&
+        (it->second.m_balance == account.GetBalance()) &&
+        (it->second.m_nonce == account.GetNonce())) {
+      m_stateDeltaSerialized.insert(m_stateDeltaSerialized.end(),
+                                    it->second.m_serialized.begin(),
+                                    it->second.m_serialized.end());
+      continue;
+    }
+
+    if (!Messenger::SetAccountStoreDeltaEntry(
+            m_stateDeltaSerialized, m_stateDeltaSerialized.size(), address,
+            GetAccount(address), account)) {
+      LOG_GENERAL(WARNING, "Messenger::SetAccountStoreDeltaEntry failed.");
+      return false;
+    }
   }
 
   return true;
 }
 
+void AccountStore::UpdateDeltaEntries() {
+  const auto& addressToAccount = *m_accountStoreTemp->GetAddressToAccount();
+
+  for (const auto& address : m_accountStoreTemp->TakeTouchedAddresses()) {
+    auto it = addressToAccount.find(address);
+    if ((it == addressToAccount.end()) || it->second.isContract()) {
+      m_deltaEntries.erase(address);
+      continue;
+    }
+
+    DeltaEntry& entry = m_deltaEntries[address];
+    entry.m_committedVersion = m_committedVersion;
+    entry.m_balance = it->second.GetBalance();
+    entry.m_nonce = it->second.GetNonce();
+    entry.m_serialized.clear();
+    if (!Messenger::SetAccountStoreDeltaEntry(entry.m_serialized, 0, address,
+                                              GetAccount(address),
+                                              it->second)) {
+      // SerializeDelta will try again
+      m_deltaEntries.erase(address);
+    }
+  }
+}
+
 void AccountStore::GetSerializedDelta(bytes& dst) {
   lock_guard<mutex> g(m_mutexDelta);
 
@@ -188,26 +318,97 @@ bool AccountStore::DeserializeDelta(const bytes& src, unsigned int offset,
     if (!Messenger::GetAccountStoreDelta(src, offset, *this, revertible,
                                          false)) {
       LOG_GENERAL(WARNING, "Messenger::GetAccountStoreDelta failed.");
+      // Part of the delta may be in, so no copy can be trusted
+      m_readView.Clear();
+      m_snapshot.Clear();
+      m_readViewPending.clear();
+      m_committedVersion++;
       return false;
     }
+    PublishReadView();
   } else {
     unique_lock<shared_timed_mutex> g(m_mutexPrimary);
 
     if (!Messenger::GetAccountStoreDelta(src, offset, *this, revertible,
                                          false)) {
       LOG_GENERAL(WARNING, "Messenger::GetAccountStoreDelta failed.");
+      // Part of the delta may be in, so no copy can be trusted
+      m_readView.Clear();
+      m_snapshot.Clear();
+      m_readViewPending.clear();
+      m_committedVersion++;
+      return false;
+    }
+    PublishReadView();
+  }
+
+  return true;
+}
+
+bool AccountStore::DeserializeDeltas(const vector<const bytes*>& deltas) {
+  LOG_MARKER();
+
+  unique_lock<shared_timed_mutex> g(m_mutexPrimary);
+
+  set<Address> touched;
+  const bool applied = Messenger::GetAccountStoreDeltas(
+      deltas, *this, RETRIEVER_THREADS, touched);
+
+  // The trie follows whatever went in, so that the two stay consistent
+  vector<pair<Address, bytes>> entries;
+  entries.reserve(touched.size());
+  for (const auto& address : touched) {
+    auto it = m_addressToAccount->find(address);
+    if (it == m_addressToAccount->end()) {
+      continue;
+    }
+    bytes rawBytes;
+    if (!it->second.SerializeBase(rawBytes, 0)) {
+      LOG_GENERAL(WARNING, "Messenger::SetAccountBase failed");
       return false;
     }
+    entries.emplace_back(address, move(rawBytes));
   }
+  UpdateStateTrieBatch(entries);
+
+  if (!applied) {
+    LOG_GENERAL(WARNING, "Messenger::GetAccountStoreDeltas failed.");
+    // Part of the deltas may be in, so no copy can be trusted
+    m_readView.Clear();
+    m_snapshot.Clear();
+    m_readViewPending.clear();
+    m_committedVersion++;
+    return false;
+  }
+  PublishReadView();
 
   return true;
 }
 
 bool AccountStore::DeserializeDeltaTemp(const bytes& src, unsigned int offset) {
   lock_guard<mutex> g(m_mutexDelta);
+  // The delta may change contract storage behind the encoded entries
+  m_deltaEntries.clear();
   return m_accountStoreTemp->DeserializeDelta(src, offset);
 }
 
+void AccountStore::PublishReadView() {
+  for (const auto& address : m_readViewPending) {
+    auto it = m_addressToAccount->find(address);
+    if (it != m_addressToAccount->end()) {
+      m_readView.Put(address, it->second);
+      m_snapshot.Update(address,
+                        {it->second.GetBalance(), it->second.GetNonce()});
+    } else {
+      m_readView.Remove(address);
+      m_snapshot.Remove(address);
+    }
+  }
+  m_readViewPending.clear();
+  m_snapshot.Publish();
+  m_committedVersion++;
+}
+
 bool AccountStore::MoveRootToDisk(const h256& root) {
   // convert h256 to bytes
   if (!BlockStorage::GetBlockStorage().PutStateRoot(root.asBytes())) {
@@ -220,6 +421,8 @@ bool AccountStore::MoveRootToDisk(const h256& root) {
 bool AccountStore::MoveUpdatesToDisk(bool repopulate, bool retrieveFromTrie) {
   LOG_MARKER();
 
+  EpochPerf::Scope perf(EpochPerf::COMMIT);
+
   unique_lock<shared_timed_mutex> g(m_mutexPrimary, defer_lock);
   unique_lock<mutex> g2(m_mutexDB, defer_lock);
   lock(g, g2);
@@ -295,6 +498,15 @@ bool AccountStore::MoveUpdatesToDisk(bool repopulate, bool retrieveFromTrie) {
 
   m_addressToAccount->clear();
 
+  const TrieNodeCache* nodeCache = m_db.GetNodeCache();
+  if (nodeCache != nullptr) {
+    LOG_GENERAL(INFO, "Trie node cache hits: " << nodeCache->GetHits()
+                                               << " misses: "
+                                               << nodeCache->GetMisses()
+                                               << " bytes: "
+                                               << nodeCache->GetSizeInBytes());
+  }
+
   return true;
 }
 
@@ -377,9 +589,17 @@ bool AccountStore::UpdateStateTrieFromTempStateDB() {
       LOG_GENERAL(WARNING, "GetTempStateInBatch failed");
       return false;
     }
+    vector<pair<Address, bytes>> entries;
+    entries.reserve(states.size());
     for (const auto& state : states) {
-      UpdateStateTrie(state->first, state->second);
+      bytes rawBytes;
+      if (!state->second.SerializeBase(rawBytes, 0)) {
+        LOG_GENERAL(WARNING, "Account::SerializeBase failed");
+        return false;
+      }
+      entries.emplace_back(state->first, move(rawBytes));
     }
+    UpdateStateTrieBatch(entries);
   }
 
   if (!BlockStorage::GetBlockStorage().ResetDB(BlockStorage::TEMP_STATE)) {
@@ -403,6 +623,9 @@ void AccountStore::DiscardUnsavedUpdates() {
       m_state.setRoot(m_prevRoot);
     }
     m_addressToAccount->clear();
+    m_readView.Clear();
+    m_snapshot.Clear();
+    m_committedVersion++;
   } catch (const boost::exception& e) {
     LOG_GENERAL(WARNING, "Error with AccountStore::DiscardUnsavedUpdates. "
                              << boost::diagnostic_information(e));
@@ -448,10 +671,207 @@ bool AccountStore::RetrieveFromDisk() {
   return true;
 }
 
+bool AccountStore::PutStateRootCheckpoint(const uint64_t& blockNum,
+                                          const StateHash& blockStateRoot) {
+  const StateHash root = GetPrevRootHash();
+  if (root != blockStateRoot) {
+    LOG_GENERAL(WARNING, "State root on disk "
+                             << root << " is not that of Tx block " << blockNum
+                             << " " << blockStateRoot);
+    return false;
+  }
+
+  if (!BlockStorage::GetBlockStorage().PutStateRootCheckpoint(blockNum, root)) {
+    LOG_GENERAL(WARNING, "BlockStorage::PutStateRootCheckpoint failed "
+                             << blockNum);
+    return false;
+  }
+  return true;
+}
+
+bool AccountStore::GetCommittedAccount(const Address& address,
+                                       Account& account) {
+  if (m_readView.Get(address, account)) {
+    return true;
+  }
+
+  // Hold the primary lock until the copy is stored, so that no commit can come
+  // in between and leave the copy stale
+  shared_lock<shared_timed_mutex> lock(m_mutexPrimary);
+
+  // Reading through GetAccount would insert into m_addressToAccount
+  auto it = m_addressToAccount->find(address);
+  if (it != m_addressToAccount->end()) {
+    account = it->second;
+  } else {
+    string rawAccountBase;
+    {
+      std::lock(m_mutexTrie, m_mutexDB);
+      lock_guard<mutex> lock1(m_mutexTrie, adopt_lock);
+      lock_guard<mutex> lock2(m_mutexDB, adopt_lock);
+
+      rawAccountBase = m_state.at(address);
+    }
+    if (rawAccountBase.empty()) {
+      return false;
+    }
+
+    account = Account();
+    if (!account.DeserializeBase(
+            bytes(rawAccountBase.begin(), rawAccountBase.end()), 0)) {
+      LOG_GENERAL(WARNING, "Account::DeserializeBase failed");
+      return false;
+    }
+    if (account.isContract()) {
+      account.SetAddress(address);
+    }
+  }
+
+  m_readView.Put(address, account);
+  return true;
+}
+
+bool AccountStore::GetCommittedBalanceAndNonce(const Address& address,
+                                               AccountSnapshot::Entry& entry) {
+  if (m_snapshot.Get(address, entry)) {
+    return true;
+  }
+
+  // Read before the account, so that a commit in between drops the offer
+  const uint64_t version = m_snapshot.GetVersion();
+  Account account;
+  if (!GetCommittedAccount(address, account)) {
+    return false;
+  }
+  entry = {account.GetBalance(), account.GetNonce()};
+  m_snapshot.Offer(address, entry, version);
+  return true;
+}
+
 Account* AccountStore::GetAccountTemp(const Address& address) {
   return m_accountStoreTemp->GetAccount(address);
 }
 
+bool AccountStore::PeekAccountTemp(const Address& address, Account& account) {
+  // The parent store loads the accounts it reads from the trie
+  unique_lock<shared_timed_mutex> g(m_mutexPrimary, defer_lock);
+  unique_lock<mutex> g2(m_mutexDelta, defer_lock);
+  lock(g, g2);
+
+  return PeekAccountTempCore(address, account);
+}
+
+bool AccountStore::PeekAccountTempCore(const Address& address,
+                                       Account& account) {
+  const auto& tempAccounts = *m_accountStoreTemp->GetAddressToAccount();
+  auto it = tempAccounts.find(address);
+  if (it != tempAccounts.end()) {
+    account = it->second;
+    return true;
+  }
+
+  const Account* found = GetAccount(address);
+  if (found == nullptr) {
+    return false;
+  }
+  account = *found;
+  return true;
+}
+
+void AccountStore::AddAccountsTemp(const map<Address, Account>& accounts) {
+  unique_lock<shared_timed_mutex> g(m_mutexPrimary, defer_lock);
+  unique_lock<mutex> g2(m_mutexDelta, defer_lock);
+  lock(g, g2);
+
+  auto& tempAccounts = *m_accountStoreTemp->GetAddressToAccount();
+  for (const auto& entry : accounts) {
+    tempAccounts[entry.first] = entry.second;
+    m_accountStoreTemp->m_touchedAddresses.emplace(entry.first);
+  }
+  UpdateDeltaEntries();
+}
+
+void AccountStore::PrefetchAccounts(const set<Address>& addresses,
+                                    const set<Address>& contractCalls) {
+  if (m_txnExecutionPool == nullptr) {
+    return;
+  }
+
+  unique_lock<shared_timed_mutex> g(m_mutexPrimary);
+
+  vector<Address> missing;
+  vector<Address> contractsInMemory;
+  for (const auto& addr : addresses) {
+    auto it = m_addressToAccount->find(addr);
+    if (it == m_addressToAccount->end()) {
+      missing.emplace_back(addr);
+    } else if (it->second.isContract() &&
+               contractCalls.find(addr) != contractCalls.end()) {
+      contractsInMemory.emplace_back(addr);
+    }
+  }
+  if (missing.empty() && contractsInMemory.empty()) {
+    return;
+  }
+
+  vector<Account> accounts(missing.size());
+  vector<char> found(missing.size(), false);
+
+  {
+    std::lock(m_mutexTrie, m_mutexDB);
+    lock_guard<mutex> lock1(m_mutexTrie, adopt_lock);
+    lock_guard<mutex> lock2(m_mutexDB, adopt_lock);
+
+    mutex mutexJobs;
+    condition_variable cvJobs;
+    const unsigned int numJobs = min<size_t>(
+        TXN_EXECUTION_THREADS, missing.size() + contractsInMemory.size());
+    unsigned int jobsLeft = numJobs;
+
+    for (unsigned int j = 0; j < numJobs; j++) {
+      m_txnExecutionPool->AddJob([&, j]() {
+        for (unsigned int i = j; i < missing.size(); i += numJobs) {
+          const string rawAccountBase = m_state.at(missing.at(i));
+          if (rawAccountBase.empty() ||
+              !accounts.at(i).DeserializeBase(
+                  bytes(rawAccountBase.begin(), rawAccountBase.end()), 0)) {
+            continue;
+          }
+          found.at(i) = true;
+          if (accounts.at(i).isContract()) {
+            accounts.at(i).SetAddress(missing.at(i));
+            if (contractCalls.find(missing.at(i)) != contractCalls.end()) {
+              ContractStorage2::GetContractStorage().PrefetchStateData(
+                  missing.at(i));
+            }
+          }
+        }
+        for (unsigned int i = j; i < contractsInMemory.size(); i += numJobs) {
+          ContractStorage2::GetContractStorage().PrefetchStateData(
+              contractsInMemory.at(i));
+        }
+        lock_guard<mutex> g(mutexJobs);
+        jobsLeft--;
+        cvJobs.notify_all();
+      });
+    }
+
+    unique_lock<mutex> lock(mutexJobs);
+    cvJobs.wait(lock, [&jobsLeft] { return jobsLeft == 0; });
+  }
+
+  unsigned int numLoaded = 0;
+  for (unsigned int i = 0; i < missing.size(); i++) {
+    if (found.at(i)) {
+      m_addressToAccount->emplace(missing.at(i), move(accounts.at(i)));
+      numLoaded++;
+    }
+  }
+
+  LOG_GENERAL(INFO, "Prefetched " << numLoaded << " of " << missing.size()
+                                  << " accounts");
+}
+
 bool AccountStore::UpdateAccountsTemp(const uint64_t& blockNum,
                                       const unsigned int& numShards,
                                       const bool& isDS,
@@ -463,8 +883,184 @@ bool AccountStore::UpdateAccountsTemp(const uint64_t& blockNum,
   unique_lock<mutex> g2(m_mutexDelta, defer_lock);
   lock(g, g2);
 
-  return m_accountStoreTemp->UpdateAccounts(blockNum, numShards, isDS,
-                                            transaction, receipt);
+  bool ret = m_accountStoreTemp->UpdateAccounts(blockNum, numShards, isDS,
+                                                transaction, receipt);
+  UpdateDeltaEntries();
+  return ret;
+}
+
+bool AccountStore::UpdateAccountsTempParallel(
+    const uint64_t& blockNum, const unsigned int& numShards, const bool& isDS,
+    const vector<Transaction>& transactions,
+    vector<TransactionReceipt>& receipts, vector<char>& results) {
+  // LOG_MARKER();
+
+  results.assign(transactions.size(), false);
+
+  if (transactions.size() != receipts.size()) {
+    LOG_GENERAL(WARNING, "Mismatch: transactions = "
+                             << transactions.size()
+                             << ", receipts = " << receipts.size());
+    return false;
+  }
+
+  unique_lock<shared_timed_mutex> g(m_mutexPrimary, defer_lock);
+  unique_lock<mutex> g2(m_mutexDelta, defer_lock);
+  lock(g, g2);
+
+  if ((m_txnExecutionPool == nullptr) || (transactions.size() < 2)) {
+    for (unsigned int i = 0; i < transactions.size(); i++) {
+      results.at(i) = m_accountStoreTemp->UpdateAccounts(
+          blockNum, numShards, isDS, transactions.at(i), receipts.at(i));
+    }
+    UpdateDeltaEntries();
+    return true;
+  }
+
+  vector<set<Address>> addrs(transactions.size());
+  set<Address> touched;
+  for (unsigned int i = 0; i < transactions.size(); i++) {
+    const Transaction& transaction = transactions.at(i);
+    const auto type = Transaction::GetTransactionType(transaction);
+    if ((type != Transaction::NON_CONTRACT) &&
+        ((type != Transaction::CONTRACT_CALL) ||
+         !ContractCallsRunInParallel())) {
+      LOG_GENERAL(WARNING, "Transaction cannot be executed in parallel: "
+                               << transaction.GetTranID());
+      return false;
+    }
+
+    addrs.at(i) = {
+        transaction.GetToAddr(),
+        Account::GetAddressFromPublicKey(transaction.GetSenderPubKey())};
+    for (const auto& addr : addrs.at(i)) {
+      if (!touched.emplace(addr).second) {
+        LOG_GENERAL(WARNING, "Address " << addr
+                                         << " used by more than one "
+                                            "transaction");
+        return false;
+      }
+    }
+  }
+
+  // Copy the accounts each transaction reads into its own scratch store,
+  // without pulling them into AccountStoreTemp, as the serial path may not
+  // look some of them up. The contract states are journaled per contract
+  // instead, so that each call can be committed or rolled back on its own.
+  vector<AccountStoreScratch> scratches(transactions.size());
+  vector<Address> contracts;
+  for (unsigned int i = 0; i < transactions.size(); i++) {
+    for (const auto& addr : addrs.at(i)) {
+      Account account;
+      scratches.at(i).AddToScope(
+          addr, PeekAccountTempCore(addr, account) ? &account : nullptr);
+    }
+    if (Transaction::GetTransactionType(transactions.at(i)) ==
+        Transaction::CONTRACT_CALL) {
+      contracts.emplace_back(transactions.at(i).GetToAddr());
+    }
+  }
+  ContractStorage2::GetContractStorage().BeginTempSession(contracts);
+  // Transactions executed again start from the receipts they came in with
+  const vector<TransactionReceipt> receiptsIn(receipts);
+
+  mutex mutexJobs;
+  condition_variable cvJobs;
+  unsigned int jobsLeft = transactions.size();
+
+  for (unsigned int i = 0; i < transactions.size(); i++) {
+    m_txnExecutionPool->AddJob([&, i]() {
+      auto& scratch = scratches.at(i);
+      const bool isCall = Transaction::GetTransactionType(transactions.at(i)) ==
+                          Transaction::CONTRACT_CALL;
+      unsigned int ipc = 0;
+      if (isCall) {
+        ipc = AcquireScratchIPC();
+        scratch.SetScillaIPCServer(m_scratchIPCs.at(ipc).m_server);
+        scratch.SetScillaIPCSocketPath(m_scratchIPCs.at(ipc).m_socketPath);
+      }
+      results.at(i) = scratch.UpdateAccounts(
+          blockNum, numShards, isDS, transactions.at(i), receipts.at(i));
+      if (isCall) {
+        ReleaseScratchIPC(ipc);
+      }
+      // Notify under the lock, as the waiter owns these and may return
+      // as soon as it sees the count drop to zero
+      lock_guard<mutex> g(mutexJobs);
+      jobsLeft--;
+      cvJobs.notify_all();
+    });
+  }
+
+  {
+    unique_lock<mutex> lock(mutexJobs);
+    cvJobs.wait(lock, [&jobsLeft] { return jobsLeft == 0; });
+  }
+
+  // A transaction that reached outside its own accounts (e.g., a contract
+  // messaging another one) may depend on the ones before it, so it and all
+  // that follow are rolled back and executed again in order
+  unsigned int numKept = transactions.size();
+  for (unsigned int i = 0; i < transactions.size(); i++) {
+    if (scratches.at(i).IsOutOfScope()) {
+      LOG_GENERAL(INFO, "Transaction " << transactions.at(i).GetTranID()
+                                       << " reached outside its accounts, "
+                                       << transactions.size() - i
+                                       << " transactions executed again");
+      numKept = i;
+      break;
+    }
+  }
+
+  // Failed transactions may still have changed their accounts (e.g., copied
+  // from the parent store or left a partial update), so every account a kept
+  // transaction looked up is written back as the serial path would have left
+  // it. The ones it never looked up stay out, as they would in the delta.
+  auto& tempAccounts = *m_accountStoreTemp->GetAddressToAccount();
+  for (unsigned int i = 0; i < transactions.size(); i++) {
+    const Transaction& transaction = transactions.at(i);
+    if (Transaction::GetTransactionType(transaction) ==
+        Transaction::CONTRACT_CALL) {
+      ContractStorage2::GetContractStorage().EndTempSession(
+          transaction.GetToAddr(), i >= numKept);
+    }
+    if (i >= numKept) {
+      continue;
+    }
+    const auto& accounts = scratches.at(i).GetAccounts();
+    for (const auto& addr : scratches.at(i).GetTouchedAddresses()) {
+      auto it = accounts.find(addr);
+      if (it != accounts.end()) {
+        tempAccounts[addr] = it->second;
+        m_accountStoreTemp->m_touchedAddresses.emplace(addr);
+      }
+    }
+    m_accountStoreTemp->AddToStorageRootUpdateBuffer(
+        scratches.at(i).GetStorageRootUpdateBuffer());
+  }
+
+  for (unsigned int i = numKept; i < transactions.size(); i++) {
+    receipts.at(i) = receiptsIn.at(i);
+    results.at(i) = m_accountStoreTemp->UpdateAccounts(
+        blockNum, numShards, isDS, transactions.at(i), receipts.at(i));
+  }
+  UpdateDeltaEntries();
+
+  return true;
+}
+
+unsigned int AccountStore::AcquireScratchIPC() {
+  unique_lock<mutex> lock(m_mutexScratchIPCs);
+  m_cvScratchIPCs.wait(lock, [this] { return !m_freeScratchIPCs.empty(); });
+  const unsigned int ipc = m_freeScratchIPCs.back();
+  m_freeScratchIPCs.pop_back();
+  return ipc;
+}
+
+void AccountStore::ReleaseScratchIPC(unsigned int ipc) {
+  lock_guard<mutex> g(m_mutexScratchIPCs);
+  m_freeScratchIPCs.emplace_back(ipc);
+  m_cvScratchIPCs.notify_one();
 }
 
 bool AccountStore::UpdateCoinbaseTemp(const Address& rewardee,
@@ -482,14 +1078,37 @@ bool AccountStore::UpdateCoinbaseTemp(const Address& rewardee,
 }
 
 uint128_t AccountStore::GetNonceTemp(const Address& address) {
-  lock_guard<mutex> g(m_mutexDelta);
+  unique_lock<mutex> g(m_mutexDelta, defer_lock);
+  shared_lock<shared_timed_mutex> g2(m_mutexPrimary, defer_lock);
+  lock(g, g2);
 
   if (m_accountStoreTemp->GetAddressToAccount()->find(address) !=
       m_accountStoreTemp->GetAddressToAccount()->end()) {
     return m_accountStoreTemp->GetNonce(address);
-  } else {
-    return this->GetNonce(address);
   }
+
+  auto it = m_addressToAccount->find(address);
+  if (it != m_addressToAccount->end()) {
+    return it->second.GetNonce();
+  }
+
+  // The txns of accounts not read yet are ordered by nonce before they are
+  // applied, so only the nonce is decoded here
+  string rawAccountBase;
+  {
+    std::lock(m_mutexTrie, m_mutexDB);
+    lock_guard<mutex> lock1(m_mutexTrie, adopt_lock);
+    lock_guard<mutex> lock2(m_mutexDB, adopt_lock);
+
+    rawAccountBase = m_state.at(address);
+  }
+  uint64_t nonce = 0;
+  if (!rawAccountBase.empty() &&
+      !Messenger::GetAccountBaseNonce(
+          bytes(rawAccountBase.begin(), rawAccountBase.end()), 0, nonce)) {
+    LOG_GENERAL(WARNING, "Messenger::GetAccountBaseNonce failed");
+  }
+  return nonce;
 }
 
 StateHash AccountStore::GetStateDeltaHash() {
@@ -540,12 +1159,19 @@ void AccountStore::RevertCommitTemp() {
     // LOG_GENERAL(INFO, "Revert changed address: " << entry.first);
     (*m_addressToAccount)[entry.first] = entry.second;
     UpdateStateTrie(entry.first, entry.second);
+    m_readView.Put(entry.first, entry.second);
+    m_snapshot.Update(entry.first,
+                      {entry.second.GetBalance(), entry.second.GetNonce()});
   }
   for (auto const& entry : m_addressToAccountRevCreated) {
     // LOG_GENERAL(INFO, "Remove created address: " << entry.first);
     RemoveAccount(entry.first);
     RemoveFromTrie(entry.first);
+    m_readView.Remove(entry.first);
+    m_snapshot.Remove(entry.first);
   }
+  m_snapshot.Publish();
 
   ContractStorage2::GetContractStorage().RevertContractStates();
+  m_committedVersion++;
 }
\ No newline at end of file
@@ -19,16 +19,23 @@
 #define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_ACCOUNTSTORE_H_
 
 #include <json/json.h>
+#include <atomic>
+#include <condition_variable>
 #include <map>
+#include <mutex>
 #include <set>
 #include <shared_mutex>
 #include <unordered_map>
+#include <vector>
 
 #include <Schnorr.h>
 #include "Account.h"
+#include "AccountReadView.h"
+#include "AccountSnapshot.h"
 #include "AccountStoreSC.h"
 #include "AccountStoreTrie.h"
 #include "Address.h"
+#include "FlatAddressMap.h"
 #include "TransactionReceipt.h"
 #include "common/Constants.h"
 #include "common/Singleton.h"
@@ -38,14 +45,18 @@
 #include "depends/libTrie/TrieDB.h"
 #include "libData/AccountData/Transaction.h"
 #include "libServer/ScillaIPCServer.h"
+#include "libUtils/ThreadPool.h"
 
 using StateHash = dev::h256;
 
 class AccountStore;
 
-class AccountStoreTemp : public AccountStoreSC<std::map<Address, Account>> {
+class AccountStoreTemp : public AccountStoreSC<FlatAddressMap<Account>> {
   AccountStore& m_parent;
 
+  /// accounts that may have changed since their delta entry was encoded
+  std::set<Address> m_touchedAddresses;
+
   friend class AccountStore;
 
  public:
@@ -56,14 +67,65 @@ class AccountStoreTemp : public AccountStoreSC<std::map<Address, Account>> {
   /// Returns the Account associated with the specified address.
   Account* GetAccount(const Address& address) override;
 
-  const std::shared_ptr<std::map<Address, Account>>& GetAddressToAccount() {
+  /// Returns and forgets the addresses looked up since the last call
+  std::set<Address> TakeTouchedAddresses() {
+    std::set<Address> touched;
+    touched.swap(m_touchedAddresses);
+    return touched;
+  }
+
+  const std::shared_ptr<FlatAddressMap<Account>>& GetAddressToAccount() {
     return this->m_addressToAccount;
   }
 
   void AddAccountDuringDeserialization(const Address& address,
                                        const Account& account) {
     (*m_addressToAccount)[address] = account;
+    m_touchedAddresses.emplace(address);
+  }
+};
+
+/// Private copy of the accounts touched by one transaction, so that
+/// transactions without common addresses can be executed on separate threads.
+/// Any other address (e.g., the recipient of a contract message) is out of
+/// scope: it reads as absent and marks the outcome as unusable.
+class AccountStoreScratch
+    : public AccountStoreSC<std::map<Address, Account>> {
+  std::set<Address> m_scope;
+  /// addresses in scope looked up, i.e., the ones AccountStoreTemp would have
+  /// pulled in had the transaction been executed there
+  std::set<Address> m_touched;
+  bool m_outOfScope{false};
+
+ public:
+  AccountStoreScratch() = default;
+
+  using AccountStoreSC<std::map<Address, Account>>::UpdateAccounts;
+
+  /// Adds address to the scope, along with its account if it exists
+  void AddToScope(const Address& address, const Account* account) {
+    m_scope.emplace(address);
+    if (account != nullptr) {
+      AddAccount(address, *account);
+    }
   }
+
+  Account* GetAccount(const Address& address) override {
+    if (m_scope.find(address) == m_scope.end()) {
+      m_outOfScope = true;
+      return nullptr;
+    }
+    m_touched.emplace(address);
+    return AccountStoreSC<std::map<Address, Account>>::GetAccount(address);
+  }
+
+  bool IsOutOfScope() const { return m_outOfScope; }
+
+  const std::map<Address, Account>& GetAccounts() const {
+    return *m_addressToAccount;
+  }
+
+  const std::set<Address>& GetTouchedAddresses() const { return m_touched; }
 };
 
 // Singleton class for providing interface related Account System
@@ -89,23 +151,83 @@ class AccountStore
   /// buffer for the raw bytes of state delta serialized
   bytes m_stateDeltaSerialized;
 
+  /// serialized state delta of a payment account in AccountStoreTemp, along
+  /// with the balance and nonce it was encoded from
+  struct DeltaEntry {
+    uint64_t m_committedVersion;
+    uint128_t m_balance;
+    uint64_t m_nonce;
+    bytes m_serialized;
+  };
+  /// delta entries encoded as transactions are applied, so that
+  /// SerializeDelta mostly only has to join them
+  std::unordered_map<Address, DeltaEntry> m_deltaEntries;
+  /// bumped whenever the committed states change, as the delta entries are
+  /// relative to them
+  std::atomic<uint64_t> m_committedVersion{0};
+
+  /// committed accounts served to GetCommittedAccount
+  AccountReadView m_readView;
+  /// addresses changed by the delta being applied, refreshed in m_readView
+  /// once the whole delta is in
+  std::set<Address> m_readViewPending;
+  /// balances and nonces of committed accounts for the admission checks
+  AccountSnapshot m_snapshot;
+
   std::shared_ptr<ScillaIPCServer> m_scillaIPCServer;
   std::unique_ptr<jsonrpc::AbstractServerConnector> m_scillaIPCServerConnector;
 
+  /// workers for UpdateAccountsTempParallel
+  std::unique_ptr<ThreadPool> m_txnExecutionPool;
+
+  /// scilla IPC servers lent to the contract calls run by
+  /// UpdateAccountsTempParallel, each listening on its own socket
+  struct ScratchIPC {
+    std::string m_socketPath;
+    std::unique_ptr<jsonrpc::AbstractServerConnector> m_connector;
+    std::shared_ptr<ScillaIPCServer> m_server;
+  };
+  std::vector<ScratchIPC> m_scratchIPCs;
+  std::vector<unsigned int> m_freeScratchIPCs;
+  std::mutex m_mutexScratchIPCs;
+  std::condition_variable m_cvScratchIPCs;
+
   AccountStore();
   ~AccountStore();
 
   /// Store the trie root to leveldb
   bool MoveRootToDisk(const dev::h256& root);
 
+  /// Copy the accounts changed by the last delta into m_readView
+  void PublishReadView();
+
+  /// Encode the delta entries of the accounts touched in AccountStoreTemp
+  void UpdateDeltaEntries();
+
+  /// PeekAccountTemp for callers already holding m_mutexPrimary and
+  /// m_mutexDelta
+  bool PeekAccountTempCore(const Address& address, Account& account);
+
+  /// Take one of m_scratchIPCs, waiting for one to be released if need be
+  unsigned int AcquireScratchIPC();
+  void ReleaseScratchIPC(unsigned int ipc);
+
  public:
   /// Returns the singleton AccountStore instance.
   static AccountStore& GetInstance();
 
   bool Serialize(bytes& src, unsigned int offset) const override;
 
+  bool SerializeChunk(bytes& dst, unsigned int offset, const Address& cursor,
+                      unsigned int maxAccounts, Address& next, bool& more,
+                      dev::h256& root) const;
+
   bool Deserialize(const bytes& src, unsigned int offset) override;
 
+  /// Adds the accounts of a chunk from SerializeChunk, which Deserialize
+  /// starts with for the first chunk
+  bool DeserializeChunk(const bytes& src, unsigned int offset);
+
   /// generate serialized raw bytes for StateDelta
   bool SerializeDelta();
 
@@ -116,6 +238,10 @@ class AccountStore
   bool DeserializeDelta(const bytes& src, unsigned int offset,
                         bool revertible = false);
 
+  /// update account states with consecutive StateDeltas, decoded ahead on
+  /// RETRIEVER_THREADS threads, and the state trie once for all of them
+  bool DeserializeDeltas(const std::vector<const bytes*>& deltas);
+
   /// update account states in AccountStoreTemp with the raw bytes of StateDelta
   bool DeserializeDeltaTemp(const bytes& src, unsigned int offset);
 
@@ -147,20 +273,74 @@ class AccountStore
   /// repopulate the in-memory data structures from persistent storage
   bool RetrieveFromDisk();
 
+  /// Keep the state root last moved to disk as the checkpoint of Tx block
+  /// blockNum, if it is the state root of that block
+  bool PutStateRootCheckpoint(const uint64_t& blockNum,
+                              const StateHash& blockStateRoot);
+
+  /// Copy the account as of the last committed state without waiting for a
+  /// block being applied or written to disk, unless it was not read since
+  bool GetCommittedAccount(const Address& address, Account& account);
+
+  /// Balance and nonce of the account as of the last committed state, read
+  /// without any lock once the account is in the snapshot
+  bool GetCommittedBalanceAndNonce(const Address& address,
+                                   AccountSnapshot::Entry& entry);
+
+  /// Records a nonce admitted for the sender and not yet committed
+  void AdmitPendingNonce(const Address& address, uint64_t nonce) {
+    m_snapshot.AdmitNonce(address, nonce);
+  }
+
+  /// The highest nonce admitted for the sender, or else committedNonce
+  uint64_t GetPendingNonce(const Address& address, uint64_t committedNonce) {
+    return m_snapshot.GetPendingNonce(address, committedNonce);
+  }
+
   /// Get the instance of an account from AccountStoreTemp
   Account* GetAccountTemp(const Address& address);
 
+  /// Load the accounts not yet in memory from the state trie on worker
+  /// threads, and read ahead the states of those among contractCalls that
+  /// are contracts, so that executing the transactions does not wait on disk
+  void PrefetchAccounts(const std::set<Address>& addresses,
+                        const std::set<Address>& contractCalls);
+
   /// update account states in AccountStoreTemp
   bool UpdateAccountsTemp(const uint64_t& blockNum,
                           const unsigned int& numShards, const bool& isDS,
                           const Transaction& transaction,
                           TransactionReceipt& receipt);
 
+  /// whether UpdateAccountsTempParallel takes contract calls, which needs
+  /// DS_PARALLEL_CONTRACT_CALLS and memfd support for the scilla files
+  bool ContractCallsRunInParallel() const { return !m_scratchIPCs.empty(); }
+
+  /// update account states in AccountStoreTemp for payments (and, if
+  /// ContractCallsRunInParallel, contract calls) that share no sender or
+  /// recipient, running them on worker threads; the resulting states and
+  /// receipts are the same as calling UpdateAccountsTemp on each transaction
+  /// in order
+  bool UpdateAccountsTempParallel(const uint64_t& blockNum,
+                                  const unsigned int& numShards,
+                                  const bool& isDS,
+                                  const std::vector<Transaction>& transactions,
+                                  std::vector<TransactionReceipt>& receipts,
+                                  std::vector<char>& results);
+
   /// add account in AccountStoreTemp
   void AddAccountTemp(const Address& address, const Account& account) {
     m_accountStoreTemp->AddAccount(address, account);
+    m_accountStoreTemp->m_touchedAddresses.emplace(address);
   }
 
+  /// Copies the account as AccountStoreTemp has it, without pulling it into
+  /// AccountStoreTemp. Returns false if there is none.
+  bool PeekAccountTemp(const Address& address, Account& account);
+
+  /// Puts the accounts in AccountStoreTemp, as if they had been changed there
+  void AddAccountsTemp(const std::map<Address, Account>& accounts);
+
   /// increase balance for account in AccountStoreTemp
   bool IncreaseBalanceTemp(const Address& address, const uint128_t& delta) {
     return m_accountStoreTemp->IncreaseBalance(address, delta);
@@ -184,13 +364,26 @@ class AccountStore
     m_accountStoreTemp->CleanStorageRootUpdateBuffer();
   }
 
+  /// Get the time spent in each phase of contract transactions in
+  /// AccountStoreTemp
+  ScillaCallProfile GetScillaCallProfileTemp() const {
+    return m_accountStoreTemp->GetScillaCallProfile();
+  }
+
+  /// Reset the ScillaCallProfile of AccountStoreTemp
+  void ResetScillaCallProfileTemp() {
+    m_accountStoreTemp->ResetScillaCallProfile();
+  }
+
   /// used in deserialization
   void AddAccountDuringDeserialization(const Address& address,
                                        const Account& account,
                                        const Account& oriAccount,
                                        const bool fullCopy = false,
-                                       const bool revertible = false) {
+                                       const bool revertible = false,
+                                       const bool updateTrie = true) {
     (*m_addressToAccount)[address] = account;
+    m_readViewPending.emplace(address);
 
     if (revertible) {
       if (fullCopy) {
@@ -200,7 +393,9 @@ class AccountStore
       }
     }
 
-    UpdateStateTrie(address, account);
+    if (updateTrie) {
+      UpdateStateTrie(address, account);
+    }
   }
 
   /// return the hash of the raw bytes of StateDelta
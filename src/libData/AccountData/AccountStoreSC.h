@@ -22,16 +22,36 @@
 #include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 
 #include "AccountStoreBase.h"
 #include "libUtils/DetachedFunction.h"
+#include "libUtils/MemFile.h"
+#include "libUtils/TimeUtils.h"
 
 class ScillaIPCServer;
 
 template <class MAP>
 class AccountStoreSC;
 
+/// Number of scilla runs and the time in microseconds spent in each phase of
+/// contract transactions. The IPC state reads and writes are served while
+/// scilla runs, so their time is also part of m_invokeMicro.
+struct ScillaCallProfile {
+  uint64_t m_invocations{0};
+  uint64_t m_exportMicro{0};
+  uint64_t m_invokeMicro{0};
+  uint64_t m_parseMicro{0};
+  uint64_t m_ipcReads{0};
+  uint64_t m_ipcReadMicro{0};
+  uint64_t m_ipcWrites{0};
+  uint64_t m_ipcWriteMicro{0};
+};
+
 template <class MAP>
 class AccountStoreAtomic
     : public AccountStoreBase<std::unordered_map<Address, Account>> {
@@ -91,9 +111,35 @@ class AccountStoreSC : public AccountStoreBase<MAP> {
   std::condition_variable cv_callContract;
   std::atomic<bool> m_txnProcessTimeout;
 
+  /// in-memory replacement of each file under SCILLA_FILES if SCILLA_MEM_FILES
+  std::map<std::string, std::unique_ptr<MemFile>> m_memFiles;
+
   /// scilla IPC server
   std::shared_ptr<ScillaIPCServer> m_scillaIPCServer;
 
+  /// socket of m_scillaIPCServer passed to scilla
+  std::string m_scillaIPCSocketPath{SCILLA_IPC_SOCKET_PATH};
+
+  /// time spent in each phase of contract transactions, see
+  /// GetScillaCallProfile
+  std::atomic<uint64_t> m_profileInvocations{0};
+  std::atomic<uint64_t> m_profileExportMicro{0};
+  std::atomic<uint64_t> m_profileInvokeMicro{0};
+  std::atomic<uint64_t> m_profileParseMicro{0};
+
+  /// adds the time until it goes out of scope to one of the profile counters
+  class ProfileTimer {
+    std::atomic<uint64_t>& m_counter;
+    const std::chrono::system_clock::time_point m_start;
+
+   public:
+    explicit ProfileTimer(std::atomic<uint64_t>& counter)
+        : m_counter(counter), m_start(r_timer_start()) {}
+    ~ProfileTimer() {
+      m_counter += static_cast<uint64_t>(r_timer_end(m_start));
+    }
+  };
+
   /// A set of contract account address pending for storageroot updating
   std::set<Address> m_storageRootUpdateBuffer;
 
@@ -133,17 +179,41 @@ class AccountStoreSC : public AccountStoreBase<MAP> {
   /// Utility functions
   /// get the json format file for the current blocknum
   Json::Value GetBlockStateJson(const uint64_t& BlockNum) const;
-  /// get the command for invoking the scilla_checker while deploying
-  std::string GetContractCheckerCmdStr(const std::string& root_w_version,
-                                       const uint64_t& available_gas);
-  /// get the command for invoking the scilla_runner while deploying
-  std::string GetCreateContractCmdStr(
+  /// get the arguments for invoking the scilla_checker while deploying
+  std::vector<std::string> GetContractCheckerArgs(
+      const std::string& root_w_version, const uint64_t& available_gas);
+  /// get the arguments for invoking the scilla_runner while deploying
+  std::vector<std::string> GetCreateContractArgs(
       const std::string& root_w_version, const uint64_t& available_gas,
       const boost::multiprecision::uint128_t& balance);
-  /// get the command for invoking the scilla_runner while calling
-  std::string GetCallContractCmdStr(
+  /// get the arguments for invoking the scilla_runner while calling
+  std::vector<std::string> GetCallContractArgs(
       const std::string& root_w_version, const uint64_t& available_gas,
       const boost::multiprecision::uint128_t& balance);
+  /// get the key of the cached checker output for the code
+  std::string GetCheckerCacheKey(const bytes& code);
+  /// get the cached checker output with gas_remaining for gasRemained
+  bool GetCachedCheckerOutput(const std::string& key,
+                              const uint64_t& gasRemained,
+                              std::string& checkerPrint);
+  /// cache the output of a successful checker run and the gas it used
+  void CacheCheckerOutput(const std::string& key, const uint64_t& gasUsed,
+                          const std::string& checkerPrint);
+  /// get the path to pass to scilla for one of the files under SCILLA_FILES
+  std::string GetScillaFilePath(const std::string& file);
+  /// write one of the scilla input files
+  bool WriteScillaFile(const std::string& file, const std::string& content);
+  /// read the scilla output file, false if there is none
+  bool ReadScillaOutput(std::string& output);
+  /// clear the scilla files left by the previous run
+  void ResetScillaFiles();
+  /// get the command line of a scilla binary with its arguments
+  static std::string GetCmdStr(const std::string& binary,
+                               const std::vector<std::string>& args);
+  /// run the scilla_checker or scilla_runner from m_root_w_version, on a
+  /// scilla-server worker if ENABLE_SCILLA_SERVER or else in a new process
+  bool InvokeScilla(bool checker, const std::vector<std::string>& args,
+                    std::string& output, int& pid);
   /// updating m_root_w_version
   bool PrepareRootPathWVersion(const uint32_t& scilla_version);
 
@@ -202,12 +272,28 @@ class AccountStoreSC : public AccountStoreBase<MAP> {
   virtual void SetScillaIPCServer(
       std::shared_ptr<ScillaIPCServer> scillaIPCServer);
 
+  /// public interface to set the socket the scilla ipc server listens on
+  void SetScillaIPCSocketPath(const std::string& path);
+
   /// public interface to invoke processing of the buffered storage root
   /// updating tasks
   void ProcessStorageRootUpdateBuffer();
 
   /// public interface to clean StorageRootUpdateBuffer
   void CleanStorageRootUpdateBuffer();
+
+  /// public interface to get the contracts pending for storageroot updating
+  const std::set<Address>& GetStorageRootUpdateBuffer() const;
+
+  /// public interface to add contracts pending for storageroot updating
+  void AddToStorageRootUpdateBuffer(const std::set<Address>& addresses);
+
+  /// public interface to get the time spent in each phase of contract
+  /// transactions since the last ResetScillaCallProfile
+  ScillaCallProfile GetScillaCallProfile() const;
+
+  /// public interface to reset the ScillaCallProfile counters
+  void ResetScillaCallProfile();
 };
 
 #include "AccountStoreAtomic.tpp"
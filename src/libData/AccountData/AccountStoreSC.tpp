@@ -19,8 +19,10 @@
 #include <boost/filesystem.hpp>
 #include <chrono>
 
+#include "libCrypto/Sha2.h"
 #include "libPersistence/ContractStorage2.h"
 #include "libServer/ScillaIPCServer.h"
+#include "libServer/ScillaWorkerPool.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/JsonUtils.h"
 #include "libUtils/SafeMath.h"
@@ -55,12 +57,9 @@ void AccountStoreSC<MAP>::InvokeScillaChecker(std::string& checkerPrint,
   auto func1 = [this, &checkerPrint, &ret_checker, &pid, &gasRemained,
                 &receipt]() mutable -> void {
     try {
-      if (!SysCommand::ExecuteCmd(
-              SysCommand::WITH_OUTPUT_PID,
-              GetContractCheckerCmdStr(m_root_w_version, gasRemained),
-              checkerPrint, pid)) {
-        LOG_GENERAL(WARNING, "ExecuteCmd failed: " << GetContractCheckerCmdStr(
-                                 m_root_w_version, gasRemained));
+      if (!InvokeScilla(true,
+                        GetContractCheckerArgs(m_root_w_version, gasRemained),
+                        checkerPrint, pid)) {
         receipt.AddError(EXECUTE_CMD_FAILED);
         ret_checker = false;
       }
@@ -236,7 +235,19 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
       std::string checkerPrint;
 
       int pid = -1;
-      InvokeScillaChecker(checkerPrint, ret_checker, pid, gasRemained, receipt);
+      const uint64_t gasBeforeChecker = gasRemained;
+      std::string checkerCacheKey;
+      bool checkerCached = false;
+      if (SCILLA_CHECKER_CACHE) {
+        checkerCacheKey = GetCheckerCacheKey(toAccount->GetCode());
+        checkerCached =
+            GetCachedCheckerOutput(checkerCacheKey, gasRemained, checkerPrint);
+      }
+
+      if (!checkerCached) {
+        InvokeScillaChecker(checkerPrint, ret_checker, pid, gasRemained,
+                            receipt);
+      }
 
       if (m_txnProcessTimeout) {
         LOG_GENERAL(
@@ -262,6 +273,11 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
         ret_checker = false;
       }
 
+      if (ret_checker && SCILLA_CHECKER_CACHE && !checkerCached) {
+        CacheCheckerOutput(checkerCacheKey, gasBeforeChecker - gasRemained,
+                           checkerPrint);
+      }
+
       if (ret_checker) {
         std::map<std::string, bytes> t_map_depth_map;
         t_map_depth_map.emplace(
@@ -292,13 +308,10 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
           auto func2 = [this, &runnerPrint, &ret, &pid, gasRemained,
                         &receipt]() mutable -> void {
             try {
-              if (!SysCommand::ExecuteCmd(
-                      SysCommand::WITH_OUTPUT_PID,
-                      GetCreateContractCmdStr(m_root_w_version, gasRemained, 0),
+              if (!InvokeScilla(
+                      false,
+                      GetCreateContractArgs(m_root_w_version, gasRemained, 0),
                       runnerPrint, pid)) {
-                LOG_GENERAL(WARNING,
-                            "ExecuteCmd failed: " << GetCreateContractCmdStr(
-                                m_root_w_version, gasRemained, 0));
                 receipt.AddError(EXECUTE_CMD_FAILED);
                 ret = false;
               }
@@ -504,14 +517,10 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
       auto func = [this, &runnerPrint, &ret, &pid, gasRemained, &receipt,
                    &toAddr]() mutable -> void {
         try {
-          if (!SysCommand::ExecuteCmd(
-                  SysCommand::WITH_OUTPUT_PID,
-                  GetCallContractCmdStr(m_root_w_version, gasRemained,
-                                        this->GetBalance(toAddr)),
-                  runnerPrint, pid)) {
-            LOG_GENERAL(WARNING, "ExecuteCmd failed: " << GetCallContractCmdStr(
-                                     m_root_w_version, gasRemained,
-                                     this->GetBalance(toAddr)));
+          if (!InvokeScilla(false,
+                            GetCallContractArgs(m_root_w_version, gasRemained,
+                                                this->GetBalance(toAddr)),
+                            runnerPrint, pid)) {
             receipt.AddError(EXECUTE_CMD_FAILED);
             ret = false;
           }
@@ -523,7 +532,8 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
         cv_callContract.notify_all();
       };
 
-      Contract::ContractStorage2::GetContractStorage().BufferCurrentState();
+      Contract::ContractStorage2::GetContractStorage().BufferCurrentState(
+          toAddr);
       DetachedFunction(1, func);
 
       {
@@ -555,7 +565,8 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
 
       if (ret &&
           !ParseCallContract(gasRemained, runnerPrint, receipt, tree_depth)) {
-        Contract::ContractStorage2::GetContractStorage().RevertPrevState();
+        Contract::ContractStorage2::GetContractStorage().RevertPrevState(
+            toAddr);
         receipt.RemoveAllTransitions();
         ret = false;
       }
@@ -653,9 +664,9 @@ template <class MAP>
 bool AccountStoreSC<MAP>::ExportCreateContractFiles(
     const Account& contract, const uint32_t& scilla_version) {
   LOG_MARKER();
+  ProfileTimer timer(m_profileExportMicro);
 
-  boost::filesystem::remove_all("./" + SCILLA_FILES);
-  boost::filesystem::create_directories("./" + SCILLA_FILES);
+  ResetScillaFiles();
 
   if (!(boost::filesystem::exists("./" + SCILLA_LOG))) {
     boost::filesystem::create_directories("./" + SCILLA_LOG);
@@ -668,17 +679,20 @@ bool AccountStoreSC<MAP>::ExportCreateContractFiles(
 
   try {
     // Scilla code
-    std::ofstream os(INPUT_CODE);
-    os << DataConversion::CharArrayToString(contract.GetCode());
-    os.close();
-
-    os.open(INIT_JSON);
-    os << DataConversion::CharArrayToString(contract.GetInitData());
-    os.close();
+    const std::string code =
+        DataConversion::CharArrayToString(contract.GetCode());
+    if (!WriteScillaFile(INPUT_CODE, code) ||
+        !WriteScillaFile(INIT_JSON, DataConversion::CharArrayToString(
+                                        contract.GetInitData()))) {
+      return false;
+    }
 
     // Block Json
-    JSONUtils::GetInstance().writeJsontoFile(INPUT_BLOCKCHAIN_JSON,
-                                             GetBlockStateJson(m_curBlockNum));
+    if (!WriteScillaFile(INPUT_BLOCKCHAIN_JSON,
+                         JSONUtils::GetInstance().convertJsontoStr(
+                             GetBlockStateJson(m_curBlockNum)))) {
+      return false;
+    }
   } catch (const std::exception& e) {
     LOG_GENERAL(WARNING, "Exception caught: " << e.what());
     return false;
@@ -692,8 +706,7 @@ bool AccountStoreSC<MAP>::ExportContractFiles(Account& contract) {
   LOG_MARKER();
   std::chrono::system_clock::time_point tpStart;
 
-  boost::filesystem::remove_all("./" + SCILLA_FILES);
-  boost::filesystem::create_directories("./" + SCILLA_FILES);
+  ResetScillaFiles();
 
   if (!(boost::filesystem::exists("./" + SCILLA_LOG))) {
     boost::filesystem::create_directories("./" + SCILLA_LOG);
@@ -716,22 +729,28 @@ bool AccountStoreSC<MAP>::ExportContractFiles(Account& contract) {
 
   try {
     // Scilla code
-    std::ofstream os(INPUT_CODE);
-    os << DataConversion::CharArrayToString(contract.GetCode());
-    os.close();
+    const std::string code =
+        DataConversion::CharArrayToString(contract.GetCode());
+    if (!WriteScillaFile(INPUT_CODE, code)) {
+      return false;
+    }
 
-    os.open(INIT_JSON);
     if (LOG_SC) {
       LOG_GENERAL(INFO,
                   "init data to export: " << DataConversion::CharArrayToString(
                       contract.GetInitData()));
     }
-    os << DataConversion::CharArrayToString(contract.GetInitData());
-    os.close();
+    if (!WriteScillaFile(INIT_JSON, DataConversion::CharArrayToString(
+                                        contract.GetInitData()))) {
+      return false;
+    }
 
     // Block Json
-    JSONUtils::GetInstance().writeJsontoFile(INPUT_BLOCKCHAIN_JSON,
-                                             GetBlockStateJson(m_curBlockNum));
+    if (!WriteScillaFile(INPUT_BLOCKCHAIN_JSON,
+                         JSONUtils::GetInstance().convertJsontoStr(
+                             GetBlockStateJson(m_curBlockNum)))) {
+      return false;
+    }
     if (ENABLE_CHECK_PERFORMANCE_LOG) {
       LOG_GENERAL(DEBUG, "LDB Read (microsec) = " << r_timer_end(tpStart));
     }
@@ -747,6 +766,7 @@ template <class MAP>
 bool AccountStoreSC<MAP>::ExportCallContractFiles(
     Account& contract, const Transaction& transaction) {
   LOG_MARKER();
+  ProfileTimer timer(m_profileExportMicro);
 
   if (!ExportContractFiles(contract)) {
     LOG_GENERAL(WARNING, "ExportContractFiles failed");
@@ -767,7 +787,10 @@ bool AccountStoreSC<MAP>::ExportCallContractFiles(
         Account::GetAddressFromPublicKey(transaction.GetSenderPubKey()).hex();
     msgObj["_amount"] = transaction.GetAmount().convert_to<std::string>();
 
-    JSONUtils::GetInstance().writeJsontoFile(INPUT_MESSAGE_JSON, msgObj);
+    if (!WriteScillaFile(INPUT_MESSAGE_JSON,
+                         JSONUtils::GetInstance().convertJsontoStr(msgObj))) {
+      return false;
+    }
   } catch (const std::exception& e) {
     LOG_GENERAL(WARNING, "Exception caught: " << e.what());
     return false;
@@ -780,6 +803,7 @@ template <class MAP>
 bool AccountStoreSC<MAP>::ExportCallContractFiles(
     Account& contract, const Json::Value& contractData) {
   LOG_MARKER();
+  ProfileTimer timer(m_profileExportMicro);
 
   if (!ExportContractFiles(contract)) {
     LOG_GENERAL(WARNING, "ExportContractFiles failed");
@@ -787,7 +811,11 @@ bool AccountStoreSC<MAP>::ExportCallContractFiles(
   }
 
   try {
-    JSONUtils::GetInstance().writeJsontoFile(INPUT_MESSAGE_JSON, contractData);
+    if (!WriteScillaFile(INPUT_MESSAGE_JSON,
+                         JSONUtils::GetInstance().convertJsontoStr(
+                             contractData))) {
+      return false;
+    }
   } catch (const std::exception& e) {
     LOG_GENERAL(WARNING, "Exception caught: " << e.what());
     return false;
@@ -814,55 +842,217 @@ bool AccountStoreSC<MAP>::PrepareRootPathWVersion(
 }
 
 template <class MAP>
-std::string AccountStoreSC<MAP>::GetContractCheckerCmdStr(
+std::vector<std::string> AccountStoreSC<MAP>::GetContractCheckerArgs(
     const std::string& root_w_version, const uint64_t& available_gas) {
-  std::string cmdStr =
-      // "rm -rf " + SCILLA_IPC_SOCKET_PATH + "; " +
-      root_w_version + '/' + SCILLA_CHECKER +
-      " -contractinfo -jsonerrors -libdir " + root_w_version + '/' +
-      SCILLA_LIB + " " + INPUT_CODE + " -gaslimit " +
-      std::to_string(available_gas);
-  if (LOG_SC) {
-    LOG_GENERAL(INFO, cmdStr);
-  }
-  return cmdStr;
+  return {"-contractinfo",
+          "-jsonerrors",
+          "-libdir",
+          root_w_version + '/' + SCILLA_LIB,
+          GetScillaFilePath(INPUT_CODE),
+          "-gaslimit",
+          std::to_string(available_gas)};
 }
 
 template <class MAP>
-std::string AccountStoreSC<MAP>::GetCreateContractCmdStr(
+std::vector<std::string> AccountStoreSC<MAP>::GetCreateContractArgs(
     const std::string& root_w_version, const uint64_t& available_gas,
     const boost::multiprecision::uint128_t& balance) {
-  std::string cmdStr =
-      // "rm -rf " + SCILLA_IPC_SOCKET_PATH + "; " +
-      root_w_version + '/' + SCILLA_BINARY + " -init " + INIT_JSON +
-      " -ipcaddress " + SCILLA_IPC_SOCKET_PATH + " -iblockchain " +
-      INPUT_BLOCKCHAIN_JSON + " -o " + OUTPUT_JSON + " -i " + INPUT_CODE +
-      " -libdir " + root_w_version + '/' + SCILLA_LIB + " -gaslimit " +
-      std::to_string(available_gas) + " -jsonerrors -balance " +
-      balance.convert_to<std::string>();
-  if (LOG_SC) {
-    LOG_GENERAL(INFO, cmdStr);
-  }
-  return cmdStr;
+  return {"-init",
+          GetScillaFilePath(INIT_JSON),
+          "-ipcaddress",
+          m_scillaIPCSocketPath,
+          "-iblockchain",
+          GetScillaFilePath(INPUT_BLOCKCHAIN_JSON),
+          "-o",
+          GetScillaFilePath(OUTPUT_JSON),
+          "-i",
+          GetScillaFilePath(INPUT_CODE),
+          "-libdir",
+          root_w_version + '/' + SCILLA_LIB,
+          "-gaslimit",
+          std::to_string(available_gas),
+          "-jsonerrors",
+          "-balance",
+          balance.convert_to<std::string>()};
 }
 
 template <class MAP>
-std::string AccountStoreSC<MAP>::GetCallContractCmdStr(
+std::vector<std::string> AccountStoreSC<MAP>::GetCallContractArgs(
     const std::string& root_w_version, const uint64_t& available_gas,
     const boost::multiprecision::uint128_t& balance) {
-  std::string cmdStr =
-      // "rm -rf " + SCILLA_IPC_SOCKET_PATH + "; " +
-      root_w_version + '/' + SCILLA_BINARY + " -init " + INIT_JSON +
-      " -ipcaddress " + SCILLA_IPC_SOCKET_PATH + " -iblockchain " +
-      INPUT_BLOCKCHAIN_JSON + " -imessage " + INPUT_MESSAGE_JSON + " -o " +
-      OUTPUT_JSON + " -i " + INPUT_CODE + " -libdir " + root_w_version + '/' +
-      SCILLA_LIB + " -gaslimit " + std::to_string(available_gas) +
-      " -disable-pp-json" + " -disable-validate-json" +
-      " -jsonerrors -balance " + balance.convert_to<std::string>();
+  return {"-init",
+          GetScillaFilePath(INIT_JSON),
+          "-ipcaddress",
+          m_scillaIPCSocketPath,
+          "-iblockchain",
+          GetScillaFilePath(INPUT_BLOCKCHAIN_JSON),
+          "-imessage",
+          GetScillaFilePath(INPUT_MESSAGE_JSON),
+          "-o",
+          GetScillaFilePath(OUTPUT_JSON),
+          "-i",
+          GetScillaFilePath(INPUT_CODE),
+          "-libdir",
+          root_w_version + '/' + SCILLA_LIB,
+          "-gaslimit",
+          std::to_string(available_gas),
+          "-disable-pp-json",
+          "-disable-validate-json",
+          "-jsonerrors",
+          "-balance",
+          balance.convert_to<std::string>()};
+}
+
+template <class MAP>
+std::string AccountStoreSC<MAP>::GetScillaFilePath(const std::string& file) {
+  if (!SCILLA_MEM_FILES) {
+    return file;
+  }
+
+  auto& memFile = m_memFiles[file];
+  if (!memFile) {
+    memFile = std::make_unique<MemFile>(
+        boost::filesystem::path(file).filename().string());
+  }
+  // Falls back to the file on disk if there is no memfd support
+  return memFile->IsOpen() ? memFile->GetPath() : file;
+}
+
+template <class MAP>
+bool AccountStoreSC<MAP>::WriteScillaFile(const std::string& file,
+                                          const std::string& content) {
+  if (GetScillaFilePath(file) != file) {
+    return m_memFiles[file]->Write(content);
+  }
+
+  std::ofstream os(file);
+  os << content;
+  os.close();
+  return !os.fail();
+}
+
+template <class MAP>
+bool AccountStoreSC<MAP>::ReadScillaOutput(std::string& output) {
+  if (GetScillaFilePath(OUTPUT_JSON) != OUTPUT_JSON) {
+    return m_memFiles[OUTPUT_JSON]->Read(output);
+  }
+
+  std::ifstream in(OUTPUT_JSON, std::ios::binary);
+  if (!in.is_open()) {
+    return false;
+  }
+  output = {std::istreambuf_iterator<char>(in),
+            std::istreambuf_iterator<char>()};
+  return true;
+}
+
+template <class MAP>
+void AccountStoreSC<MAP>::ResetScillaFiles() {
+  // The memfd inputs are overwritten by the next export, only the output of
+  // the previous run has to go
+  if (GetScillaFilePath(OUTPUT_JSON) != OUTPUT_JSON &&
+      m_memFiles[OUTPUT_JSON]->Clear()) {
+    return;
+  }
+
+  boost::filesystem::remove_all("./" + SCILLA_FILES);
+  boost::filesystem::create_directories("./" + SCILLA_FILES);
+}
+
+template <class MAP>
+std::string AccountStoreSC<MAP>::GetCmdStr(
+    const std::string& binary, const std::vector<std::string>& args) {
+  std::string cmdStr = binary;
+  for (const auto& arg : args) {
+    cmdStr += " " + arg;
+  }
+  return cmdStr;
+}
+
+template <class MAP>
+bool AccountStoreSC<MAP>::InvokeScilla(bool checker,
+                                       const std::vector<std::string>& args,
+                                       std::string& output, int& pid) {
+  ProfileTimer timer(m_profileInvokeMicro);
+  m_profileInvocations++;
+  const std::string cmdStr = GetCmdStr(
+      m_root_w_version + '/' + (checker ? SCILLA_CHECKER : SCILLA_BINARY),
+      args);
   if (LOG_SC) {
     LOG_GENERAL(INFO, cmdStr);
   }
-  return cmdStr;
+
+  bool ret;
+  if (ENABLE_SCILLA_SERVER) {
+    auto& pool = ScillaWorkerPool::GetInstance();
+    ret = checker ? pool.CallChecker(m_root_w_version, args, output, pid)
+                  : pool.CallRunner(m_root_w_version, args, output, pid);
+  } else {
+    ret = SysCommand::ExecuteCmd(SysCommand::WITH_OUTPUT_PID, cmdStr, output,
+                                 pid);
+  }
+
+  if (!ret) {
+    LOG_GENERAL(WARNING, "ExecuteCmd failed: " << cmdStr);
+  }
+  return ret;
+}
+
+template <class MAP>
+std::string AccountStoreSC<MAP>::GetCheckerCacheKey(const bytes& code) {
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  sha2.Update(code);
+  return dev::h256(sha2.Finalize()).hex() + ':' + m_root_w_version;
+}
+
+template <class MAP>
+bool AccountStoreSC<MAP>::GetCachedCheckerOutput(const std::string& key,
+                                                 const uint64_t& gasRemained,
+                                                 std::string& checkerPrint) {
+  std::string cached;
+  if (!Contract::ContractStorage2::GetContractStorage().GetCheckerOutput(
+          key, cached)) {
+    return false;
+  }
+
+  Json::Value entry;
+  Json::Value output;
+  uint64_t gasUsed;
+  try {
+    if (!JSONUtils::GetInstance().convertStrtoJson(cached, entry) ||
+        !JSONUtils::GetInstance().convertStrtoJson(entry["output"].asString(),
+                                                   output)) {
+      return false;
+    }
+    gasUsed = boost::lexical_cast<uint64_t>(entry["gas_used"].asString());
+  } catch (const std::exception& e) {
+    LOG_GENERAL(WARNING, "Invalid cached checker output: " << e.what());
+    return false;
+  }
+
+  // The checker's gas cost only depends on the code. With less gas than that
+  // left it would run out, so the checker has to run for the exact error.
+  if (gasUsed > gasRemained) {
+    return false;
+  }
+
+  output["gas_remaining"] = std::to_string(gasRemained - gasUsed);
+  checkerPrint = JSONUtils::GetInstance().convertJsontoStr(output);
+  LOG_GENERAL(INFO, "Reusing checker output of " << key);
+  return true;
+}
+
+template <class MAP>
+void AccountStoreSC<MAP>::CacheCheckerOutput(const std::string& key,
+                                             const uint64_t& gasUsed,
+                                             const std::string& checkerPrint) {
+  Json::Value entry;
+  entry["gas_used"] = std::to_string(gasUsed);
+  entry["output"] = checkerPrint;
+  if (!Contract::ContractStorage2::GetContractStorage().PutCheckerOutput(
+          key, JSONUtils::GetInstance().convertJsontoStr(entry))) {
+    LOG_GENERAL(WARNING, "PutCheckerOutput failed for " << key);
+  }
 }
 
 template <class MAP>
@@ -870,6 +1060,7 @@ bool AccountStoreSC<MAP>::ParseContractCheckerOutput(
     const std::string& checkerPrint, TransactionReceipt& receipt,
     bytes& map_depth_data, uint64_t& gasRemained) {
   LOG_MARKER();
+  ProfileTimer timer(m_profileParseMicro);
 
   LOG_GENERAL(
       INFO,
@@ -944,6 +1135,7 @@ template <class MAP>
 bool AccountStoreSC<MAP>::ParseCreateContract(uint64_t& gasRemained,
                                               const std::string& runnerPrint,
                                               TransactionReceipt& receipt) {
+  ProfileTimer timer(m_profileParseMicro);
   Json::Value jsonOutput;
   if (!ParseCreateContractOutput(jsonOutput, runnerPrint, receipt)) {
     return false;
@@ -957,10 +1149,9 @@ bool AccountStoreSC<MAP>::ParseCreateContractOutput(
     TransactionReceipt& receipt) {
   // LOG_MARKER();
 
-  std::ifstream in(OUTPUT_JSON, std::ios::binary);
   std::string outStr;
 
-  if (!in.is_open()) {
+  if (!ReadScillaOutput(outStr)) {
     LOG_GENERAL(WARNING,
                 "Error opening output file or no output file generated");
 
@@ -971,9 +1162,6 @@ bool AccountStoreSC<MAP>::ParseCreateContractOutput(
       receipt.AddError(NO_OUTPUT);
       return false;
     }
-  } else {
-    outStr = {std::istreambuf_iterator<char>(in),
-              std::istreambuf_iterator<char>()};
   }
 
   LOG_GENERAL(
@@ -1060,15 +1248,16 @@ bool AccountStoreSC<MAP>::ParseCallContractOutput(
     Json::Value& jsonOutput, const std::string& runnerPrint,
     TransactionReceipt& receipt) {
   // LOG_MARKER();
+  // Only the output itself, ParseCallContractJsonOutput runs the chain calls
+  ProfileTimer timer(m_profileParseMicro);
   std::chrono::system_clock::time_point tpStart;
   if (ENABLE_CHECK_PERFORMANCE_LOG) {
     tpStart = r_timer_start();
   }
-  std::ifstream in(OUTPUT_JSON, std::ios::binary);
   std::string outStr;
 
   try {
-    if (!in.is_open()) {
+    if (!ReadScillaOutput(outStr)) {
       LOG_GENERAL(WARNING,
                   "Error opening output file or no output file generated");
 
@@ -1079,9 +1268,6 @@ bool AccountStoreSC<MAP>::ParseCallContractOutput(
         receipt.AddError(NO_OUTPUT);
         return false;
       }
-    } else {
-      outStr = {std::istreambuf_iterator<char>(in),
-                std::istreambuf_iterator<char>()};
     }
 
     LOG_GENERAL(
@@ -1343,14 +1529,10 @@ bool AccountStoreSC<MAP>::ParseCallContractJsonOutput(
       auto func = [this, &runnerPrint, &result, &pid, gasRemained, &receipt,
                    &recipient]() mutable -> void {
         try {
-          if (!SysCommand::ExecuteCmd(
-                  SysCommand::WITH_OUTPUT_PID,
-                  GetCallContractCmdStr(m_root_w_version, gasRemained,
-                                        this->GetBalance(recipient)),
-                  runnerPrint, pid)) {
-            LOG_GENERAL(WARNING, "ExecuteCmd failed: " << GetCallContractCmdStr(
-                                     m_root_w_version, gasRemained,
-                                     this->GetBalance(recipient)));
+          if (!InvokeScilla(false,
+                            GetCallContractArgs(m_root_w_version, gasRemained,
+                                                this->GetBalance(recipient)),
+                            runnerPrint, pid)) {
             receipt.AddError(EXECUTE_CMD_FAILED);
             result = false;
           }
@@ -1484,4 +1666,50 @@ void AccountStoreSC<MAP>::SetScillaIPCServer(
     std::shared_ptr<ScillaIPCServer> scillaIPCServer) {
   LOG_MARKER();
   m_scillaIPCServer = std::move(scillaIPCServer);
+}
+
+template <class MAP>
+void AccountStoreSC<MAP>::SetScillaIPCSocketPath(const std::string& path) {
+  m_scillaIPCSocketPath = path;
+}
+
+template <class MAP>
+const std::set<Address>& AccountStoreSC<MAP>::GetStorageRootUpdateBuffer()
+    const {
+  return m_storageRootUpdateBuffer;
+}
+
+template <class MAP>
+void AccountStoreSC<MAP>::AddToStorageRootUpdateBuffer(
+    const std::set<Address>& addresses) {
+  std::lock_guard<std::mutex> g(m_mutexUpdateAccounts);
+  m_storageRootUpdateBuffer.insert(addresses.begin(), addresses.end());
+}
+
+template <class MAP>
+ScillaCallProfile AccountStoreSC<MAP>::GetScillaCallProfile() const {
+  ScillaCallProfile profile;
+  profile.m_invocations = m_profileInvocations;
+  profile.m_exportMicro = m_profileExportMicro;
+  profile.m_invokeMicro = m_profileInvokeMicro;
+  profile.m_parseMicro = m_profileParseMicro;
+  if (m_scillaIPCServer != nullptr) {
+    const auto stats = m_scillaIPCServer->GetStats();
+    profile.m_ipcReads = stats.m_reads;
+    profile.m_ipcReadMicro = stats.m_readMicro;
+    profile.m_ipcWrites = stats.m_writes;
+    profile.m_ipcWriteMicro = stats.m_writeMicro;
+  }
+  return profile;
+}
+
+template <class MAP>
+void AccountStoreSC<MAP>::ResetScillaCallProfile() {
+  m_profileInvocations = 0;
+  m_profileExportMicro = 0;
+  m_profileInvokeMicro = 0;
+  m_profileParseMicro = 0;
+  if (m_scillaIPCServer != nullptr) {
+    m_scillaIPCServer->ResetStats();
+  }
 }
\ No newline at end of file
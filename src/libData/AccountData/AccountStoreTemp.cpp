@@ -24,8 +24,11 @@ using namespace boost::multiprecision;
 AccountStoreTemp::AccountStoreTemp(AccountStore& parent) : m_parent(parent) {}
 
 Account* AccountStoreTemp::GetAccount(const Address& address) {
+  // The caller may change what it gets
+  m_touchedAddresses.emplace(address);
+
   Account* account =
-      AccountStoreBase<map<Address, Account>>::GetAccount(address);
+      AccountStoreBase<FlatAddressMap<Account>>::GetAccount(address);
   if (account != nullptr) {
     // LOG_GENERAL(INFO, "Got From Temp");
     return account;
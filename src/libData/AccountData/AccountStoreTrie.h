@@ -36,6 +36,10 @@ class AccountStoreTrie : public AccountStoreSC<MAP> {
   AccountStoreTrie();
 
   bool UpdateStateTrie(const Address& address, const Account& account);
+  /// Inserts serialized accounts, merging the root's subtrees in parallel, or
+  /// building the trie bottom up if it is empty and the addresses are sorted
+  void UpdateStateTrieBatch(
+      const std::vector<std::pair<Address, bytes>>& entries);
   bool RemoveFromTrie(const Address& address);
 
  public:
@@ -44,13 +48,24 @@ class AccountStoreTrie : public AccountStoreSC<MAP> {
   void InitTrie();
 
   bool Serialize(bytes& dst, unsigned int offset) const override;
+  /// Serializes up to maxAccounts accounts as Serialize does, from the first
+  /// address not below cursor, along with the state root. more is set if there
+  /// are accounts left, and next to the first of them, to resume from.
+  bool SerializeChunk(bytes& dst, unsigned int offset, const Address& cursor,
+                      unsigned int maxAccounts, Address& next, bool& more,
+                      dev::h256& root) const;
 
   Account* GetAccount(const Address& address) override;
 
   dev::h256 GetStateRootHash() const;
+  /// Returns the state trie nodes that prove the account of address, or its
+  /// absence, against the state root, which is set to root
+  std::vector<bytes> GetStateProof(const Address& address, dev::h256& root);
   dev::h256 GetPrevRootHash() const;
   bool UpdateStateTrieAll();
 
+  /// Logs every account of the state trie, STATE_EXPORT_CHUNK_ACCOUNTS at a
+  /// time so that the trie is not locked for the whole state
   void PrintAccountState() override;
 };
 
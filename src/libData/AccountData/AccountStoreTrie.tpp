@@ -15,6 +15,8 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include "libPersistence/ContractStorage.h"
 
 #include "libMessage/MessengerAccountStoreTrie.h"
@@ -52,6 +54,24 @@ bool AccountStoreTrie<DB, MAP>::Serialize(bytes& dst,
   return true;
 }
 
+template <class DB, class MAP>
+bool AccountStoreTrie<DB, MAP>::SerializeChunk(bytes& dst, unsigned int offset,
+                                               const Address& cursor,
+                                               unsigned int maxAccounts,
+                                               Address& next, bool& more,
+                                               dev::h256& root) const {
+  std::lock_guard<std::mutex> g(m_mutexTrie);
+  root = m_state.root();
+  if (!MessengerAccountStoreTrie::SetAccountStoreTrieChunk(
+          dst, offset, m_state, this->m_addressToAccount, cursor, maxAccounts,
+          next, more)) {
+    LOG_GENERAL(WARNING, "Messenger::SetAccountStoreTrieChunk failed.");
+    return false;
+  }
+
+  return true;
+}
+
 template <class DB, class MAP>
 Account* AccountStoreTrie<DB, MAP>::GetAccount(const Address& address) {
   // LOG_MARKER();
@@ -106,6 +126,15 @@ bool AccountStoreTrie<DB, MAP>::UpdateStateTrie(const Address& address,
   return true;
 }
 
+template <class DB, class MAP>
+void AccountStoreTrie<DB, MAP>::UpdateStateTrieBatch(
+    const std::vector<std::pair<Address, bytes>>& entries) {
+  std::lock_guard<std::mutex> g(m_mutexTrie);
+  if (!m_state.buildSorted(entries)) {
+    m_state.insertBatch(entries, STATE_TRIE_UPDATE_THREADS);
+  }
+}
+
 template <class DB, class MAP>
 bool AccountStoreTrie<DB, MAP>::RemoveFromTrie(const Address& address) {
   // LOG_MARKER();
@@ -125,6 +154,17 @@ dev::h256 AccountStoreTrie<DB, MAP>::GetStateRootHash() const {
   return m_state.root();
 }
 
+template <class DB, class MAP>
+std::vector<bytes> AccountStoreTrie<DB, MAP>::GetStateProof(
+    const Address& address, dev::h256& root) {
+  std::lock(m_mutexTrie, m_mutexDB);
+  std::lock_guard<std::mutex> lock1(m_mutexTrie, std::adopt_lock);
+  std::lock_guard<std::mutex> lock2(m_mutexDB, std::adopt_lock);
+
+  root = m_state.root();
+  return m_state.getProof(address);
+}
+
 template <class DB, class MAP>
 dev::h256 AccountStoreTrie<DB, MAP>::GetPrevRootHash() const {
   LOG_MARKER();
@@ -136,21 +176,58 @@ dev::h256 AccountStoreTrie<DB, MAP>::GetPrevRootHash() const {
 
 template <class DB, class MAP>
 bool AccountStoreTrie<DB, MAP>::UpdateStateTrieAll() {
-  std::lock_guard<std::mutex> g(m_mutexTrie);
+  std::vector<std::pair<Address, bytes>> entries;
+  entries.reserve(this->m_addressToAccount->size());
   for (auto const& entry : *(this->m_addressToAccount)) {
     bytes rawBytes;
     if (!entry.second.SerializeBase(rawBytes, 0)) {
       LOG_GENERAL(WARNING, "Messenger::SetAccountBase failed");
       return false;
     }
-    m_state.insert(entry.first, rawBytes);
+    entries.emplace_back(entry.first, std::move(rawBytes));
   }
 
+  // Sorted, so that an empty trie (as at genesis) is built bottom up
+  std::sort(entries.begin(), entries.end(),
+            [](const std::pair<Address, bytes>& a,
+               const std::pair<Address, bytes>& b) {
+              return a.first < b.first;
+            });
+  UpdateStateTrieBatch(entries);
+
   return true;
 }
 
 template <class DB, class MAP>
 void AccountStoreTrie<DB, MAP>::PrintAccountState() {
-  AccountStoreBase<MAP>::PrintAccountState();
+  LOG_MARKER();
+
+  Address cursor;
+  for (bool more = true; more;) {
+    std::vector<std::pair<Address, bytes>> chunk;
+    {
+      std::lock_guard<std::mutex> g(m_mutexTrie);
+      auto it = m_state.lower_bound(cursor);
+      for (unsigned int i = 0;
+           i < STATE_EXPORT_CHUNK_ACCOUNTS && it != m_state.end(); i++, ++it) {
+        const auto entry = *it;
+        chunk.emplace_back(entry.first, entry.second.toBytes());
+      }
+      more = it != m_state.end();
+      if (more) {
+        cursor = (*it).first;
+      }
+    }
+
+    for (const auto& entry : chunk) {
+      Account account;
+      if (!account.DeserializeBase(entry.second, 0)) {
+        LOG_GENERAL(WARNING, "Account::DeserializeBase failed");
+        continue;
+      }
+      LOG_GENERAL(INFO, entry.first << " " << account);
+    }
+  }
+
   LOG_GENERAL(INFO, "State Root: " << GetStateRootHash());
 }
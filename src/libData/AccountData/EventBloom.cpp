@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "EventBloom.h"
+#include "TransactionReceipt.h"
+#include "libCrypto/Sha2.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+EventBloom::Bits EventBloom::GetKeyBits(const Address& address,
+                                        const string& eventName) {
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  sha2.Update(address.asBytes());
+  if (!eventName.empty()) {
+    sha2.Update(bytes(eventName.begin(), eventName.end()));
+  }
+  return dev::h256(sha2.Finalize()).bloomPart<3, SIZE>();
+}
+
+void EventBloom::Add(const Address& address, const string& eventName) {
+  m_bits |= GetKeyBits(address, "");
+  m_bits |= GetKeyBits(address, eventName);
+}
+
+void EventBloom::AddReceipt(const TransactionReceipt& receipt) {
+  for (const auto& log : receipt.GetData().m_eventLogs) {
+    if (!log.isMember("address") || !log.isMember("_eventname") ||
+        !log["address"].isString() || !log["_eventname"].isString()) {
+      continue;
+    }
+    try {
+      Add(Address(log["address"].asString()), log["_eventname"].asString());
+    } catch (const exception& e) {
+      LOG_GENERAL(WARNING, "Invalid event log address "
+                               << log["address"].asString() << ": "
+                               << e.what());
+    }
+  }
+}
+
+bool EventBloom::MayContain(const Address& address,
+                            const string& eventName) const {
+  return m_bits.contains(GetKeyBits(address, eventName));
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_EVENTBLOOM_H_
+#define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_EVENTBLOOM_H_
+
+#include <string>
+
+#include "Address.h"
+#include "depends/common/FixedHash.h"
+
+class TransactionReceipt;
+
+/// Bloom filter of the (contract address, event name) of the event logs of
+/// the transactions of a tx block. Each address is also added by itself, so
+/// that the events of a contract can be looked up whatever their name.
+class EventBloom {
+ public:
+  static const unsigned int SIZE = 256;  // 2048 bits, 3 set per key
+  using Bits = dev::FixedHash<SIZE>;
+
+  EventBloom() = default;
+  explicit EventBloom(const Bits& bits) : m_bits(bits) {}
+
+  void Add(const Address& address, const std::string& eventName);
+
+  /// Adds the event logs of the receipt.
+  void AddReceipt(const TransactionReceipt& receipt);
+
+  /// Whether the block may have events of address, named eventName unless it
+  /// is empty. A false answer is exact, a true one may be a false positive.
+  bool MayContain(const Address& address, const std::string& eventName) const;
+
+  void Merge(const EventBloom& other) { m_bits |= other.m_bits; }
+
+  bool IsEmpty() const { return !m_bits; }
+
+  const Bits& GetBits() const { return m_bits; }
+
+ private:
+  static Bits GetKeyBits(const Address& address, const std::string& eventName);
+
+  Bits m_bits;
+};
+
+#endif  // ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_EVENTBLOOM_H_
@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_FLATADDRESSMAP_H_
+#define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_FLATADDRESSMAP_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Address.h"
+
+/// Open addressing hash map keyed by Address, usable as the MAP of the
+/// account stores.
+/// Entries are placed one after another in chunks of an arena and the table
+/// only holds their positions, so growing the table never moves an entry and
+/// pointers to values stay valid until the entry is erased. clear() destroys
+/// the entries but keeps the arena and the table for the next round.
+/// Entries are iterated in insertion order, not in address order.
+template <class T>
+class FlatAddressMap {
+ public:
+  using key_type = Address;
+  using mapped_type = T;
+  using value_type = std::pair<const Address, T>;
+  using size_type = std::size_t;
+
+ private:
+  static const size_type CHUNK_SIZE = 256;
+  static const uint32_t EMPTY = 0;
+  static const uint32_t ERASED = UINT32_MAX;
+
+  struct Node {
+    value_type m_value;
+    bool m_live;
+
+    template <class... Args>
+    explicit Node(Args&&... args)
+        : m_value(std::forward<Args>(args)...), m_live(true) {}
+  };
+
+  using Storage =
+      typename std::aligned_storage<sizeof(Node), alignof(Node)>::type;
+
+  std::vector<std::unique_ptr<Storage[]>> m_chunks;
+  /// number of nodes placed since the last clear, including erased ones
+  size_type m_numNodes{0};
+  size_type m_size{0};
+  /// position of the node plus one, EMPTY or ERASED
+  std::vector<uint32_t> m_table;
+  size_type m_numErased{0};
+
+  Node* GetNode(size_type pos) const {
+    Storage& storage = m_chunks[pos / CHUNK_SIZE][pos % CHUNK_SIZE];
+    return reinterpret_cast<Node*>(&storage);
+  }
+
+  static size_type Hash(const Address& key) {
+    // Addresses are parts of hashes, so any of their bytes will do
+    size_type h;
+    std::memcpy(&h, key.data(), sizeof(h));
+    return h;
+  }
+
+  /// Returns the table slot holding key, or the slot to put it in
+  size_type FindSlot(const Address& key, bool& found) const {
+    const size_type mask = m_table.size() - 1;
+    size_type firstErased = m_table.size();
+
+    for (size_type slot = Hash(key) & mask;; slot = (slot + 1) & mask) {
+      const uint32_t entry = m_table[slot];
+      if (entry == EMPTY) {
+        found = false;
+        return (firstErased < m_table.size()) ? firstErased : slot;
+      }
+      if (entry == ERASED) {
+        if (firstErased == m_table.size()) {
+          firstErased = slot;
+        }
+      } else if (GetNode(entry - 1)->m_value.first == key) {
+        found = true;
+        return slot;
+      }
+    }
+  }
+
+  void Rehash(size_type capacity) {
+    std::vector<uint32_t> table(capacity, EMPTY);
+    const size_type mask = capacity - 1;
+    for (size_type pos = 0; pos < m_numNodes; pos++) {
+      const Node* node = GetNode(pos);
+      if (!node->m_live) {
+        continue;
+      }
+      size_type slot = Hash(node->m_value.first) & mask;
+      while (table[slot] != EMPTY) {
+        slot = (slot + 1) & mask;
+      }
+      table[slot] = pos + 1;
+    }
+    m_table.swap(table);
+    m_numErased = 0;
+  }
+
+  /// Keeps the table at most half full, counting erased slots
+  void Reserve(size_type count) {
+    if (m_table.empty()) {
+      m_table.assign(CHUNK_SIZE * 2, EMPTY);
+    }
+    if ((count + m_numErased) * 2 > m_table.size()) {
+      size_type capacity = m_table.size();
+      while (count * 2 > capacity) {
+        capacity *= 2;
+      }
+      Rehash(capacity);
+    }
+  }
+
+  template <class... Args>
+  Node* PlaceNode(Args&&... args) {
+    if (m_numNodes == m_chunks.size() * CHUNK_SIZE) {
+      m_chunks.emplace_back(new Storage[CHUNK_SIZE]);
+    }
+    Node* node = new (GetNode(m_numNodes)) Node(std::forward<Args>(args)...);
+    m_numNodes++;
+    return node;
+  }
+
+  template <class Value>
+  class Iterator {
+    const FlatAddressMap* m_map;
+    size_type m_pos;
+
+    void SkipErased() {
+      while ((m_pos < m_map->m_numNodes) && !m_map->GetNode(m_pos)->m_live) {
+        m_pos++;
+      }
+    }
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename FlatAddressMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value*;
+    using reference = Value&;
+
+    Iterator(const FlatAddressMap* map, size_type pos)
+        : m_map(map), m_pos(pos) {
+      SkipErased();
+    }
+
+    template <class V>
+    Iterator(const Iterator<V>& other)
+        : m_map(other.m_map), m_pos(other.m_pos) {}
+
+    reference operator*() const { return m_map->GetNode(m_pos)->m_value; }
+    pointer operator->() const { return &m_map->GetNode(m_pos)->m_value; }
+
+    Iterator& operator++() {
+      m_pos++;
+      SkipErased();
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator it(*this);
+      ++(*this);
+      return it;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return m_pos == other.m_pos;
+    }
+    bool operator!=(const Iterator& other) const {
+      return m_pos != other.m_pos;
+    }
+
+    template <class V>
+    friend class Iterator;
+    friend class FlatAddressMap;
+  };
+
+ public:
+  using iterator = Iterator<value_type>;
+  using const_iterator = Iterator<const value_type>;
+
+  FlatAddressMap() = default;
+  FlatAddressMap(const FlatAddressMap&) = delete;
+  FlatAddressMap& operator=(const FlatAddressMap&) = delete;
+
+  ~FlatAddressMap() { clear(); }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, m_numNodes); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, m_numNodes); }
+
+  size_type size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  iterator find(const Address& key) {
+    if (m_table.empty()) {
+      return end();
+    }
+    bool found;
+    const size_type slot = FindSlot(key, found);
+    return found ? iterator(this, m_table[slot] - 1) : end();
+  }
+
+  const_iterator find(const Address& key) const {
+    return const_cast<FlatAddressMap*>(this)->find(key);
+  }
+
+  size_type count(const Address& key) const {
+    return (find(key) != end()) ? 1 : 0;
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(const Address& key, Args&&... args) {
+    Reserve(m_size + 1);
+    bool found;
+    const size_type slot = FindSlot(key, found);
+    if (found) {
+      return {iterator(this, m_table[slot] - 1), false};
+    }
+    if (m_table[slot] == ERASED) {
+      m_numErased--;
+    }
+    PlaceNode(std::piecewise_construct, std::forward_as_tuple(key),
+              std::forward_as_tuple(std::forward<Args>(args)...));
+    m_table[slot] = m_numNodes;
+    m_size++;
+    return {iterator(this, m_numNodes - 1), true};
+  }
+
+  template <class P>
+  std::pair<iterator, bool> insert(P&& value) {
+    return emplace(value.first, std::forward<P>(value).second);
+  }
+
+  T& operator[](const Address& key) { return emplace(key).first->second; }
+
+  size_type erase(const Address& key) {
+    if (m_table.empty()) {
+      return 0;
+    }
+    bool found;
+    const size_type slot = FindSlot(key, found);
+    if (!found) {
+      return 0;
+    }
+    Node* node = GetNode(m_table[slot] - 1);
+    node->m_value.~value_type();
+    node->m_live = false;
+    m_table[slot] = ERASED;
+    m_numErased++;
+    m_size--;
+    return 1;
+  }
+
+  /// Returns the entries in address order, as a std::map would iterate them
+  std::vector<const value_type*> GetSortedEntries() const {
+    std::vector<const value_type*> entries;
+    entries.reserve(m_size);
+    for (const auto& entry : *this) {
+      entries.emplace_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const value_type* a, const value_type* b) {
+                return a->first < b->first;
+              });
+    return entries;
+  }
+
+  /// Destroys all entries. The memory is kept for the entries to come.
+  void clear() {
+    for (size_type pos = 0; pos < m_numNodes; pos++) {
+      Node* node = GetNode(pos);
+      if (node->m_live) {
+        node->~Node();
+      }
+    }
+    m_numNodes = 0;
+    m_size = 0;
+    m_numErased = 0;
+    std::fill(m_table.begin(), m_table.end(), EMPTY);
+  }
+};
+
+template <class T>
+const typename FlatAddressMap<T>::size_type FlatAddressMap<T>::CHUNK_SIZE;
+template <class T>
+const uint32_t FlatAddressMap<T>::EMPTY;
+template <class T>
+const uint32_t FlatAddressMap<T>::ERASED;
+
+#endif  // ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_FLATADDRESSMAP_H_
@@ -26,6 +26,9 @@
 struct MBnForwardedTxnEntry {
   MicroBlock m_microBlock;
   std::vector<TransactionWithReceipt> m_transactions;
+  // Set by a compact relay, in the order of the microblock txn hashes, until
+  // m_transactions is rebuilt from them
+  std::vector<TransactionReceipt> m_receipts;
 
   friend std::ostream& operator<<(std::ostream& os,
                                   const MBnForwardedTxnEntry& t);
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_PENDINGTXNQUEUE_H_
+#define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_PENDINGTXNQUEUE_H_
+
+#include <functional>
+#include <map>
+#include <set>
+
+#include "Address.h"
+#include "Transaction.h"
+
+/// Transactions held back until the nonce of their sender catches up.
+/// A sender whose lowest held nonce is the next one expected is kept in a
+/// ready set, so picking a transaction does not go through every sender.
+/// Senders touched since the last pick are looked up again on the next one.
+class PendingTxnQueue {
+ public:
+  using NonceFunc = std::function<uint128_t(const Address& addr)>;
+  using TxnMap = std::map<Address, std::map<uint64_t, Transaction>>;
+
+  explicit PendingTxnQueue(const NonceFunc& getNonce) : m_getNonce(getNonce) {}
+
+  /// Holds the transaction. If the sender already has one with the same
+  /// nonce, only the one with the higher gas price is kept.
+  void Insert(const Transaction& t) {
+    const Address senderAddr = t.GetSenderAddr();
+    auto& txns = m_txns[senderAddr];
+    auto it = txns.find(t.GetNonce());
+    if (it == txns.end()) {
+      txns.emplace(t.GetNonce(), t);
+    } else if (t.GetGasPrice() > it->second.GetGasPrice()) {
+      it->second = t;
+    }
+    m_touched.insert(senderAddr);
+  }
+
+  /// Records that the nonce of the sender may have changed.
+  void Touch(const Address& addr) {
+    if (Contains(addr)) {
+      m_touched.insert(addr);
+    }
+  }
+
+  bool Contains(const Address& addr) const {
+    return m_txns.find(addr) != m_txns.end();
+  }
+
+  /// Takes the lowest held transaction of the first ready sender.
+  /// Returns false if no sender is ready.
+  bool PopReady(Transaction& t) {
+    for (const auto& addr : m_touched) {
+      auto it = m_txns.find(addr);
+      if ((it != m_txns.end()) &&
+          (it->second.begin()->first == m_getNonce(addr) + 1)) {
+        m_ready.insert(addr);
+      } else {
+        m_ready.erase(addr);
+      }
+    }
+    m_touched.clear();
+
+    if (m_ready.empty()) {
+      return false;
+    }
+
+    const Address addr = *m_ready.begin();
+    auto it = m_txns.find(addr);
+    t = std::move(it->second.begin()->second);
+    it->second.erase(it->second.begin());
+    if (it->second.empty()) {
+      m_txns.erase(it);
+    }
+
+    // Whether the next one is ready depends on how t is handled
+    m_ready.erase(addr);
+    Touch(addr);
+    return true;
+  }
+
+  const TxnMap& GetTxns() const { return m_txns; }
+
+ private:
+  TxnMap m_txns;
+  std::set<Address> m_ready;
+  std::set<Address> m_touched;
+  NonceFunc m_getNonce;
+};
+
+#endif  // ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_PENDINGTXNQUEUE_H_
@@ -30,12 +30,51 @@ unsigned char LOW_BITS_MASK = 0x0F;
 unsigned char ACC_COND = 0x1;
 unsigned char TX_COND = 0x2;
 
+void Transaction::CopyCached(const shared_ptr<const bytes>& cached,
+                             bytes& dst, unsigned int offset) {
+  if ((offset + cached->size()) > dst.size()) {
+    dst.resize(offset + cached->size());
+  }
+  copy(cached->begin(), cached->end(), dst.begin() + offset);
+}
+
 bool Transaction::SerializeCoreFields(bytes& dst, unsigned int offset) const {
-  return Messenger::SetTransactionCoreInfo(dst, offset, m_coreInfo);
+  auto cached = atomic_load(&m_serializedCoreFields);
+  if (!cached) {
+    bytes encoded;
+    if (!Messenger::SetTransactionCoreInfo(encoded, 0, m_coreInfo)) {
+      return false;
+    }
+    cached = make_shared<const bytes>(move(encoded));
+    atomic_store(&m_serializedCoreFields, cached);
+  }
+
+  CopyCached(cached, dst, offset);
+  return true;
 }
 
 Transaction::Transaction() {}
 
+Transaction::Transaction(const Transaction& src)
+    : SerializableDataBlock(src),
+      m_tranID(src.m_tranID),
+      m_coreInfo(src.m_coreInfo),
+      m_signature(src.m_signature),
+      m_serialized(atomic_load(&src.m_serialized)),
+      m_serializedCoreFields(atomic_load(&src.m_serializedCoreFields)) {}
+
+Transaction& Transaction::operator=(const Transaction& src) {
+  if (this != &src) {
+    m_tranID = src.m_tranID;
+    m_coreInfo = src.m_coreInfo;
+    m_signature = src.m_signature;
+    atomic_store(&m_serialized, atomic_load(&src.m_serialized));
+    atomic_store(&m_serializedCoreFields,
+                 atomic_load(&src.m_serializedCoreFields));
+  }
+  return *this;
+}
+
 Transaction::Transaction(const bytes& src, unsigned int offset) {
   Deserialize(src, offset);
 }
@@ -51,14 +90,8 @@ Transaction::Transaction(const uint32_t& version, const uint64_t& nonce,
   SerializeCoreFields(txnData, 0);
 
   // Generate the transaction ID
-  SHA2<HashType::HASH_VARIANT_256> sha2;
-  sha2.Update(txnData);
-  const bytes& output = sha2.Finalize();
-  if (output.size() != TRAN_HASH_SIZE) {
-    LOG_GENERAL(WARNING, "We failed to generate m_tranID.");
-    return;
-  }
-  copy(output.begin(), output.end(), m_tranID.asArray().begin());
+  SHA2<HashType::HASH_VARIANT_256>::Hash(txnData.data(), txnData.size(),
+                                         m_tranID.data());
 
   // Generate the signature
   if (!Schnorr::Sign(txnData, senderKeyPair.first, m_coreInfo.senderPubKey,
@@ -90,14 +123,8 @@ Transaction::Transaction(const uint32_t& version, const uint64_t& nonce,
   SerializeCoreFields(txnData, 0);
 
   // Generate the transaction ID
-  SHA2<HashType::HASH_VARIANT_256> sha2;
-  sha2.Update(txnData);
-  const bytes& output = sha2.Finalize();
-  if (output.size() != TRAN_HASH_SIZE) {
-    LOG_GENERAL(WARNING, "We failed to generate m_tranID.");
-    return;
-  }
-  copy(output.begin(), output.end(), m_tranID.asArray().begin());
+  SHA2<HashType::HASH_VARIANT_256>::Hash(txnData.data(), txnData.size(),
+                                         m_tranID.data());
 
   // Verify the signature
   if (!Schnorr::Verify(txnData, m_signature, m_coreInfo.senderPubKey)) {
@@ -111,11 +138,18 @@ Transaction::Transaction(const TxnHash& tranID,
     : m_tranID(tranID), m_coreInfo(coreInfo), m_signature(signature) {}
 
 bool Transaction::Serialize(bytes& dst, unsigned int offset) const {
-  if (!Messenger::SetTransaction(dst, offset, *this)) {
-    LOG_GENERAL(WARNING, "Messenger::SetTransaction failed.");
-    return false;
+  auto cached = atomic_load(&m_serialized);
+  if (!cached) {
+    bytes encoded;
+    if (!Messenger::SetTransaction(encoded, 0, *this)) {
+      LOG_GENERAL(WARNING, "Messenger::SetTransaction failed.");
+      return false;
+    }
+    cached = make_shared<const bytes>(move(encoded));
+    atomic_store(&m_serialized, cached);
   }
 
+  CopyCached(cached, dst, offset);
   return true;
 }
 
@@ -164,6 +198,7 @@ const Signature& Transaction::GetSignature() const { return m_signature; }
 
 void Transaction::SetSignature(const Signature& signature) {
   m_signature = signature;
+  atomic_store(&m_serialized, shared_ptr<const bytes>());
 }
 
 unsigned int Transaction::GetShardIndex(const Address& fromAddr,
@@ -19,6 +19,7 @@
 #define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_TRANSACTION_H_
 
 #include <array>
+#include <memory>
 
 #include <Schnorr.h>
 #include "Address.h"
@@ -64,10 +65,24 @@ class Transaction : public SerializableDataBlock {
   TransactionCoreInfo m_coreInfo;
   Signature m_signature;
 
+  // Encodings made on first use and dropped when the fields change. Copies
+  // share them, and they are only accessed through atomic_load/atomic_store
+  // as const transactions may be serialized from several threads.
+  mutable std::shared_ptr<const bytes> m_serialized;
+  mutable std::shared_ptr<const bytes> m_serializedCoreFields;
+
+  static void CopyCached(const std::shared_ptr<const bytes>& cached,
+                         bytes& dst, unsigned int offset);
+
  public:
   /// Default constructor.
   Transaction();
 
+  Transaction(const Transaction& src);
+  Transaction(Transaction&& src) = default;
+  Transaction& operator=(const Transaction& src);
+  Transaction& operator=(Transaction&& src) = default;
+
   /// Constructor with specified transaction fields.
   Transaction(const uint32_t& version, const uint64_t& nonce,
               const Address& toAddr, const PairOfKey& senderKeyPair,
@@ -22,11 +22,130 @@
 using namespace std;
 using namespace boost::multiprecision;
 
-TransactionReceipt::TransactionReceipt() {
-  update();
-  m_errorObj[to_string(m_edge)] = Json::arrayValue;
+namespace {
+
+/// Parses the decimal form of a uint64, as written by to_string
+bool StrToUint64(const string& str, uint64_t& value) {
+  try {
+    value = stoull(str);
+  } catch (const exception&) {
+    return false;
+  }
+  return to_string(value) == str;
+}
+
+bool JsonToTransitions(const Json::Value& transitions,
+                       vector<TransactionReceipt::Transition>& dst) {
+  if (!transitions.isArray()) {
+    return false;
+  }
+  for (const auto& t : transitions) {
+    if (!t.isObject() || t.size() != 3 || !t["addr"].isString() ||
+        !t["depth"].isUInt() || !t.isMember("msg")) {
+      return false;
+    }
+    const string addrStr = t["addr"].asString();
+    if (addrStr.size() != 2 + 2 * ACC_ADDR_SIZE) {
+      return false;
+    }
+    Address addr;
+    try {
+      addr = Address(addrStr);
+    } catch (const exception&) {
+      return false;
+    }
+    if ("0x" + addr.hex() != addrStr) {
+      return false;
+    }
+    dst.push_back({addr, t["msg"], t["depth"].asUInt()});
+  }
+  return true;
+}
+
+bool JsonToErrors(const Json::Value& errors,
+                  map<unsigned int, vector<unsigned int>>& dst) {
+  if (!errors.isObject()) {
+    return false;
+  }
+  for (const auto& edgeStr : errors.getMemberNames()) {
+    uint64_t edge;
+    const auto& codes = errors[edgeStr];
+    if (!StrToUint64(edgeStr, edge) || edge > UINT32_MAX ||
+        !codes.isArray() || codes.empty()) {
+      return false;
+    }
+    for (const auto& code : codes) {
+      if (!code.isUInt()) {
+        return false;
+      }
+      dst[edge].push_back(code.asUInt());
+    }
+  }
+  return true;
+}
+
+/// Splits a JSON receipt into its fields. The members that are not in the
+/// form this class writes are kept as they are in m_others.
+void JsonToData(const Json::Value& obj, TransactionReceipt::Data& data) {
+  if (!obj.isObject()) {
+    data.m_others = obj;
+    return;
+  }
+
+  data.m_others = Json::objectValue;
+  for (const auto& name : obj.getMemberNames()) {
+    const auto& value = obj[name];
+    bool known = false;
+    if (name == "success") {
+      known = value.isBool();
+      if (known) {
+        data.m_result = value.asBool()
+                            ? TransactionReceipt::Data::Result::SUCCESS
+                            : TransactionReceipt::Data::Result::FAILURE;
+      }
+    } else if (name == "cumulative_gas") {
+      uint64_t cumGas;
+      known = value.isString() && StrToUint64(value.asString(), cumGas);
+      if (known) {
+        data.m_hasCumGas = true;
+        data.m_cumGas = cumGas;
+      }
+    } else if (name == "epoch_num") {
+      uint64_t epochNum;
+      known = value.isString() && StrToUint64(value.asString(), epochNum);
+      if (known) {
+        data.m_hasEpochNum = true;
+        data.m_epochNum = epochNum;
+      }
+    } else if (name == "event_logs") {
+      known = value.isArray() && !value.empty();
+      if (known) {
+        data.m_eventLogs.assign(value.begin(), value.end());
+      }
+    } else if (name == "transitions") {
+      vector<TransactionReceipt::Transition> transitions;
+      known = !value.empty() && JsonToTransitions(value, transitions);
+      if (known) {
+        data.m_transitions = move(transitions);
+      }
+    } else if (name == "errors") {
+      map<unsigned int, vector<unsigned int>> errors;
+      known = !value.empty() && JsonToErrors(value, errors);
+      if (known) {
+        data.m_errors = move(errors);
+        data.m_edge = data.m_errors.rbegin()->first;
+      }
+    }
+    if (!known) {
+      data.m_others[name] = value;
+    }
+  }
 }
 
+}  // namespace
+
+TransactionReceipt::TransactionReceipt() { update(); }
+
 bool TransactionReceipt::Serialize(bytes& dst, unsigned int offset) const {
   if (!Messenger::SetTransactionReceipt(dst, offset, *this)) {
     LOG_GENERAL(WARNING, "Messenger::SetTransactionReceipt failed.");
@@ -42,10 +161,9 @@ bool TransactionReceipt::Deserialize(const bytes& src, unsigned int offset) {
     return false;
   }
 
-  if (!JSONUtils::GetInstance().convertStrtoJson(m_tranReceiptStr,
-                                                 m_tranReceiptObj)) {
-    LOG_GENERAL(WARNING, "Error with convert receipt string to json object");
-    return false;
+  // A binary receipt is already in the form it is hashed with
+  if (BINARY_TXN_RECEIPTS && !m_tranReceiptBytes.empty()) {
+    return true;
   }
 
   try {
@@ -59,92 +177,146 @@ bool TransactionReceipt::Deserialize(const bytes& src, unsigned int offset) {
 }
 
 void TransactionReceipt::SetResult(const bool& result) {
-  if (result) {
-    m_tranReceiptObj["success"] = true;
-  } else {
-    m_tranReceiptObj["success"] = false;
-  }
+  m_data.m_result = result ? Data::Result::SUCCESS : Data::Result::FAILURE;
 }
 
 void TransactionReceipt::AddEdge() {
   LOG_MARKER();
-  m_edge++;
-  m_errorObj[to_string(m_edge)] = Json::arrayValue;
+  m_data.m_edge++;
 }
 
 void TransactionReceipt::AddError(const unsigned int& errCode) {
   LOG_GENERAL(INFO, "AddError: " << errCode);
-  m_errorObj[to_string(m_edge)].append(errCode);
+  m_data.m_errors[m_data.m_edge].push_back(errCode);
 }
 
 void TransactionReceipt::SetCumGas(const uint64_t& cumGas) {
-  m_cumGas = cumGas;
-  m_tranReceiptObj["cumulative_gas"] = to_string(m_cumGas);
+  m_data.m_hasCumGas = true;
+  m_data.m_cumGas = cumGas;
 }
 
 void TransactionReceipt::SetEpochNum(const uint64_t& epochNum) {
-  m_tranReceiptObj["epoch_num"] = to_string(epochNum);
+  m_data.m_hasEpochNum = true;
+  m_data.m_epochNum = epochNum;
+}
+
+string TransactionReceipt::GetString() const {
+  if (!m_tranReceiptStr.empty()) {
+    return m_tranReceiptStr;
+  }
+
+  const Json::Value obj = GetJsonValue();
+  if (obj == Json::nullValue) {
+    return "{}";
+  }
+  return JSONUtils::GetInstance().convertJsontoStr(obj);
 }
 
-void TransactionReceipt::SetString(const std::string& tranReceiptStr) {
-  if (!JSONUtils::GetInstance().convertStrtoJson(tranReceiptStr,
-                                                 m_tranReceiptObj)) {
+bool TransactionReceipt::SetString(const std::string& tranReceiptStr) {
+  Json::Value obj;
+  if (!JSONUtils::GetInstance().convertStrtoJson(tranReceiptStr, obj)) {
     LOG_GENERAL(WARNING, "Error with convert receipt string to json object");
-    return;
+    return false;
   }
+
+  // The cumulative gas is kept unless the receipt has its own
+  Data data;
+  data.m_cumGas = m_data.m_cumGas;
+  JsonToData(obj, data);
+  m_data = move(data);
+  m_errorsInstalled = true;
   m_tranReceiptStr = tranReceiptStr;
+  m_tranReceiptBytes.clear();
+  if (BINARY_TXN_RECEIPTS &&
+      !Messenger::SetTransactionReceiptData(m_tranReceiptBytes, 0, m_data)) {
+    LOG_GENERAL(WARNING, "Messenger::SetTransactionReceiptData failed.");
+  }
+  return true;
+}
+
+void TransactionReceipt::SetData(const Data& data,
+                                 const bytes& tranReceiptBytes) {
+  m_data = data;
+  m_errorsInstalled = true;
+  m_tranReceiptStr.clear();
+  m_tranReceiptBytes = tranReceiptBytes;
 }
 
 void TransactionReceipt::AddEntry(const LogEntry& entry) {
-  m_tranReceiptObj["event_logs"].append(entry.GetJsonObject());
+  m_data.m_eventLogs.push_back(entry.GetJsonObject());
 }
 
 void TransactionReceipt::AddTransition(const Address& addr,
                                        const Json::Value& transition,
                                        uint32_t tree_depth) {
-  Json::Value _json;
-  _json["addr"] = "0x" + addr.hex();
-  _json["msg"] = transition;
-  _json["depth"] = tree_depth;
-  m_tranReceiptObj["transitions"].append(_json);
+  m_data.m_transitions.push_back({addr, transition, tree_depth});
 }
 
 void TransactionReceipt::RemoveAllTransitions() {
-  m_tranReceiptObj.removeMember("transitions");
+  m_data.m_transitions.clear();
+  m_data.m_others.removeMember("transitions");
 }
 
 void TransactionReceipt::CleanEntry() {
-  m_tranReceiptObj.removeMember("event_logs");
+  m_data.m_eventLogs.clear();
+  m_data.m_others.removeMember("event_logs");
 }
 
 void TransactionReceipt::clear() {
-  m_tranReceiptStr.clear();
-  m_tranReceiptObj.clear();
-  m_errorObj.clear();
-  m_edge = 0;
+  m_data = Data();
+  m_errorsInstalled = false;
   update();
 }
 
-void TransactionReceipt::InstallError() {
-  Json::Value errorObj;
-  for (const auto& e : m_errorObj.getMemberNames()) {
-    if (!m_errorObj[e].empty()) {
-      errorObj[e] = m_errorObj[e];
-    }
+void TransactionReceipt::InstallError() { m_errorsInstalled = true; }
+
+Json::Value TransactionReceipt::GetJsonValue() const {
+  Json::Value obj = m_data.m_others;
+  if (m_data.m_result != Data::Result::UNSET) {
+    obj["success"] = m_data.m_result == Data::Result::SUCCESS;
+  }
+  if (m_data.m_hasCumGas) {
+    obj["cumulative_gas"] = to_string(m_data.m_cumGas);
+  }
+  if (m_data.m_hasEpochNum) {
+    obj["epoch_num"] = to_string(m_data.m_epochNum);
+  }
+  for (const auto& entry : m_data.m_eventLogs) {
+    obj["event_logs"].append(entry);
   }
-  if (!errorObj.empty()) {
-    m_tranReceiptObj["errors"] = errorObj;
+  for (const auto& transition : m_data.m_transitions) {
+    Json::Value _json;
+    _json["addr"] = "0x" + transition.m_addr.hex();
+    _json["msg"] = transition.m_msg;
+    _json["depth"] = transition.m_depth;
+    obj["transitions"].append(_json);
   }
+  if (m_errorsInstalled) {
+    Json::Value errorObj;
+    for (const auto& e : m_data.m_errors) {
+      for (const auto& code : e.second) {
+        errorObj[to_string(e.first)].append(code);
+      }
+    }
+    if (!errorObj.empty()) {
+      obj["errors"] = errorObj;
+    }
+  }
+  return obj;
 }
 
 void TransactionReceipt::update() {
-  if (m_tranReceiptObj == Json::nullValue) {
-    m_tranReceiptStr = "{}";
+  InstallError();
+  m_tranReceiptStr.clear();
+  m_tranReceiptBytes.clear();
+  if (BINARY_TXN_RECEIPTS) {
+    if (!Messenger::SetTransactionReceiptData(m_tranReceiptBytes, 0,
+                                              m_data)) {
+      LOG_GENERAL(WARNING, "Messenger::SetTransactionReceiptData failed.");
+    }
     return;
   }
-  InstallError();
-  m_tranReceiptStr =
-      JSONUtils::GetInstance().convertJsontoStr(m_tranReceiptObj);
+  m_tranReceiptStr = GetString();
 }
 
 /// Implements the Serialize function inherited from Serializable.
@@ -20,10 +20,13 @@
 
 #include <json/json.h>
 
+#include <map>
 #include <unordered_map>
+#include <vector>
 
 #include "LogEntry.h"
 #include "Transaction.h"
+#include "common/Constants.h"
 #include "depends/common/FixedHash.h"
 #include "libCrypto/Sha2.h"
 #include "libUtils/DataConversion.h"
@@ -55,11 +58,34 @@ enum ReceiptError : unsigned int {
 };
 
 class TransactionReceipt : public SerializableDataBlock {
-  Json::Value m_tranReceiptObj = Json::nullValue;
+ public:
+  struct Transition {
+    Address m_addr;
+    Json::Value m_msg;
+    uint32_t m_depth;
+  };
+
+  /// Fields the JSON and the binary forms of a receipt are both built from
+  struct Data {
+    enum class Result : unsigned char { UNSET, FAILURE, SUCCESS };
+
+    Result m_result = Result::UNSET;
+    bool m_hasCumGas = false;
+    uint64_t m_cumGas = 0;
+    bool m_hasEpochNum = false;
+    uint64_t m_epochNum = 0;
+    unsigned int m_edge = 0;
+    std::map<unsigned int, std::vector<unsigned int>> m_errors;  // By edge
+    std::vector<Json::Value> m_eventLogs;
+    std::vector<Transition> m_transitions;
+    Json::Value m_others;  // Members of a JSON receipt not listed above
+  };
+
+ private:
+  Data m_data;
+  bool m_errorsInstalled = false;
   std::string m_tranReceiptStr;
-  uint64_t m_cumGas = 0;
-  unsigned int m_edge = 0;
-  Json::Value m_errorObj;
+  bytes m_tranReceiptBytes;
 
  public:
   TransactionReceipt();
@@ -76,11 +102,17 @@ class TransactionReceipt : public SerializableDataBlock {
                      uint32_t tree_depth);
   void RemoveAllTransitions();
   void CleanEntry();
-  const std::string& GetString() const { return m_tranReceiptStr; }
-  void SetString(const std::string& tranReceiptStr);
-  const uint64_t& GetCumGas() const { return m_cumGas; }
+  /// Returns the JSON receipt, built from the fields if it is binary
+  std::string GetString() const;
+  bool SetString(const std::string& tranReceiptStr);
+  /// Returns the binary receipt, empty unless BINARY_TXN_RECEIPTS
+  const bytes& GetBytes() const { return m_tranReceiptBytes; }
+  /// Sets the fields of a binary receipt, with their encoding
+  void SetData(const Data& data, const bytes& tranReceiptBytes);
+  const Data& GetData() const { return m_data; }
+  const uint64_t& GetCumGas() const { return m_data.m_cumGas; }
   void clear();
-  const Json::Value& GetJsonValue() const { return m_tranReceiptObj; }
+  Json::Value GetJsonValue() const;
   void update();
 };
 
@@ -117,8 +149,12 @@ class TransactionWithReceipt : public SerializableDataBlock {
 
     SHA2<HashType::HASH_VARIANT_256> sha2;
     for (const auto& tr : txrs) {
-      sha2.Update(DataConversion::StringToCharArray(
-          tr.GetTransactionReceipt().GetString()));
+      if (BINARY_TXN_RECEIPTS) {
+        sha2.Update(tr.GetTransactionReceipt().GetBytes());
+      } else {
+        sha2.Update(DataConversion::StringToCharArray(
+            tr.GetTransactionReceipt().GetString()));
+      }
     }
     return TxnHash(sha2.Finalize());
   }
@@ -18,138 +18,333 @@
 #ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_TXNPOOL_H_
 #define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_TXNPOOL_H_
 
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index_container.hpp>
 #include <functional>
-#include <map>
-#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 #include "Account.h"
 #include "Transaction.h"
 
+/// Pending transactions of a node.
+/// Each transaction is stored once and looked up through three indices:
+/// by hash, by gas price (highest first) and by sender and nonce.
+/// The pool accounts for the memory its transactions use. Once a memory limit
+/// is set and reached, the lowest gas price transactions are evicted, taking
+/// the highest nonce of their sender first so no nonce chain is broken.
 struct TxnPool {
-  struct PubKeyNonceHash {
-    std::size_t operator()(const std::pair<PubKey, uint128_t>& p) const {
-      std::size_t seed = 0;
-      boost::hash_combine(seed, std::string(p.first));
-      boost::hash_combine(seed, p.second.convert_to<std::string>());
+  struct HashTag {};
+  struct GasTag {};
+  struct NonceTag {};
 
-      return seed;
-    }
-  };
+  typedef boost::multi_index_container<
+      Transaction,
+      boost::multi_index::indexed_by<
+          boost::multi_index::hashed_unique<
+              boost::multi_index::tag<HashTag>,
+              boost::multi_index::const_mem_fun<
+                  Transaction, const TxnHash&, &Transaction::GetTranID>,
+              boost::hash<TxnHash>>,
+          // One tree node per txn, ordered by gas price and then by hash.
+          // The hash keeps the order the same on every node of the shard,
+          // which per-price FIFO buckets would not, and popping the front
+          // never rebalances a tree of price levels.
+          boost::multi_index::ordered_non_unique<
+              boost::multi_index::tag<GasTag>,
+              boost::multi_index::composite_key<
+                  Transaction,
+                  boost::multi_index::const_mem_fun<
+                      Transaction, const uint128_t&, &Transaction::GetGasPrice>,
+                  boost::multi_index::const_mem_fun<
+                      Transaction, const TxnHash&, &Transaction::GetTranID>>,
+              boost::multi_index::composite_key_compare<
+                  std::greater<uint128_t>, std::less<TxnHash>>>,
+          boost::multi_index::ordered_unique<
+              boost::multi_index::tag<NonceTag>,
+              boost::multi_index::composite_key<
+                  Transaction,
+                  boost::multi_index::const_mem_fun<
+                      Transaction, const PubKey&,
+                      &Transaction::GetSenderPubKey>,
+                  boost::multi_index::const_mem_fun<
+                      Transaction, const uint64_t&, &Transaction::GetNonce>>>>>
+      TxnContainer;
+
+  TxnContainer Txns;
+
+  /// A memoryLimit of 0 means no limit
+  explicit TxnPool(uint64_t memoryLimit = 0) : m_memoryLimit(memoryLimit) {}
+
+  /// Approximate memory used by a pooled transaction
+  static uint64_t GetMemorySize(const Transaction& t) {
+    return sizeof(Transaction) + t.GetCode().size() + t.GetData().size();
+  }
 
-  std::unordered_map<TxnHash, Transaction> HashIndex;
-  std::map<uint128_t, std::map<TxnHash, Transaction>, std::greater<uint128_t>>
-      GasIndex;
-  std::unordered_map<std::pair<PubKey, uint64_t>, Transaction, PubKeyNonceHash>
-      NonceIndex;
+  const TxnContainer::index<HashTag>::type& HashIndex() const {
+    return Txns.get<HashTag>();
+  }
 
   void clear() {
-    HashIndex.clear();
-    GasIndex.clear();
-    NonceIndex.clear();
+    Txns.clear();
+    m_sizeInBytes = 0;
   }
 
-  unsigned int size() { return HashIndex.size(); }
+  unsigned int size() const { return Txns.size(); }
+
+  uint64_t GetSizeInBytes() const { return m_sizeInBytes; }
+
+  uint64_t GetEvictedCount() const { return m_evictedCount; }
 
-  bool exist(const TxnHash& th) {
-    return HashIndex.find(th) != HashIndex.end();
+  bool exist(const TxnHash& th) const {
+    const auto& hashIdx = Txns.get<HashTag>();
+    return hashIdx.find(th) != hashIdx.end();
   }
 
-  bool get(const TxnHash& th, Transaction& t) {
-    if (!exist(th)) {
+  bool get(const TxnHash& th, Transaction& t) const {
+    const auto& hashIdx = Txns.get<HashTag>();
+    auto searchHash = hashIdx.find(th);
+    if (searchHash == hashIdx.end()) {
       return false;
     }
-    t = HashIndex.at(th);
+    t = *searchHash;
 
     return true;
   }
 
+  void erase(const TxnHash& th) {
+    auto& hashIdx = Txns.get<HashTag>();
+    auto searchHash = hashIdx.find(th);
+    if (searchHash != hashIdx.end()) {
+      m_sizeInBytes -= GetMemorySize(*searchHash);
+      hashIdx.erase(searchHash);
+    }
+  }
+
+  /// Returns false if the transaction is already in the pool, or if it was
+  /// evicted right away to stay within the memory limit
   bool insert(const Transaction& t) {
     if (exist(t.GetTranID())) {
       return false;
     }
 
-    auto searchNonce = NonceIndex.find({t.GetSenderPubKey(), t.GetNonce()});
-    if (searchNonce != NonceIndex.end()) {
-      if ((t.GetGasPrice() > searchNonce->second.GetGasPrice()) ||
-          (t.GetGasPrice() == searchNonce->second.GetGasPrice() &&
-           t.GetTranID() < searchNonce->second.GetTranID())) {
-        // erase from HashIdxTxns
-        auto searchHash = HashIndex.find(searchNonce->second.GetTranID());
-        if (searchHash != HashIndex.end()) {
-          HashIndex.erase(searchHash);
-        }
-        // erase from GasIdxTxns
-        auto searchGas = GasIndex.find(searchNonce->second.GetGasPrice());
-        if (searchGas != GasIndex.end()) {
-          auto searchGasHash =
-              searchGas->second.find(searchNonce->second.GetTranID());
-          if (searchGasHash != searchGas->second.end()) {
-            searchGas->second.erase(searchGasHash);
-          }
-        }
-        HashIndex[t.GetTranID()] = t;
-        GasIndex[t.GetGasPrice()][t.GetTranID()] = t;
-        searchNonce->second = t;
+    bool added = true;
+    auto& nonceIdx = Txns.get<NonceTag>();
+    auto searchNonce =
+        nonceIdx.find(boost::make_tuple(t.GetSenderPubKey(), t.GetNonce()));
+    if (searchNonce != nonceIdx.end()) {
+      added = false;
+      if ((t.GetGasPrice() > searchNonce->GetGasPrice()) ||
+          (t.GetGasPrice() == searchNonce->GetGasPrice() &&
+           t.GetTranID() < searchNonce->GetTranID())) {
+        m_sizeInBytes -= GetMemorySize(*searchNonce);
+        // Keys stay unique as the new hash is not in the pool yet
+        nonceIdx.replace(searchNonce, t);
+        m_sizeInBytes += GetMemorySize(t);
+        added = true;
       }
     } else {
-      HashIndex[t.GetTranID()] = t;
-      GasIndex[t.GetGasPrice()][t.GetTranID()] = t;
-      NonceIndex[{t.GetSenderPubKey(), t.GetNonce()}] = t;
+      Txns.insert(t);
+      m_sizeInBytes += GetMemorySize(t);
     }
-    return true;
+
+    if (!added) {
+      return true;
+    }
+    EvictToMemoryLimit();
+    return exist(t.GetTranID());
   }
 
   void findSameNonceButHigherGas(Transaction& t) {
-    auto searchNonce = NonceIndex.find({t.GetSenderPubKey(), t.GetNonce()});
-    if (searchNonce != NonceIndex.end()) {
-      if (searchNonce->second.GetGasPrice() > t.GetGasPrice()) {
-        t = std::move(searchNonce->second);
-
-        // erase tx nonce map
-        NonceIndex.erase(searchNonce);
-        // erase tx gas map
-        GasIndex[t.GetGasPrice()].erase(t.GetTranID());
-        if (GasIndex[t.GetGasPrice()].empty()) {
-          GasIndex.erase(t.GetGasPrice());
-        }
-        // erase tx hash map
-        HashIndex.erase(t.GetTranID());
+    auto& nonceIdx = Txns.get<NonceTag>();
+    auto searchNonce =
+        nonceIdx.find(boost::make_tuple(t.GetSenderPubKey(), t.GetNonce()));
+    if (searchNonce != nonceIdx.end()) {
+      if (searchNonce->GetGasPrice() > t.GetGasPrice()) {
+        t = *searchNonce;
+        m_sizeInBytes -= GetMemorySize(t);
+        nonceIdx.erase(searchNonce);
       }
     }
   }
 
   bool findOne(Transaction& t) {
-    if (GasIndex.empty()) {
+    auto& gasIdx = Txns.get<GasTag>();
+    if (gasIdx.empty()) {
       return false;
     }
 
-    auto firstGas = GasIndex.begin();
-    auto firstHash = firstGas->second.begin();
+    auto firstGas = gasIdx.begin();
+    t = *firstGas;
+    m_sizeInBytes -= GetMemorySize(t);
+    gasIdx.erase(firstGas);
+    return true;
+  }
+
+ private:
+  void EvictToMemoryLimit() {
+    if (m_memoryLimit == 0) {
+      return;
+    }
+
+    auto& gasIdx = Txns.get<GasTag>();
+    auto& nonceIdx = Txns.get<NonceTag>();
+    while (m_sizeInBytes > m_memoryLimit && !gasIdx.empty()) {
+      // Later nonces of the sender cannot be processed without this one
+      const PubKey& sender = std::prev(gasIdx.end())->GetSenderPubKey();
+      auto lastNonce =
+          std::prev(nonceIdx.upper_bound(boost::make_tuple(sender)));
+      m_sizeInBytes -= GetMemorySize(*lastNonce);
+      nonceIdx.erase(lastNonce);
+      m_evictedCount++;
+    }
+  }
+
+  uint64_t m_memoryLimit;
+  uint64_t m_sizeInBytes{0};
+  uint64_t m_evictedCount{0};
+};
+
+/// Round-local view of a TxnPool.
+/// Transactions taken out of the view are only recorded and the base pool is
+/// left untouched, so a round starts without copying the pool and can be
+/// rerun from the same base. ApplyTo() then removes the taken transactions
+/// from the pool and adds the ones inserted into the view.
+class TxnPoolView {
+ public:
+  /// The base pool must not be modified while the view is read
+  void Reset(const TxnPool& base) {
+    m_base = &base;
+    m_gasCursor = base.Txns.get<TxnPool::GasTag>().begin();
+    m_taken.clear();
+    m_added.clear();
+  }
+
+  void clear() {
+    m_base = nullptr;
+    m_taken.clear();
+    m_added.clear();
+  }
 
-    if (firstHash != firstGas->second.end()) {
-      t = std::move(firstHash->second);
+  bool insert(const Transaction& t) {
+    if (m_added.exist(t.GetTranID()) || FindInBase(t.GetTranID())) {
+      return false;
+    }
 
-      // erase tx gas map
-      firstGas->second.erase(firstHash);
-      if (firstGas->second.empty()) {
-        GasIndex.erase(firstGas);
+    const Transaction* searchNonce =
+        FindNonceInBase(t.GetSenderPubKey(), t.GetNonce());
+    if (searchNonce != nullptr) {
+      if (IsPreferred(t, *searchNonce)) {
+        m_taken.insert(searchNonce->GetTranID());
+        m_added.insert(t);
       }
-      // erase tx nonce map
-      NonceIndex.erase({t.GetSenderPubKey(), t.GetNonce()});
-      // erase tx hash m ap
-      HashIndex.erase(t.GetTranID());
       return true;
     }
-    return false;
+    return m_added.insert(t);
   }
+
+  void findSameNonceButHigherGas(Transaction& t) {
+    const Transaction* searchNonce =
+        FindNonceInBase(t.GetSenderPubKey(), t.GetNonce());
+    if (searchNonce == nullptr) {
+      m_added.findSameNonceButHigherGas(t);
+      return;
+    }
+    if (searchNonce->GetGasPrice() > t.GetGasPrice()) {
+      t = *searchNonce;
+      m_taken.insert(t.GetTranID());
+    }
+  }
+
+  bool findOne(Transaction& t) {
+    const Transaction* fromBase = nullptr;
+    if (m_base != nullptr) {
+      const auto& gasIdx = m_base->Txns.get<TxnPool::GasTag>();
+      while (m_gasCursor != gasIdx.end() &&
+             m_taken.find(m_gasCursor->GetTranID()) != m_taken.end()) {
+        ++m_gasCursor;
+      }
+      if (m_gasCursor != gasIdx.end()) {
+        fromBase = &*m_gasCursor;
+      }
+    }
+
+    const auto& addedGasIdx = m_added.Txns.get<TxnPool::GasTag>();
+    if (!addedGasIdx.empty() &&
+        (fromBase == nullptr || IsHigherGas(*addedGasIdx.begin(), *fromBase))) {
+      return m_added.findOne(t);
+    }
+    if (fromBase == nullptr) {
+      return false;
+    }
+
+    t = *fromBase;
+    m_taken.insert(t.GetTranID());
+    ++m_gasCursor;
+    return true;
+  }
+
+  /// Brings the pool in line with the view and clears the view
+  void ApplyTo(TxnPool& pool) {
+    for (const auto& th : m_taken) {
+      pool.erase(th);
+    }
+    for (const auto& t : m_added.HashIndex()) {
+      pool.insert(t);
+    }
+    clear();
+  }
+
+ private:
+  // Same rules as TxnPool::insert for a transaction with the same nonce
+  static bool IsPreferred(const Transaction& t, const Transaction& current) {
+    return (t.GetGasPrice() > current.GetGasPrice()) ||
+           (t.GetGasPrice() == current.GetGasPrice() &&
+            t.GetTranID() < current.GetTranID());
+  }
+
+  // Same order as the gas index of TxnPool
+  static bool IsHigherGas(const Transaction& a, const Transaction& b) {
+    return (a.GetGasPrice() > b.GetGasPrice()) ||
+           (a.GetGasPrice() == b.GetGasPrice() &&
+            a.GetTranID() < b.GetTranID());
+  }
+
+  bool FindInBase(const TxnHash& th) const {
+    return m_base != nullptr && m_base->exist(th) &&
+           m_taken.find(th) == m_taken.end();
+  }
+
+  const Transaction* FindNonceInBase(const PubKey& pubKey,
+                                     const uint64_t& nonce) const {
+    if (m_base == nullptr) {
+      return nullptr;
+    }
+    const auto& nonceIdx = m_base->Txns.get<TxnPool::NonceTag>();
+    auto searchNonce = nonceIdx.find(boost::make_tuple(pubKey, nonce));
+    if (searchNonce == nonceIdx.end() ||
+        m_taken.find(searchNonce->GetTranID()) != m_taken.end()) {
+      return nullptr;
+    }
+    return &*searchNonce;
+  }
+
+  const TxnPool* m_base{nullptr};
+  TxnPool::TxnContainer::index<TxnPool::GasTag>::type::const_iterator
+      m_gasCursor;
+  std::unordered_set<TxnHash> m_taken;
+  TxnPool m_added;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const TxnPool& t) {
   os << "Txn in txnPool: " << std::endl;
-  for (const auto& entry : t.HashIndex) {
-    os << "TranID: " << entry.first.hex() << " Sender:"
-       << Account::GetAddressFromPublicKey(entry.second.GetSenderPubKey())
-       << " Nonce: " << entry.second.GetNonce() << std::endl;
+  for (const auto& entry : t.HashIndex()) {
+    os << "TranID: " << entry.GetTranID().hex() << " Sender:"
+       << Account::GetAddressFromPublicKey(entry.GetSenderPubKey())
+       << " Nonce: " << entry.GetNonce() << std::endl;
   }
   return os;
 }
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TxnSpeculation.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+Account* TxnSpeculation::Store::GetAccount(const Address& address) {
+  Account* account =
+      AccountStoreSC<map<Address, Account>>::GetAccount(address);
+  if (account != nullptr) {
+    return account;
+  }
+
+  // Pulled in on first use, as AccountStoreTemp does from its parent
+  const auto& seed = m_speculation.GetSeed(address);
+  if (!seed) {
+    return nullptr;
+  }
+  return &m_addressToAccount->emplace(address, *seed).first->second;
+}
+
+void TxnSpeculation::Reset(const uint64_t& epochNum) {
+  m_epochNum = epochNum;
+  m_seeds.clear();
+  m_store.Clear();
+  m_outcomes.clear();
+}
+
+const boost::optional<Account>& TxnSpeculation::GetSeed(
+    const Address& address) {
+  auto it = m_seeds.find(address);
+  if (it == m_seeds.end()) {
+    boost::optional<Account> seed;
+    Account account;
+    if (AccountStore::GetInstance().PeekAccountTemp(address, account)) {
+      seed = std::move(account);
+    }
+    it = m_seeds.emplace(address, std::move(seed)).first;
+  }
+  return it->second;
+}
+
+uint128_t TxnSpeculation::GetNonce(const Address& address) {
+  const auto& accounts = m_store.GetAccounts();
+  auto it = accounts.find(address);
+  if (it != accounts.end()) {
+    return it->second.GetNonce();
+  }
+  const auto& seed = GetSeed(address);
+  return seed ? seed->GetNonce() : 0;
+}
+
+bool TxnSpeculation::Speculate(const unsigned int& numShards,
+                               const Transaction& transaction) {
+  if (Transaction::GetTransactionType(transaction) !=
+      Transaction::NON_CONTRACT) {
+    return false;
+  }
+
+  const Address fromAddr =
+      Account::GetAddressFromPublicKey(transaction.GetSenderPubKey());
+  const Address& toAddr = transaction.GetToAddr();
+  const auto& from = GetSeed(fromAddr);
+  const auto& to = GetSeed(toAddr);
+  if ((from && from->isContract()) || (to && to->isContract())) {
+    return false;
+  }
+
+  Outcome outcome{transaction.GetTranID(), false, {}, {}};
+
+  // Same checks as Validator::PreCheckCreatedTransaction, which reads the
+  // sender as committed before the round, i.e., as the seed has it
+  if ((DataConversion::UnpackA(transaction.GetVersion()) == CHAIN_ID) &&
+      !IsNullAddress(fromAddr) && from &&
+      (from->GetBalance() >= transaction.GetAmount())) {
+    outcome.m_receipt.SetEpochNum(m_epochNum);
+    outcome.m_result = m_store.UpdateAccounts(m_epochNum, numShards, false,
+                                              transaction, outcome.m_receipt);
+
+    // What AccountStoreTemp has of them once the transaction is executed
+    const auto& accounts = m_store.GetAccounts();
+    for (const auto& addr : {fromAddr, toAddr}) {
+      auto it = accounts.find(addr);
+      if (it != accounts.end()) {
+        outcome.m_accounts.emplace(*it);
+      }
+    }
+  }
+
+  m_outcomes.emplace_back(move(outcome));
+  return true;
+}
+
+bool TxnSpeculation::Validate(const uint64_t& epochNum) {
+  if (m_outcomes.empty()) {
+    return false;
+  }
+
+  if (epochNum != m_epochNum) {
+    LOG_GENERAL(INFO, "Speculated for epoch " << m_epochNum << ", discarding "
+                                              << m_outcomes.size() << " txns");
+    Reset(epochNum);
+    return false;
+  }
+
+  for (const auto& entry : m_seeds) {
+    const auto& seed = entry.second;
+    Account account;
+    const bool found =
+        AccountStore::GetInstance().PeekAccountTemp(entry.first, account);
+    if ((found != static_cast<bool>(seed)) ||
+        (found && (account.isContract() ||
+                   (account.GetBalance() != seed->GetBalance()) ||
+                   (account.GetNonce() != seed->GetNonce())))) {
+      LOG_GENERAL(INFO, "Account " << entry.first
+                                   << " changed by the final block, discarding "
+                                   << m_outcomes.size() << " txns");
+      Reset(epochNum);
+      return false;
+    }
+  }
+
+  LOG_GENERAL(INFO, "Speculated txns kept: " << m_outcomes.size());
+  return true;
+}
+
+bool TxnSpeculation::TakeNext(const Transaction& transaction, bool& result,
+                              TransactionReceipt& receipt) {
+  if (m_outcomes.empty()) {
+    return false;
+  }
+
+  Outcome& outcome = m_outcomes.front();
+  if (outcome.m_tranID != transaction.GetTranID()) {
+    LOG_GENERAL(INFO, "Txn " << transaction.GetTranID()
+                             << " not speculated, discarding "
+                             << m_outcomes.size() << " txns");
+    Reset(m_epochNum);
+    return false;
+  }
+
+  AccountStore::GetInstance().AddAccountsTemp(outcome.m_accounts);
+  result = outcome.m_result;
+  receipt = move(outcome.m_receipt);
+  m_outcomes.pop_front();
+  return true;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_TXNSPECULATION_H_
+#define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_TXNSPECULATION_H_
+
+#include <deque>
+#include <map>
+
+#include <boost/optional.hpp>
+
+#include "AccountStore.h"
+
+/// Payments of the next round, executed ahead of it against the accounts as
+/// AccountStoreTemp has them now, i.e., as they are expected to be committed.
+/// The accounts are pulled into a store of their own, so AccountStoreTemp is
+/// left as it is. Once the round starts, the outcome of a transaction is used
+/// in place of executing it again if the accounts it started from are
+/// unchanged and the transactions before it were the ones speculated.
+class TxnSpeculation {
+ public:
+  /// Forgets everything speculated, to start over for epochNum
+  void Reset(const uint64_t& epochNum);
+
+  uint64_t GetEpochNum() const { return m_epochNum; }
+
+  unsigned int GetNumSpeculated() const { return m_outcomes.size(); }
+
+  /// Nonce of the sender as of the transactions speculated so far
+  uint128_t GetNonce(const Address& address);
+
+  /// Executes the transaction after the ones speculated so far. Returns false,
+  /// leaving it out, if it is not a payment between accounts that are not
+  /// contracts.
+  bool Speculate(const unsigned int& numShards, const Transaction& transaction);
+
+  /// Checks that AccountStoreTemp has all the accounts the speculation started
+  /// from as they were, and forgets everything otherwise
+  bool Validate(const uint64_t& epochNum);
+
+  /// If the transaction is the next one speculated, puts the accounts it left
+  /// in AccountStoreTemp and returns its outcome. Otherwise forgets the rest.
+  bool TakeNext(const Transaction& transaction, bool& result,
+                TransactionReceipt& receipt);
+
+ private:
+  /// Accounts of the transactions speculated, pulled from the seeds
+  class Store : public AccountStoreSC<std::map<Address, Account>> {
+    TxnSpeculation& m_speculation;
+
+   public:
+    explicit Store(TxnSpeculation& speculation) : m_speculation(speculation) {}
+
+    using AccountStoreSC<std::map<Address, Account>>::UpdateAccounts;
+
+    Account* GetAccount(const Address& address) override;
+
+    const std::map<Address, Account>& GetAccounts() const {
+      return *m_addressToAccount;
+    }
+
+    void Clear() { m_addressToAccount->clear(); }
+  };
+
+  struct Outcome {
+    TxnHash m_tranID;
+    bool m_result;
+    TransactionReceipt m_receipt;
+    std::map<Address, Account> m_accounts;
+  };
+
+  /// The account as the speculation started from it, if there was one
+  const boost::optional<Account>& GetSeed(const Address& address);
+
+  uint64_t m_epochNum{0};
+  std::map<Address, boost::optional<Account>> m_seeds;
+  Store m_store{*this};
+  std::deque<Outcome> m_outcomes;
+};
+
+#endif  // ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_TXNSPECULATION_H_
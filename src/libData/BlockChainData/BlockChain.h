@@ -18,7 +18,8 @@
 #ifndef ZILLIQA_SRC_LIBDATA_BLOCKCHAINDATA_BLOCKCHAIN_H_
 #define ZILLIQA_SRC_LIBDATA_BLOCKCHAINDATA_BLOCKCHAIN_H_
 
-#include <mutex>
+#include <memory>
+#include <shared_mutex>
 
 #include "libData/BlockData/Block/DSBlock.h"
 #include "libData/DataStructures/CircularArray.h"
@@ -26,78 +27,128 @@
 
 /// Transient storage for DS/Tx/ Blocks. The block should have function
 /// .GetHeader().GetBlockNum()
+///
+/// The last BLOCKCHAIN_SIZE blocks are kept in a ring, and the blocks it
+/// drops go to a second ring of olderBlocksSize blocks. Blocks further back
+/// are read from persistent storage. Blocks are shared with the readers and
+/// never modified, so a reader only holds the lock to take a pointer.
 template <class T>
 class BlockChain {
-  std::mutex m_mutexBlocks;
-  CircularArray<T> m_blocks;
+ public:
+  using BlockPtr = std::shared_ptr<const T>;
+
+ private:
+  const size_t m_olderBlocksSize;
+  std::shared_timed_mutex m_mutexBlocks;
+  CircularArray<BlockPtr> m_blocks;
+  CircularArray<BlockPtr> m_olderBlocks;
+
+  static const BlockPtr& GetDummyBlock() {
+    static const BlockPtr dummyBlock = std::make_shared<const T>();
+    return dummyBlock;
+  }
+
+  static uint64_t GetBlockNum(const BlockPtr& block) {
+    return block ? block->GetHeader().GetBlockNum() : INIT_BLOCK_NUMBER;
+  }
 
  protected:
   /// Constructor.
-  BlockChain() { Reset(); }
+  explicit BlockChain(size_t olderBlocksSize = 0)
+      : m_olderBlocksSize(olderBlocksSize) {
+    Reset();
+  }
 
   ~BlockChain() {}
 
-  virtual T GetBlockFromPersistentStorage(const uint64_t& blockNum) = 0;
+  /// Returns nullptr if the block is not in persistent storage
+  virtual BlockPtr GetBlockFromPersistentStorage(const uint64_t& blockNum) = 0;
 
  public:
   /// Reset
-  void Reset() { m_blocks.resize(BLOCKCHAIN_SIZE); }
+  void Reset() {
+    std::unique_lock<std::shared_timed_mutex> g(m_mutexBlocks);
+    m_blocks.resize(BLOCKCHAIN_SIZE);
+    m_olderBlocks.resize(m_olderBlocksSize);
+  }
 
   /// Returns the number of blocks.
   uint64_t GetBlockCount() {
-    std::lock_guard<std::mutex> g(m_mutexBlocks);
+    std::shared_lock<std::shared_timed_mutex> g(m_mutexBlocks);
     return m_blocks.size();
   }
 
   /// Returns the last stored block.
-  const T& GetLastBlock() {
-    std::lock_guard<std::mutex> g(m_mutexBlocks);
+  BlockPtr GetLastBlockPtr() {
+    std::shared_lock<std::shared_timed_mutex> g(m_mutexBlocks);
     try {
-      return m_blocks.back();
+      const BlockPtr& block = m_blocks.back();
+      return block ? block : GetDummyBlock();
     } catch (...) {
-      static T defaultBlock;
-      return defaultBlock;
+      return GetDummyBlock();
     }
   }
 
-  /// Returns the block at the specified block number.
-  T GetBlock(const uint64_t& blockNum) {
-    std::lock_guard<std::mutex> g(m_mutexBlocks);
-
-    if (m_blocks.size() > 0 &&
-        (m_blocks.back().GetHeader().GetBlockNum() < blockNum)) {
-      LOG_GENERAL(WARNING,
-                  "BlockNum too high " << blockNum << " Dummy block used");
-      return T();
-    } else if (blockNum + m_blocks.capacity() < m_blocks.size()) {
-      return GetBlockFromPersistentStorage(blockNum);
-    }
+  /// Returns the last stored block. It stays valid until BLOCKCHAIN_SIZE
+  /// blocks and the older blocks kept have been added after it.
+  const T& GetLastBlock() { return *GetLastBlockPtr(); }
+
+  /// Returns the block at the specified block number, or a dummy block if
+  /// there is none.
+  BlockPtr GetBlockPtr(const uint64_t& blockNum) {
+    {
+      std::shared_lock<std::shared_timed_mutex> g(m_mutexBlocks);
+
+      if (m_blocks.size() > 0 && GetBlockNum(m_blocks.back()) < blockNum) {
+        LOG_GENERAL(WARNING,
+                    "BlockNum too high " << blockNum << " Dummy block used");
+        return GetDummyBlock();
+      }
+
+      if (blockNum + m_blocks.capacity() >= m_blocks.size()) {
+        const BlockPtr& block = m_blocks[blockNum];
+        if (GetBlockNum(block) != blockNum) {
+          LOG_GENERAL(WARNING,
+                      "BlockNum : " << blockNum << " != GetBlockNum() : "
+                                    << GetBlockNum(block)
+                                    << ", a dummy block will be used and "
+                                       "abnormal behavior may happen!");
+          return GetDummyBlock();
+        }
+        return block;
+      }
 
-    if (m_blocks[blockNum].GetHeader().GetBlockNum() != blockNum) {
-      LOG_GENERAL(WARNING,
-                  "BlockNum : " << blockNum << " != GetBlockNum() : "
-                                << m_blocks[blockNum].GetHeader().GetBlockNum()
-                                << ", a dummy block will be used and abnormal "
-                                   "behavior may happen!");
-      return T();
+      if (m_olderBlocks.capacity() > 0) {
+        const BlockPtr& block = m_olderBlocks[blockNum];
+        if (GetBlockNum(block) == blockNum) {
+          return block;
+        }
+      }
     }
-    return m_blocks[blockNum];
+
+    const BlockPtr block = GetBlockFromPersistentStorage(blockNum);
+    return block ? block : GetDummyBlock();
   }
 
+  /// Returns a copy of the block at the specified block number. Prefer
+  /// GetBlockPtr, which does not copy the block.
+  T GetBlock(const uint64_t& blockNum) { return *GetBlockPtr(blockNum); }
+
   /// Adds a block to the chain.
   int AddBlock(const T& block) {
     uint64_t blockNumOfNewBlock = block.GetHeader().GetBlockNum();
+    // Copied before taking the lock
+    BlockPtr newBlock = std::make_shared<const T>(block);
 
-    std::lock_guard<std::mutex> g(m_mutexBlocks);
+    std::unique_lock<std::shared_timed_mutex> g(m_mutexBlocks);
 
-    uint64_t blockNumOfExistingBlock =
-        m_blocks[blockNumOfNewBlock].GetHeader().GetBlockNum();
+    BlockPtr& existingBlock = m_blocks[blockNumOfNewBlock];
+    uint64_t blockNumOfExistingBlock = GetBlockNum(existingBlock);
 
     if (blockNumOfExistingBlock < blockNumOfNewBlock ||
         INIT_BLOCK_NUMBER == blockNumOfExistingBlock) {
       if (m_blocks.size() > 0) {
-        uint64_t blockNumOfLastBlock =
-            m_blocks.back().GetHeader().GetBlockNum();
+        uint64_t blockNumOfLastBlock = GetBlockNum(m_blocks.back());
         uint64_t blockNumMissed = blockNumOfNewBlock - blockNumOfLastBlock - 1;
         if (blockNumMissed > 0) {
           LOG_GENERAL(INFO,
@@ -107,7 +158,11 @@ class BlockChain {
           m_blocks.increase_size(blockNumMissed);
         }
       }
-      m_blocks.insert_new(blockNumOfNewBlock, block);
+      if (existingBlock && m_olderBlocks.capacity() > 0 &&
+          INIT_BLOCK_NUMBER != blockNumOfExistingBlock) {
+        m_olderBlocks.insert_new(blockNumOfExistingBlock, existingBlock);
+      }
+      m_blocks.insert_new(blockNumOfNewBlock, newBlock);
     } else {
       LOG_GENERAL(WARNING, "Failed to add " << blockNumOfNewBlock << " "
                                             << blockNumOfExistingBlock);
@@ -120,33 +175,37 @@ class BlockChain {
 
 class DSBlockChain : public BlockChain<DSBlock> {
  public:
-  DSBlock GetBlockFromPersistentStorage(const uint64_t& blockNum) override {
+  DSBlockChain() : BlockChain(BLOCKCHAIN_OLDER_BLOCKS_SIZE) {}
+
+  BlockPtr GetBlockFromPersistentStorage(const uint64_t& blockNum) override {
     DSBlockSharedPtr block;
     if (!BlockStorage::GetBlockStorage().GetDSBlock(blockNum, block)) {
       LOG_GENERAL(WARNING, "BlockNum not in persistent storage "
                                << blockNum << " Dummy block used");
-      return DSBlock();
+      return nullptr;
     }
-    return *block;
+    return block;
   }
 };
 
 class TxBlockChain : public BlockChain<TxBlock> {
  public:
-  TxBlock GetBlockFromPersistentStorage(const uint64_t& blockNum) override {
+  TxBlockChain() : BlockChain(BLOCKCHAIN_OLDER_BLOCKS_SIZE) {}
+
+  BlockPtr GetBlockFromPersistentStorage(const uint64_t& blockNum) override {
     TxBlockSharedPtr block;
     if (!BlockStorage::GetBlockStorage().GetTxBlock(blockNum, block)) {
       LOG_GENERAL(WARNING, "BlockNum not in persistent storage "
                                << blockNum << " Dummy block used");
-      return TxBlock();
+      return nullptr;
     }
-    return *block;
+    return block;
   }
 };
 
 class VCBlockChain : public BlockChain<VCBlock> {
  public:
-  VCBlock GetBlockFromPersistentStorage([
+  BlockPtr GetBlockFromPersistentStorage([
       [gnu::unused]] const uint64_t& blockNum) override {
     throw "vc block persistent storage not supported";
   }
@@ -154,7 +213,7 @@ class VCBlockChain : public BlockChain<VCBlock> {
 
 class FallbackBlockChain : public BlockChain<FallbackBlock> {
  public:
-  FallbackBlock GetBlockFromPersistentStorage([
+  BlockPtr GetBlockFromPersistentStorage([
       [gnu::unused]] const uint64_t& blockNum) override {
     throw "fallback block persistent storage not supported";
   }
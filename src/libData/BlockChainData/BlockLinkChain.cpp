@@ -15,6 +15,8 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include "BlockLinkChain.h"
 #include "libMessage/Messenger.h"
 #include "libPersistence/BlockStorage.h"
@@ -31,46 +33,123 @@ BlockLink BlockLinkChain::GetFromPersistentStorage(const uint64_t& index) {
   return *blnkshared;
 }
 
-void BlockLinkChain::Reset() { m_blockLinkChain.resize(BLOCKCHAIN_SIZE); }
+void BlockLinkChain::Reset() {
+  std::unique_lock<std::shared_timed_mutex> g(m_mutexBlockLinkChain);
+  m_blockLinks.clear();
+  m_linksOfDSIndex.clear();
+  m_linksOfType.clear();
+}
 
 BlockLinkChain::BlockLinkChain() { Reset(); }
 
 BlockLink BlockLinkChain::GetBlockLink(const uint64_t& index) {
-  std::lock_guard<std::mutex> g(m_mutexBlockLinkChain);
-  if (m_blockLinkChain.size() <= index) {
+  std::shared_lock<std::shared_timed_mutex> g(m_mutexBlockLinkChain);
+  if (m_blockLinks.size() <= index) {
     LOG_GENERAL(WARNING,
                 "Unable to find blocklink, returning dummy link " << index);
     return BlockLink();
-  } else if (index + m_blockLinkChain.capacity() < m_blockLinkChain.size()) {
+  }
+  const BlockLink& link = m_blockLinks[index];
+  if (std::get<BlockLinkIndex::INDEX>(link) != index) {
+    // Skipped when it was added
     return GetFromPersistentStorage(index);
   }
-  if (std::get<BlockLinkIndex::INDEX>(m_blockLinkChain[index]) != index) {
-    LOG_GENERAL(WARNING, "Does not match the given index");
-    return BlockLink();
+  return link;
+}
+
+std::vector<BlockLink> BlockLinkChain::GetBlockLinks(uint64_t fromIndex,
+                                                     uint64_t toIndex) {
+  std::vector<BlockLink> links;
+  std::shared_lock<std::shared_timed_mutex> g(m_mutexBlockLinkChain);
+  if (fromIndex > toIndex || fromIndex >= m_blockLinks.size()) {
+    return links;
+  }
+  toIndex = std::min<uint64_t>(toIndex, m_blockLinks.size() - 1);
+  links.reserve(toIndex - fromIndex + 1);
+  for (uint64_t i = fromIndex; i <= toIndex; i++) {
+    const BlockLink& link = m_blockLinks[i];
+    links.emplace_back(std::get<BlockLinkIndex::INDEX>(link) == i
+                           ? link
+                           : GetFromPersistentStorage(i));
+  }
+  return links;
+}
+
+std::vector<BlockLink> BlockLinkChain::GetBlockLinksOfDSIndex(
+    uint64_t dsIndex) {
+  std::vector<BlockLink> links;
+  std::shared_lock<std::shared_timed_mutex> g(m_mutexBlockLinkChain);
+  const auto it = m_linksOfDSIndex.find(dsIndex);
+  if (it == m_linksOfDSIndex.end()) {
+    return links;
+  }
+  for (uint64_t i = it->second.first; i <= it->second.second; i++) {
+    const BlockLink& link = m_blockLinks[i];
+    if (std::get<BlockLinkIndex::INDEX>(link) == i &&
+        std::get<BlockLinkIndex::DSINDEX>(link) == dsIndex) {
+      links.emplace_back(link);
+    }
+  }
+  return links;
+}
+
+bool BlockLinkChain::GetLinkRangeOfDSIndex(uint64_t dsIndex,
+                                           uint64_t& firstIndex,
+                                           uint64_t& lastIndex) {
+  std::shared_lock<std::shared_timed_mutex> g(m_mutexBlockLinkChain);
+  const auto it = m_linksOfDSIndex.find(dsIndex);
+  if (it == m_linksOfDSIndex.end()) {
+    return false;
   }
-  return m_blockLinkChain[index];
+  firstIndex = it->second.first;
+  lastIndex = it->second.second;
+  return true;
+}
+
+std::vector<uint64_t> BlockLinkChain::GetLinkIndexesOfType(BlockType blocktype,
+                                                           uint64_t fromIndex) {
+  std::shared_lock<std::shared_timed_mutex> g(m_mutexBlockLinkChain);
+  const auto it = m_linksOfType.find(blocktype);
+  if (it == m_linksOfType.end()) {
+    return {};
+  }
+  return std::vector<uint64_t>(
+      std::lower_bound(it->second.begin(), it->second.end(), fromIndex),
+      it->second.end());
 }
 
 bool BlockLinkChain::AddBlockLink(const uint64_t& index,
                                   const uint64_t& dsindex,
                                   const BlockType blocktype,
                                   const BlockHash& blockhash) {
-  uint64_t latestIndex = GetLatestIndex();
-
-  std::lock_guard<std::mutex> g(m_mutexBlockLinkChain);
-
-  if ((m_blockLinkChain.size() > 0) && (index <= latestIndex)) {
-    LOG_GENERAL(WARNING, "Latest index in blocklink "
-                             << latestIndex << " is greater than " << index);
-    return false;
-  } else if (m_blockLinkChain.size() == 0 && index > 0) {
-    LOG_GENERAL(WARNING,
-                "First index to be inserted should be 0 not " << index);
-    return false;
+  {
+    std::unique_lock<std::shared_timed_mutex> g(m_mutexBlockLinkChain);
+
+    if (!m_blockLinks.empty()) {
+      const uint64_t latestIndex =
+          std::get<BlockLinkIndex::INDEX>(m_blockLinks.back());
+      if (index <= latestIndex) {
+        LOG_GENERAL(WARNING, "Latest index in blocklink "
+                                 << latestIndex << " is greater than "
+                                 << index);
+        return false;
+      }
+    } else if (index > 0) {
+      LOG_GENERAL(WARNING,
+                  "First index to be inserted should be 0 not " << index);
+      return false;
+    }
+
+    // Positions of skipped indexes hold dummy links
+    m_blockLinks.resize(index);
+    m_blockLinks.emplace_back(BLOCKLINK_VERSION, index, dsindex, blocktype,
+                              blockhash);
+
+    auto range =
+        m_linksOfDSIndex.emplace(dsindex, std::make_pair(index, index));
+    range.first->second.second = index;
+    m_linksOfType[blocktype].push_back(index);
   }
-  m_blockLinkChain.insert_new(
-      index,
-      std::make_tuple(BLOCKLINK_VERSION, index, dsindex, blocktype, blockhash));
 
   bytes dst;
 
@@ -94,11 +173,11 @@ bool BlockLinkChain::AddBlockLink(const uint64_t& index,
 }
 
 uint64_t BlockLinkChain::GetLatestIndex() {
-  std::lock_guard<std::mutex> g(m_mutexBlockLinkChain);
-  if (m_blockLinkChain.size() == 0) {
+  std::shared_lock<std::shared_timed_mutex> g(m_mutexBlockLinkChain);
+  if (m_blockLinks.empty()) {
     return 0;
   }
-  return std::get<BlockLinkIndex::INDEX>(m_blockLinkChain.back());
+  return std::get<BlockLinkIndex::INDEX>(m_blockLinks.back());
 }
 
 const DequeOfNode& BlockLinkChain::GetBuiltDSComm() {
@@ -110,7 +189,11 @@ void BlockLinkChain::SetBuiltDSComm(const DequeOfNode& dsComm) {
 }
 
 const BlockLink& BlockLinkChain::GetLatestBlockLink() {
-  std::lock_guard<std::mutex> g(m_mutexBlockLinkChain);
-
-  return m_blockLinkChain.back();
+  std::shared_lock<std::shared_timed_mutex> g(m_mutexBlockLinkChain);
+  if (m_blockLinks.empty()) {
+    static const BlockLink dummyLink;
+    return dummyLink;
+  }
+  // Links are only added at the back, which leaves this one in place
+  return m_blockLinks.back();
 }
@@ -18,8 +18,12 @@
 #ifndef ZILLIQA_SRC_LIBDATA_BLOCKCHAINDATA_BLOCKLINKCHAIN_H_
 #define ZILLIQA_SRC_LIBDATA_BLOCKCHAINDATA_BLOCKLINKCHAIN_H_
 
+#include <deque>
+#include <map>
+#include <shared_mutex>
+#include <vector>
+
 #include "libData/BlockData/Block.h"
-#include "libData/DataStructures/CircularArray.h"
 
 typedef std::tuple<uint32_t, uint64_t, uint64_t, BlockType, BlockHash>
     BlockLink;
@@ -33,9 +37,17 @@ enum BlockLinkIndex : unsigned char {
   BLOCKHASH = 4,
 };
 
+/// Every link since index 0 is kept in memory, which takes about 64 bytes a
+/// link, along with the links of each DS index and of each block type, so
+/// that range queries seek instead of walking the chain.
 class BlockLinkChain {
-  CircularArray<BlockLink> m_blockLinkChain;
-  std::mutex m_mutexBlockLinkChain;
+  std::shared_timed_mutex m_mutexBlockLinkChain;
+  // The position of a link is its index
+  std::deque<BlockLink> m_blockLinks;
+  // DS index -> indexes of its first and last links
+  std::map<uint64_t, std::pair<uint64_t, uint64_t>> m_linksOfDSIndex;
+  // Indexes of the links of each block type, in increasing order
+  std::map<BlockType, std::vector<uint64_t>> m_linksOfType;
   DequeOfNode m_builtDsCommittee;
 
  public:
@@ -46,6 +58,22 @@ class BlockLinkChain {
 
   BlockLink GetBlockLink(const uint64_t& index);
 
+  /// Returns the links from fromIndex to toIndex, both included, as far as
+  /// the chain goes
+  std::vector<BlockLink> GetBlockLinks(uint64_t fromIndex, uint64_t toIndex);
+
+  /// Returns the links of the DS index, in order
+  std::vector<BlockLink> GetBlockLinksOfDSIndex(uint64_t dsIndex);
+
+  /// Sets the indexes of the first and last links of the DS index, or returns
+  /// false if it has none
+  bool GetLinkRangeOfDSIndex(uint64_t dsIndex, uint64_t& firstIndex,
+                             uint64_t& lastIndex);
+
+  /// Returns the indexes of the links of the block type from fromIndex on
+  std::vector<uint64_t> GetLinkIndexesOfType(BlockType blocktype,
+                                             uint64_t fromIndex = 0);
+
   bool AddBlockLink(const uint64_t& index, const uint64_t& dsindex,
                     const BlockType blocktype, const BlockHash& blockhash);
   uint64_t GetLatestIndex();
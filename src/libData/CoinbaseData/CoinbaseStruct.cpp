@@ -23,8 +23,7 @@ CoinbaseStruct::CoinbaseStruct() {}
 
 CoinbaseStruct::CoinbaseStruct(const uint64_t& blockNumberInput,
                                const int32_t& shardIdInput,
-                               const std::vector<bool>& b1Input,
-                               const std::vector<bool>& b2Input,
+                               const Bitmap& b1Input, const Bitmap& b2Input,
                                const uint128_t& rewardsInput)
     : m_blockNumber(blockNumberInput),
       m_shardId(shardIdInput),
@@ -39,10 +38,10 @@ const uint64_t& CoinbaseStruct::GetBlockNumber() const { return m_blockNumber; }
 const int32_t& CoinbaseStruct::GetShardId() const { return m_shardId; }
 
 /// Returns the b1
-const vector<bool>& CoinbaseStruct::GetB1() const { return m_b1; }
+const Bitmap& CoinbaseStruct::GetB1() const { return m_b1; }
 
 //// Returns the b2
-const vector<bool>& CoinbaseStruct::GetB2() const { return m_b2; }
+const Bitmap& CoinbaseStruct::GetB2() const { return m_b2; }
 
 /// Returns the rewards
 const uint128_t& CoinbaseStruct::GetRewards() const { return m_rewards; }
@@ -21,14 +21,15 @@
 #include <array>
 
 #include "common/Constants.h"
+#include "libUtils/Bitmap.h"
 
 /// Holds information of cosigs and rewards for specific block and specific
 /// shard.
 class CoinbaseStruct {
   uint64_t m_blockNumber{};
   int32_t m_shardId{};
-  std::vector<bool> m_b1;
-  std::vector<bool> m_b2;
+  Bitmap m_b1;
+  Bitmap m_b2;
   uint128_t m_rewards{};
 
  public:
@@ -37,9 +38,8 @@ class CoinbaseStruct {
 
   /// Constructor with specified transaction fields.
   CoinbaseStruct(const uint64_t& blockNumberInput,
-                 const int32_t& m_shardIdInput,
-                 const std::vector<bool>& b1Input,
-                 const std::vector<bool>& b2Input,
+                 const int32_t& m_shardIdInput, const Bitmap& b1Input,
+                 const Bitmap& b2Input,
                  const uint128_t& rewardsInput);
 
   /// Returns the current block number.
@@ -49,10 +49,10 @@ class CoinbaseStruct {
   const int32_t& GetShardId() const;
 
   /// Returns the b1.
-  const std::vector<bool>& GetB1() const;
+  const Bitmap& GetB1() const;
 
   /// Returns the b2.
-  const std::vector<bool>& GetB2() const;
+  const Bitmap& GetB2() const;
 
   /// Returns the rewards.
   const uint128_t& GetRewards() const;
@@ -29,8 +29,7 @@ using namespace std;
 using namespace boost::multiprecision;
 
 template <class Container>
-bool DirectoryService::SaveCoinbaseCore(const vector<bool>& b1,
-                                        const vector<bool>& b2,
+bool DirectoryService::SaveCoinbaseCore(const Bitmap& b1, const Bitmap& b2,
                                         const Container& shard,
                                         const int32_t& shard_id,
                                         const uint64_t& epochNum) {
@@ -71,12 +70,14 @@ bool DirectoryService::SaveCoinbaseCore(const vector<bool>& b1,
     const auto& pubKey = std::get<SHARD_NODE_PUBKEY>(kv);
     if (b1.at(i)) {
       m_coinbaseRewardees[epochNum][shard_id].push_back(pubKey);
+      ++m_coinbaseCosigCounts[pubKey];
       if (m_mapNodeReputation[pubKey] < MAX_REPUTATION) {
         ++m_mapNodeReputation[pubKey];
       }
     }
     if (b2.at(i)) {
       m_coinbaseRewardees[epochNum][shard_id].push_back(pubKey);
+      ++m_coinbaseCosigCounts[pubKey];
       if (m_mapNodeReputation[pubKey] < MAX_REPUTATION) {
         ++m_mapNodeReputation[pubKey];
       }
@@ -98,8 +99,7 @@ bool DirectoryService::SaveCoinbaseCore(const vector<bool>& b1,
   return true;
 }
 
-bool DirectoryService::SaveCoinbase(const vector<bool>& b1,
-                                    const vector<bool>& b2,
+bool DirectoryService::SaveCoinbase(const Bitmap& b1, const Bitmap& b2,
                                     const int32_t& shard_id,
                                     const uint64_t& epochNum) {
   if (LOOKUP_NODE_MODE) {
@@ -154,10 +154,23 @@ void DirectoryService::InitCoinbase() {
 
   auto it = m_coinbaseRewardees.begin();
   while (it != m_coinbaseRewardees.end()) {
-    if (it->first < firstTxEpoch)
+    if (it->first < firstTxEpoch) {
+      for (const auto& shardIdRewardee : it->second) {
+        if (shardIdRewardee.first == CoinbaseReward::LOOKUP_REWARD) {
+          continue;
+        }
+        for (const auto& pk : shardIdRewardee.second) {
+          auto count = m_coinbaseCosigCounts.find(pk);
+          if ((count != m_coinbaseCosigCounts.end()) &&
+              (--count->second == 0)) {
+            m_coinbaseCosigCounts.erase(count);
+          }
+        }
+      }
       it = m_coinbaseRewardees.erase(it);
-    else
+    } else {
       ++it;
+    }
   }
 
   const auto& vecLookup = m_mediator.m_lookup->GetLookupNodesStatic();
@@ -182,13 +195,14 @@ void DirectoryService::InitCoinbase() {
 
   uint128_t sig_count = 0;
   uint32_t lookup_count = 0;
-  for (auto const& epochNum : m_coinbaseRewardees) {
-    for (auto const& shardId : epochNum.second) {
-      if (shardId.first == CoinbaseReward::LOOKUP_REWARD) {
-        lookup_count += shardId.second.size();
-      } else {
-        sig_count += shardId.second.size();
-      }
+  for (const auto& pkCount : m_coinbaseCosigCounts) {
+    sig_count += pkCount.second;
+  }
+  for (const auto& epochNumShardRewardee : m_coinbaseRewardees) {
+    const auto& lookups =
+        epochNumShardRewardee.second.find(CoinbaseReward::LOOKUP_REWARD);
+    if (lookups != epochNumShardRewardee.second.end()) {
+      lookup_count += lookups->second.size();
     }
   }
   LOG_GENERAL(INFO, "Total signatures count: " << sig_count << " lookup count "
@@ -338,52 +352,54 @@ void DirectoryService::InitCoinbase() {
       "[CNBSE] Rewarding cosig rewards to lookup, DS, and shard nodes...");
 
   for (const auto& epochNumShardRewardee : m_coinbaseRewardees) {
-    const auto& epochNum = epochNumShardRewardee.first;
-    const auto& shards = epochNumShardRewardee.second;
-    LOG_GENERAL(INFO, "[CNBSE] Rewarding epoch " << epochNum);
-    for (const auto& shardIdRewardee : shards) {
-      const auto& shardId = shardIdRewardee.first;
-      const auto& rewardees = shardIdRewardee.second;
-      LOG_GENERAL(INFO, "[CNBSE] Rewarding shard " << shardId);
-      if (shardId == CoinbaseReward::LOOKUP_REWARD) {
-        for (const auto& pk : rewardees) {
-          const auto& addr = Account::GetAddressFromPublicKey(pk);
-          if (!AccountStore::GetInstance().UpdateCoinbaseTemp(
-                  addr, coinbaseAddress, reward_each_lookup)) {
-            LOG_GENERAL(WARNING, "Could not reward " << addr << " - " << pk);
-          } else {
-            nonGuard.emplace_back(addr);
-            suc_lookup_counter++;
-          }
-        }
+    const auto& lookups =
+        epochNumShardRewardee.second.find(CoinbaseReward::LOOKUP_REWARD);
+    if (lookups == epochNumShardRewardee.second.end()) {
+      continue;
+    }
+    LOG_GENERAL(INFO, "[CNBSE] Rewarding lookups of epoch "
+                          << epochNumShardRewardee.first);
+    for (const auto& pk : lookups->second) {
+      const auto& addr = Account::GetAddressFromPublicKey(pk);
+      if (!AccountStore::GetInstance().UpdateCoinbaseTemp(
+              addr, coinbaseAddress, reward_each_lookup)) {
+        LOG_GENERAL(WARNING, "Could not reward " << addr << " - " << pk);
       } else {
-        for (const auto& pk : rewardees) {
-          if (GUARD_MODE && pubKeyAndIsGuard[pk]) {
-            suc_counter++;
-          } else {
-            const auto& addr = Account::GetAddressFromPublicKey(pk);
-            if (!AccountStore::GetInstance().UpdateCoinbaseTemp(
-                    addr, coinbaseAddress, reward_each)) {
-              LOG_GENERAL(WARNING, "Could not reward " << addr << " - " << pk);
-            } else {
-              if (addr == myAddr) {
-                LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-                          "[REWARD] Rewarded " << reward_each << " for blk "
-                                               << epochNum);
-                LOG_STATE("[REWARD]["
-                          << setw(15) << left
-                          << m_mediator.m_selfPeer.GetPrintableIPAddress()
-                          << "][" << m_mediator.m_currentEpochNum << "]["
-                          << reward_each << "] for blk " << epochNum);
-              }
-              suc_counter++;
-            }
-          }
-        }
+        nonGuard.emplace_back(addr);
+        suc_lookup_counter++;
       }
     }
   }
 
+  // Each node gets the reward of all its cosigs at once
+  for (const auto& pkCount : m_coinbaseCosigCounts) {
+    const auto& pk = pkCount.first;
+    const uint128_t count = pkCount.second;
+    if (GUARD_MODE && pubKeyAndIsGuard[pk]) {
+      suc_counter += count;
+      continue;
+    }
+
+    const auto& addr = Account::GetAddressFromPublicKey(pk);
+    uint128_t reward = 0;
+    if (!SafeMath<uint128_t>::mul(reward_each, count, reward) ||
+        !AccountStore::GetInstance().UpdateCoinbaseTemp(addr, coinbaseAddress,
+                                                        reward)) {
+      LOG_GENERAL(WARNING, "Could not reward " << addr << " - " << pk);
+      continue;
+    }
+    if (addr == myAddr) {
+      LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+                "[REWARD] Rewarded " << reward << " for " << count
+                                     << " cosigs");
+      LOG_STATE("[REWARD][" << setw(15) << left
+                            << m_mediator.m_selfPeer.GetPrintableIPAddress()
+                            << "][" << m_mediator.m_currentEpochNum << "]["
+                            << reward << "] for " << count << " cosigs");
+    }
+    suc_counter += count;
+  }
+
   uint128_t balance_left = total_reward - (suc_counter * reward_each) -
                            (suc_lookup_counter * reward_each_lookup) -
                            (node_count * base_reward_each);
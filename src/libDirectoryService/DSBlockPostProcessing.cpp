@@ -36,6 +36,7 @@
 #include "libNetwork/P2PComm.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
+#include "libUtils/EpochPerf.h"
 #include "libUtils/HashUtils.h"
 #include "libUtils/Logger.h"
 #include "libUtils/SanityChecks.h"
@@ -232,7 +233,8 @@ void DirectoryService::SendDSBlockToShardNodes(
   }
 }
 
-void DirectoryService::UpdateMyDSModeAndConsensusId() {
+void DirectoryService::UpdateMyDSModeAndConsensusId(
+    const IndexOfNode& dsIndex) {
   LOG_MARKER();
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
@@ -257,14 +259,10 @@ void DirectoryService::UpdateMyDSModeAndConsensusId() {
   // 2. My node was removed by the DS Committee due to lack of sufficient
   // performance.
   bool isDropout = true;
-  for (auto it = m_mediator.m_DSCommittee->begin();
-       it != m_mediator.m_DSCommittee->end(); ++it) {
-    // Look for my public key.
-    if (m_mediator.m_selfKey.second == it->first) {
-      m_consensusMyID = std::distance(m_mediator.m_DSCommittee->begin(), it);
-      isDropout = false;
-      break;
-    }
+  const auto myIndex = dsIndex.find(m_mediator.m_selfKey.second);
+  if (myIndex != dsIndex.end()) {
+    m_consensusMyID = myIndex->second;
+    isDropout = false;
   }
 
   // Check if I am one of the DS Committee drop outs.
@@ -317,7 +315,7 @@ void DirectoryService::UpdateMyDSModeAndConsensusId() {
   }
 }
 
-void DirectoryService::UpdateDSCommitteeComposition() {
+void DirectoryService::UpdateDSCommitteeComposition(IndexOfNode& dsIndex) {
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
                 "DirectoryService::UpdateDSCommitteeComposition is not "
@@ -329,9 +327,9 @@ void DirectoryService::UpdateDSCommitteeComposition() {
   LOG_MARKER();
   std::lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
 
-  UpdateDSCommitteeCompositionCore(m_mediator.m_selfKey.second,
-                                   *m_mediator.m_DSCommittee,
-                                   m_mediator.m_dsBlockChain.GetLastBlock());
+  UpdateDSCommitteeCompositionCore(
+      m_mediator.m_selfKey.second, *m_mediator.m_DSCommittee,
+      m_mediator.m_dsBlockChain.GetLastBlock(), dsIndex);
 }
 
 void DirectoryService::StartNextTxEpoch() {
@@ -347,6 +345,7 @@ void DirectoryService::StartNextTxEpoch() {
   {
     lock_guard<mutex> g(m_mutexAllPOW);
     m_allPoWs.clear();
+    m_allPoWSortHashes.clear();
   }
 
   // blacklist pop for ds nodes
@@ -368,6 +367,7 @@ void DirectoryService::StartNextTxEpoch() {
   {
     std::lock_guard<mutex> lock(m_mutexMicroBlocks);
     m_microBlocks.clear();
+    m_microBlockTotals.clear();
     m_missingMicroBlocks.clear();
     m_microBlockStateDeltas.clear();
   }
@@ -419,6 +419,7 @@ void DirectoryService::StartNextTxEpoch() {
   if (m_mediator.m_currentEpochNum % NUM_FINAL_BLOCK_PER_POW == 0) {
     lock_guard<mutex> h(m_mutexCoinbaseRewardees);
     m_coinbaseRewardees.clear();
+    m_coinbaseCosigCounts.clear();
   }
 
   // Start sharding work
@@ -495,6 +496,7 @@ void DirectoryService::StartFirstTxEpoch() {
   {
     lock_guard<mutex> g(m_mutexAllPOW);
     m_allPoWs.clear();
+    m_allPoWSortHashes.clear();
   }
 
   // blacklist pop for ds nodes
@@ -516,6 +518,7 @@ void DirectoryService::StartFirstTxEpoch() {
   {
     std::lock_guard<mutex> lock(m_mutexMicroBlocks);
     m_microBlocks.clear();
+    m_microBlockTotals.clear();
     m_missingMicroBlocks.clear();
     m_microBlockStateDeltas.clear();
     m_totalTxnFees = 0;
@@ -679,6 +682,10 @@ void DirectoryService::ProcessDSBlockConsensusWhenDone() {
 
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum, "DSBlock consensus DONE");
 
+  if (ENABLE_EPOCH_PERF) {
+    EpochPerf::GetInstance().End(EpochPerf::DS_BLOCK_CONSENSUS);
+  }
+
   lock_guard<mutex> g(m_mediator.m_node->m_mutexDSBlock);
 
   if (m_mode == PRIMARY_DS) {
@@ -794,8 +801,9 @@ void DirectoryService::ProcessDSBlockConsensusWhenDone() {
       << "] AFTER SENDING DSBLOCK");
 
   ClearVCBlockVector();
-  UpdateDSCommitteeComposition();
-  UpdateMyDSModeAndConsensusId();
+  IndexOfNode dsIndex;
+  UpdateDSCommitteeComposition(dsIndex);
+  UpdateMyDSModeAndConsensusId(dsIndex);
 
   if (m_mediator.m_DSCommittee->at(GetConsensusLeaderID()).first ==
       m_mediator.m_selfKey.second) {
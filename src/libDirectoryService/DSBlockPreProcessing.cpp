@@ -21,12 +21,14 @@
 
 #include "DSComposition.h"
 #include "DirectoryService.h"
+#include "ShardingOrder.h"
 #include "common/Constants.h"
 #include "common/Messages.h"
 #include "common/Serializable.h"
 #include "depends/common/RLP.h"
 #include "depends/libTrie/TrieDB.h"
 #include "depends/libTrie/TrieHash.h"
+#include "libConsensus/ConsensusLatencyTracker.h"
 #include "libCrypto/Sha2.h"
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
@@ -35,7 +37,7 @@
 #include "libPOW/pow.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
-#include "libUtils/HashUtils.h"
+#include "libUtils/EpochPerf.h"
 #include "libUtils/Logger.h"
 #include "libUtils/SanityChecks.h"
 #include "libUtils/ShardSizeCalculator.h"
@@ -151,30 +153,13 @@ void DirectoryService::ComputeSharding(const VectorOfPoWSoln& sortedPoWSolns) {
     m_shards.emplace_back();
   }
 
-  // Push all the sorted PoW submissions into an ordered map with key =
-  // H(last_block_hash, pow_hash)
-  map<array<unsigned char, BLOCK_HASH_SIZE>, PubKey> sortedPoWs;
-  bytes lastBlockHash(BLOCK_HASH_SIZE);
+  // Order all the sorted PoW submissions by H(last_block_hash, pow_hash)
+  const bytes lastBlockHash = GetShardingBlockHash();
 
-  if (m_mediator.m_currentEpochNum > 1) {
-    lastBlockHash =
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
-  }
-
-  bytes hashVec(BLOCK_HASH_SIZE + POW_SIZE);
-  copy(lastBlockHash.begin(), lastBlockHash.end(), hashVec.begin());
-  for (const auto& kv : sortedPoWSolns) {
-    const PubKey& key = kv.second;
-    const auto& powHash = kv.first;
-    copy(powHash.begin(), powHash.end(), hashVec.begin() + BLOCK_HASH_SIZE);
+  const auto sortedPoWs =
+      OrderPoWsForSharding(lastBlockHash, sortedPoWSolns, POW_VERIFY_THREADS);
 
-    const bytes& sortHashVec = HashUtils::BytesToHash(hashVec);
-    array<unsigned char, BLOCK_HASH_SIZE> sortHash{};
-    copy(sortHashVec.begin(), sortHashVec.end(), sortHash.begin());
-    sortedPoWs.emplace(sortHash, key);
-  }
-
-  // Distribute the map-ordered nodes among the generated shards
+  // Distribute the ordered nodes among the generated shards
   // First fill up first shard, then second shard, ..., then final shard
   uint32_t shard_index = 0;
   for (const auto& kv : sortedPoWs) {
@@ -439,10 +424,26 @@ bool DirectoryService::VerifyRemovedByzantineNodes() {
   unsigned int numOfRemovedMembers = removeDSNodePubkeys.size();
 
   // Create an empty vector to populate with our view of the DS members to
-  // remove.
+  // remove. If it was found ahead for the most winners, the first ones of it
+  // are the ones to remove for the proposed winners.
   std::vector<PubKey> comparedToBeRemoved;
-  unsigned int comparedNumOfRemoved =
-      DetermineByzantineNodes(numOfProposedMembers, comparedToBeRemoved);
+  unsigned int comparedNumOfRemoved = 0;
+  bool precomputed = false;
+  {
+    lock_guard<mutex> g(m_mutexDsMemberPerformance);
+    if (m_expectedByzantineNodesEpoch == m_mediator.m_currentEpochNum) {
+      comparedNumOfRemoved = std::min<unsigned int>(
+          numOfProposedMembers, m_expectedByzantineNodes.size());
+      comparedToBeRemoved.assign(
+          m_expectedByzantineNodes.begin(),
+          m_expectedByzantineNodes.begin() + comparedNumOfRemoved);
+      precomputed = true;
+    }
+  }
+  if (!precomputed) {
+    comparedNumOfRemoved =
+        DetermineByzantineNodes(numOfProposedMembers, comparedToBeRemoved);
+  }
 
   // Check that the number of nodes to remove matches the proposed
   // DS block.
@@ -477,14 +478,9 @@ bool DirectoryService::VerifyPoWOrdering(
   LOG_MARKER();
 
   // Requires mutex for m_shards
-  bytes lastBlockHash(BLOCK_HASH_SIZE, 0);
+  const bytes lastBlockHash = GetShardingBlockHash();
   set<PubKey> keyset;
 
-  if (m_mediator.m_currentEpochNum > 1) {
-    lastBlockHash =
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
-  }
-
   const float MISORDER_TOLERANCE =
       (float)MISORDER_TOLERANCE_IN_PERCENT / ONE_HUNDRED_PERCENT;
   const uint32_t MAX_MISORDER_NODE =
@@ -534,23 +530,24 @@ bool DirectoryService::VerifyPoWOrdering(
     }
   }
 
-  bytes hashVec(BLOCK_HASH_SIZE + BLOCK_HASH_SIZE);
-  std::copy(lastBlockHash.begin(), lastBlockHash.end(), hashVec.begin());
+  // The first solution of each node, as the leader took it
+  std::map<PubKey, std::array<unsigned char, 32>> sortedResults;
+  for (const auto& kv : sortedPoWSolns) {
+    sortedResults.emplace(kv.second, kv.first);
+  }
+
+  PreVerifyPoWsFromLeader(shards, allPoWsFromLeader, sortedResults);
+
   bool ret = true;
-  bytes vec(BLOCK_HASH_SIZE), preVec(BLOCK_HASH_SIZE);
-  uint32_t misorderNodes = 0;
+  std::vector<std::array<unsigned char, 32>> results;
+  std::vector<PubKey> resultKeys;
   for (const auto& shard : shards) {
     for (const auto& shardNode : shard) {
       const PubKey& toFind = std::get<SHARD_NODE_PUBKEY>(shardNode);
-      auto it = std::find_if(
-          sortedPoWSolns.cbegin(), sortedPoWSolns.cend(),
-          [&toFind](
-              const std::pair<std::array<unsigned char, 32>, PubKey>& item) {
-            return item.second == toFind;
-          });
+      auto it = sortedResults.find(toFind);
 
       std::array<unsigned char, 32> result{};
-      if (it == sortedPoWSolns.cend()) {
+      if (it == sortedResults.end()) {
         LOG_GENERAL(WARNING, "Failed to find key in the PoW ordering "
                                  << toFind << " " << sortedPoWSolns.size());
 
@@ -577,7 +574,7 @@ bool DirectoryService::VerifyPoWOrdering(
           }
         }
       } else {
-        result = it->first;
+        result = it->second;
       }
 
       auto r = keyset.insert(std::get<SHARD_NODE_PUBKEY>(shardNode));
@@ -588,45 +585,78 @@ bool DirectoryService::VerifyPoWOrdering(
         break;
       }
 
-      copy(result.begin(), result.end(), hashVec.begin() + BLOCK_HASH_SIZE);
-      const bytes& sortHashVec = HashUtils::BytesToHash(hashVec);
+      results.emplace_back(result);
+      resultKeys.emplace_back(toFind);
+    }
+    if (!ret) {
+      break;
+    }
+  }
 
-      if (DEBUG_LEVEL >= 5) {
-        string sortHashVecStr;
-        if (!DataConversion::Uint8VecToHexStr(sortHashVec, sortHashVecStr)) {
-          LOG_GENERAL(INFO,
-                      "[DSSORT]"
-                          << " Unable to convert sortHashVec to hex string");
-        } else {
-          LOG_GENERAL(INFO, "[DSSORT]"
-                                << sortHashVecStr << " "
-                                << std::get<SHARD_NODE_PUBKEY>(shardNode));
-        }
+  // Only the sort hashes of the PoWs that were not submitted to us are left
+  // to work out
+  std::vector<PoWSortHash> sortHashes(results.size());
+  std::vector<std::array<unsigned char, 32>> missingResults;
+  std::vector<unsigned int> missingIndexes;
+  {
+    lock_guard<mutex> g(m_mutexAllPOW);
+    const bool fromSameBlock = m_allPoWSortBlockHash == lastBlockHash;
+    for (unsigned int i = 0; i < results.size(); i++) {
+      auto it = m_allPoWSortHashes.find(resultKeys.at(i));
+      if (fromSameBlock && it != m_allPoWSortHashes.end() &&
+          it->second.first == results.at(i)) {
+        sortHashes.at(i) = it->second.second;
+      } else {
+        missingResults.emplace_back(results.at(i));
+        missingIndexes.emplace_back(i);
       }
-      if (sortHashVec < vec) {
-        string vecStr, sortHashVecStr;
-        if (!DataConversion::Uint8VecToHexStr(vec, vecStr) ||
-            !DataConversion::Uint8VecToHexStr(sortHashVec, sortHashVecStr)) {
-          LOG_GENERAL(WARNING,
-                      "Unable to convert vec or sortHashVec to hex string");
-        } else {
-          LOG_GENERAL(WARNING, "Bad PoW ordering found: " << vecStr << " "
-                                                          << sortHashVecStr);
-        }
+    }
+  }
 
-        ++misorderNodes;
-        // If there is one PoW ordering fail, then vec is assigned to a big
-        // mismatch hash already, need to revert it to previous result and
-        // continue the comparison.
-        vec = preVec;
-        continue;
+  const auto missingSortHashes =
+      ComputePoWSortHashes(lastBlockHash, missingResults, POW_VERIFY_THREADS);
+  for (unsigned int i = 0; i < missingIndexes.size(); i++) {
+    sortHashes.at(missingIndexes.at(i)) = missingSortHashes.at(i);
+  }
+
+  LOG_GENERAL(INFO, "Sort hashes worked out ahead for "
+                        << results.size() - missingResults.size() << " of "
+                        << results.size() << " nodes");
+
+  PoWSortHash vec{}, preVec{};
+  uint32_t misorderNodes = 0;
+  for (unsigned int i = 0; i < sortHashes.size(); i++) {
+    const auto& sortHash = sortHashes.at(i);
+
+    if (DEBUG_LEVEL >= 5) {
+      string sortHashStr;
+      if (!DataConversion::charArrToHexStr(sortHash, sortHashStr)) {
+        LOG_GENERAL(INFO,
+                    "[DSSORT]" << " Unable to convert sortHash to hex string");
+      } else {
+        LOG_GENERAL(INFO, "[DSSORT]" << sortHashStr << " " << resultKeys.at(i));
       }
-      preVec = vec;
-      vec = sortHashVec;
     }
-    if (!ret) {
-      break;
+    if (sortHash < vec) {
+      string vecStr, sortHashStr;
+      if (!DataConversion::charArrToHexStr(vec, vecStr) ||
+          !DataConversion::charArrToHexStr(sortHash, sortHashStr)) {
+        LOG_GENERAL(WARNING,
+                    "Unable to convert vec or sortHash to hex string");
+      } else {
+        LOG_GENERAL(WARNING,
+                    "Bad PoW ordering found: " << vecStr << " " << sortHashStr);
+      }
+
+      ++misorderNodes;
+      // If there is one PoW ordering fail, then vec is assigned to a big
+      // mismatch hash already, need to revert it to previous result and
+      // continue the comparison.
+      vec = preVec;
+      continue;
     }
+    preVec = vec;
+    vec = sortHash;
   }
 
   if (misorderNodes > MAX_MISORDER_NODE) {
@@ -639,6 +669,25 @@ bool DirectoryService::VerifyPoWOrdering(
   return ret;
 }
 
+bytes DirectoryService::GetShardingBlockHash() const {
+  if (m_mediator.m_currentEpochNum > 1) {
+    return m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+  }
+  return bytes(BLOCK_HASH_SIZE, 0);
+}
+
+void DirectoryService::SavePoWSortHash(
+    const PubKey& pubKey, const std::array<unsigned char, 32>& result) {
+  const bytes lastBlockHash = GetShardingBlockHash();
+  if (lastBlockHash != m_allPoWSortBlockHash) {
+    m_allPoWSortHashes.clear();
+    m_allPoWSortBlockHash = lastBlockHash;
+  }
+
+  m_allPoWSortHashes[pubKey] = {
+      result, ComputePoWSortHashes(lastBlockHash, {result}, 0).front()};
+}
+
 bool DirectoryService::VerifyPoWFromLeader(const Peer& peer,
                                            const PubKey& pubKey,
                                            const PoWSolution& powSoln) {
@@ -685,6 +734,62 @@ bool DirectoryService::VerifyPoWFromLeader(const Peer& peer,
   return true;
 }
 
+void DirectoryService::PreVerifyPoWsFromLeader(
+    const DequeOfShard& shards, const MapOfPubKeyPoW& allPoWsFromLeader,
+    const std::map<PubKey, std::array<unsigned char, 32>>& sortedResults) {
+  if (POW_VERIFY_THREADS <= 1) {
+    return;
+  }
+
+  // The PoWs that VerifyPoWOrdering will take from the announcement are
+  // verified ahead on several threads, so that checking them one by one
+  // afterwards only looks up the POW cache
+  std::vector<PoWVerifyRequest> requests;
+  for (const auto& shard : shards) {
+    for (const auto& shardNode : shard) {
+      const PubKey& pubKey = std::get<SHARD_NODE_PUBKEY>(shardNode);
+      const auto it = allPoWsFromLeader.find(pubKey);
+      if (sortedResults.find(pubKey) != sortedResults.end() ||
+          m_allPoWs.find(pubKey) != m_allPoWs.end() ||
+          it == allPoWsFromLeader.end()) {
+        continue;
+      }
+
+      const auto& powSoln = it->second;
+      PoWVerifyRequest request;
+      request.difficulty =
+          (GUARD_MODE && Guard::GetInstance().IsNodeInShardGuardList(pubKey))
+              ? (POW_DIFFICULTY / POW_DIFFICULTY)
+              : m_mediator.m_dsBlockChain.GetLastBlock()
+                    .GetHeader()
+                    .GetDifficulty();
+      request.headerHash = POW::GenHeaderHash(
+          m_mediator.m_dsBlockRand, m_mediator.m_txBlockRand,
+          std::get<SHARD_NODE_PEER>(shardNode), pubKey, powSoln.lookupId,
+          powSoln.gasPrice);
+      request.nonce = powSoln.nonce;
+      if (!DataConversion::charArrToHexStr(powSoln.result, request.result) ||
+          !DataConversion::charArrToHexStr(powSoln.mixhash,
+                                           request.mixHash)) {
+        continue;
+      }
+      requests.emplace_back(move(request));
+    }
+  }
+
+  if (requests.size() <= 1) {
+    return;
+  }
+
+  const auto verified = POW::GetInstance().PoWVerifyBatch(
+      m_pendingDSBlock->GetHeader().GetBlockNum(), requests,
+      POW_VERIFY_THREADS);
+  LOG_GENERAL(INFO, "Verified ahead "
+                        << count(verified.begin(), verified.end(), true)
+                        << " of " << requests.size()
+                        << " PoWs from the announcement");
+}
+
 bool DirectoryService::VerifyNodePriority(const DequeOfShard& shards,
                                           MapOfPubKeyPoW& priorityNodePoWs) {
   // If the PoW submissions less than the max number of nodes, then all nodes
@@ -1312,7 +1417,7 @@ bool DirectoryService::RunConsensusOnDSBlockWhenDSBackup() {
 
 bool DirectoryService::ProcessShardingStructure(
     const DequeOfShard& shards,
-    std::map<PubKey, uint32_t>& publicKeyToshardIdMap,
+    PubKeyHashMap<uint32_t>& publicKeyToshardIdMap,
     std::map<PubKey, uint16_t>& mapNodeReputation) {
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
@@ -1448,6 +1553,10 @@ void DirectoryService::SaveDSPerformance() {
                         *m_mediator.m_DSCommittee, m_mediator.m_currentEpochNum,
                         NUM_FINAL_BLOCK_PER_POW,
                         CoinbaseReward::FINALBLOCK_REWARD);
+
+  // Let the consensus leader deprioritise members that miss co-signatures
+  ConsensusLatencyTracker::GetInstance().SetCosigPerformance(
+      m_dsMemberPerformance, (NUM_FINAL_BLOCK_PER_POW - 1) * 2);
 }
 
 unsigned int DirectoryService::DetermineByzantineNodesCore(
@@ -1528,6 +1637,15 @@ unsigned int DirectoryService::DetermineByzantineNodes(
       m_dsMemberPerformance);
 }
 
+void DirectoryService::PrecomputeByzantineNodes() {
+  std::vector<PubKey> byzantineNodes;
+  DetermineByzantineNodes(NUM_DS_BYZANTINE_REMOVED, byzantineNodes);
+
+  lock_guard<mutex> g(m_mutexDsMemberPerformance);
+  m_expectedByzantineNodes = std::move(byzantineNodes);
+  m_expectedByzantineNodesEpoch = m_mediator.m_currentEpochNum;
+}
+
 void DirectoryService::RunConsensusOnDSBlock() {
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
@@ -1538,6 +1656,10 @@ void DirectoryService::RunConsensusOnDSBlock() {
 
   LOG_MARKER();
 
+  if (ENABLE_EPOCH_PERF) {
+    EpochPerf::GetInstance().Begin(EpochPerf::DS_BLOCK_CONSENSUS);
+  }
+
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
             "Number of PoW recvd: " << m_allPoWs.size() << ", DS PoW recvd: "
                                     << m_allDSPoWs.size());
@@ -1556,10 +1678,14 @@ void DirectoryService::RunConsensusOnDSBlock() {
   // Record the performance of the coinbase rewardees to get the co-sigs
   // before the variable is cleared.
   SaveDSPerformance();
+  if (m_mode != PRIMARY_DS) {
+    PrecomputeByzantineNodes();
+  }
 
   {
     lock_guard<mutex> h(m_mutexCoinbaseRewardees);
     m_coinbaseRewardees.clear();
+    m_coinbaseCosigCounts.clear();
   }
 
   // Upon consensus object creation failure, one should not return from the
@@ -1584,6 +1710,7 @@ void DirectoryService::RunConsensusOnDSBlock() {
 
   // View change will wait for timeout. If conditional variable is notified
   // before timeout, the thread will return without triggering view change.
+  StageViewChange();
   std::unique_lock<std::mutex> cv_lk(m_MutexCVViewChangeDSBlock);
   if (cv_viewChangeDSBlock.wait_for(cv_lk,
                                     std::chrono::seconds(VIEWCHANGE_TIME)) ==
@@ -15,6 +15,9 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <iterator>
+
 #include "DSComposition.h"
 
 using namespace std;
@@ -22,6 +25,14 @@ using namespace std;
 void UpdateDSCommitteeCompositionCore(const PubKey& selfKeyPub,
                                       DequeOfNode& dsComm,
                                       const DSBlock& dsblock) {
+  IndexOfNode dsIndex;
+  UpdateDSCommitteeCompositionCore(selfKeyPub, dsComm, dsblock, dsIndex);
+}
+
+void UpdateDSCommitteeCompositionCore(const PubKey& selfKeyPub,
+                                      DequeOfNode& dsComm,
+                                      const DSBlock& dsblock,
+                                      IndexOfNode& dsIndex) {
   LOG_MARKER();
 
   // Get the map of all pow winners from the DS Block
@@ -31,16 +42,20 @@ void UpdateDSCommitteeCompositionCore(const PubKey& selfKeyPub,
   // Get the vector of all non-performant nodes to be removed.
   const auto& removeDSNodePubkeys = dsblock.GetHeader().GetDSRemovePubKeys();
 
-  // Shuffle the non-performant nodes to the back.
-  DequeOfNode::iterator it;
+  dsIndex.clear();
+  dsIndex.reserve(dsComm.size());
+  for (unsigned int i = 0; i < dsComm.size(); ++i) {
+    dsIndex.emplace(dsComm[i].first, i);
+  }
+
+  // Shuffle the non-performant nodes to the back, in the order they are
+  // listed in. A node listed twice goes back again.
+  vector<bool> isRemoved(dsComm.size(), false);
+  vector<uint16_t> removedOrder;
   for (const auto& RemovedNode : removeDSNodePubkeys) {
     // Find the pubkey in our view of the DS Committee.
-    for (it = dsComm.begin(); it != dsComm.end(); ++it) {
-      if (RemovedNode == it->first) {
-        break;
-      }
-    }
-    if (it == dsComm.end()) {
+    const auto index = dsIndex.find(RemovedNode);
+    if (index == dsIndex.end()) {
       LOG_GENERAL(WARNING,
                   "[FATAL] The DS member "
                       << RemovedNode
@@ -53,44 +68,45 @@ void UpdateDSCommitteeCompositionCore(const PubKey& selfKeyPub,
         "Shuffling non-performant node to the back of the DS Composition: "
             << RemovedNode);
 
-    // Move the candidate to the back of the committee and continue processing
-    // other candidates. Only reorders the Committee. The size is not changed.
-    dsComm.emplace_back(*it);
-    dsComm.erase(it);
+    if (isRemoved[index->second]) {
+      removedOrder.erase(
+          find(removedOrder.begin(), removedOrder.end(), index->second));
+    }
+    isRemoved[index->second] = true;
+    removedOrder.emplace_back(index->second);
+  }
 
-    continue;
+  DequeOfNode shuffled;
+  for (unsigned int i = 0; i < dsComm.size(); ++i) {
+    if (!isRemoved[i]) {
+      shuffled.emplace_back(move(dsComm[i]));
+    }
+  }
+  for (const auto& index : removedOrder) {
+    shuffled.emplace_back(move(dsComm[index]));
   }
 
-  // Add the new winners.
-  for (const auto& DSPowWinner : NewDSMembers) {
+  // Add the new winners. Every winner is placed in front of the ones before
+  // it, behind the DS guards in guard mode.
+  const unsigned int numFront =
+      GUARD_MODE ? min<unsigned int>(Guard::GetInstance().GetNumOfDSGuard(),
+                                     shuffled.size())
+                 : 0;
+  dsComm.clear();
+  dsComm.insert(dsComm.end(), make_move_iterator(shuffled.begin()),
+                make_move_iterator(shuffled.begin() + numFront));
+  for (auto it = NewDSMembers.rbegin(); it != NewDSMembers.rend(); ++it) {
     // If the current iterated winner is my node.
-    if (selfKeyPub == DSPowWinner.first) {
-      if (!GUARD_MODE) {
-        // Place my node's information in front of the DS Committee
-        // Peer() is required because my own node's network information is
-        // zeroed out.
-        dsComm.emplace_front(selfKeyPub, Peer());
-      } else {
-        // Calculate the position to insert the current winner.
-        it = dsComm.begin() + (Guard::GetInstance().GetNumOfDSGuard());
-        // Place my node's information in front of the DS Committee Community
-        // Nodes.
-        dsComm.emplace(it, selfKeyPub, Peer());
-      }
+    if (selfKeyPub == it->first) {
+      // Peer() is required because my own node's network information is
+      // zeroed out.
+      dsComm.emplace_back(selfKeyPub, Peer());
     } else {
-      if (!GUARD_MODE) {
-        // Place the current winner node's information in front of the DS
-        // Committee.
-        dsComm.emplace_front(DSPowWinner);
-      } else {
-        // Calculate the position to insert the current winner.
-        it = dsComm.begin() + (Guard::GetInstance().GetNumOfDSGuard());
-        // Place the winner's information in front of the DS Committee Community
-        // Nodes.
-        dsComm.emplace(it, DSPowWinner);
-      }
+      dsComm.emplace_back(*it);
     }
   }
+  dsComm.insert(dsComm.end(), make_move_iterator(shuffled.begin() + numFront),
+                make_move_iterator(shuffled.end()));
 
   // Print some statistics.
   unsigned int NumLosers = removeDSNodePubkeys.size();
@@ -100,11 +116,16 @@ void UpdateDSCommitteeCompositionCore(const PubKey& selfKeyPub,
   LOG_GENERAL(INFO, "Nodes expiring due to old age: " << NumExpiring);
 
   // Remove one node for every winner, maintaining the size of the DS Committee.
-  for (uint32_t i = 0; i < NumWinners; ++i) {
+  for (uint32_t i = 0; i < NumWinners && !dsComm.empty(); ++i) {
     // One item is always removed every winner, with removal priority given to
     // 'loser' candidates before expiring nodes.
     LOG_GENERAL(INFO,
                 "Node dropped from DS Committee: " << dsComm.back().first);
     dsComm.pop_back();
   }
+
+  dsIndex.clear();
+  for (unsigned int i = 0; i < dsComm.size(); ++i) {
+    dsIndex.emplace(dsComm[i].first, i);
+  }
 }
@@ -29,4 +29,11 @@ void UpdateDSCommitteeCompositionCore(const PubKey& selfKeyPub,
                                       DequeOfNode& dsComm,
                                       const DSBlock& dsblock);
 
+/// Same as above, and also fills dsIndex with the position of every member
+/// of the new committee. The committee is rebuilt in a single pass.
+void UpdateDSCommitteeCompositionCore(const PubKey& selfKeyPub,
+                                      DequeOfNode& dsComm,
+                                      const DSBlock& dsblock,
+                                      IndexOfNode& dsIndex);
+
 #endif  // ZILLIQA_SRC_LIBDIRECTORYSERVICE_DSCOMPOSITION_H_
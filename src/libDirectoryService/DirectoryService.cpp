@@ -39,6 +39,7 @@
 #include "libUtils/Logger.h"
 #include "libUtils/RootComputation.h"
 #include "libUtils/SanityChecks.h"
+#include "libUtils/ThreadPool.h"
 #include "libUtils/TimestampVerifier.h"
 
 using namespace std;
@@ -48,6 +49,10 @@ DirectoryService::DirectoryService(Mediator& mediator) : m_mediator(mediator) {
   if (!LOOKUP_NODE_MODE) {
     SetState(POW_SUBMISSION);
     cv_POWSubmission.notify_all();
+    if (POW_VERIFY_THREADS > 0) {
+      m_powVerifyPool =
+          make_unique<ThreadPool>(POW_VERIFY_THREADS, "PoWVerify");
+    }
   }
   m_mode = IDLE;
   SetConsensusLeaderID(0);
@@ -56,7 +61,10 @@ DirectoryService::DirectoryService(Mediator& mediator) : m_mediator(mediator) {
   m_forceMulticast = false;
 }
 
-DirectoryService::~DirectoryService() {}
+DirectoryService::~DirectoryService() {
+  // Its threads use the other members
+  m_powVerifyPool.reset();
+}
 
 void DirectoryService::StartSynchronization(bool clean) {
   if (LOOKUP_NODE_MODE) {
@@ -450,6 +458,7 @@ bool DirectoryService::CleanVariables() {
   {
     std::lock_guard<mutex> lock(m_mutexAllPOW);
     m_allPoWs.clear();
+    m_allPoWSortHashes.clear();
   }
 
   ClearDSPoWSolns();
@@ -459,6 +468,7 @@ bool DirectoryService::CleanVariables() {
   {
     std::lock_guard<mutex> lock(m_mutexMicroBlocks);
     m_microBlocks.clear();
+    m_microBlockTotals.clear();
     m_microBlockStateDeltas.clear();
     m_missingMicroBlocks.clear();
     m_totalTxnFees = 0;
@@ -722,9 +732,9 @@ void DirectoryService::StartNewDSEpochConsensus(bool fromFallback,
                                 (fromFallback ? FALLBACK_EXTRA_TIME : 0)
                          << " seconds, accepting PoW submissions...");
 
-    this_thread::sleep_for(
-        chrono::seconds(NEW_NODE_SYNC_INTERVAL + POW_WINDOW_IN_SECONDS +
-                        (fromFallback ? FALLBACK_EXTRA_TIME : 0)));
+    const bool closedEarly = WaitForPoWSubmissions(
+        NEW_NODE_SYNC_INTERVAL + POW_WINDOW_IN_SECONDS +
+        (fromFallback ? FALLBACK_EXTRA_TIME : 0));
 
     // create and send POW submission packets
     auto func = [this]() mutable -> void {
@@ -732,13 +742,17 @@ void DirectoryService::StartNewDSEpochConsensus(bool fromFallback,
     };
     DetachedFunction(1, func);
 
-    LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-              "Waiting " << POWPACKETSUBMISSION_WINDOW_IN_SECONDS
-                         << " seconds, accepting PoW submissions packet from "
-                            "other DS member...");
+    // The backups forward their packets only at the end of their own window,
+    // and they take the solutions they missed from the announcement
+    if (!closedEarly) {
+      LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+                "Waiting " << POWPACKETSUBMISSION_WINDOW_IN_SECONDS
+                           << " seconds, accepting PoW submissions packet from "
+                              "other DS member...");
 
-    this_thread::sleep_for(
-        chrono::seconds(POWPACKETSUBMISSION_WINDOW_IN_SECONDS));
+      this_thread::sleep_for(
+          chrono::seconds(POWPACKETSUBMISSION_WINDOW_IN_SECONDS));
+    }
 
     RunConsensusOnDSBlock();
   } else {
@@ -1067,7 +1081,8 @@ bool DirectoryService::Execute(const bytes& message, unsigned int offset,
                        &DirectoryService::ProcessGetDSTxBlockMessage,
                        &DirectoryService::ProcessPoWPacketSubmission,
                        &DirectoryService::ProcessNewDSGuardNetworkInfo,
-                       &DirectoryService::ProcessCosigsRewardsFromSeed});
+                       &DirectoryService::ProcessCosigsRewardsFromSeed,
+                       &DirectoryService::ProcessFinalBlockProposal});
 
   const unsigned char ins_byte = message.at(offset);
 
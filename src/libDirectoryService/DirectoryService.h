@@ -21,6 +21,7 @@
 #include <array>
 #include <condition_variable>
 #include <deque>
+#include <functional>
 #include <list>
 #include <map>
 #include <set>
@@ -30,6 +31,7 @@
 #include "common/Constants.h"
 #include "common/Executable.h"
 #include "libConsensus/Consensus.h"
+#include "libCrypto/PubKeyHash.h"
 #include "libData/BlockData/Block.h"
 #include "libData/BlockData/BlockHeader/BlockHashSet.h"
 #include "libData/MiningData/DSPowSolution.h"
@@ -40,6 +42,9 @@
 #include "libPersistence/BlockStorage.h"
 #include "libUtils/TimeUtils.h"
 
+#include "GasPriceHistory.h"
+#include "ShardingOrder.h"
+
 class Mediator;
 
 struct PoWSolution {
@@ -97,6 +102,8 @@ const int FINALBLOCK_REWARD = -1;
 const int LOOKUP_REWARD = -2;
 }  // namespace CoinbaseReward
 
+class ThreadPool;
+
 using VectorOfPoWSoln =
     std::vector<std::pair<std::array<unsigned char, 32>, PubKey>>;
 using MapOfPubKeyPoW = std::map<PubKey, PoWSolution>;
@@ -119,22 +126,32 @@ class DirectoryService : public Executable {
 
   // Temporary buffers for sharding committee members and transaction sharing
   DequeOfShard m_tempShards;
-  std::map<PubKey, uint32_t> m_tempPublicKeyToshardIdMap;
+  PubKeyHashMap<uint32_t> m_tempPublicKeyToshardIdMap;
   std::map<PubKey, uint16_t> m_tempMapNodeReputation;
 
   // PoW common variables
   std::mutex m_mutexAllPoWConns;
-  std::map<PubKey, Peer> m_allPoWConns;
+  PubKeyHashMap<Peer> m_allPoWConns;
 
   std::mutex m_mutexAllPoWCounter;
-  std::map<PubKey, uint8_t> m_AllPoWCounter;
+  PubKeyHashMap<uint8_t> m_AllPoWCounter;
 
   mutable std::mutex m_mutexAllPOW;
   MapOfPubKeyPoW m_allPoWs;  // map<pubkey, PoW Soln>
+  // Sort hashes of the results in m_allPoWs, worked out as the PoWs arrive
+  // so that the backups do not redo them when checking the PoW ordering
+  std::map<PubKey, std::pair<std::array<unsigned char, 32>, PoWSortHash>>
+      m_allPoWSortHashes;
+  bytes m_allPoWSortBlockHash;
 
   std::mutex m_mutexAllDSPOWs;
   MapOfPubKeyPoW m_allDSPoWs;  // map<pubkey, DS PoW Sol
 
+  // PoW submissions waiting for verification, by submitter key and nonce
+  std::unique_ptr<ThreadPool> m_powVerifyPool;
+  std::mutex m_mutexPoWVerifyQueued;
+  std::set<std::pair<PubKey, uint64_t>> m_powVerifyQueued;
+
   // Consensus variables
   std::shared_ptr<ConsensusCommon> m_consensusObject;
   bytes m_consensusBlockHash;
@@ -147,6 +164,13 @@ class DirectoryService : public Executable {
   // Final block consensus variables
   std::shared_ptr<TxBlock> m_finalBlock;
 
+  // Final blocks received ahead of their announcement
+  // (ENABLE_FINALBLOCK_PREDISTRIBUTION), keyed by block hash
+  std::map<BlockHash, std::pair<TxBlock, std::shared_ptr<MicroBlock>>>
+      m_proposedFinalBlocks;
+  std::mutex m_mutexProposedFinalBlocks;
+  std::condition_variable cv_proposedFinalBlock;
+
   struct MBSubmissionBufferEntry {
     MicroBlock m_microBlock;
     bytes m_stateDelta;
@@ -205,12 +229,21 @@ class DirectoryService : public Executable {
   // Map<EpochNumber, Map<shard-id, vector <Public keys to be rewarded>>
   std::map<uint64_t, std::map<int32_t, std::vector<PubKey>>>
       m_coinbaseRewardees;
+  // Number of cosigs of each node in m_coinbaseRewardees, lookups excluded
+  std::unordered_map<PubKey, uint32_t> m_coinbaseCosigCounts;
   std::mutex m_mutexCoinbaseRewardees;
 
   // DS Reputation
   // Map<Public Key, Number of Co-Sigs> observed from the coinbase rewards.
   std::map<PubKey, uint32_t> m_dsMemberPerformance;
   std::mutex m_mutexDsMemberPerformance;
+  // Byzantine nodes to be removed for the most winners, as found by a backup
+  // before the DS block arrives, and the epoch they were found in
+  std::vector<PubKey> m_expectedByzantineNodes;
+  uint64_t m_expectedByzantineNodesEpoch{0};
+
+  // Gas price
+  GasPriceHistory m_gasPriceHistory{GAS_CONGESTION_PERCENT};
 
   // pow solutions
   std::vector<DSPowSolution> m_powSolutions;
@@ -226,6 +259,10 @@ class DirectoryService : public Executable {
   bool ProcessPoWPacketSubmission(const bytes& message, unsigned int offset,
                                   const Peer& from);
   bool VerifyPoWSubmission(const DSPowSolution& sol);
+  // Verifies sol on the PoW verification threads and calls onVerified if it
+  // is valid. A solution already waiting for verification is dropped.
+  void QueuePoWSubmission(const DSPowSolution& sol,
+                          const std::function<void()>& onVerified = nullptr);
 
   bool ProcessDSBlockConsensus(const bytes& message, unsigned int offset,
                                const Peer& from);
@@ -235,6 +272,8 @@ class DirectoryService : public Executable {
                                   const Peer& from);
   bool ProcessFinalBlockConsensusCore(const bytes& message, unsigned int offset,
                                       const Peer& from);
+  bool ProcessFinalBlockProposal(const bytes& message, unsigned int offset,
+                                 const Peer& from);
   bool ProcessViewChangeConsensus(const bytes& message, unsigned int offset,
                                   const Peer& from);
   bool ProcessPushLatestDSBlock(const bytes& message, unsigned int offset,
@@ -300,14 +339,24 @@ class DirectoryService : public Executable {
                          const MapOfPubKeyPoW& priorityNodePoWs);
   bool VerifyPoWFromLeader(const Peer& peer, const PubKey& pubKey,
                            const PoWSolution& powSoln);
+  void PreVerifyPoWsFromLeader(
+      const DequeOfShard& shards, const MapOfPubKeyPoW& allPoWsFromLeader,
+      const std::map<PubKey, std::array<unsigned char, 32>>& sortedResults);
   bool VerifyNodePriority(const DequeOfShard& shards,
                           MapOfPubKeyPoW& priorityNodePoWs);
+  /// Gets the block hash the PoW results are sorted with for sharding
+  bytes GetShardingBlockHash() const;
+  /// Saves the sort hash of result, requires m_mutexAllPOW
+  void SavePoWSortHash(const PubKey& pubKey,
+                       const std::array<unsigned char, 32>& result);
 
   // DS Reputation
   void SaveDSPerformance();
   unsigned int DetermineByzantineNodes(
       unsigned int numOfProposedDSMembers,
       std::vector<PubKey>& removeDSNodePubkeys);
+  /// Finds the Byzantine nodes for the most winners ahead of the DS block
+  void PrecomputeByzantineNodes();
 
   // internal calls from RunConsensusOnDSBlock
   bool RunConsensusOnDSBlockWhenDSPrimary();
@@ -321,8 +370,8 @@ class DirectoryService : public Executable {
                                const DequeOfShard& shards,
                                const unsigned int& my_shards_lo,
                                const unsigned int& my_shards_hi);
-  void UpdateMyDSModeAndConsensusId();
-  void UpdateDSCommitteeComposition();
+  void UpdateMyDSModeAndConsensusId(const IndexOfNode& dsIndex);
+  void UpdateDSCommitteeComposition(IndexOfNode& dsIndex);
 
   void ProcessDSBlockConsensusWhenDone();
 
@@ -334,6 +383,8 @@ class DirectoryService : public Executable {
   // Final Block functions
   bool RunConsensusOnFinalBlockWhenDSBackup();
   bool ComposeFinalBlock();
+  bool SendFinalBlockProposal();
+  bool GetProposedFinalBlock(const bytes& txBlockHash);
   bool CheckWhetherDSBlockIsFresh(const uint64_t dsblock_num);
   void CommitMBSubmissionMsgBuffer();
   bool ProcessMicroblockSubmissionFromShard(
@@ -341,12 +392,31 @@ class DirectoryService : public Executable {
       const std::vector<bytes>& stateDelta);
   bool ProcessMicroblockSubmissionFromShardCore(const MicroBlock& microBlocks,
                                                 const bytes& stateDelta);
+  /// Checks a submission without holding the buffer or microblock locks, so
+  /// that several can be checked at once
+  bool VerifyMicroBlockSubmission(const MicroBlock& microBlock);
+  /// Applies the state delta of a verified submission and adds its
+  /// microblock, under m_mutexMicroBlocks
+  bool SaveMicroBlockSubmission(const MicroBlock& microBlock,
+                                const bytes& stateDelta);
+  /// The caller holds m_mutexMicroBlocks
+  bool HasMicroBlockFromShard(const uint32_t shardId);
   bool ProcessMissingMicroblockSubmission(
       const uint64_t epochNumber, const std::vector<MicroBlock>& microBlocks,
       const std::vector<bytes>& stateDeltas);
   void ExtractDataFromMicroblocks(std::vector<MicroBlockInfo>& mbInfos,
                                   uint64_t& allGasLimit, uint64_t& allGasUsed,
                                   uint128_t& allRewards, uint32_t& numTxs);
+  void SumMicroBlocks(const std::set<MicroBlock>& microBlocks,
+                      uint64_t& allGasLimit, uint64_t& allGasUsed,
+                      uint128_t& allRewards, uint32_t& numTxs);
+  /// Adds microBlock to the microblocks of epochNum and to their running
+  /// totals. The caller holds m_mutexMicroBlocks.
+  bool AddMicroBlock(const uint64_t epochNum, const MicroBlock& microBlock);
+  /// Removes the microblock at it from the microblocks of epochNum and from
+  /// their running totals. The caller holds m_mutexMicroBlocks.
+  void RemoveMicroBlock(const uint64_t epochNum,
+                        std::set<MicroBlock>::const_iterator it);
   bool VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
                                    uint32_t shardId);
   bool ProcessStateDelta(const bytes& stateDelta,
@@ -485,7 +555,7 @@ class DirectoryService : public Executable {
   // Sharding committee members
   std::mutex mutable m_mutexShards;
   DequeOfShard m_shards;
-  std::map<PubKey, uint32_t> m_publicKeyToshardIdMap;
+  PubKeyHashMap<uint32_t> m_publicKeyToshardIdMap;
 
   // Proof of Reputation(PoR) variables.
   std::map<PubKey, uint16_t> m_mapNodeReputation;
@@ -513,8 +583,23 @@ class DirectoryService : public Executable {
   std::mutex m_mutexPrepareRunFinalblockConsensus;
   std::atomic<bool> m_startedRunFinalblockConsensus{};
 
+  /// What the final block takes from the microblocks of an epoch, kept up
+  /// to date as each microblock is accepted. m_mbInfos follows the order of
+  /// m_microBlocks. Once a sum overflows, the sums are redone in that order
+  /// when the final block is composed, as the overflowing microblock is then
+  /// left out of them.
+  struct MicroBlockTotals {
+    std::vector<MicroBlockInfo> m_mbInfos;
+    uint64_t m_gasLimit{0};
+    uint64_t m_gasUsed{0};
+    uint128_t m_rewards{0};
+    uint32_t m_numTxs{0};
+    bool m_overflow{false};
+  };
+
   std::mutex m_mutexMicroBlocks;
   std::unordered_map<uint64_t, std::set<MicroBlock>> m_microBlocks;
+  std::unordered_map<uint64_t, MicroBlockTotals> m_microBlockTotals;
   std::unordered_map<uint64_t, std::vector<BlockHash>> m_missingMicroBlocks;
   std::unordered_map<uint64_t, std::unordered_map<BlockHash, bytes>>
       m_microBlockStateDeltas;
@@ -595,14 +680,14 @@ class DirectoryService : public Executable {
   void RunConsensusOnFinalBlock();
 
   // Coinbase
-  bool SaveCoinbase(const std::vector<bool>& b1, const std::vector<bool>& b2,
+  bool SaveCoinbase(const Bitmap& b1, const Bitmap& b2,
                     const int32_t& shard_id, const uint64_t& epochNum);
   void InitCoinbase();
   void StoreCoinbaseInDiagnosticDB(const DiagnosticDataCoinbase& entry);
 
   template <class Container>
-  bool SaveCoinbaseCore(const std::vector<bool>& b1,
-                        const std::vector<bool>& b2, const Container& shard,
+  bool SaveCoinbaseCore(const Bitmap& b1, const Bitmap& b2,
+                        const Container& shard,
                         const int32_t& shard_id, const uint64_t& epochNum);
 
   void GetCoinbaseRewardees(
@@ -615,7 +700,7 @@ class DirectoryService : public Executable {
   /// Used by PoW winner to configure sharding variables as the next DS leader
   bool ProcessShardingStructure(
       const DequeOfShard& shards,
-      std::map<PubKey, uint32_t>& publicKeyToshardIdMap,
+      PubKeyHashMap<uint32_t>& publicKeyToshardIdMap,
       std::map<PubKey, uint16_t>& mapNodeReputation);
 
   /// Used by PoW winner to finish setup as the next DS leader
@@ -649,6 +734,11 @@ class DirectoryService : public Executable {
   int64_t GetAllPoWSize() const;
 
   bool SendPoWPacketSubmissionToOtherDSComm();
+  /// Waits for PoW submissions for up to windowInSeconds. With
+  /// POW_EARLY_CLOSE_PERCENT set, returns true once that percent of the
+  /// nodes expected from the last sharding structure have been verified and
+  /// none came in for POW_EARLY_CLOSE_IDLE_IN_SECONDS.
+  bool WaitForPoWSubmissions(const unsigned int windowInSeconds);
 
   // Reset certain variables to the initial state
   bool CleanVariables();
@@ -686,6 +776,34 @@ class DirectoryService : public Executable {
   std::string GetActionString(Action action) const;
   bool ValidateViewChangeState(DirState NodeState, DirState StatePropose);
 
+  /// What the next view change needs, worked out while the consensus it
+  /// would replace is still running. Valid for the view change counter,
+  /// state, leader and latest block link it was worked out for.
+  struct StagedViewChange {
+    bool m_valid{false};
+    uint64_t m_epochNum{0};
+    uint64_t m_blockLinkIndex{0};
+    uint32_t m_vcCounter{0};
+    uint16_t m_leaderID{0};
+    DirState m_vcState{};
+    uint16_t m_candidateLeaderIndex{0};
+    CommitteeHash m_committeeHash;
+  };
+  std::mutex m_mutexStagedViewChange;
+  StagedViewChange m_stagedViewChange;
+
+  DirState GetLastKnownGoodState() const;
+  uint16_t CalculateNewLeaderIndex(const uint32_t vcCounter,
+                                   const DirState vcState);
+  bool CheckUseVCBlockInsteadOfDSBlock(const BlockLink& bl,
+                                       VCBlockSharedPtr& prevVCBlockptr,
+                                       const DirState vcState);
+  /// Stages the next view change, so that it can start right away if the
+  /// current consensus stalls
+  void StageViewChange();
+  /// Gets the staged view change if it is still valid
+  bool GetStagedViewChange(StagedViewChange& staged);
+
   void AddDSPoWs(const PubKey& Pubk, const PoWSolution& DSPOWSoln);
   MapOfPubKeyPoW GetAllDSPoWs();
   void ClearDSPoWSolns();
@@ -33,7 +33,9 @@
 #include "libNetwork/Guard.h"
 #include "libPersistence/ContractStorage2.h"
 #include "libUtils/DataConversion.h"
+#include "libUtils/DetachedExecutor.h"
 #include "libUtils/DetachedFunction.h"
+#include "libUtils/EpochPerf.h"
 #include "libUtils/Logger.h"
 #include "libUtils/SanityChecks.h"
 
@@ -50,6 +52,9 @@ bool DirectoryService::StoreFinalBlockToDisk() {
     return true;
   }
 
+  // The microblock, final block and state delta are written together
+  EpochCommit epochCommit;
+
   if (m_mediator.m_node->m_microblock != nullptr &&
       m_mediator.m_node->m_microblock->GetHeader().GetTxRootHash() !=
           TxnHash()) {
@@ -58,11 +63,8 @@ bool DirectoryService::StoreFinalBlockToDisk() {
                                       << *(m_mediator.m_node->m_microblock));
     bytes body;
     m_mediator.m_node->m_microblock->Serialize(body, 0);
-    if (!BlockStorage::GetBlockStorage().PutMicroBlock(
-            m_mediator.m_node->m_microblock->GetBlockHash(), body)) {
-      LOG_GENERAL(WARNING, "Failed to put microblock in persistence");
-      return false;
-    }
+    epochCommit.PutMicroBlock(m_mediator.m_node->m_microblock->GetBlockHash(),
+                              body);
   }
 
   // Add finalblock to txblockchain
@@ -80,18 +82,17 @@ bool DirectoryService::StoreFinalBlockToDisk() {
 
   bytes serializedTxBlock;
   m_finalBlock->Serialize(serializedTxBlock, 0);
-  if (!BlockStorage::GetBlockStorage().PutTxBlock(
-          m_finalBlock->GetHeader().GetBlockNum(), serializedTxBlock)) {
-    LOG_GENERAL(WARNING, "Failed to put microblock in persistence");
-    return false;
-  }
+  epochCommit.PutTxBlock(m_finalBlock->GetHeader().GetBlockNum(),
+                         serializedTxBlock);
 
   bytes stateDelta;
   AccountStore::GetInstance().GetSerializedDelta(stateDelta);
-  if (!BlockStorage::GetBlockStorage().PutStateDelta(
-          m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum(),
-          stateDelta)) {
-    LOG_GENERAL(WARNING, "Failed to put statedelta in persistence");
+  epochCommit.PutStateDelta(
+      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum(),
+      stateDelta);
+
+  if (!BlockStorage::GetBlockStorage().CommitEpoch(epochCommit)) {
+    LOG_GENERAL(WARNING, "Failed to put final block in persistence");
     return false;
   }
 
@@ -138,6 +139,11 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
 
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum, "Final block consensus DONE");
 
+  if (ENABLE_EPOCH_PERF) {
+    EpochPerf::GetInstance().End(EpochPerf::FINAL_BLOCK_CONSENSUS);
+    EpochPerf::GetInstance().AddTxns(m_finalBlock->GetHeader().GetNumTxs());
+  }
+
   // Clear microblock(s)
   // m_microBlocks.clear();
 
@@ -181,7 +187,10 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
   }
 
   if (isVacuousEpoch) {
-    auto writeStateToDisk = [this]() -> void {
+    const uint64_t stateBlockNum = m_finalBlock->GetHeader().GetBlockNum();
+    const StateHash blockStateRoot =
+        m_finalBlock->GetHeader().GetStateRootHash();
+    auto writeStateToDisk = [this, stateBlockNum, blockStateRoot]() -> void {
       if (!AccountStore::GetInstance().MoveUpdatesToDisk(
               ENABLE_REPOPULATE && (m_mediator.m_dsBlockChain.GetLastBlock()
                                             .GetHeader()
@@ -204,6 +213,8 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
                                    << " failed");
           return;
         }
+        AccountStore::GetInstance().PutStateRootCheckpoint(stateBlockNum,
+                                                           blockStateRoot);
         if (!BlockStorage::GetBlockStorage().PutEpochFin(
                 m_mediator.m_currentEpochNum)) {
           LOG_GENERAL(WARNING, "BlockStorage::PutEpochFin failed "
@@ -225,7 +236,8 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
         m_mediator.m_node->PopulateAccounts();
       }
     };
-    DetachedFunction(1, writeStateToDisk);
+    DetachedExecutor::GetInstance().Run(DetachedExecutor::PERSISTENCE_LANE,
+                                        writeStateToDisk);
   } else {
     // Coinbase
     SaveCoinbase(m_finalBlock->GetB1(), m_finalBlock->GetB2(),
@@ -32,6 +32,7 @@
 #include "libNetwork/P2PComm.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
+#include "libUtils/EpochPerf.h"
 #include "libUtils/Logger.h"
 #include "libUtils/RootComputation.h"
 #include "libUtils/SanityChecks.h"
@@ -40,36 +41,12 @@
 using namespace std;
 using namespace boost::multiprecision;
 
-void DirectoryService::ExtractDataFromMicroblocks(
-    vector<MicroBlockInfo>& mbInfos, uint64_t& allGasLimit,
-    uint64_t& allGasUsed, uint128_t& allRewards, uint32_t& numTxs) {
-  if (LOOKUP_NODE_MODE) {
-    LOG_GENERAL(WARNING,
-                "DirectoryService::ExtractDataFromMicroblocks not expected "
-                "to be called from LookUp node");
-    return;
-  }
-
-  LOG_MARKER();
-
-  unsigned int i = 1;
-
-  lock_guard<mutex> g(m_mutexMicroBlocks);
-
-  auto& microBlocks = m_microBlocks[m_mediator.m_currentEpochNum];
-
-  for (auto& microBlock : microBlocks) {
-    LOG_STATE("[STATS][" << std::setw(15) << std::left
-                         << m_mediator.m_selfPeer.GetPrintableIPAddress()
-                         << "][" << i << "    ]["
-                         << microBlock.GetHeader().GetNumTxs() << "] PROPOSED");
-
-    i++;
-
-    LOG_GENERAL(INFO, "Pushback microblock shard ID: "
-                          << microBlock.GetHeader().GetShardId() << endl
-                          << "hash: " << microBlock.GetHeader().GetHashes());
-
+void DirectoryService::SumMicroBlocks(const set<MicroBlock>& microBlocks,
+                                      uint64_t& allGasLimit,
+                                      uint64_t& allGasUsed,
+                                      uint128_t& allRewards,
+                                      uint32_t& numTxs) {
+  for (const auto& microBlock : microBlocks) {
     uint64_t tmpGasLimit = allGasLimit, tmpGasUsed = allGasUsed;
     uint128_t tmpRewards = allRewards;
 
@@ -95,11 +72,37 @@ void DirectoryService::ExtractDataFromMicroblocks(
     }
 
     numTxs += microBlock.GetHeader().GetNumTxs();
+  }
+}
 
-    mbInfos.push_back({microBlock.GetBlockHash(),
-                       microBlock.GetHeader().GetTxRootHash(),
-                       microBlock.GetHeader().GetShardId()});
+void DirectoryService::ExtractDataFromMicroblocks(
+    vector<MicroBlockInfo>& mbInfos, uint64_t& allGasLimit,
+    uint64_t& allGasUsed, uint128_t& allRewards, uint32_t& numTxs) {
+  if (LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "DirectoryService::ExtractDataFromMicroblocks not expected "
+                "to be called from LookUp node");
+    return;
   }
+
+  LOG_MARKER();
+
+  lock_guard<mutex> g(m_mutexMicroBlocks);
+
+  // The totals were gathered as the microblocks came in
+  const auto& totals = m_microBlockTotals[m_mediator.m_currentEpochNum];
+  mbInfos = totals.m_mbInfos;
+
+  if (!totals.m_overflow) {
+    allGasLimit = totals.m_gasLimit;
+    allGasUsed = totals.m_gasUsed;
+    allRewards = totals.m_rewards;
+    numTxs = totals.m_numTxs;
+    return;
+  }
+
+  SumMicroBlocks(m_microBlocks[m_mediator.m_currentEpochNum], allGasLimit,
+                 allGasUsed, allRewards, numTxs);
 }
 
 bool DirectoryService::ComposeFinalBlock() {
@@ -226,8 +229,9 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSPrimary() {
     LOG_GENERAL(WARNING, "DS ComposeMicroBlock Failed");
     m_mediator.m_node->m_microblock = nullptr;
   } else {
-    m_microBlocks[m_mediator.m_currentEpochNum].emplace(
-        *(m_mediator.m_node->m_microblock));
+    lock_guard<mutex> g(m_mutexMicroBlocks);
+    AddMicroBlock(m_mediator.m_currentEpochNum,
+                  *(m_mediator.m_node->m_microblock));
   }
 
   // stores it in m_finalBlock
@@ -237,6 +241,11 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSPrimary() {
     return false;
   }
 
+  // Start moving the block body while the consensus object is being set up;
+  // the announcement will then only carry the block hash
+  const bool proposalSent =
+      ENABLE_FINALBLOCK_PREDISTRIBUTION && SendFinalBlockProposal();
+
 #ifdef VC_TEST_FB_SUSPEND_1
   if (m_mode == PRIMARY_DS && m_viewChangeCounter < 1) {
     LOG_EPOCH(
@@ -290,13 +299,15 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSPrimary() {
   }
 
   auto announcementGeneratorFunc =
-      [this](bytes& dst, unsigned int offset, const uint32_t consensusID,
-             const uint64_t blockNumber, const bytes& blockHash,
-             const uint16_t leaderID, const PairOfKey& leaderKey,
-             bytes& messageToCosign) mutable -> bool {
+      [this, proposalSent](bytes& dst, unsigned int offset,
+                           const uint32_t consensusID,
+                           const uint64_t blockNumber, const bytes& blockHash,
+                           const uint16_t leaderID, const PairOfKey& leaderKey,
+                           bytes& messageToCosign) mutable -> bool {
     return Messenger::SetDSFinalBlockAnnouncement(
         dst, offset, consensusID, blockNumber, blockHash, leaderID, leaderKey,
-        *m_finalBlock, m_mediator.m_node->m_microblock, messageToCosign);
+        *m_finalBlock, m_mediator.m_node->m_microblock, messageToCosign,
+        proposalSent);
   };
 
   cl->StartConsensus(announcementGeneratorFunc, BROADCAST_GOSSIP_MODE);
@@ -304,6 +315,130 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSPrimary() {
   return true;
 }
 
+bool DirectoryService::SendFinalBlockProposal() {
+  LOG_MARKER();
+
+  bytes proposal = {MessageType::DIRECTORY,
+                    DSInstructionType::FINALBLOCKPROPOSAL};
+
+  if (!Messenger::SetDSFinalBlockProposal(
+          proposal, MessageOffset::BODY,
+          m_finalBlock->GetHeader().GetBlockNum(), *m_finalBlock,
+          m_mediator.m_node->m_microblock, m_mediator.m_selfKey)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Messenger::SetDSFinalBlockProposal failed");
+    return false;
+  }
+
+  if (BROADCAST_GOSSIP_MODE) {
+    P2PComm::GetInstance().SpreadRumor(proposal);
+  } else {
+    vector<Peer> peerList;
+    for (auto const& i : *m_mediator.m_DSCommittee) {
+      peerList.push_back(i.second);
+    }
+    P2PComm::GetInstance().SendMessage(peerList, proposal);
+  }
+
+  return true;
+}
+
+bool DirectoryService::ProcessFinalBlockProposal(
+    const bytes& message, unsigned int offset,
+    [[gnu::unused]] const Peer& from) {
+  if (LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "DirectoryService::ProcessFinalBlockProposal not expected to "
+                "be called from LookUp node");
+    return true;
+  }
+
+  if (!ENABLE_FINALBLOCK_PREDISTRIBUTION) {
+    LOG_GENERAL(WARNING, "Final block predistribution not enabled");
+    return false;
+  }
+
+  LOG_MARKER();
+
+  uint64_t blockNumber = 0;
+  TxBlock txBlock;
+  shared_ptr<MicroBlock> microBlock;
+  PubKey leaderKey;
+
+  if (!Messenger::GetDSFinalBlockProposal(message, offset, blockNumber,
+                                          txBlock, microBlock, leaderKey)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Messenger::GetDSFinalBlockProposal failed");
+    return false;
+  }
+
+  {
+    lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
+    if (GetConsensusLeaderID() >= m_mediator.m_DSCommittee->size() ||
+        leaderKey !=
+            m_mediator.m_DSCommittee->at(GetConsensusLeaderID()).first) {
+      LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+                "Final block proposal not sent by the DS leader");
+      return false;
+    }
+  }
+
+  const uint64_t expectedBlockNum =
+      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+  if ((blockNumber != expectedBlockNum) ||
+      (txBlock.GetHeader().GetBlockNum() != blockNumber)) {
+    LOG_CHECK_FAIL("Proposed block number", blockNumber, expectedBlockNum);
+    return false;
+  }
+
+  {
+    lock_guard<mutex> g(m_mutexProposedFinalBlocks);
+    // Proposals for earlier blocks can no longer be announced
+    for (auto it = m_proposedFinalBlocks.begin();
+         it != m_proposedFinalBlocks.end();) {
+      if (it->second.first.GetHeader().GetBlockNum() < blockNumber) {
+        it = m_proposedFinalBlocks.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    m_proposedFinalBlocks[txBlock.GetBlockHash()] =
+        make_pair(txBlock, microBlock);
+  }
+  cv_proposedFinalBlock.notify_all();
+
+  LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+            "Received proposal for final block " << blockNumber);
+  return true;
+}
+
+bool DirectoryService::GetProposedFinalBlock(const bytes& txBlockHash) {
+  if (txBlockHash.size() != BLOCK_HASH_SIZE) {
+    LOG_CHECK_FAIL("Block hash size", txBlockHash.size(), BLOCK_HASH_SIZE);
+    return false;
+  }
+
+  const BlockHash hash(txBlockHash);
+
+  // The announcement may overtake the proposal
+  unique_lock<mutex> lock(m_mutexProposedFinalBlocks);
+  if (!cv_proposedFinalBlock.wait_for(
+          lock, chrono::milliseconds(FINALBLOCK_PROPOSAL_WAIT_IN_MS),
+          [this, &hash] {
+            return m_proposedFinalBlocks.find(hash) !=
+                   m_proposedFinalBlocks.end();
+          })) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Proposed final block " << hash << " not received");
+    return false;
+  }
+
+  const auto& proposal = m_proposedFinalBlocks.at(hash);
+  *m_finalBlock = proposal.first;
+  m_mediator.m_node->m_microblock = proposal.second;
+  return true;
+}
+
 // Check version (must be most current version)
 bool DirectoryService::CheckFinalBlockVersion() {
   if (LOOKUP_NODE_MODE) {
@@ -490,35 +625,18 @@ bool DirectoryService::CheckLegitimacyOfMicroBlocks() {
   {
     lock_guard<mutex> g(m_mutexMicroBlocks);
 
-    auto& microBlocks = m_microBlocks[m_mediator.m_currentEpochNum];
-    for (auto& microBlock : microBlocks) {
-      uint64_t tmpGasLimit = allGasLimit, tmpGasUsed = allGasUsed;
-      uint128_t tmpRewards = allRewards;
-
-      bool flag = true;
-      if (!SafeMath<uint64_t>::add(
-              allGasLimit, microBlock.GetHeader().GetGasLimit(), allGasLimit)) {
-        flag = false;
-      }
-      if (flag &&
-          !SafeMath<uint64_t>::add(
-              allGasUsed, microBlock.GetHeader().GetGasUsed(), allGasUsed)) {
-        flag = false;
-      }
-      if (flag &&
-          !SafeMath<uint128_t>::add(
-              allRewards, microBlock.GetHeader().GetRewards(), allRewards)) {
-        flag = false;
-      }
-      if (!flag) {
-        allGasLimit = tmpGasLimit;
-        allGasUsed = tmpGasUsed;
-        allRewards = tmpRewards;
-      }
-
-      allNumTxns += microBlock.GetHeader().GetNumTxs();
-      ++allNumMicroBlockHashes;
+    const auto& microBlocks = m_microBlocks[m_mediator.m_currentEpochNum];
+    const auto& totals = m_microBlockTotals[m_mediator.m_currentEpochNum];
+    if (!totals.m_overflow) {
+      allGasLimit = totals.m_gasLimit;
+      allGasUsed = totals.m_gasUsed;
+      allRewards = totals.m_rewards;
+      allNumTxns = totals.m_numTxs;
+    } else {
+      SumMicroBlocks(microBlocks, allGasLimit, allGasUsed, allRewards,
+                     allNumTxns);
     }
+    allNumMicroBlockHashes = microBlocks.size();
   }
 
   bool ret = true;
@@ -924,8 +1042,9 @@ bool DirectoryService::CheckMicroBlockValidity(bytes& errorMsg) {
   if (!ret) {
     m_mediator.m_node->m_microblock = nullptr;
   } else {
-    m_microBlocks[m_mediator.m_currentEpochNum].emplace(
-        *(m_mediator.m_node->m_microblock));
+    lock_guard<mutex> g(m_mutexMicroBlocks);
+    AddMicroBlock(m_mediator.m_currentEpochNum,
+                  *(m_mediator.m_node->m_microblock));
   }
 
   return ret;
@@ -949,16 +1068,31 @@ bool DirectoryService::FinalBlockValidator(
 
   m_mediator.m_node->m_microblock.reset(new MicroBlock());
 
+  bytes txBlockHash;
   if (!Messenger::GetDSFinalBlockAnnouncement(
           message, offset, consensusID, blockNumber, blockHash, leaderID,
           leaderKey, *m_finalBlock, m_mediator.m_node->m_microblock,
-          messageToCosign)) {
+          messageToCosign, txBlockHash)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::GetDSFinalBlockAnnouncement failed");
     m_mediator.m_node->m_microblock = nullptr;
     return false;
   }
 
+  if (!txBlockHash.empty()) {
+    // Announcement only has the hash, the block was sent ahead of it
+    if (!GetProposedFinalBlock(txBlockHash)) {
+      m_mediator.m_node->m_microblock = nullptr;
+      return false;
+    }
+
+    messageToCosign.clear();
+    if (!m_finalBlock->GetHeader().Serialize(messageToCosign, 0)) {
+      LOG_GENERAL(WARNING, "TxBlockHeader serialization failed");
+      return false;
+    }
+  }
+
   bytes t_errorMsg;
   if (CheckMicroBlocks(t_errorMsg, true,
                        false)) {  // Firstly check whether the leader
@@ -1184,6 +1318,10 @@ void DirectoryService::RunConsensusOnFinalBlock() {
       SetState(FINALBLOCK_CONSENSUS_PREP);
     }
 
+    if (ENABLE_EPOCH_PERF) {
+      EpochPerf::GetInstance().Begin(EpochPerf::FINAL_BLOCK_CONSENSUS);
+    }
+
     m_mediator.m_node->m_txn_distribute_window_open = true;
 
     m_mediator.m_node->PrepareGoodStateForFinalBlock();
@@ -1231,6 +1369,7 @@ void DirectoryService::RunConsensusOnFinalBlock() {
   auto func1 = [this]() -> void {
     // View change will wait for timeout. If conditional variable is notified
     // before timeout, the thread will return without triggering view change.
+    StageViewChange();
     std::unique_lock<std::mutex> cv_lk(m_MutexCVViewChangeFinalBlock);
     if (cv_viewChangeFinalBlock.wait_for(
             cv_lk, std::chrono::seconds(VIEWCHANGE_TIME)) ==
@@ -1270,7 +1409,7 @@ void DirectoryService::RemoveDSMicroBlock() {
                       });
   if (dsmb != microBlocksAtEpoch.end()) {
     LOG_GENERAL(INFO, "Removed DS microblock from list of microblocks");
-    microBlocksAtEpoch.erase(dsmb);
+    RemoveMicroBlock(m_mediator.m_currentEpochNum, dsmb);
   }
 
   m_mediator.m_node->m_microblock = nullptr;
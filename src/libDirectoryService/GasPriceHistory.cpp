@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "GasPriceHistory.h"
+#include "libUtils/SafeMath.h"
+
+using namespace std;
+
+void GasPriceHistory::GetCongestion(const uint64_t loBlockNum,
+                                    const uint64_t hiBlockNum,
+                                    const TxBlockGasGetter& getTxBlockGas,
+                                    uint64_t& fullBlockNum,
+                                    uint64_t& totalBlockNum) {
+  lock_guard<mutex> g(m_mutexTxBlocks);
+
+  if (loBlockNum != m_txLoBlockNum || hiBlockNum + 1 < m_txNextBlockNum ||
+      m_txNextBlockNum < loBlockNum) {
+    m_txLoBlockNum = loBlockNum;
+    m_txNextBlockNum = loBlockNum;
+    m_fullBlockNum = 0;
+    m_totalBlockNum = 0;
+  }
+
+  for (; m_txNextBlockNum <= hiBlockNum; ++m_txNextBlockNum) {
+    const auto gas = getTxBlockGas(m_txNextBlockNum);
+    if (gas.first >= gas.second * m_congestionPercent / 100) {
+      m_fullBlockNum++;
+    }
+    m_totalBlockNum++;
+  }
+
+  fullBlockNum = m_fullBlockNum;
+  totalBlockNum = m_totalBlockNum;
+}
+
+bool GasPriceHistory::GetMeanGasPrice(
+    const uint64_t curDSBlockNum, const uint64_t windowSize,
+    const DSBlockGasPriceGetter& getDSGasPrice, uint128_t& meanGasPrice) {
+  lock_guard<mutex> g(m_mutexDSBlocks);
+
+  // Block 0 is never counted
+  const uint64_t lowDSBlockNum =
+      max<uint64_t>(curDSBlockNum > windowSize ? curDSBlockNum - windowSize : 0,
+                    1);
+
+  if (curDSBlockNum + 1 < m_dsNextBlockNum) {
+    m_dsNextBlockNum = 0;
+    m_dsGasPrices.clear();
+    m_dsGasPriceSum = 0;
+  }
+
+  while (!m_dsGasPrices.empty() &&
+         m_dsGasPrices.front().first < lowDSBlockNum) {
+    m_dsGasPriceSum -= m_dsGasPrices.front().second;
+    m_dsGasPrices.pop_front();
+  }
+
+  for (m_dsNextBlockNum = max(m_dsNextBlockNum, lowDSBlockNum);
+       m_dsNextBlockNum <= curDSBlockNum; ++m_dsNextBlockNum) {
+    const uint128_t gasPrice = getDSGasPrice(m_dsNextBlockNum);
+    uint128_t sum;
+    if (!SafeMath<uint128_t>::add(m_dsGasPriceSum, gasPrice, sum)) {
+      continue;
+    }
+    m_dsGasPriceSum = sum;
+    m_dsGasPrices.emplace_back(m_dsNextBlockNum, gasPrice);
+  }
+
+  return SafeMath<uint128_t>::div(m_dsGasPriceSum, m_dsGasPrices.size(),
+                                  meanGasPrice);
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDIRECTORYSERVICE_GASPRICEHISTORY_H_
+#define ZILLIQA_SRC_LIBDIRECTORYSERVICE_GASPRICEHISTORY_H_
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+#include "common/BaseType.h"
+
+/// Running totals over the blocks the gas price is worked out from. A window
+/// that moves forward from the last one only reads the blocks it gained, so
+/// every block is read once; any other window is read again in full.
+class GasPriceHistory {
+ public:
+  /// Gets the gas used and the gas limit of a tx block
+  using TxBlockGasGetter =
+      std::function<std::pair<uint128_t, uint128_t>(const uint64_t blockNum)>;
+  /// Gets the gas price of a DS block
+  using DSBlockGasPriceGetter =
+      std::function<uint128_t(const uint64_t blockNum)>;
+
+  explicit GasPriceHistory(const unsigned int congestionPercent)
+      : m_congestionPercent(congestionPercent) {}
+
+  /// Counts the tx blocks from loBlockNum to hiBlockNum, and those of them
+  /// whose gas used is at least the congestion percent of their gas limit
+  void GetCongestion(const uint64_t loBlockNum, const uint64_t hiBlockNum,
+                     const TxBlockGasGetter& getTxBlockGas,
+                     uint64_t& fullBlockNum, uint64_t& totalBlockNum);
+
+  /// Gets the mean gas price of DS blocks curDSBlockNum - windowSize to
+  /// curDSBlockNum, block 0 excluded. Returns false if there is none.
+  bool GetMeanGasPrice(const uint64_t curDSBlockNum, const uint64_t windowSize,
+                       const DSBlockGasPriceGetter& getDSGasPrice,
+                       uint128_t& meanGasPrice);
+
+ private:
+  const unsigned int m_congestionPercent;
+
+  std::mutex m_mutexTxBlocks;
+  uint64_t m_txLoBlockNum{0};
+  uint64_t m_txNextBlockNum{0};
+  uint64_t m_fullBlockNum{0};
+  uint64_t m_totalBlockNum{0};
+
+  std::mutex m_mutexDSBlocks;
+  uint64_t m_dsNextBlockNum{0};
+  std::deque<std::pair<uint64_t, uint128_t>> m_dsGasPrices;
+  uint128_t m_dsGasPriceSum{0};
+};
+
+#endif  // ZILLIQA_SRC_LIBDIRECTORYSERVICE_GASPRICEHISTORY_H_
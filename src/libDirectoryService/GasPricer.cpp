@@ -32,16 +32,14 @@ uint128_t DirectoryService::GetNewGasPrice() {
   uint64_t totalBlockNum = 0;
   uint64_t fullBlockNum = 0;
 
-  for (uint64_t i = loBlockNum; i <= hiBlockNum; ++i) {
-    uint128_t gasUsed =
-        m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetGasUsed();
-    uint128_t gasLimit =
-        m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetGasLimit();
-    if (gasUsed >= gasLimit * GAS_CONGESTION_PERCENT / 100) {
-      fullBlockNum++;
-    }
-    totalBlockNum++;
-  }
+  m_gasPriceHistory.GetCongestion(
+      loBlockNum, hiBlockNum,
+      [this](const uint64_t blockNum) {
+        const auto txBlock = m_mediator.m_txBlockChain.GetBlockPtr(blockNum);
+        return pair<uint128_t, uint128_t>(txBlock->GetHeader().GetGasUsed(),
+                                          txBlock->GetHeader().GetGasLimit());
+      },
+      fullBlockNum, totalBlockNum);
 
   if (fullBlockNum < totalBlockNum * UNFILLED_PERCENT_LOW / 100) {
     return GetDecreasedGasPrice();
@@ -55,25 +53,15 @@ uint128_t DirectoryService::GetNewGasPrice() {
 uint128_t DirectoryService::GetHistoricalMeanGasPrice() {
   uint64_t curDSBlockNum =
       m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
-  uint64_t lowDSBlockNum = (curDSBlockNum > MEAN_GAS_PRICE_DS_NUM)
-                               ? (curDSBlockNum - MEAN_GAS_PRICE_DS_NUM)
-                               : 0;
-  uint64_t totalBlockNum = 0;
-  uint128_t totalGasPrice = 0;
-  for (uint64_t i = curDSBlockNum; i >= lowDSBlockNum; --i) {
-    if (i == 0) {
-      break;
-    }
-    if (!SafeMath<uint128_t>::add(
-            totalGasPrice,
-            m_mediator.m_dsBlockChain.GetBlock(i).GetHeader().GetGasPrice(),
-            totalGasPrice)) {
-      continue;
-    }
-    totalBlockNum++;
-  }
   uint128_t ret;
-  if (!SafeMath<uint128_t>::div(totalGasPrice, totalBlockNum, ret)) {
+  if (!m_gasPriceHistory.GetMeanGasPrice(
+          curDSBlockNum, MEAN_GAS_PRICE_DS_NUM,
+          [this](const uint64_t blockNum) {
+            return m_mediator.m_dsBlockChain.GetBlockPtr(blockNum)
+                ->GetHeader()
+                .GetGasPrice();
+          },
+          ret)) {
     return m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetGasPrice();
   }
   return ret;
@@ -26,6 +26,7 @@
 #include "depends/common/RLP.h"
 #include "depends/libTrie/TrieDB.h"
 #include "depends/libTrie/TrieHash.h"
+#include "libConsensus/AggregatedPubKeyCache.h"
 #include "libCrypto/Sha2.h"
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
@@ -34,6 +35,8 @@
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
+#include "libUtils/OrderedPipeline.h"
+#include "libUtils/SafeMath.h"
 #include "libUtils/SanityChecks.h"
 #include "libUtils/TimestampVerifier.h"
 
@@ -51,7 +54,7 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
 
   LOG_MARKER();
 
-  const vector<bool>& B2 = microBlock.GetB2();
+  const Bitmap& B2 = microBlock.GetB2();
   vector<PubKey> keys;
   unsigned int index = 0;
   unsigned int count = 0;
@@ -65,8 +68,8 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
     }
 
     for (const auto& ds : *m_mediator.m_DSCommittee) {
+      keys.emplace_back(ds.first);
       if (B2.at(index)) {
-        keys.emplace_back(ds.first);
         count++;
       }
       index++;
@@ -83,8 +86,8 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
 
     // Generate the aggregated key
     for (const auto& kv : shard) {
+      keys.emplace_back(std::get<SHARD_NODE_PUBKEY>(kv));
       if (B2.at(index)) {
-        keys.emplace_back(std::get<SHARD_NODE_PUBKEY>(kv));
         count++;
       }
       index++;
@@ -96,7 +99,8 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
     return false;
   }
 
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<PubKey> aggregatedKey =
+      AggregatedPubKeyCache::GetInstance().AggregatePubKeys(keys, B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return false;
@@ -195,6 +199,78 @@ bool DirectoryService::ProcessStateDelta(
   return true;
 }
 
+bool DirectoryService::AddMicroBlock(const uint64_t epochNum,
+                                     const MicroBlock& microBlock) {
+  auto& microBlocksAtEpoch = m_microBlocks[epochNum];
+  const auto inserted = microBlocksAtEpoch.emplace(microBlock);
+  if (!inserted.second) {
+    return false;
+  }
+
+  const auto& header = microBlock.GetHeader();
+  auto& totals = m_microBlockTotals[epochNum];
+  const auto pos = distance(microBlocksAtEpoch.begin(), inserted.first);
+  totals.m_mbInfos.insert(
+      totals.m_mbInfos.begin() + pos,
+      {microBlock.GetBlockHash(), header.GetTxRootHash(), header.GetShardId()});
+
+  if (!totals.m_overflow &&
+      (!SafeMath<uint64_t>::add(totals.m_gasLimit, header.GetGasLimit(),
+                                totals.m_gasLimit) ||
+       !SafeMath<uint64_t>::add(totals.m_gasUsed, header.GetGasUsed(),
+                                totals.m_gasUsed) ||
+       !SafeMath<uint128_t>::add(totals.m_rewards, header.GetRewards(),
+                                 totals.m_rewards))) {
+    LOG_GENERAL(WARNING, "Microblock totals overflow at shard "
+                             << header.GetShardId());
+    totals.m_overflow = true;
+  }
+  totals.m_numTxs += header.GetNumTxs();
+
+  LOG_STATE("[STATS][" << std::setw(15) << std::left
+                       << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
+                       << pos + 1 << "    ][" << header.GetNumTxs()
+                       << "] PROPOSED");
+  LOG_GENERAL(INFO, "Pushback microblock shard ID: "
+                        << header.GetShardId() << endl
+                        << "hash: " << header.GetHashes());
+
+  return true;
+}
+
+void DirectoryService::RemoveMicroBlock(const uint64_t epochNum,
+                                        set<MicroBlock>::const_iterator it) {
+  auto& microBlocksAtEpoch = m_microBlocks[epochNum];
+  auto& totals = m_microBlockTotals[epochNum];
+  const auto pos = distance(microBlocksAtEpoch.cbegin(), it);
+  if (static_cast<size_t>(pos) < totals.m_mbInfos.size()) {
+    totals.m_mbInfos.erase(totals.m_mbInfos.begin() + pos);
+  }
+
+  // The sums hold every microblock unless they overflowed
+  const auto& header = it->GetHeader();
+  if (!totals.m_overflow) {
+    totals.m_gasLimit -= header.GetGasLimit();
+    totals.m_gasUsed -= header.GetGasUsed();
+    totals.m_rewards -= header.GetRewards();
+  }
+  totals.m_numTxs -= header.GetNumTxs();
+
+  microBlocksAtEpoch.erase(it);
+}
+
+bool DirectoryService::HasMicroBlockFromShard(const uint32_t shardId) {
+  const auto& microBlocksAtEpoch = m_microBlocks[m_mediator.m_currentEpochNum];
+  if (find_if(microBlocksAtEpoch.begin(), microBlocksAtEpoch.end(),
+              [shardId](const MicroBlock& mb) -> bool {
+                return mb.GetHeader().GetShardId() == shardId;
+              }) != microBlocksAtEpoch.end()) {
+    LOG_GENERAL(WARNING, "Duplicate microblock received for shard " << shardId);
+    return true;
+  }
+  return false;
+}
+
 bool DirectoryService::ProcessMicroblockSubmissionFromShardCore(
     const MicroBlock& microBlock, const bytes& stateDelta) {
   if (LOOKUP_NODE_MODE) {
@@ -204,19 +280,18 @@ bool DirectoryService::ProcessMicroblockSubmissionFromShardCore(
     return true;
   }
 
+  return VerifyMicroBlockSubmission(microBlock) &&
+         SaveMicroBlockSubmission(microBlock, stateDelta);
+}
+
+bool DirectoryService::VerifyMicroBlockSubmission(
+    const MicroBlock& microBlock) {
   uint32_t shardId = microBlock.GetHeader().GetShardId();
   {
-    lock_guard<mutex> g(m_mutexMicroBlocks);
-    auto& microBlocksAtEpoch = m_microBlocks[m_mediator.m_currentEpochNum];
-
     // Check if we already received a validated microblock with the same shard
     // id. Save on unnecessary-validation.
-    if (find_if(microBlocksAtEpoch.begin(), microBlocksAtEpoch.end(),
-                [shardId](const MicroBlock& mb) -> bool {
-                  return mb.GetHeader().GetShardId() == shardId;
-                }) != microBlocksAtEpoch.end()) {
-      LOG_GENERAL(WARNING,
-                  "Duplicate microblock received for shard " << shardId);
+    lock_guard<mutex> g(m_mutexMicroBlocks);
+    if (HasMicroBlockFromShard(shardId)) {
       return false;
     }
   }
@@ -296,6 +371,11 @@ bool DirectoryService::ProcessMicroblockSubmissionFromShardCore(
                         << endl
                         << microBlock.GetHeader().GetHashes());
 
+  return true;
+}
+
+bool DirectoryService::SaveMicroBlockSubmission(const MicroBlock& microBlock,
+                                                const bytes& stateDelta) {
   lock_guard<mutex> g(m_mutexMicroBlocks);
 
   if (m_stopRecvNewMBSubmission) {
@@ -305,6 +385,11 @@ bool DirectoryService::ProcessMicroblockSubmissionFromShardCore(
     return false;
   }
 
+  // Another submission from the shard may have been verified meanwhile
+  if (HasMicroBlockFromShard(microBlock.GetHeader().GetShardId())) {
+    return false;
+  }
+
   if (microBlock.GetHeader().GetShardId() != m_shards.size() &&
       !SaveCoinbase(microBlock.GetB1(), microBlock.GetB2(),
                     microBlock.GetHeader().GetShardId(),
@@ -329,8 +414,8 @@ bool DirectoryService::ProcessMicroblockSubmissionFromShardCore(
     }
   }
 
-  auto& microBlocksAtEpoch = m_microBlocks[m_mediator.m_currentEpochNum];
-  microBlocksAtEpoch.emplace(microBlock);
+  AddMicroBlock(m_mediator.m_currentEpochNum, microBlock);
+  const auto& microBlocksAtEpoch = m_microBlocks[m_mediator.m_currentEpochNum];
 
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
             microBlocksAtEpoch.size()
@@ -365,23 +450,47 @@ bool DirectoryService::ProcessMicroblockSubmissionFromShardCore(
 void DirectoryService::CommitMBSubmissionMsgBuffer() {
   LOG_MARKER();
 
-  lock_guard<mutex> g(m_mutexMBSubmissionBuffer);
+  vector<MBSubmissionBufferEntry> entries;
+  {
+    lock_guard<mutex> g(m_mutexMBSubmissionBuffer);
 
-  for (auto it = m_MBSubmissionBuffer.begin();
-       it != m_MBSubmissionBuffer.end();) {
-    if (it->first < m_mediator.m_currentEpochNum) {
-      it = m_MBSubmissionBuffer.erase(it);
-    } else if (it->first == m_mediator.m_currentEpochNum) {
-      for (const auto& entry : it->second) {
-        ProcessMicroblockSubmissionFromShardCore(entry.m_microBlock,
-                                                 entry.m_stateDelta);
+    for (auto it = m_MBSubmissionBuffer.begin();
+         it != m_MBSubmissionBuffer.end();) {
+      if (it->first < m_mediator.m_currentEpochNum) {
+        it = m_MBSubmissionBuffer.erase(it);
+      } else if (it->first == m_mediator.m_currentEpochNum) {
+        entries = move(it->second);
+        m_MBSubmissionBuffer.erase(it);
+        break;
+      } else {
+        it++;
       }
-      m_MBSubmissionBuffer.erase(it);
-      break;
-    } else {
-      it++;
     }
   }
+
+  if (entries.empty()) {
+    return;
+  }
+
+  // The submissions are verified side by side and saved one at a time, as
+  // saving applies their state deltas
+  const auto numThreads = static_cast<unsigned int>(
+      min<size_t>(MICROBLOCK_VERIFY_THREADS, entries.size()));
+  size_t saved = 0;
+  RunOrderedPipeline<bool>(
+      "VerifyMBSubmissions", entries.size(), numThreads, entries.size(),
+      [this, &entries](size_t i, bool& verified) {
+        verified = VerifyMicroBlockSubmission(entries.at(i).m_microBlock);
+        return true;
+      },
+      [this, &entries](size_t i, bool& verified) {
+        if (verified) {
+          SaveMicroBlockSubmission(entries.at(i).m_microBlock,
+                                   entries.at(i).m_stateDelta);
+        }
+        return true;
+      },
+      saved);
 }
 
 bool DirectoryService::ProcessMicroblockSubmissionFromShard(
@@ -667,7 +776,7 @@ bool DirectoryService::ProcessMissingMicroblockSubmission(
         return false;
       }
 
-      microBlocksAtEpoch.emplace(microBlocks.at(i));
+      AddMicroBlock(epochNumber, microBlocks.at(i));
       // m_fetchedMicroBlocks.emplace(microBlock);
 
       LOG_GENERAL(INFO, microBlocksAtEpoch.size()
@@ -36,6 +36,8 @@
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
 #include "libUtils/SanityChecks.h"
+#include "libUtils/ShardSizeCalculator.h"
+#include "libUtils/ThreadPool.h"
 
 using namespace std;
 using namespace boost::multiprecision;
@@ -83,6 +85,60 @@ bool DirectoryService::SendPoWPacketSubmissionToOtherDSComm() {
   return true;
 }
 
+bool DirectoryService::WaitForPoWSubmissions(
+    const unsigned int windowInSeconds) {
+  if (POW_EARLY_CLOSE_PERCENT == 0) {
+    this_thread::sleep_for(chrono::seconds(windowInSeconds));
+    return false;
+  }
+
+  // The nodes of the last sharding structure are expected to come back
+  uint32_t numShardNodes = 0;
+  {
+    lock_guard<mutex> g(m_mutexShards);
+    for (const auto& shard : m_shards) {
+      numShardNodes += shard.size();
+    }
+  }
+  const uint32_t numExpected = ShardSizeCalculator::GetTrimmedShardCount(
+      m_mediator.GetShardSize(false), SHARD_SIZE_TOLERANCE_LO,
+      SHARD_SIZE_TOLERANCE_HI, numShardNodes);
+  const uint64_t target =
+      (static_cast<uint64_t>(numExpected) * POW_EARLY_CLOSE_PERCENT + 99) / 100;
+
+  const auto startTime = chrono::steady_clock::now();
+  const auto endTime = startTime + chrono::seconds(windowInSeconds);
+  auto lastArrival = startTime;
+  int64_t lastCount = GetAllPoWSize();
+
+  while (chrono::steady_clock::now() < endTime) {
+    this_thread::sleep_for(min<chrono::steady_clock::duration>(
+        chrono::seconds(1), endTime - chrono::steady_clock::now()));
+
+    const auto now = chrono::steady_clock::now();
+    const int64_t count = GetAllPoWSize();
+    if (count != lastCount) {
+      lastCount = count;
+      lastArrival = now;
+      continue;
+    }
+
+    if ((numExpected > 0) && (static_cast<uint64_t>(count) >= target) &&
+        (now - lastArrival >=
+         chrono::seconds(POW_EARLY_CLOSE_IDLE_IN_SECONDS))) {
+      LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+                "Closing the PoW window after "
+                    << chrono::duration_cast<chrono::seconds>(now - startTime)
+                           .count()
+                    << " of " << windowInSeconds << " seconds with " << count
+                    << " of " << numExpected << " expected submissions");
+      return true;
+    }
+  }
+
+  return false;
+}
+
 bool DirectoryService::ProcessPoWPacketSubmission(
     const bytes& message, unsigned int offset,
     [[gnu::unused]] const Peer& from) {
@@ -122,7 +178,7 @@ bool DirectoryService::ProcessPoWPacketSubmission(
       LOG_GENERAL(INFO, "Too late");
       break;
     }
-    VerifyPoWSubmission(sol);
+    QueuePoWSubmission(sol);
   }
 
   return true;
@@ -207,7 +263,9 @@ bool DirectoryService::ProcessPoWSubmission(const bytes& message,
                         submitterKey, nonce, resultingHash, mixHash, lookupId,
                         gasPrice, signature);
 
-  if (VerifyPoWSubmission(powSoln)) {
+  // Kept for the PoW packet to the other DS members once verified
+  QueuePoWSubmission(powSoln, [this, powSoln]() {
+    const PubKey& submitterKey = powSoln.GetSubmitterKey();
     std::unique_lock<std::mutex> lk(m_mutexPowSolution);
     auto submittedNumber =
         std::count_if(m_powSolutions.begin(), m_powSolutions.end(),
@@ -218,14 +276,44 @@ bool DirectoryService::ProcessPoWSubmission(const bytes& message,
       LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
                 "Node " << submitterKey
                         << " submitted pow count already reach limit");
-      return false;
+      return;
     }
     m_powSolutions.emplace_back(powSoln);
-  }
+  });
 
   return true;
 }
 
+void DirectoryService::QueuePoWSubmission(
+    const DSPowSolution& sol, const std::function<void()>& onVerified) {
+  const auto key = make_pair(sol.GetSubmitterKey(), sol.GetNonce());
+  auto verify = [this, sol, onVerified, key]() {
+    const bool verified = VerifyPoWSubmission(sol);
+    if (m_powVerifyPool) {
+      lock_guard<mutex> g(m_mutexPoWVerifyQueued);
+      m_powVerifyQueued.erase(key);
+    }
+    if (verified && onVerified) {
+      onVerified();
+    }
+  };
+
+  if (!m_powVerifyPool) {
+    verify();
+    return;
+  }
+
+  {
+    lock_guard<mutex> g(m_mutexPoWVerifyQueued);
+    if (!m_powVerifyQueued.insert(key).second) {
+      LOG_GENERAL(INFO, "PoW submission of " << sol.GetSubmitterKey()
+                                             << " already being verified");
+      return;
+    }
+  }
+  m_powVerifyPool->AddJob(verify);
+}
+
 bool DirectoryService::VerifyPoWSubmission(const DSPowSolution& sol) {
   LOG_MARKER();
 
@@ -339,6 +427,19 @@ bool DirectoryService::VerifyPoWSubmission(const DSPowSolution& sol) {
     }
   }
 
+  array<uint8_t, 32> resultingHashArr{};
+  DataConversion::HexStrToStdArray(resultingHash, resultingHashArr);
+  {
+    // A solution accepted already is not worth the ethash evaluation again
+    lock_guard<mutex> g(m_mutexAllPOW);
+    auto it = m_allPoWs.find(submitterPubKey);
+    if (it != m_allPoWs.end() && it->second.nonce == nonce &&
+        it->second.result == resultingHashArr) {
+      LOG_GENERAL(INFO, "Duplicated");
+      return true;
+    }
+  }
+
   // m_timespec = r_timer_start();
 
   auto headerHash = POW::GenHeaderHash(rand1, rand2, submitterPeer,
@@ -359,14 +460,14 @@ bool DirectoryService::VerifyPoWSubmission(const DSPowSolution& sol) {
       lock_guard<mutex> g(m_mutexAllPOW, adopt_lock);
       lock_guard<mutex> g2(m_mutexAllPoWConns, adopt_lock);
 
-      array<uint8_t, 32> resultingHashArr{}, mixHashArr{};
-      DataConversion::HexStrToStdArray(resultingHash, resultingHashArr);
+      array<uint8_t, 32> mixHashArr{};
       DataConversion::HexStrToStdArray(mixHash, mixHashArr);
       PoWSolution soln(nonce, resultingHashArr, mixHashArr, lookupId, gasPrice);
 
       m_allPoWConns.emplace(submitterPubKey, submitterPeer);
       if (m_allPoWs.find(submitterPubKey) == m_allPoWs.end()) {
         m_allPoWs[submitterPubKey] = soln;
+        SavePoWSortHash(submitterPubKey, soln.result);
       } else if (m_allPoWs[submitterPubKey].result > soln.result) {
         // string harderSolnStr, oldSolnStr;
         // DataConversion::charArrToHexStr(soln.result, harderSolnStr);
@@ -374,6 +475,7 @@ bool DirectoryService::VerifyPoWSubmission(const DSPowSolution& sol) {
         // oldSolnStr);
         LOG_GENERAL(INFO, "Replaced");
         m_allPoWs[submitterPubKey] = soln;
+        SavePoWSortHash(submitterPubKey, soln.result);
       } else if (m_allPoWs[submitterPubKey].result == soln.result) {
         LOG_GENERAL(INFO, "Duplicated");
         return true;
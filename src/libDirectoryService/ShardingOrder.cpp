@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+#include "ShardingOrder.h"
+#include "libCrypto/Sha2.h"
+
+using namespace std;
+
+namespace {
+// Below this many hashes per thread, starting a thread costs more than it
+// saves
+const size_t MIN_HASHES_PER_THREAD = 512;
+}  // namespace
+
+vector<PoWSortHash> ComputePoWSortHashes(
+    const bytes& lastBlockHash,
+    const vector<array<unsigned char, POW_SIZE>>& results,
+    const unsigned int numThreads) {
+  vector<PoWSortHash> sortHashes(results.size());
+
+  auto computeRange = [&](size_t begin, size_t end) {
+    bytes hashVec(BLOCK_HASH_SIZE + POW_SIZE);
+    copy(lastBlockHash.begin(), lastBlockHash.end(), hashVec.begin());
+    SHA2<HashType::HASH_VARIANT_256> sha2;
+    for (size_t i = begin; i < end; i++) {
+      copy(results[i].begin(), results[i].end(),
+           hashVec.begin() + BLOCK_HASH_SIZE);
+      sha2.Reset();
+      sha2.Update(hashVec);
+      const bytes& sortHash = sha2.Finalize();
+      copy(sortHash.begin(), sortHash.end(), sortHashes[i].begin());
+    }
+  };
+
+  const size_t numRanges = min<size_t>(
+      numThreads + 1, max<size_t>(results.size() / MIN_HASHES_PER_THREAD, 1));
+  const size_t rangeSize = (results.size() + numRanges - 1) / numRanges;
+
+  // The caller takes the first range
+  vector<thread> threads;
+  for (size_t r = 1; r < numRanges; r++) {
+    threads.emplace_back(computeRange, r * rangeSize,
+                         min(results.size(), (r + 1) * rangeSize));
+  }
+  computeRange(0, min(results.size(), rangeSize));
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  return sortHashes;
+}
+
+vector<pair<PoWSortHash, PubKey>> OrderPoWsForSharding(
+    const bytes& lastBlockHash,
+    const vector<pair<array<unsigned char, POW_SIZE>, PubKey>>& powSolns,
+    const unsigned int numThreads) {
+  vector<array<unsigned char, POW_SIZE>> results;
+  results.reserve(powSolns.size());
+  for (const auto& kv : powSolns) {
+    results.emplace_back(kv.first);
+  }
+  const auto sortHashes =
+      ComputePoWSortHashes(lastBlockHash, results, numThreads);
+
+  // A stable sort keeps the first of equal hashes ahead of the others
+  vector<size_t> order(powSolns.size());
+  iota(order.begin(), order.end(), 0);
+  stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return sortHashes[a] < sortHashes[b];
+  });
+
+  vector<pair<PoWSortHash, PubKey>> orderedPoWs;
+  orderedPoWs.reserve(order.size());
+  for (const auto i : order) {
+    if (!orderedPoWs.empty() && orderedPoWs.back().first == sortHashes[i]) {
+      continue;
+    }
+    orderedPoWs.emplace_back(sortHashes[i], powSolns[i].second);
+  }
+
+  return orderedPoWs;
+}
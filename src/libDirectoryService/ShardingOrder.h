@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDIRECTORYSERVICE_SHARDINGORDER_H_
+#define ZILLIQA_SRC_LIBDIRECTORYSERVICE_SHARDINGORDER_H_
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include <Schnorr.h>
+#include "common/BaseType.h"
+#include "common/Constants.h"
+
+using PoWSortHash = std::array<unsigned char, BLOCK_HASH_SIZE>;
+
+// Used by the DS leader to shard the nodes and by the backups to check it
+
+/// Computes H(lastBlockHash, result) for each PoW result, on up to
+/// numThreads threads besides the caller
+std::vector<PoWSortHash> ComputePoWSortHashes(
+    const bytes& lastBlockHash,
+    const std::vector<std::array<unsigned char, POW_SIZE>>& results,
+    const unsigned int numThreads);
+
+/// Orders the nodes of powSolns by sort hash, which is the order they are
+/// sharded in. Of nodes with the same sort hash only the first one is kept.
+std::vector<std::pair<PoWSortHash, PubKey>> OrderPoWsForSharding(
+    const bytes& lastBlockHash,
+    const std::vector<std::pair<std::array<unsigned char, POW_SIZE>, PubKey>>&
+        powSolns,
+    const unsigned int numThreads);
+
+#endif  // ZILLIQA_SRC_LIBDIRECTORYSERVICE_SHARDINGORDER_H_
@@ -26,6 +26,7 @@
 #include "depends/common/RLP.h"
 #include "depends/libTrie/TrieDB.h"
 #include "depends/libTrie/TrieHash.h"
+#include "libConsensus/AggregatedPubKeyCache.h"
 #include "libCrypto/Sha2.h"
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
@@ -88,15 +89,17 @@ void DirectoryService::ProcessViewChangeConsensusWhenDone() {
 
   vector<PubKey> keys;
   for (auto const& kv : *m_mediator.m_DSCommittee) {
+    keys.emplace_back(kv.first);
     if (m_pendingVCBlock->GetB2().at(index)) {
-      keys.emplace_back(kv.first);
       count++;
     }
     index++;
   }
 
   // Verify cosig against vcblock
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<PubKey> aggregatedKey =
+      AggregatedPubKeyCache::GetInstance().AggregatePubKeys(
+          keys, m_pendingVCBlock->GetB2());
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return;
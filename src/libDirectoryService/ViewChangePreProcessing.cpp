@@ -98,9 +98,11 @@ bool DirectoryService::ViewChangeValidator(
   }
 
   // Verify the CommitteeHash member of the BlockHeaderBase
-  CommitteeHash committeeHash;
-  if (!Messenger::GetDSCommitteeHash(*m_mediator.m_DSCommittee,
-                                     committeeHash)) {
+  StagedViewChange staged;
+  const bool useStaged = GetStagedViewChange(staged);
+  CommitteeHash committeeHash = staged.m_committeeHash;
+  if (!useStaged && !Messenger::GetDSCommitteeHash(*m_mediator.m_DSCommittee,
+                                                   committeeHash)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::GetDSCommitteeHash failed.");
     return false;
@@ -127,7 +129,8 @@ bool DirectoryService::ViewChangeValidator(
   }
 
   // Verify candidate leader index
-  uint16_t candidateLeaderIndex = CalculateNewLeaderIndex();
+  uint16_t candidateLeaderIndex =
+      useStaged ? staged.m_candidateLeaderIndex : CalculateNewLeaderIndex();
 
   // Create a temporary local structure of ds committee pubkeys
   // Used range based loop due to clang tidy enforcement
@@ -234,16 +237,66 @@ void DirectoryService::SetLastKnownGoodState() {
     return;
   }
 
+  m_viewChangestate = GetLastKnownGoodState();
+}
+
+DirectoryService::DirState DirectoryService::GetLastKnownGoodState() const {
   switch (m_state) {
     case VIEWCHANGE_CONSENSUS_PREP:
     case VIEWCHANGE_CONSENSUS:
     case ERROR:
-      break;
+      return m_viewChangestate;
     default:
-      m_viewChangestate = (DirState)m_state;
+      return (DirState)m_state;
   }
 }
 
+// Everything the next view change computes from the committee and the block
+// link chain alone is worked out while waiting for the view change timeout,
+// so that a stalled consensus is replaced without redoing it. The stage is
+// only used if nothing it depends on has moved since.
+void DirectoryService::StageViewChange() {
+  if (LOOKUP_NODE_MODE) {
+    return;
+  }
+
+  StagedViewChange staged;
+  staged.m_vcCounter = m_viewChangeCounter + 1;
+  staged.m_vcState = GetLastKnownGoodState();
+  staged.m_epochNum = m_mediator.m_currentEpochNum;
+  staged.m_blockLinkIndex = m_mediator.m_blocklinkchain.GetLatestIndex();
+  staged.m_leaderID = GetConsensusLeaderID();
+
+  {
+    lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
+    if (!Messenger::GetDSCommitteeHash(*m_mediator.m_DSCommittee,
+                                       staged.m_committeeHash)) {
+      LOG_GENERAL(WARNING, "Messenger::GetDSCommitteeHash failed");
+      return;
+    }
+    staged.m_candidateLeaderIndex =
+        CalculateNewLeaderIndex(staged.m_vcCounter, staged.m_vcState);
+  }
+  staged.m_valid = true;
+
+  lock_guard<mutex> g(m_mutexStagedViewChange);
+  m_stagedViewChange = staged;
+}
+
+bool DirectoryService::GetStagedViewChange(StagedViewChange& staged) {
+  {
+    lock_guard<mutex> g(m_mutexStagedViewChange);
+    staged = m_stagedViewChange;
+  }
+
+  return staged.m_valid && staged.m_vcCounter == m_viewChangeCounter &&
+         staged.m_vcState == m_viewChangestate &&
+         staged.m_epochNum == m_mediator.m_currentEpochNum &&
+         staged.m_blockLinkIndex ==
+             m_mediator.m_blocklinkchain.GetLatestIndex() &&
+         staged.m_leaderID == GetConsensusLeaderID();
+}
+
 void DirectoryService::RunConsensusOnViewChange() {
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
@@ -305,7 +358,10 @@ void DirectoryService::RunConsensusOnViewChange() {
           m_mediator.m_DSCommittee->at(faultyLeaderIndex));
     }
 
-    m_candidateLeaderIndex = CalculateNewLeaderIndex();
+    StagedViewChange staged;
+    m_candidateLeaderIndex = GetStagedViewChange(staged)
+                                 ? staged.m_candidateLeaderIndex
+                                 : CalculateNewLeaderIndex();
 
     LOG_GENERAL(
         INFO,
@@ -357,6 +413,8 @@ void DirectoryService::ScheduleViewChangeTimeout() {
     return;
   }
 
+  StageViewChange();
+
   std::unique_lock<std::mutex> cv_lk(m_MutexCVViewChangeVCBlock);
   if (cv_ViewChangeVCBlock.wait_for(cv_lk,
                                     std::chrono::seconds(VIEWCHANGE_TIME)) ==
@@ -408,9 +466,12 @@ bool DirectoryService::ComputeNewCandidateLeader(
                   << m_mediator.m_DSCommittee->at(candidateLeaderIndex).first);
 
   // Compute the CommitteeHash member of the BlockHeaderBase
+  StagedViewChange staged;
   CommitteeHash committeeHash;
-  if (!Messenger::GetDSCommitteeHash(*m_mediator.m_DSCommittee,
-                                     committeeHash)) {
+  if (GetStagedViewChange(staged)) {
+    committeeHash = staged.m_committeeHash;
+  } else if (!Messenger::GetDSCommitteeHash(*m_mediator.m_DSCommittee,
+                                            committeeHash)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::GetDSCommitteeHash failed.");
     return false;
@@ -466,6 +527,11 @@ bool DirectoryService::NodeVCPrecheck() {
 }
 
 uint16_t DirectoryService::CalculateNewLeaderIndex() {
+  return CalculateNewLeaderIndex(m_viewChangeCounter, m_viewChangestate);
+}
+
+uint16_t DirectoryService::CalculateNewLeaderIndex(const uint32_t vcCounter,
+                                                   const DirState vcState) {
   // New leader is computed using the following
   // new candidate leader index is
   // H((finalblock or vc block), vc counter) % size
@@ -475,7 +541,7 @@ uint16_t DirectoryService::CalculateNewLeaderIndex() {
   uint64_t latestIndex = m_mediator.m_blocklinkchain.GetLatestIndex();
   BlockLink bl = m_mediator.m_blocklinkchain.GetBlockLink(latestIndex);
   VCBlockSharedPtr prevVCBlockptr;
-  if (CheckUseVCBlockInsteadOfDSBlock(bl, prevVCBlockptr)) {
+  if (CheckUseVCBlockInsteadOfDSBlock(bl, prevVCBlockptr, vcState)) {
     LOG_GENERAL(INFO,
                 "Using hash of last vc block for computing candidate leader");
     sha2.Update(prevVCBlockptr->GetBlockHash().asBytes());
@@ -487,7 +553,7 @@ uint16_t DirectoryService::CalculateNewLeaderIndex() {
   }
 
   bytes vcCounterBytes;
-  Serializable::SetNumber<uint32_t>(vcCounterBytes, 0, m_viewChangeCounter,
+  Serializable::SetNumber<uint32_t>(vcCounterBytes, 0, vcCounter,
                                     sizeof(uint32_t));
   sha2.Update(vcCounterBytes);
   uint16_t lastBlockHash = DataConversion::charArrTo16Bits(sha2.Finalize());
@@ -517,13 +583,20 @@ uint16_t DirectoryService::CalculateNewLeaderIndex() {
 
     LOG_GENERAL(INFO, "Re-computed candidate leader is at index: "
                           << candidateLeaderIndex
-                          << " VC counter: " << m_viewChangeCounter);
+                          << " VC counter: " << vcCounter);
   }
   return candidateLeaderIndex;
 }
 
 bool DirectoryService::CheckUseVCBlockInsteadOfDSBlock(
     const BlockLink& bl, VCBlockSharedPtr& prevVCBlockptr) {
+  return CheckUseVCBlockInsteadOfDSBlock(bl, prevVCBlockptr,
+                                         m_viewChangestate);
+}
+
+bool DirectoryService::CheckUseVCBlockInsteadOfDSBlock(
+    const BlockLink& bl, VCBlockSharedPtr& prevVCBlockptr,
+    const DirState vcState) {
   BlockType latestBlockType = get<BlockLinkIndex::BLOCKTYPE>(bl);
 
   if (latestBlockType == BlockType::VC) {
@@ -539,8 +612,7 @@ bool DirectoryService::CheckUseVCBlockInsteadOfDSBlock(
       return false;
     }
 
-    if (m_viewChangestate == DSBLOCK_CONSENSUS ||
-        m_viewChangestate == DSBLOCK_CONSENSUS_PREP) {
+    if (vcState == DSBLOCK_CONSENSUS || vcState == DSBLOCK_CONSENSUS_PREP) {
       if (prevVCBlockptr->GetHeader().GetViewChangeState() ==
               DSBLOCK_CONSENSUS ||
           prevVCBlockptr->GetHeader().GetViewChangeState() ==
@@ -551,13 +623,13 @@ bool DirectoryService::CheckUseVCBlockInsteadOfDSBlock(
             WARNING,
             "The previous vc block is not for current state.  prevVCBlockptr: "
                 << to_string(prevVCBlockptr->GetHeader().GetViewChangeState())
-                << " m_viewChangestate:" << m_viewChangestate);
+                << " vcState:" << vcState);
         return false;
       }
     }
 
-    if (m_viewChangestate == FINALBLOCK_CONSENSUS ||
-        m_viewChangestate == FINALBLOCK_CONSENSUS_PREP) {
+    if (vcState == FINALBLOCK_CONSENSUS ||
+        vcState == FINALBLOCK_CONSENSUS_PREP) {
       if (prevVCBlockptr->GetHeader().GetViewChangeState() ==
               FINALBLOCK_CONSENSUS ||
           prevVCBlockptr->GetHeader().GetViewChangeState() ==
@@ -568,7 +640,7 @@ bool DirectoryService::CheckUseVCBlockInsteadOfDSBlock(
             WARNING,
             "The previous vc block is not for current state.  prevVCBlockptr: "
                 << to_string(prevVCBlockptr->GetHeader().GetViewChangeState())
-                << " m_viewChangestate:" << m_viewChangestate);
+                << " vcState:" << vcState);
         return false;
       }
     }
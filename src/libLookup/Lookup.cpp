@@ -21,10 +21,12 @@
 #include <stdint.h>
 #include <sys/socket.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cstring>
 #include <exception>
 #include <fstream>
 #include <random>
+#include <thread>
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
@@ -34,6 +36,7 @@
 #include "libData/AccountData/Account.h"
 #include "libData/AccountData/AccountStore.h"
 #include "libData/AccountData/Transaction.h"
+#include "libData/AccountData/TxnPool.h"
 #include "libData/BlockChainData/BlockChain.h"
 #include "libData/BlockChainData/BlockLinkChain.h"
 #include "libData/BlockData/Block.h"
@@ -50,15 +53,31 @@
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/GetTxnFromFile.h"
+#include "libUtils/MemoryStats.h"
 #include "libUtils/RandomGenerator.h"
 #include "libUtils/SanityChecks.h"
 #include "libUtils/SysCommand.h"
+#include "libValidator/Validator.h"
 
 using namespace std;
 using namespace boost::multiprecision;
 
 const int32_t MAX_FETCH_BLOCK_RETRIES = 5;
 
+namespace {
+// Response type followed by the big-endian block range
+string GetSeedResponseKey(unsigned char ins, uint64_t lowBlockNum,
+                          uint64_t highBlockNum) {
+  string key(1, static_cast<char>(ins));
+  for (const uint64_t num : {lowBlockNum, highBlockNum}) {
+    for (int shift = 56; shift >= 0; shift -= 8) {
+      key.push_back(static_cast<char>(num >> shift));
+    }
+  }
+  return key;
+}
+}  // namespace
+
 Lookup::Lookup(Mediator& mediator, SyncType syncType) : m_mediator(mediator) {
   m_syncType.store(SyncType::NO_SYNC);
   vector<SyncType> ignorable_syncTypes = {NO_SYNC, DB_VERIF};
@@ -76,9 +95,18 @@ Lookup::Lookup(Mediator& mediator, SyncType syncType) : m_mediator(mediator) {
     SetDSCommitteInfo();
   }
   m_sendSCCallsToDS = false;
+
+  MemoryStats::GetInstance().Register(
+      "TxnShardPool", [this]() { return m_txnShardMap.GetSizeInBytes(); });
+  MemoryStats::GetInstance().Register("DispatchedTxns", [this]() {
+    return m_dispatchedTxns.GetSizeInBytes();
+  });
 }
 
-Lookup::~Lookup() {}
+Lookup::~Lookup() {
+  MemoryStats::GetInstance().Unregister("TxnShardPool");
+  MemoryStats::GetInstance().Unregister("DispatchedTxns");
+}
 
 void Lookup::InitAsNewJoiner() {
   LOG_MARKER();
@@ -537,6 +565,67 @@ void Lookup::SendMessageToSeedNodes(const bytes& message) const {
   P2PComm::GetInstance().SendMessage(seedNodePeer, message);
 }
 
+void Lookup::StartSeedSubscription() {
+  if (!LOOKUP_NODE_MODE || !ARCHIVAL_LOOKUP) {
+    LOG_GENERAL(WARNING,
+                "Lookup::StartSeedSubscription not expected to be called from "
+                "other than the ARCHIVAL LOOKUP.");
+    return;
+  }
+
+  if (!SEED_SUBSCRIBE_TO_LOOKUP) {
+    return;
+  }
+
+  bytes message = {MessageType::LOOKUP, LookupInstructionType::SUBSCRIBESEED};
+  if (!Messenger::SetLookupSubscribeSeed(message, MessageOffset::BODY,
+                                         m_mediator.m_selfPeer.m_listenPortHost,
+                                         m_mediator.m_selfKey)) {
+    LOG_GENERAL(WARNING, "Messenger::SetLookupSubscribeSeed failed.");
+    return;
+  }
+
+  // Renewed well before the upper seeds drop the subscription
+  auto func = [this, message]() -> void {
+    const unsigned int renewInterval =
+        max(1u, SEED_SUBSCRIPTION_TTL_IN_SEC / 3);
+    while (true) {
+      SendMessageToSeedNodes(message);
+      this_thread::sleep_for(chrono::seconds(renewInterval));
+    }
+  };
+  DetachedFunction(1, func);
+}
+
+void Lookup::RelayToSeedSubscribers(const bytes& message) {
+  if (!LOOKUP_NODE_MODE || ARCHIVAL_LOOKUP) {
+    LOG_GENERAL(WARNING,
+                "Lookup::RelayToSeedSubscribers not expected to be called from "
+                "other than the LookUp node.");
+    return;
+  }
+
+  vector<Peer> subscribers;
+  {
+    lock_guard<mutex> g(m_mutexSeedSubscribers);
+    const auto now = chrono::steady_clock::now();
+    for (auto it = m_seedSubscribers.begin(); it != m_seedSubscribers.end();) {
+      if (it->second.second <= now) {
+        LOG_GENERAL(INFO, "Subscription of seed " << it->second.first
+                                                  << " ran out");
+        it = m_seedSubscribers.erase(it);
+        continue;
+      }
+      subscribers.emplace_back(it->second.first);
+      ++it;
+    }
+  }
+
+  if (!subscribers.empty()) {
+    P2PComm::GetInstance().SendMessage(subscribers, message);
+  }
+}
+
 bytes Lookup::ComposeGetDSInfoMessage(bool initialDS) {
   LOG_MARKER();
 
@@ -554,7 +643,7 @@ bytes Lookup::ComposeGetDSInfoMessage(bool initialDS) {
   return getDSNodesMessage;
 }
 
-bytes Lookup::ComposeGetStateMessage() {
+bytes Lookup::ComposeGetStateMessage(const Address& cursor) {
   LOG_MARKER();
 
   bytes getStateMessage = {MessageType::LOOKUP,
@@ -562,7 +651,8 @@ bytes Lookup::ComposeGetStateMessage() {
 
   if (!Messenger::SetLookupGetStateFromSeed(
           getStateMessage, MessageOffset::BODY,
-          m_mediator.m_selfPeer.m_listenPortHost)) {
+          m_mediator.m_selfPeer.m_listenPortHost, cursor,
+          STATE_EXPORT_CHUNK_ACCOUNTS)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::SetLookupGetStateFromSeed failed.");
     return {};
@@ -584,6 +674,10 @@ bool Lookup::GetDSInfoFromLookupNodes(bool initialDS) {
 }
 
 bool Lookup::GetStateFromSeedNodes() {
+  {
+    lock_guard<mutex> lock(m_mutexSetState);
+    m_stateSyncRoot = dev::h256();
+  }
   SendMessageToRandomSeedNode(ComposeGetStateMessage());
   return true;
 }
@@ -704,12 +798,48 @@ bool Lookup::GetTxBlockFromSeedNodes(uint64_t lowBlockNum,
                                      uint64_t highBlockNum) {
   LOG_MARKER();
 
-  SendMessageToRandomSeedNode(
-      ComposeGetTxBlockMessage(lowBlockNum, highBlockNum));
+  if (TXBLOCK_DOWNLOAD_MAX_CHUNKS <= 1) {
+    SendMessageToRandomSeedNode(
+        ComposeGetTxBlockMessage(lowBlockNum, highBlockNum));
+    return true;
+  }
+
+  VectorOfPeer seedNodes = GetNotBlackListedSeedNodes();
+  shuffle(seedNodes.begin(), seedNodes.end(), RandomGenerator::rng);
+
+  // Nothing is sent while a download is ongoing, its poller retries it
+  const auto requests = m_txBlockDownloader.Start(
+      lowBlockNum, highBlockNum, seedNodes, TxBlockDownloader::Clock::now());
+  if (requests.empty()) {
+    return true;
+  }
+
+  SendTxBlockRequests(requests);
+  DetachedFunction(1, [this]() { PollTxBlockDownload(); });
 
   return true;
 }
 
+void Lookup::SendTxBlockRequests(
+    const vector<TxBlockDownloader::Request>& requests) {
+  for (const auto& request : requests) {
+    LOG_GENERAL(INFO, "Requesting tx blocks " << request.m_lowBlockNum << " to "
+                                              << request.m_highBlockNum
+                                              << " from " << request.m_peer);
+    P2PComm::GetInstance().SendMessage(
+        request.m_peer, ComposeGetTxBlockMessage(request.m_lowBlockNum,
+                                                 request.m_highBlockNum));
+  }
+}
+
+void Lookup::PollTxBlockDownload() {
+  while (m_txBlockDownloader.IsActive()) {
+    this_thread::sleep_for(chrono::seconds(1));
+    SendTxBlockRequests(
+        m_txBlockDownloader.Poll(TxBlockDownloader::Clock::now()));
+  }
+}
+
 bool Lookup::GetStateDeltaFromSeedNodes(const uint64_t& blockNum)
 
 {
@@ -920,27 +1050,52 @@ bool Lookup::ProcessGetDSInfoFromSeed(const bytes& message, unsigned int offset,
   return true;
 }
 
-void Lookup::SendMessageToRandomSeedNode(const bytes& message) const {
-  LOG_MARKER();
+bool Lookup::SendCachedSeedResponse(unsigned char ins, uint64_t lowBlockNum,
+                                    uint64_t highBlockNum,
+                                    const Peer& peer) {
+  shared_ptr<bytes> message;
+  if (!m_seedResponseCache.Lookup(
+          GetSeedResponseKey(ins, lowBlockNum, highBlockNum), message)) {
+    return false;
+  }
 
+  LOG_GENERAL(INFO, "Sending cached response for " << lowBlockNum << " to "
+                                                   << highBlockNum);
+  P2PComm::GetInstance().SendMessage(peer, *message);
+  return true;
+}
+
+void Lookup::CacheSeedResponse(unsigned char ins, uint64_t lowBlockNum,
+                               uint64_t highBlockNum, const bytes& message) {
+  m_seedResponseCache.Insert(GetSeedResponseKey(ins, lowBlockNum, highBlockNum),
+                             make_shared<bytes>(message), message.size());
+}
+
+VectorOfPeer Lookup::GetNotBlackListedSeedNodes() const {
   VectorOfPeer notBlackListedSeedNodes;
-  {
-    lock_guard<mutex> lock(m_mutexSeedNodes);
-    if (0 == m_seedNodes.size()) {
-      LOG_GENERAL(WARNING, "Seed nodes are empty");
-      return;
-    }
 
-    for (const auto& node : m_seedNodes) {
-      auto seedNodeIpToSend = TryGettingResolvedIP(node.second);
-      if (!Blacklist::GetInstance().Exist(seedNodeIpToSend) &&
-          (m_mediator.m_selfPeer.GetIpAddress() != seedNodeIpToSend)) {
-        notBlackListedSeedNodes.push_back(
-            Peer(seedNodeIpToSend, node.second.GetListenPortHost()));
-      }
+  lock_guard<mutex> lock(m_mutexSeedNodes);
+  if (0 == m_seedNodes.size()) {
+    LOG_GENERAL(WARNING, "Seed nodes are empty");
+    return notBlackListedSeedNodes;
+  }
+
+  for (const auto& node : m_seedNodes) {
+    auto seedNodeIpToSend = TryGettingResolvedIP(node.second);
+    if (!Blacklist::GetInstance().Exist(seedNodeIpToSend) &&
+        (m_mediator.m_selfPeer.GetIpAddress() != seedNodeIpToSend)) {
+      notBlackListedSeedNodes.push_back(
+          Peer(seedNodeIpToSend, node.second.GetListenPortHost()));
     }
   }
 
+  return notBlackListedSeedNodes;
+}
+
+void Lookup::SendMessageToRandomSeedNode(const bytes& message) const {
+  LOG_MARKER();
+
+  const VectorOfPeer notBlackListedSeedNodes = GetNotBlackListedSeedNodes();
   if (notBlackListedSeedNodes.empty()) {
     LOG_GENERAL(WARNING,
                 "All the seed nodes are blacklisted, please check you network "
@@ -986,6 +1141,12 @@ bool Lookup::ProcessGetDSBlockFromSeed(const bytes& message,
                                                       << lowBlockNum << " to "
                                                       << highBlockNum);
 
+  Peer requestingNode(from.m_ipAddress, portNo);
+  if (SendCachedSeedResponse(LookupInstructionType::SETDSBLOCKFROMSEED,
+                             lowBlockNum, highBlockNum, requestingNode)) {
+    return true;
+  }
+
   bytes dsBlockMessage = {MessageType::LOOKUP,
                           LookupInstructionType::SETDSBLOCKFROMSEED};
 
@@ -997,7 +1158,11 @@ bool Lookup::ProcessGetDSBlockFromSeed(const bytes& message,
     return false;
   }
 
-  Peer requestingNode(from.m_ipAddress, portNo);
+  if (!dsBlocks.empty() && dsBlocks.size() == highBlockNum - lowBlockNum + 1) {
+    CacheSeedResponse(LookupInstructionType::SETDSBLOCKFROMSEED, lowBlockNum,
+                      highBlockNum, dsBlockMessage);
+  }
+
   LOG_GENERAL(INFO, requestingNode);
   P2PComm::GetInstance().SendMessage(requestingNode, dsBlockMessage);
 
@@ -1080,8 +1245,11 @@ bool Lookup::ProcessGetStateFromSeed(const bytes& message, unsigned int offset,
   LOG_MARKER();
 
   uint32_t portNo = 0;
+  Address cursor;
+  unsigned int maxAccounts = 0;
 
-  if (!Messenger::GetLookupGetStateFromSeed(message, offset, portNo)) {
+  if (!Messenger::GetLookupGetStateFromSeed(message, offset, portNo, cursor,
+                                            maxAccounts)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::GetLookupGetStateFromSeed failed.");
     return false;
@@ -1091,9 +1259,14 @@ bool Lookup::ProcessGetStateFromSeed(const bytes& message, unsigned int offset,
   bytes setStateMessage = {MessageType::LOOKUP,
                            LookupInstructionType::SETSTATEFROMSEED};
 
+  // The whole state is only sent to the nodes that ask for it
+  if (maxAccounts > STATE_EXPORT_CHUNK_ACCOUNTS) {
+    maxAccounts = STATE_EXPORT_CHUNK_ACCOUNTS;
+  }
+
   if (!Messenger::SetLookupSetStateFromSeed(
           setStateMessage, MessageOffset::BODY, m_mediator.m_selfKey,
-          AccountStore::GetInstance())) {
+          AccountStore::GetInstance(), cursor, maxAccounts)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::SetLookupSetStateFromSeed failed.");
     return false;
@@ -1138,6 +1311,12 @@ bool Lookup::ProcessGetTxBlockFromSeed(const bytes& message,
   vector<TxBlock> txBlocks;
   RetrieveTxBlocks(txBlocks, lowBlockNum, highBlockNum);
 
+  Peer requestingNode(from.m_ipAddress, portNo);
+  if (SendCachedSeedResponse(LookupInstructionType::SETTXBLOCKFROMSEED,
+                             lowBlockNum, highBlockNum, requestingNode)) {
+    return true;
+  }
+
   bytes txBlockMessage = {MessageType::LOOKUP,
                           LookupInstructionType::SETTXBLOCKFROMSEED};
   if (!Messenger::SetLookupSetTxBlockFromSeed(
@@ -1148,7 +1327,11 @@ bool Lookup::ProcessGetTxBlockFromSeed(const bytes& message,
     return false;
   }
 
-  Peer requestingNode(from.m_ipAddress, portNo);
+  if (!txBlocks.empty() && txBlocks.size() == highBlockNum - lowBlockNum + 1) {
+    CacheSeedResponse(LookupInstructionType::SETTXBLOCKFROMSEED, lowBlockNum,
+                      highBlockNum, txBlockMessage);
+  }
+
   P2PComm::GetInstance().SendMessage(requestingNode, txBlockMessage);
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
             "Sent Txblks " << lowBlockNum << " - " << highBlockNum);
@@ -1301,6 +1484,12 @@ bool Lookup::ProcessGetStateDeltasFromSeed(const bytes& message,
                 << from << " for blocks: " << lowBlockNum << " to "
                 << highBlockNum);
 
+  Peer requestingNode(from.m_ipAddress, portNo);
+  if (SendCachedSeedResponse(LookupInstructionType::SETSTATEDELTASFROMSEED,
+                             lowBlockNum, highBlockNum, requestingNode)) {
+    return true;
+  }
+
   vector<bytes> stateDeltas;
   for (auto i = lowBlockNum; i <= highBlockNum; i++) {
     bytes stateDelta;
@@ -1324,8 +1513,12 @@ bool Lookup::ProcessGetStateDeltasFromSeed(const bytes& message,
     return false;
   }
 
-  uint128_t ipAddr = from.m_ipAddress;
-  Peer requestingNode(ipAddr, portNo);
+  if (highBlockNum >= lowBlockNum &&
+      stateDeltas.size() == highBlockNum - lowBlockNum + 1) {
+    CacheSeedResponse(LookupInstructionType::SETSTATEDELTASFROMSEED,
+                      lowBlockNum, highBlockNum, stateDeltasMessage);
+  }
+
   LOG_GENERAL(INFO, requestingNode);
   P2PComm::GetInstance().SendMessage(requestingNode, stateDeltasMessage);
   return true;
@@ -1621,10 +1814,11 @@ bool Lookup::ProcessGetCosigsRewardsFromSeed(
   }
 
   uint64_t blockNum;
+  uint64_t blockCount = 1;
   uint32_t portNo = 0;
   PubKey dsPubKey;
-  if (!Messenger::GetLookupGetCosigsRewardsFromSeed(message, offset, dsPubKey,
-                                                    blockNum, portNo)) {
+  if (!Messenger::GetLookupGetCosigsRewardsFromSeed(
+          message, offset, dsPubKey, blockNum, blockCount, portNo)) {
     LOG_GENERAL(WARNING, "Failed to process");
     return false;
   }
@@ -1650,30 +1844,65 @@ bool Lookup::ProcessGetCosigsRewardsFromSeed(
     }
   }
 
-  LOG_GENERAL(INFO, "Request for cosig/rewards for blockNum " << blockNum);
+  blockCount = min<uint64_t>(
+      blockCount, max(COSIGS_REWARDS_MAX_BLOCKS_PER_REQUEST, 1u));
+  LOG_GENERAL(INFO, "Request for cosig/rewards for blockNum "
+                        << blockNum << " count " << blockCount);
 
   Peer requestingNode(ipSenderAddr, portNo);
-  vector<MicroBlock> retMicroBlocks;
 
-  TxBlockSharedPtr txblkPtr;
-  int retryCount = MAX_FETCH_BLOCK_RETRIES;
-  while (retryCount > 0) {
-    if (!BlockStorage::GetBlockStorage().GetTxBlock(blockNum, txblkPtr)) {
-      LOG_GENERAL(WARNING,
-                  "Failed to fetch tx block " << blockNum << " , retry... ");
-      this_thread::sleep_for(chrono::seconds(1));
-    } else {
+  // The blocks after the latest one are left out, except for the first one,
+  // which may be about to be stored
+  const uint64_t latestBlockNum =
+      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+  vector<bytes> records;
+  for (uint64_t num = blockNum; num - blockNum < blockCount; num++) {
+    if (num > blockNum && num > latestBlockNum) {
       break;
     }
+    bytes record;
+    if (!GetCosigsRewardsRecord(num, record, MAX_FETCH_BLOCK_RETRIES)) {
+      break;
+    }
+    records.emplace_back(move(record));
+  }
 
-    --retryCount;
+  if (records.empty()) {
+    return false;
   }
 
-  if (retryCount == 0) {
-    LOG_GENERAL(WARNING, "Failed to fetch tx block, giving up !");
+  bytes retMsg = {MessageType::DIRECTORY,
+                  DSInstructionType::SETCOSIGSREWARDSFROMSEED};
+
+  if (!Messenger::SetLookupSetCosigsRewardsFromSeed(
+          retMsg, MessageOffset::BODY, m_mediator.m_selfKey, records)) {
+    LOG_GENERAL(WARNING, "Failed to Process ");
     return false;
   }
 
+  P2PComm::GetInstance().SendMessage(requestingNode, retMsg);
+  return true;
+}
+
+bool Lookup::GetCosigsRewardsRecord(const uint64_t& blockNum, bytes& record,
+                                    int retries) {
+  if (BlockStorage::GetBlockStorage().GetCosigsRewards(blockNum, record)) {
+    return true;
+  }
+
+  TxBlockSharedPtr txblkPtr;
+  int retryCount = retries;
+  while (!BlockStorage::GetBlockStorage().GetTxBlock(blockNum, txblkPtr)) {
+    if (--retryCount <= 0) {
+      LOG_GENERAL(WARNING,
+                  "Failed to fetch tx block " << blockNum << ", giving up !");
+      return false;
+    }
+    LOG_GENERAL(WARNING,
+                "Failed to fetch tx block " << blockNum << " , retry... ");
+    this_thread::sleep_for(chrono::seconds(1));
+  }
+
   const auto& microblockInfos = txblkPtr->GetMicroBlockInfos();
   std::vector<MicroBlock> microblocks;
   for (const auto& mbInfo : microblockInfos) {
@@ -1682,41 +1911,44 @@ bool Lookup::ProcessGetCosigsRewardsFromSeed(
       continue;
     }
     MicroBlockSharedPtr mbptr;
-    retryCount = MAX_FETCH_BLOCK_RETRIES;
-    while (retryCount > 0) {
-      if (!BlockStorage::GetBlockStorage().GetMicroBlock(
-              mbInfo.m_microBlockHash, mbptr)) {
-        LOG_GENERAL(WARNING, "Could not get MicroBlock "
-                                 << mbInfo.m_microBlockHash << ", retry..");
-        this_thread::sleep_for(chrono::seconds(1));
-      } else {
-        break;
+    retryCount = retries;
+    while (!BlockStorage::GetBlockStorage().GetMicroBlock(
+        mbInfo.m_microBlockHash, mbptr)) {
+      if (--retryCount <= 0) {
+        LOG_GENERAL(WARNING, "Failed to fetch MicroBlock "
+                                 << mbInfo.m_microBlockHash
+                                 << " , giving up !");
+        return false;
       }
-
-      --retryCount;
-    }
-    if (retryCount == 0) {
-      LOG_GENERAL(WARNING, "Failed to fetch MicroBlock "
-                               << mbInfo.m_microBlockHash << " , giving up !");
-      return false;
+      LOG_GENERAL(WARNING, "Could not get MicroBlock "
+                               << mbInfo.m_microBlockHash << ", retry..");
+      this_thread::sleep_for(chrono::seconds(1));
     }
     microblocks.emplace_back(*mbptr);
   }
 
-  bytes retMsg = {MessageType::DIRECTORY,
-                  DSInstructionType::SETCOSIGSREWARDSFROMSEED};
-
-  if (!Messenger::SetLookupSetCosigsRewardsFromSeed(
-          retMsg, MessageOffset::BODY, m_mediator.m_selfKey, blockNum,
-          microblocks, *txblkPtr, m_mediator.m_ds->GetNumShards())) {
-    LOG_GENERAL(WARNING, "Failed to Process ");
+  if (!Messenger::SetCosigsRewardsRecord(record, blockNum, microblocks,
+                                         *txblkPtr,
+                                         m_mediator.m_ds->GetNumShards())) {
+    LOG_GENERAL(WARNING, "Messenger::SetCosigsRewardsRecord failed");
     return false;
   }
 
-  P2PComm::GetInstance().SendMessage(requestingNode, retMsg);
+  if (!BlockStorage::GetBlockStorage().PutCosigsRewards(blockNum, record)) {
+    LOG_GENERAL(WARNING, "BlockStorage::PutCosigsRewards failed " << blockNum);
+  }
   return true;
 }
 
+void Lookup::StoreCosigsRewardsRecord(const uint64_t& blockNum) {
+  if (!LOOKUP_NODE_MODE) {
+    return;
+  }
+
+  bytes record;
+  GetCosigsRewardsRecord(blockNum, record, 1);
+}
+
 bool Lookup::ProcessSetDSInfoFromSeed(const bytes& message, unsigned int offset,
                                       const Peer& from) {
   LOG_MARKER();
@@ -1959,6 +2191,7 @@ bool Lookup::ProcessSetTxBlockFromSeed(const bytes& message,
   LOG_MARKER();
 
   if (AlreadyJoinedNetwork()) {
+    m_txBlockDownloader.Reset();
     cv_setTxBlockFromSeed.notify_all();
     return true;
   }
@@ -1970,10 +2203,25 @@ bool Lookup::ProcessSetTxBlockFromSeed(const bytes& message,
   std::vector<TxBlock> txBlocks;
   PubKey lookupPubKey;
 
+  // Outside of a download, a range we already have is dropped before the
+  // tx blocks are parsed
+  if (!m_txBlockDownloader.IsActive() &&
+      Messenger::GetLookupSetTxBlockFromSeedRange(message, offset, lowBlockNum,
+                                                  highBlockNum) &&
+      lowBlockNum <= highBlockNum &&
+      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
+          highBlockNum) {
+    LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+              "I already have the blocks " << lowBlockNum << " to "
+                                           << highBlockNum);
+    return false;
+  }
+
   if (!Messenger::GetLookupSetTxBlockFromSeed(
           message, offset, lowBlockNum, highBlockNum, lookupPubKey, txBlocks)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::GetLookupSetTxBlockFromSeed failed.");
+    m_txBlockDownloader.OnFailure(from);
     return false;
   }
 
@@ -1989,6 +2237,22 @@ bool Lookup::ProcessSetTxBlockFromSeed(const bytes& message,
                                                  << lowBlockNum << " to "
                                                  << highBlockNum);
 
+  if (m_txBlockDownloader.IsActive()) {
+    if (!m_txBlockDownloader.OnResponse(from, lowBlockNum, highBlockNum,
+                                         txBlocks)) {
+      LOG_GENERAL(WARNING, "Tx blocks were not requested from " << from);
+      return false;
+    }
+    // Commit only once every chunk is in, as one range
+    if (!m_txBlockDownloader.TakeBlocks(txBlocks)) {
+      return true;
+    }
+    if (!txBlocks.empty()) {
+      lowBlockNum = txBlocks.front().GetHeader().GetBlockNum();
+      highBlockNum = txBlocks.back().GetHeader().GetBlockNum();
+    }
+  }
+
   // Update GetWork Server info for new nodes not in shards
   if (GETWORK_SERVER_MINE) {
     // roughly calc how many seconds to next PoW
@@ -2123,97 +2387,243 @@ void Lookup::PrepareForStartPow() {
   m_mediator.m_lookup->SendMessageToRandomSeedNode(getpowsubmission_message);
 }
 
+bool Lookup::WaitForStateDeltas(uint64_t lowBlockNum, uint64_t highBlockNum) {
+  auto received = [this, lowBlockNum, highBlockNum]() {
+    return static_cast<uint64_t>(distance(
+               m_stateDeltaBuffer.lower_bound(lowBlockNum),
+               m_stateDeltaBuffer.upper_bound(highBlockNum))) ==
+           highBlockNum - lowBlockNum + 1;
+  };
+
+  for (unsigned int retry = 1; retry <= RETRY_GETSTATEDELTAS_COUNT; retry++) {
+    {
+      unique_lock<mutex> cv_lk(m_mutexSetStateDeltasFromSeed);
+      if (cv_setStateDeltasFromSeed.wait_for(
+              cv_lk, chrono::seconds(GETSTATEDELTAS_TIMEOUT_IN_SECONDS),
+              received)) {
+        return true;
+      }
+    }
+    LOG_GENERAL(WARNING, "[Retry: " << retry
+                                    << "] Didn't receive statedeltas for "
+                                       "txBlks: "
+                                    << lowBlockNum << "-" << highBlockNum);
+    if (retry < RETRY_GETSTATEDELTAS_COUNT) {
+      GetStateDeltasFromSeedNodes(lowBlockNum, highBlockNum);
+    }
+  }
+
+  return false;
+}
+
+bool Lookup::ApplyStateDeltas(uint64_t lowBlockNum, uint64_t highBlockNum,
+                              uint64_t lastBlockNum,
+                              unsigned int& numApplied) {
+  map<uint64_t, bytes> stateDeltas;
+  {
+    lock_guard<mutex> g(m_mutexSetStateDeltasFromSeed);
+    auto begin = m_stateDeltaBuffer.lower_bound(lowBlockNum);
+    auto end = m_stateDeltaBuffer.upper_bound(highBlockNum);
+    stateDeltas.insert(make_move_iterator(begin), make_move_iterator(end));
+    m_stateDeltaBuffer.erase(begin, end);
+  }
+
+  // The deltas not applied yet are applied run by run, a run ending where
+  // the state goes to disk, so that the state trie is updated once per run
+  vector<uint64_t> runBlockNums;
+  vector<const bytes*> run;
+  auto applyRun = [&]() {
+    if (run.empty()) {
+      return true;
+    }
+    if (!AccountStore::GetInstance().DeserializeDeltas(run)) {
+      LOG_GENERAL(WARNING,
+                  "AccountStore::GetInstance().DeserializeDeltas failed");
+      return false;
+    }
+    for (size_t i = 0; i < run.size(); i++) {
+      if (!BlockStorage::GetBlockStorage().PutStateDelta(runBlockNums[i],
+                                                         *run[i])) {
+        LOG_GENERAL(WARNING, "BlockStorage::PutStateDelta failed");
+        return false;
+      }
+    }
+    m_prevStateRootHashTemp = AccountStore::GetInstance().GetStateRootHash();
+    numApplied += run.size();
+    runBlockNums.clear();
+    run.clear();
+    return true;
+  };
+
+  bytes tmp;
+  for (const auto& it : stateDeltas) {
+    const uint64_t txBlkNum = it.first;
+
+    // TBD - To verify state delta hash against one from TxBlk.
+    // But not crucial right now since we do verify sender i.e lookup and
+    // trust it.
+
+    if (!BlockStorage::GetBlockStorage().GetStateDelta(txBlkNum, tmp)) {
+      runBlockNums.emplace_back(txBlkNum);
+      run.emplace_back(&it.second);
+    }
+    if ((txBlkNum + 1) % NUM_FINAL_BLOCK_PER_POW == 0) {
+      if (!applyRun()) {
+        return false;
+      }
+      if (ENABLE_REPOPULATE && ((txBlkNum + 1) % (NUM_FINAL_BLOCK_PER_POW *
+                                                  REPOPULATE_STATE_PER_N_DS) ==
+                                REPOPULATE_STATE_IN_DS)) {
+        if (!AccountStore::GetInstance().MoveUpdatesToDisk(true)) {
+          LOG_GENERAL(WARNING, "AccountStore::MoveUpdatesToDisk(true) failed");
+          return false;
+        }
+      } else if (txBlkNum + NUM_FINAL_BLOCK_PER_POW > lastBlockNum) {
+        if (!AccountStore::GetInstance().MoveUpdatesToDisk(false)) {
+          LOG_GENERAL(WARNING, "AccountStore::MoveUpdatesToDisk(false) failed");
+          return false;
+        }
+      }
+    }
+  }
+
+  return applyRun();
+}
+
 void Lookup::CommitTxBlocks(const vector<TxBlock>& txBlocks) {
   LOG_GENERAL(INFO, "[TxBlockVerif]"
                         << "Success");
   uint64_t lowBlockNum = txBlocks.front().GetHeader().GetBlockNum();
   uint64_t highBlockNum = txBlocks.back().GetHeader().GetBlockNum();
   bool placeholder = false;
-  if (m_syncType != SyncType::RECOVERY_ALL_SYNC) {
-    unsigned int retry = 1;
-    while (retry <= RETRY_GETSTATEDELTAS_COUNT) {
-      // Get the state-delta for all txBlocks from random lookup nodes
-      GetStateDeltasFromSeedNodes(lowBlockNum, highBlockNum);
-      std::unique_lock<std::mutex> cv_lk(m_mutexSetStateDeltasFromSeed);
-      if (cv_setStateDeltasFromSeed.wait_for(
-              cv_lk, std::chrono::seconds(GETSTATEDELTAS_TIMEOUT_IN_SECONDS)) ==
-          std::cv_status::timeout) {
-        LOG_GENERAL(
-            WARNING,
-            "[Retry: " << retry
-                       << "] Didn't receive statedeltas! Will try again");
-        retry++;
-      } else {
-        break;
+  const bool fetchStateDeltas = m_syncType != SyncType::RECOVERY_ALL_SYNC &&
+                                m_syncType != SyncType::LIGHT_SYNC;
+  const bool fetchMicroBlocks = (LOOKUP_NODE_MODE && ARCHIVAL_LOOKUP &&
+                                 m_syncType == SyncType::NEW_LOOKUP_SYNC) ||
+                                (LOOKUP_NODE_MODE && !ARCHIVAL_LOOKUP &&
+                                 m_syncType == SyncType::LOOKUP_SYNC);
+
+  // The blocks are committed window by window. The state deltas of the next
+  // windows are fetched while those of the current one are applied and its
+  // blocks stored, and the microblock bodies of a stored window are fetched
+  // in the background meanwhile.
+  const size_t window = max(STATEDELTA_FETCH_WINDOW, 1u);
+  const size_t maxInFlight = window * max(STATEDELTA_FETCH_IN_FLIGHT, 1u);
+  size_t requested = 0;
+  if (fetchStateDeltas) {
+    lock_guard<mutex> g(m_mutexSetStateDeltasFromSeed);
+    m_stateDeltaBuffer.clear();
+    m_stateDeltaRange = {lowBlockNum, highBlockNum};
+  }
+
+  for (size_t windowBegin = 0; windowBegin < txBlocks.size();
+       windowBegin += window) {
+    const size_t windowEnd = min(windowBegin + window, txBlocks.size());
+    const uint64_t windowLowBlockNum =
+        txBlocks[windowBegin].GetHeader().GetBlockNum();
+    const uint64_t windowHighBlockNum =
+        txBlocks[windowEnd - 1].GetHeader().GetBlockNum();
+
+    if (fetchStateDeltas) {
+      // Get the state-delta for the windows ahead from random lookup nodes
+      for (; requested < txBlocks.size() &&
+             requested < windowBegin + maxInFlight;
+           requested += window) {
+        GetStateDeltasFromSeedNodes(
+            txBlocks[requested].GetHeader().GetBlockNum(),
+            txBlocks[min(requested + window, txBlocks.size()) - 1]
+                .GetHeader()
+                .GetBlockNum());
+      }
+
+      unsigned int numApplied = 0;
+      if (!WaitForStateDeltas(windowLowBlockNum, windowHighBlockNum) ||
+          !ApplyStateDeltas(windowLowBlockNum, windowHighBlockNum,
+                            highBlockNum, numApplied)) {
+        LOG_GENERAL(WARNING, "Failed to receive state-deltas for txBlks: "
+                                 << windowLowBlockNum << "-"
+                                 << windowHighBlockNum);
+        cv_setTxBlockFromSeed.notify_all();
+        cv_waitJoined.notify_all();
+        return;
+      }
+
+      // Check StateRootHash and One in last TxBlk of the window
+      const TxBlock& lastTxBlock = txBlocks[windowEnd - 1];
+      if (numApplied > 0 && m_prevStateRootHashTemp !=
+                                lastTxBlock.GetHeader().GetStateRootHash()) {
+        LOG_CHECK_FAIL("State root hash",
+                       lastTxBlock.GetHeader().GetStateRootHash(),
+                       m_prevStateRootHashTemp);
+        return;
       }
-    }
-    if (retry > RETRY_GETSTATEDELTAS_COUNT) {
-      LOG_GENERAL(WARNING, "Failed to receive state-deltas for txBlks: "
-                               << lowBlockNum << "-" << highBlockNum);
-      cv_setTxBlockFromSeed.notify_all();
-      cv_waitJoined.notify_all();
-      return;
     }
 
-    // Check StateRootHash and One in last TxBlk
-    if (m_prevStateRootHashTemp !=
-        txBlocks.back().GetHeader().GetStateRootHash()) {
-      LOG_CHECK_FAIL("State root hash",
-                     txBlocks.back().GetHeader().GetStateRootHash(),
-                     m_prevStateRootHashTemp);
-      return;
+    if (LOOKUP_NODE_MODE && windowBegin == 0) {
+      m_mediator.m_node->ClearUnconfirmedTxn();
     }
-  }
-  if (LOOKUP_NODE_MODE) {
-    m_mediator.m_node->ClearUnconfirmedTxn();
-  }
 
-  for (const auto& txBlock : txBlocks) {
-    LOG_EPOCH(INFO, m_mediator.m_currentEpochNum, txBlock);
+    vector<uint64_t> cosigsRewardsBlockNums;
+    for (size_t i = windowBegin; i < windowEnd; i++) {
+      const TxBlock& txBlock = txBlocks[i];
+      LOG_EPOCH(INFO, m_mediator.m_currentEpochNum, txBlock);
+
+      m_mediator.m_node->AddBlock(txBlock);
+      // Store Tx Block to disk
+      bytes serializedTxBlock;
+      txBlock.Serialize(serializedTxBlock, 0);
+      uint64_t blockNum = txBlock.GetHeader().GetBlockNum();
+
+      if (!BlockStorage::GetBlockStorage().PutTxBlock(blockNum,
+                                                      serializedTxBlock)) {
+        LOG_GENERAL(WARNING, "BlockStorage::PutTxBlock failed " << txBlock);
+        return;
+      }
 
-    m_mediator.m_node->AddBlock(txBlock);
-    // Store Tx Block to disk
-    bytes serializedTxBlock;
-    txBlock.Serialize(serializedTxBlock, 0);
-    uint64_t blockNum = txBlock.GetHeader().GetBlockNum();
+      // If txblk not from vacaous epoch and is rejoining as ds node
+      if ((blockNum + 1) % NUM_FINAL_BLOCK_PER_POW != 0 &&
+          (m_syncType == SyncType::DS_SYNC ||
+           m_syncType == SyncType::GUARD_DS_SYNC)) {
+        // Coinbase
+        uint128_t rewards = txBlock.GetHeader().GetRewards();
+        LOG_GENERAL(INFO, "Update coin base for finalblock with blockNum: "
+                              << blockNum << ", reward: " << rewards);
+        m_mediator.m_ds->SaveCoinbase(txBlock.GetB1(), txBlock.GetB2(),
+                                      CoinbaseReward::FINALBLOCK_REWARD,
+                                      blockNum + 1);
+        // Need if it join immediately before vacaous. And will be used in
+        // InitCoinbase in final blk consensus in vacaous epoch.
+        m_mediator.m_ds->m_totalTxnFees += rewards;
+      }
 
-    if (!BlockStorage::GetBlockStorage().PutTxBlock(blockNum,
-                                                    serializedTxBlock)) {
-      LOG_GENERAL(WARNING, "BlockStorage::PutTxBlock failed " << txBlock);
-      return;
-    }
+      if (fetchMicroBlocks) {
+        m_mediator.m_node->LoadUnavailableMicroBlockHashes(
+            txBlock, placeholder, true /*skip shardid check*/);
+      }
 
-    // If txblk not from vacaous epoch and is rejoining as ds node
-    if ((blockNum + 1) % NUM_FINAL_BLOCK_PER_POW != 0 &&
-        (m_syncType == SyncType::DS_SYNC ||
-         m_syncType == SyncType::GUARD_DS_SYNC)) {
-      // Coinbase
-      uint128_t rewards = txBlock.GetHeader().GetRewards();
-      LOG_GENERAL(INFO, "Update coin base for finalblock with blockNum: "
-                            << blockNum << ", reward: " << rewards);
-      m_mediator.m_ds->SaveCoinbase(txBlock.GetB1(), txBlock.GetB2(),
-                                    CoinbaseReward::FINALBLOCK_REWARD,
-                                    blockNum + 1);
-      // Need if it join immediately before vacaous. And will be used in
-      // InitCoinbase in final blk consensus in vacaous epoch.
-      m_mediator.m_ds->m_totalTxnFees += rewards;
+      if (m_syncType == SyncType::DS_SYNC ||
+          m_syncType == SyncType::GUARD_DS_SYNC) {
+        // GetCosigRewards for the txBlks of the window are sent together
+        cosigsRewardsBlockNums.emplace_back(blockNum);
+      }
     }
 
-    if ((LOOKUP_NODE_MODE && ARCHIVAL_LOOKUP &&
-         m_syncType == SyncType::NEW_LOOKUP_SYNC) ||
-        (LOOKUP_NODE_MODE && !ARCHIVAL_LOOKUP &&
-         m_syncType == SyncType::LOOKUP_SYNC)) {
-      m_mediator.m_node->LoadUnavailableMicroBlockHashes(
-          txBlock, placeholder, true /*skip shardid check*/);
+    if (!cosigsRewardsBlockNums.empty()) {
+      ComposeAndSendGetCosigsRewardsFromSeed(cosigsRewardsBlockNums);
     }
 
-    if (m_syncType == SyncType::DS_SYNC ||
-        m_syncType == SyncType::GUARD_DS_SYNC) {
-      // Compose And Send GetCosigRewards for this txBlk from seed
-      ComposeAndSendGetCosigsRewardsFromSeed(txBlock.GetHeader().GetBlockNum());
+    if (fetchMicroBlocks && windowEnd < txBlocks.size()) {
+      CheckAndFetchUnavailableMBs(false);
     }
   }
 
+  if (fetchStateDeltas) {
+    // Drop the answers to requests sent again
+    lock_guard<mutex> g(m_mutexSetStateDeltasFromSeed);
+    m_stateDeltaBuffer.clear();
+    m_stateDeltaRange = {0, 0};
+  }
+
   m_mediator.m_currentEpochNum =
       m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
   // To trigger m_isVacuousEpoch calculation
@@ -2360,8 +2770,8 @@ void Lookup::FindMissingMBsForLastNTxBlks(const uint32_t& num) {
   }
 }
 
-const vector<Transaction>& Lookup::GetTxnFromShardMap(uint32_t index) {
-  return m_txnShardMap[index];
+vector<Transaction> Lookup::GetTxnFromShardMap(uint32_t index) const {
+  return m_txnShardMap.GetTxns(index);
 }
 
 bool Lookup::ProcessSetStateDeltaFromSeed(const bytes& message,
@@ -2458,41 +2868,16 @@ bool Lookup::ProcessSetStateDeltasFromSeed(const bytes& message,
     return false;
   }
 
-  int txBlkNum = lowBlockNum;
-  bytes tmp;
-  for (const auto& delta : stateDeltas) {
-    // TBD - To verify state delta hash against one from TxBlk.
-    // But not crucial right now since we do verify sender i.e lookup and
-    // trust it.
+  if (lowBlockNum < m_stateDeltaRange.first ||
+      highBlockNum > m_stateDeltaRange.second) {
+    LOG_GENERAL(WARNING, "StateDeltas were not requested");
+    return false;
+  }
 
-    if (!BlockStorage::GetBlockStorage().GetStateDelta(txBlkNum, tmp)) {
-      if (!AccountStore::GetInstance().DeserializeDelta(delta, 0)) {
-        LOG_GENERAL(WARNING,
-                    "AccountStore::GetInstance().DeserializeDelta failed");
-        return false;
-      }
-      if (!BlockStorage::GetBlockStorage().PutStateDelta(txBlkNum, delta)) {
-        LOG_GENERAL(WARNING, "BlockStorage::PutStateDelta failed");
-        return false;
-      }
-      m_prevStateRootHashTemp = AccountStore::GetInstance().GetStateRootHash();
-    }
-    if ((txBlkNum + 1) % NUM_FINAL_BLOCK_PER_POW == 0) {
-      if (ENABLE_REPOPULATE && ((txBlkNum + 1) % (NUM_FINAL_BLOCK_PER_POW *
-                                                  REPOPULATE_STATE_PER_N_DS) ==
-                                REPOPULATE_STATE_IN_DS)) {
-        if (!AccountStore::GetInstance().MoveUpdatesToDisk(true)) {
-          LOG_GENERAL(WARNING, "AccountStore::MoveUpdatesToDisk(true) failed");
-          return false;
-        }
-      } else if (txBlkNum + NUM_FINAL_BLOCK_PER_POW > highBlockNum) {
-        if (!AccountStore::GetInstance().MoveUpdatesToDisk(false)) {
-          LOG_GENERAL(WARNING, "AccountStore::MoveUpdatesToDisk(false) failed");
-          return false;
-        }
-      }
-    }
-    txBlkNum++;
+  // Applied in order by CommitTxBlocks
+  uint64_t txBlkNum = lowBlockNum;
+  for (auto& delta : stateDeltas) {
+    m_stateDeltaBuffer.emplace(txBlkNum++, move(delta));
   }
 
   cv_setStateDeltasFromSeed.notify_all();
@@ -2510,8 +2895,12 @@ bool Lookup::ProcessSetStateFromSeed(const bytes& message, unsigned int offset,
   unique_lock<mutex> lock(m_mutexSetState);
   PubKey lookupPubKey;
   bytes accountStoreBytes;
+  bool more = false;
+  Address next;
+  dev::h256 stateRoot;
   if (!Messenger::GetLookupSetStateFromSeed(message, offset, lookupPubKey,
-                                            accountStoreBytes)) {
+                                            accountStoreBytes, more, next,
+                                            stateRoot)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::GetLookupSetStateFromSeed failed.");
     return false;
@@ -2524,11 +2913,32 @@ bool Lookup::ProcessSetStateFromSeed(const bytes& message, unsigned int offset,
     return false;
   }
 
-  if (!AccountStore::GetInstance().Deserialize(accountStoreBytes, 0)) {
-    LOG_GENERAL(WARNING, "Deserialize AccountStore Failed");
+  if (stateRoot == dev::h256() || m_stateSyncRoot == dev::h256()) {
+    // The whole state or its first chunk
+    if (!AccountStore::GetInstance().Deserialize(accountStoreBytes, 0)) {
+      LOG_GENERAL(WARNING, "Deserialize AccountStore Failed");
+      return false;
+    }
+    m_stateSyncRoot = stateRoot;
+  } else if (stateRoot != m_stateSyncRoot) {
+    // The chunks so far are of another state, so start again
+    LOG_GENERAL(INFO, "State root changed to " << stateRoot
+                                               << " during state sync");
+    m_stateSyncRoot = dev::h256();
+    SendMessageToRandomSeedNode(ComposeGetStateMessage());
+    return true;
+  } else if (!AccountStore::GetInstance().DeserializeChunk(accountStoreBytes,
+                                                           0)) {
+    LOG_GENERAL(WARNING, "DeserializeChunk AccountStore Failed");
     return false;
   }
 
+  if (more) {
+    SendMessageToRandomSeedNode(ComposeGetStateMessage(next));
+    return true;
+  }
+  m_stateSyncRoot = dev::h256();
+
   if (!LOOKUP_NODE_MODE) {
     if (m_syncType == SyncType::NEW_SYNC ||
         m_syncType == SyncType::NORMAL_SYNC) {
@@ -2767,17 +3177,40 @@ bool Lookup::ProcessSetTxnsFromLookup([[gnu::unused]] const bytes& message,
   LOG_GENERAL(INFO,
               "Received " << txns.size() << " txns for microblock :" << mbHash);
 
+  // The transactions are indexed under the epoch of their microblock
+  MicroBlockSharedPtr microBlock;
+  const bool hasMicroBlock =
+      (ENABLE_TXN_HISTORY_INDEX || ENABLE_EVENT_BLOOM_INDEX) &&
+      BlockStorage::GetBlockStorage().GetMicroBlock(mbHash, microBlock);
+  const bool indexHistory = ENABLE_TXN_HISTORY_INDEX && hasMicroBlock;
+
+  if (ENABLE_EVENT_BLOOM_INDEX && hasMicroBlock) {
+    EventBloom eventBloom;
+    for (const auto& txn : txns) {
+      eventBloom.AddReceipt(txn.GetTransactionReceipt());
+    }
+    if (!BlockStorage::GetBlockStorage().MergeEventBloom(
+            microBlock->GetHeader().GetEpochNum(), eventBloom)) {
+      LOG_GENERAL(WARNING, "BlockStorage::MergeEventBloom failed");
+    }
+  }
+
   for (const auto& txn : txns) {
     bytes serializedTxBody;
     txn.Serialize(serializedTxBody, 0);
 
-    if (!BlockStorage::GetBlockStorage().PutTxBody(
+    if (!BlockStorage::GetBlockStorage().EnqueueTxBody(
             txn.GetTransaction().GetTranID(), serializedTxBody)) {
-      LOG_GENERAL(WARNING, "BlockStorage::PutTxBody failed "
+      LOG_GENERAL(WARNING, "BlockStorage::EnqueueTxBody failed "
                                << txn.GetTransaction().GetTranID());
       continue;  // Transaction already existed locally. Move on so as to delete
                  // the entry from unavailable list
     }
+    if (indexHistory && !BlockStorage::GetBlockStorage().PutTxnHistory(
+                            txn, microBlock->GetHeader().GetEpochNum())) {
+      LOG_GENERAL(WARNING, "BlockStorage::PutTxnHistory failed "
+                               << txn.GetTransaction().GetTranID());
+    }
   }
 
   // Delete the mb from unavailable list here
@@ -3365,6 +3798,28 @@ void Lookup::StartSynchronization() {
   }
 }
 
+void Lookup::StartLightSynchronization() {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Lookup::StartLightSynchronization not expected to be called "
+                "from other than the LookUp node.");
+    return;
+  }
+
+  LOG_MARKER();
+
+  // The light node never joins the network, it keeps pulling the new blocks
+  // from the seeds, which CheckDirBlocks and CheckTxBlocks verify
+  auto func = [this]() -> void {
+    while (GetSyncType() == SyncType::LIGHT_SYNC) {
+      GetDSBlockFromSeedNodes(m_mediator.m_dsBlockChain.GetBlockCount(), 0);
+      GetTxBlockFromSeedNodes(m_mediator.m_txBlockChain.GetBlockCount(), 0);
+      this_thread::sleep_for(chrono::seconds(NEW_NODE_SYNC_INTERVAL));
+    }
+  };
+  DetachedFunction(1, func);
+}
+
 bool Lookup::GetDSInfoLoop() {
   unsigned int counter = 0;
   // Allow over-writing ds committee because of corner case where node rejoined
@@ -3741,25 +4196,34 @@ bool Lookup::ProcessGetDirectoryBlocksFromSeed(const bytes& message,
     return false;
   }
 
+  uint128_t ipAddr = from.m_ipAddress;
+  Peer peer(ipAddr, portNo);
+
+  const uint64_t latestIndex = m_mediator.m_blocklinkchain.GetLatestIndex();
+  if (SendCachedSeedResponse(LookupInstructionType::SETDIRBLOCKSFROMSEED,
+                             index_num, latestIndex, peer)) {
+    return true;
+  }
+
   bytes msg = {MessageType::LOOKUP,
                LookupInstructionType::SETDIRBLOCKSFROMSEED};
 
   vector<boost::variant<DSBlock, VCBlock, FallbackBlockWShardingStructure>>
       dirBlocks;
+  bool complete = true;
 
-  for (uint64_t i = index_num;
-       i <= m_mediator.m_blocklinkchain.GetLatestIndex(); i++) {
-    BlockLink b = m_mediator.m_blocklinkchain.GetBlockLink(i);
-
+  for (const auto& b :
+       m_mediator.m_blocklinkchain.GetBlockLinks(index_num, latestIndex)) {
     if (get<BlockLinkIndex::BLOCKTYPE>(b) == BlockType::DS) {
-      dirBlocks.emplace_back(
-          m_mediator.m_dsBlockChain.GetBlock(get<BlockLinkIndex::DSINDEX>(b)));
+      dirBlocks.emplace_back(*m_mediator.m_dsBlockChain.GetBlockPtr(
+          get<BlockLinkIndex::DSINDEX>(b)));
     } else if (get<BlockLinkIndex::BLOCKTYPE>(b) == BlockType::VC) {
       VCBlockSharedPtr vcblockptr;
       if (!BlockStorage::GetBlockStorage().GetVCBlock(
               get<BlockLinkIndex::BLOCKHASH>(b), vcblockptr)) {
         LOG_GENERAL(WARNING, "could not get vc block "
                                  << get<BlockLinkIndex::BLOCKHASH>(b));
+        complete = false;
         continue;
       }
       dirBlocks.emplace_back(*vcblockptr);
@@ -3769,15 +4233,13 @@ bool Lookup::ProcessGetDirectoryBlocksFromSeed(const bytes& message,
               get<BlockLinkIndex::BLOCKHASH>(b), fallbackwsharding)) {
         LOG_GENERAL(WARNING, "could not get fb block "
                                  << get<BlockLinkIndex::BLOCKHASH>(b));
+        complete = false;
         continue;
       }
       dirBlocks.emplace_back(*fallbackwsharding);
     }
   }
 
-  uint128_t ipAddr = from.m_ipAddress;
-  Peer peer(ipAddr, portNo);
-
   if (!Messenger::SetLookupSetDirectoryBlocksFromSeed(
           msg, MessageOffset::BODY, SHARDINGSTRUCTURE_VERSION, dirBlocks,
           index_num, m_mediator.m_selfKey)) {
@@ -3786,6 +4248,11 @@ bool Lookup::ProcessGetDirectoryBlocksFromSeed(const bytes& message,
     return false;
   }
 
+  if (complete && !dirBlocks.empty()) {
+    CacheSeedResponse(LookupInstructionType::SETDIRBLOCKSFROMSEED, index_num,
+                      latestIndex, msg);
+  }
+
   P2PComm::GetInstance().SendMessage(peer, msg);
 
   return true;
@@ -3958,20 +4425,83 @@ void Lookup::ComposeAndSendGetShardingStructureFromSeed() {
   SendMessageToRandomSeedNode(message);
 }
 
-void Lookup::ComposeAndSendGetCosigsRewardsFromSeed(const uint64_t& block_num) {
+void Lookup::ComposeAndSendGetCosigsRewardsFromSeed(
+    const vector<uint64_t>& blockNums) {
   LOG_MARKER();
-  bytes message = {MessageType::LOOKUP,
-                   LookupInstructionType::GETCOSIGSREWARDSFROMSEED};
 
-  if (!Messenger::SetLookupGetCosigsRewardsFromSeed(
-          message, MessageOffset::BODY, block_num,
-          m_mediator.m_selfPeer.m_listenPortHost, m_mediator.m_selfKey)) {
-    LOG_GENERAL(WARNING, "Messenger::SetLookupGetCosigsRewardsFromSeed");
-    return;
+  const uint64_t maxCount = max(COSIGS_REWARDS_MAX_BLOCKS_PER_REQUEST, 1u);
+  for (size_t i = 0; i < blockNums.size();) {
+    const uint64_t lowBlockNum = blockNums[i];
+    uint64_t count = 1;
+    for (++i; i < blockNums.size() && count < maxCount &&
+              blockNums[i] == lowBlockNum + count;
+         ++i) {
+      ++count;
+    }
+
+    bytes message = {MessageType::LOOKUP,
+                     LookupInstructionType::GETCOSIGSREWARDSFROMSEED};
+
+    if (!Messenger::SetLookupGetCosigsRewardsFromSeed(
+            message, MessageOffset::BODY, lowBlockNum, count,
+            m_mediator.m_selfPeer.m_listenPortHost, m_mediator.m_selfKey)) {
+      LOG_GENERAL(WARNING, "Messenger::SetLookupGetCosigsRewardsFromSeed");
+      return;
+    }
+    LOG_GENERAL(INFO, "Sending req for cosigs/rewards of block num = "
+                          << lowBlockNum << " count = " << count);
+    SendMessageToRandomSeedNode(message);
   }
-  LOG_GENERAL(INFO,
-              "Sending req for cosigs/rewards of block num = " << block_num);
-  SendMessageToRandomSeedNode(message);
+}
+
+bool Lookup::ProcessSubscribeSeed(const bytes& message, unsigned int offset,
+                                  const Peer& from) {
+  LOG_MARKER();
+
+  if (!LOOKUP_NODE_MODE || ARCHIVAL_LOOKUP) {
+    LOG_GENERAL(WARNING,
+                "Lookup::ProcessSubscribeSeed not expected to be called from "
+                "other than the LookUp node.");
+    return true;
+  }
+
+  if (LOOKUP_MAX_SEED_SUBSCRIBERS == 0) {
+    LOG_GENERAL(WARNING, "Seed subscriptions are disabled, ignore " << from);
+    return false;
+  }
+
+  PubKey seedPubKey;
+  uint32_t portNo = 0;
+  if (!Messenger::GetLookupSubscribeSeed(message, offset, seedPubKey,
+                                         portNo)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Messenger::GetLookupSubscribeSeed failed.");
+    return false;
+  }
+
+  const Peer seedPeer(from.m_ipAddress, portNo);
+  const auto now = chrono::steady_clock::now();
+
+  lock_guard<mutex> g(m_mutexSeedSubscribers);
+  if (m_seedSubscribers.find(seedPubKey) == m_seedSubscribers.end()) {
+    if (m_seedSubscribers.size() >= LOOKUP_MAX_SEED_SUBSCRIBERS) {
+      for (auto it = m_seedSubscribers.begin();
+           it != m_seedSubscribers.end();) {
+        it = it->second.second <= now ? m_seedSubscribers.erase(it) : ++it;
+      }
+    }
+    if (m_seedSubscribers.size() >= LOOKUP_MAX_SEED_SUBSCRIBERS) {
+      LOG_GENERAL(WARNING, "Already " << m_seedSubscribers.size()
+                                      << " seeds subscribed, ignore "
+                                      << seedPeer);
+      return false;
+    }
+    LOG_GENERAL(INFO, "Seed " << seedPeer << " subscribed");
+  }
+
+  m_seedSubscribers[seedPubKey] = {
+      seedPeer, now + chrono::seconds(SEED_SUBSCRIPTION_TTL_IN_SEC)};
+  return true;
 }
 
 bool Lookup::Execute(const bytes& message, unsigned int offset,
@@ -4015,7 +4545,8 @@ bool Lookup::Execute(const bytes& message, unsigned int offset,
       &Lookup::ProcessForwardTxn,
       &Lookup::ProcessGetDSGuardNetworkInfo,
       &Lookup::ProcessSetHistoricalDB,
-      &Lookup::ProcessGetCosigsRewardsFromSeed};
+      &Lookup::ProcessGetCosigsRewardsFromSeed,
+      &Lookup::ProcessSubscribeSeed};
 
   const unsigned char ins_byte = message.at(offset);
   const unsigned int ins_handlers_count =
@@ -4056,47 +4587,55 @@ void Lookup::RemoveSeedNodesFromBlackList() {
   }
 }
 
-bool Lookup::AddToTxnShardMap(const Transaction& tx, uint32_t shardId,
-                              TxnShardMap& txnShardMap,
-                              mutex& txnShardMapMutex) {
-  lock_guard<mutex> g(txnShardMapMutex);
-
-  uint32_t size = 0;
+bool Lookup::AddToTxnShardMap(const Transaction& tx, uint32_t shardId) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Lookup::AddToTxnShardMap not expected to be called from "
+                "other than the LookUp node.");
+    return true;
+  }
 
-  for (const auto& x : txnShardMap) {
-    size += x.second.size();
+  if (!ENABLE_PENDING_TXN_PERSISTENCE) {
+    return m_txnShardMap.Add(tx, shardId);
   }
 
-  if (size >= TXN_STORAGE_LIMIT) {
-    LOG_GENERAL(INFO, "Number of txns exceeded limit");
+  shared_lock<shared_timed_mutex> g(m_mutexPendingTxns);
+  if (!m_txnShardMap.Add(tx, shardId)) {
     return false;
   }
+  if (!BlockStorage::GetBlockStorage().PutPendingTxns({tx}, shardId)) {
+    LOG_GENERAL(WARNING, "BlockStorage::PutPendingTxns failed");
+  }
+  return true;
+}
 
-  // case where txn already exist
-  if (find_if(txnShardMap[shardId].begin(), txnShardMap[shardId].end(),
-              [tx](const Transaction& txn) {
-                return tx.GetTranID() == txn.GetTranID();
-              }) != txnShardMap[shardId].end()) {
-    LOG_GENERAL(WARNING, "Same hash present " << tx.GetTranID());
-    return false;
+void Lookup::CompactTxnShardMap() {
+  unique_lock<shared_timed_mutex> g(m_mutexPendingTxns);
+  if (!BlockStorage::GetBlockStorage().RewritePendingTxns(
+          m_txnShardMap.GetAllTxns())) {
+    LOG_GENERAL(WARNING, "BlockStorage::RewritePendingTxns failed");
   }
+}
 
-  txnShardMap[shardId].push_back(tx);
-  LOG_GENERAL(INFO,
-              "Added Txn " << tx.GetTranID().hex() << " to shard " << shardId);
+void Lookup::CacheDispatchedTxns(const vector<Transaction>& txns) {
+  if (!COMPACT_MBNFORWARD_RELAY) {
+    return;
+  }
 
-  return true;
+  for (const auto& tx : txns) {
+    m_dispatchedTxns.Insert(tx.GetTranID(), make_shared<Transaction>(tx),
+                            TxnPool::GetMemorySize(tx));
+  }
 }
 
-bool Lookup::AddToTxnShardMap(const Transaction& tx, uint32_t shardId) {
-  if (!LOOKUP_NODE_MODE) {
-    LOG_GENERAL(WARNING,
-                "Lookup::AddToTxnShardMap not expected to be called from "
-                "other than the LookUp node.");
-    return true;
+bool Lookup::GetDispatchedTxn(const TxnHash& txnHash, Transaction& tx) {
+  shared_ptr<Transaction> cached;
+  if (!m_dispatchedTxns.Lookup(txnHash, cached)) {
+    return false;
   }
 
-  return AddToTxnShardMap(tx, shardId, m_txnShardMap, m_txnShardMapMutex);
+  tx = *cached;
+  return true;
 }
 
 bool Lookup::DeleteTxnShardMap(uint32_t shardId) {
@@ -4107,9 +4646,7 @@ bool Lookup::DeleteTxnShardMap(uint32_t shardId) {
     return true;
   }
 
-  lock_guard<mutex> g(m_txnShardMapMutex);
-
-  m_txnShardMap[shardId].clear();
+  m_txnShardMap.Clear(shardId);
 
   return true;
 }
@@ -4137,6 +4674,14 @@ void Lookup::SenderTxnBatchThread(const uint32_t oldNumShards) {
         numShards = m_mediator.m_ds->GetNumShards();
         SendTxnPacketToNodes(oldNumShards, numShards);
       }
+      // The txns sent or dropped are left in the pendingTxns db until then
+      if (ENABLE_PENDING_TXN_PERSISTENCE &&
+          PENDING_TXN_COMPACTION_INTERVAL_IN_EPOCHS > 0 &&
+          m_mediator.m_currentEpochNum %
+                  PENDING_TXN_COMPACTION_INTERVAL_IN_EPOCHS ==
+              0) {
+        CompactTxnShardMap();
+      }
       break;
     }
     m_startedTxnBatchThread = false;
@@ -4150,40 +4695,29 @@ void Lookup::RectifyTxnShardMap(const uint32_t oldNumShards,
 
   auto t_start = std::chrono::high_resolution_clock::now();
 
-  map<uint, vector<Transaction>> tempTxnShardMap;
-
-  lock_guard<mutex> g(m_txnShardMapMutex);
-
   LOG_GENERAL(INFO, "Shard dropped or gained, shuffling txn shard map");
   LOG_GENERAL(INFO, "New Shard Size: " << newNumShards
                                        << "  Old Shard Size: " << oldNumShards);
-  for (const auto& shard : m_txnShardMap) {
-    if (shard.first == oldNumShards) {
+  m_txnShardMap.Reassign([oldNumShards, newNumShards](
+                             uint32_t shardId, const Transaction& tx) {
+    if (shardId == oldNumShards) {
       // ds txns
-      continue;
+      return newNumShards;
     }
-    for (const auto& tx : shard.second) {
-      unsigned int fromShard = tx.GetShardIndex(newNumShards);
-
-      if (Transaction::GetTransactionType(tx) == Transaction::CONTRACT_CALL) {
-        // if shard do not match directly send to ds
-        unsigned int toShard =
-            Transaction::GetShardIndex(tx.GetToAddr(), newNumShards);
-        if (toShard != fromShard) {
-          // later would be placed in the new ds shard
-          m_txnShardMap[oldNumShards].emplace_back(tx);
-          continue;
-        }
-      }
 
-      tempTxnShardMap[fromShard].emplace_back(tx);
-    }
-  }
-  tempTxnShardMap[newNumShards] = move(m_txnShardMap[oldNumShards]);
+    unsigned int fromShard = tx.GetShardIndex(newNumShards);
 
-  m_txnShardMap.clear();
+    if (Transaction::GetTransactionType(tx) == Transaction::CONTRACT_CALL) {
+      // if shard do not match directly send to ds
+      unsigned int toShard =
+          Transaction::GetShardIndex(tx.GetToAddr(), newNumShards);
+      if (toShard != fromShard) {
+        return newNumShards;
+      }
+    }
 
-  m_txnShardMap = move(tempTxnShardMap);
+    return fromShard;
+  });
 
   auto t_end = std::chrono::high_resolution_clock::now();
 
@@ -4193,6 +4727,139 @@ void Lookup::RectifyTxnShardMap(const uint32_t oldNumShards,
   LOG_GENERAL(INFO, "Elapsed time for exchange " << elaspedTimeMs);
 }
 
+bool Lookup::GetTxnPacketRecipients(const uint32_t shardId,
+                                    const uint32_t numShards,
+                                    vector<Peer>& toSend) {
+  toSend.clear();
+
+  if (shardId < numShards) {
+    lock_guard<mutex> g(m_mediator.m_ds->m_mutexShards);
+    if (m_mediator.m_ds->m_shards.at(shardId).empty()) {
+      return false;
+    }
+    uint16_t lastBlockHash = DataConversion::charArrTo16Bits(
+        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
+    uint32_t leader_id = m_mediator.m_node->CalculateShardLeaderFromShard(
+        lastBlockHash, m_mediator.m_ds->m_shards.at(shardId).size(),
+        m_mediator.m_ds->m_shards.at(shardId));
+    LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+              "Shard leader id " << leader_id);
+
+    auto it = m_mediator.m_ds->m_shards.at(shardId).begin();
+    // Lookup sends to NUM_NODES_TO_SEND_LOOKUP + Leader
+    unsigned int num_node_to_send = NUM_NODES_TO_SEND_LOOKUP;
+    for (unsigned int j = 0;
+         j < num_node_to_send &&
+         it != m_mediator.m_ds->m_shards.at(shardId).end();
+         j++, it++) {
+      if (distance(m_mediator.m_ds->m_shards.at(shardId).begin(), it) ==
+          leader_id) {
+        num_node_to_send++;
+      } else {
+        toSend.push_back(std::get<SHARD_NODE_PEER>(*it));
+        LOG_GENERAL(INFO, "Sent to node " << get<SHARD_NODE_PEER>(*it));
+      }
+    }
+    return true;
+  }
+
+  // To send DS
+  lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
+
+  if (m_mediator.m_DSCommittee->empty()) {
+    return false;
+  }
+
+  // Send to NUM_NODES_TO_SEND_LOOKUP which including DS leader
+  PairOfNode dsLeader;
+  if (Node::GetDSLeader(m_mediator.m_blocklinkchain.GetLatestBlockLink(),
+                        m_mediator.m_dsBlockChain.GetLastBlock(),
+                        *m_mediator.m_DSCommittee, dsLeader)) {
+    toSend.push_back(dsLeader.second);
+  }
+
+  for (auto const& i : *m_mediator.m_DSCommittee) {
+    if (toSend.size() < NUM_NODES_TO_SEND_LOOKUP &&
+        i.second != dsLeader.second) {
+      toSend.push_back(i.second);
+    }
+
+    if (toSend.size() >= NUM_NODES_TO_SEND_LOOKUP) {
+      break;
+    }
+  }
+  return true;
+}
+
+void Lookup::StreamTxnPacketsToShard(
+    const uint32_t shardId, const uint32_t numShards,
+    const vector<Transaction>& genTxns,
+    const chrono::steady_clock::time_point& deadline) {
+  vector<Peer> toSend;
+  if (!GetTxnPacketRecipients(shardId, numShards, toSend)) {
+    LOG_GENERAL(INFO, "No nodes to send txns to for shard " << shardId);
+    return;
+  }
+
+  bool genTxnsSent = genTxns.empty();
+  const vector<Transaction> noTxns;
+  const uint64_t dsBlockNum =
+      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+
+  while (true) {
+    // Whatever is left at the deadline goes out in one go
+    const bool lastRound = chrono::steady_clock::now() >= deadline;
+    const vector<Transaction> txns =
+        m_txnShardMap.Take(shardId, LOOKUP_TXN_PACKET_SIZE);
+
+    if (!txns.empty() || !genTxnsSent) {
+      bytes msg = {MessageType::NODE, NodeInstructionType::FORWARDTXNPACKET};
+      if (!Messenger::SetNodeForwardTxnBlock(
+              msg, MessageOffset::BODY, m_mediator.m_currentEpochNum,
+              dsBlockNum, shardId, m_mediator.m_selfKey, txns,
+              genTxnsSent ? noTxns : genTxns, LOOKUP_TXN_PACKET_ATTESTATION)) {
+        LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+                  "Messenger::SetNodeForwardTxnBlock failed.");
+        LOG_GENERAL(WARNING, "Cannot create packet for " << shardId
+                                                         << " shard");
+        // Keep them for the next epoch
+        for (const auto& tx : txns) {
+          m_txnShardMap.Add(tx, shardId);
+        }
+        return;
+      }
+
+      P2PComm::GetInstance().SendBroadcastMessage(toSend, msg);
+      CacheDispatchedTxns(txns);
+      if (!genTxnsSent) {
+        CacheDispatchedTxns(genTxns);
+      }
+      if (shardId == numShards) {
+        LOG_GENERAL(INFO, "[DSMB]"
+                              << " Sent DS the txns");
+      } else {
+        LOG_GENERAL(INFO,
+                    "Sent " << txns.size() << " txns to shard " << shardId);
+      }
+      genTxnsSent = true;
+
+      if (txns.size() == LOOKUP_TXN_PACKET_SIZE) {
+        // More may be waiting
+        continue;
+      }
+    }
+
+    if (lastRound) {
+      return;
+    }
+
+    this_thread::sleep_for(
+        min<chrono::steady_clock::duration>(
+            chrono::milliseconds(LOOKUP_TXN_STREAM_INTERVAL_IN_MS),
+            deadline - chrono::steady_clock::now()));
+  }
+}
+
 void Lookup::SendTxnPacketToNodes(const uint32_t oldNumShards,
                                   const uint32_t newNumShards) {
   LOG_MARKER();
@@ -4220,106 +4887,23 @@ void Lookup::SendTxnPacketToNodes(const uint32_t oldNumShards,
     DetachedFunction(1, rectifyFunc);
   }
 
-  this_thread::sleep_for(
-      chrono::milliseconds(LOOKUP_DELAY_SEND_TXNPACKET_IN_MS));
+  // Txns are streamed to every shard and the DS committee side by side, and
+  // the last of them go out at the end of the send delay
+  const auto deadline =
+      chrono::steady_clock::now() +
+      chrono::milliseconds(LOOKUP_DELAY_SEND_TXNPACKET_IN_MS);
 
+  vector<thread> senders;
   for (unsigned int i = 0; i < numShards + 1; i++) {
-    bytes msg = {MessageType::NODE, NodeInstructionType::FORWARDTXNPACKET};
-    bool result = false;
-
-    {
-      lock_guard<mutex> g(m_txnShardMapMutex);
-      auto transactionNumber = mp[i].size();
-
-      LOG_GENERAL(INFO, "Txn number generated: " << transactionNumber);
-
-      if (GetTxnFromShardMap(i).empty() && mp[i].empty()) {
-        LOG_GENERAL(INFO, "No txns to send to shard " << i);
-        continue;
-      }
-
-      result = Messenger::SetNodeForwardTxnBlock(
-          msg, MessageOffset::BODY, m_mediator.m_currentEpochNum,
-          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum(), i,
-          m_mediator.m_selfKey, GetTxnFromShardMap(i), mp[i]);
-    }
-
-    if (!result) {
-      LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
-                "Messenger::SetNodeForwardTxnBlock failed.");
-      LOG_GENERAL(WARNING, "Cannot create packet for " << i << " shard");
-      continue;
-    }
-    vector<Peer> toSend;
-    if (i < numShards) {
-      {
-        lock_guard<mutex> g(m_mediator.m_ds->m_mutexShards);
-        uint16_t lastBlockHash = DataConversion::charArrTo16Bits(
-            m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
-        uint32_t leader_id = m_mediator.m_node->CalculateShardLeaderFromShard(
-            lastBlockHash, m_mediator.m_ds->m_shards.at(i).size(),
-            m_mediator.m_ds->m_shards.at(i));
-        LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-                  "Shard leader id " << leader_id);
-
-        auto it = m_mediator.m_ds->m_shards.at(i).begin();
-        // Lookup sends to NUM_NODES_TO_SEND_LOOKUP + Leader
-        unsigned int num_node_to_send = NUM_NODES_TO_SEND_LOOKUP;
-        for (unsigned int j = 0; j < num_node_to_send &&
-                                 it != m_mediator.m_ds->m_shards.at(i).end();
-             j++, it++) {
-          if (distance(m_mediator.m_ds->m_shards.at(i).begin(), it) ==
-              leader_id) {
-            num_node_to_send++;
-          } else {
-            toSend.push_back(std::get<SHARD_NODE_PEER>(*it));
-            LOG_GENERAL(INFO, "Sent to node " << get<SHARD_NODE_PEER>(*it));
-          }
-        }
-        if (m_mediator.m_ds->m_shards.at(i).empty()) {
-          continue;
-        }
-      }
-
-      P2PComm::GetInstance().SendBroadcastMessage(toSend, msg);
-
-      DeleteTxnShardMap(i);
-    } else if (i == numShards) {
-      // To send DS
-      {
-        lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
-
-        if (m_mediator.m_DSCommittee->empty()) {
-          continue;
-        }
-
-        // Send to NUM_NODES_TO_SEND_LOOKUP which including DS leader
-        PairOfNode dsLeader;
-        if (Node::GetDSLeader(m_mediator.m_blocklinkchain.GetLatestBlockLink(),
-                              m_mediator.m_dsBlockChain.GetLastBlock(),
-                              *m_mediator.m_DSCommittee, dsLeader)) {
-          toSend.push_back(dsLeader.second);
-        }
-
-        for (auto const& i : *m_mediator.m_DSCommittee) {
-          if (toSend.size() < NUM_NODES_TO_SEND_LOOKUP &&
-              i.second != dsLeader.second) {
-            toSend.push_back(i.second);
-          }
-
-          if (toSend.size() >= NUM_NODES_TO_SEND_LOOKUP) {
-            break;
-          }
-        }
-      }
-
-      P2PComm::GetInstance().SendBroadcastMessage(toSend, msg);
-
-      LOG_GENERAL(INFO, "[DSMB]"
-                            << " Sent DS the txns");
+    const vector<Transaction>& genTxns = mp[i];
+    LOG_GENERAL(INFO, "Txn number generated: " << genTxns.size());
+    senders.emplace_back([this, i, numShards, &genTxns, deadline]() {
+      StreamTxnPacketsToShard(i, numShards, genTxns, deadline);
+    });
+  }
 
-      DeleteTxnShardMap(i);
-    }
+  for (auto& sender : senders) {
+    sender.join();
   }
 }
 
@@ -4410,6 +4994,22 @@ bool Lookup::ProcessForwardTxn(const bytes& message, unsigned int offset,
 
   LOG_GENERAL(INFO, "Recvd from " << from);
 
+  // The packets of this lookup attest the txns as verified, so the ones the
+  // seed checked are verified here once instead of at every shard node
+  if (LOOKUP_TXN_PACKET_ATTESTATION) {
+    const auto isInvalid = [](const Transaction& txn) {
+      if (!Validator::VerifyTransaction(txn)) {
+        LOG_GENERAL(WARNING, "Txn " << txn.GetTranID() << " not verified");
+        return true;
+      }
+      return false;
+    };
+    txnsShard.erase(remove_if(txnsShard.begin(), txnsShard.end(), isInvalid),
+                    txnsShard.end());
+    txnsDS.erase(remove_if(txnsDS.begin(), txnsDS.end(), isInvalid),
+                 txnsDS.end());
+  }
+
   if (!ARCHIVAL_LOOKUP) {
     uint32_t shard_size = m_mediator.m_ds->GetNumShards();
 
@@ -4521,6 +5121,13 @@ void Lookup::SetSyncType(SyncType syncType) {
             "Set sync type to " << syncType);
 }
 
+void Lookup::RefreshLookupServerCache() {
+  if (m_lookupServer) {
+    m_lookupServer->IndexTxnCounts();
+    m_lookupServer->RefreshResponseCache();
+  }
+}
+
 bool Lookup::ProcessGetDSGuardNetworkInfo(const bytes& message,
                                           unsigned int offset,
                                           const Peer& from) {
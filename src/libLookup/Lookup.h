@@ -24,20 +24,25 @@
 #include <cstdlib>
 #include <map>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <Schnorr.h>
 #include "common/Executable.h"
+#include "libCrypto/PubKeyHash.h"
 #include "libData/AccountData/Transaction.h"
 #include "libData/BlockData/Block/DSBlock.h"
 #include "libData/BlockData/Block/MicroBlock.h"
 #include "libData/BlockData/Block/TxBlock.h"
 #include "libNetwork/Peer.h"
 #include "libNetwork/ShardStruct.h"
+#include "libPersistence/BlockCache.h"
 #include "libUtils/IPConverter.h"
 #include "libUtils/Logger.h"
+#include "TxBlockDownloader.h"
+#include "TxnShardPool.h"
 
 #include <condition_variable>
 #include <map>
@@ -49,11 +54,6 @@ class Mediator;
 class Synchronizer;
 class LookupServer;
 
-// The "first" element in the pair is a map of shard to its transactions
-// The "second" element in the pair counts the total number of transactions in
-// the whole map
-using TxnShardMap = std::map<uint32_t, std::vector<Transaction>>;
-
 // Enum used to tell send type to seed node
 enum SEND_TYPE { ARCHIVAL_SEND_SHARD = 0, ARCHIVAL_SEND_DS };
 
@@ -118,23 +118,91 @@ class Lookup : public Executable {
   std::mutex m_mutexSetTxBlockFromSeed;
   std::mutex m_mutexSetTxBodyFromSeed;
   std::mutex m_mutexSetState;
+  // State root of the chunks of the state received so far, zero before the
+  // first one
+  dev::h256 m_stateSyncRoot;
   std::mutex mutable m_mutexLookupNodes;
   std::mutex m_mutexCheckDirBlocks;
   std::mutex m_mutexMicroBlocksBuffer;
 
-  TxnShardMap m_txnShardMap;
+  // Seeds subscribed to the blocks this lookup receives, with the peer the
+  // blocks go to and the time the subscription runs out
+  PubKeyHashMap<std::pair<Peer, std::chrono::steady_clock::time_point>>
+      m_seedSubscribers;
+  std::mutex m_mutexSeedSubscribers;
+
+  TxnShardPool m_txnShardMap{
+      TXN_STORAGE_LIMIT,
+      static_cast<uint64_t>(TXN_STORAGE_MEMORY_LIMIT_IN_MB) * 1024 * 1024};
+  // Held shared to add to m_txnShardMap and unique to compact its copy in
+  // the pendingTxns db, so that no txn added meanwhile is left out
+  std::shared_timed_mutex m_mutexPendingTxns;
 
   // Get StateDeltas from seed
   std::mutex m_mutexSetStateDeltasFromSeed;
   std::condition_variable cv_setStateDeltasFromSeed;
 
+  // State deltas received for the tx blocks being committed, and the range
+  // of those blocks
+  std::map<uint64_t, bytes> m_stateDeltaBuffer;
+  std::pair<uint64_t, uint64_t> m_stateDeltaRange;
+
+  /// Waits until the state deltas of lowBlockNum to highBlockNum are all
+  /// received, requesting them again on timeout
+  bool WaitForStateDeltas(uint64_t lowBlockNum, uint64_t highBlockNum);
+
+  /// Applies the received state deltas of lowBlockNum to highBlockNum, in a
+  /// commit that ends at lastBlockNum
+  bool ApplyStateDeltas(uint64_t lowBlockNum, uint64_t highBlockNum,
+                        uint64_t lastBlockNum, unsigned int& numApplied);
+
   // TxBlockBuffer
   std::vector<TxBlock> m_txBlockBuffer;
 
+  // Encoded responses of a seed for complete block ranges, keyed by response
+  // type and range. The blocks of a range never change once final.
+  BlockCache<std::string, bytes> m_seedResponseCache{
+      static_cast<size_t>(SEED_RESPONSE_CACHE_SIZE_IN_MB) * 1024 * 1024};
+
+  // Txns sent to the shards, for rebuilding the microblocks that shard nodes
+  // forward with the txn hashes only
+  BlockCache<TxnHash, Transaction> m_dispatchedTxns{
+      COMPACT_MBNFORWARD_RELAY
+          ? static_cast<size_t>(COMPACT_RELAY_TXN_CACHE_SIZE_IN_MB) * 1024 *
+                1024
+          : 0};
+
+  void CacheDispatchedTxns(const std::vector<Transaction>& txns);
+
+  /// Sends the cached response of type ins for the range to peer. Returns
+  /// false if it is not cached.
+  bool SendCachedSeedResponse(unsigned char ins, uint64_t lowBlockNum,
+                              uint64_t highBlockNum, const Peer& peer);
+  void CacheSeedResponse(unsigned char ins, uint64_t lowBlockNum,
+                         uint64_t highBlockNum, const bytes& message);
+
+  // Tx blocks requested from several seeds at once
+  TxBlockDownloader m_txBlockDownloader{
+      TXBLOCK_DOWNLOAD_MAX_CHUNKS, TXBLOCK_DOWNLOAD_CHUNK_SIZE,
+      TXBLOCK_DOWNLOAD_TIMEOUT_IN_SECONDS, TXBLOCK_DOWNLOAD_RETRY_COUNT};
+
+  void SendTxBlockRequests(
+      const std::vector<TxBlockDownloader::Request>& requests);
+
+  /// Moves the timed out tx block chunks to other seeds until the download
+  /// completes or is given up
+  void PollTxBlockDownload();
+
   std::shared_ptr<LookupServer> m_lookupServer;
 
+  /// Gets the cosigs and rewards record of the tx block blockNum, made from
+  /// the stored blocks and kept if not stored yet. The blocks are read up to
+  /// retries times, a second apart.
+  bool GetCosigsRewardsRecord(const uint64_t& blockNum, bytes& record,
+                              int retries);
+
   bytes ComposeGetDSInfoMessage(bool initialDS = false);
-  bytes ComposeGetStateMessage();
+  bytes ComposeGetStateMessage(const Address& cursor = Address());
 
   bytes ComposeGetDSBlockMessage(uint64_t lowBlockNum, uint64_t highBlockNum);
   bytes ComposeGetTxBlockMessage(uint64_t lowBlockNum, uint64_t highBlockNum);
@@ -179,10 +247,7 @@ class Lookup : public Executable {
   // Getter for m_seedNodes
   VectorOfNode GetSeedNodes() const;
 
-  std::mutex m_txnShardMapMutex;
-
-  const std::vector<Transaction>& GetTxnFromShardMap(
-      uint32_t index);  // Use m_txnShardMapMutex with this function
+  std::vector<Transaction> GetTxnFromShardMap(uint32_t index) const;
 
   std::mutex m_mutexShardStruct;
   std::condition_variable cv_shardStruct;
@@ -216,6 +281,16 @@ class Lookup : public Executable {
 
   void SendMessageToRandomSeedNode(const bytes& message) const;
 
+  /// Asks the upper seeds to push the blocks they receive to this seed, and
+  /// renews the subscription before it runs out
+  void StartSeedSubscription();
+
+  /// Pushes a block message this lookup has processed to the subscribed seeds
+  void RelayToSeedSubscribers(const bytes& message);
+
+  // Resolved seed peers that are neither blacklisted nor myself
+  VectorOfPeer GetNotBlackListedSeedNodes() const;
+
   void RectifyTxnShardMap(const uint32_t, const uint32_t);
 
   // TODO: move the Get and ProcessSet functions to Synchronizer
@@ -228,6 +303,7 @@ class Lookup : public Executable {
   bool GetStateDeltaFromSeedNodes(const uint64_t& blockNum);
   bool GetStateDeltasFromSeedNodes(uint64_t lowBlockNum, uint64_t highBlockNum);
 
+  /// Asks for the state, STATE_EXPORT_CHUNK_ACCOUNTS accounts at a time
   bool GetStateFromSeedNodes();
   // UNUSED
   bool ProcessGetShardFromSeed([[gnu::unused]] const bytes& message,
@@ -250,6 +326,10 @@ class Lookup : public Executable {
   // Start synchronization with other lookup nodes as a lookup node
   void StartSynchronization();
 
+  // Follow the DS and tx blocks from the seed nodes, without the microblocks
+  // and the state, as a light node
+  void StartLightSynchronization();
+
   // Set my lookup ip offline in other lookup nodes
   bool GetMyLookupOffline();
 
@@ -264,9 +344,14 @@ class Lookup : public Executable {
   void RejoinAsNewLookup(bool fromLookup = true);
 
   bool AddToTxnShardMap(const Transaction& tx, uint32_t shardId);
-  static bool AddToTxnShardMap(const Transaction& tx, uint32_t shardId,
-                               TxnShardMap& txnShardMap,
-                               std::mutex& txnShardMapMutex);
+
+  /// Rewrites the pending transactions from the txn shard map
+  void CompactTxnShardMap();
+
+  bool IsTxnShardMapFull() const { return m_txnShardMap.IsFull(); }
+
+  /// Gets a txn this lookup sent to a shard, if it is still cached
+  bool GetDispatchedTxn(const TxnHash& txnHash, Transaction& tx);
 
   void CheckBufferTxBlocks();
 
@@ -279,6 +364,18 @@ class Lookup : public Executable {
   void SenderTxnBatchThread(const uint32_t);
 
   void SendTxnPacketToNodes(const uint32_t, const uint32_t);
+
+  /// Peers a txn packet for the shard (or the DS committee, for shardId ==
+  /// numShards) is sent to. Returns false if there are none.
+  bool GetTxnPacketRecipients(const uint32_t shardId, const uint32_t numShards,
+                              std::vector<Peer>& toSend);
+
+  /// Sends the txns held for the shard in packets of LOOKUP_TXN_PACKET_SIZE,
+  /// as they come in, until the deadline
+  void StreamTxnPacketsToShard(
+      const uint32_t shardId, const uint32_t numShards,
+      const std::vector<Transaction>& genTxns,
+      const std::chrono::steady_clock::time_point& deadline);
   bool ProcessEntireShardingStructure();
   bool ProcessGetDSInfoFromSeed(const bytes& message, unsigned int offset,
                                 const Peer& from);
@@ -371,10 +468,22 @@ class Lookup : public Executable {
   bool ProcessGetCosigsRewardsFromSeed(const bytes& message,
                                        unsigned int offset, const Peer& from);
 
+  bool ProcessSubscribeSeed(const bytes& message, unsigned int offset,
+                            const Peer& from);
+
   void ComposeAndSendGetDirectoryBlocksFromSeed(const uint64_t& index_num,
                                                 bool toSendSeed = true);
 
-  void ComposeAndSendGetCosigsRewardsFromSeed(const uint64_t& block_num);
+  /// Requests the cosigs and rewards of the ascending blockNums, one request
+  /// per run of consecutive blocks of up to
+  /// COSIGS_REWARDS_MAX_BLOCKS_PER_REQUEST
+  void ComposeAndSendGetCosigsRewardsFromSeed(
+      const std::vector<uint64_t>& blockNums);
+
+  /// Keeps the cosigs and rewards record of the tx block blockNum once all
+  /// of its microblocks are stored, so that requests for it are served
+  /// without reading the blocks
+  void StoreCosigsRewardsRecord(const uint64_t& blockNum);
 
   static bool VerifySenderNode(const VectorOfNode& vecNodes,
                                const PubKey& pubKeyToVerify);
@@ -410,6 +519,14 @@ class Lookup : public Executable {
     m_lookupServer = std::move(lookupServer);
   }
 
+  const std::shared_ptr<LookupServer>& GetLookupServer() const {
+    return m_lookupServer;
+  }
+
+  /// Refreshes the responses the lookup server caches and indexes the txn
+  /// counts of the new tx blocks, as a block was added
+  void RefreshLookupServerCache();
+
   bool m_fetchedOfflineLookups = false;
   std::mutex m_mutexOfflineLookupsUpdation;
   std::condition_variable cv_offlineLookups;
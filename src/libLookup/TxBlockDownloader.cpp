@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "TxBlockDownloader.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+vector<TxBlockDownloader::Request> TxBlockDownloader::Start(
+    uint64_t lowBlockNum, uint64_t highBlockNum, const vector<Peer>& peers,
+    const Clock::time_point& now) {
+  lock_guard<mutex> g(m_mutex);
+
+  if (m_active || peers.empty()) {
+    return {};
+  }
+
+  // Seeds serve a lowBlockNum of 0 from block 1
+  lowBlockNum = max<uint64_t>(lowBlockNum, 1);
+
+  uint64_t numChunks = min<uint64_t>(max(m_maxChunks, 1u), peers.size());
+  uint64_t chunkSize = max(m_chunkSize, 1u);
+  if (highBlockNum != 0) {
+    const uint64_t numBlocks =
+        highBlockNum >= lowBlockNum ? highBlockNum - lowBlockNum + 1 : 1;
+    numChunks = min(numChunks, (numBlocks + chunkSize - 1) / chunkSize);
+    chunkSize = (numBlocks + numChunks - 1) / numChunks;
+    numChunks = (numBlocks + chunkSize - 1) / chunkSize;
+  }
+
+  m_active = true;
+  m_lowBlockNum = lowBlockNum;
+  m_peers = peers;
+  m_chunks.clear();
+  m_txBlocks.clear();
+
+  vector<Request> requests;
+  for (uint64_t i = 0; i < numChunks; i++) {
+    const uint64_t low = lowBlockNum + i * chunkSize;
+    uint64_t high = low + chunkSize - 1;
+    if (i + 1 == numChunks) {
+      high = highBlockNum;
+    }
+    const auto peerIndex = static_cast<unsigned int>(i % peers.size());
+    m_chunks.push_back({low, high, peerIndex, now, 0, ChunkState::PENDING});
+    requests.emplace_back(MakeRequest(m_chunks.back()));
+  }
+
+  LOG_GENERAL(INFO, "Downloading tx blocks from "
+                        << lowBlockNum << " in " << numChunks << " chunks from "
+                        << peers.size() << " seeds");
+
+  return requests;
+}
+
+bool TxBlockDownloader::OnResponse(const Peer& from, uint64_t lowBlockNum,
+                                   uint64_t highBlockNum,
+                                   const vector<TxBlock>& txBlocks) {
+  lock_guard<mutex> g(m_mutex);
+
+  auto chunk = FindChunk(from, lowBlockNum, highBlockNum);
+  if (chunk == m_chunks.end()) {
+    return false;
+  }
+
+  chunk->m_state = ChunkState::DONE;
+  for (const auto& txBlock : txBlocks) {
+    const uint64_t blockNum = txBlock.GetHeader().GetBlockNum();
+    if (blockNum >= m_lowBlockNum) {
+      m_txBlocks.emplace(blockNum, txBlock);
+    }
+  }
+
+  return true;
+}
+
+void TxBlockDownloader::OnFailure(const Peer& from) {
+  lock_guard<mutex> g(m_mutex);
+
+  for (auto& chunk : m_chunks) {
+    if (chunk.m_state != ChunkState::DONE &&
+        m_peers[chunk.m_peerIndex].GetIpAddress() == from.GetIpAddress()) {
+      chunk.m_state = ChunkState::FAILED;
+    }
+  }
+}
+
+vector<TxBlockDownloader::Request> TxBlockDownloader::Poll(
+    const Clock::time_point& now) {
+  lock_guard<mutex> g(m_mutex);
+
+  vector<Request> requests;
+  if (!m_active) {
+    return requests;
+  }
+
+  for (auto& chunk : m_chunks) {
+    if (chunk.m_state == ChunkState::DONE ||
+        (chunk.m_state == ChunkState::PENDING &&
+         now < chunk.m_sentAt + m_timeout)) {
+      continue;
+    }
+
+    if (chunk.m_retries >= m_retryCount) {
+      LOG_GENERAL(WARNING, "Giving up tx blocks from "
+                               << chunk.m_lowBlockNum << " after "
+                               << chunk.m_retries << " retries");
+      m_active = false;
+      m_chunks.clear();
+      m_txBlocks.clear();
+      return {};
+    }
+
+    chunk.m_peerIndex = (chunk.m_peerIndex + 1) % m_peers.size();
+    chunk.m_sentAt = now;
+    chunk.m_retries++;
+    chunk.m_state = ChunkState::PENDING;
+    requests.emplace_back(MakeRequest(chunk));
+  }
+
+  return requests;
+}
+
+bool TxBlockDownloader::TakeBlocks(vector<TxBlock>& txBlocks) {
+  lock_guard<mutex> g(m_mutex);
+
+  if (!m_active ||
+      any_of(m_chunks.begin(), m_chunks.end(), [](const Chunk& chunk) {
+        return chunk.m_state != ChunkState::DONE;
+      })) {
+    return false;
+  }
+
+  txBlocks.clear();
+  for (auto& it : m_txBlocks) {
+    if (!txBlocks.empty() &&
+        it.first != txBlocks.back().GetHeader().GetBlockNum() + 1) {
+      LOG_GENERAL(WARNING, "Missing tx blocks from "
+                               << txBlocks.back().GetHeader().GetBlockNum() + 1
+                               << " to " << it.first - 1);
+      break;
+    }
+    txBlocks.emplace_back(move(it.second));
+  }
+
+  m_active = false;
+  m_chunks.clear();
+  m_txBlocks.clear();
+  return true;
+}
+
+bool TxBlockDownloader::IsActive() const {
+  lock_guard<mutex> g(m_mutex);
+  return m_active;
+}
+
+void TxBlockDownloader::Reset() {
+  lock_guard<mutex> g(m_mutex);
+  m_active = false;
+  m_chunks.clear();
+  m_txBlocks.clear();
+}
+
+TxBlockDownloader::Request TxBlockDownloader::MakeRequest(
+    const Chunk& chunk) const {
+  return {chunk.m_lowBlockNum, chunk.m_highBlockNum,
+          m_peers[chunk.m_peerIndex]};
+}
+
+vector<TxBlockDownloader::Chunk>::iterator TxBlockDownloader::FindChunk(
+    const Peer& from, uint64_t lowBlockNum, uint64_t highBlockNum) {
+  return find_if(m_chunks.begin(), m_chunks.end(), [&](const Chunk& chunk) {
+    return chunk.m_state == ChunkState::PENDING &&
+           m_peers[chunk.m_peerIndex].GetIpAddress() == from.GetIpAddress() &&
+           chunk.m_lowBlockNum <= lowBlockNum &&
+           (chunk.m_highBlockNum == 0 || chunk.m_highBlockNum == highBlockNum);
+  });
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBLOOKUP_TXBLOCKDOWNLOADER_H_
+#define ZILLIQA_SRC_LIBLOOKUP_TXBLOCKDOWNLOADER_H_
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "libData/BlockData/Block/TxBlock.h"
+#include "libNetwork/Peer.h"
+
+/// Downloads a range of tx blocks from several seeds at once. The range is
+/// split into chunks that are requested from different seeds. A chunk that is
+/// not answered in time, or whose answer is rejected, is requested again from
+/// the next seed. Once every chunk is answered, the blocks are handed out in
+/// order, so that they can be committed as one range.
+class TxBlockDownloader {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Blocks lowBlockNum to highBlockNum to be requested from peer, with a
+  /// highBlockNum of 0 meaning up to the latest block
+  struct Request {
+    uint64_t m_lowBlockNum;
+    uint64_t m_highBlockNum;
+    Peer m_peer;
+  };
+
+  TxBlockDownloader(unsigned int maxChunks, unsigned int chunkSize,
+                    unsigned int timeoutInSeconds, unsigned int retryCount)
+      : m_maxChunks(maxChunks),
+        m_chunkSize(chunkSize),
+        m_timeout(timeoutInSeconds),
+        m_retryCount(retryCount) {}
+
+  /// Plans the download of lowBlockNum to highBlockNum, a highBlockNum of 0
+  /// meaning up to the latest block, and returns the requests to send. The
+  /// chunks are given to the peers in order and the last chunk of an open
+  /// range is open too. Does nothing while a download is ongoing.
+  std::vector<Request> Start(uint64_t lowBlockNum, uint64_t highBlockNum,
+                             const std::vector<Peer>& peers,
+                             const Clock::time_point& now);
+
+  /// Records the blocks sent by from for lowBlockNum to highBlockNum, as the
+  /// seed echoes them. A seed may move lowBlockNum up to the start of its DS
+  /// epoch and sets the highBlockNum of an open range. Returns false if no
+  /// such chunk was outstanding with from.
+  bool OnResponse(const Peer& from, uint64_t lowBlockNum,
+                  uint64_t highBlockNum, const std::vector<TxBlock>& txBlocks);
+
+  /// Drops the answer of from so that its chunk is requested again
+  void OnFailure(const Peer& from);
+
+  /// Returns the requests that move the timed out or failed chunks to the
+  /// next seed. Gives the download up if a chunk is out of retries.
+  std::vector<Request> Poll(const Clock::time_point& now);
+
+  /// Once every chunk is answered, moves out the contiguous blocks from the
+  /// lowest one received and ends the download. Returns false until then.
+  bool TakeBlocks(std::vector<TxBlock>& txBlocks);
+
+  bool IsActive() const;
+
+  void Reset();
+
+ private:
+  enum class ChunkState : unsigned char { PENDING, FAILED, DONE };
+
+  struct Chunk {
+    uint64_t m_lowBlockNum;
+    uint64_t m_highBlockNum;
+    unsigned int m_peerIndex;
+    Clock::time_point m_sentAt;
+    unsigned int m_retries;
+    ChunkState m_state;
+  };
+
+  Request MakeRequest(const Chunk& chunk) const;
+  std::vector<Chunk>::iterator FindChunk(const Peer& from,
+                                         uint64_t lowBlockNum,
+                                         uint64_t highBlockNum);
+
+  const unsigned int m_maxChunks;
+  const unsigned int m_chunkSize;
+  const std::chrono::seconds m_timeout;
+  const unsigned int m_retryCount;
+
+  mutable std::mutex m_mutex;
+  bool m_active{false};
+  uint64_t m_lowBlockNum{0};
+  std::vector<Peer> m_peers;
+  std::vector<Chunk> m_chunks;
+  std::map<uint64_t, TxBlock> m_txBlocks;
+};
+
+#endif  // ZILLIQA_SRC_LIBLOOKUP_TXBLOCKDOWNLOADER_H_
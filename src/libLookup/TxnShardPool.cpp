@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "TxnShardPool.h"
+#include "libData/AccountData/TxnPool.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+TxnShardPool::Shard* TxnShardPool::FindShard(uint32_t shardId) const {
+  auto it = m_shards.find(shardId);
+  return (it == m_shards.end()) ? nullptr : it->second.get();
+}
+
+bool TxnShardPool::MakeRoom(Shard& shard, const Transaction& tx,
+                            uint64_t txnSize) {
+  if (m_memoryLimit == 0) {
+    return true;
+  }
+
+  while (m_sizeInBytes + txnSize > m_memoryLimit) {
+    auto cheapest = min_element(shard.m_txns.begin(), shard.m_txns.end(),
+                                [](const Transaction& a, const Transaction& b) {
+                                  return a.GetGasPrice() < b.GetGasPrice();
+                                });
+    if (cheapest == shard.m_txns.end() ||
+        cheapest->GetGasPrice() >= tx.GetGasPrice()) {
+      return false;
+    }
+
+    // Later nonces of the sender cannot be processed without this one
+    auto victim = cheapest;
+    for (auto it = shard.m_txns.begin(); it != shard.m_txns.end(); ++it) {
+      if (it->GetSenderPubKey() == cheapest->GetSenderPubKey() &&
+          it->GetNonce() > victim->GetNonce()) {
+        victim = it;
+      }
+    }
+
+    LOG_GENERAL(INFO, "Evicted Txn " << victim->GetTranID().hex());
+    m_sizeInBytes -= TxnPool::GetMemorySize(*victim);
+    shard.m_hashes.erase(victim->GetTranID());
+    shard.m_txns.erase(victim);
+    m_size--;
+    m_evictedCount++;
+  }
+
+  return true;
+}
+
+bool TxnShardPool::Add(const Transaction& tx, uint32_t shardId) {
+  // Reserve a slot first, so concurrent submissions cannot overshoot
+  if (++m_size > m_capacity) {
+    m_size--;
+    LOG_GENERAL(INFO, "Number of txns exceeded limit");
+    return false;
+  }
+
+  shared_lock<shared_timed_mutex> lock(m_mutexShards);
+  Shard* shard = FindShard(shardId);
+  while (shard == nullptr) {
+    lock.unlock();
+    {
+      unique_lock<shared_timed_mutex> g(m_mutexShards);
+      auto& newShard = m_shards[shardId];
+      if (!newShard) {
+        newShard.reset(new Shard());
+      }
+    }
+    lock.lock();
+    shard = FindShard(shardId);
+  }
+
+  lock_guard<mutex> g(shard->m_mutex);
+  if (!shard->m_hashes.emplace(tx.GetTranID()).second) {
+    m_size--;
+    LOG_GENERAL(WARNING, "Same hash present " << tx.GetTranID());
+    return false;
+  }
+  const uint64_t txnSize = TxnPool::GetMemorySize(tx);
+  if (!MakeRoom(*shard, tx, txnSize)) {
+    shard->m_hashes.erase(tx.GetTranID());
+    m_size--;
+    LOG_GENERAL(INFO, "Size of txns exceeded memory limit");
+    return false;
+  }
+  m_sizeInBytes += txnSize;
+  shard->m_txns.emplace_back(tx);
+  LOG_GENERAL(INFO,
+              "Added Txn " << tx.GetTranID().hex() << " to shard " << shardId);
+
+  return true;
+}
+
+vector<Transaction> TxnShardPool::GetTxns(uint32_t shardId) const {
+  shared_lock<shared_timed_mutex> lock(m_mutexShards);
+  const Shard* shard = FindShard(shardId);
+  if (shard == nullptr) {
+    return {};
+  }
+  lock_guard<mutex> g(shard->m_mutex);
+  return shard->m_txns;
+}
+
+vector<pair<uint32_t, Transaction>> TxnShardPool::GetAllTxns() const {
+  vector<pair<uint32_t, Transaction>> result;
+  result.reserve(m_size);
+  shared_lock<shared_timed_mutex> lock(m_mutexShards);
+  for (const auto& entry : m_shards) {
+    lock_guard<mutex> g(entry.second->m_mutex);
+    for (const auto& tx : entry.second->m_txns) {
+      result.emplace_back(entry.first, tx);
+    }
+  }
+  return result;
+}
+
+bool TxnShardPool::IsEmpty(uint32_t shardId) const {
+  shared_lock<shared_timed_mutex> lock(m_mutexShards);
+  const Shard* shard = FindShard(shardId);
+  if (shard == nullptr) {
+    return true;
+  }
+  lock_guard<mutex> g(shard->m_mutex);
+  return shard->m_txns.empty();
+}
+
+vector<Transaction> TxnShardPool::Take(uint32_t shardId,
+                                       unsigned int maxCount) {
+  shared_lock<shared_timed_mutex> lock(m_mutexShards);
+  Shard* shard = FindShard(shardId);
+  if (shard == nullptr) {
+    return {};
+  }
+  lock_guard<mutex> g(shard->m_mutex);
+  const auto end =
+      shard->m_txns.begin() + min<size_t>(maxCount, shard->m_txns.size());
+  vector<Transaction> txns(make_move_iterator(shard->m_txns.begin()),
+                           make_move_iterator(end));
+  shard->m_txns.erase(shard->m_txns.begin(), end);
+  for (const auto& tx : txns) {
+    shard->m_hashes.erase(tx.GetTranID());
+    m_sizeInBytes -= TxnPool::GetMemorySize(tx);
+  }
+  m_size -= txns.size();
+  return txns;
+}
+
+void TxnShardPool::Clear(uint32_t shardId) {
+  shared_lock<shared_timed_mutex> lock(m_mutexShards);
+  Shard* shard = FindShard(shardId);
+  if (shard == nullptr) {
+    return;
+  }
+  lock_guard<mutex> g(shard->m_mutex);
+  m_size -= shard->m_txns.size();
+  for (const auto& tx : shard->m_txns) {
+    m_sizeInBytes -= TxnPool::GetMemorySize(tx);
+  }
+  shard->m_txns.clear();
+  shard->m_hashes.clear();
+}
+
+void TxnShardPool::Reassign(const ReassignFunc& func) {
+  unique_lock<shared_timed_mutex> lock(m_mutexShards);
+
+  map<uint32_t, unique_ptr<Shard>> shards;
+  for (const auto& entry : m_shards) {
+    for (auto& tx : entry.second->m_txns) {
+      auto& shard = shards[func(entry.first, tx)];
+      if (!shard) {
+        shard.reset(new Shard());
+      }
+      if (shard->m_hashes.emplace(tx.GetTranID()).second) {
+        shard->m_txns.emplace_back(move(tx));
+      } else {
+        // Was held for two shards that are now the same one
+        m_size--;
+        m_sizeInBytes -= TxnPool::GetMemorySize(tx);
+      }
+    }
+  }
+
+  m_shards = move(shards);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBLOOKUP_TXNSHARDPOOL_H_
+#define ZILLIQA_SRC_LIBLOOKUP_TXNSHARDPOOL_H_
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "libData/AccountData/Transaction.h"
+
+/// Transactions received by the lookup, waiting to be forwarded to each shard
+/// and to the DS committee. Admission is O(1): a running count enforces the
+/// storage limit and every shard keeps a hash index next to its list. Shards
+/// are locked separately, so submissions to different shards do not contend.
+/// Once the memory limit is reached, a new transaction takes the place of the
+/// lowest gas price transactions of its shard, starting from the highest nonce
+/// of their sender. Concurrent submissions may overshoot the limit slightly.
+class TxnShardPool {
+ public:
+  /// Maps a transaction held for a shard to the shard it should move to
+  using ReassignFunc =
+      std::function<uint32_t(uint32_t shardId, const Transaction& tx)>;
+
+  /// A memoryLimit of 0 means no limit
+  explicit TxnShardPool(unsigned int capacity, uint64_t memoryLimit = 0)
+      : m_capacity(capacity), m_memoryLimit(memoryLimit) {}
+
+  /// Adds the transaction to the shard. Returns false if the pool is full and
+  /// nothing cheaper can be evicted, or if the shard already holds it.
+  bool Add(const Transaction& tx, uint32_t shardId);
+
+  /// Returns a copy of the transactions held for the shard
+  std::vector<Transaction> GetTxns(uint32_t shardId) const;
+
+  /// Returns a copy of every transaction held, with the id of its shard
+  std::vector<std::pair<uint32_t, Transaction>> GetAllTxns() const;
+
+  bool IsEmpty(uint32_t shardId) const;
+
+  /// Removes and returns up to maxCount of the oldest transactions held for
+  /// the shard
+  std::vector<Transaction> Take(uint32_t shardId, unsigned int maxCount);
+
+  /// Drops the transactions held for the shard
+  void Clear(uint32_t shardId);
+
+  /// Moves every transaction to the shard given by func, keeping the order
+  /// within each shard
+  void Reassign(const ReassignFunc& func);
+
+  unsigned int Size() const { return m_size; }
+
+  /// Whether Add would fail for any transaction, as the storage limit is
+  /// reached. The memory limit may still be met by evicting cheaper ones.
+  bool IsFull() const { return m_size >= m_capacity; }
+
+  uint64_t GetSizeInBytes() const { return m_sizeInBytes; }
+
+  uint64_t GetEvictedCount() const { return m_evictedCount; }
+
+ private:
+  struct Shard {
+    mutable std::mutex m_mutex;
+    std::vector<Transaction> m_txns;
+    std::unordered_set<TxnHash> m_hashes;
+  };
+
+  const unsigned int m_capacity;
+  const uint64_t m_memoryLimit;
+  std::atomic<unsigned int> m_size{0};
+  std::atomic<uint64_t> m_sizeInBytes{0};
+  std::atomic<uint64_t> m_evictedCount{0};
+
+  // Held shared while using a shard, and unique to add or rebuild shards
+  mutable std::shared_timed_mutex m_mutexShards;
+  std::map<uint32_t, std::unique_ptr<Shard>> m_shards;
+
+  Shard* FindShard(uint32_t shardId) const;
+  bool MakeRoom(Shard& shard, const Transaction& tx, uint64_t txnSize);
+};
+
+#endif  // ZILLIQA_SRC_LIBLOOKUP_TXNSHARDPOOL_H_
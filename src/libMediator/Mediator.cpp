@@ -20,10 +20,16 @@
 #include "Mediator.h"
 #include "common/Constants.h"
 #include "libCrypto/Sha2.h"
+#include "libNetwork/TrafficStats.h"
+#include "libPersistence/BlockStorage.h"
 #include "libServer/GetWorkServer.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
+#include "libUtils/EpochPerf.h"
+#include "libUtils/MemoryStats.h"
+#include "libUtils/MessageStats.h"
 #include "libUtils/ShardSizeCalculator.h"
+#include "libUtils/TraceRecorder.h"
 #include "libValidator/Validator.h"
 
 using namespace std;
@@ -124,6 +130,36 @@ std::string Mediator::GetNodeMode(const Peer& peer) {
 
 void Mediator::IncreaseEpochNum() {
   std::lock_guard<mutex> lock(m_mutexVacuousEpoch);
+  if (ENABLE_MESSAGE_STATS) {
+    MessageStats::GetInstance().LogAndReset(m_currentEpochNum);
+  }
+  if (ENABLE_TRAFFIC_STATS) {
+    TrafficStats::GetInstance().LogAndReset(m_currentEpochNum);
+  }
+  if (ENABLE_MEMORY_STATS) {
+    // The estimators take the locks of the subsystems, which the epoch
+    // change should not wait on
+    const uint64_t epochNum = m_currentEpochNum;
+    auto func = [epochNum]() -> void {
+      MemoryStats::GetInstance().Log(epochNum);
+    };
+    DetachedFunction(1, func);
+  }
+  if (ENABLE_CONSENSUS_TRACE) {
+    TraceRecorder::GetInstance().Flush(m_currentEpochNum);
+  }
+  if (ENABLE_EPOCH_PERF) {
+    const uint64_t epochNum = m_currentEpochNum;
+    const DiagnosticDataEpochPerf record = EpochPerf::GetInstance().TakeRecord(
+        m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum());
+    auto func = [epochNum, record]() -> void {
+      if (!BlockStorage::GetBlockStorage().PutDiagnosticDataEpochPerf(
+              epochNum, record)) {
+        LOG_GENERAL(WARNING, "PutDiagnosticDataEpochPerf failed " << epochNum);
+      }
+    };
+    DetachedFunction(1, func);
+  }
   m_currentEpochNum++;
   if ((m_currentEpochNum + NUM_VACUOUS_EPOCHS) % NUM_FINAL_BLOCK_PER_POW == 0) {
     m_isVacuousEpoch = true;
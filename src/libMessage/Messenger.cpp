@@ -21,12 +21,19 @@
 #include "libData/BlockChainData/BlockLinkChain.h"
 #include "libDirectoryService/DirectoryService.h"
 #include "libMessage/ZilliqaMessage.pb.h"
+#include "libUtils/JsonUtils.h"
 #include "libUtils/Logger.h"
+#include "libUtils/OrderedPipeline.h"
 
+#include <google/protobuf/arena.h>
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/wire_format_lite.h>
 #include <algorithm>
+#include <climits>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <random>
 #include <unordered_set>
 
@@ -34,6 +41,31 @@ using namespace boost::multiprecision;
 using namespace std;
 using namespace ZilliqaMessage;
 
+namespace {
+/// Top level message of a Set or Get call, created on an arena owned by the
+/// call. Its nested fields and repeated elements are then carved out of the
+/// arena blocks instead of being allocated one by one, and are all released
+/// at once when the call returns.
+template <class T>
+class ArenaMessage {
+ public:
+  ArenaMessage()
+      : m_message(google::protobuf::Arena::CreateMessage<T>(&m_arena)) {}
+
+  ArenaMessage(const ArenaMessage&) = delete;
+  ArenaMessage& operator=(const ArenaMessage&) = delete;
+
+  T* operator->() { return m_message; }
+  const T* operator->() const { return m_message; }
+  T& operator*() { return *m_message; }
+  const T& operator*() const { return *m_message; }
+
+ private:
+  google::protobuf::Arena m_arena;
+  T* const m_message;
+};
+}  // namespace
+
 // ============================================================================
 // Utility conversion functions
 // ============================================================================
@@ -90,15 +122,23 @@ void ProtobufByteArrayToNumber(const ByteArray& byteArray, T& number) {
   number = Serializable::GetNumber<T>(tmp, 0, S);
 }
 
+// The size is computed once, which caches it in every nested message, and the
+// encoding then reuses the cached sizes
 template <class T>
 bool SerializeToArray(const T& protoMessage, bytes& dst,
                       const unsigned int offset) {
-  if ((offset + protoMessage.ByteSize()) > dst.size()) {
-    dst.resize(offset + protoMessage.ByteSize());
+  const size_t size = protoMessage.ByteSizeLong();
+  if (size > INT_MAX) {
+    LOG_GENERAL(WARNING, "Message too large to serialize, size: " << size);
+    return false;
+  }
+
+  if ((offset + size) > dst.size()) {
+    dst.resize(offset + size);
   }
 
-  return protoMessage.SerializeToArray(dst.data() + offset,
-                                       protoMessage.ByteSize());
+  protoMessage.SerializeWithCachedSizesToArray(dst.data() + offset);
+  return true;
 }
 
 template bool SerializeToArray<ProtoAccountStore>(
@@ -108,15 +148,120 @@ template bool SerializeToArray<ProtoAccountStore>(
 template <class T>
 bool RepeatableToArray(const T& repeatable, bytes& dst,
                        const unsigned int offset) {
-  int tempOffset = offset;
+  size_t size = 0;
+  for (const auto& element : repeatable) {
+    size += element.ByteSizeLong();
+  }
+  if (size > INT_MAX) {
+    LOG_GENERAL(WARNING, "Elements too large to serialize, size: " << size);
+    return false;
+  }
+
+  if ((offset + size) > dst.size()) {
+    dst.resize(offset + size);
+  }
+
+  uint8_t* target = dst.data() + offset;
   for (const auto& element : repeatable) {
-    if (!SerializeToArray(element, dst, tempOffset)) {
-      LOG_GENERAL(WARNING, "SerializeToArray failed, offset: " << tempOffset);
+    target = element.SerializeWithCachedSizesToArray(target);
+  }
+  return true;
+}
+
+// Encodes first followed by second, the input that announcements sign
+bool ConcatenateToArray(const google::protobuf::MessageLite& first,
+                        const google::protobuf::MessageLite& second,
+                        bytes& dst) {
+  dst.clear();
+  const size_t firstSize = first.ByteSizeLong();
+  const size_t secondSize = second.ByteSizeLong();
+  if (firstSize + secondSize > INT_MAX) {
+    LOG_GENERAL(WARNING, "Messages too large to serialize, size: "
+                             << firstSize + secondSize);
+    return false;
+  }
+
+  dst.resize(firstSize + secondSize);
+  second.SerializeWithCachedSizesToArray(
+      first.SerializeWithCachedSizesToArray(dst.data()));
+  return true;
+}
+
+using google::protobuf::internal::WireFormatLite;
+
+// Walks the fields of the message read by codedIn, up to its current limit.
+// onField(fieldNumber, wireType) decodes the field and returns 1, returns 0
+// to have it skipped without being parsed, or -1 to fail.
+template <class F>
+bool ReadFields(google::protobuf::io::CodedInputStream& codedIn, F onField) {
+  while (true) {
+    const uint32_t tag = codedIn.ReadTag();
+    if (tag == 0) {
+      return codedIn.ConsumedEntireMessage();
+    }
+    const int ret = onField(WireFormatLite::GetTagFieldNumber(tag),
+                            WireFormatLite::GetTagWireType(tag));
+    if (ret < 0 || (ret == 0 && !WireFormatLite::SkipField(&codedIn, tag))) {
       return false;
     }
-    tempOffset += element.ByteSize();
   }
-  return true;
+}
+
+// Walks the fields of the embedded message at the position of codedIn
+template <class F>
+bool ReadEmbeddedFields(google::protobuf::io::CodedInputStream& codedIn,
+                        F onField) {
+  uint32_t length = 0;
+  if (!codedIn.ReadVarint32(&length)) {
+    return false;
+  }
+  const auto limit = codedIn.PushLimit(length);
+  const bool ret = ReadFields(codedIn, onField);
+  codedIn.PopLimit(limit);
+  return ret;
+}
+
+// Reads the block hash out of the ProtoBlockBase at the position of codedIn,
+// skipping the co-signatures
+bool ReadBlockBaseHash(google::protobuf::io::CodedInputStream& codedIn,
+                       BlockHash& blockHash) {
+  string protoBlockHash;
+  bool hasBlockHash = false;
+  if (!ReadEmbeddedFields(
+          codedIn, [&](int field, WireFormatLite::WireType type) {
+            if (field != ProtoBlockBase::kBlockhashFieldNumber ||
+                type != WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+              return 0;
+            }
+            hasBlockHash = true;
+            return WireFormatLite::ReadBytes(&codedIn, &protoBlockHash) ? 1
+                                                                        : -1;
+          })) {
+    return false;
+  }
+  return hasBlockHash &&
+         Messenger::CopyWithSizeCheck(protoBlockHash, blockHash.asArray());
+}
+
+// Writes an embedded message field holding the already encoded message at
+// offset of dst, and returns the offset past it
+unsigned int EmbeddedToArray(const int fieldNumber, const bytes& encoded,
+                             bytes& dst, const unsigned int offset) {
+  using google::protobuf::io::CodedOutputStream;
+
+  const uint32_t tag = WireFormatLite::MakeTag(
+      fieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  const unsigned int end =
+      offset + CodedOutputStream::VarintSize32(tag) +
+      CodedOutputStream::VarintSize32(encoded.size()) + encoded.size();
+  if (end > dst.size()) {
+    dst.resize(end);
+  }
+
+  uint8_t* target = CodedOutputStream::WriteVarint32ToArray(tag, &dst[offset]);
+  target = CodedOutputStream::WriteVarint32ToArray(encoded.size(), target);
+  copy(encoded.begin(), encoded.end(), target);
+  return end;
 }
 
 template <class T, size_t S>
@@ -936,16 +1081,16 @@ bool ProtobufToBlockBase(const ProtoBlockBase& protoBlockBase,
   }
 
   // Deserialize cosigs
-  CoSignatures cosigs;
-  cosigs.m_B1.resize(protoBlockBase.cosigs().b1().size());
-  cosigs.m_B2.resize(protoBlockBase.cosigs().b2().size());
+  CoSignatures cosigs(0);
 
   PROTOBUFBYTEARRAYTOSERIALIZABLE(protoBlockBase.cosigs().cs1(), cosigs.m_CS1);
-  copy(protoBlockBase.cosigs().b1().begin(), protoBlockBase.cosigs().b1().end(),
-       cosigs.m_B1.begin());
+  for (const auto& i : protoBlockBase.cosigs().b1()) {
+    cosigs.m_B1.push_back(i);
+  }
   PROTOBUFBYTEARRAYTOSERIALIZABLE(protoBlockBase.cosigs().cs2(), cosigs.m_CS2);
-  copy(protoBlockBase.cosigs().b2().begin(), protoBlockBase.cosigs().b2().end(),
-       cosigs.m_B2.begin());
+  for (const auto& i : protoBlockBase.cosigs().b2()) {
+    cosigs.m_B2.push_back(i);
+  }
 
   base.SetCoSignatures(cosigs);
 
@@ -1236,13 +1381,11 @@ bool ProtobufToTransaction(const ProtoTransaction& protoTransaction,
     return false;
   }
 
-  SHA2<HashType::HASH_VARIANT_256> sha2;
-  sha2.Update(txnData);
-  const bytes& hash = sha2.Finalize();
+  TxnHash expected;
+  SHA2<HashType::HASH_VARIANT_256>::Hash(txnData.data(), txnData.size(),
+                                         expected.data());
 
-  if (!std::equal(hash.begin(), hash.end(), tranID.begin(), tranID.end())) {
-    TxnHash expected;
-    copy(hash.begin(), hash.end(), expected.asArray().begin());
+  if (expected != tranID) {
     LOG_GENERAL(WARNING, "TranID verification failed. Expected: "
                              << expected << " Actual: " << tranID);
     return false;
@@ -1299,9 +1442,115 @@ bool ProtobufToTransactionArray(
   return true;
 }
 
+void TransactionReceiptDataToProtobuf(
+    const TransactionReceipt::Data& data,
+    ProtoTransactionReceiptData& protoReceiptData) {
+  if (data.m_result != TransactionReceipt::Data::Result::UNSET) {
+    protoReceiptData.set_success(data.m_result ==
+                                 TransactionReceipt::Data::Result::SUCCESS);
+  }
+  if (data.m_hasCumGas) {
+    protoReceiptData.set_cumgas(data.m_cumGas);
+  }
+  if (data.m_hasEpochNum) {
+    protoReceiptData.set_epochnum(data.m_epochNum);
+  }
+  protoReceiptData.set_edges(data.m_edge);
+  for (const auto& e : data.m_errors) {
+    if (e.second.empty()) {
+      continue;
+    }
+    auto* protoErrors = protoReceiptData.add_errors();
+    protoErrors->set_edge(e.first);
+    for (const auto& code : e.second) {
+      protoErrors->add_codes(code);
+    }
+  }
+  for (const auto& entry : data.m_eventLogs) {
+    protoReceiptData.add_eventlogs(
+        JSONUtils::GetInstance().convertJsontoCompactStr(entry));
+  }
+  for (const auto& transition : data.m_transitions) {
+    auto* protoTransition = protoReceiptData.add_transitions();
+    protoTransition->set_addr(transition.m_addr.data(),
+                              transition.m_addr.size);
+    protoTransition->set_depth(transition.m_depth);
+    protoTransition->set_msg(
+        JSONUtils::GetInstance().convertJsontoCompactStr(transition.m_msg));
+  }
+  if (!data.m_others.isNull()) {
+    protoReceiptData.set_others(
+        JSONUtils::GetInstance().convertJsontoCompactStr(data.m_others));
+  }
+}
+
+bool ProtobufToTransactionReceiptData(
+    const ProtoTransactionReceiptData& protoReceiptData,
+    TransactionReceipt::Data& data) {
+  data = TransactionReceipt::Data();
+  if (protoReceiptData.has_success()) {
+    data.m_result = protoReceiptData.success()
+                        ? TransactionReceipt::Data::Result::SUCCESS
+                        : TransactionReceipt::Data::Result::FAILURE;
+  }
+  data.m_hasCumGas = protoReceiptData.has_cumgas();
+  data.m_cumGas = protoReceiptData.cumgas();
+  data.m_hasEpochNum = protoReceiptData.has_epochnum();
+  data.m_epochNum = protoReceiptData.epochnum();
+  data.m_edge = protoReceiptData.edges();
+  for (const auto& protoErrors : protoReceiptData.errors()) {
+    if (protoErrors.edge() > data.m_edge || protoErrors.codes().empty()) {
+      LOG_GENERAL(WARNING, "Invalid receipt errors for edge "
+                               << protoErrors.edge());
+      return false;
+    }
+    auto& codes = data.m_errors[protoErrors.edge()];
+    codes.assign(protoErrors.codes().begin(), protoErrors.codes().end());
+  }
+  for (const auto& entry : protoReceiptData.eventlogs()) {
+    data.m_eventLogs.emplace_back();
+    if (!JSONUtils::GetInstance().convertStrtoJson(entry,
+                                                   data.m_eventLogs.back())) {
+      LOG_GENERAL(WARNING, "Invalid receipt event log");
+      return false;
+    }
+  }
+  for (const auto& protoTransition : protoReceiptData.transitions()) {
+    if (protoTransition.addr().size() != ACC_ADDR_SIZE) {
+      LOG_GENERAL(WARNING, "Invalid receipt transition address size "
+                               << protoTransition.addr().size());
+      return false;
+    }
+    TransactionReceipt::Transition transition;
+    copy(protoTransition.addr().begin(), protoTransition.addr().end(),
+         transition.m_addr.asArray().begin());
+    transition.m_depth = protoTransition.depth();
+    if (!JSONUtils::GetInstance().convertStrtoJson(protoTransition.msg(),
+                                                   transition.m_msg)) {
+      LOG_GENERAL(WARNING, "Invalid receipt transition message");
+      return false;
+    }
+    data.m_transitions.emplace_back(move(transition));
+  }
+  if (!protoReceiptData.others().empty() &&
+      !JSONUtils::GetInstance().convertStrtoJson(protoReceiptData.others(),
+                                                 data.m_others)) {
+    LOG_GENERAL(WARNING, "Invalid receipt members");
+    return false;
+  }
+  return true;
+}
+
 void TransactionReceiptToProtobuf(const TransactionReceipt& transReceipt,
                                   ProtoTransactionReceipt& protoTransReceipt) {
-  protoTransReceipt.set_receipt(transReceipt.GetString());
+  // A binary receipt is stored in the form it is hashed with
+  const bytes& tranReceiptBytes = transReceipt.GetBytes();
+  if (!tranReceiptBytes.empty()) {
+    protoTransReceipt.set_data(tranReceiptBytes.data(),
+                               tranReceiptBytes.size());
+  } else {
+    protoTransReceipt.set_receipt(transReceipt.GetString());
+  }
   // protoTransReceipt.set_cumgas(transReceipt.GetCumGas());
   protoTransReceipt.set_cumgas(transReceipt.GetCumGas());
 }
@@ -1313,12 +1562,29 @@ bool ProtobufToTransactionReceipt(
     LOG_GENERAL(WARNING, "CheckRequiredFieldsProtoTransactionReceipt failed");
     return false;
   }
+
+  if (!protoTransactionReceipt.data().empty()) {
+    TransactionReceipt::Data data;
+    bytes tranReceiptBytes(protoTransactionReceipt.data().begin(),
+                           protoTransactionReceipt.data().end());
+    if (!Messenger::GetTransactionReceiptData(tranReceiptBytes, 0, data)) {
+      LOG_GENERAL(WARNING, "Messenger::GetTransactionReceiptData failed");
+      return false;
+    }
+    if (!data.m_hasCumGas) {
+      data.m_cumGas = protoTransactionReceipt.cumgas();
+    }
+    transactionReceipt.SetData(data, tranReceiptBytes);
+    return true;
+  }
+
   std::string tranReceiptStr;
   tranReceiptStr.resize(protoTransactionReceipt.receipt().size());
   copy(protoTransactionReceipt.receipt().begin(),
        protoTransactionReceipt.receipt().end(), tranReceiptStr.begin());
-  transactionReceipt.SetString(tranReceiptStr);
+  // Set first, so that a receipt without cumulative_gas keeps it
   transactionReceipt.SetCumGas(protoTransactionReceipt.cumgas());
+  transactionReceipt.SetString(tranReceiptStr);
 
   return true;
 }
@@ -2122,8 +2388,10 @@ bool SetConsensusAnnouncementCore(
     return false;
   }
 
-  bytes tmp(announcement.consensusinfo().ByteSize());
-  announcement.consensusinfo().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(announcement.consensusinfo(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
 
@@ -2146,52 +2414,40 @@ bool SetConsensusAnnouncementCore(
         LOG_GENERAL(WARNING, "Announcement dsblock content not initialized");
         return false;
       }
-      inputToSigning.resize(announcement.consensusinfo().ByteSize() +
-                            announcement.dsblock().ByteSize());
-      announcement.consensusinfo().SerializeToArray(
-          inputToSigning.data(), announcement.consensusinfo().ByteSize());
-      announcement.dsblock().SerializeToArray(
-          inputToSigning.data() + announcement.consensusinfo().ByteSize(),
-          announcement.dsblock().ByteSize());
+      if (!ConcatenateToArray(announcement.consensusinfo(),
+                              announcement.dsblock(), inputToSigning)) {
+        return false;
+      }
       break;
     case ConsensusAnnouncement::AnnouncementCase::kMicroblock:
       if (!announcement.microblock().IsInitialized()) {
         LOG_GENERAL(WARNING, "Announcement microblock content not initialized");
         return false;
       }
-      inputToSigning.resize(announcement.consensusinfo().ByteSize() +
-                            announcement.microblock().ByteSize());
-      announcement.consensusinfo().SerializeToArray(
-          inputToSigning.data(), announcement.consensusinfo().ByteSize());
-      announcement.microblock().SerializeToArray(
-          inputToSigning.data() + announcement.consensusinfo().ByteSize(),
-          announcement.microblock().ByteSize());
+      if (!ConcatenateToArray(announcement.consensusinfo(),
+                              announcement.microblock(), inputToSigning)) {
+        return false;
+      }
       break;
     case ConsensusAnnouncement::AnnouncementCase::kFinalblock:
       if (!announcement.finalblock().IsInitialized()) {
         LOG_GENERAL(WARNING, "Announcement finalblock content not initialized");
         return false;
       }
-      inputToSigning.resize(announcement.consensusinfo().ByteSize() +
-                            announcement.finalblock().ByteSize());
-      announcement.consensusinfo().SerializeToArray(
-          inputToSigning.data(), announcement.consensusinfo().ByteSize());
-      announcement.finalblock().SerializeToArray(
-          inputToSigning.data() + announcement.consensusinfo().ByteSize(),
-          announcement.finalblock().ByteSize());
+      if (!ConcatenateToArray(announcement.consensusinfo(),
+                              announcement.finalblock(), inputToSigning)) {
+        return false;
+      }
       break;
     case ConsensusAnnouncement::AnnouncementCase::kVcblock:
       if (!announcement.vcblock().IsInitialized()) {
         LOG_GENERAL(WARNING, "Announcement vcblock content not initialized");
         return false;
       }
-      inputToSigning.resize(announcement.consensusinfo().ByteSize() +
-                            announcement.vcblock().ByteSize());
-      announcement.consensusinfo().SerializeToArray(
-          inputToSigning.data(), announcement.consensusinfo().ByteSize());
-      announcement.vcblock().SerializeToArray(
-          inputToSigning.data() + announcement.consensusinfo().ByteSize(),
-          announcement.vcblock().ByteSize());
+      if (!ConcatenateToArray(announcement.consensusinfo(),
+                              announcement.vcblock(), inputToSigning)) {
+        return false;
+      }
       break;
     case ConsensusAnnouncement::AnnouncementCase::kFallbackblock:
       if (!announcement.fallbackblock().IsInitialized()) {
@@ -2199,13 +2455,10 @@ bool SetConsensusAnnouncementCore(
                     "Announcement fallbackblock content not initialized");
         return false;
       }
-      inputToSigning.resize(announcement.consensusinfo().ByteSize() +
-                            announcement.fallbackblock().ByteSize());
-      announcement.consensusinfo().SerializeToArray(
-          inputToSigning.data(), announcement.consensusinfo().ByteSize());
-      announcement.fallbackblock().SerializeToArray(
-          inputToSigning.data() + announcement.consensusinfo().ByteSize(),
-          announcement.fallbackblock().ByteSize());
+      if (!ConcatenateToArray(announcement.consensusinfo(),
+                              announcement.fallbackblock(), inputToSigning)) {
+        return false;
+      }
       break;
     case ConsensusAnnouncement::AnnouncementCase::ANNOUNCEMENT_NOT_SET:
     default:
@@ -2285,49 +2538,34 @@ bool GetConsensusAnnouncementCore(
   bytes tmp;
 
   if (announcement.has_dsblock() && announcement.dsblock().IsInitialized()) {
-    tmp.resize(announcement.consensusinfo().ByteSize() +
-               announcement.dsblock().ByteSize());
-    announcement.consensusinfo().SerializeToArray(
-        tmp.data(), announcement.consensusinfo().ByteSize());
-    announcement.dsblock().SerializeToArray(
-        tmp.data() + announcement.consensusinfo().ByteSize(),
-        announcement.dsblock().ByteSize());
+    if (!ConcatenateToArray(announcement.consensusinfo(),
+                            announcement.dsblock(), tmp)) {
+      return false;
+    }
   } else if (announcement.has_microblock() &&
              announcement.microblock().IsInitialized()) {
-    tmp.resize(announcement.consensusinfo().ByteSize() +
-               announcement.microblock().ByteSize());
-    announcement.consensusinfo().SerializeToArray(
-        tmp.data(), announcement.consensusinfo().ByteSize());
-    announcement.microblock().SerializeToArray(
-        tmp.data() + announcement.consensusinfo().ByteSize(),
-        announcement.microblock().ByteSize());
+    if (!ConcatenateToArray(announcement.consensusinfo(),
+                            announcement.microblock(), tmp)) {
+      return false;
+    }
   } else if (announcement.has_finalblock() &&
              announcement.finalblock().IsInitialized()) {
-    tmp.resize(announcement.consensusinfo().ByteSize() +
-               announcement.finalblock().ByteSize());
-    announcement.consensusinfo().SerializeToArray(
-        tmp.data(), announcement.consensusinfo().ByteSize());
-    announcement.finalblock().SerializeToArray(
-        tmp.data() + announcement.consensusinfo().ByteSize(),
-        announcement.finalblock().ByteSize());
+    if (!ConcatenateToArray(announcement.consensusinfo(),
+                            announcement.finalblock(), tmp)) {
+      return false;
+    }
   } else if (announcement.has_vcblock() &&
              announcement.vcblock().IsInitialized()) {
-    tmp.resize(announcement.consensusinfo().ByteSize() +
-               announcement.vcblock().ByteSize());
-    announcement.consensusinfo().SerializeToArray(
-        tmp.data(), announcement.consensusinfo().ByteSize());
-    announcement.vcblock().SerializeToArray(
-        tmp.data() + announcement.consensusinfo().ByteSize(),
-        announcement.vcblock().ByteSize());
+    if (!ConcatenateToArray(announcement.consensusinfo(),
+                            announcement.vcblock(), tmp)) {
+      return false;
+    }
   } else if (announcement.has_fallbackblock() &&
              announcement.fallbackblock().IsInitialized()) {
-    tmp.resize(announcement.consensusinfo().ByteSize() +
-               announcement.fallbackblock().ByteSize());
-    announcement.consensusinfo().SerializeToArray(
-        tmp.data(), announcement.consensusinfo().ByteSize());
-    announcement.fallbackblock().SerializeToArray(
-        tmp.data() + announcement.consensusinfo().ByteSize(),
-        announcement.fallbackblock().ByteSize());
+    if (!ConcatenateToArray(announcement.consensusinfo(),
+                            announcement.fallbackblock(), tmp)) {
+      return false;
+    }
   } else {
     LOG_GENERAL(WARNING, "Announcement content not set");
     return false;
@@ -2407,81 +2645,266 @@ bool Messenger::GetShardHash(const Shard& shard, CommitteeHash& dst) {
 bool Messenger::GetShardingStructureHash(const uint32_t& version,
                                          const DequeOfShard& shards,
                                          ShardingHash& dst) {
-  ProtoShardingStructure protoShardingStructure;
-
-  ShardingStructureToProtobuf(version, shards, protoShardingStructure);
-
-  if (!protoShardingStructure.IsInitialized()) {
-    LOG_GENERAL(WARNING, "ProtoShardingStructure initialization failed");
-    return false;
-  }
-
-  bytes tmp;
-
-  if (!SerializeToArray(protoShardingStructure, tmp, 0)) {
-    LOG_GENERAL(WARNING, "ProtoShardingStructure serialization failed");
+  const auto encoded = GetEncodedShardingStructure(version, shards);
+  if (!encoded) {
     return false;
   }
 
   SHA2<HashType::HASH_VARIANT_256> sha2;
-  sha2.Update(tmp);
-  tmp = sha2.Finalize();
+  sha2.Update(*encoded);
+  const bytes tmp = sha2.Finalize();
 
   copy(tmp.begin(), tmp.end(), dst.asArray().begin());
 
   return true;
 }
 
-bool Messenger::SetAccountBase(bytes& dst, const unsigned int offset,
-                               const AccountBase& accountbase) {
-  ProtoAccountBase result;
-
-  AccountBaseToProtobuf(accountbase, result);
+shared_ptr<const bytes> Messenger::GetEncodedShardingStructure(
+    const uint32_t& version, const DequeOfShard& shards) {
+  static mutex mutexEncoded;
+  static uint32_t encodedVersion = 0;
+  static DequeOfShard encodedShards;
+  static shared_ptr<const bytes> encoded;
 
-  if (!result.IsInitialized()) {
-    LOG_GENERAL(WARNING, "ProtoAccountBase initialization failed");
-    return false;
+  {
+    lock_guard<mutex> g(mutexEncoded);
+    if (encoded && encodedVersion == version && encodedShards == shards) {
+      return encoded;
+    }
   }
 
-  return SerializeToArray(result, dst, offset);
-}
+  ArenaMessage<ProtoShardingStructure> protoShardingStructure;
+  ShardingStructureToProtobuf(version, shards, *protoShardingStructure);
 
-bool Messenger::GetAccountBase(const bytes& src, const unsigned int offset,
-                               AccountBase& accountbase) {
+  if (!protoShardingStructure->IsInitialized()) {
+    LOG_GENERAL(WARNING, "ProtoShardingStructure initialization failed");
+    return nullptr;
+  }
+
+  auto result = make_shared<bytes>();
+  if (!SerializeToArray(*protoShardingStructure, *result, 0)) {
+    LOG_GENERAL(WARNING, "ProtoShardingStructure serialization failed");
+    return nullptr;
+  }
+
+  lock_guard<mutex> g(mutexEncoded);
+  encodedVersion = version;
+  encodedShards = shards;
+  encoded = result;
+  return encoded;
+}
+
+namespace {
+// The fields of a ProtoAccountBase in the order protobuf writes them. The
+// encoding is what the state trie holds, so it has to stay byte for byte that
+// of AccountBaseToProtobuf.
+const uint32_t ACCOUNT_BASE_VERSION_TAG = WireFormatLite::MakeTag(
+    ProtoAccountBase::kVersionFieldNumber, WireFormatLite::WIRETYPE_VARINT);
+const uint32_t ACCOUNT_BASE_BALANCE_TAG =
+    WireFormatLite::MakeTag(ProtoAccountBase::kBalanceFieldNumber,
+                            WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+const uint32_t ACCOUNT_BASE_NONCE_TAG = WireFormatLite::MakeTag(
+    ProtoAccountBase::kNonceFieldNumber, WireFormatLite::WIRETYPE_VARINT);
+const uint32_t ACCOUNT_BASE_CODEHASH_TAG =
+    WireFormatLite::MakeTag(ProtoAccountBase::kCodehashFieldNumber,
+                            WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+const uint32_t ACCOUNT_BASE_STORAGEROOT_TAG =
+    WireFormatLite::MakeTag(ProtoAccountBase::kStoragerootFieldNumber,
+                            WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+const uint32_t BYTEARRAY_DATA_TAG =
+    WireFormatLite::MakeTag(ByteArray::kDataFieldNumber,
+                            WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+
+uint8_t* WriteHashToArray(const uint32_t tag, const dev::h256& hash,
+                          uint8_t* target) {
+  using google::protobuf::io::CodedOutputStream;
+  target = CodedOutputStream::WriteVarint32ToArray(tag, target);
+  target = CodedOutputStream::WriteVarint32ToArray(dev::h256::size, target);
+  return copy(hash.begin(), hash.end(), target);
+}
+
+// Reads a length delimited field of exactly value.size bytes into value
+template <class T>
+bool ReadFixedBytes(google::protobuf::io::CodedInputStream& codedIn,
+                    T& value) {
+  uint32_t length = 0;
+  return codedIn.ReadVarint32(&length) && length == value.size &&
+         codedIn.ReadRaw(value.data(), length);
+}
+
+// Decodes the fields of the ProtoAccountBase in src for which a destination
+// is given, skipping the others without parsing them. The balance and nonce
+// asked for must be present, and the balance exactly UINT128_SIZE bytes.
+bool ReadAccountBaseFields(const bytes& src, const unsigned int offset,
+                           uint32_t* version, uint128_t* balance,
+                           uint64_t* nonce, dev::h256* codeHash,
+                           dev::h256* storageRoot) {
   if (offset >= src.size()) {
     LOG_GENERAL(WARNING, "Invalid data and offset, data size "
                              << src.size() << ", offset " << offset);
     return false;
   }
 
-  ProtoAccountBase result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  google::protobuf::io::CodedInputStream codedIn(src.data() + offset,
+                                                 src.size() - offset);
+  bool hasBalance = false;
+  bool hasNonce = false;
+  const bool ret =
+      ReadFields(codedIn, [&](int field, WireFormatLite::WireType type) {
+        const uint32_t tag = WireFormatLite::MakeTag(field, type);
+        if (tag == ACCOUNT_BASE_VERSION_TAG && version != nullptr) {
+          return codedIn.ReadVarint32(version) ? 1 : -1;
+        }
+        if (tag == ACCOUNT_BASE_NONCE_TAG && nonce != nullptr) {
+          hasNonce = true;
+          return codedIn.ReadVarint64(nonce) ? 1 : -1;
+        }
+        if (tag == ACCOUNT_BASE_CODEHASH_TAG && codeHash != nullptr) {
+          return ReadFixedBytes(codedIn, *codeHash) ? 1 : -1;
+        }
+        if (tag == ACCOUNT_BASE_STORAGEROOT_TAG && storageRoot != nullptr) {
+          return ReadFixedBytes(codedIn, *storageRoot) ? 1 : -1;
+        }
+        if (tag == ACCOUNT_BASE_BALANCE_TAG && balance != nullptr) {
+          return ReadEmbeddedFields(
+                     codedIn,
+                     [&](int byteArrayField,
+                         WireFormatLite::WireType byteArrayType) {
+                       if (WireFormatLite::MakeTag(byteArrayField,
+                                                   byteArrayType) !=
+                           BYTEARRAY_DATA_TAG) {
+                         return 0;
+                       }
+                       string data;
+                       if (!WireFormatLite::ReadBytes(&codedIn, &data) ||
+                           data.size() != UINT128_SIZE) {
+                         return -1;
+                       }
+                       *balance = Serializable::GetNumber<uint128_t>(
+                           bytes(data.begin(), data.end()), 0, UINT128_SIZE);
+                       hasBalance = true;
+                       return 1;
+                     })
+                     ? 1
+                     : -1;
+        }
+        return 0;
+      });
 
-  if (!result.IsInitialized()) {
-    LOG_GENERAL(WARNING, "ProtoAccount initialization failed");
+  if (!ret) {
+    LOG_GENERAL(WARNING, "ProtoAccountBase decoding failed");
+    return false;
+  }
+  if ((balance != nullptr && !hasBalance) || (nonce != nullptr && !hasNonce)) {
+    LOG_GENERAL(WARNING, "ProtoAccountBase initialization failed");
     return false;
   }
+  return true;
+}
+}  // namespace
 
-  if (!ProtobufToAccountBase(result, accountbase)) {
-    LOG_GENERAL(WARNING, "ProtobufToAccountBase failed");
+bool Messenger::SetAccountBase(bytes& dst, const unsigned int offset,
+                               const AccountBase& accountbase) {
+  using google::protobuf::io::CodedOutputStream;
+
+  // Written directly instead of through a ProtoAccountBase, as every account
+  // written to the state trie goes through here
+  const uint32_t version = accountbase.GetVersion();
+  const uint64_t nonce = accountbase.GetNonce();
+  const bool hasCodeHash = accountbase.GetCodeHash() != dev::h256();
+  const bool hasStorageRoot = accountbase.GetStorageRoot() != dev::h256();
+
+  const unsigned int balanceSize = 2 + UINT128_SIZE;
+  const unsigned int hashSize = 2 + dev::h256::size;
+  const unsigned int size =
+      (version != 0 ? 1 + CodedOutputStream::VarintSize32(version) : 0) + 2 +
+      balanceSize + 1 + CodedOutputStream::VarintSize64(nonce) +
+      (hasCodeHash ? hashSize : 0) + (hasStorageRoot ? hashSize : 0);
+  if (offset + size > dst.size()) {
+    dst.resize(offset + size);
+  }
+
+  uint8_t* target = dst.data() + offset;
+  if (version != 0) {
+    target = CodedOutputStream::WriteVarint32ToArray(ACCOUNT_BASE_VERSION_TAG,
+                                                     target);
+    target = CodedOutputStream::WriteVarint32ToArray(version, target);
+  }
+  target =
+      CodedOutputStream::WriteVarint32ToArray(ACCOUNT_BASE_BALANCE_TAG, target);
+  target = CodedOutputStream::WriteVarint32ToArray(balanceSize, target);
+  target = CodedOutputStream::WriteVarint32ToArray(BYTEARRAY_DATA_TAG, target);
+  target = CodedOutputStream::WriteVarint32ToArray(UINT128_SIZE, target);
+  NumberToArray<uint128_t, UINT128_SIZE>(accountbase.GetBalance(), dst,
+                                         target - dst.data());
+  target += UINT128_SIZE;
+  target =
+      CodedOutputStream::WriteVarint32ToArray(ACCOUNT_BASE_NONCE_TAG, target);
+  target = CodedOutputStream::WriteVarint64ToArray(nonce, target);
+  if (hasCodeHash) {
+    target = WriteHashToArray(ACCOUNT_BASE_CODEHASH_TAG,
+                              accountbase.GetCodeHash(), target);
+  }
+  if (hasStorageRoot) {
+    WriteHashToArray(ACCOUNT_BASE_STORAGEROOT_TAG,
+                     accountbase.GetStorageRoot(), target);
+  }
+
+  return true;
+}
+
+bool Messenger::GetAccountBase(const bytes& src, const unsigned int offset,
+                               AccountBase& accountbase) {
+  uint32_t version = 0;
+  uint128_t balance = 0;
+  uint64_t nonce = 0;
+  dev::h256 codeHash;
+  dev::h256 storageRoot;
+  if (!ReadAccountBaseFields(src, offset, &version, &balance, &nonce,
+                             &codeHash, &storageRoot)) {
     return false;
   }
 
+  accountbase.SetVersion(version);
+  accountbase.SetBalance(balance);
+  accountbase.SetNonce(nonce);
+  if (codeHash != dev::h256()) {
+    accountbase.SetCodeHash(codeHash);
+  }
+  if (storageRoot != dev::h256()) {
+    accountbase.SetStorageRoot(storageRoot);
+  }
+
   return true;
 }
 
+bool Messenger::GetAccountBaseBalance(const bytes& src,
+                                      const unsigned int offset,
+                                      uint128_t& balance) {
+  balance = 0;
+  return ReadAccountBaseFields(src, offset, nullptr, &balance, nullptr,
+                               nullptr, nullptr);
+}
+
+bool Messenger::GetAccountBaseNonce(const bytes& src, const unsigned int offset,
+                                    uint64_t& nonce) {
+  nonce = 0;
+  return ReadAccountBaseFields(src, offset, nullptr, nullptr, &nonce, nullptr,
+                               nullptr);
+}
+
 bool Messenger::SetAccount(bytes& dst, const unsigned int offset,
                            const Account& account) {
-  ProtoAccount result;
+  ArenaMessage<ProtoAccount> result;
 
-  AccountToProtobuf(account, result);
+  AccountToProtobuf(account, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoAccount initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetAccount(const bytes& src, const unsigned int offset,
@@ -2492,17 +2915,17 @@ bool Messenger::GetAccount(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoAccount result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoAccount> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoAccount initialization failed");
     return false;
   }
 
   Address address;
 
-  if (!ProtobufToAccount(result, account, address)) {
+  if (!ProtobufToAccount(*result, account, address)) {
     LOG_GENERAL(WARNING, "ProtobufToAccount failed");
     return false;
   }
@@ -2513,27 +2936,27 @@ bool Messenger::GetAccount(const bytes& src, const unsigned int offset,
 bool Messenger::SetAccountDelta(bytes& dst, const unsigned int offset,
                                 Account* oldAccount,
                                 const Account& newAccount) {
-  ProtoAccount result;
+  ArenaMessage<ProtoAccount> result;
 
-  AccountDeltaToProtobuf(oldAccount, newAccount, result);
+  AccountDeltaToProtobuf(oldAccount, newAccount, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoAccount initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 template <class MAP>
 bool Messenger::SetAccountStore(bytes& dst, const unsigned int offset,
                                 const MAP& addressToAccount) {
-  ProtoAccountStore result;
+  ArenaMessage<ProtoAccountStore> result;
 
   LOG_GENERAL(INFO, "Accounts to serialize: " << addressToAccount.size());
 
   for (const auto& entry : addressToAccount) {
-    ProtoAccountStore::AddressAccount* protoEntry = result.add_entries();
+    ProtoAccountStore::AddressAccount* protoEntry = result->add_entries();
     protoEntry->set_address(entry.first.data(), entry.first.size);
     ProtoAccount* protoEntryAccount = protoEntry->mutable_account();
     AccountToProtobuf(entry.second, *protoEntryAccount);
@@ -2543,12 +2966,12 @@ bool Messenger::SetAccountStore(bytes& dst, const unsigned int offset,
     }
   }
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 template <class MAP>
@@ -2560,17 +2983,17 @@ bool Messenger::GetAccountStore(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoAccountStore result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoAccountStore> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
     return false;
   }
 
-  LOG_GENERAL(INFO, "Accounts deserialized: " << result.entries().size());
+  LOG_GENERAL(INFO, "Accounts deserialized: " << result->entries().size());
 
-  for (const auto& entry : result.entries()) {
+  for (const auto& entry : result->entries()) {
     Address address;
     Account account;
 
@@ -2598,17 +3021,17 @@ bool Messenger::GetAccountStore(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoAccountStore result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoAccountStore> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
     return false;
   }
 
-  LOG_GENERAL(INFO, "Accounts deserialized: " << result.entries().size());
+  LOG_GENERAL(INFO, "Accounts deserialized: " << result->entries().size());
 
-  for (const auto& entry : result.entries()) {
+  for (const auto& entry : result->entries()) {
     Address address;
     Account account;
 
@@ -2631,16 +3054,17 @@ bool Messenger::GetAccountStore(const bytes& src, const unsigned int offset,
 bool Messenger::SetAccountStoreDelta(bytes& dst, const unsigned int offset,
                                      AccountStoreTemp& accountStoreTemp,
                                      AccountStore& accountStore) {
-  ProtoAccountStore result;
+  ArenaMessage<ProtoAccountStore> result;
 
   LOG_GENERAL(INFO, "Account deltas to serialize: "
                         << accountStoreTemp.GetNumOfAccounts());
 
-  for (const auto& entry : *accountStoreTemp.GetAddressToAccount()) {
-    ProtoAccountStore::AddressAccount* protoEntry = result.add_entries();
-    protoEntry->set_address(entry.first.data(), entry.first.size);
+  for (const auto* entry :
+       accountStoreTemp.GetAddressToAccount()->GetSortedEntries()) {
+    ProtoAccountStore::AddressAccount* protoEntry = result->add_entries();
+    protoEntry->set_address(entry->first.data(), entry->first.size);
     ProtoAccount* protoEntryAccount = protoEntry->mutable_account();
-    AccountDeltaToProtobuf(accountStore.GetAccount(entry.first), entry.second,
+    AccountDeltaToProtobuf(accountStore.GetAccount(entry->first), entry->second,
                            *protoEntryAccount);
     if (!protoEntryAccount->IsInitialized()) {
       LOG_GENERAL(WARNING, "ProtoAccount initialization failed");
@@ -2648,12 +3072,31 @@ bool Messenger::SetAccountStoreDelta(bytes& dst, const unsigned int offset,
     }
   }
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
+}
+
+bool Messenger::SetAccountStoreDeltaEntry(bytes& dst,
+                                          const unsigned int offset,
+                                          const Address& address,
+                                          const Account* oldAccount,
+                                          const Account& newAccount) {
+  ArenaMessage<ProtoAccountStore> result;
+
+  ProtoAccountStore::AddressAccount* protoEntry = result->add_entries();
+  protoEntry->set_address(address.data(), address.size);
+  ProtoAccount* protoEntryAccount = protoEntry->mutable_account();
+  AccountDeltaToProtobuf(oldAccount, newAccount, *protoEntryAccount);
+  if (!protoEntryAccount->IsInitialized()) {
+    LOG_GENERAL(WARNING, "ProtoAccount initialization failed");
+    return false;
+  }
+
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::StateDeltaToAddressMap(
@@ -2665,15 +3108,15 @@ bool Messenger::StateDeltaToAddressMap(
     return false;
   }
 
-  ProtoAccountStore result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoAccountStore> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
     return false;
   }
 
-  for (const auto& entry : result.entries()) {
+  for (const auto& entry : result->entries()) {
     Address address;
     Account account;
 
@@ -2697,22 +3140,16 @@ bool Messenger::StateDeltaToAddressMap(
   return true;
 }
 
-bool Messenger::GetAccountStoreDelta(const bytes& src,
-                                     const unsigned int offset,
-                                     AccountStore& accountStore,
-                                     const bool revertible, bool temp) {
-  ProtoAccountStore result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
-
-  if (!result.IsInitialized()) {
-    LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
-    return false;
-  }
-
+namespace {
+// Leaves the state trie out for the addresses put in touched, if any
+bool AccountStoreDeltaToAccounts(const ProtoAccountStore& delta,
+                                 AccountStore& accountStore,
+                                 const bool revertible, const bool temp,
+                                 set<Address>* touched) {
   LOG_GENERAL(INFO,
-              "Total Number of Accounts Delta: " << result.entries().size());
+              "Total Number of Accounts Delta: " << delta.entries().size());
 
-  for (const auto& entry : result.entries()) {
+  for (const auto& entry : delta.entries()) {
     Address address;
     Account account, t_account;
 
@@ -2745,29 +3182,78 @@ bool Messenger::GetAccountStoreDelta(const bytes& src,
       return false;
     }
 
-    accountStore.AddAccountDuringDeserialization(address, account, t_account,
-                                                 fullCopy, revertible);
+    accountStore.AddAccountDuringDeserialization(
+        address, account, t_account, fullCopy, revertible, touched == nullptr);
+    if (touched != nullptr) {
+      touched->emplace(address);
+    }
   }
 
   return true;
 }
+}  // namespace
+
+bool Messenger::GetAccountStoreDelta(const bytes& src,
+                                     const unsigned int offset,
+                                     AccountStore& accountStore,
+                                     const bool revertible, bool temp) {
+  ArenaMessage<ProtoAccountStore> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result->IsInitialized()) {
+    LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
+    return false;
+  }
+
+  return AccountStoreDeltaToAccounts(*result, accountStore, revertible, temp,
+                                     nullptr);
+}
+
+bool Messenger::GetAccountStoreDeltas(const vector<const bytes*>& srcs,
+                                      AccountStore& accountStore,
+                                      const unsigned int numThreads,
+                                      set<Address>& touched) {
+  using Delta = unique_ptr<ProtoAccountStore>;
+
+  bool applied = true;
+  auto decode = [&srcs](size_t i, Delta& delta) {
+    delta = make_unique<ProtoAccountStore>();
+    if (!delta->ParseFromArray(srcs.at(i)->data(), srcs.at(i)->size()) ||
+        !delta->IsInitialized()) {
+      LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
+      return false;
+    }
+    return true;
+  };
+  auto apply = [&](size_t, Delta& delta) {
+    applied = AccountStoreDeltaToAccounts(*delta, accountStore, false, false,
+                                          &touched);
+    return applied;
+  };
+
+  size_t numApplied = 0;
+  return RunOrderedPipeline<Delta>("DecodeStateDeltas", srcs.size(),
+                                   numThreads, numThreads * 4, decode, apply,
+                                   numApplied) &&
+         applied;
+}
 
 bool Messenger::GetAccountStoreDelta(const bytes& src,
                                      const unsigned int offset,
                                      AccountStoreTemp& accountStoreTemp,
                                      bool temp) {
-  ProtoAccountStore result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoAccountStore> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
     return false;
   }
 
   LOG_GENERAL(INFO,
-              "Total Number of Accounts Delta: " << result.entries().size());
+              "Total Number of Accounts Delta: " << result->entries().size());
 
-  for (const auto& entry : result.entries()) {
+  for (const auto& entry : result->entries()) {
     Address address;
     Account account;
 
@@ -2877,16 +3363,16 @@ bool Messenger::GetDSBlockHeader(const bytes& src, const unsigned int offset,
 
 bool Messenger::SetDSBlock(bytes& dst, const unsigned int offset,
                            const DSBlock& dsBlock) {
-  ProtoDSBlock result;
+  ArenaMessage<ProtoDSBlock> result;
 
-  DSBlockToProtobuf(dsBlock, result);
+  DSBlockToProtobuf(dsBlock, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoDSBlock initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetDSBlock(const bytes& src, const unsigned int offset,
@@ -2897,15 +3383,15 @@ bool Messenger::GetDSBlock(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoDSBlock result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoDSBlock> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoDSBlock initialization failed");
     return false;
   }
 
-  return ProtobufToDSBlock(result, dsBlock);
+  return ProtobufToDSBlock(*result, dsBlock);
 }
 
 bool Messenger::SetMicroBlockHeader(bytes& dst, const unsigned int offset,
@@ -2945,16 +3431,16 @@ bool Messenger::GetMicroBlockHeader(const bytes& src, const unsigned int offset,
 
 bool Messenger::SetMicroBlock(bytes& dst, const unsigned int offset,
                               const MicroBlock& microBlock) {
-  ProtoMicroBlock result;
+  ArenaMessage<ProtoMicroBlock> result;
 
-  MicroBlockToProtobuf(microBlock, result);
+  MicroBlockToProtobuf(microBlock, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoMicroBlock initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetMicroBlock(const bytes& src, const unsigned int offset,
@@ -2965,15 +3451,15 @@ bool Messenger::GetMicroBlock(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoMicroBlock result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoMicroBlock> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoMicroBlock initialization failed");
     return false;
   }
 
-  return ProtobufToMicroBlock(result, microBlock);
+  return ProtobufToMicroBlock(*result, microBlock);
 }
 
 bool Messenger::SetTxBlockHeader(bytes& dst, const unsigned int offset,
@@ -3011,16 +3497,16 @@ bool Messenger::GetTxBlockHeader(const bytes& src, const unsigned int offset,
 
 bool Messenger::SetTxBlock(bytes& dst, const unsigned int offset,
                            const TxBlock& txBlock) {
-  ProtoTxBlock result;
+  ArenaMessage<ProtoTxBlock> result;
 
-  TxBlockToProtobuf(txBlock, result);
+  TxBlockToProtobuf(txBlock, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTxBlock initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetTxBlock(const bytes& src, const unsigned int offset,
@@ -3031,15 +3517,15 @@ bool Messenger::GetTxBlock(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoTxBlock result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoTxBlock> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTxBlock initialization failed");
     return false;
   }
 
-  return ProtobufToTxBlock(result, txBlock);
+  return ProtobufToTxBlock(*result, txBlock);
 }
 
 bool Messenger::SetVCBlockHeader(bytes& dst, const unsigned int offset,
@@ -3077,16 +3563,16 @@ bool Messenger::GetVCBlockHeader(const bytes& src, const unsigned int offset,
 
 bool Messenger::SetVCBlock(bytes& dst, const unsigned int offset,
                            const VCBlock& vcBlock) {
-  ProtoVCBlock result;
+  ArenaMessage<ProtoVCBlock> result;
 
-  VCBlockToProtobuf(vcBlock, result);
+  VCBlockToProtobuf(vcBlock, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoVCBlock initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetVCBlock(const bytes& src, const unsigned int offset,
@@ -3097,15 +3583,15 @@ bool Messenger::GetVCBlock(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoVCBlock result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoVCBlock> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoVCBlock initialization failed");
     return false;
   }
 
-  return ProtobufToVCBlock(result, vcBlock);
+  return ProtobufToVCBlock(*result, vcBlock);
 }
 
 bool Messenger::SetFallbackBlockHeader(
@@ -3149,16 +3635,16 @@ bool Messenger::GetFallbackBlockHeader(
 
 bool Messenger::SetFallbackBlock(bytes& dst, const unsigned int offset,
                                  const FallbackBlock& fallbackBlock) {
-  ProtoFallbackBlock result;
+  ArenaMessage<ProtoFallbackBlock> result;
 
-  FallbackBlockToProtobuf(fallbackBlock, result);
+  FallbackBlockToProtobuf(fallbackBlock, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoFallbackBlock initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetFallbackBlock(const bytes& src, const unsigned int offset,
@@ -3169,30 +3655,30 @@ bool Messenger::GetFallbackBlock(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoFallbackBlock result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoFallbackBlock> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoFallbackBlock initialization failed");
     return false;
   }
 
-  ProtobufToFallbackBlock(result, fallbackBlock);
+  ProtobufToFallbackBlock(*result, fallbackBlock);
 
   return true;
 }
 
 bool Messenger::SetTransactionCoreInfo(bytes& dst, const unsigned int offset,
                                        const TransactionCoreInfo& transaction) {
-  ProtoTransactionCoreInfo result;
+  ArenaMessage<ProtoTransactionCoreInfo> result;
 
-  TransactionCoreInfoToProtobuf(transaction, result);
+  TransactionCoreInfoToProtobuf(transaction, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTransactionCoreInfo initialization failed");
     return false;
   }
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetTransactionCoreInfo(const bytes& src,
@@ -3204,28 +3690,28 @@ bool Messenger::GetTransactionCoreInfo(const bytes& src,
     return false;
   }
 
-  ProtoTransactionCoreInfo result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoTransactionCoreInfo> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTransactionCoreInfo initialization failed");
     return false;
   }
 
-  return ProtobufToTransactionCoreInfo(result, transaction);
+  return ProtobufToTransactionCoreInfo(*result, transaction);
 }
 
 bool Messenger::SetTransaction(bytes& dst, const unsigned int offset,
                                const Transaction& transaction) {
-  ProtoTransaction result;
+  ArenaMessage<ProtoTransaction> result;
 
-  TransactionToProtobuf(transaction, result);
+  TransactionToProtobuf(transaction, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTransaction initialization failed");
     return false;
   }
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetTransaction(const bytes& src, const unsigned int offset,
@@ -3236,27 +3722,27 @@ bool Messenger::GetTransaction(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoTransaction result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoTransaction> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTransaction initialization failed");
     return false;
   }
 
-  return ProtobufToTransaction(result, transaction);
+  return ProtobufToTransaction(*result, transaction);
 }
 
 bool Messenger::SetTransactionFileOffset(
     bytes& dst, const unsigned int offset,
     const std::vector<uint32_t>& txnOffsets) {
-  ProtoTxnFileOffset result;
-  TransactionOffsetToProtobuf(txnOffsets, result);
-  if (!result.IsInitialized()) {
+  ArenaMessage<ProtoTxnFileOffset> result;
+  TransactionOffsetToProtobuf(txnOffsets, *result);
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTxnFileOffset initialization failed");
     return false;
   }
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetTransactionFileOffset(const bytes& src,
@@ -3268,27 +3754,27 @@ bool Messenger::GetTransactionFileOffset(const bytes& src,
     return false;
   }
 
-  ProtoTxnFileOffset result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoTxnFileOffset> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTxnFileOffset initialization failed");
     return false;
   }
 
-  ProtobufToTransactionOffset(result, txnOffsets);
+  ProtobufToTransactionOffset(*result, txnOffsets);
   return true;
 }
 
 bool Messenger::SetTransactionArray(bytes& dst, const unsigned int offset,
                                     const std::vector<Transaction>& txns) {
-  ProtoTransactionArray result;
-  TransactionArrayToProtobuf(txns, result);
-  if (!result.IsInitialized()) {
+  ArenaMessage<ProtoTransactionArray> result;
+  TransactionArrayToProtobuf(txns, *result);
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTransactionArray initialization failed");
     return false;
   }
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetTransactionArray(const bytes& src, const unsigned int offset,
@@ -3299,29 +3785,29 @@ bool Messenger::GetTransactionArray(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoTransactionArray result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoTransactionArray> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTransactionArray initialization failed");
     return false;
   }
 
-  return ProtobufToTransactionArray(result, txns);
+  return ProtobufToTransactionArray(*result, txns);
 }
 
 bool Messenger::SetTransactionReceipt(
     bytes& dst, const unsigned int offset,
     const TransactionReceipt& transactionReceipt) {
-  ProtoTransactionReceipt result;
+  ArenaMessage<ProtoTransactionReceipt> result;
 
-  TransactionReceiptToProtobuf(transactionReceipt, result);
+  TransactionReceiptToProtobuf(transactionReceipt, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTransactionReceipt initialization failed");
     return false;
   }
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetTransactionReceipt(const bytes& src,
@@ -3333,29 +3819,63 @@ bool Messenger::GetTransactionReceipt(const bytes& src,
     return false;
   }
 
-  ProtoTransactionReceipt result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoTransactionReceipt> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTransactionReceipt initialization failed");
     return false;
   }
 
-  return ProtobufToTransactionReceipt(result, transactionReceipt);
+  return ProtobufToTransactionReceipt(*result, transactionReceipt);
+}
+
+bool Messenger::SetTransactionReceiptData(
+    bytes& dst, const unsigned int offset,
+    const TransactionReceipt::Data& data) {
+  ArenaMessage<ProtoTransactionReceiptData> result;
+
+  TransactionReceiptDataToProtobuf(data, *result);
+
+  if (!result->IsInitialized()) {
+    LOG_GENERAL(WARNING, "ProtoTransactionReceiptData initialization failed");
+    return false;
+  }
+  return SerializeToArray(*result, dst, offset);
+}
+
+bool Messenger::GetTransactionReceiptData(const bytes& src,
+                                          const unsigned int offset,
+                                          TransactionReceipt::Data& data) {
+  if (offset > src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  ArenaMessage<ProtoTransactionReceiptData> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result->IsInitialized()) {
+    LOG_GENERAL(WARNING, "ProtoTransactionReceiptData initialization failed");
+    return false;
+  }
+
+  return ProtobufToTransactionReceiptData(*result, data);
 }
 
 bool Messenger::SetTransactionWithReceipt(
     bytes& dst, const unsigned int offset,
     const TransactionWithReceipt& transactionWithReceipt) {
-  ProtoTransactionWithReceipt result;
+  ArenaMessage<ProtoTransactionWithReceipt> result;
 
-  TransactionWithReceiptToProtobuf(transactionWithReceipt, result);
+  TransactionWithReceiptToProtobuf(transactionWithReceipt, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTransactionWithReceipt initialization failed");
     return false;
   }
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetTransactionWithReceipt(
@@ -3367,29 +3887,29 @@ bool Messenger::GetTransactionWithReceipt(
     return false;
   }
 
-  ProtoTransactionWithReceipt result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoTransactionWithReceipt> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoTransactionWithReceipt initialization failed");
     return false;
   }
 
-  return ProtobufToTransactionWithReceipt(result, transactionWithReceipt);
+  return ProtobufToTransactionWithReceipt(*result, transactionWithReceipt);
 }
 
 bool Messenger::SetStateIndex(bytes& dst, const unsigned int offset,
                               const vector<Contract::Index>& indexes) {
-  ProtoStateIndex result;
+  ArenaMessage<ProtoStateIndex> result;
 
-  StateIndexToProtobuf(indexes, result);
+  StateIndexToProtobuf(indexes, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoStateIndex initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetStateIndex(const bytes& src, const unsigned int offset,
@@ -3400,29 +3920,29 @@ bool Messenger::GetStateIndex(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoStateIndex result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoStateIndex> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoStateIndex initialization failed");
     return false;
   }
 
-  return ProtobufToStateIndex(result, indexes);
+  return ProtobufToStateIndex(*result, indexes);
 }
 
 bool Messenger::SetStateData(bytes& dst, const unsigned int offset,
                              const Contract::StateEntry& entry) {
-  ProtoStateData result;
+  ArenaMessage<ProtoStateData> result;
 
-  StateDataToProtobuf(entry, result);
+  StateDataToProtobuf(entry, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoStateData initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetStateData(const bytes& src, const unsigned int offset,
@@ -3433,29 +3953,29 @@ bool Messenger::GetStateData(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoStateData result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoStateData> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoStateData initialization failed");
     return false;
   }
 
-  return ProtobufToStateData(result, entry, version);
+  return ProtobufToStateData(*result, entry, version);
 }
 
 bool Messenger::SetPeer(bytes& dst, const unsigned int offset,
                         const Peer& peer) {
-  ProtoPeer result;
+  ArenaMessage<ProtoPeer> result;
 
-  PeerToProtobuf(peer, result);
+  PeerToProtobuf(peer, *result);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoPeer initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetPeer(const bytes& src, const unsigned int offset,
@@ -3466,15 +3986,15 @@ bool Messenger::GetPeer(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoPeer result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoPeer> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoPeer initialization failed");
     return false;
   }
 
-  ProtobufToPeer(result, peer);
+  ProtobufToPeer(*result, peer);
 
   return true;
 }
@@ -3483,26 +4003,26 @@ bool Messenger::SetBlockLink(
     bytes& dst, const unsigned int offset,
     const std::tuple<uint32_t, uint64_t, uint64_t, BlockType, BlockHash>&
         blocklink) {
-  ProtoBlockLink result;
+  ArenaMessage<ProtoBlockLink> result;
 
-  result.set_version(get<BlockLinkIndex::VERSION>(blocklink));
-  result.set_index(get<BlockLinkIndex::INDEX>(blocklink));
-  result.set_dsindex(get<BlockLinkIndex::DSINDEX>(blocklink));
-  result.set_blocktype(get<BlockLinkIndex::BLOCKTYPE>(blocklink));
+  result->set_version(get<BlockLinkIndex::VERSION>(blocklink));
+  result->set_index(get<BlockLinkIndex::INDEX>(blocklink));
+  result->set_dsindex(get<BlockLinkIndex::DSINDEX>(blocklink));
+  result->set_blocktype(get<BlockLinkIndex::BLOCKTYPE>(blocklink));
   BlockHash blkhash = get<BlockLinkIndex::BLOCKHASH>(blocklink);
-  result.set_blockhash(blkhash.data(), blkhash.size);
+  result->set_blockhash(blkhash.data(), blkhash.size);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoBlockLink initialization failed");
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetBlockLink(
     const bytes& src, const unsigned int offset,
     std::tuple<uint32_t, uint64_t, uint64_t, BlockType, BlockHash>& blocklink) {
-  ProtoBlockLink result;
+  ArenaMessage<ProtoBlockLink> result;
   BlockHash blkhash;
 
   if (offset >= src.size()) {
@@ -3511,27 +4031,27 @@ bool Messenger::GetBlockLink(
     return false;
   }
 
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoBlockLink initialization failed");
     return false;
   }
 
-  if (!CheckRequiredFieldsProtoBlockLink(result)) {
+  if (!CheckRequiredFieldsProtoBlockLink(*result)) {
     LOG_GENERAL(WARNING, "CheckRequiredFieldsProtoBlockLink failed");
     return false;
   }
 
-  get<BlockLinkIndex::VERSION>(blocklink) = result.version();
-  get<BlockLinkIndex::INDEX>(blocklink) = result.index();
-  get<BlockLinkIndex::DSINDEX>(blocklink) = result.dsindex();
+  get<BlockLinkIndex::VERSION>(blocklink) = result->version();
+  get<BlockLinkIndex::INDEX>(blocklink) = result->index();
+  get<BlockLinkIndex::DSINDEX>(blocklink) = result->dsindex();
 
-  if (!CopyWithSizeCheck(result.blockhash(), blkhash.asArray())) {
+  if (!CopyWithSizeCheck(result->blockhash(), blkhash.asArray())) {
     return false;
   }
 
-  get<BlockLinkIndex::BLOCKTYPE>(blocklink) = (BlockType)result.blocktype();
+  get<BlockLinkIndex::BLOCKTYPE>(blocklink) = (BlockType)result->blocktype();
   get<BlockLinkIndex::BLOCKHASH>(blocklink) = blkhash;
 
   return true;
@@ -3540,19 +4060,19 @@ bool Messenger::GetBlockLink(
 bool Messenger::SetFallbackBlockWShardingStructure(
     bytes& dst, const unsigned int offset, const FallbackBlock& fallbackblock,
     const uint32_t& shardingStructureVersion, const DequeOfShard& shards) {
-  ProtoFallbackBlockWShardingStructure result;
+  ArenaMessage<ProtoFallbackBlockWShardingStructure> result;
 
-  FallbackBlockToProtobuf(fallbackblock, *result.mutable_fallbackblock());
+  FallbackBlockToProtobuf(fallbackblock, *result->mutable_fallbackblock());
   ShardingStructureToProtobuf(shardingStructureVersion, shards,
-                              *result.mutable_sharding());
+                              *result->mutable_sharding());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "ProtoFallbackBlockWShardingStructure initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetFallbackBlockWShardingStructure(
@@ -3564,10 +4084,10 @@ bool Messenger::GetFallbackBlockWShardingStructure(
     return false;
   }
 
-  ProtoFallbackBlockWShardingStructure result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoFallbackBlockWShardingStructure> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "ProtoFallbackBlockWShardingStructure initialization failed");
     return false;
@@ -3575,7 +4095,7 @@ bool Messenger::GetFallbackBlockWShardingStructure(
 
 // TODO: Check if default value is acceptable for each field
 #if 0
-  if (!result.has_fallbackblock() || !result.has_sharding()) {
+  if (!result->has_fallbackblock() || !result->has_sharding()) {
     LOG_GENERAL(
         WARNING,
         "GetFallbackBlockWShardingStructure check required field failed");
@@ -3583,9 +4103,9 @@ bool Messenger::GetFallbackBlockWShardingStructure(
   }
 #endif
 
-  ProtobufToFallbackBlock(result.fallbackblock(), fallbackblock);
+  ProtobufToFallbackBlock(result->fallbackblock(), fallbackblock);
 
-  return ProtobufToShardingStructure(result.sharding(),
+  return ProtobufToShardingStructure(result->sharding(),
                                      shardingStructureVersion, shards);
 }
 
@@ -3594,19 +4114,19 @@ bool Messenger::SetDiagnosticDataNodes(bytes& dst, const unsigned int offset,
                                        const DequeOfShard& shards,
                                        const uint32_t& dsCommitteeVersion,
                                        const DequeOfNode& dsCommittee) {
-  ProtoDiagnosticDataNodes result;
+  ArenaMessage<ProtoDiagnosticDataNodes> result;
 
   ShardingStructureToProtobuf(shardingStructureVersion, shards,
-                              *result.mutable_shards());
+                              *result->mutable_shards());
   DSCommitteeToProtobuf(dsCommitteeVersion, dsCommittee,
-                        *result.mutable_dscommittee());
+                        *result->mutable_dscommittee());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoDiagnosticDataNodes initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetDiagnosticDataNodes(const bytes& src,
@@ -3615,7 +4135,7 @@ bool Messenger::GetDiagnosticDataNodes(const bytes& src,
                                        DequeOfShard& shards,
                                        uint32_t& dsCommitteeVersion,
                                        DequeOfNode& dsCommittee) {
-  ProtoDiagnosticDataNodes result;
+  ArenaMessage<ProtoDiagnosticDataNodes> result;
 
   if (offset >= src.size()) {
     LOG_GENERAL(WARNING, "Invalid data and offset, data size "
@@ -3623,59 +4143,59 @@ bool Messenger::GetDiagnosticDataNodes(const bytes& src,
     return false;
   }
 
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoDiagnosticDataNodes initialization failed");
     return false;
   }
 
-  if (!ProtobufToShardingStructure(result.shards(), shardingStructureVersion,
+  if (!ProtobufToShardingStructure(result->shards(), shardingStructureVersion,
                                    shards)) {
     LOG_GENERAL(WARNING, "ProtobufToShardingStructure failed");
     return false;
   }
 
-  return ProtobufToDSCommittee(result.dscommittee(), dsCommitteeVersion,
+  return ProtobufToDSCommittee(result->dscommittee(), dsCommitteeVersion,
                                dsCommittee);
 }
 
 bool Messenger::SetDiagnosticDataCoinbase(bytes& dst, const unsigned int offset,
                                           const DiagnosticDataCoinbase& entry) {
-  ProtoDiagnosticDataCoinbase result;
+  ArenaMessage<ProtoDiagnosticDataCoinbase> result;
 
   NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
-      entry.nodeCount, *result.mutable_nodecount());
+      entry.nodeCount, *result->mutable_nodecount());
   NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
-      entry.sigCount, *result.mutable_sigcount());
-  result.set_lookupcount(entry.lookupCount);
+      entry.sigCount, *result->mutable_sigcount());
+  result->set_lookupcount(entry.lookupCount);
   NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
-      entry.totalReward, *result.mutable_totalreward());
+      entry.totalReward, *result->mutable_totalreward());
   NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
-      entry.baseReward, *result.mutable_basereward());
+      entry.baseReward, *result->mutable_basereward());
   NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
-      entry.baseRewardEach, *result.mutable_baserewardeach());
+      entry.baseRewardEach, *result->mutable_baserewardeach());
   NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
-      entry.lookupReward, *result.mutable_lookupreward());
+      entry.lookupReward, *result->mutable_lookupreward());
   NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
-      entry.rewardEachLookup, *result.mutable_rewardeachlookup());
+      entry.rewardEachLookup, *result->mutable_rewardeachlookup());
   NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
-      entry.nodeReward, *result.mutable_nodereward());
+      entry.nodeReward, *result->mutable_nodereward());
   NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
-      entry.rewardEach, *result.mutable_rewardeach());
+      entry.rewardEach, *result->mutable_rewardeach());
   NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
-      entry.balanceLeft, *result.mutable_balanceleft());
+      entry.balanceLeft, *result->mutable_balanceleft());
   SerializableToProtobufByteArray(entry.luckyDrawWinnerKey,
-                                  *result.mutable_luckydrawwinnerkey());
-  result.set_luckydrawwinneraddr(entry.luckyDrawWinnerAddr.data(),
+                                  *result->mutable_luckydrawwinnerkey());
+  result->set_luckydrawwinneraddr(entry.luckyDrawWinnerAddr.data(),
                                  entry.luckyDrawWinnerAddr.size);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoDiagnosticDataCoinbase initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetDiagnosticDataCoinbase(const bytes& src,
@@ -3687,46 +4207,99 @@ bool Messenger::GetDiagnosticDataCoinbase(const bytes& src,
     return false;
   }
 
-  ProtoDiagnosticDataCoinbase result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ProtoDiagnosticDataCoinbase> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoDiagnosticDataCoinbase initialization failed");
     return false;
   }
 
-  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result.nodecount(),
+  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result->nodecount(),
                                                      entry.nodeCount);
-  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result.sigcount(),
+  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result->sigcount(),
                                                      entry.sigCount);
-  entry.lookupCount = result.lookupcount();
-  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result.totalreward(),
+  entry.lookupCount = result->lookupcount();
+  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result->totalreward(),
                                                      entry.totalReward);
-  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result.basereward(),
+  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result->basereward(),
                                                      entry.baseReward);
-  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result.baserewardeach(),
+  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result->baserewardeach(),
                                                      entry.baseRewardEach);
-  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result.lookupreward(),
+  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result->lookupreward(),
                                                      entry.lookupReward);
-  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result.rewardeachlookup(),
+  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result->rewardeachlookup(),
                                                      entry.rewardEachLookup);
-  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result.nodereward(),
+  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result->nodereward(),
                                                      entry.nodeReward);
-  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result.rewardeach(),
+  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result->rewardeach(),
                                                      entry.rewardEach);
-  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result.balanceleft(),
+  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result->balanceleft(),
                                                      entry.balanceLeft);
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.luckydrawwinnerkey(),
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->luckydrawwinnerkey(),
                                   entry.luckyDrawWinnerKey);
-  copy(result.luckydrawwinneraddr().begin(),
-       result.luckydrawwinneraddr().begin() +
-           min((unsigned int)result.luckydrawwinneraddr().size(),
+  copy(result->luckydrawwinneraddr().begin(),
+       result->luckydrawwinneraddr().begin() +
+           min((unsigned int)result->luckydrawwinneraddr().size(),
                (unsigned int)entry.luckyDrawWinnerAddr.size),
        entry.luckyDrawWinnerAddr.asArray().begin());
 
   return true;
 }
 
+bool Messenger::SetDiagnosticDataEpochPerf(
+    bytes& dst, const unsigned int offset,
+    const DiagnosticDataEpochPerf& entry) {
+  ArenaMessage<ProtoDiagnosticDataEpochPerf> result;
+
+  result->set_dsblocknum(entry.dsBlockNum);
+  result->set_powtime(entry.powTime);
+  result->set_dsblockconsensustime(entry.dsBlockConsensusTime);
+  result->set_txnprocessingtime(entry.txnProcessingTime);
+  result->set_microblockconsensustime(entry.microBlockConsensusTime);
+  result->set_finalblockconsensustime(entry.finalBlockConsensusTime);
+  result->set_committime(entry.commitTime);
+  result->set_txncount(entry.txnCount);
+  result->set_bytessent(entry.bytesSent);
+
+  if (!result->IsInitialized()) {
+    LOG_GENERAL(WARNING, "ProtoDiagnosticDataEpochPerf initialization failed");
+    return false;
+  }
+
+  return SerializeToArray(*result, dst, offset);
+}
+
+bool Messenger::GetDiagnosticDataEpochPerf(const bytes& src,
+                                           const unsigned int offset,
+                                           DiagnosticDataEpochPerf& entry) {
+  if (offset >= src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  ArenaMessage<ProtoDiagnosticDataEpochPerf> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result->IsInitialized()) {
+    LOG_GENERAL(WARNING, "ProtoDiagnosticDataEpochPerf initialization failed");
+    return false;
+  }
+
+  entry.dsBlockNum = result->dsblocknum();
+  entry.powTime = result->powtime();
+  entry.dsBlockConsensusTime = result->dsblockconsensustime();
+  entry.txnProcessingTime = result->txnprocessingtime();
+  entry.microBlockConsensusTime = result->microblockconsensustime();
+  entry.finalBlockConsensusTime = result->finalblockconsensustime();
+  entry.commitTime = result->committime();
+  entry.txnCount = result->txncount();
+  entry.bytesSent = result->bytessent();
+
+  return true;
+}
+
 // ============================================================================
 // Peer Manager messages
 // ============================================================================
@@ -3735,18 +4308,20 @@ bool Messenger::SetPMHello(bytes& dst, const unsigned int offset,
                            const PairOfKey& key, const uint32_t listenPort) {
   LOG_MARKER();
 
-  PMHello result;
+  ArenaMessage<PMHello> result;
 
   SerializableToProtobufByteArray(key.second,
-                                  *result.mutable_data()->mutable_pubkey());
-  result.mutable_data()->set_listenport(listenPort);
+                                  *result->mutable_data()->mutable_pubkey());
+  result->mutable_data()->set_listenport(listenPort);
 
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "PMHello.Data initialization failed");
     return false;
   }
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
   if (!Schnorr::Sign(tmp, key.first, key.second, signature)) {
@@ -3754,14 +4329,14 @@ bool Messenger::SetPMHello(bytes& dst, const unsigned int offset,
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "PMHello initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetPMHello(const bytes& src, const unsigned int offset,
@@ -3774,22 +4349,24 @@ bool Messenger::GetPMHello(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  PMHello result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<PMHello> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized() || !result.data().IsInitialized()) {
+  if (!result->IsInitialized() || !result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "PMHello initialization failed");
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.data().pubkey(), pubKey);
-  listenPort = result.data().listenport();
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->data().pubkey(), pubKey);
+  listenPort = result->data().listenport();
 
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, pubKey)) {
     LOG_GENERAL(WARNING, "PMHello signature wrong");
@@ -3811,31 +4388,33 @@ bool Messenger::SetDSPoWSubmission(
     const uint32_t& lookupId, const uint128_t& gasPrice) {
   LOG_MARKER();
 
-  DSPoWSubmission result;
+  ArenaMessage<DSPoWSubmission> result;
 
-  result.mutable_data()->set_blocknumber(blockNumber);
-  result.mutable_data()->set_difficultylevel(difficultyLevel);
+  result->mutable_data()->set_blocknumber(blockNumber);
+  result->mutable_data()->set_difficultylevel(difficultyLevel);
 
   SerializableToProtobufByteArray(
-      submitterPeer, *result.mutable_data()->mutable_submitterpeer());
+      submitterPeer, *result->mutable_data()->mutable_submitterpeer());
   SerializableToProtobufByteArray(
-      submitterKey.second, *result.mutable_data()->mutable_submitterpubkey());
+      submitterKey.second, *result->mutable_data()->mutable_submitterpubkey());
 
-  result.mutable_data()->set_nonce(nonce);
-  result.mutable_data()->set_resultinghash(resultingHash);
-  result.mutable_data()->set_mixhash(mixHash);
-  result.mutable_data()->set_lookupid(lookupId);
+  result->mutable_data()->set_nonce(nonce);
+  result->mutable_data()->set_resultinghash(resultingHash);
+  result->mutable_data()->set_mixhash(mixHash);
+  result->mutable_data()->set_lookupid(lookupId);
 
   NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
-      gasPrice, *result.mutable_data()->mutable_gasprice());
+      gasPrice, *result->mutable_data()->mutable_gasprice());
 
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "DSPoWSubmission.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   // We use MultiSig::SignKey to emphasize that this is for the
   // Proof-of-Possession (PoP) phase (refer to #1097)
@@ -3845,14 +4424,14 @@ bool Messenger::SetDSPoWSubmission(
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "DSPoWSubmission initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetDSPoWSubmission(const bytes& src, const unsigned int offset,
@@ -3870,31 +4449,34 @@ bool Messenger::GetDSPoWSubmission(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  DSPoWSubmission result;
+  ArenaMessage<DSPoWSubmission> result;
 
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized() || !result.data().IsInitialized()) {
+  if (!result->IsInitialized() || !result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "DSPoWSubmission initialization failed");
     return false;
   }
 
-  blockNumber = result.data().blocknumber();
-  difficultyLevel = result.data().difficultylevel();
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.data().submitterpeer(), submitterPeer);
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.data().submitterpubkey(),
+  blockNumber = result->data().blocknumber();
+  difficultyLevel = result->data().difficultylevel();
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->data().submitterpeer(),
+                                  submitterPeer);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->data().submitterpubkey(),
                                   submitterPubKey);
-  nonce = result.data().nonce();
-  resultingHash = result.data().resultinghash();
-  mixHash = result.data().mixhash();
-  lookupId = result.data().lookupid();
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  nonce = result->data().nonce();
+  resultingHash = result->data().resultinghash();
+  mixHash = result->data().mixhash();
+  lookupId = result->data().lookupid();
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
-  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result.data().gasprice(),
+  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result->data().gasprice(),
                                                      gasPrice);
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   // We use MultiSig::VerifyKey to emphasize that this is for the
   // Proof-of-Possession (PoP) phase (refer to #1097)
@@ -3911,30 +4493,32 @@ bool Messenger::SetDSPoWPacketSubmission(
     const vector<DSPowSolution>& dsPowSolutions, const PairOfKey& keys) {
   LOG_MARKER();
 
-  DSPoWPacketSubmission result;
+  ArenaMessage<DSPoWPacketSubmission> result;
 
   for (const auto& sol : dsPowSolutions) {
     DSPowSolutionToProtobuf(sol,
-                            *result.mutable_data()->add_dspowsubmissions());
+                            *result->mutable_data()->add_dspowsubmissions());
   }
 
-  SerializableToProtobufByteArray(keys.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(keys.second, *result->mutable_pubkey());
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
   Signature signature;
   if (!Schnorr::Sign(tmp, keys.first, keys.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign DSPoWPacketSubmission");
     return false;
   }
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "DSPoWPacketSubmission initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetDSPowPacketSubmission(const bytes& src,
@@ -3949,25 +4533,27 @@ bool Messenger::GetDSPowPacketSubmission(const bytes& src,
     return false;
   }
 
-  DSPoWPacketSubmission result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<DSPoWPacketSubmission> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "DSPoWPacketSubmission initialization failed");
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), pubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), pubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
   if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, pubKey)) {
     LOG_GENERAL(WARNING, "DSPoWPacketSubmission signature wrong");
     return false;
   }
 
-  for (const auto& powSubmission : result.data().dspowsubmissions()) {
+  for (const auto& powSubmission : result->data().dspowsubmissions()) {
     DSPowSolution sol;
     ProtobufToDSPowSolution(powSubmission, sol);
     dsPowSolutions.emplace_back(move(sol));
@@ -3984,25 +4570,28 @@ bool Messenger::SetDSMicroBlockSubmission(bytes& dst, const unsigned int offset,
                                           const PairOfKey& keys) {
   LOG_MARKER();
 
-  DSMicroBlockSubmission result;
+  ArenaMessage<DSMicroBlockSubmission> result;
 
-  result.mutable_data()->set_microblocktype(microBlockType);
-  result.mutable_data()->set_epochnumber(epochNumber);
+  result->mutable_data()->set_microblocktype(microBlockType);
+  result->mutable_data()->set_epochnumber(epochNumber);
   for (const auto& microBlock : microBlocks) {
-    MicroBlockToProtobuf(microBlock, *result.mutable_data()->add_microblocks());
+    MicroBlockToProtobuf(microBlock,
+                         *result->mutable_data()->add_microblocks());
   }
   for (const auto& stateDelta : stateDeltas) {
-    result.mutable_data()->add_statedeltas(stateDelta.data(),
+    result->mutable_data()->add_statedeltas(stateDelta.data(),
                                            stateDelta.size());
   }
 
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "DSMicroBlockSubmission.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.mutable_data()->ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
   if (!Schnorr::Sign(tmp, keys.first, keys.second, signature)) {
@@ -4010,15 +4599,15 @@ bool Messenger::SetDSMicroBlockSubmission(bytes& dst, const unsigned int offset,
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
-  SerializableToProtobufByteArray(keys.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
+  SerializableToProtobufByteArray(keys.second, *result->mutable_pubkey());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "DSMicroBlockSubmission initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetDSMicroBlockSubmission(
@@ -4033,36 +4622,38 @@ bool Messenger::GetDSMicroBlockSubmission(
     return false;
   }
 
-  DSMicroBlockSubmission result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<DSMicroBlockSubmission> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized() || !result.data().IsInitialized()) {
+  if (!result->IsInitialized() || !result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "DSMicroBlockSubmission initialization failed");
     return false;
   }
 
   // First deserialize the fields needed just for signature check
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), pubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), pubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   // Check signature
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
   if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, pubKey)) {
     LOG_GENERAL(WARNING, "DSMicroBlockSubmission signature wrong");
     return false;
   }
 
   // Deserialize the remaining fields
-  microBlockType = result.data().microblocktype();
-  epochNumber = result.data().epochnumber();
-  for (const auto& proto_mb : result.data().microblocks()) {
+  microBlockType = result->data().microblocktype();
+  epochNumber = result->data().epochnumber();
+  for (const auto& proto_mb : result->data().microblocks()) {
     MicroBlock microBlock;
     ProtobufToMicroBlock(proto_mb, microBlock);
     microBlocks.emplace_back(move(microBlock));
   }
-  for (const auto& proto_delta : result.data().statedeltas()) {
+  for (const auto& proto_delta : result->data().statedeltas()) {
     stateDeltas.emplace_back();
     copy(proto_delta.begin(), proto_delta.end(),
          std::back_inserter(stateDeltas.back()));
@@ -4228,7 +4819,8 @@ bool Messenger::SetDSFinalBlockAnnouncement(
     bytes& dst, const unsigned int offset, const uint32_t consensusID,
     const uint64_t blockNumber, const bytes& blockHash, const uint16_t leaderID,
     const PairOfKey& leaderKey, const TxBlock& txBlock,
-    const shared_ptr<MicroBlock>& microBlock, bytes& messageToCosign) {
+    const shared_ptr<MicroBlock>& microBlock, bytes& messageToCosign,
+    const bool hashOnly) {
   LOG_MARKER();
 
   ConsensusAnnouncement announcement;
@@ -4236,11 +4828,17 @@ bool Messenger::SetDSFinalBlockAnnouncement(
   // Set the FinalBlock announcement parameters
 
   DSFinalBlockAnnouncement* finalblock = announcement.mutable_finalblock();
-  TxBlockToProtobuf(txBlock, *finalblock->mutable_txblock());
-  if (microBlock != nullptr) {
-    MicroBlockToProtobuf(*microBlock, *finalblock->mutable_microblock());
+  if (hashOnly) {
+    // Block body was already sent in DSFinalBlockProposal
+    const bytes& txBlockHash = txBlock.GetBlockHash().asBytes();
+    finalblock->set_txblockhash(txBlockHash.data(), txBlockHash.size());
   } else {
-    LOG_GENERAL(WARNING, "microblock is nullptr");
+    TxBlockToProtobuf(txBlock, *finalblock->mutable_txblock());
+    if (microBlock != nullptr) {
+      MicroBlockToProtobuf(*microBlock, *finalblock->mutable_microblock());
+    } else {
+      LOG_GENERAL(WARNING, "microblock is nullptr");
+    }
   }
 
   if (!finalblock->IsInitialized()) {
@@ -4274,7 +4872,8 @@ bool Messenger::GetDSFinalBlockAnnouncement(
     const bytes& src, const unsigned int offset, const uint32_t consensusID,
     const uint64_t blockNumber, const bytes& blockHash, const uint16_t leaderID,
     const PubKey& leaderKey, TxBlock& txBlock,
-    shared_ptr<MicroBlock>& microBlock, bytes& messageToCosign) {
+    shared_ptr<MicroBlock>& microBlock, bytes& messageToCosign,
+    bytes& txBlockHash) {
   LOG_MARKER();
 
   if (offset >= src.size()) {
@@ -4307,6 +4906,14 @@ bool Messenger::GetDSFinalBlockAnnouncement(
   // Get the FinalBlock announcement parameters
 
   const DSFinalBlockAnnouncement& finalblock = announcement.finalblock();
+  txBlockHash.clear();
+  if (!finalblock.has_txblock() && !finalblock.txblockhash().empty()) {
+    txBlockHash.resize(finalblock.txblockhash().size());
+    copy(finalblock.txblockhash().begin(), finalblock.txblockhash().end(),
+         txBlockHash.begin());
+    return true;
+  }
+
   if (!ProtobufToTxBlock(finalblock.txblock(), txBlock)) {
     return false;
   }
@@ -4330,6 +4937,101 @@ bool Messenger::GetDSFinalBlockAnnouncement(
   return true;
 }
 
+bool Messenger::SetDSFinalBlockProposal(
+    bytes& dst, const unsigned int offset, const uint64_t blockNumber,
+    const TxBlock& txBlock, const shared_ptr<MicroBlock>& microBlock,
+    const PairOfKey& leaderKey) {
+  LOG_MARKER();
+
+  ArenaMessage<DSFinalBlockProposal> result;
+
+  result->mutable_data()->set_blocknumber(blockNumber);
+  TxBlockToProtobuf(txBlock, *result->mutable_data()->mutable_txblock());
+  if (microBlock != nullptr) {
+    MicroBlockToProtobuf(*microBlock,
+                         *result->mutable_data()->mutable_microblock());
+  }
+
+  if (!result->data().IsInitialized()) {
+    LOG_GENERAL(WARNING, "DSFinalBlockProposal.Data initialization failed");
+    return false;
+  }
+
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
+
+  Signature signature;
+  if (!Schnorr::Sign(tmp, leaderKey.first, leaderKey.second, signature)) {
+    LOG_GENERAL(WARNING, "Failed to sign DSFinalBlockProposal");
+    return false;
+  }
+
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
+  SerializableToProtobufByteArray(leaderKey.second, *result->mutable_pubkey());
+
+  if (!result->IsInitialized()) {
+    LOG_GENERAL(WARNING, "DSFinalBlockProposal initialization failed");
+    return false;
+  }
+
+  return SerializeToArray(*result, dst, offset);
+}
+
+bool Messenger::GetDSFinalBlockProposal(const bytes& src,
+                                        const unsigned int offset,
+                                        uint64_t& blockNumber,
+                                        TxBlock& txBlock,
+                                        shared_ptr<MicroBlock>& microBlock,
+                                        PubKey& leaderKey) {
+  LOG_MARKER();
+
+  if (offset >= src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  ArenaMessage<DSFinalBlockProposal> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result->IsInitialized() || !result->data().IsInitialized()) {
+    LOG_GENERAL(WARNING, "DSFinalBlockProposal initialization failed");
+    return false;
+  }
+
+  // First deserialize the fields needed just for signature check
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), leaderKey);
+  Signature signature;
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
+
+  // Check signature
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
+  if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, leaderKey)) {
+    LOG_GENERAL(WARNING, "DSFinalBlockProposal signature wrong");
+    return false;
+  }
+
+  // Deserialize the remaining fields
+  blockNumber = result->data().blocknumber();
+  if (!ProtobufToTxBlock(result->data().txblock(), txBlock)) {
+    return false;
+  }
+
+  if (result->data().has_microblock()) {
+    microBlock = make_shared<MicroBlock>();
+    ProtobufToMicroBlock(result->data().microblock(), *microBlock);
+  } else {
+    microBlock = nullptr;
+  }
+
+  return true;
+}
+
 bool Messenger::SetDSVCBlockAnnouncement(
     bytes& dst, const unsigned int offset, const uint32_t consensusID,
     const uint64_t blockNumber, const bytes& blockHash, const uint16_t leaderID,
@@ -4427,21 +5129,21 @@ bool Messenger::SetDSMissingMicroBlocksErrorMsg(
     const uint32_t listenPort) {
   LOG_MARKER();
 
-  DSMissingMicroBlocksErrorMsg result;
+  ArenaMessage<DSMissingMicroBlocksErrorMsg> result;
 
   for (const auto& hash : missingMicroBlockHashes) {
-    result.add_mbhashes(hash.data(), hash.size);
+    result->add_mbhashes(hash.data(), hash.size);
   }
 
-  result.set_epochnum(epochNum);
-  result.set_listenport(listenPort);
+  result->set_epochnum(epochNum);
+  result->set_listenport(listenPort);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "DSMissingMicroBlocksErrorMsg initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetDSMissingMicroBlocksErrorMsg(
@@ -4456,15 +5158,15 @@ bool Messenger::GetDSMissingMicroBlocksErrorMsg(
     return false;
   }
 
-  DSMissingMicroBlocksErrorMsg result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<DSMissingMicroBlocksErrorMsg> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "DSMissingMicroBlocksErrorMsg initialization failed");
     return false;
   }
 
-  for (const auto& hash : result.mbhashes()) {
+  for (const auto& hash : result->mbhashes()) {
     missingMicroBlockHashes.emplace_back();
     unsigned int size = min((unsigned int)hash.size(),
                             (unsigned int)missingMicroBlockHashes.back().size);
@@ -4472,8 +5174,8 @@ bool Messenger::GetDSMissingMicroBlocksErrorMsg(
          missingMicroBlockHashes.back().asArray().begin());
   }
 
-  epochNum = result.epochnum();
-  listenPort = result.listenport();
+  epochNum = result->epochnum();
+  listenPort = result->listenport();
 
   return true;
 }
@@ -4488,23 +5190,30 @@ bool Messenger::SetNodeVCDSBlocksMessage(
     const uint32_t& shardingStructureVersion, const DequeOfShard& shards) {
   LOG_MARKER();
 
-  NodeDSBlock result;
+  ArenaMessage<NodeDSBlock> result;
 
-  result.set_shardid(shardId);
-  DSBlockToProtobuf(dsBlock, *result.mutable_dsblock());
+  result->set_shardid(shardId);
+  DSBlockToProtobuf(dsBlock, *result->mutable_dsblock());
 
   for (const auto& vcblock : vcBlocks) {
-    VCBlockToProtobuf(vcblock, *result.add_vcblocks());
+    VCBlockToProtobuf(vcblock, *result->add_vcblocks());
   }
-  ShardingStructureToProtobuf(shardingStructureVersion, shards,
-                              *result.mutable_sharding());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeDSBlock initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  // The sharding structure is the last field, so appending its shared
+  // encoding gives the same bytes as encoding it in the message
+  const auto sharding =
+      GetEncodedShardingStructure(shardingStructureVersion, shards);
+  if (!sharding || !SerializeToArray(*result, dst, offset)) {
+    return false;
+  }
+  EmbeddedToArray(NodeDSBlock::kShardingFieldNumber, *sharding, dst,
+                  offset + result->GetCachedSize());
+  return true;
 }
 
 bool Messenger::GetNodeVCDSBlocksMessage(const bytes& src,
@@ -4521,20 +5230,20 @@ bool Messenger::GetNodeVCDSBlocksMessage(const bytes& src,
     return false;
   }
 
-  NodeDSBlock result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<NodeDSBlock> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeDSBlock initialization failed");
     return false;
   }
 
-  shardId = result.shardid();
-  if (!ProtobufToDSBlock(result.dsblock(), dsBlock)) {
+  shardId = result->shardid();
+  if (!ProtobufToDSBlock(result->dsblock(), dsBlock)) {
     return false;
   }
 
-  for (const auto& proto_vcblock : result.vcblocks()) {
+  for (const auto& proto_vcblock : result->vcblocks()) {
     VCBlock vcblock;
     if (!ProtobufToVCBlock(proto_vcblock, vcblock)) {
       LOG_GENERAL(WARNING, "ProtobufToVCBlock failed");
@@ -4543,7 +5252,7 @@ bool Messenger::GetNodeVCDSBlocksMessage(const bytes& src,
     vcBlocks.emplace_back(move(vcblock));
   }
 
-  return ProtobufToShardingStructure(result.sharding(),
+  return ProtobufToShardingStructure(result->sharding(),
                                      shardingStructureVersion, shards);
 }
 
@@ -4554,19 +5263,19 @@ bool Messenger::SetNodeFinalBlock(bytes& dst, const unsigned int offset,
                                   const bytes& stateDelta) {
   LOG_MARKER();
 
-  NodeFinalBlock result;
+  ArenaMessage<NodeFinalBlock> result;
 
-  result.set_dsblocknumber(dsBlockNumber);
-  result.set_consensusid(consensusID);
-  TxBlockToProtobuf(txBlock, *result.mutable_txblock());
-  result.set_statedelta(stateDelta.data(), stateDelta.size());
+  result->set_dsblocknumber(dsBlockNumber);
+  result->set_consensusid(consensusID);
+  TxBlockToProtobuf(txBlock, *result->mutable_txblock());
+  result->set_statedelta(stateDelta.data(), stateDelta.size());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeFinalBlock initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetNodeFinalBlock(const bytes& src, const unsigned int offset,
@@ -4581,43 +5290,105 @@ bool Messenger::GetNodeFinalBlock(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  NodeFinalBlock result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<NodeFinalBlock> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeFinalBlock initialization failed");
     return false;
   }
 
-  dsBlockNumber = result.dsblocknumber();
-  consensusID = result.consensusid();
-  if (!ProtobufToTxBlock(result.txblock(), txBlock)) {
+  dsBlockNumber = result->dsblocknumber();
+  consensusID = result->consensusid();
+  if (!ProtobufToTxBlock(result->txblock(), txBlock)) {
     return false;
   }
-  stateDelta.resize(result.statedelta().size());
-  copy(result.statedelta().begin(), result.statedelta().end(),
+  stateDelta.resize(result->statedelta().size());
+  copy(result->statedelta().begin(), result->statedelta().end(),
        stateDelta.begin());
 
   return true;
 }
 
+bool Messenger::GetNodeFinalBlockHeader(const bytes& src,
+                                        const unsigned int offset,
+                                        uint64_t& dsBlockNumber,
+                                        TxBlockHeader& txBlockHeader,
+                                        BlockHash& blockHash) {
+  LOG_MARKER();
+
+  if (offset >= src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  google::protobuf::io::ArrayInputStream arrayIn(src.data() + offset,
+                                                 src.size() - offset);
+  google::protobuf::io::CodedInputStream codedIn(&arrayIn);
+
+  ArenaMessage<ProtoTxBlock::TxBlockHeader> protoHeader;
+  bool hasHeader = false;
+  bool hasBlockHash = false;
+  dsBlockNumber = 0;
+
+  auto onTxBlock = [&](int field, WireFormatLite::WireType type) {
+    if (type != WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      return 0;
+    }
+    if (field == ProtoTxBlock::kHeaderFieldNumber) {
+      hasHeader = true;
+      return WireFormatLite::ReadMessage(&codedIn, &*protoHeader) ? 1 : -1;
+    }
+    if (field == ProtoTxBlock::kBlockbaseFieldNumber) {
+      hasBlockHash = true;
+      return ReadBlockBaseHash(codedIn, blockHash) ? 1 : -1;
+    }
+    return 0;
+  };
+
+  if (!ReadFields(codedIn,
+                  [&](int field, WireFormatLite::WireType type) {
+                    if (field == NodeFinalBlock::kDsblocknumberFieldNumber &&
+                        type == WireFormatLite::WIRETYPE_VARINT) {
+                      return codedIn.ReadVarint64(&dsBlockNumber) ? 1 : -1;
+                    }
+                    if (field == NodeFinalBlock::kTxblockFieldNumber &&
+                        type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+                      return ReadEmbeddedFields(codedIn, onTxBlock) ? 1 : -1;
+                    }
+                    return 0;
+                  }) ||
+      !hasHeader || !hasBlockHash) {
+    LOG_GENERAL(WARNING, "NodeFinalBlock header initialization failed");
+    return false;
+  }
+
+  return ProtobufToTxBlockHeader(*protoHeader, txBlockHeader);
+}
+
 bool Messenger::SetNodeMBnForwardTransaction(
     bytes& dst, const unsigned int offset, const MicroBlock& microBlock,
-    const vector<TransactionWithReceipt>& txns) {
+    const vector<TransactionWithReceipt>& txns, const bool compact) {
   LOG_MARKER();
 
-  NodeMBnForwardTransaction result;
+  ArenaMessage<NodeMBnForwardTransaction> result;
 
-  MicroBlockToProtobuf(microBlock, *result.mutable_microblock());
+  MicroBlockToProtobuf(microBlock, *result->mutable_microblock());
 
   unsigned int txnsCount = 0;
 
   for (const auto& txn : txns) {
-    SerializableToProtobufByteArray(txn, *result.add_txnswithreceipt());
+    if (compact) {
+      SerializableToProtobufByteArray(txn.GetTransactionReceipt(),
+                                      *result->add_receipts());
+    } else {
+      SerializableToProtobufByteArray(txn, *result->add_txnswithreceipt());
+    }
     txnsCount++;
   }
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "SetNodeMBnForwardTransaction initialization failed");
     return false;
   }
@@ -4626,7 +5397,7 @@ bool Messenger::SetNodeMBnForwardTransaction(
                                  << " MBHash: " << microBlock.GetBlockHash()
                                  << " Txns: " << txnsCount);
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::SetNodePendingTxn(
@@ -4635,27 +5406,29 @@ bool Messenger::SetNodePendingTxn(
     const uint32_t shardId, const PairOfKey& key) {
   LOG_MARKER();
 
-  NodePendingTxn result;
+  ArenaMessage<NodePendingTxn> result;
 
   SerializableToProtobufByteArray(key.second,
-                                  *result.mutable_data()->mutable_pubkey());
-  result.mutable_data()->set_epochnumber(epochnum);
-  result.mutable_data()->set_shardid(shardId);
+                                  *result->mutable_data()->mutable_pubkey());
+  result->mutable_data()->set_epochnumber(epochnum);
+  result->mutable_data()->set_shardid(shardId);
 
   for (const auto& hashCodePair : hashCodeMap) {
-    auto protoHashCodePair = result.mutable_data()->add_hashcodepair();
+    auto protoHashCodePair = result->mutable_data()->add_hashcodepair();
     protoHashCodePair->set_txnhash(hashCodePair.first.data(),
                                    hashCodePair.first.size);
     protoHashCodePair->set_code(hashCodePair.second);
   }
 
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "NodePendingTxn.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
   if (!Schnorr::Sign(tmp, key.first, key.second, signature)) {
@@ -4663,14 +5436,14 @@ bool Messenger::SetNodePendingTxn(
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodePendingTxn initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetNodePendingTxn(
@@ -4685,28 +5458,30 @@ bool Messenger::GetNodePendingTxn(
     return false;
   }
 
-  NodePendingTxn result;
+  ArenaMessage<NodePendingTxn> result;
 
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized() || !result.data().IsInitialized()) {
+  if (!result->IsInitialized() || !result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "NodePendingTxn initialization failed");
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.data().pubkey(), pubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->data().pubkey(), pubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, pubKey)) {
     LOG_GENERAL(WARNING, "NodePendingTxn signature wrong");
     return false;
   }
 
-  for (const auto& codeHashPair : result.data().hashcodepair()) {
+  for (const auto& codeHashPair : result->data().hashcodepair()) {
     TxnHash txhash;
     unsigned int size = min((unsigned int)codeHashPair.txnhash().size(),
                             (unsigned int)txhash.size);
@@ -4716,8 +5491,8 @@ bool Messenger::GetNodePendingTxn(
                         static_cast<PoolTxnStatus>(codeHashPair.code()));
   }
 
-  epochnum = result.data().epochnumber();
-  shardId = result.data().shardid();
+  epochnum = result->data().epochnumber();
+  shardId = result->data().shardid();
 
   return true;
 }
@@ -4733,26 +5508,34 @@ bool Messenger::GetNodeMBnForwardTransaction(const bytes& src,
     return false;
   }
 
-  NodeMBnForwardTransaction result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<NodeMBnForwardTransaction> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeForwardTransaction initialization failed");
     return false;
   }
 
-  ProtobufToMicroBlock(result.microblock(), entry.m_microBlock);
+  ProtobufToMicroBlock(result->microblock(), entry.m_microBlock);
 
   unsigned int txnsCount = 0;
 
-  for (const auto& txn : result.txnswithreceipt()) {
+  for (const auto& txn : result->txnswithreceipt()) {
     TransactionWithReceipt txr;
     PROTOBUFBYTEARRAYTOSERIALIZABLE(txn, txr);
     entry.m_transactions.emplace_back(txr);
     txnsCount++;
   }
 
-  LOG_GENERAL(INFO, entry << endl << " Txns: " << txnsCount);
+  for (const auto& receipt : result->receipts()) {
+    TransactionReceipt tr;
+    PROTOBUFBYTEARRAYTOSERIALIZABLE(receipt, tr);
+    entry.m_receipts.emplace_back(tr);
+  }
+
+  LOG_GENERAL(INFO, entry << endl
+                          << " Txns: " << txnsCount
+                          << " Receipts: " << entry.m_receipts.size());
 
   return true;
 }
@@ -4761,16 +5544,16 @@ bool Messenger::SetNodeVCBlock(bytes& dst, const unsigned int offset,
                                const VCBlock& vcBlock) {
   LOG_MARKER();
 
-  NodeVCBlock result;
+  ArenaMessage<NodeVCBlock> result;
 
-  VCBlockToProtobuf(vcBlock, *result.mutable_vcblock());
+  VCBlockToProtobuf(vcBlock, *result->mutable_vcblock());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeVCBlock initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetNodeVCBlock(const bytes& src, const unsigned int offset,
@@ -4783,30 +5566,103 @@ bool Messenger::GetNodeVCBlock(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  NodeVCBlock result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<NodeVCBlock> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeVCBlock initialization failed");
     return false;
   }
 
-  return ProtobufToVCBlock(result.vcblock(), vcBlock);
+  return ProtobufToVCBlock(result->vcblock(), vcBlock);
+}
+
+bool Messenger::GetNodeVCBlockHeader(const bytes& src,
+                                     const unsigned int offset,
+                                     VCBlockHeader& vcBlockHeader,
+                                     BlockHash& blockHash) {
+  LOG_MARKER();
+
+  if (offset >= src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  google::protobuf::io::ArrayInputStream arrayIn(src.data() + offset,
+                                                 src.size() - offset);
+  google::protobuf::io::CodedInputStream codedIn(&arrayIn);
+
+  ArenaMessage<ProtoVCBlock::VCBlockHeader> protoHeader;
+  bool hasHeader = false;
+  bool hasBlockHash = false;
+
+  auto onVCBlock = [&](int field, WireFormatLite::WireType type) {
+    if (type != WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      return 0;
+    }
+    if (field == ProtoVCBlock::kHeaderFieldNumber) {
+      hasHeader = true;
+      return WireFormatLite::ReadMessage(&codedIn, &*protoHeader) ? 1 : -1;
+    }
+    if (field == ProtoVCBlock::kBlockbaseFieldNumber) {
+      hasBlockHash = true;
+      return ReadBlockBaseHash(codedIn, blockHash) ? 1 : -1;
+    }
+    return 0;
+  };
+
+  if (!ReadFields(codedIn,
+                  [&](int field, WireFormatLite::WireType type) {
+                    if (field != NodeVCBlock::kVcblockFieldNumber ||
+                        type != WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+                      return 0;
+                    }
+                    return ReadEmbeddedFields(codedIn, onVCBlock) ? 1 : -1;
+                  }) ||
+      !hasHeader || !hasBlockHash) {
+    LOG_GENERAL(WARNING, "NodeVCBlock header initialization failed");
+    return false;
+  }
+
+  return ProtobufToVCBlockHeader(*protoHeader, vcBlockHeader);
+}
+
+namespace {
+/// The hash a lookup signs to attest the txns of a packet as verified. The
+/// txn ids stand for the txns, as ProtobufToTransaction checks them.
+bytes GetTxnPacketCommitment(const NodeForwardTxnBlock& packet) {
+  bytes header;
+  Serializable::SetNumber<uint64_t>(header, 0, packet.epochnumber(),
+                                    sizeof(uint64_t));
+  Serializable::SetNumber<uint64_t>(header, header.size(), packet.dsblocknum(),
+                                    sizeof(uint64_t));
+  Serializable::SetNumber<uint32_t>(header, header.size(), packet.shardid(),
+                                    sizeof(uint32_t));
+
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  sha2.Update(header);
+  for (const auto& txn : packet.transactions()) {
+    sha2.Update(reinterpret_cast<const uint8_t*>(txn.tranid().data()),
+                txn.tranid().size());
+  }
+  return sha2.Finalize();
 }
+}  // namespace
 
 bool Messenger::SetNodeForwardTxnBlock(
     bytes& dst, const unsigned int offset, const uint64_t& epochNumber,
     const uint64_t& dsBlockNum, const uint32_t& shardId,
     const PairOfKey& lookupKey, const std::vector<Transaction>& txnsCurrent,
-    const std::vector<Transaction>& txnsGenerated) {
+    const std::vector<Transaction>& txnsGenerated, const bool attest) {
   LOG_MARKER();
 
-  NodeForwardTxnBlock result;
+  ArenaMessage<NodeForwardTxnBlock> result;
 
-  result.set_epochnumber(epochNumber);
-  result.set_dsblocknum(dsBlockNum);
-  result.set_shardid(shardId);
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  result->set_epochnumber(epochNumber);
+  result->set_dsblocknum(dsBlockNum);
+  result->set_shardid(shardId);
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
 
   unsigned int txnsCurrentCount = 0;
   unsigned int txnsGeneratedCount = 0;
@@ -4817,38 +5673,38 @@ bool Messenger::SetNodeForwardTxnBlock(
     if (msg_size >= PACKET_BYTESIZE_LIMIT) {
       break;
     }
-    ProtoTransaction* protoTxn = new ProtoTransaction();
+    ProtoTransaction* protoTxn = result->add_transactions();
     TransactionToProtobuf(txn, *protoTxn);
-    unsigned txn_size = protoTxn->ByteSize();
+    unsigned txn_size = protoTxn->ByteSizeLong();
     if ((msg_size + txn_size) > PACKET_BYTESIZE_LIMIT &&
         txn_size >= SMALL_TXN_SIZE) {
+      result->mutable_transactions()->RemoveLast();
       continue;
     }
-    *result.add_transactions() = *protoTxn;
     txnsCurrentCount++;
-    msg_size += protoTxn->ByteSize();
+    msg_size += txn_size;
   }
 
   for (const auto& txn : txnsGenerated) {
     if (msg_size >= PACKET_BYTESIZE_LIMIT) {
       break;
     }
-    ProtoTransaction* protoTxn = new ProtoTransaction();
+    ProtoTransaction* protoTxn = result->add_transactions();
     TransactionToProtobuf(txn, *protoTxn);
-    unsigned txn_size = protoTxn->ByteSize();
+    unsigned txn_size = protoTxn->ByteSizeLong();
     if ((msg_size + txn_size) > PACKET_BYTESIZE_LIMIT &&
         txn_size >= SMALL_TXN_SIZE) {
+      result->mutable_transactions()->RemoveLast();
       continue;
     }
-    *result.add_transactions() = *protoTxn;
     txnsGeneratedCount++;
     msg_size += txn_size;
   }
 
   Signature signature;
-  if (result.transactions().size() > 0) {
+  if (result->transactions().size() > 0) {
     bytes tmp;
-    if (!RepeatableToArray(result.transactions(), tmp, 0)) {
+    if (!RepeatableToArray(result->transactions(), tmp, 0)) {
       LOG_GENERAL(WARNING, "Failed to serialize transactions");
       return false;
     }
@@ -4856,11 +5712,22 @@ bool Messenger::SetNodeForwardTxnBlock(
       LOG_GENERAL(WARNING, "Failed to sign transactions");
       return false;
     }
+
+    if (attest) {
+      Signature attestation;
+      if (!Schnorr::Sign(GetTxnPacketCommitment(*result), lookupKey.first,
+                         lookupKey.second, attestation)) {
+        LOG_GENERAL(WARNING, "Failed to attest transactions");
+        return false;
+      }
+      SerializableToProtobufByteArray(attestation,
+                                      *result->mutable_attestation());
+    }
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeForwardTxnBlock initialization failed");
     return false;
   }
@@ -4869,24 +5736,23 @@ bool Messenger::SetNodeForwardTxnBlock(
                               << " Current txns: " << txnsCurrentCount
                               << " Generated txns: " << txnsGeneratedCount);
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
-bool Messenger::SetNodeForwardTxnBlock(bytes& dst, const unsigned int offset,
-                                       const uint64_t& epochNumber,
-                                       const uint64_t& dsBlockNum,
-                                       const uint32_t& shardId,
-                                       const PubKey& lookupKey,
-                                       std::vector<Transaction>& txns,
-                                       const Signature& signature) {
+bool Messenger::SetNodeForwardTxnBlock(
+    bytes& dst, const unsigned int offset, const uint64_t& epochNumber,
+    const uint64_t& dsBlockNum, const uint32_t& shardId,
+    const PubKey& lookupKey, std::vector<Transaction>& txns,
+    const Signature& signature, const Signature& attestation,
+    const bool attested) {
   LOG_MARKER();
 
-  NodeForwardTxnBlock result;
+  ArenaMessage<NodeForwardTxnBlock> result;
 
-  result.set_epochnumber(epochNumber);
-  result.set_dsblocknum(dsBlockNum);
-  result.set_shardid(shardId);
-  SerializableToProtobufByteArray(lookupKey, *result.mutable_pubkey());
+  result->set_epochnumber(epochNumber);
+  result->set_dsblocknum(dsBlockNum);
+  result->set_shardid(shardId);
+  SerializableToProtobufByteArray(lookupKey, *result->mutable_pubkey());
 
   unsigned int txnsCount = 0;
 
@@ -4896,21 +5762,25 @@ bool Messenger::SetNodeForwardTxnBlock(bytes& dst, const unsigned int offset,
     if (msg_size >= PACKET_BYTESIZE_LIMIT) {
       break;
     }
-    ProtoTransaction* protoTxn = new ProtoTransaction();
+    ProtoTransaction* protoTxn = result->add_transactions();
     TransactionToProtobuf(txn, *protoTxn);
-    unsigned txn_size = protoTxn->ByteSize();
+    unsigned txn_size = protoTxn->ByteSizeLong();
     if ((msg_size + txn_size) > PACKET_BYTESIZE_LIMIT &&
         txn_size >= SMALL_TXN_SIZE) {
+      result->mutable_transactions()->RemoveLast();
       continue;
     }
-    *result.add_transactions() = *protoTxn;
     txnsCount++;
     msg_size += txn_size;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
+  if (attested) {
+    SerializableToProtobufByteArray(attestation,
+                                    *result->mutable_attestation());
+  }
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeForwardTxnBlock initialization failed");
     return false;
   }
@@ -4918,48 +5788,61 @@ bool Messenger::SetNodeForwardTxnBlock(bytes& dst, const unsigned int offset,
   LOG_GENERAL(INFO, "Epoch: " << epochNumber << " shardId: " << shardId
                               << " Txns: " << txnsCount);
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetNodeForwardTxnBlock(
     const bytes& src, const unsigned int offset, uint64_t& epochNumber,
     uint64_t& dsBlockNum, uint32_t& shardId, PubKey& lookupPubKey,
-    std::vector<Transaction>& txns, Signature& signature) {
+    std::vector<Transaction>& txns, Signature& signature,
+    Signature& attestation, bool& attested) {
   LOG_MARKER();
 
+  attested = false;
+
   if (offset >= src.size()) {
     LOG_GENERAL(WARNING, "Invalid data and offset, data size "
                              << src.size() << ", offset " << offset);
     return false;
   }
 
-  NodeForwardTxnBlock result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<NodeForwardTxnBlock> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeForwardTxnBlock initialization failed");
     return false;
   }
 
-  epochNumber = result.epochnumber();
-  dsBlockNum = result.dsblocknum();
-  shardId = result.shardid();
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  epochNumber = result->epochnumber();
+  dsBlockNum = result->dsblocknum();
+  shardId = result->shardid();
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubKey);
 
-  if (result.transactions().size() > 0) {
+  if (result->transactions().size() > 0) {
     bytes tmp;
-    if (!RepeatableToArray(result.transactions(), tmp, 0)) {
+    if (!RepeatableToArray(result->transactions(), tmp, 0)) {
       LOG_GENERAL(WARNING, "Failed to serialize transactions");
       return false;
     }
-    PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+    PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
     if (!Schnorr::Verify(tmp, signature, lookupPubKey)) {
       LOG_GENERAL(WARNING, "Invalid signature in transactions");
       return false;
     }
 
-    for (const auto& txn : result.transactions()) {
+    // An invalid attestation only leaves the txns to be verified one by one
+    if (result->has_attestation()) {
+      PROTOBUFBYTEARRAYTOSERIALIZABLE(result->attestation(), attestation);
+      attested = Schnorr::Verify(GetTxnPacketCommitment(*result), attestation,
+                                 lookupPubKey);
+      if (!attested) {
+        LOG_GENERAL(WARNING, "Invalid attestation in transactions");
+      }
+    }
+
+    for (const auto& txn : result->transactions()) {
       Transaction t;
       if (!ProtobufToTransaction(txn, t)) {
         LOG_GENERAL(WARNING, "ProtobufToTransaction failed");
@@ -5165,16 +6048,16 @@ bool Messenger::SetNodeFallbackBlock(bytes& dst, const unsigned int offset,
                                      const FallbackBlock& fallbackBlock) {
   LOG_MARKER();
 
-  NodeFallbackBlock result;
+  ArenaMessage<NodeFallbackBlock> result;
 
-  FallbackBlockToProtobuf(fallbackBlock, *result.mutable_fallbackblock());
+  FallbackBlockToProtobuf(fallbackBlock, *result->mutable_fallbackblock());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeFallbackBlock initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetNodeFallbackBlock(const bytes& src,
@@ -5188,15 +6071,15 @@ bool Messenger::GetNodeFallbackBlock(const bytes& src,
     return false;
   }
 
-  NodeFallbackBlock result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<NodeFallbackBlock> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeFallbackBlock initialization failed");
     return false;
   }
 
-  ProtobufToFallbackBlock(result.fallbackblock(), fallbackBlock);
+  ProtobufToFallbackBlock(result->fallbackblock(), fallbackBlock);
 
   return true;
 }
@@ -5204,18 +6087,15 @@ bool Messenger::GetNodeFallbackBlock(const bytes& src,
 bool Messenger::ShardStructureToArray(bytes& dst, const unsigned int offset,
                                       const uint32_t& version,
                                       const DequeOfShard& shards) {
-  ProtoShardingStructure protoShardingStructure;
-  ShardingStructureToProtobuf(version, shards, protoShardingStructure);
-
-  if (!protoShardingStructure.IsInitialized()) {
-    LOG_GENERAL(WARNING, "ProtoShardingStructure initialization failed");
+  const auto encoded = GetEncodedShardingStructure(version, shards);
+  if (!encoded) {
     return false;
   }
 
-  if (!SerializeToArray(protoShardingStructure, dst, offset)) {
-    LOG_GENERAL(WARNING, "ProtoShardingStructure serialization failed");
-    return false;
+  if ((offset + encoded->size()) > dst.size()) {
+    dst.resize(offset + encoded->size());
   }
+  copy(encoded->begin(), encoded->end(), dst.begin() + offset);
 
   return true;
 }
@@ -5238,32 +6118,50 @@ bool Messenger::ArrayToShardStructure(const bytes& src,
 bool Messenger::SetNodeMissingTxnsErrorMsg(
     bytes& dst, const unsigned int offset,
     const vector<TxnHash>& missingTxnHashes, const uint64_t epochNum,
-    const uint32_t listenPort) {
+    const uint32_t listenPort, const vector<TxnHash>& blockTranHashes) {
   LOG_MARKER();
 
-  NodeMissingTxnsErrorMsg result;
+  ArenaMessage<NodeMissingTxnsErrorMsg> result;
 
+  unordered_map<TxnHash, uint32_t> blockPositions;
+  for (uint32_t i = 0; i < blockTranHashes.size(); i++) {
+    blockPositions.emplace(blockTranHashes[i], i);
+  }
+
+  vector<uint32_t> positions;
   for (const auto& hash : missingTxnHashes) {
     LOG_EPOCH(INFO, epochNum, "Missing txn: " << hash);
-    result.add_txnhashes(hash.data(), hash.size);
+    const auto it = blockPositions.find(hash);
+    if (it != blockPositions.end()) {
+      positions.emplace_back(it->second);
+    } else {
+      result->add_txnhashes(hash.data(), hash.size);
+    }
+  }
+
+  sort(positions.begin(), positions.end());
+  positions.erase(unique(positions.begin(), positions.end()), positions.end());
+  uint32_t previous = 0;
+  for (const auto& position : positions) {
+    result->add_positiongaps(position - previous);
+    previous = position;
   }
 
-  result.set_epochnum(epochNum);
-  result.set_listenport(listenPort);
+  result->set_epochnum(epochNum);
+  result->set_listenport(listenPort);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeMissingTxnsErrorMsg initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
-bool Messenger::GetNodeMissingTxnsErrorMsg(const bytes& src,
-                                           const unsigned int offset,
-                                           vector<TxnHash>& missingTxnHashes,
-                                           uint64_t& epochNum,
-                                           uint32_t& listenPort) {
+bool Messenger::GetNodeMissingTxnsErrorMsg(
+    const bytes& src, const unsigned int offset,
+    vector<TxnHash>& missingTxnHashes, uint64_t& epochNum,
+    uint32_t& listenPort, const vector<TxnHash>& blockTranHashes) {
   LOG_MARKER();
 
   if (offset >= src.size()) {
@@ -5272,15 +6170,15 @@ bool Messenger::GetNodeMissingTxnsErrorMsg(const bytes& src,
     return false;
   }
 
-  NodeMissingTxnsErrorMsg result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<NodeMissingTxnsErrorMsg> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeMissingTxnsErrorMsg initialization failed");
     return false;
   }
 
-  for (const auto& hash : result.txnhashes()) {
+  for (const auto& hash : result->txnhashes()) {
     missingTxnHashes.emplace_back();
     unsigned int size = min((unsigned int)hash.size(),
                             (unsigned int)missingTxnHashes.back().size);
@@ -5288,8 +6186,20 @@ bool Messenger::GetNodeMissingTxnsErrorMsg(const bytes& src,
          missingTxnHashes.back().asArray().begin());
   }
 
-  epochNum = result.epochnum();
-  listenPort = result.listenport();
+  uint64_t position = 0;
+  for (const auto& gap : result->positiongaps()) {
+    position += gap;
+    if (position >= blockTranHashes.size()) {
+      LOG_GENERAL(WARNING, "Missing txn position " << position
+                                                   << " beyond block txns "
+                                                   << blockTranHashes.size());
+      return false;
+    }
+    missingTxnHashes.emplace_back(blockTranHashes[position]);
+  }
+
+  epochNum = result->epochnum();
+  listenPort = result->listenport();
 
   return true;
 }
@@ -5302,16 +6212,16 @@ bool Messenger::SetLookupGetSeedPeers(bytes& dst, const unsigned int offset,
                                       const uint32_t listenPort) {
   LOG_MARKER();
 
-  LookupGetSeedPeers result;
+  ArenaMessage<LookupGetSeedPeers> result;
 
-  result.set_listenport(listenPort);
+  result->set_listenport(listenPort);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetSeedPeers initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupGetSeedPeers(const bytes& src,
@@ -5325,15 +6235,15 @@ bool Messenger::GetLookupGetSeedPeers(const bytes& src,
     return false;
   }
 
-  LookupGetSeedPeers result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetSeedPeers> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetSeedPeers initialization failed");
     return false;
   }
 
-  listenPort = result.listenport();
+  listenPort = result->listenport();
 
   return true;
 }
@@ -5343,7 +6253,7 @@ bool Messenger::SetLookupSetSeedPeers(bytes& dst, const unsigned int offset,
                                       const vector<Peer>& candidateSeeds) {
   LOG_MARKER();
 
-  LookupSetSeedPeers result;
+  ArenaMessage<LookupSetSeedPeers> result;
 
   unordered_set<uint32_t> indicesAlreadyAdded;
 
@@ -5359,15 +6269,15 @@ bool Messenger::SetLookupSetSeedPeers(bytes& dst, const unsigned int offset,
     indicesAlreadyAdded.insert(index);
 
     SerializableToProtobufByteArray(candidateSeeds.at(index),
-                                    *result.add_candidateseeds());
+                                    *result->add_candidateseeds());
   }
 
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
 
   Signature signature;
-  if (result.candidateseeds().size() > 0) {
+  if (result->candidateseeds().size() > 0) {
     bytes tmp;
-    if (!RepeatableToArray(result.candidateseeds(), tmp, 0)) {
+    if (!RepeatableToArray(result->candidateseeds(), tmp, 0)) {
       LOG_GENERAL(WARNING, "Failed to serialize candidate seeds");
       return false;
     }
@@ -5377,14 +6287,14 @@ bool Messenger::SetLookupSetSeedPeers(bytes& dst, const unsigned int offset,
     }
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetSeedPeers initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupSetSeedPeers(const bytes& src,
@@ -5399,28 +6309,28 @@ bool Messenger::GetLookupSetSeedPeers(const bytes& src,
     return false;
   }
 
-  LookupSetSeedPeers result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupSetSeedPeers> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetSeedPeers initialization failed");
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubKey);
 
-  for (const auto& peer : result.candidateseeds()) {
+  for (const auto& peer : result->candidateseeds()) {
     Peer seedPeer;
     PROTOBUFBYTEARRAYTOSERIALIZABLE(peer, seedPeer);
     candidateSeeds.emplace_back(seedPeer);
   }
 
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
-  if (result.candidateseeds().size() > 0) {
+  if (result->candidateseeds().size() > 0) {
     bytes tmp;
-    if (!RepeatableToArray(result.candidateseeds(), tmp, 0)) {
+    if (!RepeatableToArray(result->candidateseeds(), tmp, 0)) {
       LOG_GENERAL(WARNING, "Failed to serialize candidate seeds");
       return false;
     }
@@ -5440,17 +6350,17 @@ bool Messenger::SetLookupGetDSInfoFromSeed(bytes& dst,
                                            const bool initialDS) {
   LOG_MARKER();
 
-  LookupGetDSInfoFromSeed result;
+  ArenaMessage<LookupGetDSInfoFromSeed> result;
 
-  result.set_listenport(listenPort);
-  result.set_initialds(initialDS);
+  result->set_listenport(listenPort);
+  result->set_initialds(initialDS);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetDSInfoFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupGetDSInfoFromSeed(const bytes& src,
@@ -5465,16 +6375,16 @@ bool Messenger::GetLookupGetDSInfoFromSeed(const bytes& src,
     return false;
   }
 
-  LookupGetDSInfoFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetDSInfoFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetDSInfoFromSeed initialization failed");
     return false;
   }
 
-  listenPort = result.listenport();
-  initialDS = result.initialds();
+  listenPort = result->listenport();
+  initialDS = result->initialds();
 
   return true;
 }
@@ -5487,15 +6397,15 @@ bool Messenger::SetLookupSetDSInfoFromSeed(bytes& dst,
                                            const bool initialDS) {
   LOG_MARKER();
 
-  LookupSetDSInfoFromSeed result;
+  ArenaMessage<LookupSetDSInfoFromSeed> result;
 
   DSCommitteeToProtobuf(dsCommitteeVersion, dsNodes,
-                        *result.mutable_dscommittee());
+                        *result->mutable_dscommittee());
 
-  SerializableToProtobufByteArray(senderKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(senderKey.second, *result->mutable_pubkey());
 
   bytes tmp;
-  if (!SerializeToArray(result.dscommittee(), tmp, 0)) {
+  if (!SerializeToArray(result->dscommittee(), tmp, 0)) {
     LOG_GENERAL(WARNING, "Failed to serialize DS committee");
     return false;
   }
@@ -5506,16 +6416,16 @@ bool Messenger::SetLookupSetDSInfoFromSeed(bytes& dst,
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  result.set_initialds(initialDS);
+  result->set_initialds(initialDS);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetDSInfoFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupSetDSInfoFromSeed(
@@ -5529,31 +6439,31 @@ bool Messenger::GetLookupSetDSInfoFromSeed(
     return false;
   }
 
-  LookupSetDSInfoFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), senderPubKey);
+  ArenaMessage<LookupSetDSInfoFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), senderPubKey);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetDSInfoFromSeed initialization failed");
     return false;
   }
 
-  if (!ProtobufToDSCommittee(result.dscommittee(), dsCommitteeVersion,
+  if (!ProtobufToDSCommittee(result->dscommittee(), dsCommitteeVersion,
                              dsNodes)) {
     LOG_GENERAL(WARNING, "ProtobufToDSCommittee failed");
     return false;
   }
 
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   bytes tmp;
-  if (!SerializeToArray(result.dscommittee(), tmp, 0)) {
+  if (!SerializeToArray(result->dscommittee(), tmp, 0)) {
     LOG_GENERAL(WARNING, "Failed to serialize DS committee");
     return false;
   }
 
-  initialDS = result.initialds();
+  initialDS = result->initialds();
 
   if (!Schnorr::Verify(tmp, signature, senderPubKey)) {
     LOG_GENERAL(WARNING, "Invalid signature in DS nodes info");
@@ -5570,18 +6480,18 @@ bool Messenger::SetLookupGetDSBlockFromSeed(bytes& dst,
                                             const uint32_t listenPort) {
   LOG_MARKER();
 
-  LookupGetDSBlockFromSeed result;
+  ArenaMessage<LookupGetDSBlockFromSeed> result;
 
-  result.set_lowblocknum(lowBlockNum);
-  result.set_highblocknum(highBlockNum);
-  result.set_listenport(listenPort);
+  result->set_lowblocknum(lowBlockNum);
+  result->set_highblocknum(highBlockNum);
+  result->set_listenport(listenPort);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetDSBlockFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupGetDSBlockFromSeed(const bytes& src,
@@ -5597,17 +6507,17 @@ bool Messenger::GetLookupGetDSBlockFromSeed(const bytes& src,
     return false;
   }
 
-  LookupGetDSBlockFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetDSBlockFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetDSBlockFromSeed initialization failed");
     return false;
   }
 
-  lowBlockNum = result.lowblocknum();
-  highBlockNum = result.highblocknum();
-  listenPort = result.listenport();
+  lowBlockNum = result->lowblocknum();
+  highBlockNum = result->highblocknum();
+  listenPort = result->listenport();
 
   return true;
 }
@@ -5620,38 +6530,40 @@ bool Messenger::SetLookupSetDSBlockFromSeed(bytes& dst,
                                             const vector<DSBlock>& dsBlocks) {
   LOG_MARKER();
 
-  LookupSetDSBlockFromSeed result;
+  ArenaMessage<LookupSetDSBlockFromSeed> result;
 
-  result.mutable_data()->set_lowblocknum(lowBlockNum);
-  result.mutable_data()->set_highblocknum(highBlockNum);
+  result->mutable_data()->set_lowblocknum(lowBlockNum);
+  result->mutable_data()->set_highblocknum(highBlockNum);
 
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
 
   for (const auto& dsblock : dsBlocks) {
-    DSBlockToProtobuf(dsblock, *result.mutable_data()->add_dsblocks());
+    DSBlockToProtobuf(dsblock, *result->mutable_data()->add_dsblocks());
   }
 
   Signature signature;
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetDSBlockFromSeed.Data initialization failed");
     return false;
   }
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   if (!Schnorr::Sign(tmp, lookupKey.first, lookupKey.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign DS blocks");
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetDSBlockFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupSetDSBlockFromSeed(
@@ -5665,19 +6577,19 @@ bool Messenger::GetLookupSetDSBlockFromSeed(
     return false;
   }
 
-  LookupSetDSBlockFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupSetDSBlockFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetDSBlockFromSeed initialization failed");
     return false;
   }
 
-  lowBlockNum = result.data().lowblocknum();
-  highBlockNum = result.data().highblocknum();
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  lowBlockNum = result->data().lowblocknum();
+  highBlockNum = result->data().highblocknum();
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubKey);
 
-  for (const auto& proto_dsblock : result.data().dsblocks()) {
+  for (const auto& proto_dsblock : result->data().dsblocks()) {
     DSBlock dsblock;
     if (!ProtobufToDSBlock(proto_dsblock, dsblock)) {
       LOG_GENERAL(WARNING, "ProtobufToDSBlock failed");
@@ -5686,11 +6598,13 @@ bool Messenger::GetLookupSetDSBlockFromSeed(
     dsBlocks.emplace_back(dsblock);
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, lookupPubKey)) {
     LOG_GENERAL(WARNING, "Invalid signature in GetLookupSetDSBlockFromSeed");
@@ -5707,18 +6621,18 @@ bool Messenger::SetLookupGetTxBlockFromSeed(bytes& dst,
                                             const uint32_t listenPort) {
   LOG_MARKER();
 
-  LookupGetTxBlockFromSeed result;
+  ArenaMessage<LookupGetTxBlockFromSeed> result;
 
-  result.set_lowblocknum(lowBlockNum);
-  result.set_highblocknum(highBlockNum);
-  result.set_listenport(listenPort);
+  result->set_lowblocknum(lowBlockNum);
+  result->set_highblocknum(highBlockNum);
+  result->set_listenport(listenPort);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetTxBlockFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupGetTxBlockFromSeed(const bytes& src,
@@ -5734,17 +6648,17 @@ bool Messenger::GetLookupGetTxBlockFromSeed(const bytes& src,
     return false;
   }
 
-  LookupGetTxBlockFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetTxBlockFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetTxBlockFromSeed initialization failed");
     return false;
   }
 
-  lowBlockNum = result.lowblocknum();
-  highBlockNum = result.highblocknum();
-  listenPort = result.listenport();
+  lowBlockNum = result->lowblocknum();
+  highBlockNum = result->highblocknum();
+  listenPort = result->listenport();
 
   return true;
 }
@@ -5757,39 +6671,88 @@ bool Messenger::SetLookupSetTxBlockFromSeed(bytes& dst,
                                             const vector<TxBlock>& txBlocks) {
   LOG_MARKER();
 
-  LookupSetTxBlockFromSeed result;
+  ArenaMessage<LookupSetTxBlockFromSeed> result;
 
-  result.mutable_data()->set_lowblocknum(lowBlockNum);
-  result.mutable_data()->set_highblocknum(highBlockNum);
+  result->mutable_data()->set_lowblocknum(lowBlockNum);
+  result->mutable_data()->set_highblocknum(highBlockNum);
 
   for (const auto& txblock : txBlocks) {
-    TxBlockToProtobuf(txblock, *result.mutable_data()->add_txblocks());
+    TxBlockToProtobuf(txblock, *result->mutable_data()->add_txblocks());
   }
 
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
 
   Signature signature;
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetTxBlockFromSeed.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   if (!Schnorr::Sign(tmp, lookupKey.first, lookupKey.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign tx blocks");
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetTxBlockFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
+}
+
+bool Messenger::GetLookupSetTxBlockFromSeedRange(const bytes& src,
+                                                 const unsigned int offset,
+                                                 uint64_t& lowBlockNum,
+                                                 uint64_t& highBlockNum) {
+  LOG_MARKER();
+
+  if (offset >= src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  google::protobuf::io::ArrayInputStream arrayIn(src.data() + offset,
+                                                 src.size() - offset);
+  google::protobuf::io::CodedInputStream codedIn(&arrayIn);
+
+  lowBlockNum = 0;
+  highBlockNum = 0;
+
+  auto onData = [&](int field, WireFormatLite::WireType type) {
+    if (type != WireFormatLite::WIRETYPE_VARINT) {
+      return 0;
+    }
+    if (field == LookupSetTxBlockFromSeed::Data::kLowblocknumFieldNumber) {
+      return codedIn.ReadVarint64(&lowBlockNum) ? 1 : -1;
+    }
+    if (field == LookupSetTxBlockFromSeed::Data::kHighblocknumFieldNumber) {
+      return codedIn.ReadVarint64(&highBlockNum) ? 1 : -1;
+    }
+    return 0;
+  };
+
+  if (!ReadFields(codedIn, [&](int field, WireFormatLite::WireType type) {
+        if (field != LookupSetTxBlockFromSeed::kDataFieldNumber ||
+            type != WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          return 0;
+        }
+        return ReadEmbeddedFields(codedIn, onData) ? 1 : -1;
+      })) {
+    LOG_GENERAL(WARNING,
+                "LookupSetTxBlockFromSeed range initialization failed");
+    return false;
+  }
+
+  return true;
 }
 
 bool Messenger::GetLookupSetTxBlockFromSeed(
@@ -5797,7 +6760,7 @@ bool Messenger::GetLookupSetTxBlockFromSeed(
     uint64_t& highBlockNum, PubKey& lookupPubKey, vector<TxBlock>& txBlocks) {
   LOG_MARKER();
 
-  LookupSetTxBlockFromSeed result;
+  ArenaMessage<LookupSetTxBlockFromSeed> result;
 
   google::protobuf::io::ArrayInputStream arrayIn(src.data() + offset,
                                                  src.size() - offset);
@@ -5805,16 +6768,16 @@ bool Messenger::GetLookupSetTxBlockFromSeed(
   codedIn.SetTotalBytesLimit(MAX_READ_WATERMARK_IN_BYTES,
                              MAX_READ_WATERMARK_IN_BYTES);
 
-  if (!result.ParseFromCodedStream(&codedIn) ||
-      !codedIn.ConsumedEntireMessage() || !result.IsInitialized()) {
+  if (!result->ParseFromCodedStream(&codedIn) ||
+      !codedIn.ConsumedEntireMessage() || !result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetTxBlockFromSeed initialization failed");
     return false;
   }
 
-  lowBlockNum = result.data().lowblocknum();
-  highBlockNum = result.data().highblocknum();
+  lowBlockNum = result->data().lowblocknum();
+  highBlockNum = result->data().highblocknum();
 
-  for (const auto& txblock : result.data().txblocks()) {
+  for (const auto& txblock : result->data().txblocks()) {
     TxBlock block;
     if (!ProtobufToTxBlock(txblock, block)) {
       LOG_GENERAL(WARNING, "ProtobufToTxBlock failed");
@@ -5823,12 +6786,14 @@ bool Messenger::GetLookupSetTxBlockFromSeed(
     txBlocks.emplace_back(block);
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, lookupPubKey)) {
     LOG_GENERAL(WARNING, "Invalid signature in GetLookupSetTxBlockFromSeed");
@@ -5844,17 +6809,17 @@ bool Messenger::SetLookupGetStateDeltaFromSeed(bytes& dst,
                                                const uint32_t listenPort) {
   LOG_MARKER();
 
-  LookupGetStateDeltaFromSeed result;
+  ArenaMessage<LookupGetStateDeltaFromSeed> result;
 
-  result.set_blocknum(blockNum);
-  result.set_listenport(listenPort);
+  result->set_blocknum(blockNum);
+  result->set_listenport(listenPort);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetStateDeltaFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::SetLookupGetStateDeltasFromSeed(bytes& dst,
@@ -5864,18 +6829,18 @@ bool Messenger::SetLookupGetStateDeltasFromSeed(bytes& dst,
                                                 const uint32_t listenPort) {
   LOG_MARKER();
 
-  LookupGetStateDeltasFromSeed result;
+  ArenaMessage<LookupGetStateDeltasFromSeed> result;
 
-  result.set_lowblocknum(lowBlockNum);
-  result.set_highblocknum(highBlockNum);
-  result.set_listenport(listenPort);
+  result->set_lowblocknum(lowBlockNum);
+  result->set_highblocknum(highBlockNum);
+  result->set_listenport(listenPort);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetStateDeltasFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupGetStateDeltaFromSeed(const bytes& src,
@@ -5890,16 +6855,16 @@ bool Messenger::GetLookupGetStateDeltaFromSeed(const bytes& src,
     return false;
   }
 
-  LookupGetStateDeltaFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetStateDeltaFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetStateDeltaFromSeed initialization failed");
     return false;
   }
 
-  blockNum = result.blocknum();
-  listenPort = result.listenport();
+  blockNum = result->blocknum();
+  listenPort = result->listenport();
 
   return true;
 }
@@ -5917,17 +6882,17 @@ bool Messenger::GetLookupGetStateDeltasFromSeed(const bytes& src,
     return false;
   }
 
-  LookupGetStateDeltasFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetStateDeltasFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetStateDeltasFromSeed initialization failed");
     return false;
   }
 
-  lowBlockNum = result.lowblocknum();
-  highBlockNum = result.highblocknum();
-  listenPort = result.listenport();
+  lowBlockNum = result->lowblocknum();
+  highBlockNum = result->highblocknum();
+  listenPort = result->listenport();
 
   return true;
 }
@@ -5939,36 +6904,38 @@ bool Messenger::SetLookupSetStateDeltaFromSeed(bytes& dst,
                                                const bytes& stateDelta) {
   LOG_MARKER();
 
-  LookupSetStateDeltaFromSeed result;
+  ArenaMessage<LookupSetStateDeltaFromSeed> result;
 
-  result.mutable_data()->set_blocknum(blockNum);
+  result->mutable_data()->set_blocknum(blockNum);
 
-  result.mutable_data()->set_statedelta(stateDelta.data(), stateDelta.size());
+  result->mutable_data()->set_statedelta(stateDelta.data(), stateDelta.size());
 
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
 
   Signature signature;
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "LookupSetStateDeltaFromSeed.Data initialization failed");
     return false;
   }
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   if (!Schnorr::Sign(tmp, lookupKey.first, lookupKey.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign StateDelta");
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetStateDeltaFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::SetLookupSetStateDeltasFromSeed(
@@ -5977,39 +6944,41 @@ bool Messenger::SetLookupSetStateDeltasFromSeed(
     const vector<bytes>& stateDeltas) {
   LOG_MARKER();
 
-  LookupSetStateDeltasFromSeed result;
+  ArenaMessage<LookupSetStateDeltasFromSeed> result;
 
-  result.mutable_data()->set_lowblocknum(lowBlockNum);
-  result.mutable_data()->set_highblocknum(highBlockNum);
+  result->mutable_data()->set_lowblocknum(lowBlockNum);
+  result->mutable_data()->set_highblocknum(highBlockNum);
 
   for (const auto& delta : stateDeltas) {
-    result.mutable_data()->add_statedeltas(delta.data(), delta.size());
+    result->mutable_data()->add_statedeltas(delta.data(), delta.size());
   }
 
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
 
   Signature signature;
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "LookupSetStateDeltasFromSeed.Data initialization failed");
     return false;
   }
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   if (!Schnorr::Sign(tmp, lookupKey.first, lookupKey.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign StateDeltas");
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetStateDeltasFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupSetStateDeltaFromSeed(const bytes& src,
@@ -6025,26 +6994,28 @@ bool Messenger::GetLookupSetStateDeltaFromSeed(const bytes& src,
     return false;
   }
 
-  LookupSetStateDeltaFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupSetStateDeltaFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetStateDeltaFromSeed initialization failed");
     return false;
   }
 
-  blockNum = result.data().blocknum();
+  blockNum = result->data().blocknum();
 
-  stateDelta.resize(result.data().statedelta().size());
-  std::copy(result.data().statedelta().begin(),
-            result.data().statedelta().end(), stateDelta.begin());
+  stateDelta.resize(result->data().statedelta().size());
+  std::copy(result->data().statedelta().begin(),
+            result->data().statedelta().end(), stateDelta.begin());
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, lookupPubKey)) {
     LOG_GENERAL(WARNING, "Invalid signature in state delta");
@@ -6065,30 +7036,32 @@ bool Messenger::GetLookupSetStateDeltasFromSeed(
     return false;
   }
 
-  LookupSetStateDeltasFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupSetStateDeltasFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetStateDeltasFromSeed initialization failed");
     return false;
   }
 
-  lowBlockNum = result.data().lowblocknum();
-  highBlockNum = result.data().highblocknum();
+  lowBlockNum = result->data().lowblocknum();
+  highBlockNum = result->data().highblocknum();
   stateDeltas.clear();
-  for (const auto& delta : result.data().statedeltas()) {
+  for (const auto& delta : result->data().statedeltas()) {
     bytes tmp;
     tmp.resize(delta.size());
     std::copy(delta.begin(), delta.end(), tmp.begin());
     stateDeltas.emplace_back(tmp);
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, lookupPubKey)) {
     LOG_GENERAL(WARNING, "Invalid signature in state deltas");
@@ -6099,24 +7072,32 @@ bool Messenger::GetLookupSetStateDeltasFromSeed(
 }
 
 bool Messenger::SetLookupGetStateFromSeed(bytes& dst, const unsigned int offset,
-                                          const uint32_t listenPort) {
+                                          const uint32_t listenPort,
+                                          const Address& cursor,
+                                          const unsigned int maxAccounts) {
   LOG_MARKER();
 
-  LookupGetStateFromSeed result;
+  ArenaMessage<LookupGetStateFromSeed> result;
 
-  result.set_listenport(listenPort);
+  result->set_listenport(listenPort);
+  if (maxAccounts > 0) {
+    result->set_cursor(cursor.data(), cursor.size);
+    result->set_maxaccounts(maxAccounts);
+  }
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetStateFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupGetStateFromSeed(const bytes& src,
                                           const unsigned int offset,
-                                          uint32_t& listenPort) {
+                                          uint32_t& listenPort,
+                                          Address& cursor,
+                                          unsigned int& maxAccounts) {
   LOG_MARKER();
 
   if (offset >= src.size()) {
@@ -6125,59 +7106,86 @@ bool Messenger::GetLookupGetStateFromSeed(const bytes& src,
     return false;
   }
 
-  LookupGetStateFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetStateFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetStateFromSeed initialization failed");
     return false;
   }
 
-  listenPort = result.listenport();
+  listenPort = result->listenport();
+  maxAccounts = result->maxaccounts();
+  cursor = Address();
+  if (result->cursor().size() == cursor.size) {
+    copy(result->cursor().begin(), result->cursor().end(),
+         cursor.asArray().begin());
+  }
 
   return true;
 }
 
 bool Messenger::SetLookupSetStateFromSeed(bytes& dst, const unsigned int offset,
                                           const PairOfKey& lookupKey,
-                                          const AccountStore& accountStore) {
+                                          const AccountStore& accountStore,
+                                          const Address& cursor,
+                                          const unsigned int maxAccounts) {
   LOG_MARKER();
 
-  LookupSetStateFromSeed result;
+  ArenaMessage<LookupSetStateFromSeed> result;
 
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
   Signature signature;
 
   bytes tmp;
 
-  if (!accountStore.Serialize(tmp, 0)) {
-    LOG_GENERAL(WARNING, "Failed to serialize AccountStore");
-    return false;
+  if (maxAccounts == 0) {
+    if (!accountStore.Serialize(tmp, 0)) {
+      LOG_GENERAL(WARNING, "Failed to serialize AccountStore");
+      return false;
+    }
+    result->mutable_accountstore()->set_data(tmp.data(), tmp.size());
+  } else {
+    Address next;
+    bool more = false;
+    dev::h256 root;
+    if (!accountStore.SerializeChunk(tmp, 0, cursor, maxAccounts, next, more,
+                                     root)) {
+      LOG_GENERAL(WARNING, "Failed to serialize AccountStore chunk");
+      return false;
+    }
+    result->mutable_accountstore()->set_data(tmp.data(), tmp.size());
+    if (more) {
+      result->set_next(next.data(), next.size);
+      tmp.insert(tmp.end(), next.begin(), next.end());
+    }
+    result->set_stateroot(root.data(), root.size);
+    tmp.insert(tmp.end(), root.begin(), root.end());
   }
-  result.mutable_accountstore()->set_data(tmp.data(), tmp.size());
 
   if (!Schnorr::Sign(tmp, lookupKey.first, lookupKey.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign accounts");
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetStateFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupSetStateFromSeed(const bytes& src,
                                           const unsigned int offset,
                                           PubKey& lookupPubKey,
-                                          bytes& accountStoreBytes) {
+                                          bytes& accountStoreBytes, bool& more,
+                                          Address& next, dev::h256& stateRoot) {
   LOG_MARKER();
 
-  LookupSetStateFromSeed result;
+  ArenaMessage<LookupSetStateFromSeed> result;
 
   google::protobuf::io::ArrayInputStream arrayIn(src.data() + offset,
                                                  src.size() - offset);
@@ -6185,20 +7193,52 @@ bool Messenger::GetLookupSetStateFromSeed(const bytes& src,
   codedIn.SetTotalBytesLimit(MAX_READ_WATERMARK_IN_BYTES,
                              MAX_READ_WATERMARK_IN_BYTES);
 
-  if (!result.ParseFromCodedStream(&codedIn) ||
-      !codedIn.ConsumedEntireMessage() || !result.IsInitialized()) {
+  if (!result->ParseFromCodedStream(&codedIn) ||
+      !codedIn.ConsumedEntireMessage() || !result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetStateFromSeed initialization failed");
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
-  copy(result.accountstore().data().begin(), result.accountstore().data().end(),
-       back_inserter(accountStoreBytes));
+  copy(result->accountstore().data().begin(),
+       result->accountstore().data().end(), back_inserter(accountStoreBytes));
 
-  if (!Schnorr::Verify(accountStoreBytes, signature, lookupPubKey)) {
+  more = false;
+  next = Address();
+  stateRoot = dev::h256();
+  if (!result->next().empty()) {
+    if (result->next().size() != next.size) {
+      LOG_GENERAL(WARNING, "Invalid next address in accounts");
+      return false;
+    }
+    more = true;
+    copy(result->next().begin(), result->next().end(), next.asArray().begin());
+  }
+  if (!result->stateroot().empty()) {
+    if (result->stateroot().size() != stateRoot.size) {
+      LOG_GENERAL(WARNING, "Invalid state root in accounts");
+      return false;
+    }
+    copy(result->stateroot().begin(), result->stateroot().end(),
+         stateRoot.asArray().begin());
+  }
+
+  // The signature also covers the cursor and root of a chunk, which are
+  // appended for the check only
+  const size_t accountStoreSize = accountStoreBytes.size();
+  accountStoreBytes.insert(accountStoreBytes.end(), result->next().begin(),
+                           result->next().end());
+  accountStoreBytes.insert(accountStoreBytes.end(),
+                           result->stateroot().begin(),
+                           result->stateroot().end());
+  const bool verified =
+      Schnorr::Verify(accountStoreBytes, signature, lookupPubKey);
+  accountStoreBytes.resize(accountStoreSize);
+
+  if (!verified) {
     LOG_GENERAL(WARNING, "Invalid signature in accounts");
     return false;
   }
@@ -6212,33 +7252,35 @@ bool Messenger::SetLookupSetLookupOffline(bytes& dst, const unsigned int offset,
                                           const PairOfKey& lookupKey) {
   LOG_MARKER();
 
-  LookupSetLookupOffline result;
+  ArenaMessage<LookupSetLookupOffline> result;
 
-  result.mutable_data()->set_msgtype(msgType);
-  result.mutable_data()->set_listenport(listenPort);
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  result->mutable_data()->set_msgtype(msgType);
+  result->mutable_data()->set_listenport(listenPort);
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
 
   Signature signature;
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetLookupOffline.Data initialization failed");
     return false;
   }
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   if (!Schnorr::Sign(tmp, lookupKey.first, lookupKey.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign set lookup offline message");
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetLookupOffline initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupSetLookupOffline(const bytes& src,
@@ -6254,23 +7296,25 @@ bool Messenger::GetLookupSetLookupOffline(const bytes& src,
     return false;
   }
 
-  LookupSetLookupOffline result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupSetLookupOffline> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetLookupOffline initialization failed");
     return false;
   }
 
-  listenPort = result.data().listenport();
-  msgType = result.data().msgtype();
+  listenPort = result->data().listenport();
+  msgType = result->data().msgtype();
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubkey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubkey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, lookupPubkey)) {
     LOG_GENERAL(WARNING, "Invalid signature in GetLookupSetLookupOffline");
@@ -6286,32 +7330,34 @@ bool Messenger::SetLookupSetLookupOnline(bytes& dst, const unsigned int offset,
                                          const PairOfKey& lookupKey) {
   LOG_MARKER();
 
-  LookupSetLookupOnline result;
+  ArenaMessage<LookupSetLookupOnline> result;
 
-  result.mutable_data()->set_msgtype(msgType);
-  result.mutable_data()->set_listenport(listenPort);
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  result->mutable_data()->set_msgtype(msgType);
+  result->mutable_data()->set_listenport(listenPort);
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
 
   Signature signature;
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetLookupOnline.Data initialization failed");
     return false;
   }
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   if (!Schnorr::Sign(tmp, lookupKey.first, lookupKey.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign set lookup online message");
     return false;
   }
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetLookupOnline initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupSetLookupOnline(const bytes& src,
@@ -6326,24 +7372,26 @@ bool Messenger::GetLookupSetLookupOnline(const bytes& src,
     return false;
   }
 
-  LookupSetLookupOnline result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupSetLookupOnline> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetLookupOnline initialization failed");
     return false;
   }
 
-  msgType = result.data().msgtype();
-  listenPort = result.data().listenport();
+  msgType = result->data().msgtype();
+  listenPort = result->data().listenport();
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), pubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), pubKey);
 
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, pubKey)) {
     LOG_GENERAL(WARNING, "Invalid signature in GetLookupSetLookupOnline");
@@ -6357,16 +7405,16 @@ bool Messenger::SetLookupGetOfflineLookups(bytes& dst,
                                            const uint32_t listenPort) {
   LOG_MARKER();
 
-  LookupGetOfflineLookups result;
+  ArenaMessage<LookupGetOfflineLookups> result;
 
-  result.set_listenport(listenPort);
+  result->set_listenport(listenPort);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetOfflineLookups initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupGetOfflineLookups(const bytes& src,
@@ -6380,15 +7428,15 @@ bool Messenger::GetLookupGetOfflineLookups(const bytes& src,
     return false;
   }
 
-  LookupGetOfflineLookups result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetOfflineLookups> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetOfflineLookups initialization failed");
     return false;
   }
 
-  listenPort = result.listenport();
+  listenPort = result->listenport();
 
   return true;
 }
@@ -6399,17 +7447,17 @@ bool Messenger::SetLookupSetOfflineLookups(bytes& dst,
                                            const vector<Peer>& nodes) {
   LOG_MARKER();
 
-  LookupSetOfflineLookups result;
+  ArenaMessage<LookupSetOfflineLookups> result;
 
   for (const auto& node : nodes) {
-    SerializableToProtobufByteArray(node, *result.add_nodes());
+    SerializableToProtobufByteArray(node, *result->add_nodes());
   }
 
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
   Signature signature;
-  if (result.nodes().size() > 0) {
+  if (result->nodes().size() > 0) {
     bytes tmp;
-    if (!RepeatableToArray(result.nodes(), tmp, 0)) {
+    if (!RepeatableToArray(result->nodes(), tmp, 0)) {
       LOG_GENERAL(WARNING, "Failed to serialize offline lookup nodes");
       return false;
     }
@@ -6420,14 +7468,14 @@ bool Messenger::SetLookupSetOfflineLookups(bytes& dst,
     }
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetOfflineLookups initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupSetOfflineLookups(const bytes& src,
@@ -6442,27 +7490,27 @@ bool Messenger::GetLookupSetOfflineLookups(const bytes& src,
     return false;
   }
 
-  LookupSetOfflineLookups result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupSetOfflineLookups> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetOfflineLookups initialization failed");
     return false;
   }
 
-  for (const auto& lookup : result.nodes()) {
+  for (const auto& lookup : result->nodes()) {
     Peer node;
     PROTOBUFBYTEARRAYTOSERIALIZABLE(lookup, node);
     nodes.emplace_back(node);
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
-  if (result.nodes().size() > 0) {
+  if (result->nodes().size() > 0) {
     bytes tmp;
-    if (!RepeatableToArray(result.nodes(), tmp, 0)) {
+    if (!RepeatableToArray(result->nodes(), tmp, 0)) {
       LOG_GENERAL(WARNING, "Failed to serialize offline lookup nodes");
       return false;
     }
@@ -6489,23 +7537,25 @@ bool Messenger::GetLookupSetRaiseStartPoW(const bytes& src,
     return false;
   }
 
-  LookupRaiseStartPoW result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupRaiseStartPoW> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupRaiseStartPoW initialization failed");
     return false;
   }
 
-  msgType = result.data().msgtype();
-  blockNumber = result.data().blocknumber();
+  msgType = result->data().msgtype();
+  blockNumber = result->data().blocknumber();
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), dsPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), dsPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, dsPubKey)) {
     LOG_GENERAL(WARNING, "Invalid signature in raise start PoW message");
@@ -6521,33 +7571,35 @@ bool Messenger::SetLookupSetRaiseStartPoW(bytes& dst, const unsigned int offset,
                                           const PairOfKey& dsKey) {
   LOG_MARKER();
 
-  LookupRaiseStartPoW result;
+  ArenaMessage<LookupRaiseStartPoW> result;
 
-  result.mutable_data()->set_msgtype(msgType);
-  result.mutable_data()->set_blocknumber(blockNumber);
-  SerializableToProtobufByteArray(dsKey.second, *result.mutable_pubkey());
+  result->mutable_data()->set_msgtype(msgType);
+  result->mutable_data()->set_blocknumber(blockNumber);
+  SerializableToProtobufByteArray(dsKey.second, *result->mutable_pubkey());
 
   Signature signature;
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupRaiseStartPoW.Data initialization failed");
     return false;
   }
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   if (!Schnorr::Sign(tmp, dsKey.first, dsKey.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign raise start PoW message");
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupRaiseStartPoW initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::SetLookupGetStartPoWFromSeed(bytes& dst,
@@ -6557,34 +7609,36 @@ bool Messenger::SetLookupGetStartPoWFromSeed(bytes& dst,
                                              const PairOfKey& keys) {
   LOG_MARKER();
 
-  LookupGetStartPoWFromSeed result;
+  ArenaMessage<LookupGetStartPoWFromSeed> result;
 
-  result.mutable_data()->set_listenport(listenPort);
-  result.mutable_data()->set_blocknumber(blockNumber);
+  result->mutable_data()->set_listenport(listenPort);
+  result->mutable_data()->set_blocknumber(blockNumber);
 
   Signature signature;
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "LookupGetStartPoWFromSeed.Data initialization failed");
     return false;
   }
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   if (!Schnorr::Sign(tmp, keys.first, keys.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign GetStartPoWFromSeed message");
     return false;
   }
 
-  SerializableToProtobufByteArray(keys.second, *result.mutable_pubkey());
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(keys.second, *result->mutable_pubkey());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetStartPoWFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupGetStartPoWFromSeed(const bytes& src,
@@ -6599,29 +7653,31 @@ bool Messenger::GetLookupGetStartPoWFromSeed(const bytes& src,
     return false;
   }
 
-  LookupGetStartPoWFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetStartPoWFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized() || !result.data().IsInitialized()) {
+  if (!result->IsInitialized() || !result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetStartPoWFromSeed initialization failed");
     return false;
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   PubKey pubKey;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), pubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), pubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, pubKey)) {
     LOG_GENERAL(WARNING, "Invalid signature in GetStartPoWFromSeed message");
     return false;
   }
 
-  listenPort = result.data().listenport();
-  blockNumber = result.data().blocknumber();
+  listenPort = result->data().listenport();
+  blockNumber = result->data().blocknumber();
 
   return true;
 }
@@ -6632,10 +7688,10 @@ bool Messenger::SetLookupSetStartPoWFromSeed(bytes& dst,
                                              const PairOfKey& lookupKey) {
   LOG_MARKER();
 
-  LookupSetStartPoWFromSeed result;
+  ArenaMessage<LookupSetStartPoWFromSeed> result;
 
-  result.set_blocknumber(blockNumber);
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  result->set_blocknumber(blockNumber);
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
 
   bytes tmp;
   NumberToArray<uint64_t, sizeof(uint64_t)>(blockNumber, tmp, 0);
@@ -6646,14 +7702,14 @@ bool Messenger::SetLookupSetStartPoWFromSeed(bytes& dst,
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetStartPoWFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupSetStartPoWFromSeed(const bytes& src,
@@ -6667,20 +7723,20 @@ bool Messenger::GetLookupSetStartPoWFromSeed(const bytes& src,
     return false;
   }
 
-  LookupSetStartPoWFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupSetStartPoWFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetStartPoWFromSeed initialization failed");
     return false;
   }
 
   bytes tmp;
-  NumberToArray<uint64_t, sizeof(uint64_t)>(result.blocknumber(), tmp, 0);
+  NumberToArray<uint64_t, sizeof(uint64_t)>(result->blocknumber(), tmp, 0);
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, lookupPubKey)) {
     LOG_GENERAL(WARNING, "Invalid signature in start PoW message");
@@ -6694,22 +7750,22 @@ bool Messenger::SetForwardTxnBlockFromSeed(
     bytes& dst, const unsigned int offset,
     const vector<Transaction>& shardTransactions,
     const vector<Transaction>& dsTransactions) {
-  LookupForwardTxnsFromSeed result;
+  ArenaMessage<LookupForwardTxnsFromSeed> result;
 
   if (!shardTransactions.empty()) {
     TransactionArrayToProtobuf(shardTransactions,
-                               *result.mutable_shardtransactions());
+                               *result->mutable_shardtransactions());
   }
   if (!dsTransactions.empty()) {
     TransactionArrayToProtobuf(dsTransactions,
-                               *result.mutable_dstransactions());
+                               *result->mutable_dstransactions());
   }
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupForwardTxnsFromSeed initialization failed");
     return false;
   }
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetForwardTxnBlockFromSeed(
@@ -6722,21 +7778,21 @@ bool Messenger::GetForwardTxnBlockFromSeed(
     return false;
   }
 
-  LookupForwardTxnsFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupForwardTxnsFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupForwardTxnsFromSeed initialization failed");
     return false;
   }
 
-  if (!ProtobufToTransactionArray(result.shardtransactions(),
+  if (!ProtobufToTransactionArray(result->shardtransactions(),
                                   shardTransactions)) {
     LOG_GENERAL(WARNING, "ProtobufToTransactionArray failed");
     return false;
   }
 
-  return ProtobufToTransactionArray(result.dstransactions(), dsTransactions);
+  return ProtobufToTransactionArray(result->dstransactions(), dsTransactions);
 }
 
 // UNUSED
@@ -6745,16 +7801,16 @@ bool Messenger::SetLookupGetShardsFromSeed(bytes& dst,
                                            const uint32_t listenPort) {
   LOG_MARKER();
 
-  LookupGetShardsFromSeed result;
+  ArenaMessage<LookupGetShardsFromSeed> result;
 
-  result.set_listenport(listenPort);
+  result->set_listenport(listenPort);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetShardsFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 // UNUSED
@@ -6769,15 +7825,15 @@ bool Messenger::GetLookupGetShardsFromSeed(const bytes& src,
     return false;
   }
 
-  LookupGetShardsFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetShardsFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetShardsFromSeed initialization failed");
     return false;
   }
 
-  listenPort = result.listenport();
+  listenPort = result->listenport();
 
   return true;
 }
@@ -6788,32 +7844,35 @@ bool Messenger::SetLookupSetShardsFromSeed(
     const uint32_t& shardingStructureVersion, const DequeOfShard& shards) {
   LOG_MARKER();
 
-  LookupSetShardsFromSeed result;
+  ArenaMessage<LookupSetShardsFromSeed> result;
 
-  ShardingStructureToProtobuf(shardingStructureVersion, shards,
-                              *result.mutable_sharding());
-
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
-  Signature signature;
-  bytes tmp;
-  if (!SerializeToArray(result.sharding(), tmp, 0)) {
+  const auto sharding =
+      GetEncodedShardingStructure(shardingStructureVersion, shards);
+  if (!sharding) {
     LOG_GENERAL(WARNING, "Failed to serialize sharding structure");
     return false;
   }
 
-  if (!Schnorr::Sign(tmp, lookupKey.first, lookupKey.second, signature)) {
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
+  Signature signature;
+  if (!Schnorr::Sign(*sharding, lookupKey.first, lookupKey.second,
+                     signature)) {
     LOG_GENERAL(WARNING, "Failed to sign sharding structure");
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetShardsFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  // The sharding structure is the first field, so the shared encoding goes
+  // in front of the other fields
+  const unsigned int next = EmbeddedToArray(
+      LookupSetShardsFromSeed::kShardingFieldNumber, *sharding, dst, offset);
+  return SerializeToArray(*result, dst, next);
 }
 
 bool Messenger::GetLookupSetShardsFromSeed(const bytes& src,
@@ -6829,26 +7888,26 @@ bool Messenger::GetLookupSetShardsFromSeed(const bytes& src,
     return false;
   }
 
-  LookupSetShardsFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupSetShardsFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetShardsFromSeed initialization failed");
     return false;
   }
 
-  if (!ProtobufToShardingStructure(result.sharding(), shardingStructureVersion,
+  if (!ProtobufToShardingStructure(result->sharding(), shardingStructureVersion,
                                    shards)) {
     LOG_GENERAL(WARNING, "ProtobufToShardingStructure failed");
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   bytes tmp;
-  if (!SerializeToArray(result.sharding(), tmp, 0)) {
+  if (!SerializeToArray(result->sharding(), tmp, 0)) {
     LOG_GENERAL(WARNING, "Failed to serialize sharding structure");
     return false;
   }
@@ -6866,19 +7925,19 @@ bool Messenger::SetLookupGetMicroBlockFromLookup(
     const vector<BlockHash>& microBlockHashes, uint32_t portNo) {
   LOG_MARKER();
 
-  LookupGetMicroBlockFromLookup result;
+  ArenaMessage<LookupGetMicroBlockFromLookup> result;
 
-  result.set_portno(portNo);
+  result->set_portno(portNo);
 
   for (const auto& hash : microBlockHashes) {
-    result.add_mbhashes(hash.data(), hash.size);
+    result->add_mbhashes(hash.data(), hash.size);
   }
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetMicroBlockFromLookup initialization failed");
     return false;
   }
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 // UNUSED
@@ -6893,17 +7952,17 @@ bool Messenger::GetLookupGetMicroBlockFromLookup(
     return false;
   }
 
-  LookupGetMicroBlockFromLookup result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetMicroBlockFromLookup> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetMicroBlockFromLookup initialization failed");
     return false;
   }
 
-  portNo = result.portno();
+  portNo = result->portno();
 
-  for (const auto& hash : result.mbhashes()) {
+  for (const auto& hash : result->mbhashes()) {
     microBlockHashes.emplace_back();
     unsigned int size = min((unsigned int)hash.size(),
                             (unsigned int)microBlockHashes.back().size);
@@ -6918,17 +7977,17 @@ bool Messenger::SetLookupSetMicroBlockFromLookup(
     bytes& dst, const unsigned int offset, const PairOfKey& lookupKey,
     const vector<MicroBlock>& mbs) {
   LOG_MARKER();
-  LookupSetMicroBlockFromLookup result;
+  ArenaMessage<LookupSetMicroBlockFromLookup> result;
 
   for (const auto& mb : mbs) {
-    MicroBlockToProtobuf(mb, *result.add_microblocks());
+    MicroBlockToProtobuf(mb, *result->add_microblocks());
   }
 
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
   Signature signature;
-  if (result.microblocks().size() > 0) {
+  if (result->microblocks().size() > 0) {
     bytes tmp;
-    if (!RepeatableToArray(result.microblocks(), tmp, 0)) {
+    if (!RepeatableToArray(result->microblocks(), tmp, 0)) {
       LOG_GENERAL(WARNING, "Failed to serialize micro blocks");
       return false;
     }
@@ -6939,14 +7998,14 @@ bool Messenger::SetLookupSetMicroBlockFromLookup(
     }
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetMicroBlockFromLookup initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupSetMicroBlockFromLookup(const bytes& src,
@@ -6961,21 +8020,21 @@ bool Messenger::GetLookupSetMicroBlockFromLookup(const bytes& src,
     return false;
   }
 
-  LookupSetMicroBlockFromLookup result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupSetMicroBlockFromLookup> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetMicroBlockFromLookup initialization failed");
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
-  if (result.microblocks().size() > 0) {
+  if (result->microblocks().size() > 0) {
     bytes tmp;
-    if (!RepeatableToArray(result.microblocks(), tmp, 0)) {
+    if (!RepeatableToArray(result->microblocks(), tmp, 0)) {
       LOG_GENERAL(WARNING, "Failed to serialize micro blocks");
       return false;
     }
@@ -6986,7 +8045,7 @@ bool Messenger::GetLookupSetMicroBlockFromLookup(const bytes& src,
     }
   }
 
-  for (const auto& res_mb : result.microblocks()) {
+  for (const auto& res_mb : result->microblocks()) {
     MicroBlock mb;
 
     ProtobufToMicroBlock(res_mb, mb);
@@ -7005,21 +8064,21 @@ bool Messenger::SetLookupGetTxnsFromLookup(bytes& dst,
                                            uint32_t portNo) {
   LOG_MARKER();
 
-  LookupGetTxnsFromLookup result;
+  ArenaMessage<LookupGetTxnsFromLookup> result;
 
-  result.set_portno(portNo);
-  result.set_mbhash(mbHash.data(), mbHash.size);
+  result->set_portno(portNo);
+  result->set_mbhash(mbHash.data(), mbHash.size);
 
   for (const auto& txhash : txnhashes) {
-    result.add_txnhashes(txhash.data(), txhash.size);
+    result->add_txnhashes(txhash.data(), txhash.size);
   }
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetTxnsFromLookup initialization failure");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 // UNUSED
@@ -7036,20 +8095,20 @@ bool Messenger::GetLookupGetTxnsFromLookup(const bytes& src,
     return false;
   }
 
-  LookupGetTxnsFromLookup result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetTxnsFromLookup> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetTxnsFromLookup initialization failure");
     return false;
   }
 
-  portNo = result.portno();
-  auto hash = result.mbhash();
+  portNo = result->portno();
+  auto hash = result->mbhash();
   unsigned int size = min((unsigned int)hash.size(), (unsigned int)mbHash.size);
   copy(hash.begin(), hash.begin() + size, mbHash.asArray().begin());
 
-  for (const auto& hash : result.txnhashes()) {
+  for (const auto& hash : result->txnhashes()) {
     txnhashes.emplace_back();
     size = min((unsigned int)hash.size(), (unsigned int)txnhashes.back().size);
     copy(hash.begin(), hash.begin() + size, txnhashes.back().asArray().begin());
@@ -7063,19 +8122,19 @@ bool Messenger::SetLookupSetTxnsFromLookup(
     const BlockHash& mbHash, const vector<TransactionWithReceipt>& txns) {
   LOG_MARKER();
 
-  LookupSetTxnsFromLookup result;
+  ArenaMessage<LookupSetTxnsFromLookup> result;
 
-  result.set_mbhash(mbHash.data(), mbHash.size);
+  result->set_mbhash(mbHash.data(), mbHash.size);
 
   for (auto const& txn : txns) {
-    SerializableToProtobufByteArray(txn, *result.add_transactions());
+    SerializableToProtobufByteArray(txn, *result->add_transactions());
   }
 
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
   Signature signature;
-  if (result.transactions().size() > 0) {
+  if (result->transactions().size() > 0) {
     bytes tmp;
-    if (!RepeatableToArray(result.transactions(), tmp, 0)) {
+    if (!RepeatableToArray(result->transactions(), tmp, 0)) {
       LOG_GENERAL(WARNING, "Failed to serialize transactions");
       return false;
     }
@@ -7086,14 +8145,14 @@ bool Messenger::SetLookupSetTxnsFromLookup(
     }
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetTxnsFromLookup initialization failure");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 // UNUSED
@@ -7108,25 +8167,25 @@ bool Messenger::GetLookupSetTxnsFromLookup(
     return false;
   }
 
-  LookupSetTxnsFromLookup result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupSetTxnsFromLookup> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetTxnsFromLookup initialization failed");
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
-  auto hash = result.mbhash();
+  auto hash = result->mbhash();
   unsigned int size = min((unsigned int)hash.size(), (unsigned int)mbHash.size);
   copy(hash.begin(), hash.begin() + size, mbHash.asArray().begin());
 
-  if (result.transactions().size() > 0) {
+  if (result->transactions().size() > 0) {
     bytes tmp;
-    if (!RepeatableToArray(result.transactions(), tmp, 0)) {
+    if (!RepeatableToArray(result->transactions(), tmp, 0)) {
       LOG_GENERAL(WARNING, "Failed to serialize transactions");
       return false;
     }
@@ -7137,7 +8196,7 @@ bool Messenger::GetLookupSetTxnsFromLookup(
     }
   }
 
-  for (auto const& protoTxn : result.transactions()) {
+  for (auto const& protoTxn : result->transactions()) {
     TransactionWithReceipt txn;
     PROTOBUFBYTEARRAYTOSERIALIZABLE(protoTxn, txn);
     txns.emplace_back(txn);
@@ -7150,18 +8209,18 @@ bool Messenger::SetLookupGetDirectoryBlocksFromSeed(bytes& dst,
                                                     const unsigned int offset,
                                                     const uint32_t portNo,
                                                     const uint64_t& indexNum) {
-  LookupGetDirectoryBlocksFromSeed result;
+  ArenaMessage<LookupGetDirectoryBlocksFromSeed> result;
 
-  result.set_portno(portNo);
-  result.set_indexnum(indexNum);
+  result->set_portno(portNo);
+  result->set_indexnum(indexNum);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "LookupGetDirectoryBlocksFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupGetDirectoryBlocksFromSeed(const bytes& src,
@@ -7174,18 +8233,18 @@ bool Messenger::GetLookupGetDirectoryBlocksFromSeed(const bytes& src,
     return false;
   }
 
-  LookupGetDirectoryBlocksFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetDirectoryBlocksFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "LookupGetDirectoryBlocksFromSeed initialization failed");
     return false;
   }
 
-  portNo = result.portno();
+  portNo = result->portno();
 
-  indexNum = result.indexnum();
+  indexNum = result->indexnum();
 
   return true;
 }
@@ -7197,14 +8256,14 @@ bool Messenger::SetLookupSetDirectoryBlocksFromSeed(
         boost::variant<DSBlock, VCBlock, FallbackBlockWShardingStructure>>&
         directoryBlocks,
     const uint64_t& indexNum, const PairOfKey& lookupKey) {
-  LookupSetDirectoryBlocksFromSeed result;
+  ArenaMessage<LookupSetDirectoryBlocksFromSeed> result;
 
-  result.mutable_data()->set_indexnum(indexNum);
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  result->mutable_data()->set_indexnum(indexNum);
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
 
   for (const auto& dirblock : directoryBlocks) {
     ProtoSingleDirectoryBlock* proto_dir_blocks =
-        result.mutable_data()->add_dirblocks();
+        result->mutable_data()->add_dirblocks();
     if (dirblock.type() == typeid(DSBlock)) {
       DSBlockToProtobuf(get<DSBlock>(dirblock),
                         *proto_dir_blocks->mutable_dsblock());
@@ -7224,28 +8283,30 @@ bool Messenger::SetLookupSetDirectoryBlocksFromSeed(
   }
 
   Signature signature;
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "LookupSetDirectoryBlocksFromSeed.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   if (!Schnorr::Sign(tmp, lookupKey.first, lookupKey.second, signature)) {
     LOG_GENERAL(WARNING,
                 "Failed to sign set LookupSetDirectoryBlocksFromSeed message");
     return false;
   }
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "LookupSetDirectoryBlocksFromSeed initialization failed");
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupSetDirectoryBlocksFromSeed(
@@ -7254,7 +8315,7 @@ bool Messenger::GetLookupSetDirectoryBlocksFromSeed(
     vector<boost::variant<DSBlock, VCBlock, FallbackBlockWShardingStructure>>&
         directoryBlocks,
     uint64_t& indexNum, PubKey& pubKey) {
-  LookupSetDirectoryBlocksFromSeed result;
+  ArenaMessage<LookupSetDirectoryBlocksFromSeed> result;
 
   google::protobuf::io::ArrayInputStream arrayIn(src.data() + offset,
                                                  src.size() - offset);
@@ -7262,20 +8323,22 @@ bool Messenger::GetLookupSetDirectoryBlocksFromSeed(
   codedIn.SetTotalBytesLimit(MAX_READ_WATERMARK_IN_BYTES,
                              MAX_READ_WATERMARK_IN_BYTES);
 
-  if (!result.ParseFromCodedStream(&codedIn) ||
-      !codedIn.ConsumedEntireMessage() || !result.IsInitialized()) {
+  if (!result->ParseFromCodedStream(&codedIn) ||
+      !codedIn.ConsumedEntireMessage() || !result->IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "LookupSetDirectoryBlocksFromSeed initialization failed");
     return false;
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), pubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), pubKey);
 
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, pubKey)) {
     LOG_GENERAL(WARNING,
@@ -7283,9 +8346,9 @@ bool Messenger::GetLookupSetDirectoryBlocksFromSeed(
     return false;
   }
 
-  indexNum = result.data().indexnum();
+  indexNum = result->data().indexnum();
 
-  for (const auto& dirblock : result.data().dirblocks()) {
+  for (const auto& dirblock : result->data().dirblocks()) {
     DSBlock dsblock;
     VCBlock vcblock;
     FallbackBlockWShardingStructure fallbackblockwshard;
@@ -7354,28 +8417,30 @@ bool Messenger::SetConsensusCommit(
     const PairOfKey& backupKey) {
   LOG_MARKER();
 
-  ConsensusCommit result;
+  ArenaMessage<ConsensusCommit> result;
 
-  result.mutable_consensusinfo()->set_consensusid(consensusID);
-  result.mutable_consensusinfo()->set_blocknumber(blockNumber);
-  result.mutable_consensusinfo()->set_blockhash(blockHash.data(),
+  result->mutable_consensusinfo()->set_consensusid(consensusID);
+  result->mutable_consensusinfo()->set_blocknumber(blockNumber);
+  result->mutable_consensusinfo()->set_blockhash(blockHash.data(),
                                                 blockHash.size());
-  result.mutable_consensusinfo()->set_backupid(backupID);
+  result->mutable_consensusinfo()->set_backupid(backupID);
 
   SerializableToProtobufByteArray(
-      commitPoint, *result.mutable_consensusinfo()->mutable_commitpoint());
+      commitPoint, *result->mutable_consensusinfo()->mutable_commitpoint());
 
   SerializableToProtobufByteArray(
       commitPointHash,
-      *result.mutable_consensusinfo()->mutable_commitpointhash());
+      *result->mutable_consensusinfo()->mutable_commitpointhash());
 
-  if (!result.consensusinfo().IsInitialized()) {
+  if (!result->consensusinfo().IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusCommit.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.consensusinfo().ByteSize());
-  result.consensusinfo().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->consensusinfo(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
 
@@ -7384,15 +8449,15 @@ bool Messenger::SetConsensusCommit(
     return false;
   }
 
-  SerializableToProtobufByteArray(backupKey.second, *result.mutable_pubkey());
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(backupKey.second, *result->mutable_pubkey());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusCommit initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetConsensusCommit(const bytes& src, const unsigned int offset,
@@ -7410,29 +8475,29 @@ bool Messenger::GetConsensusCommit(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ConsensusCommit result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ConsensusCommit> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusCommit initialization failed");
     return false;
   }
 
-  if (result.consensusinfo().consensusid() != consensusID) {
+  if (result->consensusinfo().consensusid() != consensusID) {
     LOG_GENERAL(WARNING, "Consensus ID mismatch. Expected: "
                              << consensusID << " Actual: "
-                             << result.consensusinfo().consensusid());
+                             << result->consensusinfo().consensusid());
     return false;
   }
 
-  if (result.consensusinfo().blocknumber() != blockNumber) {
+  if (result->consensusinfo().blocknumber() != blockNumber) {
     LOG_GENERAL(WARNING, "Block number mismatch. Expected: "
                              << blockNumber << " Actual: "
-                             << result.consensusinfo().blocknumber());
+                             << result->consensusinfo().blocknumber());
     return false;
   }
 
-  const auto& tmpBlockHash = result.consensusinfo().blockhash();
+  const auto& tmpBlockHash = result->consensusinfo().blockhash();
   if (!std::equal(blockHash.begin(), blockHash.end(), tmpBlockHash.begin(),
                   tmpBlockHash.end(),
                   [](const unsigned char left, const char right) -> bool {
@@ -7458,7 +8523,7 @@ bool Messenger::GetConsensusCommit(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  backupID = result.consensusinfo().backupid();
+  backupID = result->consensusinfo().backupid();
 
   if (backupID >= committeeKeys.size()) {
     LOG_GENERAL(WARNING, "Backup ID beyond shard size. Backup ID: "
@@ -7467,17 +8532,19 @@ bool Messenger::GetConsensusCommit(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.consensusinfo().commitpoint(),
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->consensusinfo().commitpoint(),
                                   commitPoint);
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.consensusinfo().commitpointhash(),
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->consensusinfo().commitpointhash(),
                                   commitPointHash);
 
-  bytes tmp(result.consensusinfo().ByteSize());
-  result.consensusinfo().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->consensusinfo(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, committeeKeys.at(backupID).first)) {
     LOG_GENERAL(WARNING, "Invalid signature in commit");
@@ -7493,17 +8560,17 @@ bool Messenger::SetConsensusChallenge(
     const vector<ChallengeSubsetInfo>& subsetInfo, const PairOfKey& leaderKey) {
   LOG_MARKER();
 
-  ConsensusChallenge result;
+  ArenaMessage<ConsensusChallenge> result;
 
-  result.mutable_consensusinfo()->set_consensusid(consensusID);
-  result.mutable_consensusinfo()->set_blocknumber(blockNumber);
-  result.mutable_consensusinfo()->set_blockhash(blockHash.data(),
+  result->mutable_consensusinfo()->set_consensusid(consensusID);
+  result->mutable_consensusinfo()->set_blocknumber(blockNumber);
+  result->mutable_consensusinfo()->set_blockhash(blockHash.data(),
                                                 blockHash.size());
-  result.mutable_consensusinfo()->set_leaderid(leaderID);
+  result->mutable_consensusinfo()->set_leaderid(leaderID);
 
   for (const auto& subset : subsetInfo) {
     ConsensusChallenge::SubsetInfo* si =
-        result.mutable_consensusinfo()->add_subsetinfo();
+        result->mutable_consensusinfo()->add_subsetinfo();
 
     SerializableToProtobufByteArray(subset.aggregatedCommit,
                                     *si->mutable_aggregatedcommit());
@@ -7512,13 +8579,15 @@ bool Messenger::SetConsensusChallenge(
     SerializableToProtobufByteArray(subset.challenge, *si->mutable_challenge());
   }
 
-  if (!result.consensusinfo().IsInitialized()) {
+  if (!result->consensusinfo().IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusChallenge.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.consensusinfo().ByteSize());
-  result.consensusinfo().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->consensusinfo(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
 
@@ -7527,15 +8596,15 @@ bool Messenger::SetConsensusChallenge(
     return false;
   }
 
-  SerializableToProtobufByteArray(leaderKey.second, *result.mutable_pubkey());
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(leaderKey.second, *result->mutable_pubkey());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusChallenge initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetConsensusChallenge(
@@ -7550,29 +8619,29 @@ bool Messenger::GetConsensusChallenge(
     return false;
   }
 
-  ConsensusChallenge result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ConsensusChallenge> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusChallenge initialization failed");
     return false;
   }
 
-  if (result.consensusinfo().consensusid() != consensusID) {
+  if (result->consensusinfo().consensusid() != consensusID) {
     LOG_GENERAL(WARNING, "Consensus ID mismatch. Expected: "
                              << consensusID << " Actual: "
-                             << result.consensusinfo().consensusid());
+                             << result->consensusinfo().consensusid());
     return false;
   }
 
-  if (result.consensusinfo().blocknumber() != blockNumber) {
+  if (result->consensusinfo().blocknumber() != blockNumber) {
     LOG_GENERAL(WARNING, "Block number mismatch. Expected: "
                              << blockNumber << " Actual: "
-                             << result.consensusinfo().blocknumber());
+                             << result->consensusinfo().blocknumber());
     return false;
   }
 
-  const auto& tmpBlockHash = result.consensusinfo().blockhash();
+  const auto& tmpBlockHash = result->consensusinfo().blockhash();
   if (!std::equal(blockHash.begin(), blockHash.end(), tmpBlockHash.begin(),
                   tmpBlockHash.end(),
                   [](const unsigned char left, const char right) -> bool {
@@ -7597,14 +8666,14 @@ bool Messenger::GetConsensusChallenge(
     return false;
   }
 
-  if (result.consensusinfo().leaderid() != leaderID) {
+  if (result->consensusinfo().leaderid() != leaderID) {
     LOG_GENERAL(WARNING, "Leader ID mismatch. Expected: "
                              << leaderID << " Actual: "
-                             << result.consensusinfo().leaderid());
+                             << result->consensusinfo().leaderid());
     return false;
   }
 
-  for (const auto& proto_si : result.consensusinfo().subsetinfo()) {
+  for (const auto& proto_si : result->consensusinfo().subsetinfo()) {
     ChallengeSubsetInfo si;
 
     PROTOBUFBYTEARRAYTOSERIALIZABLE(proto_si.aggregatedcommit(),
@@ -7615,12 +8684,14 @@ bool Messenger::GetConsensusChallenge(
     subsetInfo.emplace_back(si);
   }
 
-  bytes tmp(result.consensusinfo().ByteSize());
-  result.consensusinfo().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->consensusinfo(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, leaderKey)) {
     LOG_GENERAL(WARNING, "Invalid signature in challenge");
@@ -7636,27 +8707,29 @@ bool Messenger::SetConsensusResponse(
     const vector<ResponseSubsetInfo>& subsetInfo, const PairOfKey& backupKey) {
   LOG_MARKER();
 
-  ConsensusResponse result;
+  ArenaMessage<ConsensusResponse> result;
 
-  result.mutable_consensusinfo()->set_consensusid(consensusID);
-  result.mutable_consensusinfo()->set_blocknumber(blockNumber);
-  result.mutable_consensusinfo()->set_blockhash(blockHash.data(),
+  result->mutable_consensusinfo()->set_consensusid(consensusID);
+  result->mutable_consensusinfo()->set_blocknumber(blockNumber);
+  result->mutable_consensusinfo()->set_blockhash(blockHash.data(),
                                                 blockHash.size());
-  result.mutable_consensusinfo()->set_backupid(backupID);
+  result->mutable_consensusinfo()->set_backupid(backupID);
 
   for (const auto& subset : subsetInfo) {
     ConsensusResponse::SubsetInfo* si =
-        result.mutable_consensusinfo()->add_subsetinfo();
+        result->mutable_consensusinfo()->add_subsetinfo();
     SerializableToProtobufByteArray(subset.response, *si->mutable_response());
   }
 
-  if (!result.consensusinfo().IsInitialized()) {
+  if (!result->consensusinfo().IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusResponse.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.consensusinfo().ByteSize());
-  result.consensusinfo().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->consensusinfo(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
 
@@ -7665,15 +8738,15 @@ bool Messenger::SetConsensusResponse(
     return false;
   }
 
-  SerializableToProtobufByteArray(backupKey.second, *result.mutable_pubkey());
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(backupKey.second, *result->mutable_pubkey());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusResponse initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetConsensusResponse(
@@ -7688,29 +8761,29 @@ bool Messenger::GetConsensusResponse(
     return false;
   }
 
-  ConsensusResponse result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ConsensusResponse> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusResponse initialization failed");
     return false;
   }
 
-  if (result.consensusinfo().consensusid() != consensusID) {
+  if (result->consensusinfo().consensusid() != consensusID) {
     LOG_GENERAL(WARNING, "Consensus ID mismatch. Expected: "
                              << consensusID << " Actual: "
-                             << result.consensusinfo().consensusid());
+                             << result->consensusinfo().consensusid());
     return false;
   }
 
-  if (result.consensusinfo().blocknumber() != blockNumber) {
+  if (result->consensusinfo().blocknumber() != blockNumber) {
     LOG_GENERAL(WARNING, "Block number mismatch. Expected: "
                              << blockNumber << " Actual: "
-                             << result.consensusinfo().blocknumber());
+                             << result->consensusinfo().blocknumber());
     return false;
   }
 
-  const auto& tmpBlockHash = result.consensusinfo().blockhash();
+  const auto& tmpBlockHash = result->consensusinfo().blockhash();
   if (!std::equal(blockHash.begin(), blockHash.end(), tmpBlockHash.begin(),
                   tmpBlockHash.end(),
                   [](const unsigned char left, const char right) -> bool {
@@ -7736,7 +8809,7 @@ bool Messenger::GetConsensusResponse(
     return false;
   }
 
-  backupID = result.consensusinfo().backupid();
+  backupID = result->consensusinfo().backupid();
 
   if (backupID >= committeeKeys.size()) {
     LOG_GENERAL(WARNING, "Backup ID beyond shard size. Backup ID: "
@@ -7745,7 +8818,7 @@ bool Messenger::GetConsensusResponse(
     return false;
   }
 
-  for (const auto& proto_si : result.consensusinfo().subsetinfo()) {
+  for (const auto& proto_si : result->consensusinfo().subsetinfo()) {
     ResponseSubsetInfo si;
 
     PROTOBUFBYTEARRAYTOSERIALIZABLE(proto_si.response(), si.response);
@@ -7753,12 +8826,14 @@ bool Messenger::GetConsensusResponse(
     subsetInfo.emplace_back(si);
   }
 
-  bytes tmp(result.consensusinfo().ByteSize());
-  result.consensusinfo().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->consensusinfo(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, committeeKeys.at(backupID).first)) {
     LOG_GENERAL(WARNING, "Invalid signature in response");
@@ -7771,30 +8846,32 @@ bool Messenger::GetConsensusResponse(
 bool Messenger::SetConsensusCollectiveSig(
     bytes& dst, const unsigned int offset, const uint32_t consensusID,
     const uint64_t blockNumber, const bytes& blockHash, const uint16_t leaderID,
-    const Signature& collectiveSig, const vector<bool>& bitmap,
+    const Signature& collectiveSig, const Bitmap& bitmap,
     const PairOfKey& leaderKey) {
   LOG_MARKER();
 
-  ConsensusCollectiveSig result;
+  ArenaMessage<ConsensusCollectiveSig> result;
 
-  result.mutable_consensusinfo()->set_consensusid(consensusID);
-  result.mutable_consensusinfo()->set_blocknumber(blockNumber);
-  result.mutable_consensusinfo()->set_blockhash(blockHash.data(),
+  result->mutable_consensusinfo()->set_consensusid(consensusID);
+  result->mutable_consensusinfo()->set_blocknumber(blockNumber);
+  result->mutable_consensusinfo()->set_blockhash(blockHash.data(),
                                                 blockHash.size());
-  result.mutable_consensusinfo()->set_leaderid(leaderID);
+  result->mutable_consensusinfo()->set_leaderid(leaderID);
   SerializableToProtobufByteArray(
-      collectiveSig, *result.mutable_consensusinfo()->mutable_collectivesig());
+      collectiveSig, *result->mutable_consensusinfo()->mutable_collectivesig());
   for (const auto& i : bitmap) {
-    result.mutable_consensusinfo()->add_bitmap(i);
+    result->mutable_consensusinfo()->add_bitmap(i);
   }
 
-  if (!result.consensusinfo().IsInitialized()) {
+  if (!result->consensusinfo().IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusCollectiveSig.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.consensusinfo().ByteSize());
-  result.consensusinfo().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->consensusinfo(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
 
@@ -7803,21 +8880,21 @@ bool Messenger::SetConsensusCollectiveSig(
     return false;
   }
 
-  SerializableToProtobufByteArray(leaderKey.second, *result.mutable_pubkey());
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(leaderKey.second, *result->mutable_pubkey());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusCollectiveSig initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetConsensusCollectiveSig(
     const bytes& src, const unsigned int offset, const uint32_t consensusID,
     const uint64_t blockNumber, const bytes& blockHash, const uint16_t leaderID,
-    vector<bool>& bitmap, Signature& collectiveSig, const PubKey& leaderKey) {
+    Bitmap& bitmap, Signature& collectiveSig, const PubKey& leaderKey) {
   LOG_MARKER();
 
   if (offset >= src.size()) {
@@ -7826,29 +8903,29 @@ bool Messenger::GetConsensusCollectiveSig(
     return false;
   }
 
-  ConsensusCollectiveSig result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ConsensusCollectiveSig> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusCollectiveSig initialization failed");
     return false;
   }
 
-  if (result.consensusinfo().consensusid() != consensusID) {
+  if (result->consensusinfo().consensusid() != consensusID) {
     LOG_GENERAL(WARNING, "Consensus ID mismatch. Expected: "
                              << consensusID << " Actual: "
-                             << result.consensusinfo().consensusid());
+                             << result->consensusinfo().consensusid());
     return false;
   }
 
-  if (result.consensusinfo().blocknumber() != blockNumber) {
+  if (result->consensusinfo().blocknumber() != blockNumber) {
     LOG_GENERAL(WARNING, "Block number mismatch. Expected: "
                              << blockNumber << " Actual: "
-                             << result.consensusinfo().blocknumber());
+                             << result->consensusinfo().blocknumber());
     return false;
   }
 
-  const auto& tmpBlockHash = result.consensusinfo().blockhash();
+  const auto& tmpBlockHash = result->consensusinfo().blockhash();
   if (!std::equal(blockHash.begin(), blockHash.end(), tmpBlockHash.begin(),
                   tmpBlockHash.end(),
                   [](const unsigned char left, const char right) -> bool {
@@ -7874,26 +8951,28 @@ bool Messenger::GetConsensusCollectiveSig(
     return false;
   }
 
-  if (result.consensusinfo().leaderid() != leaderID) {
+  if (result->consensusinfo().leaderid() != leaderID) {
     LOG_GENERAL(WARNING, "Leader ID mismatch. Expected: "
                              << leaderID << " Actual: "
-                             << result.consensusinfo().leaderid());
+                             << result->consensusinfo().leaderid());
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.consensusinfo().collectivesig(),
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->consensusinfo().collectivesig(),
                                   collectiveSig);
 
-  for (const auto& i : result.consensusinfo().bitmap()) {
+  for (const auto& i : result->consensusinfo().bitmap()) {
     bitmap.emplace_back(i);
   }
 
-  bytes tmp(result.consensusinfo().ByteSize());
-  result.consensusinfo().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->consensusinfo(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, leaderKey)) {
     LOG_GENERAL(WARNING, "Invalid signature in collectivesig");
@@ -7909,23 +8988,25 @@ bool Messenger::SetConsensusCommitFailure(
     const bytes& errorMsg, const PairOfKey& backupKey) {
   LOG_MARKER();
 
-  ConsensusCommitFailure result;
+  ArenaMessage<ConsensusCommitFailure> result;
 
-  result.mutable_consensusinfo()->set_consensusid(consensusID);
-  result.mutable_consensusinfo()->set_blocknumber(blockNumber);
-  result.mutable_consensusinfo()->set_blockhash(blockHash.data(),
+  result->mutable_consensusinfo()->set_consensusid(consensusID);
+  result->mutable_consensusinfo()->set_blocknumber(blockNumber);
+  result->mutable_consensusinfo()->set_blockhash(blockHash.data(),
                                                 blockHash.size());
-  result.mutable_consensusinfo()->set_backupid(backupID);
-  result.mutable_consensusinfo()->set_errormsg(errorMsg.data(),
+  result->mutable_consensusinfo()->set_backupid(backupID);
+  result->mutable_consensusinfo()->set_errormsg(errorMsg.data(),
                                                errorMsg.size());
 
-  if (!result.consensusinfo().IsInitialized()) {
+  if (!result->consensusinfo().IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusCommitFailure.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.consensusinfo().ByteSize());
-  result.consensusinfo().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->consensusinfo(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
 
@@ -7934,15 +9015,15 @@ bool Messenger::SetConsensusCommitFailure(
     return false;
   }
 
-  SerializableToProtobufByteArray(backupKey.second, *result.mutable_pubkey());
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(backupKey.second, *result->mutable_pubkey());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusCommitFailure initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetConsensusCommitFailure(
@@ -7957,29 +9038,29 @@ bool Messenger::GetConsensusCommitFailure(
     return false;
   }
 
-  ConsensusCommitFailure result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ConsensusCommitFailure> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusCommitFailure initialization failed");
     return false;
   }
 
-  if (result.consensusinfo().consensusid() != consensusID) {
+  if (result->consensusinfo().consensusid() != consensusID) {
     LOG_GENERAL(WARNING, "Consensus ID mismatch. Expected: "
                              << consensusID << " Actual: "
-                             << result.consensusinfo().consensusid());
+                             << result->consensusinfo().consensusid());
     return false;
   }
 
-  if (result.consensusinfo().blocknumber() != blockNumber) {
+  if (result->consensusinfo().blocknumber() != blockNumber) {
     LOG_GENERAL(WARNING, "Block number mismatch. Expected: "
                              << blockNumber << " Actual: "
-                             << result.consensusinfo().blocknumber());
+                             << result->consensusinfo().blocknumber());
     return false;
   }
 
-  const auto& tmpBlockHash = result.consensusinfo().blockhash();
+  const auto& tmpBlockHash = result->consensusinfo().blockhash();
   if (!std::equal(blockHash.begin(), blockHash.end(), tmpBlockHash.begin(),
                   tmpBlockHash.end(),
                   [](const unsigned char left, const char right) -> bool {
@@ -8005,7 +9086,7 @@ bool Messenger::GetConsensusCommitFailure(
     return false;
   }
 
-  backupID = result.consensusinfo().backupid();
+  backupID = result->consensusinfo().backupid();
 
   if (backupID >= committeeKeys.size()) {
     LOG_GENERAL(WARNING, "Backup ID beyond shard size. Backup ID: "
@@ -8014,16 +9095,18 @@ bool Messenger::GetConsensusCommitFailure(
     return false;
   }
 
-  errorMsg.resize(result.consensusinfo().errormsg().size());
-  copy(result.consensusinfo().errormsg().begin(),
-       result.consensusinfo().errormsg().end(), errorMsg.begin());
+  errorMsg.resize(result->consensusinfo().errormsg().size());
+  copy(result->consensusinfo().errormsg().begin(),
+       result->consensusinfo().errormsg().end(), errorMsg.begin());
 
-  bytes tmp(result.consensusinfo().ByteSize());
-  result.consensusinfo().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->consensusinfo(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, committeeKeys.at(backupID).first)) {
     LOG_GENERAL(WARNING, "Invalid signature in commit failure");
@@ -8039,22 +9122,24 @@ bool Messenger::SetConsensusConsensusFailure(
     const PairOfKey& leaderKey) {
   LOG_MARKER();
 
-  ConsensusConsensusFailure result;
+  ArenaMessage<ConsensusConsensusFailure> result;
 
-  result.mutable_consensusinfo()->set_consensusid(consensusID);
-  result.mutable_consensusinfo()->set_blocknumber(blockNumber);
-  result.mutable_consensusinfo()->set_blockhash(blockHash.data(),
+  result->mutable_consensusinfo()->set_consensusid(consensusID);
+  result->mutable_consensusinfo()->set_blocknumber(blockNumber);
+  result->mutable_consensusinfo()->set_blockhash(blockHash.data(),
                                                 blockHash.size());
-  result.mutable_consensusinfo()->set_leaderid(leaderID);
+  result->mutable_consensusinfo()->set_leaderid(leaderID);
 
-  if (!result.consensusinfo().IsInitialized()) {
+  if (!result->consensusinfo().IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "ConsensusConsensusFailure.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.consensusinfo().ByteSize());
-  result.consensusinfo().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->consensusinfo(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
 
@@ -8063,15 +9148,15 @@ bool Messenger::SetConsensusConsensusFailure(
     return false;
   }
 
-  SerializableToProtobufByteArray(leaderKey.second, *result.mutable_pubkey());
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(leaderKey.second, *result->mutable_pubkey());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusConsensusFailure initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetConsensusConsensusFailure(
@@ -8086,29 +9171,29 @@ bool Messenger::GetConsensusConsensusFailure(
     return false;
   }
 
-  ConsensusConsensusFailure result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<ConsensusConsensusFailure> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "ConsensusConsensusFailure initialization failed");
     return false;
   }
 
-  if (result.consensusinfo().consensusid() != consensusID) {
+  if (result->consensusinfo().consensusid() != consensusID) {
     LOG_GENERAL(WARNING, "Consensus ID mismatch. Expected: "
                              << consensusID << " Actual: "
-                             << result.consensusinfo().consensusid());
+                             << result->consensusinfo().consensusid());
     return false;
   }
 
-  if (result.consensusinfo().blocknumber() != blockNumber) {
+  if (result->consensusinfo().blocknumber() != blockNumber) {
     LOG_GENERAL(WARNING, "Block number mismatch. Expected: "
                              << blockNumber << " Actual: "
-                             << result.consensusinfo().blocknumber());
+                             << result->consensusinfo().blocknumber());
     return false;
   }
 
-  const auto& tmpBlockHash = result.consensusinfo().blockhash();
+  const auto& tmpBlockHash = result->consensusinfo().blockhash();
   if (!std::equal(blockHash.begin(), blockHash.end(), tmpBlockHash.begin(),
                   tmpBlockHash.end(),
                   [](const unsigned char left, const char right) -> bool {
@@ -8134,19 +9219,21 @@ bool Messenger::GetConsensusConsensusFailure(
     return false;
   }
 
-  if (result.consensusinfo().leaderid() != leaderID) {
+  if (result->consensusinfo().leaderid() != leaderID) {
     LOG_GENERAL(WARNING, "Leader ID mismatch. Expected: "
                              << leaderID << " Actual: "
-                             << result.consensusinfo().leaderid());
+                             << result->consensusinfo().leaderid());
     return false;
   }
 
-  bytes tmp(result.consensusinfo().ByteSize());
-  result.consensusinfo().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->consensusinfo(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, leaderKey)) {
     LOG_GENERAL(WARNING, "Invalid signature in ConsensusConsensusFailure");
@@ -8166,20 +9253,20 @@ bool Messenger::SetLookupGetDSTxBlockFromSeed(
     const uint64_t txHighBlockNum, const uint32_t listenPort) {
   LOG_MARKER();
 
-  LookupGetDSTxBlockFromSeed result;
+  ArenaMessage<LookupGetDSTxBlockFromSeed> result;
 
-  result.set_dslowblocknum(dsLowBlockNum);
-  result.set_dshighblocknum(dsHighBlockNum);
-  result.set_txlowblocknum(txLowBlockNum);
-  result.set_txhighblocknum(txHighBlockNum);
-  result.set_listenport(listenPort);
+  result->set_dslowblocknum(dsLowBlockNum);
+  result->set_dshighblocknum(dsHighBlockNum);
+  result->set_txlowblocknum(txLowBlockNum);
+  result->set_txhighblocknum(txHighBlockNum);
+  result->set_listenport(listenPort);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetDSTxBlockFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupGetDSTxBlockFromSeed(
@@ -8194,19 +9281,19 @@ bool Messenger::GetLookupGetDSTxBlockFromSeed(
     return false;
   }
 
-  LookupGetDSTxBlockFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupGetDSTxBlockFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetDSTxBlockFromSeed initialization failed");
     return false;
   }
 
-  dsLowBlockNum = result.dslowblocknum();
-  dsHighBlockNum = result.dshighblocknum();
-  txLowBlockNum = result.txlowblocknum();
-  txHighBlockNum = result.txhighblocknum();
-  listenPort = result.listenport();
+  dsLowBlockNum = result->dslowblocknum();
+  dsHighBlockNum = result->dshighblocknum();
+  txLowBlockNum = result->txlowblocknum();
+  txHighBlockNum = result->txhighblocknum();
+  listenPort = result->listenport();
 
   return true;
 }
@@ -8218,41 +9305,43 @@ bool Messenger::SetVCNodeSetDSTxBlockFromSeed(bytes& dst,
                                               const vector<TxBlock>& txBlocks) {
   LOG_MARKER();
 
-  VCNodeSetDSTxBlockFromSeed result;
+  ArenaMessage<VCNodeSetDSTxBlockFromSeed> result;
 
   for (const auto& dsblock : DSBlocks) {
-    DSBlockToProtobuf(dsblock, *result.mutable_data()->add_dsblocks());
+    DSBlockToProtobuf(dsblock, *result->mutable_data()->add_dsblocks());
   }
 
   for (const auto& txblock : txBlocks) {
-    TxBlockToProtobuf(txblock, *result.mutable_data()->add_txblocks());
+    TxBlockToProtobuf(txblock, *result->mutable_data()->add_txblocks());
   }
 
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
 
   Signature signature;
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "VCNodeSetDSTxBlockFromSeed.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   if (!Schnorr::Sign(tmp, lookupKey.first, lookupKey.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign DS and Tx blocks");
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "VCNodeSetDSTxBlockFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetVCNodeSetDSTxBlockFromSeed(const bytes& src,
@@ -8268,15 +9357,15 @@ bool Messenger::GetVCNodeSetDSTxBlockFromSeed(const bytes& src,
     return false;
   }
 
-  VCNodeSetDSTxBlockFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<VCNodeSetDSTxBlockFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "VCNodeSetDSTxBlockFromSeed initialization failed");
     return false;
   }
 
-  for (const auto& proto_dsblock : result.data().dsblocks()) {
+  for (const auto& proto_dsblock : result->data().dsblocks()) {
     DSBlock dsblock;
     if (!ProtobufToDSBlock(proto_dsblock, dsblock)) {
       LOG_GENERAL(WARNING, "ProtobufToDSBlock failed");
@@ -8285,7 +9374,7 @@ bool Messenger::GetVCNodeSetDSTxBlockFromSeed(const bytes& src,
     dsBlocks.emplace_back(dsblock);
   }
 
-  for (const auto& txblock : result.data().txblocks()) {
+  for (const auto& txblock : result->data().txblocks()) {
     TxBlock block;
     if (!ProtobufToTxBlock(txblock, block)) {
       LOG_GENERAL(WARNING, "ProtobufToTxBlock failed");
@@ -8294,13 +9383,15 @@ bool Messenger::GetVCNodeSetDSTxBlockFromSeed(const bytes& src,
     txBlocks.emplace_back(block);
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), lookupPubKey);
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   if (!Schnorr::Verify(tmp, signature, lookupPubKey)) {
     LOG_GENERAL(WARNING, "Invalid signature in VCNodeSetDSTxBlockFromSeed");
@@ -8315,24 +9406,26 @@ bool Messenger::SetDSLookupNewDSGuardNetworkInfo(
     const Peer& dsGuardNewNetworkInfo, const uint64_t timestamp,
     const PairOfKey& dsguardkey) {
   LOG_MARKER();
-  DSLookupSetDSGuardNetworkInfoUpdate result;
+  ArenaMessage<DSLookupSetDSGuardNetworkInfoUpdate> result;
 
-  result.mutable_data()->set_dsepochnumber(dsEpochNumber);
+  result->mutable_data()->set_dsepochnumber(dsEpochNumber);
   SerializableToProtobufByteArray(
-      dsguardkey.second, *result.mutable_data()->mutable_dsguardpubkey());
+      dsguardkey.second, *result->mutable_data()->mutable_dsguardpubkey());
   PeerToProtobuf(dsGuardNewNetworkInfo,
-                 *result.mutable_data()->mutable_dsguardnewnetworkinfo());
-  result.mutable_data()->set_timestamp(timestamp);
+                 *result->mutable_data()->mutable_dsguardnewnetworkinfo());
+  result->mutable_data()->set_timestamp(timestamp);
 
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(
         WARNING,
         "DSLookupSetDSGuardNetworkInfoUpdate.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
   if (!Schnorr::Sign(tmp, dsguardkey.first, dsguardkey.second, signature)) {
@@ -8340,15 +9433,15 @@ bool Messenger::SetDSLookupNewDSGuardNetworkInfo(
     return false;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "DSLookupSetDSGuardNetworkInfoUpdate initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetDSLookupNewDSGuardNetworkInfo(
@@ -8362,32 +9455,35 @@ bool Messenger::GetDSLookupNewDSGuardNetworkInfo(
     return false;
   }
 
-  DSLookupSetDSGuardNetworkInfoUpdate result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<DSLookupSetDSGuardNetworkInfoUpdate> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized() || !result.data().IsInitialized()) {
+  if (!result->IsInitialized() || !result->data().IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "DSLookupSetDSGuardNetworkInfoUpdate initialization failed");
     return false;
   }
 
   // First deserialize the fields needed just for signature check
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.data().dsguardpubkey(), dsGuardPubkey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->data().dsguardpubkey(),
+                                  dsGuardPubkey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   // Check signature
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
   if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, dsGuardPubkey)) {
     LOG_GENERAL(WARNING, "DSLookupSetDSGuardNetworkInfoUpdate signature wrong");
     return false;
   }
 
   // Deserialize the remaining fields
-  dsEpochNumber = result.data().dsepochnumber();
-  ProtobufToPeer(result.data().dsguardnewnetworkinfo(), dsGuardNewNetworkInfo);
-  timestamp = result.data().timestamp();
+  dsEpochNumber = result->data().dsepochnumber();
+  ProtobufToPeer(result->data().dsguardnewnetworkinfo(), dsGuardNewNetworkInfo);
+  timestamp = result->data().timestamp();
 
   return true;
 }
@@ -8397,28 +9493,30 @@ bool Messenger::SetLookupGetNewDSGuardNetworkInfoFromLookup(
     const uint64_t dsEpochNumber, const PairOfKey& lookupKey) {
   LOG_MARKER();
 
-  NodeGetGuardNodeNetworkInfoUpdate result;
-  result.mutable_data()->set_portno(portNo);
-  result.mutable_data()->set_dsepochnumber(dsEpochNumber);
-  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+  ArenaMessage<NodeGetGuardNodeNetworkInfoUpdate> result;
+  result->mutable_data()->set_portno(portNo);
+  result->mutable_data()->set_dsepochnumber(dsEpochNumber);
+  SerializableToProtobufByteArray(lookupKey.second, *result->mutable_pubkey());
 
-  if (result.data().IsInitialized()) {
-    bytes tmp(result.data().ByteSize());
-    result.data().SerializeToArray(tmp.data(), tmp.size());
+  if (result->data().IsInitialized()) {
+    bytes tmp;
+    if (!SerializeToArray(result->data(), tmp, 0)) {
+      return false;
+    }
 
     Signature signature;
     if (!Schnorr::Sign(tmp, lookupKey.first, lookupKey.second, signature)) {
       LOG_GENERAL(WARNING, "Failed to sign ds guard identity update");
       return false;
     }
-    SerializableToProtobufByteArray(signature, *result.mutable_signature());
+    SerializableToProtobufByteArray(signature, *result->mutable_signature());
   } else {
     LOG_GENERAL(
         WARNING,
         "SetLookupGetNewDSGuardNetworkInfoFromLookup initialization failed");
     return false;
   }
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupGetNewDSGuardNetworkInfoFromLookup(
@@ -8432,10 +9530,10 @@ bool Messenger::GetLookupGetNewDSGuardNetworkInfoFromLookup(
     return false;
   }
 
-  NodeGetGuardNodeNetworkInfoUpdate result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<NodeGetGuardNodeNetworkInfoUpdate> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized() || !result.data().IsInitialized()) {
+  if (!result->IsInitialized() || !result->data().IsInitialized()) {
     LOG_GENERAL(
         WARNING,
         "GetLookupGetNewDSGuardNetworkInfoFromLookup initialization failed");
@@ -8447,20 +9545,22 @@ bool Messenger::GetLookupGetNewDSGuardNetworkInfoFromLookup(
   // We don't return senderPubKey since timing issues may make it difficult for
   // the lookup to check it against the shard structure
   PubKey senderPubKey;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), senderPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), senderPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   // Check signature
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
   if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, senderPubKey)) {
     LOG_GENERAL(WARNING, "DSMicroBlockSubmission signature wrong");
     return false;
   }
 
-  portNo = result.data().portno();
-  dsEpochNumber = result.data().dsepochnumber();
+  portNo = result->data().portno();
+  dsEpochNumber = result->data().dsepochnumber();
 
   return true;
 }
@@ -8470,11 +9570,11 @@ bool Messenger::SetNodeSetNewDSGuardNetworkInfo(
     const vector<DSGuardUpdateStruct>& vecOfDSGuardUpdateStruct,
     const PairOfKey& lookupKey) {
   LOG_MARKER();
-  NodeSetGuardNodeNetworkInfoUpdate result;
+  ArenaMessage<NodeSetGuardNodeNetworkInfoUpdate> result;
 
   for (const auto& dsguardupdate : vecOfDSGuardUpdateStruct) {
     ProtoDSGuardUpdateStruct* proto_DSGuardUpdateStruct =
-        result.mutable_data()->add_dsguardupdatestruct();
+        result->mutable_data()->add_dsguardupdatestruct();
     SerializableToProtobufByteArray(
         dsguardupdate.m_dsGuardPubkey,
         *proto_DSGuardUpdateStruct->mutable_dsguardpubkey());
@@ -8483,13 +9583,15 @@ bool Messenger::SetNodeSetNewDSGuardNetworkInfo(
     proto_DSGuardUpdateStruct->set_timestamp(dsguardupdate.m_timestamp);
   }
 
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "NodeSetGuardNodeNetworkInfoUpdate.Data initialization failed");
     return false;
   }
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   Signature signature;
   if (!Schnorr::Sign(tmp, lookupKey.first, lookupKey.second, signature)) {
@@ -8497,15 +9599,15 @@ bool Messenger::SetNodeSetNewDSGuardNetworkInfo(
     return false;
   }
   SerializableToProtobufByteArray(lookupKey.second,
-                                  *result.mutable_lookuppubkey());
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+                                  *result->mutable_lookuppubkey());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "SetNodeSetNewDSGuardNetworkInfo initialization failed");
     return false;
   }
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::SetNodeGetNewDSGuardNetworkInfo(
@@ -8520,27 +9622,29 @@ bool Messenger::SetNodeGetNewDSGuardNetworkInfo(
     return false;
   }
 
-  NodeSetGuardNodeNetworkInfoUpdate result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<NodeSetGuardNodeNetworkInfoUpdate> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "NodeSetGuardNodeNetworkInfoUpdate initialization failed");
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.lookuppubkey(), lookupPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->lookuppubkey(), lookupPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
   if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, lookupPubKey)) {
     LOG_GENERAL(WARNING, "NodeSetGuardNodeNetworkInfoUpdate signature wrong");
     return false;
   }
 
   for (const auto& proto_DSGuardUpdateStruct :
-       result.data().dsguardupdatestruct()) {
+       result->data().dsguardupdatestruct()) {
     PubKey tempPubk;
     PROTOBUFBYTEARRAYTOSERIALIZABLE(proto_DSGuardUpdateStruct.dsguardpubkey(),
                                     tempPubk);
@@ -8558,32 +9662,34 @@ bool Messenger::SetSeedNodeHistoricalDB(bytes& dst, const unsigned int offset,
                                         const PairOfKey& archivalKeys,
                                         const uint32_t code,
                                         const string& path) {
-  SeedSetHistoricalDB result;
+  ArenaMessage<SeedSetHistoricalDB> result;
 
-  result.mutable_data()->set_code(code);
-  result.mutable_data()->set_path(path);
+  result->mutable_data()->set_code(code);
+  result->mutable_data()->set_path(path);
   SerializableToProtobufByteArray(archivalKeys.second,
-                                  *result.mutable_pubkey());
+                                  *result->mutable_pubkey());
 
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "SeedSetHistoricalDB.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
   Signature signature;
   if (!Schnorr::Sign(tmp, archivalKeys.first, archivalKeys.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign SeedSetHistoricalDB");
     return false;
   }
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "SeedSetHistoricalDB initialization failed");
     return false;
   }
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetSeedNodeHistoricalDB(const bytes& src,
@@ -8596,25 +9702,27 @@ bool Messenger::GetSeedNodeHistoricalDB(const bytes& src,
     return false;
   }
 
-  SeedSetHistoricalDB result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<SeedSetHistoricalDB> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "SeedSetHistoricalDB initialization failed ");
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), archivalPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), archivalPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
   if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, archivalPubKey)) {
     LOG_GENERAL(WARNING, "SeedSetHistoricalDB signature wrong");
     return false;
   }
-  code = result.data().code();
-  path = result.data().path();
+  code = result->data().code();
+  path = result->data().path();
 
   return true;
 }
@@ -8624,32 +9732,34 @@ bool Messenger::SetNodeRemoveFromBlacklist(bytes& dst,
                                            const PairOfKey& myKey,
                                            const uint128_t& ipAddress,
                                            const uint64_t& dsEpochNumber) {
-  NodeRemoveFromBlacklist result;
+  ArenaMessage<NodeRemoveFromBlacklist> result;
   NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
-      ipAddress, *result.mutable_data()->mutable_ipaddress());
-  result.mutable_data()->set_dsepochnumber(dsEpochNumber);
+      ipAddress, *result->mutable_data()->mutable_ipaddress());
+  result->mutable_data()->set_dsepochnumber(dsEpochNumber);
 
-  SerializableToProtobufByteArray(myKey.second, *result.mutable_pubkey());
+  SerializableToProtobufByteArray(myKey.second, *result->mutable_pubkey());
 
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeRemoveFromBlacklist.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
   Signature signature;
   if (!Schnorr::Sign(tmp, myKey.first, myKey.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign NodeRemoveFromBlacklist");
     return false;
   }
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeRemoveFromBlacklist initialization failed");
     return false;
   }
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetNodeRemoveFromBlacklist(const bytes& src,
@@ -8663,72 +9773,79 @@ bool Messenger::GetNodeRemoveFromBlacklist(const bytes& src,
     return false;
   }
 
-  NodeRemoveFromBlacklist result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<NodeRemoveFromBlacklist> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeRemoveFromBlacklist initialization failed");
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), senderPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), senderPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
   if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, senderPubKey)) {
     LOG_GENERAL(WARNING, "NodeRemoveFromBlacklist signature wrong");
     return false;
   }
 
-  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result.data().ipaddress(),
+  ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(result->data().ipaddress(),
                                                      ipAddress);
-  dsEpochNumber = result.data().dsepochnumber();
+  dsEpochNumber = result->data().dsepochnumber();
   return true;
 }
 
 bool Messenger::SetLookupGetCosigsRewardsFromSeed(bytes& dst,
                                                   const unsigned int offset,
                                                   const uint64_t txBlkNum,
+                                                  const uint64_t blockCount,
                                                   const uint32_t listenPort,
                                                   const PairOfKey& keys) {
   LOG_MARKER();
 
-  LookupGetCosigsRewardsFromSeed result;
+  ArenaMessage<LookupGetCosigsRewardsFromSeed> result;
 
-  result.mutable_data()->set_epochnumber(txBlkNum);
-  result.mutable_data()->set_portno(listenPort);
+  result->mutable_data()->set_epochnumber(txBlkNum);
+  result->mutable_data()->set_blockcount(blockCount);
+  result->mutable_data()->set_portno(listenPort);
 
   Signature signature;
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "LookupGetCosigsRewardsFromSeed.Data initialization failed");
     return false;
   }
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
 
   if (!Schnorr::Sign(tmp, keys.first, keys.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign GetCosigsRewardsFromSeed message");
     return false;
   }
 
-  SerializableToProtobufByteArray(keys.second, *result.mutable_pubkey());
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(keys.second, *result->mutable_pubkey());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "LookupGetCosigsRewardsFromSeed initialization failed");
     return false;
   }
 
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupGetCosigsRewardsFromSeed(const bytes& src,
                                                   const unsigned int offset,
                                                   PubKey& senderPubKey,
                                                   uint64_t& txBlockNumber,
+                                                  uint64_t& blockCount,
                                                   uint32_t& port) {
   if (offset >= src.size()) {
     LOG_GENERAL(WARNING, "Invalid data and offset, data size "
@@ -8736,35 +9853,38 @@ bool Messenger::GetLookupGetCosigsRewardsFromSeed(const bytes& src,
     return false;
   }
 
-  LookupGetCosigsRewardsFromSeed result;
+  ArenaMessage<LookupGetCosigsRewardsFromSeed> result;
 
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetCosigRewardsFromSeed initialization failed");
     return false;
   }
 
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), senderPubKey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), senderPubKey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
   if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, senderPubKey)) {
     LOG_GENERAL(WARNING, "LookupGetCosigRewardsFromSeed signature wrong");
     return false;
   }
 
-  txBlockNumber = result.data().epochnumber();
-  port = result.data().portno();
+  txBlockNumber = result->data().epochnumber();
+  blockCount = max<uint64_t>(result->data().blockcount(), 1);
+  port = result->data().portno();
   return true;
 }
 
-bool Messenger::SetLookupSetCosigsRewardsFromSeed(
-    bytes& dst, const unsigned int offset, const PairOfKey& myKey,
-    const uint64_t& txBlkNumber, const std::vector<MicroBlock>& microblocks,
-    const TxBlock& txBlock, const uint32_t& numberOfShards) {
-  LookupSetCosigsRewardsFromSeed result;
+bool Messenger::SetCosigsRewardsRecord(bytes& dst, const uint64_t& txBlkNumber,
+                                       const vector<MicroBlock>& microblocks,
+                                       const TxBlock& txBlock,
+                                       const uint32_t& numberOfShards) {
+  ArenaMessage<LookupSetCosigsRewardsFromSeed::Data> result;
 
   // For Non-DS Shard
   for (const auto& mb : microblocks) {
@@ -8772,7 +9892,7 @@ bool Messenger::SetLookupSetCosigsRewardsFromSeed(
       continue;  // use txBlk for ds shard
     }
     ProtoCosigsRewardsStructure* proto_CosigsRewardsStructure =
-        result.mutable_data()->add_cosigsrewards();
+        result->add_cosigsrewards();
 
     // txblock and shardid
     proto_CosigsRewardsStructure->set_epochnumber(txBlkNumber);
@@ -8792,7 +9912,7 @@ bool Messenger::SetLookupSetCosigsRewardsFromSeed(
 
   // For DS Shard
   ProtoCosigsRewardsStructure* proto_CosigsRewardsStructure =
-      result.mutable_data()->add_cosigsrewards();
+      result->add_cosigsrewards();
 
   // txblock and shardid
   proto_CosigsRewardsStructure->set_epochnumber(txBlkNumber + 1);
@@ -8809,29 +9929,55 @@ bool Messenger::SetLookupSetCosigsRewardsFromSeed(
       txBlock.GetHeader().GetRewards(),
       *proto_CosigsRewardsStructure->mutable_rewards());
 
-  SerializableToProtobufByteArray(myKey.second, *result.mutable_pubkey());
+  if (!result->IsInitialized()) {
+    LOG_GENERAL(WARNING,
+                "LookupSetCosigsRewardsFromSeed.Data initialization failed");
+    return false;
+  }
+
+  return SerializeToArray(*result, dst, 0);
+}
+
+bool Messenger::SetLookupSetCosigsRewardsFromSeed(
+    bytes& dst, const unsigned int offset, const PairOfKey& myKey,
+    const vector<bytes>& records) {
+  ArenaMessage<LookupSetCosigsRewardsFromSeed> result;
+
+  // The records are Data messages, whose entries add up when merged
+  for (const auto& record : records) {
+    ArenaMessage<LookupSetCosigsRewardsFromSeed::Data> data;
+    if (!data->ParseFromArray(record.data(), record.size())) {
+      LOG_GENERAL(WARNING, "Failed to parse cosigs/rewards record");
+      return false;
+    }
+    result->mutable_data()->MergeFrom(*data);
+  }
+
+  SerializableToProtobufByteArray(myKey.second, *result->mutable_pubkey());
 
-  if (!result.data().IsInitialized()) {
+  if (!result->data().IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "LookupSetCosigsRewardsFromSeed.Data initialization failed");
     return false;
   }
 
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
   Signature signature;
   if (!Schnorr::Sign(tmp, myKey.first, myKey.second, signature)) {
     LOG_GENERAL(WARNING, "Failed to sign LookupSetCosigsRewardsFromSeed");
     return false;
   }
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
 
-  if (!result.IsInitialized()) {
+  if (!result->IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "LookupSetCosigsRewardsFromSeed initialization failed");
     return false;
   }
-  return SerializeToArray(result, dst, offset);
+  return SerializeToArray(*result, dst, offset);
 }
 
 bool Messenger::GetLookupSetCosigsRewardsFromSeed(
@@ -8845,23 +9991,25 @@ bool Messenger::GetLookupSetCosigsRewardsFromSeed(
     return false;
   }
 
-  LookupSetCosigsRewardsFromSeed result;
-  result.ParseFromArray(src.data() + offset, src.size() - offset);
+  ArenaMessage<LookupSetCosigsRewardsFromSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
 
-  if (!result.IsInitialized() || !result.data().IsInitialized()) {
+  if (!result->IsInitialized() || !result->data().IsInitialized()) {
     LOG_GENERAL(WARNING,
                 "LookupSetCosigsRewardsFromSeed initialization failed");
     return false;
   }
 
   // First deserialize the fields needed just for signature check
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), senderPubkey);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), senderPubkey);
   Signature signature;
-  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
 
   // Check signature
-  bytes tmp(result.data().ByteSize());
-  result.data().SerializeToArray(tmp.data(), tmp.size());
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
   if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, senderPubkey)) {
     LOG_GENERAL(WARNING, "LookupSetCosigsRewardsFromSeed signature wrong");
     return false;
@@ -8873,7 +10021,7 @@ bool Messenger::GetLookupSetCosigsRewardsFromSeed(
   uint128_t rewards;
   cosigrewards.clear();
 
-  for (const auto& proto_cosigrewards : result.data().cosigsrewards()) {
+  for (const auto& proto_cosigrewards : result->data().cosigsrewards()) {
     txBlkNum = proto_cosigrewards.epochnumber();
     shardId = proto_cosigrewards.shardid();
     ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(
@@ -8891,4 +10039,75 @@ bool Messenger::GetLookupSetCosigsRewardsFromSeed(
   }
 
   return true;
-}
\ No newline at end of file
+}
+bool Messenger::SetLookupSubscribeSeed(bytes& dst, const unsigned int offset,
+                                       const uint32_t listenPort,
+                                       const PairOfKey& keys) {
+  LOG_MARKER();
+
+  ArenaMessage<LookupSubscribeSeed> result;
+
+  result->mutable_data()->set_portno(listenPort);
+
+  if (!result->data().IsInitialized()) {
+    LOG_GENERAL(WARNING, "LookupSubscribeSeed.Data initialization failed");
+    return false;
+  }
+
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
+
+  Signature signature;
+  if (!Schnorr::Sign(tmp, keys.first, keys.second, signature)) {
+    LOG_GENERAL(WARNING, "Failed to sign LookupSubscribeSeed message");
+    return false;
+  }
+
+  SerializableToProtobufByteArray(keys.second, *result->mutable_pubkey());
+  SerializableToProtobufByteArray(signature, *result->mutable_signature());
+
+  if (!result->IsInitialized()) {
+    LOG_GENERAL(WARNING, "LookupSubscribeSeed initialization failed");
+    return false;
+  }
+
+  return SerializeToArray(*result, dst, offset);
+}
+
+bool Messenger::GetLookupSubscribeSeed(const bytes& src,
+                                       const unsigned int offset,
+                                       PubKey& senderPubKey, uint32_t& port) {
+  LOG_MARKER();
+
+  if (offset >= src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  ArenaMessage<LookupSubscribeSeed> result;
+  result->ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result->IsInitialized() || !result->data().IsInitialized()) {
+    LOG_GENERAL(WARNING, "LookupSubscribeSeed initialization failed");
+    return false;
+  }
+
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->pubkey(), senderPubKey);
+  Signature signature;
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result->signature(), signature);
+
+  bytes tmp;
+  if (!SerializeToArray(result->data(), tmp, 0)) {
+    return false;
+  }
+  if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, senderPubKey)) {
+    LOG_GENERAL(WARNING, "LookupSubscribeSeed signature wrong");
+    return false;
+  }
+
+  port = result->data().portno();
+  return true;
+}
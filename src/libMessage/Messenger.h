@@ -71,10 +71,21 @@ class Messenger {
                                        const DequeOfShard& shards,
                                        ShardingHash& dst);
 
+  // Returns the shards encoded as a ProtoShardingStructure. The last
+  // structure encoded is kept and shared until a different one is asked for,
+  // so that the messages of a DS epoch that carry it encode it once.
+  static std::shared_ptr<const bytes> GetEncodedShardingStructure(
+      const uint32_t& version, const DequeOfShard& shards);
+
   static bool SetAccountBase(bytes& dst, const unsigned int offset,
                              const AccountBase& accountbase);
   static bool GetAccountBase(const bytes& src, const unsigned int offset,
                              AccountBase& accountbase);
+  /// Decode only the balance or the nonce of an encoded AccountBase
+  static bool GetAccountBaseBalance(const bytes& src, const unsigned int offset,
+                                    uint128_t& balance);
+  static bool GetAccountBaseNonce(const bytes& src, const unsigned int offset,
+                                  uint64_t& nonce);
 
   static bool SetAccount(bytes& dst, const unsigned int offset,
                          const Account& account);
@@ -98,12 +109,25 @@ class Messenger {
   static bool SetAccountStoreDelta(bytes& dst, const unsigned int offset,
                                    AccountStoreTemp& accountStoreTemp,
                                    AccountStore& accountStore);
+  // Serializes the delta of one account, so that the entries of all changed
+  // accounts in address order add up to the output of SetAccountStoreDelta
+  static bool SetAccountStoreDeltaEntry(bytes& dst, const unsigned int offset,
+                                        const Address& address,
+                                        const Account* oldAccount,
+                                        const Account& newAccount);
   static bool GetAccountStoreDelta(const bytes& src, const unsigned int offset,
                                    AccountStore& accountStore,
                                    const bool revertible, bool temp);
   static bool GetAccountStoreDelta(const bytes& src, const unsigned int offset,
                                    AccountStoreTemp& accountStoreTemp,
                                    bool temp);
+  // Applies the state deltas in order, decoding them on numThreads threads
+  // ahead of the one being applied. The state trie is left to the caller,
+  // for the addresses put in touched.
+  static bool GetAccountStoreDeltas(const std::vector<const bytes*>& srcs,
+                                    AccountStore& accountStore,
+                                    const unsigned int numThreads,
+                                    std::set<Address>& touched);
 
   static bool GetMbInfoHash(const std::vector<MicroBlockInfo>& mbInfos,
                             MBInfoHash& dst);
@@ -178,6 +202,11 @@ class Messenger {
       const TransactionReceipt& transactionReceipt);
   static bool GetTransactionReceipt(const bytes& src, const unsigned int offset,
                                     TransactionReceipt& transactionReceipt);
+  static bool SetTransactionReceiptData(bytes& dst, const unsigned int offset,
+                                        const TransactionReceipt::Data& data);
+  static bool GetTransactionReceiptData(const bytes& src,
+                                        const unsigned int offset,
+                                        TransactionReceipt::Data& data);
 
   static bool SetTransactionWithReceipt(
       bytes& dst, const unsigned int offset,
@@ -234,6 +263,12 @@ class Messenger {
                                         const unsigned int offset,
                                         DiagnosticDataCoinbase& entry);
 
+  static bool SetDiagnosticDataEpochPerf(bytes& dst, const unsigned int offset,
+                                         const DiagnosticDataEpochPerf& entry);
+  static bool GetDiagnosticDataEpochPerf(const bytes& src,
+                                         const unsigned int offset,
+                                         DiagnosticDataEpochPerf& entry);
+
   // ============================================================================
   // Peer Manager messages
   // ============================================================================
@@ -302,13 +337,26 @@ class Messenger {
       const uint64_t blockNumber, const bytes& blockHash,
       const uint16_t leaderID, const PairOfKey& leaderKey,
       const TxBlock& txBlock, const std::shared_ptr<MicroBlock>& microBlock,
-      bytes& messageToCosign);
+      bytes& messageToCosign, const bool hashOnly = false);
 
+  /// If the announcement only carries the block hash, txBlockHash is set and
+  /// txBlock, microBlock and messageToCosign are left untouched.
   static bool GetDSFinalBlockAnnouncement(
       const bytes& src, const unsigned int offset, const uint32_t consensusID,
       const uint64_t blockNumber, const bytes& blockHash,
       const uint16_t leaderID, const PubKey& leaderKey, TxBlock& txBlock,
-      std::shared_ptr<MicroBlock>& microBlock, bytes& messageToCosign);
+      std::shared_ptr<MicroBlock>& microBlock, bytes& messageToCosign,
+      bytes& txBlockHash);
+
+  static bool SetDSFinalBlockProposal(
+      bytes& dst, const unsigned int offset, const uint64_t blockNumber,
+      const TxBlock& txBlock, const std::shared_ptr<MicroBlock>& microBlock,
+      const PairOfKey& leaderKey);
+  static bool GetDSFinalBlockProposal(const bytes& src,
+                                      const unsigned int offset,
+                                      uint64_t& blockNumber, TxBlock& txBlock,
+                                      std::shared_ptr<MicroBlock>& microBlock,
+                                      PubKey& leaderKey);
 
   static bool SetDSVCBlockAnnouncement(
       bytes& dst, const unsigned int offset, const uint32_t consensusID,
@@ -359,14 +407,29 @@ class Messenger {
                                 uint64_t& dsBlockNumber, uint32_t& consensusID,
                                 TxBlock& txBlock, bytes& stateDelta);
 
+  // Decodes only the DS block number, header and block hash of a final
+  // block, skipping its microblock infos, co-signatures and state delta
+  static bool GetNodeFinalBlockHeader(const bytes& src,
+                                      const unsigned int offset,
+                                      uint64_t& dsBlockNumber,
+                                      TxBlockHeader& txBlockHeader,
+                                      BlockHash& blockHash);
+
   static bool SetNodeVCBlock(bytes& dst, const unsigned int offset,
                              const VCBlock& vcBlock);
   static bool GetNodeVCBlock(const bytes& src, const unsigned int offset,
                              VCBlock& vcBlock);
+  // Decodes only the header and block hash of a VC block
+  static bool GetNodeVCBlockHeader(const bytes& src, const unsigned int offset,
+                                   VCBlockHeader& vcBlockHeader,
+                                   BlockHash& blockHash);
 
+  // With compact set, only the receipts of txns are sent, the receiver
+  // finding the txns from the microblock txn hashes
   static bool SetNodeMBnForwardTransaction(
       bytes& dst, const unsigned int offset, const MicroBlock& microBlock,
-      const std::vector<TransactionWithReceipt>& txns);
+      const std::vector<TransactionWithReceipt>& txns,
+      const bool compact = false);
   static bool GetNodeMBnForwardTransaction(const bytes& src,
                                            const unsigned int offset,
                                            MBnForwardedTxnEntry& entry);
@@ -380,22 +443,25 @@ class Messenger {
       const std::unordered_map<TxnHash, PoolTxnStatus>& hashCodeMap,
       const uint32_t shardId, const PairOfKey& key);
 
+  /// The packet is attested if attest, for txns the lookup has verified
   static bool SetNodeForwardTxnBlock(
       bytes& dst, const unsigned int offset, const uint64_t& epochNumber,
       const uint64_t& dsBlockNum, const uint32_t& shardId,
       const PairOfKey& lookupKey, const std::vector<Transaction>& txnsCurrent,
-      const std::vector<Transaction>& txnsGenerated);
-  static bool SetNodeForwardTxnBlock(bytes& dst, const unsigned int offset,
-                                     const uint64_t& epochNumber,
-                                     const uint64_t& dsBlockNum,
-                                     const uint32_t& shardId,
-                                     const PubKey& lookupKey,
-                                     std::vector<Transaction>& txns,
-                                     const Signature& signature);
+      const std::vector<Transaction>& txnsGenerated, const bool attest = false);
+  /// Serializes a received packet again, with its attestation if attested
+  static bool SetNodeForwardTxnBlock(
+      bytes& dst, const unsigned int offset, const uint64_t& epochNumber,
+      const uint64_t& dsBlockNum, const uint32_t& shardId,
+      const PubKey& lookupKey, std::vector<Transaction>& txns,
+      const Signature& signature, const Signature& attestation,
+      const bool attested);
+  /// attested is set if the packet carries a valid attestation of the lookup
   static bool GetNodeForwardTxnBlock(
       const bytes& src, const unsigned int offset, uint64_t& epochNumber,
       uint64_t& dsBlockNum, uint32_t& shardId, PubKey& lookupPubKey,
-      std::vector<Transaction>& txns, Signature& signature);
+      std::vector<Transaction>& txns, Signature& signature,
+      Signature& attestation, bool& attested);
 
   static bool SetNodeMicroBlockAnnouncement(
       bytes& dst, const unsigned int offset, const uint32_t consensusID,
@@ -432,15 +498,18 @@ class Messenger {
   static bool ArrayToShardStructure(const bytes& src, const unsigned int offset,
                                     uint32_t& version, DequeOfShard& shards);
 
+  // The missing txns found in blockTranHashes, the txn hashes of the
+  // microblock they were proposed in, are sent as their positions in it. The
+  // receiver must then pass the same hashes to decode them.
   static bool SetNodeMissingTxnsErrorMsg(
       bytes& dst, const unsigned int offset,
       const std::vector<TxnHash>& missingTxnHashes, const uint64_t epochNum,
-      const uint32_t listenPort);
-  static bool GetNodeMissingTxnsErrorMsg(const bytes& src,
-                                         const unsigned int offset,
-                                         std::vector<TxnHash>& missingTxnHashes,
-                                         uint64_t& epochNum,
-                                         uint32_t& listenPort);
+      const uint32_t listenPort,
+      const std::vector<TxnHash>& blockTranHashes = {});
+  static bool GetNodeMissingTxnsErrorMsg(
+      const bytes& src, const unsigned int offset,
+      std::vector<TxnHash>& missingTxnHashes, uint64_t& epochNum,
+      uint32_t& listenPort, const std::vector<TxnHash>& blockTranHashes = {});
 
   // ============================================================================
   // Lookup messages
@@ -506,6 +575,11 @@ class Messenger {
                                           const uint64_t highBlockNum,
                                           const PairOfKey& lookupKey,
                                           const std::vector<TxBlock>& txBlocks);
+  // Decodes only the block range, without parsing the tx blocks
+  static bool GetLookupSetTxBlockFromSeedRange(const bytes& src,
+                                               const unsigned int offset,
+                                               uint64_t& lowBlockNum,
+                                               uint64_t& highBlockNum);
   static bool GetLookupSetTxBlockFromSeed(const bytes& src,
                                           const unsigned int offset,
                                           uint64_t& lowBlockNum,
@@ -550,18 +624,27 @@ class Messenger {
                                               uint64_t& highBlockNum,
                                               PubKey& lookupPubKey,
                                               std::vector<bytes>& stateDeltas);
+  /// maxAccounts 0 asks for the whole state, else for a chunk from cursor
   static bool SetLookupGetStateFromSeed(bytes& dst, const unsigned int offset,
-                                        const uint32_t listenPort);
+                                        const uint32_t listenPort,
+                                        const Address& cursor = Address(),
+                                        const unsigned int maxAccounts = 0);
   static bool GetLookupGetStateFromSeed(const bytes& src,
                                         const unsigned int offset,
-                                        uint32_t& listenPort);
+                                        uint32_t& listenPort, Address& cursor,
+                                        unsigned int& maxAccounts);
   static bool SetLookupSetStateFromSeed(bytes& dst, const unsigned int offset,
                                         const PairOfKey& lookupKey,
-                                        const AccountStore& accountStore);
+                                        const AccountStore& accountStore,
+                                        const Address& cursor = Address(),
+                                        const unsigned int maxAccounts = 0);
+  /// stateRoot is zero for the whole state, else more is set if there are
+  /// chunks left and next to the cursor of the following one
   static bool GetLookupSetStateFromSeed(const bytes& src,
                                         const unsigned int offset,
                                         PubKey& lookupPubKey,
-                                        bytes& accountStoreBytes);
+                                        bytes& accountStoreBytes, bool& more,
+                                        Address& next, dev::h256& stateRoot);
   static bool SetLookupSetLookupOffline(bytes& dst, const unsigned int offset,
                                         const uint8_t msgType,
                                         const uint32_t listenPort,
@@ -795,12 +878,12 @@ class Messenger {
       bytes& dst, const unsigned int offset, const uint32_t consensusID,
       const uint64_t blockNumber, const bytes& blockHash,
       const uint16_t leaderID, const Signature& collectiveSig,
-      const std::vector<bool>& bitmap, const PairOfKey& leaderKey);
+      const Bitmap& bitmap, const PairOfKey& leaderKey);
   static bool GetConsensusCollectiveSig(
       const bytes& src, const unsigned int offset, const uint32_t consensusID,
       const uint64_t blockNumber, const bytes& blockHash,
-      const uint16_t leaderID, std::vector<bool>& bitmap,
-      Signature& collectiveSig, const PubKey& leaderKey);
+      const uint16_t leaderID, Bitmap& bitmap, Signature& collectiveSig,
+      const PubKey& leaderKey);
 
   static bool SetConsensusCommitFailure(bytes& dst, const unsigned int offset,
                                         const uint32_t consensusID,
@@ -899,6 +982,7 @@ class Messenger {
   static bool SetLookupGetCosigsRewardsFromSeed(bytes& dst,
                                                 const unsigned int offset,
                                                 const uint64_t txBlkNum,
+                                                const uint64_t blockCount,
                                                 const uint32_t listenPort,
                                                 const PairOfKey& keys);
 
@@ -906,15 +990,31 @@ class Messenger {
                                                 const unsigned int offset,
                                                 PubKey& senderPubKey,
                                                 uint64_t& txBlockNumber,
+                                                uint64_t& blockCount,
                                                 uint32_t& port);
 
+  /// Serializes the cosigs and rewards of one tx block and its microblocks
+  /// as LookupSetCosigsRewardsFromSeed.Data, so that the records of several
+  /// blocks are joined by SetLookupSetCosigsRewardsFromSeed
+  static bool SetCosigsRewardsRecord(bytes& dst, const uint64_t& txBlkNumber,
+                                     const std::vector<MicroBlock>& microblocks,
+                                     const TxBlock& txBlock,
+                                     const uint32_t& numberOfShards);
+
   static bool SetLookupSetCosigsRewardsFromSeed(
       bytes& dst, const unsigned int offset, const PairOfKey& myKey,
-      const uint64_t& txBlkNumber, const std::vector<MicroBlock>& microblocks,
-      const TxBlock& txBlock, const uint32_t& numberOfShards);
+      const std::vector<bytes>& records);
 
   static bool GetLookupSetCosigsRewardsFromSeed(
       const bytes& src, const unsigned int offset,
       std::vector<CoinbaseStruct>& cosigrewards, PubKey& senderPubkey);
+
+  static bool SetLookupSubscribeSeed(bytes& dst, const unsigned int offset,
+                                     const uint32_t listenPort,
+                                     const PairOfKey& keys);
+
+  static bool GetLookupSubscribeSeed(const bytes& src,
+                                     const unsigned int offset,
+                                     PubKey& senderPubKey, uint32_t& port);
 };
 #endif  // ZILLIQA_SRC_LIBMESSAGE_MESSENGER_H_
@@ -52,6 +52,15 @@ template bool MessengerAccountStoreBase::GetAccountStore<map<Address, Account>>(
     const bytes& src, const unsigned int offset,
     map<Address, Account>& addressToAccount);
 
+template bool
+MessengerAccountStoreBase::SetAccountStore<FlatAddressMap<Account>>(
+    bytes& dst, const unsigned int offset,
+    const FlatAddressMap<Account>& addressToAccount);
+template bool
+MessengerAccountStoreBase::GetAccountStore<FlatAddressMap<Account>>(
+    const bytes& src, const unsigned int offset,
+    FlatAddressMap<Account>& addressToAccount);
+
 template <class MAP>
 bool MessengerAccountStoreBase::SetAccountStore(bytes& dst,
                                                 const unsigned int offset,
@@ -37,6 +37,52 @@ template bool MessengerAccountStoreTrie::SetAccountStoreTrie<
         stateTrie,
     const shared_ptr<unordered_map<Address, Account>>& addressToAccount);
 
+template bool MessengerAccountStoreTrie::SetAccountStoreTrieChunk<
+    dev::OverlayDB, std::unordered_map<Address, Account>>(
+    bytes& dst, const unsigned int offset,
+    const dev::SpecificTrieDB<dev::GenericTrieDB<dev::OverlayDB>, Address>&
+        stateTrie,
+    const shared_ptr<unordered_map<Address, Account>>& addressToAccount,
+    const Address& cursor, const unsigned int maxAccounts, Address& next,
+    bool& more);
+
+namespace {
+/// Adds the account in the entry of the state trie at address to result,
+/// taking it from addressToAccount if it is there
+template <class MAP>
+bool AddTrieEntry(ProtoAccountStore& result, const Address& address,
+                  dev::bytesConstRef rawAccountBase,
+                  const shared_ptr<MAP>& addressToAccount) {
+  ProtoAccountStore::AddressAccount* protoEntry = result.add_entries();
+  protoEntry->set_address(address.data(), address.size);
+  ProtoAccount* protoEntryAccount = protoEntry->mutable_account();
+
+  auto it = addressToAccount->find(address);
+  if (it != addressToAccount->end()) {
+    const Account& account = it->second;
+    AccountToProtobuf(account, *protoEntryAccount);
+  } else {
+    Account account;
+    if (!account.DeserializeBase(
+            bytes(rawAccountBase.begin(), rawAccountBase.end()), 0)) {
+      LOG_GENERAL(WARNING, "Account::DeserializeBase failed");
+      return true;
+    }
+    if (account.GetCodeHash() != dev::h256()) {
+      account.SetAddress(address);
+    }
+    AccountToProtobuf(account, *protoEntryAccount);
+  }
+
+  if (!protoEntryAccount->IsInitialized()) {
+    LOG_GENERAL(WARNING, "ProtoAccount initialization failed.");
+    return false;
+  }
+
+  return true;
+}
+}  // namespace
+
 template <class DB, class MAP>
 bool MessengerAccountStoreTrie::SetAccountStoreTrie(
     bytes& dst, const unsigned int offset,
@@ -45,34 +91,42 @@ bool MessengerAccountStoreTrie::SetAccountStoreTrie(
   ProtoAccountStore result;
 
   for (const auto& i : stateTrie) {
-    ProtoAccountStore::AddressAccount* protoEntry = result.add_entries();
-    Address address(i.first);
-    protoEntry->set_address(address.data(), address.size);
-    ProtoAccount* protoEntryAccount = protoEntry->mutable_account();
-
-    auto it = addressToAccount->find(address);
-    if (it != addressToAccount->end()) {
-      const Account& account = it->second;
-      AccountToProtobuf(account, *protoEntryAccount);
-    } else {
-      Account account;
-      if (!account.DeserializeBase(bytes(i.second.begin(), i.second.end()),
-                                   0)) {
-        LOG_GENERAL(WARNING, "Account::DeserializeBase failed");
-        continue;
-      }
-      if (account.GetCodeHash() != dev::h256()) {
-        account.SetAddress(address);
-      }
-      AccountToProtobuf(account, *protoEntryAccount);
+    if (!AddTrieEntry(result, Address(i.first), i.second, addressToAccount)) {
+      return false;
     }
+  }
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed.");
+    return false;
+  }
+
+  return SerializeToArray(result, dst, offset);
+}
 
-    if (!protoEntryAccount->IsInitialized()) {
-      LOG_GENERAL(WARNING, "ProtoAccount initialization failed.");
+template <class DB, class MAP>
+bool MessengerAccountStoreTrie::SetAccountStoreTrieChunk(
+    bytes& dst, const unsigned int offset,
+    const dev::SpecificTrieDB<dev::GenericTrieDB<DB>, Address>& stateTrie,
+    const shared_ptr<MAP>& addressToAccount, const Address& cursor,
+    const unsigned int maxAccounts, Address& next, bool& more) {
+  ProtoAccountStore result;
+
+  auto it = stateTrie.lower_bound(cursor);
+  for (unsigned int i = 0; i < maxAccounts && it != stateTrie.end();
+       i++, ++it) {
+    const auto entry = *it;
+    if (!AddTrieEntry(result, Address(entry.first), entry.second,
+                      addressToAccount)) {
       return false;
     }
   }
 
+  more = it != stateTrie.end();
+  if (more) {
+    next = (*it).first;
+  }
+
   if (!result.IsInitialized()) {
     LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed.");
     return false;
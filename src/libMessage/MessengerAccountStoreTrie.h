@@ -36,6 +36,15 @@ class MessengerAccountStoreTrie {
       bytes& dst, const unsigned int offset,
       const dev::SpecificTrieDB<dev::GenericTrieDB<DB>, Address>& stateTrie,
       const std::shared_ptr<MAP>& addressToAccount);
+  /// Encodes up to maxAccounts accounts of stateTrie as SetAccountStoreTrie
+  /// does, from the first address not below cursor. more is set if there are
+  /// accounts left, and next to the first of them.
+  template <class DB, class MAP>
+  static bool SetAccountStoreTrieChunk(
+      bytes& dst, const unsigned int offset,
+      const dev::SpecificTrieDB<dev::GenericTrieDB<DB>, Address>& stateTrie,
+      const std::shared_ptr<MAP>& addressToAccount, const Address& cursor,
+      const unsigned int maxAccounts, Address& next, bool& more);
 };
 
 #endif  // ZILLIQA_SRC_LIBMESSAGE_MESSENGERACCOUNTSTORETRIE_H_
@@ -15,6 +15,8 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <climits>
+
 #include "MessengerSWInfo.h"
 #include "libMessage/ZilliqaMessage.pb.h"
 #include "libUtils/Logger.h"
@@ -26,12 +28,18 @@ using namespace ZilliqaMessage;
 template <class T = ProtoSWInfo>
 bool SerializeToArray(const T& protoMessage, bytes& dst,
                       const unsigned int offset) {
-  if ((offset + protoMessage.ByteSize()) > dst.size()) {
-    dst.resize(offset + protoMessage.ByteSize());
+  const size_t size = protoMessage.ByteSizeLong();
+  if (size > INT_MAX) {
+    LOG_GENERAL(WARNING, "Message too large to serialize, size: " << size);
+    return false;
   }
 
-  return protoMessage.SerializeToArray(dst.data() + offset,
-                                       protoMessage.ByteSize());
+  if ((offset + size) > dst.size()) {
+    dst.resize(offset + size);
+  }
+
+  protoMessage.SerializeWithCachedSizesToArray(dst.data() + offset);
+  return true;
 }
 
 inline bool CheckRequiredFieldsProtoSWInfo(const ProtoSWInfo& protoSWInfo) {
@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#include "AsyncSender.h"
+#include "Blacklist.h"
+#include "P2PComm.h"
+#include "libUtils/Logger.h"
+#include "libUtils/ThreadAffinity.h"
+
+using namespace std;
+
+namespace {
+const unsigned int MAX_EVENTS = 64;
+
+/// Blacklists the peer on the same errors as the blocking sends do.
+void BlacklistOnError(int error, const Peer& peer) {
+  if (error == EHOSTUNREACH || error == ETIMEDOUT) {
+    LOG_GENERAL(WARNING, "[blacklist] Encountered "
+                             << error << " (" << std::strerror(error)
+                             << "). Adding " << peer.GetPrintableIPAddress()
+                             << " as strictly blacklisted");
+    Blacklist::GetInstance().Add(peer.m_ipAddress);
+  } else if (error == EHOSTDOWN || error == ECONNREFUSED) {
+    LOG_GENERAL(WARNING, "[blacklist] Encountered "
+                             << error << " (" << std::strerror(error)
+                             << "). Adding " << peer.GetPrintableIPAddress()
+                             << " as relaxed blacklisted");
+    Blacklist::GetInstance().Add(peer.m_ipAddress, false);
+  } else {
+    LOG_GENERAL(WARNING, "Async send failed. Code = "
+                             << error << " Desc: " << std::strerror(error)
+                             << ". IP address: " << peer);
+  }
+}
+}  // namespace
+
+AsyncSender::AsyncSender(unsigned int maxRetries, unsigned int retryDelayInMs)
+    : m_maxRetries(maxRetries), m_retryDelayInMs(max(retryDelayInMs, 1u)) {
+  m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+  m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_epollFd < 0 || m_wakeFd < 0) {
+    LOG_GENERAL(WARNING, "Cannot set up the async sender: "
+                             << std::strerror(errno));
+    return;
+  }
+
+  struct epoll_event event {};
+  event.events = EPOLLIN;
+  event.data.ptr = nullptr;
+  if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event) < 0) {
+    LOG_GENERAL(WARNING, "Cannot set up the async sender: "
+                             << std::strerror(errno));
+    return;
+  }
+
+  m_thread = thread([this]() {
+    ThreadAffinity::Apply("AsyncSender");
+    Loop();
+  });
+}
+
+AsyncSender::~AsyncSender() {
+  {
+    lock_guard<mutex> g(m_mutex);
+    m_stopped = true;
+  }
+  if (m_thread.joinable()) {
+    const uint64_t one = 1;
+    if (write(m_wakeFd, &one, sizeof(one)) < 0) {
+      LOG_GENERAL(WARNING, "Cannot wake the async sender");
+    }
+    m_thread.join();
+  }
+
+  for (auto& entry : m_active) {
+    CloseSocket(entry.first);
+  }
+  if (m_wakeFd >= 0) {
+    close(m_wakeFd);
+  }
+  if (m_epollFd >= 0) {
+    close(m_epollFd);
+  }
+}
+
+void AsyncSender::Send(const Peer& peer, const vector<FramePtr>& frames,
+                       const Callback& callback) {
+  unique_ptr<Request> request(new Request);
+  request->m_peer = peer;
+  request->m_frames = frames;
+  request->m_callback = callback;
+  {
+    lock_guard<mutex> g(m_mutex);
+    if (m_stopped) {
+      return;
+    }
+    m_submitted.push_back(move(request));
+  }
+
+  const uint64_t one = 1;
+  if (write(m_wakeFd, &one, sizeof(one)) < 0) {
+    LOG_GENERAL(WARNING, "Cannot wake the async sender");
+  }
+}
+
+void AsyncSender::Loop() {
+  struct epoll_event events[MAX_EVENTS];
+  vector<unique_ptr<Request>> submitted;
+
+  while (true) {
+    int timeout = -1;
+    if (!m_retryAt.empty()) {
+      timeout = max<int64_t>(
+          0, chrono::duration_cast<chrono::milliseconds>(
+                 m_retryAt.begin()->first - Clock::now())
+                     .count() +
+                 1);
+    }
+
+    const int n = epoll_wait(m_epollFd, events, MAX_EVENTS, timeout);
+    if (n < 0 && errno != EINTR) {
+      LOG_GENERAL(WARNING, "epoll_wait failed: " << std::strerror(errno));
+      return;
+    }
+
+    for (int i = 0; i < n; i++) {
+      if (events[i].data.ptr == nullptr) {
+        uint64_t count;
+        if (read(m_wakeFd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+          LOG_GENERAL(WARNING, "Cannot read the wake up of the async sender");
+        }
+        continue;
+      }
+      OnReady(static_cast<Request*>(events[i].data.ptr));
+    }
+
+    {
+      lock_guard<mutex> g(m_mutex);
+      if (m_stopped) {
+        return;
+      }
+      submitted.swap(m_submitted);
+    }
+    for (auto& request : submitted) {
+      Request* raw = request.get();
+      m_active.emplace(raw, move(request));
+      Start(raw);
+    }
+    submitted.clear();
+
+    const auto now = Clock::now();
+    while (!m_retryAt.empty() && m_retryAt.begin()->first <= now) {
+      Request* request = m_retryAt.begin()->second;
+      m_retryAt.erase(m_retryAt.begin());
+      Start(request);
+    }
+  }
+}
+
+void AsyncSender::Start(Request* request) {
+  const Peer& peer = request->m_peer;
+
+  request->m_iov.clear();
+  for (const auto& frame : request->m_frames) {
+    request->m_iov.push_back(
+        {const_cast<unsigned char*>(frame->GetHeader().data()),
+         frame->GetHeader().size()});
+    request->m_iov.push_back(
+        {const_cast<unsigned char*>(frame->GetBody().data()),
+         frame->GetBody().size()});
+  }
+  request->m_iovIndex = 0;
+
+  request->m_fd =
+      socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (request->m_fd < 0) {
+    Fail(request);
+    return;
+  }
+
+  struct sockaddr_in serv_addr {};
+  serv_addr.sin_family = AF_INET;
+  serv_addr.sin_addr.s_addr = peer.m_ipAddress.convert_to<unsigned long>();
+  serv_addr.sin_port = htons(peer.m_listenPortHost);
+
+  request->m_connecting = false;
+  if (connect(request->m_fd, (struct sockaddr*)&serv_addr,
+              sizeof(serv_addr)) < 0) {
+    if (errno != EINPROGRESS) {
+      Fail(request);
+      return;
+    }
+    request->m_connecting = true;
+  }
+
+  struct epoll_event event {};
+  event.events = EPOLLOUT;
+  event.data.ptr = request;
+  if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, request->m_fd, &event) < 0) {
+    Fail(request);
+  }
+}
+
+void AsyncSender::OnReady(Request* request) {
+  if (request->m_connecting) {
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(request->m_fd, SOL_SOCKET, SO_ERROR, &error, &length) < 0 ||
+        error != 0) {
+      errno = error;
+      Fail(request);
+      return;
+    }
+    request->m_connecting = false;
+  }
+
+  auto& iov = request->m_iov;
+  while (request->m_iovIndex < iov.size()) {
+    struct msghdr msg {};
+    msg.msg_iov = iov.data() + request->m_iovIndex;
+    msg.msg_iovlen = min<size_t>(iov.size() - request->m_iovIndex, IOV_MAX);
+    const ssize_t n = sendmsg(request->m_fd, &msg, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // Written again once the socket has room
+        return;
+      }
+      Fail(request);
+      return;
+    }
+
+    // Move past the part that has been written
+    size_t advance = n;
+    while (request->m_iovIndex < iov.size() &&
+           advance >= iov[request->m_iovIndex].iov_len) {
+      advance -= iov[request->m_iovIndex].iov_len;
+      request->m_iovIndex++;
+    }
+    if (request->m_iovIndex < iov.size()) {
+      iov[request->m_iovIndex].iov_base =
+          static_cast<unsigned char*>(iov[request->m_iovIndex].iov_base) +
+          advance;
+      iov[request->m_iovIndex].iov_len -= advance;
+    }
+  }
+
+  Finish(request, true);
+}
+
+void AsyncSender::Fail(Request* request) {
+  const int error = errno;
+  CloseSocket(request);
+  BlacklistOnError(error, request->m_peer);
+
+  if (Blacklist::GetInstance().Exist(request->m_peer.m_ipAddress)) {
+    Finish(request, false);
+    return;
+  }
+
+  LOG_GENERAL(WARNING, "Socket connect failed " << request->m_retries << "/"
+                                                << m_maxRetries
+                                                << ". IP address: "
+                                                << request->m_peer);
+  if (++request->m_retries > m_maxRetries) {
+    LOG_GENERAL(WARNING,
+                "Socket connect failed over " << m_maxRetries << " times.");
+    Finish(request, false);
+    return;
+  }
+  m_retryAt.emplace(
+      Clock::now() + chrono::milliseconds(rand() % m_retryDelayInMs + 1),
+      request);
+}
+
+void AsyncSender::Finish(Request* request, bool result) {
+  CloseSocket(request);
+  auto it = m_active.find(request);
+  if (it == m_active.end()) {
+    return;
+  }
+  auto owned = move(it->second);
+  m_active.erase(it);
+  if (owned->m_callback) {
+    owned->m_callback(result);
+  }
+}
+
+void AsyncSender::CloseSocket(Request* request) {
+  if (request->m_fd >= 0) {
+    // Closing also takes the socket out of the epoll set
+    shutdown(request->m_fd, SHUT_RDWR);
+    close(request->m_fd);
+    request->m_fd = -1;
+  }
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_ASYNCSENDER_H_
+#define ZILLIQA_SRC_LIBNETWORK_ASYNCSENDER_H_
+
+#include <sys/uio.h>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Peer.h"
+
+class MessageFrame;
+
+/// Writes messages on non-blocking sockets from a single thread, so that many
+/// large sends can be in flight without holding a thread each. Every send
+/// connects on its own socket, and is retried from scratch on failure like a
+/// blocking send. Callbacks are run on the sending thread.
+class AsyncSender {
+ public:
+  using FramePtr = std::shared_ptr<const MessageFrame>;
+  using Callback = std::function<void(bool)>;
+  using Clock = std::chrono::steady_clock;
+
+ private:
+  struct Request {
+    Peer m_peer;
+    std::vector<FramePtr> m_frames;
+    Callback m_callback;
+    int m_fd{-1};
+    bool m_connecting{false};
+    std::vector<struct iovec> m_iov;
+    size_t m_iovIndex{0};
+    unsigned int m_retries{0};
+  };
+
+  const unsigned int m_maxRetries;
+  const unsigned int m_retryDelayInMs;
+
+  int m_epollFd{-1};
+  int m_wakeFd{-1};
+
+  std::mutex m_mutex;
+  std::vector<std::unique_ptr<Request>> m_submitted;
+  bool m_stopped{false};
+
+  // Only touched by the sending thread
+  std::map<Request*, std::unique_ptr<Request>> m_active;
+  std::multimap<Clock::time_point, Request*> m_retryAt;
+
+  std::thread m_thread;
+
+  void Loop();
+  void Start(Request* request);
+  void OnReady(Request* request);
+  void Fail(Request* request);
+  void Finish(Request* request, bool result);
+  void CloseSocket(Request* request);
+
+ public:
+  AsyncSender(unsigned int maxRetries, unsigned int retryDelayInMs);
+  ~AsyncSender();
+
+  AsyncSender(AsyncSender const&) = delete;
+  void operator=(AsyncSender const&) = delete;
+
+  /// Returns whether the sender could set up its thread.
+  bool IsRunning() const { return m_thread.joinable(); }
+
+  /// Queues the frames to be written to peer on one connection. The callback
+  /// is told whether they were all written, unless the sender is destroyed
+  /// first.
+  void Send(const Peer& peer, const std::vector<FramePtr>& frames,
+            const Callback& callback);
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_ASYNCSENDER_H_
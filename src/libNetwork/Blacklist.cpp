@@ -30,15 +30,20 @@ Blacklist& Blacklist::GetInstance() {
   return blacklist;
 }
 
+Blacklist::Shard& Blacklist::GetShard(const uint128_t& ip) {
+  return m_shards[hash<uint128_t>()(ip) % NUM_SHARDS];
+}
+
 /// P2PComm may use this function
 bool Blacklist::Exist(const uint128_t& ip, const bool strict) {
-  if (!m_enabled) {
+  if (!m_enabled || m_size == 0) {
     return false;
   }
 
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  const auto& bl = m_blacklistIP.find(ip);
-  if (bl != m_blacklistIP.end()) {
+  Shard& shard = GetShard(ip);
+  shared_lock<shared_timed_mutex> g(shard.m_mutex);
+  const auto& bl = shard.m_blacklistIP.find(ip);
+  if (bl != shard.m_blacklistIP.end()) {
     if (strict) {
       // always return exist when strict, must be checked while sending message
       return true;
@@ -55,16 +60,20 @@ void Blacklist::Add(const uint128_t& ip, const bool strict) {
     return;
   }
 
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  if (m_whitelistedIP.end() == m_whitelistedIP.find(ip)) {
-    const auto& res = m_blacklistIP.emplace(ip, strict);
-    // already existed, then over-ride strictness i.e. false by true
-    if (!res.second && strict) {
-      res.first->second = strict;
-    }
-  } else {
+  if (IsWhitelistedIP(ip)) {
     LOG_GENERAL(INFO,
                 "Whitelisted IP: " << IPConverter::ToStrFromNumericalIP(ip));
+    return;
+  }
+
+  Shard& shard = GetShard(ip);
+  lock_guard<shared_timed_mutex> g(shard.m_mutex);
+  const auto& res = shard.m_blacklistIP.emplace(ip, strict);
+  if (res.second) {
+    m_size++;
+  } else if (strict) {
+    // already existed, then over-ride strictness i.e. false by true
+    res.first->second = strict;
   }
 }
 
@@ -74,14 +83,18 @@ void Blacklist::Remove(const uint128_t& ip) {
     return;
   }
 
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  m_blacklistIP.erase(ip);
+  Shard& shard = GetShard(ip);
+  lock_guard<shared_timed_mutex> g(shard.m_mutex);
+  m_size -= shard.m_blacklistIP.erase(ip);
 }
 
 /// Reputation Manager may use this function
 void Blacklist::Clear() {
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  m_blacklistIP.clear();
+  for (auto& shard : m_shards) {
+    lock_guard<shared_timed_mutex> g(shard.m_mutex);
+    m_size -= shard.m_blacklistIP.size();
+    shard.m_blacklistIP.clear();
+  }
   LOG_GENERAL(INFO, "Blacklist cleared");
 }
 
@@ -90,26 +103,27 @@ void Blacklist::Pop(unsigned int num_to_pop) {
     return;
   }
 
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  LOG_GENERAL(INFO, "Num of nodes in blacklist: " << m_blacklistIP.size());
+  LOG_GENERAL(INFO, "Num of nodes in blacklist: " << m_size);
 
   unsigned int counter = 0;
-  for (auto it = m_blacklistIP.begin(); it != m_blacklistIP.end();) {
-    if (counter < num_to_pop) {
-      it = m_blacklistIP.erase(it);
-      counter++;
-    } else {
+  for (auto& shard : m_shards) {
+    if (counter >= num_to_pop) {
       break;
     }
+
+    lock_guard<shared_timed_mutex> g(shard.m_mutex);
+    for (auto it = shard.m_blacklistIP.begin();
+         it != shard.m_blacklistIP.end() && counter < num_to_pop;) {
+      it = shard.m_blacklistIP.erase(it);
+      m_size--;
+      counter++;
+    }
   }
 
   LOG_GENERAL(INFO, "Removed " << counter << " nodes from blacklist");
 }
 
-unsigned int Blacklist::SizeOfBlacklist() {
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  return m_blacklistIP.size();
-}
+unsigned int Blacklist::SizeOfBlacklist() { return m_size; }
 
 void Blacklist::Enable(const bool enable) {
   if (!enable) {
@@ -123,7 +137,7 @@ bool Blacklist::Whitelist(const uint128_t& ip) {
   if (!m_enabled) {
     return false;
   }
-  lock_guard<mutex> g(m_mutexBlacklistIP);
+  lock_guard<shared_timed_mutex> g(m_mutexWhitelistIP);
   return m_whitelistedIP.emplace(ip).second;
 }
 
@@ -131,11 +145,11 @@ bool Blacklist::RemoveFromWhitelist(const uint128_t& ip) {
   if (!m_enabled) {
     return false;
   }
-  lock_guard<mutex> g(m_mutexBlacklistIP);
+  lock_guard<shared_timed_mutex> g(m_mutexWhitelistIP);
   return (m_whitelistedIP.erase(ip) > 0);
 }
 
 bool Blacklist::IsWhitelistedIP(const uint128_t& ip) {
-  lock_guard<mutex> g(m_mutexBlacklistIP);
+  shared_lock<shared_timed_mutex> g(m_mutexWhitelistIP);
   return m_whitelistedIP.end() != m_whitelistedIP.find(ip);
 }
@@ -18,9 +18,11 @@
 #ifndef ZILLIQA_SRC_LIBNETWORK_BLACKLIST_H_
 #define ZILLIQA_SRC_LIBNETWORK_BLACKLIST_H_
 
+#include <array>
 #include <atomic>
 #include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <unordered_map>
 
 #include "common/BaseType.h"
@@ -29,7 +31,11 @@ namespace std {
 template <>
 struct hash<uint128_t> {
   std::size_t operator()(const uint128_t& key) const {
-    return std::hash<std::string>()(key.convert_to<std::string>());
+    // Mix both halves so that addresses sharing a prefix spread out
+    uint64_t h = static_cast<uint64_t>(key) ^
+                 (static_cast<uint64_t>(key >> 64) * 0xC2B2AE3D27D4EB4FULL);
+    h *= 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 32);
   }
 };
 }  // namespace std
@@ -42,14 +48,28 @@ class Blacklist {
   Blacklist(Blacklist const&) = delete;
   void operator=(Blacklist const&) = delete;
 
-  std::mutex m_mutexBlacklistIP;
-  std::unordered_map<uint128_t, bool>
-      m_blacklistIP;  // IP <-> Strict/Relaxed
-                      // Strict -> Blacklisted for both sending and incoming msg
-                      // Relaxed -> Blacklisted for incoming msg only
+  static const unsigned int NUM_SHARDS = 16;
+
+  // The IP space is split over independently locked shards, so lookups on
+  // the accept path only share a lock with writers touching the same shard
+  struct Shard {
+    std::shared_timed_mutex m_mutex;
+    std::unordered_map<uint128_t, bool>
+        m_blacklistIP;  // IP <-> Strict/Relaxed
+                        // Strict -> Blacklisted for both sending and incoming
+                        // msg
+                        // Relaxed -> Blacklisted for incoming msg only
+  };
+
+  std::array<Shard, NUM_SHARDS> m_shards;
+  std::atomic<unsigned int> m_size{0};
+
+  std::shared_timed_mutex m_mutexWhitelistIP;
   std::set<uint128_t> m_whitelistedIP;
   std::atomic<bool> m_enabled;
 
+  Shard& GetShard(const uint128_t& ip);
+
  public:
   static Blacklist& GetInstance();
 
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "BroadcastHashFilter.h"
+
+using namespace std;
+
+BroadcastHashFilter::BroadcastHashFilter(unsigned int intervalInSeconds,
+                                         unsigned int expiryInSeconds)
+    : m_interval(max(intervalInSeconds, 1u)), m_start(Clock::now()) {
+  // One bucket being filled plus enough full buckets to cover the expiry
+  const unsigned int numBuckets =
+      (expiryInSeconds + m_interval.count() - 1) / m_interval.count() + 1;
+
+  for (auto& stripe : m_stripes) {
+    stripe.m_buckets.resize(numBuckets);
+  }
+}
+
+uint64_t BroadcastHashFilter::GetSlot(const Clock::time_point& now) const {
+  if (now <= m_start) {
+    return 1;
+  }
+  // Slot 0 is reserved for buckets that were never used
+  return (now - m_start) / m_interval + 1;
+}
+
+bool BroadcastHashFilter::ToDigest(const bytes& hash, Digest& digest) {
+  if (hash.size() != DIGEST_SIZE) {
+    return false;
+  }
+  copy(hash.begin(), hash.end(), digest.begin());
+  return true;
+}
+
+bool BroadcastHashFilter::ContainsInStripe(const Stripe& stripe,
+                                           const Digest& digest,
+                                           uint64_t slot) const {
+  const uint64_t numBuckets = stripe.m_buckets.size();
+
+  for (const auto& bucket : stripe.m_buckets) {
+    if ((bucket.m_slot == 0) || (bucket.m_slot + numBuckets <= slot)) {
+      // Never used or expired
+      continue;
+    }
+    if (bucket.m_hashes.find(digest) != bucket.m_hashes.end()) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool BroadcastHashFilter::Insert(const bytes& hash,
+                                 const Clock::time_point& now) {
+  Digest digest;
+  if (!ToDigest(hash, digest)) {
+    return false;
+  }
+
+  const uint64_t slot = GetSlot(now);
+  Stripe& stripe = m_stripes[digest[0] % NUM_STRIPES];
+  lock_guard<mutex> g(stripe.m_mutex);
+
+  if (ContainsInStripe(stripe, digest, slot)) {
+    return false;
+  }
+
+  Bucket& bucket = stripe.m_buckets[slot % stripe.m_buckets.size()];
+  if (bucket.m_slot != slot) {
+    // Whatever this bucket held has expired
+    bucket.m_hashes.clear();
+    bucket.m_slot = slot;
+  }
+  bucket.m_hashes.insert(digest);
+
+  return true;
+}
+
+bool BroadcastHashFilter::Contains(const bytes& hash,
+                                   const Clock::time_point& now) {
+  Digest digest;
+  if (!ToDigest(hash, digest)) {
+    return false;
+  }
+
+  Stripe& stripe = m_stripes[digest[0] % NUM_STRIPES];
+  lock_guard<mutex> g(stripe.m_mutex);
+  return ContainsInStripe(stripe, digest, GetSlot(now));
+}
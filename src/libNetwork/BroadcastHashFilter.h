@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_BROADCASTHASHFILTER_H_
+#define ZILLIQA_SRC_LIBNETWORK_BROADCASTHASHFILTER_H_
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "common/BaseType.h"
+
+/// Remembers the hashes of recently seen broadcast messages.
+/// Hashes are kept in a ring of time buckets, each covering one interval. A
+/// bucket is dropped as a whole once it falls out of the expiry window, and
+/// the hash space is split over independently locked stripes.
+class BroadcastHashFilter {
+ public:
+  static const unsigned int DIGEST_SIZE = 32;
+  using Digest = std::array<unsigned char, DIGEST_SIZE>;
+  using Clock = std::chrono::steady_clock;
+
+ private:
+  static const unsigned int NUM_STRIPES = 16;
+
+  struct DigestHash {
+    std::size_t operator()(const Digest& d) const {
+      // The digest is already uniformly distributed
+      std::size_t h;
+      std::memcpy(&h, d.data() + DIGEST_SIZE - sizeof(h), sizeof(h));
+      return h;
+    }
+  };
+
+  struct Bucket {
+    uint64_t m_slot{0};
+    std::unordered_set<Digest, DigestHash> m_hashes;
+  };
+
+  struct Stripe {
+    std::mutex m_mutex;
+    std::vector<Bucket> m_buckets;
+  };
+
+  std::array<Stripe, NUM_STRIPES> m_stripes;
+  const std::chrono::seconds m_interval;
+  const Clock::time_point m_start;
+
+  uint64_t GetSlot(const Clock::time_point& now) const;
+  bool ContainsInStripe(const Stripe& stripe, const Digest& digest,
+                        uint64_t slot) const;
+  static bool ToDigest(const bytes& hash, Digest& digest);
+
+ public:
+  /// Hashes are retained for at least expiryInSeconds and at most one extra
+  /// intervalInSeconds.
+  BroadcastHashFilter(unsigned int intervalInSeconds,
+                      unsigned int expiryInSeconds);
+
+  /// Adds the hash. Returns false if it was already present (or malformed).
+  bool Insert(const bytes& hash, const Clock::time_point& now = Clock::now());
+
+  /// Checks if the hash was seen within the expiry window.
+  bool Contains(const bytes& hash, const Clock::time_point& now = Clock::now());
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_BROADCASTHASHFILTER_H_
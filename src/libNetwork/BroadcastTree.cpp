@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+
+#include "BroadcastTree.h"
+
+using namespace std;
+
+namespace BroadcastTree {
+
+uint32_t GetRegion(const Peer& peer, unsigned int prefixBits) {
+  if (prefixBits == 0) {
+    return 0;
+  }
+  prefixBits = min(prefixBits, 32u);
+
+  // The first octet of the address is in the lowest byte
+  const uint32_t netIp =
+      (peer.GetIpAddress() & 0xFFFFFFFF).convert_to<uint32_t>();
+  const uint32_t hostIp = ((netIp & 0xFF) << 24) | ((netIp & 0xFF00) << 8) |
+                          ((netIp >> 8) & 0xFF00) | (netIp >> 24);
+  return prefixBits == 32 ? hostIp : hostIp >> (32 - prefixBits);
+}
+
+vector<uint32_t> GetTreeOrder(const vector<uint32_t>& regions,
+                              uint32_t clusterSize, uint32_t childClusters) {
+  const uint32_t count = regions.size();
+  vector<uint32_t> order(count);
+  iota(order.begin(), order.end(), 0);
+  // A single region keeps the plain index arithmetic
+  if (clusterSize == 0 || count <= clusterSize ||
+      all_of(regions.begin(), regions.end(),
+             [&regions](uint32_t region) { return region == regions[0]; })) {
+    return order;
+  }
+
+  vector<uint32_t> sorted(order.begin() + clusterSize, order.end());
+  stable_sort(sorted.begin(), sorted.end(),
+              [&regions](uint32_t a, uint32_t b) {
+                return regions[a] < regions[b];
+              });
+
+  // Visit the clusters depth-first, filling each one below the first with
+  // the next sorted nodes. Only the last cluster can be short.
+  const uint32_t clusterCount = (count + clusterSize - 1) / clusterSize;
+  auto next = sorted.begin();
+  vector<uint32_t> pending{0};
+  while (!pending.empty()) {
+    const uint32_t cluster = pending.back();
+    pending.pop_back();
+
+    if (cluster > 0) {
+      const uint32_t lo = cluster * clusterSize;
+      const uint32_t hi = min(lo + clusterSize, count);
+      copy(next, next + (hi - lo), order.begin() + lo);
+      next += hi - lo;
+    }
+
+    // Pushed last to first so that the first child is visited next
+    const uint64_t firstChild = (uint64_t)cluster * childClusters + 1;
+    for (uint64_t child = min<uint64_t>(firstChild + childClusters - 1,
+                                        clusterCount - 1);
+         child >= firstChild; child--) {
+      pending.push_back(child);
+    }
+  }
+  return order;
+}
+
+vector<uint32_t> GetInterleavedOrder(const vector<uint32_t>& regions) {
+  map<uint32_t, vector<uint32_t>> byRegion;
+  for (uint32_t i = 0; i < regions.size(); i++) {
+    byRegion[regions[i]].push_back(i);
+  }
+
+  vector<uint32_t> order;
+  order.reserve(regions.size());
+  for (size_t round = 0; order.size() < regions.size(); round++) {
+    for (const auto& region : byRegion) {
+      if (round < region.second.size()) {
+        order.push_back(region.second[round]);
+      }
+    }
+  }
+  return order;
+}
+
+}  // namespace BroadcastTree
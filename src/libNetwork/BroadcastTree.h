@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_BROADCASTTREE_H_
+#define ZILLIQA_SRC_LIBNETWORK_BROADCASTTREE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "Peer.h"
+
+/// Orders the nodes of a committee for the block forwarding trees. The order
+/// only depends on the committee and its IPs, so that every node computes the
+/// same tree. Peers sharing the leading IPv4 bits are taken to be in the same
+/// region.
+namespace BroadcastTree {
+
+/// Returns the region of the peer, i.e. the leading prefixBits bits of its
+/// IPv4 address, or 0 for every peer if prefixBits is 0.
+uint32_t GetRegion(const Peer& peer, unsigned int prefixBits);
+
+/// Returns the node index at each position of the tree built over clusters
+/// of clusterSize nodes, where cluster c forwards to clusters c * childClusters
+/// + 1 to (c + 1) * childClusters. The first cluster keeps the first nodes.
+/// The other nodes are sorted by region and laid out on the clusters in
+/// depth-first order, so that a subtree holds nodes of as few regions as
+/// possible and most forwarding stays within a region. With a single region
+/// the order is the index order.
+std::vector<uint32_t> GetTreeOrder(const std::vector<uint32_t>& regions,
+                                   uint32_t clusterSize,
+                                   uint32_t childClusters);
+
+/// Returns the node indices taking one node of each region in turn, so that
+/// consecutive nodes are spread over the regions.
+std::vector<uint32_t> GetInterleavedOrder(
+    const std::vector<uint32_t>& regions);
+
+}  // namespace BroadcastTree
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_BROADCASTTREE_H_
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <mutex>
+
+#include "ConnectionCounter.h"
+
+using namespace std;
+
+ConnectionCounter::ConnectionCounter(const unsigned int numStripes)
+    : m_stripes(max(numStripes, 1u)) {}
+
+ConnectionCounter::Stripe& ConnectionCounter::GetStripe(const uint128_t& ip) {
+  return m_stripes[IPHash()(ip) % m_stripes.size()];
+}
+
+const ConnectionCounter::Stripe& ConnectionCounter::GetStripe(
+    const uint128_t& ip) const {
+  return m_stripes[IPHash()(ip) % m_stripes.size()];
+}
+
+bool ConnectionCounter::TryAdd(const uint128_t& ip,
+                               unsigned int maxConnections) {
+  auto tryIncrement = [maxConnections](Counter& counter) {
+    unsigned int count = counter.m_count;
+    while (count <= maxConnections) {
+      if (counter.m_count.compare_exchange_weak(count, count + 1)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  Stripe& stripe = GetStripe(ip);
+  {
+    shared_lock<shared_timed_mutex> g(stripe.m_mutex);
+    auto it = stripe.m_counters.find(ip);
+    if (it != stripe.m_counters.end()) {
+      return tryIncrement(it->second);
+    }
+  }
+
+  // First connection from ip since the last Clear
+  unique_lock<shared_timed_mutex> g(stripe.m_mutex);
+  return tryIncrement(stripe.m_counters[ip]);
+}
+
+void ConnectionCounter::Remove(const uint128_t& ip) {
+  Stripe& stripe = GetStripe(ip);
+  shared_lock<shared_timed_mutex> g(stripe.m_mutex);
+  auto it = stripe.m_counters.find(ip);
+  if (it == stripe.m_counters.end()) {
+    return;
+  }
+  auto& count = it->second.m_count;
+  unsigned int current = count;
+  while (current > 0 && !count.compare_exchange_weak(current, current - 1)) {
+  }
+}
+
+unsigned int ConnectionCounter::Get(const uint128_t& ip) const {
+  const Stripe& stripe = GetStripe(ip);
+  shared_lock<shared_timed_mutex> g(stripe.m_mutex);
+  auto it = stripe.m_counters.find(ip);
+  return it == stripe.m_counters.end() ? 0 : it->second.m_count.load();
+}
+
+void ConnectionCounter::Clear() {
+  for (auto& stripe : m_stripes) {
+    unique_lock<shared_timed_mutex> g(stripe.m_mutex);
+    stripe.m_counters.clear();
+  }
+}
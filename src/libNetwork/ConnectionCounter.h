@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_CONNECTIONCOUNTER_H_
+#define ZILLIQA_SRC_LIBNETWORK_CONNECTIONCOUNTER_H_
+
+#include <atomic>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/BaseType.h"
+
+/// Counts the open incoming connections of each IP address. The addresses are
+/// split over independently locked stripes, and the count of an address that
+/// has been seen already is changed atomically under a shared lock, so
+/// connections from different addresses never wait for one another.
+class ConnectionCounter {
+  struct Counter {
+    std::atomic<unsigned int> m_count{0};
+  };
+
+  struct IPHash {
+    std::size_t operator()(const uint128_t& ip) const {
+      return std::hash<uint64_t>()(static_cast<uint64_t>(ip));
+    }
+  };
+
+  struct Stripe {
+    mutable std::shared_timed_mutex m_mutex;
+    std::unordered_map<uint128_t, Counter, IPHash> m_counters;
+  };
+
+  std::vector<Stripe> m_stripes;
+
+  Stripe& GetStripe(const uint128_t& ip);
+  const Stripe& GetStripe(const uint128_t& ip) const;
+
+ public:
+  explicit ConnectionCounter(const unsigned int numStripes = 64);
+
+  /// Counts one more connection from ip, unless it already has more than
+  /// maxConnections. Returns whether the connection was counted.
+  bool TryAdd(const uint128_t& ip, unsigned int maxConnections);
+
+  /// Counts one connection less from ip, never going below zero.
+  void Remove(const uint128_t& ip);
+
+  /// Returns the connections counted for ip.
+  unsigned int Get(const uint128_t& ip) const;
+
+  /// Forgets the counts of all addresses.
+  void Clear();
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_CONNECTIONCOUNTER_H_
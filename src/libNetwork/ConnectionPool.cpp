@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "ConnectionPool.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+ConnectionPool::ConnectionPool(unsigned int maxPerPeer,
+                               unsigned int idleTimeoutInSeconds,
+                               unsigned int waitTimeoutInMilliseconds)
+    : m_maxPerPeer(max(maxPerPeer, 1u)),
+      m_idleTimeout(idleTimeoutInSeconds),
+      m_waitTimeout(waitTimeoutInMilliseconds) {}
+
+ConnectionPool::~ConnectionPool() { Clear(); }
+
+void ConnectionPool::CloseSocket(int fd) {
+  shutdown(fd, SHUT_RDWR);
+  close(fd);
+}
+
+bool ConnectionPool::IsHealthy(int fd) {
+  // The remote side never writes back to us, so any readable state means the
+  // connection was closed (recv returns 0) or is in error
+  unsigned char buf;
+  ssize_t n = recv(fd, &buf, 1, MSG_PEEK | MSG_DONTWAIT);
+  if (n < 0) {
+    return (errno == EAGAIN || errno == EWOULDBLOCK);
+  }
+  return false;
+}
+
+int ConnectionPool::Acquire(const Peer& peer) {
+  unique_lock<mutex> lock(m_mutex);
+  PeerSockets& sockets = m_sockets[peer];
+
+  if (sockets.m_inUse >= m_maxPerPeer) {
+    if (!m_cv.wait_for(lock, m_waitTimeout, [this, &sockets]() {
+          return sockets.m_inUse < m_maxPerPeer;
+        })) {
+      LOG_GENERAL(INFO, "All " << m_maxPerPeer << " connections to " << peer
+                               << " are busy, opening an extra one");
+    }
+  }
+
+  sockets.m_inUse++;
+
+  const auto now = chrono::steady_clock::now();
+  while (!sockets.m_idle.empty()) {
+    IdleSocket idle = sockets.m_idle.back();
+    sockets.m_idle.pop_back();
+
+    if ((now - idle.m_lastUsed) < m_idleTimeout && IsHealthy(idle.m_fd)) {
+      return idle.m_fd;
+    }
+
+    CloseSocket(idle.m_fd);
+  }
+
+  return -1;
+}
+
+void ConnectionPool::Release(const Peer& peer, int fd, bool reusable) {
+  {
+    lock_guard<mutex> g(m_mutex);
+    PeerSockets& sockets = m_sockets[peer];
+
+    if (sockets.m_inUse > 0) {
+      sockets.m_inUse--;
+    }
+
+    if (fd >= 0) {
+      if (reusable && sockets.m_idle.size() < m_maxPerPeer) {
+        sockets.m_idle.push_back({fd, chrono::steady_clock::now()});
+      } else {
+        CloseSocket(fd);
+      }
+    }
+  }
+
+  m_cv.notify_all();
+}
+
+void ConnectionPool::CloseExpired() {
+  lock_guard<mutex> g(m_mutex);
+  const auto expiry = chrono::steady_clock::now() - m_idleTimeout;
+
+  for (auto it = m_sockets.begin(); it != m_sockets.end();) {
+    auto& idle = it->second.m_idle;
+
+    // Idle sockets are ordered by last use, so expired ones are at the front
+    while (!idle.empty() && idle.front().m_lastUsed <= expiry) {
+      CloseSocket(idle.front().m_fd);
+      idle.pop_front();
+    }
+
+    if (idle.empty() && it->second.m_inUse == 0) {
+      it = m_sockets.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void ConnectionPool::Clear() {
+  lock_guard<mutex> g(m_mutex);
+
+  for (auto& entry : m_sockets) {
+    for (const auto& idle : entry.second.m_idle) {
+      CloseSocket(idle.m_fd);
+    }
+    entry.second.m_idle.clear();
+  }
+}
+
+unsigned int ConnectionPool::IdleCount(const Peer& peer) {
+  lock_guard<mutex> g(m_mutex);
+  const auto& it = m_sockets.find(peer);
+  return (it == m_sockets.end()) ? 0 : it->second.m_idle.size();
+}
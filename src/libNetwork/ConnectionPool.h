@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_CONNECTIONPOOL_H_
+#define ZILLIQA_SRC_LIBNETWORK_CONNECTIONPOOL_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+
+#include "Peer.h"
+
+/// Keeps outgoing TCP connections open per peer so that repeated sends to the
+/// same peer can reuse a warm socket instead of reconnecting every time.
+class ConnectionPool {
+  struct IdleSocket {
+    int m_fd;
+    std::chrono::time_point<std::chrono::steady_clock> m_lastUsed;
+  };
+
+  struct PeerSockets {
+    std::deque<IdleSocket> m_idle;  // most recently used at the back
+    unsigned int m_inUse{0};
+  };
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::map<Peer, PeerSockets> m_sockets;
+
+  unsigned int m_maxPerPeer;
+  std::chrono::seconds m_idleTimeout;
+  std::chrono::milliseconds m_waitTimeout;
+
+  static bool IsHealthy(int fd);
+  static void CloseSocket(int fd);
+
+ public:
+  ConnectionPool(unsigned int maxPerPeer, unsigned int idleTimeoutInSeconds,
+                 unsigned int waitTimeoutInMilliseconds);
+  ~ConnectionPool();
+
+  // Pool owns socket descriptors, so it should not be copied
+  ConnectionPool(ConnectionPool const&) = delete;
+  void operator=(ConnectionPool const&) = delete;
+
+  /// Reserves a connection slot for the peer and returns a healthy idle socket
+  /// if one is available, or -1 if the caller needs to open a new one. Blocks
+  /// for up to the wait timeout while the peer already has the maximum number
+  /// of sockets in use. Every call must be paired with Release().
+  int Acquire(const Peer& peer);
+
+  /// Returns the slot reserved by Acquire(). The socket is kept for reuse if
+  /// reusable is true and the peer's idle list is not full, otherwise it is
+  /// closed. Pass fd = -1 if no socket was opened.
+  void Release(const Peer& peer, int fd, bool reusable);
+
+  /// Closes idle sockets that exceeded the idle timeout.
+  void CloseExpired();
+
+  /// Closes all idle sockets.
+  void Clear();
+
+  /// Number of idle sockets currently held for the peer.
+  unsigned int IdleCount(const Peer& peer);
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_CONNECTIONPOOL_H_
@@ -19,6 +19,7 @@
 
 #include "libCrypto/Sha2.h"
 #include "libNetwork/Blacklist.h"
+#include "libNetwork/BroadcastTree.h"
 #include "libNetwork/P2PComm.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/IPConverter.h"
@@ -113,6 +114,8 @@ void DataSender::DetermineShardToSendDataTo(unsigned int& my_cluster_num,
   //    ...
   //    cluster 0 => Shard (num of clusters)
   //    cluster 1 => Shard (num of clusters + 1)
+  // The committee is taken one region at a time, so that every cluster has
+  // members in as many regions as possible
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
                 "DataSender::DetermineShardToSendDataTo not "
@@ -136,7 +139,20 @@ void DataSender::DetermineShardToSendDataTo(unsigned int& my_cluster_num,
   }
   LOG_GENERAL(INFO, "Shard groups = " << shard_groups_count)
 
-  my_cluster_num = indexB2 / MULTICAST_CLUSTER_SIZE;
+  vector<uint32_t> regions;
+  regions.reserve(tmpCommittee.size());
+  for (uint32_t i = 0; i < tmpCommittee.size(); i++) {
+    // My own entry has no IP
+    const Peer& peer = i == indexB2 ? P2PComm::GetInstance().GetSelfPeer()
+                                    : tmpCommittee.at(i).second;
+    regions.push_back(
+        BroadcastTree::GetRegion(peer, BROADCAST_REGION_PREFIX_BITS));
+  }
+  const vector<uint32_t> order = BroadcastTree::GetInterleavedOrder(regions);
+  const uint32_t my_position =
+      find(order.begin(), order.end(), indexB2) - order.begin();
+
+  my_cluster_num = my_position / MULTICAST_CLUSTER_SIZE;
   my_shards_lo = my_cluster_num * shard_groups_count;
   my_shards_hi = my_shards_lo + shard_groups_count;
 
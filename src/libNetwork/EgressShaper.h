@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_EGRESSSHAPER_H_
+#define ZILLIQA_SRC_LIBNETWORK_EGRESSSHAPER_H_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+/// Token bucket of bytes shared by the outgoing messages of one class: up to
+/// burst bytes may leave at once, and bytesPerSecond are regained every
+/// second. A message larger than the burst leaves once the bucket is full,
+/// and the bucket goes into debt for the rest. A rate of 0 does not limit.
+class EgressShaper {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+ private:
+  const double m_bytesPerSecond;
+  const double m_burst;
+  std::mutex m_mutex;
+  double m_tokens;
+  Clock::time_point m_last;
+  std::atomic<uint64_t> m_throttled{0};
+
+ public:
+  EgressShaper(double bytesPerSecond, unsigned int burst)
+      : m_bytesPerSecond(bytesPerSecond),
+        m_burst(burst > 0 ? burst : 1),
+        m_tokens(m_burst),
+        m_last(Clock::now()) {}
+
+  EgressShaper(const EgressShaper&) = delete;
+  EgressShaper& operator=(const EgressShaper&) = delete;
+
+  bool IsEnabled() const { return m_bytesPerSecond > 0; }
+
+  /// Takes the tokens of a message of bytes, or returns false and sets wait to
+  /// the time until it may leave
+  bool TryTake(uint64_t bytes, Clock::duration& wait,
+               const Clock::time_point& now = Clock::now()) {
+    if (m_bytesPerSecond <= 0) {
+      return true;
+    }
+
+    std::lock_guard<std::mutex> g(m_mutex);
+    if (now > m_last) {
+      const double elapsed =
+          std::chrono::duration<double>(now - m_last).count();
+      m_tokens += elapsed * m_bytesPerSecond;
+      if (m_tokens > m_burst) {
+        m_tokens = m_burst;
+      }
+      m_last = now;
+    }
+
+    const double needed = bytes < m_burst ? bytes : m_burst;
+    if (m_tokens < needed) {
+      m_throttled++;
+      wait = std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>((needed - m_tokens) /
+                                        m_bytesPerSecond));
+      return false;
+    }
+    m_tokens -= bytes;
+    return true;
+  }
+
+  /// Returns the number of times a message had to wait
+  uint64_t GetThrottled() const { return m_throttled; }
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_EGRESSSHAPER_H_
@@ -23,6 +23,7 @@
 
 #include <Schnorr.h>
 #include "Peer.h"
+#include "libCrypto/PubKeyHash.h"
 #include "libMediator/Mediator.h"
 
 class Guard {
@@ -35,11 +36,11 @@ class Guard {
 
   // DS guardlist
   std::mutex m_mutexDSGuardList;
-  std::unordered_set<PubKey> m_DSGuardList;
+  PubKeyHashSet m_DSGuardList;
 
   // Shard guardlist
   std::mutex m_mutexShardGuardList;
-  std::unordered_set<PubKey> m_ShardGuardList;
+  PubKeyHashSet m_ShardGuardList;
 
   // IPFilter
   std::mutex m_mutexIPExclusion;
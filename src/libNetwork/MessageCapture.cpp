@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "MessageCapture.h"
+#include "common/Constants.h"
+#include "common/Serializable.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+const string MessageCapture::MAGIC = "ZILCAP01";
+const unsigned int MessageCapture::RECORD_HEADER_SIZE =
+    sizeof(uint64_t) + UINT128_SIZE + sizeof(uint32_t) + sizeof(uint32_t);
+
+bool MessageCaptureWriter::Open(const string& path) {
+  lock_guard<mutex> g(m_mutex);
+
+  m_file.open(path, ios::binary | ios::trunc);
+  if (!m_file.is_open()) {
+    LOG_GENERAL(WARNING, "Failed to create capture file " << path);
+    return false;
+  }
+  m_file.write(MessageCapture::MAGIC.data(), MessageCapture::MAGIC.size());
+  m_start = chrono::steady_clock::now();
+  m_records = 0;
+  LOG_GENERAL(INFO, "Capturing the incoming messages to " << path);
+  return m_file.good();
+}
+
+bool MessageCaptureWriter::IsOpen() {
+  lock_guard<mutex> g(m_mutex);
+  return m_file.is_open();
+}
+
+void MessageCaptureWriter::Record(const bytes& message, const Peer& from) {
+  bytes header;
+  header.reserve(MessageCapture::RECORD_HEADER_SIZE);
+
+  lock_guard<mutex> g(m_mutex);
+  if (!m_file.is_open()) {
+    return;
+  }
+
+  // Taken under the lock, so that the offsets never go backwards
+  const uint64_t offsetMicros =
+      chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() -
+                                                  m_start)
+          .count();
+  Serializable::SetNumber<uint64_t>(header, 0, offsetMicros, sizeof(uint64_t));
+  from.Serialize(header, sizeof(uint64_t));
+  Serializable::SetNumber<uint32_t>(header, header.size(), message.size(),
+                                    sizeof(uint32_t));
+
+  m_file.write(reinterpret_cast<const char*>(header.data()), header.size());
+  m_file.write(reinterpret_cast<const char*>(message.data()), message.size());
+  if (!m_file.good()) {
+    LOG_GENERAL(WARNING, "Failed to write to the capture file, stopping it");
+    m_file.close();
+    return;
+  }
+  ++m_records;
+}
+
+uint64_t MessageCaptureWriter::GetRecordCount() {
+  lock_guard<mutex> g(m_mutex);
+  return m_records;
+}
+
+bool MessageCaptureReader::Open(const string& path) {
+  m_file.open(path, ios::binary);
+  if (!m_file.is_open()) {
+    LOG_GENERAL(WARNING, "Failed to open capture file " << path);
+    return false;
+  }
+
+  string magic(MessageCapture::MAGIC.size(), '\0');
+  m_file.read(&magic[0], magic.size());
+  if (!m_file.good() || magic != MessageCapture::MAGIC) {
+    LOG_GENERAL(WARNING, path << " is not a capture file");
+    m_file.close();
+    return false;
+  }
+  return true;
+}
+
+bool MessageCaptureReader::Next(MessageCapture::Record& record) {
+  if (!m_file.is_open()) {
+    return false;
+  }
+
+  bytes header(MessageCapture::RECORD_HEADER_SIZE);
+  m_file.read(reinterpret_cast<char*>(header.data()), header.size());
+  if (m_file.gcount() == 0 && m_file.eof()) {
+    return false;
+  }
+  if (!m_file.good()) {
+    LOG_GENERAL(WARNING, "Capture file ends within a record header");
+    return false;
+  }
+
+  record.m_offsetMicros =
+      Serializable::GetNumber<uint64_t>(header, 0, sizeof(uint64_t));
+  if (record.m_from.Deserialize(header, sizeof(uint64_t)) != 0) {
+    return false;
+  }
+  const uint32_t length = Serializable::GetNumber<uint32_t>(
+      header, header.size() - sizeof(uint32_t), sizeof(uint32_t));
+  if (length > MAX_READ_WATERMARK_IN_BYTES) {
+    LOG_GENERAL(WARNING, "Capture record of " << length << " bytes is too big");
+    return false;
+  }
+
+  record.m_message.resize(length);
+  m_file.read(reinterpret_cast<char*>(record.m_message.data()), length);
+  if (static_cast<uint32_t>(m_file.gcount()) != length) {
+    LOG_GENERAL(WARNING, "Capture file ends within a record");
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_MESSAGECAPTURE_H_
+#define ZILLIQA_SRC_LIBNETWORK_MESSAGECAPTURE_H_
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#include "Peer.h"
+#include "common/BaseType.h"
+
+/// File of the messages a node received, in the order they were dispatched,
+/// so that a run can be fed to a node again offline. The file starts with
+/// MAGIC and holds one record per message: the microseconds since the capture
+/// started, the sender (as Peer::Serialize writes it), the message length and
+/// the message.
+struct MessageCapture {
+  static const std::string MAGIC;
+  static const unsigned int RECORD_HEADER_SIZE;
+
+  struct Record {
+    uint64_t m_offsetMicros{0};
+    Peer m_from;
+    bytes m_message;
+  };
+};
+
+/// Appends the messages given to Record to a capture file. Record may be
+/// called from several threads.
+class MessageCaptureWriter {
+  std::mutex m_mutex;
+  std::ofstream m_file;
+  std::chrono::steady_clock::time_point m_start;
+  uint64_t m_records{0};
+
+ public:
+  /// Creates (or truncates) the file and starts the clock of the capture.
+  bool Open(const std::string& path);
+
+  bool IsOpen();
+
+  void Record(const bytes& message, const Peer& from);
+
+  /// Returns the number of messages written so far.
+  uint64_t GetRecordCount();
+};
+
+/// Reads back the records of a capture file in order.
+class MessageCaptureReader {
+  std::ifstream m_file;
+
+ public:
+  /// Opens the file and checks its magic.
+  bool Open(const std::string& path);
+
+  /// Reads the next record. Returns false at the end of the file, or if the
+  /// record is cut short or larger than MAX_READ_WATERMARK_IN_BYTES.
+  bool Next(MessageCapture::Record& record);
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_MESSAGECAPTURE_H_
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "MessagePool.h"
+#include "libUtils/MemoryStats.h"
+
+using namespace std;
+
+MessagePool::ThreadCache::~ThreadCache() {
+  // Not given back to the shared lists, which may be gone already when the
+  // thread exits at shutdown
+  for (auto& messages : m_messages) {
+    for (auto message : messages) {
+      delete message;
+    }
+  }
+}
+
+MessagePool::MessagePool() {
+  MemoryStats::GetInstance().Register(
+      "MessagePool", [this]() -> uint64_t { return m_sharedBytes; });
+}
+
+MessagePool::~MessagePool() {
+  MemoryStats::GetInstance().Unregister("MessagePool");
+  for (auto& shared : m_shared) {
+    lock_guard<mutex> g(shared.m_mutex);
+    for (auto message : shared.m_messages) {
+      delete message;
+    }
+    shared.m_messages.clear();
+  }
+}
+
+MessagePool& MessagePool::GetInstance() {
+  static MessagePool pool;
+  return pool;
+}
+
+MessagePool::ThreadCache& MessagePool::GetThreadCache() {
+  static thread_local ThreadCache cache;
+  return cache;
+}
+
+unsigned int MessagePool::ClassToAcquire(size_t size) {
+  unsigned int sizeClass = 0;
+  while (sizeClass < NUM_CLASSES && ClassSize(sizeClass) < size) {
+    ++sizeClass;
+  }
+  return sizeClass;
+}
+
+unsigned int MessagePool::ClassToRelease(size_t capacity) {
+  if (capacity < ClassSize(0) || capacity > ClassSize(NUM_CLASSES - 1)) {
+    return NUM_CLASSES;
+  }
+  unsigned int sizeClass = NUM_CLASSES - 1;
+  while (ClassSize(sizeClass) > capacity) {
+    --sizeClass;
+  }
+  return sizeClass;
+}
+
+MessagePool::Message* MessagePool::Take(unsigned int sizeClass) {
+  auto& cached = GetThreadCache().m_messages[sizeClass];
+  if (cached.empty()) {
+    auto& shared = m_shared[sizeClass];
+    lock_guard<mutex> g(shared.m_mutex);
+    const size_t count = min<size_t>(BATCH_SIZE, shared.m_messages.size());
+    cached.insert(cached.end(), shared.m_messages.end() - count,
+                  shared.m_messages.end());
+    shared.m_messages.resize(shared.m_messages.size() - count);
+    m_sharedBytes -= count * ClassSize(sizeClass);
+  }
+  if (cached.empty()) {
+    return nullptr;
+  }
+  Message* message = cached.back();
+  cached.pop_back();
+  return message;
+}
+
+MessagePool::Message* MessagePool::Acquire(bytes::const_iterator begin,
+                                           bytes::const_iterator end,
+                                           const Peer& from) {
+  const size_t size = distance(begin, end);
+  const unsigned int sizeClass = ClassToAcquire(size);
+
+  Message* message = nullptr;
+  if (sizeClass < NUM_CLASSES) {
+    message = Take(sizeClass);
+    if (message == nullptr) {
+      message = new Message();
+      // Sized to the whole class so that it can serve any payload of it
+      message->first.reserve(ClassSize(sizeClass));
+    }
+  } else {
+    message = new Message();
+  }
+
+  message->first.assign(begin, end);
+  message->second = from;
+  return message;
+}
+
+void MessagePool::Release(Message* message) {
+  if (message == nullptr) {
+    return;
+  }
+
+  const unsigned int sizeClass = ClassToRelease(message->first.capacity());
+  if (sizeClass == NUM_CLASSES) {
+    delete message;
+    return;
+  }
+
+  auto& cached = GetThreadCache().m_messages[sizeClass];
+  cached.push_back(message);
+  if (cached.size() < THREAD_CACHE_SIZE) {
+    return;
+  }
+
+  // Hands half of the cache over to the threads taking envelopes, and drops
+  // what the shared list has no room for
+  const uint64_t classSize = ClassSize(sizeClass);
+  auto& shared = m_shared[sizeClass];
+  {
+    lock_guard<mutex> g(shared.m_mutex);
+    while (cached.size() > THREAD_CACHE_SIZE - BATCH_SIZE &&
+           (shared.m_messages.size() + 1) * classSize <=
+               MAX_SHARED_BYTES_PER_CLASS) {
+      shared.m_messages.push_back(cached.back());
+      cached.pop_back();
+      m_sharedBytes += classSize;
+    }
+  }
+  while (cached.size() > THREAD_CACHE_SIZE - BATCH_SIZE) {
+    delete cached.back();
+    cached.pop_back();
+  }
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_MESSAGEPOOL_H_
+#define ZILLIQA_SRC_LIBNETWORK_MESSAGEPOOL_H_
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "common/BaseType.h"
+#include "libNetwork/Peer.h"
+
+/// Keeps the envelopes of received messages for reuse, so that the receive
+/// path stops allocating once the node has warmed up. Envelopes are sorted by
+/// the capacity of their payload into power of two classes. Each thread keeps a
+/// small cache per class, and moves envelopes to or from the shared lists in
+/// batches, so the reactor threads that take envelopes and the handler threads
+/// that give them back only meet on the shared lock once per batch.
+class MessagePool {
+ public:
+  typedef std::pair<bytes, Peer> Message;
+
+ private:
+  static const unsigned int MIN_CLASS_SHIFT = 8;   // 256 bytes
+  static const unsigned int MAX_CLASS_SHIFT = 20;  // 1 MB
+  static const unsigned int NUM_CLASSES = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1;
+  static const unsigned int THREAD_CACHE_SIZE = 32;
+  static const unsigned int BATCH_SIZE = THREAD_CACHE_SIZE / 2;
+  /// Bytes the shared lists may hold in each class
+  static const uint64_t MAX_SHARED_BYTES_PER_CLASS = 8 * 1024 * 1024;
+
+  struct SharedList {
+    std::mutex m_mutex;
+    std::vector<Message*> m_messages;
+  };
+
+  struct ThreadCache {
+    std::array<std::vector<Message*>, NUM_CLASSES> m_messages;
+    ~ThreadCache();
+  };
+
+  std::array<SharedList, NUM_CLASSES> m_shared;
+  std::atomic<uint64_t> m_sharedBytes{0};
+
+  MessagePool();
+  ~MessagePool();
+
+  MessagePool(MessagePool const&) = delete;
+  void operator=(MessagePool const&) = delete;
+
+  static ThreadCache& GetThreadCache();
+
+  /// The smallest class holding size bytes, or NUM_CLASSES if none does
+  static unsigned int ClassToAcquire(size_t size);
+
+  /// The largest class a payload of capacity bytes can serve, or NUM_CLASSES
+  /// if it is too small or too large to be kept
+  static unsigned int ClassToRelease(size_t capacity);
+
+  static size_t ClassSize(unsigned int sizeClass) {
+    return size_t{1} << (sizeClass + MIN_CLASS_SHIFT);
+  }
+
+  Message* Take(unsigned int sizeClass);
+
+ public:
+  /// Returns the singleton MessagePool instance.
+  static MessagePool& GetInstance();
+
+  /// Returns an envelope holding a copy of [begin, end) received from peer.
+  /// It must be given back with Release once the message has been handled.
+  Message* Acquire(bytes::const_iterator begin, bytes::const_iterator end,
+                   const Peer& from);
+
+  Message* Acquire(const bytes& payload, const Peer& from) {
+    return Acquire(payload.begin(), payload.end(), from);
+  }
+
+  /// Gives back an envelope returned by Acquire. The class is picked from the
+  /// capacity of the payload at this point, so a handler may have swapped it.
+  void Release(Message* message);
+
+  /// Returns the bytes held by the shared lists.
+  uint64_t GetSharedBytes() const { return m_sharedBytes; }
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_MESSAGEPOOL_H_
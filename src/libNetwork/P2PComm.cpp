@@ -29,20 +29,29 @@
 #include <signal.h>
 #include <stdint.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
+#include <climits>
 #include <cstring>
 #include <memory>
 #include <utility>
 
 #include "Blacklist.h"
+#include "MessagePool.h"
 #include "P2PComm.h"
+#include "TrafficStats.h"
 #include "common/Messages.h"
 #include "libCrypto/Sha2.h"
+#include "libUtils/CompressionUtils.h"
 #include "libUtils/DataConversion.h"
-#include "libUtils/DetachedFunction.h"
+#include "libUtils/DetachedExecutor.h"
+#include "libUtils/EpochPerf.h"
 #include "libUtils/JoinableFunction.h"
 #include "libUtils/Logger.h"
+#include "libUtils/MemoryStats.h"
 #include "libUtils/SafeMath.h"
+#include "libUtils/ThreadAffinity.h"
+#include "libUtils/TimerWheel.h"
 
 using namespace std;
 using namespace boost::multiprecision;
@@ -50,6 +59,8 @@ using namespace boost::multiprecision;
 const unsigned char START_BYTE_NORMAL = 0x11;
 const unsigned char START_BYTE_BROADCAST = 0x22;
 const unsigned char START_BYTE_GOSSIP = 0x33;
+// Set on top of the start byte when the payload is compressed
+const unsigned char START_BYTE_COMPRESSED_FLAG = 0x80;
 const unsigned int HDR_LEN = 6;
 const unsigned int HASH_LEN = 32;
 const unsigned int GOSSIP_MSGTYPE_LEN = 1;
@@ -57,8 +68,7 @@ const unsigned int GOSSIP_ROUND_LEN = 4;
 const unsigned int GOSSIP_SNDR_LISTNR_PORT_LEN = 4;
 
 P2PComm::Dispatcher P2PComm::m_dispatcher;
-std::mutex P2PComm::m_mutexPeerConnectionCount;
-std::map<uint128_t, uint16_t> P2PComm::m_peerConnectionCount;
+ConnectionCounter P2PComm::m_peerConnectionCount;
 
 /// Comparison operator for ordering the list of message hashes.
 struct HashCompare {
@@ -67,57 +77,147 @@ struct HashCompare {
   }
 };
 
-static void close_socket(int* cli_sock) {
-  if (cli_sock != NULL) {
-    shutdown(*cli_sock, SHUT_RDWR);
-    close(*cli_sock);
+static SendClass ClassifyMessage(const bytes& message,
+                                 unsigned char startByte) {
+  if (startByte == START_BYTE_GOSSIP || message.size() < MessageOffset::BODY) {
+    return SendClass::GOSSIP;
   }
+
+  const unsigned char instruction = message.at(MessageOffset::INST);
+  switch (message.at(MessageOffset::TYPE)) {
+    case MessageType::DIRECTORY:
+      switch (instruction) {
+        case DSInstructionType::DSBLOCKCONSENSUS:
+        case DSInstructionType::FINALBLOCKCONSENSUS:
+        case DSInstructionType::VIEWCHANGECONSENSUS:
+        case DSInstructionType::FINALBLOCKPROPOSAL:
+          return SendClass::CONSENSUS;
+        case DSInstructionType::MICROBLOCKSUBMISSION:
+          return SendClass::BLOCKS;
+        default:
+          break;
+      }
+      break;
+    case MessageType::NODE:
+      switch (instruction) {
+        case NodeInstructionType::MICROBLOCKCONSENSUS:
+        case NodeInstructionType::FALLBACKCONSENSUS:
+          return SendClass::CONSENSUS;
+        case NodeInstructionType::DSBLOCK:
+        case NodeInstructionType::FINALBLOCK:
+        case NodeInstructionType::VCBLOCK:
+        case NodeInstructionType::FALLBACKBLOCK:
+          return SendClass::BLOCKS;
+        case NodeInstructionType::SUBMITTRANSACTION:
+        case NodeInstructionType::MBNFORWARDTRANSACTION:
+        case NodeInstructionType::FORWARDTXNPACKET:
+        case NodeInstructionType::PENDINGTXN:
+          return SendClass::BULK;
+        default:
+          break;
+      }
+      break;
+    case MessageType::LOOKUP:
+      switch (instruction) {
+        case LookupInstructionType::FORWARDTXN:
+        case LookupInstructionType::SETDSBLOCKFROMSEED:
+        case LookupInstructionType::SETTXBLOCKFROMSEED:
+        case LookupInstructionType::SETSTATEFROMSEED:
+        case LookupInstructionType::SETMICROBLOCKFROMLOOKUP:
+        case LookupInstructionType::SETTXNFROMLOOKUP:
+        case LookupInstructionType::SETDIRBLOCKSFROMSEED:
+        case LookupInstructionType::SETSTATEDELTAFROMSEED:
+        case LookupInstructionType::SETSTATEDELTASFROMSEED:
+          return SendClass::BULK;
+        default:
+          break;
+      }
+      break;
+    default:
+      break;
+  }
+
+  return SendClass::GOSSIP;
 }
 
-static bool comparePairSecond(
-    const pair<bytes, chrono::time_point<chrono::system_clock>>& a,
-    const pair<bytes, chrono::time_point<chrono::system_clock>>& b) {
-  return a.second < b.second;
+static const string& GetTrafficType(const MessageFrame& frame) {
+  return frame.GetStartByte() == START_BYTE_GOSSIP
+             ? TrafficStats::GOSSIP_TYPE
+             : TrafficStats::GetTypeName(frame.GetMsgType());
 }
 
-P2PComm::P2PComm() : m_sendQueue(SENDQUEUE_SIZE) {
-  auto func = [this]() -> void {
-    bytes emptyHash;
+static const char* GetSendClassName(unsigned int sendClass) {
+  static const char* names[NUM_SEND_CLASSES] = {"Consensus", "Blocks",
+                                                "Gossip", "Bulk"};
+  return names[sendClass];
+}
 
-    while (true) {
-      this_thread::sleep_for(chrono::seconds(BROADCAST_INTERVAL));
-      lock(m_broadcastToRemoveMutex, m_broadcastHashesMutex);
-      lock_guard<mutex> g(m_broadcastToRemoveMutex, adopt_lock);
-      lock_guard<mutex> g2(m_broadcastHashesMutex, adopt_lock);
+/// Logs the start of a broadcast, and its end once the last job is gone.
+struct BroadcastLog {
+  Peer m_selfPeer;
+  string m_hashStr;
 
-      if (m_broadcastToRemove.empty() ||
-          m_broadcastToRemove.front().second >
-              chrono::system_clock::now() - chrono::seconds(BROADCAST_EXPIRY)) {
-        continue;
-      }
+  BroadcastLog(const Peer& selfPeer, const string& hashStr)
+      : m_selfPeer(selfPeer), m_hashStr(hashStr) {
+    LOG_STATE("[BROAD][" << std::setw(15) << std::left
+                         << m_selfPeer.GetPrintableIPAddress() << "]["
+                         << m_hashStr.substr(0, 6) << "] BEGN");
+  }
+
+  ~BroadcastLog() {
+    LOG_STATE("[BROAD][" << std::setw(15) << std::left
+                         << m_selfPeer.GetPrintableIPAddress() << "]["
+                         << m_hashStr.substr(0, 6) << "] DONE");
+  }
+};
 
-      auto up = upper_bound(
-          m_broadcastToRemove.begin(), m_broadcastToRemove.end(),
-          make_pair(emptyHash, chrono::system_clock::now() -
-                                   chrono::seconds(BROADCAST_EXPIRY)),
-          comparePairSecond);
+static void close_socket(int* cli_sock) {
+  if (cli_sock != NULL) {
+    shutdown(*cli_sock, SHUT_RDWR);
+    close(*cli_sock);
+  }
+}
 
-      for (auto it = m_broadcastToRemove.begin(); it != up; ++it) {
-        m_broadcastHashes.erase(it->first);
+P2PComm::P2PComm() {
+  if (ENABLE_CONNECTION_POOL) {
+    auto funcCloseIdleConnections = [this]() -> void {
+      while (true) {
+        this_thread::sleep_for(chrono::seconds(CONNECTION_POOL_IDLE_TIMEOUT));
+        m_connectionPool.CloseExpired();
       }
+    };
 
-      m_broadcastToRemove.erase(m_broadcastToRemove.begin(), up);
+    DetachedExecutor::GetInstance().RunLongRunning("CloseIdleConnections",
+                                                   funcCloseIdleConnections);
+  }
+
+  if (ENABLE_GOSSIP_BATCH_VERIFY) {
+    m_gossipVerifier = make_unique<SignatureBatchVerifier>(
+        GOSSIP_VERIFY_NUM_THREADS, GOSSIP_VERIFY_BATCH_SIZE,
+        GOSSIP_VERIFY_WINDOW_IN_MS);
+  }
+
+  if (ENABLE_ASYNC_SEND) {
+    m_asyncSender =
+        make_unique<AsyncSender>(MAXRETRYCONN, PUMPMESSAGE_MILLISECONDS);
+    if (!m_asyncSender->IsRunning()) {
+      m_asyncSender.reset();
     }
-  };
+  }
 
-  DetachedFunction(1, func);
+  MemoryStats::GetInstance().Register(
+      "RumorManager", [this]() { return m_rumorManager.GetSizeInBytes(); });
+  MemoryStats::GetInstance().Register(
+      "SendQueue", [this]() -> uint64_t { return m_outboxes.GetBytes(); });
 }
 
 P2PComm::~P2PComm() {
-  SendJob* job = NULL;
-  while (m_sendQueue.pop(job)) {
-    delete job;
-  }
+  MemoryStats::GetInstance().Unregister("RumorManager");
+  MemoryStats::GetInstance().Unregister("SendQueue");
+
+  // Stops the senders before freeing the jobs they left queued
+  m_asyncSender.reset();
+  m_SendPool.JoinAll();
 }
 
 P2PComm& P2PComm::GetInstance() {
@@ -125,61 +225,186 @@ P2PComm& P2PComm::GetInstance() {
   return comm;
 }
 
-uint32_t SendJob::writeMsg(const void* buf, int cli_sock, const Peer& from,
-                           const uint32_t message_length) {
-  uint32_t written_length = 0;
+MessageFrame::MessageFrame(const bytes& message, unsigned char startByte,
+                           const bytes& hash)
+    : m_startByte(startByte),
+      m_sendClass(ClassifyMessage(message, startByte)),
+      m_msgType(message.empty() ? UCHAR_MAX : message.front()),
+      m_hash(hash) {
+  // Transmission format:
+  // 0x01 ~ 0xFF - version, defined in constant file
+  // 0x11 - start byte
+  // 0xLL 0xLL 0xLL 0xLL - 4-byte length of message
+  // <message>
 
-  while (written_length < message_length) {
-    ssize_t n = write(cli_sock, (unsigned char*)buf + written_length,
-                      message_length - written_length);
+  // 0x01 ~ 0xFF - version, defined in constant file
+  // 0x22 - start byte (broadcast)
+  // 0xLL 0xLL 0xLL 0xLL - 4-byte length of hash + message
+  // <32-byte hash> <message>
 
-    if (P2PComm::IsHostHavingNetworkIssue()) {
-      LOG_GENERAL(WARNING, "[blacklist] Encountered "
-                               << errno << " (" << std::strerror(errno)
-                               << "). Adding " << from.GetPrintableIPAddress()
-                               << " as strictly blacklisted");
-      Blacklist::GetInstance().Add(from.m_ipAddress);  // strict
-      return written_length;
-    } else if (P2PComm::IsNodeNotRunning()) {
-      LOG_GENERAL(WARNING, "[blacklist] Encountered "
-                               << errno << " (" << std::strerror(errno)
-                               << "). Adding " << from.GetPrintableIPAddress()
-                               << " as relaxed blacklisted");
-      Blacklist::GetInstance().Add(from.m_ipAddress, false);  // relaxed
-      return written_length;
-    }
+  // 0x01 ~ 0xFF - version, defined in constant file
+  // 0x33 - start byte (report)
+  // 0x00 0x00 0x00 0x01 - 4-byte length of message
+  // 0x00
+
+  // If the message is compressed, START_BYTE_COMPRESSED_FLAG is added to the
+  // start byte and only <message> is replaced with its compressed form. The
+  // broadcast hash still covers the original message.
+  unsigned char wireStartByte = m_startByte;
+  if (!ENABLE_MESSAGE_COMPRESSION ||
+      message.size() < MESSAGE_COMPRESSION_THRESHOLD_IN_BYTES ||
+      !CompressionUtils::Compress(message, 0, m_body,
+                                  MESSAGE_COMPRESSION_MIN_SAVING_PERCENT)) {
+    m_body = message;
+  } else {
+    wireStartByte |= START_BYTE_COMPRESSED_FLAG;
+  }
 
-    if (errno == EPIPE) {
-      LOG_GENERAL(WARNING, " SIGPIPE detected. Error No: "
-                               << errno << " Desc: " << std::strerror(errno));
-      return written_length;
-      // No retry as it is likely the other end terminate the conn due to
-      // duplicated msg.
+  uint32_t length = m_body.size();
+
+  if (m_startByte == START_BYTE_BROADCAST) {
+    length += HASH_LEN;
+  }
+
+  m_header = {(unsigned char)(MSG_VERSION & 0xFF),
+              wireStartByte,
+              (unsigned char)((length >> 24) & 0xFF),
+              (unsigned char)((length >> 16) & 0xFF),
+              (unsigned char)((length >> 8) & 0xFF),
+              (unsigned char)(length & 0xFF)};
+
+  if (m_startByte == START_BYTE_BROADCAST) {
+    m_header.insert(m_header.end(), m_hash.begin(), m_hash.end());
+  }
+}
+
+bool SendJob::writeMsg(const vector<MessageFramePtr>& frames, int cli_sock,
+                       const Peer& to) {
+  // Headers and bodies are sent with a single gather write, so no body is
+  // ever copied into a per-peer buffer
+  vector<struct iovec> iov;
+  iov.reserve(frames.size() * 2);
+  size_t message_length = 0;
+  for (const auto& frame : frames) {
+    if ((frame->GetStartByte() == START_BYTE_BROADCAST) &&
+        (frame->GetHash().size() != HASH_LEN)) {
+      LOG_GENERAL(WARNING, "Wrong message hash length.");
+      return false;
     }
+    iov.push_back({const_cast<unsigned char*>(frame->GetHeader().data()),
+                   frame->GetHeader().size()});
+    iov.push_back({const_cast<unsigned char*>(frame->GetBody().data()),
+                   frame->GetBody().size()});
+    message_length += frame->GetSize();
+  }
+  size_t written_length = 0;
+  size_t iov_index = 0;
+
+  while (written_length < message_length) {
+    ssize_t n =
+        writev(cli_sock, iov.data() + iov_index,
+               min<size_t>(iov.size() - iov_index, IOV_MAX));
 
     if (n <= 0) {
-      LOG_GENERAL(WARNING, "Socket write failed in message header. Code = "
-                               << errno << " Desc: " << std::strerror(errno)
-                               << ". IP address:" << from);
-      return written_length;
+      if (P2PComm::IsHostHavingNetworkIssue()) {
+        LOG_GENERAL(WARNING, "[blacklist] Encountered "
+                                 << errno << " (" << std::strerror(errno)
+                                 << "). Adding " << to.GetPrintableIPAddress()
+                                 << " as strictly blacklisted");
+        Blacklist::GetInstance().Add(to.m_ipAddress);  // strict
+      } else if (P2PComm::IsNodeNotRunning()) {
+        LOG_GENERAL(WARNING, "[blacklist] Encountered "
+                                 << errno << " (" << std::strerror(errno)
+                                 << "). Adding " << to.GetPrintableIPAddress()
+                                 << " as relaxed blacklisted");
+        Blacklist::GetInstance().Add(to.m_ipAddress, false);  // relaxed
+      } else if (errno == EPIPE) {
+        // No retry as it is likely the other end terminate the conn due to
+        // duplicated msg.
+        LOG_GENERAL(WARNING, " SIGPIPE detected. Error No: "
+                                 << errno << " Desc: " << std::strerror(errno));
+      } else {
+        LOG_GENERAL(WARNING, "Socket write failed. Code = "
+                                 << errno << " Desc: " << std::strerror(errno)
+                                 << ". IP address:" << to);
+      }
+      return false;
     }
 
     written_length += n;
+
+    // Move past the part that has been written
+    size_t advance = n;
+    while ((iov_index < iov.size()) && (advance >= iov[iov_index].iov_len)) {
+      advance -= iov[iov_index].iov_len;
+      iov_index++;
+    }
+    if (iov_index < iov.size()) {
+      iov[iov_index].iov_base =
+          static_cast<unsigned char*>(iov[iov_index].iov_base) + advance;
+      iov[iov_index].iov_len -= advance;
+    }
   }
 
   if (written_length > 1000000) {
     LOG_GENERAL(INFO, "DEBUG: Sent a total of " << written_length << " bytes");
   }
 
-  return written_length;
+  return true;
+}
+
+int SendJob::ConnectToPeer(const Peer& peer) {
+  int cli_sock = socket(AF_INET, SOCK_STREAM, 0);
+
+  // LINUX HAS NO SO_NOSIGPIPE
+  // int set = 1;
+  // setsockopt(cli_sock, SOL_SOCKET, SO_NOSIGPIPE, (void *)&set,
+  // sizeof(int));
+  signal(SIGPIPE, SIG_IGN);
+  if (cli_sock < 0) {
+    LOG_GENERAL(WARNING, "Socket creation failed. Code = "
+                             << errno << " Desc: " << std::strerror(errno)
+                             << ". IP address: " << peer);
+    return -1;
+  }
+
+  struct sockaddr_in serv_addr {};
+  serv_addr.sin_family = AF_INET;
+  serv_addr.sin_addr.s_addr = peer.m_ipAddress.convert_to<unsigned long>();
+  serv_addr.sin_port = htons(peer.m_listenPortHost);
+
+  if (connect(cli_sock, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) < 0) {
+    LOG_GENERAL(WARNING, "Socket connect failed. Code = "
+                             << errno << " Desc: " << std::strerror(errno)
+                             << ". IP address: " << peer);
+    if (P2PComm::IsHostHavingNetworkIssue()) {
+      LOG_GENERAL(WARNING, "[blacklist] Encountered "
+                               << errno << " (" << std::strerror(errno)
+                               << "). Adding " << peer.GetPrintableIPAddress()
+                               << " as strictly blacklisted");
+      Blacklist::GetInstance().Add(peer.m_ipAddress);
+    } else if (P2PComm::IsNodeNotRunning()) {
+      LOG_GENERAL(WARNING, "[blacklist] Encountered "
+                               << errno << " (" << std::strerror(errno)
+                               << "). Adding " << peer.GetPrintableIPAddress()
+                               << " as relaxed blacklisted");
+      Blacklist::GetInstance().Add(peer.m_ipAddress, false);
+    }
+
+    close_socket(&cli_sock);
+    return -1;
+  }
+
+  return cli_sock;
 }
 
-bool SendJob::SendMessageSocketCore(const Peer& peer, const bytes& message,
-                                    unsigned char start_byte,
-                                    const bytes& msg_hash) {
+bool SendJob::SendMessageSocketCore(const Peer& peer,
+                                    const vector<MessageFramePtr>& frames) {
   // LOG_MARKER();
-  LOG_PAYLOAD(DEBUG, "Sending to " << peer, message,
-              Logger::MAX_BYTES_TO_DISPLAY);
+  for (const auto& frame : frames) {
+    LOG_PAYLOAD(DEBUG, "Sending to " << peer, frame->GetBody(),
+                Logger::MAX_BYTES_TO_DISPLAY);
+  }
 
   if (peer.m_ipAddress == 0 && peer.m_listenPortHost == 0) {
     LOG_GENERAL(INFO,
@@ -192,91 +417,40 @@ bool SendJob::SendMessageSocketCore(const Peer& peer, const bytes& message,
   }
 
   try {
-    int cli_sock = socket(AF_INET, SOCK_STREAM, 0);
-    unique_ptr<int, void (*)(int*)> cli_sock_closer(&cli_sock, close_socket);
-
-    // LINUX HAS NO SO_NOSIGPIPE
-    // int set = 1;
-    // setsockopt(cli_sock, SOL_SOCKET, SO_NOSIGPIPE, (void *)&set,
-    // sizeof(int));
-    signal(SIGPIPE, SIG_IGN);
-    if (cli_sock < 0) {
-      LOG_GENERAL(WARNING, "Socket creation failed. Code = "
-                               << errno << " Desc: " << std::strerror(errno)
-                               << ". IP address: " << peer);
-      return false;
-    }
-
-    struct sockaddr_in serv_addr {};
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_addr.s_addr = peer.m_ipAddress.convert_to<unsigned long>();
-    serv_addr.sin_port = htons(peer.m_listenPortHost);
-
-    if (connect(cli_sock, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) <
-        0) {
-      LOG_GENERAL(WARNING, "Socket connect failed. Code = "
-                               << errno << " Desc: " << std::strerror(errno)
-                               << ". IP address: " << peer);
-      if (P2PComm::IsHostHavingNetworkIssue()) {
-        LOG_GENERAL(WARNING, "[blacklist] Encountered "
-                                 << errno << " (" << std::strerror(errno)
-                                 << "). Adding " << peer.GetPrintableIPAddress()
-                                 << " as strictly blacklisted");
-        Blacklist::GetInstance().Add(peer.m_ipAddress);
-      } else if (P2PComm::IsNodeNotRunning()) {
-        LOG_GENERAL(WARNING, "[blacklist] Encountered "
-                                 << errno << " (" << std::strerror(errno)
-                                 << "). Adding " << peer.GetPrintableIPAddress()
-                                 << " as relaxed blacklisted");
-        Blacklist::GetInstance().Add(peer.m_ipAddress, false);
+    if (!ENABLE_CONNECTION_POOL) {
+      int cli_sock = ConnectToPeer(peer);
+      if (cli_sock < 0) {
+        return false;
       }
+      unique_ptr<int, void (*)(int*)> cli_sock_closer(&cli_sock, close_socket);
 
-      return false;
-    }
-    // Transmission format:
-    // 0x01 ~ 0xFF - version, defined in constant file
-    // 0x11 - start byte
-    // 0xLL 0xLL 0xLL 0xLL - 4-byte length of message
-    // <message>
-
-    // 0x01 ~ 0xFF - version, defined in constant file
-    // 0x22 - start byte (broadcast)
-    // 0xLL 0xLL 0xLL 0xLL - 4-byte length of hash + message
-    // <32-byte hash> <message>
-
-    // 0x01 ~ 0xFF - version, defined in constant file
-    // 0x33 - start byte (report)
-    // 0x00 0x00 0x00 0x01 - 4-byte length of message
-    // 0x00
-    uint32_t length = message.size();
-
-    if (start_byte == START_BYTE_BROADCAST) {
-      length += HASH_LEN;
+      writeMsg(frames, cli_sock, peer);
+      return true;
     }
 
-    unsigned char buf[HDR_LEN] = {(unsigned char)(MSG_VERSION & 0xFF),
-                                  start_byte,
-                                  (unsigned char)((length >> 24) & 0xFF),
-                                  (unsigned char)((length >> 16) & 0xFF),
-                                  (unsigned char)((length >> 8) & 0xFF),
-                                  (unsigned char)(length & 0xFF)};
+    ConnectionPool& pool = P2PComm::GetInstance().GetConnectionPool();
+    int cli_sock = pool.Acquire(peer);
 
-    if (HDR_LEN != writeMsg(buf, cli_sock, peer, HDR_LEN)) {
-      LOG_GENERAL(INFO, "DEBUG: not written_length == " << HDR_LEN);
-    }
+    if (cli_sock >= 0) {
+      if (writeMsg(frames, cli_sock, peer)) {
+        pool.Release(peer, cli_sock, true);
+        return true;
+      }
 
-    if (start_byte != START_BYTE_BROADCAST) {
-      writeMsg(&message.at(0), cli_sock, peer, length);
-      return true;
+      // The pooled connection went stale, retry once on a fresh one while
+      // keeping the reserved slot
+      LOG_GENERAL(INFO, "Pooled connection to " << peer
+                                                << " failed, reconnecting");
+      close_socket(&cli_sock);
     }
 
-    if (HASH_LEN != writeMsg(&msg_hash.at(0), cli_sock, peer, HASH_LEN)) {
-      LOG_GENERAL(WARNING, "Wrong message hash length.");
-      return true;
+    cli_sock = ConnectToPeer(peer);
+    if (cli_sock < 0) {
+      pool.Release(peer, -1, false);
+      return false;
     }
 
-    length -= HASH_LEN;
-    writeMsg(&message.at(0), cli_sock, peer, length);
+    pool.Release(peer, cli_sock, writeMsg(frames, cli_sock, peer));
   } catch (const std::exception& e) {
     LOG_GENERAL(WARNING, "Error with write socket." << ' ' << e.what());
     return false;
@@ -284,89 +458,212 @@ bool SendJob::SendMessageSocketCore(const Peer& peer, const bytes& message,
   return true;
 }
 
-void SendJob::SendMessageCore(const Peer& peer, const bytes& message,
-                              unsigned char startbyte, const bytes& hash) {
+bool SendJob::SendMessageCore(const Peer& peer,
+                              const vector<MessageFramePtr>& frames,
+                              unsigned int maxRetries) {
   uint32_t retry_counter = 0;
-  while (!SendMessageSocketCore(peer, message, startbyte, hash)) {
+  while (!SendMessageSocketCore(peer, frames)) {
     if (Blacklist::GetInstance().Exist(peer.m_ipAddress)) {
-      return;
+      return false;
     }
 
     LOG_GENERAL(WARNING, "Socket connect failed " << retry_counter << "/"
-                                                  << MAXRETRYCONN
+                                                  << maxRetries
                                                   << ". IP address: " << peer);
 
-    if (++retry_counter > MAXRETRYCONN) {
+    if (++retry_counter > maxRetries) {
       LOG_GENERAL(WARNING,
-                  "Socket connect failed over " << MAXRETRYCONN << " times.");
-      return;
+                  "Socket connect failed over " << maxRetries << " times.");
+      return false;
     }
     this_thread::sleep_for(
         chrono::milliseconds(rand() % PUMPMESSAGE_MILLISECONDS + 1));
   }
+  return true;
 }
 
-void SendJobPeer::DoSend() {
-  if (Blacklist::GetInstance().Exist(m_peer.m_ipAddress)) {
-    LOG_GENERAL(INFO, m_peer << " is blacklisted - blocking all messages");
+void P2PComm::QueueSendJob(SendJob* job) {
+  // The job belongs to the outbox once queued
+  const Peer peer = job->m_peer;
+  const SendClass sendClass = job->m_frame->GetSendClass();
+  unique_ptr<SendJob> queued(job);
+  unique_ptr<SendJob> evicted;
+  const bool startSending = m_outboxes.Queue(queued, evicted);
+
+  if (evicted) {
+    LOG_GENERAL(WARNING,
+                "SendQueue to " << evicted->m_peer << " is full, dropped a "
+                                << GetSendClassName(static_cast<unsigned int>(
+                                       evicted->m_frame->GetSendClass()))
+                                << " message");
+  }
+  if (queued) {
+    LOG_GENERAL(WARNING, "SendQueue to "
+                             << peer << " is full, dropped a "
+                             << GetSendClassName(
+                                    static_cast<unsigned int>(sendClass))
+                             << " message");
     return;
   }
 
-  SendMessageCore(m_peer, m_message, m_startbyte, m_hash);
+  if (startSending) {
+    ScheduleDrain(peer, sendClass);
+  }
 }
 
-template <class T>
-void SendJobPeers<T>::DoSend() {
-  vector<unsigned int> indexes(m_peers.size());
+template <class Container>
+void P2PComm::QueueSendJobs(const Container& peers,
+                            const MessageFramePtr& frame,
+                            bool allowSendToRelaxedBlacklist) {
+  vector<unsigned int> indexes(peers.size());
 
   for (unsigned int i = 0; i < indexes.size(); i++) {
     indexes.at(i) = i;
   }
   random_shuffle(indexes.begin(), indexes.end());
 
-  string hashStr;
-  if ((m_startbyte == START_BYTE_BROADCAST) && (m_selfPeer != Peer())) {
-    if (!DataConversion::Uint8VecToHexStr(m_hash, hashStr)) {
+  shared_ptr<BroadcastLog> broadcastLog;
+  if ((frame->GetStartByte() == START_BYTE_BROADCAST) &&
+      (m_selfPeer != Peer())) {
+    string hashStr;
+    if (!DataConversion::Uint8VecToHexStr(frame->GetHash(), hashStr)) {
       return;
     }
-    LOG_STATE("[BROAD][" << std::setw(15) << std::left
-                         << m_selfPeer.GetPrintableIPAddress() << "]["
-                         << hashStr.substr(0, 6) << "] BEGN");
+    broadcastLog = make_shared<BroadcastLog>(m_selfPeer, hashStr);
   }
 
-  for (vector<unsigned int>::const_iterator curr = indexes.begin();
-       curr < indexes.end(); ++curr) {
-    const Peer& peer = m_peers.at(*curr);
+  for (const auto& index : indexes) {
+    auto job = new SendJob;
+    job->m_peer = peers.at(index);
+    job->m_frame = frame;
+    job->m_allowSendToRelaxedBlacklist = allowSendToRelaxedBlacklist;
+    job->m_broadcastLog = broadcastLog;
+    QueueSendJob(job);
+  }
+}
 
-    /// TBD: Update the container dynamically when blacklist is updated
-    if (Blacklist::GetInstance().Exist(peer.m_ipAddress,
-                                       !m_allowSendToRelaxedBlacklist)) {
-      LOG_GENERAL(INFO, peer << " is blacklisted - blocking all messages");
-      continue;
-    }
+void P2PComm::ScheduleDrain(const Peer& peer, SendClass sendClass) {
+  m_SendPool.AddJob([this, peer]() mutable -> void { DrainOutbox(peer); },
+                    sendClass <= SendClass::BLOCKS
+                        ? ThreadPool::Priority::HIGH
+                        : ThreadPool::Priority::NORMAL);
+}
 
-    SendMessageCore(peer, m_message, m_startbyte, m_hash);
+void P2PComm::DrainOutbox(const Peer& peer) {
+  auto jobs = make_shared<vector<unique_ptr<SendJob>>>();
+  chrono::steady_clock::duration throttledFor{};
+  // Without framed receive on the other side, one connection carries one
+  // message
+  const uint64_t maxBytes = ENABLE_CONNECTION_POOL ? SEND_COALESCE_MAX_BYTES : 0;
+  m_outboxes.TakeBatch(peer, maxBytes, m_bulkShaper, *jobs, throttledFor);
+
+  if (jobs->empty()) {
+    TimerWheel::GetInstance().ScheduleAfter(
+        [this, peer]() { ResumeThrottled(peer); },
+        chrono::duration_cast<chrono::milliseconds>(throttledFor) +
+            chrono::milliseconds(1));
+    return;
   }
 
-  if ((m_startbyte == START_BYTE_BROADCAST) && (m_selfPeer != Peer())) {
-    LOG_STATE("[BROAD][" << std::setw(15) << std::left
-                         << m_selfPeer.GetPrintableIPAddress() << "]["
-                         << hashStr.substr(0, 6) << "] DONE");
+  uint64_t batchBytes = 0;
+  vector<MessageFramePtr> frames;
+  frames.reserve(jobs->size());
+  for (const auto& job : *jobs) {
+    batchBytes += job->m_frame->GetSize();
+    frames.push_back(job->m_frame);
+  }
+
+  /// TBD: Update the container dynamically when blacklist is updated
+  if (Blacklist::GetInstance().Exist(
+          peer.m_ipAddress, !jobs->front()->m_allowSendToRelaxedBlacklist)) {
+    LOG_GENERAL(INFO, peer << " is blacklisted - blocking all messages");
+    FinishDrain(peer, *jobs, true);
+    return;
+  }
+
+  // A peer that keeps failing is only probed now and then, with one attempt
+  const auto verdict = m_peerHealth.Check(peer);
+  if (verdict == PeerHealth::Verdict::SKIP) {
+    LOG_GENERAL(INFO, peer << " is unreachable - skipping " << jobs->size()
+                           << " messages");
+    FinishDrain(peer, *jobs, true);
+    return;
+  }
+  const bool probe = verdict == PeerHealth::Verdict::PROBE;
+
+  // The outbox stays taken until the write is done, so the messages to the
+  // peer still leave in order
+  if (!probe && m_asyncSender && batchBytes >= ASYNC_SEND_MIN_BYTES &&
+      peer.m_listenPortHost != 0) {
+    m_asyncSender->Send(peer, frames, [this, peer, jobs](bool success) {
+      m_peerHealth.Record(peer, success);
+      FinishDrain(peer, *jobs, false);
+    });
+    return;
   }
+
+  m_peerHealth.Record(
+      peer, SendJob::SendMessageCore(peer, frames, probe ? 0 : MAXRETRYCONN));
+  FinishDrain(peer, *jobs, false);
 }
 
-void P2PComm::ProcessSendJob(SendJob* job) {
-  auto funcSendMsg = [job]() mutable -> void {
-    job->DoSend();
-    delete job;
-  };
-  m_SendPool.AddJob(funcSendMsg);
+void P2PComm::ResumeThrottled(const Peer& peer) {
+  SendClass nextClass = SendClass::BULK;
+  if (m_outboxes.Resume(peer, nextClass)) {
+    ScheduleDrain(peer, nextClass);
+  }
 }
 
-void P2PComm::ClearBroadcastHashAsync(const bytes& message_hash) {
-  LOG_MARKER();
-  lock_guard<mutex> guard(m_broadcastToRemoveMutex);
-  m_broadcastToRemove.emplace_back(message_hash, chrono::system_clock::now());
+void P2PComm::FinishDrain(const Peer& peer, vector<unique_ptr<SendJob>>& jobs,
+                          bool blocked) {
+  uint64_t batchBytes = 0;
+  for (const auto& job : jobs) {
+    batchBytes += job->m_frame->GetSize();
+    if (ENABLE_TRAFFIC_STATS && !blocked) {
+      TrafficStats::GetInstance().Record(true, peer.m_ipAddress,
+                                         GetTrafficType(*job->m_frame),
+                                         job->m_frame->GetSize());
+    }
+  }
+  if (ENABLE_EPOCH_PERF && !blocked) {
+    EpochPerf::GetInstance().AddBytesSent(batchBytes);
+  }
+
+  // Goes back to the pool between batches, so that one busy peer does not
+  // hold a thread while the messages to other peers wait
+  SendClass nextClass = SendClass::BULK;
+  if (m_outboxes.Finish(peer, jobs, blocked, nextClass)) {
+    ScheduleDrain(peer, nextClass);
+  }
+}
+
+Json::Value P2PComm::GetSendQueueStats() {
+  Json::Value result;
+  for (unsigned int c = 0; c < NUM_SEND_CLASSES; ++c) {
+    const auto& stats = m_outboxes.GetStats(c);
+    const uint64_t sent = stats.m_sent;
+    const uint64_t dropped = stats.m_dropped;
+    Json::Value entry;
+    entry["Waiting"] = stats.m_waiting.load();
+    entry["WaitingBytes"] = static_cast<Json::UInt64>(stats.m_waitingBytes);
+    entry["Sent"] = static_cast<Json::UInt64>(sent);
+    entry["Dropped"] = static_cast<Json::UInt64>(dropped);
+    entry["Coalesced"] = static_cast<Json::UInt64>(stats.m_coalesced);
+    entry["AvgWaitUs"] = static_cast<Json::UInt64>(
+        sent + dropped == 0 ? 0 : stats.m_totalWaitMicros / (sent + dropped));
+    result[GetSendClassName(c)] = entry;
+  }
+  result["PeerHealth"]["Down"] = m_peerHealth.GetDownCount();
+  result["PeerHealth"]["Skipped"] =
+      static_cast<Json::UInt64>(m_peerHealth.GetSkipped());
+  result["PeerHealth"]["Probes"] =
+      static_cast<Json::UInt64>(m_peerHealth.GetProbes());
+  result["BulkShaper"]["Enabled"] = m_bulkShaper.IsEnabled();
+  result["BulkShaper"]["Throttled"] =
+      static_cast<Json::UInt64>(m_bulkShaper.GetThrottled());
+  result["Peers"] = m_outboxes.GetPeerCount();
+  result["BulkShaper"]["ThrottledPeers"] = m_outboxes.GetThrottledCount();
+  return result;
 }
 
 void P2PComm::ProcessBroadCastMsg(bytes& message, const Peer& from) {
@@ -376,35 +673,25 @@ void P2PComm::ProcessBroadCastMsg(bytes& message, const Peer& from) {
   P2PComm& p2p = P2PComm::GetInstance();
 
   // Check if this message has been received before
-  bool found = false;
-  {
-    lock_guard<mutex> guard(p2p.m_broadcastHashesMutex);
-
-    found =
-        (p2p.m_broadcastHashes.find(msg_hash) != p2p.m_broadcastHashes.end());
-    // While we have the lock, we should quickly add the hash
-    if (!found) {
-      SHA2<HashType::HASH_VARIANT_256> sha256;
-      sha256.Update(message, HDR_LEN + HASH_LEN,
-                    message.size() - HDR_LEN - HASH_LEN);
-      bytes this_msg_hash = sha256.Finalize();
-
-      if (this_msg_hash == msg_hash) {
-        p2p.m_broadcastHashes.insert(this_msg_hash);
-      } else {
-        LOG_GENERAL(WARNING, "Incorrect message hash.");
-        return;
-      }
-    }
-  }
-
-  if (found) {
+  if (p2p.m_broadcastHashes.Contains(msg_hash)) {
     // We already sent and/or received this message before -> discard
     LOG_GENERAL(INFO, "Discarding duplicate");
     return;
   }
 
-  p2p.ClearBroadcastHashAsync(msg_hash);
+  SHA2<HashType::HASH_VARIANT_256> sha256;
+  sha256.Update(message, HDR_LEN + HASH_LEN,
+                message.size() - HDR_LEN - HASH_LEN);
+  if (sha256.Finalize() != msg_hash) {
+    LOG_GENERAL(WARNING, "Incorrect message hash.");
+    return;
+  }
+
+  // Another copy may have been accepted while we were hashing
+  if (!p2p.m_broadcastHashes.Insert(msg_hash)) {
+    LOG_GENERAL(INFO, "Discarding duplicate");
+    return;
+  }
 
   string msgHashStr;
   if (!DataConversion::Uint8VecToHexStr(msg_hash, msgHashStr)) {
@@ -414,9 +701,8 @@ void P2PComm::ProcessBroadCastMsg(bytes& message, const Peer& from) {
   LOG_STATE("[BROAD][" << std::setw(15) << std::left << p2p.m_selfPeer << "]["
                        << msgHashStr.substr(0, 6) << "] RECV");
 
-  // Move the shared_ptr message to raw pointer type
-  pair<bytes, Peer>* raw_message = new pair<bytes, Peer>(
-      bytes(message.begin() + HDR_LEN + HASH_LEN, message.end()), from);
+  pair<bytes, Peer>* raw_message = MessagePool::GetInstance().Acquire(
+      message.begin() + HDR_LEN + HASH_LEN, message.end(), from);
 
   // Queue the message
   m_dispatcher(raw_message);
@@ -449,22 +735,84 @@ void P2PComm::ProcessBroadCastMsg(bytes& message, const Peer& from) {
 
     if (p2p.SpreadForeignRumor(rumor_message)) {
       // skip the keys and signature.
-      bytes tmp(rumor_message.begin() + PUB_KEY_SIZE +
-                    SIGNATURE_CHALLENGE_SIZE + SIGNATURE_RESPONSE_SIZE,
-                rumor_message.end());
-      std::pair<bytes, Peer>* raw_message = new pair<bytes, Peer>(tmp, from);
+      std::pair<bytes, Peer>* raw_message =
+          MessagePool::GetInstance().Acquire(
+              rumor_message.begin() + PUB_KEY_SIZE + SIGNATURE_CHALLENGE_SIZE +
+                  SIGNATURE_RESPONSE_SIZE,
+              rumor_message.end(), from);
+
+      LOG_GENERAL(INFO, "Rumor size: " << raw_message->first.size());
+
+      // Queue the message
+      m_dispatcher(raw_message);
+    }
+    return;
+  }
+
+  const auto gossipType = static_cast<RRS::Message::Type>(gossipMsgTyp);
+  if (p2p.m_gossipVerifier && RumorManager::IsSignedType(gossipType)) {
+    // Leave the signature check to the batch verifier, off this thread
+    PubKey senderPubKey;
+    Signature signature;
+    if ((rumor_message.size() < PUB_KEY_SIZE + SIGNATURE_CHALLENGE_SIZE +
+                                     SIGNATURE_RESPONSE_SIZE) ||
+        !senderPubKey.Deserialize(rumor_message, 0) ||
+        !signature.Deserialize(rumor_message, PUB_KEY_SIZE)) {
+      LOG_GENERAL(WARNING, "Gossip message without valid key and signature");
+      return;
+    }
+
+    const bytes signedPart(rumor_message.begin() + PUB_KEY_SIZE +
+                               SIGNATURE_CHALLENGE_SIZE +
+                               SIGNATURE_RESPONSE_SIZE,
+                           rumor_message.end());
+
+    auto onVerified = [gossipMsgTyp, gossipMsgRound, rumor_message,
+                       from](bool verified) {
+      if (!verified) {
+        LOG_GENERAL(WARNING,
+                    "Signature verification failed. so ignoring message");
+        return;
+      }
+      ProcessRumor(gossipMsgTyp, gossipMsgRound, rumor_message, from, true);
+    };
+
+    if (!p2p.m_gossipVerifier->Submit(signedPart, signature, senderPubKey,
+                                      onVerified)) {
+      LOG_GENERAL(WARNING, "Gossip verify queue is full");
+    }
+    return;
+  }
+
+  ProcessRumor(gossipMsgTyp, gossipMsgRound, rumor_message, from, false);
+}
+
+/*static*/ void P2PComm::ProcessRumor(unsigned char gossipMsgTyp,
+                                      uint32_t gossipMsgRound,
+                                      const bytes& rumor_message,
+                                      const Peer& from,
+                                      bool isSignatureVerified) {
+  P2PComm& p2p = P2PComm::GetInstance();
+
+  if (gossipMsgTyp == (uint8_t)RRS::Message::Type::BATCH) {
+    auto rumors = p2p.m_rumorManager.RumorBatchReceived(rumor_message, from,
+                                                        isSignatureVerified);
+    for (const auto& rumor : rumors) {
+      std::pair<bytes, Peer>* raw_message =
+          MessagePool::GetInstance().Acquire(rumor, from);
 
-      LOG_GENERAL(INFO, "Rumor size: " << tmp.size());
+      LOG_GENERAL(INFO, "Rumor size: " << rumor.size());
 
       // Queue the message
       m_dispatcher(raw_message);
     }
   } else {
     auto resp = p2p.m_rumorManager.RumorReceived(
-        (unsigned int)gossipMsgTyp, gossipMsgRound, rumor_message, from);
+        (unsigned int)gossipMsgTyp, gossipMsgRound, rumor_message, from,
+        isSignatureVerified);
     if (resp.first) {
       std::pair<bytes, Peer>* raw_message =
-          new pair<bytes, Peer>(resp.second, from);
+          MessagePool::GetInstance().Acquire(resp.second, from);
 
       LOG_GENERAL(INFO, "Rumor size: " << rumor_message.size());
 
@@ -479,19 +827,12 @@ void P2PComm::CloseAndFreeBufferEvent(struct bufferevent* bufev) {
   struct sockaddr_in cli_addr {};
   socklen_t addr_size = sizeof(struct sockaddr_in);
   getpeername(fd, (struct sockaddr*)&cli_addr, &addr_size);
-  uint128_t ipAddr = cli_addr.sin_addr.s_addr;
-  {
-    std::unique_lock<std::mutex> lock(m_mutexPeerConnectionCount);
-    if (m_peerConnectionCount[ipAddr] > 0) {
-      m_peerConnectionCount[ipAddr]--;
-    }
-  }
+  m_peerConnectionCount.Remove(uint128_t(cli_addr.sin_addr.s_addr));
   bufferevent_free(bufev);
 }
 
 void P2PComm::ClearPeerConnectionCount() {
-  std::unique_lock<std::mutex> lock(m_mutexPeerConnectionCount);
-  m_peerConnectionCount.clear();
+  m_peerConnectionCount.Clear();
 }
 
 void P2PComm::EventCallback(struct bufferevent* bev, short events,
@@ -525,7 +866,7 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
   }
   size_t len = evbuffer_get_length(input);
   if (len == 0) {
-    LOG_GENERAL(WARNING, "evbuffer_get_length failure.");
+    // All complete messages were already consumed by ReadCallback
     return;
   }
   bytes message(len);
@@ -539,6 +880,36 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
     return;
   }
 
+  ProcessReceivedMessage(message, from);
+}
+
+bool P2PComm::DecompressMessage(bytes& message) {
+  const unsigned char startByte = message[1] & ~START_BYTE_COMPRESSED_FLAG;
+  const unsigned int prefixLen =
+      (startByte == START_BYTE_BROADCAST) ? HDR_LEN + HASH_LEN : HDR_LEN;
+
+  if (message.size() <= prefixLen) {
+    return false;
+  }
+
+  bytes result(message.begin(), message.begin() + prefixLen);
+  if (!CompressionUtils::Decompress(message, prefixLen, result,
+                                    MAX_READ_WATERMARK_IN_BYTES)) {
+    return false;
+  }
+
+  const uint32_t length = result.size() - HDR_LEN;
+  result[1] = startByte;
+  result[2] = (length >> 24) & 0xFF;
+  result[3] = (length >> 16) & 0xFF;
+  result[4] = (length >> 8) & 0xFF;
+  result[5] = length & 0xFF;
+
+  message.swap(result);
+  return true;
+}
+
+void P2PComm::ProcessReceivedMessage(bytes& message, Peer& from) {
   // Reception format:
   // 0x01 ~ 0xFF - version, defined in constant file
   // 0x11 - start byte
@@ -568,7 +939,6 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
   }
 
   const unsigned char version = message[0];
-  const unsigned char startByte = message[1];
 
   // Check for version requirement
   if (version != (unsigned char)(MSG_VERSION & 0xFF)) {
@@ -578,6 +948,17 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
     return;
   }
 
+  // Counted as it came on the wire
+  const size_t wireBytes = message.size();
+
+  if ((message[1] & START_BYTE_COMPRESSED_FLAG) &&
+      !DecompressMessage(message)) {
+    LOG_GENERAL(WARNING, "Failed to decompress message from " << from);
+    return;
+  }
+
+  const unsigned char startByte = message[1];
+
   const uint32_t messageLength =
       (message[2] << 24) + (message[3] << 16) + (message[4] << 8) + message[5];
 
@@ -607,14 +988,25 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
       return;
     }
 
+    if (ENABLE_TRAFFIC_STATS) {
+      TrafficStats::GetInstance().Record(
+          false, from.m_ipAddress,
+          TrafficStats::GetTypeName(message[HDR_LEN + HASH_LEN]), wireBytes);
+    }
+
     ProcessBroadCastMsg(message, from);
   } else if (startByte == START_BYTE_NORMAL) {
     LOG_PAYLOAD(INFO, "Incoming normal " << from, message,
                 Logger::MAX_BYTES_TO_DISPLAY);
 
-    // Move the shared_ptr message to raw pointer type
-    pair<bytes, Peer>* raw_message = new pair<bytes, Peer>(
-        bytes(message.begin() + HDR_LEN, message.end()), from);
+    if (ENABLE_TRAFFIC_STATS) {
+      TrafficStats::GetInstance().Record(
+          false, from.m_ipAddress, TrafficStats::GetTypeName(message[HDR_LEN]),
+          wireBytes);
+    }
+
+    pair<bytes, Peer>* raw_message = MessagePool::GetInstance().Acquire(
+        message.begin() + HDR_LEN, message.end(), from);
 
     // Queue the message
     m_dispatcher(raw_message);
@@ -641,6 +1033,11 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
       return;
     }
 
+    if (ENABLE_TRAFFIC_STATS) {
+      TrafficStats::GetInstance().Record(false, from.m_ipAddress,
+                                         TrafficStats::GOSSIP_TYPE, wireBytes);
+    }
+
     ProcessGossipMsg(message, from);
   } else {
     // Unexpected start byte. Drop this message
@@ -651,22 +1048,94 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
 void P2PComm::ReadCallback(struct bufferevent* bev, [[gnu::unused]] void* ctx) {
   struct evbuffer* input = bufferevent_get_input(bev);
 
+  // Get the IP info
+  int fd = bufferevent_getfd(bev);
+  struct sockaddr_in cli_addr {};
+  socklen_t addr_size = sizeof(struct sockaddr_in);
+  getpeername(fd, (struct sockaddr*)&cli_addr, &addr_size);
+  Peer from(cli_addr.sin_addr.s_addr, cli_addr.sin_port);
+
   size_t len = evbuffer_get_length(input);
   if (len >= MAX_READ_WATERMARK_IN_BYTES) {
-    // Get the IP info
-    int fd = bufferevent_getfd(bev);
-    struct sockaddr_in cli_addr {};
-    socklen_t addr_size = sizeof(struct sockaddr_in);
-    getpeername(fd, (struct sockaddr*)&cli_addr, &addr_size);
-    Peer from(cli_addr.sin_addr.s_addr, cli_addr.sin_port);
     LOG_GENERAL(WARNING, "[blacklist] Encountered data of size: "
                              << len << " being received."
                              << " Adding sending node "
                              << from.GetPrintableIPAddress()
                              << " as strictly blacklisted");
     Blacklist::GetInstance().Add(from.m_ipAddress);
-    bufferevent_free(bev);
+    CloseAndFreeBufferEvent(bev);
+    return;
+  }
+
+  // Process every complete message in the buffer right away, so that the
+  // sender can keep the connection open and reuse it for further messages
+  while (len >= HDR_LEN) {
+    unsigned char header[HDR_LEN];
+    if (evbuffer_copyout(input, header, HDR_LEN) !=
+        static_cast<ev_ssize_t>(HDR_LEN)) {
+      LOG_GENERAL(WARNING, "evbuffer_copyout failure.");
+      return;
+    }
+
+    if (header[0] != (unsigned char)(MSG_VERSION & 0xFF)) {
+      // Leave it to EventCallback to report once the sender closes
+      return;
+    }
+
+    const size_t frameLength = HDR_LEN + ((uint32_t)header[2] << 24) +
+                               ((uint32_t)header[3] << 16) +
+                               ((uint32_t)header[4] << 8) + header[5];
+
+    // The header alone tells whether the frame is worth reading, so the
+    // connection is dropped before its body comes in
+    const unsigned char startByte = header[1] & ~START_BYTE_COMPRESSED_FLAG;
+    if ((startByte != START_BYTE_NORMAL) &&
+        (startByte != START_BYTE_BROADCAST) &&
+        (startByte != START_BYTE_GOSSIP)) {
+      LOG_GENERAL(WARNING, "Incorrect start byte from " << from);
+      CloseAndFreeBufferEvent(bev);
+      return;
+    }
+    if ((frameLength >= MAX_READ_WATERMARK_IN_BYTES) ||
+        ((startByte == START_BYTE_GOSSIP) &&
+         (frameLength >= MAX_GOSSIP_MSG_SIZE_IN_BYTES))) {
+      LOG_GENERAL(WARNING, "[blacklist] Frame of size "
+                               << frameLength << " announced by "
+                               << from.GetPrintableIPAddress()
+                               << ", strictly blacklisting it");
+      Blacklist::GetInstance().Add(from.m_ipAddress);
+      CloseAndFreeBufferEvent(bev);
+      return;
+    }
+    if (Blacklist::GetInstance().Exist(from.m_ipAddress,
+                                       false /* for incoming message */)) {
+      LOG_GENERAL(INFO, "The node " << from
+                                    << " is in black list, dropping it");
+      CloseAndFreeBufferEvent(bev);
+      return;
+    }
+
+    if (len < frameLength) {
+      // Not called again until the whole frame is in
+      bufferevent_setwatermark(bev, EV_READ, frameLength,
+                               MAX_READ_WATERMARK_IN_BYTES);
+      return;
+    }
+
+    bytes message(frameLength);
+    if (evbuffer_remove(input, message.data(), frameLength) !=
+        static_cast<int>(frameLength)) {
+      LOG_GENERAL(WARNING, "evbuffer_remove failure.");
+      return;
+    }
+
+    ProcessReceivedMessage(message, from);
+
+    len = evbuffer_get_length(input);
   }
+
+  bufferevent_setwatermark(bev, EV_READ, MIN_READ_WATERMARK_IN_BYTES,
+                           MAX_READ_WATERMARK_IN_BYTES);
 }
 
 void P2PComm::AcceptConnectionCallback([[gnu::unused]] evconnlistener* listener,
@@ -690,14 +1159,10 @@ void P2PComm::AcceptConnectionCallback([[gnu::unused]] evconnlistener* listener,
     return;
   }
 
-  {
-    std::unique_lock<std::mutex> lock(m_mutexPeerConnectionCount);
-    if (m_peerConnectionCount[from.GetIpAddress()] > MAX_PEER_CONNECTION) {
-      LOG_GENERAL(WARNING, "Connection ignored from " << from);
-      evutil_closesocket(cli_sock);
-      return;
-    }
-    m_peerConnectionCount[from.GetIpAddress()]++;
+  if (!m_peerConnectionCount.TryAdd(from.GetIpAddress(), MAX_PEER_CONNECTION)) {
+    LOG_GENERAL(WARNING, "Connection ignored from " << from);
+    evutil_closesocket(cli_sock);
+    return;
   }
 
   // Set up buffer event for this new connection
@@ -707,6 +1172,7 @@ void P2PComm::AcceptConnectionCallback([[gnu::unused]] evconnlistener* listener,
 
     // Close the socket
     evutil_closesocket(cli_sock);
+    m_peerConnectionCount.Remove(from.GetIpAddress());
 
     return;
   }
@@ -718,6 +1184,7 @@ void P2PComm::AcceptConnectionCallback([[gnu::unused]] evconnlistener* listener,
 
     // Close the socket
     evutil_closesocket(cli_sock);
+    m_peerConnectionCount.Remove(from.GetIpAddress());
 
     return;
   }
@@ -740,18 +1207,6 @@ void P2PComm::StartMessagePump(uint32_t listen_port_host,
                                Dispatcher dispatcher) {
   LOG_MARKER();
 
-  // Launch the thread that reads messages from the send queue
-  auto funcCheckSendQueue = [this]() mutable -> void {
-    SendJob* job = NULL;
-    while (true) {
-      while (m_sendQueue.pop(job)) {
-        ProcessSendJob(job);
-      }
-      std::this_thread::sleep_for(std::chrono::microseconds(1));
-    }
-  };
-  DetachedFunction(1, funcCheckSendQueue);
-
   m_dispatcher = move(dispatcher);
 
   struct sockaddr_in serv_addr {};
@@ -760,6 +1215,28 @@ void P2PComm::StartMessagePump(uint32_t listen_port_host,
   serv_addr.sin_port = htons(listen_port_host);
   serv_addr.sin_addr.s_addr = INADDR_ANY;
 
+  // Each loop owns the connections its listener accepts, and the kernel
+  // spreads the incoming connections over the listeners sharing the port
+  unsigned int numLoops = max(P2P_RECEIVE_THREADS, 1U);
+#ifndef LEV_OPT_REUSEABLE_PORT
+  if (numLoops > 1) {
+    LOG_GENERAL(WARNING, "libevent has no SO_REUSEPORT listeners, "
+                         "receiving on one thread");
+    numLoops = 1;
+  }
+#endif  // LEV_OPT_REUSEABLE_PORT
+
+  for (unsigned int i = 1; i < numLoops; i++) {
+    DetachedExecutor::GetInstance().RunLongRunning(
+        "ReceiveLoop", [serv_addr]() { RunReceiveLoop(serv_addr, true); });
+  }
+  RunReceiveLoop(serv_addr, numLoops > 1);
+}
+
+void P2PComm::RunReceiveLoop(const struct sockaddr_in& serv_addr,
+                             bool reusePort) {
+  ThreadAffinity::Apply("ReceiveLoop");
+
   // Create the listener
   struct event_base* base = event_base_new();
   if (base == NULL) {
@@ -768,10 +1245,16 @@ void P2PComm::StartMessagePump(uint32_t listen_port_host,
     return;
   }
 
+  unsigned int flags = LEV_OPT_REUSEABLE | LEV_OPT_CLOSE_ON_FREE;
+#ifdef LEV_OPT_REUSEABLE_PORT
+  if (reusePort) {
+    flags |= LEV_OPT_REUSEABLE_PORT;
+  }
+#endif  // LEV_OPT_REUSEABLE_PORT
+
   struct evconnlistener* listener = evconnlistener_new_bind(
-      base, AcceptConnectionCallback, nullptr,
-      LEV_OPT_REUSEABLE | LEV_OPT_CLOSE_ON_FREE, -1,
-      (struct sockaddr*)&serv_addr, sizeof(struct sockaddr_in));
+      base, AcceptConnectionCallback, nullptr, flags, -1,
+      (const struct sockaddr*)&serv_addr, sizeof(struct sockaddr_in));
 
   if (listener == NULL) {
     LOG_GENERAL(WARNING, "evconnlistener_new_bind failure.");
@@ -785,27 +1268,52 @@ void P2PComm::StartMessagePump(uint32_t listen_port_host,
   event_base_free(base);
 }
 
+void P2PComm::SetSendInterceptor(const SendInterceptor& interceptor) {
+  lock_guard<mutex> g(m_mutexSendInterceptor);
+  m_sendInterceptor = interceptor;
+  m_hasSendInterceptor = static_cast<bool>(interceptor);
+}
+
+P2PComm::SendInterceptor P2PComm::GetSendInterceptor() {
+  if (!m_hasSendInterceptor) {
+    return nullptr;
+  }
+  lock_guard<mutex> g(m_mutexSendInterceptor);
+  return m_sendInterceptor;
+}
+
+template <class Container>
+bool P2PComm::InterceptSend(const Container& peers, const bytes& message) {
+  const SendInterceptor interceptor = GetSendInterceptor();
+  if (!interceptor) {
+    return false;
+  }
+  for (const auto& peer : peers) {
+    interceptor(peer, message);
+  }
+  return true;
+}
+
+bool P2PComm::InterceptSend(const Peer& peer, const bytes& message) {
+  const SendInterceptor interceptor = GetSendInterceptor();
+  if (!interceptor) {
+    return false;
+  }
+  interceptor(peer, message);
+  return true;
+}
+
 void P2PComm::SendMessage(const vector<Peer>& peers, const bytes& message,
                           const unsigned char& startByteType) {
   // LOG_MARKER();
 
-  if (peers.empty()) {
+  if (peers.empty() || InterceptSend(peers, message)) {
     return;
   }
 
-  // Make job
-  SendJob* job = new SendJobPeers<vector<Peer>>;
-  dynamic_cast<SendJobPeers<vector<Peer>>*>(job)->m_peers = peers;
-  job->m_selfPeer = m_selfPeer;
-  job->m_startbyte = startByteType;
-  job->m_message = message;
-  job->m_hash.clear();
-  job->m_allowSendToRelaxedBlacklist = false;
-
-  // Queue job
-  if (!m_sendQueue.bounded_push(job)) {
-    LOG_GENERAL(WARNING, "SendQueue is full");
-  }
+  QueueSendJobs(
+      peers, make_shared<const MessageFrame>(message, startByteType, bytes()),
+      false);
 }
 
 void P2PComm::SendMessage(const deque<Peer>& peers, const bytes& message,
@@ -813,110 +1321,77 @@ void P2PComm::SendMessage(const deque<Peer>& peers, const bytes& message,
                           const bool bAllowSendToRelaxedBlacklist) {
   // LOG_MARKER();
 
-  if (peers.empty()) {
+  if (peers.empty() || InterceptSend(peers, message)) {
     return;
   }
 
-  // Make job
-  SendJob* job = new SendJobPeers<deque<Peer>>;
-  dynamic_cast<SendJobPeers<deque<Peer>>*>(job)->m_peers = peers;
-  job->m_selfPeer = m_selfPeer;
-  job->m_startbyte = startByteType;
-  job->m_message = message;
-  job->m_hash.clear();
-  job->m_allowSendToRelaxedBlacklist = bAllowSendToRelaxedBlacklist;
-
-  // Queue job
-  if (!m_sendQueue.bounded_push(job)) {
-    LOG_GENERAL(WARNING, "SendQueue is full");
-  }
+  QueueSendJobs(
+      peers, make_shared<const MessageFrame>(message, startByteType, bytes()),
+      bAllowSendToRelaxedBlacklist);
 }
 
 void P2PComm::SendMessage(const Peer& peer, const bytes& message,
                           const unsigned char& startByteType) {
   // LOG_MARKER();
 
+  if (InterceptSend(peer, message)) {
+    return;
+  }
+
   // Make job
-  SendJob* job = new SendJobPeer;
-  dynamic_cast<SendJobPeer*>(job)->m_peer = peer;
-  job->m_selfPeer = m_selfPeer;
-  job->m_startbyte = startByteType;
-  job->m_message = message;
-  job->m_hash.clear();
+  SendJob* job = new SendJob;
+  job->m_peer = peer;
+  job->m_frame =
+      make_shared<const MessageFrame>(message, startByteType, bytes());
   job->m_allowSendToRelaxedBlacklist = false;
 
-  // Queue job
-  if (!m_sendQueue.bounded_push(job)) {
-    LOG_GENERAL(WARNING, "SendQueue is full");
-  }
+  QueueSendJob(job);
 }
 
 void P2PComm::SendBroadcastMessage(const vector<Peer>& peers,
                                    const bytes& message) {
   LOG_MARKER();
 
-  if (peers.empty()) {
+  if (peers.empty() || InterceptSend(peers, message)) {
     return;
   }
 
   SHA2<HashType::HASH_VARIANT_256> sha256;
   sha256.Update(message);
 
-  // Make job
-  SendJob* job = new SendJobPeers<vector<Peer>>;
-  dynamic_cast<SendJobPeers<vector<Peer>>*>(job)->m_peers = peers;
-  job->m_selfPeer = m_selfPeer;
-  job->m_startbyte = START_BYTE_BROADCAST;
-  job->m_message = message;
-  job->m_hash = sha256.Finalize();
-  job->m_allowSendToRelaxedBlacklist = false;
-
-  bytes hashCopy(job->m_hash);
-
-  // Queue job
-  if (!m_sendQueue.bounded_push(job)) {
-    LOG_GENERAL(WARNING, "SendQueue is full");
-  }
+  const auto frame = make_shared<const MessageFrame>(
+      message, START_BYTE_BROADCAST, sha256.Finalize());
+  QueueSendJobs(peers, frame, false);
 
-  lock_guard<mutex> guard(m_broadcastHashesMutex);
-  m_broadcastHashes.insert(hashCopy);
+  m_broadcastHashes.Insert(frame->GetHash());
 }
 
 void P2PComm::SendBroadcastMessage(const deque<Peer>& peers,
                                    const bytes& message) {
   LOG_MARKER();
 
-  if (peers.empty()) {
+  if (peers.empty() || InterceptSend(peers, message)) {
     return;
   }
 
   SHA2<HashType::HASH_VARIANT_256> sha256;
   sha256.Update(message);
 
-  // Make job
-  SendJob* job = new SendJobPeers<deque<Peer>>;
-  dynamic_cast<SendJobPeers<deque<Peer>>*>(job)->m_peers = peers;
-  job->m_selfPeer = m_selfPeer;
-  job->m_startbyte = START_BYTE_BROADCAST;
-  job->m_message = message;
-  job->m_hash = sha256.Finalize();
-  job->m_allowSendToRelaxedBlacklist = false;
-
-  bytes hashCopy(job->m_hash);
-
-  // Queue job
-  if (!m_sendQueue.bounded_push(job)) {
-    LOG_GENERAL(WARNING, "SendQueue is full");
-  }
+  const auto frame = make_shared<const MessageFrame>(
+      message, START_BYTE_BROADCAST, sha256.Finalize());
+  QueueSendJobs(peers, frame, false);
 
-  lock_guard<mutex> guard(m_broadcastHashesMutex);
-  m_broadcastHashes.insert(hashCopy);
+  m_broadcastHashes.Insert(frame->GetHash());
 }
 
 void P2PComm::SendMessageNoQueue(const Peer& peer, const bytes& message,
                                  const unsigned char& startByteType) {
   // LOG_MARKER();
 
+  if (InterceptSend(peer, message)) {
+    return;
+  }
+
   if (Blacklist::GetInstance().Exist(peer.m_ipAddress)) {
     LOG_GENERAL(INFO, "The node "
                           << peer
@@ -924,7 +1399,22 @@ void P2PComm::SendMessageNoQueue(const Peer& peer, const bytes& message,
     return;
   }
 
-  SendJob::SendMessageCore(peer, message, startByteType, {});
+  const auto verdict = m_peerHealth.Check(peer);
+  if (verdict == PeerHealth::Verdict::SKIP) {
+    LOG_GENERAL(INFO, peer << " is unreachable - skipping the message");
+    return;
+  }
+
+  const auto frame =
+      make_shared<const MessageFrame>(message, startByteType, bytes());
+  m_peerHealth.Record(
+      peer, SendJob::SendMessageCore(
+                peer, {frame},
+                verdict == PeerHealth::Verdict::PROBE ? 0 : MAXRETRYCONN));
+  if (ENABLE_TRAFFIC_STATS) {
+    TrafficStats::GetInstance().Record(
+        true, peer.m_ipAddress, GetTrafficType(*frame), frame->GetSize());
+  }
 }
 
 bool P2PComm::SpreadRumor(const bytes& message) {
@@ -19,15 +19,26 @@
 #define ZILLIQA_SRC_LIBNETWORK_P2PCOMM_H_
 
 #include <event2/util.h>
-#include <boost/lockfree/queue.hpp>
+#include <json/json.h>
+#include <atomic>
+#include <chrono>
 #include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <vector>
 
+#include "AsyncSender.h"
+#include "BroadcastHashFilter.h"
+#include "ConnectionCounter.h"
+#include "ConnectionPool.h"
+#include "EgressShaper.h"
 #include "Peer.h"
+#include "PeerHealth.h"
 #include "RumorManager.h"
+#include "SendOutboxes.h"
+#include "SignatureBatchVerifier.h"
 #include "common/BaseType.h"
 #include "common/Constants.h"
 #include "libUtils/Logger.h"
@@ -38,55 +49,13 @@ struct evconnlistener;
 extern const unsigned char START_BYTE_NORMAL;
 extern const unsigned char START_BYTE_GOSSIP;
 
-class SendJob {
- protected:
-  static uint32_t writeMsg(const void* buf, int cli_sock, const Peer& from,
-                           const uint32_t message_length);
-  static bool SendMessageSocketCore(const Peer& peer, const bytes& message,
-                                    unsigned char start_byte,
-                                    const bytes& msg_hash);
-
- public:
-  Peer m_selfPeer;
-  unsigned char m_startbyte{};
-  bytes m_message;
-  bytes m_hash;
-  bool m_allowSendToRelaxedBlacklist{};
-
-  static void SendMessageCore(const Peer& peer, const bytes& message,
-                              unsigned char startbyte, const bytes& hash);
-
-  virtual ~SendJob() {}
-  virtual void DoSend() = 0;
-};
-
-class SendJobPeer : public SendJob {
- public:
-  Peer m_peer;
-  void DoSend();
-};
-
-template <class T>
-class SendJobPeers : public SendJob {
- public:
-  T m_peers;
-  void DoSend();
-};
-
 /// Provides network layer functionality.
 class P2PComm {
-  std::set<bytes> m_broadcastHashes;
-  std::mutex m_broadcastHashesMutex;
-  std::deque<
-      std::pair<bytes, std::chrono::time_point<std::chrono::system_clock>>>
-      m_broadcastToRemove;
-  std::mutex m_broadcastToRemoveMutex;
+  BroadcastHashFilter m_broadcastHashes{BROADCAST_INTERVAL, BROADCAST_EXPIRY};
   RumorManager m_rumorManager;
 
   const static uint32_t MAXPUMPMESSAGE = 128;
 
-  void ClearBroadcastHashAsync(const bytes& message_hash);
-
   P2PComm();
   ~P2PComm();
 
@@ -100,17 +69,58 @@ class P2PComm {
   Peer m_selfPeer;
   PairOfKey m_selfKey;
 
-  static std::mutex m_mutexPeerConnectionCount;
-  static std::map<uint128_t, uint16_t> m_peerConnectionCount;
+  static ConnectionCounter m_peerConnectionCount;
 
   ThreadPool m_SendPool{MAXMESSAGE, "SendPool"};
 
-  boost::lockfree::queue<SendJob*> m_sendQueue;
-  void ProcessSendJob(SendJob* job);
+  ConnectionPool m_connectionPool{CONNECTION_POOL_MAX_PER_PEER,
+                                  CONNECTION_POOL_IDLE_TIMEOUT,
+                                  CONNECTION_POOL_WAIT_MILLISECONDS};
+
+  std::unique_ptr<SignatureBatchVerifier> m_gossipVerifier;
+
+  // Large messages are written from here when ENABLE_ASYNC_SEND is set
+  std::unique_ptr<AsyncSender> m_asyncSender;
+
+  SendOutboxes m_outboxes{SENDQUEUE_SIZE};
+  // Skips the peers that keep failing, so that they do not hold the threads
+  PeerHealth m_peerHealth{
+      PEER_HEALTH_FAILURE_THRESHOLD,
+      std::chrono::milliseconds(PEER_HEALTH_MIN_BACKOFF_IN_MS),
+      std::chrono::milliseconds(PEER_HEALTH_MAX_BACKOFF_IN_MS)};
+  // Shared by the bulk messages to all peers
+  EgressShaper m_bulkShaper{
+      static_cast<double>(EGRESS_BULK_RATE_IN_BYTES_PER_SEC),
+      EGRESS_BULK_BURST_IN_BYTES};
+
+  /// Queues a job in the outbox of its peer. Once the outbox holds
+  /// SENDQUEUE_SIZE jobs, the newest job of a lower class makes room, or the
+  /// job is dropped if there is none.
+  void QueueSendJob(SendJob* job);
+  template <class Container>
+  void QueueSendJobs(const Container& peers, const MessageFramePtr& frame,
+                     bool allowSendToRelaxedBlacklist);
+  void ScheduleDrain(const Peer& peer, SendClass sendClass);
+  /// Sends the first job of the highest class, along with the small jobs
+  /// behind it, then schedules itself again if the outbox is not empty. Bulk
+  /// jobs the shaper holds back are retried once it has the tokens, or as soon
+  /// as a job of a higher class arrives.
+  void DrainOutbox(const Peer& peer);
+  /// Schedules the drain of an outbox held back by the bulk shaper
+  void ResumeThrottled(const Peer& peer);
+  /// Counts and frees the jobs sent by DrainOutbox, and schedules the next
+  /// drain of the outbox
+  void FinishDrain(const Peer& peer,
+                   std::vector<std::unique_ptr<SendJob>>& jobs, bool blocked);
 
   static void ProcessBroadCastMsg(bytes& message, const Peer& from);
   static void ProcessGossipMsg(bytes& message, Peer& from);
+  static void ProcessRumor(unsigned char gossipMsgTyp, uint32_t gossipMsgRound,
+                           const bytes& rumor_message, const Peer& from,
+                           bool isSignatureVerified);
 
+  static void ProcessReceivedMessage(bytes& message, Peer& from);
+  static bool DecompressMessage(bytes& message);
   static void EventCallback(struct bufferevent* bev, short events, void* ctx);
   static void ReadCallback(struct bufferevent* bev, void* ctx);
   static void AcceptConnectionCallback(evconnlistener* listener,
@@ -119,6 +129,10 @@ class P2PComm {
                                        void* arg);
   static void CloseAndFreeBufferEvent(struct bufferevent* bufev);
 
+  /// Accepts and reads connections on a listener of its own until it fails
+  static void RunReceiveLoop(const struct sockaddr_in& serv_addr,
+                             bool reusePort);
+
  public:
   /// Returns the singleton P2PComm instance.
   static P2PComm& GetInstance();
@@ -134,7 +148,30 @@ class P2PComm {
   inline static bool IsNodeNotRunning();
   static void ClearPeerConnectionCount();
 
+  /// Returns the jobs waiting, sent and dropped for each class of message.
+  Json::Value GetSendQueueStats();
+
+  /// Returns the pool of reusable outgoing connections.
+  ConnectionPool& GetConnectionPool() { return m_connectionPool; }
+
+  using SendInterceptor =
+      std::function<void(const Peer& peer, const bytes& message)>;
+
+  /// Hands all outgoing messages to the interceptor instead of the network
+  /// (used by in-process simulations and replays). Pass nullptr to restore.
+  void SetSendInterceptor(const SendInterceptor& interceptor);
+
  private:
+  std::mutex m_mutexSendInterceptor;
+  SendInterceptor m_sendInterceptor;
+  // Checked before taking the lock, so that sends pay nothing without one
+  std::atomic<bool> m_hasSendInterceptor{false};
+  /// The interceptor set, or an empty one
+  SendInterceptor GetSendInterceptor();
+  template <class Container>
+  bool InterceptSend(const Container& peers, const bytes& message);
+  bool InterceptSend(const Peer& peer, const bytes& message);
+
   using SocketCloser = std::unique_ptr<int, void (*)(int*)>;
   static Dispatcher m_dispatcher;
   static BroadcastListFunc m_broadcast_list_retriever;
@@ -178,6 +215,8 @@ class P2PComm {
 
   void SetSelfPeer(const Peer& self);
 
+  const Peer& GetSelfPeer() const { return m_selfPeer; }
+
   void SetSelfKey(const PairOfKey& self);
 
   bool SpreadRumor(const bytes& message);
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PeerHealth.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+PeerHealth::PeerHealth(unsigned int failureThreshold,
+                       const chrono::milliseconds& minBackoff,
+                       const chrono::milliseconds& maxBackoff)
+    : m_failureThreshold(failureThreshold),
+      m_minBackoff(minBackoff),
+      m_maxBackoff(max(minBackoff, maxBackoff)) {}
+
+chrono::milliseconds PeerHealth::GetBackoff(unsigned int failures) const {
+  chrono::milliseconds backoff = m_minBackoff;
+  for (unsigned int i = m_failureThreshold; i < failures; ++i) {
+    backoff *= 2;
+    if (backoff >= m_maxBackoff) {
+      return m_maxBackoff;
+    }
+  }
+  return backoff;
+}
+
+void PeerHealth::DropExpired(const Clock::time_point& now) {
+  for (auto it = m_entries.begin(); it != m_entries.end();) {
+    if (!it->second.m_probing && it->second.m_retryAt <= now) {
+      it = m_entries.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+PeerHealth::Verdict PeerHealth::Check(const Peer& peer,
+                                      const Clock::time_point& now) {
+  if (m_failureThreshold == 0) {
+    return Verdict::SEND;
+  }
+
+  lock_guard<mutex> g(m_mutex);
+  auto it = m_entries.find(peer);
+  if (it == m_entries.end() || it->second.m_failures < m_failureThreshold) {
+    return Verdict::SEND;
+  }
+
+  Entry& entry = it->second;
+  if (entry.m_probing || now < entry.m_retryAt) {
+    m_skipped++;
+    return Verdict::SKIP;
+  }
+  entry.m_probing = true;
+  m_probes++;
+  return Verdict::PROBE;
+}
+
+void PeerHealth::Record(const Peer& peer, bool success,
+                        const Clock::time_point& now) {
+  if (m_failureThreshold == 0) {
+    return;
+  }
+
+  lock_guard<mutex> g(m_mutex);
+  auto it = m_entries.find(peer);
+  if (success) {
+    if (it != m_entries.end()) {
+      if (it->second.m_failures >= m_failureThreshold) {
+        LOG_GENERAL(INFO, peer << " is reachable again");
+      }
+      m_entries.erase(it);
+    }
+    return;
+  }
+
+  if (it == m_entries.end()) {
+    if (m_entries.size() >= MAX_PEERS) {
+      DropExpired(now);
+    }
+    it = m_entries.emplace(peer, Entry()).first;
+  }
+
+  Entry& entry = it->second;
+  entry.m_failures++;
+  entry.m_probing = false;
+  if (entry.m_failures >= m_failureThreshold) {
+    const auto backoff = GetBackoff(entry.m_failures);
+    entry.m_retryAt = now + backoff;
+    LOG_GENERAL(WARNING, peer << " failed " << entry.m_failures
+                              << " sends in a row, skipping it for "
+                              << backoff.count() << " ms");
+  }
+}
+
+unsigned int PeerHealth::GetDownCount(const Clock::time_point& now) {
+  lock_guard<mutex> g(m_mutex);
+  unsigned int count = 0;
+  for (const auto& it : m_entries) {
+    if (it.second.m_failures >= m_failureThreshold &&
+        (it.second.m_probing || now < it.second.m_retryAt)) {
+      count++;
+    }
+  }
+  return count;
+}
+
+void PeerHealth::Clear() {
+  lock_guard<mutex> g(m_mutex);
+  m_entries.clear();
+}
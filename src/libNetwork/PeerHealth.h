@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_PEERHEALTH_H_
+#define ZILLIQA_SRC_LIBNETWORK_PEERHEALTH_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+#include "Peer.h"
+
+/// Circuit breaker per peer. Once failureThreshold sends to a peer have
+/// failed in a row, sends to it are skipped for a backoff that starts at
+/// minBackoff and doubles with each further failure, up to maxBackoff. When
+/// the backoff is over, one send is let through as a probe, without retries,
+/// while the others are still skipped. A successful send closes the breaker.
+/// A threshold of 0 never skips.
+class PeerHealth {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  enum class Verdict : unsigned char { SEND, PROBE, SKIP };
+
+  /// Peers beyond which those whose backoff is over are forgotten
+  static const size_t MAX_PEERS = 4096;
+
+ private:
+  struct Entry {
+    unsigned int m_failures{0};
+    Clock::time_point m_retryAt;
+    bool m_probing{false};
+  };
+
+  const unsigned int m_failureThreshold;
+  const std::chrono::milliseconds m_minBackoff;
+  const std::chrono::milliseconds m_maxBackoff;
+
+  std::mutex m_mutex;
+  std::map<Peer, Entry> m_entries;
+  std::atomic<uint64_t> m_skipped{0};
+  std::atomic<uint64_t> m_probes{0};
+
+  std::chrono::milliseconds GetBackoff(unsigned int failures) const;
+  void DropExpired(const Clock::time_point& now);
+
+ public:
+  PeerHealth(unsigned int failureThreshold,
+             const std::chrono::milliseconds& minBackoff,
+             const std::chrono::milliseconds& maxBackoff);
+
+  PeerHealth(const PeerHealth&) = delete;
+  PeerHealth& operator=(const PeerHealth&) = delete;
+
+  /// Tells whether to send to peer now, as a probe, or not at all. A PROBE
+  /// must be followed by Record.
+  Verdict Check(const Peer& peer, const Clock::time_point& now = Clock::now());
+
+  /// Records whether a send to peer went through
+  void Record(const Peer& peer, bool success,
+              const Clock::time_point& now = Clock::now());
+
+  /// Returns the number of peers whose sends are being skipped
+  unsigned int GetDownCount(const Clock::time_point& now = Clock::now());
+
+  uint64_t GetSkipped() const { return m_skipped; }
+  uint64_t GetProbes() const { return m_probes; }
+
+  void Clear();
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_PEERHEALTH_H_
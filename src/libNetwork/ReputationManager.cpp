@@ -15,6 +15,8 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include "ReputationManager.h"
 
 #include "Blacklist.h"
@@ -46,56 +48,77 @@ void ReputationManager::PunishNode(const uint128_t& IPAddress,
 }
 
 void ReputationManager::AwardAllNodes() {
-  std::vector<uint128_t> AllKnownIPs = GetAllKnownIP();
-  for (const auto& ip : AllKnownIPs) {
-    AwardNode(ip);
+  std::vector<uint128_t> recoveredIPs;
+  {
+    std::lock_guard<std::mutex> lock(m_mutexReputations);
+    m_awardRound++;
+
+    // Only banned nodes need to be visited now, everyone else catches up on
+    // their next access
+    for (auto it = m_bannedIPs.begin(); it != m_bannedIPs.end();) {
+      if (GetReputationInternal(*it).m_score > REPTHRESHOLD) {
+        recoveredIPs.emplace_back(*it);
+        it = m_bannedIPs.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  for (const auto& ip : recoveredIPs) {
+    if (Blacklist::GetInstance().Exist(ip)) {
+      LOG_GENERAL(INFO, "Node " << IPConverter::ToStrFromNumericalIP(ip)
+                                << " unbanned.");
+      Blacklist::GetInstance().Remove(ip);
+    }
   }
 }
 
 void ReputationManager::AddNodeIfNotKnown(const uint128_t& IPAddress) {
   std::lock_guard<std::mutex> lock(m_mutexReputations);
-  AddNodeIfNotKnownInternal(IPAddress);
+  GetReputationInternal(IPAddress);
 }
 
-void ReputationManager::AddNodeIfNotKnownInternal(const uint128_t& IPAddress) {
-  if (m_Reputations.find(IPAddress) == m_Reputations.end()) {
-    m_Reputations.emplace(IPAddress, ScoreType::GOOD);
+ReputationManager::Reputation& ReputationManager::GetReputationInternal(
+    const uint128_t& IPAddress) {
+  auto it = m_Reputations.find(IPAddress);
+  if (it == m_Reputations.end()) {
+    it = m_Reputations
+             .emplace(IPAddress, Reputation{ScoreType::GOOD, m_awardRound})
+             .first;
+  }
+
+  Reputation& rep = it->second;
+  if (rep.m_awardRound < m_awardRound) {
+    // Apply the award rounds missed since the last access
+    const uint64_t missed = m_awardRound - rep.m_awardRound;
+    const uint64_t headroom =
+        static_cast<int64_t>(UPPERREPTHRESHOLD) - rep.m_score;
+    rep.m_score += static_cast<int32_t>(
+        std::min<uint64_t>(missed * AWARD_FOR_GOOD_NODES, headroom));
+    rep.m_awardRound = m_awardRound;
   }
+  return rep;
 }
 
 int32_t ReputationManager::GetReputation(const uint128_t& IPAddress) {
   std::lock_guard<std::mutex> lock(m_mutexReputations);
-  AddNodeIfNotKnownInternal(IPAddress);
-  return m_Reputations[IPAddress];
+  return GetReputationInternal(IPAddress).m_score;
 }
 
 void ReputationManager::Clear() {
   LOG_MARKER();
   std::lock_guard<std::mutex> lock(m_mutexReputations);
   m_Reputations.clear();
-}
-
-void ReputationManager::SetReputation(const uint128_t& IPAddress,
-                                      const int32_t ReputationScore) {
-  std::lock_guard<std::mutex> lock(m_mutexReputations);
-  AddNodeIfNotKnownInternal(IPAddress);
-
-  if (ReputationScore > ScoreType::UPPERREPTHRESHOLD) {
-    LOG_GENERAL(
-        WARNING,
-        "Reputation score too high. Exceed upper bound. ReputationScore: "
-            << ReputationScore << ". Setting reputation to "
-            << ScoreType::UPPERREPTHRESHOLD);
-    m_Reputations[IPAddress] = ScoreType::UPPERREPTHRESHOLD;
-    return;
-  }
-
-  m_Reputations[IPAddress] = ReputationScore;
+  m_bannedIPs.clear();
+  m_awardRound = 0;
 }
 
 void ReputationManager::UpdateReputation(const uint128_t& IPAddress,
                                          const int32_t ReputationScoreDelta) {
-  int32_t NewRep = GetReputation(IPAddress);
+  std::lock_guard<std::mutex> lock(m_mutexReputations);
+  Reputation& rep = GetReputationInternal(IPAddress);
+  int32_t NewRep = rep.m_score;
 
   // Update result with score delta
   if (!(SafeMath<int32_t>::add(NewRep, ReputationScoreDelta, NewRep))) {
@@ -103,32 +126,27 @@ void ReputationManager::UpdateReputation(const uint128_t& IPAddress,
   }
 
   // Further deduct score if node is going to be ban
-  if (NewRep <= REPTHRESHOLD && !IsNodeBanned(IPAddress)) {
+  if (NewRep <= REPTHRESHOLD && rep.m_score > REPTHRESHOLD) {
     if (!(SafeMath<int32_t>::sub(
             NewRep, ScoreType::BAN_MULTIPLIER * ScoreType::AWARD_FOR_GOOD_NODES,
             NewRep))) {
       LOG_GENERAL(WARNING, "Underflow detected.");
     }
   }
-  SetReputation(IPAddress, NewRep);
-}
-
-std::vector<uint128_t> ReputationManager::GetAllKnownIP() {
-  std::lock_guard<std::mutex> lock(m_mutexReputations);
 
-  std::vector<uint128_t> AllKnownIPs;
-  for (const auto& node : m_Reputations) {
-    AllKnownIPs.emplace_back(node.first);
+  if (NewRep > ScoreType::UPPERREPTHRESHOLD) {
+    LOG_GENERAL(
+        WARNING,
+        "Reputation score too high. Exceed upper bound. ReputationScore: "
+            << NewRep << ". Setting reputation to "
+            << ScoreType::UPPERREPTHRESHOLD);
+    NewRep = ScoreType::UPPERREPTHRESHOLD;
   }
-  return AllKnownIPs;
-}
-
-void ReputationManager::AwardNode(const uint128_t& IPAddress) {
-  UpdateReputation(IPAddress, ScoreType::AWARD_FOR_GOOD_NODES);
+  rep.m_score = NewRep;
 
-  if (Blacklist::GetInstance().Exist(IPAddress) && !IsNodeBanned(IPAddress)) {
-    LOG_GENERAL(INFO, "Node " << IPConverter::ToStrFromNumericalIP(IPAddress)
-                              << " unbanned.");
-    Blacklist::GetInstance().Remove(IPAddress);
+  if (NewRep <= REPTHRESHOLD) {
+    m_bannedIPs.insert(IPAddress);
+  } else {
+    m_bannedIPs.erase(IPAddress);
   }
 }
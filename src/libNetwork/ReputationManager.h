@@ -18,25 +18,17 @@
 #ifndef ZILLIQA_SRC_LIBNETWORK_REPUTATIONMANAGER_H_
 #define ZILLIQA_SRC_LIBNETWORK_REPUTATIONMANAGER_H_
 
+#include "Blacklist.h"
 #include "Peer.h"
 #include "common/Constants.h"
 
 #include <functional>
 #include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class ReputationManager {
-  // Custom hasher
-  // Ref:
-  // https://stackoverflow.com/questions/32082786/why-i-cannot-use-neither-stdunordered-map-nor-boostunordered-map-with-boost
-  template <typename T>
-  struct HashStr {
-    size_t operator()(const T& t) const {
-      return std::hash<std::string>()(t.str());
-    }
-  };
-
   ReputationManager();
   ~ReputationManager();
 
@@ -71,14 +63,20 @@ class ReputationManager {
   std::mutex m_mutexReputations;
 
  private:
-  std::unordered_map<uint128_t, int32_t, HashStr<uint128_t>> m_Reputations;
+  // Awards are applied lazily: each entry remembers the last award round it
+  // has seen and catches up the next time it is accessed
+  struct Reputation {
+    int32_t m_score;
+    uint64_t m_awardRound;
+  };
+
+  std::unordered_map<uint128_t, Reputation> m_Reputations;
+  std::unordered_set<uint128_t> m_bannedIPs;
+  uint64_t m_awardRound{0};
 
-  void AddNodeIfNotKnownInternal(const uint128_t& IPAddress);
-  void SetReputation(const uint128_t& IPAddress, const int32_t ReputationScore);
+  Reputation& GetReputationInternal(const uint128_t& IPAddress);
   void UpdateReputation(const uint128_t& IPAddress,
                         const int32_t ReputationScoreDelta);
-  std::vector<uint128_t> GetAllKnownIP();
-  void AwardNode(const uint128_t& IPAddress);
 };
 
 #endif  // ZILLIQA_SRC_LIBNETWORK_REPUTATIONMANAGER_H_
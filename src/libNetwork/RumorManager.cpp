@@ -26,6 +26,7 @@
 #include "libCrypto/Sha2.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/HashUtils.h"
+#include "libUtils/ThreadAffinity.h"
 
 namespace {
 RRS::Message::Type convertType(uint8_t type) {
@@ -36,6 +37,11 @@ RRS::Message::Type convertType(uint8_t type) {
   }
 }
 
+// Batch layout: [count] followed by [type][rounds][length][payload] entries
+const unsigned int BATCH_COUNT_LEN = sizeof(uint32_t);
+const unsigned int BATCH_ENTRY_HDR_LEN =
+    sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t);
+
 }  // anonymous namespace
 
 // CONSTRUCTORS
@@ -67,6 +73,7 @@ void RumorManager::StartRounds() {
   }
 
   std::thread([&]() {
+    ThreadAffinity::Apply("Rumor");
     unsigned int rounds = 0;
     while (true) {
       std::unique_lock<std::mutex> guard(m_continueRoundMutex);
@@ -360,55 +367,62 @@ void RumorManager::SendRumorToForeignPeer(const Peer& toForeignPeer,
   P2PComm::GetInstance().SendMessage(toForeignPeer, cmd, START_BYTE_GOSSIP);
 }
 
-std::pair<bool, RumorManager::RawBytes> RumorManager::VerifyMessage(
-    const RawBytes& message, const RRS::Message::Type& t, const Peer& from) {
-  bytes message_wo_keysig;
+bool RumorManager::VerifyKeyAndSignature(const RawBytes& message,
+                                         const Peer& from,
+                                         RawBytes& message_wo_keysig,
+                                         bool isSignatureVerified) {
+  // verify if the pubkey is from with-in our network
+  PubKey senderPubKey;
+  if (!senderPubKey.Deserialize(message, 0)) {
+    return false;
+  }
 
-  if (((RRS::Message::Type::EMPTY_PUSH == t ||
-        RRS::Message::Type::EMPTY_PULL == t) &&
-       SIGN_VERIFY_EMPTY_MSGTYP) ||
-      ((RRS::Message::Type::LAZY_PUSH == t ||
-        RRS::Message::Type::LAZY_PULL == t || RRS::Message::Type::PUSH == t ||
-        RRS::Message::Type::PULL == t) &&
-       SIGN_VERIFY_NONEMPTY_MSGTYP)) {
-    // verify if the pubkey is from with-in our network
-    PubKey senderPubKey;
-    if (!senderPubKey.Deserialize(message, 0)) {
-      return {false, {}};
-    }
+  // Verify if the pub key of sender (myview) is same as pubkey received in
+  // message
+  auto k = m_pubKeyPeerBiMap.right.find(from);
+  if (k == m_pubKeyPeerBiMap.right.end()) {
+    // I dont know this peer, missing in my peerlist.
+    LOG_GENERAL(DEBUG, "Received Rumor from peer : "
+                           << from
+                           << " whose pubkey does not exist in my store");
+    return false;
+  } else if (!(k->second == senderPubKey)) {
+    LOG_GENERAL(WARNING,
+                "Public Key of sender does not exist in my list. so ignoring "
+                "message");
+    return false;
+  }
 
-    // Verify if the pub key of sender (myview) is same as pubkey received in
-    // message
-    auto k = m_pubKeyPeerBiMap.right.find(from);
-    if (k == m_pubKeyPeerBiMap.right.end()) {
-      // I dont know this peer, missing in my peerlist.
-      LOG_GENERAL(DEBUG, "Received Rumor from peer : "
-                             << from
-                             << " whose pubkey does not exist in my store");
-      return {false, {}};
-    } else if (!(k->second == senderPubKey)) {
-      LOG_GENERAL(WARNING,
-                  "Public Key of sender does not exist in my list. so ignoring "
-                  "message");
-      return {false, {}};
-    }
+  // verify if signature matches the one in message.
+  Signature toVerify;
+  if (!toVerify.Deserialize(message, PUB_KEY_SIZE)) {
+    return false;
+  }
 
-    // verify if signature matches the one in message.
-    Signature toVerify;
-    if (!toVerify.Deserialize(message, PUB_KEY_SIZE)) {
-      return {false, {}};
-    }
+  message_wo_keysig.insert(message_wo_keysig.end(),
+                           message.begin() + PUB_KEY_SIZE +
+                               SIGNATURE_CHALLENGE_SIZE +
+                               SIGNATURE_RESPONSE_SIZE,
+                           message.end());
 
-    message_wo_keysig.insert(message_wo_keysig.end(),
-                             message.begin() + PUB_KEY_SIZE +
-                                 SIGNATURE_CHALLENGE_SIZE +
-                                 SIGNATURE_RESPONSE_SIZE,
-                             message.end());
+  if (!isSignatureVerified &&
+      !P2PComm::GetInstance().VerifyMessage(message_wo_keysig, toVerify,
+                                            senderPubKey)) {
+    LOG_GENERAL(WARNING, "Signature verification failed. so ignoring message");
+    return false;
+  }
 
-    if (!P2PComm::GetInstance().VerifyMessage(message_wo_keysig, toVerify,
-                                              senderPubKey)) {
-      LOG_GENERAL(WARNING,
-                  "Signature verification failed. so ignoring message");
+  return true;
+}
+
+std::pair<bool, RumorManager::RawBytes> RumorManager::VerifyMessage(
+    const RawBytes& message, const RRS::Message::Type& t, const Peer& from,
+    bool isSignatureVerified) {
+  bytes message_wo_keysig;
+
+  if (IsSignedType(t)) {
+    if (!VerifyKeyAndSignature(message, from, message_wo_keysig,
+                               isSignatureVerified)) {
       return {false, {}};
     }
   } else {
@@ -418,7 +432,8 @@ std::pair<bool, RumorManager::RawBytes> RumorManager::VerifyMessage(
 }
 
 std::pair<bool, RumorManager::RawBytes> RumorManager::RumorReceived(
-    uint8_t type, int32_t round, const RawBytes& message, const Peer& from) {
+    uint8_t type, int32_t round, const RawBytes& message, const Peer& from,
+    bool isSignatureVerified) {
   {
     std::lock_guard<std::mutex> guard(m_continueRoundMutex);
     if (!m_continueRound) {
@@ -437,17 +452,81 @@ std::pair<bool, RumorManager::RawBytes> RumorManager::RumorReceived(
     return {false, {}};
   }
 
-  int64_t recvdRumorId = -1;
   RRS::Message::Type t = convertType(type);
-  bool toBeDispatched = false;
 
-  auto result = VerifyMessage(message, t, from);
+  auto result = VerifyMessage(message, t, from, isSignatureVerified);
   if (!result.first) {
     return {false, {}};
   }
-  bytes message_wo_keysig(result.second);
 
-  // All checks passed. Good to accept this rumor
+  std::vector<RRS::Message> responses;
+  auto resp = ProcessRumor(t, round, result.second, from, p->second, responses);
+  SendMessages(from, responses);
+  return resp;
+}
+
+std::vector<RumorManager::RawBytes> RumorManager::RumorBatchReceived(
+    const RawBytes& message, const Peer& from, bool isSignatureVerified) {
+  std::vector<RawBytes> toBeDispatched;
+  {
+    std::lock_guard<std::mutex> guard(m_continueRoundMutex);
+    if (!m_continueRound) {
+      return toBeDispatched;
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+
+  auto p = m_peerIdPeerBimap.right.find(from);
+  if (p == m_peerIdPeerBimap.right.end()) {
+    // I dont know this peer, missing in my peerlist.
+    LOG_GENERAL(DEBUG, "Received Rumor batch from peer : "
+                           << from << " which does not exist in my peerlist.");
+    return toBeDispatched;
+  }
+
+  // The whole batch is covered by a single signature
+  RawBytes batch;
+  if (IsSignedType(RRS::Message::Type::BATCH)) {
+    if (!VerifyKeyAndSignature(message, from, batch, isSignatureVerified)) {
+      return toBeDispatched;
+    }
+  } else {
+    batch = message;
+  }
+
+  // A malformed batch is dropped as a whole
+  std::vector<BatchEntry> entries;
+  if (!ParseBatch(batch, MAX_RUMOR_BATCH_SIZE_IN_BYTES, entries)) {
+    LOG_GENERAL(WARNING, "Malformed rumor batch from " << from);
+    return toBeDispatched;
+  }
+
+  std::vector<RRS::Message> responses;
+  for (const auto& entry : entries) {
+    if (RRS::Message::Type::BATCH == entry.m_type ||
+        RRS::Message::Type::FORWARD == entry.m_type) {
+      LOG_GENERAL(WARNING, "Unexpected message type in rumor batch");
+      continue;
+    }
+
+    auto resp = ProcessRumor(entry.m_type, entry.m_rounds, entry.m_payload,
+                             from, p->second, responses);
+    if (resp.first) {
+      toBeDispatched.emplace_back(resp.second);
+    }
+  }
+
+  SendMessages(from, responses);
+  return toBeDispatched;
+}
+
+std::pair<bool, RumorManager::RawBytes> RumorManager::ProcessRumor(
+    const RRS::Message::Type t, int32_t round,
+    const RawBytes& message_wo_keysig, const Peer& from, int peerId,
+    std::vector<RRS::Message>& responses) {
+  int64_t recvdRumorId = -1;
+  bool toBeDispatched = false;
 
   if (RRS::Message::Type::EMPTY_PUSH == t ||
       RRS::Message::Type::EMPTY_PULL == t) {
@@ -466,7 +545,7 @@ std::pair<bool, RumorManager::RawBytes> RumorManager::RumorReceived(
       // Now that's the new hash message. So we dont have the real message.
       // So lets ask the sender for it.
       RRS::Message pullMsg(RRS::Message::Type::PULL, recvdRumorId, -1);
-      SendMessage(from, pullMsg);
+      responses.emplace_back(pullMsg);
     } else {
       recvdRumorId = it->second;
       LOG_GENERAL(DEBUG, "Old Gossip hash message received from "
@@ -477,7 +556,7 @@ std::pair<bool, RumorManager::RawBytes> RumorManager::RumorReceived(
       if (it == m_rumorHashRawMsgBimap.left.end()) {
         // didn't receive real message (PUSH) yet :( Lets ask this peer.
         RRS::Message pullMsg(RRS::Message::Type::PULL, recvdRumorId, -1);
-        SendMessage(from, pullMsg);
+        responses.emplace_back(pullMsg);
       }
     }
   } else if (RRS::Message::Type::PULL == t) {
@@ -488,7 +567,7 @@ std::pair<bool, RumorManager::RawBytes> RumorManager::RumorReceived(
       if (it2 != m_rumorIdHashBimap.right.end()) {
         recvdRumorId = it2->second;
         RRS::Message pushMsg(RRS::Message::Type::PUSH, recvdRumorId, -1);
-        SendMessage(from, pushMsg);
+        responses.emplace_back(pushMsg);
       }
     } else  // I dont have it as of now. Add this peer to subscriber list for
             // this hash message.
@@ -567,12 +646,13 @@ std::pair<bool, RumorManager::RawBytes> RumorManager::RumorReceived(
   RRS::Message recvMsg(t, recvdRumorId, round);
 
   std::pair<int, std::vector<RRS::Message>> pullMsgs =
-      m_rumorHolder->receivedMessage(recvMsg, p->second);
+      m_rumorHolder->receivedMessage(recvMsg, peerId);
 
   LOG_GENERAL(DEBUG, "Sending " << pullMsgs.second.size()
                                 << " EMPTY_PULL or LAZY_PULL Messages");
 
-  SendMessages(from, pullMsgs.second);
+  responses.insert(responses.end(), pullMsgs.second.begin(),
+                   pullMsgs.second.end());
 
   return {toBeDispatched, message_wo_keysig};
 }
@@ -589,74 +669,103 @@ void RumorManager::AppendKeyAndSignature(RawBytes& result,
   result.insert(result.end(), tmp.begin(), tmp.end());
 }
 
-void RumorManager::SendMessage(const Peer& toPeer,
-                               const RRS::Message& message) {
+RumorManager::RawBytes RumorManager::GenerateGossipHeader(
+    const RRS::Message::Type t, int32_t rounds) {
   // Add round and type to outgoing message
-  RRS::Message::Type t = message.type();
   RawBytes cmd = {(unsigned char)t};
   unsigned int cur_offset = RRSMessageOffset::R_ROUNDS;
 
-  Serializable::SetNumber<uint32_t>(cmd, cur_offset, message.rounds(),
-                                    sizeof(uint32_t));
+  Serializable::SetNumber<uint32_t>(cmd, cur_offset, rounds, sizeof(uint32_t));
 
   cur_offset += sizeof(uint32_t);
 
   Serializable::SetNumber<uint32_t>(
       cmd, cur_offset, m_selfPeer.m_listenPortHost, sizeof(uint32_t));
 
-  if (!(RRS::Message::Type::EMPTY_PUSH == t ||
-        RRS::Message::Type::EMPTY_PULL == t)) {
-    // Get the hash messages based on rumor id.
-    auto it1 = m_rumorIdHashBimap.left.find(message.rumorId());
-    if (it1 != m_rumorIdHashBimap.left.end()) {
-      if (RRS::Message::Type::PUSH == t) {
-        // Get the raw message based on hash
-        auto it2 = m_rumorHashRawMsgBimap.left.find(it1->second);
-        if (it2 != m_rumorHashRawMsgBimap.left.end()) {
-          if (SIGN_VERIFY_NONEMPTY_MSGTYP) {
-            // Add pubkey and signature before message body
-            AppendKeyAndSignature(cmd, it2->second);
-          }
+  return cmd;
+}
 
-          // Add raw message to outgoing message
-          cmd.insert(cmd.end(), it2->second.begin(), it2->second.end());
-          std::string gossipHashStr;
-          if (!DataConversion::Uint8VecToHexStr(it1->second, gossipHashStr)) {
-            return;
-          }
-          LOG_GENERAL(INFO, "Sending [" << gossipHashStr.substr(0, 6) << "] to "
-                                        << toPeer);
-        } else {
-          // Nothing to send.
-          return;
-        }
-      } else if (RRS::Message::Type::LAZY_PUSH == t ||
-                 RRS::Message::Type::LAZY_PULL == t ||
-                 RRS::Message::Type::PULL == t) {
-        if (SIGN_VERIFY_NONEMPTY_MSGTYP) {
-          // Add pubkey and signature before message body
-          AppendKeyAndSignature(cmd, it1->second);
-        }
+bool RumorManager::IsSignedType(const RRS::Message::Type t) {
+  switch (t) {
+    case RRS::Message::Type::EMPTY_PUSH:
+    case RRS::Message::Type::EMPTY_PULL:
+      return SIGN_VERIFY_EMPTY_MSGTYP;
+    case RRS::Message::Type::LAZY_PUSH:
+    case RRS::Message::Type::LAZY_PULL:
+    case RRS::Message::Type::PUSH:
+    case RRS::Message::Type::PULL:
+      return SIGN_VERIFY_NONEMPTY_MSGTYP;
+    case RRS::Message::Type::BATCH:
+      // A batch may carry any of the types above
+      return SIGN_VERIFY_EMPTY_MSGTYP || SIGN_VERIFY_NONEMPTY_MSGTYP;
+    default:
+      return false;
+  }
+}
 
-        // Add hash message to outgoing message for types
-        // LAZY_PULL/LAZY_PUSH/PULL
-        cmd.insert(cmd.end(), it1->second.begin(), it1->second.end());
-        LOG_GENERAL(DEBUG, "Sending Gossip Hash Message: "
-                               << message << " To Peer : " << toPeer);
-      } else {
-        return;
-      }
-    }
-  } else {  // EMPTY_PULL/ EMPTY_PUSH
+bool RumorManager::GetMessagePayload(const Peer& toPeer,
+                                     const RRS::Message& message,
+                                     RawBytes& payload) {
+  RRS::Message::Type t = message.type();
+
+  if (RRS::Message::Type::EMPTY_PUSH == t ||
+      RRS::Message::Type::EMPTY_PULL == t) {
     if (SIGN_VERIFY_EMPTY_MSGTYP) {
-      // Add pubkey and signature before message body
-      RawBytes dummyMsg = {'D', 'U', 'M', 'M', 'Y'};
-      AppendKeyAndSignature(cmd, dummyMsg);
-      // Add dummy message to outgoing message
-      cmd.insert(cmd.end(), dummyMsg.begin(), dummyMsg.end());
+      // Sign a dummy message
+      payload = {'D', 'U', 'M', 'M', 'Y'};
+    }
+    return true;
+  }
+
+  // Get the hash messages based on rumor id.
+  auto it1 = m_rumorIdHashBimap.left.find(message.rumorId());
+  if (it1 == m_rumorIdHashBimap.left.end()) {
+    return false;
+  }
+
+  if (RRS::Message::Type::PUSH == t) {
+    // Get the raw message based on hash
+    auto it2 = m_rumorHashRawMsgBimap.left.find(it1->second);
+    if (it2 == m_rumorHashRawMsgBimap.left.end()) {
+      // Nothing to send.
+      return false;
+    }
+    std::string gossipHashStr;
+    if (!DataConversion::Uint8VecToHexStr(it1->second, gossipHashStr)) {
+      return false;
     }
+    LOG_GENERAL(INFO,
+                "Sending [" << gossipHashStr.substr(0, 6) << "] to " << toPeer);
+    payload = it2->second;
+    return true;
+  } else if (RRS::Message::Type::LAZY_PUSH == t ||
+             RRS::Message::Type::LAZY_PULL == t ||
+             RRS::Message::Type::PULL == t) {
+    // Hash message for types LAZY_PULL/LAZY_PUSH/PULL
+    LOG_GENERAL(DEBUG, "Sending Gossip Hash Message: "
+                           << message << " To Peer : " << toPeer);
+    payload = it1->second;
+    return true;
   }
 
+  return false;
+}
+
+void RumorManager::SendMessage(const Peer& toPeer,
+                               const RRS::Message& message) {
+  RawBytes payload;
+  if (!GetMessagePayload(toPeer, message, payload)) {
+    return;
+  }
+
+  RawBytes cmd = GenerateGossipHeader(message.type(), message.rounds());
+
+  if (IsSignedType(message.type())) {
+    // Add pubkey and signature before message body
+    AppendKeyAndSignature(cmd, payload);
+  }
+  cmd.insert(cmd.end(), payload.begin(), payload.end());
+
   // Send the message to peer .
   if (SIMULATED_NETWORK_DELAY_IN_MS > 0) {
     std::this_thread::sleep_for(
@@ -665,11 +774,134 @@ void RumorManager::SendMessage(const Peer& toPeer,
   P2PComm::GetInstance().SendMessage(toPeer, cmd, START_BYTE_GOSSIP);
 }
 
+void RumorManager::SendBatch(const Peer& toPeer, const RawBytes& batch) {
+  RawBytes cmd = GenerateGossipHeader(RRS::Message::Type::BATCH, 0);
+
+  if (IsSignedType(RRS::Message::Type::BATCH)) {
+    // One signature covers every message in the batch
+    AppendKeyAndSignature(cmd, batch);
+  }
+  cmd.insert(cmd.end(), batch.begin(), batch.end());
+
+  if (SIMULATED_NETWORK_DELAY_IN_MS > 0) {
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(SIMULATED_NETWORK_DELAY_IN_MS));
+  }
+  P2PComm::GetInstance().SendMessage(toPeer, cmd, START_BYTE_GOSSIP);
+}
+
 void RumorManager::SendMessages(const Peer& toPeer,
                                 const std::vector<RRS::Message>& messages) {
+  if (!ENABLE_RUMOR_BATCHING || messages.size() < 2) {
+    for (auto& k : messages) {
+      SendMessage(toPeer, k);
+    }
+    return;
+  }
+
+  // Coalesce the messages into as few signed envelopes as the size limit
+  // allows
+  RawBytes batch;
   for (auto& k : messages) {
+    RawBytes payload;
+    if (!GetMessagePayload(toPeer, k, payload)) {
+      continue;
+    }
+
+    if (AppendBatchEntry(batch, k.type(), k.rounds(), payload,
+                         MAX_RUMOR_BATCH_SIZE_IN_BYTES)) {
+      continue;
+    }
+    if (!batch.empty()) {
+      SendBatch(toPeer, batch);
+      batch.clear();
+      if (AppendBatchEntry(batch, k.type(), k.rounds(), payload,
+                           MAX_RUMOR_BATCH_SIZE_IN_BYTES)) {
+        continue;
+      }
+    }
+    // Too large for a batch of its own, which the receiver would drop
     SendMessage(toPeer, k);
   }
+
+  if (!batch.empty()) {
+    SendBatch(toPeer, batch);
+  }
+}
+
+bool RumorManager::AppendBatchEntry(RawBytes& batch,
+                                    const RRS::Message::Type t, int32_t rounds,
+                                    const RawBytes& payload,
+                                    unsigned int maxSize) {
+  const size_t headerSize = batch.empty() ? BATCH_COUNT_LEN : 0;
+  if (batch.size() + headerSize + BATCH_ENTRY_HDR_LEN + payload.size() >
+      maxSize) {
+    return false;
+  }
+
+  uint32_t count = 0;
+  if (batch.empty()) {
+    batch.assign(BATCH_COUNT_LEN, 0);
+  } else {
+    count = Serializable::GetNumber<uint32_t>(batch, 0, BATCH_COUNT_LEN);
+  }
+  Serializable::SetNumber<uint32_t>(batch, 0, count + 1, BATCH_COUNT_LEN);
+
+  unsigned int cur_offset = batch.size();
+  batch.push_back((unsigned char)t);
+  cur_offset += sizeof(uint8_t);
+  Serializable::SetNumber<uint32_t>(batch, cur_offset, rounds,
+                                    sizeof(uint32_t));
+  cur_offset += sizeof(uint32_t);
+  Serializable::SetNumber<uint32_t>(batch, cur_offset, payload.size(),
+                                    sizeof(uint32_t));
+  batch.insert(batch.end(), payload.begin(), payload.end());
+  return true;
+}
+
+bool RumorManager::ParseBatch(const RawBytes& batch, unsigned int maxSize,
+                              std::vector<BatchEntry>& entries) {
+  entries.clear();
+  if (batch.size() > maxSize || batch.size() < BATCH_COUNT_LEN) {
+    return false;
+  }
+
+  const uint32_t count =
+      Serializable::GetNumber<uint32_t>(batch, 0, BATCH_COUNT_LEN);
+  if (count == 0) {
+    return false;
+  }
+
+  std::vector<BatchEntry> parsed;
+  unsigned int offset = BATCH_COUNT_LEN;
+  for (uint32_t i = 0; i < count; i++) {
+    if (batch.size() - offset < BATCH_ENTRY_HDR_LEN) {
+      return false;
+    }
+
+    const RRS::Message::Type t = convertType(batch.at(offset));
+    const int32_t rounds = Serializable::GetNumber<uint32_t>(
+        batch, offset + sizeof(uint8_t), sizeof(uint32_t));
+    const uint32_t len = Serializable::GetNumber<uint32_t>(
+        batch, offset + sizeof(uint8_t) + sizeof(uint32_t), sizeof(uint32_t));
+    offset += BATCH_ENTRY_HDR_LEN;
+
+    if (batch.size() - offset < len) {
+      return false;
+    }
+
+    parsed.push_back(
+        {t, rounds,
+         RawBytes(batch.begin() + offset, batch.begin() + offset + len)});
+    offset += len;
+  }
+
+  // Bytes past the last entry are not covered by the count
+  if (offset != batch.size()) {
+    return false;
+  }
+  entries = std::move(parsed);
+  return true;
 }
 
 // PUBLIC CONST METHODS
@@ -681,7 +913,7 @@ void RumorManager::PrintStatistics() {
   LOG_MARKER();
   // we use hash of message to uniquely identify message across different nodes
   // in network.
-  for (const auto& i : m_rumorHolder->rumorsMap()) {
+  for (const auto& i : m_rumorHolder->rumors()) {
     uint32_t rumorId = i.first;
     auto it = m_rumorIdHashBimap.left.find(rumorId);
     if (it != m_rumorIdHashBimap.left.end()) {
@@ -698,6 +930,24 @@ void RumorManager::PrintStatistics() {
   }
 }
 
+uint64_t RumorManager::GetSizeInBytes() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+
+  uint64_t sizeInBytes = 0;
+  for (const auto& it : m_rumorHashRawMsgBimap) {
+    sizeInBytes += it.left.size() + it.right.size();
+  }
+  for (const auto& it : m_rumorIdHashBimap) {
+    sizeInBytes += it.right.size();
+  }
+  for (const auto& it : m_hashesSubscriberMap) {
+    sizeInBytes += it.first.size() + it.second.size() * sizeof(Peer);
+  }
+  sizeInBytes += m_rumorRawMsgTimestamp.size() *
+                 sizeof(RumorRawMsgTimestampDeque::value_type);
+  return sizeInBytes;
+}
+
 void RumorManager::CleanUp() {
   int count = 0;
   auto now = std::chrono::high_resolution_clock::now();
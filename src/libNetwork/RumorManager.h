@@ -80,8 +80,25 @@ class RumorManager {
 
   void SendMessage(const Peer& toPeer, const RRS::Message& message);
 
+  void SendBatch(const Peer& toPeer, const RawBytes& batch);
+
+  bool GetMessagePayload(const Peer& toPeer, const RRS::Message& message,
+                         RawBytes& payload);
+
+  RawBytes GenerateGossipHeader(const RRS::Message::Type t, int32_t rounds);
+
   RawBytes GenerateGossipForwardMessage(const RawBytes& message);
 
+  bool VerifyKeyAndSignature(const RawBytes& message, const Peer& from,
+                             RawBytes& message_wo_keysig,
+                             bool isSignatureVerified);
+
+  std::pair<bool, RawBytes> ProcessRumor(const RRS::Message::Type t,
+                                         int32_t round,
+                                         const RawBytes& message_wo_keysig,
+                                         const Peer& from, int peerId,
+                                         std::vector<RRS::Message>& responses);
+
  public:
   // CREATORS
   RumorManager();
@@ -98,9 +115,39 @@ class RumorManager {
 
   void SpreadBufferedRumors();
 
+  /// If isSignatureVerified is set, the signature was already checked by the
+  /// caller and only the sender key is matched against the peer.
   std::pair<bool, RawBytes> RumorReceived(uint8_t type, int32_t round,
                                           const RawBytes& message,
-                                          const Peer& from);
+                                          const Peer& from,
+                                          bool isSignatureVerified = false);
+
+  /// Processes every message of a batch and returns the rumors to dispatch.
+  std::vector<RawBytes> RumorBatchReceived(const RawBytes& message,
+                                           const Peer& from,
+                                           bool isSignatureVerified = false);
+
+  /// Checks if messages of this type carry the sender key and signature.
+  static bool IsSignedType(const RRS::Message::Type t);
+
+  /// A message as carried in a batch
+  struct BatchEntry {
+    RRS::Message::Type m_type;
+    int32_t m_rounds;
+    RawBytes m_payload;
+  };
+
+  /// Appends a message to a batch, which may start out empty. Returns false,
+  /// leaving the batch as it is, if it would grow beyond maxSize bytes.
+  static bool AppendBatchEntry(RawBytes& batch, const RRS::Message::Type t,
+                               int32_t rounds, const RawBytes& payload,
+                               unsigned int maxSize);
+
+  /// Splits a batch into its messages. Returns false if it is larger than
+  /// maxSize bytes, holds no message, or its entries do not fill it exactly
+  /// the way its count says.
+  static bool ParseBatch(const RawBytes& batch, unsigned int maxSize,
+                         std::vector<BatchEntry>& entries);
 
   void StartRounds();
   void StopRounds();
@@ -119,9 +166,13 @@ class RumorManager {
   void CleanUp();
 
   std::pair<bool, RumorManager::RawBytes> VerifyMessage(
-      const RawBytes& message, const RRS::Message::Type& t, const Peer& from);
+      const RawBytes& message, const RRS::Message::Type& t, const Peer& from,
+      bool isSignatureVerified = false);
 
   void AppendKeyAndSignature(RawBytes& result, const RawBytes& messageToSig);
+  /// Returns the bytes held by the rumors kept for spreading and dedup
+  uint64_t GetSizeInBytes();
+
   // CONST METHODS
   const RumorIdRumorBimap& rumors() const;
 };
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "SendOutboxes.h"
+
+using namespace std;
+
+SendOutboxes::~SendOutboxes() {
+  lock_guard<mutex> g(m_mutex);
+  for (auto& entry : m_outboxes) {
+    for (auto& jobs : entry.second.m_jobs) {
+      for (auto job : jobs) {
+        delete job;
+      }
+    }
+  }
+}
+
+SendClass SendOutboxes::GetFirstClass(const Outbox& outbox) {
+  for (unsigned int c = 0; c < NUM_SEND_CLASSES; ++c) {
+    if (!outbox.m_jobs[c].empty()) {
+      return static_cast<SendClass>(c);
+    }
+  }
+  return SendClass::BULK;
+}
+
+bool SendOutboxes::Queue(unique_ptr<SendJob>& job,
+                         unique_ptr<SendJob>& evicted) {
+  const unsigned int sendClass =
+      static_cast<unsigned int>(job->m_frame->GetSendClass());
+  const uint64_t frameBytes = job->m_frame->GetSize();
+  job->m_queuedAt = chrono::steady_clock::now();
+
+  bool startDrain = false;
+  {
+    lock_guard<mutex> g(m_mutex);
+    auto it = m_outboxes.find(job->m_peer);
+    startDrain = it == m_outboxes.end();
+    auto& outbox = startDrain ? m_outboxes[job->m_peer] : it->second;
+    if (outbox.m_size >= m_maxJobs) {
+      for (unsigned int c = NUM_SEND_CLASSES - 1; c > sendClass; --c) {
+        if (!outbox.m_jobs[c].empty()) {
+          evicted.reset(outbox.m_jobs[c].back());
+          outbox.m_jobs[c].pop_back();
+          --outbox.m_size;
+          break;
+        }
+      }
+      if (!evicted) {
+        ++m_stats[sendClass].m_dropped;
+        return false;
+      }
+    }
+    // Jobs ahead of the bulk ones need not wait for the shaper
+    if (outbox.m_throttled &&
+        sendClass < static_cast<unsigned int>(SendClass::BULK)) {
+      outbox.m_throttled = false;
+      startDrain = true;
+    }
+    outbox.m_jobs[sendClass].push_back(job.release());
+    ++outbox.m_size;
+  }
+
+  if (evicted) {
+    const uint64_t evictedBytes = evicted->m_frame->GetSize();
+    auto& stats =
+        m_stats[static_cast<unsigned int>(evicted->m_frame->GetSendClass())];
+    --stats.m_waiting;
+    stats.m_waitingBytes -= evictedBytes;
+    ++stats.m_dropped;
+    m_bytes -= evictedBytes;
+  }
+
+  auto& stats = m_stats[sendClass];
+  ++stats.m_waiting;
+  stats.m_waitingBytes += frameBytes;
+  m_bytes += frameBytes;
+  return startDrain;
+}
+
+void SendOutboxes::TakeBatch(const Peer& peer, uint64_t maxBytes,
+                             EgressShaper& shaper,
+                             vector<unique_ptr<SendJob>>& jobs,
+                             EgressShaper::Clock::duration& wait) {
+  {
+    lock_guard<mutex> g(m_mutex);
+    auto& outbox = m_outboxes.at(peer);
+    uint64_t batchBytes = 0;
+    bool throttled = false;
+    for (auto& queue : outbox.m_jobs) {
+      while (!queue.empty()) {
+        SendJob* next = queue.front();
+        if (!jobs.empty() &&
+            (batchBytes + next->m_frame->GetSize() > maxBytes ||
+             next->m_allowSendToRelaxedBlacklist !=
+                 jobs.front()->m_allowSendToRelaxedBlacklist)) {
+          break;
+        }
+        if (next->m_frame->GetSendClass() == SendClass::BULK &&
+            !shaper.TryTake(next->m_frame->GetSize(), wait)) {
+          throttled = true;
+          break;
+        }
+        batchBytes += next->m_frame->GetSize();
+        jobs.emplace_back(next);
+        queue.pop_front();
+        --outbox.m_size;
+      }
+      if (!queue.empty()) {
+        break;
+      }
+    }
+
+    // Nothing may leave yet, so the outbox waits without holding a thread
+    if (jobs.empty()) {
+      outbox.m_throttled = throttled;
+      return;
+    }
+  }
+
+  const auto now = chrono::steady_clock::now();
+  for (const auto& job : jobs) {
+    auto& stats =
+        m_stats[static_cast<unsigned int>(job->m_frame->GetSendClass())];
+    --stats.m_waiting;
+    stats.m_waitingBytes -= job->m_frame->GetSize();
+    stats.m_totalWaitMicros +=
+        chrono::duration_cast<chrono::microseconds>(now - job->m_queuedAt)
+            .count();
+  }
+  m_stats[static_cast<unsigned int>(jobs.front()->m_frame->GetSendClass())]
+      .m_coalesced += jobs.size() - 1;
+}
+
+bool SendOutboxes::Resume(const Peer& peer, SendClass& nextClass) {
+  lock_guard<mutex> g(m_mutex);
+  auto it = m_outboxes.find(peer);
+  // A job of a higher class may have resumed the drain already
+  if (it == m_outboxes.end() || !it->second.m_throttled) {
+    return false;
+  }
+  it->second.m_throttled = false;
+  nextClass = GetFirstClass(it->second);
+  return true;
+}
+
+bool SendOutboxes::Finish(const Peer& peer, vector<unique_ptr<SendJob>>& jobs,
+                          bool blocked, SendClass& nextClass) {
+  uint64_t batchBytes = 0;
+  for (const auto& job : jobs) {
+    auto& stats =
+        m_stats[static_cast<unsigned int>(job->m_frame->GetSendClass())];
+    ++(blocked ? stats.m_dropped : stats.m_sent);
+    batchBytes += job->m_frame->GetSize();
+  }
+  jobs.clear();
+  m_bytes -= batchBytes;
+
+  lock_guard<mutex> g(m_mutex);
+  auto it = m_outboxes.find(peer);
+  if (it->second.m_size == 0) {
+    m_outboxes.erase(it);
+    return false;
+  }
+  nextClass = GetFirstClass(it->second);
+  return true;
+}
+
+unsigned int SendOutboxes::GetPeerCount() {
+  lock_guard<mutex> g(m_mutex);
+  return m_outboxes.size();
+}
+
+unsigned int SendOutboxes::GetThrottledCount() {
+  lock_guard<mutex> g(m_mutex);
+  unsigned int throttled = 0;
+  for (const auto& entry : m_outboxes) {
+    throttled += entry.second.m_throttled ? 1 : 0;
+  }
+  return throttled;
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_SENDOUTBOXES_H_
+#define ZILLIQA_SRC_LIBNETWORK_SENDOUTBOXES_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "EgressShaper.h"
+#include "Peer.h"
+#include "common/BaseType.h"
+#include "common/Constants.h"
+
+/// Classes of outgoing messages, in the order the queue of a peer serves them.
+/// GOSSIP also covers the messages that fit no other class.
+enum class SendClass : unsigned char { CONSENSUS, BLOCKS, GOSSIP, BULK };
+const unsigned int NUM_SEND_CLASSES = 4;
+
+/// Wire format of an outgoing message. It is built once and shared by every
+/// peer the message is sent to.
+class MessageFrame {
+  unsigned char m_startByte;
+  SendClass m_sendClass;
+  unsigned char m_msgType;
+  bytes m_hash;
+  bytes m_header;  // version, start byte, length and (for broadcast) hash
+  bytes m_body;
+
+ public:
+  MessageFrame(const bytes& message, unsigned char startByte,
+               const bytes& hash);
+
+  unsigned char GetStartByte() const { return m_startByte; }
+  SendClass GetSendClass() const { return m_sendClass; }
+  unsigned char GetMsgType() const { return m_msgType; }
+  const bytes& GetHash() const { return m_hash; }
+  const bytes& GetHeader() const { return m_header; }
+  const bytes& GetBody() const { return m_body; }
+  size_t GetSize() const { return m_header.size() + m_body.size(); }
+};
+
+using MessageFramePtr = std::shared_ptr<const MessageFrame>;
+
+struct BroadcastLog;
+
+/// A message waiting in the queue of the peer it is sent to.
+class SendJob {
+ protected:
+  static bool writeMsg(const std::vector<MessageFramePtr>& frames,
+                       int cli_sock, const Peer& to);
+  static int ConnectToPeer(const Peer& peer);
+  static bool SendMessageSocketCore(const Peer& peer,
+                                    const std::vector<MessageFramePtr>& frames);
+
+ public:
+  Peer m_peer;
+  MessageFramePtr m_frame;
+  bool m_allowSendToRelaxedBlacklist{};
+  std::chrono::steady_clock::time_point m_queuedAt;
+  // Shared by the jobs of one broadcast, logs its end once they are all gone
+  std::shared_ptr<BroadcastLog> m_broadcastLog;
+
+  /// Writes the frames to the peer on one connection, retrying up to
+  /// maxRetries times on failure. Returns whether they went through.
+  static bool SendMessageCore(const Peer& peer,
+                              const std::vector<MessageFramePtr>& frames,
+                              unsigned int maxRetries = MAXRETRYCONN);
+};
+
+/// Jobs waiting to be sent, in one outbox per peer that holds each class in
+/// the order its jobs were queued. An outbox exists while one drain of it is
+/// scheduled, running or waiting for the bulk shaper, so that the messages to
+/// a peer leave in order. The caller runs the drains.
+class SendOutboxes {
+ public:
+  struct ClassStats {
+    std::atomic<unsigned int> m_waiting{0};
+    std::atomic<uint64_t> m_waitingBytes{0};
+    std::atomic<uint64_t> m_sent{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_coalesced{0};
+    std::atomic<uint64_t> m_totalWaitMicros{0};
+  };
+
+ private:
+  struct Outbox {
+    std::array<std::deque<SendJob*>, NUM_SEND_CLASSES> m_jobs;
+    unsigned int m_size{0};
+    // Set while the drain waits for the bulk shaper, and none is scheduled
+    bool m_throttled{false};
+  };
+
+  const unsigned int m_maxJobs;
+  std::mutex m_mutex;
+  std::map<Peer, Outbox> m_outboxes;
+  std::array<ClassStats, NUM_SEND_CLASSES> m_stats;
+  // Bytes of the frames queued or being sent
+  std::atomic<uint64_t> m_bytes{0};
+
+  static SendClass GetFirstClass(const Outbox& outbox);
+
+ public:
+  explicit SendOutboxes(unsigned int maxJobs) : m_maxJobs(maxJobs) {}
+  ~SendOutboxes();
+
+  SendOutboxes(const SendOutboxes&) = delete;
+  SendOutboxes& operator=(const SendOutboxes&) = delete;
+
+  /// Queues a job in the outbox of its peer. Once the outbox holds maxJobs
+  /// jobs, the newest job of a lower class is moved to evicted to make room,
+  /// or the job is left where it is if there is none. Returns whether a drain
+  /// of the outbox must be scheduled for the class of the job.
+  bool Queue(std::unique_ptr<SendJob>& job, std::unique_ptr<SendJob>& evicted);
+
+  /// Takes the first job of the highest class of the outbox of the peer, and
+  /// the jobs behind it up to maxBytes in all. Bulk jobs leave only with the
+  /// tokens of the shaper; when none may leave, the outbox is throttled and
+  /// wait is set to the time until the shaper has the tokens.
+  void TakeBatch(const Peer& peer, uint64_t maxBytes, EgressShaper& shaper,
+                 std::vector<std::unique_ptr<SendJob>>& jobs,
+                 EgressShaper::Clock::duration& wait);
+
+  /// Ends the throttling of the outbox of the peer. Returns whether a drain
+  /// must be scheduled for nextClass, which is not the case once a job of a
+  /// higher class has resumed the outbox.
+  bool Resume(const Peer& peer, SendClass& nextClass);
+
+  /// Counts the jobs taken by TakeBatch as sent, or as dropped when blocked,
+  /// and frees them. Returns whether the next drain must be scheduled for
+  /// nextClass; otherwise the outbox is empty and removed.
+  bool Finish(const Peer& peer, std::vector<std::unique_ptr<SendJob>>& jobs,
+              bool blocked, SendClass& nextClass);
+
+  const ClassStats& GetStats(unsigned int sendClass) const {
+    return m_stats[sendClass];
+  }
+  uint64_t GetBytes() const { return m_bytes; }
+  unsigned int GetPeerCount();
+  unsigned int GetThrottledCount();
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_SENDOUTBOXES_H_
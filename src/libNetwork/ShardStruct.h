@@ -19,6 +19,7 @@
 #define ZILLIQA_SRC_LIBNETWORK_SHARDSTRUCT_H_
 
 #include <tuple>
+#include <unordered_map>
 
 #include <Schnorr.h>
 #include "Peer.h"
@@ -39,6 +40,9 @@ using PairOfNode = std::pair<PubKey, Peer>;
 using VectorOfNode = std::vector<PairOfNode>;
 using DequeOfNode = std::deque<PairOfNode>;
 
+/// Position of every member of a DequeOfNode, by public key
+using IndexOfNode = std::unordered_map<PubKey, uint16_t>;
+
 enum NodeMessage { NODE_PUBKEY, NODE_PEER, NODE_MSG };
 
 using NodeMsg = std::tuple<PubKey, Peer, bytes>;
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "SignatureBatchVerifier.h"
+
+using namespace std;
+
+namespace {
+// Batches that wait behind the one being verified
+const unsigned int QUEUED_BATCHES = 64;
+
+bool SchnorrVerify(const bytes& message, const Signature& signature,
+                   const PubKey& pubKey) {
+  return Schnorr::Verify(message, 0, message.size(), signature, pubKey);
+}
+}  // namespace
+
+SignatureBatchVerifier::SignatureBatchVerifier(unsigned int numThreads,
+                                               unsigned int maxBatchSize,
+                                               unsigned int windowInMs,
+                                               const VerifyFunc& verify)
+    : m_numThreads(max(numThreads, 1u)),
+      m_maxBatchSize(max(maxBatchSize, 1u)),
+      m_maxQueueSize(m_maxBatchSize * QUEUED_BATCHES),
+      m_window(windowInMs),
+      m_verify(verify ? verify : SchnorrVerify),
+      m_pool(m_numThreads, "SigVerify") {
+  m_batchThread = thread([this]() { BatchLoop(); });
+}
+
+SignatureBatchVerifier::~SignatureBatchVerifier() {
+  {
+    lock_guard<mutex> g(m_mutex);
+    m_stopped = true;
+  }
+  m_cvJobs.notify_all();
+  if (m_batchThread.joinable()) {
+    m_batchThread.join();
+  }
+}
+
+bool SignatureBatchVerifier::Submit(const bytes& message,
+                                    const Signature& signature,
+                                    const PubKey& pubKey,
+                                    const Callback& callback) {
+  {
+    lock_guard<mutex> g(m_mutex);
+    if (m_stopped || m_jobs.size() >= m_maxQueueSize) {
+      return false;
+    }
+    m_jobs.push_back({message, signature, pubKey, callback});
+  }
+  m_cvJobs.notify_one();
+  return true;
+}
+
+void SignatureBatchVerifier::BatchLoop() {
+  vector<Job> batch;
+  vector<char> results;
+
+  while (true) {
+    {
+      unique_lock<mutex> lock(m_mutex);
+      m_cvJobs.wait(lock, [this] { return m_stopped || !m_jobs.empty(); });
+      if (m_stopped) {
+        return;
+      }
+
+      // Give the batch a short window to fill up
+      m_cvJobs.wait_for(lock, m_window, [this] {
+        return m_stopped || m_jobs.size() >= m_maxBatchSize;
+      });
+      if (m_stopped) {
+        return;
+      }
+
+      const size_t count = min<size_t>(m_jobs.size(), m_maxBatchSize);
+      batch.assign(make_move_iterator(m_jobs.begin()),
+                   make_move_iterator(m_jobs.begin() + count));
+      m_jobs.erase(m_jobs.begin(), m_jobs.begin() + count);
+    }
+
+    VerifyBatch(batch, results);
+
+    for (size_t i = 0; i < batch.size(); i++) {
+      batch[i].m_callback(results[i] != 0);
+    }
+    batch.clear();
+  }
+}
+
+void SignatureBatchVerifier::VerifyBatch(vector<Job>& batch,
+                                         vector<char>& results) {
+  results.assign(batch.size(), 0);
+
+  if (batch.size() == 1 || m_numThreads == 1) {
+    for (size_t i = 0; i < batch.size(); i++) {
+      results[i] = m_verify(batch[i].m_message, batch[i].m_signature,
+                            batch[i].m_pubKey);
+    }
+    return;
+  }
+
+  // Split the batch into one contiguous chunk per thread
+  const size_t numChunks = min<size_t>(m_numThreads, batch.size());
+  const size_t chunkSize = (batch.size() + numChunks - 1) / numChunks;
+
+  mutex mutexDone;
+  condition_variable cvDone;
+  size_t chunksLeft = 0;
+
+  for (size_t start = 0; start < batch.size(); start += chunkSize) {
+    const size_t end = min(start + chunkSize, batch.size());
+    {
+      lock_guard<mutex> g(mutexDone);
+      chunksLeft++;
+    }
+    m_pool.AddJob([this, &batch, &results, &mutexDone, &cvDone, &chunksLeft,
+                   start, end]() {
+      for (size_t i = start; i < end; i++) {
+        results[i] = m_verify(batch[i].m_message, batch[i].m_signature,
+                              batch[i].m_pubKey);
+      }
+      lock_guard<mutex> g(mutexDone);
+      if (--chunksLeft == 0) {
+        cvDone.notify_one();
+      }
+    });
+  }
+
+  unique_lock<mutex> lock(mutexDone);
+  cvDone.wait(lock, [&chunksLeft] { return chunksLeft == 0; });
+}
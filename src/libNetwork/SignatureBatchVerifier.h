@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_SIGNATUREBATCHVERIFIER_H_
+#define ZILLIQA_SRC_LIBNETWORK_SIGNATUREBATCHVERIFIER_H_
+
+#include <Schnorr.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "libUtils/Logger.h"
+#include "libUtils/ThreadPool.h"
+
+/// Verifies signatures off the network thread. Submitted jobs are collected
+/// for a short window and the resulting batch is verified in parallel on a
+/// thread pool. Callbacks are run on the batching thread in submission order.
+class SignatureBatchVerifier {
+ public:
+  using Callback = std::function<void(bool)>;
+  using VerifyFunc = std::function<bool(const bytes&, const Signature&,
+                                        const PubKey&)>;
+
+ private:
+  struct Job {
+    bytes m_message;
+    Signature m_signature;
+    PubKey m_pubKey;
+    Callback m_callback;
+  };
+
+  const unsigned int m_numThreads;
+  const unsigned int m_maxBatchSize;
+  const unsigned int m_maxQueueSize;
+  const std::chrono::milliseconds m_window;
+  const VerifyFunc m_verify;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cvJobs;
+  std::deque<Job> m_jobs;
+  bool m_stopped{false};
+
+  ThreadPool m_pool;
+  std::thread m_batchThread;
+
+  void BatchLoop();
+  void VerifyBatch(std::vector<Job>& batch, std::vector<char>& results);
+
+ public:
+  /// Uses Schnorr::Verify unless another verify function is given.
+  SignatureBatchVerifier(unsigned int numThreads, unsigned int maxBatchSize,
+                         unsigned int windowInMs,
+                         const VerifyFunc& verify = VerifyFunc());
+  ~SignatureBatchVerifier();
+
+  /// Queues a signature for verification. Returns false if the queue is full,
+  /// in which case the callback is never called.
+  bool Submit(const bytes& message, const Signature& signature,
+              const PubKey& pubKey, const Callback& callback);
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_SIGNATUREBATCHVERIFIER_H_
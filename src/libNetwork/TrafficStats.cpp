@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TrafficStats.h"
+#include "common/MessageNames.h"
+#include "libUtils/IPConverter.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+const string TrafficStats::GOSSIP_TYPE = "GOSSIP";
+
+namespace {
+void Add(TrafficStats::Entry& entry, bool sent, uint64_t bytes) {
+  auto& counter = sent ? entry.m_sent : entry.m_received;
+  counter.m_bytes += bytes;
+  counter.m_messages++;
+}
+
+Json::Value CounterToJson(const TrafficStats::Counter& counter) {
+  Json::Value _json;
+  _json["bytes"] = Json::UInt64(counter.m_bytes);
+  _json["messages"] = Json::UInt64(counter.m_messages);
+  return _json;
+}
+
+Json::Value EntryToJson(const TrafficStats::Entry& entry) {
+  Json::Value _json;
+  _json["sent"] = CounterToJson(entry.m_sent);
+  _json["received"] = CounterToJson(entry.m_received);
+  return _json;
+}
+
+string EntryToString(const TrafficStats::Entry& entry) {
+  return "sent=" + to_string(entry.m_sent.m_bytes) + "B/" +
+         to_string(entry.m_sent.m_messages) +
+         " received=" + to_string(entry.m_received.m_bytes) + "B/" +
+         to_string(entry.m_received.m_messages);
+}
+}  // namespace
+
+TrafficStats& TrafficStats::GetInstance() {
+  static TrafficStats ts;
+  return ts;
+}
+
+const string& TrafficStats::GetTypeName(unsigned char msgType) {
+  static const string unknown = "UNKNOWN";
+  if (msgType >= ARRAY_SIZE(MessageTypeStrings)) {
+    return unknown;
+  }
+  return MessageTypeStrings[msgType];
+}
+
+void TrafficStats::Record(bool sent, const uint128_t& ipAddress,
+                          const string& type, uint64_t bytes) {
+  lock_guard<mutex> g(m_mutex);
+  auto it = m_current.m_peers.find(ipAddress);
+  if (it == m_current.m_peers.end() &&
+      m_current.m_peers.size() < MAX_PEERS) {
+    it = m_current.m_peers.emplace(ipAddress, Entry()).first;
+  }
+  Add(it == m_current.m_peers.end() ? m_current.m_other : it->second, sent,
+      bytes);
+  Add(m_current.m_types[type], sent, bytes);
+  Add(m_current.m_total, sent, bytes);
+}
+
+TrafficStats::Entry TrafficStats::GetPeer(const uint128_t& ipAddress) {
+  lock_guard<mutex> g(m_mutex);
+  const auto it = m_current.m_peers.find(ipAddress);
+  return it == m_current.m_peers.end() ? Entry() : it->second;
+}
+
+TrafficStats::Entry TrafficStats::GetType(const string& type) {
+  lock_guard<mutex> g(m_mutex);
+  const auto it = m_current.m_types.find(type);
+  return it == m_current.m_types.end() ? Entry() : it->second;
+}
+
+void TrafficStats::LogAndReset(uint64_t epochNum) {
+  lock_guard<mutex> g(m_mutex);
+
+  LOG_GENERAL(INFO, "[TRAFFIC][" << epochNum << "] total "
+                                 << EntryToString(m_current.m_total)
+                                 << " peers=" << m_current.m_peers.size());
+  for (const auto& it : m_current.m_types) {
+    LOG_GENERAL(INFO, "[TRAFFIC][" << epochNum << "] " << it.first << " "
+                                   << EntryToString(it.second));
+  }
+
+  m_previous = move(m_current);
+  m_current = Period();
+  m_previousEpoch = epochNum;
+}
+
+Json::Value TrafficStats::ToJson(const Period& period) {
+  Json::Value _json;
+  _json["total"] = EntryToJson(period.m_total);
+  _json["other_peers"] = EntryToJson(period.m_other);
+  _json["types"] = Json::Value(Json::objectValue);
+  for (const auto& it : period.m_types) {
+    _json["types"][it.first] = EntryToJson(it.second);
+  }
+  _json["peers"] = Json::Value(Json::objectValue);
+  for (const auto& it : period.m_peers) {
+    _json["peers"][IPConverter::ToStrFromNumericalIP(it.first)] =
+        EntryToJson(it.second);
+  }
+  return _json;
+}
+
+Json::Value TrafficStats::GetStats() {
+  lock_guard<mutex> g(m_mutex);
+
+  Json::Value _json;
+  _json["current"] = ToJson(m_current);
+  _json["previous"] = ToJson(m_previous);
+  _json["previous_epoch"] = Json::UInt64(m_previousEpoch);
+  return _json;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_TRAFFICSTATS_H_
+#define ZILLIQA_SRC_LIBNETWORK_TRAFFICSTATS_H_
+
+#include <json/json.h>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "common/BaseType.h"
+
+/// Counts the bytes and messages sent to and received from each peer, and of
+/// each message type, per epoch. The bytes are those on the wire, headers and
+/// compression included. Peers beyond the first MAX_PEERS of an epoch are
+/// counted together as "other".
+class TrafficStats {
+ public:
+  static const size_t MAX_PEERS = 4096;
+
+  struct Counter {
+    uint64_t m_bytes{0};
+    uint64_t m_messages{0};
+  };
+
+  struct Entry {
+    Counter m_sent;
+    Counter m_received;
+  };
+
+ private:
+  struct Period {
+    std::map<uint128_t, Entry> m_peers;
+    std::map<std::string, Entry> m_types;
+    Entry m_other;  // peers past MAX_PEERS
+    Entry m_total;
+  };
+
+  std::mutex m_mutex;
+  Period m_current;
+  Period m_previous;
+  uint64_t m_previousEpoch{0};
+
+  TrafficStats() = default;
+  ~TrafficStats() = default;
+
+  TrafficStats(TrafficStats const&) = delete;
+  void operator=(TrafficStats const&) = delete;
+
+  static Json::Value ToJson(const Period& period);
+
+ public:
+  /// Returns the singleton TrafficStats instance.
+  static TrafficStats& GetInstance();
+
+  /// Returns the name under which the messages of msgType are counted.
+  static const std::string& GetTypeName(unsigned char msgType);
+
+  /// Name under which gossip (rumor) messages are counted
+  static const std::string GOSSIP_TYPE;
+
+  /// Records one message sent to or received from the peer at ipAddress.
+  void Record(bool sent, const uint128_t& ipAddress, const std::string& type,
+              uint64_t bytes);
+
+  /// Returns the counters of the current epoch for the peer at ipAddress.
+  Entry GetPeer(const uint128_t& ipAddress);
+
+  /// Returns the counters of the current epoch for the message type.
+  Entry GetType(const std::string& type);
+
+  /// Logs the traffic of the epoch and starts a new period.
+  void LogAndReset(uint64_t epochNum);
+
+  /// Returns the traffic of the current and the last completed epoch.
+  Json::Value GetStats();
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_TRAFFICSTATS_H_
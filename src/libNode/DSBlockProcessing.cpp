@@ -28,6 +28,8 @@
 #include "depends/libDatabase/MemoryDB.h"
 #include "depends/libTrie/TrieDB.h"
 #include "depends/libTrie/TrieHash.h"
+#include "libConsensus/AggregatedPubKeyCache.h"
+#include "libConsensus/VerifiedCosigCache.h"
 #include "libCrypto/Sha2.h"
 #include "libData/AccountData/Account.h"
 #include "libData/AccountData/AccountStore.h"
@@ -71,6 +73,10 @@ void Node::StoreDSBlockToDisk(const DSBlock& dsblock) {
   // Update the rand1 value for next PoW
   m_mediator.UpdateDSBlockRand();
 
+  if (LOOKUP_NODE_MODE) {
+    m_mediator.m_lookup->RefreshLookupServerCache();
+  }
+
   // Store DS Block to disk
   bytes serializedDSBlock;
   dsblock.Serialize(serializedDSBlock, 0);
@@ -107,13 +113,23 @@ void Node::UpdateDSCommitteeComposition(DequeOfNode& dsComm,
                                    dsblock);
 }
 
+void Node::UpdateDSCommitteeComposition(DequeOfNode& dsComm,
+                                        const DSBlock& dsblock,
+                                        IndexOfNode& dsIndex) {
+  // Update the DS committee composition.
+  LOG_MARKER();
+
+  UpdateDSCommitteeCompositionCore(m_mediator.m_selfKey.second, dsComm,
+                                   dsblock, dsIndex);
+}
+
 bool Node::VerifyDSBlockCoSignature(const DSBlock& dsblock) {
   LOG_MARKER();
 
   unsigned int index = 0;
   unsigned int count = 0;
 
-  const vector<bool>& B2 = dsblock.GetB2();
+  const Bitmap& B2 = dsblock.GetB2();
   if (m_mediator.m_DSCommittee->size() != B2.size()) {
     LOG_CHECK_FAIL("Cosig size", B2.size(), m_mediator.m_DSCommittee->size());
     return false;
@@ -122,8 +138,8 @@ bool Node::VerifyDSBlockCoSignature(const DSBlock& dsblock) {
   // Generate the aggregated key
   vector<PubKey> keys;
   for (auto const& kv : *m_mediator.m_DSCommittee) {
+    keys.emplace_back(kv.first);
     if (B2.at(index)) {
-      keys.emplace_back(kv.first);
       count++;
     }
     index++;
@@ -134,7 +150,8 @@ bool Node::VerifyDSBlockCoSignature(const DSBlock& dsblock) {
     return false;
   }
 
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<PubKey> aggregatedKey =
+      AggregatedPubKeyCache::GetInstance().AggregatePubKeys(keys, B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return false;
@@ -148,8 +165,8 @@ bool Node::VerifyDSBlockCoSignature(const DSBlock& dsblock) {
   }
   dsblock.GetCS1().Serialize(message, message.size());
   BitVector::SetBitVector(message, message.size(), dsblock.GetB1());
-  if (!MultiSig::MultiSigVerify(message, 0, message.size(), dsblock.GetCS2(),
-                                *aggregatedKey)) {
+  if (!VerifiedCosigCache::GetInstance().MultiSigVerify(
+          message, 0, message.size(), dsblock.GetCS2(), B2, *aggregatedKey)) {
     LOG_GENERAL(WARNING, "Cosig verification failed");
     for (auto& kv : keys) {
       LOG_GENERAL(WARNING, kv);
@@ -535,14 +552,31 @@ bool Node::ProcessVCDSBlocksMessage(const bytes& message,
   if (LOOKUP_NODE_MODE) {
     LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
               "I the lookup node have stored the DS Block");
+
+    // Archive the tx bodies of the DS epochs past the retained ones
+    const uint64_t dsBlockNum = dsblock.GetHeader().GetBlockNum();
+    DSBlockSharedPtr oldestKeptDSBlock;
+    if (TX_BODY_RETENTION_DS_EPOCHS > 0 &&
+        dsBlockNum > TX_BODY_RETENTION_DS_EPOCHS &&
+        BlockStorage::GetBlockStorage().GetDSBlock(
+            dsBlockNum - TX_BODY_RETENTION_DS_EPOCHS, oldestKeptDSBlock)) {
+      const uint64_t oldestKeptEpochNum =
+          oldestKeptDSBlock->GetHeader().GetEpochNum();
+      auto func = [oldestKeptEpochNum]() mutable -> void {
+        BlockStorage::GetBlockStorage().ArchiveTxBodies(oldestKeptEpochNum);
+      };
+      DetachedFunction(1, func);
+    }
   }
 
   m_mediator.UpdateDSBlockRand();  // Update the rand1 value for next PoW
 
+  IndexOfNode dsIndex;
   {
     std::lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
     UpdateDSCommitteeComposition(*m_mediator.m_DSCommittee,
-                                 m_mediator.m_dsBlockChain.GetLastBlock());
+                                 m_mediator.m_dsBlockChain.GetLastBlock(),
+                                 dsIndex);
   }
 
   uint16_t lastBlockHash = 0;
@@ -575,18 +609,11 @@ bool Node::ProcessVCDSBlocksMessage(const bytes& message,
         m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSPoWWinners();
 
     // Find my new consensus ID.
-    DequeOfNode::iterator it;
     bool isNewDSMember = false;
-    for (it = m_mediator.m_DSCommittee->begin();
-         it != m_mediator.m_DSCommittee->end(); ++it) {
-      // Look for my public key.
-      if (m_mediator.m_selfKey.second == it->first) {
-        uint16_t consensusIndex =
-            std::distance(m_mediator.m_DSCommittee->begin(), it);
-        isNewDSMember = true;
-        m_mediator.m_ds->SetConsensusMyID(consensusIndex);
-        break;
-      }
+    const auto myIndex = dsIndex.find(m_mediator.m_selfKey.second);
+    if (myIndex != dsIndex.end()) {
+      isNewDSMember = true;
+      m_mediator.m_ds->SetConsensusMyID(myIndex->second);
     }
 
     // If I am the next DS leader -> need to set myself up as a DS node
@@ -24,12 +24,13 @@
 #include "common/Constants.h"
 #include "common/Messages.h"
 #include "common/Serializable.h"
+#include "libConsensus/AggregatedPubKeyCache.h"
 #include "libCrypto/Sha2.h"
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
 #include "libUtils/BitVector.h"
 #include "libUtils/DataConversion.h"
-#include "libUtils/DetachedFunction.h"
+#include "libUtils/DetachedExecutor.h"
 #include "libUtils/Logger.h"
 #include "libUtils/TimeLockedFunction.h"
 #include "libUtils/TimeUtils.h"
@@ -62,7 +63,7 @@ bool Node::VerifyFallbackBlockCoSignature(const FallbackBlock& fallbackblock) {
 
   uint32_t shard_id = fallbackblock.GetHeader().GetShardId();
 
-  const vector<bool>& B2 = fallbackblock.GetB2();
+  const Bitmap& B2 = fallbackblock.GetB2();
   if (m_mediator.m_ds->m_shards[shard_id].size() != B2.size()) {
     LOG_GENERAL(WARNING,
                 "Mismatch: shard "
@@ -76,8 +77,8 @@ bool Node::VerifyFallbackBlockCoSignature(const FallbackBlock& fallbackblock) {
   vector<PubKey> keys;
 
   for (auto const& shardNode : m_mediator.m_ds->m_shards[shard_id]) {
+    keys.emplace_back(std::get<SHARD_NODE_PUBKEY>(shardNode));
     if (B2.at(index)) {
-      keys.emplace_back(std::get<SHARD_NODE_PUBKEY>(shardNode));
       count++;
     }
     index++;
@@ -88,7 +89,8 @@ bool Node::VerifyFallbackBlockCoSignature(const FallbackBlock& fallbackblock) {
     return false;
   }
 
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<PubKey> aggregatedKey =
+      AggregatedPubKeyCache::GetInstance().AggregatePubKeys(keys, B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return false;
@@ -308,7 +310,8 @@ bool Node::ProcessFallbackBlock(const bytes& message, unsigned int cur_offset,
                                   1
                            << "] FINISH WRITE STATE TO DISK");
     };
-    DetachedFunction(1, writeStateToDisk);
+    DetachedExecutor::GetInstance().Run(DetachedExecutor::PERSISTENCE_LANE,
+                                        writeStateToDisk);
   }
 
   if (!LOOKUP_NODE_MODE) {
@@ -23,11 +23,13 @@
 #include "common/Constants.h"
 #include "common/Messages.h"
 #include "common/Serializable.h"
+#include "libConsensus/AggregatedPubKeyCache.h"
 #include "libCrypto/Sha2.h"
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
 #include "libUtils/BitVector.h"
 #include "libUtils/DataConversion.h"
+#include "libUtils/DetachedExecutor.h"
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
 
@@ -78,15 +80,17 @@ void Node::ProcessFallbackConsensusWhenDone() {
 
   vector<PubKey> keys;
   for (auto const& kv : *m_myShardMembers) {
+    keys.emplace_back(kv.first);
     if (m_pendingFallbackBlock->GetB2().at(index)) {
-      keys.emplace_back(kv.first);
       count++;
     }
     index++;
   }
 
   // Verify cosig agains fallbackblock
-  shared_ptr<PubKey> aggregatetdKey = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<PubKey> aggregatetdKey =
+      AggregatedPubKeyCache::GetInstance().AggregatePubKeys(
+          keys, m_pendingFallbackBlock->GetB2());
   if (aggregatetdKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return;
@@ -213,7 +217,8 @@ void Node::ProcessFallbackConsensusWhenDone() {
                                   1
                            << "] FINISH WRITE STATE TO DISK");
     };
-    DetachedFunction(1, writeStateToDisk);
+    DetachedExecutor::GetInstance().Run(DetachedExecutor::PERSISTENCE_LANE,
+                                        writeStateToDisk);
 
     SetState(POW_SUBMISSION);
 
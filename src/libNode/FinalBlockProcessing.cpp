@@ -29,6 +29,8 @@
 #include "depends/libDatabase/MemoryDB.h"
 #include "depends/libTrie/TrieDB.h"
 #include "depends/libTrie/TrieHash.h"
+#include "libConsensus/AggregatedPubKeyCache.h"
+#include "libConsensus/VerifiedCosigCache.h"
 #include "libCrypto/Sha2.h"
 #include "libData/AccountData/Account.h"
 #include "libData/AccountData/AccountStore.h"
@@ -43,8 +45,11 @@
 #include "libServer/LookupServer.h"
 #include "libServer/WebsocketServer.h"
 #include "libUtils/BitVector.h"
+#include "libUtils/CommitPipeline.h"
 #include "libUtils/DataConversion.h"
+#include "libUtils/DetachedExecutor.h"
 #include "libUtils/DetachedFunction.h"
+#include "libUtils/EpochPerf.h"
 #include "libUtils/HashUtils.h"
 #include "libUtils/Logger.h"
 #include "libUtils/RootComputation.h"
@@ -56,7 +61,7 @@
 using namespace std;
 using namespace boost::multiprecision;
 
-bool Node::StoreFinalBlock(const TxBlock& txBlock) {
+bool Node::StoreFinalBlock(const TxBlock& txBlock, EpochCommit& epochCommit) {
   LOG_MARKER();
 
   AddBlock(txBlock);
@@ -69,11 +74,7 @@ bool Node::StoreFinalBlock(const TxBlock& txBlock) {
   // Store Tx Block to disk
   bytes serializedTxBlock;
   txBlock.Serialize(serializedTxBlock, 0);
-  if (!BlockStorage::GetBlockStorage().PutTxBlock(
-          txBlock.GetHeader().GetBlockNum(), serializedTxBlock)) {
-    LOG_GENERAL(WARNING, "BlockStorage::PutTxBlock failed " << txBlock);
-    return false;
-  }
+  epochCommit.PutTxBlock(txBlock.GetHeader().GetBlockNum(), serializedTxBlock);
 
   m_mediator.IncreaseEpochNum();
 
@@ -226,7 +227,7 @@ bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock) {
   unsigned int index = 0;
   unsigned int count = 0;
 
-  const vector<bool>& B2 = txblock.GetB2();
+  const Bitmap& B2 = txblock.GetB2();
   if (m_mediator.m_DSCommittee->size() != B2.size()) {
     LOG_CHECK_FAIL("Cosig size", B2.size(), m_mediator.m_DSCommittee->size());
     return false;
@@ -235,8 +236,8 @@ bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock) {
   // Generate the aggregated key
   vector<PubKey> keys;
   for (auto const& kv : *m_mediator.m_DSCommittee) {
+    keys.emplace_back(kv.first);
     if (B2.at(index)) {
-      keys.emplace_back(kv.first);
       count++;
     }
     index++;
@@ -247,7 +248,8 @@ bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock) {
     return false;
   }
 
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<PubKey> aggregatedKey =
+      AggregatedPubKeyCache::GetInstance().AggregatePubKeys(keys, B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return false;
@@ -261,8 +263,8 @@ bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock) {
   }
   txblock.GetCS1().Serialize(message, message.size());
   BitVector::SetBitVector(message, message.size(), txblock.GetB1());
-  if (!MultiSig::MultiSigVerify(message, 0, message.size(), txblock.GetCS2(),
-                                *aggregatedKey)) {
+  if (!VerifiedCosigCache::GetInstance().MultiSigVerify(
+          message, 0, message.size(), txblock.GetCS2(), B2, *aggregatedKey)) {
     LOG_GENERAL(WARNING, "Cosig verification failed");
     for (auto& kv : keys) {
       LOG_GENERAL(WARNING, kv);
@@ -420,9 +422,17 @@ void Node::CallActOnFinalblock() {
 
   LOG_MARKER();
 
+  // Held for the whole send, which may overlap the next round
+  const shared_ptr<MicroBlock> microblock = m_microblock;
+  if (microblock == nullptr) {
+    LOG_GENERAL(WARNING, "No microblock to send");
+    return;
+  }
+
   auto composeMBnForwardTxnMessageForSender =
-      [this](bytes& forwardtxn_message) -> bool {
-    return ComposeMBnForwardTxnMessageForSender(forwardtxn_message);
+      [this, microblock](bytes& forwardtxn_message) -> bool {
+    return ComposeMBnForwardTxnMessageForSender(*microblock,
+                                                forwardtxn_message);
   };
 
   auto sendMbnFowardTxnToShardNodes =
@@ -434,14 +444,15 @@ void Node::CallActOnFinalblock() {
   lock_guard<mutex> g(m_mutexShardMember);
 
   DataSender::GetInstance().SendDataToOthers(
-      *m_microblock, *m_myShardMembers, {}, {},
+      *microblock, *m_myShardMembers, {}, {},
       m_mediator.m_lookup->GetLookupNodes(),
       m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash(), m_consensusMyID,
       composeMBnForwardTxnMessageForSender, false, SendDataToLookupFuncDefault,
       sendMbnFowardTxnToShardNodes);
 }
 
-bool Node::ComposeMBnForwardTxnMessageForSender(bytes& mb_txns_message) {
+bool Node::ComposeMBnForwardTxnMessageForSender(const MicroBlock& microblock,
+                                                bytes& mb_txns_message) {
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
                 "Node::ComposeMBnForwardTxnMessageForSender not expected to be "
@@ -451,14 +462,10 @@ bool Node::ComposeMBnForwardTxnMessageForSender(bytes& mb_txns_message) {
 
   std::vector<TransactionWithReceipt> txns_to_send;
 
-  if (m_microblock == nullptr) {
-    return false;
-  }
-
   const auto& blocknum =
       m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
   {
-    const vector<TxnHash>& tx_hashes = m_microblock->GetTranHashes();
+    const vector<TxnHash>& tx_hashes = microblock.GetTranHashes();
     lock_guard<mutex> g(m_mutexProcessedTransactions);
     auto& processedTransactions = m_processedTransactions[blocknum];
     for (const auto& tx_hash : tx_hashes) {
@@ -477,7 +484,8 @@ bool Node::ComposeMBnForwardTxnMessageForSender(bytes& mb_txns_message) {
                      NodeInstructionType::MBNFORWARDTRANSACTION};
 
   if (!Messenger::SetNodeMBnForwardTransaction(
-          mb_txns_message, MessageOffset::BODY, *m_microblock, txns_to_send)) {
+          mb_txns_message, MessageOffset::BODY, microblock, txns_to_send,
+          COMPACT_MBNFORWARD_RELAY)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::SetNodeMBnForwardTransaction failed.");
     return false;
@@ -492,7 +500,7 @@ bool Node::ComposeMBnForwardTxnMessageForSender(bytes& mb_txns_message) {
 
   LOG_GENERAL(INFO, "[SendMBnTxn]"
                         << " Sending lookup :"
-                        << m_microblock->GetHeader().GetShardId()
+                        << microblock.GetHeader().GetShardId()
                         << " Epoch:" << m_mediator.m_currentEpochNum);
 
   return true;
@@ -540,10 +548,13 @@ bool Node::ProcessFinalBlockCore(const bytes& message, unsigned int offset,
   TxBlock txBlock;
   bytes stateDelta;
 
-  if (!Messenger::GetNodeFinalBlock(message, offset, dsBlockNumber, consensusID,
-                                    txBlock, stateDelta)) {
+  // Only the header is decoded until the block is known not to be stale
+  TxBlockHeader txBlockHeader;
+  BlockHash blockHash;
+  if (!Messenger::GetNodeFinalBlockHeader(message, offset, dsBlockNumber,
+                                          txBlockHeader, blockHash)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
-              "Messenger::GetNodeFinalBlock failed.");
+              "Messenger::GetNodeFinalBlockHeader failed.");
     return false;
   }
 
@@ -572,6 +583,24 @@ bool Node::ProcessFinalBlockCore(const bytes& message, unsigned int offset,
     }
   }
 
+  // A block of an earlier epoch of a DS epoch we have is a duplicate or a
+  // late delivery, which would fail CheckWhetherBlockIsLatest without
+  // rejoining
+  if (dsBlockNumber <=
+          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() &&
+      txBlockHeader.GetBlockNum() < m_mediator.m_currentEpochNum) {
+    LOG_GENERAL(INFO, "Dropping stale final block "
+                          << txBlockHeader.GetBlockNum() << " " << blockHash);
+    return false;
+  }
+
+  if (!Messenger::GetNodeFinalBlock(message, offset, dsBlockNumber, consensusID,
+                                    txBlock, stateDelta)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Messenger::GetNodeFinalBlock failed.");
+    return false;
+  }
+
   lock_guard<mutex> g(m_mutexFinalBlock);
   if (txBlock.GetHeader().GetVersion() != TXBLOCK_VERSION) {
     LOG_CHECK_FAIL("TxBlock version", txBlock.GetHeader().GetVersion(),
@@ -700,6 +729,10 @@ bool Node::ProcessFinalBlockCore(const bytes& message, unsigned int offset,
                        << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
                        << m_mediator.m_currentEpochNum << "] RECVD FLBLK");
 
+  if (ENABLE_EPOCH_PERF) {
+    EpochPerf::GetInstance().AddTxns(txBlock.GetHeader().GetNumTxs());
+  }
+
   bool toSendTxnToLookup = false;
 
   const bool& toSendPendingTxn = !(IsUnconfirmedTxnEmpty());
@@ -712,38 +745,13 @@ bool Node::ProcessFinalBlockCore(const bytes& message, unsigned int offset,
     return false;
   }
 
-  if (isVacuousEpoch) {
-    unordered_map<Address, int256_t> addressMap;
-    if (!Messenger::StateDeltaToAddressMap(stateDelta, 0, addressMap)) {
-      LOG_GENERAL(WARNING, "Messenger::StateDeltaToAccountMap failed");
-    } else {
-      auto it = addressMap.find(
-          Account::GetAddressFromPublicKey(m_mediator.m_selfKey.second));
-      if (it != addressMap.end()) {
-        auto reward = it->second;
-        LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-                  "[REWARD]"
-                      << " Got " << reward << " as reward");
-        LOG_STATE("[REWARD][" << setw(15) << left
-                              << m_mediator.m_selfPeer.GetPrintableIPAddress()
-                              << "][" << m_mediator.m_currentEpochNum << "]["
-                              << reward << "] FLBLK");
-      } else {
-        LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-                  "[REWARD]"
-                      << "Got no reward this ds epoch");
-      }
-    }
-  }
   if (LOOKUP_NODE_MODE) {
     ClearUnconfirmedTxn();
   }
 
-  if (!BlockStorage::GetBlockStorage().PutStateDelta(
-          txBlock.GetHeader().GetBlockNum(), stateDelta)) {
-    LOG_GENERAL(WARNING, "BlockStorage::PutStateDelta failed");
-    return false;
-  }
+  // The state delta, final block and epoch marker are written together
+  EpochCommit epochCommit;
+  epochCommit.PutStateDelta(txBlock.GetHeader().GetBlockNum(), stateDelta);
 
   if (!LOOKUP_NODE_MODE &&
       (!CheckStateRoot(txBlock) || m_doRejoinAtStateRoot)) {
@@ -764,23 +772,30 @@ bool Node::ProcessFinalBlockCore(const bytes& message, unsigned int offset,
     return false;
   }
 
+  // The block is in the chain and the state updated once stored. The rest of
+  // the commit runs as stages, so that the next round waits neither on the
+  // disk nor on the sends to the lookups.
+  CommitPipeline commitPipeline("FinalBlockCommit");
+  // Held by a lookup until the epoch is committed, so that the microblocks
+  // received meanwhile are not marked available before it
+  unique_lock<mutex> lockUnavailableMicroBlocks(m_mutexUnavailableMicroBlocks,
+                                                defer_lock);
+
   if (!isVacuousEpoch) {
-    if (!StoreFinalBlock(txBlock)) {
+    if (!StoreFinalBlock(txBlock, epochCommit)) {
       LOG_GENERAL(WARNING, "StoreFinalBlock failed!");
       return false;
     }
 
     // if lookup and loaded microblocks, then skip
-    lock_guard<mutex> g(m_mutexUnavailableMicroBlocks);
+    lockUnavailableMicroBlocks.lock();
     if (!(LOOKUP_NODE_MODE &&
           m_unavailableMicroBlocks.find(txBlock.GetHeader().GetBlockNum()) !=
               m_unavailableMicroBlocks.end())) {
-      if (!BlockStorage::GetBlockStorage().PutEpochFin(
-              m_mediator.m_currentEpochNum)) {
-        LOG_GENERAL(WARNING, "BlockStorage::PutEpochFin failed "
-                                 << m_mediator.m_currentEpochNum);
-        return false;
-      }
+      epochCommit.PutEpochFin(m_mediator.m_currentEpochNum);
+    }
+    if (!LOOKUP_NODE_MODE) {
+      lockUnavailableMicroBlocks.unlock();
     }
   } else {
     LOG_GENERAL(INFO, "isVacuousEpoch now");
@@ -793,11 +808,28 @@ bool Node::ProcessFinalBlockCore(const bytes& message, unsigned int offset,
     // Remove because shard nodes will be shuffled in next epoch.
     CleanMicroblockConsensusBuffer();
 
-    if (!StoreFinalBlock(txBlock)) {
+    if (!StoreFinalBlock(txBlock, epochCommit)) {
       LOG_GENERAL(WARNING, "StoreFinalBlock failed!");
       return false;
     }
-    auto writeStateToDisk = [this]() -> void {
+  }
+
+  const uint64_t committedEpochNum = m_mediator.m_currentEpochNum;
+  const auto commitEpoch = commitPipeline.Add(
+      "CommitEpoch", [epochCommit, committedEpochNum]() {
+        if (!BlockStorage::GetBlockStorage().CommitEpoch(epochCommit)) {
+          LOG_GENERAL(WARNING,
+                      "BlockStorage::CommitEpoch failed " << committedEpochNum);
+          return false;
+        }
+        return true;
+      });
+
+  if (isVacuousEpoch) {
+    // The state on disk must not get ahead of the blocks
+    const uint64_t stateBlockNum = txBlock.GetHeader().GetBlockNum();
+    const StateHash blockStateRoot = txBlock.GetHeader().GetStateRootHash();
+    auto writeStateToDisk = [this, stateBlockNum, blockStateRoot]() -> bool {
       if (!AccountStore::GetInstance().MoveUpdatesToDisk(
               LOOKUP_NODE_MODE && ENABLE_REPOPULATE &&
               (m_mediator.m_dsBlockChain.GetLastBlock()
@@ -813,20 +845,23 @@ bool Node::ProcessFinalBlockCore(const bytes& message, unsigned int offset,
           LOG_GENERAL(WARNING, "BlockStorage::PutLatestEpochStatesUpdated "
                                    << m_mediator.m_currentEpochNum
                                    << " failed");
-          return;
+          return false;
         }
+        // Only a hint for the rejoin, so a mismatch does not fail the commit
+        AccountStore::GetInstance().PutStateRootCheckpoint(stateBlockNum,
+                                                           blockStateRoot);
         if (!LOOKUP_NODE_MODE) {
           if (!BlockStorage::GetBlockStorage().PutMetadata(
                   MetaType::DSINCOMPLETED, {'0'})) {
             LOG_GENERAL(WARNING,
                         "BlockStorage::PutMetadata (DSINCOMPLETED) '0' failed");
-            return;
+            return false;
           }
           if (!BlockStorage::GetBlockStorage().PutEpochFin(
                   m_mediator.m_currentEpochNum)) {
             LOG_GENERAL(WARNING, "BlockStorage::PutEpochFin failed "
                                      << m_mediator.m_currentEpochNum);
-            return;
+            return false;
           }
         } else {
           // change if all microblock received from shards
@@ -844,7 +879,7 @@ bool Node::ProcessFinalBlockCore(const bytes& message, unsigned int offset,
                     m_mediator.m_currentEpochNum)) {
               LOG_GENERAL(WARNING, "BlockStorage::PutEpochFin failed "
                                        << m_mediator.m_currentEpochNum);
-              return;
+              return false;
             }
           }
         }
@@ -862,8 +897,38 @@ bool Node::ProcessFinalBlockCore(const bytes& message, unsigned int offset,
           PopulateAccounts();
         }
       }
+      return true;
     };
-    DetachedFunction(1, writeStateToDisk);
+    commitPipeline.Add("WriteStateToDisk", writeStateToDisk, {commitEpoch},
+                       DetachedExecutor::PERSISTENCE_LANE);
+
+    // Only logged, off the path of the next round
+    const uint64_t rewardEpochNum = txBlock.GetHeader().GetBlockNum();
+    commitPipeline.Add("LogReward", [this, rewardEpochNum,
+                                     stateDelta = move(stateDelta)]() {
+      unordered_map<Address, int256_t> addressMap;
+      if (!Messenger::StateDeltaToAddressMap(stateDelta, 0, addressMap)) {
+        LOG_GENERAL(WARNING, "Messenger::StateDeltaToAccountMap failed");
+        return false;
+      }
+      auto it = addressMap.find(
+          Account::GetAddressFromPublicKey(m_mediator.m_selfKey.second));
+      if (it != addressMap.end()) {
+        auto reward = it->second;
+        LOG_EPOCH(INFO, rewardEpochNum,
+                  "[REWARD]"
+                      << " Got " << reward << " as reward");
+        LOG_STATE("[REWARD][" << setw(15) << left
+                              << m_mediator.m_selfPeer.GetPrintableIPAddress()
+                              << "][" << rewardEpochNum << "][" << reward
+                              << "] FLBLK");
+      } else {
+        LOG_EPOCH(INFO, rewardEpochNum,
+                  "[REWARD]"
+                      << "Got no reward this ds epoch");
+      }
+      return true;
+    });
   }
 
   // m_mediator.HeartBeatPulse();
@@ -885,12 +950,32 @@ bool Node::ProcessFinalBlockCore(const bytes& message, unsigned int offset,
 
   if (!LOOKUP_NODE_MODE) {
     if (toSendTxnToLookup) {
-      CallActOnFinalblock();
+      commitPipeline.Add("ActOnFinalblock", [this]() {
+        CallActOnFinalblock();
+        return true;
+      });
     }
     if (toSendPendingTxn) {
-      SendPendingTxnToLookup();
+      commitPipeline.Add("SendPendingTxn",
+                         [this]() { return SendPendingTxnToLookup(); });
+    }
+  }
+
+  commitPipeline.Start();
+
+  // The microblocks and txn bodies a lookup commits next are written after
+  // the block they belong to
+  if (LOOKUP_NODE_MODE) {
+    const bool committed = commitPipeline.Wait(commitEpoch);
+    if (lockUnavailableMicroBlocks.owns_lock()) {
+      lockUnavailableMicroBlocks.unlock();
     }
+    if (!committed) {
+      return false;
+    }
+  }
 
+  if (!LOOKUP_NODE_MODE) {
     if (isVacuousEpoch) {
       InitiatePoW();
     } else {
@@ -930,7 +1015,8 @@ bool Node::ProcessStateDeltaFromFinalBlock(
     const bytes& stateDeltaBytes, const StateHash& finalBlockStateDeltaHash) {
   LOG_MARKER();
 
-  // Init local AccountStoreTemp first
+  // Init local AccountStoreTemp first, once nothing is read from it ahead
+  StopTxnSpeculation();
   AccountStore::GetInstance().InitTemp();
 
   LOG_GENERAL(INFO,
@@ -985,6 +1071,18 @@ void Node::CommitForwardedTransactions(const MBnForwardedTxnEntry& entry) {
 
   LOG_MARKER();
 
+  // The events are looked up by the tx block of the microblock
+  if (ENABLE_EVENT_BLOOM_INDEX) {
+    EventBloom eventBloom;
+    for (const auto& twr : entry.m_transactions) {
+      eventBloom.AddReceipt(twr.GetTransactionReceipt());
+    }
+    if (!BlockStorage::GetBlockStorage().MergeEventBloom(
+            entry.m_microBlock.GetHeader().GetEpochNum(), eventBloom)) {
+      LOG_GENERAL(WARNING, "BlockStorage::MergeEventBloom failed");
+    }
+  }
+
   for (const auto& twr : entry.m_transactions) {
     LOG_GENERAL(INFO, "Commit txn " << twr.GetTransaction().GetTranID().hex());
     if (LOOKUP_NODE_MODE) {
@@ -999,12 +1097,17 @@ void Node::CommitForwardedTransactions(const MBnForwardedTxnEntry& entry) {
     // Store TxBody to disk
     bytes serializedTxBody;
     twr.Serialize(serializedTxBody, 0);
-    if (!BlockStorage::GetBlockStorage().PutTxBody(
+    if (!BlockStorage::GetBlockStorage().EnqueueTxBody(
             twr.GetTransaction().GetTranID(), serializedTxBody)) {
-      LOG_GENERAL(WARNING, "BlockStorage::PutTxBody failed "
+      LOG_GENERAL(WARNING, "BlockStorage::EnqueueTxBody failed "
                                << twr.GetTransaction().GetTranID());
       return;
     }
+    if (!BlockStorage::GetBlockStorage().PutTxnHistory(
+            twr, entry.m_microBlock.GetHeader().GetEpochNum())) {
+      LOG_GENERAL(WARNING, "BlockStorage::PutTxnHistory failed "
+                               << twr.GetTransaction().GetTranID());
+    }
   }
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
             "Proceessed " << entry.m_transactions.size() << " of txns.");
@@ -1093,6 +1196,22 @@ bool Node::ProcessMBnForwardTransaction(const bytes& message,
     return false;
   }
 
+  if (!entry.m_receipts.empty()) {
+    PendingCompactMBnForward pending{move(entry), from, {}};
+    vector<TxnHash> missing;
+    if (!RebuildCompactMBnForward(pending, missing)) {
+      return missing.empty() ? false
+                             : RequestCompactMBnForwardTxns(move(pending),
+                                                            missing);
+    }
+    entry = move(pending.m_entry);
+  }
+
+  return ProcessMBnForwardedTxnEntry(entry, from);
+}
+
+bool Node::ProcessMBnForwardedTxnEntry(const MBnForwardedTxnEntry& entry,
+                                       const Peer& from) {
   // Verify txnhash
   TxnHash txnHash = ComputeRoot(entry.m_transactions);
   if (txnHash != entry.m_microBlock.GetHeader().GetTxRootHash()) {
@@ -1148,6 +1267,176 @@ bool Node::ProcessMBnForwardTransaction(const bytes& message,
   return ProcessMBnForwardTransactionCore(entry);
 }
 
+bool Node::RebuildCompactMBnForward(PendingCompactMBnForward& pending,
+                                    vector<TxnHash>& missing) {
+  MBnForwardedTxnEntry& entry = pending.m_entry;
+  const vector<TxnHash>& tranHashes = entry.m_microBlock.GetTranHashes();
+  if (tranHashes.size() != entry.m_receipts.size()) {
+    LOG_CHECK_FAIL("Receipts count", tranHashes.size(),
+                   entry.m_receipts.size());
+    return false;
+  }
+
+  vector<Transaction> txns(tranHashes.size());
+  for (unsigned int i = 0; i < tranHashes.size(); i++) {
+    const auto it = pending.m_received.find(tranHashes[i]);
+    if (it != pending.m_received.end()) {
+      txns[i] = it->second;
+    } else if (!m_mediator.m_lookup->GetDispatchedTxn(tranHashes[i],
+                                                      txns[i])) {
+      missing.emplace_back(tranHashes[i]);
+    }
+  }
+
+  LOG_GENERAL(INFO, "Compact MB " << entry.m_microBlock.GetBlockHash()
+                                  << " txns: " << tranHashes.size()
+                                  << " missing: " << missing.size());
+
+  if (!missing.empty()) {
+    return false;
+  }
+
+  entry.m_transactions.clear();
+  for (unsigned int i = 0; i < txns.size(); i++) {
+    entry.m_transactions.emplace_back(txns[i], entry.m_receipts[i]);
+  }
+  entry.m_receipts.clear();
+  pending.m_received.clear();
+
+  return true;
+}
+
+bool Node::RequestCompactMBnForwardTxns(PendingCompactMBnForward&& pending,
+                                        const vector<TxnHash>& missing) {
+  const MicroBlock& microBlock = pending.m_entry.m_microBlock;
+  const uint32_t shardId = microBlock.GetHeader().GetShardId();
+
+  // The txns are asked from the sender, whose listening port is found from
+  // the committee it belongs to
+  Peer sender;
+  {
+    lock_guard<mutex> g(m_mediator.m_ds->m_mutexShards);
+    if (shardId < m_mediator.m_ds->m_shards.size()) {
+      for (const auto& node : m_mediator.m_ds->m_shards.at(shardId)) {
+        const Peer& peer = std::get<SHARD_NODE_PEER>(node);
+        if (peer.m_ipAddress == pending.m_from.m_ipAddress) {
+          sender = peer;
+          break;
+        }
+      }
+    }
+  }
+  if (sender.m_listenPortHost == 0) {
+    lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
+    for (const auto& node : *m_mediator.m_DSCommittee) {
+      if (node.second.m_ipAddress == pending.m_from.m_ipAddress) {
+        sender = node.second;
+        break;
+      }
+    }
+  }
+  if (sender.m_listenPortHost == 0) {
+    LOG_GENERAL(WARNING, "Sender of compact MB " << microBlock.GetBlockHash()
+                                                 << " not in shard "
+                                                 << shardId);
+    return false;
+  }
+
+  const uint64_t epochNum = microBlock.GetHeader().GetEpochNum();
+  {
+    lock_guard<mutex> g(m_mutexPendingCompactMBnForwards);
+
+    // Relays of this microblock from the other senders are dropped while
+    // its txns are asked for. The missing microblock fetch covers a sender
+    // that never answers.
+    if (m_pendingCompactMBnForwards.find(microBlock.GetBlockHash()) !=
+        m_pendingCompactMBnForwards.end()) {
+      LOG_GENERAL(INFO, "Txns of compact MB " << microBlock.GetBlockHash()
+                                               << " already requested");
+      return true;
+    }
+
+    const uint64_t lastBlockNum =
+        m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+    for (auto it = m_pendingCompactMBnForwards.begin();
+         it != m_pendingCompactMBnForwards.end();) {
+      if (it->second.m_entry.m_microBlock.GetHeader().GetEpochNum() + 1 <
+          lastBlockNum) {
+        it = m_pendingCompactMBnForwards.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    m_pendingCompactMBnForwards.emplace(microBlock.GetBlockHash(),
+                                        move(pending));
+  }
+
+  bytes request = {MessageType::NODE, NodeInstructionType::SUBMITTRANSACTION,
+                   SUBMITTRANSACTIONTYPE::MISSINGTXNREQUEST};
+  if (!Messenger::SetNodeMissingTxnsErrorMsg(
+          request, MessageOffset::BODY + MessageOffset::INST, missing,
+          epochNum, m_mediator.m_selfPeer.m_listenPortHost)) {
+    LOG_GENERAL(WARNING, "Messenger::SetNodeMissingTxnsErrorMsg failed");
+    return false;
+  }
+
+  LOG_GENERAL(INFO, "Requesting " << missing.size() << " txns of epoch "
+                                  << epochNum << " from " << sender);
+  P2PComm::GetInstance().SendMessage(sender, request);
+
+  return true;
+}
+
+bool Node::ProcessCompactMBnForwardMissingTxns(const bytes& message,
+                                               unsigned int offset) {
+  if (offset + sizeof(uint64_t) > message.size()) {
+    LOG_GENERAL(WARNING, "Invalid txn message, message size: "
+                             << message.size()
+                             << ", txn data offset: " << offset);
+    return false;
+  }
+
+  const auto epochNum =
+      Serializable::GetNumber<uint64_t>(message, offset, sizeof(uint64_t));
+
+  vector<Transaction> txns;
+  if (!Messenger::GetTransactionArray(message, offset + sizeof(uint64_t),
+                                      txns)) {
+    LOG_GENERAL(WARNING, "Messenger::GetTransactionArray failed.");
+    return false;
+  }
+
+  vector<PendingCompactMBnForward> rebuilt;
+  {
+    lock_guard<mutex> g(m_mutexPendingCompactMBnForwards);
+    for (auto it = m_pendingCompactMBnForwards.begin();
+         it != m_pendingCompactMBnForwards.end();) {
+      auto& pending = it->second;
+      vector<TxnHash> missing;
+      if (pending.m_entry.m_microBlock.GetHeader().GetEpochNum() != epochNum) {
+        ++it;
+        continue;
+      }
+      for (const auto& tx : txns) {
+        pending.m_received.emplace(tx.GetTranID(), tx);
+      }
+      if (RebuildCompactMBnForward(pending, missing)) {
+        rebuilt.emplace_back(move(pending));
+        it = m_pendingCompactMBnForwards.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  for (const auto& pending : rebuilt) {
+    ProcessMBnForwardedTxnEntry(pending.m_entry, pending.m_from);
+  }
+
+  return true;
+}
+
 bool Node::AddPendingTxn(const HashCodeMap& pendingTxns, const PubKey& pubkey,
                          uint32_t shardId) {
   uint size;
@@ -1174,11 +1463,10 @@ bool Node::AddPendingTxn(const HashCodeMap& pendingTxns, const PubKey& pubkey,
     }
   }
 
-  unique_lock<shared_timed_mutex> g(m_unconfirmedTxnsMutex);
   for (const auto& entry : pendingTxns) {
     LOG_GENERAL(INFO, " " << entry.first << " " << entry.second);
-    m_unconfirmedTxns.emplace(entry);
   }
+  m_unconfirmedTxns.InsertBatch(pendingTxns);
   return true;
 }
 
@@ -1280,6 +1568,8 @@ bool Node::ProcessMBnForwardTransactionCore(const MBnForwardedTxnEntry& entry) {
     if (isEveryMicroBlockAvailable) {
       DeleteEntryFromFwdingAssgnAndMissingBodyCountMap(
           entry.m_microBlock.GetHeader().GetEpochNum());
+      m_mediator.m_lookup->StoreCosigsRewardsRecord(
+          entry.m_microBlock.GetHeader().GetEpochNum());
 
       if (m_isVacuousEpochBuffer) {
         // Check is states updated
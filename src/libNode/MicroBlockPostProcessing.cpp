@@ -38,6 +38,7 @@
 #include "libUtils/BitVector.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
+#include "libUtils/EpochPerf.h"
 #include "libUtils/Logger.h"
 #include "libUtils/RootComputation.h"
 #include "libUtils/SanityChecks.h"
@@ -238,6 +239,10 @@ bool Node::ProcessMicroBlockConsensusCore(const bytes& message,
   ConsensusCommon::State state = m_consensusObject->GetState();
 
   if (state == ConsensusCommon::State::DONE) {
+    if (ENABLE_EPOCH_PERF) {
+      EpochPerf::GetInstance().End(EpochPerf::MICROBLOCK_CONSENSUS);
+    }
+
     // Update the micro block with the co-signatures from the consensus
     m_microblock->SetCoSignatures(*m_consensusObject);
 
@@ -295,6 +300,7 @@ bool Node::ProcessMicroBlockConsensusCore(const bytes& message,
                      m_consensusObject->GetCS2(), m_consensusObject->GetB2());
 
     SetState(WAITING_FINALBLOCK);
+    SpeculateNextMicroBlock();
 
     lock_guard<mutex> cv_lk(m_MutexCVFBWaitMB);
     cv_FBWaitMB.notify_all();
@@ -18,6 +18,7 @@
 #include <array>
 #include <chrono>
 #include <functional>
+#include <set>
 #include <thread>
 
 #include "Node.h"
@@ -31,6 +32,7 @@
 #include "libCrypto/Sha2.h"
 #include "libData/AccountData/Account.h"
 #include "libData/AccountData/AccountStore.h"
+#include "libData/AccountData/PendingTxnQueue.h"
 #include "libData/AccountData/Transaction.h"
 #include "libData/AccountData/TransactionReceipt.h"
 #include "libData/AccountData/TxnOrderVerifier.h"
@@ -40,17 +42,38 @@
 #include "libUtils/BitVector.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
+#include "libUtils/EpochPerf.h"
 #include "libUtils/Logger.h"
 #include "libUtils/RootComputation.h"
 #include "libUtils/SanityChecks.h"
 #include "libUtils/TimeLockedFunction.h"
 #include "libUtils/TimeUtils.h"
 #include "libUtils/TimestampVerifier.h"
+#include "libValidator/Validator.h"
 
 using namespace std;
 using namespace boost::multiprecision;
 using namespace boost::multi_index;
 
+namespace {
+// Load the accounts and contract states the pooled transactions will read
+void PrefetchForTxns(const TxnPool& txns) {
+  set<Address> addresses;
+  set<Address> contractCalls;
+  for (const auto& t : txns.HashIndex()) {
+    addresses.emplace(t.GetSenderAddr());
+    if (IsNullAddress(t.GetToAddr())) {
+      continue;
+    }
+    addresses.emplace(t.GetToAddr());
+    if (Transaction::GetTransactionType(t) == Transaction::CONTRACT_CALL) {
+      contractCalls.emplace(t.GetToAddr());
+    }
+  }
+  AccountStore::GetInstance().PrefetchAccounts(addresses, contractCalls);
+}
+}  // namespace
+
 bool Node::ComposeMicroBlock(const uint64_t& microblock_gas_limit) {
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
@@ -167,8 +190,14 @@ bool Node::OnNodeMissingTxns(const bytes& errorMsg, const unsigned int offset,
   uint64_t epochNum = 0;
   uint32_t portNo = 0;
 
-  if (!Messenger::GetNodeMissingTxnsErrorMsg(
-          errorMsg, offset, missingTransactions, epochNum, portNo)) {
+  // Backups send the txns missing from my proposal as positions in it
+  const shared_ptr<MicroBlock> microblock = m_microblock;
+  const vector<TxnHash> proposedTranHashes =
+      microblock ? microblock->GetTranHashes() : vector<TxnHash>();
+
+  if (!Messenger::GetNodeMissingTxnsErrorMsg(errorMsg, offset,
+                                             missingTransactions, epochNum,
+                                             portNo, proposedTranHashes)) {
     LOG_GENERAL(WARNING, "Messenger::GetNodeMissingTxnsErrorMsg failed");
     return false;
   }
@@ -249,7 +278,7 @@ bool Node::OnCommitFailure([
   return true;
 }
 
-void Node::NotifyTimeout(bool& txnProcTimeout) {
+void Node::NotifyTimeout(atomic<bool>& txnProcTimeout, uint64_t round) {
   int timeout_time = std::max(
       0,
       ((int)MICROBLOCK_TIMEOUT -
@@ -258,13 +287,167 @@ void Node::NotifyTimeout(bool& txnProcTimeout) {
   LOG_GENERAL(INFO, "The overall timeout for txn processing will be "
                         << timeout_time << " seconds");
   unique_lock<mutex> lock(m_mutexCVTxnProcFinished);
-  if (cv_TxnProcFinished.wait_for(lock, chrono::seconds(timeout_time)) ==
-      cv_status::timeout) {
+  if (!cv_TxnProcFinished.wait_for(
+          lock, chrono::seconds(timeout_time),
+          [this, round]() { return m_txnProcRound != round; })) {
     txnProcTimeout = true;
     AccountStore::GetInstance().NotifyTimeout();
   }
 }
 
+uint64_t Node::GetTxnProcRound() {
+  lock_guard<mutex> g(m_mutexCVTxnProcFinished);
+  return m_txnProcRound;
+}
+
+void Node::FinishTxnProcRound() {
+  {
+    lock_guard<mutex> g(m_mutexCVTxnProcFinished);
+    m_txnProcRound++;
+  }
+  cv_TxnProcFinished.notify_all();
+}
+
+void Node::SpeculateNextMicroBlock() {
+  const uint64_t epochNum = m_mediator.m_currentEpochNum + 1;
+  if (!SPECULATIVE_TXN_PROCESSING || LOOKUP_NODE_MODE ||
+      m_mediator.GetIsVacuousEpoch(epochNum) ||
+      (ENABLE_ACCOUNTS_POPULATING && UPDATE_PREGENED_ACCOUNTS)) {
+    return;
+  }
+
+  const uint64_t round = m_txnSpeculationRound;
+  auto speculate = [this, epochNum, round]() -> void {
+    lock_guard<mutex> g(m_mutexTxnSpeculation);
+    // The final block may already be on its way into AccountStoreTemp
+    if (round != m_txnSpeculationRound) {
+      return;
+    }
+    m_txnSpeculation.Reset(epochNum);
+
+    // Taken in the order the next round takes them, from what this round
+    // left in the pool
+    vector<Transaction> txns;
+    {
+      lock_guard<mutex> g2(m_mutexCreatedTransactions);
+      TxnPoolView view(t_createdTxns);
+      uint64_t gasBound = 0;
+      Transaction t;
+      while (gasBound < SHARD_MICROBLOCK_GAS_LIMIT && view.findOne(t)) {
+        gasBound += t.GetGasLimit();
+        txns.emplace_back(move(t));
+      }
+    }
+
+    const unsigned int numShards = m_numShards;
+    for (const auto& t : txns) {
+      if (m_stopTxnSpeculation) {
+        break;
+      }
+      // The round stops using the outcomes at the first transaction it takes
+      // in place of the ones left out here
+      if (t.GetNonce() != m_txnSpeculation.GetNonce(t.GetSenderAddr()) + 1) {
+        continue;
+      }
+      if (!m_txnSpeculation.Speculate(numShards, t)) {
+        break;
+      }
+    }
+
+    LOG_GENERAL(INFO, "Speculated " << m_txnSpeculation.GetNumSpeculated()
+                                    << " txns for epoch " << epochNum);
+  };
+  DetachedFunction(1, speculate);
+}
+
+void Node::StopTxnSpeculation() {
+  if (!SPECULATIVE_TXN_PROCESSING) {
+    return;
+  }
+
+  m_stopTxnSpeculation = true;
+  lock_guard<mutex> g(m_mutexTxnSpeculation);
+  m_txnSpeculationRound++;
+  m_stopTxnSpeculation = false;
+}
+
+namespace {
+/// Transactions waiting to be executed together: payments, and at the DS
+/// committee also contract calls if the account store runs them in parallel.
+/// Queued transactions share no sender or recipient, so executing them
+/// together leaves the same state as executing them one by one in queue order.
+class TxnBatch {
+  const bool m_withContractCalls;
+  vector<Transaction> m_txns;
+  set<Address> m_senders;
+  set<Address> m_addrs;
+  uint64_t m_gasBound{0};
+
+ public:
+  using AppliedFunc =
+      function<bool(const Transaction& t, const TransactionReceipt& tr)>;
+
+  explicit TxnBatch(bool withContractCalls)
+      : m_withContractCalls(withContractCalls) {}
+
+  /// Returns the most gas the queued transactions can use.
+  uint64_t GetGasBound() const { return m_gasBound; }
+
+  bool HasSender(const Address& addr) const {
+    return m_senders.find(addr) != m_senders.end();
+  }
+
+  bool CanAdd(const Transaction& t) const {
+    if (TXN_EXECUTION_THREADS <= 1) {
+      return false;
+    }
+    const auto type = Transaction::GetTransactionType(t);
+    if ((type != Transaction::NON_CONTRACT) &&
+        ((type != Transaction::CONTRACT_CALL) || !m_withContractCalls)) {
+      return false;
+    }
+    return (m_addrs.find(t.GetSenderAddr()) == m_addrs.end()) &&
+           (m_addrs.find(t.GetToAddr()) == m_addrs.end());
+  }
+
+  void Add(const Transaction& t) {
+    m_txns.emplace_back(t);
+    m_senders.emplace(t.GetSenderAddr());
+    m_addrs.emplace(t.GetSenderAddr());
+    m_addrs.emplace(t.GetToAddr());
+    m_gasBound +=
+        Transaction::GetTransactionType(t) == Transaction::NON_CONTRACT
+            ? NORMAL_TRAN_GAS
+            : t.GetGasLimit();
+  }
+
+  /// Executes the queued transactions and passes the successful ones to
+  /// onApplied in order. Returns false as soon as onApplied does.
+  bool Flush(const Validator& validator, const AppliedFunc& onApplied) {
+    if (m_txns.empty()) {
+      return true;
+    }
+
+    vector<Transaction> txns;
+    txns.swap(m_txns);
+    m_senders.clear();
+    m_addrs.clear();
+    m_gasBound = 0;
+
+    vector<TransactionReceipt> receipts(txns.size());
+    vector<char> results;
+    validator.CheckCreatedTransactions(txns, receipts, results);
+
+    for (unsigned int i = 0; i < txns.size(); i++) {
+      if (results.at(i) && !onApplied(txns.at(i), receipts.at(i))) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+}  // namespace
+
 void Node::ProcessTransactionWhenShardLeader(
     const uint64_t& microblock_gas_limit) {
   LOG_MARKER();
@@ -273,42 +456,32 @@ void Node::ProcessTransactionWhenShardLeader(
     UpdateBalanceForPreGeneratedAccounts();
   }
 
+  // Held for the round, as its transactions take the outcomes in order
+  lock_guard<mutex> g2(m_mutexTxnSpeculation);
   lock_guard<mutex> g(m_mutexCreatedTransactions);
 
-  t_createdTxns = m_createdTxns;
-  map<Address, map<uint64_t, Transaction>> t_addrNonceTxnMap;
+  EpochPerf::Scope perf(EpochPerf::TXN_PROCESSING);
+
+  m_txnSpeculation.Validate(m_mediator.m_currentEpochNum);
+  t_createdTxns.Reset(m_createdTxns);
+  PrefetchForTxns(m_createdTxns);
+  PendingTxnQueue t_pendingTxns([](const Address& addr) {
+    return AccountStore::GetInstance().GetNonceTemp(addr);
+  });
   t_processedTransactions.clear();
   m_TxnOrder.clear();
 
-  bool txnProcTimeout = false;
+  // The round is taken here, so that the timer ends as soon as it is over,
+  // even if it is over before the timer starts waiting
+  atomic<bool> txnProcTimeout{false};
+  const uint64_t txnProcRound = GetTxnProcRound();
 
-  auto txnProcTimer = [this, &txnProcTimeout]() -> void {
-    NotifyTimeout(txnProcTimeout);
+  auto txnProcTimer = [this, &txnProcTimeout, txnProcRound]() -> void {
+    NotifyTimeout(txnProcTimeout, txnProcRound);
   };
 
   DetachedFunction(1, txnProcTimer);
 
-  this_thread::sleep_for(chrono::milliseconds(100));
-
-  auto findOneFromAddrNonceTxnMap =
-      [](Transaction& t,
-         map<Address, map<uint64_t, Transaction>>& t_addrNonceTxnMap) -> bool {
-    for (auto it = t_addrNonceTxnMap.begin(); it != t_addrNonceTxnMap.end();
-         it++) {
-      if (it->second.begin()->first ==
-          AccountStore::GetInstance().GetNonceTemp(it->first) + 1) {
-        t = move(it->second.begin()->second);
-        it->second.erase(it->second.begin());
-
-        if (it->second.empty()) {
-          t_addrNonceTxnMap.erase(it);
-        }
-        return true;
-      }
-    }
-    return false;
-  };
-
   auto appendOne = [this](const Transaction& t, const TransactionReceipt& tr) {
     t_processedTransactions.insert(
         make_pair(t.GetTranID(), TransactionWithReceipt(t, tr)));
@@ -322,110 +495,138 @@ void Node::ProcessTransactionWhenShardLeader(
 
   AccountStore::GetInstance().CleanStorageRootUpdateBufferTemp();
 
-  while (m_gasUsedTotal < microblock_gas_limit) {
+  auto applyOne = [&appendOne, this](const Transaction& t,
+                                     const TransactionReceipt& tr) -> bool {
+    if (!SafeMath<uint64_t>::add(m_gasUsedTotal, tr.GetCumGas(),
+                                 m_gasUsedTotal)) {
+      LOG_GENERAL(WARNING, "m_gasUsedTotal addition unsafe!");
+      return false;
+    }
+    uint128_t txnFee;
+    if (!SafeMath<uint128_t>::mul(tr.GetCumGas(), t.GetGasPrice(), txnFee)) {
+      LOG_GENERAL(WARNING, "txnFee multiplication unsafe!");
+      return true;
+    }
+    if (!SafeMath<uint128_t>::add(m_txnFees, txnFee, m_txnFees)) {
+      LOG_GENERAL(WARNING, "m_txnFees addition unsafe!");
+      return false;
+    }
+    appendOne(t, tr);
+    return true;
+  };
+
+  // A payment (or, at the DS committee, a contract call) that is ready is
+  // only queued. The queue is applied on the worker threads of the account
+  // store once anything further depends on its outcome.
+  TxnBatch batch(m_mediator.m_ds->m_mode != DirectoryService::Mode::IDLE &&
+                 AccountStore::GetInstance().ContractCallsRunInParallel());
+
+  auto flushBatch = [&batch, &applyOne, this]() -> bool {
+    return batch.Flush(*m_mediator.m_validator, applyOne);
+  };
+
+  auto processOne = [&batch, &flushBatch, &applyOne, &t_pendingTxns,
+                     this](const Transaction& t) -> bool {
+    t_pendingTxns.Touch(t.GetSenderAddr());
+
+    // The batch is empty, as the transactions before were speculated too
+    bool result = false;
+    TransactionReceipt speculatedReceipt;
+    if (m_txnSpeculation.TakeNext(t, result, speculatedReceipt)) {
+      return !result || applyOne(t, speculatedReceipt);
+    }
+
+    if (batch.CanAdd(t)) {
+      batch.Add(t);
+      // Txns of the sender waiting in t_pendingTxns need its new nonce
+      if (t_pendingTxns.Contains(t.GetSenderAddr())) {
+        return flushBatch();
+      }
+      return true;
+    }
+
+    if (!flushBatch()) {
+      return false;
+    }
+    TransactionReceipt tr;
+    if (m_mediator.m_validator->CheckCreatedTransaction(t, tr)) {
+      return applyOne(t, tr);
+    }
+    return true;
+  };
+
+  // Counts the queued transactions at the most gas they can use, so a check
+  // that passes also passes with the exact figure after they are applied
+  auto exceedsGasLimit = [&batch, &microblock_gas_limit,
+                          this](const uint64_t& gasLimit) -> bool {
+    return m_gasUsedTotal + batch.GetGasBound() + gasLimit >
+           microblock_gas_limit;
+  };
+
+  while (true) {
+    if (m_gasUsedTotal + batch.GetGasBound() >= microblock_gas_limit) {
+      if (!flushBatch() || (m_gasUsedTotal >= microblock_gas_limit)) {
+        break;
+      }
+    }
+
     if (txnProcTimeout) {
       break;
     }
 
     Transaction t;
-    TransactionReceipt tr;
 
-    // check m_addrNonceTxnMap contains any txn meets right nonce,
+    // check t_pendingTxns contains any txn meets right nonce,
     // if contains, process it
-    if (findOneFromAddrNonceTxnMap(t, t_addrNonceTxnMap)) {
+    if (t_pendingTxns.PopReady(t)) {
       // check whether m_createdTransaction have transaction with same Addr and
       // nonce if has and with larger gasPrice then replace with that one.
       // (*optional step)
       t_createdTxns.findSameNonceButHigherGas(t);
 
-      if (m_gasUsedTotal + t.GetGasLimit() > microblock_gas_limit) {
+      if (exceedsGasLimit(t.GetGasLimit()) && !flushBatch()) {
+        break;
+      }
+      if (exceedsGasLimit(t.GetGasLimit())) {
         gasLimitExceededTxnBuffer.emplace_back(t);
         continue;
       }
 
-      if (m_mediator.m_validator->CheckCreatedTransaction(t, tr)) {
-        if (!SafeMath<uint64_t>::add(m_gasUsedTotal, tr.GetCumGas(),
-                                     m_gasUsedTotal)) {
-          LOG_GENERAL(WARNING, "m_gasUsedTotal addition unsafe!");
-          break;
-        }
-        uint128_t txnFee;
-        if (!SafeMath<uint128_t>::mul(tr.GetCumGas(), t.GetGasPrice(),
-                                      txnFee)) {
-          LOG_GENERAL(WARNING, "txnFee multiplication unsafe!");
-          continue;
-        }
-        if (!SafeMath<uint128_t>::add(m_txnFees, txnFee, m_txnFees)) {
-          LOG_GENERAL(WARNING, "m_txnFees addition unsafe!");
-          break;
-        }
-        appendOne(t, tr);
-
-        continue;
+      if (!processOne(t)) {
+        break;
       }
     }
     // if no txn in u_map meet right nonce process new come-in transactions
     else if (t_createdTxns.findOne(t)) {
-      // LOG_GENERAL(INFO, "findOneFromCreated");
-
       Address senderAddr = t.GetSenderAddr();
+
+      // The nonce checks below need the queued transactions of the sender
+      if (batch.HasSender(senderAddr) && !flushBatch()) {
+        break;
+      }
+
       // check nonce, if nonce larger than expected, put it into
-      // m_addrNonceTxnMap
+      // t_pendingTxns
       if (t.GetNonce() >
           AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1) {
-        // LOG_GENERAL(INFO, "High nonce: "
-        //                     << t.GetNonce() << " cur sender " <<
-        //                     senderAddr.hex()
-        //                     << " nonce: "
-        //                     <<
-        //                     AccountStore::GetInstance().GetNonceTemp(senderAddr));
-        auto it1 = t_addrNonceTxnMap.find(senderAddr);
-        if (it1 != t_addrNonceTxnMap.end()) {
-          auto it2 = it1->second.find(t.GetNonce());
-          if (it2 != it1->second.end()) {
-            // found the txn with same addr and same nonce
-            // then compare the gasprice and remains the higher one
-            if (t.GetGasPrice() > it2->second.GetGasPrice()) {
-              it2->second = t;
-            }
-            continue;
-          }
-        }
-        t_addrNonceTxnMap[senderAddr].insert({t.GetNonce(), t});
+        t_pendingTxns.Insert(t);
       }
       // if nonce too small, ignore it
       else if (t.GetNonce() <
                AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1) {
-        // LOG_GENERAL(INFO,
-        //             "Nonce too small"
-        //                 << " Expected "
-        //                 <<
-        //                 AccountStore::GetInstance().GetNonceTemp(senderAddr)
-        //                 << " Found " << t.GetNonce());
       }
       // if nonce correct, process it
       else {
-        if (m_gasUsedTotal + t.GetGasLimit() > microblock_gas_limit) {
+        if (exceedsGasLimit(t.GetGasLimit()) && !flushBatch()) {
+          break;
+        }
+        if (exceedsGasLimit(t.GetGasLimit())) {
           gasLimitExceededTxnBuffer.emplace_back(t);
           continue;
         }
-        if (m_mediator.m_validator->CheckCreatedTransaction(t, tr)) {
-          if (!SafeMath<uint64_t>::add(m_gasUsedTotal, tr.GetCumGas(),
-                                       m_gasUsedTotal)) {
-            LOG_GENERAL(WARNING, "m_gasUsedTotal addition unsafe!");
-            break;
-          }
-          uint128_t txnFee;
-          if (!SafeMath<uint128_t>::mul(tr.GetCumGas(), t.GetGasPrice(),
-                                        txnFee)) {
-            LOG_GENERAL(WARNING, "txnFee multiplication unsafe!");
-            continue;
-          }
-          if (!SafeMath<uint128_t>::add(m_txnFees, txnFee, m_txnFees)) {
-            LOG_GENERAL(WARNING, "m_txnFees addition unsafe!");
-            break;
-          }
-          appendOne(t, tr);
+
+        if (!processOne(t)) {
+          break;
         }
       }
     } else {
@@ -433,15 +634,19 @@ void Node::ProcessTransactionWhenShardLeader(
     }
   }
 
+  // Whatever is still queued was due before the loop ended
+  flushBatch();
+  m_txnSpeculation.Reset(m_mediator.m_currentEpochNum);
+
   AccountStore::GetInstance().ProcessStorageRootUpdateBufferTemp();
 
-  cv_TxnProcFinished.notify_all();
+  FinishTxnProcRound();
   PutTxnsInTempDataBase(t_processedTransactions);
   if (ENABLE_TXNS_BACKUP) {
     SaveTxnsToS3(t_processedTransactions);
   }
   // Put txns in map back into pool
-  ReinstateMemPool(t_addrNonceTxnMap, gasLimitExceededTxnBuffer);
+  ReinstateMemPool(t_pendingTxns.GetTxns(), gasLimitExceededTxnBuffer);
 }
 
 bool Node::VerifyTxnsOrdering(const vector<TxnHash>& tranHashes,
@@ -495,8 +700,15 @@ void Node::UpdateProcessedTransactions() {
 
   {
     lock_guard<mutex> g(m_mutexCreatedTransactions);
-    m_createdTxns = move(t_createdTxns);
-    t_createdTxns.clear();
+    t_createdTxns.ApplyTo(m_createdTxns);
+  }
+  // The txns taken in blocks are left in the pendingTxns db until then
+  if (ENABLE_PENDING_TXN_PERSISTENCE &&
+      PENDING_TXN_COMPACTION_INTERVAL_IN_EPOCHS > 0 &&
+      m_mediator.m_currentEpochNum %
+              PENDING_TXN_COMPACTION_INTERVAL_IN_EPOCHS ==
+          0) {
+    CompactPendingTxns();
   }
   if (m_mediator.m_currentEpochNum % NUM_STORE_TX_BODIES_INTERVAL == 0) {
     BlockStorage::GetBlockStorage().ResetDB(
@@ -519,43 +731,32 @@ void Node::ProcessTransactionWhenShardBackup(
     UpdateBalanceForPreGeneratedAccounts();
   }
 
+  // Held for the round, as its transactions take the outcomes in order
+  lock_guard<mutex> g2(m_mutexTxnSpeculation);
   lock_guard<mutex> g(m_mutexCreatedTransactions);
 
-  t_createdTxns = m_createdTxns;
+  EpochPerf::Scope perf(EpochPerf::TXN_PROCESSING);
+
+  m_txnSpeculation.Validate(m_mediator.m_currentEpochNum);
+  t_createdTxns.Reset(m_createdTxns);
+  PrefetchForTxns(m_createdTxns);
   m_expectedTranOrdering.clear();
-  map<Address, map<uint64_t, Transaction>> t_addrNonceTxnMap;
+  PendingTxnQueue t_pendingTxns([](const Address& addr) {
+    return AccountStore::GetInstance().GetNonceTemp(addr);
+  });
   t_processedTransactions.clear();
 
-  bool txnProcTimeout = false;
+  // The round is taken here, so that the timer ends as soon as it is over,
+  // even if it is over before the timer starts waiting
+  atomic<bool> txnProcTimeout{false};
+  const uint64_t txnProcRound = GetTxnProcRound();
 
-  auto txnProcTimer = [this, &txnProcTimeout]() -> void {
-    NotifyTimeout(txnProcTimeout);
+  auto txnProcTimer = [this, &txnProcTimeout, txnProcRound]() -> void {
+    NotifyTimeout(txnProcTimeout, txnProcRound);
   };
 
   DetachedFunction(1, txnProcTimer);
 
-  this_thread::sleep_for(chrono::milliseconds(100));
-
-  auto findOneFromAddrNonceTxnMap =
-      [](Transaction& t,
-         std::map<Address, map<uint64_t, Transaction>>& t_addrNonceTxnMap)
-      -> bool {
-    for (auto it = t_addrNonceTxnMap.begin(); it != t_addrNonceTxnMap.end();
-         it++) {
-      if (it->second.begin()->first ==
-          AccountStore::GetInstance().GetNonceTemp(it->first) + 1) {
-        t = move(it->second.begin()->second);
-        it->second.erase(it->second.begin());
-
-        if (it->second.empty()) {
-          t_addrNonceTxnMap.erase(it);
-        }
-        return true;
-      }
-    }
-    return false;
-  };
-
   auto appendOne = [this](const Transaction& t, const TransactionReceipt& tr) {
     m_expectedTranOrdering.emplace_back(t.GetTranID());
     t_processedTransactions.insert(
@@ -569,67 +770,121 @@ void Node::ProcessTransactionWhenShardBackup(
 
   AccountStore::GetInstance().CleanStorageRootUpdateBufferTemp();
 
-  while (m_gasUsedTotal < microblock_gas_limit) {
+  auto applyOne = [&appendOne, this](const Transaction& t,
+                                     const TransactionReceipt& tr) -> bool {
+    if (!SafeMath<uint64_t>::add(m_gasUsedTotal, tr.GetCumGas(),
+                                 m_gasUsedTotal)) {
+      LOG_GENERAL(WARNING, "m_gasUsedTotal addition overflow!");
+      return false;
+    }
+    uint128_t txnFee;
+    if (!SafeMath<uint128_t>::mul(tr.GetCumGas(), t.GetGasPrice(), txnFee)) {
+      LOG_GENERAL(WARNING, "txnFee multiplication overflow!");
+      return true;
+    }
+    if (!SafeMath<uint128_t>::add(m_txnFees, txnFee, m_txnFees)) {
+      LOG_GENERAL(WARNING, "m_txnFees addition overflow!");
+      return false;
+    }
+    appendOne(t, tr);
+    return true;
+  };
+
+  // A payment (or, at the DS committee, a contract call) that is ready is
+  // only queued. The queue is applied on the worker threads of the account
+  // store once anything further depends on its outcome.
+  TxnBatch batch(m_mediator.m_ds->m_mode != DirectoryService::Mode::IDLE &&
+                 AccountStore::GetInstance().ContractCallsRunInParallel());
+
+  auto flushBatch = [&batch, &applyOne, this]() -> bool {
+    return batch.Flush(*m_mediator.m_validator, applyOne);
+  };
+
+  auto processOne = [&batch, &flushBatch, &applyOne, &t_pendingTxns,
+                     this](const Transaction& t) -> bool {
+    t_pendingTxns.Touch(t.GetSenderAddr());
+
+    // The batch is empty, as the transactions before were speculated too
+    bool result = false;
+    TransactionReceipt speculatedReceipt;
+    if (m_txnSpeculation.TakeNext(t, result, speculatedReceipt)) {
+      return !result || applyOne(t, speculatedReceipt);
+    }
+
+    if (batch.CanAdd(t)) {
+      batch.Add(t);
+      // Txns of the sender waiting in t_pendingTxns need its new nonce
+      if (t_pendingTxns.Contains(t.GetSenderAddr())) {
+        return flushBatch();
+      }
+      return true;
+    }
+
+    if (!flushBatch()) {
+      return false;
+    }
+    TransactionReceipt tr;
+    if (m_mediator.m_validator->CheckCreatedTransaction(t, tr)) {
+      return applyOne(t, tr);
+    }
+    return true;
+  };
+
+  // Counts the queued transactions at the most gas they can use, so a check
+  // that passes also passes with the exact figure after they are applied
+  auto exceedsGasLimit = [&batch, &microblock_gas_limit,
+                          this](const uint64_t& gasLimit) -> bool {
+    return m_gasUsedTotal + batch.GetGasBound() + gasLimit >
+           microblock_gas_limit;
+  };
+
+  while (true) {
+    if (m_gasUsedTotal + batch.GetGasBound() >= microblock_gas_limit) {
+      if (!flushBatch() || (m_gasUsedTotal >= microblock_gas_limit)) {
+        break;
+      }
+    }
+
     if (txnProcTimeout) {
       break;
     }
 
     Transaction t;
-    TransactionReceipt tr;
 
-    // check t_addrNonceTxnMap contains any txn meets right nonce,
+    // check t_pendingTxns contains any txn meets right nonce,
     // if contains, process it
-    if (findOneFromAddrNonceTxnMap(t, t_addrNonceTxnMap)) {
+    if (t_pendingTxns.PopReady(t)) {
       // check whether m_createdTransaction have transaction with same Addr and
       // nonce if has and with larger gasPrice then replace with that one.
       // (*optional step)
       t_createdTxns.findSameNonceButHigherGas(t);
 
-      if (m_gasUsedTotal + t.GetGasLimit() > microblock_gas_limit) {
+      if (exceedsGasLimit(t.GetGasLimit()) && !flushBatch()) {
+        break;
+      }
+      if (exceedsGasLimit(t.GetGasLimit())) {
         gasLimitExceededTxnBuffer.emplace_back(t);
         continue;
       }
 
-      if (m_mediator.m_validator->CheckCreatedTransaction(t, tr)) {
-        if (!SafeMath<uint64_t>::add(m_gasUsedTotal, tr.GetCumGas(),
-                                     m_gasUsedTotal)) {
-          LOG_GENERAL(WARNING, "m_gasUsedTotal addition unsafe!");
-          break;
-        }
-        uint128_t txnFee;
-        if (!SafeMath<uint128_t>::mul(tr.GetCumGas(), t.GetGasPrice(),
-                                      txnFee)) {
-          LOG_GENERAL(WARNING, "txnFee multiplication unsafe!");
-          continue;
-        }
-        if (!SafeMath<uint128_t>::add(m_txnFees, txnFee, m_txnFees)) {
-          LOG_GENERAL(WARNING, "m_txnFees addition unsafe!");
-          break;
-        }
-        appendOne(t, tr);
-        continue;
+      if (!processOne(t)) {
+        break;
       }
     }
     // if no txn in u_map meet right nonce process new come-in transactions
     else if (t_createdTxns.findOne(t)) {
       Address senderAddr = t.GetSenderAddr();
+
+      // The nonce checks below need the queued transactions of the sender
+      if (batch.HasSender(senderAddr) && !flushBatch()) {
+        break;
+      }
+
       // check nonce, if nonce larger than expected, put it into
-      // t_addrNonceTxnMap
+      // t_pendingTxns
       if (t.GetNonce() >
           AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1) {
-        auto it1 = t_addrNonceTxnMap.find(senderAddr);
-        if (it1 != t_addrNonceTxnMap.end()) {
-          auto it2 = it1->second.find(t.GetNonce());
-          if (it2 != it1->second.end()) {
-            // found the txn with same addr and same nonce
-            // then compare the gasprice and remains the higher one
-            if (t.GetGasPrice() > it2->second.GetGasPrice()) {
-              it2->second = t;
-            }
-            continue;
-          }
-        }
-        t_addrNonceTxnMap[senderAddr].insert({t.GetNonce(), t});
+        t_pendingTxns.Insert(t);
       }
       // if nonce too small, ignore it
       else if (t.GetNonce() <
@@ -637,28 +892,16 @@ void Node::ProcessTransactionWhenShardBackup(
       }
       // if nonce correct, process it
       else {
-        if (m_gasUsedTotal + t.GetGasLimit() > microblock_gas_limit) {
+        if (exceedsGasLimit(t.GetGasLimit()) && !flushBatch()) {
+          break;
+        }
+        if (exceedsGasLimit(t.GetGasLimit())) {
           gasLimitExceededTxnBuffer.emplace_back(t);
           continue;
         }
 
-        if (m_mediator.m_validator->CheckCreatedTransaction(t, tr)) {
-          if (!SafeMath<uint64_t>::add(m_gasUsedTotal, tr.GetCumGas(),
-                                       m_gasUsedTotal)) {
-            LOG_GENERAL(WARNING, "m_gasUsedTotal addition overflow!");
-            break;
-          }
-          uint128_t txnFee;
-          if (!SafeMath<uint128_t>::mul(tr.GetCumGas(), t.GetGasPrice(),
-                                        txnFee)) {
-            LOG_GENERAL(WARNING, "txnFee multiplication overflow!");
-            continue;
-          }
-          if (!SafeMath<uint128_t>::add(m_txnFees, txnFee, m_txnFees)) {
-            LOG_GENERAL(WARNING, "m_txnFees addition overflow!");
-            break;
-          }
-          appendOne(t, tr);
+        if (!processOne(t)) {
+          break;
         }
       }
     } else {
@@ -666,13 +909,17 @@ void Node::ProcessTransactionWhenShardBackup(
     }
   }
 
+  // Whatever is still queued was due before the loop ended
+  flushBatch();
+  m_txnSpeculation.Reset(m_mediator.m_currentEpochNum);
+
   AccountStore::GetInstance().ProcessStorageRootUpdateBufferTemp();
 
-  cv_TxnProcFinished.notify_all();
+  FinishTxnProcRound();
 
   PutTxnsInTempDataBase(t_processedTransactions);
 
-  ReinstateMemPool(t_addrNonceTxnMap, gasLimitExceededTxnBuffer);
+  ReinstateMemPool(t_pendingTxns.GetTxns(), gasLimitExceededTxnBuffer);
 }
 
 void Node::PutTxnsInTempDataBase(
@@ -735,62 +982,53 @@ std::string Node::GetAwsS3CpString(const std::string& uploadFilePath) {
 void Node::ReinstateMemPool(
     const map<Address, map<uint64_t, Transaction>>& addrNonceTxnMap,
     const vector<Transaction>& gasLimitExceededTxnBuffer) {
-  unique_lock<shared_timed_mutex> g(m_unconfirmedTxnsMutex);
+  vector<pair<TxnHash, PoolTxnStatus>> unconfirmed;
 
   // Put remaining txns back in pool
   for (const auto& kv : addrNonceTxnMap) {
     for (const auto& nonceTxn : kv.second) {
       t_createdTxns.insert(nonceTxn.second);
-      m_unconfirmedTxns.emplace(nonceTxn.second.GetTranID(),
-                                PoolTxnStatus::PRESENT_NONCE_HIGH);
+      unconfirmed.emplace_back(nonceTxn.second.GetTranID(),
+                               PoolTxnStatus::PRESENT_NONCE_HIGH);
     }
   }
 
   for (const auto& t : gasLimitExceededTxnBuffer) {
     t_createdTxns.insert(t);
     LOG_GENERAL(INFO, "PendingAPI " << t.GetTranID());
-    m_unconfirmedTxns.emplace(t.GetTranID(),
-                              PoolTxnStatus::PRESENT_GAS_EXCEEDED);
+    unconfirmed.emplace_back(t.GetTranID(),
+                             PoolTxnStatus::PRESENT_GAS_EXCEEDED);
   }
+
+  m_unconfirmedTxns.InsertBatch(unconfirmed);
 }
 
 void Node::PutProcessedInUnconfirmedTxns() {
-  unique_lock<shared_timed_mutex> g(m_unconfirmedTxnsMutex);
-
-  uint count = 0;
+  vector<pair<TxnHash, PoolTxnStatus>> unconfirmed;
+  unconfirmed.reserve(t_processedTransactions.size());
 
   for (const auto& t : t_processedTransactions) {
-    m_unconfirmedTxns.emplace(
+    unconfirmed.emplace_back(
         t.first, PoolTxnStatus::PRESENT_VALID_CONSENSUS_NOT_REACHED);
-    count++;
   }
-  LOG_GENERAL(INFO, "Count of txns " << count);
+
+  m_unconfirmedTxns.InsertBatch(unconfirmed);
+  LOG_GENERAL(INFO, "Count of txns " << unconfirmed.size());
 }
 
 PoolTxnStatus Node::IsTxnInMemPool(const TxnHash& txhash) const {
-  shared_lock<shared_timed_mutex> g(m_unconfirmedTxnsMutex, defer_lock);
-  // Try to lock for 100 ms
-  if (!g.try_lock_for(chrono::milliseconds(100))) {
-    return PoolTxnStatus::ERROR;
-  }
-  const auto res = m_unconfirmedTxns.find(txhash);
-  if (res == m_unconfirmedTxns.end()) {
+  PoolTxnStatus status;
+  if (!m_unconfirmedTxns.Find(txhash, status)) {
     return PoolTxnStatus::NOT_PRESENT;
   }
-  return res->second;
+  return status;
 }
 
 unordered_map<TxnHash, PoolTxnStatus> Node::GetUnconfirmedTxns() const {
-  shared_lock<shared_timed_mutex> g(m_unconfirmedTxnsMutex);
-
-  return m_unconfirmedTxns;
+  return m_unconfirmedTxns.Snapshot();
 }
 
-bool Node::IsUnconfirmedTxnEmpty() const {
-  shared_lock<shared_timed_mutex> g(m_unconfirmedTxnsMutex);
-
-  return m_unconfirmedTxns.empty();
-}
+bool Node::IsUnconfirmedTxnEmpty() const { return m_unconfirmedTxns.Empty(); }
 
 void Node::UpdateBalanceForPreGeneratedAccounts() {
   LOG_MARKER();
@@ -1016,6 +1254,11 @@ bool Node::RunConsensusOnMicroBlock() {
 
   SetState(MICROBLOCK_CONSENSUS);
 
+  // Ended when the consensus is done, and left to the next epoch if it fails
+  if (ENABLE_EPOCH_PERF) {
+    EpochPerf::GetInstance().Begin(EpochPerf::MICROBLOCK_CONSENSUS);
+  }
+
   CommitMicroBlockConsensusBuffer();
 
   return true;
@@ -1129,7 +1372,8 @@ unsigned char Node::CheckLegitimacyOfTxnHashes(bytes& errorMsg) {
     if (missingTxnHashes.size() > 0) {
       if (!Messenger::SetNodeMissingTxnsErrorMsg(
               errorMsg, 0, missingTxnHashes, m_mediator.m_currentEpochNum,
-              m_mediator.m_selfPeer.m_listenPortHost)) {
+              m_mediator.m_selfPeer.m_listenPortHost,
+              m_microblock->GetTranHashes())) {
         LOG_GENERAL(WARNING, "Messenger::SetNodeMissingTxnsErrorMsg failed");
         return false;
       }
@@ -17,8 +17,14 @@
 
 #include <arpa/inet.h>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
 #include <thread>
 #include <tuple>
 
@@ -42,6 +48,7 @@
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
 #include "libNetwork/Blacklist.h"
+#include "libNetwork/BroadcastTree.h"
 #include "libNetwork/Guard.h"
 #include "libPOW/pow.h"
 #include "libPersistence/Retriever.h"
@@ -49,6 +56,7 @@
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
+#include "libUtils/MemoryStats.h"
 #include "libUtils/SanityChecks.h"
 #include "libUtils/TimeLockedFunction.h"
 #include "libUtils/TimeUtils.h"
@@ -139,15 +147,72 @@ void Node::AddBalanceToGenesisAccount() {
   AccountStore::GetInstance().AddAccount(Address(),
                                          {TOTAL_COINBASE_REWARD, nonce});
   PopulateAccounts();
+  LoadGenesisAccounts();
 
+  // The trie is still empty, so it is built bottom up in one pass
   AccountStore::GetInstance().UpdateStateTrieAll();
 }
 
+void Node::LoadGenesisAccounts() {
+  if (GENESIS_ACCOUNTS_FILE.empty()) {
+    return;
+  }
+
+  LOG_MARKER();
+
+  ifstream file(GENESIS_ACCOUNTS_FILE);
+  if (!file) {
+    LOG_GENERAL(WARNING, "Failed to open " << GENESIS_ACCOUNTS_FILE);
+    return;
+  }
+
+  string line;
+  unsigned int lineNum = 0;
+  unsigned int loaded = 0;
+  while (getline(file, line)) {
+    lineNum++;
+    istringstream fields(line);
+    string addrStr;
+    string balanceStr;
+    uint64_t nonce = 0;
+    if (!(fields >> addrStr >> balanceStr)) {
+      continue;
+    }
+    fields >> nonce;
+
+    bytes addrBytes;
+    if (!DataConversion::HexStrToUint8Vec(addrStr, addrBytes) ||
+        addrBytes.size() != ACC_ADDR_SIZE) {
+      LOG_GENERAL(WARNING, "Bad address on line " << lineNum << " of "
+                                                  << GENESIS_ACCOUNTS_FILE);
+      continue;
+    }
+
+    try {
+      if (AccountStore::GetInstance().AddAccount(
+              Address(addrBytes), {uint128_t(balanceStr), nonce})) {
+        loaded++;
+      }
+    } catch (const std::exception&) {
+      LOG_GENERAL(WARNING, "Bad balance on line " << lineNum << " of "
+                                                  << GENESIS_ACCOUNTS_FILE);
+    }
+  }
+
+  LOG_GENERAL(INFO, "Loaded " << loaded << " genesis accounts from "
+                              << GENESIS_ACCOUNTS_FILE);
+}
+
 Node::Node(Mediator& mediator, [[gnu::unused]] unsigned int syncType,
            [[gnu::unused]] bool toRetrieveHistory)
-    : m_mediator(mediator) {}
+    : m_mediator(mediator) {
+  MemoryStats::GetInstance().Register("TxnPool", [this]() {
+    lock_guard<mutex> g(m_mutexCreatedTransactions);
+    return m_createdTxns.GetSizeInBytes();
+  });
+}
 
-Node::~Node() {}
+Node::~Node() { MemoryStats::GetInstance().Unregister("TxnPool"); }
 
 bool Node::DownloadPersistenceFromS3() {
   LOG_MARKER();
@@ -191,6 +256,7 @@ bool Node::Install(const SyncType syncType, const bool toRetrieveHistory,
 
     if (SyncType::NEW_SYNC == syncType ||
         SyncType::NEW_LOOKUP_SYNC == syncType ||
+        SyncType::LIGHT_SYNC == syncType ||
         (rejoiningAfterRecover && (SyncType::NORMAL_SYNC == syncType))) {
       return true;
     }
@@ -200,6 +266,10 @@ bool Node::Install(const SyncType syncType, const bool toRetrieveHistory,
     /// When non-rejoin mode, call wake-up or recovery
     if (SyncType::NO_SYNC == m_mediator.m_lookup->GetSyncType() ||
         SyncType::RECOVERY_ALL_SYNC == syncType) {
+      if (ENABLE_PENDING_TXN_PERSISTENCE) {
+        ReloadPendingTxns();
+      }
+
       if (RECOVERY_TRIM_INCOMPLETED_BLOCK) {
         WakeupAtDSEpoch();
       } else {
@@ -274,7 +344,8 @@ void Node::AddGenesisInfo(SyncType syncType) {
   }
 }
 
-bool Node::CheckIntegrity(bool fromIsolatedBinary) {
+bool Node::CheckIntegrity(bool fromIsolatedBinary, uint64_t fromBlockNum,
+                          uint64_t toBlockNum, const string& checkpointFile) {
   // Retrieve the latest Tx block from storage
   TxBlockSharedPtr latestTxBlock;
   if (!BlockStorage::GetBlockStorage().GetLatestTxBlock(latestTxBlock)) {
@@ -408,122 +479,179 @@ bool Node::CheckIntegrity(bool fromIsolatedBinary) {
     return false;
   }
 
-  // Check the other Tx blocks
-  shared_ptr<bool> result = make_shared<bool>(new bool(true));
-
-  // This lambda performs all the checks on one Tx block
-  auto validateOneTxBlock =
-      [&, result, fromIsolatedBinary](uint64_t blockNum) mutable -> void {
-    // Abort checking if overall result is false already
-    if (!*result && !fromIsolatedBinary) {
-      return;
+  // Check the other Tx blocks, resuming after the checkpoint unless a range
+  // is given
+  const uint64_t lastBlockNum = min(toBlockNum, latestTxBlockNum);
+  uint64_t firstBlockNum = fromBlockNum;
+  if (!checkpointFile.empty() && fromBlockNum == 0) {
+    ifstream checkpoint(checkpointFile);
+    if (checkpoint >> firstBlockNum) {
+      LOG_GENERAL(INFO, "Resuming validation at Tx block " << firstBlockNum);
+    } else {
+      firstBlockNum = 0;
     }
-    if (fromIsolatedBinary && (blockNum % 1000 == 0)) {
-      cout << "[" << getTime() << "] On Tx block " << blockNum << endl;
+  }
+  if (fromIsolatedBinary) {
+    cout << "[" << getTime() << "] Checking Tx blocks " << firstBlockNum
+         << " to " << lastBlockNum << endl;
+  }
+
+  atomic<bool> result{true};
+
+  // This lambda performs all the checks on the Tx blocks lowBlockNum to
+  // hiBlockNum, which are read in one pass over the db with the block before
+  // them
+  auto validateTxBlocks = [&, fromIsolatedBinary](uint64_t lowBlockNum,
+                                                  uint64_t hiBlockNum) -> bool {
+    const uint64_t readBlockNum = lowBlockNum > 0 ? lowBlockNum - 1 : 0;
+    vector<TxBlockSharedPtr> txBlocks;
+    if (!BlockStorage::GetBlockStorage().GetRangeTxBlocks(
+            readBlockNum, hiBlockNum, txBlocks)) {
+      txBlocks.clear();
     }
 
-    // Fetch the block
-    TxBlockSharedPtr txBlock;
-    if (!BlockStorage::GetBlockStorage().GetTxBlock(blockNum, txBlock)) {
-      LOG_GENERAL(WARNING, "Missing FB: " << blockNum);
-      *result = false;
-      return;
+    bool chunkResult = true;
+    if (txBlocks.size() < hiBlockNum - readBlockNum + 1) {
+      LOG_GENERAL(WARNING, "Missing FB: " << readBlockNum + txBlocks.size());
+      chunkResult = false;
     }
 
-    // Check that prevHash field == hash of previous Tx block
-    if (blockNum > 0) {
-      TxBlockSharedPtr txBlockPrev;
-      if (!BlockStorage::GetBlockStorage().GetTxBlock(blockNum - 1,
-                                                      txBlockPrev)) {
-        LOG_GENERAL(WARNING, "Missing FB: " << blockNum - 1);
-        *result = false;
-        return;
-      }
-      const BlockHash& prevHash = txBlock->GetHeader().GetPrevHash();
-      const BlockHash& prevBlockHash = txBlockPrev->GetHeader().GetMyHash();
-      if (prevHash != prevBlockHash) {
-        LOG_CHECK_FAIL("Prev hash", prevHash, prevBlockHash);
-        *result = false;
-        return;
+    for (size_t i = 0; i < txBlocks.size(); i++) {
+      // Abort checking if overall result is false already
+      if (!result && !fromIsolatedBinary) {
+        return false;
       }
-    }
 
-    // Check the microblocks
-    const auto& microblockInfos = txBlock->GetMicroBlockInfos();
-    for (const auto& mbInfo : microblockInfos) {
-      MicroBlockSharedPtr mbptr;
-      LOG_GENERAL(INFO, "FB: " << txBlock->GetHeader().GetBlockNum()
-                               << " MB: " << mbInfo.m_shardId);
-      // Skip because empty microblocks are not stored
-      if (mbInfo.m_txnRootHash == TxnHash()) {
+      const uint64_t blockNum = readBlockNum + i;
+      if (blockNum < lowBlockNum) {
         continue;
       }
-      if (BlockStorage::GetBlockStorage().GetMicroBlock(mbInfo.m_microBlockHash,
-                                                        mbptr)) {
-        // Check the transactions
-        if (LOOKUP_NODE_MODE) {
-          const auto& tranHashes = mbptr->GetTranHashes();
-          for (const auto& tranHash : tranHashes) {
-            TxBodySharedPtr tx;
-            if (!BlockStorage::GetBlockStorage().CheckTxBody(tranHash)) {
-              LOG_GENERAL(WARNING, "FB: " << txBlock->GetHeader().GetBlockNum()
-                                          << " MB: " << mbInfo.m_shardId
-                                          << " Missing Tx: " << tranHash);
-              *result = false;
-              if (!fromIsolatedBinary) {
-                break;
+      if (fromIsolatedBinary && (blockNum % 1000 == 0)) {
+        cout << "[" << getTime() << "] On Tx block " << blockNum << endl;
+      }
+      const auto& txBlock = txBlocks[i];
+
+      // Check that prevHash field == hash of previous Tx block
+      if (blockNum > 0) {
+        const BlockHash& prevHash = txBlock->GetHeader().GetPrevHash();
+        const BlockHash& prevBlockHash =
+            txBlocks[i - 1]->GetHeader().GetMyHash();
+        if (prevHash != prevBlockHash) {
+          LOG_CHECK_FAIL("Prev hash", prevHash, prevBlockHash);
+          chunkResult = false;
+          if (!fromIsolatedBinary) {
+            return false;
+          }
+        }
+      }
+
+      // Check the microblocks
+      const auto& microblockInfos = txBlock->GetMicroBlockInfos();
+      for (const auto& mbInfo : microblockInfos) {
+        MicroBlockSharedPtr mbptr;
+        LOG_GENERAL(INFO, "FB: " << blockNum << " MB: " << mbInfo.m_shardId);
+        // Skip because empty microblocks are not stored
+        if (mbInfo.m_txnRootHash == TxnHash()) {
+          continue;
+        }
+        if (BlockStorage::GetBlockStorage().GetMicroBlock(
+                mbInfo.m_microBlockHash, mbptr)) {
+          // Check the transactions
+          if (LOOKUP_NODE_MODE) {
+            const auto& tranHashes = mbptr->GetTranHashes();
+            for (const auto& tranHash : tranHashes) {
+              if (!BlockStorage::GetBlockStorage().CheckTxBody(tranHash)) {
+                LOG_GENERAL(WARNING, "FB: " << blockNum
+                                            << " MB: " << mbInfo.m_shardId
+                                            << " Missing Tx: " << tranHash);
+                chunkResult = false;
+                if (!fromIsolatedBinary) {
+                  return false;
+                }
               }
             }
           }
-        }
-      } else {
-        LOG_GENERAL(WARNING,
-                    "FB: " << txBlock->GetHeader().GetBlockNum()
-                           << " Missing MB: " << mbInfo.m_microBlockHash);
-        *result = false;
-        if (!fromIsolatedBinary) {
-          break;
+        } else {
+          LOG_GENERAL(WARNING, "FB: " << blockNum << " Missing MB: "
+                                      << mbInfo.m_microBlockHash);
+          chunkResult = false;
+          if (!fromIsolatedBinary) {
+            return false;
+          }
         }
       }
     }
+    return chunkResult;
   };
 
-  const unsigned int NUMTHREADS = 10;
-  const int MAXJOBSLEFT = NUMTHREADS * 3;
-  ThreadPool validatePool(NUMTHREADS, "ValidatePool");
-
-  uint64_t blockNum = 0;
+  // Blocks below nextCheckpoint all passed; the chunks that passed above it
+  // wait in passedChunks for the ones before them
+  mutex mutexCheckpoint;
+  uint64_t nextCheckpoint = firstBlockNum;
+  map<uint64_t, uint64_t> passedChunks;
+  auto onChunkPassed = [&](uint64_t lowBlockNum, uint64_t hiBlockNum) {
+    if (checkpointFile.empty()) {
+      return;
+    }
+    lock_guard<mutex> g(mutexCheckpoint);
+    passedChunks.emplace(lowBlockNum, hiBlockNum);
+    const uint64_t prevCheckpoint = nextCheckpoint;
+    while (!passedChunks.empty() &&
+           passedChunks.begin()->first == nextCheckpoint) {
+      nextCheckpoint = passedChunks.begin()->second + 1;
+      passedChunks.erase(passedChunks.begin());
+    }
+    if (nextCheckpoint == prevCheckpoint) {
+      return;
+    }
+    const string tmpFile = checkpointFile + ".tmp";
+    {
+      ofstream checkpoint(tmpFile, ios::trunc);
+      checkpoint << nextCheckpoint << endl;
+    }
+    if (rename(tmpFile.c_str(), checkpointFile.c_str()) != 0) {
+      LOG_GENERAL(WARNING, "Failed to write checkpoint " << checkpointFile);
+    }
+  };
 
-  while (blockNum <= latestTxBlockNum) {
-    validatePool.AddJob([validateOneTxBlock, blockNum]() mutable -> void {
-      validateOneTxBlock(blockNum);
-    });
+  const uint64_t BLOCKSPERJOB = 1000;
+  const unsigned int numThreads = max(1U, thread::hardware_concurrency());
+  const int MAXJOBSLEFT = numThreads * 2;
+  ThreadPool validatePool(numThreads, "ValidatePool");
 
-    if (!*result && !fromIsolatedBinary) {
+  for (uint64_t lowBlockNum = firstBlockNum; lowBlockNum <= lastBlockNum;
+       lowBlockNum += BLOCKSPERJOB) {
+    if (!result && !fromIsolatedBinary) {
       break;
     }
 
-    while (validatePool.GetJobsLeft() > MAXJOBSLEFT) {
-    }
+    const uint64_t hiBlockNum =
+        min(lastBlockNum, lowBlockNum + BLOCKSPERJOB - 1);
+    validatePool.AddJob([&, lowBlockNum, hiBlockNum]() {
+      if (validateTxBlocks(lowBlockNum, hiBlockNum)) {
+        onChunkPassed(lowBlockNum, hiBlockNum);
+      } else {
+        result = false;
+      }
+    });
 
-    blockNum++;
-  }
+    validatePool.WaitForJobsLeft(MAXJOBSLEFT);
 
-  while (validatePool.GetJobsLeft() > 0) {
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+    if (hiBlockNum == lastBlockNum) {
+      break;
+    }
   }
 
+  validatePool.WaitForJobsLeft(0);
+
   if (fromIsolatedBinary) {
     cout << "[" << getTime() << "] Done" << endl;
   }
 
-  return *result;
+  return result;
 }
 
-void Node::ClearUnconfirmedTxn() {
-  unique_lock<shared_timed_mutex> g(m_unconfirmedTxnsMutex);
-  m_unconfirmedTxns.clear();
-}
+void Node::ClearUnconfirmedTxn() { m_unconfirmedTxns.Clear(); }
 
 bool Node::ValidateDB() {
   const string lookupIp = "127.0.0.1";
@@ -594,6 +722,19 @@ bool Node::StartRetrieveHistory(const SyncType syncType,
 
   m_mediator.m_DSCommittee->clear();
 
+  if (SyncType::LIGHT_SYNC == syncType) {
+    // Only the blocks are kept, there is no committee, shard or state to load
+    m_retriever = std::make_shared<Retriever>(m_mediator);
+    if (!m_retriever->RecoverEpochCommit() ||
+        !m_retriever->RetrieveBlockLink(false) ||
+        !m_retriever->RetrieveTxBlockHeaders()) {
+      return false;
+    }
+    LOG_GENERAL(INFO, "RetrieveHistory Success");
+    m_mediator.m_isRetrievedHistory = true;
+    return true;
+  }
+
   uint16_t ds_consensusLeaderID = 0;
 
   if (!BlockStorage::GetBlockStorage().GetDSCommittee(m_mediator.m_DSCommittee,
@@ -658,6 +799,10 @@ bool Node::StartRetrieveHistory(const SyncType syncType,
 
   m_retriever = std::make_shared<Retriever>(m_mediator);
 
+  if (!m_retriever->RecoverEpochCommit()) {
+    return false;
+  }
+
   /// Retrieve block link
   bool ds_result =
       m_retriever->RetrieveBlockLink(RECOVERY_TRIM_INCOMPLETED_BLOCK &&
@@ -902,6 +1047,7 @@ bool Node::StartRetrieveHistory(const SyncType syncType,
     std::map<uint64_t, std::map<int32_t, std::vector<PubKey>>>
         coinbaseRewardeesTmp;
     m_mediator.m_ds->GetCoinbaseRewardees(coinbaseRewardeesTmp);
+    vector<uint64_t> cosigsRewardsBlockNums;
     for (auto blockNum =
              m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetEpochNum();
          blockNum <=
@@ -913,10 +1059,13 @@ bool Node::StartRetrieveHistory(const SyncType syncType,
                                        .GetMicroBlockInfos()
                                        .size() -
                                    1)) {
-        m_mediator.m_lookup->ComposeAndSendGetCosigsRewardsFromSeed(blockNum);
-        this_thread::sleep_for(chrono::milliseconds(100));
+        cosigsRewardsBlockNums.emplace_back(blockNum);
       }
     }
+    if (!cosigsRewardsBlockNums.empty()) {
+      m_mediator.m_lookup->ComposeAndSendGetCosigsRewardsFromSeed(
+          cosigsRewardsBlockNums);
+    }
   }
 
   bool res = false;
@@ -1432,8 +1581,20 @@ bool Node::ProcessSubmitMissingTxn(const bytes& message, unsigned int offset,
 }
 
 bool Node::ProcessSubmitTransaction(const bytes& message, unsigned int offset,
-                                    [[gnu::unused]] const Peer& from) {
+                                    const Peer& from) {
+  if (offset >= message.size()) {
+    LOG_GENERAL(WARNING, "Invalid submit txn message, message size: "
+                             << message.size() << ", offset: " << offset);
+    return false;
+  }
+
   if (LOOKUP_NODE_MODE) {
+    // Only the txns asked for a compact microblock relay are expected
+    if (message[offset] == SUBMITTRANSACTIONTYPE::MISSINGTXN &&
+        COMPACT_MBNFORWARD_RELAY) {
+      return ProcessCompactMBnForwardMissingTxns(
+          message, offset + MessageOffset::INST);
+    }
     LOG_GENERAL(WARNING,
                 "Node::ProcessSubmitTransaction not expected to be called "
                 "from LookUp node.");
@@ -1449,6 +1610,11 @@ bool Node::ProcessSubmitTransaction(const bytes& message, unsigned int offset,
   unsigned char submitTxnType = message[cur_offset];
   cur_offset += MessageOffset::INST;
 
+  if (submitTxnType == SUBMITTRANSACTIONTYPE::MISSINGTXNREQUEST) {
+    // A lookup missing the txns of the microblock forwarded to it
+    return OnNodeMissingTxns(message, cur_offset, from);
+  }
+
   if (submitTxnType == SUBMITTRANSACTIONTYPE::MISSINGTXN) {
     if (m_mediator.m_ds->m_mode == DirectoryService::IDLE) {
       if (m_state != MICROBLOCK_CONSENSUS) {
@@ -1493,15 +1659,26 @@ bool Node::ProcessTxnPacketFromLookup([[gnu::unused]] const bytes& message,
     return false;
   }
 
+  // The same packet may come from another lookup or from a shard peer
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  sha2.Update(message, offset, message.size() - offset);
+  const bytes packetHash = sha2.Finalize();
+  if (m_txnPacketHashes.Contains(packetHash)) {
+    LOG_GENERAL(INFO, "Txn packet from " << from << " already received");
+    return true;
+  }
+
   uint64_t epochNumber = 0, dsBlockNum = 0;
   uint32_t shardId = 0;
   PubKey lookupPubKey;
   vector<Transaction> transactions;
   Signature signature;
+  Signature attestation;
+  bool attested = false;
 
-  if (!Messenger::GetNodeForwardTxnBlock(message, offset, epochNumber,
-                                         dsBlockNum, shardId, lookupPubKey,
-                                         transactions, signature)) {
+  if (!Messenger::GetNodeForwardTxnBlock(
+          message, offset, epochNumber, dsBlockNum, shardId, lookupPubKey,
+          transactions, signature, attestation, attested)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::GetNodeForwardTxnBlock failed.");
     return false;
@@ -1521,7 +1698,7 @@ bool Node::ProcessTxnPacketFromLookup([[gnu::unused]] const bytes& message,
   bytes message2 = {MessageType::NODE, NodeInstructionType::FORWARDTXNPACKET};
   if (!Messenger::SetNodeForwardTxnBlock(
           message2, MessageOffset::BODY, epochNumber, dsBlockNum, shardId,
-          lookupPubKey, transactions, signature)) {
+          lookupPubKey, transactions, signature, attestation, attested)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::GetNodeForwardTxnBlock failed.");
     return false;
@@ -1593,7 +1770,8 @@ bool Node::ProcessTxnPacketFromLookup([[gnu::unused]] const bytes& message,
                 "Packet received from a non-lookup node, "
                 "should be from gossip neighbor and process it");
     return ProcessTxnPacketFromLookupCore(message2, epochNumber, dsBlockNum,
-                                          shardId, lookupPubKey, transactions);
+                                          shardId, lookupPubKey, transactions,
+                                          attested);
   }
 
   return true;
@@ -1604,7 +1782,8 @@ bool Node::ProcessTxnPacketFromLookupCore(const bytes& message,
                                           const uint64_t& dsBlockNum,
                                           const uint32_t& shardId,
                                           const PubKey& lookupPubKey,
-                                          const vector<Transaction>& txns) {
+                                          const vector<Transaction>& txns,
+                                          const bool attested) {
   LOG_MARKER();
 
   if (LOOKUP_NODE_MODE) {
@@ -1734,13 +1913,52 @@ bool Node::ProcessTxnPacketFromLookupCore(const bytes& message,
 
   LOG_GENERAL(INFO, "Start check txn packet from lookup");
 
-  std::vector<Transaction> checkedTxns;
-  for (const auto& txn : txns) {
-    if (m_mediator.GetIsVacuousEpoch()) {
-      LOG_GENERAL(WARNING, "Already in vacuous epoch, stop proc txn");
-      return false;
+  if (m_mediator.GetIsVacuousEpoch()) {
+    LOG_GENERAL(WARNING, "Already in vacuous epoch, stop proc txn");
+    return false;
+  }
+
+  // Txns still in the pool from another packet are not verified again
+  std::vector<Transaction> unseenTxns;
+  bool anySeen = false;
+  {
+    lock_guard<mutex> g(m_mutexCreatedTransactions);
+    for (unsigned int i = 0; i < txns.size(); i++) {
+      const bool seen = m_createdTxns.exist(txns.at(i).GetTranID());
+      if (seen && !anySeen) {
+        anySeen = true;
+        unseenTxns.assign(txns.begin(), txns.begin() + i);
+      } else if (!seen && anySeen) {
+        unseenTxns.emplace_back(txns.at(i));
+      }
     }
-    if (m_mediator.m_validator->CheckCreatedTransactionFromLookup(txn)) {
+  }
+  const auto& toCheck = anySeen ? unseenTxns : txns;
+  if (toCheck.size() < txns.size()) {
+    LOG_GENERAL(INFO, txns.size() - toCheck.size()
+                          << " txns from packet already received");
+  }
+
+  // The lookup verified the signatures of the txns it attested, and the
+  // packet keeps its attestation when gossiped
+  const bool trustAttestation = LOOKUP_TXN_PACKET_ATTESTATION && attested;
+  if (trustAttestation) {
+    LOG_GENERAL(INFO, "Txn packet attested by lookup, skip txn signatures");
+  }
+
+  std::vector<char> results;
+  m_mediator.m_validator->CheckCreatedTransactionsFromLookup(toCheck, results,
+                                                             trustAttestation);
+
+  if (m_mediator.GetIsVacuousEpoch()) {
+    LOG_GENERAL(WARNING, "Already in vacuous epoch, stop proc txn");
+    return false;
+  }
+
+  std::vector<Transaction> checkedTxns;
+  for (unsigned int i = 0; i < toCheck.size(); i++) {
+    const auto& txn = toCheck.at(i);
+    if (results.at(i)) {
       checkedTxns.push_back(txn);
     } else {
       LOG_GENERAL(WARNING, "Txn " << txn.GetTranID().hex() << " is not valid.");
@@ -1763,11 +1981,28 @@ bool Node::ProcessTxnPacketFromLookupCore(const bytes& message,
       m_createdTxns.insert(txn);
     }
 
+    // Written under the lock, so that a compaction never misses them
+    if (ENABLE_PENDING_TXN_PERSISTENCE && !checkedTxns.empty() &&
+        !BlockStorage::GetBlockStorage().PutPendingTxns(checkedTxns,
+                                                        m_myshardId)) {
+      LOG_GENERAL(WARNING, "BlockStorage::PutPendingTxns failed");
+    }
+
     LOG_GENERAL(INFO, "Txn processed: " << processed_count
                                         << " TxnPool size after processing: "
                                         << m_createdTxns.size());
+    LOG_GENERAL(INFO, "TxnPool bytes: " << m_createdTxns.GetSizeInBytes()
+                                        << " evicted txns: "
+                                        << m_createdTxns.GetEvictedCount());
   }
 
+  // Recorded only once the packet is taken in, so that one dropped on the
+  // way can still come again. Peers gossip it as serialized here.
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  sha2.Update(message, MessageOffset::BODY,
+              message.size() - MessageOffset::BODY);
+  m_txnPacketHashes.Insert(sha2.Finalize());
+
   LOG_STATE("[TXNPKTPROC][" << std::setw(15) << std::left
                             << m_mediator.m_selfPeer.GetPrintableIPAddress()
                             << "][" << m_mediator.m_currentEpochNum << "]["
@@ -1833,17 +2068,19 @@ void Node::CommitTxnPacketBuffer() {
     PubKey lookupPubKey;
     vector<Transaction> transactions;
     Signature signature;
+    Signature attestation;
+    bool attested = false;
 
     if (!Messenger::GetNodeForwardTxnBlock(
             message, MessageOffset::BODY, epochNumber, dsBlockNum, shardId,
-            lookupPubKey, transactions, signature)) {
+            lookupPubKey, transactions, signature, attestation, attested)) {
       LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
                 "Messenger::GetNodeForwardTxnBlock failed.");
       return;
     }
 
     ProcessTxnPacketFromLookupCore(message, epochNumber, dsBlockNum, shardId,
-                                   lookupPubKey, transactions);
+                                   lookupPubKey, transactions, attested);
   }
   m_txnPacketBuffer.clear();
 }
@@ -1897,6 +2134,10 @@ uint16_t Node::GetConsensusLeaderID() const {
 
 void Node::AddBlock(const TxBlock& block) {
   m_mediator.m_txBlockChain.AddBlock(block);
+
+  if (LOOKUP_NODE_MODE && (m_mediator.m_lookup != nullptr)) {
+    m_mediator.m_lookup->RefreshLookupServerCache();
+  }
 }
 
 void Node::RejoinAsNormal() {
@@ -2028,6 +2269,62 @@ void Node::SetMyshardId(uint32_t shardId) {
   m_myshardId = shardId;
 }
 
+void Node::ReloadPendingTxns() {
+  LOG_MARKER();
+
+  vector<pair<uint32_t, Transaction>> pending;
+  if (!BlockStorage::GetBlockStorage().GetAllPendingTxns(pending)) {
+    LOG_GENERAL(WARNING, "BlockStorage::GetAllPendingTxns failed");
+  }
+
+  vector<Transaction> txns;
+  txns.reserve(pending.size());
+  for (const auto& entry : pending) {
+    txns.emplace_back(entry.second);
+  }
+  vector<char> results;
+  m_mediator.m_validator->CheckPendingTransactions(txns, results);
+
+  unsigned int reloaded = 0;
+  if (LOOKUP_NODE_MODE) {
+    for (unsigned int i = 0; i < pending.size(); i++) {
+      if (results.at(i) && m_mediator.m_lookup->AddToTxnShardMap(
+                                  txns.at(i), pending.at(i).first)) {
+        reloaded++;
+      }
+    }
+    m_mediator.m_lookup->CompactTxnShardMap();
+  } else {
+    {
+      lock_guard<mutex> g(m_mutexCreatedTransactions);
+      for (unsigned int i = 0; i < txns.size(); i++) {
+        if (results.at(i) && m_createdTxns.insert(txns.at(i))) {
+          reloaded++;
+        }
+      }
+    }
+    CompactPendingTxns();
+  }
+
+  LOG_GENERAL(INFO, "Reloaded " << reloaded << " of " << pending.size()
+                                << " pending txns");
+}
+
+void Node::CompactPendingTxns() {
+  vector<pair<uint32_t, Transaction>> txns;
+  {
+    lock_guard<mutex> g(m_mutexCreatedTransactions);
+    txns.reserve(m_createdTxns.size());
+    for (const auto& entry : m_createdTxns.HashIndex()) {
+      txns.emplace_back(m_myshardId, entry);
+    }
+    // Rewritten under the lock, so that the txns added meanwhile are kept
+    if (!BlockStorage::GetBlockStorage().RewritePendingTxns(txns)) {
+      LOG_GENERAL(WARNING, "BlockStorage::RewritePendingTxns failed");
+    }
+  }
+}
+
 void Node::CleanCreatedTransaction() {
   LOG_MARKER();
   {
@@ -2044,10 +2341,7 @@ void Node::CleanCreatedTransaction() {
     m_processedTransactions.clear();
     t_processedTransactions.clear();
   }
-  {
-    std::unique_lock<shared_timed_mutex> lock(m_unconfirmedTxnsMutex);
-    m_unconfirmedTxns.clear();
-  }
+  m_unconfirmedTxns.Clear();
   m_TxnOrder.clear();
   m_gasUsedTotal = 0;
   m_txnFees = 0;
@@ -2394,6 +2688,7 @@ bool Node::ToBlockMessage([[gnu::unused]] unsigned char ins_byte) {
       }
     } else if (LOOKUP_NODE_MODE &&
                (ins_byte == NodeInstructionType::FINALBLOCK ||
+                ins_byte == NodeInstructionType::SUBMITTRANSACTION ||
                 ins_byte ==
                     NodeInstructionType::MBNFORWARDTRANSACTION))  // Is seed
                                                                   // or lookup
@@ -2410,7 +2705,7 @@ bool Node::ToBlockMessage([[gnu::unused]] unsigned char ins_byte) {
 
 void Node::GetNodesToBroadCastUsingTreeBasedClustering(
     uint32_t cluster_size, uint32_t num_of_child_clusters, uint32_t& nodes_lo,
-    uint32_t& nodes_hi) {
+    uint32_t& nodes_hi, vector<uint32_t>& treeOrder) {
   // make sure cluster_size is with-in the valid range
   cluster_size = std::max(cluster_size, MIN_CLUSTER_SIZE);
   cluster_size = std::min(cluster_size, (uint32_t)m_myShardMembers->size());
@@ -2424,7 +2719,23 @@ void Node::GetNodesToBroadCastUsingTreeBasedClustering(
   num_of_child_clusters =
       std::min(num_of_child_clusters, num_of_total_clusters - 1);
 
-  uint32_t my_cluster_num = m_consensusMyID / cluster_size;
+  // Every member computes the same order from the IPs of the shard; my own
+  // entry has no IP
+  vector<uint32_t> regions;
+  regions.reserve(m_myShardMembers->size());
+  for (uint32_t i = 0; i < m_myShardMembers->size(); i++) {
+    const Peer& peer = i == m_consensusMyID ? m_mediator.m_selfPeer
+                                            : m_myShardMembers->at(i).second;
+    regions.push_back(
+        BroadcastTree::GetRegion(peer, BROADCAST_REGION_PREFIX_BITS));
+  }
+  treeOrder = BroadcastTree::GetTreeOrder(regions, cluster_size,
+                                          num_of_child_clusters);
+  const uint32_t my_position =
+      find(treeOrder.begin(), treeOrder.end(), m_consensusMyID) -
+      treeOrder.begin();
+
+  uint32_t my_cluster_num = my_position / cluster_size;
 
   LOG_GENERAL(INFO, "cluster_size :"
                         << cluster_size
@@ -2453,8 +2764,9 @@ void Node::SendBlockToOtherShardNodes(const bytes& message,
 
   lock_guard<mutex> g(m_mutexShardMember);
 
+  vector<uint32_t> treeOrder;
   GetNodesToBroadCastUsingTreeBasedClustering(
-      cluster_size, num_of_child_clusters, nodes_lo, nodes_hi);
+      cluster_size, num_of_child_clusters, nodes_lo, nodes_hi, treeOrder);
 
   string hashStr;
   if (!DataConversion::Uint8VecToHexStr(this_msg_hash, hashStr)) {
@@ -2478,9 +2790,9 @@ void Node::SendBlockToOtherShardNodes(const bytes& message,
                                      << ")");
 
   for (uint32_t i = nodes_lo; i <= nodes_hi; i++) {
-    const auto& kv = m_myShardMembers->at(i);
+    const auto& kv = m_myShardMembers->at(treeOrder[i]);
     shardBlockReceivers.emplace_back(std::get<SHARD_NODE_PEER>(kv));
-    LOG_GENERAL(INFO, "[" << PAD(i, 3, ' ') << "] "
+    LOG_GENERAL(INFO, "[" << PAD(treeOrder[i], 3, ' ') << "] "
                           << std::get<SHARD_NODE_PUBKEY>(kv) << " "
                           << std::get<SHARD_NODE_PEER>(kv));
   }
@@ -2544,6 +2856,15 @@ bool Node::Execute(const bytes& message, unsigned int offset,
     if (!result) {
       // To-do: Error recovery
     }
+
+    // Seeds subscribed to this lookup get the blocks it has processed
+    if (result && LOOKUP_NODE_MODE && !ARCHIVAL_LOOKUP &&
+        (ins_byte == NodeInstructionType::DSBLOCK ||
+         ins_byte == NodeInstructionType::FINALBLOCK ||
+         ins_byte == NodeInstructionType::MBNFORWARDTRANSACTION ||
+         ins_byte == NodeInstructionType::VCBLOCK)) {
+      m_mediator.m_lookup->RelayToSeedSubscribers(message);
+    }
   } else {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Unknown instruction byte " << hex << (unsigned int)ins_byte
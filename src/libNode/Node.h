@@ -35,11 +35,14 @@
 #include "libData/AccountData/Transaction.h"
 #include "libData/AccountData/TransactionReceipt.h"
 #include "libData/AccountData/TxnPool.h"
+#include "libData/AccountData/TxnSpeculation.h"
 #include "libData/BlockData/Block.h"
 #include "libLookup/Synchronizer.h"
+#include "libNetwork/BroadcastHashFilter.h"
 #include "libNetwork/DataSender.h"
 #include "libNetwork/P2PComm.h"
 #include "libPersistence/BlockStorage.h"
+#include "libUtils/ShardedHashMap.h"
 
 class Mediator;
 class Retriever;
@@ -60,7 +63,10 @@ class Node : public Executable {
     NUM_ACTIONS
   };
 
-  enum SUBMITTRANSACTIONTYPE : unsigned char { MISSINGTXN = 0x01 };
+  enum SUBMITTRANSACTIONTYPE : unsigned char {
+    MISSINGTXN = 0x01,
+    MISSINGTXNREQUEST = 0x02,  // Lookup asking for the txns of a compact relay
+  };
 
   enum REJOINTYPE : unsigned char {
     ATFINALBLOCK = 0x00,
@@ -124,7 +130,9 @@ class Node : public Executable {
 
   // Transactions information
   std::mutex m_mutexCreatedTransactions;
-  TxnPool m_createdTxns, t_createdTxns;
+  TxnPool m_createdTxns{static_cast<uint64_t>(TXN_POOL_MEMORY_LIMIT_IN_MB) *
+                        1024 * 1024};
+  TxnPoolView t_createdTxns;
 
   std::vector<TxnHash> m_expectedTranOrdering;
   std::mutex m_mutexProcessedTransactions;
@@ -138,16 +146,32 @@ class Node : public Executable {
   uint64_t m_gasUsedTotal = 0;
   uint128_t m_txnFees = 0;
 
+  // Payments of the next microblock executed while waiting for the final
+  // block, with SPECULATIVE_TXN_PROCESSING
+  std::mutex m_mutexTxnSpeculation;
+  TxnSpeculation m_txnSpeculation;
+  std::atomic<uint64_t> m_txnSpeculationRound{0};
+  std::atomic<bool> m_stopTxnSpeculation{false};
+
   // std::mutex m_mutexCommittedTransactions;
   // std::unordered_map<uint64_t, std::list<TransactionWithReceipt>>
   //     m_committedTransactions;
-  std::shared_timed_mutex mutable m_unconfirmedTxnsMutex;
-  std::unordered_map<TxnHash, PoolTxnStatus> m_unconfirmedTxns;
+  ShardedHashMap<TxnHash, PoolTxnStatus> m_unconfirmedTxns;
 
   std::mutex m_mutexMBnForwardedTxnBuffer;
   std::unordered_map<uint64_t, std::vector<MBnForwardedTxnEntry>>
       m_mbnForwardedTxnBuffer;
 
+  // Microblocks relayed in compact form, waiting for the txn bodies this
+  // lookup did not have, keyed by microblock hash
+  struct PendingCompactMBnForward {
+    MBnForwardedTxnEntry m_entry;
+    Peer m_from;
+    std::unordered_map<TxnHash, Transaction> m_received;
+  };
+  std::mutex m_mutexPendingCompactMBnForwards;
+  std::map<BlockHash, PendingCompactMBnForward> m_pendingCompactMBnForwards;
+
   std::mutex m_mutexPendingTxnBuffer;
   std::unordered_map<uint64_t,
                      std::vector<std::tuple<HashCodeMap, PubKey, uint32_t>>>
@@ -156,9 +180,15 @@ class Node : public Executable {
   std::mutex m_mutexTxnPacketBuffer;
   std::vector<bytes> m_txnPacketBuffer;
 
+  // Txn packets already taken in, so that the copies from other lookups and
+  // from shard peers are dropped before parsing
+  BroadcastHashFilter m_txnPacketHashes{BROADCAST_INTERVAL, BROADCAST_EXPIRY};
+
   // txn proc timeout related
   std::mutex m_mutexCVTxnProcFinished;
   std::condition_variable cv_TxnProcFinished;
+  // Bumped each time a round of txn processing finishes
+  uint64_t m_txnProcRound{0};
 
   std::mutex m_mutexMicroBlockConsensusBuffer;
   std::unordered_map<uint32_t, VectorOfNodeMsg> m_microBlockConsensusBuffer;
@@ -216,7 +246,7 @@ class Node : public Executable {
                                           bool& isEveryMicroBlockAvailable);
 
   // void StoreMicroBlocks();
-  bool StoreFinalBlock(const TxBlock& txBlock);
+  bool StoreFinalBlock(const TxBlock& txBlock, EpochCommit& epochCommit);
   void InitiatePoW();
   void ScheduleMicroBlockConsensus();
   void BeginNextConsensusRound();
@@ -255,6 +285,19 @@ class Node : public Executable {
   bool ProcessMBnForwardTransaction(const bytes& message,
                                     unsigned int cur_offset, const Peer& from);
   bool ProcessMBnForwardTransactionCore(const MBnForwardedTxnEntry& entry);
+  // Verifies the forwarded txns against the microblock, then commits or
+  // buffers them
+  bool ProcessMBnForwardedTxnEntry(const MBnForwardedTxnEntry& entry,
+                                   const Peer& from);
+
+  // Compact relay: rebuilds the txns of pending from the receipts, the bodies
+  // received and the dispatched txns, else returns the hashes still missing
+  bool RebuildCompactMBnForward(PendingCompactMBnForward& pending,
+                                std::vector<TxnHash>& missing);
+  bool RequestCompactMBnForwardTxns(PendingCompactMBnForward&& pending,
+                                    const std::vector<TxnHash>& missing);
+  bool ProcessCompactMBnForwardMissingTxns(const bytes& message,
+                                           unsigned int offset);
 
   bool ProcessPendingTxn(const bytes& message, unsigned int cur_offset,
                          const Peer& from);
@@ -265,7 +308,8 @@ class Node : public Executable {
                                       const uint64_t& dsBlockNum,
                                       const uint32_t& shardId,
                                       const PubKey& lookupPubKey,
-                                      const std::vector<Transaction>& txns);
+                                      const std::vector<Transaction>& txns,
+                                      const bool attested);
   bool ProcessProposeGasPrice(const bytes& message, unsigned int offset,
                               const Peer& from);
 
@@ -282,7 +326,8 @@ class Node : public Executable {
   bool ProcessRemoveNodeFromBlacklist(const bytes& message, unsigned int offset,
                                       const Peer& from);
 
-  bool ComposeMBnForwardTxnMessageForSender(bytes& mb_txns_message);
+  bool ComposeMBnForwardTxnMessageForSender(const MicroBlock& microblock,
+                                            bytes& mb_txns_message);
 
   bool VerifyDSBlockCoSignature(const DSBlock& dsblock);
   bool VerifyFinalBlockCoSignature(const TxBlock& txblock);
@@ -315,7 +360,9 @@ class Node : public Executable {
   bool CheckMicroBlockStateDeltaHash();
   bool CheckMicroBlockTranReceiptHash();
 
-  void NotifyTimeout(bool& txnProcTimeout);
+  void NotifyTimeout(std::atomic<bool>& txnProcTimeout, uint64_t round);
+  uint64_t GetTxnProcRound();
+  void FinishTxnProcRound();
   bool VerifyTxnsOrdering(const std::vector<TxnHash>& tranHashes,
                           std::vector<TxnHash>& missingtranHashes);
 
@@ -357,9 +404,11 @@ class Node : public Executable {
   void SendFallbackBlockToOtherShardNodes(const bytes& fallbackblock_message);
   void SendBlockToOtherShardNodes(const bytes& message, uint32_t cluster_size,
                                   uint32_t num_of_child_clusters);
+  /// Positions [nodes_lo, nodes_hi] in treeOrder of the shard members to
+  /// forward to, where treeOrder holds the member index at each position
   void GetNodesToBroadCastUsingTreeBasedClustering(
       uint32_t cluster_size, uint32_t num_of_child_clusters, uint32_t& nodes_lo,
-      uint32_t& nodes_hi);
+      uint32_t& nodes_hi, std::vector<uint32_t>& treeOrder);
 
   void GetIpMapping(std::unordered_map<std::string, Peer>& ipMapping);
 
@@ -499,7 +548,13 @@ class Node : public Executable {
   bool StartRetrieveHistory(const SyncType syncType,
                             bool rejoiningAfterRecover = false);
 
-  bool CheckIntegrity(bool fromIsolatedBinary = false);
+  /// Validates the persistence, with the Tx blocks fromBlockNum to
+  /// toBlockNum. With a checkpointFile, the next Tx block to validate is kept
+  /// in it as the blocks pass, and a run without fromBlockNum resumes there.
+  bool CheckIntegrity(bool fromIsolatedBinary = false,
+                      uint64_t fromBlockNum = 0,
+                      uint64_t toBlockNum = UINT64_MAX,
+                      const std::string& checkpointFile = "");
   void PutProcessedInUnconfirmedTxns();
 
   bool SendPendingTxnToLookup();
@@ -518,6 +573,9 @@ class Node : public Executable {
 
   void UpdateDSCommitteeComposition(DequeOfNode& dsComm,
                                     const DSBlock& dsblock);
+  void UpdateDSCommitteeComposition(DequeOfNode& dsComm,
+                                    const DSBlock& dsblock,
+                                    IndexOfNode& dsIndex);
 
   void UpdateDSCommitteeAfterFallback(const uint32_t& shard_id,
                                       const PubKey& leaderPubKey,
@@ -531,6 +589,10 @@ class Node : public Executable {
 
   void AddBalanceToGenesisAccount();
 
+  /// Adds the accounts of GENESIS_ACCOUNTS_FILE, if set, to the account store
+  /// without touching the state trie
+  void LoadGenesisAccounts();
+
   void PopulateAccounts(bool temp = false);
 
   void UpdateBalanceForPreGeneratedAccounts();
@@ -545,6 +607,8 @@ class Node : public Executable {
 
   void CommitPendingTxnBuffer();
 
+  void SpeculateNextMicroBlock();
+  void StopTxnSpeculation();
   void ProcessTransactionWhenShardLeader(const uint64_t& microblock_gas_limit);
   void ProcessTransactionWhenShardBackup(const uint64_t& microblock_gas_limit);
   bool ComposeMicroBlock(const uint64_t& microblock_gas_limit);
@@ -678,6 +742,14 @@ class Node : public Executable {
       const std::unordered_map<TxnHash, TransactionWithReceipt>&
           processedTransactions);
 
+  /// Adds the pending transactions kept before a restart that still pass
+  /// Validator::CheckPendingTransactions to the txn pool, or on a lookup to
+  /// the txn shard map
+  void ReloadPendingTxns();
+
+  /// Rewrites the pending transactions from the txn pool
+  void CompactPendingTxns();
+
   void SaveTxnsToS3(const std::unordered_map<TxnHash, TransactionWithReceipt>&
                         processedTransactions);
 
@@ -39,6 +39,7 @@
 #include "libPOW/pow.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
+#include "libUtils/EpochPerf.h"
 #include "libUtils/Logger.h"
 #include "libUtils/SanityChecks.h"
 #include "libUtils/TimeLockedFunction.h"
@@ -115,16 +116,20 @@ bool Node::StartPoW(const uint64_t& block_num, uint8_t ds_difficulty,
   auto startTime = std::chrono::high_resolution_clock::now();
   int powTimeWindow = POW_WINDOW_IN_SECONDS;
 
-  // Only in guard mode that shard guard can submit different PoW
-  if (GUARD_MODE && Guard::GetInstance().IsNodeInShardGuardList(
-                        m_mediator.m_selfKey.second)) {
-    winning_result = POW::GetInstance().PoWMine(
-        block_num, shardGuardDiff, m_mediator.m_selfKey, headerHash,
-        FULL_DATASET_MINE, std::time(0), powTimeWindow);
-  } else {
-    winning_result = POW::GetInstance().PoWMine(
-        block_num, difficulty, m_mediator.m_selfKey, headerHash,
-        FULL_DATASET_MINE, std::time(0), powTimeWindow);
+  {
+    EpochPerf::Scope perf(EpochPerf::POW);
+
+    // Only in guard mode that shard guard can submit different PoW
+    if (GUARD_MODE && Guard::GetInstance().IsNodeInShardGuardList(
+                          m_mediator.m_selfKey.second)) {
+      winning_result = POW::GetInstance().PoWMine(
+          block_num, shardGuardDiff, m_mediator.m_selfKey, headerHash,
+          FULL_DATASET_MINE, std::time(0), powTimeWindow);
+    } else {
+      winning_result = POW::GetInstance().PoWMine(
+          block_num, difficulty, m_mediator.m_selfKey, headerHash,
+          FULL_DATASET_MINE, std::time(0), powTimeWindow);
+    }
   }
 
   if (winning_result.success) {
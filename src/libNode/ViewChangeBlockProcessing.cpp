@@ -28,6 +28,8 @@
 #include "depends/libDatabase/MemoryDB.h"
 #include "depends/libTrie/TrieDB.h"
 #include "depends/libTrie/TrieHash.h"
+#include "libConsensus/AggregatedPubKeyCache.h"
+#include "libConsensus/VerifiedCosigCache.h"
 #include "libCrypto/Sha2.h"
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
@@ -49,7 +51,7 @@ bool Node::VerifyVCBlockCoSignature(const VCBlock& vcblock) {
   unsigned int index = 0;
   unsigned int count = 0;
 
-  const vector<bool>& B2 = vcblock.GetB2();
+  const Bitmap& B2 = vcblock.GetB2();
   if (m_mediator.m_DSCommittee->size() != B2.size()) {
     LOG_GENERAL(WARNING, "Mismatch: DS committee size = "
                              << m_mediator.m_DSCommittee->size()
@@ -61,8 +63,8 @@ bool Node::VerifyVCBlockCoSignature(const VCBlock& vcblock) {
   vector<PubKey> keys;
 
   for (auto const& kv : *m_mediator.m_DSCommittee) {
+    keys.emplace_back(kv.first);
     if (B2.at(index)) {
-      keys.emplace_back(kv.first);
       count++;
     }
     index++;
@@ -73,7 +75,8 @@ bool Node::VerifyVCBlockCoSignature(const VCBlock& vcblock) {
     return false;
   }
 
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<PubKey> aggregatedKey =
+      AggregatedPubKeyCache::GetInstance().AggregatePubKeys(keys, B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return false;
@@ -87,8 +90,8 @@ bool Node::VerifyVCBlockCoSignature(const VCBlock& vcblock) {
   }
   vcblock.GetCS1().Serialize(message, message.size());
   BitVector::SetBitVector(message, message.size(), vcblock.GetB1());
-  if (!MultiSig::MultiSigVerify(message, 0, message.size(), vcblock.GetCS2(),
-                                *aggregatedKey)) {
+  if (!VerifiedCosigCache::GetInstance().MultiSigVerify(
+          message, 0, message.size(), vcblock.GetCS2(), B2, *aggregatedKey)) {
     LOG_GENERAL(WARNING, "Cosig verification failed. Pubkeys");
     for (auto& kv : keys) {
       LOG_GENERAL(WARNING, kv);
@@ -103,6 +106,30 @@ bool Node::ProcessVCBlock(const bytes& message, unsigned int cur_offset,
                           [[gnu::unused]] const Peer& from) {
   LOG_MARKER();
 
+  // Only the header is decoded until the block is known to be for this epoch
+  // and not seen before
+  VCBlockHeader vcBlockHeader;
+  BlockHash vcBlockHash;
+  if (!Messenger::GetNodeVCBlockHeader(message, cur_offset, vcBlockHeader,
+                                       vcBlockHash)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Messenger::GetNodeVCBlockHeader failed.");
+    return false;
+  }
+
+  if (vcBlockHeader.GetViewChangeEpochNo() != m_mediator.m_currentEpochNum) {
+    LOG_GENERAL(WARNING, "Dropping vc block of epoch "
+                             << vcBlockHeader.GetViewChangeEpochNo());
+    return false;
+  }
+
+  VCBlockSharedPtr VCBlockptr;
+  if (BlockStorage::GetBlockStorage().GetVCBlock(vcBlockHash, VCBlockptr)) {
+    LOG_GENERAL(WARNING,
+                "Duplicated vc block detected. 0x" << vcBlockHash.hex());
+    return false;
+  }
+
   VCBlock vcblock;
 
   if (!Messenger::GetNodeVCBlock(message, cur_offset, vcblock)) {
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "DAGStore.h"
+#include "depends/libethash/include/ethash/keccak.hpp"
+#include "depends/libethash/lib/ethash/ethash-internal.hpp"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace {
+const char DAG_MAGIC[8] = {'Z', 'I', 'L', 'D', 'A', 'G', 0, 1};
+const size_t HEADER_SIZE = 4096;
+
+struct DAGHeader {
+  char m_magic[8];
+  int32_t m_epochNumber;
+  int32_t m_numItems;
+  ethash_hash256 m_checksum;
+};
+static_assert(sizeof(DAGHeader) <= HEADER_SIZE, "DAG header too big");
+}  // namespace
+
+DAGStore::DAGStore(const string& dir) : m_dir(dir) {}
+
+string DAGStore::GetPath(int epochNumber) const {
+  return m_dir + "/" + to_string(epochNumber) + ".dag";
+}
+
+shared_ptr<ethash::epoch_context_full> DAGStore::Load(int epochNumber) const {
+  const string path = GetPath(epochNumber);
+  const int numItems = ethash::calculate_full_dataset_num_items(epochNumber);
+  const size_t dataSize =
+      static_cast<size_t>(numItems) * sizeof(ethash::hash1024);
+  const size_t fileSize = HEADER_SIZE + dataSize;
+
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != fileSize) {
+    LOG_GENERAL(WARNING, "Wrong size of stored DAG " << path);
+    close(fd);
+    return nullptr;
+  }
+
+  // Private so that the pages are shared with the other processes until
+  // the lazy lookup of an all zero item writes to one
+  void* base =
+      mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    LOG_GENERAL(WARNING, "Failed to map stored DAG " << path);
+    return nullptr;
+  }
+
+  DAGHeader header{};
+  memcpy(&header, base, sizeof(header));
+  auto* items = reinterpret_cast<ethash::hash1024*>(static_cast<char*>(base) +
+                                                    HEADER_SIZE);
+  bool checksOut = memcmp(header.m_magic, DAG_MAGIC, sizeof(DAG_MAGIC)) == 0 &&
+                   header.m_epochNumber == epochNumber &&
+                   header.m_numItems == numItems;
+  if (checksOut) {
+    const auto checksum =
+        ethash::keccak256(reinterpret_cast<uint8_t*>(items), dataSize);
+    checksOut = memcmp(header.m_checksum.bytes, checksum.bytes,
+                       sizeof(checksum.bytes)) == 0;
+  }
+  if (!checksOut) {
+    LOG_GENERAL(WARNING, "Stored DAG " << path << " does not check out");
+    munmap(base, fileSize);
+    return nullptr;
+  }
+
+  shared_ptr<ethash::epoch_context> light =
+      ethash::create_epoch_context(epochNumber);
+  if (!light) {
+    munmap(base, fileSize);
+    return nullptr;
+  }
+
+  LOG_GENERAL(INFO, "Mapped stored DAG " << path);
+
+  return shared_ptr<ethash::epoch_context_full>(
+      new ethash::epoch_context_full(
+          epochNumber, light->light_cache_num_items, light->light_cache,
+          numItems, items),
+      [light, base, fileSize](ethash::epoch_context_full* context) {
+        delete context;
+        munmap(base, fileSize);
+      });
+}
+
+bool DAGStore::Generate(int epochNumber, unsigned int numThreads) const {
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(m_dir, ec);
+
+  const string path = GetPath(epochNumber);
+
+  // Only one process of the host generates a dataset. The lock goes away
+  // with the process if it dies halfway.
+  const string lockPath = path + ".lock";
+  const int lockFd = open(lockPath.c_str(), O_RDWR | O_CREAT, 0644);
+  if (lockFd < 0 || flock(lockFd, LOCK_EX | LOCK_NB) != 0) {
+    if (lockFd >= 0) {
+      close(lockFd);
+    }
+    return false;
+  }
+
+  auto unlock = [lockFd]() {
+    flock(lockFd, LOCK_UN);
+    close(lockFd);
+  };
+
+  if (boost::filesystem::exists(path)) {
+    unlock();
+    return true;
+  }
+
+  const auto light = ethash::create_epoch_context(epochNumber);
+  const int numItems = ethash::calculate_full_dataset_num_items(epochNumber);
+  const size_t dataSize =
+      static_cast<size_t>(numItems) * sizeof(ethash::hash1024);
+  const size_t fileSize = HEADER_SIZE + dataSize;
+
+  const string tmpPath = path + ".tmp";
+  const int fd = open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (!light || fd < 0 || ftruncate(fd, fileSize) != 0) {
+    LOG_GENERAL(WARNING, "Failed to create DAG file " << tmpPath);
+    if (fd >= 0) {
+      close(fd);
+    }
+    unlock();
+    return false;
+  }
+  void* base =
+      mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    LOG_GENERAL(WARNING, "Failed to map DAG file " << tmpPath);
+    unlock();
+    return false;
+  }
+
+  LOG_GENERAL(INFO, "Generating DAG of epoch " << epochNumber << " into "
+                                               << path);
+
+  auto* items = reinterpret_cast<ethash::hash1024*>(static_cast<char*>(base) +
+                                                    HEADER_SIZE);
+  auto generateRange = [&light, items](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      items[i] = ethash::calculate_dataset_item(*light, i);
+    }
+  };
+
+  const int numRanges = static_cast<int>(max(numThreads, 1u));
+  const int rangeSize = (numItems + numRanges - 1) / numRanges;
+  vector<thread> threads;
+  for (int r = 0; r < numRanges; r++) {
+    threads.emplace_back(generateRange, min(numItems, r * rangeSize),
+                         min(numItems, (r + 1) * rangeSize));
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  DAGHeader header{};
+  memcpy(header.m_magic, DAG_MAGIC, sizeof(DAG_MAGIC));
+  header.m_epochNumber = epochNumber;
+  header.m_numItems = numItems;
+  header.m_checksum =
+      ethash::keccak256(reinterpret_cast<uint8_t*>(items), dataSize);
+  memcpy(base, &header, sizeof(header));
+
+  const bool synced = msync(base, fileSize, MS_SYNC) == 0;
+  munmap(base, fileSize);
+
+  // Renamed into place once complete, so that a reader never maps a partial
+  // dataset
+  const bool stored = synced && rename(tmpPath.c_str(), path.c_str()) == 0;
+  if (!stored) {
+    LOG_GENERAL(WARNING, "Failed to store DAG " << path);
+    unlink(tmpPath.c_str());
+  }
+
+  unlock();
+  return stored;
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBPOW_DAGSTORE_H_
+#define ZILLIQA_SRC_LIBPOW_DAGSTORE_H_
+
+#include <memory>
+#include <string>
+
+#include "depends/libethash/include/ethash/ethash.hpp"
+
+/// Keeps the full ethash datasets in files, one per epoch, so that a dataset
+/// is generated once and then mapped by every node process of the host. A
+/// file starts with a page holding the epoch, the number of items and the
+/// keccak256 checksum of the items that follow it.
+class DAGStore {
+ public:
+  explicit DAGStore(const std::string& dir);
+
+  /// Maps the full dataset of epochNumber. Returns nullptr if it is not
+  /// stored or does not match its checksum.
+  std::shared_ptr<ethash::epoch_context_full> Load(int epochNumber) const;
+
+  /// Generates the full dataset of epochNumber on numThreads threads and
+  /// stores it. Returns false if it failed or another process is already
+  /// generating it.
+  bool Generate(int epochNumber, unsigned int numThreads) const;
+
+  std::string GetPath(int epochNumber) const;
+
+ private:
+  const std::string m_dir;
+};
+
+#endif  // ZILLIQA_SRC_LIBPOW_DAGSTORE_H_
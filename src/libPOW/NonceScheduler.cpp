@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "NonceScheduler.h"
+
+using namespace std;
+
+NonceScheduler::NonceScheduler(unsigned int numDevices,
+                               const chrono::milliseconds& rangeDuration,
+                               uint64_t initialRangeSize)
+    : m_rangeDuration(rangeDuration),
+      m_initialRangeSize(initialRangeSize),
+      m_hashRates(numDevices, 0) {}
+
+void NonceScheduler::Start(uint64_t startNonce) {
+  lock_guard<mutex> g(m_mutex);
+  m_nextNonce = startNonce;
+  m_solved = false;
+  m_stopped = false;
+}
+
+bool NonceScheduler::NextRange(unsigned int device, uint64_t minSize,
+                               uint64_t& start, uint64_t& size) {
+  lock_guard<mutex> g(m_mutex);
+
+  if (m_stopped || device >= m_hashRates.size()) {
+    return false;
+  }
+
+  const uint64_t hashRate = m_hashRates[device];
+  size = hashRate == 0 ? m_initialRangeSize
+                       : hashRate * m_rangeDuration.count() / 1000;
+  size = max({size, minSize, uint64_t{1}});
+
+  start = m_nextNonce;
+  m_nextNonce += size;
+  return true;
+}
+
+void NonceScheduler::AddHashes(unsigned int device, uint64_t numHashes,
+                               const Clock::duration& elapsed) {
+  const auto elapsedInUs =
+      chrono::duration_cast<chrono::microseconds>(elapsed).count();
+  if (numHashes == 0 || elapsedInUs <= 0) {
+    return;
+  }
+  const uint64_t hashRate = numHashes * 1000000 / elapsedInUs;
+
+  lock_guard<mutex> g(m_mutex);
+  if (device >= m_hashRates.size()) {
+    return;
+  }
+
+  // Smooth out the batches a device is interrupted in
+  auto& deviceHashRate = m_hashRates[device];
+  deviceHashRate =
+      deviceHashRate == 0 ? hashRate : (deviceHashRate * 3 + hashRate) / 4;
+}
+
+bool NonceScheduler::Solve() {
+  m_stopped = true;
+  bool expected = false;
+  return m_solved.compare_exchange_strong(expected, true);
+}
+
+void NonceScheduler::Stop() { m_stopped = true; }
+
+bool NonceScheduler::IsStopped() const { return m_stopped; }
+
+uint64_t NonceScheduler::GetHashRate(unsigned int device) const {
+  lock_guard<mutex> g(m_mutex);
+  return device < m_hashRates.size() ? m_hashRates[device] : 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBPOW_NONCESCHEDULER_H_
+#define ZILLIQA_SRC_LIBPOW_NONCESCHEDULER_H_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+/// Hands out the nonces of one PoW to several mining devices. Each device
+/// takes a range that keeps it busy for about rangeDuration at the hashrate
+/// measured on its earlier ranges, so that a slow device never holds back a
+/// fast one. The hashrates are kept from one PoW to the next.
+class NonceScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  NonceScheduler(unsigned int numDevices,
+                 const std::chrono::milliseconds& rangeDuration,
+                 uint64_t initialRangeSize = 1ULL << 32);
+
+  /// Starts handing out the nonces from startNonce
+  void Start(uint64_t startNonce);
+
+  /// Takes the next range of device, from start and at least minSize long so
+  /// that it fits a whole batch of the device. Returns false once stopped.
+  bool NextRange(unsigned int device, uint64_t minSize, uint64_t& start,
+                 uint64_t& size);
+
+  /// Records that device hashed numHashes nonces in elapsed
+  void AddHashes(unsigned int device, uint64_t numHashes,
+                 const Clock::duration& elapsed);
+
+  /// Stops every device for a solution. Returns true for the first solution
+  /// only, which is the one to keep.
+  bool Solve();
+
+  /// Stops every device without a solution
+  void Stop();
+
+  bool IsStopped() const;
+
+  /// Returns the measured hashes per second of device, 0 if not known yet
+  uint64_t GetHashRate(unsigned int device) const;
+
+ private:
+  const std::chrono::milliseconds m_rangeDuration;
+  const uint64_t m_initialRangeSize;
+
+  std::atomic<bool> m_stopped{true};
+  std::atomic<bool> m_solved{false};
+
+  mutable std::mutex m_mutex;
+  uint64_t m_nextNonce{0};
+  std::vector<uint64_t> m_hashRates;
+};
+
+#endif  // ZILLIQA_SRC_LIBPOW_NONCESCHEDULER_H_
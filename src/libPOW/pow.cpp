@@ -21,12 +21,15 @@
 #include <iomanip>
 #include <iostream>
 
+#include "DAGStore.h"
 #include "common/Serializable.h"
 #include "depends/libethash/include/ethash/ethash.hpp"
 #include "depends/libethash/lib/ethash/ethash-internal.hpp"
 #include "libCrypto/Sha2.h"
 #include "libServer/GetWorkServer.h"
 #include "libUtils/DataConversion.h"
+#include "libUtils/OrderedPipeline.h"
+#include "libUtils/ThreadAffinity.h"
 #include "pow.h"
 
 #ifdef OPENCL_MINE
@@ -39,6 +42,23 @@
 
 using namespace boost::multiprecision;
 
+namespace {
+// Each CPU thread takes nonces for about this long at its hashrate at a time
+const unsigned int CPU_NONCE_RANGE_IN_MS = 500;
+// Nonces of the first range of a thread, before its hashrate is known
+const uint64_t CPU_INITIAL_NONCE_RANGE = 256;
+// Bounds the cache of the verified PoWs of a block
+const size_t MAX_VERIFIED_HASHES = 1 << 16;
+// Thread group of the CPU mining threads and the GPU miner host threads
+const std::string MINER_THREAD_GROUP = "Miner";
+
+void PinThreadToCore(unsigned int core) {
+  if (!ThreadAffinity::PinCores({core})) {
+    LOG_GENERAL(WARNING, "Failed to pin mining thread to core " << core);
+  }
+}
+}  // namespace
+
 POW::POW() {
   m_currentBlockNum = 0;
   m_epochContextLight =
@@ -50,16 +70,21 @@ POW::POW() {
 
   if (!GETWORK_SERVER_MINE && FULL_DATASET_MINE && !CUDA_GPU_MINE &&
       !OPENCL_GPU_MINE && !REMOTE_MINE) {
-    m_epochContextFull = ethash::create_epoch_context_full(
-        ethash::get_epoch_number(m_currentBlockNum));
+    m_epochContextFull = CreateEpochContextFull(
+        ethash::get_epoch_number(m_currentBlockNum), false);
   }
 
   if (!LOOKUP_NODE_MODE) {
     if (OPENCL_GPU_MINE) {
       InitOpenCL();
-    } else if (CUDA_GPU_MINE) {
+    }
+    if (CUDA_GPU_MINE) {
       InitCUDA();
     }
+    if (!m_miners.empty()) {
+      m_nonceScheduler = std::make_unique<NonceScheduler>(
+          m_miners.size(), std::chrono::milliseconds(GPU_NONCE_RANGE_IN_MS));
+    }
   }
 }
 
@@ -72,7 +97,7 @@ POW& POW::GetInstance() {
 
 void POW::StopMining() {
   m_shouldMine = false;
-  if (GETWORK_SERVER_MINE) {
+  if (GETWORK_SERVER_MINE || (REMOTE_MINE && REMOTE_MINE_PUSH_PORT != 0)) {
     GetWorkServer::GetInstance().StopMining();
   }
 }
@@ -236,27 +261,93 @@ bool POW::EthashConfigureClient(uint64_t block_number, bool fullDataset) {
                     << " currentBlockNum: " << m_currentBlockNum);
   }
 
-  if (ethash::get_epoch_number(block_number) !=
-      ethash::get_epoch_number(m_currentBlockNum)) {
-    auto epochNumber = ethash::get_epoch_number(block_number);
-    m_epochContextLight = ethash::create_epoch_context(epochNumber);
+  const int epochNumber = ethash::get_epoch_number(block_number);
+  const bool isPrepared = epochNumber == m_nextEpochNumber;
+
+  // Only waits if the prepared context is still being generated
+  if (epochNumber != ethash::get_epoch_number(m_currentBlockNum)) {
+    if (isPrepared && m_nextEpochContextLight.valid()) {
+      m_epochContextLight = m_nextEpochContextLight.get();
+      m_nextEpochContextLight = {};
+    } else {
+      m_epochContextLight = ethash::create_epoch_context(epochNumber);
+    }
   }
 
   bool isMineFullCpu = fullDataset && !CUDA_GPU_MINE && !OPENCL_GPU_MINE &&
                        !GETWORK_SERVER_MINE && !REMOTE_MINE;
 
   if (isMineFullCpu && (m_epochContextFull == nullptr ||
-                        ethash::get_epoch_number(block_number) !=
-                            ethash::get_epoch_number(m_currentBlockNum))) {
-    m_epochContextFull = ethash::create_epoch_context_full(
-        ethash::get_epoch_number(block_number));
+                        m_epochContextFull->epoch_number != epochNumber)) {
+    if (isPrepared && m_nextEpochContextFull.valid()) {
+      m_epochContextFull = m_nextEpochContextFull.get();
+      m_nextEpochContextFull = {};
+    } else {
+      m_epochContextFull = CreateEpochContextFull(epochNumber, false);
+    }
   }
 
   m_currentBlockNum = block_number;
 
+  // The next block starts a new epoch, so get its contexts ready meanwhile
+  const int nextEpochNumber = ethash::get_epoch_number(block_number + 1);
+  if (nextEpochNumber != epochNumber && nextEpochNumber != m_nextEpochNumber) {
+    PrepareEpochContext(nextEpochNumber, isMineFullCpu);
+  }
+
   return true;
 }
 
+void POW::PrepareEpochContext(int epochNumber, bool isMineFullCpu) {
+  LOG_GENERAL(INFO, "Generating the context of ethash epoch " << epochNumber);
+
+  m_nextEpochNumber = epochNumber;
+  m_nextEpochContextLight =
+      std::async(std::launch::async, [epochNumber]() {
+        return std::shared_ptr<ethash::epoch_context>(
+            ethash::create_epoch_context(epochNumber));
+      }).share();
+
+  if (isMineFullCpu) {
+    m_nextEpochContextFull =
+        std::async(std::launch::async, [this, epochNumber]() {
+          return CreateEpochContextFull(epochNumber, true);
+        }).share();
+  } else {
+    m_nextEpochContextFull = {};
+  }
+}
+
+std::shared_ptr<ethash::epoch_context_full> POW::CreateEpochContextFull(
+    int epochNumber, bool canWait) {
+  if (!DAG_STORE_DIR.empty()) {
+    const DAGStore store(DAG_STORE_DIR);
+    auto context = store.Load(epochNumber);
+    if (context) {
+      return context;
+    }
+
+    const unsigned int numThreads = std::thread::hardware_concurrency();
+    if (canWait) {
+      if (store.Generate(epochNumber, numThreads)) {
+        context = store.Load(epochNumber);
+        if (context) {
+          return context;
+        }
+      }
+    } else if (!m_dagStoreGeneration.valid() ||
+               m_dagStoreGeneration.wait_for(std::chrono::seconds(0)) ==
+                   std::future_status::ready) {
+      m_dagStoreGeneration =
+          std::async(std::launch::async, [store, epochNumber, numThreads]() {
+            return store.Generate(epochNumber, numThreads);
+          });
+    }
+  }
+
+  return ethash::create_epoch_context_full(epochNumber);
+}
+
 ethash_mining_result_t POW::MineGetWork(uint64_t blockNum,
                                         ethash_hash256 const& headerHash,
                                         uint8_t difficulty, int timeWindow) {
@@ -275,99 +366,142 @@ ethash_mining_result_t POW::MineGetWork(uint64_t blockNum,
   return result;
 }
 
-ethash_mining_result_t POW::MineLight(ethash_hash256 const& headerHash,
-                                      ethash_hash256 const& boundary,
-                                      uint64_t startNonce, int timeWindow) {
-  uint64_t nonce = startNonce;
-  auto startTime = std::chrono::high_resolution_clock::now();
+ethash_mining_result_t POW::MineCPU(ethash_hash256 const& headerHash,
+                                    ethash_hash256 const& boundary,
+                                    uint64_t startNonce, int timeWindow,
+                                    bool fullDataset) {
+  const unsigned int numCores =
+      std::max(std::thread::hardware_concurrency(), 1u);
+  const unsigned int numThreads =
+      CPU_MINE_THREADS > 0 ? CPU_MINE_THREADS : numCores;
+
+  // Held until the threads are done, even if the epoch moves on meanwhile
+  const auto contextLight = m_epochContextLight;
+  const auto contextFull = fullDataset ? m_epochContextFull : nullptr;
+  if (fullDataset && !contextFull) {
+    LOG_GENERAL(WARNING, "No full dataset to mine with");
+    return ethash_mining_result_t{"", "", 0, false};
+  }
 
-  while (m_shouldMine) {
-    auto mineResult = ethash::hash(*m_epochContextLight, headerHash, nonce);
-    if (ethash::is_less_or_equal(mineResult.final_hash, boundary)) {
-      ethash_mining_result_t winning_result = {
-          BlockhashToHexString(mineResult.final_hash),
-          BlockhashToHexString(mineResult.mix_hash), nonce, true};
-      return winning_result;
+  NonceScheduler scheduler(numThreads,
+                           std::chrono::milliseconds(CPU_NONCE_RANGE_IN_MS),
+                           CPU_INITIAL_NONCE_RANGE);
+  scheduler.Start(startNonce);
+
+  ethash_mining_result_t result{"", "", 0, false};
+  unsigned int numThreadsDone = 0;
+  std::mutex mutexResult;
+  std::condition_variable cvResult;
+
+  auto mineThread = [&](unsigned int index) {
+    if (!ThreadAffinity::GetCores(MINER_THREAD_GROUP).empty()) {
+      ThreadAffinity::Apply(MINER_THREAD_GROUP, index);
+    } else if (CPU_MINE_PIN_THREADS) {
+      PinThreadToCore(index % numCores);
     }
-    nonce++;
 
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    auto timePassedInSeconds = std::chrono::duration_cast<std::chrono::seconds>(
-                                   currentTime - startTime)
-                                   .count();
-    if (timePassedInSeconds > timeWindow) {
-      LOG_GENERAL(WARNING,
-                  "Time out while mining pow result, time "
-                  "passed in seconds "
-                      << timePassedInSeconds << ", time window " << timeWindow);
-      m_shouldMine = false;
-      break;
+    uint64_t start = 0;
+    uint64_t size = 0;
+    while (m_shouldMine && scheduler.NextRange(index, 0, start, size)) {
+      const auto rangeStart = NonceScheduler::Clock::now();
+      uint64_t nonce = start;
+      for (; nonce - start < size && m_shouldMine && !scheduler.IsStopped();
+           ++nonce) {
+        const auto mineResult =
+            contextFull ? ethash::hash(*contextFull, headerHash, nonce)
+                        : ethash::hash(*contextLight, headerHash, nonce);
+        if (ethash::is_less_or_equal(mineResult.final_hash, boundary)) {
+          if (scheduler.Solve()) {
+            std::lock_guard<std::mutex> g(mutexResult);
+            result = {BlockhashToHexString(mineResult.final_hash),
+                      BlockhashToHexString(mineResult.mix_hash), nonce, true};
+          }
+          break;
+        }
+      }
+      scheduler.AddHashes(index, nonce - start,
+                          NonceScheduler::Clock::now() - rangeStart);
     }
-  }
 
-  ethash_mining_result_t failure_result = {"", "", 0, false};
-  return failure_result;
-}
-
-ethash_mining_result_t POW::MineFull(ethash_hash256 const& headerHash,
-                                     ethash_hash256 const& boundary,
-                                     uint64_t startNonce, int timeWindow) {
-  uint64_t nonce = startNonce;
-  auto startTime = std::chrono::high_resolution_clock::now();
-
-  while (m_shouldMine) {
-    auto mineResult = ethash::hash(*m_epochContextFull, headerHash, nonce);
-    if (ethash::is_less_or_equal(mineResult.final_hash, boundary)) {
-      ethash_mining_result_t winning_result = {
-          BlockhashToHexString(mineResult.final_hash),
-          BlockhashToHexString(mineResult.mix_hash), nonce, true};
-      return winning_result;
+    {
+      std::lock_guard<std::mutex> g(mutexResult);
+      ++numThreadsDone;
     }
-    nonce++;
+    cvResult.notify_all();
+  };
 
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    auto timePassedInSeconds = std::chrono::duration_cast<std::chrono::seconds>(
-                                   currentTime - startTime)
-                                   .count();
-    if (timePassedInSeconds > timeWindow) {
-      LOG_GENERAL(WARNING,
-                  "Time out while mining pow result, time "
-                  "passed in seconds "
-                      << timePassedInSeconds << ", time window " << timeWindow);
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < numThreads; ++i) {
+    threads.emplace_back(mineThread, i);
+  }
+
+  {
+    std::unique_lock<std::mutex> lk(mutexResult);
+    if (!cvResult.wait_for(lk, std::chrono::seconds(timeWindow), [&] {
+          return scheduler.IsStopped() || numThreadsDone == numThreads;
+        })) {
+      LOG_GENERAL(WARNING, "Time out while mining pow result, time window "
+                               << timeWindow);
       m_shouldMine = false;
-      break;
     }
   }
+  scheduler.Stop();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (unsigned int i = 0; i < numThreads; ++i) {
+    LOG_GENERAL(INFO, "CPU mining thread " << i << " hashrate "
+                                           << scheduler.GetHashRate(i)
+                                           << " H/s");
+  }
 
-  ethash_mining_result_t failure_result = {"", "", 0, false};
-  return failure_result;
+  return result;
 }
 
 ethash_mining_result_t POW::MineFullGPU(uint64_t blockNum,
                                         ethash_hash256 const& headerHash,
                                         uint8_t difficulty, uint64_t startNonce,
                                         int timeWindow) {
+  if (!m_nonceScheduler) {
+    return ethash_mining_result_t{"", "", 0, false};
+  }
+
   std::vector<std::unique_ptr<std::thread>> vecThread;
-  uint64_t nonce = startNonce;
-  m_minerIndex = 0;
   // Clear old result
   for (auto& miningResult : m_vecMiningResult) {
     miningResult = ethash_mining_result_t{"", "", 0, false};
   }
-  for (size_t i = 0; i < m_miners.size(); ++i) {
-    vecThread.push_back(std::make_unique<std::thread>([&] {
-      MineFullGPUThread(blockNum, headerHash, difficulty, nonce, timeWindow);
+  m_numMinersDone = 0;
+  m_nonceScheduler->Start(startNonce);
+  for (unsigned int i = 0; i < m_miners.size(); ++i) {
+    vecThread.push_back(std::make_unique<std::thread>([&, i] {
+      MineFullGPUThread(blockNum, headerHash, difficulty, i);
     }));
   }
 
-  std::this_thread::sleep_for(std::chrono::milliseconds(5));
-  std::unique_lock<std::mutex> lk(m_mutexMiningResult);
-  m_cvMiningResult.wait(lk);
+  {
+    std::unique_lock<std::mutex> lk(m_mutexMiningResult);
+    if (!m_cvMiningResult.wait_for(lk, std::chrono::seconds(timeWindow), [&] {
+          return m_nonceScheduler->IsStopped() ||
+                 m_numMinersDone == m_miners.size();
+        })) {
+      LOG_GENERAL(WARNING, "Time out while mining pow result, time window "
+                               << timeWindow);
+    }
+  }
+  m_nonceScheduler->Stop();
   m_shouldMine = false;
   for (auto& ptrThead : vecThread) {
     ptrThead->join();
   }
 
+  for (unsigned int i = 0; i < m_miners.size(); ++i) {
+    LOG_GENERAL(INFO, "GPU miner " << i << " hashrate "
+                                   << m_nonceScheduler->GetHashRate(i)
+                                   << " H/s");
+  }
+
   for (const auto& miningResult : m_vecMiningResult) {
     if (miningResult.success) {
       return miningResult;
@@ -387,6 +521,19 @@ ethash_mining_result_t POW::RemoteMine(const PairOfKey& pairOfKey,
   m_shouldMine = true;
 
   ethash_mining_result_t miningResult{"", "", 0, false};
+
+  // Accept the solution pushed by the proxy from before it gets the work
+  const bool pushResult = REMOTE_MINE_PUSH_PORT != 0;
+  if (pushResult) {
+    const int epoch = ethash::get_epoch_number(blockNum);
+    PoWWorkPackage work = {
+        BlockhashToHexString(headerHash),
+        BlockhashToHexString(ethash::calculate_seed(epoch)),
+        BlockhashToHexString(boundary), blockNum,
+        DevidedBoundaryToDifficulty(boundary)};
+    GetWorkServer::GetInstance().StartMining(work);
+  }
+
   uint32_t retryTime = 0;
   bool sendWorkSuccess = false;
   do {
@@ -401,6 +548,9 @@ ethash_mining_result_t POW::RemoteMine(const PairOfKey& pairOfKey,
 
   if (!sendWorkSuccess) {
     LOG_GENERAL(WARNING, "Failed to send work package to mining proxy.");
+    if (pushResult) {
+      GetWorkServer::GetInstance().StopMining();
+    }
     return miningResult;
   }
 
@@ -408,6 +558,9 @@ ethash_mining_result_t POW::RemoteMine(const PairOfKey& pairOfKey,
   ethash_hash256 mixHash{};
   bool checkResult = CheckMiningResult(pairOfKey, headerHash, boundary, nonce,
                                        mixHash, timeWindow);
+  if (pushResult) {
+    GetWorkServer::GetInstance().StopMining();
+  }
   if (!checkResult) {
     LOG_GENERAL(WARNING, "Failed to check pow result from mining proxy.");
     return miningResult;
@@ -559,8 +712,22 @@ bool POW::CheckMiningResult(const PairOfKey& pairOfKey,
       return false;
     }
 
-    std::this_thread::sleep_for(
-        std::chrono::seconds(CHECK_MINING_RESULT_INTERVAL));
+    if (REMOTE_MINE_PUSH_PORT != 0) {
+      // Woken up as soon as the proxy pushes a verified solution, and polls
+      // in between for a proxy that does not push
+      const auto pushed = GetWorkServer::GetInstance().GetResult(
+          CHECK_MINING_RESULT_INTERVAL);
+      if (pushed.success) {
+        nonce = pushed.winning_nonce;
+        mixHash = StringToBlockhash(pushed.mix_hash);
+        LOG_GENERAL(INFO, "PoW result pushed by proxy, nonce: "
+                              << nonce << " mix hash: " << pushed.mix_hash);
+        return true;
+      }
+    } else {
+      std::this_thread::sleep_for(
+          std::chrono::seconds(CHECK_MINING_RESULT_INTERVAL));
+    }
 
     try {
       jsonrpc::Client client(*m_httpClient);
@@ -668,13 +835,11 @@ bool POW::SendVerifyResult(const PairOfKey& pairOfKey,
 }
 
 void POW::MineFullGPUThread(uint64_t blockNum, ethash_hash256 const& headerHash,
-                            uint8_t difficulty, uint64_t nonce,
-                            int timeWindow) {
+                            uint8_t difficulty, unsigned int index) {
   LOG_MARKER();
-  auto index = m_minerIndex.load(std::memory_order_relaxed);
-  ++m_minerIndex;
   LOG_GENERAL(INFO, "Difficulty : " << std::to_string(difficulty)
                                     << ", miner index " << index);
+  ThreadAffinity::Apply(MINER_THREAD_GROUP, index);
   dev::eth::WorkPackage wp;
   wp.blockNumber = blockNum;
   wp.boundary = (dev::h256)(dev::u256)((dev::bigint(1) << 256) /
@@ -682,49 +847,52 @@ void POW::MineFullGPUThread(uint64_t blockNum, ethash_hash256 const& headerHash,
 
   wp.header = dev::h256{headerHash.bytes, dev::h256::ConstructFromPointer};
 
-  constexpr uint32_t NONCE_SEGMENT_WIDTH = 40;
-  const uint64_t NONCE_SEGMENT = (uint64_t)pow(2, NONCE_SEGMENT_WIDTH);
-  wp.startNonce = nonce + index * NONCE_SEGMENT;
-
-  auto startTime = std::chrono::high_resolution_clock::now();
+  const auto boundary = DifficultyLevelInIntDevided(difficulty);
+  uint64_t batchSize = 0;
+  uint64_t rangeEnd = 0;
 
   dev::eth::Solution solution;
-  while (m_shouldMine) {
+  while (m_shouldMine && !m_nonceScheduler->IsStopped()) {
+    // A batch running past the range would hash the nonces of another GPU
+    if (wp.startNonce >= rangeEnd || rangeEnd - wp.startNonce < batchSize) {
+      uint64_t rangeSize = 0;
+      if (!m_nonceScheduler->NextRange(index, batchSize, wp.startNonce,
+                                       rangeSize)) {
+        break;
+      }
+      rangeEnd = wp.startNonce + rangeSize;
+    }
+
+    const auto batchStart = NonceScheduler::Clock::now();
     if (!m_miners[index]->mine(wp, solution)) {
       LOG_GENERAL(WARNING, "GPU failed to do mine, GPU miner log: "
                                << m_miners[index]->getLog());
-      m_vecMiningResult[index] = ethash_mining_result_t{"", "", 0, false};
-      m_cvMiningResult.notify_one();
-      return;
+      break;
     }
     auto hashResult = LightHash(blockNum, headerHash, solution.nonce);
-    auto boundary = DifficultyLevelInIntDevided(difficulty);
     if (ethash::is_less_or_equal(hashResult.final_hash, boundary)) {
-      m_vecMiningResult[index] =
-          ethash_mining_result_t{BlockhashToHexString(hashResult.final_hash),
-                                 solution.mixHash.hex(), solution.nonce, true};
-      m_cvMiningResult.notify_one();
-      return;
-    }
-    wp.startNonce = solution.nonce;
-
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    auto timePassedInSeconds = std::chrono::duration_cast<std::chrono::seconds>(
-                                   currentTime - startTime)
-                                   .count();
-    if (timePassedInSeconds > timeWindow) {
-      LOG_GENERAL(WARNING,
-                  "Time out while mining pow result, time "
-                  "passed in seconds "
-                      << timePassedInSeconds << ", time window " << timeWindow);
-      m_shouldMine = false;
+      if (m_nonceScheduler->Solve()) {
+        std::lock_guard<std::mutex> g(m_mutexMiningResult);
+        m_vecMiningResult[index] = ethash_mining_result_t{
+            BlockhashToHexString(hashResult.final_hash),
+            solution.mixHash.hex(), solution.nonce, true};
+      }
       break;
     }
+
+    // The miner returns the nonce after its batch, or the one it stopped at
+    const uint64_t numHashes = solution.nonce - wp.startNonce;
+    batchSize = std::max(batchSize, numHashes);
+    m_nonceScheduler->AddHashes(index, numHashes,
+                                NonceScheduler::Clock::now() - batchStart);
+    wp.startNonce = std::max(solution.nonce, wp.startNonce + 1);
   }
 
-  m_vecMiningResult[index] = ethash_mining_result_t{"", "", 0, false};
-  m_cvMiningResult.notify_one();
-  return;
+  {
+    std::lock_guard<std::mutex> g(m_mutexMiningResult);
+    ++m_numMinersDone;
+  }
+  m_cvMiningResult.notify_all();
 }
 
 bytes POW::ConcatAndhash(const std::array<unsigned char, UINT256_SIZE>& rand1,
@@ -792,10 +960,9 @@ ethash_mining_result_t POW::PoWMine(uint64_t blockNum, uint8_t difficulty,
   } else if (OPENCL_GPU_MINE || CUDA_GPU_MINE) {
     result =
         MineFullGPU(blockNum, headerHash, difficulty, startNonce, timeWindow);
-  } else if (fullDataset) {
-    result = MineFull(headerHash, boundary, startNonce, timeWindow);
   } else {
-    result = MineLight(headerHash, boundary, startNonce, timeWindow);
+    result =
+        MineCPU(headerHash, boundary, startNonce, timeWindow, fullDataset);
   }
   return result;
 }
@@ -804,9 +971,15 @@ bool POW::PoWVerify(uint64_t blockNum, uint8_t difficulty,
                     const ethash_hash256& headerHash, uint64_t winning_nonce,
                     const std::string& winning_result,
                     const std::string& winning_mixhash) {
+  return PoWVerify(blockNum, GetBoundary(difficulty), headerHash,
+                   winning_nonce, winning_result, winning_mixhash);
+}
+
+bool POW::PoWVerify(uint64_t blockNum, const ethash_hash256& boundary,
+                    const ethash_hash256& headerHash, uint64_t winning_nonce,
+                    const std::string& winning_result,
+                    const std::string& winning_mixhash) {
   LOG_MARKER();
-  EthashConfigureClient(blockNum);
-  const auto boundary = DifficultyLevelInIntDevided(difficulty);
   auto winnning_result = StringToBlockhash(winning_result);
   auto winningMixhash = StringToBlockhash(winning_mixhash);
 
@@ -815,15 +988,95 @@ bool POW::PoWVerify(uint64_t blockNum, uint8_t difficulty,
     return false;
   }
 
-  return ethash::verify(*m_epochContextLight, headerHash, winningMixhash,
-                        winning_nonce, boundary);
+  VerifiedKey key{{}, winning_nonce};
+  std::copy(std::begin(headerHash.bytes), std::end(headerHash.bytes),
+            key.first.begin());
+
+  ethash::result hashResult{};
+  bool found = false;
+  {
+    std::lock_guard<std::mutex> g(m_mutexVerifiedHashes);
+    if (m_verifiedBlockNum != blockNum) {
+      m_verifiedHashes.clear();
+      m_verifiedBlockNum = blockNum;
+    }
+    const auto it = m_verifiedHashes.find(key);
+    if (it != m_verifiedHashes.end()) {
+      hashResult = it->second;
+      found = true;
+    }
+  }
+
+  if (!found) {
+    // The mix hash is checked cheaply first, as ethash::verify does, so that
+    // a made up one costs no ethash evaluation nor room in the cache
+    if (!ethash::verify_final_hash(headerHash, winningMixhash, winning_nonce,
+                                   boundary)) {
+      return false;
+    }
+    const auto context = GetEpochContextLight(blockNum);
+    hashResult = ethash::hash(*context, headerHash, winning_nonce);
+
+    std::lock_guard<std::mutex> g(m_mutexVerifiedHashes);
+    if (m_verifiedBlockNum == blockNum) {
+      if (m_verifiedHashes.size() >= MAX_VERIFIED_HASHES) {
+        m_verifiedHashes.clear();
+      }
+      m_verifiedHashes.emplace(key, hashResult);
+    }
+  }
+
+  return std::equal(std::begin(hashResult.mix_hash.bytes),
+                    std::end(hashResult.mix_hash.bytes),
+                    std::begin(winningMixhash.bytes)) &&
+         ethash::is_less_or_equal(hashResult.final_hash, boundary);
+}
+
+std::vector<bool> POW::PoWVerifyBatch(
+    uint64_t blockNum, const std::vector<PoWVerifyRequest>& requests,
+    unsigned int numThreads) {
+  std::vector<bool> verified(requests.size(), false);
+  size_t applied = 0;
+  RunOrderedPipeline<bool>(
+      "PoWVerifyBatch", requests.size(),
+      std::min<unsigned int>(numThreads, requests.size()), requests.size(),
+      [&](size_t i, bool& valid) {
+        const auto& request = requests.at(i);
+        valid = PoWVerify(blockNum, GetBoundary(request.difficulty),
+                          request.headerHash, request.nonce, request.result,
+                          request.mixHash);
+        return true;
+      },
+      [&](size_t i, bool& valid) {
+        verified.at(i) = valid;
+        return true;
+      },
+      applied);
+  return verified;
+}
+
+const ethash_hash256& POW::GetBoundary(uint8_t difficulty) {
+  static const auto boundaries = []() {
+    std::array<ethash_hash256, 256> boundaries{};
+    for (unsigned int i = 0; i < boundaries.size(); i++) {
+      boundaries[i] = DifficultyLevelInIntDevided(static_cast<uint8_t>(i));
+    }
+    return boundaries;
+  }();
+  return boundaries[difficulty];
 }
 
 ethash::result POW::LightHash(uint64_t blockNum,
                               ethash_hash256 const& headerHash,
                               uint64_t nonce) {
+  return ethash::hash(*GetEpochContextLight(blockNum), headerHash, nonce);
+}
+
+std::shared_ptr<ethash::epoch_context> POW::GetEpochContextLight(
+    uint64_t blockNum) {
   EthashConfigureClient(blockNum);
-  return ethash::hash(*m_epochContextLight, headerHash, nonce);
+  std::lock_guard<std::mutex> g(m_mutexLightClientConfigure);
+  return m_epochContextLight;
 }
 
 bool POW::CheckSolnAgainstsTargetedDifficulty(const ethash_hash256& result,
@@ -851,7 +1104,8 @@ void POW::InitOpenCL() {
     LOG_GENERAL(FATAL, "Failed to configure OpenCL GPU, please check hardware");
   }
 
-  auto gpuToUse = GetGpuToUse();
+  auto gpuToUse = GetGpuToUse(OPENCL_GPU_TO_USE.empty() ? GPU_TO_USE
+                                                       : OPENCL_GPU_TO_USE);
   auto totalGpuDevice = CLMiner::getNumDevices();
 
   CLMiner::setNumInstances(gpuToUse.size());
@@ -880,7 +1134,8 @@ void POW::InitCUDA() {
 #ifdef CUDA_MINE
   using namespace dev::eth;
 
-  auto gpuToUse = GetGpuToUse();
+  auto gpuToUse =
+      GetGpuToUse(CUDA_GPU_TO_USE.empty() ? GPU_TO_USE : CUDA_GPU_TO_USE);
   auto deviceGenerateDag = *gpuToUse.begin();
   LOG_GENERAL(INFO, "Generate dag Nvidia GPU #" << deviceGenerateDag);
 
@@ -913,18 +1168,18 @@ void POW::InitCUDA() {
 #endif
 }
 
-std::set<unsigned int> POW::GetGpuToUse() {
-  std::set<unsigned int> gpuToUse;
-  std::stringstream ss(GPU_TO_USE);
+std::set<unsigned int> POW::GetGpuToUse(const std::string& gpuToUse) {
+  std::set<unsigned int> gpuIndexes;
+  std::stringstream ss(gpuToUse);
   std::string item;
   while (std::getline(ss, item, ',')) {
     unsigned int index = strtol(item.c_str(), NULL, 10);
-    gpuToUse.insert(index);
+    gpuIndexes.insert(index);
   }
 
-  if (gpuToUse.empty()) {
+  if (gpuIndexes.empty()) {
     LOG_GENERAL(FATAL, "Please select at least one GPU to use.");
   }
 
-  return gpuToUse;
+  return gpuIndexes;
 }
@@ -20,6 +20,8 @@
 
 #include <stdint.h>
 #include <array>
+#include <future>
+#include <map>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -30,6 +32,7 @@
 #include "jsonrpccpp/client/connectors/httpclient.h"
 #pragma GCC diagnostic pop
 
+#include "NonceScheduler.h"
 #include "common/Constants.h"
 #include "depends/common/Miner.h"
 #include "depends/libethash/include/ethash/ethash.hpp"
@@ -46,6 +49,15 @@ typedef struct EthashMiningResult {
   bool success{};
 } ethash_mining_result_t;
 
+/// A proof-of-work submission to verify in a batch.
+struct PoWVerifyRequest {
+  uint8_t difficulty{};
+  ethash_hash256 headerHash{};
+  uint64_t nonce{};
+  std::string result;
+  std::string mixHash;
+};
+
 /// Implements the proof-of-work functionality.
 class POW {
   static std::string BytesToHexString(const uint8_t* str, const uint64_t s);
@@ -93,6 +105,24 @@ class POW {
                  const ethash_hash256& headerHash, uint64_t winning_nonce,
                  const std::string& winning_result,
                  const std::string& winning_mixhash);
+
+  /// Verifies a proof-of-work submission against the boundary of its
+  /// difficulty. The hash of each header and nonce is kept for blockNum, so
+  /// verifying a submission again costs no ethash evaluation.
+  bool PoWVerify(uint64_t blockNum, const ethash_hash256& boundary,
+                 const ethash_hash256& headerHash, uint64_t winning_nonce,
+                 const std::string& winning_result,
+                 const std::string& winning_mixhash);
+
+  /// Verifies the submissions on numThreads threads, and returns whether
+  /// each of them is valid, in order
+  std::vector<bool> PoWVerifyBatch(
+      uint64_t blockNum, const std::vector<PoWVerifyRequest>& requests,
+      unsigned int numThreads);
+
+  /// Returns the boundary of difficulty, worked out once per difficulty
+  static const ethash_hash256& GetBoundary(uint8_t difficulty);
+
   static bytes ConcatAndhash(
       const std::array<unsigned char, UINT256_SIZE>& rand1,
       const std::array<unsigned char, UINT256_SIZE>& rand2, const Peer& peer,
@@ -106,7 +136,8 @@ class POW {
                                            uint8_t difficulty);
   bool CheckSolnAgainstsTargetedDifficulty(const std::string& result,
                                            uint8_t difficulty);
-  static std::set<unsigned int> GetGpuToUse();
+  static std::set<unsigned int> GetGpuToUse(
+      const std::string& gpuToUse = GPU_TO_USE);
 
   // Put it to public function so can directly test with it
   ethash_mining_result_t RemoteMine(const PairOfKey& pairOfKey,
@@ -131,23 +162,51 @@ class POW {
                         ethash_hash256 const& boundary, bool verifyResult);
 
  private:
+  /// Returns the light context of blockNum, which stays valid for the caller
+  /// on another thread even if the epoch moves on meanwhile
+  std::shared_ptr<ethash::epoch_context> GetEpochContextLight(
+      uint64_t blockNum);
+
+  /// Starts generating the contexts of epochNumber in the background,
+  /// requires m_mutexLightClientConfigure
+  void PrepareEpochContext(int epochNumber, bool isMineFullCpu);
+  /// Creates the full context of epochNumber, mapping it from DAG_STORE_DIR
+  /// if it is stored there. A missing dataset is generated into the store
+  /// first if canWait, and in the background for the next start otherwise.
+  std::shared_ptr<ethash::epoch_context_full> CreateEpochContextFull(
+      int epochNumber, bool canWait);
+
   std::shared_ptr<ethash::epoch_context> m_epochContextLight = nullptr;
   std::shared_ptr<ethash::epoch_context_full> m_epochContextFull = nullptr;
+  // Contexts of the next epoch, generated before the first block of it
+  int m_nextEpochNumber{-1};
+  std::shared_future<std::shared_ptr<ethash::epoch_context>>
+      m_nextEpochContextLight;
+  std::shared_future<std::shared_ptr<ethash::epoch_context_full>>
+      m_nextEpochContextFull;
+  std::future<bool> m_dagStoreGeneration;
+
+  // Hashes of the verified headers and nonces of m_verifiedBlockNum
+  using VerifiedKey = std::pair<std::array<uint8_t, 32>, uint64_t>;
+  std::map<VerifiedKey, ethash::result> m_verifiedHashes;
+  uint64_t m_verifiedBlockNum{0};
+  std::mutex m_mutexVerifiedHashes;
   uint64_t m_currentBlockNum;
   std::atomic<bool> m_shouldMine{};
   std::vector<dev::eth::MinerPtr> m_miners;
   std::vector<ethash_mining_result_t> m_vecMiningResult;
-  std::atomic<int> m_minerIndex{};
+  std::unique_ptr<NonceScheduler> m_nonceScheduler;
+  unsigned int m_numMinersDone{0};
   std::condition_variable m_cvMiningResult;
   std::mutex m_mutexMiningResult;
   std::unique_ptr<jsonrpc::HttpClient> m_httpClient;
 
-  ethash_mining_result_t MineLight(ethash_hash256 const& headerHash,
-                                   ethash_hash256 const& boundary,
-                                   uint64_t startNonce, int timeWindow);
-  ethash_mining_result_t MineFull(ethash_hash256 const& headerHash,
-                                  ethash_hash256 const& boundary,
-                                  uint64_t startNonce, int timeWindow);
+  /// Mines on CPU_MINE_THREADS threads, which take their nonces from a
+  /// NonceScheduler, over the full dataset or the light cache
+  ethash_mining_result_t MineCPU(ethash_hash256 const& headerHash,
+                                 ethash_hash256 const& boundary,
+                                 uint64_t startNonce, int timeWindow,
+                                 bool fullDataset);
   ethash_mining_result_t MineGetWork(uint64_t blockNum,
                                      ethash_hash256 const& headerHash,
                                      uint8_t difficulty, int timeWindow);
@@ -156,7 +215,7 @@ class POW {
                                      uint8_t difficulty, uint64_t startNonce,
                                      int timeWindow);
   void MineFullGPUThread(uint64_t blockNum, ethash_hash256 const& headerHash,
-                         uint8_t difficulty, uint64_t nonce, int timeWindow);
+                         uint8_t difficulty, unsigned int index);
   void InitOpenCL();
   void InitCUDA();
 };
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBPERSISTENCE_BLOCKCACHE_H_
+#define ZILLIQA_SRC_LIBPERSISTENCE_BLOCKCACHE_H_
+
+#include <atomic>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+
+/// Memory-bounded LRU of the blocks decoded from BlockStorage, so that the
+/// same recent blocks are not deserialized again for every reader. Cached
+/// blocks are shared by all the readers and must not be modified.
+template <typename Key, typename Value>
+class BlockCache {
+  /// (key, block, size of its serialized form)
+  using Entry = std::tuple<Key, std::shared_ptr<Value>, size_t>;
+
+  const size_t m_capacityInBytes;
+  size_t m_sizeInBytes{0};
+  mutable std::mutex m_mutex;
+  std::list<Entry> m_recency;  // most recently used first
+  std::unordered_map<Key, typename std::list<Entry>::iterator> m_entries;
+
+  std::atomic<uint64_t> m_hits{0};
+  std::atomic<uint64_t> m_misses{0};
+
+  /// Rough cost of a block decoded from size bytes and its bookkeeping
+  static size_t EntrySize(size_t size) { return 2 * size + 128; }
+
+  void EraseEntry(typename std::list<Entry>::iterator it) {
+    m_sizeInBytes -= EntrySize(std::get<2>(*it));
+    m_entries.erase(std::get<0>(*it));
+    m_recency.erase(it);
+  }
+
+ public:
+  /// A capacity of 0 disables caching.
+  explicit BlockCache(size_t capacityInBytes)
+      : m_capacityInBytes(capacityInBytes) {}
+
+  BlockCache(const BlockCache&) = delete;
+  BlockCache& operator=(const BlockCache&) = delete;
+
+  /// Returns false if the block is not cached.
+  bool Lookup(const Key& key, std::shared_ptr<Value>& block) {
+    if (m_capacityInBytes == 0) {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> g(m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+      m_misses++;
+      return false;
+    }
+    m_recency.splice(m_recency.begin(), m_recency, it->second);
+    block = std::get<1>(*it->second);
+    m_hits++;
+    return true;
+  }
+
+  /// Caches the block decoded from size bytes, replacing any cached one.
+  void Insert(const Key& key, const std::shared_ptr<Value>& block,
+              size_t size) {
+    const size_t entrySize = EntrySize(size);
+    if (!block || entrySize > m_capacityInBytes) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> g(m_mutex);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+      EraseEntry(it->second);
+    }
+    m_recency.emplace_front(key, block, size);
+    m_entries.emplace(key, m_recency.begin());
+    m_sizeInBytes += entrySize;
+
+    while (m_sizeInBytes > m_capacityInBytes) {
+      EraseEntry(std::prev(m_recency.end()));
+    }
+  }
+
+  /// Drops the block, to be called when it is written or deleted.
+  void Erase(const Key& key) {
+    if (m_capacityInBytes == 0) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> g(m_mutex);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+      EraseEntry(it->second);
+    }
+  }
+
+  /// Drops all cached blocks.
+  void Clear() {
+    std::lock_guard<std::mutex> g(m_mutex);
+    m_entries.clear();
+    m_recency.clear();
+    m_sizeInBytes = 0;
+  }
+
+  uint64_t GetHits() const { return m_hits; }
+  uint64_t GetMisses() const { return m_misses; }
+  size_t GetSizeInBytes() const {
+    std::lock_guard<std::mutex> g(m_mutex);
+    return m_sizeInBytes;
+  }
+};
+
+#endif  // ZILLIQA_SRC_LIBPERSISTENCE_BLOCKCACHE_H_
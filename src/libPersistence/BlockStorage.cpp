@@ -19,8 +19,11 @@
 #include <sys/syscall.h>
 #include <unistd.h>
 #include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <sstream>
 #include <string>
 
@@ -34,25 +37,96 @@
 #include "libData/BlockChainData/BlockLinkChain.h"
 #include "libMessage/Messenger.h"
 #include "libUtils/DataConversion.h"
+#include "libUtils/DetachedExecutor.h"
+#include "libUtils/DetachedFunction.h"
+#include "libUtils/MemoryStats.h"
+#include "libUtils/OrderedPipeline.h"
 
 using namespace std;
 
+namespace {
+/// Marks m_microBlockIndexDB as covering all the stored microblocks
+const string MICROBLOCK_INDEX_COMPLETE_KEY = "complete";
+const unsigned int MICROBLOCK_INDEX_PREFIX_SIZE =
+    sizeof(uint64_t) + sizeof(uint32_t);
+
+/// Writes of an epoch being committed, see BlockStorage::CommitEpoch
+const string EPOCH_COMMIT_JOURNAL_KEY = "epochCommitJournal";
+
+/// Appends field to the journal, prefixed with its big-endian size
+void AppendJournalField(string& journal, const string& field) {
+  for (unsigned int i = 0; i < sizeof(uint32_t); i++) {
+    journal.push_back(
+        static_cast<char>(field.size() >> (8 * (sizeof(uint32_t) - 1 - i))));
+  }
+  journal.append(field);
+}
+
+/// Big-endian as LevelDB::BinaryKey, so that the keys sort by number
+string GetBlockNumKey(const uint64_t& blockNum) {
+  string key(sizeof(uint64_t), '\0');
+  for (unsigned int i = 0; i < sizeof(uint64_t); i++) {
+    key[i] = static_cast<char>(blockNum >> (8 * (sizeof(uint64_t) - 1 - i)));
+  }
+  return key;
+}
+
+const unsigned int TXN_COUNT_SIZE = 16;
+
+/// Holds the epoch of the latest checkpoint, in STORAGE_PATH + CHECKPOINT_PATH
+const string CHECKPOINT_LATEST_FILE = "LATEST";
+
+/// Key of m_txnHistoryIndexDB, ordered by epoch within each address. The
+/// (epoch, hash) suffix is the cursor GetTxnHistory resumes after.
+string GetTxnHistoryKey(const Address& address, const uint64_t& epochNum,
+                        const TxnHash& tranHash) {
+  string key(reinterpret_cast<const char*>(address.data()), Address::size);
+  key += GetBlockNumKey(epochNum);
+  key.append(reinterpret_cast<const char*>(tranHash.data()), TxnHash::size);
+  return key;
+}
+
+const unsigned int TXN_HISTORY_SUFFIX_SIZE = sizeof(uint64_t) + TxnHash::size;
+
+bool ReadJournalField(const string& journal, size_t& pos, string& field) {
+  if (journal.size() - pos < sizeof(uint32_t)) {
+    return false;
+  }
+  uint32_t size = 0;
+  for (unsigned int i = 0; i < sizeof(uint32_t); i++) {
+    size = (size << 8) | static_cast<unsigned char>(journal[pos++]);
+  }
+  if (journal.size() - pos < size) {
+    return false;
+  }
+  field = journal.substr(pos, size);
+  pos += size;
+  return true;
+}
+}  // namespace
+
 BlockStorage& BlockStorage::GetBlockStorage(const std::string& path,
                                             bool diagnostic) {
   static BlockStorage bs(path, diagnostic);
   return bs;
 }
 
+size_t BlockStorage::GetBlockCacheCapacity() {
+  return static_cast<size_t>(BLOCKSTORAGE_CACHE_SIZE_IN_MB) * 1024 * 1024 / 4;
+}
+
 bool BlockStorage::PutBlock(const uint64_t& blockNum, const bytes& body,
                             const BlockType& blockType) {
   int ret = -1;  // according to LevelDB::Insert return value
   if (blockType == BlockType::DS) {
     unique_lock<shared_timed_mutex> g(m_mutexDsBlockchain);
     ret = m_dsBlockchainDB->Insert(blockNum, body);
+    m_dsBlockCache.Erase(blockNum);
     LOG_GENERAL(INFO, "Stored DSBlock num = " << blockNum);
   } else if (blockType == BlockType::Tx) {
     unique_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
     ret = m_txBlockchainDB->Insert(blockNum, body);
+    m_txBlockCache.Erase(blockNum);
     LOG_GENERAL(INFO, "Stored TxBlock num = " << blockNum);
   }
   return (ret == 0);
@@ -109,11 +183,330 @@ bool BlockStorage::PutTxBody(const dev::h256& key, const bytes& body) {
   {
     unique_lock<shared_timed_mutex> g(m_mutexTxBody);
     ret = m_txBodyDB->Insert(key, body) && m_txBodyTmpDB->Insert(key, body);
+    m_txBodyCache.Erase(key);
   }
 
   return (ret == 0);
 }
 
+bool BlockStorage::EnqueueTxBody(const dev::h256& key, const bytes& body) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING, "Non lookup node should not trigger this.");
+    return false;
+  }
+
+  if (TX_BODY_WRITE_QUEUE_SIZE == 0) {
+    return PutTxBody(key, body);
+  }
+
+  unique_lock<mutex> g(m_mutexTxBodyQueue);
+  if (!m_txBodyWriterStarted) {
+    auto func = [this]() -> void { WriteQueuedTxBodies(); };
+    DetachedExecutor::GetInstance().RunLongRunning("TxBodyWriter", func);
+    m_txBodyWriterStarted = true;
+  }
+  m_cvTxBodyQueue.wait(g, [this]() {
+    return m_queuedTxBodies.size() < TX_BODY_WRITE_QUEUE_SIZE;
+  });
+  m_queuedTxBodies[key] = body;
+  m_cvTxBodyQueue.notify_all();
+
+  return true;
+}
+
+bool BlockStorage::PutTxnHistory(const TransactionWithReceipt& twr,
+                                 const uint64_t& epochNum) {
+  if (!m_txnHistoryIndexDB) {
+    return true;
+  }
+
+  const Transaction& tx = twr.GetTransaction();
+  const Address sender = tx.GetSenderAddr();
+  leveldb::WriteBatch batch;
+  batch.Put(GetTxnHistoryKey(sender, epochNum, tx.GetTranID()),
+            leveldb::Slice());
+  if (tx.GetToAddr() != Address() && tx.GetToAddr() != sender) {
+    batch.Put(GetTxnHistoryKey(tx.GetToAddr(), epochNum, tx.GetTranID()),
+              leveldb::Slice());
+  }
+
+  unique_lock<shared_timed_mutex> g(m_mutexTxnHistoryIndex);
+  return m_txnHistoryIndexDB->Write(batch);
+}
+
+bool BlockStorage::MergeEventBloom(const uint64_t& blockNum,
+                                   const EventBloom& bloom) {
+  if (!m_eventBloomDB || bloom.IsEmpty()) {
+    return true;
+  }
+
+  const string key = GetBlockNumKey(blockNum);
+
+  // The transactions of a block come in one microblock at a time
+  unique_lock<shared_timed_mutex> g(m_mutexEventBloom);
+  EventBloom merged(bloom);
+  const string stored = m_eventBloomDB->Lookup(key);
+  if (stored.size() == EventBloom::SIZE) {
+    merged.Merge(EventBloom(EventBloom::Bits(
+        reinterpret_cast<const unsigned char*>(stored.data()),
+        EventBloom::Bits::ConstructFromPointer)));
+  }
+  return m_eventBloomDB->Insert(
+             leveldb::Slice(key),
+             leveldb::Slice(
+                 reinterpret_cast<const char*>(merged.GetBits().data()),
+                 EventBloom::SIZE)) == 0;
+}
+
+bool BlockStorage::PutCosigsRewards(const uint64_t& blockNum,
+                                    const bytes& record) {
+  if (!m_cosigsRewardsDB) {
+    return false;
+  }
+
+  unique_lock<shared_timed_mutex> g(m_mutexCosigsRewards);
+  return m_cosigsRewardsDB->Insert(GetBlockNumKey(blockNum), record) == 0;
+}
+
+bool BlockStorage::GetCosigsRewards(const uint64_t& blockNum, bytes& record) {
+  if (!m_cosigsRewardsDB) {
+    return false;
+  }
+
+  string stored;
+  {
+    shared_lock<shared_timed_mutex> g(m_mutexCosigsRewards);
+    stored = m_cosigsRewardsDB->Lookup(GetBlockNumKey(blockNum));
+  }
+  if (stored.empty()) {
+    return false;
+  }
+
+  record = bytes(stored.begin(), stored.end());
+  return true;
+}
+
+bool BlockStorage::GetEventBloom(const uint64_t& blockNum, EventBloom& bloom) {
+  if (!m_eventBloomDB) {
+    return false;
+  }
+
+  string stored;
+  {
+    shared_lock<shared_timed_mutex> g(m_mutexEventBloom);
+    stored = m_eventBloomDB->Lookup(GetBlockNumKey(blockNum));
+  }
+  if (stored.size() != EventBloom::SIZE) {
+    return false;
+  }
+
+  bloom = EventBloom(
+      EventBloom::Bits(reinterpret_cast<const unsigned char*>(stored.data()),
+                       EventBloom::Bits::ConstructFromPointer));
+  return true;
+}
+
+bool BlockStorage::GetTxnHistory(const Address& address,
+                                 const string& startAfter, unsigned int count,
+                                 vector<pair<uint64_t, TxnHash>>& txns,
+                                 string& next) {
+  txns.clear();
+  next.clear();
+  if (!m_txnHistoryIndexDB || (count == 0) ||
+      (!startAfter.empty() && startAfter.size() != TXN_HISTORY_SUFFIX_SIZE)) {
+    return false;
+  }
+
+  const string prefix(reinterpret_cast<const char*>(address.data()),
+                      Address::size);
+
+  shared_lock<shared_timed_mutex> g(m_mutexTxnHistoryIndex);
+  unique_ptr<leveldb::Iterator> it(
+      m_txnHistoryIndexDB->GetDB()->NewIterator(leveldb::ReadOptions()));
+  it->Seek(prefix + startAfter);
+  if (!startAfter.empty() && it->Valid() &&
+      (it->key().ToString() == prefix + startAfter)) {
+    it->Next();
+  }
+
+  for (; it->Valid(); it->Next()) {
+    const string key = it->key().ToString();
+    if ((key.size() != Address::size + TXN_HISTORY_SUFFIX_SIZE) ||
+        (key.compare(0, Address::size, prefix) != 0)) {
+      break;
+    }
+    if (txns.size() == count) {
+      next = GetTxnHistoryKey(address, txns.back().first, txns.back().second)
+                 .substr(Address::size);
+      break;
+    }
+
+    uint64_t epochNum = 0;
+    for (unsigned int i = 0; i < sizeof(uint64_t); i++) {
+      epochNum = (epochNum << 8) |
+                 static_cast<unsigned char>(key[Address::size + i]);
+    }
+    const auto* raw = reinterpret_cast<const unsigned char*>(key.data()) +
+                      Address::size + sizeof(uint64_t);
+    txns.emplace_back(epochNum, TxnHash(bytes(raw, raw + TxnHash::size)));
+  }
+
+  return true;
+}
+
+void BlockStorage::InitTxBodyArchive() {
+  const string dir = STORAGE_PATH + PERSISTENCE_PATH + "/txBodyArchive";
+  if (TX_BODY_RETENTION_DS_EPOCHS > 0 || boost::filesystem::exists(dir)) {
+    m_txBodyArchive = make_unique<TxBodyArchive>(dir);
+  }
+}
+
+bool BlockStorage::ArchiveTxBodies(const uint64_t& oldestKeptEpochNum) {
+  LOG_MARKER();
+
+  if (!m_txBodyArchive) {
+    return false;
+  }
+
+  unique_lock<mutex> g(m_mutexTxBodyArchive, try_to_lock);
+  if (!g.owns_lock()) {
+    LOG_GENERAL(INFO, "Tx bodies are already being archived");
+    return false;
+  }
+
+  FlushTxBodies();
+
+  // One segment per call, named by the first epoch in it
+  uint64_t epochNum = m_txBodyArchive->GetNextEpoch();
+  const uint64_t segmentId = epochNum;
+  uint64_t count = 0;
+  for (; epochNum < oldestKeptEpochNum; epochNum++) {
+    list<MicroBlockSharedPtr> microBlocks;
+    GetRangeMicroBlocks(epochNum, epochNum, 0, numeric_limits<uint32_t>::max(),
+                        microBlocks);
+
+    vector<pair<dev::h256, bytes>> bodies;
+    {
+      shared_lock<shared_timed_mutex> g(m_mutexTxBody);
+      for (const auto& microBlock : microBlocks) {
+        for (const auto& tranHash : microBlock->GetTranHashes()) {
+          const string body = m_txBodyDB->Lookup(tranHash);
+          if (!body.empty()) {
+            bodies.emplace_back(tranHash, bytes(body.begin(), body.end()));
+          }
+        }
+      }
+    }
+
+    // Readers look in the archive after txBodies, so a body has to be
+    // archived before it is deleted
+    if (!m_txBodyArchive->Append(segmentId, bodies)) {
+      LOG_GENERAL(WARNING, "Failed to archive the tx bodies of epoch "
+                               << epochNum);
+      return false;
+    }
+    {
+      unique_lock<shared_timed_mutex> g(m_mutexTxBody);
+      for (const auto& body : bodies) {
+        m_txBodyDB->DeleteKey(body.first);
+        m_txBodyCache.Erase(body.first);
+      }
+    }
+    if (!m_txBodyArchive->PutNextEpoch(epochNum + 1)) {
+      return false;
+    }
+    count += bodies.size();
+  }
+
+  LOG_GENERAL(INFO, "Archived " << count << " tx bodies before epoch "
+                                << oldestKeptEpochNum);
+  return true;
+}
+
+void BlockStorage::WriteQueuedTxBodies() {
+  while (true) {
+    {
+      unique_lock<mutex> g(m_mutexTxBodyQueue);
+      m_cvTxBodyQueue.wait(g, [this]() { return !m_queuedTxBodies.empty(); });
+      m_writingTxBodies.swap(m_queuedTxBodies);
+    }
+    m_cvTxBodyQueue.notify_all();
+
+    // Everything queued so far goes in one batch per db. m_writingTxBodies
+    // is only modified by this thread, under m_mutexTxBodyQueue.
+    {
+      unique_lock<shared_timed_mutex> g(m_mutexTxBody);
+      leveldb::WriteBatch bodyBatch;
+      leveldb::WriteBatch tmpBatch;
+      for (const auto& entry : m_writingTxBodies) {
+        const leveldb::Slice body(
+            reinterpret_cast<const char*>(entry.second.data()),
+            entry.second.size());
+        m_txBodyDB->BatchPut(bodyBatch, entry.first, body);
+        m_txBodyTmpDB->BatchPut(tmpBatch, entry.first, body);
+        m_txBodyCache.Erase(entry.first);
+      }
+      if (!m_txBodyDB->Write(bodyBatch) || !m_txBodyTmpDB->Write(tmpBatch)) {
+        LOG_GENERAL(WARNING, "Failed to write " << m_writingTxBodies.size()
+                                                << " queued tx bodies");
+      }
+    }
+
+    {
+      lock_guard<mutex> g(m_mutexTxBodyQueue);
+      m_writingTxBodies.clear();
+    }
+    m_cvTxBodyQueue.notify_all();
+  }
+}
+
+void BlockStorage::RegisterMemoryStats() {
+  MemoryStats::GetInstance().Register(
+      "BlockCache", [this]() { return GetBlockCacheSizeInBytes(); });
+  MemoryStats::GetInstance().Register(
+      "TxBodyQueue", [this]() { return GetQueuedTxBodiesSizeInBytes(); });
+}
+
+BlockStorage::~BlockStorage() {
+  MemoryStats::GetInstance().Unregister("BlockCache");
+  MemoryStats::GetInstance().Unregister("TxBodyQueue");
+}
+
+size_t BlockStorage::GetBlockCacheSizeInBytes() const {
+  return m_dsBlockCache.GetSizeInBytes() + m_txBlockCache.GetSizeInBytes() +
+         m_microBlockCache.GetSizeInBytes() + m_txBodyCache.GetSizeInBytes();
+}
+
+uint64_t BlockStorage::GetQueuedTxBodiesSizeInBytes() {
+  lock_guard<mutex> g(m_mutexTxBodyQueue);
+  uint64_t sizeInBytes = 0;
+  for (const auto& queue : {&m_queuedTxBodies, &m_writingTxBodies}) {
+    for (const auto& entry : *queue) {
+      sizeInBytes += entry.first.size + entry.second.size();
+    }
+  }
+  return sizeInBytes;
+}
+
+void BlockStorage::FlushTxBodies() {
+  unique_lock<mutex> g(m_mutexTxBodyQueue);
+  m_cvTxBodyQueue.wait(g, [this]() {
+    return m_queuedTxBodies.empty() && m_writingTxBodies.empty();
+  });
+}
+
+bool BlockStorage::GetQueuedTxBody(const dev::h256& key, bytes& body) {
+  lock_guard<mutex> g(m_mutexTxBodyQueue);
+  for (const auto& queue : {&m_queuedTxBodies, &m_writingTxBodies}) {
+    auto it = queue->find(key);
+    if (it != queue->end()) {
+      body = it->second;
+      return true;
+    }
+  }
+  return false;
+}
+
 bool BlockStorage::PutProcessedTxBodyTmp(const dev::h256& key,
                                          const bytes& body) {
   int ret;
@@ -124,12 +517,174 @@ bool BlockStorage::PutProcessedTxBodyTmp(const dev::h256& key,
   return (ret == 0);
 }
 
+namespace {
+// Writes the shard id and serialized body of a pending transaction to batch
+bool BatchPutPendingTxn(LevelDB& db, leveldb::WriteBatch& batch,
+                        const uint32_t& shardId, const Transaction& txn) {
+  bytes value;
+  Serializable::SetNumber<uint32_t>(value, 0, shardId, sizeof(uint32_t));
+  if (!txn.Serialize(value, sizeof(uint32_t))) {
+    return false;
+  }
+  db.BatchPut(batch, txn.GetTranID(),
+              leveldb::Slice(reinterpret_cast<const char*>(value.data()),
+                             value.size()));
+  return true;
+}
+}  // namespace
+
+bool BlockStorage::PutPendingTxns(const vector<Transaction>& txns,
+                                  const uint32_t& shardId) {
+  leveldb::WriteBatch batch;
+  for (const auto& txn : txns) {
+    if (!BatchPutPendingTxn(*m_pendingTxnDB, batch, shardId, txn)) {
+      LOG_GENERAL(WARNING, "Failed to serialize txn " << txn.GetTranID());
+    }
+  }
+
+  unique_lock<shared_timed_mutex> g(m_mutexPendingTxn);
+  return m_pendingTxnDB->Write(batch);
+}
+
+bool BlockStorage::RewritePendingTxns(
+    const vector<pair<uint32_t, Transaction>>& txns) {
+  leveldb::WriteBatch batch;
+  for (const auto& entry : txns) {
+    if (!BatchPutPendingTxn(*m_pendingTxnDB, batch, entry.first,
+                            entry.second)) {
+      LOG_GENERAL(WARNING,
+                  "Failed to serialize txn " << entry.second.GetTranID());
+    }
+  }
+
+  unique_lock<shared_timed_mutex> g(m_mutexPendingTxn);
+  return m_pendingTxnDB->ResetDB() && m_pendingTxnDB->Write(batch);
+}
+
+bool BlockStorage::GetAllPendingTxns(
+    vector<pair<uint32_t, Transaction>>& txns) {
+  LOG_MARKER();
+
+  shared_lock<shared_timed_mutex> g(m_mutexPendingTxn);
+  unique_ptr<leveldb::Iterator> it(
+      m_pendingTxnDB->GetDB()->NewIterator(leveldb::ReadOptions()));
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    const bytes value(it->value().data(),
+                      it->value().data() + it->value().size());
+    Transaction txn;
+    if (value.size() < sizeof(uint32_t) ||
+        !txn.Deserialize(value, sizeof(uint32_t))) {
+      LOG_GENERAL(WARNING, "Skipped a pending txn that cannot be parsed");
+      continue;
+    }
+    txns.emplace_back(
+        Serializable::GetNumber<uint32_t>(value, 0, sizeof(uint32_t)),
+        move(txn));
+  }
+  return it->status().ok();
+}
+
 bool BlockStorage::PutMicroBlock(const BlockHash& blockHash,
                                  const bytes& body) {
   unique_lock<shared_timed_mutex> g(m_mutexMicroBlock);
   int ret = m_microBlockDB->Insert(blockHash, body);
+  m_microBlockCache.Erase(blockHash);
 
-  return (ret == 0);
+  return (ret == 0) && UpdateMicroBlockIndex(blockHash, body, false);
+}
+
+string BlockStorage::GetMicroBlockIndexKey(const uint64_t& epochNum,
+                                           const uint32_t& shardId,
+                                           const BlockHash* blockHash) {
+  // Big-endian, so that the keys sort by epoch and then by shard id
+  string key(MICROBLOCK_INDEX_PREFIX_SIZE, '\0');
+  for (unsigned int i = 0; i < sizeof(uint64_t); i++) {
+    key[i] = static_cast<char>(epochNum >> (8 * (sizeof(uint64_t) - 1 - i)));
+  }
+  for (unsigned int i = 0; i < sizeof(uint32_t); i++) {
+    key[sizeof(uint64_t) + i] =
+        static_cast<char>(shardId >> (8 * (sizeof(uint32_t) - 1 - i)));
+  }
+  if (blockHash != nullptr) {
+    key.append(blockHash->begin(), blockHash->end());
+  }
+  return key;
+}
+
+bool BlockStorage::UpdateMicroBlockIndex(const BlockHash& blockHash,
+                                         const bytes& body, bool remove) {
+  MicroBlock microBlock;
+  if (!microBlock.Deserialize(body, 0)) {
+    LOG_GENERAL(WARNING, "Failed to index MicroBlock " << blockHash);
+    return false;
+  }
+
+  const string key =
+      GetMicroBlockIndexKey(microBlock.GetHeader().GetEpochNum(),
+                            microBlock.GetHeader().GetShardId(), &blockHash);
+  if (remove) {
+    return m_microBlockIndexDB->DeleteKey(key) == 0;
+  }
+  return m_microBlockIndexDB->Insert(leveldb::Slice(key), leveldb::Slice()) ==
+         0;
+}
+
+bool BlockStorage::CompleteMicroBlockIndex() {
+  unique_lock<shared_timed_mutex> g(m_mutexMicroBlock);
+
+  if (m_microBlockIndexComplete) {
+    return true;
+  }
+
+  if (!m_microBlockIndexDB->Exists(MICROBLOCK_INDEX_COMPLETE_KEY)) {
+    LOG_GENERAL(INFO, "Indexing the stored MicroBlocks");
+
+    unique_ptr<leveldb::Iterator> it(
+        m_microBlockDB->GetDB()->NewIterator(leveldb::ReadOptions()));
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+      BlockHash blockHash;
+      if (!LevelDB::DecodeKey(it->key(), blockHash)) {
+        continue;
+      }
+      const string blockString = it->value().ToString();
+      if (!UpdateMicroBlockIndex(blockHash,
+                                 bytes(blockString.begin(), blockString.end()),
+                                 false)) {
+        return false;
+      }
+    }
+
+    if (m_microBlockIndexDB->Insert(
+            leveldb::Slice(MICROBLOCK_INDEX_COMPLETE_KEY), leveldb::Slice()) !=
+        0) {
+      return false;
+    }
+  }
+
+  m_microBlockIndexComplete = true;
+  return true;
+}
+
+void BlockStorage::StartKeyMigration() {
+  vector<shared_ptr<LevelDB>> dbs;
+  for (const auto& db :
+       {m_dsBlockchainDB, m_txBlockchainDB, m_txBodyDB, m_txBodyTmpDB,
+        m_microBlockDB, m_VCBlockDB, m_fallbackBlockDB, m_blockLinkDB,
+        m_stateDeltaDB}) {
+    if (db && db->IsMigratingKeys()) {
+      dbs.emplace_back(db);
+    }
+  }
+  if (dbs.empty()) {
+    return;
+  }
+
+  auto func = [dbs]() mutable -> void {
+    for (const auto& db : dbs) {
+      db->MigrateKeys();
+    }
+  };
+  DetachedFunction(1, func);
 }
 
 bool BlockStorage::InitiateHistoricalDB(const string& path) {
@@ -184,18 +739,19 @@ bool BlockStorage::GetMicroBlock(const BlockHash& blockHash,
                                  MicroBlockSharedPtr& microblock) {
   LOG_MARKER();
 
-  string blockString;
-
-  {
-    shared_lock<shared_timed_mutex> g(m_mutexMicroBlock);
-    blockString = m_microBlockDB->Lookup(blockHash);
+  if (m_microBlockCache.Lookup(blockHash, microblock)) {
+    return true;
   }
 
+  // Cached under the lock, so that a write in between cannot be undone
+  shared_lock<shared_timed_mutex> g(m_mutexMicroBlock);
+  const string blockString = m_microBlockDB->Lookup(blockHash);
   if (blockString.empty()) {
     return false;
   }
   microblock =
       make_shared<MicroBlock>(bytes(blockString.begin(), blockString.end()), 0);
+  m_microBlockCache.Insert(blockHash, microblock, blockString.size());
 
   return true;
 }
@@ -212,34 +768,75 @@ bool BlockStorage::GetRangeMicroBlocks(const uint64_t lowEpochNum,
                                        list<MicroBlockSharedPtr>& blocks) {
   LOG_MARKER();
 
+  if ((lowEpochNum > hiEpochNum) || (loShardId > hiShardId)) {
+    return false;
+  }
+
+  if (!m_microBlockIndexComplete && !CompleteMicroBlockIndex()) {
+    LOG_GENERAL(WARNING, "Failed to index the stored MicroBlocks");
+    return false;
+  }
+
   shared_lock<shared_timed_mutex> g(m_mutexMicroBlock);
 
-  leveldb::Iterator* it =
-      m_microBlockDB->GetDB()->NewIterator(leveldb::ReadOptions());
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    string bns = it->key().ToString();
-    string blockString = it->value().ToString();
-    if (blockString.empty()) {
-      LOG_GENERAL(WARNING, "Lost one block in the chain");
-      delete it;
-      return false;
+  // Seek to (epoch, loShardId) of each epoch in the range and read on until
+  // hiShardId is passed
+  unique_ptr<leveldb::Iterator> it(
+      m_microBlockIndexDB->GetDB()->NewIterator(leveldb::ReadOptions()));
+  uint64_t epochNum = lowEpochNum;
+  it->Seek(GetMicroBlockIndexKey(epochNum, loShardId, nullptr));
+  while (it->Valid()) {
+    const leveldb::Slice key = it->key();
+    if (key.size() != MICROBLOCK_INDEX_PREFIX_SIZE + BlockHash::size) {
+      it->Next();
+      continue;
+    }
+
+    const auto* raw = reinterpret_cast<const unsigned char*>(key.data());
+    epochNum = 0;
+    for (unsigned int i = 0; i < sizeof(uint64_t); i++) {
+      epochNum = (epochNum << 8) | raw[i];
+    }
+    uint32_t shardId = 0;
+    for (unsigned int i = sizeof(uint64_t); i < MICROBLOCK_INDEX_PREFIX_SIZE;
+         i++) {
+      shardId = (shardId << 8) | raw[i];
     }
-    MicroBlockSharedPtr block = MicroBlockSharedPtr(
-        new MicroBlock(bytes(blockString.begin(), blockString.end()), 0));
 
-    if (block->GetHeader().GetEpochNum() < lowEpochNum ||
-        block->GetHeader().GetEpochNum() > hiEpochNum ||
-        block->GetHeader().GetShardId() < loShardId ||
-        block->GetHeader().GetShardId() > hiShardId) {
+    if (epochNum > hiEpochNum) {
+      break;
+    }
+    if (shardId < loShardId) {
+      it->Seek(GetMicroBlockIndexKey(epochNum, loShardId, nullptr));
+      continue;
+    }
+    if (shardId > hiShardId) {
+      if (epochNum == hiEpochNum) {
+        break;
+      }
+      it->Seek(GetMicroBlockIndexKey(epochNum + 1, loShardId, nullptr));
       continue;
     }
 
+    const BlockHash blockHash(
+        bytes(raw + MICROBLOCK_INDEX_PREFIX_SIZE, raw + key.size()));
+    MicroBlockSharedPtr block;
+    if (!m_microBlockCache.Lookup(blockHash, block)) {
+      string blockString = m_microBlockDB->Lookup(blockHash);
+      if (blockString.empty()) {
+        LOG_GENERAL(WARNING, "Lost one block in the chain");
+        return false;
+      }
+      block = MicroBlockSharedPtr(
+          new MicroBlock(bytes(blockString.begin(), blockString.end()), 0));
+      m_microBlockCache.Insert(blockHash, block, blockString.size());
+    }
+
     blocks.emplace_back(block);
-    LOG_GENERAL(INFO, "Retrievd MicroBlock Num:" << bns);
+    LOG_GENERAL(INFO, "Retrievd MicroBlock Num:" << blockHash);
+    it->Next();
   }
 
-  delete it;
-
   if (blocks.empty()) {
     LOG_GENERAL(INFO, "Disk has no MicroBlock matching the criteria");
     return false;
@@ -300,12 +897,12 @@ bool BlockStorage::GetTempStateInBatch(leveldb::Iterator*& iter,
 
 bool BlockStorage::GetDSBlock(const uint64_t& blockNum,
                               DSBlockSharedPtr& block) {
-  string blockString;
-  {
-    shared_lock<shared_timed_mutex> g(m_mutexDsBlockchain);
-    blockString = m_dsBlockchainDB->Lookup(blockNum);
+  if (m_dsBlockCache.Lookup(blockNum, block)) {
+    return true;
   }
 
+  shared_lock<shared_timed_mutex> g(m_mutexDsBlockchain);
+  const string blockString = m_dsBlockchainDB->Lookup(blockNum);
   if (blockString.empty()) {
     return false;
   }
@@ -314,6 +911,7 @@ bool BlockStorage::GetDSBlock(const uint64_t& blockNum,
   // LOG_GENERAL(INFO, blockString.length());
   block = DSBlockSharedPtr(
       new DSBlock(bytes(blockString.begin(), blockString.end()), 0));
+  m_dsBlockCache.Insert(blockNum, block, blockString.size());
 
   return true;
 }
@@ -343,9 +941,22 @@ bool BlockStorage::ReleaseDB() {
     unique_lock<shared_timed_mutex> g(m_mutexTxBody);
     m_txBodyDB.reset();
   }
+  {
+    unique_lock<shared_timed_mutex> g(m_mutexTxnHistoryIndex);
+    m_txnHistoryIndexDB.reset();
+  }
+  {
+    unique_lock<shared_timed_mutex> g(m_mutexEventBloom);
+    m_eventBloomDB.reset();
+  }
+  {
+    unique_lock<shared_timed_mutex> g(m_mutexCosigsRewards);
+    m_cosigsRewardsDB.reset();
+  }
   {
     unique_lock<shared_timed_mutex> g(m_mutexMicroBlock);
     m_microBlockDB.reset();
+    m_microBlockIndexDB.reset();
   }
   {
     unique_lock<shared_timed_mutex> g(m_mutexVCBlock);
@@ -354,6 +965,7 @@ bool BlockStorage::ReleaseDB() {
   {
     unique_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
     m_txBlockchainDB.reset();
+    m_txnCountDB.reset();
   }
   {
     unique_lock<shared_timed_mutex> g(m_mutexDsBlockchain);
@@ -426,21 +1038,79 @@ bool BlockStorage::GetBlockLink(const uint64_t& index,
 
 bool BlockStorage::GetTxBlock(const uint64_t& blockNum,
                               TxBlockSharedPtr& block) {
-  string blockString;
-  {
-    shared_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
-    blockString = m_txBlockchainDB->Lookup(blockNum);
+  if (m_txBlockCache.Lookup(blockNum, block)) {
+    return true;
   }
+
+  shared_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
+  const string blockString = m_txBlockchainDB->Lookup(blockNum);
   if (blockString.empty()) {
     return false;
   }
 
   block = TxBlockSharedPtr(
       new TxBlock(bytes(blockString.begin(), blockString.end()), 0));
+  m_txBlockCache.Insert(blockNum, block, blockString.size());
 
   return true;
 }
 
+bool BlockStorage::GetRangeTxBlocks(const uint64_t& lowBlockNum,
+                                    const uint64_t& hiBlockNum,
+                                    vector<TxBlockSharedPtr>& blocks) {
+  blocks.clear();
+  if (lowBlockNum > hiBlockNum) {
+    return false;
+  }
+
+  uint64_t blockNum = lowBlockNum;
+  TxBlockSharedPtr block;
+  while (m_txBlockCache.Lookup(blockNum, block)) {
+    blocks.emplace_back(block);
+    if (blockNum == hiBlockNum) {
+      return true;
+    }
+    blockNum++;
+  }
+
+  shared_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
+  if (!m_txBlockchainDB->IsBinaryKeys()) {
+    g.unlock();
+    for (; GetTxBlock(blockNum, block); blockNum++) {
+      blocks.emplace_back(block);
+      if (blockNum == hiBlockNum) {
+        break;
+      }
+    }
+    return !blocks.empty();
+  }
+
+  unique_ptr<leveldb::Iterator> it(
+      m_txBlockchainDB->GetDB()->NewIterator(leveldb::ReadOptions()));
+  it->Seek(GetBlockNumKey(blockNum));
+  for (; it->Valid(); it->Next()) {
+    uint64_t keyBlockNum = 0;
+    if (!LevelDB::DecodeKey(it->key(), keyBlockNum) ||
+        (keyBlockNum != blockNum)) {
+      break;
+    }
+
+    if (!m_txBlockCache.Lookup(blockNum, block)) {
+      const leveldb::Slice value = it->value();
+      block = make_shared<TxBlock>(
+          bytes(value.data(), value.data() + value.size()), 0);
+      m_txBlockCache.Insert(blockNum, block, value.size());
+    }
+    blocks.emplace_back(block);
+    if (blockNum == hiBlockNum) {
+      break;
+    }
+    blockNum++;
+  }
+
+  return !blocks.empty();
+}
+
 bool BlockStorage::GetLatestTxBlock(TxBlockSharedPtr& block) {
   uint64_t latestTxBlockNum = 0;
 
@@ -449,7 +1119,10 @@ bool BlockStorage::GetLatestTxBlock(TxBlockSharedPtr& block) {
     leveldb::Iterator* it =
         m_txBlockchainDB->GetDB()->NewIterator(leveldb::ReadOptions());
     for (it->SeekToFirst(); it->Valid(); it->Next()) {
-      uint64_t blockNum = boost::lexical_cast<uint64_t>(it->key().ToString());
+      uint64_t blockNum = 0;
+      if (!LevelDB::DecodeKey(it->key(), blockNum)) {
+        continue;
+      }
       if (blockNum > latestTxBlockNum) {
         latestTxBlockNum = blockNum;
       }
@@ -459,32 +1132,107 @@ bool BlockStorage::GetLatestTxBlock(TxBlockSharedPtr& block) {
   return GetTxBlock(latestTxBlockNum, block);
 }
 
-bool BlockStorage::GetTxBody(const dev::h256& key, TxBodySharedPtr& body) {
-  std::string bodyString;
+bool BlockStorage::PutTxnCount(const uint64_t& blockNum,
+                               const uint128_t& numTxns,
+                               const uint64_t& dsBlockNum) {
+  // (numTxns, dsBlockNum), both big-endian
+  string value(TXN_COUNT_SIZE, '\0');
+  for (unsigned int i = 0; i < TXN_COUNT_SIZE; i++) {
+    value[i] = static_cast<char>(
+        static_cast<unsigned int>((numTxns >> (8 * (TXN_COUNT_SIZE - 1 - i))) &
+                                  0xff));
+  }
+  value += GetBlockNumKey(dsBlockNum);
 
+  unique_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
+  return m_txnCountDB->Insert(leveldb::Slice(GetBlockNumKey(blockNum)),
+                              leveldb::Slice(value)) == 0;
+}
+
+bool BlockStorage::GetTxnCount(const uint64_t& blockNum, uint128_t& numTxns,
+                               uint64_t& dsBlockNum) {
+  string value;
   {
-    shared_lock<shared_timed_mutex> g(m_mutexTxBody);
-    bodyString = m_txBodyDB->Lookup(key);
+    shared_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
+    value = m_txnCountDB->Lookup(GetBlockNumKey(blockNum));
+  }
+  if (value.size() != TXN_COUNT_SIZE + sizeof(uint64_t)) {
+    return false;
   }
 
-  if (bodyString.empty()) {
+  numTxns = 0;
+  for (unsigned int i = 0; i < TXN_COUNT_SIZE; i++) {
+    numTxns = (numTxns << 8) | static_cast<unsigned char>(value[i]);
+  }
+  dsBlockNum = 0;
+  for (unsigned int i = TXN_COUNT_SIZE; i < value.size(); i++) {
+    dsBlockNum = (dsBlockNum << 8) | static_cast<unsigned char>(value[i]);
+  }
+  return true;
+}
+
+bool BlockStorage::GetLastTxnCountBlockNum(uint64_t& blockNum) {
+  shared_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
+  unique_ptr<leveldb::Iterator> it(
+      m_txnCountDB->GetDB()->NewIterator(leveldb::ReadOptions()));
+  it->SeekToLast();
+  if (!it->Valid() || (it->key().size() != sizeof(uint64_t))) {
     return false;
   }
+
+  blockNum = 0;
+  for (unsigned int i = 0; i < sizeof(uint64_t); i++) {
+    blockNum =
+        (blockNum << 8) | static_cast<unsigned char>(it->key().data()[i]);
+  }
+  return true;
+}
+
+bool BlockStorage::GetTxBody(const dev::h256& key, TxBodySharedPtr& body) {
+  if (m_txBodyCache.Lookup(key, body)) {
+    return true;
+  }
+
+  bytes queuedBody;
+  if (GetQueuedTxBody(key, queuedBody)) {
+    body = make_shared<TransactionWithReceipt>(queuedBody, 0);
+    return true;
+  }
+
+  shared_lock<shared_timed_mutex> g(m_mutexTxBody);
+  const std::string bodyString = m_txBodyDB->Lookup(key);
+  if (bodyString.empty()) {
+    bytes archivedBody;
+    if (!m_txBodyArchive || !m_txBodyArchive->Get(key, archivedBody)) {
+      return false;
+    }
+    body = make_shared<TransactionWithReceipt>(archivedBody, 0);
+    m_txBodyCache.Insert(key, body, archivedBody.size());
+    return true;
+  }
   body = TxBodySharedPtr(new TransactionWithReceipt(
       bytes(bodyString.begin(), bodyString.end()), 0));
+  m_txBodyCache.Insert(key, body, bodyString.size());
 
   return true;
 }
 
-bool BlockStorage::CheckTxBody(const dev::h256& key) {
+bool BlockStorage::CheckTxBody(const dev::h256& key) {
+  bytes queuedBody;
+  if (GetQueuedTxBody(key, queuedBody)) {
+    return true;
+  }
+
   shared_lock<shared_timed_mutex> g(m_mutexTxBody);
-  return m_txBodyDB->Exists(key);
+  return m_txBodyDB->Exists(key) ||
+         (m_txBodyArchive && m_txBodyArchive->Exists(key));
 }
 
 bool BlockStorage::DeleteDSBlock(const uint64_t& blocknum) {
   LOG_GENERAL(INFO, "Delete DSBlock Num: " << blocknum);
   unique_lock<shared_timed_mutex> g(m_mutexDsBlockchain);
   int ret = m_dsBlockchainDB->DeleteKey(blocknum);
+  m_dsBlockCache.Erase(blocknum);
   return (ret == 0);
 }
 
@@ -504,6 +1252,8 @@ bool BlockStorage::DeleteTxBlock(const uint64_t& blocknum) {
   LOG_GENERAL(INFO, "Delete TxBlock Num: " << blocknum);
   unique_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
   int ret = m_txBlockchainDB->DeleteKey(blocknum);
+  m_txBlockCache.Erase(blocknum);
+  m_txnCountDB->DeleteKey(GetBlockNumKey(blocknum));
   return (ret == 0);
 }
 
@@ -513,8 +1263,10 @@ bool BlockStorage::DeleteTxBody(const dev::h256& key) {
     LOG_GENERAL(WARNING, "Non lookup node should not trigger this");
     return false;
   } else {
+    FlushTxBodies();
     unique_lock<shared_timed_mutex> g(m_mutexTxBody);
     ret = m_txBodyDB->DeleteKey(key);
+    m_txBodyCache.Erase(key);
   }
 
   return (ret == 0);
@@ -522,7 +1274,13 @@ bool BlockStorage::DeleteTxBody(const dev::h256& key) {
 
 bool BlockStorage::DeleteMicroBlock(const BlockHash& blockHash) {
   unique_lock<shared_timed_mutex> g(m_mutexMicroBlock);
+  const string blockString = m_microBlockDB->Lookup(blockHash);
+  if (!blockString.empty()) {
+    UpdateMicroBlockIndex(blockHash,
+                          bytes(blockString.begin(), blockString.end()), true);
+  }
   int ret = m_microBlockDB->DeleteKey(blockHash);
+  m_microBlockCache.Erase(blockHash);
 
   return (ret == 0);
 }
@@ -560,7 +1318,6 @@ bool BlockStorage::GetAllDSBlocks(std::list<DSBlockSharedPtr>& blocks) {
   leveldb::Iterator* it =
       m_dsBlockchainDB->GetDB()->NewIterator(leveldb::ReadOptions());
   for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    string bns = it->key().ToString();
     string blockString = it->value().ToString();
     if (blockString.empty()) {
       LOG_GENERAL(WARNING, "Lost one block in the chain");
@@ -571,7 +1328,8 @@ bool BlockStorage::GetAllDSBlocks(std::list<DSBlockSharedPtr>& blocks) {
     DSBlockSharedPtr block = DSBlockSharedPtr(
         new DSBlock(bytes(blockString.begin(), blockString.end()), 0));
     blocks.emplace_back(block);
-    LOG_GENERAL(INFO, "Retrievd DsBlock Num:" << bns);
+    LOG_GENERAL(INFO,
+                "Retrievd DsBlock Num:" << block->GetHeader().GetBlockNum());
   }
 
   delete it;
@@ -589,26 +1347,54 @@ bool BlockStorage::GetAllTxBlocks(std::deque<TxBlockSharedPtr>& blocks) {
 
   shared_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
 
+  // The blocks are read in chunks, each decoded on RETRIEVER_THREADS threads
+  const size_t window = RETRIEVER_THREADS * 16;
+  const size_t chunkSize = max<size_t>(window, 1) * 64;
+  vector<string> blockStrings;
+  blockStrings.reserve(chunkSize);
+
+  auto decodeChunk = [&]() -> bool {
+    size_t applied = 0;
+    const bool decoded = RunOrderedPipeline<TxBlockSharedPtr>(
+        "DecodeTxBlocks", blockStrings.size(), RETRIEVER_THREADS, window,
+        [&](size_t i, TxBlockSharedPtr& block) {
+          const string& blockString = blockStrings.at(i);
+          block = make_shared<TxBlock>(
+              bytes(blockString.begin(), blockString.end()), 0);
+          return true;
+        },
+        [&](size_t, TxBlockSharedPtr& block) {
+          blocks.emplace_back(move(block));
+          return true;
+        },
+        applied);
+    blockStrings.clear();
+    return decoded;
+  };
+
   leveldb::Iterator* it =
       m_txBlockchainDB->GetDB()->NewIterator(leveldb::ReadOptions());
-  uint64_t count = 0;
   for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    string bns = it->key().ToString();
     string blockString = it->value().ToString();
     if (blockString.empty()) {
       LOG_GENERAL(WARNING, "Lost one block in the chain");
       delete it;
       return false;
     }
-    TxBlockSharedPtr block = TxBlockSharedPtr(
-        new TxBlock(bytes(blockString.begin(), blockString.end()), 0));
-    blocks.emplace_back(block);
-    count++;
+    blockStrings.emplace_back(move(blockString));
+    if ((blockStrings.size() == chunkSize) && !decodeChunk()) {
+      delete it;
+      return false;
+    }
   }
-  LOG_GENERAL(INFO, "Retrievd " << count << " TxBlocks");
 
   delete it;
 
+  if (!decodeChunk()) {
+    return false;
+  }
+  LOG_GENERAL(INFO, "Retrievd " << blocks.size() << " TxBlocks");
+
   if (blocks.empty()) {
     LOG_GENERAL(INFO, "Disk has no TxBlock");
     return false;
@@ -627,18 +1413,18 @@ bool BlockStorage::GetAllTxBodiesTmp(std::list<TxnHash>& txnHashes) {
 
   LOG_MARKER();
 
+  FlushTxBodies();
   shared_lock<shared_timed_mutex> g(m_mutexTxBodyTmp);
 
   leveldb::Iterator* it =
       m_txBodyTmpDB->GetDB()->NewIterator(leveldb::ReadOptions());
   for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    string hashString = it->key().ToString();
-    if (hashString.empty()) {
+    TxnHash txnHash;
+    if (!LevelDB::DecodeKey(it->key(), txnHash)) {
       LOG_GENERAL(WARNING, "Lost one Tmp txBody Hash");
       delete it;
       return false;
     }
-    TxnHash txnHash(hashString);
     txnHashes.emplace_back(txnHash);
   }
 
@@ -707,11 +1493,35 @@ bool BlockStorage::PutLatestEpochStatesUpdated(const uint64_t& epochNum) {
   return (ret == 0);
 }
 
+namespace {
+const string STATE_ROOT_CHECKPOINT_PREFIX = "STATEROOT_CHECKPOINT_";
+const string LATEST_STATE_ROOT_CHECKPOINT = "LATEST_STATEROOT_CHECKPOINT";
+}  // namespace
+
+bool BlockStorage::PutStateRootCheckpoint(const uint64_t& blockNum,
+                                          const StateHash& root) {
+  LOG_MARKER();
+  unique_lock<shared_timed_mutex> g(m_mutexStateRoot);
+  if (m_stateRootDB->Insert(STATE_ROOT_CHECKPOINT_PREFIX + to_string(blockNum),
+                            root.asBytes()) != 0) {
+    return false;
+  }
+  return m_stateRootDB->Insert(
+             LATEST_STATE_ROOT_CHECKPOINT,
+             DataConversion::StringToCharArray(to_string(blockNum))) == 0;
+}
+
 bool BlockStorage::PutEpochFin(const uint64_t& epochNum) {
   LOG_MARKER();
-  return BlockStorage::GetBlockStorage().PutMetadata(
-      MetaType::EPOCHFIN,
-      DataConversion::StringToCharArray(to_string(epochNum)));
+  // The bodies of the epoch have to be written before it is marked as done
+  FlushTxBodies();
+  if (!BlockStorage::GetBlockStorage().PutMetadata(
+          MetaType::EPOCHFIN,
+          DataConversion::StringToCharArray(to_string(epochNum)))) {
+    return false;
+  }
+  PutWarmRestartMarker(epochNum);
+  return true;
 }
 
 bool BlockStorage::GetMetadata(MetaType type, bytes& data, bool muteLog) {
@@ -777,6 +1587,44 @@ bool BlockStorage::GetLatestEpochStatesUpdated(uint64_t& epochNum) {
   return true;
 }
 
+bool BlockStorage::GetStateRootCheckpoint(const uint64_t& blockNum,
+                                          StateHash& root) {
+  string rootStr;
+  {
+    shared_lock<shared_timed_mutex> g(m_mutexStateRoot);
+    rootStr = m_stateRootDB->Lookup(STATE_ROOT_CHECKPOINT_PREFIX +
+                                    to_string(blockNum));
+  }
+
+  if (rootStr.size() != StateHash::size) {
+    return false;
+  }
+  root = StateHash(bytes(rootStr.begin(), rootStr.end()));
+  return true;
+}
+
+bool BlockStorage::GetLatestStateRootCheckpoint(uint64_t& blockNum,
+                                                StateHash& root) {
+  string blockNumStr;
+  {
+    shared_lock<shared_timed_mutex> g(m_mutexStateRoot);
+    blockNumStr = m_stateRootDB->Lookup(LATEST_STATE_ROOT_CHECKPOINT);
+  }
+
+  if (blockNumStr.empty()) {
+    LOG_GENERAL(INFO, "No state root checkpoint found");
+    return false;
+  }
+
+  try {
+    blockNum = stoull(blockNumStr);
+  } catch (...) {
+    LOG_GENERAL(WARNING, "blockNumStr is not numeric");
+    return false;
+  }
+  return GetStateRootCheckpoint(blockNum, root);
+}
+
 bool BlockStorage::GetEpochFin(uint64_t& epochNum) {
   bytes epochFinBytes;
   if (BlockStorage::GetBlockStorage().GetMetadata(MetaType::EPOCHFIN,
@@ -977,6 +1825,340 @@ bool BlockStorage::GetStateDelta(const uint64_t& finalBlockNum,
   return found;
 }
 
+bool BlockStorage::CommitEpoch(const EpochCommit& epochCommit) {
+  LOG_MARKER();
+
+  if (epochCommit.Empty()) {
+    return true;
+  }
+
+  EpochPerf::Scope perf(EpochPerf::COMMIT);
+
+  // Pending tx bodies are older than the epoch and have to survive it
+  FlushTxBodies();
+
+  const string epochFinKey = to_string((int)MetaType::EPOCHFIN);
+  string epochFin;
+  string journal;
+  for (const auto& write : epochCommit.m_writes) {
+    if (get<0>(write) == META && get<1>(write) == epochFinKey) {
+      epochFin = get<2>(write);
+    }
+    journal.push_back(static_cast<char>(get<0>(write)));
+    AppendJournalField(journal, get<1>(write));
+    AppendJournalField(journal, get<2>(write));
+  }
+
+  // The only synced write, as it alone has to survive a crash for all of the
+  // writes to
+  leveldb::WriteOptions syncOptions;
+  syncOptions.sync = true;
+  {
+    unique_lock<shared_timed_mutex> g(m_mutexMetadata);
+    if (!m_metadataDB->GetDB()
+             ->Put(syncOptions, EPOCH_COMMIT_JOURNAL_KEY, journal)
+             .ok()) {
+      LOG_GENERAL(WARNING, "Failed to journal the epoch commit");
+      return false;
+    }
+  }
+
+  if (!ApplyEpochJournal(journal)) {
+    return false;
+  }
+
+  const uint64_t cacheHits = m_dsBlockCache.GetHits() +
+                             m_txBlockCache.GetHits() +
+                             m_microBlockCache.GetHits() +
+                             m_txBodyCache.GetHits();
+  const uint64_t cacheMisses = m_dsBlockCache.GetMisses() +
+                               m_txBlockCache.GetMisses() +
+                               m_microBlockCache.GetMisses() +
+                               m_txBodyCache.GetMisses();
+  const size_t cacheBytes = GetBlockCacheSizeInBytes();
+  LOG_GENERAL(INFO, "Block cache hits: " << cacheHits << " misses: "
+                                         << cacheMisses
+                                         << " bytes: " << cacheBytes);
+
+  {
+    unique_lock<shared_timed_mutex> g(m_mutexMetadata);
+    if (m_metadataDB->DeleteKey(EPOCH_COMMIT_JOURNAL_KEY) != 0) {
+      return false;
+    }
+  }
+
+  if (!epochFin.empty()) {
+    uint64_t epochNum = 0;
+    try {
+      epochNum = std::stoull(epochFin);
+    } catch (...) {
+      LOG_GENERAL(WARNING,
+                  "EPOCHFIN cannot be parsed as uint64_t " << epochFin);
+      return true;
+    }
+    PutWarmRestartMarker(epochNum);
+    if (CHECKPOINT_INTERVAL_IN_EPOCHS > 0 &&
+        epochNum % CHECKPOINT_INTERVAL_IN_EPOCHS == 0) {
+      PublishCheckpoint(epochNum);
+    }
+  }
+  return true;
+}
+
+void BlockStorage::PutWarmRestartMarker(const uint64_t& epochNum) {
+  // Renamed over the marker, so that the daemon never reads a partial one
+  const string tmpFile = WARM_RESTART_FILE + ".tmp";
+  {
+    ofstream marker(tmpFile, ios::out | ios::trunc);
+    marker << epochNum << endl;
+    if (!marker) {
+      LOG_GENERAL(WARNING, "Failed to write " << tmpFile);
+      return;
+    }
+  }
+
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmpFile, WARM_RESTART_FILE, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING,
+                "Failed to rename " << tmpFile << " error: " << ec.message());
+  }
+}
+
+void BlockStorage::ClearWarmRestartMarker() {
+  boost::system::error_code ec;
+  boost::filesystem::remove(WARM_RESTART_FILE, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to remove " << WARM_RESTART_FILE
+                                             << " error: " << ec.message());
+  }
+}
+
+bool BlockStorage::PublishCheckpoint(const uint64_t& epochNum) {
+  LOG_MARKER();
+
+  namespace fs = boost::filesystem;
+  const fs::path root(STORAGE_PATH + CHECKPOINT_PATH);
+  const fs::path dir = root / to_string(epochNum);
+  const fs::path tmpDir = root / (to_string(epochNum) + ".tmp");
+  const auto start = chrono::steady_clock::now();
+
+  boost::system::error_code ec;
+  fs::remove_all(tmpDir, ec);
+
+  // The historical dbs are read from elsewhere and are left out
+  const vector<shared_ptr<LevelDB>> dbs = {
+      m_metadataDB,          m_dsBlockchainDB,        m_txBlockchainDB,
+      m_txnCountDB,          m_txBodyDB,              m_txnHistoryIndexDB,
+      m_eventBloomDB,        m_microBlockDB,          m_microBlockIndexDB,
+      m_txBodyTmpDB,         m_dsCommitteeDB,         m_VCBlockDB,
+      m_fallbackBlockDB,     m_blockLinkDB,           m_shardStructureDB,
+      m_stateDeltaDB,        m_tempStateDB,           m_processedTxnTmpDB,
+      m_diagnosticDBNodes,   m_diagnosticDBCoinbase,  m_diagnosticDBEpochPerf,
+      m_stateRootDB,         m_pendingTxnDB,          m_cosigsRewardsDB};
+  for (const auto& db : dbs) {
+    if (db && !db->Checkpoint((tmpDir / PERSISTENCE_PATH).string())) {
+      fs::remove_all(tmpDir, ec);
+      return false;
+    }
+  }
+
+  // Renamed once complete, so that a reader never opens a partial checkpoint
+  fs::remove_all(dir, ec);
+  fs::rename(tmpDir, dir, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to rename " << tmpDir.string()
+                                             << " error: " << ec.message());
+    fs::remove_all(tmpDir, ec);
+    return false;
+  }
+
+  const fs::path latestFile = root / CHECKPOINT_LATEST_FILE;
+  const fs::path latestTmpFile = root / (CHECKPOINT_LATEST_FILE + ".tmp");
+  {
+    ofstream latest(latestTmpFile.string(), ios::out | ios::trunc);
+    latest << epochNum << endl;
+  }
+  fs::rename(latestTmpFile, latestFile, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to rename " << latestTmpFile.string()
+                                             << " error: " << ec.message());
+  }
+
+  // The oldest checkpoints go, along with the partial ones left by a crash
+  vector<pair<uint64_t, fs::path>> published;
+  vector<fs::path> stale;
+  for (fs::directory_iterator it(root, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    const string name = it->path().filename().string();
+    if (!fs::is_directory(it->path())) {
+      continue;
+    }
+    if (name.empty() || name.size() > 19 ||
+        name.find_first_not_of("0123456789") != string::npos) {
+      stale.emplace_back(it->path());
+    } else {
+      published.emplace_back(stoull(name), it->path());
+    }
+  }
+  sort(published.begin(), published.end());
+  for (size_t i = 0; i + CHECKPOINT_KEEP_COUNT < published.size(); i++) {
+    stale.emplace_back(published[i].second);
+  }
+  for (const auto& path : stale) {
+    fs::remove_all(path, ec);
+  }
+
+  LOG_GENERAL(INFO, "Published checkpoint "
+                        << dir.string() << " in "
+                        << chrono::duration_cast<chrono::milliseconds>(
+                               chrono::steady_clock::now() - start)
+                               .count()
+                        << " ms");
+  return true;
+}
+
+bool BlockStorage::RecoverEpochCommit() {
+  LOG_MARKER();
+
+  string journal;
+  {
+    shared_lock<shared_timed_mutex> g(m_mutexMetadata);
+    journal = m_metadataDB->Lookup(EPOCH_COMMIT_JOURNAL_KEY);
+  }
+  if (journal.empty()) {
+    return true;
+  }
+
+  LOG_GENERAL(INFO, "Applying the journaled writes of an interrupted epoch");
+  if (!ApplyEpochJournal(journal)) {
+    return false;
+  }
+
+  unique_lock<shared_timed_mutex> g(m_mutexMetadata);
+  return m_metadataDB->DeleteKey(EPOCH_COMMIT_JOURNAL_KEY) == 0;
+}
+
+bool BlockStorage::ApplyEpochJournal(const string& journal) {
+  map<DBTYPE, leveldb::WriteBatch> batches;
+  vector<pair<BlockHash, bytes>> microBlocks;
+  vector<uint64_t> txBlockNums;
+
+  // Keys are journaled in hex and decimal, and written in the key format of
+  // the db they go to
+  size_t pos = 0;
+  while (pos < journal.size()) {
+    const auto type = static_cast<DBTYPE>(journal[pos++]);
+    string key;
+    string value;
+    if (!ReadJournalField(journal, pos, key) ||
+        !ReadJournalField(journal, pos, value)) {
+      LOG_GENERAL(WARNING, "Epoch journal is corrupted");
+      return false;
+    }
+    uint64_t blockNum = 0;
+    switch (type) {
+      case META:
+        batches[type].Put(key, value);
+        break;
+      case TX_BLOCK:
+        if (!LevelDB::DecodeKey(key, blockNum)) {
+          LOG_GENERAL(WARNING, "Epoch journal is corrupted");
+          return false;
+        }
+        m_txBlockchainDB->BatchPut(batches[type], blockNum, value);
+        txBlockNums.emplace_back(blockNum);
+        break;
+      case MICROBLOCK:
+        microBlocks.emplace_back(BlockHash(key),
+                                 bytes(value.begin(), value.end()));
+        m_microBlockDB->BatchPut(batches[type], BlockHash(key), value);
+        break;
+      case STATE_DELTA:
+        if (!LevelDB::DecodeKey(key, blockNum)) {
+          LOG_GENERAL(WARNING, "Epoch journal is corrupted");
+          return false;
+        }
+        m_stateDeltaDB->BatchPut(batches[type], blockNum, value);
+        break;
+      default:
+        LOG_GENERAL(WARNING, "Epoch journal has writes to db " << type);
+        return false;
+    }
+  }
+
+  for (auto& entry : batches) {
+    shared_ptr<LevelDB> db;
+    shared_timed_mutex* mutex = nullptr;
+    switch (entry.first) {
+      case META:
+        db = m_metadataDB;
+        mutex = &m_mutexMetadata;
+        break;
+      case TX_BLOCK:
+        db = m_txBlockchainDB;
+        mutex = &m_mutexTxBlockchain;
+        break;
+      case MICROBLOCK:
+        db = m_microBlockDB;
+        mutex = &m_mutexMicroBlock;
+        break;
+      default:
+        db = m_stateDeltaDB;
+        mutex = &m_mutexStateDelta;
+        break;
+    }
+
+    unique_lock<shared_timed_mutex> g(*mutex);
+    if (!db->Write(entry.second)) {
+      LOG_GENERAL(WARNING, "Failed to write the epoch to " << db->GetDBName());
+      return false;
+    }
+    if (entry.first == TX_BLOCK) {
+      for (const auto& blockNum : txBlockNums) {
+        m_txBlockCache.Erase(blockNum);
+      }
+    }
+    if (entry.first == MICROBLOCK) {
+      for (const auto& microBlock : microBlocks) {
+        m_microBlockCache.Erase(microBlock.first);
+        if (!UpdateMicroBlockIndex(microBlock.first, microBlock.second,
+                                   false)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+void EpochCommit::PutMicroBlock(const BlockHash& blockHash, const bytes& body) {
+  m_writes.emplace_back(BlockStorage::MICROBLOCK, blockHash.hex(),
+                        string(body.begin(), body.end()));
+}
+
+void EpochCommit::PutTxBlock(const uint64_t& blockNum, const bytes& body) {
+  m_writes.emplace_back(BlockStorage::TX_BLOCK, to_string(blockNum),
+                        string(body.begin(), body.end()));
+}
+
+void EpochCommit::PutStateDelta(const uint64_t& finalBlockNum,
+                                const bytes& stateDelta) {
+  m_writes.emplace_back(BlockStorage::STATE_DELTA, to_string(finalBlockNum),
+                        string(stateDelta.begin(), stateDelta.end()));
+}
+
+void EpochCommit::PutMetadata(MetaType type, const bytes& data) {
+  m_writes.emplace_back(BlockStorage::META, to_string((int)type),
+                        string(data.begin(), data.end()));
+}
+
+void EpochCommit::PutEpochFin(const uint64_t& epochNum) {
+  PutMetadata(MetaType::EPOCHFIN,
+              DataConversion::StringToCharArray(to_string(epochNum)));
+}
+
 bool BlockStorage::PutDiagnosticDataNodes(const uint64_t& dsBlockNum,
                                           const DequeOfShard& shards,
                                           const DequeOfNode& dsCommittee) {
@@ -1237,6 +2419,116 @@ bool BlockStorage::DeleteDiagnosticDataCoinbase(const uint64_t& dsBlockNum) {
   return result;
 }
 
+bool BlockStorage::PutDiagnosticDataEpochPerf(
+    const uint64_t& epochNum, const DiagnosticDataEpochPerf& entry) {
+  LOG_MARKER();
+
+  bytes data;
+
+  if (!Messenger::SetDiagnosticDataEpochPerf(data, 0, entry)) {
+    LOG_GENERAL(WARNING, "Messenger::SetDiagnosticDataEpochPerf failed");
+    return false;
+  }
+
+  lock_guard<mutex> g(m_mutexDiagnostic);
+
+  if (0 != m_diagnosticDBEpochPerf->Insert(epochNum, data)) {
+    LOG_GENERAL(WARNING, "Failed to store diagnostic data");
+    return false;
+  }
+
+  m_diagnosticDBEpochPerfCounter++;
+
+  return true;
+}
+
+bool BlockStorage::GetDiagnosticDataEpochPerf(const uint64_t& epochNum,
+                                              DiagnosticDataEpochPerf& entry) {
+  LOG_MARKER();
+
+  string dataStr;
+
+  {
+    lock_guard<mutex> g(m_mutexDiagnostic);
+    dataStr = m_diagnosticDBEpochPerf->Lookup(epochNum);
+  }
+
+  if (dataStr.empty()) {
+    LOG_GENERAL(WARNING,
+                "Failed to retrieve diagnostic data for epoch " << epochNum);
+    return false;
+  }
+
+  bytes data(dataStr.begin(), dataStr.end());
+
+  if (!Messenger::GetDiagnosticDataEpochPerf(data, 0, entry)) {
+    LOG_GENERAL(WARNING, "Messenger::GetDiagnosticDataEpochPerf failed");
+    return false;
+  }
+
+  return true;
+}
+
+void BlockStorage::GetDiagnosticDataEpochPerf(
+    map<uint64_t, DiagnosticDataEpochPerf>& diagnosticDataMap) {
+  LOG_MARKER();
+
+  lock_guard<mutex> g(m_mutexDiagnostic);
+
+  unique_ptr<leveldb::Iterator> it(
+      m_diagnosticDBEpochPerf->GetDB()->NewIterator(leveldb::ReadOptions()));
+
+  unsigned int index = 0;
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    string epochNumStr = it->key().ToString();
+    string dataStr = it->value().ToString();
+
+    if (epochNumStr.empty() || dataStr.empty()) {
+      LOG_GENERAL(WARNING,
+                  "Failed to retrieve diagnostic data at index " << index);
+      continue;
+    }
+
+    uint64_t epochNum = 0;
+    try {
+      epochNum = stoull(epochNumStr);
+    } catch (...) {
+      LOG_GENERAL(WARNING,
+                  "Non-numeric key " << epochNumStr << " at index " << index);
+      continue;
+    }
+
+    bytes data(dataStr.begin(), dataStr.end());
+
+    DiagnosticDataEpochPerf entry;
+
+    if (!Messenger::GetDiagnosticDataEpochPerf(data, 0, entry)) {
+      LOG_GENERAL(WARNING,
+                  "Messenger::GetDiagnosticDataEpochPerf failed for epoch "
+                      << epochNumStr << " at index " << index);
+      continue;
+    }
+
+    diagnosticDataMap.emplace(make_pair(epochNum, entry));
+
+    index++;
+  }
+}
+
+unsigned int BlockStorage::GetDiagnosticDataEpochPerfCount() {
+  lock_guard<mutex> g(m_mutexDiagnostic);
+  return m_diagnosticDBEpochPerfCounter;
+}
+
+bool BlockStorage::DeleteDiagnosticDataEpochPerf(const uint64_t& epochNum) {
+  lock_guard<mutex> g(m_mutexDiagnostic);
+  bool result = (0 == m_diagnosticDBEpochPerf->DeleteKey(epochNum));
+  if (result) {
+    m_diagnosticDBEpochPerfCounter--;
+  }
+  return result;
+}
+
 bool BlockStorage::ResetDB(DBTYPE type) {
   LOG_MARKER();
   bool ret = false;
@@ -1249,26 +2541,49 @@ bool BlockStorage::ResetDB(DBTYPE type) {
     case DS_BLOCK: {
       unique_lock<shared_timed_mutex> g(m_mutexDsBlockchain);
       ret = m_dsBlockchainDB->ResetDB();
+      m_dsBlockCache.Clear();
       break;
     }
     case TX_BLOCK: {
       unique_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
-      ret = m_txBlockchainDB->ResetDB();
+      ret = m_txBlockchainDB->ResetDB() & m_txnCountDB->ResetDB();
+      m_txBlockCache.Clear();
       break;
     }
     case TX_BODY: {
+      FlushTxBodies();
       unique_lock<shared_timed_mutex> g(m_mutexTxBody);
       ret = m_txBodyDB->ResetDB();
+      if (m_txBodyArchive) {
+        lock_guard<mutex> g(m_mutexTxBodyArchive);
+        ret = m_txBodyArchive->Reset() && ret;
+      }
+      if (m_txnHistoryIndexDB) {
+        unique_lock<shared_timed_mutex> g(m_mutexTxnHistoryIndex);
+        ret = m_txnHistoryIndexDB->ResetDB() && ret;
+      }
+      if (m_eventBloomDB) {
+        unique_lock<shared_timed_mutex> g(m_mutexEventBloom);
+        ret = m_eventBloomDB->ResetDB() && ret;
+      }
+      if (m_cosigsRewardsDB) {
+        unique_lock<shared_timed_mutex> g(m_mutexCosigsRewards);
+        ret = m_cosigsRewardsDB->ResetDB() && ret;
+      }
+      m_txBodyCache.Clear();
       break;
     }
     case TX_BODY_TMP: {
+      FlushTxBodies();
       unique_lock<shared_timed_mutex> g(m_mutexTxBodyTmp);
       ret = m_txBodyTmpDB->ResetDB();
       break;
     }
     case MICROBLOCK: {
       unique_lock<shared_timed_mutex> g(m_mutexMicroBlock);
-      ret = m_microBlockDB->ResetDB();
+      ret = m_microBlockDB->ResetDB() & m_microBlockIndexDB->ResetDB();
+      m_microBlockCache.Clear();
+      m_microBlockIndexComplete = false;
       break;
     }
     case DS_COMMITTEE: {
@@ -1322,6 +2637,14 @@ bool BlockStorage::ResetDB(DBTYPE type) {
       }
       break;
     }
+    case DIAGNOSTIC_EPOCH_PERF: {
+      lock_guard<mutex> g(m_mutexDiagnostic);
+      ret = m_diagnosticDBEpochPerf->ResetDB();
+      if (ret) {
+        m_diagnosticDBEpochPerfCounter = 0;
+      }
+      break;
+    }
     case STATE_ROOT: {
       unique_lock<shared_timed_mutex> g(m_mutexStateRoot);
       ret = m_stateRootDB->ResetDB();
@@ -1332,6 +2655,11 @@ bool BlockStorage::ResetDB(DBTYPE type) {
       ret = m_processedTxnTmpDB->ResetDB();
       break;
     }
+    case PENDING_TXN: {
+      unique_lock<shared_timed_mutex> g(m_mutexPendingTxn);
+      ret = m_pendingTxnDB->ResetDB();
+      break;
+    }
   }
   if (!ret) {
     LOG_GENERAL(INFO, "FAIL: Reset DB " << type << " failed");
@@ -1351,26 +2679,45 @@ bool BlockStorage::RefreshDB(DBTYPE type) {
     case DS_BLOCK: {
       unique_lock<shared_timed_mutex> g(m_mutexDsBlockchain);
       ret = m_dsBlockchainDB->RefreshDB();
+      m_dsBlockCache.Clear();
       break;
     }
     case TX_BLOCK: {
       unique_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
-      ret = m_txBlockchainDB->RefreshDB();
+      ret = m_txBlockchainDB->RefreshDB() & m_txnCountDB->RefreshDB();
+      m_txBlockCache.Clear();
       break;
     }
     case TX_BODY: {
+      FlushTxBodies();
       unique_lock<shared_timed_mutex> g(m_mutexTxBody);
       ret = m_txBodyDB->RefreshDB();
+      if (m_txnHistoryIndexDB) {
+        unique_lock<shared_timed_mutex> g(m_mutexTxnHistoryIndex);
+        ret = m_txnHistoryIndexDB->RefreshDB() && ret;
+      }
+      if (m_eventBloomDB) {
+        unique_lock<shared_timed_mutex> g(m_mutexEventBloom);
+        ret = m_eventBloomDB->RefreshDB() && ret;
+      }
+      if (m_cosigsRewardsDB) {
+        unique_lock<shared_timed_mutex> g(m_mutexCosigsRewards);
+        ret = m_cosigsRewardsDB->RefreshDB() && ret;
+      }
+      m_txBodyCache.Clear();
       break;
     }
     case TX_BODY_TMP: {
+      FlushTxBodies();
       unique_lock<shared_timed_mutex> g(m_mutexTxBodyTmp);
       ret = m_txBodyTmpDB->RefreshDB();
       break;
     }
     case MICROBLOCK: {
       unique_lock<shared_timed_mutex> g(m_mutexMicroBlock);
-      ret = m_microBlockDB->RefreshDB();
+      ret = m_microBlockDB->RefreshDB() & m_microBlockIndexDB->RefreshDB();
+      m_microBlockCache.Clear();
+      m_microBlockIndexComplete = false;
       break;
     }
     case DS_COMMITTEE: {
@@ -1419,6 +2766,14 @@ bool BlockStorage::RefreshDB(DBTYPE type) {
       }
       break;
     }
+    case DIAGNOSTIC_EPOCH_PERF: {
+      lock_guard<mutex> g(m_mutexDiagnostic);
+      ret = m_diagnosticDBEpochPerf->RefreshDB();
+      if (ret) {
+        m_diagnosticDBEpochPerfCounter = 0;
+      }
+      break;
+    }
     case STATE_ROOT: {
       unique_lock<shared_timed_mutex> g(m_mutexStateRoot);
       ret = m_stateRootDB->RefreshDB();
@@ -1434,6 +2789,11 @@ bool BlockStorage::RefreshDB(DBTYPE type) {
       ret = m_processedTxnTmpDB->RefreshDB();
       break;
     }
+    case PENDING_TXN: {
+      unique_lock<shared_timed_mutex> g(m_mutexPendingTxn);
+      ret = m_pendingTxnDB->RefreshDB();
+      break;
+    }
   }
   if (!ret) {
     LOG_GENERAL(INFO, "FAIL: Refresh DB " << type << " failed");
@@ -1457,11 +2817,21 @@ std::vector<std::string> BlockStorage::GetDBName(DBTYPE type) {
     case TX_BLOCK: {
       shared_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
       ret.push_back(m_txBlockchainDB->GetDBName());
+      ret.push_back(m_txnCountDB->GetDBName());
       break;
     }
     case TX_BODY: {
       shared_lock<shared_timed_mutex> g(m_mutexTxBody);
       ret.push_back(m_txBodyDB->GetDBName());
+      if (m_txnHistoryIndexDB) {
+        ret.push_back(m_txnHistoryIndexDB->GetDBName());
+      }
+      if (m_eventBloomDB) {
+        ret.push_back(m_eventBloomDB->GetDBName());
+      }
+      if (m_cosigsRewardsDB) {
+        ret.push_back(m_cosigsRewardsDB->GetDBName());
+      }
       break;
     }
     case TX_BODY_TMP: {
@@ -1472,6 +2842,7 @@ std::vector<std::string> BlockStorage::GetDBName(DBTYPE type) {
     case MICROBLOCK: {
       shared_lock<shared_timed_mutex> g(m_mutexMicroBlock);
       ret.push_back(m_microBlockDB->GetDBName());
+      ret.push_back(m_microBlockIndexDB->GetDBName());
       break;
     }
     case DS_COMMITTEE: {
@@ -1519,6 +2890,11 @@ std::vector<std::string> BlockStorage::GetDBName(DBTYPE type) {
       ret.push_back(m_diagnosticDBCoinbase->GetDBName());
       break;
     }
+    case DIAGNOSTIC_EPOCH_PERF: {
+      lock_guard<mutex> g(m_mutexDiagnostic);
+      ret.push_back(m_diagnosticDBEpochPerf->GetDBName());
+      break;
+    }
     case STATE_ROOT: {
       shared_lock<shared_timed_mutex> g(m_mutexStateRoot);
       ret.push_back(m_stateRootDB->GetDBName());
@@ -1529,6 +2905,11 @@ std::vector<std::string> BlockStorage::GetDBName(DBTYPE type) {
       ret.push_back(m_processedTxnTmpDB->GetDBName());
       break;
     }
+    case PENDING_TXN: {
+      shared_lock<shared_timed_mutex> g(m_mutexPendingTxn);
+      ret.push_back(m_pendingTxnDB->GetDBName());
+      break;
+    }
   }
 
   return ret;
@@ -1543,7 +2924,8 @@ bool BlockStorage::ResetAll() {
            ResetDB(FB_BLOCK) & ResetDB(BLOCKLINK) & ResetDB(SHARD_STRUCTURE) &
            ResetDB(STATE_DELTA) & ResetDB(TEMP_STATE) &
            ResetDB(DIAGNOSTIC_NODES) & ResetDB(DIAGNOSTIC_COINBASE) &
-           ResetDB(STATE_ROOT) & ResetDB(PROCESSED_TEMP);
+           ResetDB(DIAGNOSTIC_EPOCH_PERF) & ResetDB(STATE_ROOT) &
+           ResetDB(PROCESSED_TEMP) & ResetDB(PENDING_TXN);
   } else  // IS_LOOKUP_NODE
   {
     return ResetDB(META) & ResetDB(DS_BLOCK) & ResetDB(TX_BLOCK) &
@@ -1552,7 +2934,8 @@ bool BlockStorage::ResetAll() {
            ResetDB(BLOCKLINK) & ResetDB(SHARD_STRUCTURE) &
            ResetDB(STATE_DELTA) & ResetDB(TEMP_STATE) &
            ResetDB(DIAGNOSTIC_NODES) & ResetDB(DIAGNOSTIC_COINBASE) &
-           ResetDB(STATE_ROOT) & ResetDB(PROCESSED_TEMP);
+           ResetDB(DIAGNOSTIC_EPOCH_PERF) & ResetDB(STATE_ROOT) &
+           ResetDB(PROCESSED_TEMP) & ResetDB(PENDING_TXN);
   }
 }
 
@@ -1565,8 +2948,9 @@ bool BlockStorage::RefreshAll() {
            RefreshDB(VC_BLOCK) & RefreshDB(FB_BLOCK) & RefreshDB(BLOCKLINK) &
            RefreshDB(SHARD_STRUCTURE) & RefreshDB(STATE_DELTA) &
            RefreshDB(TEMP_STATE) & RefreshDB(DIAGNOSTIC_NODES) &
-           RefreshDB(DIAGNOSTIC_COINBASE) & RefreshDB(STATE_ROOT) &
-           RefreshDB(PROCESSED_TEMP) &
+           RefreshDB(DIAGNOSTIC_COINBASE) & RefreshDB(DIAGNOSTIC_EPOCH_PERF) &
+           RefreshDB(STATE_ROOT) & RefreshDB(PROCESSED_TEMP) &
+           RefreshDB(PENDING_TXN) &
            Contract::ContractStorage2::GetContractStorage().RefreshAll();
   } else  // IS_LOOKUP_NODE
   {
@@ -1576,7 +2960,8 @@ bool BlockStorage::RefreshAll() {
            RefreshDB(BLOCKLINK) & RefreshDB(SHARD_STRUCTURE) &
            RefreshDB(STATE_DELTA) & RefreshDB(TEMP_STATE) &
            RefreshDB(DIAGNOSTIC_NODES) & RefreshDB(DIAGNOSTIC_COINBASE) &
-           RefreshDB(STATE_ROOT) & RefreshDB(PROCESSED_TEMP) &
+           RefreshDB(DIAGNOSTIC_EPOCH_PERF) & RefreshDB(STATE_ROOT) &
+           RefreshDB(PROCESSED_TEMP) & RefreshDB(PENDING_TXN) &
            Contract::ContractStorage2::GetContractStorage().RefreshAll();
   }
 }
\ No newline at end of file
@@ -18,17 +18,26 @@
 #ifndef ZILLIQA_SRC_LIBPERSISTENCE_BLOCKSTORAGE_H_
 #define ZILLIQA_SRC_LIBPERSISTENCE_BLOCKSTORAGE_H_
 
+#include <atomic>
+#include <condition_variable>
 #include <list>
 #include <mutex>
 #include <shared_mutex>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include <Schnorr.h>
+#include "BlockCache.h"
 #include "ContractStorage.h"
+#include "TxBodyArchive.h"
 #include "common/Singleton.h"
 #include "depends/libDatabase/LevelDB.h"
+#include "libData/AccountData/EventBloom.h"
+#include "libData/AccountData/Transaction.h"
 #include "libData/BlockData/Block.h"
 #include "libData/BlockData/Block/FallbackBlockWShardingStructure.h"
+#include "libUtils/EpochPerf.h"
 
 typedef std::tuple<uint32_t, uint64_t, uint64_t, BlockType, BlockHash>
     BlockLink;
@@ -77,13 +86,30 @@ struct DiagnosticDataCoinbase {
   }
 };
 
+class EpochCommit;
+
 /// Manages persistent storage of DS and Tx blocks.
 class BlockStorage : public Singleton<BlockStorage> {
   std::shared_ptr<LevelDB> m_metadataDB;
   std::shared_ptr<LevelDB> m_dsBlockchainDB;
   std::shared_ptr<LevelDB> m_txBlockchainDB;
+  /// Running total of the transactions of the tx blocks in m_txBlockchainDB,
+  /// by big-endian block number, so that counts over any range are O(1)
+  std::shared_ptr<LevelDB> m_txnCountDB;
   std::shared_ptr<LevelDB> m_txBodyDB;
+  /// (address, big-endian epoch, txn hash) keys of the transactions sent
+  /// from or to each address, on lookups with ENABLE_TXN_HISTORY_INDEX
+  std::shared_ptr<LevelDB> m_txnHistoryIndexDB;
+  /// EventBloom of each tx block with contract events, by big-endian block
+  /// number, on lookups with ENABLE_EVENT_BLOOM_INDEX
+  std::shared_ptr<LevelDB> m_eventBloomDB;
+  /// Serialized cosigs and rewards of each tx block and its microblocks, by
+  /// big-endian block number, on lookups
+  std::shared_ptr<LevelDB> m_cosigsRewardsDB;
   std::shared_ptr<LevelDB> m_microBlockDB;
+  /// (epoch, shard id, hash) keys of the microblocks in m_microBlockDB, so
+  /// that a range of them can be found without reading every one
+  std::shared_ptr<LevelDB> m_microBlockIndexDB;
   std::shared_ptr<LevelDB> m_txBodyTmpDB;
   std::shared_ptr<LevelDB> m_dsCommitteeDB;
   std::shared_ptr<LevelDB> m_VCBlockDB;
@@ -93,21 +119,42 @@ class BlockStorage : public Singleton<BlockStorage> {
   std::shared_ptr<LevelDB> m_stateDeltaDB;
   std::shared_ptr<LevelDB> m_tempStateDB;
   std::shared_ptr<LevelDB> m_processedTxnTmpDB;
+  /// Shard id and body of the transactions in the txn pool, by hash, on
+  /// nodes with ENABLE_PENDING_TXN_PERSISTENCE
+  std::shared_ptr<LevelDB> m_pendingTxnDB;
   // m_diagnosticDBNodes is needed only for LOOKUP_NODE_MODE, but to make the
   // unit test and monitoring tools work with the default setting of
   // LOOKUP_NODE_MODE=false, we initialize it even if it's not a lookup node.
   std::shared_ptr<LevelDB> m_diagnosticDBNodes;
   std::shared_ptr<LevelDB> m_diagnosticDBCoinbase;
+  std::shared_ptr<LevelDB> m_diagnosticDBEpochPerf;
   std::shared_ptr<LevelDB> m_stateRootDB;
   /// used for historical data
   std::shared_ptr<LevelDB> m_txnHistoricalDB;
   std::shared_ptr<LevelDB> m_MBHistoricalDB;
 
+  /// Blocks and tx bodies decoded from the databases above, so that the
+  /// RPC and sync-serving readers of the same recent ones share them
+  BlockCache<uint64_t, DSBlock> m_dsBlockCache;
+  BlockCache<uint64_t, TxBlock> m_txBlockCache;
+  BlockCache<BlockHash, MicroBlock> m_microBlockCache;
+  BlockCache<dev::h256, TransactionWithReceipt> m_txBodyCache;
+
+  /// A quarter of BLOCKSTORAGE_CACHE_SIZE_IN_MB for each of the caches
+  static size_t GetBlockCacheCapacity();
+
+  /// Bodies moved out of m_txBodyDB by ArchiveTxBodies, on lookups that
+  /// retain TX_BODY_RETENTION_DS_EPOCHS or have archived before
+  std::unique_ptr<TxBodyArchive> m_txBodyArchive;
+  std::mutex m_mutexTxBodyArchive;
+
   BlockStorage(const std::string& path = "", bool diagnostic = false)
       : m_metadataDB(std::make_shared<LevelDB>("metadata")),
         m_dsBlockchainDB(std::make_shared<LevelDB>("dsBlocks")),
         m_txBlockchainDB(std::make_shared<LevelDB>("txBlocks")),
+        m_txnCountDB(std::make_shared<LevelDB>("txnCounts")),
         m_microBlockDB(std::make_shared<LevelDB>("microBlocks")),
+        m_microBlockIndexDB(std::make_shared<LevelDB>("microBlockIndex")),
         m_dsCommitteeDB(std::make_shared<LevelDB>("dsCommittee")),
         m_VCBlockDB(std::make_shared<LevelDB>("VCBlocks")),
         m_fallbackBlockDB(std::make_shared<LevelDB>("fallbackBlocks")),
@@ -116,22 +163,71 @@ class BlockStorage : public Singleton<BlockStorage> {
         m_stateDeltaDB(std::make_shared<LevelDB>("stateDelta")),
         m_tempStateDB(std::make_shared<LevelDB>("tempState")),
         m_processedTxnTmpDB(std::make_shared<LevelDB>("processedTxnTmp")),
+        m_pendingTxnDB(std::make_shared<LevelDB>("pendingTxns")),
         m_diagnosticDBNodes(
             std::make_shared<LevelDB>("diagnosticNodes", path, diagnostic)),
         m_diagnosticDBCoinbase(
             std::make_shared<LevelDB>("diagnosticCoinb", path, diagnostic)),
+        m_diagnosticDBEpochPerf(
+            std::make_shared<LevelDB>("diagnosticPerf", path, diagnostic)),
         m_stateRootDB(std::make_shared<LevelDB>("stateRoot")),
+        m_dsBlockCache(GetBlockCacheCapacity()),
+        m_txBlockCache(GetBlockCacheCapacity()),
+        m_microBlockCache(GetBlockCacheCapacity()),
+        m_txBodyCache(GetBlockCacheCapacity()),
         m_diagnosticDBNodesCounter(0),
-        m_diagnosticDBCoinbaseCounter(0) {
+        m_diagnosticDBCoinbaseCounter(0),
+        m_diagnosticDBEpochPerfCounter(0) {
     if (LOOKUP_NODE_MODE) {
       m_txBodyDB = std::make_shared<LevelDB>("txBodies");
       m_txBodyTmpDB = std::make_shared<LevelDB>("txBodiesTmp");
+      if (ENABLE_TXN_HISTORY_INDEX) {
+        m_txnHistoryIndexDB = std::make_shared<LevelDB>("txnHistoryIndex");
+      }
+      if (ENABLE_EVENT_BLOOM_INDEX) {
+        m_eventBloomDB = std::make_shared<LevelDB>("eventBlooms");
+      }
+      m_cosigsRewardsDB = std::make_shared<LevelDB>("cosigsRewards");
+      InitTxBodyArchive();
     }
+    StartKeyMigration();
+    RegisterMemoryStats();
   };
-  ~BlockStorage() = default;
+  ~BlockStorage();
   bool PutBlock(const uint64_t& blockNum, const bytes& body,
                 const BlockType& blockType);
 
+  /// Key of a microblock in m_microBlockIndexDB, or its (epoch, shard id)
+  /// prefix if the hash is left out
+  static std::string GetMicroBlockIndexKey(const uint64_t& epochNum,
+                                           const uint32_t& shardId,
+                                           const BlockHash* blockHash);
+
+  /// Adds or removes the index entry of the serialized microblock
+  bool UpdateMicroBlockIndex(const BlockHash& blockHash, const bytes& body,
+                             bool remove);
+
+  /// Indexes the microblocks stored before m_microBlockIndexDB was, once
+  bool CompleteMicroBlockIndex();
+
+  /// Apply the serialized writes of an epoch journal
+  bool ApplyEpochJournal(const std::string& journal);
+
+  /// Rewrites in the background the hex keys left in the block stores
+  /// profiled with binary_keys
+  void StartKeyMigration();
+
+  void InitTxBodyArchive();
+
+  /// Reports the caches and the queued tx bodies to MemoryStats
+  void RegisterMemoryStats();
+
+  /// Loop of the thread writing the bodies queued by EnqueueTxBody
+  void WriteQueuedTxBodies();
+
+  /// Copies the body of key if it is queued and not yet written
+  bool GetQueuedTxBody(const dev::h256& key, bytes& body);
+
  public:
   enum DBTYPE {
     META = 0x00,
@@ -151,6 +247,9 @@ class BlockStorage : public Singleton<BlockStorage> {
     DIAGNOSTIC_COINBASE,
     STATE_ROOT,
     PROCESSED_TEMP,
+    // Values are written in the epoch commit journal, add new types last
+    DIAGNOSTIC_EPOCH_PERF,
+    PENDING_TXN,
   };
 
   /// Returns the singleton BlockStorage instance.
@@ -177,8 +276,71 @@ class BlockStorage : public Singleton<BlockStorage> {
   /// Adds a transaction body to storage.
   bool PutTxBody(const dev::h256& key, const bytes& body);
 
+  /// Queues a transaction body for a storage thread to write together with
+  /// the others queued meanwhile, blocking only while
+  /// TX_BODY_WRITE_QUEUE_SIZE bodies are queued. Queued bodies are read
+  /// back as if written.
+  bool EnqueueTxBody(const dev::h256& key, const bytes& body);
+
+  /// Indexes twr, of epoch epochNum, under its sender and its recipient if
+  /// ENABLE_TXN_HISTORY_INDEX is set
+  bool PutTxnHistory(const TransactionWithReceipt& twr,
+                     const uint64_t& epochNum);
+
+  /// Retrieves up to count (epoch, txn hash) of the transactions of address,
+  /// oldest first, after the entry startAfter, or from the first one if
+  /// startAfter is empty. next is the entry to resume after, or empty if
+  /// there are no more.
+  bool GetTxnHistory(const Address& address, const std::string& startAfter,
+                     unsigned int count,
+                     std::vector<std::pair<uint64_t, TxnHash>>& txns,
+                     std::string& next);
+
+  /// Adds bloom to the event bloom of the tx block blockNum if
+  /// ENABLE_EVENT_BLOOM_INDEX is set
+  bool MergeEventBloom(const uint64_t& blockNum, const EventBloom& bloom);
+
+  /// Retrieves the event bloom of the tx block blockNum. Returns false if
+  /// none of its transactions committed so far had events.
+  bool GetEventBloom(const uint64_t& blockNum, EventBloom& bloom);
+
+  /// Stores the cosigs and rewards record of the tx block blockNum, as made
+  /// by Messenger::SetCosigsRewardsRecord, on lookups
+  bool PutCosigsRewards(const uint64_t& blockNum, const bytes& record);
+
+  /// Retrieves the cosigs and rewards record of the tx block blockNum.
+  /// Returns false if none was stored.
+  bool GetCosigsRewards(const uint64_t& blockNum, bytes& record);
+
+  /// Waits until the queued transaction bodies are written
+  void FlushTxBodies();
+
+  /// Returns the bytes of the blocks held by the four block caches
+  size_t GetBlockCacheSizeInBytes() const;
+
+  /// Returns the bytes of the tx bodies queued or being written
+  uint64_t GetQueuedTxBodiesSizeInBytes();
+
+  /// Moves the bodies of the transactions in the microblocks of the epochs
+  /// before oldestKeptEpochNum from the txBodies db into the archive, which
+  /// GetTxBody keeps reading them from. Returns false if another call is
+  /// still archiving.
+  bool ArchiveTxBodies(const uint64_t& oldestKeptEpochNum);
+
   bool PutProcessedTxBodyTmp(const dev::h256& key, const bytes& body);
 
+  /// Appends transactions added to the txn pool for shardId, in one write
+  bool PutPendingTxns(const std::vector<Transaction>& txns,
+                      const uint32_t& shardId);
+
+  /// Replaces the pending transactions with txns, the ones still in the txn
+  /// pool, so that the ones taken or dropped since are not kept
+  bool RewritePendingTxns(
+      const std::vector<std::pair<uint32_t, Transaction>>& txns);
+
+  /// Retrieves the pending transactions with their shard ids
+  bool GetAllPendingTxns(std::vector<std::pair<uint32_t, Transaction>>& txns);
+
   /// Retrieves the requested DS block.
   bool GetDSBlock(const uint64_t& blockNum, DSBlockSharedPtr& block);
 
@@ -192,6 +354,24 @@ class BlockStorage : public Singleton<BlockStorage> {
 
   bool GetLatestTxBlock(TxBlockSharedPtr& block);
 
+  /// Retrieves the consecutive Tx blocks from lowBlockNum, up to hiBlockNum
+  /// or the first one missing. The blocks not cached are read by iterating
+  /// the db, once its keys sort by block number.
+  bool GetRangeTxBlocks(const uint64_t& lowBlockNum, const uint64_t& hiBlockNum,
+                        std::vector<TxBlockSharedPtr>& blocks);
+
+  /// Indexes numTxns, the transactions of the tx blocks 1 to blockNum, and
+  /// dsBlockNum, the DS block of tx block blockNum.
+  bool PutTxnCount(const uint64_t& blockNum, const uint128_t& numTxns,
+                   const uint64_t& dsBlockNum);
+
+  /// Returns false if blockNum is not indexed
+  bool GetTxnCount(const uint64_t& blockNum, uint128_t& numTxns,
+                   uint64_t& dsBlockNum);
+
+  /// Highest indexed block number. Returns false if none is indexed.
+  bool GetLastTxnCountBlockNum(uint64_t& blockNum);
+
   bool CheckTxBody(const dev::h256& key);
 
   bool ReleaseDB();
@@ -263,6 +443,10 @@ class BlockStorage : public Singleton<BlockStorage> {
   /// Save latest epoch when states were moved to disk
   bool PutLatestEpochStatesUpdated(const uint64_t& epochNum);
 
+  /// Save the state root moved to disk with Tx block blockNum, once checked
+  /// against the block, as the latest state root checkpoint
+  bool PutStateRootCheckpoint(const uint64_t& blockNum, const StateHash& root);
+
   /// Save the latest epoch being fully completed
   bool PutEpochFin(const uint64_t& epochNum);
 
@@ -275,6 +459,12 @@ class BlockStorage : public Singleton<BlockStorage> {
   /// Save latest epoch when states were moved to disk
   bool GetLatestEpochStatesUpdated(uint64_t& epochNum);
 
+  /// Retrieve the state root checkpoint of Tx block blockNum
+  bool GetStateRootCheckpoint(const uint64_t& blockNum, StateHash& root);
+
+  /// Retrieve the latest state root checkpoint and its Tx block
+  bool GetLatestStateRootCheckpoint(uint64_t& blockNum, StateHash& root);
+
   /// Get the latest epoch being fully completed
   bool GetEpochFin(uint64_t& epochNum);
 
@@ -298,6 +488,29 @@ class BlockStorage : public Singleton<BlockStorage> {
   /// Retrieve state delta
   bool GetStateDelta(const uint64_t& finalBlockNum, bytes& stateDelta);
 
+  /// Write the staged writes of an epoch so that either all or none of them
+  /// survive a crash: they are journaled to the metadata db with one synced
+  /// write, then applied to each db as one batch
+  bool CommitEpoch(const EpochCommit& epochCommit);
+
+  /// Finish applying the journaled writes of an interrupted CommitEpoch
+  bool RecoverEpochCommit();
+
+  /// Record in WARM_RESTART_FILE that epochNum is fully on disk, so that a
+  /// process restarted soon after can recover from the persistence
+  void PutWarmRestartMarker(const uint64_t& epochNum);
+
+  /// Remove WARM_RESTART_FILE, so that a process that stops before its first
+  /// epoch is on disk is restarted from scratch
+  void ClearWarmRestartMarker();
+
+  /// Publish a copy of the block dbs as of epochNum in
+  /// STORAGE_PATH + CHECKPOINT_PATH/<epochNum>, which offline tools run with
+  /// it as their STORAGE_PATH can open while the node keeps running. The
+  /// latest epoch published is in the LATEST file next to it, and only the
+  /// last CHECKPOINT_KEEP_COUNT checkpoints are kept.
+  bool PublishCheckpoint(const uint64_t& epochNum);
+
   /// Write state to tempState in batch
   bool PutTempState(const std::unordered_map<Address, Account>& states);
 
@@ -344,6 +557,26 @@ class BlockStorage : public Singleton<BlockStorage> {
   /// Delete the requested diagnostic data entry from the db (coinbase rewards)
   bool DeleteDiagnosticDataCoinbase(const uint64_t& dsBlockNum);
 
+  /// Save data for diagnostic / monitoring purposes (epoch performance)
+  bool PutDiagnosticDataEpochPerf(const uint64_t& epochNum,
+                                  const DiagnosticDataEpochPerf& entry);
+
+  /// Retrieve diagnostic data for specific epoch number (epoch performance)
+  bool GetDiagnosticDataEpochPerf(const uint64_t& epochNum,
+                                  DiagnosticDataEpochPerf& entry);
+
+  /// Retrieve diagnostic data (epoch performance)
+  void GetDiagnosticDataEpochPerf(
+      std::map<uint64_t, DiagnosticDataEpochPerf>& diagnosticDataMap);
+
+  /// Retrieve the number of entries in the diagnostic data db (epoch
+  /// performance)
+  unsigned int GetDiagnosticDataEpochPerfCount();
+
+  /// Delete the requested diagnostic data entry from the db (epoch
+  /// performance)
+  bool DeleteDiagnosticDataEpochPerf(const uint64_t& epochNum);
+
   /// Clean a DB
   bool ResetDB(DBTYPE type);
 
@@ -374,13 +607,48 @@ class BlockStorage : public Singleton<BlockStorage> {
   mutable std::shared_timed_mutex m_mutexTempState;
   mutable std::shared_timed_mutex m_mutexTxBody;
   mutable std::shared_timed_mutex m_mutexTxBodyTmp;
+  mutable std::shared_timed_mutex m_mutexTxnHistoryIndex;
+  mutable std::shared_timed_mutex m_mutexEventBloom;
+  mutable std::shared_timed_mutex m_mutexCosigsRewards;
   mutable std::shared_timed_mutex m_mutexStateRoot;
   mutable std::shared_timed_mutex m_mutexTxnHistorical;
   mutable std::shared_timed_mutex m_mutexMBHistorical;
   mutable std::shared_timed_mutex m_mutexProcessTx;
+  mutable std::shared_timed_mutex m_mutexPendingTxn;
+
+  /// whether m_microBlockIndexDB covers all of m_microBlockDB
+  std::atomic<bool> m_microBlockIndexComplete{false};
+
+  /// Bodies queued by EnqueueTxBody, and the ones being written
+  std::mutex m_mutexTxBodyQueue;
+  std::condition_variable m_cvTxBodyQueue;
+  std::unordered_map<dev::h256, bytes> m_queuedTxBodies;
+  std::unordered_map<dev::h256, bytes> m_writingTxBodies;
+  bool m_txBodyWriterStarted{false};
 
   unsigned int m_diagnosticDBNodesCounter;
   unsigned int m_diagnosticDBCoinbaseCounter;
+  unsigned int m_diagnosticDBEpochPerfCounter;
+};
+
+/// Writes of one epoch to the block dbs, staged to be written together by
+/// BlockStorage::CommitEpoch
+class EpochCommit {
+  friend class BlockStorage;
+
+  /// (db, key, value) of the matching BlockStorage::Put*, with hash keys in
+  /// hex and block numbers in decimal whatever the key format of the db
+  std::vector<std::tuple<BlockStorage::DBTYPE, std::string, std::string>>
+      m_writes;
+
+ public:
+  void PutMicroBlock(const BlockHash& blockHash, const bytes& body);
+  void PutTxBlock(const uint64_t& blockNum, const bytes& body);
+  void PutStateDelta(const uint64_t& finalBlockNum, const bytes& stateDelta);
+  void PutMetadata(MetaType type, const bytes& data);
+  void PutEpochFin(const uint64_t& epochNum);
+
+  bool Empty() const { return m_writes.empty(); }
 };
 
 #endif  // ZILLIQA_SRC_LIBPERSISTENCE_BLOCKSTORAGE_H_
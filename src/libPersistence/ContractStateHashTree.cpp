@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "ContractStateHashTree.h"
+#include "libCrypto/Sha2.h"
+
+using namespace std;
+
+namespace Contract {
+
+namespace {
+const unsigned int NUM_BUCKETS = 1 << 16;
+const unsigned int BUCKETS_PER_BRANCH = 1 << 8;
+
+dev::h256 GetEmptyHash() {
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  return dev::h256(sha2.Finalize());
+}
+}  // namespace
+
+uint16_t ContractStateHashTree::GetBucketIndex(const string& key) {
+  dev::h256 hash;
+  SHA2<HashType::HASH_VARIANT_256>::Hash(
+      reinterpret_cast<const uint8_t*>(key.data()), key.size(), hash.data());
+  return (hash[0] << 8) | hash[1];
+}
+
+dev::h256 ContractStateHashTree::GetLeafHash(const string& key,
+                                             const bytes& value) {
+  // The key length keeps the boundary between key and value unambiguous
+  const uint32_t keySize = key.size();
+  const bytes header = {static_cast<unsigned char>(keySize >> 24),
+                        static_cast<unsigned char>(keySize >> 16),
+                        static_cast<unsigned char>(keySize >> 8),
+                        static_cast<unsigned char>(keySize)};
+
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  sha2.Update(header);
+  sha2.Update(reinterpret_cast<const uint8_t*>(key.data()), key.size());
+  sha2.Update(value.data(), value.size());
+  dev::h256 hash;
+  sha2.Finalize(hash.data());
+  return hash;
+}
+
+dev::h256 ContractStateHashTree::HashBucket(const Bucket& bucket) {
+  if (bucket.empty()) {
+    return dev::h256();
+  }
+
+  bytes leaves;
+  leaves.reserve(bucket.size() * dev::h256::size);
+  for (const auto& leaf : bucket) {
+    leaves.insert(leaves.end(), leaf.second.begin(), leaf.second.end());
+  }
+
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  sha2.Update(leaves);
+  return dev::h256(sha2.Finalize());
+}
+
+dev::h256 ContractStateHashTree::HashChildren(
+    const map<uint16_t, dev::h256>& children,
+    const map<uint16_t, dev::h256>& overrides, unsigned int begin,
+    unsigned int end) {
+  bytes buf;
+  auto append = [&buf](uint16_t index, const dev::h256& hash) {
+    if (hash == dev::h256()) {
+      return;
+    }
+    buf.push_back(index & 0xFF);
+    buf.insert(buf.end(), hash.begin(), hash.end());
+  };
+
+  auto child = children.lower_bound(begin);
+  auto over = overrides.lower_bound(begin);
+  while (true) {
+    const bool hasChild = (child != children.end()) && (child->first < end);
+    const bool hasOver = (over != overrides.end()) && (over->first < end);
+    if (!hasChild && !hasOver) {
+      break;
+    }
+
+    if (hasOver && (!hasChild || over->first <= child->first)) {
+      if (hasChild && (over->first == child->first)) {
+        ++child;
+      }
+      append(over->first, over->second);
+      ++over;
+    } else {
+      append(child->first, child->second);
+      ++child;
+    }
+  }
+
+  if (buf.empty()) {
+    return dev::h256();
+  }
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  sha2.Update(buf);
+  return dev::h256(sha2.Finalize());
+}
+
+void ContractStateHashTree::Set(const string& key, const bytes& value) {
+  const uint16_t index = GetBucketIndex(key);
+  auto leaf = m_buckets[index].emplace(key, dev::h256());
+  if (leaf.second) {
+    m_size++;
+  }
+  leaf.first->second = GetLeafHash(key, value);
+  m_dirtyBuckets.insert(index);
+}
+
+void ContractStateHashTree::Erase(const string& key) {
+  const uint16_t index = GetBucketIndex(key);
+  auto bucket = m_buckets.find(index);
+  if ((bucket == m_buckets.end()) || (bucket->second.erase(key) == 0)) {
+    return;
+  }
+  m_size--;
+  if (bucket->second.empty()) {
+    m_buckets.erase(bucket);
+  }
+  m_dirtyBuckets.insert(index);
+}
+
+size_t ContractStateHashTree::GetSizeInBytes() const {
+  size_t sizeInBytes = 0;
+  for (const auto& bucket : m_buckets) {
+    for (const auto& leaf : bucket.second) {
+      sizeInBytes += leaf.first.size() + dev::h256::size;
+    }
+  }
+  return sizeInBytes + (m_bucketHashes.size() + m_branchHashes.size()) *
+                           (sizeof(uint16_t) + dev::h256::size);
+}
+
+void ContractStateHashTree::Flush() const {
+  if (m_flushed && m_dirtyBuckets.empty()) {
+    return;
+  }
+
+  set<uint16_t> dirtyBranches;
+  for (const auto& index : m_dirtyBuckets) {
+    auto bucket = m_buckets.find(index);
+    if (bucket == m_buckets.end()) {
+      m_bucketHashes.erase(index);
+    } else {
+      m_bucketHashes[index] = HashBucket(bucket->second);
+    }
+    dirtyBranches.insert(index / BUCKETS_PER_BRANCH);
+  }
+  m_dirtyBuckets.clear();
+
+  for (const auto& branch : dirtyBranches) {
+    const unsigned int begin = branch * BUCKETS_PER_BRANCH;
+    const dev::h256 hash = HashChildren(m_bucketHashes, {}, begin,
+                                        begin + BUCKETS_PER_BRANCH);
+    if (hash == dev::h256()) {
+      m_branchHashes.erase(branch);
+    } else {
+      m_branchHashes[branch] = hash;
+    }
+  }
+
+  m_rootHash = HashChildren(m_branchHashes, {}, 0,
+                            NUM_BUCKETS / BUCKETS_PER_BRANCH);
+  if (m_rootHash == dev::h256()) {
+    m_rootHash = GetEmptyHash();
+  }
+  m_flushed = true;
+}
+
+dev::h256 ContractStateHashTree::GetRootHash() const {
+  Flush();
+  return m_rootHash;
+}
+
+dev::h256 ContractStateHashTree::GetRootHash(const Changes& changes) const {
+  Flush();
+  if (changes.empty()) {
+    return m_rootHash;
+  }
+
+  map<uint16_t, vector<Changes::const_iterator>> changesByBucket;
+  for (auto it = changes.begin(); it != changes.end(); ++it) {
+    changesByBucket[GetBucketIndex(it->first)].emplace_back(it);
+  }
+
+  map<uint16_t, dev::h256> bucketHashes;
+  set<uint16_t> branches;
+  for (const auto& entry : changesByBucket) {
+    auto found = m_buckets.find(entry.first);
+    Bucket bucket = (found != m_buckets.end()) ? found->second : Bucket();
+    for (const auto& change : entry.second) {
+      if (change->second == nullptr) {
+        bucket.erase(change->first);
+      } else {
+        bucket[change->first] = GetLeafHash(change->first, *change->second);
+      }
+    }
+    bucketHashes[entry.first] = HashBucket(bucket);
+    branches.insert(entry.first / BUCKETS_PER_BRANCH);
+  }
+
+  map<uint16_t, dev::h256> branchHashes;
+  for (const auto& branch : branches) {
+    const unsigned int begin = branch * BUCKETS_PER_BRANCH;
+    branchHashes[branch] = HashChildren(m_bucketHashes, bucketHashes, begin,
+                                        begin + BUCKETS_PER_BRANCH);
+  }
+
+  const dev::h256 rootHash = HashChildren(m_branchHashes, branchHashes, 0,
+                                          NUM_BUCKETS / BUCKETS_PER_BRANCH);
+  return (rootHash == dev::h256()) ? GetEmptyHash() : rootHash;
+}
+
+}  // namespace Contract
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBPERSISTENCE_CONTRACTSTATEHASHTREE_H_
+#define ZILLIQA_SRC_LIBPERSISTENCE_CONTRACTSTATEHASHTREE_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "common/BaseType.h"
+#include "depends/common/FixedHash.h"
+
+namespace Contract {
+
+/// Hash over the states of one contract that is updated per changed key.
+/// A key falls into one of 65536 buckets by the first two bytes of its hash,
+/// and the buckets sit under 256 branches below the root. A bucket hashes its
+/// leaves in key order, while a branch or the root hashes its non-empty
+/// children with their index. The hash only depends on the states, and a
+/// changed key only rehashes its bucket, its branch and the root.
+class ContractStateHashTree {
+ public:
+  /// New value of each changed key, or nullptr if the key is deleted
+  using Changes = std::map<std::string, const bytes*>;
+
+  void Set(const std::string& key, const bytes& value);
+
+  void Erase(const std::string& key);
+
+  size_t Size() const { return m_size; }
+
+  /// Returns the bytes held by the keys and hashes of the tree
+  size_t GetSizeInBytes() const;
+
+  /// Returns the hash of the states held
+  dev::h256 GetRootHash() const;
+
+  /// Returns the hash the states would have with the changes applied,
+  /// leaving the tree as it is
+  dev::h256 GetRootHash(const Changes& changes) const;
+
+ private:
+  // Leaf hash of each key in the bucket
+  using Bucket = std::map<std::string, dev::h256>;
+
+  static uint16_t GetBucketIndex(const std::string& key);
+  static dev::h256 GetLeafHash(const std::string& key, const bytes& value);
+  static dev::h256 HashBucket(const Bucket& bucket);
+
+  /// Hashes the children in [begin, end) with their index byte, taking the
+  /// hash of a child from overrides when it has one there. A zero hash
+  /// stands for an empty child and is skipped. Returns a zero hash if all
+  /// children are empty.
+  static dev::h256 HashChildren(const std::map<uint16_t, dev::h256>& children,
+                                const std::map<uint16_t, dev::h256>& overrides,
+                                unsigned int begin, unsigned int end);
+
+  void Flush() const;
+
+  std::unordered_map<uint16_t, Bucket> m_buckets;
+  size_t m_size{0};
+
+  // Hashes of the non-empty buckets and branches as of the last Flush
+  mutable std::map<uint16_t, dev::h256> m_bucketHashes;
+  mutable std::map<uint16_t, dev::h256> m_branchHashes;
+  mutable dev::h256 m_rootHash;
+  mutable std::set<uint16_t> m_dirtyBuckets;
+  mutable bool m_flushed{false};
+};
+
+}  // namespace Contract
+
+#endif  // ZILLIQA_SRC_LIBPERSISTENCE_CONTRACTSTATEHASHTREE_H_
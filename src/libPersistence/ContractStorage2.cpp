@@ -16,6 +16,7 @@
  */
 
 #include "ContractStorage2.h"
+#include "StorageKeyBuilder.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -26,6 +27,7 @@
 #include "libMessage/Messenger.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/JsonUtils.h"
+#include "libUtils/MemoryStats.h"
 
 #include <bits/stdc++.h>
 #include <boost/algorithm/string.hpp>
@@ -34,29 +36,83 @@ using namespace std;
 using namespace ZilliqaMessage;
 
 namespace Contract {
+ContractStorage2::ContractStorage2()
+    : m_codeDB("contractCode"),
+      m_initDataDB("contractInitState2"),
+      m_stateDataDB("contractStateData2"),
+      m_checkerOutputDB("contractCheckerOutput"),
+      m_codeCache(GetCodeCacheCapacity()),
+      m_initDataCache(GetCodeCacheCapacity()) {
+  MemoryStats::GetInstance().Register(
+      "ContractStorage", [this]() { return GetBufferSizeInBytes(); });
+}
+
+ContractStorage2::~ContractStorage2() {
+  MemoryStats::GetInstance().Unregister("ContractStorage");
+}
+
+size_t ContractStorage2::GetCodeCacheCapacity() {
+  return static_cast<size_t>(CONTRACT_CODE_CACHE_SIZE_IN_MB) * 1024 * 1024 / 2;
+}
+
+shared_ptr<const bytes> ContractStorage2::GetCached(
+    BlockCache<string, const bytes>& cache, LevelDB& db, mutex& dbMutex,
+    const string& key) {
+  shared_ptr<const bytes> value;
+  if (cache.Lookup(key, value)) {
+    return value;
+  }
+
+  // Inserted under the lock held by the writers when they erase it, so that a
+  // value read before a write is not cached after it
+  lock_guard<mutex> g(dbMutex);
+  const string raw = db.Lookup(key);
+  if (raw.empty()) {
+    return nullptr;
+  }
+  value = make_shared<const bytes>(raw.begin(), raw.end());
+  cache.Insert(key, value, raw.size());
+  return value;
+}
+
 // Code
 // ======================================
 
 bool ContractStorage2::PutContractCode(const dev::h160& address,
                                        const bytes& code) {
   lock_guard<mutex> g(m_codeMutex);
-  return m_codeDB.Insert(address.hex(), code) == 0;
+  const string key = address.hex();
+  const bool ret = m_codeDB.Insert(key, code) == 0;
+  m_codeCache.Erase(key);
+  return ret;
 }
 
 bool ContractStorage2::PutContractCodeBatch(
     const unordered_map<string, string>& batch) {
   lock_guard<mutex> g(m_codeMutex);
-  return m_codeDB.BatchInsert(batch);
+  const bool ret = m_codeDB.BatchInsert(batch);
+  for (const auto& entry : batch) {
+    m_codeCache.Erase(entry.first);
+  }
+  return ret;
 }
 
 bytes ContractStorage2::GetContractCode(const dev::h160& address) {
-  lock_guard<mutex> g(m_codeMutex);
-  return DataConversion::StringToCharArray(m_codeDB.Lookup(address.hex()));
+  const auto code = GetContractCodeShared(address);
+  return code ? *code : bytes();
+}
+
+shared_ptr<const bytes> ContractStorage2::GetContractCodeShared(
+    const dev::h160& address) {
+  return GetCached(m_codeCache, m_codeDB, m_codeMutex, address.hex());
 }
 
 bool ContractStorage2::DeleteContractCode(const dev::h160& address) {
   lock_guard<mutex> g(m_codeMutex);
-  return m_codeDB.DeleteKey(address.hex()) == 0;
+  const string key = address.hex();
+  const bool ret = m_codeDB.DeleteKey(key) == 0;
+  m_codeCache.Erase(key);
+  return ret;
 }
 
 // InitData
@@ -64,48 +120,86 @@ bool ContractStorage2::DeleteContractCode(const dev::h160& address) {
 bool ContractStorage2::PutInitData(const dev::h160& address,
                                    const bytes& initData) {
   lock_guard<mutex> g(m_initDataMutex);
-  return m_initDataDB.Insert(address.hex(), initData) == 0;
+  const string key = address.hex();
+  const bool ret = m_initDataDB.Insert(key, initData) == 0;
+  m_initDataCache.Erase(key);
+  return ret;
 }
 
 bool ContractStorage2::PutInitDataBatch(
     const unordered_map<string, string>& batch) {
   lock_guard<mutex> g(m_initDataMutex);
-  return m_initDataDB.BatchInsert(batch);
+  const bool ret = m_initDataDB.BatchInsert(batch);
+  for (const auto& entry : batch) {
+    m_initDataCache.Erase(entry.first);
+  }
+  return ret;
 }
 
 bytes ContractStorage2::GetInitData(const dev::h160& address) {
-  lock_guard<mutex> g(m_initDataMutex);
-  return DataConversion::StringToCharArray(m_initDataDB.Lookup(address.hex()));
+  const auto initData = GetInitDataShared(address);
+  return initData ? *initData : bytes();
+}
+
+shared_ptr<const bytes> ContractStorage2::GetInitDataShared(
+    const dev::h160& address) {
+  return GetCached(m_initDataCache, m_initDataDB, m_initDataMutex,
+                   address.hex());
 }
 
 bool ContractStorage2::DeleteInitData(const dev::h160& address) {
   lock_guard<mutex> g(m_initDataMutex);
-  return m_initDataDB.DeleteKey(address.hex()) == 0;
+  const string key = address.hex();
+  const bool ret = m_initDataDB.DeleteKey(key) == 0;
+  m_initDataCache.Erase(key);
+  return ret;
 }
 // State
 // ========================================
 template <class T>
 bool SerializeToArray(const T& protoMessage, bytes& dst,
                       const unsigned int offset) {
-  if ((offset + protoMessage.ByteSize()) > dst.size()) {
-    dst.resize(offset + protoMessage.ByteSize());
+  const size_t size = protoMessage.ByteSizeLong();
+  if (size > INT_MAX) {
+    LOG_GENERAL(WARNING, "Message too large to serialize, size: " << size);
+    return false;
+  }
+
+  if ((offset + size) > dst.size()) {
+    dst.resize(offset + size);
   }
 
-  return protoMessage.SerializeToArray(dst.data() + offset,
-                                       protoMessage.ByteSize());
+  protoMessage.SerializeWithCachedSizesToArray(dst.data() + offset);
+  return true;
+}
+
+bool ContractStorage2::PutCheckerOutput(const string& key,
+                                        const string& output) {
+  lock_guard<mutex> g(m_checkerOutputMutex);
+  return m_checkerOutputDB.Insert(leveldb::Slice(key),
+                                 leveldb::Slice(output)) == 0;
+}
+
+bool ContractStorage2::GetCheckerOutput(const string& key, string& output) {
+  lock_guard<mutex> g(m_checkerOutputMutex);
+  if (!m_checkerOutputDB.Exists(key)) {
+    return false;
+  }
+  output = m_checkerOutputDB.Lookup(key);
+  return !output.empty();
 }
 
 string ContractStorage2::GenerateStorageKey(const dev::h160& addr,
                                             const string& vname,
                                             const vector<string>& indices) {
-  string ret = addr.hex();
+  StorageKeyBuilder builder(addr);
   if (!vname.empty()) {
-    ret += SCILLA_INDEX_SEPARATOR + vname + SCILLA_INDEX_SEPARATOR;
+    builder.AppendField(vname);
     for (const auto& index : indices) {
-      ret += index + SCILLA_INDEX_SEPARATOR;
+      builder.AppendIndex(index);
     }
   }
-  return ret;
+  return builder.Key();
 }
 
 bool ContractStorage2::FetchStateValue(const dev::h160& addr, const bytes& src,
@@ -145,14 +239,14 @@ bool ContractStorage2::FetchStateValue(const dev::h160& addr, const bytes& src,
     return false;
   }
 
-  string key = addr.hex() + SCILLA_INDEX_SEPARATOR + query.name() +
-               SCILLA_INDEX_SEPARATOR;
-
-  ProtoScillaVal value;
-
+  StorageKeyBuilder builder(addr);
+  builder.AppendField(query.name());
   for (const auto& index : query.indices()) {
-    key += index + SCILLA_INDEX_SEPARATOR;
+    builder.AppendIndex(index);
   }
+  const string& key = builder.Key();
+
+  ProtoScillaVal value;
 
   if ((unsigned int)query.indices().size() > query.mapdepth()) {
     LOG_GENERAL(WARNING, "indices is deeper than map depth");
@@ -196,7 +290,7 @@ bool ContractStorage2::FetchStateValue(const dev::h160& addr, const bytes& src,
       }
     }
     if (!found) {
-      if (m_stateDataDB.Exists(key)) {
+      if (!IsDeletedByTempPrefix(key) && m_stateDataDB.Exists(key)) {
         if (query.ignoreval()) {
           return true;
         }
@@ -291,6 +385,11 @@ bool ContractStorage2::FetchStateValue(const dev::h160& addr, const bytes& src,
         t_stateDataMap.find(entry.first) == t_stateDataMap.end()) {
       continue;
     }
+    if (t_stateDataMap.find(entry.first) == t_stateDataMap.end() &&
+        m_stateDataMap.find(entry.first) == m_stateDataMap.end() &&
+        IsDeletedByTempPrefix(entry.first)) {
+      continue;
+    }
 
     counter++;
 
@@ -340,32 +439,112 @@ bool ContractStorage2::FetchStateValue(const dev::h160& addr, const bytes& src,
   return SerializeToArray(value, dst, 0);
 }
 
+ContractStorage2::TempJournal& ContractStorage2::GetJournal(
+    const string& index) {
+  if (p_sessionJournals.empty()) {
+    return p_journal;
+  }
+
+  // Every index starts with the address of its contract
+  const auto found = p_sessionJournals.find(index.substr(0, ACC_ADDR_SIZE * 2));
+  return found != p_sessionJournals.end() ? *found->second : p_journal;
+}
+
+void ContractStorage2::JournalTempState(const string& index) {
+  TempJournal& journal = GetJournal(index);
+  if (!journal.m_active ||
+      journal.m_prevStates.find(index) != journal.m_prevStates.end()) {
+    return;
+  }
+
+  PrevTempState& prev = journal.m_prevStates[index];
+  auto t_found = t_stateDataMap.find(index);
+  prev.m_exists = (t_found != t_stateDataMap.end());
+  if (prev.m_exists) {
+    prev.m_value = t_found->second;
+  }
+  prev.m_toBeDeleted =
+      (t_indexToBeDeleted.find(index) != t_indexToBeDeleted.end());
+}
+
+void ContractStorage2::SetTempStateData(const string& index,
+                                        const bytes& value) {
+  JournalTempState(index);
+  t_stateDataMap[index] = value;
+  auto pos = t_indexToBeDeleted.find(index);
+  if (pos != t_indexToBeDeleted.end()) {
+    t_indexToBeDeleted.erase(pos);
+  }
+}
+
+void ContractStorage2::MarkTempIndexToBeDeleted(const string& index) {
+  JournalTempState(index);
+  t_indexToBeDeleted.emplace(index);
+}
+
 void ContractStorage2::DeleteByPrefix(const string& prefix) {
   auto p = t_stateDataMap.lower_bound(prefix);
   while (p != t_stateDataMap.end() &&
          p->first.compare(0, prefix.size(), prefix) == 0) {
-    t_indexToBeDeleted.emplace(p->first);
+    MarkTempIndexToBeDeleted(p->first);
     ++p;
   }
 
   p = m_stateDataMap.lower_bound(prefix);
   while (p != m_stateDataMap.end() &&
          p->first.compare(0, prefix.size(), prefix) == 0) {
-    t_indexToBeDeleted.emplace(p->first);
+    MarkTempIndexToBeDeleted(p->first);
     ++p;
   }
 
-  auto it = m_stateDataDB.GetDB()->NewIterator(leveldb::ReadOptions());
-  it->Seek({prefix});
-  if (!it->Valid() ||
-      it->key().ToString().compare(0, prefix.size(), prefix) != 0) {
-    // no entry
-  } else {
-    for (; it->Valid() &&
-           it->key().ToString().compare(0, prefix.size(), prefix) == 0;
+  // The entries in the DB are deleted by the prefix instead of one by one
+  if (IsDeletedByTempPrefix(prefix)) {
+    return;
+  }
+  t_prefixesToBeDeleted.emplace(prefix);
+  TempJournal& journal = GetJournal(prefix);
+  if (journal.m_active && journal.m_prefixesCompacted.find(prefix) ==
+                              journal.m_prefixesCompacted.end()) {
+    journal.m_prefixesAdded.emplace(prefix);
+  }
+}
+
+bool ContractStorage2::IsDeletedByTempPrefix(const string& index) const {
+  if (t_prefixesToBeDeleted.empty()) {
+    return false;
+  }
+
+  // Prefixes end with a separator, so only those of the index are checked
+  for (size_t pos = index.find(SCILLA_INDEX_SEPARATOR); pos != string::npos;
+       pos = index.find(SCILLA_INDEX_SEPARATOR, pos + 1)) {
+    if (t_prefixesToBeDeleted.find(index.substr(0, pos + 1)) !=
+        t_prefixesToBeDeleted.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ContractStorage2::CompactTempPrefixDeletions(const string& prefix) {
+  auto r = t_prefixesToBeDeleted.lower_bound(prefix);
+  while (r != t_prefixesToBeDeleted.end() &&
+         r->compare(0, prefix.size(), prefix) == 0) {
+    unique_ptr<leveldb::Iterator> it(
+        m_stateDataDB.GetDB()->NewIterator(leveldb::ReadOptions()));
+    for (it->Seek({*r}); it->Valid() && it->key().starts_with(*r);
          it->Next()) {
-      t_indexToBeDeleted.emplace(it->key().ToString());
+      const string index = it->key().ToString();
+      if (t_stateDataMap.find(index) == t_stateDataMap.end() &&
+          m_stateDataMap.find(index) == m_stateDataMap.end()) {
+        MarkTempIndexToBeDeleted(index);
+      }
+    }
+
+    TempJournal& journal = GetJournal(*r);
+    if (journal.m_active) {
+      journal.m_prefixesCompacted.emplace(*r);
     }
+    r = t_prefixesToBeDeleted.erase(r);
   }
 }
 
@@ -375,7 +554,7 @@ void ContractStorage2::DeleteByIndex(const string& index) {
     if (LOG_SC) {
       LOG_GENERAL(INFO, "delete index from t: " << index);
     }
-    t_indexToBeDeleted.emplace(index);
+    MarkTempIndexToBeDeleted(index);
     return;
   }
 
@@ -384,7 +563,7 @@ void ContractStorage2::DeleteByIndex(const string& index) {
     if (LOG_SC) {
       LOG_GENERAL(INFO, "delete index from m: " << index);
     }
-    t_indexToBeDeleted.emplace(index);
+    MarkTempIndexToBeDeleted(index);
     return;
   }
 
@@ -392,7 +571,7 @@ void ContractStorage2::DeleteByIndex(const string& index) {
     if (LOG_SC) {
       LOG_GENERAL(INFO, "delete index from db: " << index);
     }
-    t_indexToBeDeleted.emplace(index);
+    MarkTempIndexToBeDeleted(index);
   }
 }
 
@@ -487,6 +666,89 @@ bool ContractStorage2::FetchStateJsonForContract(Json::Value& _json,
                              << address.hex());
   }
 
+  return InsertStatesToJson(_json, address, states, map_depth_json);
+}
+
+bool ContractStorage2::FetchStateJsonPageForContract(
+    Json::Value& _json, const dev::h160& address, const string& startAfter,
+    unsigned int pageSize, string& nextStartAfter) {
+  lock_guard<mutex> g(m_stateDataMutex);
+
+  nextStartAfter.clear();
+  if (pageSize == 0) {
+    LOG_GENERAL(WARNING, "Page size cannot be 0");
+    return false;
+  }
+  const string prefix = address.hex() + SCILLA_INDEX_SEPARATOR;
+  if (!startAfter.empty() && startAfter.compare(0, prefix.size(), prefix)) {
+    LOG_GENERAL(WARNING, "Cursor is not a state of contract " << address);
+    return false;
+  }
+  const string& start = startAfter.empty() ? prefix : startAfter;
+  auto inContract = [&prefix](const string& key) {
+    return key.compare(0, prefix.size(), prefix) == 0;
+  };
+
+  // Merge the committed states in m_stateDataMap over the DB in key order,
+  // taking one entry more than the page to know whether there is a next one
+  std::map<std::string, bytes> states;
+  auto p = m_stateDataMap.upper_bound(start);
+  unique_ptr<leveldb::Iterator> it(
+      m_stateDataDB.GetDB()->NewIterator(leveldb::ReadOptions()));
+  it->Seek({start});
+  if (it->Valid() && it->key().ToString() == startAfter) {
+    it->Next();
+  }
+
+  while (states.size() <= pageSize) {
+    const bool hasMap = p != m_stateDataMap.end() && inContract(p->first);
+    const bool hasDB = it->Valid() && it->key().starts_with(prefix);
+    if (!hasMap && !hasDB) {
+      break;
+    }
+
+    string key;
+    bytes value;
+    const int order = !hasMap   ? 1
+                      : !hasDB ? -1
+                               : p->first.compare(it->key().ToString());
+    if (order <= 0) {
+      key = p->first;
+      value = p->second;
+      ++p;
+      if (order == 0) {
+        it->Next();
+      }
+    } else {
+      key = it->key().ToString();
+      value.assign(it->value().data(), it->value().data() + it->value().size());
+      it->Next();
+    }
+
+    if (m_indexToBeDeleted.find(key) != m_indexToBeDeleted.end()) {
+      continue;
+    }
+    states.emplace(move(key), move(value));
+  }
+
+  if (states.size() > pageSize) {
+    states.erase(prev(states.end()));
+    nextStartAfter = states.rbegin()->first;
+  }
+
+  Json::Value map_depth_json;
+  if (!FetchContractFieldsMapDepth(address, map_depth_json, false)) {
+    LOG_GENERAL(WARNING, "FetchContractFieldsMapDepth failed for contract: "
+                             << address.hex());
+  }
+
+  return InsertStatesToJson(_json, address, states, map_depth_json);
+}
+
+bool ContractStorage2::InsertStatesToJson(Json::Value& _json,
+                                          const dev::h160& address,
+                                          const map<string, bytes>& states,
+                                          const Json::Value& map_depth_json) {
   for (const auto& state : states) {
     vector<string> fragments;
     boost::split(fragments, state.first,
@@ -580,14 +842,17 @@ void ContractStorage2::FetchStateDataForKey(map<string, bytes>& states,
     ++p;
   }
 
+  // Entries only in the DB are all deleted if a prefix covers the key
   auto it = m_stateDataDB.GetDB()->NewIterator(leveldb::ReadOptions());
   it->Seek({key});
-  if (!it->Valid() || it->key().ToString().compare(0, key.size(), key) != 0) {
+  if (!it->Valid() || it->key().ToString().compare(0, key.size(), key) != 0 ||
+      (temp && IsDeletedByTempPrefix(key))) {
     // no entry
   } else {
     for (; it->Valid() && it->key().ToString().compare(0, key.size(), key) == 0;
          it->Next()) {
-      if (states.find(it->key().ToString()) == states.end()) {
+      if (states.find(it->key().ToString()) == states.end() &&
+          !(temp && IsDeletedByTempPrefix(it->key().ToString()))) {
         bytes val(it->value().data(), it->value().data() + it->value().size());
         states.emplace(it->key().ToString(), val);
       }
@@ -624,6 +889,23 @@ void ContractStorage2::FetchStateDataForContract(map<string, bytes>& states,
   FetchStateDataForKey(states, key, temp);
 }
 
+void ContractStorage2::PrefetchStateData(const dev::h160& address) {
+  const string prefix = GenerateStorageKey(address, "", {});
+
+  lock_guard<mutex> g(m_stateDataMutex);
+  unique_ptr<leveldb::Iterator> it(
+      m_stateDataDB.GetDB()->NewIterator(leveldb::ReadOptions()));
+  size_t bytesRead = 0;
+  for (it->Seek({prefix}); it->Valid() && it->key().starts_with(prefix);
+       it->Next()) {
+    bytesRead += it->value().size();
+  }
+
+  if (LOG_SC) {
+    LOG_GENERAL(INFO, "Prefetched " << bytesRead << " bytes for " << address);
+  }
+}
+
 void ContractStorage2::FetchUpdatedStateValuesForAddress(
     const dev::h160& address, map<string, bytes>& t_states,
     vector<std::string>& toDeletedIndices, bool temp) {
@@ -638,24 +920,27 @@ void ContractStorage2::FetchUpdatedStateValuesForAddress(
     return;
   }
 
+  const string prefix = address.hex();
   if (temp) {
-    auto p = t_stateDataMap.lower_bound(address.hex());
+    CompactTempPrefixDeletions(prefix);
+
+    auto p = t_stateDataMap.lower_bound(prefix);
     while (p != t_stateDataMap.end() &&
-           p->first.compare(0, address.hex().size(), address.hex()) == 0) {
+           p->first.compare(0, prefix.size(), prefix) == 0) {
       t_states.emplace(p->first, p->second);
       ++p;
     }
 
-    auto r = t_indexToBeDeleted.lower_bound(address.hex());
+    auto r = t_indexToBeDeleted.lower_bound(prefix);
     while (r != t_indexToBeDeleted.end() &&
-           r->compare(0, address.hex().size(), address.hex()) == 0) {
+           r->compare(0, prefix.size(), prefix) == 0) {
       toDeletedIndices.emplace_back(*r);
       ++r;
     }
   } else {
-    auto p = m_stateDataMap.lower_bound(address.hex());
+    auto p = m_stateDataMap.lower_bound(prefix);
     while (p != m_stateDataMap.end() &&
-           p->first.compare(0, address.hex().size(), address.hex()) == 0) {
+           p->first.compare(0, prefix.size(), prefix) == 0) {
       if (t_states.find(p->first) == t_states.end()) {
         t_states.emplace(p->first, p->second);
       }
@@ -663,13 +948,13 @@ void ContractStorage2::FetchUpdatedStateValuesForAddress(
     }
 
     auto it = m_stateDataDB.GetDB()->NewIterator(leveldb::ReadOptions());
-    it->Seek({address.hex()});
-    if (!it->Valid() || it->key().ToString().compare(0, address.hex().size(),
-                                                     address.hex()) != 0) {
+    it->Seek({prefix});
+    if (!it->Valid() ||
+        it->key().ToString().compare(0, prefix.size(), prefix) != 0) {
       // no entry
     } else {
       for (; it->Valid() && it->key().ToString().compare(
-                                0, address.hex().size(), address.hex()) == 0;
+                                0, prefix.size(), prefix) == 0;
            it->Next()) {
         if (t_states.find(it->key().ToString()) == t_states.end()) {
           bytes val(it->value().data(),
@@ -679,9 +964,9 @@ void ContractStorage2::FetchUpdatedStateValuesForAddress(
       }
     }
 
-    auto r = m_indexToBeDeleted.lower_bound(address.hex());
+    auto r = m_indexToBeDeleted.lower_bound(prefix);
     while (r != m_indexToBeDeleted.end() &&
-           r->compare(0, address.hex().size(), address.hex()) == 0) {
+           r->compare(0, prefix.size(), prefix) == 0) {
       toDeletedIndices.emplace_back(*r);
       ++r;
     }
@@ -722,12 +1007,7 @@ void ContractStorage2::UpdateStateData(const string& key, const bytes& value,
     CleanEmptyMapPlaceholders(key);
   }
 
-  auto pos = t_indexToBeDeleted.find(key);
-  if (pos != t_indexToBeDeleted.end()) {
-    t_indexToBeDeleted.erase(pos);
-  }
-
-  t_stateDataMap[key] = value;
+  SetTempStateData(key, value);
 }
 
 bool ContractStorage2::UpdateStateValue(const dev::h160& addr, const bytes& q,
@@ -771,8 +1051,8 @@ bool ContractStorage2::UpdateStateValue(const dev::h160& addr, const bytes& q,
     return false;
   }
 
-  string key = addr.hex() + SCILLA_INDEX_SEPARATOR + query.name() +
-               SCILLA_INDEX_SEPARATOR;
+  StorageKeyBuilder builder(addr);
+  builder.AppendField(query.name());
 
   if (query.ignoreval()) {
     if (query.indices().size() < 1) {
@@ -780,11 +1060,11 @@ bool ContractStorage2::UpdateStateValue(const dev::h160& addr, const bytes& q,
       return false;
     }
     for (int i = 0; i < query.indices().size() - 1; ++i) {
-      key += query.indices().Get(i) + SCILLA_INDEX_SEPARATOR;
+      builder.AppendIndex(query.indices().Get(i));
     }
-    string parent_key = key;
-    key += query.indices().Get(query.indices().size() - 1) +
-           SCILLA_INDEX_SEPARATOR;
+    const string parent_key = builder.Key();
+    builder.AppendIndex(query.indices().Get(query.indices().size() - 1));
+    const string& key = builder.Key();
     if (LOG_SC) {
       LOG_GENERAL(INFO, "Delete key: " << key);
     }
@@ -804,8 +1084,9 @@ bool ContractStorage2::UpdateStateValue(const dev::h160& addr, const bytes& q,
     }
   } else {
     for (const auto& index : query.indices()) {
-      key += index + SCILLA_INDEX_SEPARATOR;
+      builder.AppendIndex(index);
     }
+    const string& key = builder.Key();
 
     if ((unsigned int)query.indices().size() > query.mapdepth()) {
       LOG_GENERAL(WARNING, "indices is deeper than map depth");
@@ -821,29 +1102,32 @@ bool ContractStorage2::UpdateStateValue(const dev::h160& addr, const bytes& q,
     } else {
       DeleteByPrefix(key);
 
-      std::function<bool(const string&, const ProtoScillaVal&)> mapHandler =
-          [&](const string& keyAcc, const ProtoScillaVal& value) -> bool {
+      // The key of each entry is built on the prefix of its parent map
+      std::function<bool(const ProtoScillaVal&)> mapHandler =
+          [&](const ProtoScillaVal& value) -> bool {
         if (!value.has_mval()) {
           LOG_GENERAL(WARNING, "val is not map but supposed to be");
           return false;
         }
         if (value.mval().m().empty()) {
-          // We have an empty map. Insert an entry for keyAcc in
+          // We have an empty map. Insert an entry for the key in
           // the store to indicate that the key itself exists.
           bytes dst;
           if (!SerializeToArray(value, dst, 0)) {
             return false;
           }
           // DB Put
-          UpdateStateData(keyAcc, dst, true);
+          UpdateStateData(builder.Key(), dst, true);
           return true;
         }
+        const size_t prefixSize = builder.Size();
         for (const auto& entry : value.mval().m()) {
-          string index(keyAcc);
-          index += entry.first + SCILLA_INDEX_SEPARATOR;
+          builder.Truncate(prefixSize);
+          builder.AppendIndex(entry.first);
+          const string& index = builder.Key();
           if (entry.second.has_mval()) {
             // We haven't reached the deepeast nesting
-            if (!mapHandler(index, entry.second)) {
+            if (!mapHandler(entry.second)) {
               return false;
             }
           } else {
@@ -861,7 +1145,7 @@ bool ContractStorage2::UpdateStateValue(const dev::h160& addr, const bytes& q,
         return true;
       };
 
-      return mapHandler(key, value);
+      return mapHandler(value);
     }
   }
   return true;
@@ -879,14 +1163,10 @@ void ContractStorage2::UpdateStateDatasAndToDeletes(
 
   if (temp) {
     for (const auto& state : t_states) {
-      t_stateDataMap[state.first] = state.second;
-      auto pos = t_indexToBeDeleted.find(state.first);
-      if (pos != t_indexToBeDeleted.end()) {
-        t_indexToBeDeleted.erase(pos);
-      }
+      SetTempStateData(state.first, state.second);
     }
     for (const auto& index : toDeleteIndices) {
-      t_indexToBeDeleted.emplace(index);
+      MarkTempIndexToBeDeleted(index);
     }
   } else {
     for (const auto& state : t_states) {
@@ -917,18 +1197,76 @@ void ContractStorage2::UpdateStateDatasAndToDeletes(
   stateHash = GetContractStateHash(addr, temp);
 }
 
-void ContractStorage2::BufferCurrentState() {
+void ContractStorage2::BufferCurrentState(const dev::h160& address) {
   LOG_MARKER();
   lock_guard<mutex> g(m_stateDataMutex);
-  p_stateDataMap = t_stateDataMap;
-  p_indexToBeDeleted = m_indexToBeDeleted;
+  TempJournal& journal = GetJournal(address.hex());
+  journal = TempJournal();
+  journal.m_active = true;
 }
 
-void ContractStorage2::RevertPrevState() {
+void ContractStorage2::RevertPrevState(const dev::h160& address) {
   LOG_MARKER();
   lock_guard<mutex> g(m_stateDataMutex);
-  t_stateDataMap = std::move(p_stateDataMap);
-  m_indexToBeDeleted = std::move(p_indexToBeDeleted);
+  // The journal is kept, so that ending its session can still undo all of
+  // the changes of the call
+  TempJournal& journal = GetJournal(address.hex());
+  RevertJournal(journal, false);
+  journal.m_active = false;
+}
+
+void ContractStorage2::RevertJournal(const TempJournal& journal,
+                                     bool revertDeletions) {
+  for (const auto& entry : journal.m_prevStates) {
+    if (entry.second.m_exists) {
+      t_stateDataMap[entry.first] = entry.second.m_value;
+    } else {
+      t_stateDataMap.erase(entry.first);
+    }
+    if (!revertDeletions) {
+      continue;
+    }
+    if (entry.second.m_toBeDeleted) {
+      t_indexToBeDeleted.emplace(entry.first);
+    } else {
+      t_indexToBeDeleted.erase(entry.first);
+    }
+  }
+  if (!revertDeletions) {
+    return;
+  }
+  for (const auto& prefix : journal.m_prefixesCompacted) {
+    t_prefixesToBeDeleted.emplace(prefix);
+  }
+  for (const auto& prefix : journal.m_prefixesAdded) {
+    t_prefixesToBeDeleted.erase(prefix);
+  }
+}
+
+void ContractStorage2::BeginTempSession(const vector<dev::h160>& addresses) {
+  lock_guard<mutex> g(m_stateDataMutex);
+  auto journal = make_shared<TempJournal>();
+  for (const auto& address : addresses) {
+    p_sessionJournals[address.hex()] = journal;
+  }
+}
+
+void ContractStorage2::EndTempSession(const dev::h160& address, bool revert) {
+  lock_guard<mutex> g(m_stateDataMutex);
+  const auto found = p_sessionJournals.find(address.hex());
+  if (found == p_sessionJournals.end()) {
+    return;
+  }
+
+  // The transactions of a session rolled back are executed again, so they
+  // have to start from the state before them
+  const auto journal = found->second;
+  if (revert) {
+    RevertJournal(*journal, true);
+  }
+  for (auto it = p_sessionJournals.begin(); it != p_sessionJournals.end();) {
+    it = (it->second == journal) ? p_sessionJournals.erase(it) : next(it);
+  }
 }
 
 void ContractStorage2::RevertContractStates() {
@@ -979,16 +1317,20 @@ bool ContractStorage2::CommitStateDB() {
   }
   if (!m_stateDataDB.BatchInsert(batch)) {
     LOG_GENERAL(WARNING, "BatchInsert m_stateDataDB failed");
+    m_stateHashTrees.clear();
     return false;
   }
   // ToDelete
   for (const auto& index : m_indexToBeDeleted) {
     if (m_stateDataDB.DeleteKey(index) < 0) {
       LOG_GENERAL(WARNING, "DeleteKey " << index << " failed");
+      m_stateHashTrees.clear();
       return false;
     }
   }
 
+  UpdateStoredStateHashTrees();
+
   m_stateDataMap.clear();
   m_indexToBeDeleted.clear();
 
@@ -1000,6 +1342,9 @@ bool ContractStorage2::CommitStateDB() {
 void ContractStorage2::InitTempStateCore() {
   t_stateDataMap.clear();
   t_indexToBeDeleted.clear();
+  t_prefixesToBeDeleted.clear();
+  p_journal = TempJournal();
+  p_sessionJournals.clear();
 }
 
 void ContractStorage2::InitTempState(bool callFromExternal) {
@@ -1020,6 +1365,37 @@ dev::h256 ContractStorage2::GetContractStateHashCore(const dev::h160& address,
     return dev::h256();
   }
 
+  if (CONTRACT_STATE_HASH_TREE) {
+    // Same precedence as FetchStateDataForKey: m_ over the DB, t_ over m_,
+    // and a deletion over a value in the same or a lower layer
+    const string prefix = GenerateStorageKey(address, "", {});
+    ContractStateHashTree::Changes changes;
+    auto addValues = [&prefix, &changes](const map<string, bytes>& values) {
+      for (auto it = values.lower_bound(prefix);
+           it != values.end() &&
+           it->first.compare(0, prefix.size(), prefix) == 0;
+           ++it) {
+        changes[it->first] = &it->second;
+      }
+    };
+    auto addDeletions = [&prefix, &changes](const set<string>& indices) {
+      for (auto it = indices.lower_bound(prefix);
+           it != indices.end() && it->compare(0, prefix.size(), prefix) == 0;
+           ++it) {
+        changes[*it] = nullptr;
+      }
+    };
+
+    addValues(m_stateDataMap);
+    addDeletions(m_indexToBeDeleted);
+    if (temp) {
+      CompactTempPrefixDeletions(prefix);
+      addValues(t_stateDataMap);
+      addDeletions(t_indexToBeDeleted);
+    }
+    return GetStoredStateHashTree(prefix).GetRootHash(changes);
+  }
+
   std::map<std::string, bytes> states;
   FetchStateDataForContract(states, address, "", {}, temp);
 
@@ -1041,6 +1417,55 @@ dev::h256 ContractStorage2::GetContractStateHashCore(const dev::h160& address,
   return ret;
 }
 
+const ContractStateHashTree& ContractStorage2::GetStoredStateHashTree(
+    const string& prefix) {
+  auto found = m_stateHashTrees.find(prefix);
+  if (found != m_stateHashTrees.end()) {
+    return found->second;
+  }
+
+  ContractStateHashTree& tree = m_stateHashTrees[prefix];
+  unique_ptr<leveldb::Iterator> it(
+      m_stateDataDB.GetDB()->NewIterator(leveldb::ReadOptions()));
+  for (it->Seek({prefix}); it->Valid() && it->key().starts_with(prefix);
+       it->Next()) {
+    const bytes value(it->value().data(),
+                      it->value().data() + it->value().size());
+    tree.Set(it->key().ToString(), value);
+  }
+
+  if (LOG_SC) {
+    LOG_GENERAL(INFO, "Built state hash tree of " << prefix << " with "
+                                                  << tree.Size() << " states");
+  }
+  return tree;
+}
+
+void ContractStorage2::UpdateStoredStateHashTrees() {
+  if (m_stateHashTrees.empty()) {
+    return;
+  }
+
+  // A key starts with the address of its contract
+  const size_t prefixSize = dev::h160().hex().size();
+  auto findTree = [prefixSize, this](const string& key) {
+    return m_stateHashTrees.find(key.substr(0, prefixSize));
+  };
+
+  for (const auto& i : m_stateDataMap) {
+    auto tree = findTree(i.first);
+    if (tree != m_stateHashTrees.end()) {
+      tree->second.Set(i.first, i.second);
+    }
+  }
+  for (const auto& index : m_indexToBeDeleted) {
+    auto tree = findTree(index);
+    if (tree != m_stateHashTrees.end()) {
+      tree->second.Erase(index);
+    }
+  }
+}
+
 dev::h256 ContractStorage2::GetContractStateHash(const dev::h160& address,
                                                  bool temp,
                                                  bool callFromExternal) {
@@ -1056,30 +1481,72 @@ dev::h256 ContractStorage2::GetContractStateHash(const dev::h160& address,
   }
 }
 
+uint64_t ContractStorage2::GetBufferSizeInBytes() {
+  lock_guard<mutex> g(m_stateDataMutex);
+
+  uint64_t sizeInBytes = 0;
+  for (const auto& stateDataMap : {&m_stateDataMap, &t_stateDataMap}) {
+    for (const auto& entry : *stateDataMap) {
+      sizeInBytes += entry.first.size() + entry.second.size();
+    }
+  }
+  for (const auto& entry : r_stateDataMap) {
+    sizeInBytes += entry.first.size() + entry.second.size();
+  }
+  for (const auto& indices :
+       {&m_indexToBeDeleted, &t_indexToBeDeleted, &t_prefixesToBeDeleted}) {
+    for (const auto& index : *indices) {
+      sizeInBytes += index.size();
+    }
+  }
+  for (const auto& entry : r_indexToBeDeleted) {
+    sizeInBytes += entry.first.size() + sizeof(bool);
+  }
+  // The contracts of a session share its journal
+  set<const TempJournal*> journals{&p_journal};
+  for (const auto& journal : p_sessionJournals) {
+    journals.insert(journal.second.get());
+  }
+  for (const auto& journal : journals) {
+    for (const auto& entry : journal->m_prevStates) {
+      sizeInBytes += entry.first.size() + entry.second.m_value.size();
+    }
+  }
+  for (const auto& tree : m_stateHashTrees) {
+    sizeInBytes += tree.first.size() + tree.second.GetSizeInBytes();
+  }
+  return sizeInBytes;
+}
+
 void ContractStorage2::Reset() {
   {
     lock_guard<mutex> g(m_codeMutex);
     m_codeDB.ResetDB();
+    m_codeCache.Clear();
   }
   {
     lock_guard<mutex> g(m_initDataMutex);
     m_initDataDB.ResetDB();
+    m_initDataCache.Clear();
   }
   {
     lock_guard<mutex> g(m_stateDataMutex);
     m_stateDataDB.ResetDB();
 
-    p_stateDataMap.clear();
-    p_indexToBeDeleted.clear();
+    p_journal = TempJournal();
+    p_sessionJournals.clear();
 
     t_stateDataMap.clear();
     t_indexToBeDeleted.clear();
+    t_prefixesToBeDeleted.clear();
 
     r_stateDataMap.clear();
     r_indexToBeDeleted.clear();
 
     m_stateDataMap.clear();
     m_indexToBeDeleted.clear();
+
+    m_stateHashTrees.clear();
   }
 }
 
@@ -1088,14 +1555,17 @@ bool ContractStorage2::RefreshAll() {
   {
     lock_guard<mutex> g(m_codeMutex);
     ret = m_codeDB.RefreshDB();
+    m_codeCache.Clear();
   }
   if (ret) {
     lock_guard<mutex> g(m_initDataMutex);
     ret = m_initDataDB.RefreshDB();
+    m_initDataCache.Clear();
   }
   if (ret) {
     lock_guard<mutex> g(m_stateDataMutex);
     ret = m_stateDataDB.RefreshDB();
+    m_stateHashTrees.clear();
   }
   return ret;
 }
@@ -25,6 +25,8 @@
 #include "common/Constants.h"
 #include "common/Singleton.h"
 #include "depends/libDatabase/LevelDB.h"
+#include "libPersistence/BlockCache.h"
+#include "libPersistence/ContractStateHashTree.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -45,6 +47,14 @@ class ContractStorage2 : public Singleton<ContractStorage2> {
   LevelDB m_codeDB;
   LevelDB m_initDataDB;
   LevelDB m_stateDataDB;
+  // Output of the scilla checker by code hash and scilla version. Derived
+  // from the code only, so it is kept across Reset.
+  LevelDB m_checkerOutputDB;
+
+  // Code and init data by address hex. They only change on deploy and
+  // delete, so the readers share them without copying or locking the DBs.
+  BlockCache<std::string, const bytes> m_codeCache;
+  BlockCache<std::string, const bytes> m_initDataCache;
 
   // Used by AccountStore
   std::map<std::string, bytes> m_stateDataMap;
@@ -53,8 +63,24 @@ class ContractStorage2 : public Singleton<ContractStorage2> {
   std::map<std::string, bytes> t_stateDataMap;
 
   // Used for revert state due to failure in chain call
-  std::map<std::string, bytes> p_stateDataMap;
-  std::set<std::string> p_indexToBeDeleted;
+  // Prior t_ state of each index changed since BufferCurrentState
+  struct PrevTempState {
+    bool m_exists;
+    bytes m_value;
+    bool m_toBeDeleted;
+  };
+  struct TempJournal {
+    std::unordered_map<std::string, PrevTempState> m_prevStates;
+    bool m_active{false};
+    // Prefixes added to and compacted from t_prefixesToBeDeleted since
+    // BufferCurrentState
+    std::set<std::string> m_prefixesAdded;
+    std::set<std::string> m_prefixesCompacted;
+  };
+  TempJournal p_journal;
+  // Journals of the contracts in a temp session, by address
+  std::unordered_map<std::string, std::shared_ptr<TempJournal>>
+      p_sessionJournals;
 
   // Used for RevertCommitTemp
   std::unordered_map<std::string, bytes> r_stateDataMap;
@@ -65,12 +91,43 @@ class ContractStorage2 : public Singleton<ContractStorage2> {
   std::set<std::string> m_indexToBeDeleted;
   std::set<std::string> t_indexToBeDeleted;
 
+  // Map prefixes deleted in t_ without listing their entries. They delete
+  // the entries that are only in m_stateDataDB, and are turned into
+  // t_indexToBeDeleted when the deletions have to be listed.
+  std::set<std::string> t_prefixesToBeDeleted;
+
+  // Hash trees of the states in m_stateDataDB, by contract address
+  std::unordered_map<std::string, ContractStateHashTree> m_stateHashTrees;
+
   mutable std::mutex m_codeMutex;
   mutable std::mutex m_initDataMutex;
   mutable std::mutex m_stateDataMutex;
+  mutable std::mutex m_checkerOutputMutex;
+
+  /// The journal of the session holding the contract of the index, or else
+  /// p_journal
+  TempJournal& GetJournal(const std::string& index);
+
+  /// Undo the changes to t_stateDataMap recorded in the journal, and those
+  /// to the deletions in the t_ sets too if revertDeletions
+  void RevertJournal(const TempJournal& journal, bool revertDeletions);
+
+  /// Record the current t_ state of index before it is first changed
+  void JournalTempState(const std::string& index);
+
+  void SetTempStateData(const std::string& index, const bytes& value);
+
+  void MarkTempIndexToBeDeleted(const std::string& index);
 
   void DeleteByPrefix(const std::string& prefix);
 
+  /// Whether a prefix in t_prefixesToBeDeleted covers the index
+  bool IsDeletedByTempPrefix(const std::string& index) const;
+
+  /// Lists the entries deleted by the prefixes under the given one in
+  /// t_indexToBeDeleted and drops those prefixes
+  void CompactTempPrefixDeletions(const std::string& prefix);
+
   void DeleteByIndex(const std::string& index);
 
   void UpdateStateData(const std::string& key, const bytes& value,
@@ -78,16 +135,36 @@ class ContractStorage2 : public Singleton<ContractStorage2> {
 
   bool CleanEmptyMapPlaceholders(const std::string& key);
 
+  bool InsertStatesToJson(Json::Value& _json, const dev::h160& address,
+                          const std::map<std::string, bytes>& states,
+                          const Json::Value& map_depth_json);
+
   dev::h256 GetContractStateHashCore(const dev::h160& address, bool temp);
 
+  /// Hash tree of the states in m_stateDataDB, built on first use
+  const ContractStateHashTree& GetStoredStateHashTree(
+      const std::string& prefix);
+
+  /// Applies the committed changes to the hash trees built so far
+  void UpdateStoredStateHashTrees();
+
   void InitTempStateCore();
 
-  ContractStorage2()
-      : m_codeDB("contractCode"),
-        m_initDataDB("contractInitState2"),
-        m_stateDataDB("contractStateData2"){};
+  static size_t GetCodeCacheCapacity();
 
-  ~ContractStorage2() = default;
+  /// Returns the value of key in db through cache, reading it from db under
+  /// dbMutex on a miss
+  static std::shared_ptr<const bytes> GetCached(
+      BlockCache<std::string, const bytes>& cache, LevelDB& db,
+      std::mutex& dbMutex, const std::string& key);
+
+  /// Returns the bytes of the states buffered in the maps and of the hash
+  /// trees built so far
+  uint64_t GetBufferSizeInBytes();
+
+  ContractStorage2();
+
+  ~ContractStorage2();
 
  public:
   /// Returns the singleton ContractStorage instance.
@@ -106,6 +183,10 @@ class ContractStorage2 : public Singleton<ContractStorage2> {
   /// Get the desired code from persistence
   bytes GetContractCode(const dev::h160& address);
 
+  /// Get the desired code without copying it, nullptr if there is none
+  std::shared_ptr<const bytes> GetContractCodeShared(
+      const dev::h160& address);
+
   /// Delete the contract code in persistence
   bool DeleteContractCode(const dev::h160& address);
 
@@ -117,8 +198,15 @@ class ContractStorage2 : public Singleton<ContractStorage2> {
 
   bytes GetInitData(const dev::h160& address);
 
+  std::shared_ptr<const bytes> GetInitDataShared(const dev::h160& address);
+
   bool DeleteInitData(const dev::h160& address);
 
+  /////////////////////////////////////////////////////////////////////////////
+  bool PutCheckerOutput(const std::string& key, const std::string& output);
+
+  bool GetCheckerOutput(const std::string& key, std::string& output);
+
   /////////////////////////////////////////////////////////////////////////////
   std::string GenerateStorageKey(const dev::h160& addr,
                                  const std::string& vname,
@@ -140,6 +228,17 @@ class ContractStorage2 : public Singleton<ContractStorage2> {
                                  const std::vector<std::string>& indices = {},
                                  bool temp = false);
 
+  /// Fetches up to pageSize committed states of the contract that come after
+  /// startAfter in key order, or from the first state if it is empty, into
+  /// _json. nextStartAfter is set to the last key fetched if there are more
+  /// states, or else left empty. A map split over pages comes back in parts
+  /// that merge into the result of FetchStateJsonForContract.
+  bool FetchStateJsonPageForContract(Json::Value& _json,
+                                     const dev::h160& address,
+                                     const std::string& startAfter,
+                                     unsigned int pageSize,
+                                     std::string& nextStartAfter);
+
   void FetchStateDataForKey(std::map<std::string, bytes>& states,
                             const std::string& key, bool temp);
 
@@ -149,6 +248,10 @@ class ContractStorage2 : public Singleton<ContractStorage2> {
                                  const std::vector<std::string>& indices = {},
                                  bool temp = true);
 
+  /// Read the stored states of the contract ahead of its execution, so that
+  /// they are already in the LevelDB and OS caches when it runs
+  void PrefetchStateData(const dev::h160& address);
+
   void FetchUpdatedStateValuesForAddress(
       const dev::h160& address, std::map<std::string, bytes>& t_states,
       std::vector<std::string>& toDeletedIndices, bool temp = false);
@@ -162,11 +265,22 @@ class ContractStorage2 : public Singleton<ContractStorage2> {
       const std::vector<std::string>& toDeleteIndices, dev::h256& stateHash,
       bool temp, bool revertible);
 
-  /// Buffer the current t_map into p_map
-  void BufferCurrentState();
+  /// Start recording changes to the t_maps, in the journal of the session
+  /// holding address if there is one
+  void BufferCurrentState(const dev::h160& address = dev::h160());
+
+  /// Undo the changes to t_stateDataMap since BufferCurrentState. The
+  /// deletions made since then are kept, as they always have been.
+  void RevertPrevState(const dev::h160& address = dev::h160());
+
+  /// Journal the changes to the t_maps of these contracts on their own, so
+  /// that calls to disjoint contracts can run at the same time and each of
+  /// them can be reverted alone
+  void BeginTempSession(const std::vector<dev::h160>& addresses);
 
-  /// Revert the t_map from the p_map just buffered
-  void RevertPrevState();
+  /// Leave the session holding address, undoing its changes to the t_maps
+  /// since its BufferCurrentState if revert
+  void EndTempSession(const dev::h160& address, bool revert);
 
   /// Put the in-memory m_map into database
   bool CommitStateDB();
@@ -27,6 +27,19 @@
 #include "libPersistence/BlockStorage.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/FileSystem.h"
+#include "libUtils/OrderedPipeline.h"
+
+namespace {
+/// The block a block link refers to, per its type
+struct LinkedBlock {
+  DSBlockSharedPtr m_dsBlock;
+  VCBlockSharedPtr m_vcBlock;
+  FallbackBlockSharedPtr m_fallbackBlock;
+};
+
+/// Items loaded ahead of the one being replayed
+size_t GetRetrieverWindow() { return RETRIEVER_THREADS * 16; }
+}  // namespace
 
 Retriever::Retriever(Mediator& mediator) : m_mediator(mediator) {}
 
@@ -125,7 +138,25 @@ bool Retriever::RetrieveTxBlocks(bool trimIncompletedBlocks) {
 
     std::string target = STORAGE_PATH + PERSISTENCE_PATH + "/stateDelta";
     unsigned int firstStateDeltaIndex = lower_bound_txnblk;
-    for (unsigned int i = lower_bound_txnblk; i <= upper_bound_txnblk; i++) {
+
+    // The states on disk may already be those of a later vacuous epoch, as
+    // recorded by its checkpoint, so the state deltas up to it are not replayed
+    uint64_t checkpointBlockNum = 0;
+    StateHash checkpointRoot;
+    if (BlockStorage::GetBlockStorage().GetLatestStateRootCheckpoint(
+            checkpointBlockNum, checkpointRoot) &&
+        checkpointBlockNum >= lower_bound_txnblk &&
+        checkpointBlockNum <= upper_bound_txnblk &&
+        (checkpointBlockNum + 1) % NUM_FINAL_BLOCK_PER_POW == 0 &&
+        checkpointRoot == AccountStore::GetInstance().GetStateRootHash() &&
+        checkpointRoot ==
+            blocks.at(checkpointBlockNum)->GetHeader().GetStateRootHash()) {
+      LOG_GENERAL(INFO, "States on disk match the checkpoint of txnblk: "
+                            << checkpointBlockNum);
+      firstStateDeltaIndex = checkpointBlockNum + 1;
+    }
+
+    for (unsigned int i = firstStateDeltaIndex; i <= upper_bound_txnblk; i++) {
       // Check if StateDeltaFromS3/StateDelta_{i} exists and copy over to the
       // local persistence/stateDelta
       std::string source = STORAGE_PATH + STATEDELTAFROMS3_PATH +
@@ -146,32 +177,51 @@ bool Retriever::RetrieveTxBlocks(bool trimIncompletedBlocks) {
             return false;
           }
 
-          // generate state now for NUM_FINAL_BLOCK_PER_POW statedeltas
-          for (unsigned int j = firstStateDeltaIndex; j <= i; j++) {
-            bytes stateDelta;
+          // generate state now for NUM_FINAL_BLOCK_PER_POW statedeltas, with
+          // the statedeltas read ahead of their replay
+          using StateDelta = std::pair<bool, bytes>;
+          bool replayed = true;
+          size_t applied = 0;
+          auto readStateDelta = [firstStateDeltaIndex](size_t k,
+                                                       StateDelta& delta) {
+            delta.first = BlockStorage::GetBlockStorage().GetStateDelta(
+                firstStateDeltaIndex + k, delta.second);
+            return true;
+          };
+          auto replayStateDelta = [&](size_t k, StateDelta& delta) {
+            const unsigned int j = firstStateDeltaIndex + k;
             LOG_GENERAL(
                 INFO,
                 "Try fetching statedelta and deserializing to state for txnBlk:"
                     << j);
-            if (BlockStorage::GetBlockStorage().GetStateDelta(j, stateDelta)) {
-              if (!AccountStore::GetInstance().DeserializeDelta(stateDelta,
-                                                                0)) {
-                LOG_GENERAL(
-                    WARNING,
-                    "AccountStore::GetInstance().DeserializeDelta failed");
-                return false;
-              }
-              if (AccountStore::GetInstance().GetStateRootHash() !=
-                  (*std::next(blocks.begin(), j))
-                      ->GetHeader()
-                      .GetStateRootHash()) {
-                LOG_GENERAL(
-                    WARNING,
-                    "StateRoot in TxBlock(BlockNum: "
-                        << j << ") : does not match retrieved stateroot hash");
-                return false;
-              }
+            if (!delta.first) {
+              return true;
+            }
+            if (!AccountStore::GetInstance().DeserializeDelta(delta.second,
+                                                              0)) {
+              LOG_GENERAL(
+                  WARNING,
+                  "AccountStore::GetInstance().DeserializeDelta failed");
+              replayed = false;
+              return false;
+            }
+            if (AccountStore::GetInstance().GetStateRootHash() !=
+                blocks.at(j)->GetHeader().GetStateRootHash()) {
+              LOG_GENERAL(
+                  WARNING,
+                  "StateRoot in TxBlock(BlockNum: "
+                      << j << ") : does not match retrieved stateroot hash");
+              replayed = false;
+              return false;
             }
+            return true;
+          };
+          RunOrderedPipeline<StateDelta>(
+              "ReplayStateDeltas", i - firstStateDeltaIndex + 1,
+              RETRIEVER_THREADS, GetRetrieverWindow(), readStateDelta,
+              replayStateDelta, applied);
+          if (!replayed) {
+            return false;
           }
           // commit the state to disk
           if (!AccountStore::GetInstance().MoveUpdatesToDisk()) {
@@ -235,6 +285,34 @@ bool Retriever::RetrieveTxBlocks(bool trimIncompletedBlocks) {
   return true;
 }
 
+bool Retriever::RetrieveTxBlockHeaders() {
+  LOG_MARKER();
+  std::deque<TxBlockSharedPtr> blocks;
+  if (!BlockStorage::GetBlockStorage().GetAllTxBlocks(blocks)) {
+    LOG_GENERAL(WARNING, "RetrieveTxBlockHeaders skipped or incompleted");
+    return false;
+  }
+
+  sort(blocks.begin(), blocks.end(),
+       [](const TxBlockSharedPtr& a, const TxBlockSharedPtr& b) {
+         return a->GetHeader().GetBlockNum() < b->GetHeader().GetBlockNum();
+       });
+
+  for (const auto& block : blocks) {
+    m_mediator.m_node->AddBlock(*block);
+  }
+
+  return true;
+}
+
+bool Retriever::RecoverEpochCommit() {
+  if (!BlockStorage::GetBlockStorage().RecoverEpochCommit()) {
+    LOG_GENERAL(WARNING, "BlockStorage::RecoverEpochCommit failed");
+    return false;
+  }
+  return true;
+}
+
 bool Retriever::RetrieveBlockLink(bool trimIncompletedBlocks) {
   std::list<BlockLink> blocklinks;
 
@@ -313,20 +391,53 @@ bool Retriever::RetrieveBlockLink(bool trimIncompletedBlocks) {
     lastDsIndex--;
   }
 
-  std::list<BlockLink>::iterator blocklinkItr;
-  for (blocklinkItr = blocklinks.begin(); blocklinkItr != blocklinks.end();
-       ++blocklinkItr) {
-    const auto& blocklink = *blocklinkItr;
+  // The linked blocks are loaded ahead on RETRIEVER_THREADS threads, while
+  // the committee is rebuilt from them in the order of the links
+  const std::vector<BlockLink> links(blocklinks.begin(), blocklinks.end());
+  bool failed = false;
+  size_t applied = 0;
+
+  auto loadBlock = [&links](size_t i, LinkedBlock& block) -> bool {
+    const auto& blocklink = links.at(i);
 
     if (std::get<BlockLinkIndex::BLOCKTYPE>(blocklink) == BlockType::DS) {
-      DSBlockSharedPtr dsblock;
       if (!BlockStorage::GetBlockStorage().GetDSBlock(
-              std::get<BlockLinkIndex::DSINDEX>(blocklink), dsblock)) {
+              std::get<BlockLinkIndex::DSINDEX>(blocklink),
+              block.m_dsBlock)) {
         LOG_GENERAL(WARNING,
                     "Could not find ds block num "
                         << std::get<BlockLinkIndex::DSINDEX>(blocklink));
         return false;
       }
+    } else if (std::get<BlockLinkIndex::BLOCKTYPE>(blocklink) ==
+               BlockType::VC) {
+      if (!BlockStorage::GetBlockStorage().GetVCBlock(
+              std::get<BlockLinkIndex::BLOCKHASH>(blocklink),
+              block.m_vcBlock)) {
+        LOG_GENERAL(WARNING,
+                    "Could not find vc with blockHash "
+                        << std::get<BlockLinkIndex::BLOCKHASH>(blocklink));
+        return false;
+      }
+    } else if (std::get<BlockLinkIndex::BLOCKTYPE>(blocklink) ==
+               BlockType::FB) {
+      if (!BlockStorage::GetBlockStorage().GetFallbackBlock(
+              std::get<BlockLinkIndex::BLOCKHASH>(blocklink),
+              block.m_fallbackBlock)) {
+        LOG_GENERAL(WARNING,
+                    "Could not find vc with blockHash "
+                        << std::get<BlockLinkIndex::BLOCKHASH>(blocklink));
+        return false;
+      }
+    }
+    return true;
+  };
+
+  auto applyBlock = [&](size_t i, LinkedBlock& block) -> bool {
+    const auto& blocklink = links.at(i);
+
+    if (std::get<BlockLinkIndex::BLOCKTYPE>(blocklink) == BlockType::DS) {
+      const DSBlockSharedPtr& dsblock = block.m_dsBlock;
 
       if (std::get<BlockLinkIndex::DSINDEX>(blocklink) == lastDsIndex &&
           trimIncompletedBlocks) {
@@ -336,13 +447,13 @@ bool Retriever::RetrieveBlockLink(bool trimIncompletedBlocks) {
                   dsblock->GetHeader().GetEpochNum())) {
             LOG_GENERAL(WARNING, "BlockStorage::PutEpochFin failed "
                                      << dsblock->GetHeader().GetEpochNum());
-            return false;
+            failed = true;
           }
-          break;
+          return false;
         } else if (dsblock->GetHeader().GetEpochNum() >= epochFinNum) {
           LOG_GENERAL(INFO, "Broke at DS Index " << lastDsIndex);
           toDelete = true;
-          break;
+          return false;
         }
       }
 
@@ -351,29 +462,13 @@ bool Retriever::RetrieveBlockLink(bool trimIncompletedBlocks) {
 
     } else if (std::get<BlockLinkIndex::BLOCKTYPE>(blocklink) ==
                BlockType::VC) {
-      VCBlockSharedPtr vcblock;
-
-      if (!BlockStorage::GetBlockStorage().GetVCBlock(
-              std::get<BlockLinkIndex::BLOCKHASH>(blocklink), vcblock)) {
-        LOG_GENERAL(WARNING,
-                    "Could not find vc with blockHash "
-                        << std::get<BlockLinkIndex::BLOCKHASH>(blocklink));
-        return false;
-      }
-      m_mediator.m_node->UpdateRetrieveDSCommitteeCompositionAfterVC(*vcblock,
-                                                                     dsComm);
+      m_mediator.m_node->UpdateRetrieveDSCommitteeCompositionAfterVC(
+          *block.m_vcBlock, dsComm);
 
     } else if (std::get<BlockLinkIndex::BLOCKTYPE>(blocklink) ==
                BlockType::FB) {
-      FallbackBlockSharedPtr fallbackwshardingstruct;
-      if (!BlockStorage::GetBlockStorage().GetFallbackBlock(
-              std::get<BlockLinkIndex::BLOCKHASH>(blocklink),
-              fallbackwshardingstruct)) {
-        LOG_GENERAL(WARNING,
-                    "Could not find vc with blockHash "
-                        << std::get<BlockLinkIndex::BLOCKHASH>(blocklink));
-        return false;
-      }
+      const FallbackBlockSharedPtr& fallbackwshardingstruct =
+          block.m_fallbackBlock;
       uint32_t shard_id =
           fallbackwshardingstruct->m_fallbackblock.GetHeader().GetShardId();
       const PubKey& leaderPubKey =
@@ -394,14 +489,22 @@ bool Retriever::RetrieveBlockLink(bool trimIncompletedBlocks) {
         std::get<BlockLinkIndex::DSINDEX>(blocklink),
         std::get<BlockLinkIndex::BLOCKTYPE>(blocklink),
         std::get<BlockLinkIndex::BLOCKHASH>(blocklink));
+    return true;
+  };
+
+  if (!RunOrderedPipeline<LinkedBlock>("RetrieveBlockLink", links.size(),
+                                       RETRIEVER_THREADS, GetRetrieverWindow(),
+                                       loadBlock, applyBlock, applied) ||
+      failed) {
+    return false;
   }
 
   if (!toDelete) {
     return true;
   }
 
-  for (; blocklinkItr != blocklinks.end(); ++blocklinkItr) {
-    const auto& blocklink = *blocklinkItr;
+  for (size_t i = applied; i < links.size(); i++) {
+    const auto& blocklink = links.at(i);
     if (std::get<BlockLinkIndex::BLOCKTYPE>(blocklink) == BlockType::DS) {
       if (!BlockStorage::GetBlockStorage().DeleteDSBlock(
               std::get<BlockLinkIndex::DSINDEX>(blocklink))) {
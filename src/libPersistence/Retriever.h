@@ -30,7 +30,12 @@ class Retriever {
  public:
   Retriever(Mediator& mediator);
 
+  /// Finish the block writes of an epoch that a crash interrupted
+  bool RecoverEpochCommit();
+
   bool RetrieveTxBlocks(bool trimIncompletedBlocks);
+  /// Loads the tx blocks without the state deltas, for the light sync
+  bool RetrieveTxBlockHeaders();
   bool RetrieveBlockLink(bool trimIncompletedBlocks);
   bool RetrieveStates();
   bool ValidateStates();
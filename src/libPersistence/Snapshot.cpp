@@ -0,0 +1,450 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <leveldb/db.h>
+#include <leveldb/write_batch.h>
+
+#include "Snapshot.h"
+#include "common/Constants.h"
+#include "depends/libDatabase/LevelDB.h"
+#include "libCrypto/Sha2.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/JsonUtils.h"
+#include "libUtils/Logger.h"
+#include "libUtils/OrderedPipeline.h"
+
+using namespace std;
+namespace fs = boost::filesystem;
+
+namespace {
+const string MANIFEST_FILE = "manifest.json";
+const unsigned int SNAPSHOT_VERSION = 1;
+
+/// Bytes of the records written to a database in one batch on import
+const size_t IMPORT_BATCH_SIZE = 4 * 1024 * 1024;
+
+size_t GetChunkSize() {
+  return static_cast<size_t>(max(SNAPSHOT_CHUNK_SIZE_IN_MB, 1u)) * 1024 *
+         1024;
+}
+
+/// Files LevelDB manages itself, as opposed to the markers the node keeps
+/// next to them, such as the key format of LevelDB::MigrateKeys
+bool IsLevelDBFile(const string& name) {
+  auto endsWith = [&name](const string& suffix) {
+    return (name.size() >= suffix.size()) &&
+           (name.compare(name.size() - suffix.size(), suffix.size(),
+                         suffix) == 0);
+  };
+  return (name == "CURRENT") || (name == "LOCK") || (name == "LOG") ||
+         (name == "LOG.old") || (name.compare(0, 9, "MANIFEST-") == 0) ||
+         endsWith(".ldb") || endsWith(".sst") || endsWith(".log") ||
+         endsWith(".dbtmp");
+}
+
+bool ReadFile(const string& path, bytes& data) {
+  ifstream file(path, ios::binary);
+  if (!file) {
+    LOG_GENERAL(WARNING, "Failed to open " << path);
+    return false;
+  }
+  data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+  return !file.bad();
+}
+
+bool WriteFile(const string& path, const bytes& data) {
+  ofstream file(path, ios::binary | ios::trunc);
+  file.write(reinterpret_cast<const char*>(data.data()), data.size());
+  file.close();
+  if (!file) {
+    LOG_GENERAL(WARNING, "Failed to write " << path);
+    return false;
+  }
+  return true;
+}
+
+string GetChecksum(const bytes& data) {
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  sha2.Update(data);
+  string checksum;
+  DataConversion::Uint8VecToHexStr(sha2.Finalize(), checksum);
+  return checksum;
+}
+
+/// Records are (4-byte big-endian size, key, 4-byte big-endian size, value)
+void AppendField(bytes& chunk, const leveldb::Slice& field) {
+  for (unsigned int i = 0; i < sizeof(uint32_t); i++) {
+    chunk.push_back(static_cast<uint8_t>(field.size() >> (8 * (3 - i))));
+  }
+  chunk.insert(chunk.end(), field.data(), field.data() + field.size());
+}
+
+bool ReadField(const bytes& chunk, size_t& pos, leveldb::Slice& field) {
+  if (chunk.size() - pos < sizeof(uint32_t)) {
+    return false;
+  }
+  uint32_t size = 0;
+  for (unsigned int i = 0; i < sizeof(uint32_t); i++) {
+    size = (size << 8) | chunk.at(pos++);
+  }
+  if (chunk.size() - pos < size) {
+    return false;
+  }
+  field = leveldb::Slice(reinterpret_cast<const char*>(chunk.data()) + pos,
+                         size);
+  pos += size;
+  return true;
+}
+
+/// Relative paths of the databases under persistenceDir, in name order
+vector<string> FindDatabases(const string& persistenceDir) {
+  vector<string> databases;
+  for (fs::recursive_directory_iterator it(persistenceDir), end; it != end;
+       ++it) {
+    if (fs::is_directory(it->path()) && fs::exists(it->path() / "CURRENT")) {
+      databases.emplace_back(
+          fs::relative(it->path(), persistenceDir).generic_string());
+    }
+  }
+  sort(databases.begin(), databases.end());
+  return databases;
+}
+
+leveldb::Options GetOptions(const string& path) {
+  // Databases are opened with their profile, as the node opens them
+  return LevelDB::GetOpenOptions(fs::path(path).filename().string());
+}
+
+bool ExportDatabase(const string& persistenceDir, const string& snapshotDir,
+                    const string& path, Json::Value& database) {
+  const string dbPath = persistenceDir + "/" + path;
+  leveldb::Options options = GetOptions(path);
+  options.create_if_missing = false;
+  leveldb::DB* rawDB = nullptr;
+  leveldb::Status status = leveldb::DB::Open(options, dbPath, &rawDB);
+  if (!status.ok()) {
+    LOG_GENERAL(WARNING, "Failed to open " << dbPath << ": "
+                                           << status.ToString());
+    return false;
+  }
+  unique_ptr<leveldb::DB> db(rawDB);
+
+  fs::create_directories(snapshotDir + "/" + path);
+  database["path"] = path;
+  database["chunks"] = Json::arrayValue;
+
+  bytes chunk;
+  uint64_t entries = 0;
+  auto writeChunk = [&]() -> bool {
+    if (entries == 0) {
+      return true;
+    }
+    char name[16];
+    snprintf(name, sizeof(name), "%08u.chunk", database["chunks"].size());
+    const string file = path + "/" + name;
+    if (!WriteFile(snapshotDir + "/" + file, chunk)) {
+      return false;
+    }
+    Json::Value entry;
+    entry["file"] = file;
+    entry["entries"] = static_cast<Json::UInt64>(entries);
+    entry["size"] = static_cast<Json::UInt64>(chunk.size());
+    entry["sha256"] = GetChecksum(chunk);
+    database["chunks"].append(entry);
+    chunk.clear();
+    entries = 0;
+    return true;
+  };
+
+  leveldb::ReadOptions readOptions;
+  readOptions.fill_cache = false;
+  readOptions.snapshot = db->GetSnapshot();
+  bool exported = true;
+  {
+    unique_ptr<leveldb::Iterator> it(db->NewIterator(readOptions));
+    for (it->SeekToFirst(); it->Valid() && exported; it->Next()) {
+      AppendField(chunk, it->key());
+      AppendField(chunk, it->value());
+      entries++;
+      if (chunk.size() >= GetChunkSize()) {
+        exported = writeChunk();
+      }
+    }
+    if (!it->status().ok()) {
+      LOG_GENERAL(WARNING, "Failed to read " << dbPath << ": "
+                                             << it->status().ToString());
+      exported = false;
+    }
+  }
+  db->ReleaseSnapshot(readOptions.snapshot);
+  if (!exported || !writeChunk()) {
+    return false;
+  }
+
+  database["files"] = Json::objectValue;
+  for (fs::directory_iterator it(dbPath), end; it != end; ++it) {
+    const string name = it->path().filename().string();
+    if (!fs::is_regular_file(it->path()) || IsLevelDBFile(name)) {
+      continue;
+    }
+    bytes content;
+    string hexContent;
+    if (!ReadFile(it->path().string(), content) ||
+        !DataConversion::Uint8VecToHexStr(content, hexContent)) {
+      return false;
+    }
+    database["files"][name] = hexContent;
+  }
+
+  LOG_GENERAL(INFO, "Exported " << path << " in "
+                                << database["chunks"].size() << " chunks");
+  return true;
+}
+
+/// Reads the chunk described by entry, failing if it does not match it
+bool ReadChunk(const string& snapshotDir, const Json::Value& entry,
+               bytes& chunk) {
+  const string file = snapshotDir + "/" + entry["file"].asString();
+  if (!ReadFile(file, chunk)) {
+    return false;
+  }
+  if ((chunk.size() != entry["size"].asUInt64()) ||
+      (GetChecksum(chunk) != entry["sha256"].asString())) {
+    LOG_GENERAL(WARNING, "Chunk " << file << " is corrupted");
+    return false;
+  }
+  return true;
+}
+
+bool ImportChunk(const string& snapshotDir, const Json::Value& entry,
+                 leveldb::DB& db) {
+  bytes chunk;
+  if (!ReadChunk(snapshotDir, entry, chunk)) {
+    return false;
+  }
+
+  leveldb::WriteBatch batch;
+  size_t batchSize = 0;
+  uint64_t entries = 0;
+  auto writeBatch = [&](bool sync) -> bool {
+    leveldb::WriteOptions writeOptions;
+    writeOptions.sync = sync;
+    leveldb::Status status = db.Write(writeOptions, &batch);
+    if (!status.ok()) {
+      LOG_GENERAL(WARNING, "Failed to import " << entry["file"].asString()
+                                               << ": " << status.ToString());
+      return false;
+    }
+    batch.Clear();
+    batchSize = 0;
+    return true;
+  };
+
+  for (size_t pos = 0; pos < chunk.size();) {
+    leveldb::Slice key, value;
+    if (!ReadField(chunk, pos, key) || !ReadField(chunk, pos, value)) {
+      LOG_GENERAL(WARNING, "Chunk " << entry["file"].asString()
+                                    << " has a truncated record");
+      return false;
+    }
+    batch.Put(key, value);
+    batchSize += key.size() + value.size();
+    entries++;
+    if ((batchSize >= IMPORT_BATCH_SIZE) && !writeBatch(false)) {
+      return false;
+    }
+  }
+  if (entries != entry["entries"].asUInt64()) {
+    LOG_GENERAL(WARNING, "Chunk " << entry["file"].asString() << " has "
+                                  << entries << " entries instead of "
+                                  << entry["entries"].asUInt64());
+    return false;
+  }
+
+  // The chunk is durable once the last batch is synced
+  return writeBatch(true);
+}
+
+bool ReadManifest(const string& snapshotDir, Json::Value& manifest) {
+  bytes content;
+  if (!ReadFile(snapshotDir + "/" + MANIFEST_FILE, content) ||
+      !JSONUtils::GetInstance().convertStrtoJson(
+          string(content.begin(), content.end()), manifest)) {
+    LOG_GENERAL(WARNING, "No valid manifest in " << snapshotDir);
+    return false;
+  }
+  if (manifest["version"].asUInt() != SNAPSHOT_VERSION) {
+    LOG_CHECK_FAIL("Snapshot version", manifest["version"].asUInt(),
+                   SNAPSHOT_VERSION);
+    return false;
+  }
+  return true;
+}
+
+/// (database index, chunk) of every chunk in manifest
+vector<pair<unsigned int, Json::Value>> GetChunks(const Json::Value& manifest) {
+  vector<pair<unsigned int, Json::Value>> chunks;
+  const Json::Value& databases = manifest["databases"];
+  for (unsigned int i = 0; i < databases.size(); i++) {
+    for (const auto& entry : databases[i]["chunks"]) {
+      chunks.emplace_back(i, entry);
+    }
+  }
+  return chunks;
+}
+}  // namespace
+
+bool Snapshot::Export(const string& persistenceDir,
+                      const string& snapshotDir) {
+  LOG_MARKER();
+
+  if (!fs::is_directory(persistenceDir)) {
+    LOG_GENERAL(WARNING, persistenceDir << " does not exist");
+    return false;
+  }
+  // The manifest is written last, so that an interrupted export is not
+  // mistaken for a snapshot
+  fs::remove(snapshotDir + "/" + MANIFEST_FILE);
+
+  const vector<string> paths = FindDatabases(persistenceDir);
+  Json::Value manifest;
+  manifest["version"] = SNAPSHOT_VERSION;
+  manifest["databases"] = Json::arrayValue;
+
+  size_t applied = 0;
+  if (!RunOrderedPipeline<Json::Value>(
+          "ExportSnapshot", paths.size(), SNAPSHOT_THREADS, SNAPSHOT_THREADS,
+          [&](size_t i, Json::Value& database) {
+            return ExportDatabase(persistenceDir, snapshotDir, paths.at(i),
+                                  database);
+          },
+          [&manifest](size_t, Json::Value& database) {
+            manifest["databases"].append(database);
+            return true;
+          },
+          applied)) {
+    return false;
+  }
+
+  const string content = JSONUtils::GetInstance().convertJsontoStr(manifest);
+  return WriteFile(snapshotDir + "/" + MANIFEST_FILE,
+                   bytes(content.begin(), content.end()));
+}
+
+bool Snapshot::Verify(const string& snapshotDir) {
+  LOG_MARKER();
+
+  Json::Value manifest;
+  if (!ReadManifest(snapshotDir, manifest)) {
+    return false;
+  }
+
+  const auto chunks = GetChunks(manifest);
+  size_t applied = 0;
+  return RunOrderedPipeline<bool>(
+      "VerifySnapshot", chunks.size(), SNAPSHOT_THREADS, SNAPSHOT_THREADS,
+      [&](size_t i, bool&) {
+        bytes chunk;
+        return ReadChunk(snapshotDir, chunks.at(i).second, chunk);
+      },
+      [](size_t, bool&) { return true; }, applied);
+}
+
+bool Snapshot::Import(const string& snapshotDir,
+                      const string& persistenceDir) {
+  LOG_MARKER();
+
+  Json::Value manifest;
+  if (!ReadManifest(snapshotDir, manifest)) {
+    return false;
+  }
+
+  const Json::Value& databases = manifest["databases"];
+  for (const auto& database : databases) {
+    const string dbPath = persistenceDir + "/" + database["path"].asString();
+    if (fs::exists(dbPath) && !fs::is_empty(dbPath)) {
+      LOG_GENERAL(WARNING, dbPath << " already exists");
+      return false;
+    }
+  }
+
+  vector<shared_ptr<leveldb::DB>> dbs;
+  auto removeDatabases = [&]() {
+    dbs.clear();
+    for (const auto& database : databases) {
+      boost::system::error_code ec;
+      fs::remove_all(persistenceDir + "/" + database["path"].asString(), ec);
+    }
+  };
+
+  for (const auto& database : databases) {
+    const string dbPath = persistenceDir + "/" + database["path"].asString();
+    fs::create_directories(dbPath);
+    leveldb::Options options = GetOptions(dbPath);
+    leveldb::DB* rawDB = nullptr;
+    leveldb::Status status = leveldb::DB::Open(options, dbPath, &rawDB);
+    if (!status.ok()) {
+      LOG_GENERAL(WARNING, "Failed to create " << dbPath << ": "
+                                               << status.ToString());
+      removeDatabases();
+      return false;
+    }
+    dbs.emplace_back(rawDB);
+  }
+
+  // Chunks hold disjoint key ranges, so even those of one database load in
+  // any order
+  const auto chunks = GetChunks(manifest);
+  size_t applied = 0;
+  if (!RunOrderedPipeline<bool>(
+          "ImportSnapshot", chunks.size(), SNAPSHOT_THREADS, SNAPSHOT_THREADS,
+          [&](size_t i, bool&) {
+            return ImportChunk(snapshotDir, chunks.at(i).second,
+                               *dbs.at(chunks.at(i).first));
+          },
+          [](size_t, bool&) { return true; }, applied)) {
+    removeDatabases();
+    return false;
+  }
+  dbs.clear();
+
+  for (const auto& database : databases) {
+    const string dbPath = persistenceDir + "/" + database["path"].asString();
+    const Json::Value& files = database["files"];
+    for (const auto& name : files.getMemberNames()) {
+      bytes content;
+      if (!DataConversion::HexStrToUint8Vec(files[name].asString(),
+                                            content) ||
+          !WriteFile(dbPath + "/" + name, content)) {
+        removeDatabases();
+        return false;
+      }
+    }
+  }
+
+  LOG_GENERAL(INFO, "Imported " << chunks.size() << " chunks of "
+                                << databases.size() << " databases");
+  return true;
+}
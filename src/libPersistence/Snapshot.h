@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBPERSISTENCE_SNAPSHOT_H_
+#define ZILLIQA_SRC_LIBPERSISTENCE_SNAPSHOT_H_
+
+#include <string>
+
+/// Point-in-time copy of all the LevelDB databases of a persistence
+/// directory: state trie, contract storage and blocks. Each database is
+/// dumped in key order into chunks of at most SNAPSHOT_CHUNK_SIZE_IN_MB,
+/// listed with their SHA256 in manifest.json, so that the chunks can be
+/// fetched in parallel and checked one by one. Importing loads the chunks
+/// straight into new databases, without replaying any block.
+class Snapshot {
+ public:
+  /// Dumps the databases under persistenceDir into snapshotDir. The
+  /// databases must not be open, i.e. the node is stopped.
+  static bool Export(const std::string& persistenceDir,
+                     const std::string& snapshotDir);
+
+  /// Checks every chunk of snapshotDir against its manifest
+  static bool Verify(const std::string& snapshotDir);
+
+  /// Loads snapshotDir into persistenceDir. None of its databases may exist
+  /// yet, and those created are removed if any chunk fails to load.
+  static bool Import(const std::string& snapshotDir,
+                     const std::string& persistenceDir);
+};
+
+#endif  // ZILLIQA_SRC_LIBPERSISTENCE_SNAPSHOT_H_
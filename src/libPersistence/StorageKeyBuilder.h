@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBPERSISTENCE_STORAGEKEYBUILDER_H_
+#define ZILLIQA_SRC_LIBPERSISTENCE_STORAGEKEYBUILDER_H_
+
+#include <string>
+
+#include "common/Constants.h"
+#include "depends/common/FixedHash.h"
+
+namespace Contract {
+
+/// Builds storage keys of the form address.vname.index0.(...).indexN. in a
+/// single buffer. Reset and Truncate keep the capacity, so a builder reused
+/// for the keys of a call, or for the entries of a nested map, does not
+/// allocate for every key or prefix. The keys are the same as the ones
+/// GenerateStorageKey returns.
+class StorageKeyBuilder {
+  // Room for the address, the field name and a few indices
+  static const size_t DEFAULT_CAPACITY = 128;
+
+  std::string m_key;
+
+ public:
+  StorageKeyBuilder() { m_key.reserve(DEFAULT_CAPACITY); }
+
+  explicit StorageKeyBuilder(const dev::h160& addr) : StorageKeyBuilder() {
+    Reset(addr);
+  }
+
+  /// Starts a key with the hex address, in the same format as h160::hex()
+  void Reset(const dev::h160& addr) {
+    static const char HEX[] = "0123456789abcdef";
+    m_key.clear();
+    for (const auto& byte : addr) {
+      m_key.push_back(HEX[byte >> 4]);
+      m_key.push_back(HEX[byte & 0x0F]);
+    }
+  }
+
+  /// Appends the field name after the address
+  StorageKeyBuilder& AppendField(const std::string& vname) {
+    m_key.push_back(SCILLA_INDEX_SEPARATOR);
+    m_key.append(vname);
+    m_key.push_back(SCILLA_INDEX_SEPARATOR);
+    return *this;
+  }
+
+  /// Appends a map index after the field name or the previous index
+  StorageKeyBuilder& AppendIndex(const char* data, size_t size) {
+    m_key.append(data, size);
+    m_key.push_back(SCILLA_INDEX_SEPARATOR);
+    return *this;
+  }
+
+  StorageKeyBuilder& AppendIndex(const std::string& index) {
+    return AppendIndex(index.data(), index.size());
+  }
+
+  size_t Size() const { return m_key.size(); }
+
+  /// Goes back to a prefix, e.g. to build the key of the next map entry
+  void Truncate(size_t size) {
+    if (size < m_key.size()) {
+      m_key.resize(size);
+    }
+  }
+
+  const std::string& Key() const { return m_key; }
+};
+
+}  // namespace Contract
+
+#endif  // ZILLIQA_SRC_LIBPERSISTENCE_STORAGEKEYBUILDER_H_
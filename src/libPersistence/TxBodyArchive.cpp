@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+#include <leveldb/write_batch.h>
+
+#include "TxBodyArchive.h"
+#include "common/Constants.h"
+#include "libUtils/CompressionUtils.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace {
+const string NEXT_EPOCH_KEY = "nextEpoch";
+const unsigned int LOCATION_SIZE =
+    sizeof(uint64_t) + sizeof(uint64_t) + sizeof(uint32_t) + 1;
+
+void AppendBigEndian(string& dst, uint64_t value, unsigned int size) {
+  for (unsigned int i = 0; i < size; i++) {
+    dst.push_back(static_cast<char>(value >> (8 * (size - 1 - i))));
+  }
+}
+
+uint64_t ReadBigEndian(const string& src, unsigned int pos,
+                       unsigned int size) {
+  uint64_t value = 0;
+  for (unsigned int i = 0; i < size; i++) {
+    value = (value << 8) | static_cast<unsigned char>(src[pos + i]);
+  }
+  return value;
+}
+}  // namespace
+
+TxBodyArchive::TxBodyArchive(const string& dir)
+    : m_dir(dir), m_indexDB(new LevelDB("txBodyArchiveIndex")) {
+  if (!boost::filesystem::exists(m_dir)) {
+    boost::filesystem::create_directories(m_dir);
+  }
+}
+
+string TxBodyArchive::GetIndexKey(const dev::h256& hash) {
+  return string(reinterpret_cast<const char*>(hash.data()), hash.size);
+}
+
+string TxBodyArchive::SerializeLocation(const Location& location) {
+  string dst;
+  AppendBigEndian(dst, location.m_segmentId, sizeof(uint64_t));
+  AppendBigEndian(dst, location.m_offset, sizeof(uint64_t));
+  AppendBigEndian(dst, location.m_size, sizeof(uint32_t));
+  dst.push_back(location.m_compressed ? 1 : 0);
+  return dst;
+}
+
+bool TxBodyArchive::DeserializeLocation(const string& src,
+                                        Location& location) {
+  if (src.size() != LOCATION_SIZE) {
+    return false;
+  }
+  unsigned int pos = 0;
+  location.m_segmentId = ReadBigEndian(src, pos, sizeof(uint64_t));
+  pos += sizeof(uint64_t);
+  location.m_offset = ReadBigEndian(src, pos, sizeof(uint64_t));
+  pos += sizeof(uint64_t);
+  location.m_size = ReadBigEndian(src, pos, sizeof(uint32_t));
+  pos += sizeof(uint32_t);
+  location.m_compressed = src[pos] != 0;
+  return true;
+}
+
+string TxBodyArchive::GetSegmentPath(uint64_t segmentId) const {
+  return m_dir + "/" + to_string(segmentId) + ".seg";
+}
+
+bool TxBodyArchive::Append(uint64_t segmentId,
+                           const vector<pair<dev::h256, bytes>>& bodies) {
+  if (bodies.empty()) {
+    return true;
+  }
+
+  const string path = GetSegmentPath(segmentId);
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd < 0) {
+    LOG_GENERAL(WARNING, "Failed to open archive segment " << path);
+    return false;
+  }
+  const off_t segmentSize = lseek(fd, 0, SEEK_END);
+  if (segmentSize < 0) {
+    close(fd);
+    return false;
+  }
+
+  string data;
+  leveldb::WriteBatch batch;
+  for (const auto& body : bodies) {
+    Location location;
+    location.m_segmentId = segmentId;
+    location.m_offset = segmentSize + data.size();
+
+    bytes compressed;
+    location.m_compressed = CompressionUtils::Compress(body.second, 0,
+                                                       compressed, 0);
+    const bytes& stored = location.m_compressed ? compressed : body.second;
+    location.m_size = stored.size();
+    data.append(stored.begin(), stored.end());
+
+    batch.Put(GetIndexKey(body.first), SerializeLocation(location));
+  }
+
+  size_t written = 0;
+  while (written < data.size()) {
+    const ssize_t ret =
+        write(fd, data.data() + written, data.size() - written);
+    if (ret < 0) {
+      LOG_GENERAL(WARNING, "Failed to append to archive segment " << path);
+      close(fd);
+      return false;
+    }
+    written += ret;
+  }
+  const bool synced = fdatasync(fd) == 0;
+  close(fd);
+  if (!synced) {
+    LOG_GENERAL(WARNING, "Failed to sync archive segment " << path);
+    return false;
+  }
+
+  return m_indexDB->GetDB()->Write(leveldb::WriteOptions(), &batch).ok();
+}
+
+bool TxBodyArchive::Get(const dev::h256& hash, bytes& body) const {
+  Location location;
+  if (!DeserializeLocation(m_indexDB->Lookup(GetIndexKey(hash)), location)) {
+    return false;
+  }
+
+  const string path = GetSegmentPath(location.m_segmentId);
+  ifstream segment(path, ios::binary);
+  bytes stored(location.m_size);
+  if (!segment.seekg(location.m_offset) ||
+      !segment.read(reinterpret_cast<char*>(stored.data()), stored.size())) {
+    LOG_GENERAL(WARNING, "Failed to read " << hash << " from " << path);
+    return false;
+  }
+
+  body.clear();
+  if (!location.m_compressed) {
+    body.swap(stored);
+    return true;
+  }
+  return CompressionUtils::Decompress(stored, 0, body, PACKET_BYTESIZE_LIMIT);
+}
+
+bool TxBodyArchive::Exists(const dev::h256& hash) const {
+  return m_indexDB->Exists(GetIndexKey(hash));
+}
+
+uint64_t TxBodyArchive::GetNextEpoch() const {
+  const string value = m_indexDB->Lookup(NEXT_EPOCH_KEY);
+  return value.size() == sizeof(uint64_t)
+             ? ReadBigEndian(value, 0, sizeof(uint64_t))
+             : 0;
+}
+
+bool TxBodyArchive::Reset() {
+  boost::system::error_code ec;
+  boost::filesystem::remove_all(m_dir, ec);
+  boost::filesystem::create_directories(m_dir, ec);
+  return m_indexDB->ResetDB() && !ec;
+}
+
+bool TxBodyArchive::PutNextEpoch(uint64_t epochNum) {
+  string value;
+  AppendBigEndian(value, epochNum, sizeof(uint64_t));
+  return m_indexDB->Insert(leveldb::Slice(NEXT_EPOCH_KEY),
+                           leveldb::Slice(value)) == 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBPERSISTENCE_TXBODYARCHIVE_H_
+#define ZILLIQA_SRC_LIBPERSISTENCE_TXBODYARCHIVE_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/BaseType.h"
+#include "depends/common/FixedHash.h"
+#include "depends/libDatabase/LevelDB.h"
+
+/// Cold storage of the transaction bodies that a lookup no longer keeps in
+/// its txBodies db. Bodies are compressed and appended to segment files that
+/// are never rewritten, and an index db maps each hash to its segment,
+/// offset and size.
+class TxBodyArchive {
+ public:
+  /// Archive under dir, with the index db in the persistence directory
+  explicit TxBodyArchive(const std::string& dir);
+
+  /// Appends the bodies to segment segmentId and indexes them. The segment
+  /// is synced before the index is written, so that an indexed body is
+  /// always readable.
+  bool Append(uint64_t segmentId,
+              const std::vector<std::pair<dev::h256, bytes>>& bodies);
+
+  /// Reads the body of hash. Returns false if it is not archived.
+  bool Get(const dev::h256& hash, bytes& body) const;
+
+  bool Exists(const dev::h256& hash) const;
+
+  /// Next epoch whose bodies are to be archived, 0 if none are yet
+  uint64_t GetNextEpoch() const;
+  bool PutNextEpoch(uint64_t epochNum);
+
+  /// Drops all the archived bodies
+  bool Reset();
+
+ private:
+  /// (segment id, offset, size, compressed) of an archived body
+  struct Location {
+    uint64_t m_segmentId{0};
+    uint64_t m_offset{0};
+    uint32_t m_size{0};
+    bool m_compressed{false};
+  };
+
+  static std::string GetIndexKey(const dev::h256& hash);
+  static std::string SerializeLocation(const Location& location);
+  static bool DeserializeLocation(const std::string& src, Location& location);
+
+  std::string GetSegmentPath(uint64_t segmentId) const;
+
+  const std::string m_dir;
+  std::unique_ptr<LevelDB> m_indexDB;
+};
+
+#endif  // ZILLIQA_SRC_LIBPERSISTENCE_TXBODYARCHIVE_H_
@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <thread>
+
+#include "ProtoRpcServer.h"
+#include "common/Constants.h"
+#include "libData/AccountData/AccountStore.h"
+#include "libLookup/Lookup.h"
+#include "libMediator/Mediator.h"
+#include "libPersistence/BlockStorage.h"
+#include "libServer/LookupServer.h"
+#include "libUtils/DetachedFunction.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+using namespace ZilliqaMessage;
+
+// Implementation in libMessage
+bool ProtobufToTransaction(const ProtoTransaction& protoTransaction,
+                           Transaction& transaction);
+
+namespace {
+const unsigned int FRAME_HEADER_SIZE = sizeof(uint32_t);
+
+bool ReadFully(int fd, char* dst, size_t size) {
+  while (size > 0) {
+    const ssize_t ret = recv(fd, dst, size, 0);
+    if (ret <= 0) {
+      if (ret < 0 && errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    dst += ret;
+    size -= ret;
+  }
+  return true;
+}
+
+bool WriteFully(int fd, const char* src, size_t size) {
+  while (size > 0) {
+    const ssize_t ret = send(fd, src, size, MSG_NOSIGNAL);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    src += ret;
+    size -= ret;
+  }
+  return true;
+}
+}  // namespace
+
+ProtoRpcServer::ProtoRpcServer(Mediator& mediator, LookupServer& lookupServer,
+                               unsigned int port)
+    : m_mediator(mediator), m_lookupServer(lookupServer), m_port(port) {}
+
+ProtoRpcServer::~ProtoRpcServer() { StopListening(); }
+
+bool ProtoRpcServer::StartListening() {
+  if (m_listenFd >= 0) {
+    return true;
+  }
+
+  m_listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  if (m_listenFd < 0) {
+    LOG_GENERAL(WARNING, "Failed to create socket for protobuf RPC");
+    return false;
+  }
+  const int enable = 1;
+  setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(m_port);
+  if (bind(m_listenFd, reinterpret_cast<struct sockaddr*>(&addr),
+           sizeof(addr)) != 0 ||
+      listen(m_listenFd, SOMAXCONN) != 0) {
+    LOG_GENERAL(WARNING, "Failed to listen for protobuf RPC on " << m_port);
+    close(m_listenFd);
+    m_listenFd = -1;
+    return false;
+  }
+
+  m_stopping = false;
+  {
+    lock_guard<mutex> g(m_mutexConnections);
+    m_threads++;
+  }
+  DetachedFunction(1, [this]() -> void { AcceptLoop(); });
+  return true;
+}
+
+void ProtoRpcServer::StopListening() {
+  if (m_listenFd < 0) {
+    return;
+  }
+
+  m_stopping = true;
+  unique_lock<mutex> g(m_mutexConnections);
+  shutdown(m_listenFd, SHUT_RDWR);
+  for (const int fd : m_connectionFds) {
+    shutdown(fd, SHUT_RDWR);
+  }
+  m_cvConnections.wait(g, [this]() { return m_threads == 0; });
+  close(m_listenFd);
+  m_listenFd = -1;
+}
+
+void ProtoRpcServer::ThreadDone(int fd) {
+  lock_guard<mutex> g(m_mutexConnections);
+  if (fd >= 0) {
+    m_connectionFds.erase(fd);
+    close(fd);
+  }
+  m_threads--;
+  m_cvConnections.notify_all();
+}
+
+void ProtoRpcServer::AcceptLoop() {
+  while (!m_stopping) {
+    struct sockaddr_in addr {};
+    socklen_t addrLen = sizeof(addr);
+    const int fd =
+        accept(m_listenFd, reinterpret_cast<struct sockaddr*>(&addr), &addrLen);
+    if (fd < 0) {
+      if (!m_stopping && errno != EINTR) {
+        LOG_GENERAL(WARNING, "Failed to accept protobuf RPC connection");
+        this_thread::sleep_for(chrono::milliseconds(100));
+      }
+      continue;
+    }
+
+    char address[INET_ADDRSTRLEN] = {0};
+    inet_ntop(AF_INET, &addr.sin_addr, address, sizeof(address));
+    const string client(address);
+
+    {
+      lock_guard<mutex> g(m_mutexConnections);
+      if (m_stopping ||
+          m_connectionFds.size() >= PROTO_RPC_MAX_CONNECTIONS) {
+        LOG_GENERAL(INFO, "Refused protobuf RPC connection from " << client);
+        close(fd);
+        continue;
+      }
+      m_connectionFds.insert(fd);
+      m_threads++;
+    }
+
+    const int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    if (LOOKUP_RPC_CONNECTION_TIMEOUT_IN_SECONDS > 0) {
+      struct timeval timeout {};
+      timeout.tv_sec = LOOKUP_RPC_CONNECTION_TIMEOUT_IN_SECONDS;
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    DetachedFunction(1, [this, fd, client]() -> void {
+      Serve(fd, client);
+      ThreadDone(fd);
+    });
+  }
+  ThreadDone(-1);
+}
+
+void ProtoRpcServer::Serve(int fd, const string& client) {
+  string frame;
+  while (!m_stopping) {
+    unsigned char header[FRAME_HEADER_SIZE];
+    if (!ReadFully(fd, reinterpret_cast<char*>(header), FRAME_HEADER_SIZE)) {
+      return;
+    }
+    uint32_t size = 0;
+    for (unsigned int i = 0; i < FRAME_HEADER_SIZE; i++) {
+      size = (size << 8) | header[i];
+    }
+    if (size > PACKET_BYTESIZE_LIMIT) {
+      LOG_GENERAL(WARNING, "Protobuf RPC frame of " << size << " bytes from "
+                                                    << client);
+      return;
+    }
+
+    frame.resize(size);
+    if (!ReadFully(fd, &frame[0], size)) {
+      return;
+    }
+
+    // A frame that does not parse is answered, and ends the connection
+    ProtoRpcRequest request;
+    ProtoRpcResponse response;
+    const bool parsed = request.ParseFromString(frame);
+    if (parsed) {
+      Handle(request, client, response);
+    } else {
+      response.set_id(0);
+      response.set_error("Invalid request");
+    }
+
+    if (!response.SerializeToString(&frame)) {
+      return;
+    }
+    for (unsigned int i = 0; i < FRAME_HEADER_SIZE; i++) {
+      header[i] = static_cast<unsigned char>(
+          frame.size() >> (8 * (FRAME_HEADER_SIZE - 1 - i)));
+    }
+    if (!WriteFully(fd, reinterpret_cast<const char*>(header),
+                    FRAME_HEADER_SIZE) ||
+        !WriteFully(fd, frame.data(), frame.size()) || !parsed) {
+      return;
+    }
+  }
+}
+
+void ProtoRpcServer::Handle(const ProtoRpcRequest& request,
+                            const string& client,
+                            ProtoRpcResponse& response) {
+  response.set_id(request.id());
+  if (m_mediator.m_lookup->GetSyncType() != SyncType::NO_SYNC) {
+    response.set_error("Lookup is syncing, try again later");
+    return;
+  }
+
+  try {
+    switch (request.method_case()) {
+      case ProtoRpcRequest::kCreatetransaction:
+        CreateTransaction(request, client, response);
+        break;
+      case ProtoRpcRequest::kGettransaction:
+        GetTransaction(request.gettransaction(), response);
+        break;
+      case ProtoRpcRequest::kGetbalance:
+        GetBalance(request.getbalance(), response);
+        break;
+      default:
+        response.set_error("Unknown method");
+    }
+  } catch (const jsonrpc::JsonRpcException& je) {
+    response.set_error(je.GetMessage());
+  } catch (const exception& e) {
+    LOG_GENERAL(INFO, "[Error]" << e.what() << " Client: " << client);
+    response.set_error("Unable to Process");
+  }
+}
+
+void ProtoRpcServer::CreateTransaction(const ProtoRpcRequest& request,
+                                       const string& client,
+                                       ProtoRpcResponse& response) {
+  Transaction tx;
+  if (!ProtobufToTransaction(request.createtransaction().tx(), tx)) {
+    response.set_error("Invalid transaction");
+    return;
+  }
+
+  const Json::Value ret =
+      m_lookupServer.SubmitTransaction(tx, request.priority(), client);
+  if (!ret.isMember("TranID")) {
+    response.set_error("Unable to Process");
+    return;
+  }
+  CreateTransactionResponse& result = *response.mutable_createtransaction();
+  result.set_info(ret["Info"].asString());
+  result.set_tranid(ret["TranID"].asString());
+  if (ret.isMember("ContractAddress")) {
+    result.set_contractaddress(ret["ContractAddress"].asString());
+  }
+}
+
+void ProtoRpcServer::GetTransaction(const GetTransactionByIdRequest& request,
+                                    ProtoRpcResponse& response) {
+  if (request.tranid().size() != TxnHash::size) {
+    response.set_error("Size not appropriate");
+    return;
+  }
+
+  const TxnHash tranHash(
+      bytes(request.tranid().begin(), request.tranid().end()));
+  TxBodySharedPtr body;
+  if (!BlockStorage::GetBlockStorage().GetTxBody(tranHash, body)) {
+    response.set_error("Txn Hash not Present");
+    return;
+  }
+
+  bytes serialized;
+  if (!body->Serialize(serialized, 0)) {
+    response.set_error("Unable to Process");
+    return;
+  }
+  response.set_transaction(serialized.data(), serialized.size());
+}
+
+void ProtoRpcServer::GetBalance(const GetBalanceRequest& request,
+                                ProtoRpcResponse& response) {
+  if (request.address().size() != ACC_ADDR_SIZE) {
+    response.set_error("Address size not appropriate");
+    return;
+  }
+
+  const Address addr(
+      bytes(request.address().begin(), request.address().end()));
+  Account account;
+  if (!AccountStore::GetInstance().GetCommittedAccount(addr, account)) {
+    response.set_error("Account is not created");
+    return;
+  }
+
+  GetBalanceResponse& balance = *response.mutable_balance();
+  balance.set_balance(account.GetBalance().str());
+  balance.set_nonce(to_string(account.GetNonce()));
+}
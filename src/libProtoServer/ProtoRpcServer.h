@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBPROTOSERVER_PROTORPCSERVER_H_
+#define ZILLIQA_SRC_LIBPROTOSERVER_PROTORPCSERVER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "ServerRequest.pb.h"
+#include "ServerResponse.pb.h"
+
+class LookupServer;
+class Mediator;
+
+/// Binary endpoint of the lookup for the high-volume clients, serving the
+/// transaction methods of LookupServer without JSON or hex. Each frame is a
+/// big-endian uint32 size followed by a ProtoRpcRequest, answered in order
+/// with a ProtoRpcResponse framed the same way. Every connection is served
+/// on its own thread, up to PROTO_RPC_MAX_CONNECTIONS. Requests fail while
+/// the lookup syncs, as the JSON-RPC server does not listen then.
+class ProtoRpcServer {
+ public:
+  ProtoRpcServer(Mediator& mediator, LookupServer& lookupServer,
+                 unsigned int port);
+  ~ProtoRpcServer();
+
+  ProtoRpcServer(const ProtoRpcServer&) = delete;
+  ProtoRpcServer& operator=(const ProtoRpcServer&) = delete;
+
+  bool StartListening();
+
+  /// Closes the listening socket and the open connections, and waits for
+  /// their threads to return
+  void StopListening();
+
+  /// Answers request, received from the IP client
+  void Handle(const ZilliqaMessage::ProtoRpcRequest& request,
+              const std::string& client,
+              ZilliqaMessage::ProtoRpcResponse& response);
+
+ private:
+  Mediator& m_mediator;
+  LookupServer& m_lookupServer;
+  const unsigned int m_port;
+  int m_listenFd{-1};
+
+  /// Threads of the accept loop and of the connections, and their sockets
+  std::mutex m_mutexConnections;
+  std::condition_variable m_cvConnections;
+  std::unordered_set<int> m_connectionFds;
+  unsigned int m_threads{0};
+  std::atomic<bool> m_stopping{false};
+
+  void AcceptLoop();
+  void Serve(int fd, const std::string& client);
+  void ThreadDone(int fd);
+
+  void CreateTransaction(const ZilliqaMessage::ProtoRpcRequest& request,
+                         const std::string& client,
+                         ZilliqaMessage::ProtoRpcResponse& response);
+  void GetTransaction(const ZilliqaMessage::GetTransactionByIdRequest& request,
+                      ZilliqaMessage::ProtoRpcResponse& response);
+  void GetBalance(const ZilliqaMessage::GetBalanceRequest& request,
+                  ZilliqaMessage::ProtoRpcResponse& response);
+};
+
+#endif  // ZILLIQA_SRC_LIBPROTOSERVER_PROTORPCSERVER_H_
@@ -86,7 +86,7 @@ uint256_t Server::GetNumTransactions(uint64_t blockNum) {
 
   uint64_t i, res = 0;
   for (i = blockNum + 1; i <= currBlockNum; i++) {
-    res += m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+    res += m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
   }
 
   return res;
@@ -752,7 +752,7 @@ StringResponse Server::GetNumTransactions() {
   if (m_BlockTxPair.first < currBlock) {
     for (uint64_t i = m_BlockTxPair.first + 1; i <= currBlock; i++) {
       m_BlockTxPair.second +=
-          m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+          m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
     }
   }
   m_BlockTxPair.first = currBlock;
@@ -932,7 +932,8 @@ ProtoBlockListing Server::DSBlockListing(ProtoPage& protoPage) {
   if (m_DSBlockCache.second.size() == 0) {
     try {
       // add the hash of genesis block
-      DSBlockHeader dshead = m_mediator.m_dsBlockChain.GetBlock(0).GetHeader();
+      DSBlockHeader dshead =
+          m_mediator.m_dsBlockChain.GetBlockPtr(0)->GetHeader();
       SHA2<HashType::HASH_VARIANT_256> sha2;
       bytes vec;
       dshead.Serialize(vec, 0);
@@ -955,15 +956,16 @@ ProtoBlockListing Server::DSBlockListing(ProtoPage& protoPage) {
 
   if (currBlockNum > m_DSBlockCache.first) {
     for (uint64_t i = m_DSBlockCache.first + 1; i < currBlockNum; i++) {
-      m_DSBlockCache.second.insert_new(m_DSBlockCache.second.size(),
-                                       m_mediator.m_dsBlockChain.GetBlock(i + 1)
-                                           .GetHeader()
-                                           .GetPrevHash()
-                                           .hex());
+      m_DSBlockCache.second.insert_new(
+          m_DSBlockCache.second.size(),
+          m_mediator.m_dsBlockChain.GetBlockPtr(i + 1)
+              ->GetHeader()
+              .GetPrevHash()
+              .hex());
     }
     // for the latest block
     DSBlockHeader dshead =
-        m_mediator.m_dsBlockChain.GetBlock(currBlockNum).GetHeader();
+        m_mediator.m_dsBlockChain.GetBlockPtr(currBlockNum)->GetHeader();
     SHA2<HashType::HASH_VARIANT_256> sha2;
     bytes vec;
     dshead.Serialize(vec, 0);
@@ -996,8 +998,8 @@ ProtoBlockListing Server::DSBlockListing(ProtoPage& protoPage) {
          i++) {
       auto blockData = ret.add_data();
       blockData->set_hash(
-          m_mediator.m_dsBlockChain.GetBlock(currBlockNum - i + 1)
-              .GetHeader()
+          m_mediator.m_dsBlockChain.GetBlockPtr(currBlockNum - i + 1)
+              ->GetHeader()
               .GetPrevHash()
               .hex());
       blockData->set_blocknum(int(currBlockNum - i));
@@ -1024,7 +1026,8 @@ ProtoBlockListing Server::TxBlockListing(ProtoPage& protoPage) {
   if (m_TxBlockCache.second.size() == 0) {
     try {
       // add the hash of genesis block
-      TxBlockHeader txhead = m_mediator.m_txBlockChain.GetBlock(0).GetHeader();
+      TxBlockHeader txhead =
+          m_mediator.m_txBlockChain.GetBlockPtr(0)->GetHeader();
       SHA2<HashType::HASH_VARIANT_256> sha2;
       bytes vec;
       txhead.Serialize(vec, 0);
@@ -1047,15 +1050,16 @@ ProtoBlockListing Server::TxBlockListing(ProtoPage& protoPage) {
 
   if (currBlockNum > m_TxBlockCache.first) {
     for (uint64_t i = m_TxBlockCache.first + 1; i < currBlockNum; i++) {
-      m_TxBlockCache.second.insert_new(m_TxBlockCache.second.size(),
-                                       m_mediator.m_txBlockChain.GetBlock(i + 1)
-                                           .GetHeader()
-                                           .GetPrevHash()
-                                           .hex());
+      m_TxBlockCache.second.insert_new(
+          m_TxBlockCache.second.size(),
+          m_mediator.m_txBlockChain.GetBlockPtr(i + 1)
+              ->GetHeader()
+              .GetPrevHash()
+              .hex());
     }
     // for the latest block
     TxBlockHeader txhead =
-        m_mediator.m_txBlockChain.GetBlock(currBlockNum).GetHeader();
+        m_mediator.m_txBlockChain.GetBlockPtr(currBlockNum)->GetHeader();
     SHA2<HashType::HASH_VARIANT_256> sha2;
     bytes vec;
     txhead.Serialize(vec, 0);
@@ -1088,8 +1092,8 @@ ProtoBlockListing Server::TxBlockListing(ProtoPage& protoPage) {
          i++) {
       auto blockData = ret.add_data();
       blockData->set_hash(
-          m_mediator.m_txBlockChain.GetBlock(currBlockNum - i + 1)
-              .GetHeader()
+          m_mediator.m_txBlockChain.GetBlockPtr(currBlockNum - i + 1)
+              ->GetHeader()
               .GetPrevHash()
               .hex());
       blockData->set_blocknum(int(currBlockNum - i));
@@ -1191,25 +1195,25 @@ StringResponse Server::GetNumTxnsDSEpoch() {
 
     if (latestTxBlockNum > m_TxBlockCountSumPair.first) {
       // Case where the DS Epoch is same
-      if (m_mediator.m_txBlockChain.GetBlock(m_TxBlockCountSumPair.first)
-              .GetHeader()
+      if (m_mediator.m_txBlockChain.GetBlockPtr(m_TxBlockCountSumPair.first)
+              ->GetHeader()
               .GetDSBlockNum() == latestDSBlockNum) {
         for (auto i = latestTxBlockNum; i > m_TxBlockCountSumPair.first; i--) {
           m_TxBlockCountSumPair.second +=
-              m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+              m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
         }
 
       } else {  // Case if DS Epoch Changed
         m_TxBlockCountSumPair.second = 0;
 
         for (auto i = latestTxBlockNum; i > m_TxBlockCountSumPair.first; i--) {
-          if (m_mediator.m_txBlockChain.GetBlock(i)
-                  .GetHeader()
+          if (m_mediator.m_txBlockChain.GetBlockPtr(i)
+                  ->GetHeader()
                   .GetDSBlockNum() < latestDSBlockNum) {
             break;
           }
           m_TxBlockCountSumPair.second +=
-              m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+              m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
         }
       }
 
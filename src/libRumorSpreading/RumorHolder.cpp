@@ -19,6 +19,7 @@
 #include "common/Constants.h"
 #include "libUtils/Logger.h"
 
+#include <algorithm>
 #include <random>
 
 #define LITERAL(s) #s
@@ -63,6 +64,14 @@ void RumorHolder::increaseStatValue(StatisticKey key, double value) {
   }
 }
 
+void RumorHolder::insertRumor(int rumorId, RumorStateMachine&& stateMach) {
+  m_rumorIndexes.emplace(rumorId, m_rumors.size());
+  if (!stateMach.isOld()) {
+    m_liveRumors.push_back(m_rumors.size());
+  }
+  m_rumors.emplace_back(rumorId, std::move(stateMach));
+}
+
 // CONSTRUCTORS
 RumorHolder::RumorHolder(const std::unordered_set<int>& peers, int id)
     : m_id(id),
@@ -154,6 +163,8 @@ RumorHolder::RumorHolder(const RumorHolder& other)
       m_peers(other.m_peers),
       m_peersInCurrentRound(other.m_peersInCurrentRound),
       m_rumors(other.m_rumors),
+      m_rumorIndexes(other.m_rumorIndexes),
+      m_liveRumors(other.m_liveRumors),
       m_mutex(),
       m_nextMemberCb(other.m_nextMemberCb),
       m_nonPriorityPeers(other.m_nonPriorityPeers),
@@ -167,6 +178,8 @@ RumorHolder::RumorHolder(RumorHolder&& other) noexcept
       m_peers(std::move(other.m_peers)),
       m_peersInCurrentRound(std::move(other.m_peersInCurrentRound)),
       m_rumors(std::move(other.m_rumors)),
+      m_rumorIndexes(std::move(other.m_rumorIndexes)),
+      m_liveRumors(std::move(other.m_liveRumors)),
       m_mutex(),
       m_nextMemberCb(std::move(other.m_nextMemberCb)),
       m_nonPriorityPeers(std::move(other.m_nonPriorityPeers)),
@@ -176,7 +189,11 @@ RumorHolder::RumorHolder(RumorHolder&& other) noexcept
 // PUBLIC METHODS
 bool RumorHolder::addRumor(int rumorId) {
   std::lock_guard<std::mutex> guard(m_mutex);  // critical section
-  return m_rumors.insert(std::make_pair(rumorId, &m_networkConfig)).second;
+  if (m_rumorIndexes.count(rumorId) > 0) {
+    return false;
+  }
+  insertRumor(rumorId, RumorStateMachine(&m_networkConfig));
+  return true;
 }
 
 std::pair<int, std::vector<Message>> RumorHolder::receivedMessage(
@@ -192,11 +209,11 @@ std::pair<int, std::vector<Message>> RumorHolder::receivedMessage(
   if (isNewPeer && ((message.type() == Message::Type::LAZY_PUSH &&
                      SEND_RESPONSE_FOR_LAZY_PUSH) ||
                     message.type() == Message::Type::EMPTY_PUSH)) {
-    for (auto& kv : m_rumors) {
-      RumorStateMachine& stateMach = kv.second;
-      if (stateMach.rounds() > 0 and !stateMach.isOld()) {
-        pullMessages.emplace_back(Message::Type::LAZY_PULL, kv.first,
-                                  kv.second.rounds());
+    for (const auto index : m_liveRumors) {
+      const auto& r = m_rumors[index];
+      if (r.second.rounds() > 0) {
+        pullMessages.emplace_back(Message::Type::LAZY_PULL, r.first,
+                                  r.second.rounds());
       }
     }
 
@@ -215,12 +232,12 @@ std::pair<int, std::vector<Message>> RumorHolder::receivedMessage(
   const int receivedRumorId = message.rumorId();
   const int theirRound = message.rounds();
   if (receivedRumorId >= 0) {
-    if (m_rumors.count(receivedRumorId) > 0) {
-      m_rumors.at(receivedRumorId).rumorReceived(fromPeer, message.rounds());
+    const auto it = m_rumorIndexes.find(receivedRumorId);
+    if (it != m_rumorIndexes.end()) {
+      m_rumors[it->second].second.rumorReceived(fromPeer, theirRound);
     } else {
-      m_rumors.insert(std::make_pair(
-          receivedRumorId,
-          RumorStateMachine(&m_networkConfig, fromPeer, theirRound)));
+      insertRumor(receivedRumorId,
+                  RumorStateMachine(&m_networkConfig, fromPeer, theirRound));
     }
   }
 
@@ -300,21 +317,28 @@ std::pair<std::vector<int>, std::vector<Message>> RumorHolder::advanceRound() {
   }
   m_nonPriorityPeers.clear();
 
-  // Construct the push messages
+  // Sorted once here for all the rumors of the round
+  std::vector<int> peersInCurrentRound(m_peersInCurrentRound.begin(),
+                                       m_peersInCurrentRound.end());
+  std::sort(peersInCurrentRound.begin(), peersInCurrentRound.end());
+
+  // Construct the push messages, dropping the rumors gone OLD from the live
+  // list
   std::vector<Message> pushMessages;
-  for (auto& r : m_rumors) {
+  pushMessages.reserve(m_liveRumors.size());
+  size_t numLive = 0;
+  for (const auto index : m_liveRumors) {
+    auto& r = m_rumors[index];
     RumorStateMachine& stateMach = r.second;
 
-    if (stateMach.isOld()) {
-      continue;
-    }
-
-    stateMach.advanceRound(m_peersInCurrentRound);
+    stateMach.advanceRound(peersInCurrentRound);
     if (!stateMach.isOld()) {
       pushMessages.emplace_back(
           Message(Message::Type::LAZY_PUSH, r.first, r.second.rounds()));
+      m_liveRumors[numLive++] = index;
     }
   }
+  m_liveRumors.resize(numLive);
   increaseStatValue(StatisticKey::NumLazyPushMessages, pushMessages.size());
 
   // No PUSH messages but still want to sent a response to peer.
@@ -336,7 +360,7 @@ const NetworkConfig& RumorHolder::networkConfig() const {
   return m_networkConfig;
 }
 
-const std::unordered_map<int, RumorStateMachine>& RumorHolder::rumorsMap()
+const std::vector<std::pair<int, RumorStateMachine>>& RumorHolder::rumors()
     const {
   return m_rumors;
 }
@@ -348,7 +372,7 @@ const std::map<RumorHolder::StatisticKey, double>& RumorHolder::statistics()
 
 bool RumorHolder::rumorExists(int rumorId) const {
   std::lock_guard<std::mutex> guard(m_mutex);  // critical section
-  return m_rumors.count(rumorId) > 0;
+  return m_rumorIndexes.count(rumorId) > 0;
 }
 
 std::ostream& RumorHolder::printStatistics(std::ostream& outStream) const {
@@ -21,7 +21,10 @@
 #include <functional>
 #include <map>
 #include <mutex>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "MemberID.h"
 #include "NetworkConfig.h"
@@ -56,7 +59,11 @@ class RumorHolder : public RumorSpreadingInterface {
   NetworkConfig m_networkConfig;
   std::vector<int> m_peers;
   std::unordered_set<int> m_peersInCurrentRound;
-  std::unordered_map<int, RumorStateMachine> m_rumors;
+  // Flat table of the rumors in the order they were first seen, with the
+  // index of each rumor ID and the indexes of the rumors that are not OLD
+  std::vector<std::pair<int, RumorStateMachine>> m_rumors;
+  std::unordered_map<int, size_t> m_rumorIndexes;
+  std::vector<size_t> m_liveRumors;
   mutable std::mutex m_mutex;
   NextMemberCb m_nextMemberCb;
   std::unordered_set<int> m_nonPriorityPeers;
@@ -75,6 +82,9 @@ class RumorHolder : public RumorSpreadingInterface {
   // Add the specified 'value' to the previous statistic value
   void increaseStatValue(StatisticKey key, double value);
 
+  // Append a rumor that is not in the table yet
+  void insertRumor(int rumorId, RumorStateMachine&& stateMach);
+
  public:
   // CONSTRUCTORS
   /// Create an instance which automatically figures out the network parameters.
@@ -109,7 +119,7 @@ class RumorHolder : public RumorSpreadingInterface {
 
   const NetworkConfig& networkConfig() const;
 
-  const std::unordered_map<int, RumorStateMachine>& rumorsMap() const;
+  const std::vector<std::pair<int, RumorStateMachine>>& rumors() const;
 
   bool rumorExists(int rumorId) const;
 
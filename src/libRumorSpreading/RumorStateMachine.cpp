@@ -15,6 +15,8 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include "RumorStateMachine.h"
 
 #define LITERAL(s) #s
@@ -32,7 +34,7 @@ std::map<RumorStateMachine::State, std::string>
 
 // PRIVATE METHODS
 void RumorStateMachine::advanceFromNew(
-    const std::unordered_set<int>& membersInRound) {
+    const std::vector<int>& membersInRound) {
   ++m_roundsInB;
   if (m_rounds > m_networkConfigPtr->maxRoundsTotal()) {
     // correct the actual total rounds spent over-all before switching to OLD
@@ -41,17 +43,10 @@ void RumorStateMachine::advanceFromNew(
     return;
   }
 
-  for (auto id : membersInRound) {
-    if (m_memberRounds.count(id) <= 0) {
-      m_memberRounds[id] = 0;
-    }
-  }
-
   // Compare our round to the majority of rounds
   int numLess = 0;
   int numGreaterOrEqual = 0;
-  for (const auto& entry : m_memberRounds) {
-    int theirRound = entry.second;
+  auto compareRound = [this, &numLess, &numGreaterOrEqual](int theirRound) {
     if (theirRound < m_rounds) {
       ++numLess;
     } else if (theirRound > m_networkConfigPtr->maxRoundsInB()) {
@@ -59,6 +54,21 @@ void RumorStateMachine::advanceFromNew(
     } else {
       ++numGreaterOrEqual;
     }
+  };
+
+  for (const auto& entry : m_memberRounds) {
+    compareRound(entry.second);
+  }
+
+  // Members of the round not heard from count as being at round 0
+  auto heard = m_memberRounds.begin();
+  for (auto id : membersInRound) {
+    while (heard != m_memberRounds.end() && heard->first < id) {
+      ++heard;
+    }
+    if (heard == m_memberRounds.end() || heard->first != id) {
+      compareRound(0);
+    }
   }
 
   if (numGreaterOrEqual > numLess) {
@@ -94,7 +104,7 @@ void RumorStateMachine::advanceFromKnown() {
 
 void RumorStateMachine::advanceToOld() {
   m_state = State::OLD;
-  m_memberRounds.clear();
+  std::vector<std::pair<int, int>>().swap(m_memberRounds);
 }
 
 // CONSTRUCTORS
@@ -125,20 +135,28 @@ RumorStateMachine::RumorStateMachine(const NetworkConfig* networkConfigPtr,
   }
 
   // Stay in B-m state
-  m_memberRounds[fromMember] = theirRound;
+  m_memberRounds.emplace_back(fromMember, theirRound);
 }
 
 void RumorStateMachine::rumorReceived(int memberId, int theirRound) {
   // Only care about other members when the rumor is NEW
   if (m_state == State::NEW) {
-    if (m_memberRounds[memberId] < theirRound) {
-      m_memberRounds[memberId] = theirRound;
+    auto it = std::lower_bound(
+        m_memberRounds.begin(), m_memberRounds.end(), memberId,
+        [](const std::pair<int, int>& entry, int id) {
+          return entry.first < id;
+        });
+    if (it == m_memberRounds.end() || it->first != memberId) {
+      it = m_memberRounds.emplace(it, memberId, 0);
+    }
+    if (it->second < theirRound) {
+      it->second = theirRound;
     }
   }
 }
 
 void RumorStateMachine::advanceRound(
-    const std::unordered_set<int>& peersInCurrentRound) {
+    const std::vector<int>& peersInCurrentRound) {
   ++m_rounds;
   switch (m_state) {
     case State::NEW:
@@ -22,8 +22,8 @@
 #include <functional>
 #include <map>
 #include <ostream>
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 #include "NetworkConfig.h"
 
 namespace RRS {
@@ -49,10 +49,13 @@ class RumorStateMachine {
   int m_rounds;
   int m_roundsInB;
   int m_roundsInC;
-  std::unordered_map<int, int> m_memberRounds;  // Member ID --> rounds
+  // (Member ID, rounds) of the members heard from in the current round,
+  // sorted by member ID. Only a few members are heard from in a round, and
+  // the vector keeps its capacity from one round to the next.
+  std::vector<std::pair<int, int>> m_memberRounds;
 
   // METHODS
-  void advanceFromNew(const std::unordered_set<int>& membersInRound);
+  void advanceFromNew(const std::vector<int>& membersInRound);
 
   void advanceFromKnown();
 
@@ -88,7 +91,9 @@ class RumorStateMachine {
   // METHODS
   void rumorReceived(int memberId, int theirRound);
 
-  void advanceRound(const std::unordered_set<int>& peersInCurrentRound);
+  // Advance by one round, with the sorted member IDs of
+  // 'peersInCurrentRound'
+  void advanceRound(const std::vector<int>& peersInCurrentRound);
 
   // CONST METHODS
   State state() const;
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBSERVER_CONCURRENCYLIMITER_H_
+#define ZILLIQA_SRC_LIBSERVER_CONCURRENCYLIMITER_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+
+/// Bounds the calls of each method that run at once. The methods and their
+/// limits are fixed at construction, so lookups need no lock. A limit of 0
+/// and the methods not given are not limited.
+class ConcurrencyLimiter {
+  struct Slot {
+    const unsigned int m_max;
+    std::atomic<unsigned int> m_running{0};
+    explicit Slot(unsigned int max) : m_max(max) {}
+  };
+
+  std::map<std::string, std::unique_ptr<Slot>> m_slots;
+
+  Slot* GetSlot(const std::string& method) const {
+    auto it = m_slots.find(method);
+    return it == m_slots.end() ? nullptr : it->second.get();
+  }
+
+ public:
+  explicit ConcurrencyLimiter(
+      const std::map<std::string, unsigned int>& limits) {
+    for (const auto& limit : limits) {
+      if (limit.second > 0) {
+        m_slots.emplace(limit.first,
+                        std::unique_ptr<Slot>(new Slot(limit.second)));
+      }
+    }
+  }
+
+  ConcurrencyLimiter(const ConcurrencyLimiter&) = delete;
+  ConcurrencyLimiter& operator=(const ConcurrencyLimiter&) = delete;
+
+  /// Returns false if method already runs its limit of calls. Every
+  /// successful call must be matched by a Release.
+  bool TryAcquire(const std::string& method) {
+    Slot* slot = GetSlot(method);
+    if (slot == nullptr) {
+      return true;
+    }
+    unsigned int running = slot->m_running.load();
+    do {
+      if (running >= slot->m_max) {
+        return false;
+      }
+    } while (!slot->m_running.compare_exchange_weak(running, running + 1));
+    return true;
+  }
+
+  void Release(const std::string& method) {
+    Slot* slot = GetSlot(method);
+    if (slot != nullptr) {
+      slot->m_running--;
+    }
+  }
+
+  unsigned int GetRunning(const std::string& method) const {
+    Slot* slot = GetSlot(method);
+    return slot == nullptr ? 0 : slot->m_running.load();
+  }
+};
+
+#endif  // ZILLIQA_SRC_LIBSERVER_CONCURRENCYLIMITER_H_
@@ -36,7 +36,8 @@ static ethash_mining_result_t FAIL_RESULT = {"", "", 0, false};
 
 // GetInstance returns the singleton instance
 GetWorkServer& GetWorkServer::GetInstance() {
-  static SafeHttpServer httpserver(GETWORK_SERVER_PORT);
+  static SafeHttpServer httpserver(
+      GETWORK_SERVER_MINE ? GETWORK_SERVER_PORT : REMOTE_MINE_PUSH_PORT);
   static GetWorkServer powserver(httpserver);
   return powserver;
 }
@@ -48,6 +49,10 @@ GetWorkServer& GetWorkServer::GetInstance() {
 // StartServer starts RPC server
 bool GetWorkServer::StartServer() {
   if (!GETWORK_SERVER_MINE) {
+    // Only takes the solutions pushed by the mining proxy
+    if (REMOTE_MINE && REMOTE_MINE_PUSH_PORT != 0) {
+      return StartListening();
+    }
     LOG_GENERAL(WARNING, "GETWORK_SERVER_MINE is not enabled");
     return false;
   }
@@ -78,6 +83,7 @@ bool GetWorkServer::StartMining(const PoWWorkPackage& wp) {
     m_curWork = wp;
     m_isMining = true;
   }
+  m_cvNewWork.notify_all();
 
   LOG_GENERAL(INFO, "Got PoW Work : "
                         << "header [" << wp.header << "], block ["
@@ -89,7 +95,11 @@ bool GetWorkServer::StartMining(const PoWWorkPackage& wp) {
 
 // StopMining stops mining and clear result
 void GetWorkServer::StopMining() {
-  m_isMining = false;
+  {
+    lock_guard<mutex> g(m_mutexWork);
+    m_isMining = false;
+  }
+  m_cvNewWork.notify_all();
 
   lock_guard<mutex> g(m_mutexResult);
   m_curResult.success = false;
@@ -210,13 +220,17 @@ bool GetWorkServer::UpdateCurrentResult(
 // RPC Methods
 //////////////////////////////////////////////////
 
-// ETH getWork Server
-Json::Value GetWorkServer::getWork() {
-  LOG_MARKER();
-  Json::Value result;
-
-  lock_guard<mutex> g(m_mutexWork);
+Json::Value GetWorkServer::AwaitWork(const string& header,
+                                     unsigned int timeoutInSeconds) {
+  unique_lock<mutex> lk(m_mutexWork);
+  m_cvNewWork.wait_for(lk, chrono::seconds(timeoutInSeconds), [&] {
+    return (m_isMining ? m_curWork.header : "") != header;
+  });
+  return GetWorkResult();
+}
 
+Json::Value GetWorkServer::GetWorkResult() {
+  Json::Value result;
   result.append(m_isMining ? m_curWork.header : "");
   result.append(m_isMining ? m_curWork.seed : "");
   result.append(m_isMining ? m_curWork.boundary : "");
@@ -226,6 +240,27 @@ Json::Value GetWorkServer::getWork() {
   return result;
 }
 
+// ETH getWork Server
+Json::Value GetWorkServer::getWork() {
+  LOG_MARKER();
+
+  lock_guard<mutex> g(m_mutexWork);
+  return GetWorkResult();
+}
+
+Json::Value GetWorkServer::getWorkLongPoll(const string& _header) {
+  LOG_MARKER();
+
+  // An empty header waits for the next work to start
+  string header = _header;
+  if (!header.empty() && !DataConversion::NormalizeHexString(header)) {
+    LOG_GENERAL(WARNING, "Invalid header: " << _header);
+    return getWork();
+  }
+
+  return AwaitWork(header, GETWORK_LONG_POLL_TIMEOUT);
+}
+
 bool GetWorkServer::submitWork(const string& _nonce, const string& _header,
                                const string& _mixdigest,
                                const string& _boundary,
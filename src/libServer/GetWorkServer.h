@@ -40,6 +40,13 @@ class AbstractStubServer : public jsonrpc::AbstractServer<AbstractStubServer> {
                            jsonrpc::JSON_ARRAY, NULL),
         &AbstractStubServer::getWorkI);
 
+    // Same as eth_getWork, once the work differs from the header given
+    this->bindAndAddMethod(
+        jsonrpc::Procedure("zil_getWorkLongPoll", jsonrpc::PARAMS_BY_POSITION,
+                           jsonrpc::JSON_ARRAY, "header", jsonrpc::JSON_STRING,
+                           NULL),
+        &AbstractStubServer::getWorkLongPollI);
+
     this->bindAndAddMethod(
         jsonrpc::Procedure("eth_submitHashrate", jsonrpc::PARAMS_BY_POSITION,
                            jsonrpc::JSON_BOOLEAN, "Hashrate",
@@ -63,6 +70,10 @@ class AbstractStubServer : public jsonrpc::AbstractServer<AbstractStubServer> {
     (void)request;
     response = this->getWork();
   }
+  inline virtual void getWorkLongPollI(const Json::Value &request,
+                                       Json::Value &response) {
+    response = this->getWorkLongPoll(request[0u].asString());
+  }
   inline virtual void submitHashrateI(const Json::Value &request,
                                       Json::Value &response) {
     response = this->submitHashrate(
@@ -76,6 +87,7 @@ class AbstractStubServer : public jsonrpc::AbstractServer<AbstractStubServer> {
   }
 
   virtual Json::Value getWork() = 0;
+  virtual Json::Value getWorkLongPoll(const std::string &header) = 0;
   virtual bool submitHashrate(const std::string &hashrate,
                               const std::string &miner_wallet,
                               const std::string &worker) = 0;
@@ -116,11 +128,15 @@ class GetWorkServer : public AbstractStubServer {
 
   PoWWorkPackage m_curWork;
   std::mutex m_mutexWork;
+  std::condition_variable m_cvNewWork;
 
   ethash_mining_result_t m_curResult;
   std::mutex m_mutexResult;
   std::condition_variable m_cvGotResult;
 
+  // Requires m_mutexWork
+  Json::Value GetWorkResult();
+
  public:
   // Returns the singleton instance.
   static GetWorkServer &GetInstance();
@@ -148,8 +164,14 @@ class GetWorkServer : public AbstractStubServer {
 
   bool UpdateCurrentResult(const ethash_mining_result_t &newResult);
 
+  // Returns the getWork result once the header of the current work, empty
+  // while not mining, differs from header, or after timeoutInSeconds
+  Json::Value AwaitWork(const std::string &header,
+                        unsigned int timeoutInSeconds);
+
   // RPC methods
   virtual Json::Value getWork();
+  virtual Json::Value getWorkLongPoll(const std::string &header);
   virtual bool submitHashrate(const std::string &hashrate,
                               const std::string &miner_wallet,
                               const std::string &worker);
@@ -35,6 +35,52 @@ using namespace boost::multiprecision;
 
 unsigned int JSON_TRAN_OBJECT_SIZE = 10;
 
+namespace {
+// Writers of the compact form of Json::FastWriter, with the keys of each
+// object in the order Json::Value sorts them
+
+// Appends the separator ('{' or ',') and the key of the next member
+void AppendKey(string& out, char separator, const char* key) {
+  out += separator;
+  out += '"';
+  out += key;
+  out += "\":";
+}
+
+void AppendValue(string& out, const Json::Value& value) {
+  Json::FastWriter writer;
+  writer.omitEndingLineFeed();
+  out += writer.write(value);
+}
+
+// Appends str quoted. Strings that Json::FastWriter escapes go through it.
+void AppendString(string& out, const string& str) {
+  for (const char c : str) {
+    const auto u = static_cast<unsigned char>(c);
+    if (u < 0x20 || u >= 0x7f || c == '"' || c == '\\') {
+      AppendValue(out, Json::Value(str));
+      return;
+    }
+  }
+  out += '"';
+  out += str;
+  out += '"';
+}
+
+template <unsigned int N>
+void AppendHex(string& out, const dev::FixedHash<N>& hash) {
+  static const char DIGITS[] = "0123456789abcdef";
+  const size_t pos = out.size();
+  out.resize(pos + 2 * N + 2);
+  out[pos] = '"';
+  for (unsigned int i = 0; i < N; i++) {
+    out[pos + 1 + 2 * i] = DIGITS[hash[i] >> 4];
+    out[pos + 2 + 2 * i] = DIGITS[hash[i] & 0x0f];
+  }
+  out[pos + 2 * N + 1] = '"';
+}
+}  // namespace
+
 const Json::Value JSONConversion::convertMicroBlockInfoArraytoJson(
     const vector<MicroBlockInfo>& v) {
   Json::Value mbInfosJson = Json::arrayValue;
@@ -89,6 +135,70 @@ const Json::Value JSONConversion::convertTxBlocktoJson(const TxBlock& txblock) {
   return ret;
 }
 
+void JSONConversion::writeTxBlockJson(const TxBlock& txblock, string& out) {
+  const TxBlockHeader& txheader = txblock.GetHeader();
+
+  std::string HeaderSignStr;
+  if (!DataConversion::SerializableToHexStr(txblock.GetCS2(), HeaderSignStr)) {
+    out += "null";  // the empty ret of convertTxBlocktoJson
+    return;
+  }
+
+  AppendKey(out, '{', "body");
+  AppendKey(out, '{', "BlockHash");
+  AppendHex(out, txblock.GetBlockHash());
+  AppendKey(out, ',', "HeaderSign");
+  AppendString(out, HeaderSignStr);
+  AppendKey(out, ',', "MicroBlockInfos");
+  out += '[';
+  bool first = true;
+  for (auto const& i : txblock.GetMicroBlockInfos()) {
+    if (!first) {
+      out += ',';
+    }
+    first = false;
+    AppendKey(out, '{', "MicroBlockHash");
+    AppendHex(out, i.m_microBlockHash);
+    AppendKey(out, ',', "MicroBlockShardId");
+    out += to_string(i.m_shardId);
+    AppendKey(out, ',', "MicroBlockTxnRootHash");
+    AppendHex(out, i.m_txnRootHash);
+    out += '}';
+  }
+  out += "]}";
+
+  AppendKey(out, ',', "header");
+  AppendKey(out, '{', "BlockNum");
+  AppendString(out, to_string(txheader.GetBlockNum()));
+  AppendKey(out, ',', "DSBlockNum");
+  AppendString(out, to_string(txheader.GetDSBlockNum()));
+  AppendKey(out, ',', "GasLimit");
+  AppendString(out, to_string(txheader.GetGasLimit()));
+  AppendKey(out, ',', "GasUsed");
+  AppendString(out, to_string(txheader.GetGasUsed()));
+  AppendKey(out, ',', "MbInfoHash");
+  AppendHex(out, txheader.GetMbInfoHash());
+  AppendKey(out, ',', "MinerPubKey");
+  AppendString(out, static_cast<string>(txheader.GetMinerPubKey()));
+  AppendKey(out, ',', "NumMicroBlocks");
+  out += to_string(static_cast<uint32_t>(txblock.GetMicroBlockInfos().size()));
+  AppendKey(out, ',', "NumTxns");
+  out += to_string(txheader.GetNumTxs());
+  AppendKey(out, ',', "PrevBlockHash");
+  AppendHex(out, txheader.GetPrevHash());
+  AppendKey(out, ',', "Rewards");
+  AppendString(out, txheader.GetRewards().str());
+  AppendKey(out, ',', "StateDeltaHash");
+  AppendHex(out, txheader.GetStateDeltaHash());
+  AppendKey(out, ',', "StateRootHash");
+  AppendHex(out, txheader.GetStateRootHash());
+  AppendKey(out, ',', "Timestamp");
+  AppendString(out, to_string(txblock.GetTimestamp()));
+  AppendKey(out, ',', "Version");
+  out += to_string(txheader.GetVersion());
+  out += "}}";
+}
+
 const Json::Value JSONConversion::convertDSblocktoJson(const DSBlock& dsblock) {
   Json::Value ret;
   Json::Value ret_header;
@@ -304,6 +414,41 @@ const Json::Value JSONConversion::convertTxtoJson(
   return _json;
 }
 
+void JSONConversion::writeTxJson(const TransactionWithReceipt& twr,
+                                 string& out) {
+  const Transaction& tx = twr.GetTransaction();
+
+  AppendKey(out, '{', "ID");
+  AppendHex(out, tx.GetTranID());
+  AppendKey(out, ',', "amount");
+  AppendString(out, tx.GetAmount().str());
+  if (!tx.GetCode().empty()) {
+    AppendKey(out, ',', "code");
+    AppendString(out, DataConversion::CharArrayToString(tx.GetCode()));
+  }
+  if (!tx.GetData().empty()) {
+    AppendKey(out, ',', "data");
+    AppendString(out, DataConversion::CharArrayToString(tx.GetData()));
+  }
+  AppendKey(out, ',', "gasLimit");
+  AppendString(out, to_string(tx.GetGasLimit()));
+  AppendKey(out, ',', "gasPrice");
+  AppendString(out, tx.GetGasPrice().str());
+  AppendKey(out, ',', "nonce");
+  AppendString(out, to_string(tx.GetNonce()));
+  AppendKey(out, ',', "receipt");
+  AppendValue(out, twr.GetTransactionReceipt().GetJsonValue());
+  AppendKey(out, ',', "senderPubKey");
+  AppendString(out, static_cast<string>(tx.GetSenderPubKey()));
+  AppendKey(out, ',', "signature");
+  AppendString(out, static_cast<string>(tx.GetSignature()));
+  AppendKey(out, ',', "toAddr");
+  AppendHex(out, tx.GetToAddr());
+  AppendKey(out, ',', "version");
+  AppendString(out, to_string(tx.GetVersion()));
+  out += '}';
+}
+
 const Json::Value JSONConversion::convertNode(const PairOfNode& node) {
   Json::Value _json;
   _json["PubKey"] = static_cast<string>(node.first);
@@ -20,6 +20,7 @@
 
 #include <json/json.h>
 #include <array>
+#include <string>
 #include <vector>
 
 #include "libData/BlockData/Block.h"
@@ -43,6 +44,12 @@ class JSONConversion {
       const Json::Value& _json);
   // Convert a Tx to JSON object
   static const Json::Value convertTxtoJson(const TransactionWithReceipt& twr);
+  // Append the compact JSON of a Tx to out, the same bytes as writing
+  // convertTxtoJson with Json::FastWriter but without building the object
+  static void writeTxJson(const TransactionWithReceipt& twr, std::string& out);
+  // Append the compact JSON of a TxBlock to out, the same bytes as writing
+  // convertTxBlocktoJson with Json::FastWriter
+  static void writeTxBlockJson(const TxBlock& txblock, std::string& out);
   // Convert a node to json
   static const Json::Value convertNode(const PairOfNode& node);
   // conver a node with reputation to json
@@ -29,6 +29,7 @@
 #include "libNetwork/P2PComm.h"
 #include "libNetwork/Peer.h"
 #include "libPersistence/BlockStorage.h"
+#include "libUtils/DetachedExecutor.h"
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
 #include "libUtils/TimeUtils.h"
@@ -102,6 +103,16 @@ LookupServer::LookupServer(Mediator& mediator,
                          jsonrpc::JSON_OBJECT, "param01", jsonrpc::JSON_STRING,
                          NULL),
       &LookupServer::GetBalanceI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetStateProof", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, "param01", jsonrpc::JSON_STRING,
+                         NULL),
+      &LookupServer::GetStateProofI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetTransactionProof", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, "param01", jsonrpc::JSON_STRING,
+                         "param02", jsonrpc::JSON_STRING, NULL),
+      &LookupServer::GetTransactionProofI);
   this->bindAndAddMethod(
       jsonrpc::Procedure("GetMinimumGasPrice", jsonrpc::PARAMS_BY_POSITION,
                          jsonrpc::JSON_STRING, NULL),
@@ -198,6 +209,18 @@ LookupServer::LookupServer(Mediator& mediator,
                          jsonrpc::JSON_OBJECT, "param01", jsonrpc::JSON_STRING,
                          NULL),
       &LookupServer::GetSmartContractStateI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure(
+          "GetSmartContractStatePage", jsonrpc::PARAMS_BY_POSITION,
+          jsonrpc::JSON_OBJECT, "param01", jsonrpc::JSON_STRING, "param02",
+          jsonrpc::JSON_STRING, "param03", jsonrpc::JSON_INTEGER, NULL),
+      &LookupServer::GetSmartContractStatePageI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure(
+          "GetTransactionsForAddress", jsonrpc::PARAMS_BY_POSITION,
+          jsonrpc::JSON_OBJECT, "param01", jsonrpc::JSON_STRING, "param02",
+          jsonrpc::JSON_STRING, "param03", jsonrpc::JSON_INTEGER, NULL),
+      &LookupServer::GetTransactionsForAddressI);
   this->bindAndAddMethod(
       jsonrpc::Procedure("GetSmartContractCode", jsonrpc::PARAMS_BY_POSITION,
                          jsonrpc::JSON_OBJECT, "param01", jsonrpc::JSON_STRING,
@@ -213,6 +236,24 @@ LookupServer::LookupServer(Mediator& mediator,
                          jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT,
                          "param01", jsonrpc::JSON_STRING, NULL),
       &LookupServer::GetTransactionsForTxBlockI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetTxBlocksRange", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, "param01", jsonrpc::JSON_STRING,
+                         "param02", jsonrpc::JSON_INTEGER, NULL),
+      &LookupServer::GetTxBlocksRangeI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetTransactionsForTxBlockRange",
+                         jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT,
+                         "param01", jsonrpc::JSON_STRING, "param02",
+                         jsonrpc::JSON_INTEGER, NULL),
+      &LookupServer::GetTransactionsForTxBlockRangeI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetEventLogs", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, "param01", jsonrpc::JSON_STRING,
+                         "param02", jsonrpc::JSON_STRING, "param03",
+                         jsonrpc::JSON_STRING, "param04", jsonrpc::JSON_INTEGER,
+                         NULL),
+      &LookupServer::GetEventLogsI);
   this->bindAndAddMethod(
       jsonrpc::Procedure("GetTotalCoinSupply", jsonrpc::PARAMS_BY_POSITION,
                          jsonrpc::JSON_REAL, NULL),
@@ -230,8 +271,6 @@ LookupServer::LookupServer(Mediator& mediator,
   m_TxBlockCache.first = 0;
   m_TxBlockCache.second.resize(NUM_PAGES_CACHE * PAGE_SIZE);
   m_RecentTransactions.resize(TXN_PAGE_SIZE);
-  m_TxBlockCountSumPair.first = 0;
-  m_TxBlockCountSumPair.second = 0;
   random_device rd;
   m_eng = mt19937(rd());
 }
@@ -277,36 +316,22 @@ bool LookupServer::StartCollectorThread() {
       }
       // LOG_GENERAL(INFO, "Size of txns " << txns.size());
 
-      bool hasTxn = false;
-
-      for (auto const& i :
-           {SEND_TYPE::ARCHIVAL_SEND_SHARD, SEND_TYPE::ARCHIVAL_SEND_DS}) {
-        {
-          lock_guard<mutex> g(m_mediator.m_lookup->m_txnShardMapMutex);
-          if (m_mediator.m_lookup->GetTxnFromShardMap(i).empty()) {
-            continue;
-          }
-          hasTxn = true;
-        }
-      }
+      const vector<Transaction> shardTxns =
+          m_mediator.m_lookup->GetTxnFromShardMap(
+              SEND_TYPE::ARCHIVAL_SEND_SHARD);
+      const vector<Transaction> dsTxns =
+          m_mediator.m_lookup->GetTxnFromShardMap(SEND_TYPE::ARCHIVAL_SEND_DS);
 
-      if (!hasTxn) {
+      if (shardTxns.empty() && dsTxns.empty()) {
         LOG_GENERAL(INFO, "No Txns to send for this seed node");
         continue;
       }
 
       bytes msg = {MessageType::LOOKUP, LookupInstructionType::FORWARDTXN};
 
-      {
-        lock_guard<mutex> g(m_mediator.m_lookup->m_txnShardMapMutex);
-        if (!Messenger::SetForwardTxnBlockFromSeed(
-                msg, MessageOffset::BODY,
-                m_mediator.m_lookup->GetTxnFromShardMap(
-                    SEND_TYPE::ARCHIVAL_SEND_SHARD),
-                m_mediator.m_lookup->GetTxnFromShardMap(
-                    SEND_TYPE::ARCHIVAL_SEND_DS))) {
-          continue;
-        }
+      if (!Messenger::SetForwardTxnBlockFromSeed(msg, MessageOffset::BODY,
+                                                 shardTxns, dsTxns)) {
+        continue;
       }
 
       m_mediator.m_lookup->SendMessageToRandomSeedNode(msg);
@@ -317,12 +342,132 @@ bool LookupServer::StartCollectorThread() {
       }
     }
   };
-  DetachedFunction(1, collectorThread);
+  DetachedExecutor::GetInstance().RunLongRunning("TxnCollector",
+                                                 collectorThread);
   return true;
 }
 
+Json::Value LookupServer::GetCachedResponse(
+    const string& key, const function<Json::Value()>& compute) {
+  if (LOOKUP_RESPONSE_CACHE_SIZE == 0) {
+    return compute();
+  }
+
+  shared_ptr<const Json::Value> response;
+  uint64_t generation = 0;
+  {
+    lock_guard<mutex> g(m_mutexResponseCache);
+    auto it = m_responseCache.find(key);
+    if (it != m_responseCache.end()) {
+      response = it->second;
+    }
+    generation = m_responseCacheGeneration;
+  }
+
+  // Errors are thrown to the caller and never cached
+  if (!response) {
+    response = make_shared<const Json::Value>(compute());
+
+    lock_guard<mutex> g(m_mutexResponseCache);
+    if ((generation == m_responseCacheGeneration) &&
+        (m_responseCache.size() < LOOKUP_RESPONSE_CACHE_SIZE)) {
+      m_responseCache.emplace(key, response);
+    }
+  }
+  return *response;
+}
+
+void LookupServer::HandleMethodCall(jsonrpc::Procedure& proc,
+                                    const Json::Value& input,
+                                    Json::Value& output) {
+  const string& method = proc.GetProcedureName();
+  if (!m_methodLimiter.TryAcquire(method)) {
+    throw JsonRpcException(RPC_MISC_ERROR,
+                           "Too many concurrent " + method +
+                               " requests, try again later");
+  }
+
+  try {
+    jsonrpc::AbstractServer<LookupServer>::HandleMethodCall(proc, input,
+                                                            output);
+  } catch (...) {
+    m_methodLimiter.Release(method);
+    throw;
+  }
+  m_methodLimiter.Release(method);
+}
+
+void LookupServer::AdmitTransaction(const string& client) {
+  if (!client.empty() && !m_clientTxnLimiter.TryAcquire(client)) {
+    throw JsonRpcException(RPC_MISC_ERROR,
+                           "Too many transactions from " + client +
+                               ", try again later");
+  }
+
+  if (m_mediator.m_lookup->IsTxnShardMapFull()) {
+    m_txnPoolFullRejects++;
+    throw JsonRpcException(RPC_DATABASE_ERROR,
+                           "Txn could not be added as database exceeded "
+                           "limit, try again later");
+  }
+}
+
+void LookupServer::AdmitSender(const Transaction& tx) {
+  if (!m_senderTxnLimiter.TryAcquire(tx.GetSenderAddr().hex())) {
+    throw JsonRpcException(RPC_MISC_ERROR,
+                           "Too many transactions from this sender, try "
+                           "again later");
+  }
+}
+
+Json::Value LookupServer::GetCreateTransactionRejects() const {
+  Json::Value _json;
+  _json["ClientRate"] = to_string(m_clientTxnLimiter.GetRejected());
+  _json["SenderRate"] = to_string(m_senderTxnLimiter.GetRejected());
+  _json["PoolFull"] = to_string(m_txnPoolFullRejects.load());
+  return _json;
+}
+
+void LookupServer::RefreshResponseCache() {
+  if (LOOKUP_RESPONSE_CACHE_SIZE == 0) {
+    return;
+  }
+
+  {
+    lock_guard<mutex> g(m_mutexResponseCache);
+    m_responseCache.clear();
+    m_responseCacheGeneration++;
+  }
+
+  // Computed on its own thread, as the one adding the block may hold locks
+  // the methods take
+  auto fillCache = [this]() mutable -> void {
+    try {
+      GetCachedResponse("GetLatestTxBlock",
+                        [this]() { return GetLatestTxBlock(); });
+      GetCachedResponse("GetLatestDsBlock",
+                        [this]() { return GetLatestDsBlock(); });
+      GetCachedResponse("GetBlockchainInfo",
+                        [this]() { return GetBlockchainInfo(); });
+      GetCachedResponse("GetShardingStructure",
+                        [this]() { return GetShardingStructure(); });
+    } catch (const exception& e) {
+      LOG_GENERAL(INFO, "Responses left to the first request: " << e.what());
+    }
+  };
+  DetachedFunction(1, fillCache);
+}
+
+/// Copies the account as of the last committed state into copy, so that RPC
+/// reads do not wait while a block is being committed
+const Account* ReadCommittedAccount(const Address& addr, Account& copy) {
+  return AccountStore::GetInstance().GetCommittedAccount(addr, copy) ? &copy
+                                                                      : nullptr;
+}
+
 bool ValidateTxn(const Transaction& tx, const Address& fromAddr,
-                 const Account* sender, const uint128_t& gasPrice) {
+                 const AccountSnapshot::Entry* sender,
+                 const uint128_t& gasPrice) {
   if (DataConversion::UnpackA(tx.GetVersion()) != CHAIN_ID) {
     throw JsonRpcException(ServerBase::RPC_VERIFY_REJECTED,
                            "CHAIN_ID incorrect");
@@ -374,11 +519,11 @@ bool ValidateTxn(const Transaction& tx, const Address& fromAddr,
                                to_string(CONTRACT_CREATE_GAS) + ")");
   }
 
-  if (sender->GetNonce() >= tx.GetNonce()) {
+  if (sender->m_nonce >= tx.GetNonce()) {
     throw JsonRpcException(ServerBase::RPC_INVALID_PARAMETER,
                            "Nonce (" + to_string(tx.GetNonce()) +
                                ") lower than current (" +
-                               to_string(sender->GetNonce()) + ")");
+                               to_string(sender->m_nonce) + ")");
   }
 
   return true;
@@ -398,14 +543,41 @@ Json::Value LookupServer::CreateTransaction(
       throw JsonRpcException(RPC_PARSE_ERROR, "Invalid Transaction JSON");
     }
 
-    Transaction tx = JSONConversion::convertJsontoTx(_json);
+    const Transaction tx = JSONConversion::convertJsontoTx(_json);
+    bool sendToDs = false;
+    if (_json.isMember("priority")) {
+      sendToDs = _json["priority"].asBool();
+    }
+    return CreateTransaction(tx, sendToDs, num_shards, gasPrice, targetFunc);
+  } catch (const JsonRpcException& je) {
+    throw je;
+  } catch (exception& e) {
+    LOG_GENERAL(INFO,
+                "[Error]" << e.what() << " Input: " << _json.toStyledString());
+    throw JsonRpcException(RPC_MISC_ERROR, "Unable to Process");
+  }
+}
 
+Json::Value LookupServer::CreateTransaction(
+    const Transaction& tx, bool sendToDs, const unsigned int num_shards,
+    const uint128_t& gasPrice, const CreateTransactionTargetFunc& targetFunc) {
+  if (!LOOKUP_NODE_MODE) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
+  }
+
+  try {
     Json::Value ret;
 
     const Address fromAddr = tx.GetSenderAddr();
-    const Account* sender = AccountStore::GetInstance().GetAccount(fromAddr);
+    AccountSnapshot::Entry senderEntry;
+    const AccountSnapshot::Entry* sender =
+        AccountStore::GetInstance().GetCommittedBalanceAndNonce(fromAddr,
+                                                                senderEntry)
+            ? &senderEntry
+            : nullptr;
+    Account toAccountCopy;
     const Account* toAccount =
-        AccountStore::GetInstance().GetAccount(tx.GetToAddr());
+        ReadCommittedAccount(tx.GetToAddr(), toAccountCopy);
 
     if (!ValidateTxn(tx, fromAddr, sender, gasPrice)) {
       return ret;
@@ -437,7 +609,7 @@ Json::Value LookupServer::CreateTransaction(
         }
         ret["Info"] = "Contract Creation txn, sent to shard";
         ret["ContractAddress"] =
-            Account::GetAddressForContract(fromAddr, sender->GetNonce()).hex();
+            Account::GetAddressForContract(fromAddr, sender->m_nonce).hex();
         break;
       case Transaction::ContractType::CONTRACT_CALL: {
         if (!ENABLE_SC) {
@@ -455,10 +627,6 @@ Json::Value LookupServer::CreateTransaction(
 
         unsigned int to_shard =
             Transaction::GetShardIndex(tx.GetToAddr(), num_shards);
-        bool sendToDs = false;
-        if (_json.isMember("priority")) {
-          sendToDs = _json["priority"].asBool();
-        }
         if ((to_shard == shard) && !sendToDs) {
           if (tx.GetGasLimit() > SHARD_MICROBLOCK_GAS_LIMIT) {
             throw JsonRpcException(
@@ -491,22 +659,45 @@ Json::Value LookupServer::CreateTransaction(
       default:
         throw JsonRpcException(RPC_MISC_ERROR, "Txn type unexpected");
     }
+    // Checked last, so that a txn rejected here is never queued
+    if (LOOKUP_NONCE_GAP_LIMIT > 0) {
+      const uint64_t pendingNonce = AccountStore::GetInstance().GetPendingNonce(
+          fromAddr, sender->m_nonce);
+      if (tx.GetNonce() > pendingNonce + LOOKUP_NONCE_GAP_LIMIT) {
+        throw JsonRpcException(RPC_INVALID_PARAMETER,
+                               "Nonce (" + to_string(tx.GetNonce()) +
+                                   ") too far ahead of pending (" +
+                                   to_string(pendingNonce) + ")");
+      }
+    }
     if (!targetFunc(tx, mapIndex)) {
       throw JsonRpcException(RPC_DATABASE_ERROR,
                              "Txn could not be added as database exceeded "
                              "limit or the txn was already present");
     }
+    if (LOOKUP_NONCE_GAP_LIMIT > 0) {
+      AccountStore::GetInstance().AdmitPendingNonce(fromAddr, tx.GetNonce());
+    }
     ret["TranID"] = tx.GetTranID().hex();
     return ret;
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (exception& e) {
-    LOG_GENERAL(INFO,
-                "[Error]" << e.what() << " Input: " << _json.toStyledString());
+    LOG_GENERAL(INFO, "[Error]" << e.what() << " Txn: " << tx.GetTranID());
     throw JsonRpcException(RPC_MISC_ERROR, "Unable to Process");
   }
 }
 
+Json::Value LookupServer::SubmitTransaction(const Transaction& tx,
+                                            bool sendToDs,
+                                            const string& client) {
+  AdmitTransaction(client);
+  return CreateTransaction(
+      tx, sendToDs, m_mediator.m_lookup->GetShardPeers().size(),
+      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetGasPrice(),
+      m_createTransactionTarget);
+}
+
 Json::Value LookupServer::GetTransaction(const string& transactionHash) {
   LOG_MARKER();
 
@@ -549,7 +740,7 @@ Json::Value LookupServer::GetDsBlock(const string& blockNum) {
   try {
     uint64_t BlockNum = stoull(blockNum);
     return JSONConversion::convertDSblocktoJson(
-        m_mediator.m_dsBlockChain.GetBlock(BlockNum));
+        *m_mediator.m_dsBlockChain.GetBlockPtr(BlockNum));
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (runtime_error& e) {
@@ -575,7 +766,7 @@ Json::Value LookupServer::GetTxBlock(const string& blockNum) {
   try {
     uint64_t BlockNum = stoull(blockNum);
     return JSONConversion::convertTxBlocktoJson(
-        m_mediator.m_txBlockChain.GetBlock(BlockNum));
+        *m_mediator.m_txBlockChain.GetBlockPtr(BlockNum));
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (runtime_error& e) {
@@ -653,7 +844,8 @@ Json::Value LookupServer::GetBalance(const string& address) {
       throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY, "invalid address");
     }
     Address addr(tmpaddr);
-    const Account* account = AccountStore::GetInstance().GetAccount(addr);
+    Account accountCopy;
+    const Account* account = ReadCommittedAccount(addr, accountCopy);
 
     Json::Value ret;
     if (account != nullptr) {
@@ -677,6 +869,122 @@ Json::Value LookupServer::GetBalance(const string& address) {
   }
 }
 
+Json::Value LookupServer::GetStateProof(const string& address) {
+  LOG_MARKER();
+
+  if (!LOOKUP_NODE_MODE) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
+  }
+
+  try {
+    if (address.size() != ACC_ADDR_SIZE * 2) {
+      throw JsonRpcException(RPC_INVALID_PARAMETER,
+                             "Address size not appropriate");
+    }
+
+    bytes tmpaddr;
+    if (!DataConversion::HexStrToUint8Vec(address, tmpaddr)) {
+      throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY, "invalid address");
+    }
+    Address addr(tmpaddr);
+
+    dev::h256 root;
+    const vector<bytes> proof =
+        AccountStore::GetInstance().GetStateProof(addr, root);
+
+    Json::Value ret;
+    ret["stateRoot"] = root.hex();
+    ret["proof"] = Json::arrayValue;
+    for (const auto& node : proof) {
+      string nodeStr;
+      if (!DataConversion::Uint8VecToHexStr(node, nodeStr)) {
+        throw JsonRpcException(RPC_MISC_ERROR, "Unable To Process");
+      }
+      ret["proof"].append(nodeStr);
+    }
+
+    Account accountCopy;
+    const Account* account = ReadCommittedAccount(addr, accountCopy);
+    bytes rawAccount;
+    if (account != nullptr && account->SerializeBase(rawAccount, 0)) {
+      string accountStr;
+      if (DataConversion::Uint8VecToHexStr(rawAccount, accountStr)) {
+        ret["account"] = accountStr;
+      }
+    }
+
+    return ret;
+  } catch (const JsonRpcException& je) {
+    throw je;
+  } catch (exception& e) {
+    LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << address);
+    throw JsonRpcException(RPC_MISC_ERROR, "Unable To Process");
+  }
+}
+
+Json::Value LookupServer::GetTransactionProof(const string& txBlockNum,
+                                              const string& tranHash) {
+  LOG_MARKER();
+
+  if (!LOOKUP_NODE_MODE) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
+  }
+
+  if (tranHash.size() != TRAN_HASH_SIZE * 2) {
+    throw JsonRpcException(RPC_INVALID_PARAMETER,
+                           "Txn Hash size not appropriate");
+  }
+
+  try {
+    const TxnHash tranID(tranHash);
+    const uint64_t blockNum = strtoull(txBlockNum.c_str(), NULL, 0);
+    const auto txBlock = m_mediator.m_txBlockChain.GetBlockPtr(blockNum);
+    if (txBlock->GetHeader().GetBlockNum() != blockNum) {
+      throw JsonRpcException(RPC_INVALID_PARAMS, "Tx Block does not exist");
+    }
+
+    for (const auto& mbInfo : txBlock->GetMicroBlockInfos()) {
+      if (mbInfo.m_txnRootHash == TxnHash()) {
+        continue;
+      }
+
+      MicroBlockSharedPtr mbptr;
+      if (!BlockStorage::GetBlockStorage().GetMicroBlock(
+              mbInfo.m_microBlockHash, mbptr) &&
+          (!m_mediator.m_lookup->m_historicalDB ||
+           !BlockStorage::GetBlockStorage().GetHistoricalMicroBlock(
+               mbInfo.m_microBlockHash, mbptr))) {
+        throw JsonRpcException(RPC_DATABASE_ERROR, "Failed to get Microblock");
+      }
+
+      const vector<TxnHash>& tranHashes = mbptr->GetTranHashes();
+      const auto it = find(tranHashes.begin(), tranHashes.end(), tranID);
+      if (it == tranHashes.end()) {
+        continue;
+      }
+
+      Json::Value ret;
+      ret["microBlockHash"] = mbInfo.m_microBlockHash.hex();
+      ret["txRootHash"] = mbInfo.m_txnRootHash.hex();
+      ret["shardId"] = mbInfo.m_shardId;
+      ret["index"] = static_cast<Json::UInt64>(it - tranHashes.begin());
+      ret["tranHashes"] = Json::arrayValue;
+      for (const auto& hash : tranHashes) {
+        ret["tranHashes"].append(hash.hex());
+      }
+      return ret;
+    }
+  } catch (const JsonRpcException& je) {
+    throw je;
+  } catch (exception& e) {
+    LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << tranHash);
+    throw JsonRpcException(RPC_MISC_ERROR, "Unable To Process");
+  }
+
+  throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
+                         "Txn Hash not in the Tx Block");
+}
+
 Json::Value LookupServer::GetSmartContractState(const string& address,
                                                 const string& vname,
                                                 const Json::Value& indices) {
@@ -698,7 +1006,8 @@ Json::Value LookupServer::GetSmartContractState(const string& address,
     }
 
     Address addr(tmpaddr);
-    const Account* account = AccountStore::GetInstance().GetAccount(addr);
+    Account accountCopy;
+    const Account* account = ReadCommittedAccount(addr, accountCopy);
 
     if (account == nullptr) {
       throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
@@ -725,6 +1034,143 @@ Json::Value LookupServer::GetSmartContractState(const string& address,
   }
 }
 
+Json::Value LookupServer::GetSmartContractStatePage(const string& address,
+                                                    const string& cursor,
+                                                    unsigned int pageSize) {
+  LOG_MARKER();
+
+  if (!LOOKUP_NODE_MODE) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
+  }
+
+  try {
+    if (address.size() != ACC_ADDR_SIZE * 2) {
+      throw JsonRpcException(RPC_INVALID_PARAMETER,
+                             "Address size not appropriate");
+    }
+    if (pageSize == 0 || pageSize > CONTRACT_STATE_PAGE_SIZE_MAX) {
+      throw JsonRpcException(RPC_INVALID_PARAMETER,
+                             "Page size must be from 1 to " +
+                                 to_string(CONTRACT_STATE_PAGE_SIZE_MAX));
+    }
+    bytes tmpaddr;
+    if (!DataConversion::HexStrToUint8Vec(address, tmpaddr)) {
+      throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY, "invalid address");
+    }
+    // The cursor is the hex of the last storage key of the previous page
+    bytes startAfter;
+    if (!cursor.empty() &&
+        !DataConversion::HexStrToUint8Vec(cursor, startAfter)) {
+      throw JsonRpcException(RPC_INVALID_PARAMETER, "invalid cursor");
+    }
+
+    Address addr(tmpaddr);
+    Account accountCopy;
+    const Account* account = ReadCommittedAccount(addr, accountCopy);
+
+    if (account == nullptr) {
+      throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
+                             "Address does not exist");
+    }
+
+    if (!account->isContract()) {
+      throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
+                             "Address not contract address");
+    }
+
+    Json::Value state = Json::objectValue;
+    string nextStartAfter;
+    if (!account->FetchStateJsonPage(
+            state, DataConversion::CharArrayToString(startAfter), pageSize,
+            nextStartAfter)) {
+      throw JsonRpcException(RPC_INTERNAL_ERROR, "FetchStateJsonPage failed");
+    }
+
+    Json::Value _json;
+    _json["state"] = state;
+    string next;
+    if (!nextStartAfter.empty() &&
+        !DataConversion::Uint8VecToHexStr(
+            DataConversion::StringToCharArray(nextStartAfter), next)) {
+      throw JsonRpcException(RPC_INTERNAL_ERROR, "Cursor encoding failed");
+    }
+    _json["next"] = next;
+    return _json;
+  } catch (const JsonRpcException& je) {
+    throw je;
+  } catch (exception& e) {
+    LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << address);
+    throw JsonRpcException(RPC_MISC_ERROR, "Unable To Process");
+  }
+}
+
+Json::Value LookupServer::GetTransactionsForAddress(const string& address,
+                                                    const string& cursor,
+                                                    unsigned int pageSize) {
+  LOG_MARKER();
+
+  if (!LOOKUP_NODE_MODE) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
+  }
+  if (!ENABLE_TXN_HISTORY_INDEX) {
+    throw JsonRpcException(RPC_INVALID_REQUEST,
+                           "Transaction history is not indexed");
+  }
+
+  try {
+    if (address.size() != ACC_ADDR_SIZE * 2) {
+      throw JsonRpcException(RPC_INVALID_PARAMETER,
+                             "Address size not appropriate");
+    }
+    if (pageSize == 0 || pageSize > TXN_HISTORY_PAGE_SIZE_MAX) {
+      throw JsonRpcException(RPC_INVALID_PARAMETER,
+                             "Page size must be from 1 to " +
+                                 to_string(TXN_HISTORY_PAGE_SIZE_MAX));
+    }
+    bytes tmpaddr;
+    if (!DataConversion::HexStrToUint8Vec(address, tmpaddr)) {
+      throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY, "invalid address");
+    }
+    // The cursor is the hex of the (epoch, hash) of the last transaction of
+    // the previous page
+    bytes startAfter;
+    if (!cursor.empty() &&
+        !DataConversion::HexStrToUint8Vec(cursor, startAfter)) {
+      throw JsonRpcException(RPC_INVALID_PARAMETER, "invalid cursor");
+    }
+
+    vector<pair<uint64_t, TxnHash>> txns;
+    string nextStartAfter;
+    if (!BlockStorage::GetBlockStorage().GetTxnHistory(
+            Address(tmpaddr), DataConversion::CharArrayToString(startAfter),
+            pageSize, txns, nextStartAfter)) {
+      throw JsonRpcException(RPC_INVALID_PARAMETER, "invalid cursor");
+    }
+
+    Json::Value _json;
+    _json["txns"] = Json::arrayValue;
+    for (const auto& txn : txns) {
+      Json::Value entry;
+      entry["epoch"] = to_string(txn.first);
+      entry["ID"] = txn.second.hex();
+      _json["txns"].append(entry);
+    }
+    string next;
+    if (!nextStartAfter.empty() &&
+        !DataConversion::Uint8VecToHexStr(
+            DataConversion::StringToCharArray(nextStartAfter), next)) {
+      throw JsonRpcException(RPC_INTERNAL_ERROR, "Cursor encoding failed");
+    }
+    _json["next"] = next;
+    return _json;
+  } catch (const JsonRpcException& je) {
+    throw je;
+  } catch (exception& e) {
+    LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << address);
+    throw JsonRpcException(RPC_MISC_ERROR, "Unable To Process");
+  }
+}
+
 Json::Value LookupServer::GetSmartContractInit(const string& address) {
   LOG_MARKER();
 
@@ -744,7 +1190,8 @@ Json::Value LookupServer::GetSmartContractInit(const string& address) {
       throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY, "invalid address");
     }
     Address addr(tmpaddr);
-    const Account* account = AccountStore::GetInstance().GetAccount(addr);
+    Account accountCopy;
+    const Account* account = ReadCommittedAccount(addr, accountCopy);
 
     if (account == nullptr) {
       throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
@@ -788,7 +1235,8 @@ Json::Value LookupServer::GetSmartContractCode(const string& address) {
       throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY, "invalid address");
     }
     Address addr(tmpaddr);
-    const Account* account = AccountStore::GetInstance().GetAccount(addr);
+    Account accountCopy;
+    const Account* account = ReadCommittedAccount(addr, accountCopy);
 
     if (account == nullptr) {
       throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
@@ -830,7 +1278,8 @@ Json::Value LookupServer::GetSmartContracts(const string& address) {
     }
 
     Address addr(tmpaddr);
-    const Account* account = AccountStore::GetInstance().GetAccount(addr);
+    Account accountCopy;
+    const Account* account = ReadCommittedAccount(addr, accountCopy);
 
     if (account == nullptr) {
       throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
@@ -846,8 +1295,9 @@ Json::Value LookupServer::GetSmartContracts(const string& address) {
 
     for (uint64_t i = 0; i < nonce; i++) {
       Address contractAddr = Account::GetAddressForContract(addr, i);
+      Account contractAccountCopy;
       const Account* contractAccount =
-          AccountStore::GetInstance().GetAccount(contractAddr);
+          ReadCommittedAccount(contractAddr, contractAccountCopy);
 
       if (contractAccount == nullptr || !contractAccount->isContract()) {
         continue;
@@ -940,22 +1390,14 @@ string LookupServer::GetNumTransactions() {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
   }
 
-  lock_guard<mutex> g(m_mutexBlockTxPair);
-
   uint64_t currBlock =
       m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
   if (currBlock == INIT_BLOCK_NUMBER) {
     throw JsonRpcException(RPC_IN_WARMUP, "No Tx blocks");
   }
-  if (m_BlockTxPair.first < currBlock) {
-    for (uint64_t i = m_BlockTxPair.first + 1; i <= currBlock; i++) {
-      m_BlockTxPair.second +=
-          m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
-    }
-  }
-  m_BlockTxPair.first = currBlock;
 
-  return m_BlockTxPair.second.str();
+  uint64_t dsBlockNum = 0;
+  return GetTxnCount(currBlock, dsBlockNum).str();
 }
 
 size_t LookupServer::GetNumTransactions(uint64_t blockNum) {
@@ -974,13 +1416,114 @@ size_t LookupServer::GetNumTransactions(uint64_t blockNum) {
     return 0;
   }
 
-  size_t i, res = 0;
+  uint64_t dsBlockNum = 0;
+  const uint128_t numTxns = GetTxnCount(currBlockNum, dsBlockNum);
+  return static_cast<size_t>(numTxns - GetTxnCount(blockNum, dsBlockNum));
+}
+
+uint128_t LookupServer::GetTxnCount(uint64_t blockNum, uint64_t& dsBlockNum) {
+  auto& storage = BlockStorage::GetBlockStorage();
+  lock_guard<mutex> g(m_mutexTxnCounts);
 
-  for (i = blockNum + 1; i <= currBlockNum; i++) {
-    res += m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+  uint128_t numTxns = 0;
+  if ((m_txnCountTip != INIT_BLOCK_NUMBER) && (blockNum <= m_txnCountTip) &&
+      storage.GetTxnCount(blockNum, numTxns, dsBlockNum)) {
+    return numTxns;
+  }
+
+  // Resume from the highest indexed block, which is lower after a restart or
+  // a deleted tip
+  uint64_t next = 0;
+  if (!storage.GetLastTxnCountBlockNum(m_txnCountTip)) {
+    m_txnCountTip = INIT_BLOCK_NUMBER;
+  } else if (m_txnCountTip >= blockNum) {
+    if (!storage.GetTxnCount(blockNum, numTxns, dsBlockNum)) {
+      throw JsonRpcException(RPC_DATABASE_ERROR,
+                             "Txn count of block " + to_string(blockNum) +
+                                 " missing");
+    }
+    return numTxns;
+  } else {
+    if (!storage.GetTxnCount(m_txnCountTip, numTxns, dsBlockNum)) {
+      throw JsonRpcException(RPC_DATABASE_ERROR, "Txn count index corrupted");
+    }
+    next = m_txnCountTip + 1;
   }
 
-  return res;
+  if (blockNum > next) {
+    LOG_GENERAL(INFO, "Indexing the txn counts of tx blocks "
+                          << next << " to " << blockNum);
+  }
+  for (uint64_t i = next; i <= blockNum; i++) {
+    const auto txBlock = m_mediator.m_txBlockChain.GetBlockPtr(i);
+    if (txBlock->GetHeader().GetBlockNum() != i) {
+      throw JsonRpcException(RPC_DATABASE_ERROR,
+                             "Tx block " + to_string(i) + " missing");
+    }
+    // Block 0 is left out, as the counts have always done
+    if (i > 0) {
+      numTxns += txBlock->GetHeader().GetNumTxs();
+    }
+    dsBlockNum = txBlock->GetHeader().GetDSBlockNum();
+    if (!storage.PutTxnCount(i, numTxns, dsBlockNum)) {
+      throw JsonRpcException(RPC_DATABASE_ERROR, "Failed to index txn count");
+    }
+    m_txnCountTip = i;
+  }
+  return numTxns;
+}
+
+uint64_t LookupServer::GetFirstTxBlockOfDSEpoch(uint64_t txBlockNum,
+                                                uint64_t dsBlockNum) {
+  auto& storage = BlockStorage::GetBlockStorage();
+  lock_guard<mutex> g(m_mutexTxnCounts);
+
+  if (m_dsEpochFirstTxBlock.first == dsBlockNum) {
+    return m_dsEpochFirstTxBlock.second;
+  }
+
+  // The DS blocks of the tx blocks never decrease, so the first one of the
+  // epoch is the lowest block in [lo, txBlockNum] not in an earlier epoch
+  uint64_t lo = 0;
+  if ((m_dsEpochFirstTxBlock.first != INIT_BLOCK_NUMBER) &&
+      (m_dsEpochFirstTxBlock.first < dsBlockNum)) {
+    lo = m_dsEpochFirstTxBlock.second;
+  }
+  uint64_t hi = txBlockNum;
+  while (lo < hi) {
+    const uint64_t mid = lo + (hi - lo) / 2;
+    uint128_t numTxns = 0;
+    uint64_t midDSBlockNum = 0;
+    if (!storage.GetTxnCount(mid, numTxns, midDSBlockNum)) {
+      throw JsonRpcException(RPC_DATABASE_ERROR,
+                             "Txn count of block " + to_string(mid) +
+                                 " missing");
+    }
+    if (midDSBlockNum < dsBlockNum) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  m_dsEpochFirstTxBlock = {dsBlockNum, lo};
+  return lo;
+}
+
+void LookupServer::IndexTxnCounts() {
+  auto indexTxnCounts = [this]() mutable -> void {
+    try {
+      const uint64_t currBlockNum =
+          m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      if (currBlockNum != INIT_BLOCK_NUMBER) {
+        uint64_t dsBlockNum = 0;
+        GetTxnCount(currBlockNum, dsBlockNum);
+      }
+    } catch (const JsonRpcException& e) {
+      LOG_GENERAL(WARNING, "Failed to index txn counts: " << e.what());
+    }
+  };
+  DetachedFunction(1, indexTxnCounts);
 }
 double LookupServer::GetTransactionRate() {
   LOG_MARKER();
@@ -1119,7 +1662,8 @@ double LookupServer::GetTxBlockRate() {
 string LookupServer::GetTotalCoinSupply() {
   auto totalSupply = TOTAL_COINBASE_REWARD + TOTAL_GENESIS_TOKEN;
   boost::multiprecision::cpp_dec_float_50 ans(totalSupply.str());
-  const Account* account = AccountStore::GetInstance().GetAccount(NullAddress);
+  Account accountCopy;
+  const Account* account = ReadCommittedAccount(NullAddress, accountCopy);
   boost::multiprecision::cpp_dec_float_50 rewards(account->GetBalance().str());
   ans -= rewards;
   ans /= 1000000000000;  // Convert to ZIL
@@ -1154,7 +1698,8 @@ Json::Value LookupServer::DSBlockListing(unsigned int page) {
   if (m_DSBlockCache.second.size() == 0) {
     try {
       // add the hash of genesis block
-      DSBlockHeader dshead = m_mediator.m_dsBlockChain.GetBlock(0).GetHeader();
+      DSBlockHeader dshead =
+          m_mediator.m_dsBlockChain.GetBlockPtr(0)->GetHeader();
       SHA2<HashType::HASH_VARIANT_256> sha2;
       bytes vec;
       dshead.Serialize(vec, 0);
@@ -1174,15 +1719,16 @@ Json::Value LookupServer::DSBlockListing(unsigned int page) {
 
   if (currBlockNum > m_DSBlockCache.first) {
     for (uint64_t i = m_DSBlockCache.first + 1; i < currBlockNum; i++) {
-      m_DSBlockCache.second.insert_new(m_DSBlockCache.second.size(),
-                                       m_mediator.m_dsBlockChain.GetBlock(i + 1)
-                                           .GetHeader()
-                                           .GetPrevHash()
-                                           .hex());
+      m_DSBlockCache.second.insert_new(
+          m_DSBlockCache.second.size(),
+          m_mediator.m_dsBlockChain.GetBlockPtr(i + 1)
+              ->GetHeader()
+              .GetPrevHash()
+              .hex());
     }
     // for the latest block
     DSBlockHeader dshead =
-        m_mediator.m_dsBlockChain.GetBlock(currBlockNum).GetHeader();
+        m_mediator.m_dsBlockChain.GetBlockPtr(currBlockNum)->GetHeader();
     SHA2<HashType::HASH_VARIANT_256> sha2;
     bytes vec;
     dshead.Serialize(vec, 0);
@@ -1217,10 +1763,11 @@ Json::Value LookupServer::DSBlockListing(unsigned int page) {
     for (uint64_t i = offset; i < PAGE_SIZE + offset && i <= currBlockNum;
          i++) {
       tmpJson.clear();
-      tmpJson["Hash"] = m_mediator.m_dsBlockChain.GetBlock(currBlockNum - i + 1)
-                            .GetHeader()
-                            .GetPrevHash()
-                            .hex();
+      tmpJson["Hash"] =
+          m_mediator.m_dsBlockChain.GetBlockPtr(currBlockNum - i + 1)
+              ->GetHeader()
+              .GetPrevHash()
+              .hex();
       tmpJson["BlockNum"] = uint(currBlockNum - i);
       _json["data"].append(tmpJson);
     }
@@ -1251,7 +1798,8 @@ Json::Value LookupServer::TxBlockListing(unsigned int page) {
   if (m_TxBlockCache.second.size() == 0) {
     try {
       // add the hash of genesis block
-      TxBlockHeader txhead = m_mediator.m_txBlockChain.GetBlock(0).GetHeader();
+      TxBlockHeader txhead =
+          m_mediator.m_txBlockChain.GetBlockPtr(0)->GetHeader();
       SHA2<HashType::HASH_VARIANT_256> sha2;
       bytes vec;
       txhead.Serialize(vec, 0);
@@ -1271,15 +1819,16 @@ Json::Value LookupServer::TxBlockListing(unsigned int page) {
 
   if (currBlockNum > m_TxBlockCache.first) {
     for (uint64_t i = m_TxBlockCache.first + 1; i < currBlockNum; i++) {
-      m_TxBlockCache.second.insert_new(m_TxBlockCache.second.size(),
-                                       m_mediator.m_txBlockChain.GetBlock(i + 1)
-                                           .GetHeader()
-                                           .GetPrevHash()
-                                           .hex());
+      m_TxBlockCache.second.insert_new(
+          m_TxBlockCache.second.size(),
+          m_mediator.m_txBlockChain.GetBlockPtr(i + 1)
+              ->GetHeader()
+              .GetPrevHash()
+              .hex());
     }
     // for the latest block
     TxBlockHeader txhead =
-        m_mediator.m_txBlockChain.GetBlock(currBlockNum).GetHeader();
+        m_mediator.m_txBlockChain.GetBlockPtr(currBlockNum)->GetHeader();
     SHA2<HashType::HASH_VARIANT_256> sha2;
     bytes vec;
     txhead.Serialize(vec, 0);
@@ -1315,10 +1864,11 @@ Json::Value LookupServer::TxBlockListing(unsigned int page) {
     for (uint64_t i = offset; i < PAGE_SIZE + offset && i <= currBlockNum;
          i++) {
       tmpJson.clear();
-      tmpJson["Hash"] = m_mediator.m_txBlockChain.GetBlock(currBlockNum - i + 1)
-                            .GetHeader()
-                            .GetPrevHash()
-                            .hex();
+      tmpJson["Hash"] =
+          m_mediator.m_txBlockChain.GetBlockPtr(currBlockNum - i + 1)
+              ->GetHeader()
+              .GetPrevHash()
+              .hex();
       tmpJson["BlockNum"] = uint(currBlockNum - i);
       _json["data"].append(tmpJson);
     }
@@ -1425,37 +1975,18 @@ string LookupServer::GetNumTxnsDSEpoch() {
     auto latestTxBlockNum = latestTxBlock.GetBlockNum();
     auto latestDSBlockNum = latestTxBlock.GetDSBlockNum();
 
-    lock_guard<mutex> g(m_mutexTxBlockCountSumPair);
-
-    if (latestTxBlockNum > m_TxBlockCountSumPair.first) {
-      // Case where the DS Epoch is same
-      if (m_mediator.m_txBlockChain.GetBlock(m_TxBlockCountSumPair.first)
-              .GetHeader()
-              .GetDSBlockNum() == latestDSBlockNum) {
-        for (auto i = latestTxBlockNum; i > m_TxBlockCountSumPair.first; i--) {
-          m_TxBlockCountSumPair.second +=
-              m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
-        }
-      }
-      // Case if DS Epoch Changed
-      else {
-        m_TxBlockCountSumPair.second = 0;
-
-        for (auto i = latestTxBlockNum; i > m_TxBlockCountSumPair.first; i--) {
-          if (m_mediator.m_txBlockChain.GetBlock(i)
-                  .GetHeader()
-                  .GetDSBlockNum() < latestDSBlockNum) {
-            break;
-          }
-          m_TxBlockCountSumPair.second +=
-              m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
-        }
-      }
-
-      m_TxBlockCountSumPair.first = latestTxBlockNum;
+    if (latestTxBlockNum == INIT_BLOCK_NUMBER) {
+      return "0";
     }
 
-    return m_TxBlockCountSumPair.second.str();
+    uint64_t dsBlockNum = 0;
+    const uint128_t numTxns = GetTxnCount(latestTxBlockNum, dsBlockNum);
+    const uint64_t firstTxBlockNum =
+        GetFirstTxBlockOfDSEpoch(latestTxBlockNum, latestDSBlockNum);
+    if (firstTxBlockNum == 0) {
+      return numTxns.str();
+    }
+    return (numTxns - GetTxnCount(firstTxBlockNum - 1, dsBlockNum)).str();
   } catch (const JsonRpcException& je) {
     throw je;
   }
@@ -1478,9 +2009,9 @@ Json::Value LookupServer::GetTransactionsForTxBlock(const string& txBlockNum) {
     throw JsonRpcException(RPC_INVALID_PARAMETER, e.what());
   }
 
-  auto const& txBlock = m_mediator.m_txBlockChain.GetBlock(txNum);
+  const auto txBlock = m_mediator.m_txBlockChain.GetBlockPtr(txNum);
 
-  return GetTransactionsForTxBlock(txBlock,
+  return GetTransactionsForTxBlock(*txBlock,
                                    m_mediator.m_lookup->m_historicalDB);
 }
 
@@ -1537,6 +2068,208 @@ Json::Value LookupServer::GetTransactionsForTxBlock(const TxBlock& txBlock,
   return _json;
 }
 
+void LookupServer::GetTxBlockRange(const string& fromBlockNum,
+                                   unsigned int count,
+                                   vector<TxBlockSharedPtr>& blocks,
+                                   bool& more) {
+  if (count == 0 || count > TXBLOCK_RANGE_SIZE_MAX) {
+    throw JsonRpcException(RPC_INVALID_PARAMETER,
+                           "Count must be from 1 to " +
+                               to_string(TXBLOCK_RANGE_SIZE_MAX));
+  }
+
+  uint64_t lowBlockNum;
+  try {
+    lowBlockNum = stoull(fromBlockNum);
+  } catch (exception& e) {
+    LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << fromBlockNum);
+    throw JsonRpcException(RPC_INVALID_PARAMS, "Invalid block number");
+  }
+
+  const uint64_t latestBlockNum =
+      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+  if (lowBlockNum > latestBlockNum) {
+    throw JsonRpcException(RPC_INVALID_PARAMS, "Tx Block does not exist");
+  }
+  const uint64_t hiBlockNum =
+      min(latestBlockNum, lowBlockNum + (count - 1));
+
+  if (!BlockStorage::GetBlockStorage().GetRangeTxBlocks(lowBlockNum,
+                                                        hiBlockNum, blocks)) {
+    throw JsonRpcException(RPC_DATABASE_ERROR, "Failed to get Tx Blocks");
+  }
+  more = blocks.back()->GetHeader().GetBlockNum() < latestBlockNum;
+}
+
+Json::Value LookupServer::GetTxBlocksRange(const string& fromBlockNum,
+                                           unsigned int count) {
+  LOG_MARKER();
+  if (!LOOKUP_NODE_MODE) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
+  }
+
+  vector<TxBlockSharedPtr> blocks;
+  bool more = false;
+  GetTxBlockRange(fromBlockNum, count, blocks, more);
+
+  Json::Value _json;
+  _json["blocks"] = Json::arrayValue;
+  for (const auto& block : blocks) {
+    _json["blocks"].append(JSONConversion::convertTxBlocktoJson(*block));
+  }
+  _json["next"] =
+      more ? to_string(blocks.back()->GetHeader().GetBlockNum() + 1) : "";
+  return _json;
+}
+
+Json::Value LookupServer::GetTransactionsForTxBlockRange(
+    const string& fromBlockNum, unsigned int count) {
+  LOG_MARKER();
+  if (!LOOKUP_NODE_MODE) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
+  }
+
+  vector<TxBlockSharedPtr> blocks;
+  bool more = false;
+  GetTxBlockRange(fromBlockNum, count, blocks, more);
+
+  // A page holds whole blocks, and ends after the one that takes its rough
+  // size past TXBLOCK_RANGE_RESPONSE_BYTES_MAX
+  Json::Value _json;
+  _json["blocks"] = Json::arrayValue;
+  uint64_t nextBlockNum = blocks.back()->GetHeader().GetBlockNum() + 1;
+  size_t responseSize = 0;
+  for (const auto& block : blocks) {
+    Json::Value entry;
+    entry["BlockNum"] = to_string(block->GetHeader().GetBlockNum());
+    entry["transactions"] = Json::arrayValue;
+
+    for (const auto& mbInfo : block->GetMicroBlockInfos()) {
+      if (mbInfo.m_txnRootHash == TxnHash()) {
+        continue;
+      }
+      MicroBlockSharedPtr microBlock;
+      if (!BlockStorage::GetBlockStorage().GetMicroBlock(
+              mbInfo.m_microBlockHash, microBlock)) {
+        throw JsonRpcException(RPC_DATABASE_ERROR, "Failed to get Microblock");
+      }
+      for (const auto& tranHash : microBlock->GetTranHashes()) {
+        TxBodySharedPtr body;
+        if (!BlockStorage::GetBlockStorage().GetTxBody(tranHash, body)) {
+          throw JsonRpcException(RPC_DATABASE_ERROR,
+                                 "Failed to get Txn " + tranHash.hex());
+        }
+        entry["transactions"].append(JSONConversion::convertTxtoJson(*body));
+        responseSize += body->GetTransaction().GetCode().size() +
+                        body->GetTransaction().GetData().size() +
+                        body->GetTransactionReceipt().GetString().size() + 512;
+      }
+    }
+
+    _json["blocks"].append(entry);
+    if (responseSize >= TXBLOCK_RANGE_RESPONSE_BYTES_MAX) {
+      nextBlockNum = block->GetHeader().GetBlockNum() + 1;
+      more = more || (block != blocks.back());
+      break;
+    }
+  }
+  _json["next"] = more ? to_string(nextBlockNum) : "";
+  return _json;
+}
+
+Json::Value LookupServer::GetEventLogs(const string& address,
+                                       const string& eventName,
+                                       const string& fromBlockNum,
+                                       unsigned int count) {
+  LOG_MARKER();
+  if (!LOOKUP_NODE_MODE) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
+  }
+  if (!ENABLE_EVENT_BLOOM_INDEX) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Event logs are not indexed");
+  }
+
+  if (count == 0 || count > EVENT_LOG_RANGE_SIZE_MAX) {
+    throw JsonRpcException(RPC_INVALID_PARAMETER,
+                           "Count must be from 1 to " +
+                               to_string(EVENT_LOG_RANGE_SIZE_MAX));
+  }
+  if (address.size() != ACC_ADDR_SIZE * 2) {
+    throw JsonRpcException(RPC_INVALID_PARAMETER,
+                           "Address size not appropriate");
+  }
+  bytes tmpaddr;
+  if (!DataConversion::HexStrToUint8Vec(address, tmpaddr)) {
+    throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY, "invalid address");
+  }
+  const Address addr(tmpaddr);
+  const string logAddress = "0x" + addr.hex();
+
+  uint64_t lowBlockNum;
+  try {
+    lowBlockNum = stoull(fromBlockNum);
+  } catch (exception& e) {
+    LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << fromBlockNum);
+    throw JsonRpcException(RPC_INVALID_PARAMS, "Invalid block number");
+  }
+
+  const uint64_t latestBlockNum =
+      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+  if (lowBlockNum > latestBlockNum) {
+    throw JsonRpcException(RPC_INVALID_PARAMS, "Tx Block does not exist");
+  }
+  const uint64_t hiBlockNum =
+      min(latestBlockNum, lowBlockNum + (count - 1));
+
+  Json::Value _json;
+  _json["events"] = Json::arrayValue;
+  for (uint64_t blockNum = lowBlockNum; blockNum <= hiBlockNum; blockNum++) {
+    EventBloom bloom;
+    if (!BlockStorage::GetBlockStorage().GetEventBloom(blockNum, bloom) ||
+        !bloom.MayContain(addr, eventName)) {
+      continue;
+    }
+
+    TxBlockSharedPtr block;
+    if (!BlockStorage::GetBlockStorage().GetTxBlock(blockNum, block)) {
+      throw JsonRpcException(RPC_DATABASE_ERROR, "Failed to get Tx Block");
+    }
+    for (const auto& mbInfo : block->GetMicroBlockInfos()) {
+      if (mbInfo.m_txnRootHash == TxnHash()) {
+        continue;
+      }
+      MicroBlockSharedPtr microBlock;
+      if (!BlockStorage::GetBlockStorage().GetMicroBlock(
+              mbInfo.m_microBlockHash, microBlock)) {
+        throw JsonRpcException(RPC_DATABASE_ERROR, "Failed to get Microblock");
+      }
+      for (const auto& tranHash : microBlock->GetTranHashes()) {
+        TxBodySharedPtr body;
+        if (!BlockStorage::GetBlockStorage().GetTxBody(tranHash, body)) {
+          throw JsonRpcException(RPC_DATABASE_ERROR,
+                                 "Failed to get Txn " + tranHash.hex());
+        }
+        for (const auto& log :
+             body->GetTransactionReceipt().GetData().m_eventLogs) {
+          if (!log["address"].isString() || !log["_eventname"].isString() ||
+              log["address"].asString() != logAddress ||
+              (!eventName.empty() &&
+               log["_eventname"].asString() != eventName)) {
+            continue;
+          }
+          Json::Value entry;
+          entry["BlockNum"] = to_string(blockNum);
+          entry["ID"] = tranHash.hex();
+          entry["event"] = log;
+          _json["events"].append(entry);
+        }
+      }
+    }
+  }
+  _json["next"] = hiBlockNum < latestBlockNum ? to_string(hiBlockNum + 1) : "";
+  return _json;
+}
+
 vector<uint> GenUniqueIndices(uint32_t size, uint32_t num, mt19937& eng) {
   // case when the number required is greater than total numbers being shuffled
   if (size < num) {
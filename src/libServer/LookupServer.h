@@ -18,7 +18,17 @@
 #ifndef ZILLIQA_SRC_LIBSERVER_LOOKUPSERVER_H_
 #define ZILLIQA_SRC_LIBSERVER_LOOKUPSERVER_H_
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "ConcurrencyLimiter.h"
+#include "RateLimiter.h"
 #include "Server.h"
+#include "common/Constants.h"
+#include "depends/safeserver/safehttpserver.h"
 
 class Mediator;
 
@@ -27,10 +37,20 @@ typedef std::function<bool(const Transaction& tx, uint32_t shardId)>
 
 class LookupServer : public Server,
                      public jsonrpc::AbstractServer<LookupServer> {
-  std::mutex m_mutexBlockTxPair;
-  std::pair<uint64_t, uint128_t> m_BlockTxPair;
-  std::mutex m_mutexTxBlockCountSumPair;
-  std::pair<uint64_t, uint128_t> m_TxBlockCountSumPair;
+  /// Guards the extension of the txn count index of BlockStorage. Holds the
+  /// highest indexed tx block, and the (DS block, first tx block) of the
+  /// latest DS epoch asked for.
+  std::mutex m_mutexTxnCounts;
+  uint64_t m_txnCountTip{INIT_BLOCK_NUMBER};
+  std::pair<uint64_t, uint64_t> m_dsEpochFirstTxBlock{INIT_BLOCK_NUMBER, 0};
+
+  /// Transactions of the tx blocks 1 to blockNum, and the DS block of
+  /// blockNum, indexing first the blocks up to blockNum not yet indexed
+  uint128_t GetTxnCount(uint64_t blockNum, uint64_t& dsBlockNum);
+
+  /// First tx block of DS epoch dsBlockNum, with txBlockNum in that epoch
+  /// and indexed
+  uint64_t GetFirstTxBlockOfDSEpoch(uint64_t txBlockNum, uint64_t dsBlockNum);
   uint64_t m_StartTimeTx;
   uint64_t m_StartTimeDs;
   std::mutex m_mutexDSBlockCache;
@@ -41,17 +61,60 @@ class LookupServer : public Server,
   static std::mutex m_mutexRecentTxns;
   std::mt19937 m_eng;
 
+  /// Responses of the methods that only change with a new block, by method
+  /// and params, dropped by RefreshResponseCache. m_responseCacheGeneration
+  /// keeps a response computed before a refresh from being cached after it.
+  std::mutex m_mutexResponseCache;
+  std::unordered_map<std::string, std::shared_ptr<const Json::Value>>
+      m_responseCache;
+  uint64_t m_responseCacheGeneration{0};
+
+  /// Bounds the calls of the costly methods, so that they cannot take every
+  /// connection thread from the rest
+  ConcurrencyLimiter m_methodLimiter{LOOKUP_RPC_METHOD_LIMITS};
+
+  /// Admission of CreateTransaction by client IP, checked before the
+  /// transaction is parsed, and by sender, checked only once its signature is
+  /// verified so that no client can spend the tokens of another sender
+  RateLimiter m_clientTxnLimiter{CREATE_TXN_RATE_PER_CLIENT,
+                                 CREATE_TXN_BURST_PER_CLIENT};
+  RateLimiter m_senderTxnLimiter{CREATE_TXN_RATE_PER_SENDER,
+                                 CREATE_TXN_BURST_PER_SENDER};
+  std::atomic<uint64_t> m_txnPoolFullRejects{0};
+
+  /// Throws if the client is over its rate, or if the txn shard map could
+  /// not take any transaction
+  void AdmitTransaction(const std::string& client);
+
+  /// Throws if the sender of tx, which has been verified, is over its rate
+  void AdmitSender(const Transaction& tx);
+
+  /// Returns the cached response of key, or caches the one computed
+  Json::Value GetCachedResponse(const std::string& key,
+                                const std::function<Json::Value()>& compute);
+
   CreateTransactionTargetFunc m_createTransactionTarget =
       [this](const Transaction& tx, uint32_t shardId) -> bool {
+    AdmitSender(tx);
     return m_mediator.m_lookup->AddToTxnShardMap(tx, shardId);
   };
 
   Json::Value GetTransactionsForTxBlock(const std::string& txBlockNum);
 
+  /// Reads up to count Tx blocks from fromBlockNum, and sets more if later
+  /// ones exist
+  void GetTxBlockRange(const std::string& fromBlockNum, unsigned int count,
+                       std::vector<TxBlockSharedPtr>& blocks, bool& more);
+
  public:
   LookupServer(Mediator& mediator, jsonrpc::AbstractServerConnector& server);
   ~LookupServer() = default;
 
+  /// Dispatches a call, or fails it at once if its method already runs its
+  /// limit of calls in LOOKUP_RPC_METHOD_LIMITS
+  virtual void HandleMethodCall(jsonrpc::Procedure& proc,
+                                const Json::Value& input, Json::Value& output);
+
   inline virtual void GetNetworkIdI(const Json::Value& request,
                                     Json::Value& response) {
     (void)request;
@@ -59,6 +122,7 @@ class LookupServer : public Server,
   }
   inline virtual void CreateTransactionI(const Json::Value& request,
                                          Json::Value& response) {
+    AdmitTransaction(jsonrpc::SafeHttpServer::GetClientAddress());
     response = CreateTransaction(
         request[0u], m_mediator.m_lookup->GetShardPeers().size(),
         m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetGasPrice(),
@@ -74,22 +138,36 @@ class LookupServer : public Server,
   }
   inline virtual void GetTxBlockI(const Json::Value& request,
                                   Json::Value& response) {
-    response = this->GetTxBlock(request[0u].asString());
+    const std::string blockNum = request[0u].asString();
+    response = GetCachedResponse("GetTxBlock:" + blockNum, [this, &blockNum]() {
+      return this->GetTxBlock(blockNum);
+    });
   }
   inline virtual void GetLatestDsBlockI(const Json::Value& request,
                                         Json::Value& response) {
     (void)request;
-    response = this->GetLatestDsBlock();
+    response = GetCachedResponse("GetLatestDsBlock",
+                                 [this]() { return this->GetLatestDsBlock(); });
   }
   inline virtual void GetLatestTxBlockI(const Json::Value& request,
                                         Json::Value& response) {
     (void)request;
-    response = this->GetLatestTxBlock();
+    response = GetCachedResponse("GetLatestTxBlock",
+                                 [this]() { return this->GetLatestTxBlock(); });
   }
   inline virtual void GetBalanceI(const Json::Value& request,
                                   Json::Value& response) {
     response = this->GetBalance(request[0u].asString());
   }
+  inline virtual void GetStateProofI(const Json::Value& request,
+                                     Json::Value& response) {
+    response = this->GetStateProof(request[0u].asString());
+  }
+  inline virtual void GetTransactionProofI(const Json::Value& request,
+                                           Json::Value& response) {
+    response = this->GetTransactionProof(request[0u].asString(),
+                                         request[1u].asString());
+  }
   inline virtual void GetMinimumGasPriceI(const Json::Value& request,
                                           Json::Value& response) {
     (void)request;
@@ -152,7 +230,9 @@ class LookupServer : public Server,
   inline virtual void GetBlockchainInfoI(const Json::Value& request,
                                          Json::Value& response) {
     (void)request;
-    response = this->GetBlockchainInfo();
+    response = GetCachedResponse("GetBlockchainInfo", [this]() {
+      return this->GetBlockchainInfo();
+    });
   }
   inline virtual void GetRecentTransactionsI(const Json::Value& request,
                                              Json::Value& response) {
@@ -162,7 +242,9 @@ class LookupServer : public Server,
   inline virtual void GetShardingStructureI(const Json::Value& request,
                                             Json::Value& response) {
     (void)request;
-    response = this->GetShardingStructure();
+    response = GetCachedResponse("GetShardingStructure", [this]() {
+      return this->GetShardingStructure();
+    });
   }
   inline virtual void GetNumTxnsTxEpochI(const Json::Value& request,
                                          Json::Value& response) {
@@ -183,6 +265,16 @@ class LookupServer : public Server,
                                              Json::Value& response) {
     response = this->GetSmartContractState(request[0u].asString());
   }
+  inline virtual void GetSmartContractStatePageI(const Json::Value& request,
+                                                 Json::Value& response) {
+    response = this->GetSmartContractStatePage(
+        request[0u].asString(), request[1u].asString(), request[2u].asUInt());
+  }
+  inline virtual void GetTransactionsForAddressI(const Json::Value& request,
+                                                 Json::Value& response) {
+    response = this->GetTransactionsForAddress(
+        request[0u].asString(), request[1u].asString(), request[2u].asUInt());
+  }
   inline virtual void GetSmartContractCodeI(const Json::Value& request,
                                             Json::Value& response) {
     response = this->GetSmartContractCode(request[0u].asString());
@@ -195,6 +287,22 @@ class LookupServer : public Server,
                                                  Json::Value& response) {
     response = this->GetTransactionsForTxBlock(request[0u].asString());
   }
+  inline virtual void GetTxBlocksRangeI(const Json::Value& request,
+                                        Json::Value& response) {
+    response = this->GetTxBlocksRange(request[0u].asString(),
+                                      request[1u].asUInt());
+  }
+  inline virtual void GetTransactionsForTxBlockRangeI(
+      const Json::Value& request, Json::Value& response) {
+    response = this->GetTransactionsForTxBlockRange(request[0u].asString(),
+                                                    request[1u].asUInt());
+  }
+  inline virtual void GetEventLogsI(const Json::Value& request,
+                                    Json::Value& response) {
+    response =
+        this->GetEventLogs(request[0u].asString(), request[1u].asString(),
+                           request[2u].asString(), request[3u].asUInt());
+  }
   inline virtual void GetShardMembersI(const Json::Value& request,
                                        Json::Value& response) {
     response = this->GetShardMembers(request[0u].asUInt());
@@ -212,15 +320,34 @@ class LookupServer : public Server,
   }
 
   std::string GetNetworkId();
+  /// Returns the CreateTransaction calls rejected by AdmitTransaction and
+  /// AdmitSender
+  Json::Value GetCreateTransactionRejects() const;
   static Json::Value CreateTransaction(
       const Json::Value& _json, const unsigned int num_shards,
       const uint128_t& gasPrice, const CreateTransactionTargetFunc& targetFunc);
+  static Json::Value CreateTransaction(
+      const Transaction& tx, bool sendToDs, const unsigned int num_shards,
+      const uint128_t& gasPrice, const CreateTransactionTargetFunc& targetFunc);
+  /// Admits and creates tx as CreateTransaction does, for the endpoints that
+  /// decode transactions themselves
+  Json::Value SubmitTransaction(const Transaction& tx, bool sendToDs,
+                                const std::string& client);
   Json::Value GetTransaction(const std::string& transactionHash);
   Json::Value GetDsBlock(const std::string& blockNum);
   Json::Value GetTxBlock(const std::string& blockNum);
   Json::Value GetLatestDsBlock();
   Json::Value GetLatestTxBlock();
   Json::Value GetBalance(const std::string& address);
+  /// Returns {"stateRoot": ..., "proof": [...], "account": ...} with the
+  /// state trie nodes on the path of address, from the root node down, and
+  /// the serialized account, which is absent if the account is not created
+  Json::Value GetStateProof(const std::string& address);
+  /// Returns {"microBlockHash": ..., "txRootHash": ..., "index": ...,
+  /// "tranHashes": [...]} for the microblock of the Tx block that has
+  /// tranHash, where the root is the hash of the tranHashes in order
+  Json::Value GetTransactionProof(const std::string& txBlockNum,
+                                  const std::string& tranHash);
   std::string GetMinimumGasPrice();
   Json::Value GetSmartContracts(const std::string& address);
   std::string GetContractAddressFromTransactionID(const std::string& tranID);
@@ -243,6 +370,14 @@ class LookupServer : public Server,
 
   size_t GetNumTransactions(uint64_t blockNum);
   bool StartCollectorThread();
+
+  /// Drops the cached responses and computes those of the latest blocks
+  /// again, to be called whenever a block is added
+  void RefreshResponseCache();
+
+  /// Indexes the txn counts of the blocks up to the latest, to be called
+  /// whenever a tx block is added
+  void IndexTxnCounts();
   std::string GetNodeState();
 
   static void AddToRecentTransactions(const dev::h256& txhash);
@@ -253,9 +388,40 @@ class LookupServer : public Server,
   Json::Value GetSmartContractState(
       const std::string& address, const std::string& vname = "",
       const Json::Value& indices = Json::arrayValue);
+  /// Returns {"state": ..., "next": cursor} with up to pageSize states
+  /// after the cursor, where an empty cursor starts from the first state and
+  /// an empty "next" means there are no more states
+  Json::Value GetSmartContractStatePage(const std::string& address,
+                                        const std::string& cursor,
+                                        unsigned int pageSize);
+  /// Returns {"txns": [{"epoch": ..., "ID": ...}], "next": cursor} with up to
+  /// pageSize of the transactions sent from or to address, oldest first,
+  /// after the cursor. Needs ENABLE_TXN_HISTORY_INDEX.
+  Json::Value GetTransactionsForAddress(const std::string& address,
+                                        const std::string& cursor,
+                                        unsigned int pageSize);
   Json::Value GetSmartContractInit(const std::string& address);
   Json::Value GetSmartContractCode(const std::string& address);
 
+  /// Returns {"blocks": [...], "next": block number} with up to count Tx
+  /// blocks from fromBlockNum, where an empty "next" means the latest block
+  /// is included
+  Json::Value GetTxBlocksRange(const std::string& fromBlockNum,
+                               unsigned int count);
+  /// Returns {"blocks": [{"BlockNum": ..., "transactions": [...]}], "next":
+  /// block number} with the transaction bodies of up to count Tx blocks from
+  /// fromBlockNum, in pages of about TXBLOCK_RANGE_RESPONSE_BYTES_MAX bytes
+  Json::Value GetTransactionsForTxBlockRange(const std::string& fromBlockNum,
+                                             unsigned int count);
+  /// Returns {"events": [{"BlockNum": ..., "ID": ..., "event": ...}],
+  /// "next": block number} with the events of address, named eventName
+  /// unless it is empty, in up to count Tx blocks from fromBlockNum. Only
+  /// the blocks whose event bloom matches are read. Needs
+  /// ENABLE_EVENT_BLOOM_INDEX.
+  Json::Value GetEventLogs(const std::string& address,
+                           const std::string& eventName,
+                           const std::string& fromBlockNum,
+                           unsigned int count);
   static Json::Value GetTransactionsForTxBlock(const TxBlock& txBlock,
                                                bool historicalDB);
 };
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBSERVER_RATELIMITER_H_
+#define ZILLIQA_SRC_LIBSERVER_RATELIMITER_H_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/// Token bucket per key: each key may take up to burst calls at once, and
+/// regains ratePerSecond of them every second. A rate of 0 does not limit.
+/// Once maxKeys keys are tracked, the idle ones are dropped, which loses
+/// nothing since their buckets are full again.
+class RateLimiter {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+ private:
+  struct Bucket {
+    double m_tokens;
+    Clock::time_point m_last;
+  };
+
+  const double m_ratePerSecond;
+  const double m_burst;
+  const size_t m_maxKeys;
+  std::mutex m_mutex;
+  std::unordered_map<std::string, Bucket> m_buckets;
+  std::atomic<uint64_t> m_rejected{0};
+
+  double Refill(const Bucket& bucket, const Clock::time_point& now) const {
+    const double elapsed =
+        std::chrono::duration<double>(now - bucket.m_last).count();
+    const double tokens = bucket.m_tokens + elapsed * m_ratePerSecond;
+    return tokens < m_burst ? tokens : m_burst;
+  }
+
+  void DropIdleBuckets(const Clock::time_point& now) {
+    for (auto it = m_buckets.begin(); it != m_buckets.end();) {
+      if (Refill(it->second, now) >= m_burst) {
+        it = m_buckets.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+ public:
+  RateLimiter(double ratePerSecond, unsigned int burst,
+              size_t maxKeys = 1 << 16)
+      : m_ratePerSecond(ratePerSecond),
+        m_burst(burst > 0 ? burst : 1),
+        m_maxKeys(maxKeys) {}
+
+  RateLimiter(const RateLimiter&) = delete;
+  RateLimiter& operator=(const RateLimiter&) = delete;
+
+  /// Takes a token of key, or returns false if it has none left
+  bool TryAcquire(const std::string& key,
+                  const Clock::time_point& now = Clock::now()) {
+    if (m_ratePerSecond <= 0) {
+      return true;
+    }
+
+    std::lock_guard<std::mutex> g(m_mutex);
+    auto it = m_buckets.find(key);
+    if (it == m_buckets.end()) {
+      if (m_buckets.size() >= m_maxKeys) {
+        DropIdleBuckets(now);
+      }
+      it = m_buckets.emplace(key, Bucket{m_burst, now}).first;
+    }
+
+    Bucket& bucket = it->second;
+    bucket.m_tokens = Refill(bucket, now);
+    bucket.m_last = now;
+    if (bucket.m_tokens < 1) {
+      m_rejected++;
+      return false;
+    }
+    bucket.m_tokens -= 1;
+    return true;
+  }
+
+  uint64_t GetRejected() const { return m_rejected; }
+};
+
+#endif  // ZILLIQA_SRC_LIBSERVER_RATELIMITER_H_
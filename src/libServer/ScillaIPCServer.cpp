@@ -18,7 +18,9 @@
 #include <jsonrpccpp/server/connectors/unixdomainsocketserver.h>
 
 #include "libPersistence/ContractStorage2.h"
+#include "libPersistence/ScillaMessage.pb.h"
 #include "libUtils/DataConversion.h"
+#include "libUtils/TimeUtils.h"
 
 #include "ScillaIPCServer.h"
 
@@ -32,6 +34,9 @@ ScillaIPCServer::ScillaIPCServer(AbstractServerConnector &conn)
   bindAndAddMethod(Procedure("fetchStateValue", PARAMS_BY_NAME, JSON_OBJECT,
                              "query", JSON_STRING, NULL),
                    &ScillaIPCServer::fetchStateValueI);
+  bindAndAddMethod(Procedure("fetchStateValues", PARAMS_BY_NAME, JSON_ARRAY,
+                             "queries", JSON_ARRAY, NULL),
+                   &ScillaIPCServer::fetchStateValuesI);
   bindAndAddMethod(Procedure("updateStateValue", PARAMS_BY_NAME, JSON_STRING,
                              "query", JSON_STRING, "value", JSON_STRING, NULL),
                    &ScillaIPCServer::updateStateValueI);
@@ -39,10 +44,24 @@ ScillaIPCServer::ScillaIPCServer(AbstractServerConnector &conn)
 
 void ScillaIPCServer::setContractAddress(const Address &address) {
   m_contrAddr = address;
+  lock_guard<mutex> g(m_mutexReadCache);
+  m_readCache.clear();
+}
+
+ScillaIPCServer::Stats ScillaIPCServer::GetStats() const {
+  return {m_reads, m_readMicro, m_writes, m_writeMicro};
+}
+
+void ScillaIPCServer::ResetStats() {
+  m_reads = 0;
+  m_readMicro = 0;
+  m_writes = 0;
+  m_writeMicro = 0;
 }
 
 void ScillaIPCServer::fetchStateValueI(const Json::Value &request,
                                        Json::Value &response) {
+  const auto tpStart = r_timer_start();
   std::string value;
   bool found;
   if (!fetchStateValue(request["query"].asString(), value, found)) {
@@ -53,10 +72,36 @@ void ScillaIPCServer::fetchStateValueI(const Json::Value &request,
   response.clear();
   response.append(Json::Value(found));
   response.append(Json::Value(value));
+
+  m_reads++;
+  m_readMicro += static_cast<uint64_t>(r_timer_end(tpStart));
+}
+
+void ScillaIPCServer::fetchStateValuesI(const Json::Value &request,
+                                        Json::Value &response) {
+  const auto tpStart = r_timer_start();
+  // Each entry of the response is [found, value] of the query at that index
+  response = Json::arrayValue;
+  for (const auto &query : request["queries"]) {
+    std::string value;
+    bool found;
+    if (!fetchStateValue(query.asString(), value, found)) {
+      throw JsonRpcException("Fetching state values failed");
+    }
+
+    Json::Value entry = Json::arrayValue;
+    entry.append(Json::Value(found));
+    entry.append(Json::Value(value));
+    response.append(entry);
+  }
+
+  m_reads += request["queries"].size();
+  m_readMicro += static_cast<uint64_t>(r_timer_end(tpStart));
 }
 
 void ScillaIPCServer::updateStateValueI(const Json::Value &request,
                                         Json::Value &response) {
+  const auto tpStart = r_timer_start();
   if (!updateStateValue(request["query"].asString(),
                         request["value"].asString())) {
     throw JsonRpcException("Updating state value failed");
@@ -64,10 +109,37 @@ void ScillaIPCServer::updateStateValueI(const Json::Value &request,
 
   // We have nothing to return. A null response is expected in the client.
   response.clear();
+
+  m_writes++;
+  m_writeMicro += static_cast<uint64_t>(r_timer_end(tpStart));
+}
+
+bool ScillaIPCServer::GetQueryFieldName(const string &query, string &name) {
+  ProtoScillaQuery parsed;
+  if (!parsed.ParseFromString(query) || !parsed.IsInitialized()) {
+    return false;
+  }
+  name = parsed.name();
+  return true;
 }
 
 bool ScillaIPCServer::fetchStateValue(const string &query, string &value,
                                       bool &found) {
+  string name;
+  const bool cacheable = GetQueryFieldName(query, name);
+  if (cacheable) {
+    lock_guard<mutex> g(m_mutexReadCache);
+    const auto field = m_readCache.find(name);
+    if (field != m_readCache.end()) {
+      const auto cached = field->second.find(query);
+      if (cached != field->second.end()) {
+        found = cached->second.first;
+        value = cached->second.second;
+        return true;
+      }
+    }
+  }
+
   bytes destination;
 
   if (!ContractStorage2::GetContractStorage().FetchStateValue(
@@ -78,11 +150,26 @@ bool ScillaIPCServer::fetchStateValue(const string &query, string &value,
 
   string value_new = DataConversion::CharArrayToString(destination);
   value.swap(value_new);
+
+  if (cacheable) {
+    lock_guard<mutex> g(m_mutexReadCache);
+    m_readCache[name][query] = {found, value};
+  }
   return true;
 }
 
 bool ScillaIPCServer::updateStateValue(const string &query,
                                        const string &value) {
+  string name;
+  {
+    lock_guard<mutex> g(m_mutexReadCache);
+    if (GetQueryFieldName(query, name)) {
+      m_readCache.erase(name);
+    } else {
+      m_readCache.clear();
+    }
+  }
+
   return ContractStorage2::GetContractStorage().UpdateStateValue(
       m_contrAddr, DataConversion::StringToCharArray(query), 0,
       DataConversion::StringToCharArray(value), 0);
@@ -21,27 +21,65 @@
 #include <jsonrpccpp/server/abstractserver.h>
 #include <jsonrpccpp/server/connectors/unixdomainsocketserver.h>
 
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
 #include "depends/common/FixedHash.h"
 
 #include "libData/AccountData/Address.h"
 
 class ScillaIPCServer : public jsonrpc::AbstractServer<ScillaIPCServer> {
  public:
+  /// Number of state reads and writes served and their total time in
+  /// microseconds
+  struct Stats {
+    uint64_t m_reads;
+    uint64_t m_readMicro;
+    uint64_t m_writes;
+    uint64_t m_writeMicro;
+  };
+
   ScillaIPCServer(jsonrpc::AbstractServerConnector& conn);
   ~ScillaIPCServer() = default;
 
   inline virtual void fetchStateValueI(const Json::Value& request,
                                        Json::Value& response);
+  inline virtual void fetchStateValuesI(const Json::Value& request,
+                                        Json::Value& response);
   inline virtual void updateStateValueI(const Json::Value& request,
                                         Json::Value& response);
   virtual bool fetchStateValue(const std::string& query, std::string& value,
                                bool& found);
   virtual bool updateStateValue(const std::string& query,
                                 const std::string& value);
+  /// Also starts a new call, dropping the cached reads of the previous one
   void setContractAddress(const Address& address);
 
+  /// Returns the reads and writes served since the last ResetStats
+  Stats GetStats() const;
+  void ResetStats();
+
  private:
   Address m_contrAddr = Address();
+
+  /// Reads of the current call by field name and query, so repeated reads
+  /// of a field do not go to the storage again. An update of a field drops
+  /// the cached reads of that field.
+  std::mutex m_mutexReadCache;
+  std::unordered_map<
+      std::string,
+      std::unordered_map<std::string, std::pair<bool, std::string>>>
+      m_readCache;
+
+  std::atomic<uint64_t> m_reads{0};
+  std::atomic<uint64_t> m_readMicro{0};
+  std::atomic<uint64_t> m_writes{0};
+  std::atomic<uint64_t> m_writeMicro{0};
+
+  static bool GetQueryFieldName(const std::string& query, std::string& name);
 };
 
 #endif  // ZILLIQA_SRC_LIBSERVER_SCILLAIPCSERVER_H_
\ No newline at end of file
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+
+#include "ScillaWorkerPool.h"
+#include "common/Constants.h"
+#include "libUtils/Logger.h"
+#include "libUtils/ThreadAffinity.h"
+
+using namespace std;
+using namespace jsonrpc;
+
+namespace {
+// How long a new worker gets to open its socket
+const unsigned int WORKER_STARTUP_POLL_IN_MS = 10;
+const unsigned int WORKER_STARTUP_POLLS = 300;
+// Code of jsonrpc::Errors::ERROR_CLIENT_CONNECTOR, the worker is gone
+const int CLIENT_CONNECTOR_ERROR = -32003;
+}  // namespace
+
+ScillaWorkerPool& ScillaWorkerPool::GetInstance() {
+  static ScillaWorkerPool pool;
+  return pool;
+}
+
+ScillaWorkerPool::~ScillaWorkerPool() { Reset(); }
+
+bool ScillaWorkerPool::StartWorker(const string& root_w_version,
+                                   Worker& worker) {
+  boost::system::error_code ec;
+  boost::filesystem::remove(worker.m_socketPath, ec);
+
+  const string binary = root_w_version + '/' + SCILLA_SERVER_BINARY;
+  // The worker keeps the cores it is pinned to before exec
+  const auto& cores = ThreadAffinity::GetCores("Scilla");
+  const pid_t pid = fork();
+  if (pid == -1) {
+    LOG_GENERAL(WARNING, "fork failed for " << binary);
+    return false;
+  }
+  if (pid == 0) {
+    if (!cores.empty()) {
+      ThreadAffinity::PinCores(cores);
+    }
+    execl(binary.c_str(), binary.c_str(), "-socket",
+          worker.m_socketPath.c_str(), static_cast<char*>(nullptr));
+    _exit(127);
+  }
+
+  for (unsigned int i = 0; i < WORKER_STARTUP_POLLS; i++) {
+    if (boost::filesystem::exists(worker.m_socketPath, ec)) {
+      worker.m_pid = pid;
+      worker.m_connector =
+          make_unique<UnixDomainSocketClient>(worker.m_socketPath);
+      worker.m_client = make_unique<Client>(*worker.m_connector);
+      LOG_GENERAL(INFO, "Started " << binary << " pid: " << pid
+                                   << " socket: " << worker.m_socketPath);
+      return true;
+    }
+    if (waitpid(pid, nullptr, WNOHANG) == pid) {
+      LOG_GENERAL(WARNING, binary << " exited during startup");
+      return false;
+    }
+    this_thread::sleep_for(chrono::milliseconds(WORKER_STARTUP_POLL_IN_MS));
+  }
+
+  LOG_GENERAL(WARNING, binary << " did not open " << worker.m_socketPath);
+  kill(pid, SIGKILL);
+  waitpid(pid, nullptr, 0);
+  return false;
+}
+
+void ScillaWorkerPool::StopWorker(Worker& worker) {
+  worker.m_client.reset();
+  worker.m_connector.reset();
+  if (worker.m_pid > 0) {
+    kill(worker.m_pid, SIGKILL);
+    waitpid(worker.m_pid, nullptr, 0);
+  }
+  worker.m_pid = -1;
+}
+
+shared_ptr<ScillaWorkerPool::Worker> ScillaWorkerPool::AcquireWorker(
+    const string& root_w_version) {
+  lock_guard<mutex> g(m_mutexWorkers);
+
+  auto& workers = m_workers[root_w_version];
+  if (workers.empty()) {
+    const unsigned int poolSize = max(SCILLA_SERVER_POOL_SIZE, 1u);
+    for (unsigned int i = 0; i < poolSize; i++) {
+      auto worker = make_shared<Worker>();
+      worker->m_socketPath = SCILLA_SERVER_SOCKET_PATH + "." +
+                             to_string(m_workers.size() - 1) + "." +
+                             to_string(i);
+      workers.emplace_back(move(worker));
+    }
+  }
+
+  // Prefer a worker that is still running over one that needs a restart
+  shared_ptr<Worker> chosen;
+  for (const auto& worker : workers) {
+    if (worker->m_busy) {
+      continue;
+    }
+    if (worker->m_pid > 0 &&
+        waitpid(worker->m_pid, nullptr, WNOHANG) == worker->m_pid) {
+      LOG_GENERAL(WARNING, "Scilla worker " << worker->m_pid << " exited");
+      worker->m_pid = -1;
+    }
+    if (worker->m_pid > 0) {
+      chosen = worker;
+      break;
+    }
+    if (!chosen) {
+      chosen = worker;
+    }
+  }
+
+  if (!chosen) {
+    LOG_GENERAL(WARNING, "No idle scilla worker for " << root_w_version);
+    return nullptr;
+  }
+  if (chosen->m_pid <= 0) {
+    StopWorker(*chosen);
+    if (!StartWorker(root_w_version, *chosen)) {
+      return nullptr;
+    }
+  }
+  chosen->m_busy = true;
+  return chosen;
+}
+
+void ScillaWorkerPool::ReleaseWorker(const shared_ptr<Worker>& worker,
+                                     bool failed) {
+  lock_guard<mutex> g(m_mutexWorkers);
+  if (failed) {
+    // The worker may have crashed or been killed on timeout, a new one is
+    // started on next use
+    StopWorker(*worker);
+  }
+  worker->m_busy = false;
+}
+
+bool ScillaWorkerPool::Call(const string& method, const string& root_w_version,
+                            const vector<string>& argv, string& output,
+                            int& pid) {
+  auto worker = AcquireWorker(root_w_version);
+  if (!worker) {
+    return false;
+  }
+  pid = worker->m_pid;
+
+  Json::Value params;
+  params["argv"] = Json::arrayValue;
+  for (const auto& arg : argv) {
+    params["argv"].append(arg);
+  }
+
+  bool failed = false;
+  try {
+    const Json::Value result = worker->m_client->CallMethod(method, params);
+    output = result.isString() ? result.asString() : result.toStyledString();
+  } catch (const JsonRpcException& e) {
+    // An error reply means the interpreter failed, not the worker
+    LOG_GENERAL(WARNING, "Scilla worker " << method << " failed: " << e.what());
+    output = e.GetMessage();
+    ReleaseWorker(worker, e.GetCode() == CLIENT_CONNECTOR_ERROR);
+    return false;
+  } catch (const exception& e) {
+    LOG_GENERAL(WARNING, "Scilla worker " << pid << " lost: " << e.what());
+    failed = true;
+  }
+
+  ReleaseWorker(worker, failed);
+  return !failed;
+}
+
+bool ScillaWorkerPool::CallChecker(const string& root_w_version,
+                                   const vector<string>& argv, string& output,
+                                   int& pid) {
+  return Call("check", root_w_version, argv, output, pid);
+}
+
+bool ScillaWorkerPool::CallRunner(const string& root_w_version,
+                                  const vector<string>& argv, string& output,
+                                  int& pid) {
+  return Call("run", root_w_version, argv, output, pid);
+}
+
+void ScillaWorkerPool::Reset() {
+  lock_guard<mutex> g(m_mutexWorkers);
+  for (auto& entry : m_workers) {
+    for (auto& worker : entry.second) {
+      StopWorker(*worker);
+    }
+  }
+  m_workers.clear();
+}
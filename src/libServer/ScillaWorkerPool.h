@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBSERVER_SCILLAWORKERPOOL_H_
+#define ZILLIQA_SRC_LIBSERVER_SCILLAWORKERPOOL_H_
+
+#include <json/json.h>
+#include <jsonrpccpp/client.h>
+#include <jsonrpccpp/client/connectors/unixdomainsocketclient.h>
+#include <sys/types.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/Singleton.h"
+
+/// Pool of long-lived scilla-server processes that run the checker and the
+/// runner over JSON-RPC, so a contract call does not fork a new interpreter.
+/// Workers are started per scilla root on first use. A worker that crashes,
+/// or is killed when the transaction times out, is restarted on next use.
+class ScillaWorkerPool : public Singleton<ScillaWorkerPool> {
+  struct Worker {
+    pid_t m_pid{-1};
+    bool m_busy{false};
+    std::string m_socketPath;
+    std::unique_ptr<jsonrpc::UnixDomainSocketClient> m_connector;
+    std::unique_ptr<jsonrpc::Client> m_client;
+  };
+
+  std::mutex m_mutexWorkers;
+  // Workers of each root_w_version
+  std::map<std::string, std::vector<std::shared_ptr<Worker>>> m_workers;
+
+  ScillaWorkerPool() = default;
+  ~ScillaWorkerPool();
+
+  ScillaWorkerPool(ScillaWorkerPool const&) = delete;
+  void operator=(ScillaWorkerPool const&) = delete;
+
+  bool StartWorker(const std::string& root_w_version, Worker& worker);
+  static void StopWorker(Worker& worker);
+
+  /// Takes an idle worker for the root, restarting it if it has exited
+  std::shared_ptr<Worker> AcquireWorker(const std::string& root_w_version);
+  void ReleaseWorker(const std::shared_ptr<Worker>& worker, bool failed);
+
+  bool Call(const std::string& method, const std::string& root_w_version,
+            const std::vector<std::string>& argv, std::string& output,
+            int& pid);
+
+ public:
+  static ScillaWorkerPool& GetInstance();
+
+  /// Runs the checker with the arguments it takes on the command line.
+  /// pid is set to the worker serving the call once it is running, so the
+  /// caller can kill it on timeout as it does a spawned process.
+  bool CallChecker(const std::string& root_w_version,
+                   const std::vector<std::string>& argv, std::string& output,
+                   int& pid);
+
+  /// Runs the runner with the arguments it takes on the command line.
+  bool CallRunner(const std::string& root_w_version,
+                  const std::vector<std::string>& argv, std::string& output,
+                  int& pid);
+
+  /// Stops all workers
+  void Reset();
+};
+
+#endif  // ZILLIQA_SRC_LIBSERVER_SCILLAWORKERPOOL_H_
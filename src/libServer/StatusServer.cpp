@@ -17,7 +17,13 @@
 
 #include "StatusServer.h"
 #include "JSONConversion.h"
+#include "LookupServer.h"
 #include "libNetwork/Blacklist.h"
+#include "libNetwork/P2PComm.h"
+#include "libNetwork/TrafficStats.h"
+#include "libUtils/MemoryStats.h"
+#include "libUtils/MessageStats.h"
+#include "libUtils/Profiler.h"
 
 using namespace jsonrpc;
 using namespace std;
@@ -90,6 +96,37 @@ StatusServer::StatusServer(Mediator& mediator,
       jsonrpc::Procedure("GetSendSCCallsToDS", jsonrpc::PARAMS_BY_POSITION,
                          jsonrpc::JSON_STRING, NULL),
       &StatusServer::GetSendSCCallsToDSI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetMessageStats", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, NULL),
+      &StatusServer::GetMessageStatsI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetMemoryStats", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, NULL),
+      &StatusServer::GetMemoryStatsI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetSendQueueStats", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, NULL),
+      &StatusServer::GetSendQueueStatsI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetTrafficStats", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, NULL),
+      &StatusServer::GetTrafficStatsI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetCreateTransactionRejects",
+                         jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT,
+                         NULL),
+      &StatusServer::GetCreateTransactionRejectsI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("StartProfiler", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_STRING, "param01", jsonrpc::JSON_STRING,
+                         "param02", jsonrpc::JSON_INTEGER, NULL),
+      &StatusServer::StartProfilerI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("StopProfiler", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_STRING, "param01", jsonrpc::JSON_STRING,
+                         NULL),
+      &StatusServer::StopProfilerI);
 }
 
 string StatusServer::GetLatestEpochStatesUpdated() {
@@ -240,4 +277,78 @@ bool StatusServer::GetSendSCCallsToDS() {
                            "Not to be queried on non-lookup or seed");
   }
   return m_mediator.m_lookup->m_sendSCCallsToDS;
-}
\ No newline at end of file
+}
+Json::Value StatusServer::GetMessageStats() {
+  if (!ENABLE_MESSAGE_STATS) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Message stats not enabled");
+  }
+  return MessageStats::GetInstance().GetStats();
+}
+
+Json::Value StatusServer::GetMemoryStats() {
+  if (!ENABLE_MEMORY_STATS) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Memory stats not enabled");
+  }
+  return MemoryStats::GetInstance().GetStats();
+}
+
+Json::Value StatusServer::GetSendQueueStats() {
+  return P2PComm::GetInstance().GetSendQueueStats();
+}
+
+Json::Value StatusServer::GetTrafficStats() {
+  if (!ENABLE_TRAFFIC_STATS) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Traffic stats not enabled");
+  }
+  return TrafficStats::GetInstance().GetStats();
+}
+
+Json::Value StatusServer::GetCreateTransactionRejects() {
+  if (!LOOKUP_NODE_MODE) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
+  }
+  const auto& lookupServer = m_mediator.m_lookup->GetLookupServer();
+  if (!lookupServer) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Lookup server not started");
+  }
+  return lookupServer->GetCreateTransactionRejects();
+}
+
+string StatusServer::StartProfiler(const string& kind,
+                                   const unsigned int windowInSeconds) {
+  Profiler::Kind profilerKind;
+  if (!Profiler::GetKind(kind, profilerKind)) {
+    throw JsonRpcException(RPC_INVALID_PARAMETER,
+                           "Profiler kind should be cpu or heap");
+  }
+  if (windowInSeconds == 0 ||
+      windowInSeconds > PROFILER_MAX_WINDOW_IN_SECONDS) {
+    throw JsonRpcException(RPC_INVALID_PARAMETER,
+                           "Window should be 1 to " +
+                               to_string(PROFILER_MAX_WINDOW_IN_SECONDS) +
+                               " seconds");
+  }
+
+  const string path = Profiler::GetInstance().Start(
+      profilerKind, m_mediator.m_currentEpochNum, windowInSeconds);
+  if (path.empty()) {
+    throw JsonRpcException(RPC_MISC_ERROR,
+                           "Profiler already running or failed to start");
+  }
+  return path;
+}
+
+string StatusServer::StopProfiler(const string& kind) {
+  Profiler::Kind profilerKind;
+  if (!Profiler::GetKind(kind, profilerKind)) {
+    throw JsonRpcException(RPC_INVALID_PARAMETER,
+                           "Profiler kind should be cpu or heap");
+  }
+
+  const string path = Profiler::GetInstance().Stop(profilerKind);
+  if (path.empty()) {
+    throw JsonRpcException(RPC_MISC_ERROR,
+                           "Profiler not running or failed to write");
+  }
+  return path;
+}
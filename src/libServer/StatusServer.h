@@ -67,6 +67,40 @@ class StatusServer : public Server,
     (void)request;
     response = this->GetSendSCCallsToDS();
   }
+  inline virtual void GetMessageStatsI(const Json::Value& request,
+                                       Json::Value& response) {
+    (void)request;
+    response = this->GetMessageStats();
+  }
+  inline virtual void GetMemoryStatsI(const Json::Value& request,
+                                      Json::Value& response) {
+    (void)request;
+    response = this->GetMemoryStats();
+  }
+  inline virtual void GetSendQueueStatsI(const Json::Value& request,
+                                         Json::Value& response) {
+    (void)request;
+    response = this->GetSendQueueStats();
+  }
+  inline virtual void GetTrafficStatsI(const Json::Value& request,
+                                       Json::Value& response) {
+    (void)request;
+    response = this->GetTrafficStats();
+  }
+  inline virtual void GetCreateTransactionRejectsI(const Json::Value& request,
+                                                   Json::Value& response) {
+    (void)request;
+    response = this->GetCreateTransactionRejects();
+  }
+  inline virtual void StartProfilerI(const Json::Value& request,
+                                     Json::Value& response) {
+    response =
+        this->StartProfiler(request[0u].asString(), request[1u].asUInt());
+  }
+  inline virtual void StopProfilerI(const Json::Value& request,
+                                    Json::Value& response) {
+    response = this->StopProfiler(request[0u].asString());
+  }
 
   Json::Value IsTxnInMemPool(const std::string& tranID);
   bool AddToBlacklistExclusion(const std::string& ipAddr);
@@ -77,6 +111,14 @@ class StatusServer : public Server,
   Json::Value GetDSCommittee();
   bool ToggleSendSCCallsToDS();
   bool GetSendSCCallsToDS();
+  Json::Value GetMessageStats();
+  Json::Value GetMemoryStats();
+  Json::Value GetSendQueueStats();
+  Json::Value GetTrafficStats();
+  Json::Value GetCreateTransactionRejects();
+  std::string StartProfiler(const std::string& kind,
+                            const unsigned int windowInSeconds);
+  std::string StopProfiler(const std::string& kind);
 };
 
 #endif  // ZILLIQA_SRC_LIBSERVER_STATUSSERVER_H_
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "StratumServer.h"
+#include "GetWorkServer.h"
+#include "libUtils/JsonUtils.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+using boost::asio::ip::tcp;
+
+namespace {
+// Longest the watcher waits on the getwork server before checking for stop
+const unsigned int WATCH_WORK_TIMEOUT_IN_SECONDS = 1;
+
+Json::Value MakeWorkNotification(const Json::Value& work) {
+  Json::Value notification;
+  notification["id"] = 0;
+  notification["jsonrpc"] = "2.0";
+  notification["result"] = work;
+  return notification;
+}
+}  // namespace
+
+StratumServer& StratumServer::GetInstance() {
+  static StratumServer server;
+  return server;
+}
+
+StratumServer::~StratumServer() { Stop(); }
+
+bool StratumServer::Start(unsigned int port) {
+  if (m_running) {
+    return true;
+  }
+
+  try {
+    m_acceptor = make_unique<tcp::acceptor>(
+        m_ioService, tcp::endpoint(tcp::v4(), static_cast<uint16_t>(port)));
+  } catch (const boost::system::system_error& e) {
+    LOG_GENERAL(WARNING, "Failed to listen on Stratum port " << port << ": "
+                                                             << e.what());
+    return false;
+  }
+
+  m_running = true;
+  Accept();
+  m_ioThread = thread([this]() { m_ioService.run(); });
+  m_workThread = thread([this]() { WatchWork(); });
+
+  LOG_GENERAL(INFO, "Stratum server listening on port " << port);
+  return true;
+}
+
+void StratumServer::Stop() {
+  if (!m_running.exchange(false)) {
+    return;
+  }
+
+  m_ioService.stop();
+  if (m_ioThread.joinable()) {
+    m_ioThread.join();
+  }
+  if (m_workThread.joinable()) {
+    m_workThread.join();
+  }
+  m_sessions.clear();
+  m_acceptor.reset();
+}
+
+void StratumServer::Accept() {
+  auto session = make_shared<Session>(m_ioService);
+  m_acceptor->async_accept(
+      session->m_socket, [this, session](const boost::system::error_code& ec) {
+        if (!m_running) {
+          return;
+        }
+        if (!ec) {
+          m_sessions.insert(session);
+          if (!m_curWorkNotification.empty()) {
+            Write(session, m_curWorkNotification);
+          }
+          Read(session);
+        }
+        Accept();
+      });
+}
+
+void StratumServer::Read(const SessionPtr& session) {
+  boost::asio::async_read_until(
+      session->m_socket, session->m_readBuffer, '\n',
+      [this, session](const boost::system::error_code& ec, size_t) {
+        // Also fails on a line longer than the read buffer
+        if (ec) {
+          Close(session);
+          return;
+        }
+
+        istream is(&session->m_readBuffer);
+        string line;
+        getline(is, line);
+
+        Json::Value request;
+        if (!JSONUtils::GetInstance().convertStrtoJson(line, request) ||
+            !request.isObject()) {
+          Close(session);
+          return;
+        }
+
+        Write(session, JSONUtils::GetInstance().convertJsontoCompactStr(
+                           HandleRequest(request)));
+        Read(session);
+      });
+}
+
+void StratumServer::Write(const SessionPtr& session, const string& line) {
+  const bool writing = !session->m_writeQueue.empty();
+  session->m_writeQueue.emplace_back(line + "\n");
+  if (!writing) {
+    WriteNext(session);
+  }
+}
+
+// Sends the queue one line at a time, as asio allows one write at once
+void StratumServer::WriteNext(const SessionPtr& session) {
+  boost::asio::async_write(
+      session->m_socket, boost::asio::buffer(session->m_writeQueue.front()),
+      [this, session](const boost::system::error_code& ec, size_t) {
+        if (ec) {
+          Close(session);
+          return;
+        }
+        session->m_writeQueue.pop_front();
+        if (!session->m_writeQueue.empty()) {
+          WriteNext(session);
+        }
+      });
+}
+
+// The queue is kept, as a pending write still refers to its front
+void StratumServer::Close(const SessionPtr& session) {
+  boost::system::error_code ec;
+  session->m_socket.close(ec);
+  m_sessions.erase(session);
+}
+
+Json::Value StratumServer::HandleRequest(const Json::Value& request) {
+  auto& getWorkServer = GetWorkServer::GetInstance();
+  const string method = request.get("method", "").asString();
+  const Json::Value& params = request["params"];
+
+  Json::Value response;
+  response["id"] = request.get("id", Json::Value());
+  response["jsonrpc"] = "2.0";
+
+  if (method == "eth_submitLogin" || method == "eth_submitHashrate") {
+    response["result"] = true;
+  } else if (method == "eth_getWork") {
+    response["result"] = getWorkServer.getWork();
+  } else if (method == "eth_submitWork" && params.isArray() &&
+             params.size() >= 3) {
+    // The boundary is not sent by EthProxy miners, so check the current one
+    const string boundary = getWorkServer.getWork()[2].asString();
+    response["result"] = getWorkServer.submitWork(
+        params[0].asString(), params[1].asString(), params[2].asString(),
+        boundary, "", "");
+  } else {
+    response["error"]["code"] = -32601;
+    response["error"]["message"] = "Method not found";
+  }
+
+  return response;
+}
+
+void StratumServer::WatchWork() {
+  string header;
+  while (m_running) {
+    auto work = GetWorkServer::GetInstance().AwaitWork(
+        header, WATCH_WORK_TIMEOUT_IN_SECONDS);
+    const string newHeader = work[0].asString();
+    if (newHeader == header) {
+      continue;
+    }
+    header = newHeader;
+
+    // Miners connecting while not mining get the next work only
+    const string line =
+        header.empty() ? ""
+                       : JSONUtils::GetInstance().convertJsontoCompactStr(
+                             MakeWorkNotification(work));
+    if (!line.empty()) {
+      LOG_GENERAL(INFO, "Pushing work " << header << " to Stratum miners");
+    }
+    m_ioService.post([this, line]() {
+      m_curWorkNotification = line;
+      if (line.empty()) {
+        return;
+      }
+      for (const auto& session : m_sessions) {
+        Write(session, line);
+      }
+    });
+  }
+}
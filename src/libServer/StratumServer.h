@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBSERVER_STRATUMSERVER_H_
+#define ZILLIQA_SRC_LIBSERVER_STRATUMSERVER_H_
+
+#include <json/json.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+
+#include <boost/asio.hpp>
+
+/// Serves the getwork methods of GetWorkServer as line delimited JSON-RPC
+/// over TCP, the EthProxy flavour of Stratum. Every new work is pushed to
+/// the connected miners as soon as it starts, so they need not poll.
+class StratumServer {
+  // A miner sending a longer line than this is dropped
+  static const size_t MAX_LINE_SIZE = 4096;
+
+  struct Session {
+    explicit Session(boost::asio::io_service& ioService)
+        : m_socket(ioService), m_readBuffer(MAX_LINE_SIZE) {}
+
+    boost::asio::ip::tcp::socket m_socket;
+    boost::asio::streambuf m_readBuffer;
+    std::deque<std::string> m_writeQueue;
+  };
+  using SessionPtr = std::shared_ptr<Session>;
+
+  StratumServer() = default;
+  ~StratumServer();
+
+  StratumServer(StratumServer const&) = delete;
+  void operator=(StratumServer const&) = delete;
+
+  boost::asio::io_service m_ioService;
+  std::unique_ptr<boost::asio::ip::tcp::acceptor> m_acceptor;
+  std::atomic<bool> m_running{false};
+  std::thread m_ioThread;
+  std::thread m_workThread;
+
+  // Only used on the io thread
+  std::set<SessionPtr> m_sessions;
+  std::string m_curWorkNotification;
+
+  void Accept();
+  void Read(const SessionPtr& session);
+  void Write(const SessionPtr& session, const std::string& line);
+  void WriteNext(const SessionPtr& session);
+  void Close(const SessionPtr& session);
+
+  /// Returns the response to one request line
+  Json::Value HandleRequest(const Json::Value& request);
+
+  /// Waits on the getwork server for new work to push to every miner
+  void WatchWork();
+
+ public:
+  static StratumServer& GetInstance();
+
+  bool Start(unsigned int port);
+  void Stop();
+};
+
+#endif  // ZILLIQA_SRC_LIBSERVER_STRATUMSERVER_H_
@@ -45,9 +45,7 @@ std::mutex WebsocketServer::m_mutexEventLogAddrHdlTracker;
 EventLogAddrHdlTracker WebsocketServer::m_eventLogAddrHdlTracker;
 
 std::mutex WebsocketServer::m_mutexEventLogDataBuffer;
-std::map<websocketpp::connection_hdl, std::unordered_map<Address, Json::Value>,
-         std::owner_less<connection_hdl>>
-    WebsocketServer::m_eventLogDataBuffer;
+std::unordered_map<Address, Json::Value> WebsocketServer::m_eventLogDataBuffer;
 
 bool WebsocketServer::start() {
   LOG_MARKER();
@@ -327,10 +325,8 @@ void WebsocketServer::ParseTxnEventLog(const TransactionWithReceipt& twr) {
     Json::Value j_eventlog;
     j_eventlog["_eventname"] = log["_eventname"];
     j_eventlog["params"] = log["params"];
-    for (const connection_hdl& hdl : find->second) {
-      lock_guard<mutex> g(m_mutexEventLogDataBuffer);
-      m_eventLogDataBuffer[hdl][addr].append(j_eventlog);
-    }
+    lock_guard<mutex> g2(m_mutexEventLogDataBuffer);
+    m_eventLogDataBuffer[addr].append(j_eventlog);
   }
 }
 
@@ -350,7 +346,7 @@ void WebsocketServer::closeSocket(
   auto find = m_subscriptions.find(hdl);
   if (find != m_subscriptions.end()) {
     if (find->second.subscribed(EVENTLOG)) {
-      lock_guard<mutex> g3(m_mutexEventLogDataBuffer);
+      lock_guard<mutex> g2(m_mutexEventLogAddrHdlTracker);
       m_eventLogAddrHdlTracker.remove(hdl);
     }
     m_subscriptions.erase(find);
@@ -360,83 +356,132 @@ void WebsocketServer::closeSocket(
 void WebsocketServer::SendOutMessages() {
   LOG_MARKER();
 
+  /// What a subscriber is sent this epoch, taken under the locks so that the
+  /// notifications are serialized and sent without them
+  struct Outbox {
+    connection_hdl m_hdl;
+    set<WEBSOCKETQUERY> m_queries;
+    set<WEBSOCKETQUERY> m_unsubscribings;
+    /// serialized event logs of the subscribed addresses that have some
+    vector<const string*> m_eventLogs;
+  };
+
+  vector<Outbox> outboxes;
+  map<connection_hdl, size_t, owner_less<connection_hdl>> outboxIndex;
   vector<std::pair<connection_hdl, string>> hdlToRemove;
+  bool newBlock = false;
+  bool eventLog = false;
 
   {
-    lock_guard<mutex> g1(m_mutexSubscriptions);
+    lock_guard<mutex> g(m_mutexSubscriptions);
 
-    if (m_subscriptions.empty()) {
-      return;
+    for (auto& subscription : m_subscriptions) {
+      if (subscription.second.queries.empty()) {
+        hdlToRemove.push_back({subscription.first, "no subscription"});
+        continue;
+      }
+      outboxIndex.emplace(subscription.first, outboxes.size());
+      outboxes.push_back({subscription.first, subscription.second.queries,
+                          subscription.second.unsubscribings, {}});
+      newBlock |= subscription.second.subscribed(NEWBLOCK);
+      eventLog |= subscription.second.subscribed(EVENTLOG);
+      subscription.second.unsubscribe_finish();
     }
+  }
 
-    lock_guard<mutex> g2(m_mutexTxnBlockNTxnHashes);
-    lock_guard<mutex> g3(m_mutexEventLogDataBuffer);
-
-    for (auto it = m_subscriptions.begin(); it != m_subscriptions.end();) {
-      if (it->second.queries.empty()) {
-        hdlToRemove.push_back({it->first, "no subscription"});
-      } else {
-        Json::Value notification;
-        notification["type"] = "Notification";
-
-        // SUBSCRIBE
-        for (const auto& query : it->second.queries) {
-          Json::Value value;
-          value["query"] = GetQueryString(query);
-          bool valid_query = true;
-          switch (query) {
-            case NEWBLOCK: {
-              value["value"] = m_jsonTxnBlockNTxnHashes;
-              break;
-            }
-            case EVENTLOG: {
-              Json::Value j_eventlogs;
-              auto buffer = m_eventLogDataBuffer.find(it->first);
-              if (buffer != m_eventLogDataBuffer.end()) {
-                for (const auto& entry : buffer->second) {
-                  Json::Value j_contract;
-                  j_contract["address"] = entry.first.hex();
-                  j_contract["event_logs"] = entry.second;
-                  j_eventlogs.append(j_contract);
-                }
-                value["value"] = std::move(j_eventlogs);
-              }
-              break;
-            }
-            default:
-              valid_query = false;
-              break;
-          }
-          if (!valid_query) {
-            continue;
-          }
-          notification["values"].append(value);
-        }
+  unordered_map<Address, Json::Value> eventLogs;
+  {
+    lock_guard<mutex> g(m_mutexEventLogDataBuffer);
+    eventLogs.swap(m_eventLogDataBuffer);
+  }
 
-        // UNSUBSCRIBE
-        if (!it->second.unsubscribings.empty()) {
-          Json::Value value;
-          value["query"] = GetQueryString(UNSUBSCRIBE);
-          Json::Value j_unsubscripings;
-          for (const auto& unsubscriping : it->second.unsubscribings) {
-            j_unsubscripings.append(GetQueryString(unsubscriping));
-          }
-          value["value"] = std::move(j_unsubscripings);
-          notification["values"].append(value);
+  // Every payload is serialized once, whatever the number of subscribers
+  auto& jsonUtils = JSONUtils::GetInstance();
+  string j_txblock;
+  if (newBlock) {
+    lock_guard<mutex> g(m_mutexTxnBlockNTxnHashes);
+    j_txblock = jsonUtils.convertJsontoCompactStr(m_jsonTxnBlockNTxnHashes);
+  }
+
+  map<Address, string> j_contracts;
+  if (eventLog) {
+    for (const auto& entry : eventLogs) {
+      Json::Value j_contract;
+      j_contract["address"] = entry.first.hex();
+      j_contract["event_logs"] = entry.second;
+      j_contracts.emplace(entry.first,
+                          jsonUtils.convertJsontoCompactStr(j_contract));
+    }
+  }
 
-          it->second.unsubscribe_finish();
+  // Routes the event logs of each address to its subscribers only, so that
+  // the cost follows the matches and not subscribers times events
+  if (!j_contracts.empty()) {
+    lock_guard<mutex> g(m_mutexEventLogAddrHdlTracker);
+    for (const auto& entry : j_contracts) {
+      auto find = m_eventLogAddrHdlTracker.m_addr_hdl_map.find(entry.first);
+      if (find == m_eventLogAddrHdlTracker.m_addr_hdl_map.end()) {
+        continue;
+      }
+      for (const auto& hdl : find->second) {
+        auto index = outboxIndex.find(hdl);
+        if (index != outboxIndex.end()) {
+          outboxes[index->second].m_eventLogs.push_back(&entry.second);
         }
+      }
+    }
+  }
 
-        if (!sendData(it->first, JSONUtils::GetInstance().convertJsontoStr(
-                                     notification))) {
-          hdlToRemove.push_back({it->first, "unable to send data"});
+  for (const auto& outbox : outboxes) {
+    string notification = "{\"type\":\"Notification\"";
+    bool first = true;
+    auto appendValue = [&](WEBSOCKETQUERY query, const string& value) {
+      notification += first ? ",\"values\":[" : ",";
+      first = false;
+      notification += "{\"query\":\"" + GetQueryString(query) + "\"";
+      if (!value.empty()) {
+        notification += ",\"value\":" + value;
+      }
+      notification += '}';
+    };
+
+    // SUBSCRIBE
+    for (const auto& query : outbox.m_queries) {
+      switch (query) {
+        case NEWBLOCK:
+          appendValue(NEWBLOCK, j_txblock);
+          break;
+        case EVENTLOG: {
+          string j_eventlogs;
+          for (const auto& j_contract : outbox.m_eventLogs) {
+            j_eventlogs += j_eventlogs.empty() ? "[" : ",";
+            j_eventlogs += *j_contract;
+          }
+          if (!j_eventlogs.empty()) {
+            j_eventlogs += ']';
+          }
+          appendValue(EVENTLOG, j_eventlogs);
+          break;
         }
+        default:
+          break;
       }
+    }
 
-      ++it;
+    // UNSUBSCRIBE
+    if (!outbox.m_unsubscribings.empty()) {
+      string j_unsubscripings;
+      for (const auto& unsubscriping : outbox.m_unsubscribings) {
+        j_unsubscripings += j_unsubscripings.empty() ? "[" : ",";
+        j_unsubscripings += "\"" + GetQueryString(unsubscriping) + "\"";
+      }
+      appendValue(UNSUBSCRIBE, j_unsubscripings + "]");
     }
 
-    m_eventLogDataBuffer.clear();
+    notification += first ? "}" : "]}";
+    if (!sendData(outbox.m_hdl, notification)) {
+      hdlToRemove.push_back({outbox.m_hdl, "unable to send data"});
+    }
   }
 
   for (const auto& pair : hdlToRemove) {
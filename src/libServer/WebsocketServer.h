@@ -77,9 +77,10 @@ struct EventLogAddrHdlTracker {
     }
     for (const auto& addr : iter_hdl_addr->second) {
       auto iter_addr_hdl = m_addr_hdl_map.find(addr);
-      if (iter_addr_hdl != m_addr_hdl_map.end()) {
-        iter_addr_hdl->second.erase(hdl);
+      if (iter_addr_hdl == m_addr_hdl_map.end()) {
+        continue;
       }
+      iter_addr_hdl->second.erase(hdl);
       if (iter_addr_hdl->second.empty()) {
         m_addr_hdl_map.erase(iter_addr_hdl);
       }
@@ -89,6 +90,8 @@ struct EventLogAddrHdlTracker {
 
   void update(const websocketpp::connection_hdl& hdl,
               const std::set<Address>& addresses) {
+    // drop the addresses of an earlier subscription of hdl
+    remove(hdl);
     for (const auto& addr : addresses) {
       m_addr_hdl_map[addr].emplace(hdl);
     }
@@ -115,12 +118,10 @@ class WebsocketServer : public Singleton<WebsocketServer> {
   static std::mutex m_mutexEventLogAddrHdlTracker;
   static EventLogAddrHdlTracker m_eventLogAddrHdlTracker;
 
-  /// a buffer for keeping the eventlog to send for each subscriber
+  /// a buffer for keeping the eventlog of each subscribed address to send,
+  /// shared by all its subscribers
   static std::mutex m_mutexEventLogDataBuffer;
-  static std::map<websocketpp::connection_hdl,
-                  std::unordered_map<Address, Json::Value>,
-                  std::owner_less<websocketpp::connection_hdl>>
-      m_eventLogDataBuffer;
+  static std::unordered_map<Address, Json::Value> m_eventLogDataBuffer;
 
   /// make run() detached in a new thread to avoid blocking
   websocketpp::lib::shared_ptr<websocketpp::lib::thread> m_thread;
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "AsyncLogBuffer.h"
+#include "Logger.h"
+
+using namespace std;
+
+namespace {
+atomic<uint64_t> nextBufferId{1};
+}  // namespace
+
+void LogRecord::CopyTail(array<char, FIELD_LEN>& field, const char* src) {
+  const size_t len = strlen(src);
+  const size_t copied = min(len, FIELD_LEN - 1);
+  memcpy(field.data(), src + len - copied, copied);
+  field[copied] = '\0';
+}
+
+void LogRecord::CopyHead(array<char, FIELD_LEN>& field, const char* src) {
+  const size_t copied = min(strlen(src), FIELD_LEN - 1);
+  memcpy(field.data(), src, copied);
+  field[copied] = '\0';
+}
+
+AsyncLogBuffer::ThreadRing::~ThreadRing() {
+  if (m_ring) {
+    m_ring->m_closed = true;
+  }
+}
+
+AsyncLogBuffer::AsyncLogBuffer(size_t capacity, Writer writer,
+                               chrono::milliseconds interval,
+                               int droppedLevel)
+    : m_id(nextBufferId++),
+      m_capacity(max<size_t>(capacity, 1)),
+      m_writer(move(writer)),
+      m_interval(interval),
+      m_droppedLevel(droppedLevel) {
+  m_thread = thread([this]() { Run(); });
+}
+
+AsyncLogBuffer::~AsyncLogBuffer() {
+  {
+    lock_guard<mutex> g(m_mutexStop);
+    m_stop = true;
+  }
+  m_cvStop.notify_all();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+  Drain();
+}
+
+bool AsyncLogBuffer::Push(LogRecord&& record) {
+  Ring& ring = GetRing();
+  const size_t head = ring.m_head.load(memory_order_relaxed);
+  if (head - ring.m_tail.load(memory_order_acquire) >= m_capacity) {
+    m_dropped++;
+    return false;
+  }
+  ring.m_records[head % m_capacity] = move(record);
+  ring.m_head.store(head + 1, memory_order_release);
+  return true;
+}
+
+void AsyncLogBuffer::Flush() { Drain(); }
+
+AsyncLogBuffer::ThreadRing& AsyncLogBuffer::CurrentRing() {
+  static thread_local ThreadRing threadRing;
+  return threadRing;
+}
+
+AsyncLogBuffer::Ring& AsyncLogBuffer::GetRing() {
+  ThreadRing& threadRing = CurrentRing();
+  if (threadRing.m_owner != m_id) {
+    if (threadRing.m_ring) {
+      threadRing.m_ring->m_closed = true;
+    }
+    threadRing.m_owner = m_id;
+    threadRing.m_ring = make_shared<Ring>(m_capacity);
+    lock_guard<mutex> g(m_mutexRings);
+    m_rings.emplace_back(threadRing.m_ring);
+  }
+  return *threadRing.m_ring;
+}
+
+void AsyncLogBuffer::Drain() {
+  lock_guard<mutex> g(m_mutexDrain);
+
+  vector<shared_ptr<Ring>> rings;
+  {
+    lock_guard<mutex> g(m_mutexRings);
+    // A closed ring gets no more records, so it goes once drained
+    m_rings.erase(remove_if(m_rings.begin(), m_rings.end(),
+                            [](const shared_ptr<Ring>& ring) {
+                              return ring->m_closed &&
+                                     ring->m_tail == ring->m_head;
+                            }),
+                  m_rings.end());
+    rings = m_rings;
+  }
+
+  vector<LogRecord> records;
+  for (const auto& ring : rings) {
+    const size_t head = ring->m_head.load(memory_order_acquire);
+    size_t tail = ring->m_tail.load(memory_order_relaxed);
+    for (; tail != head; tail++) {
+      records.emplace_back(move(ring->m_records[tail % m_capacity]));
+    }
+    ring->m_tail.store(tail, memory_order_release);
+  }
+
+  // Lines of different threads go in the order they were logged
+  stable_sort(records.begin(), records.end(),
+              [](const LogRecord& a, const LogRecord& b) {
+                return a.m_time < b.m_time;
+              });
+  for (const auto& record : records) {
+    m_writer(record);
+  }
+
+  const uint64_t dropped = m_dropped;
+  if (dropped > m_droppedReported) {
+    LogRecord record;
+    record.m_level = m_droppedLevel;
+    record.m_tid = Logger::GetPid();
+    record.m_time = chrono::system_clock::now();
+    LogRecord::CopyTail(record.m_file, __FILE__);
+    LogRecord::CopyHead(record.m_function, __FUNCTION__);
+    record.m_line = __LINE__;
+    record.m_msg = "Dropped " + to_string(dropped - m_droppedReported) +
+                   " log lines, the log buffers were full";
+    m_droppedReported = dropped;
+    m_writer(record);
+  }
+}
+
+void AsyncLogBuffer::Run() {
+  unique_lock<mutex> lock(m_mutexStop);
+  while (!m_cvStop.wait_for(lock, m_interval, [this]() { return m_stop; })) {
+    lock.unlock();
+    Drain();
+    lock.lock();
+  }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_ASYNCLOGBUFFER_H_
+#define ZILLIQA_SRC_LIBUTILS_ASYNCLOGBUFFER_H_
+
+#include <sys/types.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/BaseType.h"
+
+/// A log line as captured on the logging thread, before it is formatted
+struct LogRecord {
+  enum Kind : unsigned char { GENERAL, EPOCH, PAYLOAD };
+
+  static const size_t FIELD_LEN = 24;
+
+  Kind m_kind{GENERAL};
+  int m_level{0};
+  pid_t m_tid{0};
+  std::chrono::system_clock::time_point m_time;
+  unsigned int m_line{0};
+  std::array<char, FIELD_LEN> m_file{};
+  std::array<char, FIELD_LEN> m_function{};
+  std::array<char, FIELD_LEN> m_epoch{};
+  std::string m_msg;
+  bytes m_payload;
+  size_t m_payloadSize{0};
+
+  /// Copies the last FIELD_LEN - 1 characters of src into field
+  static void CopyTail(std::array<char, FIELD_LEN>& field, const char* src);
+  /// Copies the first FIELD_LEN - 1 characters of src into field
+  static void CopyHead(std::array<char, FIELD_LEN>& field, const char* src);
+};
+
+/// Hands log records from the logging threads to a background thread that
+/// writes them. Each logging thread has a ring buffer of its own, which it
+/// fills without taking a lock. A record that finds the ring full is dropped
+/// and counted, and the count is logged once the ring is drained.
+class AsyncLogBuffer {
+ public:
+  using Writer = std::function<void(const LogRecord&)>;
+
+  /// Keeps capacity records per thread, and writes them with writer every
+  /// interval. Dropped records are reported at droppedLevel.
+  AsyncLogBuffer(size_t capacity, Writer writer,
+                 std::chrono::milliseconds interval, int droppedLevel);
+  /// Writes what is left
+  ~AsyncLogBuffer();
+
+  /// Queues record on the ring of the calling thread, or drops it if the
+  /// ring is full
+  bool Push(LogRecord&& record);
+
+  /// Writes every record pushed so far, on the calling thread
+  void Flush();
+
+  uint64_t GetDroppedCount() const { return m_dropped; }
+
+ private:
+  struct Ring {
+    explicit Ring(size_t capacity) : m_records(capacity) {}
+    std::vector<LogRecord> m_records;
+    // Written only by the thread of the ring
+    std::atomic<size_t> m_head{0};
+    // Written only while draining
+    std::atomic<size_t> m_tail{0};
+    std::atomic<bool> m_closed{false};
+  };
+
+  // The ring of a thread, marked closed once a thread ends
+  struct ThreadRing {
+    uint64_t m_owner{0};
+    std::shared_ptr<Ring> m_ring;
+    ~ThreadRing();
+  };
+
+  static ThreadRing& CurrentRing();
+  Ring& GetRing();
+  void Drain();
+  void Run();
+
+  const uint64_t m_id;
+  const size_t m_capacity;
+  const Writer m_writer;
+  const std::chrono::milliseconds m_interval;
+  const int m_droppedLevel;
+
+  std::mutex m_mutexRings;
+  std::vector<std::shared_ptr<Ring>> m_rings;
+
+  std::mutex m_mutexDrain;
+  std::atomic<uint64_t> m_dropped{0};
+  uint64_t m_droppedReported{0};
+
+  std::mutex m_mutexStop;
+  std::condition_variable m_cvStop;
+  bool m_stop{false};
+  std::thread m_thread;
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_ASYNCLOGBUFFER_H_
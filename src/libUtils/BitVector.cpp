@@ -29,9 +29,29 @@ unsigned int BitVector::GetBitVectorSerializedSize(
   return 2 + GetBitVectorLengthInBytes(length_in_bits);
 }
 
-std::vector<bool> BitVector::GetBitVector(const bytes& src, unsigned int offset,
-                                          unsigned int expected_length) {
-  std::vector<bool> result;
+namespace {
+Bitmap ReadBits(const bytes& src, unsigned int offset, unsigned int length) {
+  Bitmap result(length);
+  const unsigned int length_bytes =
+      BitVector::GetBitVectorLengthInBytes(length);
+  for (unsigned int i = 0; i < length_bytes; i++) {
+    const unsigned char byte = src.at(offset + i);
+    if (byte == 0) {
+      continue;
+    }
+    for (unsigned int bit = 0; bit < 8; bit++) {
+      const unsigned int index = (i << 3) + bit;
+      if ((index < length) && (byte & (1 << (7 - bit)))) {
+        result.set(index);
+      }
+    }
+  }
+  return result;
+}
+}  // namespace
+
+Bitmap BitVector::GetBitVector(const bytes& src, unsigned int offset,
+                               unsigned int expected_length) {
   unsigned int actual_length = 0;
   unsigned int actual_length_bytes = 0;
 
@@ -42,19 +62,13 @@ std::vector<bool> BitVector::GetBitVector(const bytes& src, unsigned int offset,
 
   if ((actual_length_bytes == expected_length) &&
       ((src.size() - offset - 2) >= actual_length_bytes)) {
-    result.reserve(actual_length);
-    for (unsigned int index = 0; index < actual_length; index++) {
-      result.push_back(src.at(offset + 2 + (index >> 3)) &
-                       (1 << (7 - (index & 0x07))));
-    }
+    return ReadBits(src, offset + 2, actual_length);
   }
 
-  return result;
+  return Bitmap();
 }
 
-std::vector<bool> BitVector::GetBitVector(const bytes& src,
-                                          unsigned int offset) {
-  std::vector<bool> result;
+Bitmap BitVector::GetBitVector(const bytes& src, unsigned int offset) {
   unsigned int actual_length = 0;
   unsigned int actual_length_bytes = 0;
 
@@ -64,18 +78,14 @@ std::vector<bool> BitVector::GetBitVector(const bytes& src,
   }
 
   if ((src.size() - offset - 2) >= actual_length_bytes) {
-    result.reserve(actual_length);
-    for (unsigned int index = 0; index < actual_length; index++) {
-      result.push_back(src.at(offset + 2 + (index >> 3)) &
-                       (1 << (7 - (index & 0x07))));
-    }
+    return ReadBits(src, offset + 2, actual_length);
   }
 
-  return result;
+  return Bitmap();
 }
 
 unsigned int BitVector::SetBitVector(bytes& dst, unsigned int offset,
-                                     const std::vector<bool>& value) {
+                                     const Bitmap& value) {
   const unsigned int length_needed = GetBitVectorSerializedSize(value.size());
 
   if ((offset + length_needed) > dst.size()) {
@@ -86,12 +96,9 @@ unsigned int BitVector::SetBitVector(bytes& dst, unsigned int offset,
   dst.at(offset) = value.size() >> 8;
   dst.at(offset + 1) = value.size();
 
-  unsigned int index = 0;
-  for (bool b : value) {
-    if (b) {
-      dst.at(offset + 2 + (index >> 3)) |= (1 << (7 - (index & 0x07)));
-    }
-    index++;
+  for (size_t index = value.find_first(); index != Bitmap::npos;
+       index = value.find_next(index)) {
+    dst.at(offset + 2 + (index >> 3)) |= (1 << (7 - (index & 0x07)));
   }
 
   return length_needed;
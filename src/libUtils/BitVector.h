@@ -19,16 +19,17 @@
 #define ZILLIQA_SRC_LIBUTILS_BITVECTOR_H_
 
 #include "common/BaseType.h"
+#include "libUtils/Bitmap.h"
 
 class BitVector {
  public:
   static unsigned int GetBitVectorLengthInBytes(unsigned int length_in_bits);
   static unsigned int GetBitVectorSerializedSize(unsigned int length_in_bits);
-  static std::vector<bool> GetBitVector(const bytes& src, unsigned int offset,
-                                        unsigned int expected_length);
-  static std::vector<bool> GetBitVector(const bytes& src, unsigned int offset);
+  static Bitmap GetBitVector(const bytes& src, unsigned int offset,
+                             unsigned int expected_length);
+  static Bitmap GetBitVector(const bytes& src, unsigned int offset);
   static unsigned int SetBitVector(bytes& dst, unsigned int offset,
-                                   const std::vector<bool>& value);
+                                   const Bitmap& value);
 };
 
 #endif  // ZILLIQA_SRC_LIBUTILS_BITVECTOR_H_
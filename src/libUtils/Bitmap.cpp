@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "Bitmap.h"
+
+using namespace std;
+
+const size_t Bitmap::npos;
+
+Bitmap::Bitmap(size_t size, bool value)
+    : m_words(NumWords(size), value ? ~0ULL : 0), m_size(size) {
+  ClearUnusedBits();
+}
+
+Bitmap::Bitmap(const vector<bool>& bits)
+    : m_words(NumWords(bits.size()), 0), m_size(bits.size()) {
+  for (size_t i = 0; i < bits.size(); i++) {
+    if (bits[i]) {
+      m_words[i >> 6] |= 1ULL << (i & 63);
+    }
+  }
+}
+
+bool Bitmap::at(size_t index) const {
+  if (index >= m_size) {
+    throw out_of_range("Bitmap index out of range");
+  }
+  return (*this)[index];
+}
+
+void Bitmap::set(size_t index, bool value) {
+  if (index >= m_size) {
+    throw out_of_range("Bitmap index out of range");
+  }
+  if (value) {
+    m_words[index >> 6] |= 1ULL << (index & 63);
+  } else {
+    m_words[index >> 6] &= ~(1ULL << (index & 63));
+  }
+}
+
+void Bitmap::reset() { fill(m_words.begin(), m_words.end(), 0); }
+
+void Bitmap::resize(size_t size, bool value) {
+  const size_t oldSize = m_size;
+  m_words.resize(NumWords(size), value ? ~0ULL : 0);
+  m_size = size;
+
+  if (value && (size > oldSize) && ((oldSize & 63) != 0)) {
+    // Fill the rest of the previously last word
+    m_words[oldSize >> 6] |= ~0ULL << (oldSize & 63);
+  }
+  ClearUnusedBits();
+}
+
+void Bitmap::clear() {
+  m_words.clear();
+  m_size = 0;
+}
+
+void Bitmap::push_back(bool value) {
+  if ((m_size & 63) == 0) {
+    m_words.push_back(0);
+  }
+  m_size++;
+  if (value) {
+    set(m_size - 1);
+  }
+}
+
+size_t Bitmap::count() const {
+  size_t result = 0;
+  for (const auto& word : m_words) {
+    result += __builtin_popcountll(word);
+  }
+  return result;
+}
+
+size_t Bitmap::FindFrom(size_t index) const {
+  if (index >= m_size) {
+    return npos;
+  }
+
+  size_t wordIndex = index >> 6;
+  uint64_t word = m_words[wordIndex] & (~0ULL << (index & 63));
+  while (word == 0) {
+    if (++wordIndex == m_words.size()) {
+      return npos;
+    }
+    word = m_words[wordIndex];
+  }
+  return (wordIndex << 6) + __builtin_ctzll(word);
+}
+
+size_t Bitmap::find_first() const { return FindFrom(0); }
+
+size_t Bitmap::find_next(size_t index) const {
+  return (index == npos) ? npos : FindFrom(index + 1);
+}
+
+Bitmap& Bitmap::operator&=(const Bitmap& other) {
+  for (size_t i = 0; i < m_words.size(); i++) {
+    m_words[i] &= (i < other.m_words.size()) ? other.m_words[i] : 0;
+  }
+  return *this;
+}
+
+bool Bitmap::operator==(const Bitmap& other) const {
+  return (m_size == other.m_size) && (m_words == other.m_words);
+}
+
+void Bitmap::ClearUnusedBits() {
+  if ((m_size & 63) != 0) {
+    m_words.back() &= (1ULL << (m_size & 63)) - 1;
+  }
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_BITMAP_H_
+#define ZILLIQA_SRC_LIBUTILS_BITMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+/// Packed bitmap used for the co-signer maps of a consensus round.
+/// Bits are kept in 64-bit words so that counting and scanning for set bits
+/// handle a whole word at a time. The std::vector<bool> accessors used across
+/// the code are kept, so it can stand in wherever a signer map is passed.
+class Bitmap {
+ public:
+  static const size_t npos = std::numeric_limits<size_t>::max();
+
+  /// Read-only iterator over all bits.
+  class const_iterator {
+    const Bitmap* m_bitmap;
+    size_t m_index;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = bool;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const bool*;
+    using reference = bool;
+
+    const_iterator(const Bitmap* bitmap, size_t index)
+        : m_bitmap(bitmap), m_index(index) {}
+    bool operator*() const { return (*m_bitmap)[m_index]; }
+    const_iterator& operator++() {
+      m_index++;
+      return *this;
+    }
+    bool operator==(const const_iterator& other) const {
+      return m_index == other.m_index;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return m_index != other.m_index;
+    }
+  };
+
+  Bitmap() = default;
+  explicit Bitmap(size_t size, bool value = false);
+  Bitmap(const std::vector<bool>& bits);  // NOLINT(runtime/explicit)
+
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  bool operator[](size_t index) const {
+    return (m_words[index >> 6] >> (index & 63)) & 1;
+  }
+
+  /// Returns the bit. Throws std::out_of_range if the index is invalid.
+  bool at(size_t index) const;
+
+  /// Sets the bit. Throws std::out_of_range if the index is invalid.
+  void set(size_t index, bool value = true);
+
+  /// Clears all bits without changing the size.
+  void reset();
+
+  void resize(size_t size, bool value = false);
+  void clear();
+  void push_back(bool value);
+  void emplace_back(bool value) { push_back(value); }
+
+  /// Returns the number of set bits.
+  size_t count() const;
+
+  /// Returns the index of the first set bit, or npos if there is none.
+  size_t find_first() const;
+
+  /// Returns the index of the first set bit after index, or npos.
+  size_t find_next(size_t index) const;
+
+  /// Keeps only the bits that are also set in other.
+  Bitmap& operator&=(const Bitmap& other);
+
+  bool operator==(const Bitmap& other) const;
+  bool operator!=(const Bitmap& other) const { return !(*this == other); }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, m_size); }
+
+ private:
+  std::vector<uint64_t> m_words;
+  size_t m_size{0};
+
+  static size_t NumWords(size_t size) { return (size + 63) >> 6; }
+  size_t FindFrom(size_t index) const;
+  void ClearUnusedBits();
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_BITMAP_H_
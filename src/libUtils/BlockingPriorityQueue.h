@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_BLOCKINGPRIORITYQUEUE_H_
+#define ZILLIQA_SRC_LIBUTILS_BLOCKINGPRIORITYQUEUE_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/**
+ * Bounded multi-lane queue. Lane 0 has the highest priority; Pop() always
+ * serves the highest priority non-empty lane and sleeps while all lanes are
+ * empty. Each lane has its own capacity, so a flood on one lane cannot take
+ * the space of the others.
+ */
+template <class T>
+class BlockingPriorityQueue {
+ public:
+  BlockingPriorityQueue(const unsigned int numLanes,
+                        const unsigned int capacityPerLane)
+      : m_lanes(numLanes), m_capacityPerLane(capacityPerLane) {}
+
+  /// Adds an item to the lane. Returns false if the lane is full or the queue
+  /// was stopped.
+  bool Push(const T& item, const unsigned int lane) {
+    {
+      std::lock_guard<std::mutex> g(m_mutex);
+      if (m_stopped || lane >= m_lanes.size() ||
+          m_lanes[lane].size() >= m_capacityPerLane) {
+        return false;
+      }
+      m_lanes[lane].push_back(item);
+    }
+    m_cv.notify_one();
+    return true;
+  }
+
+  /// Blocks until an item is available. Returns false if the queue was
+  /// stopped.
+  bool Pop(T& item) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::deque<T>* lane = nullptr;
+    m_cv.wait(lock, [this, &lane] {
+      lane = FirstNonEmptyLane();
+      return m_stopped || lane != nullptr;
+    });
+    if (m_stopped) {
+      return false;
+    }
+    item = lane->front();
+    lane->pop_front();
+    return true;
+  }
+
+  /// Removes an item without blocking. Returns false if all lanes are empty.
+  bool TryPop(T& item) {
+    std::lock_guard<std::mutex> g(m_mutex);
+    std::deque<T>* lane = FirstNonEmptyLane();
+    if (lane == nullptr) {
+      return false;
+    }
+    item = lane->front();
+    lane->pop_front();
+    return true;
+  }
+
+  /// Wakes up all waiting consumers and rejects further items.
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> g(m_mutex);
+      m_stopped = true;
+    }
+    m_cv.notify_all();
+  }
+
+  /// Returns the number of items waiting in the lane.
+  size_t Size(const unsigned int lane) {
+    std::lock_guard<std::mutex> g(m_mutex);
+    return (lane < m_lanes.size()) ? m_lanes[lane].size() : 0;
+  }
+
+ private:
+  std::deque<T>* FirstNonEmptyLane() {
+    for (auto& lane : m_lanes) {
+      if (!lane.empty()) {
+        return &lane;
+      }
+    }
+    return nullptr;
+  }
+
+  std::vector<std::deque<T>> m_lanes;
+  const unsigned int m_capacityPerLane;
+  bool m_stopped{false};
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_BLOCKINGPRIORITYQUEUE_H_
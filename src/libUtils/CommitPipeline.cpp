@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CommitPipeline.h"
+#include "libUtils/DetachedExecutor.h"
+#include "libUtils/Logger.h"
+#include "libUtils/TimeUtils.h"
+
+using namespace std;
+
+CommitPipeline::CommitPipeline(const string& name)
+    : m_state(make_shared<State>()) {
+  m_state->m_name = name;
+}
+
+CommitPipeline::StageId CommitPipeline::Add(const string& name, Stage stage,
+                                            const vector<StageId>& dependsOn,
+                                            const string& lane) {
+  lock_guard<mutex> g(m_state->m_mutex);
+  const StageId id = m_state->m_stages.size();
+  if (m_state->m_started) {
+    LOG_GENERAL(WARNING, m_state->m_name << " already started, stage " << name
+                                         << " not added");
+    return id;
+  }
+
+  unsigned int dependencies = 0;
+  for (const auto& dependency : dependsOn) {
+    if (dependency >= id) {
+      LOG_GENERAL(WARNING, "Stage " << name << " depends on unknown stage "
+                                    << dependency);
+      continue;
+    }
+    m_state->m_stages[dependency].m_dependents.emplace_back(id);
+    dependencies++;
+  }
+
+  m_state->m_stages.push_back(
+      {name, move(stage), lane, {}, dependencies, false, WAITING});
+  return id;
+}
+
+void CommitPipeline::Start() {
+  vector<StageId> ready;
+  {
+    lock_guard<mutex> g(m_state->m_mutex);
+    if (m_state->m_started) {
+      return;
+    }
+    m_state->m_started = true;
+    for (StageId id = 0; id < m_state->m_stages.size(); id++) {
+      if (m_state->m_stages[id].m_dependenciesLeft == 0) {
+        m_state->m_stages[id].m_state = RUNNING;
+        ready.emplace_back(id);
+      }
+    }
+  }
+
+  for (const auto& id : ready) {
+    Run(m_state, id);
+  }
+}
+
+bool CommitPipeline::Wait(StageId stage) {
+  unique_lock<mutex> lock(m_state->m_mutex);
+  if (stage >= m_state->m_stages.size()) {
+    return false;
+  }
+  m_state->m_cvDone.wait(lock, [this, stage]() {
+    const StageState state = m_state->m_stages[stage].m_state;
+    return state == SUCCEEDED || state == FAILED;
+  });
+  return m_state->m_stages[stage].m_state == SUCCEEDED;
+}
+
+bool CommitPipeline::WaitAll() {
+  bool succeeded = true;
+  StageId count;
+  {
+    lock_guard<mutex> g(m_state->m_mutex);
+    count = m_state->m_stages.size();
+  }
+  for (StageId id = 0; id < count; id++) {
+    succeeded = Wait(id) && succeeded;
+  }
+  return succeeded;
+}
+
+void CommitPipeline::Run(const shared_ptr<State>& state, StageId stage) {
+  string lane;
+  {
+    lock_guard<mutex> g(state->m_mutex);
+    lane = state->m_stages[stage].m_lane;
+  }
+
+  auto task = [state, stage]() {
+    Stage func;
+    {
+      lock_guard<mutex> g(state->m_mutex);
+      func = move(state->m_stages[stage].m_stage);
+    }
+    const auto startTime = r_timer_start();
+    const bool succeeded = func();
+    LOG_GENERAL(INFO, state->m_name
+                          << " stage " << state->m_stages[stage].m_name
+                          << (succeeded ? " done in " : " failed in ")
+                          << r_timer_end(startTime) / 1000 << " ms");
+    Finish(state, stage, succeeded);
+  };
+
+  if (lane.empty()) {
+    DetachedExecutor::GetInstance().Run(task);
+  } else {
+    DetachedExecutor::GetInstance().Run(lane, task);
+  }
+}
+
+void CommitPipeline::Finish(const shared_ptr<State>& state, StageId stage,
+                            bool succeeded) {
+  vector<StageId> ready;
+  vector<StageId> skipped;
+  {
+    lock_guard<mutex> g(state->m_mutex);
+    auto& entry = state->m_stages[stage];
+    entry.m_state = succeeded ? SUCCEEDED : FAILED;
+    for (const auto& id : entry.m_dependents) {
+      auto& dependent = state->m_stages[id];
+      dependent.m_dependencyFailed |= !succeeded;
+      if (--dependent.m_dependenciesLeft > 0) {
+        continue;
+      }
+      if (dependent.m_dependencyFailed) {
+        LOG_GENERAL(WARNING, state->m_name << " stage " << dependent.m_name
+                                           << " skipped");
+        skipped.emplace_back(id);
+      } else {
+        dependent.m_state = RUNNING;
+        ready.emplace_back(id);
+      }
+    }
+  }
+  state->m_cvDone.notify_all();
+
+  for (const auto& id : skipped) {
+    Finish(state, id, false);
+  }
+  for (const auto& id : ready) {
+    Run(state, id);
+  }
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_COMMITPIPELINE_H_
+#define ZILLIQA_SRC_LIBUTILS_COMMITPIPELINE_H_
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Runs the stages of a commit on the DetachedExecutor, each one once the
+/// stages it depends on have succeeded, so that independent stages run at the
+/// same time. A stage depending on a failed one is skipped and counts as
+/// failed. The stages keep running if the pipeline goes away before them.
+class CommitPipeline {
+ public:
+  using Stage = std::function<bool()>;
+  using StageId = unsigned int;
+
+  explicit CommitPipeline(const std::string& name);
+
+  /// Adds stage, to run after the stages of dependsOn, on lane of the
+  /// DetachedExecutor if lane is not empty. Stages can only depend on stages
+  /// added before them.
+  StageId Add(const std::string& name, Stage stage,
+              const std::vector<StageId>& dependsOn = {},
+              const std::string& lane = "");
+
+  /// Starts the stages. No stage can be added after this.
+  void Start();
+
+  /// Blocks until stage is done, and returns whether it succeeded
+  bool Wait(StageId stage);
+
+  /// Blocks until all the stages are done, and returns whether they all
+  /// succeeded
+  bool WaitAll();
+
+ private:
+  enum StageState : unsigned char { WAITING, RUNNING, SUCCEEDED, FAILED };
+
+  struct StageEntry {
+    std::string m_name;
+    Stage m_stage;
+    std::string m_lane;
+    std::vector<StageId> m_dependents;
+    unsigned int m_dependenciesLeft;
+    bool m_dependencyFailed;
+    StageState m_state;
+  };
+
+  // Shared with the stages, which may outlive the pipeline
+  struct State {
+    std::string m_name;
+    std::mutex m_mutex;
+    std::condition_variable m_cvDone;
+    std::vector<StageEntry> m_stages;
+    bool m_started{false};
+  };
+
+  static void Run(const std::shared_ptr<State>& state, StageId stage);
+  static void Finish(const std::shared_ptr<State>& state, StageId stage,
+                     bool succeeded);
+
+  std::shared_ptr<State> m_state;
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_COMMITPIPELINE_H_
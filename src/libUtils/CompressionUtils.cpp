@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <snappy.h>
+
+#include "CompressionUtils.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+bool CompressionUtils::Compress(const bytes& src, unsigned int offset,
+                                bytes& dst, unsigned int minSavingPercent) {
+  if (offset >= src.size()) {
+    return false;
+  }
+
+  const size_t srcLen = src.size() - offset;
+  const char* input = reinterpret_cast<const char*>(src.data() + offset);
+
+  bytes output(snappy::MaxCompressedLength(srcLen));
+  size_t outputLen = 0;
+  snappy::RawCompress(input, srcLen, reinterpret_cast<char*>(output.data()),
+                      &outputLen);
+
+  // Skip payloads that are already dense (hashes, signatures, compressed
+  // data), the receiver would only pay for the decompression
+  if (outputLen * 100 > srcLen * (100 - min(minSavingPercent, 100u))) {
+    return false;
+  }
+
+  output.resize(outputLen);
+  dst.swap(output);
+  return true;
+}
+
+bool CompressionUtils::Decompress(const bytes& src, unsigned int offset,
+                                  bytes& dst, size_t maxSize) {
+  if (offset > src.size()) {
+    return false;
+  }
+
+  const size_t srcLen = src.size() - offset;
+  const char* input = reinterpret_cast<const char*>(src.data() + offset);
+
+  size_t outputLen = 0;
+  if (!snappy::GetUncompressedLength(input, srcLen, &outputLen)) {
+    LOG_GENERAL(WARNING, "Invalid compressed data");
+    return false;
+  }
+
+  if (outputLen > maxSize) {
+    LOG_GENERAL(WARNING, "Decompressed size " << outputLen
+                                              << " exceeds limit " << maxSize);
+    return false;
+  }
+
+  const size_t dstOffset = dst.size();
+  dst.resize(dstOffset + outputLen);
+  if (!snappy::RawUncompress(input, srcLen,
+                             reinterpret_cast<char*>(dst.data() + dstOffset))) {
+    LOG_GENERAL(WARNING, "Corrupted compressed data");
+    dst.resize(dstOffset);
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_COMPRESSIONUTILS_H_
+#define ZILLIQA_SRC_LIBUTILS_COMPRESSIONUTILS_H_
+
+#include "common/BaseType.h"
+
+class CompressionUtils {
+ public:
+  /// Compresses src. Returns false if the result would not be at least
+  /// minSavingPercent smaller than src, in which case dst is left untouched.
+  static bool Compress(const bytes& src, unsigned int offset, bytes& dst,
+                       unsigned int minSavingPercent);
+
+  /// Decompresses src starting at offset and appends the result to dst.
+  /// Returns false on corrupted input or if the result exceeds maxSize.
+  static bool Decompress(const bytes& src, unsigned int offset, bytes& dst,
+                         size_t maxSize);
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_COMPRESSIONUTILS_H_
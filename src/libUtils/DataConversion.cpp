@@ -15,10 +15,206 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include "DataConversion.h"
 
 using namespace std;
 
+namespace {
+const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+// Value of a hex digit, or -1 for any other char
+int8_t HexValue(char c) {
+  if ('0' <= c && c <= '9') {
+    return c - '0';
+  }
+  c |= 0x20;
+  if ('a' <= c && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+// The kernels below convert 16 bytes to 32 digits at a time, and leave the
+// tail to the scalar loops. Only instructions of the base instruction set
+// of the target are used, so no runtime dispatch is needed.
+#if defined(__SSE2__)
+// Nibbles of 0 to 15 to the digits '0' to '9' and 'A' to 'F'
+inline __m128i NibblesToDigits(__m128i nibbles) {
+  const __m128i letters =
+      _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)),
+                    _mm_set1_epi8('A' - '0' - 10));
+  return _mm_add_epi8(nibbles, _mm_add_epi8(_mm_set1_epi8('0'), letters));
+}
+
+size_t HexEncodeBlocks(const uint8_t* src, size_t len, char* dst) {
+  const __m128i mask = _mm_set1_epi8(0x0F);
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i hi =
+        NibblesToDigits(_mm_and_si128(_mm_srli_epi16(in, 4), mask));
+    const __m128i lo = NibblesToDigits(_mm_and_si128(in, mask));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i),
+                     _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 16),
+                     _mm_unpackhi_epi8(hi, lo));
+  }
+  return i;
+}
+
+// x <= limit for unsigned bytes
+inline __m128i LessEqual(__m128i x, __m128i limit) {
+  return _mm_cmpeq_epi8(_mm_min_epu8(x, limit), x);
+}
+
+// Digits to nibbles, with valid cleared for a byte that is not a hex digit
+inline __m128i DigitsToNibbles(__m128i digits, __m128i& valid) {
+  const __m128i number = _mm_sub_epi8(digits, _mm_set1_epi8('0'));
+  const __m128i letter = _mm_sub_epi8(_mm_or_si128(digits, _mm_set1_epi8(0x20)),
+                                      _mm_set1_epi8('a'));
+  const __m128i isNumber = LessEqual(number, _mm_set1_epi8(9));
+  const __m128i isLetter = LessEqual(letter, _mm_set1_epi8(5));
+  valid = _mm_and_si128(valid, _mm_or_si128(isNumber, isLetter));
+  return _mm_or_si128(
+      _mm_and_si128(isNumber, number),
+      _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+// Pairs of nibbles, the high one first, to 8 bytes in 16-bit lanes
+inline __m128i JoinNibbles(__m128i nibbles) {
+  return _mm_or_si128(
+      _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4),
+      _mm_srli_epi16(nibbles, 8));
+}
+
+bool HexDecodeBlocks(const char* src, size_t len, uint8_t* dst, size_t& done) {
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    __m128i valid = _mm_set1_epi8(-1);
+    const __m128i first = DigitsToNibbles(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), valid);
+    const __m128i second = DigitsToNibbles(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16)),
+        valid);
+    if (_mm_movemask_epi8(valid) != 0xFFFF) {
+      return false;
+    }
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + i / 2),
+        _mm_packus_epi16(JoinNibbles(first), JoinNibbles(second)));
+  }
+  done = i;
+  return true;
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+// Nibbles of 0 to 15 to the digits '0' to '9' and 'A' to 'F'
+inline uint8x16_t NibblesToDigits(uint8x16_t nibbles) {
+  const uint8x16_t letters =
+      vandq_u8(vcgtq_u8(nibbles, vdupq_n_u8(9)), vdupq_n_u8('A' - '0' - 10));
+  return vaddq_u8(nibbles, vaddq_u8(vdupq_n_u8('0'), letters));
+}
+
+size_t HexEncodeBlocks(const uint8_t* src, size_t len, char* dst) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const uint8x16_t in = vld1q_u8(src + i);
+    uint8x16x2_t out;
+    out.val[0] = NibblesToDigits(vshrq_n_u8(in, 4));
+    out.val[1] = NibblesToDigits(vandq_u8(in, vdupq_n_u8(0x0F)));
+    vst2q_u8(reinterpret_cast<uint8_t*>(dst + 2 * i), out);
+  }
+  return i;
+}
+
+// Digits to nibbles, with valid cleared for a byte that is not a hex digit
+inline uint8x16_t DigitsToNibbles(uint8x16_t digits, uint8x16_t& valid) {
+  const uint8x16_t number = vsubq_u8(digits, vdupq_n_u8('0'));
+  const uint8x16_t letter =
+      vsubq_u8(vorrq_u8(digits, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+  const uint8x16_t isNumber = vcleq_u8(number, vdupq_n_u8(9));
+  const uint8x16_t isLetter = vcleq_u8(letter, vdupq_n_u8(5));
+  valid = vandq_u8(valid, vorrq_u8(isNumber, isLetter));
+  return vbslq_u8(isNumber, number, vaddq_u8(letter, vdupq_n_u8(10)));
+}
+
+bool HexDecodeBlocks(const char* src, size_t len, uint8_t* dst, size_t& done) {
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    // Splits the high and the low digits of each byte
+    const uint8x16x2_t in = vld2q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    uint8x16_t valid = vdupq_n_u8(0xFF);
+    const uint8x16_t hi = DigitsToNibbles(in.val[0], valid);
+    const uint8x16_t lo = DigitsToNibbles(in.val[1], valid);
+    if (vminvq_u8(valid) != 0xFF) {
+      return false;
+    }
+    vst1q_u8(dst + i / 2, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+  }
+  done = i;
+  return true;
+}
+#else
+size_t HexEncodeBlocks(const uint8_t*, size_t, char*) { return 0; }
+
+bool HexDecodeBlocks(const char*, size_t, uint8_t*, size_t& done) {
+  done = 0;
+  return true;
+}
+#endif
+
+// Decodes into the leading bytes of d, keeping the first SIZE bytes of a
+// longer input
+template <size_t SIZE>
+bool HexStrToArray(const string& hex_input, array<uint8_t, SIZE>& d) {
+  d = {{0}};
+  if (hex_input.size() <= 2 * SIZE) {
+    if (DataConversion::HexDecode(hex_input.data(), hex_input.size(),
+                                  d.data())) {
+      return true;
+    }
+    d = {{0}};
+    return false;
+  }
+  bytes v(hex_input.size() / 2);
+  if (!DataConversion::HexDecode(hex_input.data(), hex_input.size(),
+                                 v.data())) {
+    return false;
+  }
+  copy(v.begin(), v.begin() + SIZE, d.begin());
+  return true;
+}
+}  // namespace
+
+void DataConversion::HexEncode(const uint8_t* src, size_t len, char* dst) {
+  for (size_t i = HexEncodeBlocks(src, len, dst); i < len; i++) {
+    dst[2 * i] = HEX_DIGITS[src[i] >> 4];
+    dst[2 * i + 1] = HEX_DIGITS[src[i] & 0x0F];
+  }
+}
+
+bool DataConversion::HexDecode(const char* src, size_t len, uint8_t* dst) {
+  size_t i = 0;
+  if (len % 2 != 0 || !HexDecodeBlocks(src, len, dst, i)) {
+    return false;
+  }
+  for (; i < len; i += 2) {
+    const int8_t hi = HexValue(src[i]);
+    const int8_t lo = HexValue(src[i + 1]);
+    if (hi < 0 || lo < 0) {
+      return false;
+    }
+    dst[i / 2] = (hi << 4) | lo;
+  }
+  return true;
+}
+
 bool DataConversion::HexStringToUint64(const std::string& s, uint64_t* res) {
   try {
     *res = std::stoull(s, nullptr, 16);
@@ -33,11 +229,9 @@ bool DataConversion::HexStringToUint64(const std::string& s, uint64_t* res) {
 }
 
 bool DataConversion::HexStrToUint8Vec(const string& hex_input, bytes& out) {
-  try {
+  out.resize(hex_input.size() / 2);
+  if (!HexDecode(hex_input.data(), hex_input.size(), out.data())) {
     out.clear();
-    boost::algorithm::unhex(hex_input.begin(), hex_input.end(),
-                            back_inserter(out));
-  } catch (exception& e) {
     LOG_GENERAL(WARNING, "Failed HexStrToUint8Vec conversion");
     return false;
   }
@@ -46,10 +240,7 @@ bool DataConversion::HexStrToUint8Vec(const string& hex_input, bytes& out) {
 
 bool DataConversion::HexStrToStdArray(const string& hex_input,
                                       array<uint8_t, 32>& d) {
-  d = {{0}};
-  bytes v;
-  if (HexStrToUint8Vec(hex_input, v)) {
-    copy(v.begin(), v.begin() + min((int)v.size(), 32), d.begin());
+  if (HexStrToArray(hex_input, d)) {
     return true;
   }
   LOG_GENERAL(WARNING, "Failed HexStrToStdArray conversion");
@@ -58,10 +249,7 @@ bool DataConversion::HexStrToStdArray(const string& hex_input,
 
 bool DataConversion::HexStrToStdArray64(const string& hex_input,
                                         array<uint8_t, 64>& d) {
-  d = {{0}};
-  bytes v;
-  if (HexStrToUint8Vec(hex_input, v)) {
-    copy(v.begin(), v.begin() + min((int)v.size(), 64), d.begin());
+  if (HexStrToArray(hex_input, d)) {
     return true;
   }
   LOG_GENERAL(WARNING, "Failed HexStrToStdArray conversion");
@@ -69,26 +257,19 @@ bool DataConversion::HexStrToStdArray64(const string& hex_input,
 }
 
 bool DataConversion::Uint8VecToHexStr(const bytes& hex_vec, string& str) {
-  try {
-    str = "";
-    boost::algorithm::hex(hex_vec.begin(), hex_vec.end(), back_inserter(str));
-  } catch (exception& e) {
-    LOG_GENERAL(WARNING, "Failed Uint8VecToHexStr conversion");
-    return false;
-  }
+  str.resize(2 * hex_vec.size());
+  HexEncode(hex_vec.data(), hex_vec.size(), &str[0]);
   return true;
 }
 
 bool DataConversion::Uint8VecToHexStr(const bytes& hex_vec, unsigned int offset,
                                       unsigned int len, string& str) {
-  try {
-    str = "";
-    boost::algorithm::hex(hex_vec.begin() + offset,
-                          hex_vec.begin() + offset + len, back_inserter(str));
-  } catch (exception& e) {
+  if (offset + len < offset || offset + len > hex_vec.size()) {
     LOG_GENERAL(WARNING, "Failed Uint8VecToHexStr conversion");
     return false;
   }
+  str.resize(2 * len);
+  HexEncode(hex_vec.data() + offset, len, &str[0]);
   return true;
 }
 
@@ -96,28 +277,14 @@ bool DataConversion::SerializableToHexStr(const Serializable& input,
                                           string& str) {
   bytes tmp;
   input.Serialize(tmp, 0);
-  try {
-    str = "";
-    boost::algorithm::hex(tmp.begin(), tmp.end(), back_inserter(str));
-  } catch (exception& e) {
-    LOG_GENERAL(WARNING, "Failed SerializableToHexStr conversion");
-    return false;
-  }
-  return true;
+  return Uint8VecToHexStr(tmp, str);
 }
 
 bool DataConversion::SerializableToHexStr(const SerializableCrypto& input,
                                           string& str) {
   bytes tmp;
   input.Serialize(tmp, 0);
-  try {
-    str = "";
-    boost::algorithm::hex(tmp.begin(), tmp.end(), back_inserter(str));
-  } catch (exception& e) {
-    LOG_GENERAL(WARNING, "Failed SerializableToHexStr conversion");
-    return false;
-  }
-  return true;
+  return Uint8VecToHexStr(tmp, str);
 }
 
 uint16_t DataConversion::charArrTo16Bits(const bytes& hex_arr) {
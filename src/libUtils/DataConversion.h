@@ -58,17 +58,18 @@ class DataConversion {
   template <size_t SIZE>
   static bool charArrToHexStr(const std::array<uint8_t, SIZE>& hex_arr,
                               std::string& str) {
-    try {
-      str = "";
-      boost::algorithm::hex(hex_arr.begin(), hex_arr.end(),
-                            std::back_inserter(str));
-    } catch (std::exception& e) {
-      LOG_GENERAL(WARNING, "Failed charArrToHexStr conversion");
-      return false;
-    }
+    str.resize(2 * SIZE);
+    HexEncode(hex_arr.data(), SIZE, &str[0]);
     return true;
   }
 
+  /// Writes the 2 * len uppercase hex digits of src to dst.
+  static void HexEncode(const uint8_t* src, size_t len, char* dst);
+
+  /// Writes the len / 2 bytes given by the hex digits of src to dst. Returns
+  /// false if len is odd or src has a non hex digit.
+  static bool HexDecode(const char* src, size_t len, uint8_t* dst);
+
   /// Converts a serializable object to alphanumeric hex string.
   static bool SerializableToHexStr(const Serializable& input, std::string& str);
 
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <thread>
+
+#include "DetachedExecutor.h"
+#include "common/Constants.h"
+#include "libUtils/Logger.h"
+#include "libUtils/ThreadAffinity.h"
+
+using namespace std;
+
+namespace {
+// Retry limit for starting a thread
+const unsigned int MAX_START_ATTEMPTS = 3;
+}  // namespace
+
+const string DetachedExecutor::PERSISTENCE_LANE = "Persistence";
+
+DetachedExecutor::DetachedExecutor() : m_state(make_shared<State>()) {
+  m_state->m_maxIdleThreads = DETACHED_IDLE_THREADS;
+  m_state->m_idleTimeout = chrono::seconds(DETACHED_IDLE_TIMEOUT_IN_SECONDS);
+  AddLane(PERSISTENCE_LANE, DETACHED_PERSISTENCE_THREADS);
+}
+
+void DetachedExecutor::Run(Task task) { Dispatch(m_state, move(task)); }
+
+void DetachedExecutor::Run(const string& lane, Task task) {
+  {
+    lock_guard<mutex> g(m_state->m_mutex);
+    auto it = m_state->m_lanes.find(lane);
+    if (it != m_state->m_lanes.end()) {
+      if (it->second.m_running >= it->second.m_maxThreads) {
+        it->second.m_queued.emplace_back(move(task));
+        return;
+      }
+      it->second.m_running++;
+    } else {
+      LOG_GENERAL(WARNING, "Unknown lane " << lane);
+    }
+  }
+
+  auto state = m_state;
+  Dispatch(m_state, [state, lane, task]() { RunLane(state, lane, task); });
+}
+
+void DetachedExecutor::RunLongRunning(const string& name, Task task) {
+  {
+    lock_guard<mutex> g(m_state->m_mutex);
+    m_state->m_longRunningThreads++;
+  }
+
+  auto state = m_state;
+  if (StartThread([state, name, task]() {
+        ThreadAffinity::Apply(name);
+        task();
+        lock_guard<mutex> g(state->m_mutex);
+        state->m_longRunningThreads--;
+      })) {
+    return;
+  }
+
+  {
+    lock_guard<mutex> g(m_state->m_mutex);
+    m_state->m_longRunningThreads--;
+  }
+  LOG_GENERAL(WARNING, "Running " << name << " on a kept thread");
+  Run(move(task));
+}
+
+void DetachedExecutor::AddLane(const string& lane, unsigned int maxThreads) {
+  lock_guard<mutex> g(m_state->m_mutex);
+  m_state->m_lanes[lane].m_maxThreads = max(maxThreads, 1u);
+}
+
+DetachedExecutor::Stats DetachedExecutor::GetStats() {
+  lock_guard<mutex> g(m_state->m_mutex);
+  Stats stats{};
+  stats.m_threads = m_state->m_threads;
+  stats.m_idleThreads = m_state->m_idleThreads;
+  stats.m_longRunningThreads = m_state->m_longRunningThreads;
+  stats.m_threadsStarted = m_state->m_threadsStarted;
+  stats.m_tasksRun = m_state->m_tasksRun;
+  for (const auto& lane : m_state->m_lanes) {
+    stats.m_laneTasksQueued += lane.second.m_queued.size();
+  }
+  return stats;
+}
+
+void DetachedExecutor::Dispatch(const shared_ptr<State>& state, Task task) {
+  bool startThread = false;
+  {
+    lock_guard<mutex> g(state->m_mutex);
+    state->m_tasks.emplace_back(move(task));
+    // Every queued task needs an idle thread to take it
+    startThread = state->m_tasks.size() > state->m_idleThreads;
+    if (startThread) {
+      state->m_threads++;
+      state->m_threadsStarted++;
+    }
+  }
+
+  if (!startThread) {
+    state->m_cvTask.notify_one();
+    return;
+  }
+
+  if (!StartThread([state]() { Work(state); })) {
+    // The task waits for the next thread to be free
+    lock_guard<mutex> g(state->m_mutex);
+    state->m_threads--;
+    state->m_threadsStarted--;
+  }
+}
+
+void DetachedExecutor::RunLane(const shared_ptr<State>& state,
+                               const string& lane, Task task) {
+  while (true) {
+    task();
+
+    lock_guard<mutex> g(state->m_mutex);
+    auto it = state->m_lanes.find(lane);
+    if (it == state->m_lanes.end()) {
+      return;
+    }
+    if (it->second.m_queued.empty()) {
+      it->second.m_running--;
+      return;
+    }
+    task = move(it->second.m_queued.front());
+    it->second.m_queued.pop_front();
+  }
+}
+
+void DetachedExecutor::Work(const shared_ptr<State>& state) {
+  unique_lock<mutex> lock(state->m_mutex);
+  while (true) {
+    if (state->m_tasks.empty()) {
+      state->m_idleThreads++;
+      const bool hasTask = state->m_cvTask.wait_for(
+          lock, state->m_idleTimeout,
+          [&state]() { return !state->m_tasks.empty(); });
+      state->m_idleThreads--;
+      if (!hasTask) {
+        // Ends only if enough threads are left idle
+        if (state->m_idleThreads >= state->m_maxIdleThreads) {
+          state->m_threads--;
+          return;
+        }
+        continue;
+      }
+    }
+
+    Task task = move(state->m_tasks.front());
+    state->m_tasks.pop_front();
+    lock.unlock();
+
+    task();
+    task = nullptr;
+
+    lock.lock();
+    state->m_tasksRun++;
+  }
+}
+
+bool DetachedExecutor::StartThread(const function<void()>& func) {
+  for (unsigned int i = 0; i < MAX_START_ATTEMPTS; i++) {
+    try {
+      thread(func).detach();
+      return true;
+    } catch (const system_error& e) {
+      LOG_GENERAL(WARNING, i << " times tried. Caught system_error with code "
+                             << e.code() << " meaning " << e.what());
+      this_thread::sleep_for(chrono::milliseconds(100));
+    }
+  }
+  return false;
+}
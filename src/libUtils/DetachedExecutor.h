@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_DETACHEDEXECUTOR_H_
+#define ZILLIQA_SRC_LIBUTILS_DETACHEDEXECUTOR_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "common/Singleton.h"
+
+/// Runs the background tasks of DetachedFunction on threads that are kept
+/// once started. A task runs at once, on an idle thread if there is one and on
+/// a new thread otherwise, so that a task waiting on another never blocks it.
+/// A named lane runs at most a given number of its tasks at once on these
+/// threads and queues the others. A task that never ends, such as a message
+/// pump, gets a thread of its own instead.
+class DetachedExecutor : public Singleton<DetachedExecutor> {
+ public:
+  using Task = std::function<void()>;
+
+  /// Lane of the tasks writing the state to disk
+  static const std::string PERSISTENCE_LANE;
+
+  struct Stats {
+    unsigned int m_threads;
+    unsigned int m_idleThreads;
+    unsigned int m_longRunningThreads;
+    uint64_t m_threadsStarted;
+    uint64_t m_tasksRun;
+    unsigned int m_laneTasksQueued;
+  };
+
+  DetachedExecutor();
+
+  /// Runs task on a kept thread
+  void Run(Task task);
+
+  /// Runs task on lane, after the tasks of lane queued before it if lane
+  /// already runs as many tasks as it may
+  void Run(const std::string& lane, Task task);
+
+  /// Runs task, which is not expected to end, on a thread of its own
+  void RunLongRunning(const std::string& name, Task task);
+
+  /// Lets lane run up to maxThreads of its tasks at once
+  void AddLane(const std::string& lane, unsigned int maxThreads);
+
+  Stats GetStats();
+
+ private:
+  struct Lane {
+    unsigned int m_maxThreads;
+    unsigned int m_running;
+    std::deque<Task> m_queued;
+  };
+
+  // Shared with the threads, which may outlive the executor at exit
+  struct State {
+    std::mutex m_mutex;
+    std::condition_variable m_cvTask;
+    std::deque<Task> m_tasks;
+    std::map<std::string, Lane> m_lanes;
+    unsigned int m_threads{0};
+    unsigned int m_idleThreads{0};
+    unsigned int m_longRunningThreads{0};
+    uint64_t m_threadsStarted{0};
+    uint64_t m_tasksRun{0};
+    unsigned int m_maxIdleThreads{0};
+    std::chrono::seconds m_idleTimeout{0};
+  };
+
+  static void Dispatch(const std::shared_ptr<State>& state, Task task);
+  static void RunLane(const std::shared_ptr<State>& state,
+                      const std::string& lane, Task task);
+  static void Work(const std::shared_ptr<State>& state);
+  static bool StartThread(const std::function<void()>& func);
+
+  std::shared_ptr<State> m_state;
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_DETACHEDEXECUTOR_H_
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "EpochPerf.h"
+#include "common/Constants.h"
+
+using namespace std;
+
+EpochPerf::Scope::Scope(Phase phase)
+    : m_phase(phase), m_start(chrono::steady_clock::now()) {}
+
+EpochPerf::Scope::~Scope() {
+  if (!ENABLE_EPOCH_PERF) {
+    return;
+  }
+  EpochPerf::GetInstance().Add(
+      m_phase, chrono::duration_cast<chrono::microseconds>(
+                   chrono::steady_clock::now() - m_start)
+                   .count());
+}
+
+EpochPerf& EpochPerf::GetInstance() {
+  static EpochPerf ep;
+  return ep;
+}
+
+void EpochPerf::Begin(Phase phase) {
+  lock_guard<mutex> g(m_mutex);
+  m_phaseStart[phase] = chrono::steady_clock::now();
+  m_phaseBegun[phase] = true;
+}
+
+void EpochPerf::End(Phase phase) {
+  lock_guard<mutex> g(m_mutex);
+  if (!m_phaseBegun[phase]) {
+    return;
+  }
+  m_phaseBegun[phase] = false;
+  m_phaseTime[phase] += chrono::duration_cast<chrono::microseconds>(
+                            chrono::steady_clock::now() - m_phaseStart[phase])
+                            .count();
+}
+
+void EpochPerf::Add(Phase phase, uint64_t timeInMicro) {
+  lock_guard<mutex> g(m_mutex);
+  m_phaseTime[phase] += timeInMicro;
+}
+
+void EpochPerf::AddTxns(uint64_t count) {
+  lock_guard<mutex> g(m_mutex);
+  m_txnCount += count;
+}
+
+void EpochPerf::AddBytesSent(uint64_t bytes) { m_bytesSent += bytes; }
+
+DiagnosticDataEpochPerf EpochPerf::TakeRecord(uint64_t dsBlockNum) {
+  DiagnosticDataEpochPerf record;
+  record.dsBlockNum = dsBlockNum;
+  record.bytesSent = m_bytesSent.exchange(0);
+
+  // The phases begun and not ended are left running into the next epoch
+  lock_guard<mutex> g(m_mutex);
+  record.powTime = m_phaseTime[POW];
+  record.dsBlockConsensusTime = m_phaseTime[DS_BLOCK_CONSENSUS];
+  record.txnProcessingTime = m_phaseTime[TXN_PROCESSING];
+  record.microBlockConsensusTime = m_phaseTime[MICROBLOCK_CONSENSUS];
+  record.finalBlockConsensusTime = m_phaseTime[FINAL_BLOCK_CONSENSUS];
+  record.commitTime = m_phaseTime[COMMIT];
+  record.txnCount = m_txnCount;
+  m_phaseTime.fill(0);
+  m_txnCount = 0;
+  return record;
+}
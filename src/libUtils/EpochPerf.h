@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_EPOCHPERF_H_
+#define ZILLIQA_SRC_LIBUTILS_EPOCHPERF_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <tuple>
+
+/// Time spent in each phase of a Tx epoch, in microseconds, and the
+/// transactions and bytes sent in it. A phase that spans epochs is counted in
+/// the epoch it ends in. The consensus phases include the transactions that
+/// the node processes while they run.
+struct DiagnosticDataEpochPerf {
+  uint64_t dsBlockNum{};
+  uint64_t powTime{};
+  uint64_t dsBlockConsensusTime{};
+  uint64_t txnProcessingTime{};
+  uint64_t microBlockConsensusTime{};
+  uint64_t finalBlockConsensusTime{};
+  uint64_t commitTime{};  // Epoch commit and state written to disk
+  uint64_t txnCount{};    // Txns of the final block
+  uint64_t bytesSent{};   // Bytes on the wire, headers included
+
+  bool operator==(const DiagnosticDataEpochPerf& r) const {
+    return std::tie(dsBlockNum, powTime, dsBlockConsensusTime,
+                    txnProcessingTime, microBlockConsensusTime,
+                    finalBlockConsensusTime, commitTime, txnCount,
+                    bytesSent) ==
+           std::tie(r.dsBlockNum, r.powTime, r.dsBlockConsensusTime,
+                    r.txnProcessingTime, r.microBlockConsensusTime,
+                    r.finalBlockConsensusTime, r.commitTime, r.txnCount,
+                    r.bytesSent);
+  }
+};
+
+/// Collects the DiagnosticDataEpochPerf of the current epoch. The phases are
+/// timed either between Begin and End, for those that start and finish in
+/// different handlers, or with a Scope.
+class EpochPerf {
+ public:
+  enum Phase : unsigned char {
+    POW,
+    DS_BLOCK_CONSENSUS,
+    TXN_PROCESSING,
+    MICROBLOCK_CONSENSUS,
+    FINAL_BLOCK_CONSENSUS,
+    COMMIT,
+    PHASE_COUNT
+  };
+
+  /// Adds the time of phase from its creation to its destruction, if
+  /// ENABLE_EPOCH_PERF
+  class Scope {
+    Phase m_phase;
+    std::chrono::steady_clock::time_point m_start;
+
+   public:
+    explicit Scope(Phase phase);
+    ~Scope();
+  };
+
+  /// Returns the singleton EpochPerf instance.
+  static EpochPerf& GetInstance();
+
+  /// Marks the start of phase, replacing any earlier unfinished one
+  void Begin(Phase phase);
+
+  /// Adds the time of phase since its Begin, if it was begun
+  void End(Phase phase);
+
+  void Add(Phase phase, uint64_t timeInMicro);
+  void AddTxns(uint64_t count);
+  void AddBytesSent(uint64_t bytes);
+
+  /// Returns the record of the epoch so far, and starts the next one
+  DiagnosticDataEpochPerf TakeRecord(uint64_t dsBlockNum);
+
+ private:
+  std::mutex m_mutex;
+  std::array<uint64_t, PHASE_COUNT> m_phaseTime{};
+  std::array<std::chrono::steady_clock::time_point, PHASE_COUNT> m_phaseStart{};
+  std::array<bool, PHASE_COUNT> m_phaseBegun{};
+  uint64_t m_txnCount{0};
+  std::atomic<uint64_t> m_bytesSent{0};
+
+  EpochPerf() = default;
+  ~EpochPerf() = default;
+
+  EpochPerf(EpochPerf const&) = delete;
+  void operator=(EpochPerf const&) = delete;
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_EPOCHPERF_H_
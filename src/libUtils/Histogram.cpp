@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "Histogram.h"
+
+using namespace std;
+
+Histogram::Histogram() : m_counts(BUCKET_COUNT, 0) {}
+
+unsigned int Histogram::GetBucketIndex(uint64_t value) {
+  if (value < 2 * SUB_BUCKET_COUNT) {
+    return value;
+  }
+  // Drop the low bits so that the mantissa falls in [SUB_BUCKET_COUNT,
+  // 2 * SUB_BUCKET_COUNT)
+  const unsigned int msb = 63 - __builtin_clzll(value);
+  const unsigned int shift = msb - SUB_BUCKET_BITS;
+  return shift * SUB_BUCKET_COUNT + (value >> shift);
+}
+
+uint64_t Histogram::GetBucketLowest(unsigned int index) {
+  if (index < 2 * SUB_BUCKET_COUNT) {
+    return index;
+  }
+  const unsigned int shift = index / SUB_BUCKET_COUNT - 1;
+  return static_cast<uint64_t>(index - shift * SUB_BUCKET_COUNT) << shift;
+}
+
+uint64_t Histogram::GetBucketHighest(unsigned int index) {
+  if (index + 1 >= BUCKET_COUNT) {
+    return UINT64_MAX;
+  }
+  return GetBucketLowest(index + 1) - 1;
+}
+
+void Histogram::Record(uint64_t value) {
+  m_counts.at(GetBucketIndex(value))++;
+  m_totalCount++;
+  m_min = min(m_min, value);
+  m_max = max(m_max, value);
+  m_sum += value;
+}
+
+void Histogram::Reset() {
+  fill(m_counts.begin(), m_counts.end(), 0);
+  m_totalCount = 0;
+  m_min = UINT64_MAX;
+  m_max = 0;
+  m_sum = 0;
+}
+
+double Histogram::GetMean() const {
+  return (m_totalCount == 0) ? 0 : m_sum / m_totalCount;
+}
+
+uint64_t Histogram::GetPercentile(double percentile) const {
+  if (m_totalCount == 0) {
+    return 0;
+  }
+
+  percentile = min(max(percentile, 0.0), 100.0);
+  const uint64_t target = max<uint64_t>(
+      1, static_cast<uint64_t>(ceil(percentile / 100.0 * m_totalCount)));
+
+  uint64_t seen = 0;
+  for (unsigned int i = 0; i < BUCKET_COUNT; i++) {
+    seen += m_counts[i];
+    if (seen >= target) {
+      // Never report beyond what was actually recorded
+      return min(GetBucketHighest(i), m_max);
+    }
+  }
+
+  return m_max;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_HISTOGRAM_H_
+#define ZILLIQA_SRC_LIBUTILS_HISTOGRAM_H_
+
+#include <cstdint>
+#include <vector>
+
+/// Log-linear histogram of unsigned values, in the style of HdrHistogram.
+/// Every power of two range is split into SUB_BUCKET_COUNT equal buckets, so
+/// the relative error of a reported percentile stays below 1/SUB_BUCKET_COUNT
+/// for any magnitude. Not thread safe; callers provide locking.
+class Histogram {
+  static const unsigned int SUB_BUCKET_BITS = 4;
+  static const unsigned int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+  static const unsigned int BUCKET_COUNT =
+      (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+  std::vector<uint64_t> m_counts;
+  uint64_t m_totalCount{0};
+  uint64_t m_min{UINT64_MAX};
+  uint64_t m_max{0};
+  double m_sum{0};
+
+  static unsigned int GetBucketIndex(uint64_t value);
+  static uint64_t GetBucketLowest(unsigned int index);
+  static uint64_t GetBucketHighest(unsigned int index);
+
+ public:
+  Histogram();
+
+  void Record(uint64_t value);
+  void Reset();
+
+  uint64_t GetCount() const { return m_totalCount; }
+  uint64_t GetMin() const { return (m_totalCount == 0) ? 0 : m_min; }
+  uint64_t GetMax() const { return m_max; }
+  double GetMean() const;
+
+  /// Returns the highest value that is equivalent (within bucket precision) to
+  /// the value at the given percentile (0-100).
+  uint64_t GetPercentile(double percentile) const;
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_HISTOGRAM_H_
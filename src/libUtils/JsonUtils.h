@@ -25,9 +25,11 @@
 
 class JSONUtils {
   std::unique_ptr<Json::StreamWriter> m_writer;
+  std::unique_ptr<Json::StreamWriter> m_compactWriter;
   std::unique_ptr<Json::CharReader> m_reader;
 
   std::mutex m_mutexWriter;
+  std::mutex m_mutexCompactWriter;
   std::mutex m_mutexReader;
 
   JSONUtils() {
@@ -39,6 +41,10 @@ class JSONUtils {
     writeBuilder["indentaion"] = "";
     m_writer =
         std::unique_ptr<Json::StreamWriter>(writeBuilder.newStreamWriter());
+
+    writeBuilder["indentation"] = "";
+    m_compactWriter =
+        std::unique_ptr<Json::StreamWriter>(writeBuilder.newStreamWriter());
   }
 
   ~JSONUtils(){};
@@ -75,6 +81,14 @@ class JSONUtils {
     return oss.str();
   }
 
+  /// Convert a Json object to string without any whitespace
+  std::string convertJsontoCompactStr(const Json::Value& _json) {
+    std::ostringstream oss;
+    std::lock_guard<std::mutex> g(m_mutexCompactWriter);
+    m_compactWriter->write(_json, &oss);
+    return oss.str();
+  }
+
   /// Write a Json object to target file
   void writeJsontoFile(const std::string& path, const Json::Value& _json) {
     std::ofstream os(path);
@@ -23,6 +23,7 @@
 #include <boost/filesystem.hpp>
 #include <cstring>
 #include <iostream>
+#include <thread>
 using namespace std;
 using namespace g3;
 
@@ -44,6 +45,33 @@ inline pid_t getCurrentPid() {
   return 0;
 #endif
 }
+
+// How often the background thread writes the queued logs
+const chrono::milliseconds ASYNC_WRITE_INTERVAL(10);
+
+const LEVELS& GetLevel(int value) {
+  for (const LEVELS* level : {&DEBUG, &INFO, &WARNING, &FATAL}) {
+    if (level->value == value) {
+      return *level;
+    }
+  }
+  return INFO;
+}
+
+LogRecord MakeRecord(LogRecord::Kind kind, const LEVELS& level,
+                     const char* msg, const unsigned int linenum,
+                     const char* filename, const char* function) {
+  LogRecord record;
+  record.m_kind = kind;
+  record.m_level = level.value;
+  record.m_tid = getCurrentPid();
+  record.m_time = chrono::system_clock::now();
+  record.m_line = linenum;
+  LogRecord::CopyTail(record.m_file, filename);
+  LogRecord::CopyHead(record.m_function, function);
+  record.m_msg = msg;
+  return record;
+}
 }  // namespace
 
 const streampos Logger::MAX_FILE_SIZE =
@@ -82,7 +110,16 @@ Logger::Logger(const char* prefix, bool log_to_file, const char* logpath,
   }
 }
 
-Logger::~Logger() { m_logFile.close(); }
+Logger::~Logger() {
+  // The queued logs are written before the file goes. Threads that still log
+  // write directly, once those that took the buffer are done with it.
+  auto asyncBuffer = atomic_exchange(&m_asyncBuffer, {});
+  while (asyncBuffer && asyncBuffer.use_count() > 1) {
+    this_thread::yield();
+  }
+  asyncBuffer.reset();
+  m_logFile.close();
+}
 
 void Logger::checkLog() {
   std::ifstream in(m_fileName.c_str(),
@@ -124,6 +161,12 @@ Logger& Logger::GetLogger(const char* fname_prefix, bool log_to_file,
   return logger;
 }
 
+Logger& Logger::GetMainLogger() {
+  static Logger& logger =
+      GetLogger(NULL, true, boost::filesystem::absolute("./").string().c_str());
+  return logger;
+}
+
 Logger& Logger::GetStateLogger(const char* fname_prefix, bool log_to_file,
                                const char* logpath, streampos max_file_size) {
   static Logger logger(fname_prefix, log_to_file, logpath, max_file_size);
@@ -151,140 +194,105 @@ void Logger::LogState(const char* msg) {
 void Logger::LogGeneral(const LEVELS& level, const char* msg,
                         const unsigned int linenum, const char* filename,
                         const char* function) {
-  if (IsG3Log()) {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-    LOG(level) << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-               << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-               << PAD(get_ms(cur), 3, '0') << "]["
-               << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN)
-               << "][" << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg;
+  if (IsG3Log() && !g3::logLevel(level)) {
     return;
   }
-
-  lock_guard<mutex> guard(m);
-
-  if (m_logToFile) {
-    checkLog();
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-    m_logFile << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-              << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-              << PAD(get_ms(cur), 3, '0') << "]["
-              << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-              << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg << endl
-              << flush;
-  } else {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-    cout << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-         << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-         << PAD(get_ms(cur), 3, '0') << "]["
-         << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-         << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg << endl
-         << flush;
-  }
+  Submit(MakeRecord(LogRecord::GENERAL, level, msg, linenum, filename,
+                    function));
 }
 
-void Logger::LogEpoch([[gnu::unused]] const LEVELS& level, const char* msg,
-                      const char* epoch, const unsigned int linenum,
-                      const char* filename, const char* function) {
-  lock_guard<mutex> guard(m);
-
-  if (m_logToFile) {
-    checkLog();
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-    m_logFile << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-              << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-              << PAD(get_ms(cur), 3, '0') << "]["
-              << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-              << LIMIT(function, MAX_FUNCNAME_LEN) << "] [Epoch " << epoch
-              << "] " << msg << endl
-              << flush;
-  } else {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-    cout << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-         << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-         << PAD(get_ms(cur), 3, '0') << "]["
-         << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-         << LIMIT(function, MAX_FUNCNAME_LEN) << "] [Epoch " << epoch << "] "
-         << msg << endl
-         << flush;
+void Logger::LogEpoch(const LEVELS& level, const char* msg, const char* epoch,
+                      const unsigned int linenum, const char* filename,
+                      const char* function) {
+  if (IsG3Log() && !g3::logLevel(level)) {
+    return;
   }
+  auto record =
+      MakeRecord(LogRecord::EPOCH, level, msg, linenum, filename, function);
+  LogRecord::CopyHead(record.m_epoch, epoch);
+  Submit(move(record));
 }
 
-void Logger::LogPayload([[gnu::unused]] const LEVELS& level, const char* msg,
+void Logger::LogPayload(const LEVELS& level, const char* msg,
                         const bytes& payload, size_t max_bytes_to_display,
                         const unsigned int linenum, const char* filename,
                         const char* function) {
-  std::unique_ptr<char[]> payload_string;
-  GetPayloadS(payload, max_bytes_to_display, payload_string);
+  if (IsG3Log() && !g3::logLevel(level)) {
+    return;
+  }
+  auto record =
+      MakeRecord(LogRecord::PAYLOAD, level, msg, linenum, filename, function);
+  record.m_payload.assign(
+      payload.begin(),
+      payload.begin() + min(payload.size(), max_bytes_to_display));
+  record.m_payloadSize = payload.size();
+  Submit(move(record));
+}
+
+void Logger::Submit(LogRecord&& record) {
+  const auto asyncBuffer = atomic_load(&m_asyncBuffer);
+  if (asyncBuffer) {
+    if (record.m_level != FATAL.value) {
+      asyncBuffer->Push(move(record));
+      return;
+    }
+    // Everything logged before a fatal log is out before it
+    asyncBuffer->Flush();
+  }
+  Write(record);
+}
+
+void Logger::Write(const LogRecord& record) {
+  auto cur_time_t = chrono::system_clock::to_time_t(record.m_time);
+  auto file_and_line = std::string(std::string(record.m_file.data()) + ":" +
+                                   std::to_string(record.m_line));
+  ostringstream oss;
+  oss << "[" << PAD(record.m_tid, TID_LEN, ' ') << "]["
+      << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
+      << PAD(get_ms(record.m_time), 3, '0') << "]["
+      << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
+      << LIMIT(record.m_function.data(), MAX_FUNCNAME_LEN) << "] ";
+  if (record.m_kind == LogRecord::EPOCH) {
+    oss << "[Epoch " << record.m_epoch.data() << "] ";
+  }
+  oss << record.m_msg;
+  if (record.m_kind == LogRecord::PAYLOAD) {
+    std::unique_ptr<char[]> payload_string;
+    GetPayloadS(record.m_payload, record.m_payload.size(), payload_string);
+    oss << " (Len=" << record.m_payloadSize << "): " << payload_string.get();
+    if (record.m_payloadSize > record.m_payload.size()) {
+      oss << "...";
+    }
+  }
+
+  if (IsG3Log()) {
+    LOG(GetLevel(record.m_level)) << oss.str();
+    return;
+  }
+
   lock_guard<mutex> guard(m);
 
   if (m_logToFile) {
     checkLog();
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-
-    if (payload.size() > max_bytes_to_display) {
-      m_logFile << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-                << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-                << PAD(get_ms(cur), 3, '0') << "]["
-                << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN)
-                << "][" << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg
-                << " (Len=" << payload.size() << "): " << payload_string.get()
-                << "..." << endl
-                << flush;
-    } else {
-      m_logFile << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-                << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-                << PAD(get_ms(cur), 3, '0') << "]["
-                << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN)
-                << "][" << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg
-                << " (Len=" << payload.size() << "): " << payload_string.get()
-                << endl
-                << flush;
-    }
+    m_logFile << oss.str() << endl << flush;
   } else {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
+    cout << oss.str() << endl << flush;
+  }
+}
 
-    if (payload.size() > max_bytes_to_display) {
-      cout << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-           << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-           << PAD(get_ms(cur), 3, '0') << "]["
-           << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-           << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg
-           << " (Len=" << payload.size() << "): " << payload_string.get()
-           << "..." << endl
-           << flush;
-    } else {
-      cout << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-           << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-           << PAD(get_ms(cur), 3, '0') << "]["
-           << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-           << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg
-           << " (Len=" << payload.size() << "): " << payload_string.get()
-           << endl
-           << flush;
-    }
+void Logger::StartAsync(size_t bufferSize) {
+  if (bufferSize == 0 || IsAsync()) {
+    return;
   }
+  auto asyncBuffer = make_shared<AsyncLogBuffer>(
+      bufferSize, [this](const LogRecord& record) { Write(record); },
+      ASYNC_WRITE_INTERVAL, WARNING.value);
+  atomic_store(&m_asyncBuffer, asyncBuffer);
+}
+
+uint64_t Logger::GetDroppedCount() const {
+  const auto asyncBuffer = atomic_load(&m_asyncBuffer);
+  return asyncBuffer ? asyncBuffer->GetDroppedCount() : 0;
 }
 
 void Logger::LogEpochInfo(const char* msg, const unsigned int linenum,
@@ -19,9 +19,11 @@
 #define ZILLIQA_SRC_LIBUTILS_LOGGER_H_
 
 #include <boost/filesystem.hpp>
+#include <atomic>
 #include <chrono>
 #include <fstream>
 #include <iomanip>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -30,6 +32,7 @@
 #include "g3log/g3log.hpp"
 #include "g3log/loglevels.hpp"
 #include "g3log/logworker.hpp"
+#include "libUtils/AsyncLogBuffer.h"
 #include "libUtils/TimeUtils.h"
 
 #define LIMIT(s, len)                              \
@@ -64,6 +67,16 @@ class Logger {
   bool m_bRefactor{};
   std::string m_logPath;
 
+  // Loaded and stored with the atomic functions of shared_ptr, so that a
+  // thread still logging keeps the buffer alive
+  std::shared_ptr<AsyncLogBuffer> m_asyncBuffer;
+
+  /// Writes record now, or leaves it to the background thread
+  void Submit(LogRecord&& record);
+
+  /// Formats and writes record in the layout of the log
+  void Write(const LogRecord& record);
+
  public:
   /// Limits the number of bytes of a payload to display.
   static const size_t MAX_BYTES_TO_DISPLAY = 30;
@@ -89,6 +102,9 @@ class Logger {
                            const char* logpath,
                            std::streampos max_file_size = MAX_FILE_SIZE);
 
+  /// Returns the main Logger, as created by the first call to GetLogger.
+  static Logger& GetMainLogger();
+
   /// Returns the singleton instance for the state/reporting Logger.
   static Logger& GetStateLogger(const char* fname_prefix, bool log_to_file,
                                 const char* logpath,
@@ -143,6 +159,16 @@ class Logger {
   /// See if we need to use g3log or not
   bool IsG3Log() { return (m_logToFile && m_bRefactor); };
 
+  /// Leaves the formatting and writing of the general, epoch and payload logs
+  /// to a background thread, with up to bufferSize of them queued per thread
+  void StartAsync(size_t bufferSize);
+
+  /// See if the logs are written by the background thread
+  bool IsAsync() const { return std::atomic_load(&m_asyncBuffer) != nullptr; }
+
+  /// Returns the number of logs dropped as their thread's buffer was full
+  uint64_t GetDroppedCount() const;
+
   /// Get current process id
   static pid_t GetPid();
 
@@ -175,6 +201,8 @@ class ScopeMarker {
   Logger::GetStateLogger(fname_prefix, true, logpath)
 #define INIT_EPOCHINFO_LOGGER(fname_prefix, logpath) \
   Logger::GetEpochInfoLogger(fname_prefix, true, logpath)
+#define INIT_ASYNC_LOGGER(buffer_size) \
+  Logger::GetMainLogger().StartAsync(buffer_size)
 #define LOG_MARKER() ScopeMarker marker(__LINE__, __FILE__, __FUNCTION__)
 #define LOG_STATE(msg)                                                         \
   {                                                                            \
@@ -189,9 +217,8 @@ class ScopeMarker {
   }
 #define LOG_GENERAL(level, msg)                                                \
   {                                                                            \
-    if (Logger::GetLogger(NULL, true,                                          \
-                          boost::filesystem::absolute("./").string().c_str())  \
-            .IsG3Log()) {                                                      \
+    Logger& main_logger = Logger::GetMainLogger();                             \
+    if (main_logger.IsG3Log() && !main_logger.IsAsync()) {                     \
       auto cur = std::chrono::system_clock::now();                             \
       auto cur_time_t = std::chrono::system_clock::to_time_t(cur);             \
       auto file_and_line =                                                     \
@@ -205,17 +232,14 @@ class ScopeMarker {
     } else {                                                                   \
       std::ostringstream oss;                                                  \
       oss << msg;                                                              \
-      Logger::GetLogger(NULL, true,                                            \
-                        boost::filesystem::absolute("./").string().c_str())    \
-          .LogGeneral(level, oss.str().c_str(), __LINE__, __FILE__,            \
-                      __FUNCTION__);                                           \
+      main_logger.LogGeneral(level, oss.str().c_str(), __LINE__, __FILE__,     \
+                             __FUNCTION__);                                    \
     }                                                                          \
   }
 #define LOG_EPOCH(level, epoch, msg)                                           \
   {                                                                            \
-    if (Logger::GetLogger(NULL, true,                                          \
-                          boost::filesystem::absolute("./").string().c_str())  \
-            .IsG3Log()) {                                                      \
+    Logger& main_logger = Logger::GetMainLogger();                             \
+    if (main_logger.IsG3Log() && !main_logger.IsAsync()) {                     \
       auto cur = std::chrono::system_clock::now();                             \
       auto cur_time_t = std::chrono::system_clock::to_time_t(cur);             \
       auto file_and_line =                                                     \
@@ -230,17 +254,15 @@ class ScopeMarker {
     } else {                                                                   \
       std::ostringstream oss;                                                  \
       oss << msg;                                                              \
-      Logger::GetLogger(NULL, true,                                            \
-                        boost::filesystem::absolute("./").string().c_str())    \
-          .LogEpoch(level, std::to_string(epoch).c_str(), oss.str().c_str(),   \
-                    __LINE__, __FILE__, __FUNCTION__);                         \
+      main_logger.LogEpoch(level, std::to_string(epoch).c_str(),               \
+                           oss.str().c_str(), __LINE__, __FILE__,              \
+                           __FUNCTION__);                                      \
     }                                                                          \
   }
 #define LOG_PAYLOAD(level, msg, payload, max_bytes_to_display)                 \
   {                                                                            \
-    if (Logger::GetLogger(NULL, true,                                          \
-                          boost::filesystem::absolute("./").string().c_str())  \
-            .IsG3Log()) {                                                      \
+    Logger& main_logger = Logger::GetMainLogger();                             \
+    if (main_logger.IsG3Log() && !main_logger.IsAsync()) {                     \
       std::unique_ptr<char[]> payload_string;                                  \
       Logger::GetPayloadS(payload, max_bytes_to_display, payload_string);      \
       auto cur = std::chrono::system_clock::now();                             \
@@ -269,10 +291,9 @@ class ScopeMarker {
     } else {                                                                   \
       std::ostringstream oss;                                                  \
       oss << msg;                                                              \
-      Logger::GetLogger(NULL, true,                                            \
-                        boost::filesystem::absolute("./").string().c_str())    \
-          .LogPayload(level, oss.str().c_str(), payload, max_bytes_to_display, \
-                      __LINE__, __FILE__, __FUNCTION__);                       \
+      main_logger.LogPayload(level, oss.str().c_str(), payload,                \
+                             max_bytes_to_display, __LINE__, __FILE__,         \
+                             __FUNCTION__);                                    \
     }                                                                          \
   }
 #define LOG_DISPLAY_LEVEL_ABOVE(level)                                    \
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MemFile.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+MemFile::MemFile(const string& name) {
+  m_fd = memfd_create(name.c_str(), MFD_CLOEXEC);
+  if (m_fd < 0) {
+    LOG_GENERAL(WARNING, "memfd_create failed for " << name);
+    return;
+  }
+  m_path = "/proc/" + to_string(getpid()) + "/fd/" + to_string(m_fd);
+}
+
+MemFile::~MemFile() {
+  if (m_fd >= 0) {
+    close(m_fd);
+  }
+}
+
+bool MemFile::Write(const string& content) {
+  if (!Clear()) {
+    return false;
+  }
+
+  size_t written = 0;
+  while (written < content.size()) {
+    const ssize_t n = pwrite(m_fd, content.data() + written,
+                             content.size() - written, written);
+    if (n <= 0) {
+      LOG_GENERAL(WARNING, "pwrite failed for " << m_path);
+      return false;
+    }
+    written += n;
+  }
+  return true;
+}
+
+bool MemFile::Read(string& content) const {
+  struct stat st;
+  if (m_fd < 0 || fstat(m_fd, &st) != 0 || st.st_size <= 0) {
+    return false;
+  }
+
+  content.resize(st.st_size);
+  size_t read = 0;
+  while (read < content.size()) {
+    const ssize_t n =
+        pread(m_fd, &content[read], content.size() - read, read);
+    if (n <= 0) {
+      break;
+    }
+    read += n;
+  }
+  content.resize(read);
+  return !content.empty();
+}
+
+bool MemFile::Clear() {
+  if (m_fd < 0 || ftruncate(m_fd, 0) != 0) {
+    LOG_GENERAL(WARNING, "ftruncate failed for " << m_path);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_MEMFILE_H_
+#define ZILLIQA_SRC_LIBUTILS_MEMFILE_H_
+
+#include <string>
+
+/// Anonymous in-memory file (memfd) that other processes of the same user
+/// can open by path, so a file argument can be handed to a child process
+/// without touching the filesystem.
+class MemFile {
+  int m_fd{-1};
+  std::string m_path;
+
+ public:
+  explicit MemFile(const std::string& name);
+  ~MemFile();
+
+  MemFile(const MemFile&) = delete;
+  MemFile& operator=(const MemFile&) = delete;
+
+  bool IsOpen() const { return m_fd >= 0; }
+
+  /// Path under /proc that opens this file from any process
+  const std::string& GetPath() const { return m_path; }
+
+  /// Replaces the content of the file
+  bool Write(const std::string& content);
+
+  /// Reads the whole file. Returns false if it is empty or unreadable.
+  bool Read(std::string& content) const;
+
+  bool Clear();
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_MEMFILE_H_
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <unistd.h>
+#include <fstream>
+
+#include "MemoryStats.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+MemoryStats& MemoryStats::GetInstance() {
+  static MemoryStats ms;
+  return ms;
+}
+
+void MemoryStats::Register(const string& subsystem,
+                           const Estimator& estimator) {
+  lock_guard<mutex> g(m_mutex);
+  m_estimators[subsystem] = estimator;
+}
+
+void MemoryStats::Unregister(const string& subsystem) {
+  lock_guard<mutex> g(m_mutex);
+  m_estimators.erase(subsystem);
+}
+
+Json::Value MemoryStats::Collect() {
+  Json::Value _json;
+  _json["subsystems"] = Json::Value(Json::objectValue);
+  uint64_t total = 0;
+  for (const auto& it : m_estimators) {
+    const uint64_t bytes = it.second();
+    _json["subsystems"][it.first] = Json::UInt64(bytes);
+    total += bytes;
+  }
+  _json["accounted_bytes"] = Json::UInt64(total);
+  _json["resident_bytes"] = Json::UInt64(GetResidentSizeInBytes());
+  return _json;
+}
+
+void MemoryStats::Log(uint64_t epochNum) {
+  lock_guard<mutex> g(m_mutex);
+
+  m_previous = Collect();
+  m_previousEpoch = epochNum;
+
+  for (const auto& name : m_previous["subsystems"].getMemberNames()) {
+    LOG_GENERAL(INFO, "[MEMSTATS][" << epochNum << "] " << name << " bytes="
+                                    << m_previous["subsystems"][name]
+                                           .asUInt64());
+  }
+  LOG_GENERAL(INFO, "[MEMSTATS][" << epochNum << "] accounted_bytes="
+                                  << m_previous["accounted_bytes"].asUInt64()
+                                  << " resident_bytes="
+                                  << m_previous["resident_bytes"].asUInt64());
+}
+
+Json::Value MemoryStats::GetStats() {
+  lock_guard<mutex> g(m_mutex);
+
+  Json::Value _json;
+  _json["current"] = Collect();
+  _json["previous"] = m_previous;
+  _json["previous_epoch"] = Json::UInt64(m_previousEpoch);
+  return _json;
+}
+
+uint64_t MemoryStats::GetResidentSizeInBytes() {
+#if defined(__linux__)
+  // The second field is the number of resident pages
+  ifstream statm("/proc/self/statm");
+  uint64_t totalPages = 0;
+  uint64_t residentPages = 0;
+  if (statm >> totalPages >> residentPages) {
+    return residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  }
+#endif
+  return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_MEMORYSTATS_H_
+#define ZILLIQA_SRC_LIBUTILS_MEMORYSTATS_H_
+
+#include <json/json.h>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+/// Reports the bytes held by the long-lived structures of the node. Each
+/// subsystem registers an estimator reading the counters it already keeps, and
+/// the estimators are only called when a report is made, so that the
+/// structures pay nothing for being accounted.
+class MemoryStats {
+ public:
+  typedef std::function<uint64_t()> Estimator;
+
+ private:
+  std::mutex m_mutex;
+  std::map<std::string, Estimator> m_estimators;
+  Json::Value m_previous{Json::objectValue};
+  uint64_t m_previousEpoch{0};
+
+  MemoryStats() = default;
+  ~MemoryStats() = default;
+
+  MemoryStats(MemoryStats const&) = delete;
+  void operator=(MemoryStats const&) = delete;
+
+  Json::Value Collect();
+
+ public:
+  /// Returns the singleton MemoryStats instance.
+  static MemoryStats& GetInstance();
+
+  /// Adds or replaces the estimator of a subsystem. The estimator is called
+  /// with the lock of MemoryStats held, so it must not call into MemoryStats.
+  void Register(const std::string& subsystem, const Estimator& estimator);
+
+  /// Removes the estimator of a subsystem, to be called before the structures
+  /// it reads are destroyed.
+  void Unregister(const std::string& subsystem);
+
+  /// Logs the bytes of every subsystem and of the whole process.
+  void Log(uint64_t epochNum);
+
+  /// Returns the current bytes and those logged at the last epoch.
+  Json::Value GetStats();
+
+  /// Returns the resident set size of the process, or 0 if it is unknown.
+  static uint64_t GetResidentSizeInBytes();
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_MEMORYSTATS_H_
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "MessageStats.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace {
+const double PERCENTILES[] = {50, 99, 99.9};
+const char* PERCENTILE_NAMES[] = {"p50", "p99", "p999"};
+
+Json::Value HistogramToJson(const Histogram& histogram) {
+  Json::Value _json;
+  _json["count"] = Json::UInt64(histogram.GetCount());
+  _json["min"] = Json::UInt64(histogram.GetMin());
+  _json["max"] = Json::UInt64(histogram.GetMax());
+  _json["mean"] = histogram.GetMean();
+  for (unsigned int i = 0; i < sizeof(PERCENTILES) / sizeof(double); i++) {
+    _json[PERCENTILE_NAMES[i]] =
+        Json::UInt64(histogram.GetPercentile(PERCENTILES[i]));
+  }
+  return _json;
+}
+
+string HistogramToString(const Histogram& histogram) {
+  string result;
+  for (unsigned int i = 0; i < sizeof(PERCENTILES) / sizeof(double); i++) {
+    result += string(PERCENTILE_NAMES[i]) + "=" +
+              to_string(histogram.GetPercentile(PERCENTILES[i])) + " ";
+  }
+  return result + "max=" + to_string(histogram.GetMax());
+}
+}  // namespace
+
+MessageStats& MessageStats::GetInstance() {
+  static MessageStats ms;
+  return ms;
+}
+
+void MessageStats::Record(const string& msgName, uint64_t handlerTimeInMicro,
+                          uint64_t queueTimeInMicro, uint64_t sizeInBytes) {
+  lock_guard<mutex> g(m_mutex);
+  Entry& entry = m_current[msgName];
+  entry.m_handlerTime.Record(handlerTimeInMicro);
+  entry.m_queueTime.Record(queueTimeInMicro);
+  entry.m_size.Record(sizeInBytes);
+}
+
+void MessageStats::LogAndReset(uint64_t epochNum) {
+  lock_guard<mutex> g(m_mutex);
+
+  for (const auto& it : m_current) {
+    LOG_GENERAL(INFO,
+                "[MSGSTATS][" << epochNum << "] " << it.first << " count="
+                              << it.second.m_handlerTime.GetCount()
+                              << " handler_us["
+                              << HistogramToString(it.second.m_handlerTime)
+                              << "] queue_us["
+                              << HistogramToString(it.second.m_queueTime)
+                              << "] size_bytes["
+                              << HistogramToString(it.second.m_size) << "]");
+  }
+
+  m_previous.swap(m_current);
+  m_current.clear();
+  m_previousEpoch = epochNum;
+}
+
+Json::Value MessageStats::ToJson(const map<string, Entry>& entries) {
+  Json::Value _json(Json::objectValue);
+  for (const auto& it : entries) {
+    _json[it.first]["handler_us"] = HistogramToJson(it.second.m_handlerTime);
+    _json[it.first]["queue_us"] = HistogramToJson(it.second.m_queueTime);
+    _json[it.first]["size_bytes"] = HistogramToJson(it.second.m_size);
+  }
+  return _json;
+}
+
+Json::Value MessageStats::GetStats() {
+  lock_guard<mutex> g(m_mutex);
+
+  Json::Value _json;
+  _json["current"] = ToJson(m_current);
+  _json["previous"] = ToJson(m_previous);
+  _json["previous_epoch"] = Json::UInt64(m_previousEpoch);
+  return _json;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_MESSAGESTATS_H_
+#define ZILLIQA_SRC_LIBUTILS_MESSAGESTATS_H_
+
+#include <json/json.h>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "Histogram.h"
+
+/// Collects per-message-type histograms of handler time, queue wait time and
+/// payload size for the incoming message dispatcher.
+class MessageStats {
+  struct Entry {
+    Histogram m_handlerTime;  // microseconds
+    Histogram m_queueTime;    // microseconds
+    Histogram m_size;         // bytes
+  };
+
+  std::mutex m_mutex;
+  std::map<std::string, Entry> m_current;
+  std::map<std::string, Entry> m_previous;
+  uint64_t m_previousEpoch{0};
+
+  MessageStats() = default;
+  ~MessageStats() = default;
+
+  MessageStats(MessageStats const&) = delete;
+  void operator=(MessageStats const&) = delete;
+
+  static Json::Value ToJson(const std::map<std::string, Entry>& entries);
+
+ public:
+  /// Returns the singleton MessageStats instance.
+  static MessageStats& GetInstance();
+
+  /// Records one processed message.
+  void Record(const std::string& msgName, uint64_t handlerTimeInMicro,
+              uint64_t queueTimeInMicro, uint64_t sizeInBytes);
+
+  /// Logs the statistics collected during the epoch and starts a new period.
+  void LogAndReset(uint64_t epochNum);
+
+  /// Returns the statistics of the current and the last completed epoch.
+  Json::Value GetStats();
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_MESSAGESTATS_H_
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_ORDEREDPIPELINE_H_
+#define ZILLIQA_SRC_LIBUTILS_ORDEREDPIPELINE_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "libUtils/Logger.h"
+#include "libUtils/ThreadPool.h"
+#include "libUtils/TimeUtils.h"
+
+/// Runs produce(i, item) for each i in [0, count) on numThreads threads, at
+/// most window items ahead, and apply(i, item) on the calling thread in the
+/// order of i. Stops at the first item whose produce or apply returns false.
+/// Returns false if it stopped because produce failed, and sets applied to
+/// the number of items applied. With no threads, all runs on the caller.
+template <typename T>
+bool RunOrderedPipeline(const std::string& stage, const size_t count,
+                        const unsigned int numThreads, const size_t window,
+                        const std::function<bool(size_t, T&)>& produce,
+                        const std::function<bool(size_t, T&)>& apply,
+                        size_t& applied) {
+  enum SlotState : unsigned char { PENDING, PRODUCED, FAILED };
+
+  const auto startTime = r_timer_start();
+  const size_t progressInterval = std::max<size_t>(count / 10, 1);
+  auto logProgress = [&]() {
+    if ((applied % progressInterval == 0) || (applied == count)) {
+      LOG_GENERAL(INFO, stage << ": " << applied << "/" << count << " in "
+                              << r_timer_end(startTime) / 1000 << " ms");
+    }
+  };
+
+  applied = 0;
+  if (numThreads == 0) {
+    for (size_t i = 0; i < count; i++) {
+      T item;
+      if (!produce(i, item)) {
+        return false;
+      }
+      if (!apply(i, item)) {
+        break;
+      }
+      applied++;
+      logProgress();
+    }
+    return true;
+  }
+
+  const size_t slotCount = std::max<size_t>(window, 1);
+  std::vector<T> items(slotCount);
+  std::vector<SlotState> states(slotCount, PENDING);
+  std::mutex mutexSlots;
+  std::condition_variable cvSlots;
+
+  // Declared last so that its threads are joined before the above go away
+  ThreadPool pool(numThreads, stage);
+
+  size_t submitted = 0;
+  bool produced = true;
+  for (size_t i = 0; i < count; i++) {
+    // Slot i % slotCount is free again once item i - 1 has been taken
+    for (; (submitted < count) && (submitted < i + slotCount); submitted++) {
+      pool.AddJob([&, submitted]() {
+        T item;
+        const bool ok = produce(submitted, item);
+        {
+          std::lock_guard<std::mutex> g(mutexSlots);
+          items.at(submitted % slotCount) = std::move(item);
+          states.at(submitted % slotCount) = ok ? PRODUCED : FAILED;
+        }
+        cvSlots.notify_all();
+      });
+    }
+
+    T item;
+    {
+      std::unique_lock<std::mutex> lock(mutexSlots);
+      cvSlots.wait(lock,
+                   [&]() { return states.at(i % slotCount) != PENDING; });
+      if (states.at(i % slotCount) == FAILED) {
+        produced = false;
+        break;
+      }
+      item = std::move(items.at(i % slotCount));
+      states.at(i % slotCount) = PENDING;
+    }
+
+    if (!apply(i, item)) {
+      break;
+    }
+    applied++;
+    logProgress();
+  }
+
+  return produced;
+}
+
+#endif  // ZILLIQA_SRC_LIBUTILS_ORDEREDPIPELINE_H_
@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <malloc.h>
+#include <sys/time.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "DetachedFunction.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include "common/Constants.h"
+
+using namespace std;
+
+namespace {
+
+/// The frames of the handler and of the signal trampoline
+const int SIGNAL_FRAMES = 2;
+
+string GetSymbol(void* address) {
+  Dl_info info;
+  if (dladdr(address, &info) == 0) {
+    ostringstream oss;
+    oss << address;
+    return oss.str();
+  }
+
+  if (info.dli_sname != nullptr) {
+    int status = 0;
+    char* demangled =
+        abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    string symbol = (status == 0) ? demangled : info.dli_sname;
+    free(demangled);
+    return symbol;
+  }
+
+  // Not exported, left to be resolved offline with addr2line
+  string module = (info.dli_fname != nullptr) ? info.dli_fname : "";
+  module = module.substr(module.find_last_of('/') + 1);
+  ostringstream oss;
+  oss << module << "+0x" << hex
+      << (static_cast<char*>(address) - static_cast<char*>(info.dli_fbase));
+  return oss.str();
+}
+
+bool WriteMallocInfo(const string& path) {
+  FILE* file = fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    return false;
+  }
+  const bool ok = (malloc_info(0, file) == 0);
+  fclose(file);
+  return ok;
+}
+
+string GetHeapStartPath(const string& path) {
+  return path.substr(0, path.rfind('.')) + "_start.xml";
+}
+
+}  // namespace
+
+const unsigned int Profiler::MAX_DEPTH;
+const unsigned int Profiler::MAX_SAMPLES;
+const unsigned int Profiler::MAX_SAMPLES_PER_SECOND;
+
+Profiler::Sample* Profiler::s_samples = nullptr;
+unsigned int Profiler::s_capacity = 0;
+atomic<unsigned int> Profiler::s_sampleCount{0};
+atomic<unsigned int> Profiler::s_inHandler{0};
+atomic<bool> Profiler::s_sampling{false};
+
+Profiler& Profiler::GetInstance() {
+  static Profiler profiler;
+  return profiler;
+}
+
+bool Profiler::GetKind(const string& name, Kind& kind) {
+  if (name == "cpu") {
+    kind = CPU;
+  } else if (name == "heap") {
+    kind = HEAP;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void Profiler::OnSignal(int sig) {
+  (void)sig;
+  const int savedErrno = errno;
+  ++s_inHandler;
+  if (s_sampling) {
+    const unsigned int index = s_sampleCount++;
+    if (index < s_capacity) {
+      Sample& sample = s_samples[index];
+      sample.m_depth = backtrace(sample.m_frames, MAX_DEPTH);
+    }
+  }
+  --s_inHandler;
+  errno = savedErrno;
+}
+
+string Profiler::Start(Kind kind, uint64_t epochNum,
+                       unsigned int windowInSeconds) {
+  lock_guard<mutex> g(m_mutex);
+
+  Window& window = m_windows.at(kind);
+  if (window.m_running) {
+    LOG_GENERAL(WARNING, "A profiling window is already running");
+    return "";
+  }
+
+  const auto now = chrono::duration_cast<chrono::seconds>(
+                       chrono::system_clock::now().time_since_epoch())
+                       .count();
+  const string path = STORAGE_PATH + (kind == CPU ? "/cpu" : "/heap") +
+                      "_profile_" + to_string(epochNum) + "_" +
+                      to_string(now) + (kind == CPU ? ".folded" : ".xml");
+
+  if (kind == CPU) {
+    if (!StartCpu(windowInSeconds)) {
+      return "";
+    }
+  } else if (!WriteMallocInfo(GetHeapStartPath(path))) {
+    LOG_GENERAL(WARNING, "Failed to write " << GetHeapStartPath(path));
+    return "";
+  }
+
+  window.m_running = true;
+  window.m_path = path;
+  const uint64_t generation = ++window.m_generation;
+  LOG_GENERAL(INFO, "Profiling for " << windowInSeconds << "s into " << path);
+
+  auto func = [this, kind, generation, windowInSeconds]() -> void {
+    unique_lock<mutex> lock(m_mutex);
+    if (!m_cvStop.wait_for(
+            lock, chrono::seconds(windowInSeconds), [this, kind, generation] {
+              return m_windows.at(kind).m_generation != generation;
+            })) {
+      StopLocked(kind);
+    }
+  };
+  DetachedFunction(1, func);
+
+  return path;
+}
+
+string Profiler::Stop(Kind kind) {
+  lock_guard<mutex> g(m_mutex);
+  return StopLocked(kind);
+}
+
+bool Profiler::IsRunning(Kind kind) {
+  lock_guard<mutex> g(m_mutex);
+  return m_windows.at(kind).m_running;
+}
+
+string Profiler::StopLocked(Kind kind) {
+  Window& window = m_windows.at(kind);
+  if (!window.m_running) {
+    return "";
+  }
+
+  window.m_running = false;
+  ++window.m_generation;
+  m_cvStop.notify_all();
+
+  const bool ok =
+      (kind == CPU) ? StopCpu(window.m_path) : WriteMallocInfo(window.m_path);
+  if (!ok) {
+    LOG_GENERAL(WARNING, "Failed to write " << window.m_path);
+    return "";
+  }
+
+  LOG_GENERAL(INFO, "Profile written to " << window.m_path);
+  return window.m_path;
+}
+
+bool Profiler::StartCpu(unsigned int windowInSeconds) {
+  const unsigned int rate =
+      min(max(PROFILER_SAMPLES_PER_SECOND, 1u), MAX_SAMPLES_PER_SECOND);
+
+  m_samples.assign(
+      min(static_cast<uint64_t>(rate) * windowInSeconds,
+          static_cast<uint64_t>(MAX_SAMPLES)),
+      Sample());
+  s_samples = m_samples.data();
+  s_capacity = m_samples.size();
+  s_sampleCount = 0;
+
+  // The first call loads the unwinder, which would allocate in the handler
+  void* frame = nullptr;
+  backtrace(&frame, 1);
+
+  struct sigaction action {};
+  action.sa_handler = &Profiler::OnSignal;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, &m_oldAction) != 0) {
+    LOG_GENERAL(WARNING, "Failed to install the SIGPROF handler");
+    return false;
+  }
+
+  s_sampling = true;
+
+  struct itimerval timer {};
+  timer.it_interval.tv_usec = 1000000 / rate;
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+    LOG_GENERAL(WARNING, "Failed to start the profiling timer");
+    s_sampling = false;
+    sigaction(SIGPROF, &m_oldAction, nullptr);
+    return false;
+  }
+
+  return true;
+}
+
+bool Profiler::StopCpu(const string& path) {
+  struct itimerval timer {};
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  s_sampling = false;
+  while (s_inHandler > 0) {
+    this_thread::yield();
+  }
+  sigaction(SIGPROF, &m_oldAction, nullptr);
+
+  const unsigned int taken = s_sampleCount;
+  const unsigned int kept = min(taken, s_capacity);
+
+  // Folded stacks, from the outermost frame, with the count of each
+  unordered_map<void*, string> symbols;
+  map<string, unsigned int> stacks;
+  for (unsigned int i = 0; i < kept; ++i) {
+    const Sample& sample = m_samples[i];
+    string stack;
+    for (int depth = sample.m_depth - 1; depth >= SIGNAL_FRAMES; --depth) {
+      void* address = sample.m_frames[depth];
+      auto it = symbols.find(address);
+      if (it == symbols.end()) {
+        it = symbols.emplace(address, GetSymbol(address)).first;
+      }
+      if (!stack.empty()) {
+        stack += ';';
+      }
+      stack += it->second;
+    }
+    if (!stack.empty()) {
+      ++stacks[stack];
+    }
+  }
+
+  m_samples.clear();
+  m_samples.shrink_to_fit();
+  s_samples = nullptr;
+  s_capacity = 0;
+
+  ofstream out(path);
+  for (const auto& stack : stacks) {
+    out << stack.first << " " << stack.second << "\n";
+  }
+  out.close();
+
+  LOG_GENERAL(INFO, "CPU samples kept: " << kept
+                                         << " dropped: " << (taken - kept));
+  return out.good();
+}
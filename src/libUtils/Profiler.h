@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_PROFILER_H_
+#define ZILLIQA_SRC_LIBUTILS_PROFILER_H_
+
+#include <signal.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Profiles the node from within for a window of time, so that a slow phase
+/// can be captured without attaching a profiler to the process. The CPU
+/// profile samples the stacks on SIGPROF and is written in the folded stack
+/// format of flamegraph.pl. The heap profile is the malloc_info of glibc at
+/// the start and at the end of the window. The profiles are written to
+/// STORAGE_PATH, tagged with the epoch the window started in.
+class Profiler {
+ public:
+  enum Kind : unsigned char { CPU, HEAP, KIND_COUNT };
+
+  /// Returns the singleton Profiler instance.
+  static Profiler& GetInstance();
+
+  static bool GetKind(const std::string& name, Kind& kind);
+
+  /// Starts a window of windowInSeconds, after which the profile is written.
+  /// Returns the file that it is written to, or an empty string if a window
+  /// of kind is already running or it could not be started.
+  std::string Start(Kind kind, uint64_t epochNum,
+                    unsigned int windowInSeconds);
+
+  /// Ends the running window of kind early. Returns the file written, or an
+  /// empty string if none was running.
+  std::string Stop(Kind kind);
+
+  bool IsRunning(Kind kind);
+
+ private:
+  static const unsigned int MAX_DEPTH = 64;
+  static const unsigned int MAX_SAMPLES = 1 << 16;
+  static const unsigned int MAX_SAMPLES_PER_SECOND = 1000;
+
+  struct Sample {
+    int m_depth;
+    void* m_frames[MAX_DEPTH];
+  };
+
+  struct Window {
+    bool m_running{false};
+    uint64_t m_generation{0};
+    std::string m_path;
+  };
+
+  /// Read by the signal handler, which cannot take a lock
+  static Sample* s_samples;
+  static unsigned int s_capacity;
+  static std::atomic<unsigned int> s_sampleCount;
+  static std::atomic<unsigned int> s_inHandler;
+  static std::atomic<bool> s_sampling;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cvStop;
+  std::array<Window, KIND_COUNT> m_windows;
+  std::vector<Sample> m_samples;
+  struct sigaction m_oldAction {};
+
+  Profiler() = default;
+  ~Profiler() = default;
+
+  Profiler(Profiler const&) = delete;
+  void operator=(Profiler const&) = delete;
+
+  static void OnSignal(int sig);
+
+  bool StartCpu(unsigned int windowInSeconds);
+  bool StopCpu(const std::string& path);
+
+  /// Called with m_mutex held
+  std::string StopLocked(Kind kind);
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_PROFILER_H_
@@ -39,6 +39,23 @@ inline const TxnHash& GetHash(
 inline const TxnHash& GetHash(const TransactionWithReceipt& item) {
   return item.GetTransaction().GetTranID();
 }
+
+// Hashes the ids in place instead of copying each one into a vector
+template <typename Container>
+void UpdateHashes(SHA2<HashType::HASH_VARIANT_256>& sha2,
+                  const Container& list) {
+  for (const auto& item : list) {
+    const TxnHash& hash = GetHash(item);
+    sha2.Update(hash.data(), TxnHash::size);
+  }
+}
+
+// The hashes of a vector are contiguous, so they take one update
+void UpdateHashes(SHA2<HashType::HASH_VARIANT_256>& sha2,
+                  const vector<h256>& hashes) {
+  static_assert(sizeof(h256) == h256::size, "h256 must be packed");
+  sha2.Update(hashes.front().data(), hashes.size() * h256::size);
+}
 }  // namespace
 
 template <typename... Container>
@@ -55,9 +72,7 @@ TxnHash ConcatTranAndHash(const Container&... conts) {
         }
         hasValue = true;
 
-        for (auto& item : list) {
-          sha2.Update(GetHash(item).asBytes());
-        }
+        UpdateHashes(sha2, list);
       }(conts, sha2, hasValue),
       0)...};
 
@@ -272,3 +272,82 @@ bool SafeMath<T>::div_unsignint(const T& a, const T& b, T& result) {
   result = c;
   return true;
 }
+
+#if defined(__SIZEOF_INT128__)
+// uint128_t takes the compiler's native 128-bit integer and its overflow
+// builtins instead of the cpp_int arithmetic and the type dispatch above.
+// The results, including the wrapped sum left in result on an overflowing
+// add, are the same as the generic code.
+namespace SafeMathNative {
+__extension__ typedef unsigned __int128 Native;
+
+inline Native ToNative(const uint128_t& a) {
+  const auto& backend = a.backend();
+  const unsigned int limbBits = 8 * sizeof(*backend.limbs());
+  Native value = 0;
+  for (unsigned int i = 0; i < backend.size(); i++) {
+    value |= static_cast<Native>(backend.limbs()[i]) << (i * limbBits);
+  }
+  return value;
+}
+}  // namespace SafeMathNative
+
+template <>
+inline bool SafeMath<uint128_t>::add(const uint128_t& a, const uint128_t& b,
+                                     uint128_t& result) {
+  SafeMathNative::Native c;
+  const bool overflow = __builtin_add_overflow(
+      SafeMathNative::ToNative(a), SafeMathNative::ToNative(b), &c);
+  result = c;
+
+  if (overflow) {
+    LOG_GENERAL(WARNING, "Addition Overflow!");
+    return false;
+  }
+
+  return true;
+}
+
+template <>
+inline bool SafeMath<uint128_t>::sub(const uint128_t& a, const uint128_t& b,
+                                     uint128_t& result) {
+  const SafeMathNative::Native x = SafeMathNative::ToNative(a);
+  const SafeMathNative::Native y = SafeMathNative::ToNative(b);
+  if (y > x) {
+    LOG_GENERAL(WARNING,
+                "For unsigned subtraction, minuend should be greater than "
+                "subtrahend!");
+    return false;
+  }
+
+  result = x - y;
+  return true;
+}
+
+template <>
+inline bool SafeMath<uint128_t>::mul(const uint128_t& a, const uint128_t& b,
+                                     uint128_t& result) {
+  SafeMathNative::Native c;
+  if (__builtin_mul_overflow(SafeMathNative::ToNative(a),
+                             SafeMathNative::ToNative(b), &c)) {
+    LOG_GENERAL(WARNING, "Multiplication Underflow/Overflow!");
+    return false;
+  }
+
+  result = c;
+  return true;
+}
+
+template <>
+inline bool SafeMath<uint128_t>::div(const uint128_t& a, const uint128_t& b,
+                                     uint128_t& result) {
+  const SafeMathNative::Native y = SafeMathNative::ToNative(b);
+  if (y == 0) {
+    LOG_GENERAL(WARNING, "Denominator cannot be zero!");
+    return false;
+  }
+
+  result = SafeMathNative::ToNative(a) / y;
+  return true;
+}
+#endif
@@ -17,76 +17,35 @@
 
 #include "Scheduler.h"
 
-#include <utility>
-#include "ReverseLock.h"
-
 using namespace std;
 
-Scheduler::Scheduler() {}
-
-Scheduler::~Scheduler() {}
-
-void Scheduler::ServiceQueue() {
-  unique_lock<mutex> lock(newTaskMutex);
-
-  while (true) {
-    try {
-      while (taskQueue.empty()) {
-        newTaskScheduled.wait(lock);
-      }
-
-      while (!taskQueue.empty()) {
-        std::chrono::time_point<std::chrono::system_clock> timeToWaitFor =
-            taskQueue.begin()->first;
-        if (newTaskScheduled.wait_until(lock, timeToWaitFor) ==
-            std::cv_status::timeout) {
-          break;
-        }
-      }
-
-      if (taskQueue.empty()) {
-        continue;
-      }
-
-      std::function<void(void)> f = taskQueue.begin()->second;
-      taskQueue.erase(taskQueue.begin());
-
-      {
-        ReverseLock<unique_lock<mutex>> rlock(lock);
-        f();
-      }
-    } catch (...) {
-      throw;
-    }
-  }
-  newTaskScheduled.notify_one();
-}
-
-void Scheduler::ScheduleAt(std::function<void(void)> f,
-                           chrono::time_point<chrono::system_clock> t) {
-  {
-    lock_guard<mutex> lock(newTaskMutex);
-    taskQueue.emplace(t, f);
-  }
-  newTaskScheduled.notify_one();
+Scheduler::Handle Scheduler::ScheduleAt(
+    std::function<void(void)> f, chrono::time_point<chrono::system_clock> t) {
+  return ScheduleAfter(move(f), chrono::duration_cast<chrono::milliseconds>(
+                                    t - chrono::system_clock::now())
+                                    .count());
 }
 
-void Scheduler::ScheduleAfter(std::function<void(void)> f,
-                              int64_t deltaMilliSeconds) {
-  ScheduleAt(move(f), chrono::system_clock::now() +
-                          chrono::milliseconds(deltaMilliSeconds));
+Scheduler::Handle Scheduler::ScheduleAfter(std::function<void(void)> f,
+                                           int64_t deltaMilliSeconds) {
+  return TimerWheel::GetInstance().ScheduleAfter(
+      move(f), chrono::milliseconds(deltaMilliSeconds));
 }
 
-static void SchedulePeriodicallyHelper(Scheduler* s,
-                                       std::function<void(void)> f,
+static void SchedulePeriodicallyHelper(std::function<void(void)> f,
                                        int64_t deltaMilliSeconds) {
   f();
-  s->ScheduleAfter(bind(&SchedulePeriodicallyHelper, s, f, deltaMilliSeconds),
-                   deltaMilliSeconds);
+  TimerWheel::GetInstance().ScheduleAfter(
+      bind(&SchedulePeriodicallyHelper, f, deltaMilliSeconds),
+      chrono::milliseconds(deltaMilliSeconds));
 }
 
 void Scheduler::SchedulePeriodically(std::function<void(void)> f,
                                      int64_t deltaMilliSeconds) {
-  ScheduleAfter(bind(&SchedulePeriodicallyHelper, this, f, deltaMilliSeconds),
+  ScheduleAfter(bind(&SchedulePeriodicallyHelper, f, deltaMilliSeconds),
                 deltaMilliSeconds);
 }
+
+bool Scheduler::Cancel(Handle handle) {
+  return TimerWheel::GetInstance().Cancel(handle);
+}
@@ -19,41 +19,29 @@
 #define ZILLIQA_SRC_LIBUTILS_SCHEDULER_H_
 
 #include <chrono>
-#include <condition_variable>
 #include <functional>
-#include <map>
-#include <mutex>
-#include <thread>
 
-// should be initialized this way
-// CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue,
-// &scheduler);
-// threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>,
-// "scheduler", serviceLoop));
+#include "libUtils/TimerWheel.h"
 
+/// Schedules functions on TimerWheel, which runs each of them on a thread kept
+/// by DetachedExecutor once its time comes.
 /// [TODO] Currently unused
 class Scheduler {
  public:
-  Scheduler();
-  ~Scheduler();
+  using Handle = TimerWheel::Handle;
 
-  void ScheduleAt(std::function<void(void)> f,
-                  std::chrono::time_point<std::chrono::system_clock> t =
-                      std::chrono::system_clock::now());
+  Handle ScheduleAt(std::function<void(void)> f,
+                    std::chrono::time_point<std::chrono::system_clock> t =
+                        std::chrono::system_clock::now());
 
-  void ScheduleAfter(std::function<void(void)> f, int64_t deltaMilliSeconds);
+  Handle ScheduleAfter(std::function<void(void)> f, int64_t deltaMilliSeconds);
 
   void SchedulePeriodically(std::function<void(void)> f,
                             int64_t deltaMilliSeconds);
 
-  void ServiceQueue();
-
- private:
-  std::multimap<std::chrono::time_point<std::chrono::system_clock>,
-                std::function<void(void)>>
-      taskQueue;
-  std::condition_variable newTaskScheduled;
-  mutable std::mutex newTaskMutex;
+  /// Drops a function scheduled at or after a time, and returns false if it
+  /// already ran
+  bool Cancel(Handle handle);
 };
 
 #endif  // ZILLIQA_SRC_LIBUTILS_SCHEDULER_H_
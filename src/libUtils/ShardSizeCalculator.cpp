@@ -144,6 +144,46 @@ void ShardSizeCalculator::GenerateShardCounts(
                           shardCounts, leastWaste);
 }
 
+void ShardSizeCalculator::GenerateBalancedShardCounts(
+    const uint32_t shardSize, const uint32_t shardSizeToleranceLo,
+    const uint32_t shardSizeToleranceHi, const uint32_t numNodesForSharding,
+    vector<uint32_t>& shardCounts) {
+  shardCounts.clear();
+
+  if (shardSizeToleranceLo >= shardSize) {
+    LOG_GENERAL(
+        WARNING,
+        "SHARD_SIZE_TOLERANCE_LO must be smaller than current shard size!");
+    return;
+  }
+
+  const uint32_t shard_threshold_lo = shardSize - shardSizeToleranceLo;
+  const uint32_t shard_threshold_hi = shardSize + shardSizeToleranceHi;
+
+  if (numNodesForSharding < shard_threshold_lo) {
+    LOG_GENERAL(WARNING, "Number of PoWs for sharding ("
+                             << numNodesForSharding
+                             << ") is not enough for even one shard.");
+    return;
+  }
+
+  // The fewest shards that can take all the nodes, unless that many shards
+  // cannot be filled up to the low threshold. Then one shard fewer, all full.
+  uint32_t numShards =
+      (numNodesForSharding + shard_threshold_hi - 1) / shard_threshold_hi;
+  uint32_t numNodes = numNodesForSharding;
+  if (static_cast<uint64_t>(numShards) * shard_threshold_lo >
+      numNodesForSharding) {
+    numShards--;
+    numNodes = numShards * shard_threshold_hi;
+  }
+
+  shardCounts.assign(numShards, numNodes / numShards);
+  for (uint32_t i = 0; i < numNodes % numShards; i++) {
+    shardCounts[i]++;
+  }
+}
+
 uint32_t ShardSizeCalculator::GetTrimmedShardCount(
     const uint32_t shardSize, const uint32_t shardSizeToleranceLo,
     const uint32_t shardSizeToleranceHi, const uint32_t numNodesForSharding) {
@@ -33,6 +33,17 @@ class ShardSizeCalculator {
                                   const uint32_t numNodesForSharding,
                                   std::vector<uint32_t>& shardCounts);
 
+  /// Same bounds as GenerateShardCounts, in time linear in the number of
+  /// shards rather than exponential: the fewest shards that take the most
+  /// nodes, with sizes differing by at most one. Only for exploring larger
+  /// networks offline, as the DS committee must keep agreeing on the counts
+  /// of GenerateShardCounts.
+  static void GenerateBalancedShardCounts(const uint32_t shardSize,
+                                          const uint32_t shardSizeToleranceLo,
+                                          const uint32_t shardSizeToleranceHi,
+                                          const uint32_t numNodesForSharding,
+                                          std::vector<uint32_t>& shardCounts);
+
   static uint32_t GetTrimmedShardCount(const uint32_t shardSize,
                                        const uint32_t shardSizeToleranceLo,
                                        const uint32_t shardSizeToleranceHi,
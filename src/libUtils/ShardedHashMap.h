@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_SHARDEDHASHMAP_H_
+#define ZILLIQA_SRC_LIBUTILS_SHARDEDHASHMAP_H_
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Hash map split over independently locked stripes. A lookup only takes a
+ * shared lock on the stripe owning the key, so readers do not wait for a
+ * batch update touching other stripes. Batch updates group the entries by
+ * stripe and take every stripe lock once.
+ */
+template <class Key, class Value, class Hash = std::hash<Key>>
+class ShardedHashMap {
+  struct Stripe {
+    mutable std::shared_timed_mutex m_mutex;
+    std::unordered_map<Key, Value, Hash> m_map;
+  };
+
+  std::vector<Stripe> m_stripes;
+  const Hash m_hasher;
+
+  size_t GetStripeIndex(const Key& key) const {
+    const size_t h = m_hasher(key);
+    // Mix in the high bits so the stripe does not just repeat the bucket
+    return (h ^ (h >> 16)) % m_stripes.size();
+  }
+
+  Stripe& GetStripe(const Key& key) {
+    return m_stripes[GetStripeIndex(key)];
+  }
+
+  const Stripe& GetStripe(const Key& key) const {
+    return m_stripes[GetStripeIndex(key)];
+  }
+
+ public:
+  explicit ShardedHashMap(const unsigned int numStripes = 16)
+      : m_stripes(std::max(numStripes, 1u)), m_hasher() {}
+
+  /// Adds the entry unless the key is already present (same as emplace).
+  bool Insert(const Key& key, const Value& value) {
+    Stripe& stripe = GetStripe(key);
+    std::unique_lock<std::shared_timed_mutex> g(stripe.m_mutex);
+    return stripe.m_map.emplace(key, value).second;
+  }
+
+  /// Adds a range of key-value pairs, keeping existing entries.
+  template <class Container>
+  void InsertBatch(const Container& entries) {
+    std::vector<std::vector<const typename Container::value_type*>> grouped(
+        m_stripes.size());
+    for (const auto& entry : entries) {
+      grouped[GetStripeIndex(entry.first)].push_back(&entry);
+    }
+
+    for (size_t i = 0; i < grouped.size(); i++) {
+      if (grouped[i].empty()) {
+        continue;
+      }
+      std::unique_lock<std::shared_timed_mutex> g(m_stripes[i].m_mutex);
+      for (const auto& entry : grouped[i]) {
+        m_stripes[i].m_map.emplace(entry->first, entry->second);
+      }
+    }
+  }
+
+  /// Removes the given keys. Returns the number of entries removed.
+  template <class Container>
+  size_t EraseBatch(const Container& keys) {
+    std::vector<std::vector<const Key*>> grouped(m_stripes.size());
+    for (const auto& key : keys) {
+      grouped[GetStripeIndex(key)].push_back(&key);
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < grouped.size(); i++) {
+      if (grouped[i].empty()) {
+        continue;
+      }
+      std::unique_lock<std::shared_timed_mutex> g(m_stripes[i].m_mutex);
+      for (const auto& key : grouped[i]) {
+        count += m_stripes[i].m_map.erase(*key);
+      }
+    }
+    return count;
+  }
+
+  /// Copies the value of the key into value. Returns false if not present.
+  bool Find(const Key& key, Value& value) const {
+    const Stripe& stripe = GetStripe(key);
+    std::shared_lock<std::shared_timed_mutex> g(stripe.m_mutex);
+    const auto it = stripe.m_map.find(key);
+    if (it == stripe.m_map.end()) {
+      return false;
+    }
+    value = it->second;
+    return true;
+  }
+
+  void Clear() {
+    for (auto& stripe : m_stripes) {
+      std::unique_lock<std::shared_timed_mutex> g(stripe.m_mutex);
+      stripe.m_map.clear();
+    }
+  }
+
+  bool Empty() const {
+    for (const auto& stripe : m_stripes) {
+      std::shared_lock<std::shared_timed_mutex> g(stripe.m_mutex);
+      if (!stripe.m_map.empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  size_t Size() const {
+    size_t size = 0;
+    for (const auto& stripe : m_stripes) {
+      std::shared_lock<std::shared_timed_mutex> g(stripe.m_mutex);
+      size += stripe.m_map.size();
+    }
+    return size;
+  }
+
+  /// Returns a copy of all entries. Stripes are copied one after another, so
+  /// the copy is not an atomic view if there are concurrent updates.
+  std::unordered_map<Key, Value, Hash> Snapshot() const {
+    std::unordered_map<Key, Value, Hash> result;
+    result.reserve(Size());
+    for (const auto& stripe : m_stripes) {
+      std::shared_lock<std::shared_timed_mutex> g(stripe.m_mutex);
+      result.insert(stripe.m_map.begin(), stripe.m_map.end());
+    }
+    return result;
+  }
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_SHARDEDHASHMAP_H_
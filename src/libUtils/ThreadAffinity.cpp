@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+
+#include "ThreadAffinity.h"
+#include "common/Constants.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace {
+// Longest thread name pthread_setname_np takes, without the terminator
+const size_t MAX_THREAD_NAME_LENGTH = 15;
+
+const string NUMA_PREFIX = "numa";
+
+bool ParseNumber(const string& text, unsigned int& number) {
+  if (text.empty() || text.size() > 9 ||
+      !all_of(text.begin(), text.end(), ::isdigit)) {
+    return false;
+  }
+  number = stoul(text);
+  return true;
+}
+
+// Reads the core list of a NUMA node, which is itself in the "0-3,8" form
+bool ReadNumaCores(const string& node, string& spec) {
+  ifstream file("/sys/devices/system/node/node" + node + "/cpulist");
+  return static_cast<bool>(getline(file, spec));
+}
+
+bool ParseItems(const string& spec, bool allowNuma,
+                vector<unsigned int>& cores) {
+  size_t begin = 0;
+  while (begin <= spec.size()) {
+    const size_t end = min(spec.find(',', begin), spec.size());
+    const string item = spec.substr(begin, end - begin);
+    begin = end + 1;
+
+    if (allowNuma && item.compare(0, NUMA_PREFIX.size(), NUMA_PREFIX) == 0) {
+      const string node = item.substr(NUMA_PREFIX.size());
+      unsigned int unused = 0;
+      string nodeSpec;
+      if (!ParseNumber(node, unused) || !ReadNumaCores(node, nodeSpec) ||
+          !ParseItems(nodeSpec, false, cores)) {
+        return false;
+      }
+      continue;
+    }
+
+    const size_t dash = item.find('-');
+    unsigned int first = 0;
+    unsigned int last = 0;
+    if (!ParseNumber(item.substr(0, dash), first) ||
+        (dash != string::npos && !ParseNumber(item.substr(dash + 1), last))) {
+      return false;
+    }
+    if (dash == string::npos) {
+      last = first;
+    }
+    if (last < first || last >= CPU_SETSIZE) {
+      return false;
+    }
+    for (unsigned int core = first; core <= last; core++) {
+      cores.emplace_back(core);
+    }
+  }
+  return true;
+}
+
+const map<string, vector<unsigned int>>& Groups() {
+  static const map<string, vector<unsigned int>> groups = [] {
+    map<string, vector<unsigned int>> result;
+    for (const auto& group : THREAD_AFFINITY_GROUPS) {
+      vector<unsigned int> cores;
+      if (!ThreadAffinity::ParseCores(group.second, cores)) {
+        LOG_GENERAL(WARNING, "Invalid cores " << group.second << " for thread "
+                                              << "group " << group.first);
+        continue;
+      }
+      LOG_GENERAL(INFO, "Thread group " << group.first << " on cores "
+                                        << group.second);
+      result[group.first] = move(cores);
+    }
+    return result;
+  }();
+  return groups;
+}
+
+void NameThread(const string& group) {
+#if defined(__linux__)
+  pthread_setname_np(pthread_self(),
+                     group.substr(0, MAX_THREAD_NAME_LENGTH).c_str());
+#else
+  (void)group;
+#endif
+}
+}  // namespace
+
+bool ThreadAffinity::ParseCores(const string& spec,
+                                vector<unsigned int>& cores) {
+  cores.clear();
+  if (!ParseItems(spec, true, cores) || cores.empty()) {
+    cores.clear();
+    return false;
+  }
+  sort(cores.begin(), cores.end());
+  cores.erase(unique(cores.begin(), cores.end()), cores.end());
+  return true;
+}
+
+const vector<unsigned int>& ThreadAffinity::GetCores(const string& group) {
+  static const vector<unsigned int> none;
+  const auto& groups = Groups();
+  const auto it = groups.find(group);
+  return it == groups.end() ? none : it->second;
+}
+
+bool ThreadAffinity::Apply(const string& group) {
+  NameThread(group);
+  const auto& cores = GetCores(group);
+  if (cores.empty()) {
+    return true;
+  }
+  if (!PinCores(cores)) {
+    LOG_GENERAL(WARNING, "Failed to pin a thread of group " << group);
+    return false;
+  }
+  return true;
+}
+
+bool ThreadAffinity::Apply(const string& group, unsigned int index) {
+  NameThread(group);
+  const auto& cores = GetCores(group);
+  if (cores.empty()) {
+    return true;
+  }
+  if (!PinCores({cores[index % cores.size()]})) {
+    LOG_GENERAL(WARNING, "Failed to pin thread " << index << " of group "
+                                                 << group);
+    return false;
+  }
+  return true;
+}
+
+bool ThreadAffinity::PinCores(const vector<unsigned int>& cores) {
+#if defined(__linux__)
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  for (const auto& core : cores) {
+    CPU_SET(core, &cpuSet);
+  }
+  return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+#else
+  (void)cores;
+  return false;
+#endif
+}
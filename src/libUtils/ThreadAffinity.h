@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_THREADAFFINITY_H_
+#define ZILLIQA_SRC_LIBUTILS_THREADAFFINITY_H_
+
+#include <string>
+#include <vector>
+
+/// Places the threads of the node on the cores set for their group in
+/// THREAD_AFFINITY_GROUPS. A group is named after the pool or thread it
+/// covers (e.g. SendPool, QueuePool, ReceiveLoop, Miner), and a thread of a
+/// group that is not listed floats over all the cores as before.
+class ThreadAffinity {
+ public:
+  /// Parses a core list such as "0-3,8,numa1" into sorted distinct cores. A
+  /// numaN item stands for the cores of NUMA node N.
+  static bool ParseCores(const std::string& spec,
+                         std::vector<unsigned int>& cores);
+
+  /// Returns the cores set for a group, or none if the group is not listed.
+  static const std::vector<unsigned int>& GetCores(const std::string& group);
+
+  /// Names the calling thread after its group and pins it to the cores of
+  /// the group. Returns false if the group is listed but cannot be applied.
+  static bool Apply(const std::string& group);
+
+  /// As Apply, but pins the thread to the one core of the group picked by
+  /// index, for the groups whose threads each want a core of their own.
+  static bool Apply(const std::string& group, unsigned int index);
+
+  /// Pins the calling thread to cores. Does not log or allocate, so that it
+  /// can be called in a forked child before exec.
+  static bool PinCores(const std::vector<unsigned int>& cores);
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_THREADAFFINITY_H_
@@ -18,79 +18,103 @@
 #ifndef ZILLIQA_SRC_LIBUTILS_THREADPOOL_H_
 #define ZILLIQA_SRC_LIBUTILS_THREADPOOL_H_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
-
-/**
- *  Set to 1 to use vector instead of queue for jobs container to improve
- *  memory locality however changes job order from FIFO to LIFO.
- */
-#define CONTIGUOUS_JOBS_MEMORY 0
-#if CONTIGUOUS_JOBS_MEMORY
 #include <vector>
-#else
-#include <queue>
-#endif
+
+#include "libUtils/Logger.h"
+#include "libUtils/ThreadAffinity.h"
 
 /**
- * Simple thread pool that creates `threadCount` threads upon its creation, and
- * pulls from a queue to get new jobs. This class requires a number of C++11
- * features be present in your compiler.
+ * Thread pool that creates `threadCount` threads upon its creation. Each
+ * thread has its own queue of jobs, so that the threads do not contend on one
+ * lock. A job added from outside the pool goes to the queues in turn, and a job
+ * added by a job of the pool goes to the queue of the thread running it. A
+ * thread with nothing left in its queue takes jobs from the other queues. High
+ * priority jobs are kept in a queue of their own, which comes first.
  */
 class ThreadPool {
  public:
   typedef std::function<void()> Job;
+  typedef std::chrono::steady_clock Clock;
+
+  enum class Priority : unsigned char { NORMAL, HIGH };
+
+  /// Counters of the pool since its creation
+  struct Stats {
+    uint64_t m_jobsDone;
+    uint64_t m_jobsStolen;
+    unsigned int m_maxQueueDepth;
+    std::chrono::microseconds m_totalWait;
+    std::chrono::microseconds m_maxWait;
+  };
 
   /// Constructor.
-#if CONTIGUOUS_JOBS_MEMORY
-  explicit ThreadPool(const unsigned int threadCount,
-                      const std::string& poolName,
-                      const unsigned int jobsReserveCount = 0)
-#else
   explicit ThreadPool(const unsigned int threadCount,
                       const std::string& poolName)
-#endif
       : _jobsLeft(0),
+        _queued(0),
+        _nextQueue(0),
         _bailout(false),
         _poolName(poolName),
-        _jobAvailableVar(),
-        _jobsLeftMutex(),
-        _queueMutex() {
-    _threads.reserve(threadCount);
+        _jobsDone(0),
+        _jobsStolen(0),
+        _maxQueueDepth(0),
+        _totalWaitMicros(0),
+        _maxWaitMicros(0) {
+    _queues.reserve(threadCount);
     for (unsigned int index = 0; index < threadCount; ++index) {
-      _threads.push_back(std::thread([this] { this->Task(); }));
+      _queues.emplace_back(new Queue());
     }
-
-#if CONTIGUOUS_JOBS_MEMORY
-    if (jobsReserveCount > 0) {
-      _queue.reserve(jobsReserveCount);
+    _threads.reserve(threadCount);
+    for (unsigned int index = 0; index < threadCount; ++index) {
+      _threads.push_back(std::thread([this, index] { this->Task(index); }));
     }
-#endif
   }
 
   /// Destructor (JoinAll on deconstruction).
   ~ThreadPool() { JoinAll(); }
 
-  /// Adds a new job to the pool. If there are no jobs in the queue, a thread is
-  /// woken up to take the job. If all threads are busy, the job is added to the
-  /// end of the queue.
-  void AddJob(const Job& job) {
-    std::lock(_queueMutex, _jobsLeftMutex);
-    std::lock_guard<std::mutex> lg1(_queueMutex, std::adopt_lock);
-    std::lock_guard<std::mutex> lg2(_jobsLeftMutex, std::adopt_lock);
-
-#if CONTIGUOUS_JOBS_MEMORY
-    _queue.push_back(job);
-#else
-    _queue.push(job);
-#endif
-    ++_jobsLeft;
+  /// Adds a new job to the pool and wakes up a thread if one is idle. Jobs of
+  /// a queue run in the order they were added.
+  void AddJob(Job job, Priority priority = Priority::NORMAL) {
+    Queue* queue = &_highPriorityQueue;
+    if (priority == Priority::NORMAL && !_queues.empty()) {
+      const auto& current = CurrentWorker();
+      queue = current.first == this
+                  ? _queues[current.second].get()
+                  : _queues[_nextQueue++ % _queues.size()].get();
+    }
+
+    // Counted first so that the counters never go below the queued jobs
+    const int jobsLeft = ++_jobsLeft;
+    const unsigned int queued = ++_queued;
+    unsigned int maxQueueDepth = _maxQueueDepth;
+    while (queued > maxQueueDepth &&
+           !_maxQueueDepth.compare_exchange_weak(maxQueueDepth, queued)) {
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(queue->m_mutex);
+      queue->m_jobs.push_back({std::move(job), Clock::now()});
+    }
+
+    // Taken so that a thread about to wait sees the job or gets notified
+    { std::lock_guard<std::mutex> lock(_idleMutex); }
     _jobAvailableVar.notify_one();
 
-    if (0 == _jobsLeft % 100) {
-      LOG_GENERAL(INFO, "PoolName: " << _poolName << " JobLeft: " << _jobsLeft);
+    if (0 == jobsLeft % 100) {
+      LOG_GENERAL(INFO, "PoolName: " << _poolName << " JobLeft: " << jobsLeft
+                                     << " AvgWaitUs: "
+                                     << GetAverageWaitMicros());
     }
   }
 
@@ -100,7 +124,7 @@ class ThreadPool {
   void JoinAll() {
     // scoped lock
     {
-      std::lock_guard<std::mutex> lock(_queueMutex);
+      std::lock_guard<std::mutex> lock(_idleMutex);
       if (_bailout) {
         return;
       }
@@ -124,75 +148,150 @@ class ThreadPool {
     }
   }
 
-  /// Gets the vector of threads themselves, in order to set the affinity, or
-  /// anything else you might want to do
+  /// Gets the vector of threads themselves. The threads place themselves on
+  /// the cores of the thread group named after the pool.
   std::vector<std::thread>& GetThreads() { return _threads; }
 
-  /// Returns the number of jobs in the queue
-  int GetJobsLeft() {
-    std::lock_guard<std::mutex> lock(_jobsLeftMutex);
-    return _jobsLeft;
+  /// Returns the number of jobs queued or running
+  int GetJobsLeft() { return _jobsLeft; }
+
+  /// Blocks until at most maxJobsLeft jobs are queued or running
+  void WaitForJobsLeft(int maxJobsLeft) {
+    std::unique_lock<std::mutex> lock(_jobDoneMutex);
+    ++_jobDoneWaiters;
+    _jobDoneVar.wait(lock,
+                     [this, maxJobsLeft] { return _jobsLeft <= maxJobsLeft; });
+    --_jobDoneWaiters;
+  }
+
+  /// Returns the number of jobs waiting for a thread
+  unsigned int GetQueueDepth() { return _queued; }
+
+  Stats GetStats() {
+    return {_jobsDone, _jobsStolen, _maxQueueDepth,
+            std::chrono::microseconds(_totalWaitMicros),
+            std::chrono::microseconds(_maxWaitMicros)};
   }
 
  private:
+  struct Entry {
+    Job m_job;
+    Clock::time_point m_queuedAt;
+  };
+
+  struct Queue {
+    std::mutex m_mutex;
+    std::deque<Entry> m_jobs;
+  };
+
+  /// The pool and index of the thread calling, if it belongs to a pool
+  static std::pair<const ThreadPool*, unsigned int>& CurrentWorker() {
+    static thread_local std::pair<const ThreadPool*, unsigned int> current{
+        nullptr, 0};
+    return current;
+  }
+
+  static bool Pop(Queue& queue, Entry& entry) {
+    std::lock_guard<std::mutex> lock(queue.m_mutex);
+    if (queue.m_jobs.empty()) {
+      return false;
+    }
+    entry = std::move(queue.m_jobs.front());
+    queue.m_jobs.pop_front();
+    return true;
+  }
+
+  /// Takes the next job for thread index: a high priority one, else one of
+  /// its own, else one of another thread
+  bool Take(unsigned int index, Entry& entry) {
+    if (Pop(_highPriorityQueue, entry) || Pop(*_queues[index], entry)) {
+      return true;
+    }
+    for (unsigned int i = 1; i < _queues.size(); ++i) {
+      if (Pop(*_queues[(index + i) % _queues.size()], entry)) {
+        ++_jobsStolen;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  uint64_t GetAverageWaitMicros() {
+    const uint64_t jobsDone = _jobsDone;
+    return jobsDone == 0 ? 0 : _totalWaitMicros / jobsDone;
+  }
+
   /**
-   *  Take the next job in the queue and run it.
-   *  Notify the main thread that a job has completed.
+   *  Take the next job for the thread and run it.
+   *  Wait for a job when none is left in any queue.
    */
-  void Task() {
+  void Task(unsigned int index) {
+    CurrentWorker() = {this, index};
+    ThreadAffinity::Apply(_poolName);
+
     while (true) {
-      Job job;
+      Entry entry;
 
-      // scoped lock
-      {
-        std::unique_lock<std::mutex> lock(_queueMutex);
-
-        if (_bailout) {
-          return;
-        }
+      if (!Take(index, entry)) {
+        std::unique_lock<std::mutex> lock(_idleMutex);
 
         // Wait for a job if we don't have any.
-        _jobAvailableVar.wait(lock,
-                              [this] { return !_queue.empty() || _bailout; });
-
+        _jobAvailableVar.wait(lock, [this] { return _queued > 0 || _bailout; });
         if (_bailout) {
           return;
         }
+        continue;
+      }
+
+      if (_bailout) {
+        return;
+      }
 
-        // Get job from the queue
-#if CONTIGUOUS_JOBS_MEMORY
-        job = _queue.back();
-        _queue.pop_back();
-#else
-        job = _queue.front();
-        _queue.pop();
-#endif
+      --_queued;
+      const uint64_t wait =
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              Clock::now() - entry.m_queuedAt)
+              .count();
+      _totalWaitMicros += wait;
+      uint64_t maxWait = _maxWaitMicros;
+      while (wait > maxWait &&
+             !_maxWaitMicros.compare_exchange_weak(maxWait, wait)) {
       }
 
-      job();
+      entry.m_job();
 
-      // scoped lock
-      {
-        std::lock_guard<std::mutex> lock(_jobsLeftMutex);
-        --_jobsLeft;
+      ++_jobsDone;
+      --_jobsLeft;
+
+      // Checked after the decrement, so that a waiter either sees the
+      // decrement or is seen here
+      if (_jobDoneWaiters > 0) {
+        { std::lock_guard<std::mutex> lock(_jobDoneMutex); }
+        _jobDoneVar.notify_all();
       }
     }
   }
 
   std::vector<std::thread> _threads;
-#if CONTIGUOUS_JOBS_MEMORY
-  std::vector<Job> _queue;
-#else
-  std::queue<Job> _queue;
-#endif
-
-  int _jobsLeft;
-  bool _bailout;
+  std::vector<std::unique_ptr<Queue>> _queues;
+  Queue _highPriorityQueue;
+
+  std::atomic<int> _jobsLeft;
+  std::atomic<unsigned int> _queued;
+  std::atomic<unsigned int> _nextQueue;
+  std::atomic<bool> _bailout;
   std::string _poolName;
   std::condition_variable _jobAvailableVar;
-  std::mutex _jobsLeftMutex;
-  std::mutex _queueMutex;
+  std::mutex _idleMutex;
+  std::condition_variable _jobDoneVar;
+  std::mutex _jobDoneMutex;
+  std::atomic<unsigned int> _jobDoneWaiters{0};
+
+  std::atomic<uint64_t> _jobsDone;
+  std::atomic<uint64_t> _jobsStolen;
+  std::atomic<unsigned int> _maxQueueDepth;
+  std::atomic<uint64_t> _totalWaitMicros;
+  std::atomic<uint64_t> _maxWaitMicros;
 };
 
-#undef CONTIGUOUS_JOBS_MEMORY
 #endif  // ZILLIQA_SRC_LIBUTILS_THREADPOOL_H_
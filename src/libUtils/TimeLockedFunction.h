@@ -19,79 +19,94 @@
 #define ZILLIQA_SRC_LIBUTILS_TIMELOCKEDFUNCTION_H_
 
 #include <chrono>
+#include <condition_variable>
 #include <functional>
-#include <future>
 #include <memory>
-#include <thread>
+#include <mutex>
 
+#include "libUtils/DetachedExecutor.h"
 #include "libUtils/Logger.h"
+#include "libUtils/TimerWheel.h"
 
 /// Utility class for executing a primary function and a subsequent expiry
-/// function in separate join-able threads.
+/// function. The primary function runs on a thread kept by DetachedExecutor
+/// and the expiry is a TimerWheel timer, so no thread is started for either.
 class TimeLockedFunction {
  private:
-  std::shared_ptr<std::promise<int>> result_promise;
-  std::future<int> result_future;
+  struct State {
+    std::mutex m_mutex;
+    std::condition_variable m_cvDone;
+    // Whether the primary function or the timer came first
+    bool m_decided{false};
+    bool m_mainDone{false};
+    bool m_timerDone{false};
+  };
 
-  std::unique_ptr<std::thread> thread_main;
-  std::unique_ptr<std::thread> thread_timer;
+  std::shared_ptr<State> m_state;
 
  public:
   /// Template constructor.
   template <class callable1, class callable2>
   TimeLockedFunction(unsigned int expiration_in_seconds, callable1&& main_func,
                      callable2&& expiration_func, bool call_expiry_always)
-      : result_promise(new std::promise<int>) {
+      : m_state(std::make_shared<State>()) {
     std::function<typename std::result_of<callable1()>::type()> task_main(
         main_func);
     std::function<typename std::result_of<callable2()>::type()> task_expiry(
         expiration_func);
 
-    result_future = result_promise->get_future();
+    auto state = m_state;
+    const auto handle = TimerWheel::GetInstance().ScheduleAfter(
+        [state, expiration_in_seconds, task_expiry]() {
+          bool expired = false;
+          {
+            std::lock_guard<std::mutex> g(state->m_mutex);
+            expired = !state->m_decided;
+            state->m_decided = true;
+          }
+          if (expired) {
+            LOG_GENERAL(INFO, "Expired after " +
+                                  std::to_string(expiration_in_seconds) +
+                                  " seconds");
+            task_expiry();
+          }
+          std::lock_guard<std::mutex> g(state->m_mutex);
+          state->m_timerDone = true;
+          state->m_cvDone.notify_all();
+        },
+        std::chrono::seconds(expiration_in_seconds));
 
-    auto func_main =
-        [task_main, task_expiry, call_expiry_always](
-            std::shared_ptr<std::promise<int>> result_promise) -> void {
-      try {
-        task_main();
-        result_promise->set_value(0);
-        if (call_expiry_always) {
-          task_expiry();
-        }
-      } catch (std::future_error&) {
-        // Function returned too late
-      }
-    };
-
-    thread_main = std::make_unique<std::thread>(func_main, result_promise);
-
-    auto func_timer =
-        [expiration_in_seconds, task_expiry](
-            std::shared_ptr<std::promise<int>> result_promise) -> void {
-      try {
-        LOG_GENERAL(INFO, "Entering sleep for " +
-                              std::to_string(expiration_in_seconds) +
-                              " seconds");
-        std::this_thread::sleep_for(
-            std::chrono::seconds(expiration_in_seconds));
-        LOG_GENERAL(INFO, "Woken up from the sleep of " +
-                              std::to_string(expiration_in_seconds) +
-                              " seconds");
-        result_promise->set_value(-1);
-        task_expiry();
-      } catch (std::future_error&) {
-        // Function returned on time
-      }
-    };
-
-    thread_timer = std::make_unique<std::thread>(func_timer, result_promise);
+    DetachedExecutor::GetInstance().Run(
+        [state, handle, task_main, task_expiry, call_expiry_always]() {
+          task_main();
+          bool onTime = false;
+          {
+            std::lock_guard<std::mutex> g(state->m_mutex);
+            onTime = !state->m_decided;
+            state->m_decided = true;
+          }
+          if (onTime) {
+            if (TimerWheel::GetInstance().Cancel(handle)) {
+              std::lock_guard<std::mutex> g(state->m_mutex);
+              state->m_timerDone = true;
+            }
+            if (call_expiry_always) {
+              task_expiry();
+            }
+          }
+          std::lock_guard<std::mutex> g(state->m_mutex);
+          state->m_mainDone = true;
+          state->m_cvDone.notify_all();
+        });
   }
 
-  /// Destructor. Joins both launched threads.
+  /// Destructor. Waits for the primary function, and for the expiry function
+  /// if the timer fired.
   ~TimeLockedFunction() {
-    thread_main->join();
-    thread_timer->join();
-    result_future.get();
+    std::unique_lock<std::mutex> lock(m_state->m_mutex);
+    m_state->m_cvDone.wait(lock, [this]() {
+      return m_state->m_mainDone && m_state->m_timerDone;
+    });
   }
 };
 
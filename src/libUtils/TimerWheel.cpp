@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TimerWheel.h"
+#include "libUtils/DetachedExecutor.h"
+
+using namespace std;
+
+TimerWheel::TimerWheel(chrono::milliseconds tick, unsigned int numSlots)
+    : m_tick(max(tick, chrono::milliseconds(1))),
+      m_startTime(Clock::now()),
+      m_slots(max(numSlots, 1u)) {
+  // Made first so that it is still there while the wheel is destroyed
+  DetachedExecutor::GetInstance();
+  m_thread = thread([this]() { Run(); });
+}
+
+TimerWheel::~TimerWheel() {
+  {
+    lock_guard<mutex> g(m_mutex);
+    m_stop = true;
+  }
+  m_cvTimer.notify_all();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+TimerWheel::Handle TimerWheel::ScheduleAfter(Callback callback,
+                                             chrono::milliseconds delay) {
+  Handle handle;
+  {
+    lock_guard<mutex> g(m_mutex);
+    // The tick now is under way, so a timer expires at the end of a later one
+    const uint64_t expiryTick =
+        max(GetTick(Clock::now() + max(delay, chrono::milliseconds(0))),
+            m_lastTick) +
+        1;
+    handle = m_nextHandle++;
+    auto& slot = m_slots[expiryTick % m_slots.size()];
+    slot.push_back({handle, expiryTick, move(callback)});
+    m_timers.emplace(handle, prev(slot.end()));
+  }
+  m_cvTimer.notify_one();
+  return handle;
+}
+
+bool TimerWheel::Cancel(Handle handle) {
+  lock_guard<mutex> g(m_mutex);
+  auto it = m_timers.find(handle);
+  if (it == m_timers.end()) {
+    return false;
+  }
+  m_slots[it->second->m_expiryTick % m_slots.size()].erase(it->second);
+  m_timers.erase(it);
+  return true;
+}
+
+size_t TimerWheel::GetPendingCount() {
+  lock_guard<mutex> g(m_mutex);
+  return m_timers.size();
+}
+
+uint64_t TimerWheel::GetTick(const Clock::time_point& time) const {
+  return chrono::duration_cast<chrono::milliseconds>(time - m_startTime)
+             .count() /
+         m_tick.count();
+}
+
+void TimerWheel::Run() {
+  unique_lock<mutex> lock(m_mutex);
+  while (!m_stop) {
+    if (m_timers.empty()) {
+      m_cvTimer.wait(lock, [this]() { return m_stop || !m_timers.empty(); });
+      continue;
+    }
+
+    const uint64_t nowTick = GetTick(Clock::now());
+    if (nowTick <= m_lastTick) {
+      m_cvTimer.wait_until(lock, m_startTime + m_tick * (m_lastTick + 1));
+      continue;
+    }
+
+    // Goes through the ticks that went by, at most one turn of the wheel
+    vector<Callback> expired;
+    const uint64_t firstTick =
+        max(m_lastTick + 1, nowTick >= m_slots.size()
+                                ? nowTick - m_slots.size() + 1
+                                : 0);
+    for (uint64_t tick = firstTick; tick <= nowTick; tick++) {
+      auto& slot = m_slots[tick % m_slots.size()];
+      for (auto it = slot.begin(); it != slot.end();) {
+        if (it->m_expiryTick <= nowTick) {
+          expired.emplace_back(move(it->m_callback));
+          m_timers.erase(it->m_handle);
+          it = slot.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    m_lastTick = nowTick;
+
+    lock.unlock();
+    for (auto& callback : expired) {
+      DetachedExecutor::GetInstance().Run(move(callback));
+    }
+    lock.lock();
+  }
+}
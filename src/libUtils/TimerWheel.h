@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_TIMERWHEEL_H_
+#define ZILLIQA_SRC_LIBUTILS_TIMERWHEEL_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/Singleton.h"
+
+/// Hashed timer wheel that runs callbacks once their delay is over, on one
+/// thread. Time is cut into ticks, and a timer goes into the slot of the tick
+/// it expires at, so that adding and cancelling a timer take constant time.
+/// Each tick, the timers of its slot that expire at it are handed to
+/// DetachedExecutor, while those of later turns of the wheel stay. A timer
+/// fires at the end of its tick, never early.
+class TimerWheel : public Singleton<TimerWheel> {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Handle = uint64_t;
+  using Callback = std::function<void()>;
+
+  /// Never returned for a timer
+  static const Handle INVALID_HANDLE = 0;
+
+  explicit TimerWheel(
+      std::chrono::milliseconds tick = std::chrono::milliseconds(10),
+      unsigned int numSlots = 512);
+  ~TimerWheel();
+
+  /// Runs callback once delay is over
+  Handle ScheduleAfter(Callback callback, std::chrono::milliseconds delay);
+
+  /// Drops the timer of handle, and returns false if it already fired
+  bool Cancel(Handle handle);
+
+  /// Returns the number of timers yet to fire
+  size_t GetPendingCount();
+
+ private:
+  struct Timer {
+    Handle m_handle;
+    uint64_t m_expiryTick;
+    Callback m_callback;
+  };
+
+  uint64_t GetTick(const Clock::time_point& time) const;
+  void Run();
+
+  const std::chrono::milliseconds m_tick;
+  const Clock::time_point m_startTime;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cvTimer;
+  std::vector<std::list<Timer>> m_slots;
+  std::unordered_map<Handle, std::list<Timer>::iterator> m_timers;
+  Handle m_nextHandle{INVALID_HANDLE + 1};
+  uint64_t m_lastTick{0};
+  bool m_stop{false};
+  std::thread m_thread;
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_TIMERWHEEL_H_
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+
+#include "TraceRecorder.h"
+#include "common/Constants.h"
+#include "libUtils/JsonUtils.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+TraceRecorder& TraceRecorder::GetInstance() {
+  static TraceRecorder tr;
+  return tr;
+}
+
+uint64_t TraceRecorder::NowInMicro() {
+  return chrono::duration_cast<chrono::microseconds>(
+             chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+void TraceRecorder::AddEvent(Json::Value&& event) {
+  lock_guard<mutex> g(m_mutex);
+  if (m_events.size() >= MAX_EVENTS) {
+    return;
+  }
+  m_events.emplace_back(move(event));
+}
+
+void TraceRecorder::Complete(const string& name, const string& category,
+                             uint32_t pid, uint32_t tid, uint64_t startInMicro,
+                             uint64_t durInMicro, const Json::Value& args) {
+  Json::Value event;
+  event["name"] = name;
+  event["cat"] = category;
+  event["ph"] = "X";
+  event["pid"] = pid;
+  event["tid"] = tid;
+  event["ts"] = Json::UInt64(startInMicro);
+  event["dur"] = Json::UInt64(durInMicro);
+  event["args"] = args;
+  AddEvent(move(event));
+}
+
+void TraceRecorder::Instant(const string& name, const string& category,
+                            uint32_t pid, uint32_t tid, uint64_t tsInMicro,
+                            const Json::Value& args) {
+  Json::Value event;
+  event["name"] = name;
+  event["cat"] = category;
+  event["ph"] = "i";
+  event["s"] = "t";
+  event["pid"] = pid;
+  event["tid"] = tid;
+  event["ts"] = Json::UInt64(tsInMicro);
+  event["args"] = args;
+  AddEvent(move(event));
+}
+
+void TraceRecorder::SetProcessName(uint32_t pid, const string& name) {
+  lock_guard<mutex> g(m_mutex);
+  m_processNames[pid] = name;
+}
+
+void TraceRecorder::SetThreadName(uint32_t pid, uint32_t tid,
+                                  const string& name) {
+  lock_guard<mutex> g(m_mutex);
+  m_threadNames[{pid, tid}] = name;
+}
+
+Json::Value TraceRecorder::GetTrace() {
+  lock_guard<mutex> g(m_mutex);
+
+  Json::Value _json;
+  Json::Value& events = _json["traceEvents"];
+  events = Json::Value(Json::arrayValue);
+
+  for (const auto& it : m_processNames) {
+    Json::Value meta;
+    meta["name"] = "process_name";
+    meta["ph"] = "M";
+    meta["pid"] = it.first;
+    meta["args"]["name"] = it.second;
+    events.append(meta);
+  }
+  for (const auto& it : m_threadNames) {
+    Json::Value meta;
+    meta["name"] = "thread_name";
+    meta["ph"] = "M";
+    meta["pid"] = it.first.first;
+    meta["tid"] = it.first.second;
+    meta["args"]["name"] = it.second;
+    events.append(meta);
+  }
+  for (const auto& event : m_events) {
+    events.append(event);
+  }
+
+  _json["displayTimeUnit"] = "ms";
+  return _json;
+}
+
+void TraceRecorder::Flush(uint64_t epochNum) {
+  {
+    lock_guard<mutex> g(m_mutex);
+    if (m_events.empty()) {
+      return;
+    }
+  }
+
+  const Json::Value trace = GetTrace();
+  Clear();
+
+  const string path =
+      STORAGE_PATH + "/consensus_trace_" + to_string(epochNum) + ".json";
+  JSONUtils::GetInstance().writeJsontoFile(path, trace);
+  LOG_GENERAL(INFO, "Consensus trace written to " << path);
+}
+
+void TraceRecorder::Clear() {
+  lock_guard<mutex> g(m_mutex);
+  m_events.clear();
+  m_processNames.clear();
+  m_threadNames.clear();
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_TRACERECORDER_H_
+#define ZILLIQA_SRC_LIBUTILS_TRACERECORDER_H_
+
+#include <json/json.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Buffers timeline events in the Chrome trace event format, so that they can
+/// be loaded into chrome://tracing or Perfetto. Each consensus session is one
+/// process (pid = consensus ID) and each track within it is one thread.
+class TraceRecorder {
+  /// Events recorded once the buffer is full are dropped until the next flush.
+  static const unsigned int MAX_EVENTS = 100000;
+
+  std::mutex m_mutex;
+  std::vector<Json::Value> m_events;
+  std::map<uint32_t, std::string> m_processNames;
+  std::map<std::pair<uint32_t, uint32_t>, std::string> m_threadNames;
+
+  TraceRecorder() = default;
+  ~TraceRecorder() = default;
+
+  TraceRecorder(TraceRecorder const&) = delete;
+  void operator=(TraceRecorder const&) = delete;
+
+  void AddEvent(Json::Value&& event);
+
+ public:
+  /// Returns the singleton TraceRecorder instance.
+  static TraceRecorder& GetInstance();
+
+  /// Returns the wall clock time in microseconds, so traces taken on
+  /// different nodes can be lined up.
+  static uint64_t NowInMicro();
+
+  /// Records an event that started at startInMicro and lasted durInMicro.
+  void Complete(const std::string& name, const std::string& category,
+                uint32_t pid, uint32_t tid, uint64_t startInMicro,
+                uint64_t durInMicro,
+                const Json::Value& args = Json::Value(Json::objectValue));
+
+  /// Records a point in time event.
+  void Instant(const std::string& name, const std::string& category,
+               uint32_t pid, uint32_t tid, uint64_t tsInMicro,
+               const Json::Value& args = Json::Value(Json::objectValue));
+
+  /// Labels a process (consensus session) in the trace viewer.
+  void SetProcessName(uint32_t pid, const std::string& name);
+
+  /// Labels a thread (track) of a process in the trace viewer.
+  void SetThreadName(uint32_t pid, uint32_t tid, const std::string& name);
+
+  /// Returns the buffered events as a trace JSON object.
+  Json::Value GetTrace();
+
+  /// Writes the buffered events to STORAGE_PATH/consensus_trace_<epoch>.json
+  /// and clears the buffer.
+  void Flush(uint64_t epochNum);
+
+  /// Drops all buffered events.
+  void Clear();
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_TRACERECORDER_H_
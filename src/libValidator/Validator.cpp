@@ -15,20 +15,33 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <thread>
 #include <vector>
 
 #include "Validator.h"
+#include "libConsensus/AggregatedPubKeyCache.h"
 #include "libData/AccountData/Account.h"
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
 #include "libUtils/BitVector.h"
+#include "libUtils/ThreadPool.h"
 
 using namespace std;
 using namespace boost::multiprecision;
 
 using ShardingHash = dev::h256;
 
-Validator::Validator(Mediator& mediator) : m_mediator(mediator) {}
+Validator::Validator(Mediator& mediator) : m_mediator(mediator) {
+  if (TXN_VERIFY_THREADS > 1) {
+    m_txnVerifyPool =
+        make_unique<ThreadPool>(TXN_VERIFY_THREADS, "TxnSigVerify");
+  }
+}
 
 Validator::~Validator() {}
 
@@ -39,18 +52,8 @@ bool Validator::VerifyTransaction(const Transaction& tran) {
   return Schnorr::Verify(txnData, tran.GetSignature(), tran.GetSenderPubKey());
 }
 
-bool Validator::CheckCreatedTransaction(const Transaction& tx,
-                                        TransactionReceipt& receipt) const {
-  if (LOOKUP_NODE_MODE) {
-    LOG_GENERAL(WARNING,
-                "Validator::CheckCreatedTransaction not expected to be "
-                "called from LookUp node.");
-    return true;
-  }
-  // LOG_MARKER();
-
-  // LOG_GENERAL(INFO, "Tran: " << tx.GetTranID());
-
+bool Validator::PreCheckCreatedTransaction(const Transaction& tx,
+                                           TransactionReceipt& receipt) const {
   if (DataConversion::UnpackA(tx.GetVersion()) != CHAIN_ID) {
     LOG_GENERAL(WARNING, "CHAIN_ID incorrect");
     return false;
@@ -85,11 +88,72 @@ bool Validator::CheckCreatedTransaction(const Transaction& tx,
 
   receipt.SetEpochNum(m_mediator.m_currentEpochNum);
 
+  return true;
+}
+
+bool Validator::CheckCreatedTransaction(const Transaction& tx,
+                                        TransactionReceipt& receipt) const {
+  if (LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Validator::CheckCreatedTransaction not expected to be "
+                "called from LookUp node.");
+    return true;
+  }
+  // LOG_MARKER();
+
+  // LOG_GENERAL(INFO, "Tran: " << tx.GetTranID());
+
+  if (!PreCheckCreatedTransaction(tx, receipt)) {
+    return false;
+  }
+
   return AccountStore::GetInstance().UpdateAccountsTemp(
       m_mediator.m_currentEpochNum, m_mediator.m_node->getNumShards(),
       m_mediator.m_ds->m_mode != DirectoryService::Mode::IDLE, tx, receipt);
 }
 
+void Validator::CheckCreatedTransactions(const vector<Transaction>& txns,
+                                         vector<TransactionReceipt>& receipts,
+                                         vector<char>& results) const {
+  if (LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Validator::CheckCreatedTransactions not expected to be "
+                "called from LookUp node.");
+    results.assign(txns.size(), true);
+    return;
+  }
+
+  results.assign(txns.size(), false);
+  receipts.resize(txns.size());
+
+  // The pre-checks only read the main account store, which the transactions
+  // do not change, so dropping the failed ones keeps the rest in order
+  vector<unsigned int> indexes;
+  vector<Transaction> passed;
+  vector<TransactionReceipt> passedReceipts;
+  for (unsigned int i = 0; i < txns.size(); i++) {
+    if (PreCheckCreatedTransaction(txns.at(i), receipts.at(i))) {
+      indexes.emplace_back(i);
+      passed.emplace_back(txns.at(i));
+      passedReceipts.emplace_back(receipts.at(i));
+    }
+  }
+
+  vector<char> passedResults;
+  if (!AccountStore::GetInstance().UpdateAccountsTempParallel(
+          m_mediator.m_currentEpochNum, m_mediator.m_node->getNumShards(),
+          m_mediator.m_ds->m_mode != DirectoryService::Mode::IDLE, passed,
+          passedReceipts, passedResults)) {
+    LOG_GENERAL(WARNING, "UpdateAccountsTempParallel failed");
+    return;
+  }
+
+  for (unsigned int i = 0; i < indexes.size(); i++) {
+    results.at(indexes.at(i)) = passedResults.at(i);
+    receipts.at(indexes.at(i)) = move(passedReceipts.at(i));
+  }
+}
+
 bool Validator::CheckCreatedTransactionFromLookup(const Transaction& tx) {
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
@@ -100,6 +164,127 @@ bool Validator::CheckCreatedTransactionFromLookup(const Transaction& tx) {
 
   // LOG_MARKER();
 
+  if (!PreCheckCreatedTransactionFromLookup(tx)) {
+    return false;
+  }
+
+  if (!VerifyTransaction(tx)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Signature incorrect: " << tx.GetSenderAddr()
+                                      << ". Transaction rejected: "
+                                      << tx.GetTranID());
+    return false;
+  }
+
+  return true;
+}
+
+void Validator::CheckCreatedTransactionsFromLookup(
+    const vector<Transaction>& txns, vector<char>& results,
+    const bool attested) {
+  if (LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Validator::CheckCreatedTransactionsFromLookup not expected "
+                "to be called from LookUp node.");
+    results.assign(txns.size(), true);
+    return;
+  }
+
+  results.assign(txns.size(), false);
+
+  // The other checks are cheap, so only their survivors get verified
+  vector<unsigned int> indexes;
+  for (unsigned int i = 0; i < txns.size(); i++) {
+    if (PreCheckCreatedTransactionFromLookup(txns.at(i))) {
+      indexes.emplace_back(i);
+    }
+  }
+
+  if (attested) {
+    for (const auto& i : indexes) {
+      results.at(i) = true;
+    }
+    return;
+  }
+
+  VerifyTransactionsAt(txns, indexes, results);
+
+  for (const auto& i : indexes) {
+    if (!results.at(i)) {
+      LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+                "Signature incorrect: " << txns.at(i).GetSenderAddr()
+                                        << ". Transaction rejected: "
+                                        << txns.at(i).GetTranID());
+    }
+  }
+}
+
+void Validator::CheckPendingTransactions(const vector<Transaction>& txns,
+                                         vector<char>& results) {
+  results.assign(txns.size(), false);
+
+  vector<unsigned int> indexes;
+  for (unsigned int i = 0; i < txns.size(); i++) {
+    const auto& tx = txns.at(i);
+    if (DataConversion::UnpackA(tx.GetVersion()) != CHAIN_ID) {
+      continue;
+    }
+    // Taken in a block while the node was down
+    AccountSnapshot::Entry sender;
+    if (!AccountStore::GetInstance().GetCommittedBalanceAndNonce(
+            tx.GetSenderAddr(), sender) ||
+        sender.m_nonce >= tx.GetNonce()) {
+      continue;
+    }
+    if (!LOOKUP_NODE_MODE && !PreCheckCreatedTransactionFromLookup(tx)) {
+      continue;
+    }
+    indexes.emplace_back(i);
+  }
+
+  VerifyTransactionsAt(txns, indexes, results);
+}
+
+void Validator::VerifyTransactionsAt(const vector<Transaction>& txns,
+                                     const vector<unsigned int>& indexes,
+                                     vector<char>& results) {
+  if (!m_txnVerifyPool || indexes.size() < 2) {
+    for (const auto& i : indexes) {
+      results.at(i) = VerifyTransaction(txns.at(i));
+    }
+  } else {
+    // Split the transactions into one contiguous chunk per thread
+    const size_t numChunks = min<size_t>(TXN_VERIFY_THREADS, indexes.size());
+    const size_t chunkSize = (indexes.size() + numChunks - 1) / numChunks;
+
+    mutex mutexDone;
+    condition_variable cvDone;
+    size_t chunksLeft = 0;
+
+    for (size_t start = 0; start < indexes.size(); start += chunkSize) {
+      const size_t end = min(start + chunkSize, indexes.size());
+      {
+        lock_guard<mutex> g(mutexDone);
+        chunksLeft++;
+      }
+      m_txnVerifyPool->AddJob([&txns, &results, &indexes, &mutexDone, &cvDone,
+                               &chunksLeft, start, end]() {
+        for (size_t j = start; j < end; j++) {
+          results.at(indexes.at(j)) = VerifyTransaction(txns.at(indexes.at(j)));
+        }
+        lock_guard<mutex> g(mutexDone);
+        if (--chunksLeft == 0) {
+          cvDone.notify_one();
+        }
+      });
+    }
+
+    unique_lock<mutex> lock(mutexDone);
+    cvDone.wait(lock, [&chunksLeft] { return chunksLeft == 0; });
+  }
+}
+
+bool Validator::PreCheckCreatedTransactionFromLookup(const Transaction& tx) {
   if (DataConversion::UnpackA(tx.GetVersion()) != CHAIN_ID) {
     LOG_GENERAL(WARNING, "CHAIN_ID incorrect");
     return false;
@@ -171,15 +356,11 @@ bool Validator::CheckCreatedTransactionFromLookup(const Transaction& tx) {
     return false;
   }
 
-  if (!VerifyTransaction(tx)) {
-    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
-              "Signature incorrect: " << fromAddr << ". Transaction rejected: "
-                                      << tx.GetTranID());
-    return false;
-  }
-
-  // Check if from account exists in local storage
-  if (!AccountStore::GetInstance().IsAccountExist(fromAddr)) {
+  // Check if from account exists in local storage, from the snapshot so as
+  // not to wait for a commit
+  AccountSnapshot::Entry sender;
+  if (!AccountStore::GetInstance().GetCommittedBalanceAndNonce(fromAddr,
+                                                               sender)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "fromAddr not found: " << fromAddr << ". Transaction rejected: "
                                      << tx.GetTranID());
@@ -187,11 +368,11 @@ bool Validator::CheckCreatedTransactionFromLookup(const Transaction& tx) {
   }
 
   // Check if transaction amount is valid
-  if (AccountStore::GetInstance().GetBalance(fromAddr) < tx.GetAmount()) {
+  if (sender.m_balance < tx.GetAmount()) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Insufficient funds in source account!"
-                  << " From Account  = 0x" << fromAddr << " Balance = "
-                  << AccountStore::GetInstance().GetBalance(fromAddr)
+                  << " From Account  = 0x" << fromAddr
+                  << " Balance = " << sender.m_balance
                   << " Debit Amount = " << tx.GetAmount());
     return false;
   }
@@ -207,7 +388,7 @@ bool Validator::CheckBlockCosignature(const DirectoryBlock& block,
   unsigned int index = 0;
   unsigned int count = 0;
 
-  const vector<bool>& B2 = block.GetB2();
+  const Bitmap& B2 = block.GetB2();
   if (commKeys.size() != B2.size()) {
     LOG_GENERAL(WARNING, "Mismatch: committee size = "
                              << commKeys.size()
@@ -218,8 +399,8 @@ bool Validator::CheckBlockCosignature(const DirectoryBlock& block,
   // Generate the aggregated key
   vector<PubKey> keys;
   for (auto const& kv : commKeys) {
+    keys.emplace_back(get<PubKey>(kv));
     if (B2.at(index)) {
-      keys.emplace_back(get<PubKey>(kv));
       count++;
     }
     index++;
@@ -230,7 +411,8 @@ bool Validator::CheckBlockCosignature(const DirectoryBlock& block,
     return false;
   }
 
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<PubKey> aggregatedKey =
+      AggregatedPubKeyCache::GetInstance().AggregatePubKeys(keys, B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return false;
@@ -254,6 +436,99 @@ bool Validator::CheckBlockCosignature(const DirectoryBlock& block,
   return true;
 }
 
+void Validator::CheckDirBlockCosignatures(
+    const vector<boost::variant<DSBlock, VCBlock,
+                                FallbackBlockWShardingStructure>>& dirBlocks,
+    const DequeOfNode& initDsComm, vector<char>& results) {
+  LOG_MARKER();
+
+  results.assign(dirBlocks.size(), false);
+
+  const unsigned int numThreads = max(1u, thread::hardware_concurrency());
+  // Bounds the number of committee snapshots alive at any time
+  const unsigned int maxJobsInFlight = numThreads * 3;
+
+  mutex mutexJobs;
+  condition_variable cvJobs;
+  unsigned int jobsInFlight = 0;
+  atomic<bool> failed{false};
+
+  // Declared last so that its threads are joined before the above go away
+  ThreadPool pool(numThreads, "DirBlockCosigPool");
+
+  auto dispatch = [&](unsigned int index, const function<bool()>& verify) {
+    {
+      unique_lock<mutex> lock(mutexJobs);
+      cvJobs.wait(lock, [&] { return jobsInFlight < maxJobsInFlight; });
+      jobsInFlight++;
+    }
+    pool.AddJob([&, index, verify]() {
+      results.at(index) = verify();
+      if (!results.at(index)) {
+        failed = true;
+      }
+      {
+        lock_guard<mutex> g(mutexJobs);
+        jobsInFlight--;
+      }
+      cvJobs.notify_all();
+    });
+  };
+
+  // Deriving the committee is cheap, so it runs ahead of the verification
+  auto dsComm = make_shared<const DequeOfNode>(initDsComm);
+
+  for (unsigned int i = 0; (i < dirBlocks.size()) && !failed; i++) {
+    const auto& dirBlock = dirBlocks.at(i);
+    if (typeid(DSBlock) == dirBlock.type()) {
+      const auto& dsblock = get<DSBlock>(dirBlock);
+      dispatch(i, [this, &dsblock, dsComm]() {
+        return CheckBlockCosignature(dsblock, *dsComm);
+      });
+      auto nextDsComm = make_shared<DequeOfNode>(*dsComm);
+      m_mediator.m_node->UpdateDSCommitteeComposition(*nextDsComm, dsblock);
+      dsComm = move(nextDsComm);
+    } else if (typeid(VCBlock) == dirBlock.type()) {
+      const auto& vcblock = get<VCBlock>(dirBlock);
+      dispatch(i, [this, &vcblock, dsComm]() {
+        return CheckBlockCosignature(vcblock, *dsComm);
+      });
+      auto nextDsComm = make_shared<DequeOfNode>(*dsComm);
+      m_mediator.m_node->UpdateRetrieveDSCommitteeCompositionAfterVC(
+          vcblock, *nextDsComm);
+      dsComm = move(nextDsComm);
+    } else if (typeid(FallbackBlockWShardingStructure) == dirBlock.type()) {
+      const auto& fallbackwshardingstructure =
+          get<FallbackBlockWShardingStructure>(dirBlock);
+      const auto& fallbackblock = fallbackwshardingstructure.m_fallbackblock;
+      const DequeOfShard& shards = fallbackwshardingstructure.m_shards;
+      const uint32_t shard_id = fallbackblock.GetHeader().GetShardId();
+
+      if (shard_id >= shards.size()) {
+        LOG_GENERAL(WARNING, "Fallback block shard id " << shard_id
+                                                        << " out of range");
+        break;
+      }
+
+      dispatch(i, [this, &fallbackblock, &shards, shard_id]() {
+        return CheckBlockCosignature(fallbackblock, shards.at(shard_id));
+      });
+      auto nextDsComm = make_shared<DequeOfNode>();
+      m_mediator.m_node->UpdateDSCommitteeAfterFallback(
+          shard_id, fallbackblock.GetHeader().GetLeaderPubKey(),
+          fallbackblock.GetHeader().GetLeaderNetworkInfo(), *nextDsComm,
+          shards);
+      dsComm = move(nextDsComm);
+    } else {
+      // Rejected later on
+      results.at(i) = true;
+    }
+  }
+
+  unique_lock<mutex> lock(mutexJobs);
+  cvJobs.wait(lock, [&] { return jobsInFlight == 0; });
+}
+
 bool Validator::CheckDirBlocks(
     const vector<boost::variant<DSBlock, VCBlock,
                                 FallbackBlockWShardingStructure>>& dirBlocks,
@@ -271,7 +546,11 @@ bool Validator::CheckDirBlocks(
   BlockHash prevHash = get<BlockLinkIndex::BLOCKHASH>(
       m_mediator.m_blocklinkchain.GetLatestBlockLink());
 
-  for (const auto& dirBlock : dirBlocks) {
+  vector<char> cosigResults;
+  CheckDirBlockCosignatures(dirBlocks, initDsComm, cosigResults);
+
+  for (unsigned int i = 0; i < dirBlocks.size(); i++) {
+    const auto& dirBlock = dirBlocks.at(i);
     if (typeid(DSBlock) == dirBlock.type()) {
       const auto& dsblock = get<DSBlock>(dirBlock);
       if (dsblock.GetHeader().GetBlockNum() != prevdsblocknum + 1) {
@@ -290,7 +569,7 @@ bool Validator::CheckDirBlocks(
         break;
       }
 
-      if (!CheckBlockCosignature(dsblock, mutable_ds_comm)) {
+      if (!cosigResults.at(i)) {
         LOG_GENERAL(WARNING, "Co-sig verification of ds block "
                                  << prevdsblocknum + 1 << " failed");
         ret = false;
@@ -343,7 +622,7 @@ bool Validator::CheckDirBlocks(
         ret = false;
         break;
       }
-      if (!CheckBlockCosignature(vcblock, mutable_ds_comm)) {
+      if (!cosigResults.at(i)) {
         LOG_GENERAL(WARNING, "Co-sig verification of vc block in "
                                  << prevdsblocknum << " failed"
                                  << totalIndex + 1);
@@ -428,7 +707,7 @@ bool Validator::CheckDirBlocks(
 
       uint32_t shard_id = fallbackblock.GetHeader().GetShardId();
 
-      if (!CheckBlockCosignature(fallbackblock, shards.at(shard_id))) {
+      if (!cosigResults.at(i)) {
         LOG_GENERAL(WARNING, "Co-sig verification of fallbackblock in "
                                  << prevdsblocknum << " failed"
                                  << totalIndex + 1);
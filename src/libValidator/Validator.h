@@ -19,6 +19,7 @@
 #define ZILLIQA_SRC_LIBVALIDATOR_VALIDATOR_H_
 
 #include <boost/variant.hpp>
+#include <memory>
 #include <string>
 #include "libData/AccountData/Transaction.h"
 #include "libData/AccountData/TransactionReceipt.h"
@@ -28,6 +29,7 @@
 #include "libNetwork/Peer.h"
 
 class Mediator;
+class ThreadPool;
 
 class Validator {
  public:
@@ -37,12 +39,32 @@ class Validator {
   std::string name() const { return "Validator"; }
 
   static bool VerifyTransaction(const Transaction& tran);
-
   bool CheckCreatedTransaction(const Transaction& tx,
                                TransactionReceipt& receipt) const;
 
+  /// Same as CheckCreatedTransaction on each transaction in order, for
+  /// payments that share no sender or recipient. Results are one per
+  /// transaction.
+  void CheckCreatedTransactions(const std::vector<Transaction>& txns,
+                                std::vector<TransactionReceipt>& receipts,
+                                std::vector<char>& results) const;
+
   bool CheckCreatedTransactionFromLookup(const Transaction& tx);
 
+  /// Same as CheckCreatedTransactionFromLookup on each transaction, with the
+  /// signatures verified in parallel. Results are one per transaction. The
+  /// signatures are not verified if the lookup attested the transactions.
+  void CheckCreatedTransactionsFromLookup(const std::vector<Transaction>& txns,
+                                          std::vector<char>& results,
+                                          const bool attested = false);
+
+  /// Checks the transactions reloaded into a txn pool after a restart: the
+  /// sender must still be behind the nonce, and on shard nodes the checks of
+  /// CheckCreatedTransactionFromLookup must pass. The signatures are verified
+  /// in parallel. Results are one per transaction.
+  void CheckPendingTransactions(const std::vector<Transaction>& txns,
+                                std::vector<char>& results);
+
   template <class Container, class DirectoryBlock>
   bool CheckBlockCosignature(const DirectoryBlock& block,
                              const Container& commKeys);
@@ -53,11 +75,35 @@ class Validator {
       const DequeOfNode& initDsComm, const uint64_t& index_num,
       DequeOfNode& newDSComm);
 
+  /// Verifies the co-signatures of the directory blocks on a thread pool.
+  /// The committee of each block is derived sequentially, so the results
+  /// (one per block) are only meaningful up to the first failure.
+  void CheckDirBlockCosignatures(
+      const std::vector<boost::variant<
+          DSBlock, VCBlock, FallbackBlockWShardingStructure>>& dirBlocks,
+      const DequeOfNode& initDsComm, std::vector<char>& results);
+
   // TxBlocks must be in increasing order or it will fail
   TxBlockValidationMsg CheckTxBlocks(const std::vector<TxBlock>& txBlocks,
                                      const DequeOfNode& dsComm,
                                      const BlockLink& latestBlockLink);
   Mediator& m_mediator;
+
+ private:
+  /// The checks of CheckCreatedTransaction that do not change any state
+  bool PreCheckCreatedTransaction(const Transaction& tx,
+                                  TransactionReceipt& receipt) const;
+
+  /// The checks of CheckCreatedTransactionFromLookup except the signature
+  bool PreCheckCreatedTransactionFromLookup(const Transaction& tx);
+
+  /// Sets the result of each of the transactions at indexes to whether its
+  /// signature is valid, verifying them on m_txnVerifyPool
+  void VerifyTransactionsAt(const std::vector<Transaction>& txns,
+                            const std::vector<unsigned int>& indexes,
+                            std::vector<char>& results);
+
+  std::unique_ptr<ThreadPool> m_txnVerifyPool;
 };
 
 #endif  // ZILLIQA_SRC_LIBVALIDATOR_VALIDATOR_H_
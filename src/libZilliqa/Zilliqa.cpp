@@ -27,11 +27,16 @@
 #include "libCrypto/Sha2.h"
 #include "libData/AccountData/Address.h"
 #include "libNetwork/Guard.h"
+#include "libNetwork/MessagePool.h"
 #include "libServer/GetWorkServer.h"
+#include "libServer/StratumServer.h"
 #include "libServer/WebsocketServer.h"
 #include "libUtils/DataConversion.h"
+#include "libUtils/DetachedExecutor.h"
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
+#include "libUtils/MemoryStats.h"
+#include "libUtils/MessageStats.h"
 #include "libUtils/UpgradeManager.h"
 
 using namespace std;
@@ -78,7 +83,61 @@ void Zilliqa::LogSelfNodeInfo(const PairOfKey& key, const Peer& peer) {
          MessageTypeInstructionStrings[msgType][instruction];
 }
 
-void Zilliqa::ProcessMessage(pair<bytes, Peer>* message) {
+/*static*/ Zilliqa::MessagePriority Zilliqa::GetMessagePriority(
+    const bytes& message) {
+  if (message.size() < MessageOffset::BODY) {
+    return PRIORITY_NORMAL;
+  }
+
+  const unsigned char msgType = message.at(MessageOffset::TYPE);
+  const unsigned char instruction = message.at(MessageOffset::INST);
+
+  switch (msgType) {
+    case MessageType::DIRECTORY:
+      switch (instruction) {
+        case DSInstructionType::DSBLOCKCONSENSUS:
+        case DSInstructionType::MICROBLOCKSUBMISSION:
+        case DSInstructionType::FINALBLOCKCONSENSUS:
+        case DSInstructionType::FINALBLOCKPROPOSAL:
+        case DSInstructionType::VIEWCHANGECONSENSUS:
+          return PRIORITY_HIGH;
+        default:
+          break;
+      }
+      break;
+    case MessageType::NODE:
+      switch (instruction) {
+        case NodeInstructionType::DSBLOCK:
+        case NodeInstructionType::MICROBLOCKCONSENSUS:
+        case NodeInstructionType::FINALBLOCK:
+        case NodeInstructionType::VCBLOCK:
+        case NodeInstructionType::FALLBACKCONSENSUS:
+        case NodeInstructionType::FALLBACKBLOCK:
+          return PRIORITY_HIGH;
+        case NodeInstructionType::SUBMITTRANSACTION:
+        case NodeInstructionType::MBNFORWARDTRANSACTION:
+        case NodeInstructionType::FORWARDTXNPACKET:
+        case NodeInstructionType::PENDINGTXN:
+          return PRIORITY_LOW;
+        default:
+          break;
+      }
+      break;
+    case MessageType::LOOKUP:
+      if (instruction == LookupInstructionType::FORWARDTXN) {
+        return PRIORITY_LOW;
+      }
+      break;
+    default:
+      break;
+  }
+
+  return PRIORITY_NORMAL;
+}
+
+void Zilliqa::ProcessMessage(const QueuedMessage& queuedMessage) {
+  pair<bytes, Peer>* message = queuedMessage.first;
+
   if (message->first.size() >= MessageOffset::BODY) {
     const unsigned char msg_type = message->first.at(MessageOffset::TYPE);
 
@@ -91,31 +150,43 @@ void Zilliqa::ProcessMessage(pair<bytes, Peer>* message) {
     if (msg_type < msg_handlers_count) {
       if (msg_handlers[msg_type] == NULL) {
         LOG_GENERAL(WARNING, "Message type NULL");
-        delete message;
+        MessagePool::GetInstance().Release(message);
         return;
       }
 
-      std::chrono::time_point<std::chrono::high_resolution_clock> tpStart;
+      std::chrono::time_point<std::chrono::steady_clock> tpStart;
       std::string msgName;
-      if (ENABLE_CHECK_PERFORMANCE_LOG) {
+      const size_t msgSize = message->first.size();
+      if (ENABLE_CHECK_PERFORMANCE_LOG || ENABLE_MESSAGE_STATS) {
         const auto ins_byte = message->first.at(MessageOffset::INST);
         msgName = FormatMessageName(msg_type, ins_byte);
-        LOG_GENERAL(INFO, MessageSizeKeyword << msgName << " "
-                                             << message->first.size());
+        if (ENABLE_CHECK_PERFORMANCE_LOG) {
+          LOG_GENERAL(INFO, MessageSizeKeyword << msgName << " " << msgSize);
+        }
 
-        tpStart = std::chrono::high_resolution_clock::now();
+        tpStart = std::chrono::steady_clock::now();
       }
 
       bool result = msg_handlers[msg_type]->Execute(
           message->first, MessageOffset::INST, message->second);
 
-      if (ENABLE_CHECK_PERFORMANCE_LOG) {
-        auto tpNow = std::chrono::high_resolution_clock::now();
+      if (ENABLE_CHECK_PERFORMANCE_LOG || ENABLE_MESSAGE_STATS) {
+        auto tpNow = std::chrono::steady_clock::now();
         auto timeInMicro = static_cast<int64_t>(
             (std::chrono::duration<double, std::micro>(tpNow - tpStart))
                 .count());
-        LOG_GENERAL(
-            INFO, MessgeTimeKeyword << msgName << " " << timeInMicro << " us");
+        if (ENABLE_CHECK_PERFORMANCE_LOG) {
+          LOG_GENERAL(INFO, MessgeTimeKeyword << msgName << " " << timeInMicro
+                                              << " us");
+        }
+        if (ENABLE_MESSAGE_STATS) {
+          auto queueTimeInMicro = static_cast<int64_t>(
+              (std::chrono::duration<double, std::micro>(
+                   tpStart - queuedMessage.second))
+                  .count());
+          MessageStats::GetInstance().Record(msgName, timeInMicro,
+                                             queueTimeInMicro, msgSize);
+        }
       }
 
       if (!result) {
@@ -127,7 +198,7 @@ void Zilliqa::ProcessMessage(pair<bytes, Peer>* message) {
     }
   }
 
-  delete message;
+  MessagePool::GetInstance().Release(message);
 }
 
 Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
@@ -136,25 +207,35 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
       m_ds(m_mediator),
       m_lookup(m_mediator, syncType),
       m_n(m_mediator, syncType, toRetrieveHistory),
-      m_msgQueue(MSGQUEUE_SIZE)
+      m_msgQueue(PRIORITY_COUNT, MSGQUEUE_SIZE)
 
 {
   LOG_MARKER();
 
   // Launch the thread that reads messages from the queue
   auto funcCheckMsgQueue = [this]() mutable -> void {
-    pair<bytes, Peer>* message = NULL;
-    while (true) {
-      while (m_msgQueue.pop(message)) {
-        // For now, we use a thread pool to handle this message
-        // Eventually processing will be single-threaded
-        m_queuePool.AddJob(
-            [this, message]() mutable -> void { ProcessMessage(message); });
-      }
-      std::this_thread::sleep_for(std::chrono::microseconds(1));
+    QueuedMessage message;
+    // Blocks until a message arrives, serving higher priority lanes first
+    while (m_msgQueue.Pop(message)) {
+      // For now, we use a thread pool to handle this message
+      // Eventually processing will be single-threaded
+      // Consensus and block messages also skip the jobs queued in the pool
+      const auto priority =
+          GetMessagePriority(message.first->first) == PRIORITY_HIGH
+              ? ThreadPool::Priority::HIGH
+              : ThreadPool::Priority::NORMAL;
+      const uint64_t msgBytes = message.first->first.size();
+      m_queuePool.AddJob(
+          [this, message, msgBytes]() mutable -> void {
+            ProcessMessage(message);
+            m_msgQueueBytes -= msgBytes;
+          },
+          priority);
     }
   };
-  DetachedFunction(1, funcCheckMsgQueue);
+  DetachedExecutor::GetInstance().RunLongRunning("MsgQueue", funcCheckMsgQueue);
+  MemoryStats::GetInstance().Register(
+      "MsgQueue", [this]() -> uint64_t { return m_msgQueueBytes; });
 
   m_validator = make_shared<Validator>(m_mediator);
 
@@ -183,6 +264,11 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
   // Clear any existing diagnostic data from previous runs
   BlockStorage::GetBlockStorage().ResetDB(BlockStorage::DIAGNOSTIC_NODES);
   BlockStorage::GetBlockStorage().ResetDB(BlockStorage::DIAGNOSTIC_COINBASE);
+  BlockStorage::GetBlockStorage().ResetDB(
+      BlockStorage::DIAGNOSTIC_EPOCH_PERF);
+
+  // Written again once this process has an epoch on disk
+  BlockStorage::GetBlockStorage().ClearWarmRestartMarker();
 
   if (GUARD_MODE) {
     // Setting the guard upon process launch
@@ -214,7 +300,10 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
   auto func = [this, toRetrieveHistory, syncType, key, peer]() mutable -> void {
     LogSelfNodeInfo(key, peer);
     while (!m_n.Install((SyncType)syncType, toRetrieveHistory)) {
-      if (LOOKUP_NODE_MODE && !ARCHIVAL_LOOKUP) {
+      if (SyncType::LIGHT_SYNC == syncType) {
+        // Sync the blocks again from the genesis ones
+        break;
+      } else if (LOOKUP_NODE_MODE && !ARCHIVAL_LOOKUP) {
         syncType = SyncType::LOOKUP_SYNC;
         m_mediator.m_lookup->SetSyncType(SyncType::LOOKUP_SYNC);
         break;
@@ -330,6 +419,10 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
         m_ds.m_dsguardPodDelete = true;
         m_ds.RejoinAsDS(false);
         break;
+      case SyncType::LIGHT_SYNC:
+        LOG_GENERAL(INFO, "Sync the block headers only");
+        m_lookup.StartLightSynchronization();
+        break;
       case SyncType::DB_VERIF:
         LOG_GENERAL(FATAL, "Use of deprecated syncType=DB_VERIF");
 #if 0
@@ -359,6 +452,18 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
           LOG_GENERAL(WARNING, "GetWork Mining Server couldn't start");
         }
 
+        if (GETWORK_STRATUM_PORT != 0 &&
+            !StratumServer::GetInstance().Start(GETWORK_STRATUM_PORT)) {
+          LOG_GENERAL(WARNING, "Stratum Mining Server couldn't start");
+        }
+
+      } else if (REMOTE_MINE && REMOTE_MINE_PUSH_PORT != 0) {
+        LOG_GENERAL(INFO, "Taking pushed PoW results at http://"
+                              << peer.GetPrintableIPAddress() << ":"
+                              << REMOTE_MINE_PUSH_PORT);
+        if (!GetWorkServer::GetInstance().StartServer()) {
+          LOG_GENERAL(WARNING, "Failed to listen for pushed PoW results");
+        }
       } else {
         LOG_GENERAL(INFO, "GetWork Mining Server not enable")
       }
@@ -369,7 +474,9 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
     }
 
     if (LOOKUP_NODE_MODE) {
-      m_lookupServerConnector = make_unique<SafeHttpServer>(LOOKUP_RPC_PORT);
+      m_lookupServerConnector = make_unique<SafeHttpServer>(
+          LOOKUP_RPC_PORT, "", "", LOOKUP_RPC_THREADS,
+          LOOKUP_RPC_CONNECTION_TIMEOUT_IN_SECONDS);
       m_lookupServer =
           make_shared<LookupServer>(m_mediator, *m_lookupServerConnector);
 
@@ -383,8 +490,11 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
         m_lookup.SetLookupServer(m_lookupServer);
         if (ARCHIVAL_LOOKUP) {
           m_lookupServer->StartCollectorThread();
+          m_lookup.StartSeedSubscription();
         }
-        if (m_lookup.GetSyncType() == SyncType::NO_SYNC) {
+        // A light node serves the blocks it has while it follows the chain
+        if (m_lookup.GetSyncType() == SyncType::NO_SYNC ||
+            m_lookup.GetSyncType() == SyncType::LIGHT_SYNC) {
           if (m_lookupServer->StartListening()) {
             LOG_GENERAL(INFO, "API Server started successfully");
 
@@ -395,6 +505,16 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
           LOG_GENERAL(WARNING,
                       "This lookup node not sync yet, don't start listen");
         }
+
+        if (ENABLE_PROTO_RPC) {
+          m_protoRpcServer = make_unique<ProtoRpcServer>(
+              m_mediator, *m_lookupServer, PROTO_RPC_PORT);
+          if (m_protoRpcServer->StartListening()) {
+            LOG_GENERAL(INFO, "Protobuf API Server started successfully");
+          } else {
+            LOG_GENERAL(WARNING, "Protobuf API Server couldn't start");
+          }
+        }
       }
     }
 
@@ -418,9 +538,12 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
 }
 
 Zilliqa::~Zilliqa() {
-  pair<bytes, Peer>* message = NULL;
-  while (m_msgQueue.pop(message)) {
-    delete message;
+  MemoryStats::GetInstance().Unregister("MsgQueue");
+  m_msgQueue.Stop();
+
+  QueuedMessage message;
+  while (m_msgQueue.TryPop(message)) {
+    MessagePool::GetInstance().Release(message.first);
   }
 }
 
@@ -428,7 +551,14 @@ void Zilliqa::Dispatch(pair<bytes, Peer>* message) {
   // LOG_MARKER();
 
   // Queue message
-  if (!m_msgQueue.bounded_push(message)) {
-    LOG_GENERAL(WARNING, "Input MsgQueue is full");
+  const MessagePriority priority = GetMessagePriority(message->first);
+  const uint64_t msgBytes = message->first.size();
+  m_msgQueueBytes += msgBytes;
+  if (!m_msgQueue.Push(make_pair(message, chrono::steady_clock::now()),
+                       priority)) {
+    LOG_GENERAL(WARNING, "Input MsgQueue is full (priority " << priority
+                                                             << ")");
+    m_msgQueueBytes -= msgBytes;
+    MessagePool::GetInstance().Release(message);
   }
 }
@@ -18,6 +18,8 @@
 #ifndef ZILLIQA_SRC_LIBZILLIQA_ZILLIQA_H_
 #define ZILLIQA_SRC_LIBZILLIQA_ZILLIQA_H_
 
+#include <atomic>
+#include <chrono>
 #include <vector>
 
 #include "libDirectoryService/DirectoryService.h"
@@ -25,8 +27,10 @@
 #include "libMediator/Mediator.h"
 #include "libNetwork/Peer.h"
 #include "libNode/Node.h"
+#include "libProtoServer/ProtoRpcServer.h"
 #include "libServer/LookupServer.h"
 #include "libServer/StatusServer.h"
+#include "libUtils/BlockingPriorityQueue.h"
 #include "libUtils/ThreadPool.h"
 
 /// Main Zilliqa class.
@@ -38,18 +42,35 @@ class Zilliqa {
   Node m_n;
   // ConsensusUser m_cu; // Note: This is just a test class to demo Consensus
   // usage
-  boost::lockfree::queue<std::pair<bytes, Peer>*> m_msgQueue;
+  // Messages are queued together with the time they were dispatched
+  using QueuedMessage = std::pair<std::pair<bytes, Peer>*,
+                                  std::chrono::steady_clock::time_point>;
+  BlockingPriorityQueue<QueuedMessage> m_msgQueue;
+  // Bytes of the messages queued or being processed
+  std::atomic<uint64_t> m_msgQueueBytes{0};
 
   std::unique_ptr<StatusServer> m_statusServer;
   std::shared_ptr<LookupServer> m_lookupServer;
   std::unique_ptr<jsonrpc::AbstractServerConnector> m_statusServerConnector;
   std::unique_ptr<jsonrpc::AbstractServerConnector> m_lookupServerConnector;
+  std::unique_ptr<ProtoRpcServer> m_protoRpcServer;
 
   ThreadPool m_queuePool{MAXMESSAGE, "QueuePool"};
 
-  void ProcessMessage(std::pair<bytes, Peer>* message);
+  void ProcessMessage(const QueuedMessage& queuedMessage);
 
  public:
+  /// Queue lanes, in the order they are served.
+  enum MessagePriority : unsigned int {
+    PRIORITY_HIGH = 0,  // consensus and blocks
+    PRIORITY_NORMAL,
+    PRIORITY_LOW,  // bulk transaction traffic
+    PRIORITY_COUNT
+  };
+
+  /// Returns the queue lane for an incoming message.
+  static MessagePriority GetMessagePriority(const bytes& message);
+
   /// Constructor.
   Zilliqa(const PairOfKey& key, const Peer& peer,
           SyncType syncType = SyncType::NO_SYNC,
@@ -63,6 +84,9 @@ class Zilliqa {
   /// Forwards an incoming message for processing by the appropriate subclass.
   void Dispatch(std::pair<bytes, Peer>* message);
 
+  /// Returns the bytes of the messages queued or being processed.
+  uint64_t GetPendingMessageBytes() const { return m_msgQueueBytes; }
+
   static std::string FormatMessageName(unsigned char msgType,
                                        unsigned char instruction);
 };
@@ -0,0 +1,448 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// In-process consensus benchmark. One leader and (committee - 1) backups run
+/// in this process and exchange messages through a simulated network that
+/// adds latency and drops messages. Latency and loss of each message are
+/// derived from the seed and the message itself, so runs with the same
+/// options see the same network.
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <Schnorr.h>
+#include "common/Messages.h"
+#include "libConsensus/ConsensusBackup.h"
+#include "libConsensus/ConsensusLeader.h"
+#include "libNetwork/P2PComm.h"
+#include "libNetwork/ShardStruct.h"
+#include "libUtils/Histogram.h"
+#include "libUtils/Logger.h"
+#include "libUtils/ThreadPool.h"
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+
+namespace po = boost::program_options;
+using namespace std;
+
+namespace {
+
+const uint32_t BASE_PORT = 5000;
+const unsigned char BENCH_CLASS_BYTE = 0xFE;
+const unsigned char BENCH_INS_BYTE = 0x00;
+
+struct Options {
+  unsigned int committeeSize{600};
+  unsigned int rounds{10};
+  unsigned int latencyMs{50};
+  unsigned int jitterMs{20};
+  double lossPercent{0};
+  unsigned int payloadSize{1024};
+  unsigned int seed{1};
+  unsigned int threads{max(thread::hardware_concurrency(), 1u)};
+  unsigned int timeoutSec{60};
+  bool isDS{false};
+};
+
+/// Index of the node whose code is running on this thread. Threads not
+/// started by the network (e.g., the leader's commit window timer) act for
+/// the leader.
+thread_local unsigned int t_currentNode = 0;
+
+/// Delivers messages between in-process nodes after a simulated delay.
+class SimulatedNetwork {
+ public:
+  using Handler =
+      function<bool(const bytes& message, unsigned int offset, const Peer&)>;
+  using Clock = chrono::steady_clock;
+
+  SimulatedNetwork(const Options& options)
+      : m_options(options),
+        m_handlers(options.committeeSize),
+        m_workers(options.threads, "BenchNet") {
+    m_scheduler = thread([this] { Schedule(); });
+  }
+
+  ~SimulatedNetwork() {
+    {
+      lock_guard<mutex> g(m_mutex);
+      m_stopped = true;
+    }
+    m_cv.notify_all();
+    m_scheduler.join();
+  }
+
+  static Peer GetPeer(unsigned int index) {
+    return Peer(index + 1, BASE_PORT + index);
+  }
+
+  void SetHandler(unsigned int index, const Handler& handler) {
+    lock_guard<mutex> g(m_mutexHandlers);
+    m_handlers.at(index) = handler;
+  }
+
+  void SetRound(unsigned int round) { m_round = round; }
+
+  void Send(const Peer& to, const bytes& message) {
+    const unsigned int from = t_currentNode;
+    const unsigned int dest =
+        static_cast<unsigned int>(to.m_ipAddress) - 1;  // see GetPeer
+    if (dest >= m_options.committeeSize || dest == from) {
+      return;
+    }
+
+    // Draw from a generator seeded by the message identity, so the outcome
+    // does not depend on the order in which threads happen to send
+    const uint8_t msgType =
+        (message.size() > MessageOffset::BODY) ? message[MessageOffset::BODY]
+                                                : 0;
+    seed_seq seq{m_options.seed, m_round.load(), from, dest,
+                 static_cast<unsigned int>(msgType)};
+    mt19937 gen(seq);
+
+    if (uniform_real_distribution<double>(0, 100)(gen) <
+        m_options.lossPercent) {
+      m_dropped++;
+      return;
+    }
+
+    const unsigned int jitter =
+        (m_options.jitterMs == 0)
+            ? 0
+            : uniform_int_distribution<unsigned int>(0, m_options.jitterMs)(
+                  gen);
+
+    lock_guard<mutex> g(m_mutex);
+    m_queue.push(
+        {Clock::now() + chrono::milliseconds(m_options.latencyMs + jitter),
+         m_seq++, from, dest, message});
+    m_cv.notify_one();
+  }
+
+  uint64_t GetDroppedCount() const { return m_dropped; }
+
+ private:
+  struct Delivery {
+    Clock::time_point m_deadline;
+    uint64_t m_seq;
+    unsigned int m_from;
+    unsigned int m_to;
+    bytes m_message;
+
+    bool operator>(const Delivery& r) const {
+      return tie(m_deadline, m_seq) > tie(r.m_deadline, r.m_seq);
+    }
+  };
+
+  void Schedule() {
+    unique_lock<mutex> lock(m_mutex);
+    while (!m_stopped) {
+      if (m_queue.empty()) {
+        m_cv.wait(lock);
+        continue;
+      }
+      if (m_queue.top().m_deadline > Clock::now()) {
+        m_cv.wait_until(lock, m_queue.top().m_deadline);
+        continue;
+      }
+      auto delivery = make_shared<Delivery>(m_queue.top());
+      m_queue.pop();
+      lock.unlock();
+      m_workers.AddJob([this, delivery] { Deliver(*delivery); });
+      lock.lock();
+    }
+  }
+
+  void Deliver(const Delivery& delivery) {
+    Handler handler;
+    {
+      lock_guard<mutex> g(m_mutexHandlers);
+      handler = m_handlers.at(delivery.m_to);
+    }
+    if (!handler) {
+      return;
+    }
+    t_currentNode = delivery.m_to;
+    handler(delivery.m_message, MessageOffset::BODY, GetPeer(delivery.m_from));
+    t_currentNode = 0;
+  }
+
+  const Options& m_options;
+  atomic<unsigned int> m_round{0};
+  atomic<uint64_t> m_dropped{0};
+
+  mutex m_mutexHandlers;
+  vector<Handler> m_handlers;
+
+  mutex m_mutex;
+  condition_variable m_cv;
+  priority_queue<Delivery, vector<Delivery>, greater<Delivery>> m_queue;
+  uint64_t m_seq{0};
+  bool m_stopped{false};
+  thread m_scheduler;
+
+  ThreadPool m_workers;
+};
+
+struct Phase {
+  const char* m_name;
+  ConsensusCommon::State m_endState;
+  Histogram m_latencyMs;
+};
+
+void description() {
+  cout << endl << "Description:\n";
+  cout << "\tRuns consensus rounds between in-process nodes over a simulated"
+       << endl
+       << "\tnetwork and reports rounds/sec and per-phase latency." << endl;
+}
+
+bool RunRound(const Options& options, SimulatedNetwork& network,
+              const DequeOfNode& committee, const vector<PairOfKey>& keys,
+              unsigned int round, vector<Phase>& phases,
+              vector<shared_ptr<ConsensusLeader>>& retired) {
+  const bytes blockHash(BLOCK_HASH_SIZE, round & 0xFF);
+
+  bytes payload(options.payloadSize);
+  mt19937 gen(options.seed + round);
+  generate(payload.begin(), payload.end(), [&gen] { return gen() & 0xFF; });
+
+  auto leader = make_shared<ConsensusLeader>(
+      round, round, blockHash, 0, keys.at(0).first, committee,
+      BENCH_CLASS_BYTE, BENCH_INS_BYTE,
+      []([[gnu::unused]] const bytes& errorMsg,
+         [[gnu::unused]] const Peer& from) { return true; },
+      []([[gnu::unused]] map<unsigned int, bytes> m) { return true; },
+      options.isDS);
+
+  auto validator = [](const bytes& input, unsigned int offset,
+                      [[gnu::unused]] bytes& errorMsg,
+                      [[gnu::unused]] const uint32_t consensusID,
+                      [[gnu::unused]] const uint64_t blockNumber,
+                      [[gnu::unused]] const bytes& blockHash,
+                      [[gnu::unused]] const uint16_t leaderID,
+                      [[gnu::unused]] const PubKey& leaderKey,
+                      bytes& messageToCosign) {
+    if (input.size() < offset) {
+      return false;
+    }
+    messageToCosign.assign(input.begin() + offset, input.end());
+    return true;
+  };
+
+  vector<shared_ptr<ConsensusBackup>> backups(options.committeeSize);
+  for (unsigned int i = 1; i < options.committeeSize; i++) {
+    backups.at(i) = make_shared<ConsensusBackup>(
+        round, round, blockHash, i, 0, keys.at(i).first, committee,
+        BENCH_CLASS_BYTE, BENCH_INS_BYTE, validator);
+  }
+
+  network.SetRound(round);
+  network.SetHandler(0, [leader](const bytes& message, unsigned int offset,
+                                 const Peer& from) {
+    return leader->ProcessMessage(message, offset, from);
+  });
+  for (unsigned int i = 1; i < options.committeeSize; i++) {
+    auto backup = backups.at(i);
+    network.SetHandler(i, [backup](const bytes& message, unsigned int offset,
+                                   const Peer& from) {
+      return backup->ProcessMessage(message, offset, from);
+    });
+  }
+
+  auto announcementGenerator =
+      [&payload](bytes& dst, unsigned int offset,
+                 [[gnu::unused]] const uint32_t consensusID,
+                 [[gnu::unused]] const uint64_t blockNumber,
+                 [[gnu::unused]] const bytes& blockHash,
+                 [[gnu::unused]] const uint16_t leaderID,
+                 [[gnu::unused]] const PairOfKey& leaderKey,
+                 bytes& messageToCosign) {
+        dst.resize(offset);
+        dst.insert(dst.end(), payload.begin(), payload.end());
+        messageToCosign = payload;
+        return true;
+      };
+
+  const auto start = chrono::steady_clock::now();
+  auto phaseStart = start;
+  const auto deadline = start + chrono::seconds(options.timeoutSec);
+
+  if (!leader->StartConsensus(announcementGenerator)) {
+    LOG_GENERAL(WARNING, "Round " << round << " failed to start");
+    return false;
+  }
+
+  unsigned int phase = 0;
+  bool result = false;
+  while (chrono::steady_clock::now() < deadline) {
+    const ConsensusCommon::State state = leader->GetState();
+    if (state == ConsensusCommon::State::ERROR) {
+      break;
+    }
+    // Several phases may have ended since the last poll
+    while ((phase < phases.size()) && (state >= phases[phase].m_endState)) {
+      const auto now = chrono::steady_clock::now();
+      phases[phase].m_latencyMs.Record(
+          chrono::duration_cast<chrono::milliseconds>(now - phaseStart)
+              .count());
+      phaseStart = now;
+      phase++;
+    }
+    if (state == ConsensusCommon::State::DONE) {
+      result = true;
+      break;
+    }
+    this_thread::sleep_for(chrono::microseconds(200));
+  }
+
+  for (unsigned int i = 0; i < options.committeeSize; i++) {
+    network.SetHandler(i, nullptr);
+  }
+  // Detached timers of the leader may still hold on to it
+  retired.emplace_back(leader);
+
+  LOG_GENERAL(INFO, "Round " << round << (result ? " done" : " failed")
+                             << " in leader state "
+                             << leader->GetStateString());
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  try {
+    Options options;
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "committee,n", po::value<unsigned int>(&options.committeeSize),
+        "Committee size including the leader (default 600)")(
+        "rounds,r", po::value<unsigned int>(&options.rounds),
+        "Number of consensus rounds (default 10)")(
+        "latency,l", po::value<unsigned int>(&options.latencyMs),
+        "One-way message latency in ms (default 50)")(
+        "jitter,j", po::value<unsigned int>(&options.jitterMs),
+        "Maximum extra latency in ms (default 20)")(
+        "loss,p", po::value<double>(&options.lossPercent),
+        "Percentage of messages dropped (default 0)")(
+        "payload,b", po::value<unsigned int>(&options.payloadSize),
+        "Size of the message to cosign in bytes (default 1024)")(
+        "seed,s", po::value<unsigned int>(&options.seed),
+        "Seed of the simulated network (default 1)")(
+        "threads,t", po::value<unsigned int>(&options.threads),
+        "Threads processing delivered messages (default: all cores)")(
+        "timeout,o", po::value<unsigned int>(&options.timeoutSec),
+        "Time limit of each round in seconds (default 60)")(
+        "ds,d", po::bool_switch(&options.isDS),
+        "Run as DS committee consensus");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help")) {
+        description();
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      po::notify(vm);
+    } catch (boost::program_options::error& e) {
+      cerr << "ERROR: " << e.what() << endl << endl;
+      cout << desc;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    if ((options.committeeSize < 2) || (options.threads == 0)) {
+      cerr << "ERROR: committee must have at least 2 members and threads "
+              "must be positive"
+           << endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    INIT_FILE_LOGGER("consensusbench", "./");
+
+    vector<PairOfKey> keys;
+    DequeOfNode committee;
+    for (unsigned int i = 0; i < options.committeeSize; i++) {
+      keys.emplace_back(Schnorr::GenKeyPair());
+      committee.emplace_back(keys.back().second, SimulatedNetwork::GetPeer(i));
+    }
+
+    vector<Phase> phases = {
+        {"commit", ConsensusCommon::State::CHALLENGE_DONE, {}},
+        {"response", ConsensusCommon::State::COLLECTIVESIG_DONE, {}},
+        {"finalcommit", ConsensusCommon::State::FINALCHALLENGE_DONE, {}},
+        {"finalresponse", ConsensusCommon::State::DONE, {}}};
+    vector<shared_ptr<ConsensusLeader>> retired;
+    unsigned int succeeded = 0;
+
+    SimulatedNetwork network(options);
+    P2PComm::GetInstance().SetSendInterceptor(
+        [&network](const Peer& peer, const bytes& message) {
+          network.Send(peer, message);
+        });
+
+    const auto start = chrono::steady_clock::now();
+    for (unsigned int round = 1; round <= options.rounds; round++) {
+      if (RunRound(options, network, committee, keys, round, phases,
+                   retired)) {
+        succeeded++;
+      }
+    }
+    const double elapsed =
+        chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    P2PComm::GetInstance().SetSendInterceptor(nullptr);
+
+    cout << "committee=" << options.committeeSize
+         << " rounds=" << options.rounds << " succeeded=" << succeeded
+         << " dropped=" << network.GetDroppedCount() << endl;
+    cout << "rounds/sec=" << fixed << setprecision(3)
+         << ((elapsed > 0) ? succeeded / elapsed : 0) << endl;
+    cout << left << setw(16) << "phase" << right << setw(10) << "count"
+         << setw(10) << "p50(ms)" << setw(10) << "p99(ms)" << setw(10)
+         << "max(ms)" << endl;
+    for (const auto& phase : phases) {
+      cout << left << setw(16) << phase.m_name << right << setw(10)
+           << phase.m_latencyMs.GetCount() << setw(10)
+           << phase.m_latencyMs.GetPercentile(50) << setw(10)
+           << phase.m_latencyMs.GetPercentile(99) << setw(10)
+           << phase.m_latencyMs.GetMax() << endl;
+    }
+
+    return (succeeded == options.rounds) ? SUCCESS : ERROR_UNHANDLED_EXCEPTION;
+  } catch (exception& e) {
+    cerr << "Unhandled Exception reached the top of main: " << e.what()
+         << ", application will now exit" << endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+}
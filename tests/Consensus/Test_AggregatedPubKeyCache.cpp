@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <MultiSig.h>
+#include <Schnorr.h>
+#include <vector>
+
+#include "libConsensus/AggregatedPubKeyCache.h"
+#include "libUtils/Bitmap.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE aggregatedpubkeycache
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+static vector<PubKey> MakeCommittee(unsigned int size) {
+  vector<PubKey> committee;
+  for (unsigned int i = 0; i < size; i++) {
+    committee.emplace_back(Schnorr::GenKeyPair().second);
+  }
+  return committee;
+}
+
+// Checks the cached aggregate against the one of the selected keys alone
+static void CheckAggregate(const vector<PubKey>& committee,
+                           const Bitmap& bitmap) {
+  vector<PubKey> selected;
+  for (unsigned int i = 0; i < bitmap.size(); i++) {
+    if (bitmap.at(i)) {
+      selected.emplace_back(committee.at(i));
+    }
+  }
+  auto expected = MultiSig::AggregatePubKeys(selected);
+  BOOST_REQUIRE(expected != nullptr);
+
+  auto aggregate =
+      AggregatedPubKeyCache::GetInstance().AggregatePubKeys(committee, bitmap);
+  BOOST_REQUIRE(aggregate != nullptr);
+  BOOST_CHECK_MESSAGE(*aggregate == *expected,
+                      "Wrong aggregate for " << bitmap.count() << " of "
+                                             << bitmap.size() << " signers");
+}
+
+static Bitmap MakeBitmap(unsigned int size, bool (*signs)(unsigned int)) {
+  Bitmap bitmap(size);
+  for (unsigned int i = 0; i < size; i++) {
+    bitmap.set(i, signs(i));
+  }
+  return bitmap;
+}
+
+static vector<Bitmap> MakeBitmaps(unsigned int size) {
+  return {
+      Bitmap(size, true),
+      MakeBitmap(size, [](unsigned int i) { return i != 0; }),
+      MakeBitmap(size, [](unsigned int i) { return i % 5 != 3; }),
+      MakeBitmap(size, [](unsigned int i) { return i % 3 != 0; }),
+      // Few enough signers to be added up directly
+      MakeBitmap(size, [](unsigned int i) { return i % 2 == 0; }),
+      MakeBitmap(size, [](unsigned int i) { return i == 7; }),
+  };
+}
+
+BOOST_AUTO_TEST_SUITE(aggregatedpubkeycache)
+
+BOOST_AUTO_TEST_CASE(test_same_as_multisig) {
+  INIT_STDOUT_LOGGER();
+
+  AggregatedPubKeyCache::GetInstance().Clear();
+  const auto committee = MakeCommittee(20);
+
+  // Twice, so that the second round uses the cached committee
+  for (unsigned int round = 0; round < 2; round++) {
+    for (const auto& bitmap : MakeBitmaps(committee.size())) {
+      CheckAggregate(committee, bitmap);
+    }
+  }
+
+  BOOST_CHECK(AggregatedPubKeyCache::GetInstance().AggregatePubKeys(
+                  committee, Bitmap(committee.size() - 1, true)) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_committee_change) {
+  INIT_STDOUT_LOGGER();
+
+  AggregatedPubKeyCache::GetInstance().Clear();
+  auto committee = MakeCommittee(20);
+  const auto bitmaps = MakeBitmaps(committee.size());
+  for (const auto& bitmap : bitmaps) {
+    CheckAggregate(committee, bitmap);
+  }
+
+  // A member is replaced, with the size of the committee unchanged
+  const auto previous = AggregatedPubKeyCache::GetInstance().AggregatePubKeys(
+      committee, bitmaps.front());
+  committee.at(5) = Schnorr::GenKeyPair().second;
+  for (const auto& bitmap : bitmaps) {
+    CheckAggregate(committee, bitmap);
+  }
+  BOOST_CHECK(*AggregatedPubKeyCache::GetInstance().AggregatePubKeys(
+                  committee, bitmaps.front()) != *previous);
+
+  // The same members in another order
+  swap(committee.at(0), committee.at(9));
+  for (const auto& bitmap : bitmaps) {
+    CheckAggregate(committee, bitmap);
+  }
+
+  // Or a member more
+  committee.emplace_back(Schnorr::GenKeyPair().second);
+  for (const auto& bitmap : MakeBitmaps(committee.size())) {
+    CheckAggregate(committee, bitmap);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_stale_entry_replaced) {
+  INIT_STDOUT_LOGGER();
+
+  AggregatedPubKeyCache::GetInstance().Clear();
+  const auto committee = MakeCommittee(10);
+  const auto bitmaps = MakeBitmaps(committee.size());
+  CheckAggregate(committee, bitmaps.at(1));
+
+  // Enough other committees to push the first one out of the cache
+  for (unsigned int i = 0; i < 20; i++) {
+    CheckAggregate(MakeCommittee(10), bitmaps.at(1));
+  }
+  for (const auto& bitmap : bitmaps) {
+    CheckAggregate(committee, bitmap);
+  }
+
+  // Cached again from scratch after a clear
+  AggregatedPubKeyCache::GetInstance().Clear();
+  for (const auto& bitmap : bitmaps) {
+    CheckAggregate(committee, bitmap);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
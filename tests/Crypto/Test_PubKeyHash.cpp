@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <Schnorr.h>
+#include "libCrypto/PubKeyHash.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE pubkeyhashtest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(pubkeyhashtest)
+
+BOOST_AUTO_TEST_CASE(test_fingerprint_of_equal_keys) {
+  INIT_STDOUT_LOGGER();
+
+  const PubKey pubKey = Schnorr::GenKeyPair().second;
+  bytes serialized;
+  pubKey.Serialize(serialized, 0);
+  const PubKey copy(serialized, 0);
+
+  BOOST_CHECK_EQUAL(PubKeyHash::Fingerprint(pubKey),
+                    PubKeyHash::Fingerprint(copy));
+  BOOST_CHECK_EQUAL(PubKeyHash()(pubKey), PubKeyHash()(copy));
+}
+
+BOOST_AUTO_TEST_CASE(test_hash_map_lookup) {
+  INIT_STDOUT_LOGGER();
+
+  vector<PubKey> pubKeys;
+  PubKeyHashMap<uint32_t> shardIds;
+  for (uint32_t i = 0; i < 200; i++) {
+    pubKeys.emplace_back(Schnorr::GenKeyPair().second);
+    shardIds.emplace(pubKeys.back(), i);
+  }
+
+  BOOST_CHECK_EQUAL(shardIds.size(), pubKeys.size());
+  for (uint32_t i = 0; i < pubKeys.size(); i++) {
+    BOOST_CHECK_EQUAL(shardIds.at(pubKeys[i]), i);
+  }
+  BOOST_CHECK(shardIds.find(Schnorr::GenKeyPair().second) == shardIds.end());
+
+  PubKeyHashSet guards(pubKeys.begin(), pubKeys.end());
+  BOOST_CHECK_EQUAL(guards.size(), pubKeys.size());
+  BOOST_CHECK_EQUAL(guards.count(pubKeys.front()), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -107,4 +107,45 @@ BOOST_AUTO_TEST_CASE(SHA256_002_check_896bitsx3_updatewithoffset) {
   BOOST_CHECK_EQUAL(is_equal, true);
 }
 
+/**
+ * \brief SHA256_check_hash_many
+ *
+ * \details Test the one-shot and the multi-buffer SHA256 hash functions
+ */
+BOOST_AUTO_TEST_CASE(SHA256_003_check_hash_many) {
+  const string input =
+      "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+  vector<bytes> inputs;
+  for (unsigned int i = 0; i <= input.size(); i += 8) {
+    inputs.emplace_back(input.begin(), input.begin() + i);
+  }
+
+  const unsigned int size = SHA2<HashType::HASH_VARIANT_256>::HASH_OUTPUT_SIZE;
+  bytes outputs(inputs.size() * size);
+  SHA2<HashType::HASH_VARIANT_256>::HashMany(inputs, outputs.data());
+
+  for (unsigned int i = 0; i < inputs.size(); i++) {
+    SHA2<HashType::HASH_VARIANT_256> sha2;
+    sha2.Update(inputs[i].data(), inputs[i].size());
+    const bytes expected = sha2.Finalize();
+    BOOST_CHECK(equal(expected.begin(), expected.end(),
+                      outputs.begin() + i * size));
+
+    bytes output(size);
+    SHA2<HashType::HASH_VARIANT_256>::Hash(inputs[i].data(), inputs[i].size(),
+                                           output.data());
+    BOOST_CHECK(output == expected);
+  }
+
+  bytes expected;
+  DataConversion::HexStrToUint8Vec(
+      "248D6A61D20638B8E5C026930C3E6039A33CE45964FF2167F6ECEDD419DB06C1",
+      expected);
+  bytes output(size);
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  sha2.Update(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+  sha2.Finalize(output.data());
+  BOOST_CHECK(output == expected);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
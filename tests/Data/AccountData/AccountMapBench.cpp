@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// Compares std::map and FlatAddressMap as the map of AccountStoreTemp. Each
+/// epoch pulls accounts in the way AccountStoreTemp::GetAccount does, looks
+/// them up again as transactions would, walks them in address order as
+/// SerializeDelta does and then clears the map for the next epoch.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "libData/AccountData/Account.h"
+#include "libData/AccountData/FlatAddressMap.h"
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+
+namespace po = boost::program_options;
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+struct Options {
+  unsigned int accounts{100000};
+  unsigned int lookups{4};
+  unsigned int epochs{10};
+};
+
+struct Timings {
+  double insertMs{0};
+  double lookupMs{0};
+  double walkMs{0};
+  double clearMs{0};
+};
+
+double ElapsedMs(const Clock::time_point& start) {
+  return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+Account* GetOrInsert(map<Address, Account>& accounts, const Address& address,
+                     const Account& parent) {
+  auto it = accounts.find(address);
+  if (it != accounts.end()) {
+    return &it->second;
+  }
+  return &accounts.insert(make_pair(address, parent)).first->second;
+}
+
+Account* GetOrInsert(FlatAddressMap<Account>& accounts, const Address& address,
+                     const Account& parent) {
+  auto it = accounts.find(address);
+  if (it != accounts.end()) {
+    return &it->second;
+  }
+  return &accounts.insert(make_pair(address, parent)).first->second;
+}
+
+uint64_t WalkInOrder(const map<Address, Account>& accounts) {
+  uint64_t sum = 0;
+  for (const auto& entry : accounts) {
+    sum += entry.second.GetNonce();
+  }
+  return sum;
+}
+
+uint64_t WalkInOrder(const FlatAddressMap<Account>& accounts) {
+  uint64_t sum = 0;
+  for (const auto* entry : accounts.GetSortedEntries()) {
+    sum += entry->second.GetNonce();
+  }
+  return sum;
+}
+
+template <class MAP>
+Timings Run(const Options& options, const vector<Address>& addresses) {
+  MAP accounts;
+  Timings timings;
+  const Account parent(1000000, 0);
+  uint64_t sum = 0;
+
+  for (unsigned int epoch = 0; epoch < options.epochs; epoch++) {
+    auto start = Clock::now();
+    for (const auto& address : addresses) {
+      GetOrInsert(accounts, address, parent);
+    }
+    timings.insertMs += ElapsedMs(start);
+
+    start = Clock::now();
+    for (unsigned int i = 0; i < options.lookups; i++) {
+      for (const auto& address : addresses) {
+        GetOrInsert(accounts, address, parent)->IncreaseNonce();
+      }
+    }
+    timings.lookupMs += ElapsedMs(start);
+
+    start = Clock::now();
+    sum += WalkInOrder(accounts);
+    timings.walkMs += ElapsedMs(start);
+
+    start = Clock::now();
+    accounts.clear();
+    timings.clearMs += ElapsedMs(start);
+  }
+
+  // Keeps the work from being optimized away
+  if (sum != uint64_t(options.epochs) * options.lookups * addresses.size()) {
+    cerr << "Unexpected checksum " << sum << endl;
+  }
+  return timings;
+}
+
+void Print(const string& name, const Options& options,
+           const Timings& timings) {
+  cout << setw(16) << name << fixed << setprecision(2) << setw(12)
+       << timings.insertMs / options.epochs << setw(12)
+       << timings.lookupMs / options.epochs << setw(12)
+       << timings.walkMs / options.epochs << setw(12)
+       << timings.clearMs / options.epochs << endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  try {
+    Options options;
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "accounts,a", po::value<unsigned int>(&options.accounts),
+        "Accounts touched per epoch (default 100000)")(
+        "lookups,l", po::value<unsigned int>(&options.lookups),
+        "Lookups of each account per epoch (default 4)")(
+        "epochs,e", po::value<unsigned int>(&options.epochs),
+        "Number of epochs (default 10)");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help")) {
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      po::notify(vm);
+    } catch (boost::program_options::error& e) {
+      cerr << "ERROR: " << e.what() << endl << endl;
+      cout << desc;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    if (options.epochs == 0) {
+      cerr << "ERROR: epochs must be positive" << endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    vector<Address> addresses(options.accounts);
+    for (auto& address : addresses) {
+      address = Address().random();
+    }
+
+    cout << "Average ms per epoch" << endl;
+    cout << setw(16) << "map" << setw(12) << "insert" << setw(12) << "lookup"
+         << setw(12) << "walk" << setw(12) << "clear" << endl;
+    Print("std::map", options, Run<map<Address, Account>>(options, addresses));
+    Print("FlatAddressMap", options,
+          Run<FlatAddressMap<Account>>(options, addresses));
+  } catch (exception& e) {
+    cerr << "Unhandled Exception reached the top of main: " << e.what()
+         << ", application will now exit" << endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+
+  return SUCCESS;
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// Measures the state layer at several state sizes: building the state trie
+/// and its root, MoveUpdatesToDisk, RepopulateStateTrie, payments through
+/// UpdateAccountsTemp and SerializeDelta/DeserializeDelta. Each row reports
+/// the items handled, the time taken, items per second and heap allocations
+/// per item.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Schnorr.h>
+#include <boost/program_options.hpp>
+
+#include "common/Constants.h"
+#include "libData/AccountData/AccountStore.h"
+#include "libData/AccountData/Transaction.h"
+#include "libData/AccountData/TransactionReceipt.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+
+namespace po = boost::program_options;
+using namespace std;
+
+namespace {
+atomic<uint64_t> g_allocations{0};
+}  // namespace
+
+void* operator new(size_t size) {
+  g_allocations++;
+  void* p = malloc(size);
+  if (p == nullptr) {
+    throw bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+struct Options {
+  string sizes{"10000,100000,1000000"};
+  unsigned int payments{2000};
+};
+
+class Measurement {
+ public:
+  Measurement(const string& name, uint64_t items)
+      : m_name(name),
+        m_items(items),
+        m_allocations(g_allocations),
+        m_start(Clock::now()) {}
+
+  void Print(bool ok = true) const {
+    const double ms =
+        chrono::duration<double, milli>(Clock::now() - m_start).count();
+    const uint64_t allocations = g_allocations - m_allocations;
+    cout << setw(20) << m_name << setw(10) << m_items << fixed
+         << setprecision(2) << setw(12) << ms << setw(14)
+         << (ms > 0 ? m_items * 1000 / ms : 0) << setw(12)
+         << (m_items > 0 ? double(allocations) / m_items : 0)
+         << (ok ? "" : "  FAILED") << endl;
+  }
+
+ private:
+  const string m_name;
+  const uint64_t m_items;
+  const uint64_t m_allocations;
+  const Clock::time_point m_start;
+};
+
+vector<unsigned int> ParseSizes(const string& sizes) {
+  vector<unsigned int> ret;
+  stringstream ss(sizes);
+  string item;
+  while (getline(ss, item, ',')) {
+    ret.emplace_back(stoul(item));
+  }
+  return ret;
+}
+
+void Run(unsigned int numAccounts, unsigned int numPayments) {
+  AccountStore& store = AccountStore::GetInstance();
+  store.Init();
+
+  vector<Address> addresses(numAccounts);
+  for (auto& address : addresses) {
+    address = Address().random();
+    store.AddAccount(address, {1000000, 0});
+  }
+
+  vector<Transaction> txns;
+  txns.reserve(numPayments);
+  for (unsigned int i = 0; i < numPayments; i++) {
+    PairOfKey sender = Schnorr::GenKeyPair();
+    store.AddAccount(sender.second, {1000000, 0});
+    txns.emplace_back(DataConversion::Pack(CHAIN_ID, 1), 1,
+                      addresses.at(i % numAccounts), sender, 10, 1,
+                      NORMAL_TRAN_GAS);
+  }
+  const uint64_t total = numAccounts + numPayments;
+
+  {
+    Measurement m("StateTrieRoot", total);
+    bool ok = store.UpdateStateTrieAll();
+    ok = ok && (store.GetStateRootHash() != dev::h256());
+    m.Print(ok);
+  }
+
+  {
+    Measurement m("MoveUpdatesToDisk", total);
+    m.Print(store.MoveUpdatesToDisk());
+  }
+
+  {
+    Measurement m("RepopulateStateTrie", total);
+    m.Print(store.RepopulateStateTrie());
+  }
+
+  store.InitTemp();
+  {
+    Measurement m("UpdateAccountsTemp", numPayments);
+    bool ok = true;
+    for (const auto& txn : txns) {
+      TransactionReceipt receipt;
+      ok = store.UpdateAccountsTemp(1, 1, false, txn, receipt) && ok;
+    }
+    m.Print(ok);
+  }
+
+  {
+    Measurement m("SerializeDelta", numPayments);
+    m.Print(store.SerializeDelta());
+  }
+
+  bytes delta;
+  store.GetSerializedDelta(delta);
+  {
+    Measurement m("DeserializeDelta", numPayments);
+    m.Print(store.DeserializeDelta(delta, 0));
+  }
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  try {
+    Options options;
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "sizes,s", po::value<string>(&options.sizes),
+        "Comma separated numbers of accounts (default 10000,100000,1000000)")(
+        "payments,p", po::value<unsigned int>(&options.payments),
+        "Payments applied per size (default 2000)");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help")) {
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      po::notify(vm);
+    } catch (boost::program_options::error& e) {
+      cerr << "ERROR: " << e.what() << endl << endl;
+      cout << desc;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    vector<unsigned int> sizes;
+    try {
+      sizes = ParseSizes(options.sizes);
+    } catch (exception& e) {
+      cerr << "ERROR: invalid sizes " << options.sizes << endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    INIT_FILE_LOGGER("statebench", ".");
+
+    cout << setw(20) << "operation" << setw(10) << "items" << setw(12) << "ms"
+         << setw(14) << "items/sec" << setw(12) << "allocs/item" << endl;
+    for (const auto size : sizes) {
+      if (size == 0) {
+        continue;
+      }
+      cout << "--- " << size << " accounts" << endl;
+      Run(size, options.payments);
+    }
+  } catch (exception& e) {
+    cerr << "Unhandled Exception reached the top of main: " << e.what()
+         << ", application will now exit" << endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+
+  return SUCCESS;
+}
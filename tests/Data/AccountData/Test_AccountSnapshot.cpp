@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "libData/AccountData/AccountSnapshot.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE accountsnapshottest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(accountsnapshottest)
+
+BOOST_AUTO_TEST_CASE(test_publish) {
+  INIT_STDOUT_LOGGER();
+
+  AccountSnapshot snapshot(1000);
+  const Address address = Address().random();
+  AccountSnapshot::Entry entry;
+  BOOST_CHECK(!snapshot.Get(address, entry));
+
+  // Staged changes only show once published
+  snapshot.Update(address, {100, 1});
+  BOOST_CHECK(!snapshot.Get(address, entry));
+  snapshot.Publish();
+  BOOST_CHECK(snapshot.Get(address, entry));
+  BOOST_CHECK_EQUAL(entry.m_balance, 100);
+  BOOST_CHECK_EQUAL(entry.m_nonce, 1);
+
+  snapshot.Update(address, {50, 2});
+  snapshot.Publish();
+  BOOST_CHECK(snapshot.Get(address, entry));
+  BOOST_CHECK_EQUAL(entry.m_balance, 50);
+  BOOST_CHECK_EQUAL(entry.m_nonce, 2);
+
+  snapshot.Remove(address);
+  snapshot.Publish();
+  BOOST_CHECK(!snapshot.Get(address, entry));
+  BOOST_CHECK_EQUAL(snapshot.GetVersion(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_offer) {
+  INIT_STDOUT_LOGGER();
+
+  AccountSnapshot snapshot(1000);
+  const Address fresh = Address().random();
+  const Address stale = Address().random();
+  const Address committed = Address().random();
+  AccountSnapshot::Entry entry;
+
+  snapshot.Offer(fresh, {10, 1}, snapshot.GetVersion());
+
+  // An offer read before a publish is dropped
+  const uint64_t version = snapshot.GetVersion();
+  snapshot.Publish();
+  snapshot.Offer(stale, {20, 1}, version);
+
+  // The committed change wins over an older offer
+  snapshot.Offer(committed, {30, 1}, snapshot.GetVersion());
+  snapshot.Update(committed, {25, 2});
+  snapshot.Publish();
+
+  BOOST_CHECK(snapshot.Get(fresh, entry));
+  BOOST_CHECK_EQUAL(entry.m_balance, 10);
+  BOOST_CHECK(!snapshot.Get(stale, entry));
+  BOOST_CHECK(snapshot.Get(committed, entry));
+  BOOST_CHECK_EQUAL(entry.m_balance, 25);
+  BOOST_CHECK_EQUAL(entry.m_nonce, 2);
+
+  snapshot.Clear();
+  BOOST_CHECK(!snapshot.Get(fresh, entry));
+  BOOST_CHECK_EQUAL(snapshot.Size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_capacity) {
+  INIT_STDOUT_LOGGER();
+
+  // One entry per bucket
+  AccountSnapshot snapshot(1);
+  vector<Address> addresses;
+  for (unsigned int i = 0; i < 1000; i++) {
+    addresses.emplace_back(Address().random());
+    snapshot.Update(addresses.back(), {i, i});
+    if (i % 10 == 9) {
+      snapshot.Publish();
+    }
+  }
+  BOOST_CHECK_LE(snapshot.Size(), 64 + 10);
+
+  // The accounts of the last commit are kept
+  AccountSnapshot::Entry entry;
+  BOOST_CHECK(snapshot.Get(addresses.back(), entry));
+}
+
+BOOST_AUTO_TEST_CASE(test_pending_nonce) {
+  INIT_STDOUT_LOGGER();
+
+  AccountSnapshot snapshot(1000);
+  const Address address = Address().random();
+  BOOST_CHECK_EQUAL(snapshot.GetPendingNonce(address, 4), 4);
+
+  snapshot.AdmitNonce(address, 6);
+  snapshot.AdmitNonce(address, 5);
+  BOOST_CHECK_EQUAL(snapshot.GetPendingNonce(address, 4), 6);
+
+  // Dropped once committed
+  snapshot.Update(address, {0, 5});
+  snapshot.Publish();
+  BOOST_CHECK_EQUAL(snapshot.GetPendingNonce(address, 5), 6);
+  snapshot.Update(address, {0, 6});
+  snapshot.Publish();
+  BOOST_CHECK_EQUAL(snapshot.GetPendingNonce(address, 3), 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -16,7 +16,9 @@
  */
 
 #include <array>
+#include <limits>
 #include <string>
+#include <vector>
 
 #define BOOST_TEST_MODULE accountstoretest
 #define BOOST_TEST_DYN_LINK
@@ -25,6 +27,7 @@
 #include "libData/AccountData/AccountStore.h"
 #include "libData/AccountData/AccountStoreSC.h"
 #include "libData/AccountData/Address.h"
+#include "libMessage/Messenger.h"
 #include "libTestUtils/TestUtils.h"
 #include "libUtils/Logger.h"
 #include "libUtils/SysCommand.h"
@@ -748,6 +751,47 @@ BOOST_AUTO_TEST_CASE(serializeAndDeserialize) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(serializeAndDeserializeChunks) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  AccountStore::GetInstance().Init();
+
+  const unsigned int numAccounts = 25;
+  for (unsigned int i = 1; i <= numAccounts; i++) {
+    AccountStore::GetInstance().AddAccount(Address(i), Account(i, i));
+  }
+  AccountStore::GetInstance().UpdateStateTrieAll();
+  const auto root1 = AccountStore::GetInstance().GetStateRootHash();
+
+  std::vector<bytes> chunks;
+  Address cursor;
+  for (bool more = true; more;) {
+    bytes chunk;
+    Address next;
+    dev::h256 root;
+    BOOST_REQUIRE(AccountStore::GetInstance().SerializeChunk(
+        chunk, 0, cursor, 10, next, more, root));
+    BOOST_CHECK(root == root1);
+    chunks.push_back(chunk);
+    cursor = next;
+  }
+  BOOST_CHECK_EQUAL(chunks.size(), 3);
+
+  AccountStore::GetInstance().Init();
+  BOOST_CHECK(AccountStore::GetInstance().Deserialize(chunks.front(), 0));
+  for (unsigned int i = 1; i < chunks.size(); i++) {
+    BOOST_CHECK(AccountStore::GetInstance().DeserializeChunk(chunks[i], 0));
+  }
+
+  BOOST_CHECK_MESSAGE(AccountStore::GetInstance().GetStateRootHash() == root1,
+                      "State root didn't match after the chunks");
+  for (unsigned int i = 1; i <= numAccounts; i++) {
+    BOOST_CHECK(AccountStore::GetInstance().GetBalance(Address(i)) == i);
+  }
+}
+
 // BOOST_AUTO_TEST_CASE(stateDelta) {
 //   INIT_STDOUT_LOGGER();
 
@@ -1093,4 +1137,257 @@ BOOST_AUTO_TEST_CASE(commitRevertible2) {
 //   BOOST_CHECK_EQUAL(0, num_errors);
 // }
 
+BOOST_AUTO_TEST_CASE(parallelPayments) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  AccountStore::GetInstance().Init();
+
+  // Disjoint payments, every fifth one short of funds and every seventh one
+  // to an existing account
+  const unsigned int numPayments = 40;
+  std::vector<Transaction> txns;
+  for (unsigned int i = 0; i < numPayments; i++) {
+    PairOfKey sender = Schnorr::GenKeyPair();
+    AccountStore::GetInstance().AddAccount(sender.second, {1000, 0});
+
+    PubKey recipient = Schnorr::GenKeyPair().second;
+    if (i % 7 == 0) {
+      AccountStore::GetInstance().AddAccount(recipient, {5, 3});
+    }
+
+    txns.emplace_back(DataConversion::Pack(CHAIN_ID, 1), 1,
+                      Account::GetAddressFromPublicKey(recipient), sender,
+                      (i % 5 == 0) ? 5000 : 10 + i, 1, NORMAL_TRAN_GAS);
+  }
+
+  std::vector<TransactionReceipt> serialReceipts(numPayments);
+  std::vector<char> serialResults;
+  for (unsigned int i = 0; i < numPayments; i++) {
+    serialResults.emplace_back(AccountStore::GetInstance().UpdateAccountsTemp(
+        1, 1, false, txns.at(i), serialReceipts.at(i)));
+  }
+  BOOST_REQUIRE(AccountStore::GetInstance().SerializeDelta());
+  auto serialDeltaHash = AccountStore::GetInstance().GetStateDeltaHash();
+
+  AccountStore::GetInstance().InitTemp();
+
+  std::vector<TransactionReceipt> parallelReceipts(numPayments);
+  std::vector<char> parallelResults;
+  BOOST_REQUIRE(AccountStore::GetInstance().UpdateAccountsTempParallel(
+      1, 1, false, txns, parallelReceipts, parallelResults));
+  BOOST_REQUIRE(AccountStore::GetInstance().SerializeDelta());
+
+  BOOST_CHECK(serialResults == parallelResults);
+  for (unsigned int i = 0; i < numPayments; i++) {
+    BOOST_CHECK_EQUAL(serialResults.at(i), i % 5 != 0);
+    BOOST_CHECK_EQUAL(serialReceipts.at(i).GetString(),
+                      parallelReceipts.at(i).GetString());
+  }
+  BOOST_CHECK_MESSAGE(
+      AccountStore::GetInstance().GetStateDeltaHash() == serialDeltaHash,
+      "Parallel payments produced a different state delta!");
+
+  // Payments sharing an address are rejected as a whole
+  AccountStore::GetInstance().InitTemp();
+  std::vector<Transaction> conflicting = {txns.at(1), txns.at(1)};
+  std::vector<TransactionReceipt> receipts(conflicting.size());
+  std::vector<char> results;
+  BOOST_CHECK(!AccountStore::GetInstance().UpdateAccountsTempParallel(
+      1, 1, false, conflicting, receipts, results));
+}
+
+BOOST_AUTO_TEST_CASE(parallelEarlyReturns) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  AccountStore::GetInstance().Init();
+
+  // Payments the serial path rejects before it looks up the sender: one whose
+  // gas deposit overflows and one to a contract, along with a good one
+  PairOfKey overflowSender = Schnorr::GenKeyPair();
+  PairOfKey contractSender = Schnorr::GenKeyPair();
+  PairOfKey sender = Schnorr::GenKeyPair();
+  AccountStore::GetInstance().AddAccount(overflowSender.second, {1000, 0});
+  AccountStore::GetInstance().AddAccount(contractSender.second, {1000, 0});
+  AccountStore::GetInstance().AddAccount(sender.second, {1000, 0});
+
+  Address contractAddr =
+      Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second);
+  Account contract(0, 0);
+  contract.SetCodeHash(dev::h256(1));
+  AccountStore::GetInstance().AddAccount(contractAddr, contract);
+
+  std::vector<Transaction> txns;
+  txns.emplace_back(
+      DataConversion::Pack(CHAIN_ID, 1), 1,
+      Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second),
+      overflowSender, 10, std::numeric_limits<uint128_t>::max(),
+      NORMAL_TRAN_GAS);
+  txns.emplace_back(DataConversion::Pack(CHAIN_ID, 1), 1, contractAddr,
+                    contractSender, 10, 1, NORMAL_TRAN_GAS);
+  txns.emplace_back(
+      DataConversion::Pack(CHAIN_ID, 1), 1,
+      Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second), sender,
+      10, 1, NORMAL_TRAN_GAS);
+
+  std::vector<TransactionReceipt> serialReceipts(txns.size());
+  std::vector<char> serialResults;
+  for (unsigned int i = 0; i < txns.size(); i++) {
+    serialResults.emplace_back(AccountStore::GetInstance().UpdateAccountsTemp(
+        1, 1, false, txns.at(i), serialReceipts.at(i)));
+  }
+  BOOST_REQUIRE(AccountStore::GetInstance().SerializeDelta());
+  bytes serialDelta;
+  AccountStore::GetInstance().GetSerializedDelta(serialDelta);
+
+  AccountStore::GetInstance().InitTemp();
+
+  std::vector<TransactionReceipt> parallelReceipts(txns.size());
+  std::vector<char> parallelResults;
+  BOOST_REQUIRE(AccountStore::GetInstance().UpdateAccountsTempParallel(
+      1, 1, false, txns, parallelReceipts, parallelResults));
+  BOOST_REQUIRE(AccountStore::GetInstance().SerializeDelta());
+  bytes parallelDelta;
+  AccountStore::GetInstance().GetSerializedDelta(parallelDelta);
+
+  BOOST_CHECK(serialResults == parallelResults);
+  BOOST_CHECK(serialResults == std::vector<char>({false, false, true}));
+  BOOST_CHECK_MESSAGE(serialDelta == parallelDelta,
+                      "Parallel payments produced a different state delta!");
+
+  // Neither rejected sender was pulled into the delta
+  std::unordered_map<Address, boost::multiprecision::int256_t> balanceDeltas;
+  BOOST_REQUIRE(
+      Messenger::StateDeltaToAddressMap(parallelDelta, 0, balanceDeltas));
+  BOOST_CHECK_EQUAL(
+      balanceDeltas.count(Account::GetAddressFromPublicKey(overflowSender.second)),
+      0);
+  BOOST_CHECK_EQUAL(
+      balanceDeltas.count(Account::GetAddressFromPublicKey(contractSender.second)),
+      0);
+}
+
+BOOST_AUTO_TEST_CASE(committedAccountReads) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  AccountStore::GetInstance().Init();
+
+  Address addr =
+      Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second);
+  AccountStore::GetInstance().AddAccount(addr, {100, 0});
+
+  Account account;
+  BOOST_REQUIRE(AccountStore::GetInstance().GetCommittedAccount(addr, account));
+  BOOST_CHECK_EQUAL(account.GetBalance(), 100);
+
+  // Not visible until committed
+  AccountStore::GetInstance().InitTemp();
+  BOOST_REQUIRE(AccountStore::GetInstance().IncreaseBalanceTemp(addr, 50));
+  BOOST_REQUIRE(AccountStore::GetInstance().GetCommittedAccount(addr, account));
+  BOOST_CHECK_EQUAL(account.GetBalance(), 100);
+
+  BOOST_REQUIRE(AccountStore::GetInstance().SerializeDelta());
+  AccountStore::GetInstance().CommitTemp();
+  BOOST_REQUIRE(AccountStore::GetInstance().GetCommittedAccount(addr, account));
+  BOOST_CHECK_EQUAL(account.GetBalance(), 150);
+
+  BOOST_CHECK(!AccountStore::GetInstance().GetCommittedAccount(
+      Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second),
+      account));
+}
+
+BOOST_AUTO_TEST_CASE(incrementalDelta) {
+  using boost::multiprecision::int256_t;
+
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  AccountStore::GetInstance().Init();
+
+  PairOfKey sender = Schnorr::GenKeyPair();
+  Address senderAddr = Account::GetAddressFromPublicKey(sender.second);
+  Address toAddr =
+      Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second);
+  AccountStore::GetInstance().AddAccount(senderAddr, {1000, 0});
+
+  Transaction tx(DataConversion::Pack(CHAIN_ID, 1), 1, toAddr, sender, 100, 1,
+                 NORMAL_TRAN_GAS);
+  TransactionReceipt tr;
+  BOOST_REQUIRE(
+      AccountStore::GetInstance().UpdateAccountsTemp(1, 1, false, tx, tr));
+
+  auto checkDelta = [&](const int256_t& senderDelta) {
+    BOOST_REQUIRE(AccountStore::GetInstance().SerializeDelta());
+    bytes delta;
+    AccountStore::GetInstance().GetSerializedDelta(delta);
+
+    std::unordered_map<Address, int256_t> balanceDeltas;
+    BOOST_REQUIRE(Messenger::StateDeltaToAddressMap(delta, 0, balanceDeltas));
+    BOOST_CHECK_EQUAL(balanceDeltas.size(), 2);
+    BOOST_CHECK_EQUAL(balanceDeltas[senderAddr], senderDelta);
+    BOOST_CHECK_EQUAL(balanceDeltas[toAddr], 100);
+    return delta;
+  };
+
+  checkDelta(-100 - int256_t(NORMAL_TRAN_GAS));
+
+  // Changed after its entry was encoded
+  BOOST_REQUIRE(AccountStore::GetInstance().IncreaseBalanceTemp(senderAddr, 7));
+  bytes delta = checkDelta(-93 - int256_t(NORMAL_TRAN_GAS));
+
+  // Same as encoding every account from scratch
+  AccountStore::GetInstance().InitTemp();
+  BOOST_REQUIRE(AccountStore::GetInstance().DeserializeDeltaTemp(delta, 0));
+  BOOST_CHECK(checkDelta(-93 - int256_t(NORMAL_TRAN_GAS)) == delta);
+}
+
+BOOST_AUTO_TEST_CASE(consecutiveDeltas) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  AccountStore::GetInstance().Init();
+
+  Address addr1 =
+      Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second);
+  Address addr2 =
+      Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second);
+  AccountStore::GetInstance().AddAccount(addr1, {1000, 0});
+
+  bytes delta1, delta2;
+  AccountStore::GetInstance().InitTemp();
+  BOOST_REQUIRE(AccountStore::GetInstance().IncreaseBalanceTemp(addr1, 50));
+  AccountStore::GetInstance().AddAccountTemp(addr2, {5, 0});
+  BOOST_REQUIRE(AccountStore::GetInstance().SerializeDelta());
+  AccountStore::GetInstance().GetSerializedDelta(delta1);
+  AccountStore::GetInstance().CommitTemp();
+
+  AccountStore::GetInstance().InitTemp();
+  BOOST_REQUIRE(AccountStore::GetInstance().IncreaseBalanceTemp(addr1, 25));
+  BOOST_REQUIRE(AccountStore::GetInstance().IncreaseBalanceTemp(addr2, 3));
+  BOOST_REQUIRE(AccountStore::GetInstance().SerializeDelta());
+  AccountStore::GetInstance().GetSerializedDelta(delta2);
+  AccountStore::GetInstance().CommitTemp();
+
+  const auto root = AccountStore::GetInstance().GetStateRootHash();
+
+  // Same as applying the deltas one by one
+  AccountStore::GetInstance().Init();
+  AccountStore::GetInstance().AddAccount(addr1, {1000, 0});
+  BOOST_REQUIRE(
+      AccountStore::GetInstance().DeserializeDeltas({&delta1, &delta2}));
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().GetBalance(addr1), 1075);
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().GetBalance(addr2), 8);
+  BOOST_CHECK(AccountStore::GetInstance().GetStateRootHash() == root);
+
+  bytes garbage(16, 0xff);
+  BOOST_CHECK(!AccountStore::GetInstance().DeserializeDeltas({&garbage}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+
+#include "libData/AccountData/EventBloom.h"
+#include "libData/AccountData/LogEntry.h"
+#include "libData/AccountData/TransactionReceipt.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE eventbloomtest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(eventbloomtest)
+
+BOOST_AUTO_TEST_CASE(test_add_and_match) {
+  INIT_STDOUT_LOGGER();
+
+  EventBloom bloom;
+  BOOST_CHECK(bloom.IsEmpty());
+
+  const Address contract("0x1234567890123456789012345678901234567890");
+  bloom.Add(contract, "Transfer");
+  BOOST_CHECK(!bloom.IsEmpty());
+  BOOST_CHECK(bloom.MayContain(contract, "Transfer"));
+  // Any event of the contract
+  BOOST_CHECK(bloom.MayContain(contract, ""));
+
+  // Few keys were added, so the other ones are not expected to match
+  unsigned int falsePositives = 0;
+  for (unsigned int i = 0; i < 100; i++) {
+    if (bloom.MayContain(contract, "Event" + to_string(i))) {
+      falsePositives++;
+    }
+  }
+  BOOST_CHECK_LT(falsePositives, 5);
+
+  EventBloom other(EventBloom::Bits(bloom.GetBits()));
+  BOOST_CHECK(other.MayContain(contract, "Transfer"));
+}
+
+BOOST_AUTO_TEST_CASE(test_merge) {
+  INIT_STDOUT_LOGGER();
+
+  const Address first("0x1111111111111111111111111111111111111111");
+  const Address second("0x2222222222222222222222222222222222222222");
+
+  EventBloom bloom, other;
+  bloom.Add(first, "Minted");
+  other.Add(second, "Burnt");
+  bloom.Merge(other);
+
+  BOOST_CHECK(bloom.MayContain(first, "Minted"));
+  BOOST_CHECK(bloom.MayContain(second, "Burnt"));
+}
+
+BOOST_AUTO_TEST_CASE(test_add_receipt) {
+  INIT_STDOUT_LOGGER();
+
+  const Address contract("0x3333333333333333333333333333333333333333");
+  Json::Value eventObj;
+  eventObj["_eventname"] = "Swapped";
+  eventObj["params"] = Json::arrayValue;
+  LogEntry entry;
+  BOOST_REQUIRE(entry.Install(eventObj, contract));
+
+  TransactionReceipt receipt;
+  receipt.AddEntry(entry);
+
+  EventBloom bloom;
+  bloom.AddReceipt(receipt);
+  BOOST_CHECK(bloom.MayContain(contract, "Swapped"));
+  BOOST_CHECK(bloom.MayContain(contract, ""));
+
+  EventBloom none;
+  none.AddReceipt(TransactionReceipt());
+  BOOST_CHECK(none.IsEmpty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <random>
+#include <string>
+
+#define BOOST_TEST_MODULE flataddressmaptest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "libData/AccountData/FlatAddressMap.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace {
+Address RandomAddress(mt19937& rng) {
+  Address addr;
+  // Few distinct bytes, so that probe sequences collide a lot
+  for (auto& b : addr.asArray()) {
+    b = rng() % 4;
+  }
+  return addr;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(flataddressmaptest)
+
+BOOST_AUTO_TEST_CASE(test_same_as_std_map) {
+  INIT_STDOUT_LOGGER();
+
+  FlatAddressMap<string> flat;
+  map<Address, string> expected;
+  mt19937 rng(1);
+
+  for (unsigned int round = 0; round < 3; round++) {
+    for (unsigned int i = 0; i < 20000; i++) {
+      const Address addr = RandomAddress(rng);
+      const string value = to_string(i);
+      switch (rng() % 4) {
+        case 0:
+          BOOST_CHECK_EQUAL(flat.erase(addr), expected.erase(addr));
+          break;
+        case 1:
+          flat[addr] = value;
+          expected[addr] = value;
+          break;
+        case 2: {
+          auto ret = flat.insert(make_pair(addr, value));
+          auto expectedRet = expected.insert(make_pair(addr, value));
+          BOOST_CHECK_EQUAL(ret.second, expectedRet.second);
+          BOOST_CHECK_EQUAL(ret.first->second, expectedRet.first->second);
+          break;
+        }
+        default: {
+          auto it = flat.find(addr);
+          auto expectedIt = expected.find(addr);
+          BOOST_REQUIRE_EQUAL(it == flat.end(), expectedIt == expected.end());
+          if (it != flat.end()) {
+            BOOST_CHECK_EQUAL(it->second, expectedIt->second);
+          }
+        }
+      }
+      BOOST_REQUIRE_EQUAL(flat.size(), expected.size());
+    }
+
+    auto sorted = flat.GetSortedEntries();
+    BOOST_REQUIRE_EQUAL(sorted.size(), expected.size());
+    auto expectedIt = expected.begin();
+    for (const auto* entry : sorted) {
+      BOOST_CHECK(entry->first == expectedIt->first);
+      BOOST_CHECK_EQUAL(entry->second, expectedIt->second);
+      expectedIt++;
+    }
+
+    flat.clear();
+    expected.clear();
+    BOOST_CHECK(flat.empty());
+    BOOST_CHECK(flat.begin() == flat.end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_pointer_stability) {
+  INIT_STDOUT_LOGGER();
+
+  FlatAddressMap<unsigned int> flat;
+
+  const Address first = Address().random();
+  unsigned int* value = &flat[first];
+  *value = 7;
+
+  // Enough to grow the table several times
+  for (unsigned int i = 0; i < 10000; i++) {
+    flat.emplace(Address().random(), i);
+  }
+
+  BOOST_CHECK_EQUAL(value, &flat.find(first)->second);
+  BOOST_CHECK_EQUAL(*value, 7);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+
+#define BOOST_TEST_MODULE pendingtxnqueuetest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "libData/AccountData/PendingTxnQueue.h"
+#include "libTestUtils/TestUtils.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+using namespace boost::multiprecision;
+
+namespace {
+Transaction CreateTransaction(const PubKey& senderPubKey, const uint64_t& nonce,
+                              const uint128_t& gasPrice) {
+  return Transaction(TxnHash().random(), TestUtils::DistUint32(), nonce,
+                     Address().random(), senderPubKey, TestUtils::DistUint128(),
+                     gasPrice, TestUtils::DistUint64(), {}, {},
+                     TestUtils::GenerateRandomSignature());
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(pendingtxnqueuetest)
+
+BOOST_AUTO_TEST_CASE(test_ready_order) {
+  INIT_STDOUT_LOGGER();
+
+  map<Address, uint128_t> nonces;
+  PendingTxnQueue queue(
+      [&nonces](const Address& addr) { return nonces[addr]; });
+
+  PubKey sender1 = TestUtils::GenerateRandomPubKey();
+  PubKey sender2 = TestUtils::GenerateRandomPubKey();
+  Address addr1 = Account::GetAddressFromPublicKey(sender1);
+  Address addr2 = Account::GetAddressFromPublicKey(sender2);
+
+  queue.Insert(CreateTransaction(sender1, 2, 1));
+  queue.Insert(CreateTransaction(sender1, 3, 1));
+  queue.Insert(CreateTransaction(sender2, 5, 1));
+
+  Transaction t;
+  BOOST_CHECK_MESSAGE(!queue.PopReady(t), "No sender should be ready!");
+
+  // Sender 1 applied nonce 1
+  nonces[addr1] = 1;
+  queue.Touch(addr1);
+  BOOST_REQUIRE(queue.PopReady(t));
+  BOOST_CHECK_EQUAL(t.GetNonce(), 2);
+
+  // Not applied yet, so nonce 3 has to wait
+  BOOST_CHECK(!queue.PopReady(t));
+
+  nonces[addr1] = 2;
+  BOOST_REQUIRE(queue.PopReady(t));
+  BOOST_CHECK_EQUAL(t.GetNonce(), 3);
+  BOOST_CHECK(!queue.Contains(addr1));
+
+  // Sender 2 is only looked up again once touched
+  nonces[addr2] = 4;
+  BOOST_CHECK(!queue.PopReady(t));
+  queue.Touch(addr2);
+  BOOST_REQUIRE(queue.PopReady(t));
+  BOOST_CHECK_EQUAL(t.GetNonce(), 5);
+  BOOST_CHECK(queue.GetTxns().empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_same_nonce) {
+  INIT_STDOUT_LOGGER();
+
+  PendingTxnQueue queue([](const Address&) { return 0; });
+
+  PubKey sender = TestUtils::GenerateRandomPubKey();
+  Transaction cheap = CreateTransaction(sender, 1, 10);
+  Transaction expensive = CreateTransaction(sender, 1, 20);
+
+  queue.Insert(cheap);
+  queue.Insert(expensive);
+  queue.Insert(cheap);
+
+  Transaction t;
+  BOOST_REQUIRE(queue.PopReady(t));
+  BOOST_CHECK(t.GetTranID() == expensive.GetTranID());
+  BOOST_CHECK(!queue.PopReady(t));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
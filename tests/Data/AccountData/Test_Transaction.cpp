@@ -195,6 +195,46 @@ BOOST_AUTO_TEST_CASE(testOperators) {
   BOOST_CHECK_MESSAGE(tx1 < tx3, "Less-than operator failed");
 }
 
+BOOST_AUTO_TEST_CASE(testSerializationCache) {
+  INIT_STDOUT_LOGGER();
+  LOG_MARKER();
+
+  PairOfKey sender = Schnorr::GenKeyPair();
+  Transaction tx1(DataConversion::Pack(CHAIN_ID, 1), 5, Address().random(),
+                  sender, 55, PRECISION_MIN_VALUE, 22, {}, {});
+
+  bytes message1;
+  BOOST_CHECK(tx1.Serialize(message1, 0));
+
+  // Cached bytes are written at the offset like a fresh encoding
+  bytes message2(3, 0xAB);
+  BOOST_CHECK(tx1.Serialize(message2, 3));
+  BOOST_CHECK(equal(message1.begin(), message1.end(), message2.begin() + 3));
+  BOOST_CHECK_EQUAL(message2.at(0), 0xAB);
+
+  // Copies share the encodings
+  Transaction tx2 = tx1;
+  bytes message3;
+  tx2.Serialize(message3, 0);
+  BOOST_CHECK(message1 == message3);
+
+  // A new signature drops the cached encoding but not the core fields
+  bytes coreFields1;
+  tx2.SerializeCoreFields(coreFields1, 0);
+  tx2.SetSignature(TestUtils::GenerateRandomSignature());
+  bytes message4;
+  tx2.Serialize(message4, 0);
+  BOOST_CHECK(message1 != message4);
+  bytes coreFields2;
+  tx2.SerializeCoreFields(coreFields2, 0);
+  BOOST_CHECK(coreFields1 == coreFields2);
+
+  // The original is unaffected
+  bytes message5;
+  tx1.Serialize(message5, 0);
+  BOOST_CHECK(message1 == message5);
+}
+
 // Coverage of MBnForwardedTxnEntry
 BOOST_AUTO_TEST_CASE(coveragembnforwardedtxnentry) {
   INIT_STDOUT_LOGGER();
@@ -23,6 +23,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "libData/AccountData/TransactionReceipt.h"
+#include "libMessage/Messenger.h"
 #include "libTestUtils/TestUtils.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/Logger.h"
@@ -145,4 +146,53 @@ BOOST_AUTO_TEST_CASE(transactionwithreceipt) {
                         txnOrder, twr_map, th_out));
   BOOST_CHECK_EQUAL(true, hash == th_out);
 }
+
+BOOST_AUTO_TEST_CASE(transactionreceiptdata) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  Address addr;
+  addr[0] = 5;
+  Json::Value eventObj;
+  eventObj["_eventname"] = "Event";
+  eventObj["params"] = Json::arrayValue;
+  LogEntry entry;
+  BOOST_CHECK_EQUAL(true, entry.Install(eventObj, addr));
+  Json::Value msg;
+  msg["_tag"] = "Tag";
+  msg["params"] = Json::arrayValue;
+
+  TransactionReceipt tr;
+  tr.AddEdge();
+  tr.AddError(CALL_CONTRACT_FAILED);
+  tr.AddEntry(entry);
+  tr.AddTransition(addr, msg, 2);
+  tr.SetCumGas(TestUtils::DistUint64());
+  tr.SetEpochNum(TestUtils::DistUint64());
+  tr.SetResult(true);
+  tr.update();
+  const std::string tranReceiptStr = tr.GetString();
+
+  // A JSON receipt in the form the class writes is split into its fields
+  TransactionReceipt tr_2;
+  BOOST_CHECK_EQUAL(true, tr_2.SetString(tranReceiptStr));
+  BOOST_CHECK_EQUAL(true, tr_2.GetData().m_others.empty());
+  BOOST_CHECK_EQUAL(1, tr_2.GetData().m_transitions.size());
+  tr_2.update();
+  BOOST_CHECK_EQUAL(tranReceiptStr, tr_2.GetString());
+
+  // The binary form gives back the same JSON receipt
+  bytes dst;
+  BOOST_CHECK_EQUAL(
+      true, Messenger::SetTransactionReceiptData(dst, 0, tr.GetData()));
+  TransactionReceipt::Data data;
+  BOOST_CHECK_EQUAL(true, Messenger::GetTransactionReceiptData(dst, 0, data));
+  TransactionReceipt tr_3;
+  tr_3.SetData(data, dst);
+  BOOST_CHECK_EQUAL(tranReceiptStr, tr_3.GetString());
+  BOOST_CHECK_EQUAL(tr.GetCumGas(), tr_3.GetCumGas());
+  BOOST_CHECK_LT(dst.size(), tranReceiptStr.size());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -173,4 +173,139 @@ BOOST_AUTO_TEST_CASE(txnpool) {
   BOOST_CHECK_EQUAL(false, tp.findOne(transactionTest));
 }
 
+BOOST_AUTO_TEST_CASE(txnpool_same_nonce) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  TestUtils::Initialize();
+
+  TxnPool tp;
+
+  PubKey senderPubKey = TestUtils::GenerateRandomPubKey();
+  Transaction low = createTransaction(10, TxnHash().random(), senderPubKey, 1);
+  Transaction high = createTransaction(20, TxnHash().random(), senderPubKey, 1);
+  Transaction other =
+      createTransaction(15, TxnHash().random(), senderPubKey, 2);
+
+  // ============================================================
+  // Higher gas price replaces the entry with the same nonce
+  // ============================================================
+  BOOST_CHECK_EQUAL(true, tp.insert(low));
+  BOOST_CHECK_EQUAL(true, tp.insert(other));
+  BOOST_CHECK_EQUAL(true, tp.insert(high));
+  BOOST_CHECK_EQUAL(2, tp.size());
+  BOOST_CHECK_EQUAL(false, tp.exist(low.GetTranID()));
+  BOOST_CHECK_EQUAL(true, tp.exist(high.GetTranID()));
+
+  // ============================================================
+  // Lower gas price does not replace it
+  // ============================================================
+  BOOST_CHECK_EQUAL(true, tp.insert(low));
+  BOOST_CHECK_EQUAL(2, tp.size());
+  BOOST_CHECK_EQUAL(false, tp.exist(low.GetTranID()));
+
+  // ============================================================
+  // Transactions come out in order of gas price
+  // ============================================================
+  Transaction transactionTest;
+  BOOST_CHECK_EQUAL(true, tp.findOne(transactionTest));
+  BOOST_CHECK_EQUAL(true, transactionTest == high);
+  BOOST_CHECK_EQUAL(true, tp.findOne(transactionTest));
+  BOOST_CHECK_EQUAL(true, transactionTest == other);
+  BOOST_CHECK_EQUAL(false, tp.findOne(transactionTest));
+  BOOST_CHECK_EQUAL(0, tp.size());
+}
+
+BOOST_AUTO_TEST_CASE(txnpool_view) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  TestUtils::Initialize();
+
+  TxnPool tp;
+
+  std::vector<Transaction> transaction_v;
+  generateUniqueTransactionVector(transaction_v, TestUtils::Dist1to99() + 1);
+  for (const auto& t : transaction_v) {
+    tp.insert(t);
+  }
+  const unsigned int poolSize = tp.size();
+
+  // ============================================================
+  // Taking transactions out of the view leaves the pool untouched
+  // ============================================================
+  TxnPoolView view;
+  view.Reset(tp);
+  Transaction first;
+  BOOST_CHECK_EQUAL(true, view.findOne(first));
+  Transaction second;
+  BOOST_CHECK_EQUAL(true, view.findOne(second));
+  BOOST_CHECK_EQUAL(poolSize, tp.size());
+  BOOST_CHECK_EQUAL(true, tp.exist(first.GetTranID()));
+
+  // ============================================================
+  // Resetting the view starts again from the whole pool
+  // ============================================================
+  view.Reset(tp);
+  unsigned int count = 0;
+  Transaction transactionTest;
+  while (view.findOne(transactionTest)) {
+    if (count == 0) {
+      BOOST_CHECK_EQUAL(true, transactionTest == first);
+    }
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(poolSize, count);
+
+  // ============================================================
+  // Applying the view keeps only what was inserted back
+  // ============================================================
+  BOOST_CHECK_EQUAL(true, view.insert(second));
+  BOOST_CHECK_EQUAL(false, view.insert(second));
+  view.ApplyTo(tp);
+  BOOST_CHECK_EQUAL(1, tp.size());
+  BOOST_CHECK_EQUAL(true, tp.exist(second.GetTranID()));
+}
+
+BOOST_AUTO_TEST_CASE(txnpool_memory_limit) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  TestUtils::Initialize();
+
+  PubKey senderPubKey = TestUtils::GenerateRandomPubKey();
+  PubKey otherPubKey = TestUtils::GenerateRandomPubKey();
+  Transaction cheap1 =
+      createTransaction(1, TxnHash().random(), senderPubKey, 1);
+  Transaction cheap2 =
+      createTransaction(50, TxnHash().random(), senderPubKey, 2);
+  Transaction rich = createTransaction(100, TxnHash().random(), otherPubKey, 1);
+
+  TxnPool tp(TxnPool::GetMemorySize(cheap1) + TxnPool::GetMemorySize(cheap2) +
+             TxnPool::GetMemorySize(rich) - 1);
+
+  BOOST_CHECK_EQUAL(true, tp.insert(cheap1));
+  BOOST_CHECK_EQUAL(true, tp.insert(cheap2));
+  BOOST_CHECK_EQUAL(TxnPool::GetMemorySize(cheap1) +
+                        TxnPool::GetMemorySize(cheap2),
+                    tp.GetSizeInBytes());
+
+  // ============================================================
+  // The sender of the cheapest transaction loses its highest nonce
+  // ============================================================
+  BOOST_CHECK_EQUAL(true, tp.insert(rich));
+  BOOST_CHECK_EQUAL(1, tp.GetEvictedCount());
+  BOOST_CHECK_EQUAL(true, tp.exist(cheap1.GetTranID()));
+  BOOST_CHECK_EQUAL(false, tp.exist(cheap2.GetTranID()));
+  BOOST_CHECK_EQUAL(true, tp.exist(rich.GetTranID()));
+
+  Transaction transactionTest;
+  while (tp.findOne(transactionTest)) {
+  }
+  BOOST_CHECK_EQUAL(0, tp.GetSizeInBytes());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <vector>
+
+#define BOOST_TEST_MODULE txnspeculationtest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "libData/AccountData/AccountStore.h"
+#include "libData/AccountData/Address.h"
+#include "libData/AccountData/TxnSpeculation.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+
+BOOST_AUTO_TEST_SUITE(txnspeculationtest)
+
+struct Payments {
+  PairOfKey m_sender1 = Schnorr::GenKeyPair();
+  PairOfKey m_sender2 = Schnorr::GenKeyPair();
+  Address m_addr1 = Account::GetAddressFromPublicKey(m_sender1.second);
+  Address m_addr2 = Account::GetAddressFromPublicKey(m_sender2.second);
+  Address m_existing =
+      Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second);
+  Address m_created =
+      Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second);
+  std::vector<Transaction> m_txns;
+
+  // Two senders, one of them paid by the other and the last payment short of
+  // funds, committed before the round
+  Payments() {
+    AccountStore::GetInstance().Init();
+    AccountStore::GetInstance().AddAccount(m_addr1, {1000, 0});
+    AccountStore::GetInstance().AddAccount(m_addr2, {1000, 0});
+    AccountStore::GetInstance().AddAccount(m_existing, {5, 3});
+    AccountStore::GetInstance().InitTemp();
+
+    m_txns.emplace_back(DataConversion::Pack(CHAIN_ID, 1), 1, m_existing,
+                        m_sender1, 100, 1, NORMAL_TRAN_GAS);
+    m_txns.emplace_back(DataConversion::Pack(CHAIN_ID, 1), 2, m_created,
+                        m_sender1, 200, 1, NORMAL_TRAN_GAS);
+    m_txns.emplace_back(DataConversion::Pack(CHAIN_ID, 1), 1, m_addr1,
+                        m_sender2, 50, 1, NORMAL_TRAN_GAS);
+    m_txns.emplace_back(DataConversion::Pack(CHAIN_ID, 1), 2, m_created,
+                        m_sender2, 5000, 1, NORMAL_TRAN_GAS);
+  }
+
+  std::vector<Address> GetAddresses() const {
+    return {m_addr1, m_addr2, m_existing, m_created};
+  }
+};
+
+static void Speculate(TxnSpeculation& speculation,
+                      const std::vector<Transaction>& txns) {
+  speculation.Reset(1);
+  for (const auto& t : txns) {
+    BOOST_REQUIRE(speculation.Speculate(1, t));
+  }
+  BOOST_REQUIRE_EQUAL(speculation.GetNumSpeculated(), txns.size());
+}
+
+BOOST_AUTO_TEST_CASE(sameAsUpdateAccountsTemp) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  Payments payments;
+
+  // Executed as the round does, after the check against the committed sender
+  std::vector<char> expectedResults;
+  std::vector<TransactionReceipt> expectedReceipts(payments.m_txns.size());
+  for (unsigned int i = 0; i < payments.m_txns.size(); i++) {
+    const auto& t = payments.m_txns.at(i);
+    Account sender;
+    BOOST_REQUIRE(AccountStore::GetInstance().GetCommittedAccount(
+        t.GetSenderAddr(), sender));
+    expectedReceipts.at(i).SetEpochNum(1);
+    expectedResults.emplace_back(
+        sender.GetBalance() >= t.GetAmount() &&
+        AccountStore::GetInstance().UpdateAccountsTemp(
+            1, 1, false, t, expectedReceipts.at(i)));
+  }
+  BOOST_CHECK(expectedResults == std::vector<char>({true, true, true, false}));
+  BOOST_REQUIRE(AccountStore::GetInstance().SerializeDelta());
+  const auto expectedDeltaHash =
+      AccountStore::GetInstance().GetStateDeltaHash();
+  std::map<Address, Account> expectedAccounts;
+  for (const auto& addr : payments.GetAddresses()) {
+    BOOST_REQUIRE(AccountStore::GetInstance().PeekAccountTemp(
+        addr, expectedAccounts[addr]));
+  }
+
+  AccountStore::GetInstance().InitTemp();
+  TxnSpeculation speculation;
+  Speculate(speculation, payments.m_txns);
+  BOOST_CHECK_EQUAL(speculation.GetNonce(payments.m_addr1), 2);
+  BOOST_CHECK_EQUAL(speculation.GetNonce(payments.m_addr2), 2);
+  BOOST_CHECK_EQUAL(speculation.GetNonce(payments.m_created), 0);
+
+  // Speculating leaves AccountStoreTemp as it is
+  Account account;
+  BOOST_REQUIRE(
+      AccountStore::GetInstance().PeekAccountTemp(payments.m_addr1, account));
+  BOOST_CHECK_EQUAL(account.GetBalance(), 1000);
+  BOOST_CHECK(!AccountStore::GetInstance().PeekAccountTemp(payments.m_created,
+                                                           account));
+
+  BOOST_REQUIRE(speculation.Validate(1));
+  for (unsigned int i = 0; i < payments.m_txns.size(); i++) {
+    bool result = false;
+    TransactionReceipt receipt;
+    BOOST_REQUIRE(speculation.TakeNext(payments.m_txns.at(i), result, receipt));
+    BOOST_CHECK_EQUAL(result, static_cast<bool>(expectedResults.at(i)));
+    if (result) {
+      BOOST_CHECK_EQUAL(receipt.GetString(),
+                        expectedReceipts.at(i).GetString());
+    }
+  }
+  BOOST_CHECK_EQUAL(speculation.GetNumSpeculated(), 0);
+
+  for (const auto& addr : payments.GetAddresses()) {
+    BOOST_REQUIRE(AccountStore::GetInstance().PeekAccountTemp(addr, account));
+    BOOST_CHECK_EQUAL(account.GetBalance(),
+                      expectedAccounts[addr].GetBalance());
+    BOOST_CHECK_EQUAL(account.GetNonce(), expectedAccounts[addr].GetNonce());
+  }
+  BOOST_REQUIRE(AccountStore::GetInstance().SerializeDelta());
+  BOOST_CHECK_MESSAGE(
+      AccountStore::GetInstance().GetStateDeltaHash() == expectedDeltaHash,
+      "Speculated payments produced a different state delta!");
+}
+
+BOOST_AUTO_TEST_CASE(validateDiscardsChangedSeeds) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  Payments payments;
+  TxnSpeculation speculation;
+  bool result = false;
+  TransactionReceipt receipt;
+
+  // The final block changed the balance of a sender
+  Speculate(speculation, payments.m_txns);
+  BOOST_REQUIRE(
+      AccountStore::GetInstance().IncreaseBalanceTemp(payments.m_addr2, 1));
+  BOOST_CHECK(!speculation.Validate(1));
+  BOOST_CHECK_EQUAL(speculation.GetNumSpeculated(), 0);
+  BOOST_CHECK(!speculation.TakeNext(payments.m_txns.front(), result, receipt));
+
+  // Or the nonce of a recipient
+  AccountStore::GetInstance().InitTemp();
+  Speculate(speculation, payments.m_txns);
+  AccountStore::GetInstance().AddAccountTemp(payments.m_existing, {5, 4});
+  BOOST_CHECK(!speculation.Validate(1));
+  BOOST_CHECK_EQUAL(speculation.GetNumSpeculated(), 0);
+
+  // Or created an account that was not there
+  AccountStore::GetInstance().InitTemp();
+  Speculate(speculation, payments.m_txns);
+  AccountStore::GetInstance().AddAccountTemp(payments.m_created, {0, 0});
+  BOOST_CHECK(!speculation.Validate(1));
+  BOOST_CHECK_EQUAL(speculation.GetNumSpeculated(), 0);
+
+  // Or the round is not the one speculated for
+  AccountStore::GetInstance().InitTemp();
+  Speculate(speculation, payments.m_txns);
+  BOOST_CHECK(!speculation.Validate(2));
+  BOOST_CHECK_EQUAL(speculation.GetNumSpeculated(), 0);
+
+  // Accounts the speculation did not start from may change
+  AccountStore::GetInstance().InitTemp();
+  Speculate(speculation, payments.m_txns);
+  AccountStore::GetInstance().AddAccountTemp(
+      Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second), {7, 0});
+  BOOST_CHECK(speculation.Validate(1));
+  BOOST_CHECK_EQUAL(speculation.GetNumSpeculated(), payments.m_txns.size());
+}
+
+BOOST_AUTO_TEST_CASE(takeNextResetsAtFirstMiss) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  Payments payments;
+  TxnSpeculation speculation;
+  Speculate(speculation, payments.m_txns);
+  BOOST_REQUIRE(speculation.Validate(1));
+
+  bool result = false;
+  TransactionReceipt receipt;
+  BOOST_REQUIRE(speculation.TakeNext(payments.m_txns.at(0), result, receipt));
+  BOOST_CHECK(result);
+
+  // The round took another transaction, so the rest started from other
+  // accounts
+  BOOST_CHECK(!speculation.TakeNext(payments.m_txns.at(2), result, receipt));
+  BOOST_CHECK_EQUAL(speculation.GetNumSpeculated(), 0);
+  BOOST_CHECK(!speculation.TakeNext(payments.m_txns.at(1), result, receipt));
+
+  // Only the transaction taken is in AccountStoreTemp
+  Account account;
+  BOOST_REQUIRE(
+      AccountStore::GetInstance().PeekAccountTemp(payments.m_addr1, account));
+  BOOST_CHECK_EQUAL(account.GetNonce(), 1);
+  BOOST_CHECK(!AccountStore::GetInstance().PeekAccountTemp(payments.m_created,
+                                                           account));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -134,6 +134,45 @@ BOOST_AUTO_TEST_CASE(BlockLinkChain_test) {
           ".\n");
 }
 
+BOOST_AUTO_TEST_CASE(BlockLinkChain_index_test) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  BlockLinkChain blc;
+
+  // DS epoch 0: DS, VC; DS epoch 1: DS, FB, VC
+  const vector<pair<uint64_t, BlockType>> links = {
+      {0, DS}, {0, VC}, {1, DS}, {1, FB}, {1, VC}};
+  for (uint64_t i = 0; i < links.size(); i++) {
+    BOOST_CHECK(blc.AddBlockLink(i, links[i].first, links[i].second,
+                                 BlockHash::random()));
+  }
+
+  uint64_t first = 0, last = 0;
+  BOOST_CHECK(blc.GetLinkRangeOfDSIndex(1, first, last));
+  BOOST_CHECK_EQUAL(first, 2);
+  BOOST_CHECK_EQUAL(last, 4);
+  BOOST_CHECK(!blc.GetLinkRangeOfDSIndex(2, first, last));
+
+  const auto linksOfDSIndex = blc.GetBlockLinksOfDSIndex(0);
+  BOOST_CHECK_EQUAL(linksOfDSIndex.size(), 2);
+  BOOST_CHECK(get<BlockLinkIndex::BLOCKTYPE>(linksOfDSIndex[1]) == VC);
+
+  BOOST_CHECK(blc.GetLinkIndexesOfType(VC) == vector<uint64_t>({1, 4}));
+  BOOST_CHECK(blc.GetLinkIndexesOfType(VC, 2) == vector<uint64_t>({4}));
+  BOOST_CHECK(blc.GetLinkIndexesOfType(Tx).empty());
+
+  const auto range = blc.GetBlockLinks(3, 10);
+  BOOST_CHECK_EQUAL(range.size(), 2);
+  BOOST_CHECK(range[0] == blc.GetBlockLink(3));
+  BOOST_CHECK(blc.GetBlockLinks(5, 10).empty());
+
+  blc.Reset();
+  BOOST_CHECK(blc.GetLinkIndexesOfType(DS).empty());
+  BOOST_CHECK_EQUAL(blc.GetLatestIndex(), 0);
+}
+
 template <class T1, class T2>
 void test_BlockChain(T1& blockChain, T2& block_0, T2& block_1, T2& block_last,
                      T2& block_empty) {
@@ -159,14 +198,22 @@ void test_BlockChain(T1& blockChain, T2& block_0, T2& block_1, T2& block_last,
           to_string(blockChain.GetLastBlock().GetHeader().GetBlockNum() - 1) +
           ".\n");
   // Causes segfault since BlockStorage is empty
+  // The overwritten block is still kept among the older blocks, if any
   uint64_t blocknum_overwritten = 0;
-  BOOST_CHECK_MESSAGE(blockChain.GetBlock(blocknum_overwritten) == block_empty,
-                      "Nonempty block returned when queried block number " +
-                          to_string(blocknum_overwritten) +
-                          " already overwritten by block number " +
-                          to_string(blocknum_overwritten +
-                                    block_last.GetHeader().GetBlockNum()) +
-                          ".\n");
+  const T2& block_overwritten =
+      BLOCKCHAIN_OLDER_BLOCKS_SIZE > 0 ? block_0 : block_empty;
+  BOOST_CHECK_MESSAGE(
+      blockChain.GetBlock(blocknum_overwritten) == block_overwritten,
+      "Unexpected block returned when queried block number " +
+          to_string(blocknum_overwritten) +
+          " already overwritten by block number " +
+          to_string(blocknum_overwritten +
+                    block_last.GetHeader().GetBlockNum()) +
+          ".\n");
+  BOOST_CHECK_MESSAGE(
+      blockChain.GetBlockPtr(1) == blockChain.GetBlockPtr(1) &&
+          *blockChain.GetBlockPtr(1) == block_1,
+      "GetBlockPtr did not share the stored block.\n");
   BOOST_CHECK_MESSAGE(blockChain.GetBlockCount() == BLOCKCHAIN_SIZE + 1,
                       "Incorrect BlockCount " +
                           to_string(blockChain.GetBlockCount()) +
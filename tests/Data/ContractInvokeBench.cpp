@@ -0,0 +1,360 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// Contract execution benchmark. Deploys the sample contracts of the scilla
+/// test suite under SCILLA_ROOT (fungible token, non-fungible token and
+/// multisig wallet), fills their main map with a configurable number of
+/// entries and calls them through UpdateAccountsTemp. Each row reports the
+/// time per transaction spent exporting the scilla files, running scilla
+/// (spawn and execution, without the IPC time), serving the IPC state reads
+/// and writes, parsing the output and committing the states through
+/// ContractStorage2. Calls that the contract rejects still go through every
+/// phase and are counted in the failed column.
+
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Schnorr.h>
+#include <boost/program_options.hpp>
+
+#include "common/Constants.h"
+#include "libData/AccountData/Account.h"
+#include "libData/AccountData/AccountStore.h"
+#include "libData/AccountData/Transaction.h"
+#include "libData/AccountData/TransactionReceipt.h"
+#include "libPersistence/ContractStorage2.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/JsonUtils.h"
+#include "libUtils/Logger.h"
+
+#include "ScillaTestUtil.h"
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+
+namespace po = boost::program_options;
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+struct Options {
+  string contracts{"fungible-token,nonfungible-token,wallet_2"};
+  string sizes{"10,1000,10000"};
+  unsigned int calls{20};
+  uint64_t gasLimit{500000};
+};
+
+/// Map entry i of the seeded field, for an owner that gets the first entries
+using EntryGenerator =
+    function<void(unsigned int i, const Address& owner, Json::Value& key,
+                  Json::Value& val)>;
+
+/// Changes the test message for call i
+using MessageModifier =
+    function<void(unsigned int i, const Address& owner, Json::Value& params)>;
+
+struct ContractSpec {
+  string m_name;
+  unsigned int m_testNum;
+  string m_field;
+  EntryGenerator m_entry;
+  MessageModifier m_message;
+};
+
+Json::Value BoolTrue() {
+  Json::Value ret;
+  ret["constructor"] = "True";
+  ret["argtypes"] = Json::arrayValue;
+  ret["arguments"] = Json::arrayValue;
+  return ret;
+}
+
+vector<ContractSpec> GetSpecs(unsigned int calls) {
+  return {
+      // Transfer from the owner, balances : Map ByStr20 Uint128
+      {"fungible-token", 2, "balances",
+       [](unsigned int i, const Address& owner, Json::Value& key,
+          Json::Value& val) {
+         key = "0x" + (i == 0 ? owner : Address().random()).hex();
+         val = i == 0 ? "88888888" : "1";
+       },
+       [](unsigned int, const Address&, Json::Value&) {}},
+      // transferFrom of token i + 1 by its owner,
+      // tokenOwnerMap : Map Uint256 ByStr20
+      {"nonfungible-token", 10, "tokenOwnerMap",
+       [calls](unsigned int i, const Address& owner, Json::Value& key,
+               Json::Value& val) {
+         key = to_string(i + 1);
+         val = "0x" + (i < calls ? owner : Address().random()).hex();
+       },
+       [](unsigned int i, const Address& owner, Json::Value& params) {
+         for (auto& p : params) {
+           if (p["vname"] == "tokenId") {
+             p["value"] = to_string(i + 1);
+           } else if (p["vname"] == "from") {
+             p["value"] = "0x" + owner.hex();
+           } else if (p["vname"] == "to") {
+             p["value"] = "0x" + Address().random().hex();
+           }
+         }
+       }},
+      // The message of the test as it is, owners : Map ByStr20 Bool
+      {"wallet_2", 1, "owners",
+       [](unsigned int i, const Address& owner, Json::Value& key,
+          Json::Value& val) {
+         key = "0x" + (i == 0 ? owner : Address().random()).hex();
+         val = BoolTrue();
+       },
+       [](unsigned int, const Address&, Json::Value&) {}},
+  };
+}
+
+vector<string> Split(const string& list) {
+  vector<string> ret;
+  stringstream ss(list);
+  string item;
+  while (getline(ss, item, ',')) {
+    ret.emplace_back(item);
+  }
+  return ret;
+}
+
+struct Result {
+  unsigned int m_txns{0};
+  unsigned int m_failed{0};
+  ScillaCallProfile m_profile;
+  double m_commitMicro{0};
+  double m_totalMicro{0};
+};
+
+void PrintHeader() {
+  cout << left << setw(20) << "contract" << setw(8) << "phase" << right
+       << setw(8) << "entries" << setw(6) << "txns" << setw(7) << "failed"
+       << setw(8) << "runs" << setw(11) << "export" << setw(11) << "scilla"
+       << setw(9) << "reads" << setw(11) << "read" << setw(9) << "writes"
+       << setw(11) << "write" << setw(11) << "parse" << setw(11) << "commit"
+       << setw(11) << "total" << endl;
+}
+
+/// Times are in microseconds per transaction
+void Print(const string& contract, const string& phase, unsigned int entries,
+           const Result& r) {
+  const auto& p = r.m_profile;
+  const double n = r.m_txns > 0 ? r.m_txns : 1;
+  const uint64_t ipcMicro = p.m_ipcReadMicro + p.m_ipcWriteMicro;
+  const uint64_t scillaMicro =
+      p.m_invokeMicro > ipcMicro ? p.m_invokeMicro - ipcMicro : 0;
+  cout << left << setw(20) << contract << setw(8) << phase << right << setw(8)
+       << entries << setw(6) << r.m_txns << setw(7) << r.m_failed << fixed
+       << setprecision(1) << setw(8) << p.m_invocations / n << setw(11)
+       << p.m_exportMicro / n << setw(11) << scillaMicro / n << setw(9)
+       << p.m_ipcReads / n << setw(11) << p.m_ipcReadMicro / n << setw(9)
+       << p.m_ipcWrites / n << setw(11) << p.m_ipcWriteMicro / n << setw(11)
+       << p.m_parseMicro / n << setw(11) << r.m_commitMicro / n << setw(11)
+       << r.m_totalMicro / n << endl;
+}
+
+/// Moves the temp states through the same steps as the end of an epoch
+double Commit(AccountStore& store) {
+  const auto start = Clock::now();
+  store.SerializeDelta();
+  store.CommitTemp();
+  store.MoveUpdatesToDisk();
+  store.InitTemp();
+  return chrono::duration<double, micro>(Clock::now() - start).count();
+}
+
+bool Run(const ContractSpec& spec, unsigned int entries,
+         const Options& options) {
+  ScillaTestUtil::ScillaTest test;
+  if (!ScillaTestUtil::GetScillaTest(test, spec.m_name, spec.m_testNum)) {
+    cout << left << setw(20) << spec.m_name << "test " << spec.m_testNum
+         << " not found under SCILLA_ROOT, skipped" << endl;
+    return false;
+  }
+
+  AccountStore& store = AccountStore::GetInstance();
+  store.Init();
+  store.InitTemp();
+
+  const PairOfKey owner = Schnorr::GenKeyPair();
+  const Address ownerAddr = Account::GetAddressFromPublicKey(owner.second);
+  store.AddAccountTemp(ownerAddr, {numeric_limits<uint128_t>::max(), 0});
+  uint64_t nonce = 0;
+
+  for (auto& it : test.init) {
+    if (it["vname"] == "owner") {
+      it["value"] = "0x" + ownerAddr.hex();
+    }
+  }
+  ScillaTestUtil::RemoveThisAddressFromInit(test.init);
+  ScillaTestUtil::RemoveCreationBlockFromInit(test.init);
+  const uint64_t bnum = ScillaTestUtil::GetBlockNumberFromJson(test.blockchain);
+  const uint32_t version = DataConversion::Pack(CHAIN_ID, 1);
+
+  // Deployment
+  const Address contractAddr =
+      Account::GetAddressForContract(ownerAddr, nonce);
+  Result deploy;
+  {
+    const string initStr = JSONUtils::GetInstance().convertJsontoStr(test.init);
+    const bytes data(initStr.begin(), initStr.end());
+    Transaction tx(version, nonce++, NullAddress, owner, 0, PRECISION_MIN_VALUE,
+                   options.gasLimit, test.code, data);
+    TransactionReceipt tr;
+    store.ResetScillaCallProfileTemp();
+    const auto start = Clock::now();
+    if (!store.UpdateAccountsTemp(bnum, 1, true, tx, tr)) {
+      deploy.m_failed++;
+    }
+    deploy.m_txns++;
+    deploy.m_profile = store.GetScillaCallProfileTemp();
+    deploy.m_commitMicro = Commit(store);
+    deploy.m_totalMicro =
+        chrono::duration<double, micro>(Clock::now() - start).count();
+  }
+  Print(spec.m_name, "deploy", entries, deploy);
+
+  Account* account = store.GetAccountTemp(contractAddr);
+  if (account == nullptr) {
+    cout << left << setw(20) << spec.m_name << "deployment failed" << endl;
+    return false;
+  }
+
+  // Seed the map field, values are stored as in the scilla output
+  {
+    map<string, bytes> states;
+    for (unsigned int i = 0; i < entries; i++) {
+      Json::Value key, val;
+      spec.m_entry(i, ownerAddr, key, val);
+      states.emplace(
+          Contract::ContractStorage2::GetContractStorage().GenerateStorageKey(
+              contractAddr, spec.m_field,
+              {JSONUtils::GetInstance().convertJsontoStr(key)}),
+          DataConversion::StringToCharArray(
+              JSONUtils::GetInstance().convertJsontoStr(val)));
+    }
+    account->UpdateStates(contractAddr, states, {}, true);
+    Commit(store);
+  }
+
+  // Calls
+  Result call;
+  store.ResetScillaCallProfileTemp();
+  const auto start = Clock::now();
+  for (unsigned int i = 0; i < options.calls; i++) {
+    Json::Value message = test.message;
+    spec.m_message(i, ownerAddr, message["params"]);
+    bytes data;
+    const uint64_t amount = ScillaTestUtil::PrepareMessageData(message, data);
+    Transaction tx(version, nonce++, contractAddr, owner, amount,
+                   PRECISION_MIN_VALUE, options.gasLimit, {}, data);
+    TransactionReceipt tr;
+    if (!store.UpdateAccountsTemp(bnum, 1, true, tx, tr)) {
+      call.m_failed++;
+    }
+    call.m_txns++;
+  }
+  call.m_profile = store.GetScillaCallProfileTemp();
+  call.m_commitMicro = Commit(store);
+  call.m_totalMicro =
+      chrono::duration<double, micro>(Clock::now() - start).count();
+  Print(spec.m_name, "call", entries, call);
+
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  try {
+    Options options;
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "contracts,c", po::value<string>(&options.contracts),
+        "Comma separated sample contracts (default "
+        "fungible-token,nonfungible-token,wallet_2)")(
+        "sizes,s", po::value<string>(&options.sizes),
+        "Comma separated numbers of entries in the main map of the contract "
+        "(default 10,1000,10000)")(
+        "calls,n", po::value<unsigned int>(&options.calls),
+        "Calls per contract and size (default 20)")(
+        "gas,g", po::value<uint64_t>(&options.gasLimit),
+        "Gas limit of each transaction (default 500000)");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help")) {
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      po::notify(vm);
+    } catch (boost::program_options::error& e) {
+      cerr << "ERROR: " << e.what() << endl << endl;
+      cout << desc;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    if (!ENABLE_SC || SCILLA_ROOT.empty()) {
+      cerr << "ERROR: ENABLE_SC and SCILLA_ROOT must be set in constants.xml"
+           << endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    INIT_FILE_LOGGER("contractinvokebench", ".");
+
+    const auto specs = GetSpecs(options.calls);
+    PrintHeader();
+    for (const auto& name : Split(options.contracts)) {
+      const auto spec =
+          find_if(specs.begin(), specs.end(),
+                  [&name](const ContractSpec& s) { return s.m_name == name; });
+      if (spec == specs.end()) {
+        cerr << "ERROR: unknown contract " << name << endl;
+        return ERROR_IN_COMMAND_LINE;
+      }
+      for (const auto& size : Split(options.sizes)) {
+        Run(*spec, stoul(size), options);
+      }
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    cout << "peakrss(KB)=" << usage.ru_maxrss << endl;
+  } catch (exception& e) {
+    cerr << "Unhandled Exception reached the top of main: " << e.what()
+         << ", application will now exit" << endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+
+  return SUCCESS;
+}
@@ -0,0 +1,406 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// Mempool ingress benchmark. A generated mix of payments, contract calls,
+/// same-nonce replacements with a higher gas price and nonces submitted out
+/// of order goes through the lookup's TxnShardPool (the store behind
+/// Lookup::AddToTxnShardMap), is taken out in packets per shard, inserted
+/// into the TxnPool of each shard and then composed into microblocks by the
+/// selection loop of Node::ProcessTransactionWhenShardLeader, without
+/// executing the transactions. Each stage reports transactions per second
+/// and latency percentiles; peak memory is reported at the end.
+
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Schnorr.h>
+#include <boost/program_options.hpp>
+
+#include "common/Constants.h"
+#include "libData/AccountData/Account.h"
+#include "libData/AccountData/PendingTxnQueue.h"
+#include "libData/AccountData/Transaction.h"
+#include "libData/AccountData/TxnPool.h"
+#include "libLookup/TxnShardPool.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Histogram.h"
+#include "libUtils/Logger.h"
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+
+namespace po = boost::program_options;
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+struct Options {
+  unsigned int txns{100000};
+  unsigned int senders{1000};
+  unsigned int shards{3};
+  unsigned int contractPercent{20};
+  unsigned int replacePercent{5};
+  unsigned int outOfOrderPercent{10};
+  unsigned int packetSize{1000};
+  unsigned int poolMemoryInMB{0};
+  unsigned int seed{1};
+};
+
+struct GeneratedTxn {
+  Transaction m_txn;
+  bool m_isContractCall;
+};
+
+/// Latencies of one stage, in nanoseconds
+class Stage {
+ public:
+  explicit Stage(const string& name) : m_name(name) {}
+
+  void Add(const Clock::time_point& start, const Clock::time_point& end,
+           uint64_t items = 1) {
+    const auto ns = chrono::duration_cast<chrono::nanoseconds>(end - start);
+    m_latencyNs.Record(ns.count());
+    m_totalNs += ns.count();
+    m_items += items;
+  }
+
+  void Print() const {
+    const double ms = m_totalNs / 1e6;
+    cout << left << setw(20) << m_name << right << setw(10) << m_items
+         << fixed << setprecision(2) << setw(12) << ms << setw(14)
+         << (ms > 0 ? m_items * 1000 / ms : 0) << setw(12)
+         << m_latencyNs.GetPercentile(50) / 1e3 << setw(12)
+         << m_latencyNs.GetPercentile(99) / 1e3 << setw(12)
+         << m_latencyNs.GetMax() / 1e3 << endl;
+  }
+
+  static void PrintHeader() {
+    cout << left << setw(20) << "stage" << right << setw(10) << "txns"
+         << setw(12) << "ms" << setw(14) << "txns/sec" << setw(12)
+         << "p50(us)" << setw(12) << "p99(us)" << setw(12) << "max(us)"
+         << endl;
+  }
+
+ private:
+  const string m_name;
+  Histogram m_latencyNs;
+  uint64_t m_totalNs{0};
+  uint64_t m_items{0};
+};
+
+/// Submission order of the generated transactions. Senders are interleaved
+/// at random, some nonces of a sender arrive swapped with the next one and
+/// some are followed later by a replacement with a higher gas price.
+vector<GeneratedTxn> Generate(const Options& options) {
+  mt19937 rng(options.seed);
+  uniform_int_distribution<unsigned int> percent(0, 99);
+
+  vector<PubKey> senders;
+  for (unsigned int i = 0; i < options.senders; i++) {
+    senders.emplace_back(Schnorr::GenKeyPair().second);
+  }
+  const Address contractAddr = Address().random();
+  const bytes callData(128, 'x');
+  const uint32_t version = DataConversion::Pack(CHAIN_ID, 1);
+
+  vector<uint64_t> nextNonce(options.senders, 1);
+  vector<GeneratedTxn> ret;
+  ret.reserve(options.txns + options.txns * options.replacePercent / 100);
+
+  auto makeTxn = [&](unsigned int sender, uint64_t nonce,
+                     const uint128_t& gasPrice, bool isContractCall) {
+    if (isContractCall) {
+      return GeneratedTxn{
+          Transaction(version, nonce, contractAddr, senders.at(sender), 0,
+                      gasPrice, CONTRACT_INVOKE_GAS, {}, callData, {}),
+          true};
+    }
+    return GeneratedTxn{
+        Transaction(version, nonce, Address().random(), senders.at(sender),
+                    10, gasPrice, NORMAL_TRAN_GAS, {}, {}, {}),
+        false};
+  };
+
+  uniform_int_distribution<unsigned int> pickSender(0, options.senders - 1);
+  // Gas prices cluster on a few values near the minimum
+  uniform_int_distribution<unsigned int> pickGas(1, 4);
+  vector<GeneratedTxn> replacements;
+
+  while (ret.size() < options.txns) {
+    const unsigned int sender = pickSender(rng);
+    const bool swapNext = percent(rng) < options.outOfOrderPercent &&
+                          ret.size() + 1 < options.txns;
+    const unsigned int count = swapNext ? 2 : 1;
+
+    vector<GeneratedTxn> batch;
+    for (unsigned int i = 0; i < count; i++) {
+      const uint128_t gasPrice = GAS_PRICE_MIN_VALUE * pickGas(rng);
+      const bool isContractCall = percent(rng) < options.contractPercent;
+      batch.emplace_back(
+          makeTxn(sender, nextNonce[sender]++, gasPrice, isContractCall));
+      if (percent(rng) < options.replacePercent) {
+        const auto& orig = batch.back();
+        replacements.emplace_back(
+            makeTxn(sender, orig.m_txn.GetNonce(),
+                    orig.m_txn.GetGasPrice() + GAS_PRICE_MIN_VALUE,
+                    orig.m_isContractCall));
+      }
+    }
+    if (swapNext) {
+      swap(batch[0], batch[1]);
+    }
+    for (auto& t : batch) {
+      ret.emplace_back(move(t));
+    }
+
+    // Replacements arrive a little after the transaction they replace
+    if (!replacements.empty() && percent(rng) < 50) {
+      ret.emplace_back(move(replacements.back()));
+      replacements.pop_back();
+    }
+  }
+  for (auto& t : replacements) {
+    ret.emplace_back(move(t));
+  }
+
+  return ret;
+}
+
+/// One round of Node::ProcessTransactionWhenShardLeader without execution.
+/// A selected transaction uses its whole gas limit and moves its sender to
+/// the next nonce. Returns the number of transactions selected.
+unsigned int ComposeMicroBlock(TxnPool& pool, map<Address, uint64_t>& nonces,
+                               uint64_t gasLimit) {
+  TxnPoolView view;
+  view.Reset(pool);
+  PendingTxnQueue pending(
+      [&nonces](const Address& addr) { return nonces[addr]; });
+  vector<Transaction> gasLimitExceeded;
+
+  uint64_t gasUsed = 0;
+  unsigned int selected = 0;
+  while (gasUsed < gasLimit) {
+    Transaction t;
+    if (pending.PopReady(t)) {
+      view.findSameNonceButHigherGas(t);
+    } else if (view.findOne(t)) {
+      const uint64_t expected = nonces[t.GetSenderAddr()] + 1;
+      if (t.GetNonce() > expected) {
+        pending.Insert(t);
+        continue;
+      } else if (t.GetNonce() < expected) {
+        continue;
+      }
+    } else {
+      break;
+    }
+
+    if (gasUsed + t.GetGasLimit() > gasLimit) {
+      gasLimitExceeded.emplace_back(t);
+      continue;
+    }
+    gasUsed += t.GetGasLimit();
+    nonces[t.GetSenderAddr()]++;
+    pending.Touch(t.GetSenderAddr());
+    selected++;
+  }
+
+  // Same as Node::ReinstateMemPool
+  for (const auto& kv : pending.GetTxns()) {
+    for (const auto& nonceTxn : kv.second) {
+      view.insert(nonceTxn.second);
+    }
+  }
+  for (const auto& t : gasLimitExceeded) {
+    view.insert(t);
+  }
+  view.ApplyTo(pool);
+
+  return selected;
+}
+
+void Run(const Options& options) {
+  const auto txns = Generate(options);
+  unsigned int numContractCalls = 0;
+  for (const auto& t : txns) {
+    numContractCalls += t.m_isContractCall ? 1 : 0;
+  }
+  cout << "txns=" << txns.size() << " contractcalls=" << numContractCalls
+       << " senders=" << options.senders << " shards=" << options.shards
+       << endl;
+
+  Stage::PrintHeader();
+
+  // Contract calls go to the DS committee, as in Lookup::SendTxnPacketToNodes
+  TxnShardPool shardPool(txns.size());
+  {
+    Stage stage("TxnShardPool::Add");
+    for (const auto& t : txns) {
+      const uint32_t shardId = t.m_isContractCall
+                                   ? options.shards
+                                   : t.m_txn.GetShardIndex(options.shards);
+      const auto start = Clock::now();
+      shardPool.Add(t.m_txn, shardId);
+      stage.Add(start, Clock::now());
+    }
+    stage.Print();
+  }
+
+  vector<vector<vector<Transaction>>> packets(options.shards + 1);
+  {
+    Stage stage("TxnShardPool::Take");
+    for (uint32_t shardId = 0; shardId <= options.shards; shardId++) {
+      while (true) {
+        const auto start = Clock::now();
+        auto packet = shardPool.Take(shardId, options.packetSize);
+        if (packet.empty()) {
+          break;
+        }
+        stage.Add(start, Clock::now(), packet.size());
+        packets[shardId].emplace_back(move(packet));
+      }
+    }
+    stage.Print();
+  }
+
+  const uint64_t memoryLimit =
+      static_cast<uint64_t>(options.poolMemoryInMB) * 1024 * 1024;
+  vector<TxnPool> pools(options.shards + 1, TxnPool(memoryLimit));
+  uint64_t peakPoolBytes = 0;
+  {
+    Stage stage("TxnPool::insert");
+    for (uint32_t shardId = 0; shardId <= options.shards; shardId++) {
+      for (const auto& packet : packets[shardId]) {
+        for (const auto& t : packet) {
+          const auto start = Clock::now();
+          pools[shardId].insert(t);
+          stage.Add(start, Clock::now());
+        }
+      }
+      peakPoolBytes = max(peakPoolBytes, pools[shardId].GetSizeInBytes());
+    }
+    stage.Print();
+  }
+  packets.clear();
+
+  unsigned int numMicroBlocks = 0;
+  {
+    Stage stage("ComposeMicroBlock");
+    for (uint32_t shardId = 0; shardId <= options.shards; shardId++) {
+      const uint64_t gasLimit = (shardId == options.shards)
+                                    ? DS_MICROBLOCK_GAS_LIMIT
+                                    : SHARD_MICROBLOCK_GAS_LIMIT;
+      map<Address, uint64_t> nonces;
+      while (pools[shardId].size() > 0) {
+        const auto start = Clock::now();
+        const unsigned int selected =
+            ComposeMicroBlock(pools[shardId], nonces, gasLimit);
+        if (selected == 0) {
+          break;
+        }
+        stage.Add(start, Clock::now(), selected);
+        numMicroBlocks++;
+      }
+    }
+    stage.Print();
+  }
+
+  unsigned int remaining = 0;
+  uint64_t evicted = shardPool.GetEvictedCount();
+  for (const auto& pool : pools) {
+    remaining += pool.size();
+    evicted += pool.GetEvictedCount();
+  }
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  cout << "microblocks=" << numMicroBlocks << " leftinpool=" << remaining
+       << " evicted=" << evicted << endl;
+  cout << "peakpoolbytes=" << peakPoolBytes
+       << " peakrss(KB)=" << usage.ru_maxrss << endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  try {
+    Options options;
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "txns,n", po::value<unsigned int>(&options.txns),
+        "Transactions submitted, excluding replacements (default 100000)")(
+        "senders,s", po::value<unsigned int>(&options.senders),
+        "Number of senders (default 1000)")(
+        "shards", po::value<unsigned int>(&options.shards),
+        "Number of shards besides the DS committee (default 3)")(
+        "contract", po::value<unsigned int>(&options.contractPercent),
+        "Percentage of contract calls (default 20)")(
+        "replace", po::value<unsigned int>(&options.replacePercent),
+        "Percentage of txns replaced by a higher gas price (default 5)")(
+        "outoforder", po::value<unsigned int>(&options.outOfOrderPercent),
+        "Percentage of nonces submitted out of order (default 10)")(
+        "packet", po::value<unsigned int>(&options.packetSize),
+        "Txns per packet taken from the lookup (default 1000)")(
+        "poolmemory", po::value<unsigned int>(&options.poolMemoryInMB),
+        "Memory limit of each TxnPool in MB, 0 for none (default 0)")(
+        "seed", po::value<unsigned int>(&options.seed),
+        "Random seed (default 1)");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help")) {
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      po::notify(vm);
+    } catch (boost::program_options::error& e) {
+      cerr << "ERROR: " << e.what() << endl << endl;
+      cout << desc;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    if ((options.txns == 0) || (options.senders == 0) ||
+        (options.shards == 0) || (options.packetSize == 0)) {
+      cerr << "ERROR: txns, senders, shards and packet must be positive"
+           << endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    INIT_FILE_LOGGER("mempoolbench", ".");
+
+    Run(options);
+  } catch (exception& e) {
+    cerr << "Unhandled Exception reached the top of main: " << e.what()
+         << ", application will now exit" << endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+
+  return SUCCESS;
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// Sharding order benchmark. Orders random PoW solutions the way the DS
+/// leader shards them and then checks the order the way the backups do,
+/// once with the ordered map and linear search used before and once with
+/// the sorted hash vector of ShardingOrder.h.
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Schnorr.h>
+#include <boost/program_options.hpp>
+
+#include "libDirectoryService/ShardingOrder.h"
+#include "libUtils/HashUtils.h"
+#include "libUtils/Logger.h"
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+
+namespace po = boost::program_options;
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+using PoWResult = array<unsigned char, POW_SIZE>;
+using PoWSolns = vector<pair<PoWResult, PubKey>>;
+
+double MsSince(const Clock::time_point& start) {
+  return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+PoWSortHash SortHash(bytes& hashVec, const PoWResult& result) {
+  copy(result.begin(), result.end(), hashVec.begin() + BLOCK_HASH_SIZE);
+  const bytes& sortHashVec = HashUtils::BytesToHash(hashVec);
+  PoWSortHash sortHash{};
+  copy(sortHashVec.begin(), sortHashVec.end(), sortHash.begin());
+  return sortHash;
+}
+
+vector<pair<PoWSortHash, PubKey>> MapOrder(const bytes& lastBlockHash,
+                                           const PoWSolns& solns) {
+  map<PoWSortHash, PubKey> sortedPoWs;
+  bytes hashVec(BLOCK_HASH_SIZE + POW_SIZE);
+  copy(lastBlockHash.begin(), lastBlockHash.end(), hashVec.begin());
+  for (const auto& kv : solns) {
+    sortedPoWs.emplace(SortHash(hashVec, kv.first), kv.second);
+  }
+  return {sortedPoWs.begin(), sortedPoWs.end()};
+}
+
+// Counts the nodes out of order, finding each one by a linear search
+unsigned int LinearCheck(const bytes& lastBlockHash, const PoWSolns& solns,
+                         const vector<pair<PoWSortHash, PubKey>>& ordered) {
+  bytes hashVec(BLOCK_HASH_SIZE + POW_SIZE);
+  copy(lastBlockHash.begin(), lastBlockHash.end(), hashVec.begin());
+  PoWSortHash prev{};
+  unsigned int misordered = 0;
+  for (const auto& node : ordered) {
+    const auto it = find_if(solns.begin(), solns.end(), [&](const auto& kv) {
+      return kv.second == node.second;
+    });
+    const auto sortHash = SortHash(hashVec, it->first);
+    if (sortHash < prev) {
+      misordered++;
+      continue;
+    }
+    prev = sortHash;
+  }
+  return misordered;
+}
+
+// Counts the nodes out of order, as DirectoryService::VerifyPoWOrdering does
+unsigned int SortedCheck(const bytes& lastBlockHash, const PoWSolns& solns,
+                         const vector<pair<PoWSortHash, PubKey>>& ordered,
+                         unsigned int threads) {
+  map<PubKey, PoWResult> resultOf;
+  for (const auto& kv : solns) {
+    resultOf.emplace(kv.second, kv.first);
+  }
+  vector<PoWResult> results;
+  results.reserve(ordered.size());
+  for (const auto& node : ordered) {
+    results.emplace_back(resultOf.at(node.second));
+  }
+  PoWSortHash prev{};
+  unsigned int misordered = 0;
+  for (const auto& sortHash :
+       ComputePoWSortHashes(lastBlockHash, results, threads)) {
+    if (sortHash < prev) {
+      misordered++;
+      continue;
+    }
+    prev = sortHash;
+  }
+  return misordered;
+}
+
+void Run(const vector<unsigned int>& sizes, unsigned int threads,
+         unsigned int linearLimit, unsigned int seed) {
+  mt19937 rng(seed);
+  uniform_int_distribution<unsigned int> byte(0, 255);
+
+  const unsigned int maxSize = *max_element(sizes.begin(), sizes.end());
+  PoWSolns allSolns;
+  for (unsigned int i = 0; i < maxSize; i++) {
+    PoWResult result{};
+    for (auto& b : result) {
+      b = byte(rng);
+    }
+    allSolns.emplace_back(result, Schnorr::GenKeyPair().second);
+  }
+  bytes lastBlockHash(BLOCK_HASH_SIZE);
+  for (auto& b : lastBlockHash) {
+    b = byte(rng);
+  }
+
+  cout << left << setw(10) << "nodes" << right << setw(14) << "map(ms)"
+       << setw(14) << "sorted(ms)" << setw(14) << "linear(ms)" << setw(14)
+       << "check(ms)" << endl;
+
+  for (const auto size : sizes) {
+    const PoWSolns solns(allSolns.begin(), allSolns.begin() + size);
+
+    auto start = Clock::now();
+    const auto mapOrdered = MapOrder(lastBlockHash, solns);
+    const double mapMs = MsSince(start);
+
+    start = Clock::now();
+    const auto ordered = OrderPoWsForSharding(lastBlockHash, solns, threads);
+    const double sortedMs = MsSince(start);
+
+    if (ordered != mapOrdered) {
+      cerr << "ERROR: orders differ at " << size << " nodes" << endl;
+      return;
+    }
+
+    string linearMs = "-";
+    if (size <= linearLimit) {
+      start = Clock::now();
+      LinearCheck(lastBlockHash, solns, ordered);
+      linearMs = to_string(static_cast<unsigned int>(MsSince(start)));
+    }
+
+    start = Clock::now();
+    const unsigned int misordered =
+        SortedCheck(lastBlockHash, solns, ordered, threads);
+    const double checkMs = MsSince(start);
+    if (misordered != 0) {
+      cerr << "ERROR: " << misordered << " nodes out of order" << endl;
+      return;
+    }
+
+    cout << left << setw(10) << size << right << fixed << setprecision(2)
+         << setw(14) << mapMs << setw(14) << sortedMs << setw(14) << linearMs
+         << setw(14) << checkMs << endl;
+  }
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  try {
+    vector<unsigned int> sizes{10000, 50000};
+    unsigned int threads = 4;
+    unsigned int linearLimit = 10000;
+    unsigned int seed = 1;
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "nodes,n", po::value<vector<unsigned int>>(&sizes)->multitoken(),
+        "PoW submissions to order (default 10000 50000)")(
+        "threads,t", po::value<unsigned int>(&threads),
+        "Hashing threads besides the caller (default 4)")(
+        "linear", po::value<unsigned int>(&linearLimit),
+        "Largest run checked by linear search as before (default 10000)")(
+        "seed", po::value<unsigned int>(&seed), "Random seed (default 1)");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help")) {
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      po::notify(vm);
+    } catch (boost::program_options::error& e) {
+      cerr << "ERROR: " << e.what() << endl << endl;
+      cout << desc;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    if (sizes.empty() ||
+        any_of(sizes.begin(), sizes.end(),
+               [](unsigned int size) { return size == 0; })) {
+      cerr << "ERROR: nodes must be positive" << endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    INIT_FILE_LOGGER("shardingorderbench", ".");
+
+    Run(sizes, threads, linearLimit, seed);
+  } catch (exception& e) {
+    cerr << "Unhandled Exception reached the top of main: " << e.what()
+         << ", application will now exit" << endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+
+  return SUCCESS;
+}
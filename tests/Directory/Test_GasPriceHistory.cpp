@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+
+#include "libDirectoryService/GasPriceHistory.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE gaspricehistory
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(gaspricehistory)
+
+BOOST_AUTO_TEST_CASE(test_congestion) {
+  INIT_STDOUT_LOGGER();
+
+  // Every third block is full
+  map<uint64_t, unsigned int> reads;
+  auto getTxBlockGas = [&reads](const uint64_t blockNum) {
+    reads[blockNum]++;
+    return pair<uint128_t, uint128_t>(blockNum % 3 == 0 ? 100 : 10, 100);
+  };
+
+  GasPriceHistory history(80);
+  uint64_t fullBlockNum = 0, totalBlockNum = 0;
+
+  history.GetCongestion(10, 14, getTxBlockGas, fullBlockNum, totalBlockNum);
+  BOOST_CHECK_EQUAL(totalBlockNum, 5);
+  BOOST_CHECK_EQUAL(fullBlockNum, 1);
+
+  // Moving forward only reads the new blocks
+  history.GetCongestion(10, 19, getTxBlockGas, fullBlockNum, totalBlockNum);
+  BOOST_CHECK_EQUAL(totalBlockNum, 10);
+  BOOST_CHECK_EQUAL(fullBlockNum, 3);
+  history.GetCongestion(10, 19, getTxBlockGas, fullBlockNum, totalBlockNum);
+  BOOST_CHECK_EQUAL(totalBlockNum, 10);
+  for (const auto& read : reads) {
+    BOOST_CHECK_EQUAL(read.second, 1);
+  }
+
+  // A new DS epoch starts over
+  history.GetCongestion(20, 22, getTxBlockGas, fullBlockNum, totalBlockNum);
+  BOOST_CHECK_EQUAL(totalBlockNum, 3);
+  BOOST_CHECK_EQUAL(fullBlockNum, 1);
+
+  // Nothing to count before the first block of the epoch
+  history.GetCongestion(30, 29, getTxBlockGas, fullBlockNum, totalBlockNum);
+  BOOST_CHECK_EQUAL(totalBlockNum, 0);
+  BOOST_CHECK_EQUAL(fullBlockNum, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_mean_gas_price) {
+  INIT_STDOUT_LOGGER();
+
+  auto getDSGasPrice = [](const uint64_t blockNum) {
+    return uint128_t(blockNum * 10);
+  };
+
+  GasPriceHistory history(80);
+  uint128_t mean;
+
+  // Only block 0
+  BOOST_CHECK(!history.GetMeanGasPrice(0, 3, getDSGasPrice, mean));
+
+  // Blocks 1 to 2
+  BOOST_REQUIRE(history.GetMeanGasPrice(2, 3, getDSGasPrice, mean));
+  BOOST_CHECK_EQUAL(mean, 15);
+
+  // Blocks 2 to 5, then 7 to 10
+  BOOST_REQUIRE(history.GetMeanGasPrice(5, 3, getDSGasPrice, mean));
+  BOOST_CHECK_EQUAL(mean, 35);
+  BOOST_REQUIRE(history.GetMeanGasPrice(10, 3, getDSGasPrice, mean));
+  BOOST_CHECK_EQUAL(mean, 85);
+
+  // Going back reads the window again
+  BOOST_REQUIRE(history.GetMeanGasPrice(4, 3, getDSGasPrice, mean));
+  BOOST_CHECK_EQUAL(mean, 25);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -250,4 +250,53 @@ BOOST_FIXTURE_TEST_CASE(test_UpdateWithRemovals, F) {
   }
 }
 
+// Test that the returned index matches the new composition.
+BOOST_FIXTURE_TEST_CASE(test_UpdateIndex, F) {
+  INIT_STDOUT_LOGGER();
+
+  // Create the winners, including my node.
+  std::map<PubKey, Peer> winners;
+  winners[selfPubKey] = Peer(LOCALHOST, BASE_PORT + COMMITTEE_SIZE);
+  for (int i = 1; i < NUM_OF_ELECTED; ++i) {
+    PairOfKey candidateKeyPair = Schnorr::GenKeyPair();
+    winners[candidateKeyPair.second] =
+        Peer(LOCALHOST, BASE_PORT + COMMITTEE_SIZE + i);
+  }
+
+  // Create the removed members.
+  std::vector<PubKey> removeDSNodePubkeys;
+  for (int i = 0; i < NUM_OF_REMOVED; ++i) {
+    removeDSNodePubkeys.emplace_back(dsComm.at(i).first);
+  }
+
+  // Construct the fake DS Block.
+  PairOfKey leaderKeyPair = Schnorr::GenKeyPair();
+  PubKey leaderPubKey = leaderKeyPair.second;
+  DSBlockHeader header(DS_DIFF, SHARD_DIFF, leaderPubKey, BLOCK_NUM, EPOCH_NUM,
+                       GAS_PRICE, SWInfo(), winners, removeDSNodePubkeys,
+                       DSBlockHashSet());
+  DSBlock block(header, CoSignatures());
+
+  // Update the DS Composition.
+  IndexOfNode dsIndex;
+  UpdateDSCommitteeCompositionCore(selfPubKey, dsComm, block, dsIndex);
+
+  BOOST_CHECK_EQUAL(dsComm.size(), COMMITTEE_SIZE);
+  BOOST_CHECK_EQUAL(dsIndex.size(), COMMITTEE_SIZE);
+  for (unsigned int i = 0; i < dsComm.size(); ++i) {
+    const auto it = dsIndex.find(dsComm.at(i).first);
+    BOOST_REQUIRE(it != dsIndex.end());
+    BOOST_CHECK_EQUAL(it->second, i);
+  }
+
+  // My own network information is zeroed out.
+  BOOST_REQUIRE(dsIndex.find(selfPubKey) != dsIndex.end());
+  BOOST_CHECK(dsComm.at(dsIndex.at(selfPubKey)).second == Peer());
+
+  // The removed members are dropped first.
+  for (const auto& removed : removeDSNodePubkeys) {
+    BOOST_CHECK(dsIndex.find(removed) == dsIndex.end());
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
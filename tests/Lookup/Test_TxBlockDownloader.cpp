@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <set>
+
+#include "libLookup/TxBlockDownloader.h"
+#include "libTestUtils/TestUtils.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE txblockdownloader
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+vector<Peer> MakePeers(unsigned int count) {
+  vector<Peer> peers;
+  for (unsigned int i = 0; i < count; i++) {
+    peers.emplace_back(i + 1, 30303);
+  }
+  return peers;
+}
+
+vector<TxBlock> MakeTxBlocks(uint64_t lowBlockNum, uint64_t highBlockNum) {
+  vector<TxBlock> txBlocks;
+  for (uint64_t blockNum = lowBlockNum; blockNum <= highBlockNum; blockNum++) {
+    txBlocks.emplace_back(TestUtils::createTxBlockHeader(blockNum),
+                          vector<MicroBlockInfo>(), CoSignatures());
+  }
+  return txBlocks;
+}
+
+// Answers from a different port than the one requested, as seeds do
+Peer ReplyFrom(const Peer& peer) { return Peer(peer.GetIpAddress(), 5000); }
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(txblockdownloader)
+
+BOOST_AUTO_TEST_CASE(test_split_and_order) {
+  INIT_STDOUT_LOGGER();
+
+  TxBlockDownloader downloader(4, 25, 10, 3);
+  const auto now = TxBlockDownloader::Clock::now();
+  const auto requests = downloader.Start(11, 60, MakePeers(5), now);
+
+  // 50 blocks in chunks of at most 25 from distinct seeds
+  BOOST_REQUIRE_EQUAL(requests.size(), 2);
+  BOOST_CHECK_EQUAL(requests[0].m_lowBlockNum, 11);
+  BOOST_CHECK_EQUAL(requests[0].m_highBlockNum, 35);
+  BOOST_CHECK_EQUAL(requests[1].m_lowBlockNum, 36);
+  BOOST_CHECK_EQUAL(requests[1].m_highBlockNum, 60);
+  BOOST_CHECK(!(requests[0].m_peer == requests[1].m_peer));
+
+  // A second start keeps the ongoing download
+  BOOST_CHECK(downloader.Start(1, 0, MakePeers(5), now).empty());
+
+  vector<TxBlock> txBlocks;
+  BOOST_CHECK(downloader.OnResponse(ReplyFrom(requests[1].m_peer), 36, 60,
+                                    MakeTxBlocks(36, 60)));
+  BOOST_CHECK(!downloader.TakeBlocks(txBlocks));
+  BOOST_CHECK(!downloader.OnResponse(ReplyFrom(requests[1].m_peer), 36, 60,
+                                     MakeTxBlocks(36, 60)));
+
+  BOOST_CHECK(downloader.OnResponse(ReplyFrom(requests[0].m_peer), 11, 35,
+                                    MakeTxBlocks(11, 35)));
+  BOOST_REQUIRE(downloader.TakeBlocks(txBlocks));
+  BOOST_REQUIRE_EQUAL(txBlocks.size(), 50);
+  for (unsigned int i = 0; i < txBlocks.size(); i++) {
+    BOOST_CHECK_EQUAL(txBlocks[i].GetHeader().GetBlockNum(), 11 + i);
+  }
+  BOOST_CHECK(!downloader.IsActive());
+}
+
+BOOST_AUTO_TEST_CASE(test_open_range) {
+  INIT_STDOUT_LOGGER();
+
+  TxBlockDownloader downloader(4, 10, 10, 3);
+  const auto now = TxBlockDownloader::Clock::now();
+  const auto requests = downloader.Start(0, 0, MakePeers(3), now);
+
+  BOOST_REQUIRE_EQUAL(requests.size(), 3);
+  BOOST_CHECK_EQUAL(requests[0].m_lowBlockNum, 1);
+  BOOST_CHECK_EQUAL(requests[0].m_highBlockNum, 10);
+  BOOST_CHECK_EQUAL(requests[2].m_lowBlockNum, 21);
+  BOOST_CHECK_EQUAL(requests[2].m_highBlockNum, 0);
+
+  // The latest block is 15, so the last seed has nothing to send
+  BOOST_CHECK(
+      downloader.OnResponse(ReplyFrom(requests[2].m_peer), 21, 15, {}));
+  BOOST_CHECK(downloader.OnResponse(ReplyFrom(requests[1].m_peer), 11, 20,
+                                    MakeTxBlocks(11, 15)));
+  BOOST_CHECK(downloader.OnResponse(ReplyFrom(requests[0].m_peer), 1, 10,
+                                    MakeTxBlocks(1, 10)));
+
+  vector<TxBlock> txBlocks;
+  BOOST_REQUIRE(downloader.TakeBlocks(txBlocks));
+  BOOST_REQUIRE_EQUAL(txBlocks.size(), 15);
+  BOOST_CHECK_EQUAL(txBlocks.back().GetHeader().GetBlockNum(), 15);
+}
+
+BOOST_AUTO_TEST_CASE(test_reassign) {
+  INIT_STDOUT_LOGGER();
+
+  TxBlockDownloader downloader(2, 10, 10, 1);
+  const auto now = TxBlockDownloader::Clock::now();
+  const auto requests = downloader.Start(1, 20, MakePeers(3), now);
+  BOOST_REQUIRE_EQUAL(requests.size(), 2);
+
+  BOOST_CHECK(downloader.Poll(now + chrono::seconds(5)).empty());
+
+  // The first seed sends garbage and the second one is too slow
+  downloader.OnFailure(ReplyFrom(requests[0].m_peer));
+  const auto retries = downloader.Poll(now + chrono::seconds(10));
+  BOOST_REQUIRE_EQUAL(retries.size(), 2);
+  for (unsigned int i = 0; i < retries.size(); i++) {
+    BOOST_CHECK_EQUAL(retries[i].m_lowBlockNum, requests[i].m_lowBlockNum);
+    BOOST_CHECK(!(retries[i].m_peer == requests[i].m_peer));
+  }
+
+  // A late answer from the slow seed is no longer expected
+  BOOST_CHECK(!downloader.OnResponse(ReplyFrom(requests[1].m_peer), 11, 20,
+                                     MakeTxBlocks(11, 20)));
+  BOOST_CHECK(downloader.OnResponse(ReplyFrom(retries[0].m_peer), 1, 10,
+                                    MakeTxBlocks(1, 10)));
+
+  // Out of retries for the second chunk
+  BOOST_CHECK(downloader.Poll(now + chrono::seconds(20)).empty());
+  BOOST_CHECK(!downloader.IsActive());
+
+  vector<TxBlock> txBlocks;
+  BOOST_CHECK(!downloader.TakeBlocks(txBlocks));
+  BOOST_CHECK_EQUAL(downloader.Start(1, 20, MakePeers(3), now).size(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <Schnorr.h>
+#include "common/Constants.h"
+#include "libData/AccountData/TxnPool.h"
+#include "libLookup/TxnShardPool.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE txnshardpool
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+vector<Transaction> MakeTxns(unsigned int count) {
+  PairOfKey sender = Schnorr::GenKeyPair();
+  vector<Transaction> txns;
+  for (unsigned int i = 0; i < count; i++) {
+    txns.emplace_back(DataConversion::Pack(CHAIN_ID, 1), i + 1,
+                      Address().random(), sender, 1, 1, NORMAL_TRAN_GAS);
+  }
+  return txns;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(txnshardpool)
+
+BOOST_AUTO_TEST_CASE(test_admission) {
+  INIT_STDOUT_LOGGER();
+
+  TxnShardPool pool(5);
+  const auto txns = MakeTxns(6);
+
+  BOOST_CHECK(pool.Add(txns.at(0), 0));
+  BOOST_CHECK(pool.Add(txns.at(1), 0));
+  BOOST_CHECK_MESSAGE(!pool.Add(txns.at(1), 0),
+                      "Duplicate in the same shard should be rejected!");
+  // The same transaction may be held for another shard
+  BOOST_CHECK(pool.Add(txns.at(1), 1));
+  BOOST_CHECK(pool.Add(txns.at(2), 1));
+  BOOST_CHECK(pool.Add(txns.at(3), 2));
+  BOOST_CHECK_EQUAL(pool.Size(), 5);
+  BOOST_CHECK_MESSAGE(!pool.Add(txns.at(4), 2), "Full pool should reject!");
+
+  BOOST_CHECK_EQUAL(pool.GetTxns(0).size(), 2);
+  BOOST_CHECK(pool.GetTxns(0).at(1).GetTranID() == txns.at(1).GetTranID());
+  BOOST_CHECK(pool.IsEmpty(7));
+
+  pool.Clear(0);
+  BOOST_CHECK(pool.IsEmpty(0));
+  BOOST_CHECK_EQUAL(pool.Size(), 3);
+  BOOST_CHECK(pool.Add(txns.at(0), 0));
+  BOOST_CHECK(pool.Add(txns.at(4), 2));
+}
+
+BOOST_AUTO_TEST_CASE(test_take) {
+  INIT_STDOUT_LOGGER();
+
+  TxnShardPool pool(100);
+  const auto txns = MakeTxns(5);
+  for (const auto& tx : txns) {
+    pool.Add(tx, 0);
+  }
+
+  // Oldest first
+  auto taken = pool.Take(0, 3);
+  BOOST_REQUIRE_EQUAL(taken.size(), 3);
+  BOOST_CHECK(taken.at(0).GetTranID() == txns.at(0).GetTranID());
+  BOOST_CHECK(taken.at(2).GetTranID() == txns.at(2).GetTranID());
+  BOOST_CHECK_EQUAL(pool.Size(), 2);
+
+  taken = pool.Take(0, 3);
+  BOOST_REQUIRE_EQUAL(taken.size(), 2);
+  BOOST_CHECK(taken.at(0).GetTranID() == txns.at(3).GetTranID());
+  BOOST_CHECK(pool.IsEmpty(0));
+  BOOST_CHECK(pool.Take(0, 3).empty());
+  BOOST_CHECK(pool.Take(4, 3).empty());
+
+  // Taken txns can be added again
+  BOOST_CHECK(pool.Add(txns.at(0), 0));
+}
+
+BOOST_AUTO_TEST_CASE(test_reassign) {
+  INIT_STDOUT_LOGGER();
+
+  TxnShardPool pool(100);
+  const auto txns = MakeTxns(4);
+
+  pool.Add(txns.at(0), 0);
+  pool.Add(txns.at(1), 1);
+  pool.Add(txns.at(1), 2);
+  pool.Add(txns.at(2), 2);
+  pool.Add(txns.at(3), 3);
+
+  // Shards 1 and 2 merge into 5, the rest move up by one
+  pool.Reassign([](uint32_t shardId, const Transaction&) -> uint32_t {
+    return (shardId == 1 || shardId == 2) ? 5 : shardId + 1;
+  });
+
+  BOOST_CHECK(pool.IsEmpty(0));
+  BOOST_CHECK_EQUAL(pool.GetTxns(1).size(), 1);
+  BOOST_CHECK_EQUAL(pool.GetTxns(4).size(), 1);
+  const auto merged = pool.GetTxns(5);
+  BOOST_REQUIRE_EQUAL(merged.size(), 2);
+  BOOST_CHECK(merged.at(0).GetTranID() == txns.at(1).GetTranID());
+  BOOST_CHECK(merged.at(1).GetTranID() == txns.at(2).GetTranID());
+  BOOST_CHECK_EQUAL(pool.Size(), 4);
+
+  // The rebuilt index still rejects duplicates
+  BOOST_CHECK(!pool.Add(txns.at(2), 5));
+
+  const auto all = pool.GetAllTxns();
+  BOOST_REQUIRE_EQUAL(all.size(), 4);
+  BOOST_CHECK_EQUAL(all.at(0).first, 1);
+  BOOST_CHECK(all.at(0).second.GetTranID() == txns.at(0).GetTranID());
+  BOOST_CHECK_EQUAL(all.at(3).first, 5);
+  BOOST_CHECK(all.at(3).second.GetTranID() == txns.at(2).GetTranID());
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_limit) {
+  INIT_STDOUT_LOGGER();
+
+  PairOfKey sender = Schnorr::GenKeyPair();
+  vector<Transaction> txns;
+  for (unsigned int i = 0; i < 4; i++) {
+    // Sender's nonces 1 and 2 are cheap, the others pay more
+    txns.emplace_back(DataConversion::Pack(CHAIN_ID, 1), i + 1,
+                      Address().random(), sender, 1, (i < 2) ? 1 : 10,
+                      NORMAL_TRAN_GAS);
+  }
+  const uint64_t txnSize = TxnPool::GetMemorySize(txns.at(0));
+
+  TxnShardPool pool(100, 2 * txnSize);
+  BOOST_CHECK(pool.Add(txns.at(0), 0));
+  BOOST_CHECK(pool.Add(txns.at(1), 0));
+  BOOST_CHECK_EQUAL(pool.GetSizeInBytes(), 2 * txnSize);
+
+  // Evicts the highest nonce of the cheapest sender
+  BOOST_CHECK(pool.Add(txns.at(2), 0));
+  BOOST_CHECK_EQUAL(pool.GetEvictedCount(), 1);
+  auto held = pool.GetTxns(0);
+  BOOST_REQUIRE_EQUAL(held.size(), 2);
+  BOOST_CHECK(held.at(0).GetTranID() == txns.at(0).GetTranID());
+  BOOST_CHECK(held.at(1).GetTranID() == txns.at(2).GetTranID());
+
+  // Nonce 1 is still the cheapest, so nonce 3 goes before it
+  BOOST_CHECK(pool.Add(txns.at(3), 0));
+  BOOST_CHECK_EQUAL(pool.GetEvictedCount(), 2);
+  held = pool.GetTxns(0);
+  BOOST_REQUIRE_EQUAL(held.size(), 2);
+  BOOST_CHECK(held.at(1).GetTranID() == txns.at(3).GetTranID());
+
+  // Nothing cheaper than a gas price of 1
+  BOOST_CHECK(!pool.Add(txns.at(1), 0));
+  BOOST_CHECK_EQUAL(pool.Size(), 2);
+
+  pool.Clear(0);
+  BOOST_CHECK_EQUAL(pool.GetSizeInBytes(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,512 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// Messenger encode and decode benchmark. The message types with the most
+/// volume (forwarded transaction packets, final blocks, microblocks, DS
+/// blocks with their sharding structure, state deltas and consensus commits
+/// and responses) are encoded and decoded at configurable sizes. Each stage
+/// reports MB/sec, ns per message and heap allocations per message.
+///
+/// The final block is also encoded with the size computed three times per
+/// encode, as the Messenger helpers used to do, and with the size computed
+/// once and reused through the cached sizes.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "libConsensus/ConsensusCommon.h"
+#include "libData/BlockData/Block/DSBlock.h"
+#include "libData/BlockData/Block/MicroBlock.h"
+#include "libData/BlockData/Block/TxBlock.h"
+#include "libData/BlockData/Block/VCBlock.h"
+#include "libMessage/Messenger.h"
+#include "libMessage/ZilliqaMessage.pb.h"
+#include "libTestUtils/TestUtils.h"
+#include "libUtils/Histogram.h"
+#include "libUtils/Logger.h"
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+
+namespace po = boost::program_options;
+using namespace std;
+
+namespace {
+atomic<uint64_t> g_allocations{0};
+}  // namespace
+
+// Every heap allocation of the process is counted, so that a stage can
+// report how many of them one message costs
+void* operator new(size_t size) {
+  g_allocations++;
+  void* p = malloc(size > 0 ? size : 1);
+  if (p == nullptr) {
+    throw bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete[](void* p) noexcept { free(p); }
+
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+struct Options {
+  unsigned int txns{1000};
+  unsigned int microBlockTxns{5000};
+  unsigned int microBlocks{1000};
+  unsigned int stateDeltaInKB{1024};
+  unsigned int shards{10};
+  unsigned int shardSize{600};
+  unsigned int subsets{2};
+  unsigned int iterations{200};
+};
+
+/// Latencies and allocations of one way of encoding or decoding a message
+class Stage {
+ public:
+  explicit Stage(const string& name) : m_name(name) {}
+
+  /// Runs f, which returns the size of the message handled, iterations
+  /// times. Returns false as soon as f fails, signalled by a size of 0.
+  template <class F>
+  bool Run(unsigned int iterations, F f) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      const uint64_t allocations = g_allocations;
+      const auto start = Clock::now();
+      const size_t size = f();
+      const auto end = Clock::now();
+      if (size == 0) {
+        cerr << "ERROR: " << m_name << " failed" << endl;
+        return false;
+      }
+      m_allocations += g_allocations - allocations;
+
+      const auto ns = chrono::duration_cast<chrono::nanoseconds>(end - start);
+      m_latencyNs.Record(ns.count());
+      m_totalNs += ns.count();
+      m_bytes += size;
+      m_messages++;
+    }
+    Print();
+    return true;
+  }
+
+  static void PrintHeader() {
+    cout << left << setw(32) << "stage" << right << setw(12) << "bytes/msg"
+         << setw(12) << "MB/sec" << setw(14) << "ns/msg" << setw(12)
+         << "p99(us)" << setw(12) << "allocs/msg" << endl;
+  }
+
+ private:
+  void Print() const {
+    cout << left << setw(32) << m_name << right << fixed << setprecision(2)
+         << setw(12) << m_bytes / m_messages << setw(12)
+         << (m_totalNs > 0 ? m_bytes * 1e3 / m_totalNs : 0) << setw(14)
+         << m_totalNs / m_messages << setw(12)
+         << m_latencyNs.GetPercentile(99) / 1e3 << setw(12)
+         << static_cast<double>(m_allocations) / m_messages << endl;
+  }
+
+  const string m_name;
+  Histogram m_latencyNs;
+  uint64_t m_totalNs{0};
+  uint64_t m_bytes{0};
+  uint64_t m_messages{0};
+  uint64_t m_allocations{0};
+};
+
+PairOfKey GenerateKeyPair() {
+  PairOfKey keyPair;
+  keyPair.first = PrivKey();
+  keyPair.second = PubKey(keyPair.first);
+  return keyPair;
+}
+
+TxBlock GenerateTxBlock(unsigned int numMicroBlocks) {
+  vector<MicroBlockInfo> mbInfos;
+  for (unsigned int i = 0; i < numMicroBlocks; i++) {
+    mbInfos.push_back({BlockHash::random(), TxnHash::random(), i});
+  }
+  return TxBlock(TestUtils::GenerateRandomTxBlockHeader(), mbInfos,
+                 TestUtils::GenerateRandomCoSignatures());
+}
+
+/// Encoding as done before, with each ByteSize walking the whole message
+bool EncodeUncached(const google::protobuf::MessageLite& message,
+                    bytes& dst) {
+  if (message.ByteSize() > static_cast<int>(dst.size())) {
+    dst.resize(message.ByteSize());
+  }
+  return message.SerializeToArray(dst.data(), message.ByteSize());
+}
+
+bool EncodeCached(const google::protobuf::MessageLite& message, bytes& dst) {
+  const size_t size = message.ByteSizeLong();
+  if (size > dst.size()) {
+    dst.resize(size);
+  }
+  message.SerializeWithCachedSizesToArray(dst.data());
+  return true;
+}
+
+bool BenchForwardTxnBlock(const Options& options) {
+  vector<Transaction> txns;
+  for (unsigned int i = 0; i < options.txns; i++) {
+    txns.emplace_back(TestUtils::GenerateRandomTransaction(
+        1, i + 1, Transaction::NON_CONTRACT));
+  }
+  const PairOfKey lookupKey = GenerateKeyPair();
+
+  bytes encoded;
+  return Stage("SetNodeForwardTxnBlock")
+             .Run(options.iterations,
+                  [&]() -> size_t {
+                    encoded.clear();
+                    return Messenger::SetNodeForwardTxnBlock(
+                               encoded, 0, 1, 1, 0, lookupKey, txns, {})
+                               ? encoded.size()
+                               : 0;
+                  }) &&
+         Stage("GetNodeForwardTxnBlock")
+             .Run(options.iterations, [&]() -> size_t {
+               uint64_t epochNumber = 0;
+               uint64_t dsBlockNum = 0;
+               uint32_t shardId = 0;
+               PubKey lookupPubKey;
+               vector<Transaction> decoded;
+               Signature signature;
+               Signature attestation;
+               bool attested = false;
+               return Messenger::GetNodeForwardTxnBlock(
+                          encoded, 0, epochNumber, dsBlockNum, shardId,
+                          lookupPubKey, decoded, signature, attestation,
+                          attested)
+                          ? encoded.size()
+                          : 0;
+             });
+}
+
+bool BenchFinalBlock(const Options& options) {
+  const TxBlock txBlock = GenerateTxBlock(options.microBlocks);
+  const bytes stateDelta =
+      TestUtils::GenerateRandomCharVector(options.stateDeltaInKB * 1024);
+
+  bytes encoded;
+  if (!Messenger::SetNodeFinalBlock(encoded, 0, 1, 1, txBlock, stateDelta)) {
+    cerr << "ERROR: SetNodeFinalBlock failed" << endl;
+    return false;
+  }
+  ZilliqaMessage::NodeFinalBlock message;
+  if (!message.ParseFromArray(encoded.data(), encoded.size())) {
+    cerr << "ERROR: parsing the final block failed" << endl;
+    return false;
+  }
+
+  bytes uncachedDst;
+  bytes cachedDst;
+  if (!Stage("final block encode uncached")
+           .Run(options.iterations,
+                [&]() -> size_t {
+                  uncachedDst.clear();
+                  return EncodeUncached(message, uncachedDst)
+                             ? uncachedDst.size()
+                             : 0;
+                }) ||
+      !Stage("final block encode cached")
+           .Run(options.iterations, [&]() -> size_t {
+             cachedDst.clear();
+             return EncodeCached(message, cachedDst) ? cachedDst.size() : 0;
+           })) {
+    return false;
+  }
+  if (cachedDst != uncachedDst) {
+    cerr << "ERROR: cached encoding differs" << endl;
+    return false;
+  }
+
+  return Stage("SetNodeFinalBlock")
+             .Run(options.iterations,
+                  [&]() -> size_t {
+                    encoded.clear();
+                    return Messenger::SetNodeFinalBlock(encoded, 0, 1, 1,
+                                                        txBlock, stateDelta)
+                               ? encoded.size()
+                               : 0;
+                  }) &&
+         Stage("GetNodeFinalBlock")
+             .Run(options.iterations, [&]() -> size_t {
+               uint64_t dsBlockNumber = 0;
+               uint32_t consensusID = 0;
+               TxBlock decodedTxBlock;
+               bytes decodedStateDelta;
+               return Messenger::GetNodeFinalBlock(
+                          encoded, 0, dsBlockNumber, consensusID,
+                          decodedTxBlock, decodedStateDelta)
+                          ? encoded.size()
+                          : 0;
+             });
+}
+
+bool BenchMicroBlock(const Options& options) {
+  vector<TxnHash> tranHashes;
+  for (unsigned int i = 0; i < options.microBlockTxns; i++) {
+    tranHashes.emplace_back(TxnHash::random());
+  }
+  const MicroBlock microBlock(TestUtils::GenerateRandomMicroBlockHeader(),
+                              tranHashes,
+                              TestUtils::GenerateRandomCoSignatures());
+
+  bytes encoded;
+  return Stage("SetMicroBlock")
+             .Run(options.iterations,
+                  [&]() -> size_t {
+                    encoded.clear();
+                    return Messenger::SetMicroBlock(encoded, 0, microBlock)
+                               ? encoded.size()
+                               : 0;
+                  }) &&
+         Stage("GetMicroBlock").Run(options.iterations, [&]() -> size_t {
+           MicroBlock decoded;
+           return Messenger::GetMicroBlock(encoded, 0, decoded)
+                      ? encoded.size()
+                      : 0;
+         });
+}
+
+bool BenchDSBlock(const Options& options) {
+  const DSBlock dsBlock(TestUtils::GenerateRandomDSBlockHeader(),
+                        TestUtils::GenerateRandomCoSignatures());
+  DequeOfShard shards;
+  for (unsigned int i = 0; i < options.shards; i++) {
+    shards.emplace_back(TestUtils::GenerateRandomShard(options.shardSize));
+  }
+
+  bytes encoded;
+  return Stage("SetNodeVCDSBlocksMessage")
+             .Run(options.iterations,
+                  [&]() -> size_t {
+                    encoded.clear();
+                    return Messenger::SetNodeVCDSBlocksMessage(
+                               encoded, 0, 0, dsBlock, {}, 0, shards)
+                               ? encoded.size()
+                               : 0;
+                  }) &&
+         Stage("GetNodeVCDSBlocksMessage")
+             .Run(options.iterations, [&]() -> size_t {
+               uint32_t shardId = 0;
+               DSBlock decodedDSBlock;
+               vector<VCBlock> vcBlocks;
+               uint32_t shardingStructureVersion = 0;
+               DequeOfShard decodedShards;
+               return Messenger::GetNodeVCDSBlocksMessage(
+                          encoded, 0, shardId, decodedDSBlock, vcBlocks,
+                          shardingStructureVersion, decodedShards)
+                          ? encoded.size()
+                          : 0;
+             });
+}
+
+bool BenchStateDelta(const Options& options) {
+  const bytes stateDelta =
+      TestUtils::GenerateRandomCharVector(options.stateDeltaInKB * 1024);
+  const PairOfKey lookupKey = GenerateKeyPair();
+
+  bytes encoded;
+  return Stage("SetLookupSetStateDeltaFromSeed")
+             .Run(options.iterations,
+                  [&]() -> size_t {
+                    encoded.clear();
+                    return Messenger::SetLookupSetStateDeltaFromSeed(
+                               encoded, 0, 1, lookupKey, stateDelta)
+                               ? encoded.size()
+                               : 0;
+                  }) &&
+         Stage("GetLookupSetStateDeltaFromSeed")
+             .Run(options.iterations, [&]() -> size_t {
+               uint64_t blockNum = 0;
+               PubKey lookupPubKey;
+               bytes decoded;
+               return Messenger::GetLookupSetStateDeltaFromSeed(
+                          encoded, 0, blockNum, lookupPubKey, decoded)
+                          ? encoded.size()
+                          : 0;
+             });
+}
+
+bool BenchConsensus(const Options& options) {
+  const uint32_t consensusID = 1;
+  const uint64_t blockNumber = 1;
+  const bytes blockHash(BlockHash::size, 0xAB);
+  const uint16_t backupID = 1;
+  const PairOfKey backupKey = GenerateKeyPair();
+
+  DequeOfNode committeeKeys;
+  committeeKeys.emplace_back(GenerateKeyPair().second, Peer());
+  committeeKeys.emplace_back(backupKey.second, Peer());
+
+  const CommitSecret commitSecret;
+  const CommitPoint commitPoint(commitSecret);
+  const CommitPointHash commitPointHash(commitPoint);
+
+  vector<ResponseSubsetInfo> subsetInfo;
+  for (unsigned int i = 0; i < options.subsets; i++) {
+    const Challenge challenge(commitPoint, backupKey.second, blockHash);
+    subsetInfo.push_back({Response(commitSecret, challenge, backupKey.first)});
+  }
+
+  bytes encoded;
+  if (!Stage("SetConsensusCommit")
+           .Run(options.iterations,
+                [&]() -> size_t {
+                  encoded.clear();
+                  return Messenger::SetConsensusCommit(
+                             encoded, 0, consensusID, blockNumber, blockHash,
+                             backupID, commitPoint, commitPointHash, backupKey)
+                             ? encoded.size()
+                             : 0;
+                }) ||
+      !Stage("GetConsensusCommit")
+           .Run(options.iterations, [&]() -> size_t {
+             uint16_t decodedBackupID = 0;
+             CommitPoint decodedCommitPoint;
+             CommitPointHash decodedCommitPointHash;
+             return Messenger::GetConsensusCommit(
+                        encoded, 0, consensusID, blockNumber, blockHash,
+                        decodedBackupID, decodedCommitPoint,
+                        decodedCommitPointHash, committeeKeys)
+                        ? encoded.size()
+                        : 0;
+           })) {
+    return false;
+  }
+
+  return Stage("SetConsensusResponse")
+             .Run(options.iterations,
+                  [&]() -> size_t {
+                    encoded.clear();
+                    return Messenger::SetConsensusResponse(
+                               encoded, 0, consensusID, blockNumber,
+                               blockHash, backupID, subsetInfo, backupKey)
+                               ? encoded.size()
+                               : 0;
+                  }) &&
+         Stage("GetConsensusResponse")
+             .Run(options.iterations, [&]() -> size_t {
+               uint16_t decodedBackupID = 0;
+               vector<ResponseSubsetInfo> decodedSubsetInfo;
+               return Messenger::GetConsensusResponse(
+                          encoded, 0, consensusID, blockNumber, blockHash,
+                          decodedBackupID, decodedSubsetInfo, committeeKeys)
+                          ? encoded.size()
+                          : 0;
+             });
+}
+
+bool Run(const Options& options) {
+  cout << "txns=" << options.txns
+       << " microblocktxns=" << options.microBlockTxns
+       << " microblocks=" << options.microBlocks
+       << " statedelta(KB)=" << options.stateDeltaInKB
+       << " shards=" << options.shards << "x" << options.shardSize
+       << " subsets=" << options.subsets
+       << " iterations=" << options.iterations << endl;
+
+  Stage::PrintHeader();
+
+  return BenchForwardTxnBlock(options) && BenchFinalBlock(options) &&
+         BenchMicroBlock(options) && BenchDSBlock(options) &&
+         BenchStateDelta(options) && BenchConsensus(options);
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  try {
+    Options options;
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "txns,t", po::value<unsigned int>(&options.txns),
+        "Transactions in a forwarded txn packet (default 1000)")(
+        "microblocktxns", po::value<unsigned int>(&options.microBlockTxns),
+        "Transaction hashes in a microblock (default 5000)")(
+        "microblocks,m", po::value<unsigned int>(&options.microBlocks),
+        "Microblock infos in the final block (default 1000)")(
+        "statedelta,s", po::value<unsigned int>(&options.stateDeltaInKB),
+        "State delta size in KB (default 1024)")(
+        "shards", po::value<unsigned int>(&options.shards),
+        "Shards in the sharding structure (default 10)")(
+        "shardsize", po::value<unsigned int>(&options.shardSize),
+        "Nodes per shard (default 600)")(
+        "subsets", po::value<unsigned int>(&options.subsets),
+        "Subsets in a consensus response (default 2)")(
+        "iterations,n", po::value<unsigned int>(&options.iterations),
+        "Encodes and decodes timed per stage (default 200)");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help")) {
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      po::notify(vm);
+    } catch (boost::program_options::error& e) {
+      cerr << "ERROR: " << e.what() << endl << endl;
+      cout << desc;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    if (options.iterations == 0) {
+      cerr << "ERROR: iterations must be positive" << endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    INIT_FILE_LOGGER("messengerbench", ".");
+    TestUtils::Initialize();
+
+    if (!Run(options)) {
+      return ERROR_UNHANDLED_EXCEPTION;
+    }
+  } catch (exception& e) {
+    cerr << "Unhandled Exception reached the top of main: " << e.what()
+         << ", application will now exit" << endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+
+  return SUCCESS;
+}
@@ -74,4 +74,101 @@ BOOST_AUTO_TEST_CASE(test_Genesis_DSBlock_Hash) {
   BOOST_REQUIRE(blockHash == expectedHash);
 }
 
+BOOST_AUTO_TEST_CASE(test_AccountBase_encoding) {
+  INIT_STDOUT_LOGGER();
+
+  // The encoded account bases are hashed into the state root, so they must
+  // stay byte for byte what the protobuf message encodes
+  for (unsigned int i = 0; i < 200; i++) {
+    AccountBase accountBase(TestUtils::DistUint128(), TestUtils::DistUint64(),
+                            i % 2 == 0 ? 0 : TestUtils::DistUint32());
+    if (i % 3 != 0) {
+      accountBase.SetCodeHash(dev::h256::random());
+      accountBase.SetStorageRoot(dev::h256::random());
+    }
+
+    ZilliqaMessage::ProtoAccountBase protoAccountBase;
+    protoAccountBase.set_version(accountBase.GetVersion());
+    bytes balance;
+    Serializable::SetNumber<uint128_t>(balance, 0, accountBase.GetBalance(),
+                                       UINT128_SIZE);
+    protoAccountBase.mutable_balance()->set_data(balance.data(),
+                                                 balance.size());
+    protoAccountBase.set_nonce(accountBase.GetNonce());
+    if (accountBase.GetCodeHash() != dev::h256()) {
+      protoAccountBase.set_codehash(accountBase.GetCodeHash().data(),
+                                    accountBase.GetCodeHash().size);
+    }
+    if (accountBase.GetStorageRoot() != dev::h256()) {
+      protoAccountBase.set_storageroot(accountBase.GetStorageRoot().data(),
+                                       accountBase.GetStorageRoot().size);
+    }
+    bytes expected(protoAccountBase.ByteSize());
+    protoAccountBase.SerializeToArray(expected.data(), expected.size());
+
+    bytes encoded;
+    BOOST_REQUIRE(Messenger::SetAccountBase(encoded, 0, accountBase));
+    BOOST_REQUIRE(encoded == expected);
+
+    AccountBase decoded;
+    BOOST_REQUIRE(Messenger::GetAccountBase(encoded, 0, decoded));
+    BOOST_CHECK_EQUAL(decoded.GetVersion(), accountBase.GetVersion());
+    BOOST_CHECK(decoded.GetBalance() == accountBase.GetBalance());
+    BOOST_CHECK_EQUAL(decoded.GetNonce(), accountBase.GetNonce());
+    BOOST_CHECK(decoded.GetCodeHash() == accountBase.GetCodeHash());
+    BOOST_CHECK(decoded.GetStorageRoot() == accountBase.GetStorageRoot());
+
+    uint128_t balanceOnly = 0;
+    uint64_t nonceOnly = 0;
+    BOOST_REQUIRE(Messenger::GetAccountBaseBalance(encoded, 0, balanceOnly));
+    BOOST_REQUIRE(Messenger::GetAccountBaseNonce(encoded, 0, nonceOnly));
+    BOOST_CHECK(balanceOnly == accountBase.GetBalance());
+    BOOST_CHECK_EQUAL(nonceOnly, accountBase.GetNonce());
+  }
+
+  bytes junk = {0x12, 0x05, 0x0a};
+  uint64_t nonce = 0;
+  BOOST_CHECK(!Messenger::GetAccountBaseNonce(junk, 0, nonce));
+}
+
+BOOST_AUTO_TEST_CASE(test_AccountBase_rejected) {
+  INIT_STDOUT_LOGGER();
+
+  auto encode = [](unsigned int balanceSize, bool hasBalance, bool hasNonce) {
+    ZilliqaMessage::ProtoAccountBase protoAccountBase;
+    if (hasBalance) {
+      protoAccountBase.mutable_balance()->set_data(
+          bytes(balanceSize, 1).data(), balanceSize);
+    }
+    if (hasNonce) {
+      protoAccountBase.set_nonce(1);
+    }
+    bytes encoded(protoAccountBase.ByteSize());
+    protoAccountBase.SerializeToArray(encoded.data(), encoded.size());
+    return encoded;
+  };
+
+  AccountBase accountBase;
+  uint128_t balance = 0;
+  uint64_t nonce = 0;
+  BOOST_REQUIRE(Messenger::GetAccountBase(encode(UINT128_SIZE, true, true), 0,
+                                          accountBase));
+
+  // Truncated and oversized balances
+  for (const unsigned int size : {0u, UINT128_SIZE - 1, UINT128_SIZE + 1}) {
+    const bytes encoded = encode(size, true, true);
+    BOOST_CHECK(!Messenger::GetAccountBase(encoded, 0, accountBase));
+    BOOST_CHECK(!Messenger::GetAccountBaseBalance(encoded, 0, balance));
+    BOOST_CHECK(Messenger::GetAccountBaseNonce(encoded, 0, nonce));
+  }
+
+  // Missing balance or nonce
+  const bytes noBalance = encode(UINT128_SIZE, false, true);
+  BOOST_CHECK(!Messenger::GetAccountBase(noBalance, 0, accountBase));
+  BOOST_CHECK(!Messenger::GetAccountBaseBalance(noBalance, 0, balance));
+  const bytes noNonce = encode(UINT128_SIZE, true, false);
+  BOOST_CHECK(!Messenger::GetAccountBase(noNonce, 0, accountBase));
+  BOOST_CHECK(!Messenger::GetAccountBaseNonce(noNonce, 0, nonce));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
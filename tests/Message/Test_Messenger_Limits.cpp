@@ -224,8 +224,12 @@ BOOST_AUTO_TEST_CASE(test_GetLookupSetStateFromSeed) {
       dst, offset, lookupKey, AccountStore::GetInstance()));
   PubKey lookupPubKeyDeserialized;
   bytes dummyAccountStoreBytes;  // unchecked
+  bool more = false;
+  Address next;
+  dev::h256 stateRoot;
   BOOST_CHECK(Messenger::GetLookupSetStateFromSeed(
-      dst, offset, lookupPubKeyDeserialized, dummyAccountStoreBytes));
+      dst, offset, lookupPubKeyDeserialized, dummyAccountStoreBytes, more,
+      next, stateRoot));
   BOOST_CHECK(lookupKey.second == lookupPubKeyDeserialized);
 
   // Test for above the limit. Let's add a few just to be sure.
@@ -239,7 +243,26 @@ BOOST_AUTO_TEST_CASE(test_GetLookupSetStateFromSeed) {
       dst, offset, lookupKey, AccountStore::GetInstance()));
   PubKey lookupPubKeyDeserialized2;
   BOOST_CHECK(!Messenger::GetLookupSetStateFromSeed(
-      dst, offset, lookupPubKeyDeserialized2, dummyAccountStoreBytes));
+      dst, offset, lookupPubKeyDeserialized2, dummyAccountStoreBytes, more,
+      next, stateRoot));
+
+  // The same state fits the limit in chunks
+  Address cursor;
+  unsigned int numChunks = 0;
+  do {
+    dst.clear();
+    bytes chunkBytes;
+    BOOST_REQUIRE(Messenger::SetLookupSetStateFromSeed(
+        dst, offset, lookupKey, AccountStore::GetInstance(), cursor,
+        numAccountsToReachLimit / 2));
+    BOOST_REQUIRE(Messenger::GetLookupSetStateFromSeed(
+        dst, offset, lookupPubKeyDeserialized2, chunkBytes, more, next,
+        stateRoot));
+    BOOST_CHECK(stateRoot == AccountStore::GetInstance().GetStateRootHash());
+    cursor = next;
+    numChunks++;
+  } while (more);
+  BOOST_CHECK_EQUAL(numChunks, 3);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -213,6 +213,59 @@ BOOST_AUTO_TEST_CASE(test_SetAndGetVCBlock) {
   BOOST_CHECK(vcBlock == vcBlockDeserialized);
 }
 
+BOOST_AUTO_TEST_CASE(test_GetNodeFinalBlockHeader) {
+  bytes dst;
+  unsigned int offset = 0;
+
+  vector<MicroBlockInfo> microBlockInfos;
+  for (unsigned int i = 0, count = TestUtils::Dist1to99(); i < count; i++) {
+    microBlockInfos.push_back({BlockHash::random(), TxnHash::random(), i});
+  }
+  TxBlock txBlock(TestUtils::GenerateRandomTxBlockHeader(), microBlockInfos,
+                  TestUtils::GenerateRandomCoSignatures());
+  const uint64_t dsBlockNumber = TestUtils::DistUint64();
+
+  BOOST_CHECK(Messenger::SetNodeFinalBlock(dst, offset, dsBlockNumber,
+                                           TestUtils::DistUint32(), txBlock,
+                                           TestUtils::GenerateRandomCharVector(
+                                               TestUtils::Dist1to99())));
+
+  uint64_t dsBlockNumberDeserialized = 0;
+  TxBlockHeader txBlockHeaderDeserialized;
+  BlockHash blockHashDeserialized;
+
+  BOOST_CHECK(Messenger::GetNodeFinalBlockHeader(
+      dst, offset, dsBlockNumberDeserialized, txBlockHeaderDeserialized,
+      blockHashDeserialized));
+
+  BOOST_CHECK_EQUAL(dsBlockNumber, dsBlockNumberDeserialized);
+  BOOST_CHECK(txBlock.GetHeader() == txBlockHeaderDeserialized);
+  BOOST_CHECK(txBlock.GetBlockHash() == blockHashDeserialized);
+
+  dst.resize(dst.size() / 2);
+  BOOST_CHECK(!Messenger::GetNodeFinalBlockHeader(
+      dst, offset, dsBlockNumberDeserialized, txBlockHeaderDeserialized,
+      blockHashDeserialized));
+}
+
+BOOST_AUTO_TEST_CASE(test_GetNodeVCBlockHeader) {
+  bytes dst;
+  unsigned int offset = 0;
+  VCBlock vcBlock(TestUtils::GenerateRandomVCBlockHeader(),
+                  TestUtils::GenerateRandomCoSignatures());
+
+  BOOST_CHECK(Messenger::SetNodeVCBlock(dst, offset, vcBlock));
+
+  VCBlockHeader vcBlockHeaderDeserialized;
+  BlockHash blockHashDeserialized;
+
+  BOOST_CHECK(Messenger::GetNodeVCBlockHeader(
+      dst, offset, vcBlockHeaderDeserialized, blockHashDeserialized));
+
+  BOOST_CHECK(vcBlock.GetHeader() == vcBlockHeaderDeserialized);
+  BOOST_CHECK(vcBlock.GetBlockHash() == blockHashDeserialized);
+}
+
 BOOST_AUTO_TEST_CASE(test_SetAndGetFallbackBlockHeader) {
   bytes dst;
   unsigned int offset = 0;
@@ -274,4 +327,172 @@ BOOST_AUTO_TEST_CASE(test_CopyWithSizeCheck) {
               true);
 }
 
+BOOST_AUTO_TEST_CASE(test_SetAndGetNodeMissingTxnsErrorMsg) {
+  const auto randomHash = []() {
+    TxnHash hash;
+    generate(hash.asArray().begin(), hash.asArray().end(),
+             []() -> unsigned char { return TestUtils::DistUint8(); });
+    return hash;
+  };
+  vector<TxnHash> blockTranHashes(100);
+  generate(blockTranHashes.begin(), blockTranHashes.end(), randomHash);
+  const TxnHash notInBlock = randomHash();
+  const vector<TxnHash> missing{blockTranHashes[70], notInBlock,
+                                blockTranHashes[3], blockTranHashes[99]};
+
+  bytes dst;
+  BOOST_CHECK(Messenger::SetNodeMissingTxnsErrorMsg(dst, 0, missing, 5, 33133,
+                                                    blockTranHashes));
+
+  // Hashes absent from the block come first, then the positions in order
+  vector<TxnHash> decoded;
+  uint64_t epochNum = 0;
+  uint32_t listenPort = 0;
+  BOOST_CHECK(Messenger::GetNodeMissingTxnsErrorMsg(
+      dst, 0, decoded, epochNum, listenPort, blockTranHashes));
+  BOOST_CHECK((decoded == vector<TxnHash>{notInBlock, blockTranHashes[3],
+                                          blockTranHashes[70],
+                                          blockTranHashes[99]}));
+  BOOST_CHECK_EQUAL(epochNum, 5);
+  BOOST_CHECK_EQUAL(listenPort, 33133);
+
+  // The positions cannot be decoded without the block
+  decoded.clear();
+  BOOST_CHECK(!Messenger::GetNodeMissingTxnsErrorMsg(dst, 0, decoded,
+                                                     epochNum, listenPort));
+}
+
+BOOST_AUTO_TEST_CASE(test_SetAndGetNodeForwardTxnBlockAttestation) {
+  const PairOfKey lookupKey = TestUtils::GenerateRandomKeyPair();
+  vector<Transaction> txns;
+  for (unsigned int i = 0; i < 3; i++) {
+    txns.emplace_back(TestUtils::GenerateRandomTransaction(
+        1, i + 1, Transaction::NON_CONTRACT));
+  }
+
+  uint64_t epochNumber = 0, dsBlockNum = 0;
+  uint32_t shardId = 0;
+  PubKey lookupPubKey;
+  vector<Transaction> decoded;
+  Signature signature, attestation;
+  bool attested = true;
+
+  // Not attested unless asked
+  bytes dst;
+  BOOST_CHECK(Messenger::SetNodeForwardTxnBlock(dst, 0, 5, 2, 1, lookupKey,
+                                                txns, {}));
+  BOOST_CHECK(Messenger::GetNodeForwardTxnBlock(
+      dst, 0, epochNumber, dsBlockNum, shardId, lookupPubKey, decoded,
+      signature, attestation, attested));
+  BOOST_CHECK(!attested);
+  BOOST_CHECK_EQUAL(decoded.size(), txns.size());
+
+  dst.clear();
+  decoded.clear();
+  BOOST_CHECK(Messenger::SetNodeForwardTxnBlock(dst, 0, 5, 2, 1, lookupKey,
+                                                txns, {}, true));
+  BOOST_CHECK(Messenger::GetNodeForwardTxnBlock(
+      dst, 0, epochNumber, dsBlockNum, shardId, lookupPubKey, decoded,
+      signature, attestation, attested));
+  BOOST_CHECK(attested);
+  BOOST_CHECK(lookupPubKey == lookupKey.second);
+
+  // The attestation carries over when the packet is gossiped
+  bytes gossiped;
+  BOOST_CHECK(Messenger::SetNodeForwardTxnBlock(
+      gossiped, 0, epochNumber, dsBlockNum, shardId, lookupPubKey, decoded,
+      signature, attestation, attested));
+  vector<Transaction> regossiped;
+  BOOST_CHECK(Messenger::GetNodeForwardTxnBlock(
+      gossiped, 0, epochNumber, dsBlockNum, shardId, lookupPubKey, regossiped,
+      signature, attestation, attested));
+  BOOST_CHECK(attested);
+
+  // It does not hold for another shard, though the packet stays valid
+  gossiped.clear();
+  regossiped.clear();
+  BOOST_CHECK(Messenger::SetNodeForwardTxnBlock(
+      gossiped, 0, epochNumber, dsBlockNum, shardId + 1, lookupPubKey,
+      decoded, signature, attestation, true));
+  BOOST_CHECK(Messenger::GetNodeForwardTxnBlock(
+      gossiped, 0, epochNumber, dsBlockNum, shardId, lookupPubKey, regossiped,
+      signature, attestation, attested));
+  BOOST_CHECK(!attested);
+  BOOST_CHECK_EQUAL(regossiped.size(), txns.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_SetAndGetLookupSubscribeSeed) {
+  const PairOfKey seedKey = TestUtils::GenerateRandomKeyPair();
+
+  bytes dst;
+  BOOST_CHECK(Messenger::SetLookupSubscribeSeed(dst, 0, 5555, seedKey));
+
+  PubKey seedPubKey;
+  uint32_t port = 0;
+  BOOST_CHECK(Messenger::GetLookupSubscribeSeed(dst, 0, seedPubKey, port));
+  BOOST_CHECK(seedPubKey == seedKey.second);
+  BOOST_CHECK_EQUAL(port, 5555);
+
+  // The signature comes last, so a changed last byte breaks it
+  bytes forged = dst;
+  forged.back() ^= 0xFF;
+  BOOST_CHECK(!Messenger::GetLookupSubscribeSeed(forged, 0, seedPubKey, port));
+}
+
+BOOST_AUTO_TEST_CASE(test_SetAndGetLookupCosigsRewardsFromSeed) {
+  const PairOfKey keys = TestUtils::GenerateRandomKeyPair();
+
+  bytes request;
+  BOOST_CHECK(Messenger::SetLookupGetCosigsRewardsFromSeed(request, 0, 10, 2,
+                                                           5555, keys));
+  PubKey senderPubKey;
+  uint64_t blockNum = 0;
+  uint64_t blockCount = 0;
+  uint32_t port = 0;
+  BOOST_CHECK(Messenger::GetLookupGetCosigsRewardsFromSeed(
+      request, 0, senderPubKey, blockNum, blockCount, port));
+  BOOST_CHECK(senderPubKey == keys.second);
+  BOOST_CHECK_EQUAL(blockNum, 10);
+  BOOST_CHECK_EQUAL(blockCount, 2);
+  BOOST_CHECK_EQUAL(port, 5555);
+
+  // One record per block, each with a shard entry and the DS one
+  vector<bytes> records(2);
+  vector<MicroBlock> microBlocks;
+  vector<TxBlock> txBlocks;
+  for (unsigned int i = 0; i < records.size(); i++) {
+    microBlocks.emplace_back(TestUtils::GenerateRandomMicroBlockHeader(),
+                             vector<TxnHash>(),
+                             TestUtils::GenerateRandomCoSignatures());
+    txBlocks.emplace_back(TestUtils::GenerateRandomTxBlockHeader(),
+                          vector<MicroBlockInfo>(),
+                          TestUtils::GenerateRandomCoSignatures());
+    const uint32_t numShards = microBlocks.back().GetHeader().GetShardId() + 1;
+    BOOST_CHECK(Messenger::SetCosigsRewardsRecord(
+        records[i], 10 + i, {microBlocks.back()}, txBlocks.back(), numShards));
+  }
+
+  bytes reply;
+  BOOST_CHECK(Messenger::SetLookupSetCosigsRewardsFromSeed(reply, 0, keys,
+                                                           records));
+  vector<CoinbaseStruct> cosigsRewards;
+  BOOST_CHECK(Messenger::GetLookupSetCosigsRewardsFromSeed(
+      reply, 0, cosigsRewards, senderPubKey));
+  BOOST_REQUIRE_EQUAL(cosigsRewards.size(), 2 * records.size());
+  for (unsigned int i = 0; i < records.size(); i++) {
+    const auto& shardEntry = cosigsRewards[2 * i];
+    BOOST_CHECK_EQUAL(shardEntry.GetBlockNumber(), 10 + i);
+    BOOST_CHECK_EQUAL(shardEntry.GetShardId(),
+                      microBlocks[i].GetHeader().GetShardId());
+    BOOST_CHECK(shardEntry.GetB2() == microBlocks[i].GetB2());
+    BOOST_CHECK(shardEntry.GetRewards() ==
+                microBlocks[i].GetHeader().GetRewards());
+
+    const auto& dsEntry = cosigsRewards[2 * i + 1];
+    BOOST_CHECK_EQUAL(dsEntry.GetBlockNumber(), 10 + i + 1);
+    BOOST_CHECK_EQUAL(dsEntry.GetShardId(), -1);
+    BOOST_CHECK(dsEntry.GetRewards() == txBlocks[i].GetHeader().GetRewards());
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
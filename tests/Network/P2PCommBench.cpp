@@ -0,0 +1,407 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// Loopback benchmark of P2PComm. P2PComm is a singleton, so every node is a
+/// process of its own: node 0 (this process) sends, and the nodes forked
+/// from it receive on 127.0.0.x and report each delivery through a pipe. The
+/// steady clock is shared by all the processes, so the reported latencies
+/// are one-way, from the send call to the dispatcher of the receiver.
+
+#include <arpa/inet.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <Schnorr.h>
+#include "libNetwork/MessagePool.h"
+#include "libNetwork/P2PComm.h"
+#include "libUtils/Histogram.h"
+#include "libUtils/Logger.h"
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+
+namespace po = boost::program_options;
+using namespace std;
+
+namespace {
+
+const unsigned char BENCH_CLASS_BYTE = 0xFE;
+const unsigned char BENCH_INS_BYTE = 0x00;
+const unsigned int ID_OFFSET = 2;
+const unsigned int MIN_PAYLOAD = ID_OFFSET + sizeof(uint64_t);
+
+using Clock = chrono::steady_clock;
+
+struct Options {
+  unsigned int nodes{8};
+  unsigned int smallCount{2000};
+  unsigned int smallSize{256};
+  unsigned int largeCount{50};
+  unsigned int largeSize{1024 * 1024};
+  unsigned int window{64};
+  unsigned int basePort{40000};
+  unsigned int timeoutSec{60};
+  string scenarios{"unicast,multicast,gossip"};
+};
+
+/// Written by a receiver for each message delivered to it, small enough for
+/// the write to the shared pipe to be atomic
+struct Record {
+  uint64_t m_id;
+  int64_t m_receivedNs;
+  uint32_t m_node;
+};
+
+int g_recordFd = -1;
+uint32_t g_node = 0;
+
+Peer GetPeer(const Options& options, unsigned int node) {
+  return Peer(htonl(0x7F000001 + node), options.basePort + node);
+}
+
+VectorOfNode GetOtherNodes(const Options& options,
+                           const vector<PairOfKey>& keys, unsigned int self) {
+  VectorOfNode nodes;
+  for (unsigned int i = 0; i <= options.nodes; i++) {
+    if (i != self) {
+      nodes.emplace_back(keys.at(i).second, GetPeer(options, i));
+    }
+  }
+  return nodes;
+}
+
+void ReportDelivery(pair<bytes, Peer>* message) {
+  const bytes& payload = message->first;
+  if (payload.size() >= MIN_PAYLOAD && payload[0] == BENCH_CLASS_BYTE) {
+    Record record{0, 0, g_node};
+    for (unsigned int i = 0; i < sizeof(uint64_t); i++) {
+      record.m_id = (record.m_id << 8) | payload[ID_OFFSET + i];
+    }
+    record.m_receivedNs = chrono::duration_cast<chrono::nanoseconds>(
+                              Clock::now().time_since_epoch())
+                              .count();
+    if (write(g_recordFd, &record, sizeof(record)) != sizeof(record)) {
+      LOG_GENERAL(WARNING, "Cannot report a delivery");
+    }
+  }
+  MessagePool::GetInstance().Release(message);
+}
+
+void StartNode(const Options& options, const vector<PairOfKey>& keys,
+               unsigned int node, bool withGossip) {
+  P2PComm& p2p = P2PComm::GetInstance();
+  p2p.SetSelfPeer(GetPeer(options, node));
+  p2p.SetSelfKey(keys.at(node));
+  if (withGossip) {
+    vector<PubKey> allKeys;
+    for (const auto& key : keys) {
+      allKeys.emplace_back(key.second);
+    }
+    p2p.InitializeRumorManager(GetOtherNodes(options, keys, node), allKeys);
+  }
+  p2p.StartMessagePump(options.basePort + node, ReportDelivery);
+}
+
+/// Matches the deliveries reported by the receivers with the send times.
+class Collector {
+  const int m_fd;
+  mutex m_mutex;
+  condition_variable m_cv;
+  vector<Clock::time_point> m_sentAt;
+  vector<unsigned int> m_left;
+  uint64_t m_outstanding{0};
+  uint64_t m_deliveries{0};
+  Clock::time_point m_lastDelivery;
+  Histogram m_latencyUs;
+  thread m_thread;
+
+  void Read() {
+    Record record;
+    while (read(m_fd, &record, sizeof(record)) == sizeof(record)) {
+      const Clock::time_point receivedAt{
+          chrono::duration_cast<Clock::duration>(
+              chrono::nanoseconds(record.m_receivedNs))};
+      lock_guard<mutex> g(m_mutex);
+      if (record.m_id >= m_left.size() || m_left[record.m_id] == 0) {
+        continue;
+      }
+      m_latencyUs.Record(max<int64_t>(
+          0, chrono::duration_cast<chrono::microseconds>(
+                 receivedAt - m_sentAt[record.m_id])
+                 .count()));
+      m_deliveries++;
+      m_lastDelivery = max(m_lastDelivery, receivedAt);
+      if (--m_left[record.m_id] == 0) {
+        m_outstanding--;
+        m_cv.notify_all();
+      }
+    }
+  }
+
+ public:
+  explicit Collector(int fd) : m_fd(fd) {
+    m_thread = thread([this]() { Read(); });
+    m_thread.detach();
+  }
+
+  /// Starts a new scenario, forgetting the messages of the previous one.
+  void Reset() {
+    lock_guard<mutex> g(m_mutex);
+    fill(m_left.begin(), m_left.end(), 0);
+    m_outstanding = 0;
+    m_deliveries = 0;
+    m_lastDelivery = Clock::time_point();
+    m_latencyUs.Reset();
+  }
+
+  /// Registers a message once the window has room, and returns its id.
+  uint64_t Add(unsigned int receivers, unsigned int window,
+               const Clock::time_point& deadline) {
+    unique_lock<mutex> lock(m_mutex);
+    m_cv.wait_until(lock, deadline,
+                    [this, window]() { return m_outstanding < window; });
+    m_sentAt.push_back(Clock::now());
+    m_left.push_back(receivers);
+    m_outstanding++;
+    return m_sentAt.size() - 1;
+  }
+
+  /// Sets the send time of a message to now, after its payload is built.
+  void MarkSent(uint64_t id) {
+    lock_guard<mutex> g(m_mutex);
+    m_sentAt.at(id) = Clock::now();
+  }
+
+  /// Waits for every message to be delivered. Returns false on timeout.
+  bool Wait(const Clock::time_point& deadline) {
+    unique_lock<mutex> lock(m_mutex);
+    return m_cv.wait_until(lock, deadline,
+                           [this]() { return m_outstanding == 0; });
+  }
+
+  void Report(const string& name, unsigned int messages,
+              unsigned int receivers, const Clock::time_point& start) {
+    lock_guard<mutex> g(m_mutex);
+    const double elapsed =
+        chrono::duration<double>(m_lastDelivery - start).count();
+    cout << left << setw(20) << name << right << setw(10) << messages
+         << setw(12) << m_deliveries << setw(12)
+         << static_cast<uint64_t>(messages) * receivers - m_deliveries
+         << setw(12) << fixed << setprecision(1)
+         << ((elapsed > 0) ? m_deliveries / elapsed : 0) << setw(10)
+         << m_latencyUs.GetPercentile(50) << setw(10)
+         << m_latencyUs.GetPercentile(90) << setw(10)
+         << m_latencyUs.GetPercentile(99) << setw(10) << m_latencyUs.GetMax()
+         << endl;
+  }
+};
+
+bytes MakePayload(unsigned int size, uint64_t id) {
+  bytes payload(max(size, MIN_PAYLOAD));
+  // Not compressible, so that the bytes sent are the bytes asked for
+  mt19937 gen(id);
+  generate(payload.begin(), payload.end(), [&gen] { return gen() & 0xFF; });
+  payload[0] = BENCH_CLASS_BYTE;
+  payload[1] = BENCH_INS_BYTE;
+  for (unsigned int i = 0; i < sizeof(uint64_t); i++) {
+    payload[ID_OFFSET + i] = (id >> (8 * (sizeof(uint64_t) - 1 - i))) & 0xFF;
+  }
+  return payload;
+}
+
+void RunScenario(const Options& options, Collector& collector,
+                 const string& mode, bool large) {
+  P2PComm& p2p = P2PComm::GetInstance();
+  const unsigned int count = large ? options.largeCount : options.smallCount;
+  const unsigned int size = large ? options.largeSize : options.smallSize;
+  const unsigned int receivers = (mode == "unicast") ? 1 : options.nodes;
+
+  VectorOfPeer peers;
+  for (unsigned int i = 1; i <= options.nodes; i++) {
+    peers.emplace_back(GetPeer(options, i));
+  }
+
+  collector.Reset();
+  const auto start = Clock::now();
+  const auto deadline = start + chrono::seconds(options.timeoutSec);
+  for (unsigned int i = 0; i < count && Clock::now() < deadline; i++) {
+    const uint64_t id = collector.Add(receivers, options.window, deadline);
+    const bytes payload = MakePayload(size, id);
+    collector.MarkSent(id);
+    if (mode == "unicast") {
+      p2p.SendMessage(peers.at(i % peers.size()), payload);
+    } else if (mode == "multicast") {
+      p2p.SendMessage(peers, payload);
+    } else {
+      p2p.SpreadRumor(payload);
+    }
+  }
+  if (!collector.Wait(deadline)) {
+    LOG_GENERAL(WARNING, mode << " timed out");
+  }
+
+  collector.Report(mode + (large ? "/large" : "/small"), count, receivers,
+                   start);
+}
+
+void description() {
+  cout << endl << "Description:\n";
+  cout << "\tSends messages between P2PComm nodes on loopback and reports"
+       << endl
+       << "\tdeliveries/sec and one-way latency in microseconds for unicast,"
+       << endl
+       << "\tmulticast and gossip of small and large messages." << endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  try {
+    Options options;
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "nodes,n", po::value<unsigned int>(&options.nodes),
+        "Receiving nodes (default 8)")(
+        "small-count,c", po::value<unsigned int>(&options.smallCount),
+        "Small messages per scenario (default 2000)")(
+        "small-size,s", po::value<unsigned int>(&options.smallSize),
+        "Size of the small messages in bytes (default 256)")(
+        "large-count,C", po::value<unsigned int>(&options.largeCount),
+        "Large messages per scenario (default 50)")(
+        "large-size,S", po::value<unsigned int>(&options.largeSize),
+        "Size of the large messages in bytes (default 1048576)")(
+        "window,w", po::value<unsigned int>(&options.window),
+        "Messages in flight before the sender waits (default 64)")(
+        "port,p", po::value<unsigned int>(&options.basePort),
+        "Listen port of node 0, node i listens on port + i (default 40000)")(
+        "timeout,o", po::value<unsigned int>(&options.timeoutSec),
+        "Time limit of each scenario in seconds (default 60)")(
+        "scenarios,m", po::value<string>(&options.scenarios),
+        "Comma separated list of unicast, multicast and gossip (default "
+        "all)");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help")) {
+        description();
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      po::notify(vm);
+    } catch (boost::program_options::error& e) {
+      cerr << "ERROR: " << e.what() << endl << endl;
+      cout << desc;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    vector<string> modes;
+    {
+      stringstream ss(options.scenarios);
+      string mode;
+      while (getline(ss, mode, ',')) {
+        if (mode != "unicast" && mode != "multicast" && mode != "gossip") {
+          cerr << "ERROR: unknown scenario " << mode << endl;
+          return ERROR_IN_COMMAND_LINE;
+        }
+        modes.emplace_back(mode);
+      }
+    }
+    if (options.nodes == 0 || options.nodes > 250 || options.window == 0) {
+      cerr << "ERROR: nodes must be between 1 and 250 and window positive"
+           << endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+    const bool withGossip =
+        find(modes.begin(), modes.end(), "gossip") != modes.end();
+
+    vector<PairOfKey> keys;
+    for (unsigned int i = 0; i <= options.nodes; i++) {
+      keys.emplace_back(Schnorr::GenKeyPair());
+    }
+
+    int fds[2];
+    if (pipe(fds) < 0) {
+      cerr << "ERROR: cannot create the pipe" << endl;
+      return ERROR_UNHANDLED_EXCEPTION;
+    }
+
+    // Forked before any thread is started, P2PComm included
+    vector<pid_t> children;
+    for (unsigned int node = 1; node <= options.nodes; node++) {
+      const pid_t pid = fork();
+      if (pid == 0) {
+        close(fds[0]);
+        g_recordFd = fds[1];
+        g_node = node;
+        const string logName = "p2pcommbench-" + to_string(node);
+        INIT_FILE_LOGGER(logName.c_str(), "./");
+        StartNode(options, keys, node, withGossip);
+        _exit(SUCCESS);
+      }
+      children.emplace_back(pid);
+    }
+    close(fds[1]);
+
+    INIT_FILE_LOGGER("p2pcommbench", "./");
+    thread pump([&]() { StartNode(options, keys, 0, withGossip); });
+    pump.detach();
+    // Let every node open its listener
+    this_thread::sleep_for(chrono::seconds(2));
+
+    Collector collector(fds[0]);
+    cout << "nodes=" << options.nodes << " window=" << options.window << endl;
+    cout << left << setw(20) << "scenario" << right << setw(10) << "msgs"
+         << setw(12) << "delivered" << setw(12) << "lost" << setw(12)
+         << "deliv/sec" << setw(10) << "p50(us)" << setw(10) << "p90(us)"
+         << setw(10) << "p99(us)" << setw(10) << "max(us)" << endl;
+    for (const auto& mode : modes) {
+      RunScenario(options, collector, mode, false);
+      RunScenario(options, collector, mode, true);
+    }
+
+    for (const auto pid : children) {
+      kill(pid, SIGKILL);
+      waitpid(pid, nullptr, 0);
+    }
+
+    // The message pump of this process cannot be stopped, so skip the static
+    // destructors that would run under it
+    cout.flush();
+    _exit(SUCCESS);
+  } catch (exception& e) {
+    cerr << "Unhandled Exception reached the top of main: " << e.what()
+         << ", application will now exit" << endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "libNetwork/AsyncSender.h"
+#include "libNetwork/P2PComm.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE asyncsender
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+/// Accepts one connection on a loopback port and reads it to the end.
+class Receiver {
+  int m_listenFd;
+  uint16_t m_port{0};
+  bytes m_received;
+  thread m_thread;
+
+ public:
+  Receiver() {
+    m_listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(addr);
+    bind(m_listenFd, (struct sockaddr*)&addr, sizeof(addr));
+    listen(m_listenFd, 1);
+    getsockname(m_listenFd, (struct sockaddr*)&addr, &length);
+    m_port = ntohs(addr.sin_port);
+
+    m_thread = thread([this]() {
+      const int fd = accept(m_listenFd, nullptr, nullptr);
+      unsigned char buffer[4096];
+      ssize_t n;
+      while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        m_received.insert(m_received.end(), buffer, buffer + n);
+      }
+      close(fd);
+    });
+  }
+
+  ~Receiver() { close(m_listenFd); }
+
+  uint16_t GetPort() const { return m_port; }
+
+  const bytes& Wait() {
+    m_thread.join();
+    return m_received;
+  }
+};
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(asyncsender)
+
+BOOST_AUTO_TEST_CASE(test_send_frames) {
+  INIT_STDOUT_LOGGER();
+
+  Receiver receiver;
+  AsyncSender sender(1, 1);
+  BOOST_REQUIRE(sender.IsRunning());
+
+  const bytes small{1, 2, 3};
+  const bytes large(1024 * 1024, 0x5A);
+  vector<AsyncSender::FramePtr> frames{
+      make_shared<const MessageFrame>(small, START_BYTE_NORMAL, bytes()),
+      make_shared<const MessageFrame>(large, START_BYTE_NORMAL, bytes())};
+
+  mutex mutexDone;
+  condition_variable cvDone;
+  bool done = false;
+  bool result = false;
+  sender.Send(Peer(htonl(INADDR_LOOPBACK), receiver.GetPort()), frames,
+              [&](bool sent) {
+                lock_guard<mutex> g(mutexDone);
+                done = true;
+                result = sent;
+                cvDone.notify_all();
+              });
+  {
+    unique_lock<mutex> lock(mutexDone);
+    cvDone.wait(lock, [&]() { return done; });
+  }
+  BOOST_CHECK(result);
+
+  bytes expected;
+  for (const auto& frame : frames) {
+    expected.insert(expected.end(), frame->GetHeader().begin(),
+                    frame->GetHeader().end());
+    expected.insert(expected.end(), frame->GetBody().begin(),
+                    frame->GetBody().end());
+  }
+  BOOST_CHECK(receiver.Wait() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(test_connect_refused) {
+  INIT_STDOUT_LOGGER();
+
+  // Nothing listens on the port once the receiver socket is closed
+  uint16_t port;
+  {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(addr);
+    bind(fd, (struct sockaddr*)&addr, sizeof(addr));
+    getsockname(fd, (struct sockaddr*)&addr, &length);
+    port = ntohs(addr.sin_port);
+    close(fd);
+  }
+
+  AsyncSender sender(2, 1);
+  mutex mutexDone;
+  condition_variable cvDone;
+  bool done = false;
+  bool result = true;
+  sender.Send(Peer(htonl(INADDR_LOOPBACK), port),
+              {make_shared<const MessageFrame>(bytes{1}, START_BYTE_NORMAL,
+                                               bytes())},
+              [&](bool sent) {
+                lock_guard<mutex> g(mutexDone);
+                done = true;
+                result = sent;
+                cvDone.notify_all();
+              });
+  unique_lock<mutex> lock(mutexDone);
+  cvDone.wait(lock, [&]() { return done; });
+  BOOST_CHECK(!result);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
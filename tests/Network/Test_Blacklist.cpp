@@ -15,6 +15,10 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "libNetwork/Blacklist.h"
 #include "libUtils/Logger.h"
 
@@ -102,4 +106,50 @@ BOOST_AUTO_TEST_CASE(test_pop) {
   LOG_GENERAL(INFO, "Test Blacklist pop done!");
 }
 
+BOOST_AUTO_TEST_CASE(test_concurrent_access) {
+  INIT_STDOUT_LOGGER();
+
+  Blacklist& bl = Blacklist::GetInstance();
+  bl.Clear();
+
+  // Odd IPs stay blacklisted while even IPs are added and removed
+  for (uint128_t i = 1; i < 1000; i += 2) {
+    bl.Add(i);
+  }
+
+  atomic<bool> stop{false};
+  atomic<unsigned int> misses{0};
+  vector<thread> readers;
+  for (unsigned int t = 0; t < 4; t++) {
+    readers.emplace_back([&bl, &stop, &misses]() {
+      while (!stop) {
+        for (uint128_t i = 1; i < 1000; i += 2) {
+          if (!bl.Exist(i)) {
+            misses++;
+          }
+        }
+      }
+    });
+  }
+
+  for (unsigned int round = 0; round < 100; round++) {
+    for (uint128_t i = 0; i < 1000; i += 2) {
+      bl.Add(i);
+    }
+    for (uint128_t i = 0; i < 1000; i += 2) {
+      bl.Remove(i);
+    }
+  }
+
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  BOOST_CHECK_EQUAL(misses, 0);
+  BOOST_CHECK_EQUAL(bl.SizeOfBlacklist(), 500);
+  bl.Clear();
+  BOOST_CHECK_EQUAL(bl.SizeOfBlacklist(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "libNetwork/BroadcastHashFilter.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE broadcasthashfilter
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+bytes MakeHash(unsigned int seed) {
+  bytes hash(BroadcastHashFilter::DIGEST_SIZE, 0);
+  for (unsigned int i = 0; i < hash.size(); i++) {
+    hash.at(i) = (seed * 31 + i * 7) & 0xFF;
+  }
+  hash.at(0) = seed & 0xFF;
+  hash.at(1) = (seed >> 8) & 0xFF;
+  return hash;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(broadcasthashfilter)
+
+BOOST_AUTO_TEST_CASE(test_insert_and_contains) {
+  INIT_STDOUT_LOGGER();
+
+  BroadcastHashFilter filter(60, 600);
+  auto now = BroadcastHashFilter::Clock::now();
+
+  for (unsigned int i = 0; i < 1000; i++) {
+    BOOST_CHECK_MESSAGE(filter.Insert(MakeHash(i), now),
+                        "New hash should be accepted!");
+  }
+
+  for (unsigned int i = 0; i < 2000; i++) {
+    BOOST_CHECK_EQUAL(filter.Contains(MakeHash(i), now), i < 1000);
+  }
+
+  BOOST_CHECK_MESSAGE(!filter.Insert(MakeHash(1), now),
+                      "Duplicate hash should be rejected!");
+  BOOST_CHECK_MESSAGE(!filter.Insert(bytes(10, 0), now),
+                      "Malformed hash should be rejected!");
+}
+
+BOOST_AUTO_TEST_CASE(test_expiry) {
+  INIT_STDOUT_LOGGER();
+
+  BroadcastHashFilter filter(60, 600);
+  auto now = BroadcastHashFilter::Clock::now();
+
+  filter.Insert(MakeHash(0), now);
+  filter.Insert(MakeHash(1), now + chrono::seconds(300));
+
+  BOOST_CHECK(filter.Contains(MakeHash(0), now + chrono::seconds(599)));
+  BOOST_CHECK(!filter.Contains(MakeHash(0), now + chrono::seconds(661)));
+  BOOST_CHECK(filter.Contains(MakeHash(1), now + chrono::seconds(661)));
+  BOOST_CHECK(!filter.Contains(MakeHash(1), now + chrono::seconds(961)));
+
+  // Expired hash can be inserted again
+  BOOST_CHECK(filter.Insert(MakeHash(0), now + chrono::seconds(661)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <numeric>
+
+#include "libNetwork/BroadcastTree.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE broadcasttree
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+Peer MakePeer(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+  // Net-encoded, the first octet in the lowest byte
+  return Peer(uint128_t(a) | uint128_t(b) << 8 | uint128_t(c) << 16 |
+                  uint128_t(d) << 24,
+              33133);
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(broadcasttree)
+
+BOOST_AUTO_TEST_CASE(test_region) {
+  INIT_STDOUT_LOGGER();
+
+  const Peer peer = MakePeer(10, 1, 2, 3);
+  BOOST_CHECK_EQUAL(BroadcastTree::GetRegion(peer, 0), 0);
+  BOOST_CHECK_EQUAL(BroadcastTree::GetRegion(peer, 8), 10);
+  BOOST_CHECK_EQUAL(BroadcastTree::GetRegion(peer, 16), (10 << 8) | 1);
+  BOOST_CHECK_EQUAL(BroadcastTree::GetRegion(peer, 32),
+                    (10u << 24) | (1 << 16) | (2 << 8) | 3);
+  BOOST_CHECK_EQUAL(BroadcastTree::GetRegion(MakePeer(10, 1, 9, 9), 16),
+                    BroadcastTree::GetRegion(peer, 16));
+}
+
+BOOST_AUTO_TEST_CASE(test_tree_order_single_region) {
+  INIT_STDOUT_LOGGER();
+
+  // Without regions the tree is the plain index arithmetic
+  const vector<uint32_t> order =
+      BroadcastTree::GetTreeOrder(vector<uint32_t>(23, 0), 3, 2);
+  vector<uint32_t> identity(23);
+  iota(identity.begin(), identity.end(), 0);
+  BOOST_CHECK(order == identity);
+}
+
+BOOST_AUTO_TEST_CASE(test_tree_order_regions) {
+  INIT_STDOUT_LOGGER();
+
+  // Two regions in turn, 7 clusters of 2 where cluster c forwards to
+  // clusters 2c + 1 and 2c + 2
+  vector<uint32_t> regions(14);
+  for (uint32_t i = 0; i < regions.size(); i++) {
+    regions[i] = i % 2;
+  }
+  const vector<uint32_t> order = BroadcastTree::GetTreeOrder(regions, 2, 2);
+
+  vector<uint32_t> sorted(order);
+  sort(sorted.begin(), sorted.end());
+  vector<uint32_t> identity(14);
+  iota(identity.begin(), identity.end(), 0);
+  BOOST_CHECK(sorted == identity);
+
+  // The first cluster is kept, and the subtrees of clusters 1 (clusters 1, 3
+  // and 4) and 2 (clusters 2, 5 and 6) each hold one region
+  BOOST_CHECK(order == (vector<uint32_t>{0, 1, 2, 4, 3, 5, 6, 8, 10, 12, 7, 9,
+                                          11, 13}));
+  for (const uint32_t cluster : {1, 3, 4}) {
+    BOOST_CHECK_EQUAL(regions[order[cluster * 2]], 0);
+    BOOST_CHECK_EQUAL(regions[order[cluster * 2 + 1]], 0);
+  }
+  for (const uint32_t cluster : {2, 5, 6}) {
+    BOOST_CHECK_EQUAL(regions[order[cluster * 2]], 1);
+    BOOST_CHECK_EQUAL(regions[order[cluster * 2 + 1]], 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_tree_order_short_cluster) {
+  INIT_STDOUT_LOGGER();
+
+  const vector<uint32_t> regions{5, 5, 5, 1, 2, 1, 2, 1};
+  const vector<uint32_t> order = BroadcastTree::GetTreeOrder(regions, 3, 1);
+  BOOST_CHECK(order == (vector<uint32_t>{0, 1, 2, 3, 5, 7, 4, 6}));
+}
+
+BOOST_AUTO_TEST_CASE(test_interleaved_order) {
+  INIT_STDOUT_LOGGER();
+
+  const vector<uint32_t> order =
+      BroadcastTree::GetInterleavedOrder({7, 7, 7, 3, 3, 9});
+  BOOST_CHECK(order == (vector<uint32_t>{3, 0, 5, 4, 1, 2}));
+  BOOST_CHECK(BroadcastTree::GetInterleavedOrder({4, 4, 4}) ==
+              (vector<uint32_t>{0, 1, 2}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
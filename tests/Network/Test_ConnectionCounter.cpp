@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "libNetwork/ConnectionCounter.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE connectioncounter
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(connectioncounter)
+
+BOOST_AUTO_TEST_CASE(test_limit) {
+  INIT_STDOUT_LOGGER();
+
+  ConnectionCounter counter;
+  const uint128_t ip = 0x0100007F;
+  // Same as before: the limit is exceeded by one before connections are
+  // refused
+  for (unsigned int i = 0; i < 4; i++) {
+    BOOST_CHECK(counter.TryAdd(ip, 3));
+  }
+  BOOST_CHECK(!counter.TryAdd(ip, 3));
+  BOOST_CHECK_EQUAL(counter.Get(ip), 4);
+  BOOST_CHECK_EQUAL(counter.Get(ip + 1), 0);
+
+  counter.Remove(ip);
+  BOOST_CHECK(counter.TryAdd(ip, 3));
+}
+
+BOOST_AUTO_TEST_CASE(test_remove_and_clear) {
+  INIT_STDOUT_LOGGER();
+
+  ConnectionCounter counter;
+  const uint128_t ip = 0x0200007F;
+  counter.Remove(ip);
+  BOOST_CHECK_EQUAL(counter.Get(ip), 0);
+
+  BOOST_CHECK(counter.TryAdd(ip, 10));
+  counter.Remove(ip);
+  counter.Remove(ip);
+  BOOST_CHECK_EQUAL(counter.Get(ip), 0);
+
+  BOOST_CHECK(counter.TryAdd(ip, 10));
+  counter.Clear();
+  BOOST_CHECK_EQUAL(counter.Get(ip), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent) {
+  INIT_STDOUT_LOGGER();
+
+  ConnectionCounter counter(4);
+  vector<thread> threads;
+  for (unsigned int t = 0; t < 4; t++) {
+    threads.emplace_back([&counter]() {
+      for (unsigned int i = 0; i < 10000; i++) {
+        const uint128_t ip = i % 16;
+        if (counter.TryAdd(ip, 1000000)) {
+          counter.Remove(ip);
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  for (unsigned int i = 0; i < 16; i++) {
+    BOOST_CHECK_EQUAL(counter.Get(i), 0);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
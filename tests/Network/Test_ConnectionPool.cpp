@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include "libNetwork/ConnectionPool.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE connectionpool
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(connectionpool)
+
+BOOST_AUTO_TEST_CASE(test_reuse) {
+  INIT_STDOUT_LOGGER();
+
+  ConnectionPool pool(2, 30, 10);
+  Peer peer(0x0100007F, 5000);
+
+  BOOST_CHECK_MESSAGE(pool.Acquire(peer) == -1,
+                      "Empty pool should not return a socket!");
+
+  int fds[2];
+  BOOST_REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+  pool.Release(peer, fds[0], true);
+  BOOST_CHECK_EQUAL(pool.IdleCount(peer), 1);
+
+  BOOST_CHECK_MESSAGE(pool.Acquire(peer) == fds[0],
+                      "Healthy idle socket should be reused!");
+  BOOST_CHECK_EQUAL(pool.IdleCount(peer), 0);
+
+  pool.Release(peer, fds[0], true);
+  BOOST_CHECK_EQUAL(pool.IdleCount(Peer(0x0100007F, 5001)), 0);
+
+  pool.Clear();
+  BOOST_CHECK_EQUAL(pool.IdleCount(peer), 0);
+  close(fds[1]);
+}
+
+BOOST_AUTO_TEST_CASE(test_closed_by_remote) {
+  INIT_STDOUT_LOGGER();
+
+  ConnectionPool pool(2, 30, 10);
+  Peer peer(0x0100007F, 5000);
+
+  int fds[2];
+  BOOST_REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+  pool.Acquire(peer);
+  pool.Release(peer, fds[0], true);
+  close(fds[1]);
+
+  BOOST_CHECK_MESSAGE(pool.Acquire(peer) == -1,
+                      "Socket closed by remote should not be reused!");
+  BOOST_CHECK_EQUAL(pool.IdleCount(peer), 0);
+  pool.Release(peer, -1, false);
+}
+
+BOOST_AUTO_TEST_CASE(test_expiry) {
+  INIT_STDOUT_LOGGER();
+
+  ConnectionPool pool(2, 0, 10);
+  Peer peer(0x0100007F, 5000);
+
+  int fds[2];
+  BOOST_REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+  pool.Acquire(peer);
+  pool.Release(peer, fds[0], true);
+  BOOST_CHECK_EQUAL(pool.IdleCount(peer), 1);
+
+  pool.CloseExpired();
+  BOOST_CHECK_EQUAL(pool.IdleCount(peer), 0);
+  close(fds[1]);
+}
+
+BOOST_AUTO_TEST_CASE(test_backpressure) {
+  INIT_STDOUT_LOGGER();
+
+  ConnectionPool pool(1, 30, 2000);
+  Peer peer(0x0100007F, 5000);
+
+  pool.Acquire(peer);
+
+  auto start = chrono::steady_clock::now();
+  auto waiter = async(launch::async, [&pool, &peer]() {
+    pool.Acquire(peer);
+    pool.Release(peer, -1, false);
+  });
+
+  this_thread::sleep_for(chrono::milliseconds(200));
+  pool.Release(peer, -1, false);
+  waiter.get();
+
+  auto elapsed = chrono::steady_clock::now() - start;
+  BOOST_CHECK_MESSAGE(elapsed >= chrono::milliseconds(200),
+                      "Second sender should wait for the busy connection!");
+  BOOST_CHECK_MESSAGE(elapsed < chrono::milliseconds(2000),
+                      "Second sender should be woken up on release!");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
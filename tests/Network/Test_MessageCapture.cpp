@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <string>
+
+#include "libNetwork/MessageCapture.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE messagecapture
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(messagecapture)
+
+BOOST_AUTO_TEST_CASE(test_write_and_read_back) {
+  INIT_STDOUT_LOGGER();
+
+  const string path =
+      (boost::filesystem::temp_directory_path() / "Test_MessageCapture.cap")
+          .string();
+  const Peer first(0x0100007F, 4001);
+  const Peer second(0x0200007F, 4002);
+
+  {
+    MessageCaptureWriter writer;
+    BOOST_REQUIRE(writer.Open(path));
+    writer.Record({1, 2, 3}, first);
+    writer.Record({}, second);
+    writer.Record(bytes(1000, 0xAB), first);
+    BOOST_CHECK_EQUAL(writer.GetRecordCount(), 3);
+  }
+
+  MessageCaptureReader reader;
+  BOOST_REQUIRE(reader.Open(path));
+  MessageCapture::Record record;
+
+  BOOST_REQUIRE(reader.Next(record));
+  BOOST_CHECK(record.m_message == bytes({1, 2, 3}));
+  BOOST_CHECK(record.m_from == first);
+  const uint64_t firstOffset = record.m_offsetMicros;
+
+  BOOST_REQUIRE(reader.Next(record));
+  BOOST_CHECK(record.m_message.empty());
+  BOOST_CHECK(record.m_from == second);
+  BOOST_CHECK_GE(record.m_offsetMicros, firstOffset);
+
+  BOOST_REQUIRE(reader.Next(record));
+  BOOST_CHECK(record.m_message == bytes(1000, 0xAB));
+  BOOST_CHECK(!reader.Next(record));
+
+  boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(test_reject_bad_files) {
+  INIT_STDOUT_LOGGER();
+
+  const string path =
+      (boost::filesystem::temp_directory_path() / "Test_MessageCapture.bad")
+          .string();
+
+  // Wrong magic
+  { ofstream(path, ios::binary | ios::trunc) << "NOTACAPTUREFILE"; }
+  MessageCaptureReader notCapture;
+  BOOST_CHECK(!notCapture.Open(path));
+
+  // A record cut short is not returned
+  {
+    MessageCaptureWriter writer;
+    BOOST_REQUIRE(writer.Open(path));
+    writer.Record(bytes(100, 1), Peer(0x0100007F, 4001));
+  }
+  boost::filesystem::resize_file(
+      path, boost::filesystem::file_size(path) - 1);
+  MessageCaptureReader truncated;
+  BOOST_REQUIRE(truncated.Open(path));
+  MessageCapture::Record record;
+  BOOST_CHECK(!truncated.Next(record));
+
+  boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
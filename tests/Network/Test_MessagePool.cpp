@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "libNetwork/MessagePool.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE messagepool
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(messagepool)
+
+BOOST_AUTO_TEST_CASE(test_copy_payload) {
+  INIT_STDOUT_LOGGER();
+
+  const bytes payload{1, 2, 3, 4, 5};
+  const Peer from(0x0100007F, 33133);
+  auto message = MessagePool::GetInstance().Acquire(payload.begin() + 1,
+                                                    payload.end(), from);
+  BOOST_CHECK((message->first == bytes{2, 3, 4, 5}));
+  BOOST_CHECK(message->second == from);
+  MessagePool::GetInstance().Release(message);
+}
+
+BOOST_AUTO_TEST_CASE(test_reuse_on_same_thread) {
+  INIT_STDOUT_LOGGER();
+
+  auto& pool = MessagePool::GetInstance();
+  const Peer from(0x0100007F, 33133);
+  auto first = pool.Acquire(bytes(100, 0xAA), from);
+  const auto capacity = first->first.capacity();
+  BOOST_CHECK_GE(capacity, 256);
+  pool.Release(first);
+
+  // Served from the cache of this thread, without growing the payload
+  auto second = pool.Acquire(bytes(200, 0xBB), from);
+  BOOST_CHECK(second == first);
+  BOOST_CHECK_EQUAL(second->first.capacity(), capacity);
+  BOOST_CHECK((second->first == bytes(200, 0xBB)));
+  pool.Release(second);
+}
+
+BOOST_AUTO_TEST_CASE(test_release_from_other_thread) {
+  INIT_STDOUT_LOGGER();
+
+  auto& pool = MessagePool::GetInstance();
+  const Peer from(0x0100007F, 33133);
+  vector<MessagePool::Message*> messages;
+  for (unsigned int i = 0; i < 64; i++) {
+    messages.push_back(pool.Acquire(bytes(1000, i), from));
+  }
+
+  // Enough to overflow the cache of the releasing thread
+  thread releaser([&]() {
+    for (auto message : messages) {
+      pool.Release(message);
+    }
+  });
+  releaser.join();
+  BOOST_CHECK_GT(pool.GetSharedBytes(), 0);
+
+  const auto sharedBytes = pool.GetSharedBytes();
+  auto message = pool.Acquire(bytes(1000, 0xCC), from);
+  BOOST_CHECK_LT(pool.GetSharedBytes(), sharedBytes);
+  BOOST_CHECK((message->first == bytes(1000, 0xCC)));
+  pool.Release(message);
+}
+
+BOOST_AUTO_TEST_CASE(test_oversize_not_kept) {
+  INIT_STDOUT_LOGGER();
+
+  auto& pool = MessagePool::GetInstance();
+  const Peer from(0x0100007F, 33133);
+  auto message = pool.Acquire(bytes(2 * 1024 * 1024, 0x11), from);
+  BOOST_CHECK_EQUAL(message->first.size(), 2 * 1024 * 1024);
+  pool.Release(message);
+  pool.Release(nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
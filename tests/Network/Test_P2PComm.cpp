@@ -18,7 +18,9 @@
 #include <arpa/inet.h>
 #include <chrono>
 #include <iostream>
+#include <queue>
 #include <vector>
+#include "libNetwork/MessagePool.h"
 #include "libNetwork/P2PComm.h"
 #include "libUtils/DetachedFunction.h"
 
@@ -44,7 +46,7 @@ void process_message(pair<bytes, Peer>* message) {
                                     << " MBps");
   }
 
-  delete message;
+  MessagePool::GetInstance().Release(message);
 }
 
 static bool comparePairSecond(
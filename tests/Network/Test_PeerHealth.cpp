@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+
+#include "libNetwork/PeerHealth.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE peerhealth
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+using Verdict = PeerHealth::Verdict;
+
+BOOST_AUTO_TEST_SUITE(peerhealth)
+
+BOOST_AUTO_TEST_CASE(test_open_and_probe) {
+  INIT_STDOUT_LOGGER();
+
+  PeerHealth health(2, chrono::milliseconds(100), chrono::milliseconds(350));
+  const Peer peer(0x0100007F, 4001);
+  const Peer other(0x0100007F, 4002);
+  const auto start = PeerHealth::Clock::now();
+
+  // One failure is not enough to skip the peer
+  health.Record(peer, false, start);
+  BOOST_CHECK(health.Check(peer, start) == Verdict::SEND);
+  health.Record(peer, false, start);
+  BOOST_CHECK(health.Check(peer, start) == Verdict::SKIP);
+  BOOST_CHECK(health.Check(other, start) == Verdict::SEND);
+  BOOST_CHECK_EQUAL(health.GetDownCount(start), 1);
+
+  // Once the backoff is over, a single probe goes through
+  const auto t1 = start + chrono::milliseconds(100);
+  BOOST_CHECK(health.Check(peer, t1) == Verdict::PROBE);
+  BOOST_CHECK(health.Check(peer, t1) == Verdict::SKIP);
+
+  // A failed probe doubles the backoff
+  health.Record(peer, false, t1);
+  BOOST_CHECK(health.Check(peer, t1 + chrono::milliseconds(150)) ==
+              Verdict::SKIP);
+  const auto t2 = t1 + chrono::milliseconds(200);
+  BOOST_CHECK(health.Check(peer, t2) == Verdict::PROBE);
+
+  // A successful probe closes the breaker
+  health.Record(peer, true, t2);
+  BOOST_CHECK(health.Check(peer, t2) == Verdict::SEND);
+  BOOST_CHECK_EQUAL(health.GetDownCount(t2), 0);
+  BOOST_CHECK_EQUAL(health.GetProbes(), 2);
+  BOOST_CHECK_EQUAL(health.GetSkipped(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_max_backoff) {
+  INIT_STDOUT_LOGGER();
+
+  PeerHealth health(1, chrono::milliseconds(100), chrono::milliseconds(350));
+  const Peer peer(0x0100007F, 4001);
+  auto now = PeerHealth::Clock::now();
+  for (unsigned int i = 0; i < 10; i++) {
+    health.Record(peer, false, now);
+  }
+  BOOST_CHECK(health.Check(peer, now + chrono::milliseconds(349)) ==
+              Verdict::SKIP);
+  BOOST_CHECK(health.Check(peer, now + chrono::milliseconds(350)) ==
+              Verdict::PROBE);
+}
+
+BOOST_AUTO_TEST_CASE(test_disabled) {
+  INIT_STDOUT_LOGGER();
+
+  PeerHealth health(0, chrono::milliseconds(100), chrono::milliseconds(350));
+  const Peer peer(0x0100007F, 4001);
+  for (unsigned int i = 0; i < 10; i++) {
+    health.Record(peer, false);
+  }
+  BOOST_CHECK(health.Check(peer) == Verdict::SEND);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -15,6 +15,7 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include "libNetwork/Blacklist.h"
 #include "libNetwork/ReputationManager.h"
 
 #include "libUtils/IPConverter.h"
@@ -197,4 +198,38 @@ BOOST_AUTO_TEST_CASE(test_rep_underflow) {
   tearDown();
 }
 
+BOOST_AUTO_TEST_CASE(test_lazy_award) {
+  setup();
+  banNode1();
+
+  ReputationManager& rm = ReputationManager::GetInstance();
+  Blacklist::GetInstance().Clear();
+  Blacklist::GetInstance().Add(node1);
+
+  for (int i = 0; i < 1000; i++) {
+    rm.AwardAllNodes();
+  }
+
+  // Node seen for the first time gets none of the earlier awards
+  uint128_t node3;
+  BOOST_CHECK(IPConverter::ToNumericalIPFromStr("10.0.0.1", node3));
+  BOOST_CHECK_EQUAL(rm.GetReputation(node3),
+                    ReputationManager::ScoreType::GOOD);
+
+  BOOST_CHECK_EQUAL(rm.GetReputation(node2),
+                    ReputationManager::ScoreType::UPPERREPTHRESHOLD);
+  BOOST_CHECK_EQUAL(rm.GetReputation(node1),
+                    ReputationManager::ScoreType::UPPERREPTHRESHOLD);
+  BOOST_CHECK_MESSAGE(!Blacklist::GetInstance().Exist(node1),
+                      "Recovered node should be removed from the blacklist");
+
+  rm.AwardAllNodes();
+  BOOST_CHECK_EQUAL(rm.GetReputation(node3),
+                    ReputationManager::ScoreType::GOOD +
+                        ReputationManager::ScoreType::AWARD_FOR_GOOD_NODES);
+
+  Blacklist::GetInstance().Clear();
+  tearDown();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "libNetwork/RumorManager.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE rumormanager
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+using Type = RRS::Message::Type;
+using RawBytes = RumorManager::RawBytes;
+
+static const unsigned int ANY_SIZE = 1000000;
+
+static vector<RumorManager::BatchEntry> MakeEntries() {
+  return {{Type::PUSH, 3, RawBytes(100, 0xAB)},
+          {Type::EMPTY_PULL, 0, {}},
+          {Type::LAZY_PUSH, 7, RawBytes(32, 0x11)},
+          {Type::PULL, 12, {0x01, 0x02, 0x03}}};
+}
+
+static RawBytes MakeBatch(const vector<RumorManager::BatchEntry>& entries) {
+  RawBytes batch;
+  for (const auto& entry : entries) {
+    BOOST_REQUIRE(RumorManager::AppendBatchEntry(
+        batch, entry.m_type, entry.m_rounds, entry.m_payload, ANY_SIZE));
+  }
+  return batch;
+}
+
+BOOST_AUTO_TEST_SUITE(rumormanager)
+
+BOOST_AUTO_TEST_CASE(test_batch_round_trip) {
+  INIT_STDOUT_LOGGER();
+
+  const auto entries = MakeEntries();
+  const RawBytes batch = MakeBatch(entries);
+
+  vector<RumorManager::BatchEntry> parsed;
+  BOOST_REQUIRE(RumorManager::ParseBatch(batch, ANY_SIZE, parsed));
+  BOOST_REQUIRE_EQUAL(parsed.size(), entries.size());
+  for (unsigned int i = 0; i < entries.size(); i++) {
+    BOOST_CHECK(parsed.at(i).m_type == entries.at(i).m_type);
+    BOOST_CHECK_EQUAL(parsed.at(i).m_rounds, entries.at(i).m_rounds);
+    BOOST_CHECK(parsed.at(i).m_payload == entries.at(i).m_payload);
+  }
+
+  // A batch of one message
+  RawBytes single = MakeBatch({entries.front()});
+  BOOST_REQUIRE(RumorManager::ParseBatch(single, ANY_SIZE, parsed));
+  BOOST_REQUIRE_EQUAL(parsed.size(), 1);
+  BOOST_CHECK(parsed.front().m_payload == entries.front().m_payload);
+}
+
+BOOST_AUTO_TEST_CASE(test_batch_size_limit) {
+  INIT_STDOUT_LOGGER();
+
+  const auto entries = MakeEntries();
+  const RawBytes batch = MakeBatch(entries);
+
+  // The batch fills up to the limit, and no further
+  RawBytes limited;
+  for (const auto& entry : entries) {
+    BOOST_REQUIRE(RumorManager::AppendBatchEntry(
+        limited, entry.m_type, entry.m_rounds, entry.m_payload, batch.size()));
+  }
+  BOOST_CHECK(limited == batch);
+  BOOST_CHECK(!RumorManager::AppendBatchEntry(limited, Type::EMPTY_PUSH, 0, {},
+                                              batch.size()));
+  BOOST_CHECK(limited == batch);
+
+  // A message too large for a batch of its own is left out
+  RawBytes empty;
+  BOOST_CHECK(!RumorManager::AppendBatchEntry(empty, Type::PUSH, 1,
+                                              RawBytes(100, 0), 100));
+  BOOST_CHECK(empty.empty());
+
+  // Oversized batches are rejected
+  vector<RumorManager::BatchEntry> parsed;
+  BOOST_CHECK(RumorManager::ParseBatch(batch, batch.size(), parsed));
+  BOOST_CHECK(!RumorManager::ParseBatch(batch, batch.size() - 1, parsed));
+  BOOST_CHECK(parsed.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_malformed_batch) {
+  INIT_STDOUT_LOGGER();
+
+  const RawBytes batch = MakeBatch(MakeEntries());
+  vector<RumorManager::BatchEntry> parsed;
+
+  // Cut anywhere, including within the count
+  for (size_t size = 0; size < batch.size(); size++) {
+    const RawBytes truncated(batch.begin(), batch.begin() + size);
+    BOOST_CHECK_MESSAGE(
+        !RumorManager::ParseBatch(truncated, ANY_SIZE, parsed),
+        "Batch truncated to " << size << " bytes accepted");
+    BOOST_CHECK(parsed.empty());
+  }
+
+  // Bytes past the last entry
+  RawBytes trailing = batch;
+  trailing.push_back(0);
+  BOOST_CHECK(!RumorManager::ParseBatch(trailing, ANY_SIZE, parsed));
+
+  // A count that does not match the entries
+  for (const uint32_t count : {0u, 3u, 5u, 0xFFFFFFFFu}) {
+    RawBytes miscounted = batch;
+    Serializable::SetNumber<uint32_t>(miscounted, 0, count, sizeof(uint32_t));
+    BOOST_CHECK(!RumorManager::ParseBatch(miscounted, ANY_SIZE, parsed));
+  }
+
+  // A length past the end of the batch
+  RawBytes overlong = MakeBatch({{Type::PUSH, 1, {0x01, 0x02}}});
+  Serializable::SetNumber<uint32_t>(overlong, overlong.size() - 2 - 4,
+                                    0xFFFFFFFF, sizeof(uint32_t));
+  BOOST_CHECK(!RumorManager::ParseBatch(overlong, ANY_SIZE, parsed));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
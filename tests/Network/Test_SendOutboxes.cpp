@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "common/Messages.h"
+#include "libNetwork/P2PComm.h"
+#include "libNetwork/SendOutboxes.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE sendoutboxes
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+using Jobs = vector<unique_ptr<SendJob>>;
+
+static const Peer TARGET(0x0100007F, 4001);
+static const uint64_t ANY_SIZE = 1024 * 1024;
+
+// Builds a job whose message is of the class and carries the tag
+static unique_ptr<SendJob> MakeJob(SendClass sendClass, unsigned char tag,
+                                   size_t padding = 0) {
+  bytes message;
+  switch (sendClass) {
+    case SendClass::CONSENSUS:
+      message = {MessageType::NODE, NodeInstructionType::MICROBLOCKCONSENSUS};
+      break;
+    case SendClass::BLOCKS:
+      message = {MessageType::NODE, NodeInstructionType::DSBLOCK};
+      break;
+    case SendClass::GOSSIP:
+      message = {MessageType::PEER, 0xFF};
+      break;
+    case SendClass::BULK:
+      message = {MessageType::NODE, NodeInstructionType::SUBMITTRANSACTION};
+      break;
+  }
+  message.push_back(tag);
+  message.resize(message.size() + padding);
+
+  auto job = make_unique<SendJob>();
+  job->m_peer = TARGET;
+  job->m_frame = make_shared<MessageFrame>(message, START_BYTE_NORMAL, bytes{});
+  BOOST_REQUIRE(job->m_frame->GetSendClass() == sendClass);
+  return job;
+}
+
+static unsigned char GetTag(const SendJob& job) {
+  return job.m_frame->GetBody().at(MessageOffset::BODY);
+}
+
+// Queues the job and checks that it was not dropped
+static bool Queue(SendOutboxes& outboxes, unique_ptr<SendJob> job) {
+  unique_ptr<SendJob> evicted;
+  const bool startDrain = outboxes.Queue(job, evicted);
+  BOOST_REQUIRE(!job && !evicted);
+  return startDrain;
+}
+
+BOOST_AUTO_TEST_SUITE(sendoutboxes)
+
+BOOST_AUTO_TEST_CASE(test_evict_lower_class) {
+  INIT_STDOUT_LOGGER();
+
+  SendOutboxes outboxes(3);
+  EgressShaper unlimited(0, 0);
+  BOOST_CHECK(Queue(outboxes, MakeJob(SendClass::GOSSIP, 1)));
+  BOOST_CHECK(!Queue(outboxes, MakeJob(SendClass::BULK, 2)));
+  BOOST_CHECK(!Queue(outboxes, MakeJob(SendClass::BULK, 3)));
+
+  // The newest job of the lowest class makes room
+  for (const auto& expected : vector<pair<unsigned char, unsigned char>>{
+           {10, 3}, {11, 2}, {12, 1}}) {
+    auto job = MakeJob(SendClass::CONSENSUS, expected.first);
+    unique_ptr<SendJob> evicted;
+    BOOST_CHECK(!outboxes.Queue(job, evicted));
+    BOOST_CHECK(!job);
+    BOOST_REQUIRE(evicted);
+    BOOST_CHECK_EQUAL(GetTag(*evicted), expected.second);
+  }
+
+  // Once only jobs of the same class are left, the new ones are dropped
+  for (const SendClass sendClass : {SendClass::CONSENSUS, SendClass::BULK}) {
+    auto job = MakeJob(sendClass, 13);
+    unique_ptr<SendJob> evicted;
+    BOOST_CHECK(!outboxes.Queue(job, evicted));
+    BOOST_CHECK(job);
+    BOOST_CHECK(!evicted);
+  }
+
+  Jobs jobs;
+  EgressShaper::Clock::duration wait{};
+  outboxes.TakeBatch(TARGET, ANY_SIZE, unlimited, jobs, wait);
+  BOOST_REQUIRE_EQUAL(jobs.size(), 3);
+  for (unsigned int i = 0; i < jobs.size(); ++i) {
+    BOOST_CHECK_EQUAL(GetTag(*jobs[i]), 10 + i);
+  }
+  SendClass nextClass = SendClass::BULK;
+  BOOST_CHECK(!outboxes.Finish(TARGET, jobs, false, nextClass));
+  BOOST_CHECK_EQUAL(outboxes.GetPeerCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_order_within_class) {
+  INIT_STDOUT_LOGGER();
+
+  SendOutboxes outboxes(100);
+  EgressShaper unlimited(0, 0);
+  const SendClass classes[] = {SendClass::BULK, SendClass::GOSSIP,
+                               SendClass::CONSENSUS, SendClass::BLOCKS};
+  vector<vector<unsigned char>> queued(NUM_SEND_CLASSES);
+  for (unsigned char tag = 0; tag < 40; ++tag) {
+    const SendClass sendClass = classes[(tag * 7) % 4];
+    queued[static_cast<unsigned int>(sendClass)].push_back(tag);
+    BOOST_CHECK_EQUAL(Queue(outboxes, MakeJob(sendClass, tag)), tag == 0);
+  }
+
+  // One job per batch, the highest class first and each in queued order
+  vector<unsigned char> expected;
+  for (const auto& tags : queued) {
+    expected.insert(expected.end(), tags.begin(), tags.end());
+  }
+  vector<unsigned char> sent;
+  bool more = true;
+  while (more) {
+    Jobs jobs;
+    EgressShaper::Clock::duration wait{};
+    outboxes.TakeBatch(TARGET, 1, unlimited, jobs, wait);
+    BOOST_REQUIRE_EQUAL(jobs.size(), 1);
+    sent.push_back(GetTag(*jobs.front()));
+    SendClass nextClass = SendClass::BULK;
+    more = outboxes.Finish(TARGET, jobs, false, nextClass);
+    BOOST_CHECK(jobs.empty());
+  }
+  BOOST_CHECK(sent == expected);
+}
+
+BOOST_AUTO_TEST_CASE(test_one_drain_while_throttled) {
+  INIT_STDOUT_LOGGER();
+
+  SendOutboxes outboxes(100);
+  // Lets the first bulk job through, and then no more during the test
+  EgressShaper shaper(1, 100);
+  unsigned int drains = 0;
+  auto schedule = [&drains](bool startDrain) {
+    drains += startDrain ? 1 : 0;
+    BOOST_REQUIRE_LE(drains, 1);
+  };
+  auto drain = [&](unsigned int expected) {
+    BOOST_REQUIRE_EQUAL(drains, 1);
+    Jobs jobs;
+    EgressShaper::Clock::duration wait{};
+    outboxes.TakeBatch(TARGET, ANY_SIZE, shaper, jobs, wait);
+    BOOST_CHECK_EQUAL(jobs.size(), expected);
+    --drains;
+    if (jobs.empty()) {
+      BOOST_CHECK(wait > EgressShaper::Clock::duration::zero());
+      return;
+    }
+    SendClass nextClass = SendClass::BULK;
+    schedule(outboxes.Finish(TARGET, jobs, false, nextClass));
+  };
+
+  schedule(Queue(outboxes, MakeJob(SendClass::BULK, 1, 60)));
+  schedule(Queue(outboxes, MakeJob(SendClass::BULK, 2, 60)));
+  drain(1);
+  drain(0);
+  BOOST_CHECK_EQUAL(outboxes.GetThrottledCount(), 1);
+
+  // Bulk jobs wait for the shaper, a consensus one resumes the drain
+  schedule(Queue(outboxes, MakeJob(SendClass::BULK, 3)));
+  BOOST_CHECK_EQUAL(drains, 0);
+  schedule(Queue(outboxes, MakeJob(SendClass::CONSENSUS, 4)));
+  BOOST_CHECK_EQUAL(drains, 1);
+  BOOST_CHECK_EQUAL(outboxes.GetThrottledCount(), 0);
+
+  // The timer of the shaper finds the drain resumed already
+  SendClass nextClass = SendClass::CONSENSUS;
+  schedule(outboxes.Resume(TARGET, nextClass));
+  drain(1);
+  drain(0);
+
+  schedule(outboxes.Resume(TARGET, nextClass));
+  BOOST_CHECK(nextClass == SendClass::BULK);
+  schedule(outboxes.Resume(TARGET, nextClass));
+  schedule(Queue(outboxes, MakeJob(SendClass::CONSENSUS, 5)));
+  BOOST_CHECK_EQUAL(drains, 1);
+  BOOST_CHECK_EQUAL(outboxes.GetPeerCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_counters_add_up) {
+  INIT_STDOUT_LOGGER();
+
+  SendOutboxes outboxes(8);
+  EgressShaper unlimited(0, 0);
+  vector<uint64_t> attempts(NUM_SEND_CLASSES, 0);
+  vector<uint64_t> rejected(NUM_SEND_CLASSES, 0);
+  uint64_t queuedBytes = 0;
+
+  // Jobs taken by a drain are neither waiting nor sent until it finishes
+  auto check = [&](const Jobs& taken) {
+    vector<uint64_t> counted(NUM_SEND_CLASSES, 0);
+    uint64_t bytes = 0;
+    for (const auto& job : taken) {
+      ++counted[static_cast<unsigned int>(job->m_frame->GetSendClass())];
+      bytes += job->m_frame->GetSize();
+    }
+    for (unsigned int c = 0; c < NUM_SEND_CLASSES; ++c) {
+      const auto& stats = outboxes.GetStats(c);
+      BOOST_CHECK_EQUAL(counted[c] + stats.m_waiting.load() +
+                            stats.m_sent.load() + stats.m_dropped.load(),
+                        attempts[c]);
+      bytes += stats.m_waitingBytes.load();
+    }
+    BOOST_CHECK_EQUAL(outboxes.GetBytes(), bytes);
+  };
+
+  const SendClass classes[] = {SendClass::BULK, SendClass::CONSENSUS,
+                               SendClass::GOSSIP, SendClass::BULK,
+                               SendClass::BLOCKS};
+  bool blocked = false;
+  for (unsigned char tag = 0; tag < 60; ++tag) {
+    const SendClass sendClass = classes[tag % 5];
+    auto job = MakeJob(sendClass, tag, tag);
+    const uint64_t bytes = job->m_frame->GetSize();
+    unique_ptr<SendJob> evicted;
+    outboxes.Queue(job, evicted);
+    ++attempts[static_cast<unsigned int>(sendClass)];
+    if (job) {
+      ++rejected[static_cast<unsigned int>(sendClass)];
+    } else {
+      queuedBytes += bytes;
+    }
+    check({});
+
+    // Drains now and then, blocking every other batch
+    if (tag % 6 == 5) {
+      Jobs jobs;
+      EgressShaper::Clock::duration wait{};
+      outboxes.TakeBatch(TARGET, 200, unlimited, jobs, wait);
+      BOOST_CHECK(!jobs.empty());
+      check(jobs);
+      SendClass nextClass = SendClass::BULK;
+      outboxes.Finish(TARGET, jobs, blocked, nextClass);
+      blocked = !blocked;
+      check({});
+    }
+  }
+  BOOST_CHECK(queuedBytes > outboxes.GetBytes());
+  BOOST_CHECK(rejected[static_cast<unsigned int>(SendClass::BULK)] > 0);
+
+  SendClass nextClass = SendClass::BULK;
+  while (outboxes.GetPeerCount() > 0) {
+    Jobs jobs;
+    EgressShaper::Clock::duration wait{};
+    outboxes.TakeBatch(TARGET, ANY_SIZE, unlimited, jobs, wait);
+    outboxes.Finish(TARGET, jobs, false, nextClass);
+  }
+  check({});
+  for (unsigned int c = 0; c < NUM_SEND_CLASSES; ++c) {
+    BOOST_CHECK_EQUAL(outboxes.GetStats(c).m_waiting.load(), 0);
+    BOOST_CHECK(outboxes.GetStats(c).m_dropped.load() >= rejected[c]);
+  }
+  BOOST_CHECK_EQUAL(outboxes.GetBytes(), 0);
+  BOOST_CHECK_EQUAL(outboxes.GetPeerCount(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "libNetwork/SignatureBatchVerifier.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE signaturebatchverifier
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+// Messages starting with 0x01 carry a "valid" signature
+bool FakeVerify(const bytes& message, [[gnu::unused]] const Signature& sig,
+                [[gnu::unused]] const PubKey& key) {
+  this_thread::sleep_for(chrono::milliseconds(1));
+  return !message.empty() && message.front() == 0x01;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(signaturebatchverifier)
+
+BOOST_AUTO_TEST_CASE(test_results_in_order) {
+  INIT_STDOUT_LOGGER();
+
+  const unsigned int numJobs = 200;
+  mutex m;
+  vector<pair<unsigned int, bool>> results;
+
+  {
+    SignatureBatchVerifier verifier(4, 32, 5, FakeVerify);
+    for (unsigned int i = 0; i < numJobs; i++) {
+      const bytes message = {(unsigned char)(i % 3 == 0 ? 0x00 : 0x01)};
+      BOOST_REQUIRE(verifier.Submit(message, Signature(), PubKey(),
+                                    [&m, &results, i](bool result) {
+                                      lock_guard<mutex> g(m);
+                                      results.emplace_back(i, result);
+                                    }));
+    }
+
+    for (unsigned int t = 0; t < 100; t++) {
+      {
+        lock_guard<mutex> g(m);
+        if (results.size() == numJobs) {
+          break;
+        }
+      }
+      this_thread::sleep_for(chrono::milliseconds(50));
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(results.size(), numJobs);
+  for (unsigned int i = 0; i < numJobs; i++) {
+    BOOST_CHECK_EQUAL(results[i].first, i);
+    BOOST_CHECK_EQUAL(results[i].second, i % 3 != 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_queue_full) {
+  INIT_STDOUT_LOGGER();
+
+  atomic<unsigned int> done{0};
+  SignatureBatchVerifier verifier(
+      1, 1, 0,
+      [](const bytes&, const Signature&, const PubKey&) {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        return true;
+      });
+
+  unsigned int accepted = 0;
+  for (unsigned int i = 0; i < 200; i++) {
+    if (verifier.Submit({}, Signature(), PubKey(),
+                        [&done](bool) { done++; })) {
+      accepted++;
+    }
+  }
+
+  BOOST_CHECK_MESSAGE(accepted < 200, "Queue should be bounded!");
+  BOOST_CHECK_GT(accepted, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+
+#include "common/Messages.h"
+#include "libNetwork/EgressShaper.h"
+#include "libNetwork/TrafficStats.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE trafficstats
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(trafficstats)
+
+BOOST_AUTO_TEST_CASE(test_record_and_reset) {
+  INIT_STDOUT_LOGGER();
+
+  auto& stats = TrafficStats::GetInstance();
+  const uint128_t ip = 0x0100007F;
+  const string& node = TrafficStats::GetTypeName(MessageType::NODE);
+  stats.Record(true, ip, node, 100);
+  stats.Record(true, ip, node, 50);
+  stats.Record(false, ip, TrafficStats::GOSSIP_TYPE, 30);
+
+  const auto peer = stats.GetPeer(ip);
+  BOOST_CHECK_EQUAL(peer.m_sent.m_bytes, 150);
+  BOOST_CHECK_EQUAL(peer.m_sent.m_messages, 2);
+  BOOST_CHECK_EQUAL(peer.m_received.m_bytes, 30);
+  BOOST_CHECK_EQUAL(stats.GetType(node).m_sent.m_messages, 2);
+  BOOST_CHECK_EQUAL(stats.GetType(node).m_received.m_messages, 0);
+
+  stats.LogAndReset(7);
+  BOOST_CHECK_EQUAL(stats.GetPeer(ip).m_sent.m_bytes, 0);
+  const auto json = stats.GetStats();
+  BOOST_CHECK_EQUAL(json["previous_epoch"].asUInt64(), 7);
+  BOOST_CHECK_EQUAL(json["previous"]["total"]["sent"]["bytes"].asUInt64(),
+                    150);
+  BOOST_CHECK_EQUAL(
+      json["previous"]["types"]["GOSSIP"]["received"]["messages"].asUInt64(),
+      1);
+}
+
+BOOST_AUTO_TEST_CASE(test_type_names) {
+  INIT_STDOUT_LOGGER();
+
+  BOOST_CHECK_EQUAL(TrafficStats::GetTypeName(MessageType::LOOKUP), "LOOKUP");
+  BOOST_CHECK_EQUAL(TrafficStats::GetTypeName(0xFF), "UNKNOWN");
+}
+
+BOOST_AUTO_TEST_CASE(test_shaper) {
+  INIT_STDOUT_LOGGER();
+
+  const auto start = EgressShaper::Clock::now();
+  EgressShaper::Clock::duration wait{};
+
+  EgressShaper unlimited(0, 10);
+  BOOST_CHECK(unlimited.TryTake(1 << 20, wait, start));
+
+  // 1000 bytes per second, 500 at once
+  EgressShaper shaper(1000, 500);
+  BOOST_CHECK(shaper.TryTake(400, wait, start));
+  BOOST_CHECK(!shaper.TryTake(400, wait, start));
+  BOOST_CHECK_EQUAL(shaper.GetThrottled(), 1);
+  BOOST_CHECK(wait > chrono::milliseconds(250) &&
+              wait <= chrono::milliseconds(300));
+  BOOST_CHECK(shaper.TryTake(400, wait, start + chrono::milliseconds(310)));
+
+  // A message above the burst leaves once the bucket is full, then the debt
+  // holds back the next one
+  const auto later = start + chrono::seconds(10);
+  BOOST_CHECK(shaper.TryTake(1500, wait, later));
+  BOOST_CHECK(!shaper.TryTake(1, wait, later + chrono::milliseconds(500)));
+  BOOST_CHECK(shaper.TryTake(1, wait, later + chrono::milliseconds(1010)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// PoW benchmark, for sizing mining hardware and spotting driver or kernel
+/// regressions. It reports
+/// - the raw light and full ethash hashrate on a number of threads, with the
+///   time taken to create each context,
+/// - the time to the first solution and the mean time per solution of
+///   POW::PoWMine at a low difficulty, with the hashrate they imply, for the
+///   backend set in constants.xml (light and full dataset for the CPU),
+/// - the POW::PoWVerify throughput on 1 up to the given number of threads,
+///   as seen by the DS committee while it receives submissions.
+///
+/// The GetWork and remote backends need their miners or mining proxy to be
+/// running.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "libPOW/pow.h"
+#include "libServer/GetWorkServer.h"
+#include "libUtils/Histogram.h"
+#include "libUtils/Logger.h"
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+
+namespace po = boost::program_options;
+using namespace std;
+
+namespace {
+using Clock = chrono::steady_clock;
+
+struct Options {
+  uint64_t blockNum{0};
+  unsigned int difficulty{8};
+  unsigned int iterations{5};
+  unsigned int seconds{3};
+  unsigned int threads{max(thread::hardware_concurrency(), 1u)};
+  unsigned int verifies{1000};
+  int timeWindow{60};
+  bool noFull{false};
+};
+
+double SecondsSince(const Clock::time_point& start) {
+  return chrono::duration<double>(Clock::now() - start).count();
+}
+
+string FormatSeconds(double seconds) {
+  ostringstream oss;
+  oss << fixed << setprecision(2) << seconds << "s";
+  return oss.str();
+}
+
+ethash_hash256 MakeHeaderHash(uint64_t seed) {
+  ethash_hash256 headerHash{};
+  for (unsigned int i = 0; i < sizeof(seed); i++) {
+    headerHash.bytes[i] = static_cast<uint8_t>(seed >> (8 * i));
+  }
+  return headerHash;
+}
+
+/// Hashes expected per solution under boundary
+double ExpectedHashes(const ethash_hash256& boundary) {
+  double value = 0;
+  for (const auto byte : boundary.bytes) {
+    value = value * 256 + byte;
+  }
+  return value > 0 ? pow(2.0, 256) / value : 0;
+}
+
+void PrintRow(const string& stage, const string& setup, double rate,
+              const string& unit) {
+  cout << left << setw(36) << stage << right << setw(14) << setup << fixed
+       << setprecision(1) << setw(16) << rate << " " << unit << endl;
+}
+
+/// Runs hash on threads threads for seconds and returns the hashes per second
+template <class F>
+double MeasureHashRate(unsigned int threads, unsigned int seconds, F hash) {
+  atomic<bool> running{true};
+  atomic<uint64_t> totalHashes{0};
+  vector<thread> workers;
+  const auto start = Clock::now();
+  for (unsigned int i = 0; i < threads; i++) {
+    workers.emplace_back([&, i]() {
+      const auto headerHash = MakeHeaderHash(i);
+      uint64_t nonce = 0;
+      while (running) {
+        hash(headerHash, nonce++);
+      }
+      totalHashes += nonce;
+    });
+  }
+  this_thread::sleep_for(chrono::seconds(seconds));
+  running = false;
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  return totalHashes / SecondsSince(start);
+}
+
+void BenchRawHash(const Options& options) {
+  const int epoch = ethash::get_epoch_number(options.blockNum);
+
+  auto start = Clock::now();
+  const auto light = ethash::create_epoch_context(epoch);
+  string setup = FormatSeconds(SecondsSince(start));
+  PrintRow("light hash x" + to_string(options.threads), setup,
+           MeasureHashRate(options.threads, options.seconds,
+                           [&](const ethash_hash256& headerHash,
+                               uint64_t nonce) {
+                             ethash::hash(*light, headerHash, nonce);
+                           }),
+           "H/s");
+
+  if (options.noFull) {
+    return;
+  }
+
+  // The dataset is filled on first use, so the second run is the steady one
+  start = Clock::now();
+  const auto full = ethash::create_epoch_context_full(epoch);
+  setup = FormatSeconds(SecondsSince(start));
+  for (const char* pass : {"cold", "warm"}) {
+    PrintRow("full hash x" + to_string(options.threads) + " " + pass, setup,
+             MeasureHashRate(options.threads, options.seconds,
+                             [&](const ethash_hash256& headerHash,
+                                 uint64_t nonce) {
+                               ethash::hash(*full, headerHash, nonce);
+                             }),
+             "H/s");
+  }
+}
+
+string GetBackendName() {
+  if (REMOTE_MINE) {
+    return "remote";
+  }
+  if (GETWORK_SERVER_MINE) {
+    return "getwork";
+  }
+  if (OPENCL_GPU_MINE && CUDA_GPU_MINE) {
+    return "CUDA+OpenCL";
+  }
+  if (OPENCL_GPU_MINE) {
+    return "OpenCL";
+  }
+  if (CUDA_GPU_MINE) {
+    return "CUDA";
+  }
+  return "CPU";
+}
+
+bool BenchPoWMine(const Options& options, bool fullDataset) {
+  auto& pow = POW::GetInstance();
+  PairOfKey keyPair;
+  keyPair.first = PrivKey();
+  keyPair.second = PubKey(keyPair.first);
+  const auto boundary = POW::DifficultyLevelInIntDevided(options.difficulty);
+
+  string stage = "PoWMine " + GetBackendName();
+  if (GetBackendName() == "CPU") {
+    stage += fullDataset ? " full" : " light";
+  }
+
+  Histogram latencyUs;
+  double firstSeconds = 0;
+  for (unsigned int i = 0; i < options.iterations; i++) {
+    const auto start = Clock::now();
+    const auto result =
+        pow.PoWMine(options.blockNum, options.difficulty, keyPair,
+                    MakeHeaderHash(i + 1000), fullDataset, 0,
+                    options.timeWindow);
+    const double seconds = SecondsSince(start);
+    if (!result.success) {
+      cerr << "ERROR: " << stage << " found no solution" << endl;
+      return false;
+    }
+    if (i == 0) {
+      // Includes creating the context of the epoch
+      firstSeconds = seconds;
+    }
+    latencyUs.Record(static_cast<uint64_t>(seconds * 1e6));
+  }
+
+  const double meanSeconds = latencyUs.GetMean() / 1e6;
+  PrintRow(stage, "1st " + FormatSeconds(firstSeconds),
+           meanSeconds > 0 ? ExpectedHashes(boundary) / meanSeconds : 0,
+           "H/s est, " + FormatSeconds(meanSeconds) + " per solution");
+  return true;
+}
+
+bool BenchPoWVerify(const Options& options) {
+  auto& pow = POW::GetInstance();
+  const auto boundary = POW::DifficultyLevelInIntDevided(options.difficulty);
+  const auto light = ethash::create_epoch_context(
+      ethash::get_epoch_number(options.blockNum));
+
+  // Solutions found here, as the mining backend may not be the CPU
+  struct Submission {
+    ethash_hash256 m_headerHash;
+    uint64_t m_nonce;
+    string m_result;
+    string m_mixHash;
+  };
+  vector<Submission> submissions;
+  for (unsigned int i = 0; submissions.size() < 16; i++) {
+    const auto headerHash = MakeHeaderHash(i + 2000);
+    for (uint64_t nonce = 0;; nonce++) {
+      const auto result = ethash::hash(*light, headerHash, nonce);
+      if (ethash::is_less_or_equal(result.final_hash, boundary)) {
+        submissions.push_back({headerHash, nonce,
+                               POW::BlockhashToHexString(result.final_hash),
+                               POW::BlockhashToHexString(result.mix_hash)});
+        break;
+      }
+    }
+  }
+
+  for (unsigned int threads = 1; threads <= options.threads; threads *= 2) {
+    atomic<unsigned int> next{0};
+    atomic<bool> failed{false};
+    vector<thread> workers;
+    const auto start = Clock::now();
+    for (unsigned int i = 0; i < threads; i++) {
+      workers.emplace_back([&]() {
+        for (unsigned int n = next++; n < options.verifies; n = next++) {
+          const auto& submission = submissions[n % submissions.size()];
+          if (!pow.PoWVerify(options.blockNum, options.difficulty,
+                             submission.m_headerHash, submission.m_nonce,
+                             submission.m_result, submission.m_mixHash)) {
+            failed = true;
+          }
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    if (failed) {
+      cerr << "ERROR: PoWVerify rejected a valid solution" << endl;
+      return false;
+    }
+    PrintRow("PoWVerify x" + to_string(threads), "",
+             options.verifies / SecondsSince(start), "verifies/s");
+  }
+  return true;
+}
+
+bool Run(const Options& options) {
+  cout << left << setw(36) << "stage" << right << setw(14) << "setup"
+       << setw(16) << "rate" << endl;
+
+  BenchRawHash(options);
+
+  if (GETWORK_SERVER_MINE && !GetWorkServer::GetInstance().StartServer()) {
+    cerr << "ERROR: GetWork server failed to start" << endl;
+    return false;
+  }
+  if (!BenchPoWMine(options, false)) {
+    return false;
+  }
+  if (GetBackendName() == "CPU" && !options.noFull &&
+      !BenchPoWMine(options, true)) {
+    return false;
+  }
+
+  return BenchPoWVerify(options);
+}
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  try {
+    Options options;
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "blocknum,b", po::value<uint64_t>(&options.blockNum),
+        "Block number, which sets the epoch (default 0)")(
+        "difficulty,d", po::value<unsigned int>(&options.difficulty),
+        "Difficulty of the PoWs mined and verified (default 8)")(
+        "iterations,n", po::value<unsigned int>(&options.iterations),
+        "PoWs mined per backend (default 5)")(
+        "seconds,s", po::value<unsigned int>(&options.seconds),
+        "Seconds each raw hashrate is measured for (default 3)")(
+        "threads,t", po::value<unsigned int>(&options.threads),
+        "Threads of the raw hashes and most PoWVerify threads (default all "
+        "cores)")("verifies,v", po::value<unsigned int>(&options.verifies),
+                  "PoWVerify calls per thread count (default 1000)")(
+        "timewindow,w", po::value<int>(&options.timeWindow),
+        "Seconds a PoWMine may take (default 60)")(
+        "nofull", po::bool_switch(&options.noFull),
+        "Skip the full dataset, which takes over 1 GB");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help")) {
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      po::notify(vm);
+    } catch (boost::program_options::error& e) {
+      cerr << "ERROR: " << e.what() << endl << endl;
+      cout << desc;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    if (options.iterations == 0 || options.threads == 0 ||
+        options.difficulty > 32) {
+      cerr << "ERROR: iterations and threads must be positive and "
+              "difficulty at most 32"
+           << endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    INIT_FILE_LOGGER("powbench", ".");
+
+    if (!Run(options)) {
+      return ERROR_UNHANDLED_EXCEPTION;
+    }
+  } catch (exception& e) {
+    cerr << "Unhandled Exception reached the top of main: " << e.what()
+         << ", application will now exit" << endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+
+  return SUCCESS;
+}
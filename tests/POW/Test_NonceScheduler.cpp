@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "libPOW/NonceScheduler.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE noncescheduler
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(noncescheduler)
+
+BOOST_AUTO_TEST_CASE(test_ranges_follow_hashrate) {
+  INIT_STDOUT_LOGGER();
+
+  NonceScheduler scheduler(2, chrono::milliseconds(500), 1000);
+  uint64_t start = 0, size = 0;
+  BOOST_CHECK(!scheduler.NextRange(0, 0, start, size));
+
+  scheduler.Start(100);
+  BOOST_REQUIRE(scheduler.NextRange(0, 0, start, size));
+  BOOST_CHECK_EQUAL(start, 100);
+  BOOST_CHECK_EQUAL(size, 1000);
+  BOOST_REQUIRE(scheduler.NextRange(1, 0, start, size));
+  BOOST_CHECK_EQUAL(start, 1100);
+
+  // Device 0 is four times as fast as device 1
+  scheduler.AddHashes(0, 4000, chrono::seconds(1));
+  scheduler.AddHashes(1, 1000, chrono::seconds(1));
+  BOOST_CHECK_EQUAL(scheduler.GetHashRate(0), 4000);
+  BOOST_CHECK_EQUAL(scheduler.GetHashRate(1), 1000);
+
+  BOOST_REQUIRE(scheduler.NextRange(0, 0, start, size));
+  BOOST_CHECK_EQUAL(start, 2100);
+  BOOST_CHECK_EQUAL(size, 2000);
+  BOOST_REQUIRE(scheduler.NextRange(1, 0, start, size));
+  BOOST_CHECK_EQUAL(start, 4100);
+  BOOST_CHECK_EQUAL(size, 500);
+
+  // A range always fits a whole batch
+  BOOST_REQUIRE(scheduler.NextRange(1, 800, start, size));
+  BOOST_CHECK_EQUAL(size, 800);
+
+  BOOST_CHECK(!scheduler.NextRange(2, 0, start, size));
+}
+
+BOOST_AUTO_TEST_CASE(test_first_solution_stops) {
+  INIT_STDOUT_LOGGER();
+
+  NonceScheduler scheduler(2, chrono::milliseconds(500));
+  scheduler.Start(0);
+  BOOST_CHECK(!scheduler.IsStopped());
+
+  BOOST_CHECK(scheduler.Solve());
+  BOOST_CHECK(!scheduler.Solve());
+  BOOST_CHECK(scheduler.IsStopped());
+
+  uint64_t start = 0, size = 0;
+  BOOST_CHECK(!scheduler.NextRange(0, 0, start, size));
+
+  // The next PoW starts over but keeps the hashrates
+  scheduler.AddHashes(0, 1000, chrono::seconds(1));
+  scheduler.Start(0);
+  BOOST_CHECK_EQUAL(scheduler.GetHashRate(0), 1000);
+  BOOST_REQUIRE(scheduler.NextRange(0, 0, start, size));
+  BOOST_CHECK_EQUAL(size, 500);
+  scheduler.Stop();
+  BOOST_CHECK(scheduler.Solve());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -309,6 +309,53 @@ BOOST_AUTO_TEST_CASE(mining_and_verification) {
   BOOST_REQUIRE(!verifyWinningNonce);
 }
 
+BOOST_AUTO_TEST_CASE(batch_verification) {
+  POW& POWClient = POW::GetInstance();
+  std::array<unsigned char, 32> rand1 = {{'0', '4'}};
+  std::array<unsigned char, 32> rand2 = {{'0', '5'}};
+  auto peer = TestUtils::GenerateRandomPeer();
+  auto keyPair = Schnorr::GenKeyPair();
+
+  uint8_t difficultyToUse = 5;
+  uint64_t blockToUse = 0;
+  auto headerHash =
+      POW::GenHeaderHash(rand1, rand2, peer, keyPair.second, 0, 0);
+  ethash_mining_result_t winning_result =
+      POWClient.PoWMine(blockToUse, difficultyToUse, keyPair, headerHash, false,
+                        std::time(0), POW_WINDOW_IN_SECONDS);
+  BOOST_REQUIRE(winning_result.success);
+
+  BOOST_REQUIRE(POWClient.PoWVerify(
+      blockToUse, POW::GetBoundary(difficultyToUse), headerHash,
+      winning_result.winning_nonce, winning_result.result,
+      winning_result.mix_hash));
+
+  PoWVerifyRequest request;
+  request.difficulty = difficultyToUse;
+  request.headerHash = headerHash;
+  request.nonce = winning_result.winning_nonce;
+  request.result = winning_result.result;
+  request.mixHash = winning_result.mix_hash;
+  std::vector<PoWVerifyRequest> requests{request, request, request};
+  requests[1].mixHash[0] = requests[1].mixHash[0] == '0' ? '1' : '0';
+  requests[2].difficulty = 30;
+
+  const auto verified = POWClient.PoWVerifyBatch(blockToUse, requests, 2);
+  BOOST_REQUIRE_EQUAL(verified.size(), requests.size());
+  BOOST_CHECK(verified[0]);
+  BOOST_CHECK(!verified[1]);
+  BOOST_CHECK(!verified[2]);
+
+  // Verifying again gives the same answers from the cache
+  BOOST_CHECK(POWClient.PoWVerify(blockToUse, difficultyToUse, headerHash,
+                                  winning_result.winning_nonce,
+                                  winning_result.result,
+                                  winning_result.mix_hash));
+  BOOST_CHECK(!POWClient.PoWVerify(blockToUse, difficultyToUse, headerHash,
+                                   winning_result.winning_nonce,
+                                   winning_result.result, requests[1].mixHash));
+}
+
 BOOST_AUTO_TEST_CASE(mining_and_verification_big_block_number) {
   POW& POWClient = POW::GetInstance();
   std::array<unsigned char, 32> rand1 = {{'0', '1'}};
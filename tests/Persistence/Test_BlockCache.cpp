@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <string>
+
+#include "libPersistence/BlockCache.h"
+
+#define BOOST_TEST_MODULE blockcachetest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(blockcachetest)
+
+BOOST_AUTO_TEST_CASE(testEviction) {
+  // Room for exactly two entries of 100 serialized bytes
+  BlockCache<uint64_t, string> cache(2 * (2 * 100 + 128));
+  shared_ptr<string> block;
+
+  cache.Insert(1, make_shared<string>("one"), 100);
+  cache.Insert(2, make_shared<string>("two"), 100);
+  BOOST_REQUIRE(cache.Lookup(1, block));
+  BOOST_CHECK_EQUAL(*block, "one");
+
+  // 2 is now the least recently used
+  cache.Insert(3, make_shared<string>("three"), 100);
+  BOOST_CHECK(!cache.Lookup(2, block));
+  BOOST_CHECK(cache.Lookup(1, block));
+  BOOST_CHECK(cache.Lookup(3, block));
+
+  BOOST_CHECK_EQUAL(cache.GetHits(), 3);
+  BOOST_CHECK_EQUAL(cache.GetMisses(), 1);
+  BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 2 * (2 * 100 + 128));
+}
+
+BOOST_AUTO_TEST_CASE(testEraseAndReplace) {
+  BlockCache<uint64_t, string> cache(1024 * 1024);
+  shared_ptr<string> block;
+
+  cache.Insert(1, make_shared<string>("old"), 10);
+  cache.Insert(1, make_shared<string>("new"), 10);
+  BOOST_REQUIRE(cache.Lookup(1, block));
+  BOOST_CHECK_EQUAL(*block, "new");
+  BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 2 * 10 + 128);
+
+  cache.Erase(1);
+  BOOST_CHECK(!cache.Lookup(1, block));
+  BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 0);
+
+  cache.Insert(2, make_shared<string>("two"), 10);
+  cache.Clear();
+  BOOST_CHECK(!cache.Lookup(2, block));
+}
+
+BOOST_AUTO_TEST_CASE(testDisabled) {
+  BlockCache<uint64_t, string> cache(0);
+  shared_ptr<string> block;
+
+  cache.Insert(1, make_shared<string>("one"), 10);
+  BOOST_CHECK(!cache.Lookup(1, block));
+  BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <vector>
+
+#include "libPersistence/ContractStateHashTree.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE contractstatehashtree
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace Contract;
+
+namespace {
+string MakeKey(unsigned int i) {
+  return "0123456789abcdef0123456789abcdef01234567.balances.[" +
+         to_string(i) + "].";
+}
+
+bytes MakeValue(unsigned int i) {
+  const string value = "\"" + to_string(i * 7) + "\"";
+  return bytes(value.begin(), value.end());
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(contractstatehashtree)
+
+BOOST_AUTO_TEST_CASE(test_order_independent) {
+  INIT_STDOUT_LOGGER();
+
+  ContractStateHashTree empty;
+  ContractStateHashTree forward;
+  ContractStateHashTree backward;
+  const dev::h256 emptyHash = empty.GetRootHash();
+
+  for (unsigned int i = 0; i < 2000; i++) {
+    forward.Set(MakeKey(i), MakeValue(i));
+    backward.Set(MakeKey(1999 - i), MakeValue(1999 - i));
+  }
+  BOOST_CHECK_EQUAL(forward.Size(), 2000);
+  BOOST_CHECK_EQUAL(forward.GetRootHash(), backward.GetRootHash());
+  BOOST_CHECK(forward.GetRootHash() != emptyHash);
+
+  // Overwriting with the same value keeps the hash
+  const dev::h256 hash = forward.GetRootHash();
+  forward.Set(MakeKey(10), MakeValue(10));
+  BOOST_CHECK_EQUAL(forward.GetRootHash(), hash);
+  forward.Set(MakeKey(10), MakeValue(11));
+  BOOST_CHECK(forward.GetRootHash() != hash);
+
+  for (unsigned int i = 0; i < 2000; i++) {
+    forward.Erase(MakeKey(i));
+  }
+  BOOST_CHECK_EQUAL(forward.Size(), 0);
+  BOOST_CHECK_EQUAL(forward.GetRootHash(), emptyHash);
+}
+
+BOOST_AUTO_TEST_CASE(test_changes_match_updates) {
+  INIT_STDOUT_LOGGER();
+
+  ContractStateHashTree tree;
+  for (unsigned int i = 0; i < 1000; i++) {
+    tree.Set(MakeKey(i), MakeValue(i));
+  }
+  const dev::h256 before = tree.GetRootHash();
+
+  const bytes newValue = MakeValue(5000);
+  ContractStateHashTree::Changes changes;
+  changes[MakeKey(3)] = &newValue;
+  changes[MakeKey(1500)] = &newValue;
+  changes[MakeKey(7)] = nullptr;
+  changes[MakeKey(2000)] = nullptr;
+  const dev::h256 withChanges = tree.GetRootHash(changes);
+
+  // The tree itself is left as it is
+  BOOST_CHECK_EQUAL(tree.GetRootHash(), before);
+  BOOST_CHECK(withChanges != before);
+
+  tree.Set(MakeKey(3), newValue);
+  tree.Set(MakeKey(1500), newValue);
+  tree.Erase(MakeKey(7));
+  tree.Erase(MakeKey(2000));
+  BOOST_CHECK_EQUAL(tree.GetRootHash(), withChanges);
+  BOOST_CHECK_EQUAL(tree.GetRootHash({}), withChanges);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
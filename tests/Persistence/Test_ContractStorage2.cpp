@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#include "libPersistence/ScillaMessage.pb.h"
+#pragma GCC diagnostic pop
+#include "libPersistence/ContractStorage2.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE contractstorage2
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace Contract;
+
+namespace {
+const vector<string> NO_INDICES;
+
+ContractStorage2& Storage() { return ContractStorage2::GetContractStorage(); }
+
+bytes ToBytes(const string& s) { return bytes(s.begin(), s.end()); }
+
+bytes Query(const string& name, unsigned int mapDepth,
+            const vector<string>& indices, bool ignoreVal = false) {
+  ProtoScillaQuery query;
+  query.set_name(name);
+  query.set_mapdepth(mapDepth);
+  for (const auto& index : indices) {
+    query.add_indices(index);
+  }
+  query.set_ignoreval(ignoreVal);
+  return ToBytes(query.SerializeAsString());
+}
+
+void Set(const dev::h160& addr, const string& name, unsigned int mapDepth,
+         const vector<string>& indices, const ProtoScillaVal& value) {
+  BOOST_CHECK(Storage().UpdateStateValue(addr, Query(name, mapDepth, indices),
+                                         0,
+                                         ToBytes(value.SerializeAsString()), 0));
+}
+
+void Set(const dev::h160& addr, const string& name, unsigned int mapDepth,
+         const vector<string>& indices, const string& bval) {
+  ProtoScillaVal value;
+  value.set_bval(bval);
+  Set(addr, name, mapDepth, indices, value);
+}
+
+void Delete(const dev::h160& addr, const string& name, unsigned int mapDepth,
+            const vector<string>& indices) {
+  BOOST_CHECK(Storage().UpdateStateValue(
+      addr, Query(name, mapDepth, indices, true), 0,
+      ToBytes(ProtoScillaVal().SerializeAsString()), 0));
+}
+
+/// Flattens a fetched value, as the entries of a map come in any order
+void Flatten(const ProtoScillaVal& value, const string& path,
+             map<string, string>& flat) {
+  if (!value.has_mval()) {
+    flat[path] = value.bval();
+    return;
+  }
+  if (value.mval().m().empty()) {
+    flat[path] = "{}";
+  }
+  for (const auto& entry : value.mval().m()) {
+    Flatten(entry.second, path + "/" + entry.first, flat);
+  }
+}
+
+const map<string, string> NOT_FOUND{{"", "-"}};
+
+/// Result of FetchStateValue, NOT_FOUND if nothing was found, or "!" if it
+/// failed
+map<string, string> Fetch(const dev::h160& addr, const string& name,
+                          unsigned int mapDepth,
+                          const vector<string>& indices) {
+  map<string, string> flat;
+  bytes dst;
+  bool found = false;
+  if (!Storage().FetchStateValue(addr, Query(name, mapDepth, indices), 0, dst,
+                                 0, found)) {
+    flat[""] = "!";
+    return flat;
+  }
+  if (!found) {
+    return NOT_FOUND;
+  }
+  ProtoScillaVal value;
+  BOOST_CHECK(value.ParseFromArray(dst.data(), dst.size()));
+  Flatten(value, "", flat);
+  return flat;
+}
+
+/// Contract with a value foo and a map m of depth 2, committed to the DB
+void SeedContract(const dev::h160& addr) {
+  Storage().Reset();
+  map<string, bytes> states;
+  states[Storage().GenerateStorageKey(addr, "foo", {})] = ToBytes("1");
+  for (const char* outer : {"a", "b"}) {
+    for (const char* inner : {"x", "y"}) {
+      states[Storage().GenerateStorageKey(addr, "m", {outer, inner})] =
+          ToBytes(string(outer) + inner);
+    }
+  }
+  dev::h256 stateHash;
+  Storage().UpdateStateDatasAndToDeletes(addr, states, {}, stateHash, false,
+                                         false);
+  BOOST_CHECK(Storage().CommitStateDB());
+  Storage().InitTempState(true);
+}
+
+/// What a contract call can see of the temp state of the contract
+struct TempView {
+  vector<map<string, string>> m_fetched;
+  map<string, bytes> m_states;
+  dev::h256 m_hash;
+
+  bool operator==(const TempView& other) const {
+    return m_fetched == other.m_fetched && m_states == other.m_states &&
+           m_hash == other.m_hash;
+  }
+};
+
+TempView View(const dev::h160& addr) {
+  TempView view;
+  view.m_fetched.emplace_back(Fetch(addr, "foo", 0, NO_INDICES));
+  view.m_fetched.emplace_back(Fetch(addr, "m", 2, NO_INDICES));
+  for (const char* outer : {"a", "b", "c"}) {
+    view.m_fetched.emplace_back(Fetch(addr, "m", 2, {outer}));
+    for (const char* inner : {"x", "y", "z"}) {
+      view.m_fetched.emplace_back(Fetch(addr, "m", 2, {outer, inner}));
+    }
+  }
+  Storage().FetchStateDataForContract(view.m_states, addr, "", {}, true);
+  view.m_hash = Storage().GetContractStateHash(addr, true, true);
+  return view;
+}
+
+/// Sets, deletes and replaces entries, some of them by prefix
+void ChangeContract(const dev::h160& addr) {
+  Set(addr, "foo", 0, NO_INDICES, "2");
+  Set(addr, "m", 2, {"b", "z"}, "bz");
+  Delete(addr, "m", 2, {"a", "x"});
+  ProtoScillaVal replacement;
+  (*replacement.mutable_mval()->mutable_m())["w"].set_bval("aw");
+  Set(addr, "m", 2, {"a"}, replacement);
+  Delete(addr, "m", 2, {"b"});
+}
+
+ProtoScillaVal MapOf(const map<string, string>& entries) {
+  ProtoScillaVal value;
+  auto& m = *value.mutable_mval()->mutable_m();
+  for (const auto& entry : entries) {
+    m[entry.first].set_bval(entry.second);
+  }
+  return value;
+}
+
+/// Deletes and sets parts of m by prefix, with and without reverts, and
+/// returns what is read of it along the way. If listDeletions, the entries
+/// deleted by a prefix are listed one by one after each change, as they
+/// were before the prefix tombstones.
+vector<TempView> DeleteByPrefixes(const dev::h160& addr, bool listDeletions) {
+  SeedContract(addr);
+  vector<TempView> views;
+  // The state hash and the state delta list the deletions, so they are only
+  // taken at the end
+  auto step = [&](const function<void()>& change) {
+    change();
+    if (listDeletions) {
+      map<string, bytes> states;
+      vector<string> toDeletes;
+      Storage().FetchUpdatedStateValuesForAddress(addr, states, toDeletes,
+                                                  true);
+    }
+    TempView view;
+    view.m_fetched.emplace_back(Fetch(addr, "m", 2, NO_INDICES));
+    for (const char* outer : {"a", "b", "c"}) {
+      view.m_fetched.emplace_back(Fetch(addr, "m", 2, {outer}));
+      for (const char* inner : {"q", "x", "y"}) {
+        view.m_fetched.emplace_back(Fetch(addr, "m", 2, {outer, inner}));
+      }
+      Storage().FetchStateDataForKey(
+          view.m_states, Storage().GenerateStorageKey(addr, "m", {outer}),
+          true);
+    }
+    views.emplace_back(move(view));
+  };
+
+  // Only in the DB, then set again under the deleted prefix
+  step([&]() { Delete(addr, "m", 2, {"a"}); });
+  step([&]() { Set(addr, "m", 2, {"a", "x"}, "again"); });
+  // A prefix over the one of m[a]
+  step([&]() { Set(addr, "m", 2, NO_INDICES, MapOf({})); });
+  step([&]() {
+    ProtoScillaVal value;
+    (*value.mutable_mval()->mutable_m())["b"] = MapOf({{"q", "bq"}});
+    Set(addr, "m", 2, NO_INDICES, value);
+  });
+
+  // A reverted call
+  step([&]() {
+    Storage().BufferCurrentState(addr);
+    Delete(addr, "m", 2, {"b"});
+    Set(addr, "m", 2, {"c", "x"}, "cx");
+  });
+  step([&]() { Storage().RevertPrevState(addr); });
+
+  // A session rolled back, and one kept
+  step([&]() {
+    Storage().BeginTempSession({addr});
+    Storage().BufferCurrentState(addr);
+    Delete(addr, "m", 2, {"b", "q"});
+    Set(addr, "m", 2, {"a"}, MapOf({{"y", "ay"}}));
+  });
+  step([&]() { Storage().EndTempSession(addr, true); });
+  step([&]() {
+    Storage().BeginTempSession({addr});
+    Storage().BufferCurrentState(addr);
+    Set(addr, "m", 2, {"a"}, MapOf({{"x", "ax"}, {"y", "ay"}}));
+    Delete(addr, "m", 2, {"b"});
+    Storage().EndTempSession(addr, false);
+  });
+
+  TempView last = View(addr);
+  map<string, bytes> delta;
+  vector<string> toDeletes;
+  Storage().FetchUpdatedStateValuesForAddress(addr, delta, toDeletes, true);
+  sort(toDeletes.begin(), toDeletes.end());
+  for (const auto& index : toDeletes) {
+    last.m_states["deleted " + index] = {};
+  }
+  for (const auto& state : delta) {
+    last.m_states["delta " + state.first] = state.second;
+  }
+  views.emplace_back(move(last));
+  return views;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(contractstorage2)
+
+BOOST_AUTO_TEST_CASE(test_revert_prev_state) {
+  INIT_STDOUT_LOGGER();
+
+  const dev::h160 addr("0x1000000000000000000000000000000000000001");
+  SeedContract(addr);
+
+  // Changes made before the buffer stay
+  Set(addr, "foo", 0, NO_INDICES, "3");
+  const TempView before = View(addr);
+
+  Storage().BufferCurrentState(addr);
+  ChangeContract(addr);
+  BOOST_CHECK(!(View(addr) == before));
+  Storage().RevertPrevState(addr);
+
+  // The values come back, but the deletions of the call are kept
+  BOOST_CHECK(View(addr).m_fetched[0] == before.m_fetched[0]);
+  BOOST_CHECK(Fetch(addr, "m", 2, {"a", "x"}) == NOT_FOUND);
+  BOOST_CHECK(Fetch(addr, "m", 2, {"b", "y"}) == NOT_FOUND);
+}
+
+BOOST_AUTO_TEST_CASE(test_end_temp_session_reverts_all) {
+  INIT_STDOUT_LOGGER();
+
+  const dev::h160 addr("0x1000000000000000000000000000000000000002");
+  SeedContract(addr);
+  const TempView before = View(addr);
+
+  // A session rolled back undoes the deletions too, even after the call
+  // reverted itself
+  for (bool revertCall : {false, true}) {
+    Storage().BeginTempSession({addr});
+    Storage().BufferCurrentState(addr);
+    ChangeContract(addr);
+    if (revertCall) {
+      Storage().RevertPrevState(addr);
+    }
+    Storage().EndTempSession(addr, true);
+    BOOST_CHECK(View(addr) == before);
+  }
+
+  // A session kept keeps its changes
+  Storage().BeginTempSession({addr});
+  Storage().BufferCurrentState(addr);
+  ChangeContract(addr);
+  const TempView changed = View(addr);
+  Storage().EndTempSession(addr, false);
+  BOOST_CHECK(View(addr) == changed);
+  BOOST_CHECK(!(changed == before));
+}
+
+BOOST_AUTO_TEST_CASE(test_prefix_deletions_match_listed_ones) {
+  INIT_STDOUT_LOGGER();
+
+  const dev::h160 addr("0x1000000000000000000000000000000000000003");
+  const vector<TempView> byPrefix = DeleteByPrefixes(addr, false);
+  const vector<TempView> listed = DeleteByPrefixes(addr, true);
+
+  BOOST_REQUIRE_EQUAL(byPrefix.size(), listed.size());
+  for (unsigned int i = 0; i < byPrefix.size(); i++) {
+    BOOST_CHECK_MESSAGE(byPrefix[i] == listed[i], "step " << i);
+  }
+
+  // The deletions did take effect
+  BOOST_CHECK(byPrefix[0].m_fetched[1] == NOT_FOUND);
+  BOOST_CHECK(byPrefix[1].m_fetched[3] == (map<string, string>{{"", "again"}}));
+  BOOST_CHECK(byPrefix.back().m_fetched[1] ==
+              (map<string, string>{{"/a/x", "ax"}, {"/a/y", "ay"}}));
+}
+
+BOOST_AUTO_TEST_CASE(test_prefix_deletion_committed) {
+  INIT_STDOUT_LOGGER();
+
+  // The entries a prefix deleted are gone from the DB once committed
+  const dev::h160 addr("0x1000000000000000000000000000000000000004");
+  SeedContract(addr);
+  Delete(addr, "m", 2, {"a"});
+  const dev::h256 tempHash = Storage().GetContractStateHash(addr, true, true);
+
+  map<string, bytes> states;
+  vector<string> toDeletes;
+  Storage().FetchUpdatedStateValuesForAddress(addr, states, toDeletes, true);
+  BOOST_CHECK_EQUAL(toDeletes.size(), 2);
+  dev::h256 stateHash;
+  Storage().UpdateStateDatasAndToDeletes(addr, states, toDeletes, stateHash,
+                                         false, false);
+  BOOST_CHECK(Storage().CommitStateDB());
+
+  BOOST_CHECK_EQUAL(Storage().GetContractStateHash(addr, false, true),
+                    tempHash);
+  BOOST_CHECK(Fetch(addr, "m", 2, {"a", "x"}) == NOT_FOUND);
+  BOOST_CHECK(Fetch(addr, "m", 2, {"b", "x"}) ==
+              (map<string, string>{{"", "bx"}}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -227,4 +227,101 @@ BOOST_AUTO_TEST_CASE(testDiagnosticDataCoinbase) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(testDiagnosticDataEpochPerf) {
+  INIT_STDOUT_LOGGER();
+
+  // Clear the database first
+  BlockStorage::GetBlockStorage().ResetDB(
+      BlockStorage::DBTYPE::DIAGNOSTIC_EPOCH_PERF);
+
+  vector<DiagnosticDataEpochPerf> histEntries;
+
+  const unsigned int NUM_ENTRIES = 15;
+
+  // Test writing and looking up all entries
+  for (unsigned int i = 0; i < NUM_ENTRIES; i++) {
+    DiagnosticDataEpochPerf entry = {
+        i / 5,
+        TestUtils::DistUint64(),
+        TestUtils::DistUint64(),
+        TestUtils::DistUint64(),
+        TestUtils::DistUint64(),
+        TestUtils::DistUint64(),
+        TestUtils::DistUint64(),
+        TestUtils::DistUint32(),
+        TestUtils::DistUint64()};
+    histEntries.emplace_back(entry);
+
+    BOOST_CHECK(BlockStorage::GetBlockStorage().PutDiagnosticDataEpochPerf(
+        i, histEntries.back()));
+  }
+
+  // Look-up by epoch number
+  for (unsigned int i = 0; i < NUM_ENTRIES; i++) {
+    DiagnosticDataEpochPerf entryDeserialized;
+
+    BOOST_CHECK(BlockStorage::GetBlockStorage().GetDiagnosticDataEpochPerf(
+        i, entryDeserialized));
+
+    BOOST_CHECK(entryDeserialized == histEntries.at(i));
+  }
+
+  // Look-up by dumping all contents
+  map<uint64_t, DiagnosticDataEpochPerf> diagnosticDataMap;
+  BlockStorage::GetBlockStorage().GetDiagnosticDataEpochPerf(
+      diagnosticDataMap);
+  BOOST_CHECK_EQUAL(diagnosticDataMap.size(), NUM_ENTRIES);
+  for (unsigned int i = 0; i < NUM_ENTRIES; i++) {
+    BOOST_CHECK(diagnosticDataMap.count(i) == 1);
+    BOOST_CHECK(diagnosticDataMap[i] == histEntries.at(i));
+  }
+
+  // Test deletion of entries
+  for (unsigned int i = 0; i < NUM_ENTRIES; i++) {
+    BOOST_CHECK(
+        BlockStorage::GetBlockStorage().GetDiagnosticDataEpochPerfCount() ==
+        (NUM_ENTRIES - i));
+
+    BOOST_CHECK(
+        BlockStorage::GetBlockStorage().DeleteDiagnosticDataEpochPerf(i));
+
+    DiagnosticDataEpochPerf entryDeserialized;
+    BOOST_CHECK(BlockStorage::GetBlockStorage().GetDiagnosticDataEpochPerf(
+                    i, entryDeserialized) == false);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testEpochPerfRecord) {
+  INIT_STDOUT_LOGGER();
+
+  EpochPerf& perf = EpochPerf::GetInstance();
+  perf.TakeRecord(0);
+
+  perf.Add(EpochPerf::POW, 10);
+  perf.Add(EpochPerf::POW, 5);
+  perf.Add(EpochPerf::COMMIT, 7);
+  perf.AddTxns(3);
+  perf.AddBytesSent(100);
+  perf.Begin(EpochPerf::FINAL_BLOCK_CONSENSUS);
+
+  DiagnosticDataEpochPerf record = perf.TakeRecord(2);
+  BOOST_CHECK_EQUAL(record.dsBlockNum, 2);
+  BOOST_CHECK_EQUAL(record.powTime, 15);
+  BOOST_CHECK_EQUAL(record.commitTime, 7);
+  BOOST_CHECK_EQUAL(record.txnCount, 3);
+  BOOST_CHECK_EQUAL(record.bytesSent, 100);
+  BOOST_CHECK_EQUAL(record.finalBlockConsensusTime, 0);
+
+  // The phase left running is counted in the epoch it ends in
+  perf.End(EpochPerf::FINAL_BLOCK_CONSENSUS);
+  record = perf.TakeRecord(2);
+  BOOST_CHECK_EQUAL(record.powTime, 0);
+  BOOST_CHECK_EQUAL(record.txnCount, 0);
+  BOOST_CHECK_EQUAL(record.bytesSent, 0);
+
+  // Ending a phase that was not begun adds nothing
+  perf.End(EpochPerf::FINAL_BLOCK_CONSENSUS);
+  BOOST_CHECK_EQUAL(perf.TakeRecord(2).finalBlockConsensusTime, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
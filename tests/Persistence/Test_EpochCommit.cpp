@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <list>
+
+#include "libPersistence/BlockStorage.h"
+#include "libTestUtils/TestUtils.h"
+
+#define BOOST_TEST_MODULE epochcommittest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(epochcommittest)
+
+BOOST_AUTO_TEST_CASE(testCommitEpoch) {
+  INIT_STDOUT_LOGGER();
+
+  auto& storage = BlockStorage::GetBlockStorage();
+  storage.ResetDB(BlockStorage::META);
+  storage.ResetDB(BlockStorage::MICROBLOCK);
+  storage.ResetDB(BlockStorage::STATE_DELTA);
+
+  MicroBlockHeader header(2, 1, 1, 1, 7, MicroBlockHashSet(), 0,
+                          TestUtils::GenerateRandomPubKey(), 1, 1,
+                          CommitteeHash(), BlockHash());
+  const MicroBlock microBlock(header, {}, CoSignatures());
+  bytes body;
+  BOOST_REQUIRE(microBlock.Serialize(body, 0));
+  const bytes stateDelta = {1, 2, 3};
+
+  EpochCommit epochCommit;
+  BOOST_CHECK(epochCommit.Empty());
+  epochCommit.PutMicroBlock(microBlock.GetBlockHash(), body);
+  epochCommit.PutStateDelta(7, stateDelta);
+  epochCommit.PutEpochFin(8);
+  BOOST_CHECK(!epochCommit.Empty());
+
+  // Nothing lands before the commit
+  bytes read;
+  BOOST_CHECK(!storage.GetStateDelta(7, read));
+
+  BOOST_REQUIRE(storage.CommitEpoch(epochCommit));
+
+  BOOST_CHECK(storage.GetStateDelta(7, read));
+  BOOST_CHECK(read == stateDelta);
+
+  uint64_t epochFin = 0;
+  BOOST_CHECK(storage.GetEpochFin(epochFin));
+  BOOST_CHECK_EQUAL(epochFin, 8);
+
+  MicroBlockSharedPtr readBlock;
+  BOOST_CHECK(storage.GetMicroBlock(microBlock.GetBlockHash(), readBlock));
+  BOOST_CHECK(*readBlock == microBlock);
+
+  // The microblock index is kept in step
+  list<MicroBlockSharedPtr> blocks;
+  BOOST_CHECK(storage.GetRangeMicroBlocks(7, 7, 2, 2, blocks));
+  BOOST_CHECK_EQUAL(blocks.size(), 1);
+
+  // The journal is cleared once applied
+  BOOST_CHECK(storage.RecoverEpochCommit());
+  BOOST_CHECK(storage.CommitEpoch(EpochCommit()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
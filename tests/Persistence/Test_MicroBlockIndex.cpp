@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <list>
+#include <set>
+#include <utility>
+
+#include "libPersistence/BlockStorage.h"
+#include "libTestUtils/TestUtils.h"
+
+#define BOOST_TEST_MODULE microblockindextest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+MicroBlock MakeMicroBlock(const uint64_t& epochNum, const uint32_t& shardId) {
+  MicroBlockHeader header(shardId, 1, 1, 1, epochNum, MicroBlockHashSet(), 0,
+                          TestUtils::GenerateRandomPubKey(), 1, 1,
+                          CommitteeHash(), BlockHash());
+  return MicroBlock(header, {}, CoSignatures());
+}
+
+void PutMicroBlock(const MicroBlock& microBlock) {
+  bytes body;
+  BOOST_REQUIRE(microBlock.Serialize(body, 0));
+  BOOST_REQUIRE(BlockStorage::GetBlockStorage().PutMicroBlock(
+      microBlock.GetBlockHash(), body));
+}
+
+set<pair<uint64_t, uint32_t>> GetRange(const uint64_t& lowEpochNum,
+                                       const uint64_t& hiEpochNum,
+                                       const uint32_t& loShardId,
+                                       const uint32_t& hiShardId) {
+  list<MicroBlockSharedPtr> blocks;
+  BlockStorage::GetBlockStorage().GetRangeMicroBlocks(
+      lowEpochNum, hiEpochNum, loShardId, hiShardId, blocks);
+  set<pair<uint64_t, uint32_t>> ret;
+  for (const auto& block : blocks) {
+    ret.emplace(block->GetHeader().GetEpochNum(),
+                block->GetHeader().GetShardId());
+  }
+  BOOST_CHECK_EQUAL(ret.size(), blocks.size());
+  return ret;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(microblockindextest)
+
+BOOST_AUTO_TEST_CASE(testGetRangeMicroBlocks) {
+  INIT_STDOUT_LOGGER();
+
+  BlockStorage::GetBlockStorage().ResetDB(BlockStorage::MICROBLOCK);
+
+  for (uint64_t epochNum = 1; epochNum <= 5; epochNum++) {
+    for (uint32_t shardId = 0; shardId <= 3; shardId++) {
+      PutMicroBlock(MakeMicroBlock(epochNum, shardId));
+    }
+  }
+  // Epochs past 2^8 and 2^32 must still order after the small ones
+  PutMicroBlock(MakeMicroBlock(0x100, 1));
+  PutMicroBlock(MakeMicroBlock(0x100000000, 1));
+
+  set<pair<uint64_t, uint32_t>> expected = {{2, 1}, {2, 2}, {3, 1},
+                                            {3, 2}, {4, 1}, {4, 2}};
+  BOOST_CHECK(GetRange(2, 4, 1, 2) == expected);
+
+  expected = {{5, 1}, {0x100, 1}, {0x100000000, 1}};
+  BOOST_CHECK(GetRange(5, 0x100000000, 1, 1) == expected);
+
+  BOOST_CHECK(GetRange(6, 0xff, 0, 3).empty());
+  BOOST_CHECK(GetRange(4, 2, 0, 3).empty());
+
+  const MicroBlock deleted = MakeMicroBlock(3, 2);
+  PutMicroBlock(deleted);
+  BOOST_CHECK_EQUAL(GetRange(3, 3, 2, 2).size(), 2);
+  BOOST_CHECK(
+      BlockStorage::GetBlockStorage().DeleteMicroBlock(deleted.GetBlockHash()));
+  BOOST_CHECK_EQUAL(GetRange(3, 3, 2, 2).size(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "depends/libDatabase/LevelDB.h"
+#include "libPersistence/Snapshot.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE snapshottest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const string TEST_DIR = "snapshotTest";
+const string SOURCE_DIR = TEST_DIR + "/source";
+const string SNAPSHOT_DIR = TEST_DIR + "/snapshot";
+const string TARGET_DIR = TEST_DIR + "/target";
+const unsigned int NUM_ENTRIES = 1000;
+
+void FillDatabases() {
+  boost::filesystem::remove_all(TEST_DIR);
+  boost::filesystem::create_directories(SOURCE_DIR);
+
+  LevelDB blocks("blocks", SOURCE_DIR, (string) "");
+  LevelDB state("state", SOURCE_DIR, (string) "sub");
+  for (unsigned int i = 0; i < NUM_ENTRIES; i++) {
+    const string key = to_string(i);
+    BOOST_REQUIRE_EQUAL(blocks.Insert(leveldb::Slice(key),
+                                      leveldb::Slice("block" + key)),
+                        0);
+    BOOST_REQUIRE_EQUAL(state.Insert(leveldb::Slice(key),
+                                     leveldb::Slice(string(i % 64, 's'))),
+                        0);
+  }
+  ofstream(SOURCE_DIR + "/blocks/MARKER") << "1";
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(snapshottest)
+
+BOOST_AUTO_TEST_CASE(testExportImport) {
+  INIT_STDOUT_LOGGER();
+
+  FillDatabases();
+  BOOST_REQUIRE(Snapshot::Export(SOURCE_DIR, SNAPSHOT_DIR));
+  BOOST_REQUIRE(Snapshot::Verify(SNAPSHOT_DIR));
+  BOOST_REQUIRE(Snapshot::Import(SNAPSHOT_DIR, TARGET_DIR));
+
+  {
+    LevelDB blocks("blocks", TARGET_DIR, (string) "");
+    LevelDB state("state", TARGET_DIR, (string) "sub");
+    for (unsigned int i = 0; i < NUM_ENTRIES; i++) {
+      const string key = to_string(i);
+      BOOST_CHECK_EQUAL(blocks.Lookup(key), "block" + key);
+      BOOST_CHECK_EQUAL(state.Lookup(key), string(i % 64, 's'));
+    }
+  }
+  string marker;
+  ifstream(TARGET_DIR + "/blocks/MARKER") >> marker;
+  BOOST_CHECK_EQUAL(marker, "1");
+
+  // Existing databases are never overwritten
+  BOOST_CHECK(!Snapshot::Import(SNAPSHOT_DIR, TARGET_DIR));
+}
+
+BOOST_AUTO_TEST_CASE(testCorruptedChunk) {
+  INIT_STDOUT_LOGGER();
+
+  FillDatabases();
+  BOOST_REQUIRE(Snapshot::Export(SOURCE_DIR, SNAPSHOT_DIR));
+
+  {
+    fstream chunk(SNAPSHOT_DIR + "/sub/state/00000000.chunk",
+                  ios::binary | ios::in | ios::out);
+    BOOST_REQUIRE(chunk);
+    chunk.seekp(10);
+    chunk.put('x');
+  }
+
+  BOOST_CHECK(!Snapshot::Verify(SNAPSHOT_DIR));
+  BOOST_CHECK(!Snapshot::Import(SNAPSHOT_DIR, TARGET_DIR));
+  BOOST_CHECK(!boost::filesystem::exists(TARGET_DIR + "/blocks"));
+  BOOST_CHECK(!boost::filesystem::exists(TARGET_DIR + "/sub/state"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+
+#include "libPersistence/StorageKeyBuilder.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE storagekeybuilder
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace Contract;
+
+namespace {
+// The concatenation GenerateStorageKey used before the builder
+string ConcatKey(const dev::h160& addr, const string& vname,
+                 const vector<string>& indices) {
+  string ret = addr.hex();
+  if (!vname.empty()) {
+    ret += SCILLA_INDEX_SEPARATOR + vname + SCILLA_INDEX_SEPARATOR;
+    for (const auto& index : indices) {
+      ret += index + SCILLA_INDEX_SEPARATOR;
+    }
+  }
+  return ret;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(storagekeybuilder)
+
+BOOST_AUTO_TEST_CASE(test_same_as_concatenation) {
+  INIT_STDOUT_LOGGER();
+
+  const dev::h160 addr("0x0123456789abcdef0123456789ABCDEF01234567");
+  const vector<string> indices = {"\"0x1234\"", "", "key"};
+
+  StorageKeyBuilder builder(addr);
+  BOOST_CHECK_EQUAL(builder.Key(), ConcatKey(addr, "", {}));
+
+  builder.AppendField("balances");
+  BOOST_CHECK_EQUAL(builder.Key(), ConcatKey(addr, "balances", {}));
+
+  for (size_t i = 0; i < indices.size(); i++) {
+    builder.AppendIndex(indices[i]);
+    BOOST_CHECK_EQUAL(builder.Key(),
+                      ConcatKey(addr, "balances",
+                                vector<string>(indices.begin(),
+                                               indices.begin() + i + 1)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_truncate_and_reset) {
+  INIT_STDOUT_LOGGER();
+
+  const dev::h160 addr1("0x1111111111111111111111111111111111111111");
+  const dev::h160 addr2("0x2222222222222222222222222222222222222222");
+
+  StorageKeyBuilder builder(addr1);
+  builder.AppendField("map");
+  const size_t prefixSize = builder.Size();
+  for (const string index : {"a", "bb", "ccc"}) {
+    builder.Truncate(prefixSize);
+    builder.AppendIndex(index);
+    BOOST_CHECK_EQUAL(builder.Key(), ConcatKey(addr1, "map", {index}));
+  }
+
+  builder.Reset(addr2);
+  builder.AppendField("field");
+  BOOST_CHECK_EQUAL(builder.Key(), ConcatKey(addr2, "field", {}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
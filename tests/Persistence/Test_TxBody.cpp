@@ -16,7 +16,9 @@
  */
 
 #include <Schnorr.h>
+#include <algorithm>
 #include <array>
+#include <list>
 #include <string>
 #include <vector>
 #include "common/Constants.h"
@@ -110,6 +112,67 @@ BOOST_AUTO_TEST_CASE(testBlockStorage) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(testEnqueueTxBody) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+  if (LOOKUP_NODE_MODE) {
+    TransactionWithReceipt body1 = constructDummyTxBody(5);
+    auto tx_hash = body1.GetTransaction().GetTranID();
+
+    bytes serializedTxBody;
+    body1.Serialize(serializedTxBody, 0);
+    BOOST_CHECK(BlockStorage::GetBlockStorage().EnqueueTxBody(
+        tx_hash, serializedTxBody));
+
+    // Readable whether or not it has been written yet
+    TxBodySharedPtr body2;
+    BOOST_CHECK(BlockStorage::GetBlockStorage().GetTxBody(tx_hash, body2));
+    BOOST_CHECK(body2->GetTransaction().GetTranID() == tx_hash);
+
+    BlockStorage::GetBlockStorage().FlushTxBodies();
+    list<TxnHash> tmpHashes;
+    BOOST_CHECK(BlockStorage::GetBlockStorage().GetAllTxBodiesTmp(tmpHashes));
+    BOOST_CHECK(find(tmpHashes.begin(), tmpHashes.end(), tx_hash) !=
+                tmpHashes.end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testPendingTxns) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  auto& storage = BlockStorage::GetBlockStorage();
+  const auto txn1 = constructDummyTxBody(1).GetTransaction();
+  const auto txn2 = constructDummyTxBody(2).GetTransaction();
+  const auto txn3 = constructDummyTxBody(3).GetTransaction();
+  BOOST_CHECK(storage.RewritePendingTxns({}));
+  BOOST_CHECK(storage.PutPendingTxns({txn1, txn2}, 1));
+  BOOST_CHECK(storage.PutPendingTxns({txn3}, 2));
+
+  vector<pair<uint32_t, Transaction>> pending;
+  BOOST_CHECK(storage.GetAllPendingTxns(pending));
+  BOOST_REQUIRE_EQUAL(pending.size(), 3);
+  for (const auto& entry : pending) {
+    const auto& hash = entry.second.GetTranID();
+    BOOST_CHECK_EQUAL(entry.first, hash == txn3.GetTranID() ? 2 : 1);
+    BOOST_CHECK(hash == txn1.GetTranID() || hash == txn2.GetTranID() ||
+                hash == txn3.GetTranID());
+  }
+
+  // Only the rewritten ones are left
+  BOOST_CHECK(storage.RewritePendingTxns({{3, txn2}}));
+  pending.clear();
+  BOOST_CHECK(storage.GetAllPendingTxns(pending));
+  BOOST_REQUIRE_EQUAL(pending.size(), 1);
+  BOOST_CHECK_EQUAL(pending.at(0).first, 3);
+  BOOST_CHECK(pending.at(0).second.GetTranID() == txn2.GetTranID());
+  BOOST_CHECK(pending.at(0).second.GetSignature() == txn2.GetSignature());
+
+  BOOST_CHECK(storage.ResetDB(BlockStorage::PENDING_TXN));
+}
+
 BOOST_AUTO_TEST_CASE(testTRDeserializationFromFile) {
   INIT_STDOUT_LOGGER();
 
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "libPersistence/TxBodyArchive.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE txbodyarchivetest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(txbodyarchivetest)
+
+BOOST_AUTO_TEST_CASE(testAppendAndGet) {
+  INIT_STDOUT_LOGGER();
+
+  TxBodyArchive archive("txBodyArchiveTest");
+  BOOST_REQUIRE(archive.Reset());
+  BOOST_CHECK_EQUAL(archive.GetNextEpoch(), 0);
+
+  // A body that compresses and one that does not
+  const dev::h256 hash1(1);
+  const dev::h256 hash2(2);
+  const bytes body1(1000, 'a');
+  const bytes body2 = {1, 2, 3};
+  BOOST_REQUIRE(archive.Append(0, {{hash1, body1}}));
+  BOOST_REQUIRE(archive.Append(0, {{hash2, body2}}));
+  BOOST_REQUIRE(archive.PutNextEpoch(5));
+
+  bytes body;
+  BOOST_REQUIRE(archive.Get(hash1, body));
+  BOOST_CHECK(body == body1);
+  BOOST_REQUIRE(archive.Get(hash2, body));
+  BOOST_CHECK(body == body2);
+  BOOST_CHECK(archive.Exists(hash1));
+  BOOST_CHECK(!archive.Exists(dev::h256(3)));
+  BOOST_CHECK(!archive.Get(dev::h256(3), body));
+  BOOST_CHECK_EQUAL(archive.GetNextEpoch(), 5);
+
+  BOOST_REQUIRE(archive.Reset());
+  BOOST_CHECK(!archive.Exists(hash1));
+  BOOST_CHECK_EQUAL(archive.GetNextEpoch(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
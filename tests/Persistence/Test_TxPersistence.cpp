@@ -327,4 +327,40 @@ BOOST_AUTO_TEST_CASE(testRetrieveAllTheTxBlocksInDB) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(testGetRangeTxBlocks) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  BOOST_REQUIRE(
+      BlockStorage::GetBlockStorage().ResetDB(BlockStorage::DBTYPE::TX_BLOCK));
+  // Block 6 is missing
+  for (uint64_t blockNum : {1, 2, 3, 4, 5, 7}) {
+    bytes serializedTxBlock;
+    constructDummyTxBlock(blockNum).Serialize(serializedTxBlock, 0);
+    BlockStorage::GetBlockStorage().PutTxBlock(blockNum, serializedTxBlock);
+  }
+  // Cached blocks and blocks read from the db are returned alike
+  TxBlockSharedPtr cached;
+  BOOST_REQUIRE(BlockStorage::GetBlockStorage().GetTxBlock(2, cached));
+
+  auto getRange = [](uint64_t lowBlockNum, uint64_t hiBlockNum) {
+    vector<TxBlockSharedPtr> blocks;
+    vector<uint64_t> blockNums;
+    if (BlockStorage::GetBlockStorage().GetRangeTxBlocks(
+            lowBlockNum, hiBlockNum, blocks)) {
+      for (const auto& block : blocks) {
+        blockNums.emplace_back(block->GetHeader().GetBlockNum());
+      }
+    }
+    return blockNums;
+  };
+
+  BOOST_CHECK(getRange(2, 4) == vector<uint64_t>({2, 3, 4}));
+  BOOST_CHECK(getRange(1, 1) == vector<uint64_t>({1}));
+  BOOST_CHECK(getRange(4, 10) == vector<uint64_t>({4, 5}));
+  BOOST_CHECK(getRange(6, 7).empty());
+  BOOST_CHECK(getRange(4, 2).empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "libPersistence/BlockStorage.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE txncountindextest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(txncountindextest)
+
+BOOST_AUTO_TEST_CASE(testTxnCounts) {
+  INIT_STDOUT_LOGGER();
+
+  auto& storage = BlockStorage::GetBlockStorage();
+  BOOST_REQUIRE(storage.ResetDB(BlockStorage::TX_BLOCK));
+
+  uint64_t lastBlockNum = 0;
+  BOOST_CHECK(!storage.GetLastTxnCountBlockNum(lastBlockNum));
+
+  // Block numbers past 2^8 and counts past 2^64 must keep their order and
+  // value
+  const uint128_t big = uint128_t(1) << 100;
+  for (uint64_t blockNum = 0; blockNum <= 300; blockNum++) {
+    BOOST_REQUIRE(
+        storage.PutTxnCount(blockNum, big + blockNum * 10, blockNum / 100));
+  }
+
+  BOOST_REQUIRE(storage.GetLastTxnCountBlockNum(lastBlockNum));
+  BOOST_CHECK_EQUAL(lastBlockNum, 300);
+
+  uint128_t numTxns = 0;
+  uint64_t dsBlockNum = 0;
+  BOOST_REQUIRE(storage.GetTxnCount(257, numTxns, dsBlockNum));
+  BOOST_CHECK(numTxns == big + 2570);
+  BOOST_CHECK_EQUAL(dsBlockNum, 2);
+  BOOST_CHECK(!storage.GetTxnCount(301, numTxns, dsBlockNum));
+
+  // Deleting the tip tx block drops its count
+  BOOST_CHECK(storage.DeleteTxBlock(300));
+  BOOST_CHECK(!storage.GetTxnCount(300, numTxns, dsBlockNum));
+  BOOST_REQUIRE(storage.GetLastTxnCountBlockNum(lastBlockNum));
+  BOOST_CHECK_EQUAL(lastBlockNum, 299);
+
+  BOOST_REQUIRE(storage.ResetDB(BlockStorage::TX_BLOCK));
+  BOOST_CHECK(!storage.GetLastTxnCountBlockNum(lastBlockNum));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
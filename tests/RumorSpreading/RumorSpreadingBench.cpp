@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// RumorHolder round benchmark. A holder with a configurable number of live
+/// rumors receives lazy pushes from a few peers per round and then advances
+/// the round. The rounds limits are set above the rounds run, so that every
+/// rumor stays live throughout. Reports rounds/sec, ns per rumor per round
+/// and heap allocations per round.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "libRumorSpreading/Message.h"
+#include "libRumorSpreading/RumorHolder.h"
+#include "libUtils/Logger.h"
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+
+namespace po = boost::program_options;
+using namespace std;
+
+namespace {
+atomic<uint64_t> g_allocations{0};
+}  // namespace
+
+// Every heap allocation of the process is counted, so that a round can
+// report how many of them it costs
+void* operator new(size_t size) {
+  g_allocations++;
+  void* p = malloc(size > 0 ? size : 1);
+  if (p == nullptr) {
+    throw bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete[](void* p) noexcept { free(p); }
+
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+struct Options {
+  unsigned int rumors{10000};
+  unsigned int peers{600};
+  unsigned int pushesPerRound{20};
+  unsigned int rounds{200};
+};
+
+void Run(const Options& options) {
+  unordered_set<int> peers;
+  for (unsigned int i = 1; i <= options.peers; i++) {
+    peers.insert(i);
+  }
+
+  const int maxRounds = options.rounds + 1;
+  RRS::RumorHolder holder(peers, maxRounds, maxRounds, maxRounds, 1, 0);
+  for (unsigned int i = 0; i < options.rumors; i++) {
+    holder.addRumor(i);
+  }
+
+  mt19937 gen(0);
+  uniform_int_distribution<int> peerDis(1, options.peers);
+  uniform_int_distribution<int> rumorDis(0, options.rumors - 1);
+
+  uint64_t allocations = 0;
+  chrono::nanoseconds total{0};
+  for (unsigned int round = 0; round < options.rounds; round++) {
+    const uint64_t allocationsBefore = g_allocations;
+    const auto start = Clock::now();
+    for (unsigned int i = 0; i < options.pushesPerRound; i++) {
+      holder.receivedMessage(
+          RRS::Message(RRS::Message::Type::LAZY_PUSH, rumorDis(gen), round),
+          peerDis(gen));
+    }
+    holder.advanceRound();
+    total += chrono::duration_cast<chrono::nanoseconds>(Clock::now() - start);
+    allocations += g_allocations - allocationsBefore;
+  }
+
+  const double totalNs = total.count() > 0 ? total.count() : 1;
+  cout << fixed << setprecision(2) << "rumors: " << options.rumors
+       << " peers: " << options.peers
+       << " pushes/round: " << options.pushesPerRound << endl
+       << "rounds/sec: " << options.rounds * 1e9 / totalNs << endl
+       << "ns/rumor/round: "
+       << totalNs / options.rounds / max(options.rumors, 1u) << endl
+       << "allocs/round: " << static_cast<double>(allocations) / options.rounds
+       << endl;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  try {
+    Options options;
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "rumors,r", po::value<unsigned int>(&options.rumors),
+        "Live rumors in the holder (default 10000)")(
+        "peers,p", po::value<unsigned int>(&options.peers),
+        "Peers of the holder (default 600)")(
+        "pushes", po::value<unsigned int>(&options.pushesPerRound),
+        "Lazy pushes received per round (default 20)")(
+        "rounds,n", po::value<unsigned int>(&options.rounds),
+        "Rounds timed (default 200)");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help")) {
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      po::notify(vm);
+    } catch (boost::program_options::error& e) {
+      cerr << "ERROR: " << e.what() << endl << endl;
+      cout << desc;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    if (options.rumors == 0 || options.peers == 0 || options.rounds == 0) {
+      cerr << "ERROR: rumors, peers and rounds must be positive" << endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    INIT_FILE_LOGGER("rumorspreadingbench", ".");
+
+    Run(options);
+  } catch (exception& e) {
+    cerr << "Unhandled Exception reached the top of main: " << e.what()
+         << ", application will now exit" << endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+
+  return SUCCESS;
+}
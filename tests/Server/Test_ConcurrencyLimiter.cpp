@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "libServer/ConcurrencyLimiter.h"
+
+#define BOOST_TEST_MODULE concurrencylimitertest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(concurrencylimitertest)
+
+BOOST_AUTO_TEST_CASE(testLimits) {
+  ConcurrencyLimiter limiter({{"slow", 2}, {"unlimited", 0}});
+
+  BOOST_CHECK(limiter.TryAcquire("slow"));
+  BOOST_CHECK(limiter.TryAcquire("slow"));
+  BOOST_CHECK(!limiter.TryAcquire("slow"));
+  BOOST_CHECK_EQUAL(limiter.GetRunning("slow"), 2);
+
+  limiter.Release("slow");
+  BOOST_CHECK(limiter.TryAcquire("slow"));
+  BOOST_CHECK(!limiter.TryAcquire("slow"));
+
+  // Methods not listed or with a limit of 0 are never refused
+  for (unsigned int i = 0; i < 100; i++) {
+    BOOST_CHECK(limiter.TryAcquire("unlimited"));
+    BOOST_CHECK(limiter.TryAcquire("other"));
+  }
+  BOOST_CHECK_EQUAL(limiter.GetRunning("other"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testConcurrentCalls) {
+  const unsigned int max = 3;
+  ConcurrencyLimiter limiter({{"slow", max}});
+  atomic<unsigned int> running{0};
+  atomic<unsigned int> peak{0};
+  atomic<bool> exceeded{false};
+
+  vector<thread> threads;
+  for (unsigned int t = 0; t < 8; t++) {
+    threads.emplace_back([&]() {
+      for (unsigned int i = 0; i < 10000; i++) {
+        if (!limiter.TryAcquire("slow")) {
+          continue;
+        }
+        const unsigned int now = ++running;
+        if (now > max) {
+          exceeded = true;
+        }
+        unsigned int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+        }
+        running--;
+        limiter.Release("slow");
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  BOOST_CHECK(!exceeded);
+  BOOST_CHECK_LE(peak.load(), max);
+  BOOST_CHECK_EQUAL(limiter.GetRunning("slow"), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include "libServer/GetWorkServer.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE getworkservertest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const string HEADER =
+    "46a1bd9b9c1c3ed6d1f9c0a5a4b1f5e5b9c1f6e4d2e1a6b8c9d0e1f2a3b4c5d6";
+
+// Runs func on another thread after a short while
+future<void> Later(const function<void()>& func) {
+  return async(launch::async, [func]() {
+    this_thread::sleep_for(chrono::milliseconds(100));
+    func();
+  });
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(getworkservertest)
+
+BOOST_AUTO_TEST_CASE(testAwaitWork) {
+  INIT_STDOUT_LOGGER();
+
+  auto& server = GetWorkServer::GetInstance();
+  BOOST_CHECK_EQUAL(server.AwaitWork("", 0)[0].asString(), "");
+
+  PoWWorkPackage wp;
+  wp.header = HEADER;
+  wp.seed = HEADER;
+  wp.boundary = HEADER;
+
+  // Woken up by the new work long before the timeout
+  const auto start = chrono::steady_clock::now();
+  auto starter = Later([&]() { server.StartMining(wp); });
+  auto work = server.AwaitWork("", 60);
+  BOOST_CHECK_EQUAL(work[0].asString(), HEADER);
+  BOOST_CHECK(work[3].asBool());
+  BOOST_CHECK(chrono::steady_clock::now() - start < chrono::seconds(30));
+  starter.wait();
+
+  // The miner already has the work
+  BOOST_CHECK_EQUAL(server.AwaitWork(HEADER, 0)[0].asString(), HEADER);
+
+  auto stopper = Later([&]() { server.StopMining(); });
+  work = server.AwaitWork(HEADER, 60);
+  BOOST_CHECK_EQUAL(work[0].asString(), "");
+  BOOST_CHECK(!work[3].asBool());
+  stopper.wait();
+}
+
+BOOST_AUTO_TEST_CASE(testLongPollHeader) {
+  INIT_STDOUT_LOGGER();
+
+  auto& server = GetWorkServer::GetInstance();
+  PoWWorkPackage wp;
+  wp.header = HEADER;
+  server.StartMining(wp);
+
+  // A header the miner does not have yet returns at once
+  BOOST_CHECK_EQUAL(server.getWorkLongPoll("0x1234")[0].asString(), HEADER);
+  BOOST_CHECK_EQUAL(server.getWorkLongPoll("not hex")[0].asString(), HEADER);
+
+  // The header is compared the way miners send it
+  auto stopper = Later([&]() { server.StopMining(); });
+  BOOST_CHECK_EQUAL(server.getWorkLongPoll("0x" + HEADER)[0].asString(), "");
+  stopper.wait();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <Schnorr.h>
+#include <string>
+#include <vector>
+
+#include "libServer/JSONConversion.h"
+#include "libTestUtils/TestUtils.h"
+#include "libUtils/DataConversion.h"
+
+#define BOOST_TEST_MODULE jsonconversiontest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+string WriteJson(const Json::Value& value) {
+  Json::FastWriter writer;
+  writer.omitEndingLineFeed();
+  return writer.write(value);
+}
+
+TransactionWithReceipt MakeTx(const string& code, const string& data) {
+  Address toAddr;
+  for (unsigned int i = 0; i < toAddr.asArray().size(); i++) {
+    toAddr.asArray().at(i) = i + 8;
+  }
+  return TransactionWithReceipt(
+      Transaction(1, TestUtils::DistUint64(), toAddr, Schnorr::GenKeyPair(),
+                  TestUtils::DistUint128(), TestUtils::DistUint128(),
+                  TestUtils::DistUint64(),
+                  DataConversion::StringToCharArray(code),
+                  DataConversion::StringToCharArray(data)),
+      TransactionReceipt());
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(jsonconversiontest)
+
+BOOST_AUTO_TEST_CASE(testWriteTxJson) {
+  INIT_STDOUT_LOGGER();
+
+  // Code and data with characters that the writer must escape
+  const vector<TransactionWithReceipt> txs = {
+      MakeTx("", ""), MakeTx("scilla_version 0", ""),
+      MakeTx("", R"([{"vname":"_scilla_version","type":"Uint32"}])"),
+      MakeTx("contract A\n\t(x : \"\\\x01\xc3\xa9)", "\x7f")};
+
+  for (const auto& twr : txs) {
+    string out = "prefix";
+    JSONConversion::writeTxJson(twr, out);
+    BOOST_CHECK_EQUAL(
+        out, "prefix" + WriteJson(JSONConversion::convertTxtoJson(twr)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testWriteTxBlockJson) {
+  INIT_STDOUT_LOGGER();
+
+  vector<MicroBlockInfo> mbInfos;
+  for (uint32_t shardId = 0; shardId < 4; shardId++) {
+    MicroBlockInfo mbInfo;
+    mbInfo.m_microBlockHash = BlockHash::random();
+    mbInfo.m_txnRootHash = TxnHash::random();
+    mbInfo.m_shardId = shardId;
+    mbInfos.emplace_back(mbInfo);
+  }
+
+  const vector<TxBlock> blocks = {
+      TxBlock(TestUtils::GenerateRandomTxBlockHeader(), {},
+              TestUtils::GenerateRandomCoSignatures()),
+      TxBlock(TestUtils::GenerateRandomTxBlockHeader(), mbInfos,
+              TestUtils::GenerateRandomCoSignatures())};
+
+  for (const auto& block : blocks) {
+    string out;
+    JSONConversion::writeTxBlockJson(block, out);
+    BOOST_CHECK_EQUAL(out,
+                      WriteJson(JSONConversion::convertTxBlocktoJson(block)));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <string>
+
+#include "libServer/RateLimiter.h"
+
+#define BOOST_TEST_MODULE ratelimitertest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(ratelimitertest)
+
+BOOST_AUTO_TEST_CASE(testBurstAndRefill) {
+  RateLimiter limiter(2, 3);
+  const auto start = RateLimiter::Clock::now();
+
+  for (unsigned int i = 0; i < 3; i++) {
+    BOOST_CHECK(limiter.TryAcquire("a", start));
+  }
+  BOOST_CHECK(!limiter.TryAcquire("a", start));
+  // Keys have their own buckets
+  BOOST_CHECK(limiter.TryAcquire("b", start));
+
+  // 2 tokens a second, so one is back after half a second
+  BOOST_CHECK(!limiter.TryAcquire("a", start + chrono::milliseconds(400)));
+  BOOST_CHECK(limiter.TryAcquire("a", start + chrono::milliseconds(500)));
+  BOOST_CHECK(!limiter.TryAcquire("a", start + chrono::milliseconds(500)));
+
+  // Refills stop at the burst
+  const auto later = start + chrono::seconds(60);
+  for (unsigned int i = 0; i < 3; i++) {
+    BOOST_CHECK(limiter.TryAcquire("a", later));
+  }
+  BOOST_CHECK(!limiter.TryAcquire("a", later));
+  BOOST_CHECK_EQUAL(limiter.GetRejected(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(testUnlimited) {
+  RateLimiter limiter(0, 1);
+  for (unsigned int i = 0; i < 100; i++) {
+    BOOST_CHECK(limiter.TryAcquire("a"));
+  }
+  BOOST_CHECK_EQUAL(limiter.GetRejected(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testIdleKeysDropped) {
+  RateLimiter limiter(1, 1, 2);
+  const auto start = RateLimiter::Clock::now();
+
+  BOOST_CHECK(limiter.TryAcquire("a", start));
+  BOOST_CHECK(limiter.TryAcquire("b", start));
+  BOOST_CHECK(!limiter.TryAcquire("a", start));
+
+  // Dropping the idle buckets must not give a busy key its burst back
+  const auto later = start + chrono::milliseconds(500);
+  BOOST_CHECK(limiter.TryAcquire("c", later));
+  BOOST_CHECK(!limiter.TryAcquire("a", later));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
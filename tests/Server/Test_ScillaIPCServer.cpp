@@ -926,4 +926,58 @@ BOOST_AUTO_TEST_CASE(test_scillatestsuite) {
   LOG_GENERAL(INFO, "Test_ScillaIPCServer: server has stopped listening.");
 }
 
+// Batched fetch, with cached reads dropped by an update of the field.
+BOOST_AUTO_TEST_CASE(test_query_batch) {
+  INIT_STDOUT_LOGGER();
+  UnixDomainSocketServer s(SCILLA_IPC_SOCKET_PATH);
+  ScillaIPCServer server(s);
+  UnixDomainSocketClient c(SCILLA_IPC_SOCKET_PATH);
+  Client client(c);
+
+  server.StartListening();
+
+  ProtoScillaQuery query;
+  query.set_name("foo_test_query_batch");
+  query.set_mapdepth(1);
+  query.add_indices("key1");
+  ProtoScillaVal value;
+  value.set_bval("420");
+  Json::Value params;
+  params["query"] = query.SerializeAsString();
+  params["value"] = value.SerializeAsString();
+  client.CallMethod("updateStateValue", params);
+
+  ProtoScillaQuery missing = query;
+  missing.clear_indices();
+  missing.add_indices("key2");
+  Json::Value batch;
+  batch["queries"] = Json::arrayValue;
+  batch["queries"].append(query.SerializeAsString());
+  batch["queries"].append(missing.SerializeAsString());
+
+  // Fetch twice, the second time from the read cache.
+  for (unsigned int i = 0; i < 2; i++) {
+    Json::Value result = client.CallMethod("fetchStateValues", batch);
+    BOOST_REQUIRE_EQUAL(result.size(), 2u);
+    BOOST_CHECK_EQUAL(result[0][0].asBool(), true);
+    value.Clear();
+    value.ParseFromString(result[0][1].asString());
+    BOOST_CHECK_EQUAL(value.bval(), "420");
+    BOOST_CHECK_EQUAL(result[1][0].asBool(), false);
+  }
+
+  // Updating the field must not leave the old value in the cache.
+  value.set_bval("421");
+  params["value"] = value.SerializeAsString();
+  client.CallMethod("updateStateValue", params);
+  Json::Value result = client.CallMethod("fetchStateValues", batch);
+  BOOST_REQUIRE_EQUAL(result.size(), 2u);
+  value.Clear();
+  value.ParseFromString(result[0][1].asString());
+  BOOST_CHECK_EQUAL(value.bval(), "421");
+
+  server.StopListening();
+  LOG_GENERAL(INFO, "Test ScillaIPCServer test query done!");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "libUtils/AsyncLogBuffer.h"
+
+#define BOOST_TEST_MODULE asynclogbuffer
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const int DROPPED_LEVEL = 2;
+
+LogRecord MakeRecord(const string& msg) {
+  LogRecord record;
+  record.m_time = chrono::system_clock::now();
+  record.m_msg = msg;
+  return record;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(asynclogbuffer)
+
+BOOST_AUTO_TEST_CASE(test_fields) {
+  LogRecord record;
+  LogRecord::CopyTail(record.m_file, "/a/long/path/to/src/libNode/Node.cpp");
+  BOOST_CHECK_EQUAL(string(record.m_file.data()), "to/src/libNode/Node.cpp");
+  LogRecord::CopyHead(record.m_function, "ProcessMessageFromTheNetwork");
+  BOOST_CHECK_EQUAL(string(record.m_function.data()),
+                    "ProcessMessageFromTheNe");
+  LogRecord::CopyHead(record.m_epoch, "42");
+  BOOST_CHECK_EQUAL(string(record.m_epoch.data()), "42");
+}
+
+BOOST_AUTO_TEST_CASE(test_order_across_threads) {
+  mutex mutexWritten;
+  vector<string> written;
+  {
+    AsyncLogBuffer buffer(
+        1024,
+        [&](const LogRecord& record) {
+          lock_guard<mutex> g(mutexWritten);
+          written.emplace_back(record.m_msg);
+        },
+        chrono::milliseconds(1), DROPPED_LEVEL);
+
+    vector<thread> threads;
+    for (unsigned int t = 0; t < 4; t++) {
+      threads.emplace_back([&buffer, t]() {
+        for (unsigned int i = 0; i < 100; i++) {
+          buffer.Push(MakeRecord(to_string(t) + " " + to_string(i)));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    BOOST_CHECK_EQUAL(buffer.GetDroppedCount(), 0);
+  }
+
+  // Every line is written once, and those of a thread in order
+  BOOST_REQUIRE_EQUAL(written.size(), 400);
+  map<string, int> last;
+  for (const auto& line : written) {
+    const auto space = line.find(' ');
+    const string t = line.substr(0, space);
+    const int i = stoi(line.substr(space + 1));
+    BOOST_CHECK(last.find(t) == last.end() || last[t] < i);
+    last[t] = i;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_drop_when_full) {
+  vector<LogRecord> written;
+  AsyncLogBuffer buffer(
+      4, [&](const LogRecord& record) { written.emplace_back(record); },
+      chrono::hours(1), DROPPED_LEVEL);
+
+  for (unsigned int i = 0; i < 6; i++) {
+    buffer.Push(MakeRecord(to_string(i)));
+  }
+  BOOST_CHECK_EQUAL(buffer.GetDroppedCount(), 2);
+
+  buffer.Flush();
+  BOOST_REQUIRE_EQUAL(written.size(), 5);
+  for (unsigned int i = 0; i < 4; i++) {
+    BOOST_CHECK_EQUAL(written[i].m_msg, to_string(i));
+  }
+  BOOST_CHECK_EQUAL(written[4].m_level, DROPPED_LEVEL);
+  BOOST_CHECK(written[4].m_msg.find("Dropped 2") == 0);
+
+  // Room again once drained, and the drops are reported once
+  BOOST_CHECK(buffer.Push(MakeRecord("6")));
+  buffer.Flush();
+  BOOST_REQUIRE_EQUAL(written.size(), 6);
+  BOOST_CHECK_EQUAL(written[5].m_msg, "6");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
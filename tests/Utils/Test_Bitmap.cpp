@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "libUtils/BitVector.h"
+#include "libUtils/Bitmap.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE bitmap
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(bitmap)
+
+BOOST_AUTO_TEST_CASE(test_set_and_count) {
+  INIT_STDOUT_LOGGER();
+
+  Bitmap b(130);
+  BOOST_CHECK_EQUAL(b.size(), 130);
+  BOOST_CHECK_EQUAL(b.count(), 0);
+  BOOST_CHECK_EQUAL(b.find_first(), Bitmap::npos);
+
+  b.set(0);
+  b.set(64);
+  b.set(129);
+  BOOST_CHECK_EQUAL(b.count(), 3);
+  BOOST_CHECK(b.at(64));
+  BOOST_CHECK(!b.at(65));
+  BOOST_CHECK_THROW(b.at(130), out_of_range);
+  BOOST_CHECK_THROW(b.set(130), out_of_range);
+
+  vector<size_t> setBits;
+  for (size_t i = b.find_first(); i != Bitmap::npos; i = b.find_next(i)) {
+    setBits.emplace_back(i);
+  }
+  BOOST_CHECK(setBits == vector<size_t>({0, 64, 129}));
+
+  b.set(64, false);
+  BOOST_CHECK_EQUAL(b.count(), 2);
+  b.reset();
+  BOOST_CHECK_EQUAL(b.count(), 0);
+  BOOST_CHECK_EQUAL(b.size(), 130);
+}
+
+BOOST_AUTO_TEST_CASE(test_resize_and_compat) {
+  INIT_STDOUT_LOGGER();
+
+  Bitmap b(3, true);
+  b.resize(70, true);
+  BOOST_CHECK_EQUAL(b.count(), 70);
+  b.resize(65);
+  BOOST_CHECK_EQUAL(b.count(), 65);
+  b.push_back(false);
+  b.push_back(true);
+  BOOST_CHECK_EQUAL(b.size(), 67);
+  BOOST_CHECK_EQUAL(b.count(), 66);
+
+  vector<bool> v = {true, false, true, true, false};
+  Bitmap fromVector(v);
+  unsigned int i = 0;
+  for (bool bit : fromVector) {
+    BOOST_CHECK_EQUAL(bit, v.at(i++));
+  }
+  BOOST_CHECK_EQUAL(i, v.size());
+
+  Bitmap mask(5);
+  mask.set(0);
+  mask.set(1);
+  fromVector &= mask;
+  BOOST_CHECK_EQUAL(fromVector.count(), 1);
+  BOOST_CHECK(fromVector.at(0));
+}
+
+BOOST_AUTO_TEST_CASE(test_serialization_format) {
+  INIT_STDOUT_LOGGER();
+
+  Bitmap b(10);
+  b.set(0);
+  b.set(7);
+  b.set(9);
+
+  bytes dst;
+  BOOST_CHECK_EQUAL(BitVector::SetBitVector(dst, 0, b), 4);
+  BOOST_CHECK(dst == bytes({0x00, 0x0A, 0x81, 0x40}));
+
+  BOOST_CHECK(BitVector::GetBitVector(dst, 0) == b);
+  BOOST_CHECK(BitVector::GetBitVector(dst, 0, 2) == b);
+  BOOST_CHECK(BitVector::GetBitVector(dst, 0, 3).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include "libUtils/BlockingPriorityQueue.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE blockingpriorityqueue
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(blockingpriorityqueue)
+
+BOOST_AUTO_TEST_CASE(test_priority_order) {
+  INIT_STDOUT_LOGGER();
+
+  BlockingPriorityQueue<int> queue(3, 10);
+
+  BOOST_CHECK(queue.Push(20, 2));
+  BOOST_CHECK(queue.Push(10, 1));
+  BOOST_CHECK(queue.Push(0, 0));
+  BOOST_CHECK(queue.Push(11, 1));
+  BOOST_CHECK(queue.Push(1, 0));
+
+  const vector<int> expected = {0, 1, 10, 11, 20};
+  for (const auto& e : expected) {
+    int item = -1;
+    BOOST_REQUIRE(queue.TryPop(item));
+    BOOST_CHECK_EQUAL(item, e);
+  }
+
+  int item;
+  BOOST_CHECK_MESSAGE(!queue.TryPop(item), "Queue should be empty!");
+}
+
+BOOST_AUTO_TEST_CASE(test_lane_capacity) {
+  INIT_STDOUT_LOGGER();
+
+  BlockingPriorityQueue<int> queue(2, 2);
+
+  BOOST_CHECK(queue.Push(1, 1));
+  BOOST_CHECK(queue.Push(2, 1));
+  BOOST_CHECK_MESSAGE(!queue.Push(3, 1), "Full lane should reject items!");
+  BOOST_CHECK_MESSAGE(queue.Push(4, 0),
+                      "Full lane should not affect other lanes!");
+  BOOST_CHECK_MESSAGE(!queue.Push(5, 2), "Unknown lane should be rejected!");
+
+  BOOST_CHECK_EQUAL(queue.Size(0), 1);
+  BOOST_CHECK_EQUAL(queue.Size(1), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_blocking_pop) {
+  INIT_STDOUT_LOGGER();
+
+  BlockingPriorityQueue<int> queue(2, 10);
+
+  auto consumer = async(launch::async, [&queue]() {
+    vector<int> items;
+    int item;
+    while (queue.Pop(item)) {
+      items.emplace_back(item);
+    }
+    return items;
+  });
+
+  this_thread::sleep_for(chrono::milliseconds(100));
+  queue.Push(7, 1);
+  this_thread::sleep_for(chrono::milliseconds(100));
+  queue.Stop();
+
+  BOOST_CHECK_MESSAGE(
+      consumer.wait_for(chrono::seconds(2)) == future_status::ready,
+      "Stop should wake up the consumer!");
+  const auto items = consumer.get();
+  BOOST_REQUIRE_EQUAL(items.size(), 1);
+  BOOST_CHECK_EQUAL(items.front(), 7);
+  BOOST_CHECK_MESSAGE(!queue.Push(8, 0), "Stopped queue should reject items!");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
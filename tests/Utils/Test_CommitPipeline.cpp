@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "libUtils/CommitPipeline.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE commitpipeline
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(commitpipeline)
+
+BOOST_AUTO_TEST_CASE(test_dependencies_first) {
+  INIT_STDOUT_LOGGER();
+
+  mutex mutexOrder;
+  vector<string> order;
+  auto stage = [&mutexOrder, &order](const string& name) {
+    return [&mutexOrder, &order, name]() {
+      lock_guard<mutex> g(mutexOrder);
+      order.emplace_back(name);
+      return true;
+    };
+  };
+
+  CommitPipeline pipeline("Test");
+  const auto a = pipeline.Add("a", stage("a"));
+  const auto b = pipeline.Add("b", stage("b"), {a});
+  const auto c = pipeline.Add("c", stage("c"), {a});
+  pipeline.Add("d", stage("d"), {b, c});
+  pipeline.Start();
+  BOOST_CHECK(pipeline.WaitAll());
+
+  BOOST_REQUIRE_EQUAL(order.size(), 4);
+  BOOST_CHECK_EQUAL(order.front(), "a");
+  BOOST_CHECK_EQUAL(order.back(), "d");
+}
+
+BOOST_AUTO_TEST_CASE(test_independent_stages_run_together) {
+  INIT_STDOUT_LOGGER();
+
+  // Each stage waits for the other, so they only end if run at once
+  mutex mutexMet;
+  condition_variable cvMet;
+  unsigned int arrived = 0;
+  auto meet = [&]() {
+    unique_lock<mutex> lock(mutexMet);
+    arrived++;
+    cvMet.notify_all();
+    return cvMet.wait_for(lock, chrono::seconds(5),
+                          [&arrived]() { return arrived == 2; });
+  };
+
+  CommitPipeline pipeline("Test");
+  const auto first = pipeline.Add("first", meet);
+  const auto second = pipeline.Add("second", meet);
+  pipeline.Start();
+  BOOST_CHECK(pipeline.Wait(first));
+  BOOST_CHECK(pipeline.Wait(second));
+}
+
+BOOST_AUTO_TEST_CASE(test_failure_skips_dependents) {
+  INIT_STDOUT_LOGGER();
+
+  atomic<unsigned int> ran{0};
+  CommitPipeline pipeline("Test");
+  const auto failing = pipeline.Add("failing", [&ran]() {
+    ran++;
+    return false;
+  });
+  const auto dependent = pipeline.Add("dependent",
+                                      [&ran]() {
+                                        ran++;
+                                        return true;
+                                      },
+                                      {failing});
+  const auto last = pipeline.Add("last",
+                                 [&ran]() {
+                                   ran++;
+                                   return true;
+                                 },
+                                 {dependent});
+  const auto other = pipeline.Add("other", []() { return true; });
+  pipeline.Start();
+
+  BOOST_CHECK(!pipeline.WaitAll());
+  BOOST_CHECK(!pipeline.Wait(dependent));
+  BOOST_CHECK(!pipeline.Wait(last));
+  BOOST_CHECK(pipeline.Wait(other));
+  BOOST_CHECK_EQUAL(ran, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
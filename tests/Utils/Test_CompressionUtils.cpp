@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "libUtils/CompressionUtils.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE compressionutils
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(compressionutils)
+
+BOOST_AUTO_TEST_CASE(test_round_trip) {
+  INIT_STDOUT_LOGGER();
+
+  bytes src = {0x11, 0x22, 0x33};
+  src.resize(10000, 0);
+
+  bytes compressed;
+  BOOST_REQUIRE(CompressionUtils::Compress(src, 0, compressed, 10));
+  BOOST_CHECK_LT(compressed.size(), src.size());
+
+  bytes dst = {0xAA};
+  BOOST_REQUIRE(
+      CompressionUtils::Decompress(compressed, 0, dst, src.size() + 1));
+  BOOST_REQUIRE_EQUAL(dst.size(), src.size() + 1);
+  BOOST_CHECK_EQUAL(dst.at(0), 0xAA);
+  BOOST_CHECK(equal(src.begin(), src.end(), dst.begin() + 1));
+}
+
+BOOST_AUTO_TEST_CASE(test_dense_payload_skipped) {
+  INIT_STDOUT_LOGGER();
+
+  bytes src(4096);
+  uint32_t x = 12345;
+  for (auto& b : src) {
+    x = x * 1103515245 + 12345;
+    b = (x >> 16) | 1;
+  }
+
+  bytes compressed = {0x01};
+  BOOST_CHECK_MESSAGE(!CompressionUtils::Compress(src, 0, compressed, 10),
+                      "Random payload should not be compressed!");
+  BOOST_CHECK_EQUAL(compressed.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_limits) {
+  INIT_STDOUT_LOGGER();
+
+  bytes src(10000, 0);
+  bytes compressed;
+  BOOST_REQUIRE(CompressionUtils::Compress(src, 0, compressed, 10));
+
+  bytes dst;
+  BOOST_CHECK_MESSAGE(
+      !CompressionUtils::Decompress(compressed, 0, dst, src.size() - 1),
+      "Output above the limit should be rejected!");
+
+  bytes corrupted(compressed.begin(), compressed.begin() + 9);
+  dst.clear();
+  BOOST_CHECK(!CompressionUtils::Decompress(corrupted, 0, dst, src.size()));
+  BOOST_CHECK(dst.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
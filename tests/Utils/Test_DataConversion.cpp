@@ -149,4 +149,55 @@ BOOST_AUTO_TEST_CASE(test_hexstr) {
   LOG_GENERAL(INFO, "Test HexString Conversion done!");
 }
 
+BOOST_AUTO_TEST_CASE(test_hex_encode_decode) {
+  INIT_STDOUT_LOGGER();
+
+  // Lengths around the 16-byte blocks of the vector kernels
+  for (unsigned int len = 0; len <= 70; len++) {
+    bytes input(len);
+    for (unsigned int i = 0; i < len; i++) {
+      input[i] = static_cast<uint8_t>(i * 37 + len);
+    }
+
+    std::string expected;
+    boost::algorithm::hex(input.begin(), input.end(),
+                          std::back_inserter(expected));
+    std::string str = "stale";
+    BOOST_REQUIRE(DataConversion::Uint8VecToHexStr(input, str));
+    BOOST_CHECK_EQUAL(str, expected);
+
+    bytes output;
+    BOOST_REQUIRE(DataConversion::HexStrToUint8Vec(str, output));
+    BOOST_CHECK(output == input);
+    BOOST_REQUIRE(
+        DataConversion::HexStrToUint8Vec(boost::to_lower_copy(str), output));
+    BOOST_CHECK(output == input);
+
+    // A bad digit anywhere fails the decode
+    for (unsigned int i = 0; i < str.size(); i += 7) {
+      std::string bad = str;
+      bad[i] = (i % 2) ? 'g' : ':';
+      BOOST_CHECK(!DataConversion::HexStrToUint8Vec(bad, output));
+    }
+    if (!str.empty()) {
+      BOOST_CHECK(!DataConversion::HexStrToUint8Vec(str.substr(1), output));
+    }
+  }
+
+  bytes input{0x00, 0x01, 0xAB, 0xFF};
+  std::string str;
+  BOOST_REQUIRE(DataConversion::Uint8VecToHexStr(input, 1, 2, str));
+  BOOST_CHECK_EQUAL(str, "01AB");
+  BOOST_CHECK(!DataConversion::Uint8VecToHexStr(input, 3, 2, str));
+
+  std::array<uint8_t, 32> arr;
+  BOOST_REQUIRE(DataConversion::HexStrToStdArray("01ab", arr));
+  BOOST_CHECK_EQUAL(arr[0], 0x01);
+  BOOST_CHECK_EQUAL(arr[1], 0xAB);
+  BOOST_CHECK_EQUAL(arr[2], 0x00);
+  BOOST_CHECK(!DataConversion::HexStrToStdArray("01az", arr));
+  BOOST_REQUIRE(DataConversion::charArrToHexStr(arr, str));
+  BOOST_CHECK_EQUAL(str, std::string(64, '0'));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
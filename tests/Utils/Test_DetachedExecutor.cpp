@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "libUtils/DetachedExecutor.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE detachedexecutor
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+template <class Predicate>
+bool WaitFor(Predicate predicate) {
+  for (unsigned int i = 0; i < 5000 && !predicate(); i++) {
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  return predicate();
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(detachedexecutor)
+
+BOOST_AUTO_TEST_CASE(test_reuse_threads) {
+  INIT_STDOUT_LOGGER();
+
+  auto& executor = DetachedExecutor::GetInstance();
+  atomic<unsigned int> done{0};
+  for (unsigned int i = 0; i < 100; i++) {
+    executor.Run([&done]() { done++; });
+    BOOST_REQUIRE(WaitFor([&done, i]() { return done == i + 1; }));
+    BOOST_REQUIRE(WaitFor([&executor]() {
+      return executor.GetStats().m_idleThreads > 0;
+    }));
+  }
+
+  // One task at a time needs one thread
+  BOOST_CHECK_EQUAL(executor.GetStats().m_threadsStarted, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_blocked_tasks) {
+  INIT_STDOUT_LOGGER();
+
+  // A task waiting on a later one does not keep it from running
+  // Static, as the second task may still be notifying once the first is done
+  auto& executor = DetachedExecutor::GetInstance();
+  static mutex mutexDone;
+  static condition_variable cvDone;
+  static bool done = false;
+  static atomic<bool> waited{false};
+  executor.Run([]() {
+    unique_lock<mutex> lock(mutexDone);
+    cvDone.wait(lock, []() { return done; });
+    waited = true;
+  });
+  executor.Run([]() {
+    {
+      lock_guard<mutex> g(mutexDone);
+      done = true;
+    }
+    cvDone.notify_all();
+  });
+  BOOST_CHECK(WaitFor([]() { return waited.load(); }));
+}
+
+BOOST_AUTO_TEST_CASE(test_lane) {
+  INIT_STDOUT_LOGGER();
+
+  auto& executor = DetachedExecutor::GetInstance();
+  executor.AddLane("Test", 2);
+  atomic<unsigned int> running{0};
+  atomic<unsigned int> maxRunning{0};
+  atomic<unsigned int> done{0};
+  for (unsigned int i = 0; i < 10; i++) {
+    executor.Run("Test", [&]() {
+      const unsigned int now = ++running;
+      unsigned int prev = maxRunning;
+      while (now > prev && !maxRunning.compare_exchange_weak(prev, now)) {
+      }
+      this_thread::sleep_for(chrono::milliseconds(10));
+      running--;
+      done++;
+    });
+  }
+
+  BOOST_CHECK(WaitFor([&done]() { return done == 10; }));
+  BOOST_CHECK_EQUAL(maxRunning, 2);
+  BOOST_CHECK_EQUAL(executor.GetStats().m_laneTasksQueued, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_long_running) {
+  INIT_STDOUT_LOGGER();
+
+  auto& executor = DetachedExecutor::GetInstance();
+  const auto threads = executor.GetStats().m_threads;
+  atomic<bool> stop{false};
+  executor.RunLongRunning("Test", [&stop]() {
+    while (!stop) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+    }
+  });
+
+  BOOST_CHECK(WaitFor([&executor]() {
+    return executor.GetStats().m_longRunningThreads == 1;
+  }));
+  BOOST_CHECK_EQUAL(executor.GetStats().m_threads, threads);
+
+  stop = true;
+  BOOST_CHECK(WaitFor([&executor]() {
+    return executor.GetStats().m_longRunningThreads == 0;
+  }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
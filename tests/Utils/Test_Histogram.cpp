@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "libUtils/Histogram.h"
+#include "libUtils/Logger.h"
+#include "libUtils/MessageStats.h"
+
+#define BOOST_TEST_MODULE histogram
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(histogram)
+
+BOOST_AUTO_TEST_CASE(test_empty) {
+  INIT_STDOUT_LOGGER();
+
+  Histogram h;
+  BOOST_CHECK_EQUAL(h.GetCount(), 0);
+  BOOST_CHECK_EQUAL(h.GetMin(), 0);
+  BOOST_CHECK_EQUAL(h.GetMax(), 0);
+  BOOST_CHECK_EQUAL(h.GetPercentile(99), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_small_values_exact) {
+  INIT_STDOUT_LOGGER();
+
+  Histogram h;
+  for (uint64_t i = 1; i <= 20; i++) {
+    h.Record(i);
+  }
+
+  BOOST_CHECK_EQUAL(h.GetCount(), 20);
+  BOOST_CHECK_EQUAL(h.GetMin(), 1);
+  BOOST_CHECK_EQUAL(h.GetMax(), 20);
+  BOOST_CHECK_EQUAL(h.GetPercentile(50), 10);
+  BOOST_CHECK_EQUAL(h.GetPercentile(100), 20);
+  BOOST_CHECK_CLOSE(h.GetMean(), 10.5, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(test_percentile_precision) {
+  INIT_STDOUT_LOGGER();
+
+  Histogram h;
+  for (uint64_t i = 1; i <= 100000; i++) {
+    h.Record(i);
+  }
+
+  const vector<pair<double, uint64_t>> expected = {
+      {50, 50000}, {99, 99000}, {99.9, 99900}};
+  for (const auto& e : expected) {
+    const uint64_t value = h.GetPercentile(e.first);
+    BOOST_CHECK_MESSAGE(value >= e.second && value <= e.second * 17 / 16,
+                        "p" << e.first << " = " << value << " out of range");
+  }
+
+  h.Record(UINT64_MAX);
+  BOOST_CHECK_EQUAL(h.GetPercentile(100), UINT64_MAX);
+
+  h.Reset();
+  BOOST_CHECK_EQUAL(h.GetCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_message_stats) {
+  INIT_STDOUT_LOGGER();
+
+  MessageStats& ms = MessageStats::GetInstance();
+  ms.Record("NODE_FINALBLOCK", 100, 10, 5000);
+  ms.Record("NODE_FINALBLOCK", 200, 20, 6000);
+
+  Json::Value stats = ms.GetStats();
+  BOOST_CHECK_EQUAL(
+      stats["current"]["NODE_FINALBLOCK"]["handler_us"]["count"].asUInt64(), 2);
+  BOOST_CHECK_EQUAL(
+      stats["current"]["NODE_FINALBLOCK"]["size_bytes"]["max"].asUInt64(),
+      6000);
+
+  ms.LogAndReset(7);
+  stats = ms.GetStats();
+  BOOST_CHECK(!stats["current"].isMember("NODE_FINALBLOCK"));
+  BOOST_CHECK(stats["previous"].isMember("NODE_FINALBLOCK"));
+  BOOST_CHECK_EQUAL(stats["previous_epoch"].asUInt64(), 7);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
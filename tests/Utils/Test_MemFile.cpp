@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <fstream>
+#include <iterator>
+
+#include "libUtils/Logger.h"
+#include "libUtils/MemFile.h"
+
+#define BOOST_TEST_MODULE memfile
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(memfile)
+
+BOOST_AUTO_TEST_CASE(test_write_and_read) {
+  INIT_STDOUT_LOGGER();
+
+  MemFile file("test");
+  BOOST_REQUIRE(file.IsOpen());
+
+  string content;
+  BOOST_CHECK(!file.Read(content));
+
+  BOOST_CHECK(file.Write("{\"a\": 1}"));
+  BOOST_CHECK(file.Read(content));
+  BOOST_CHECK_EQUAL(content, "{\"a\": 1}");
+
+  // Shorter content replaces the old one completely
+  BOOST_CHECK(file.Write("{}"));
+  BOOST_CHECK(file.Read(content));
+  BOOST_CHECK_EQUAL(content, "{}");
+
+  BOOST_CHECK(file.Clear());
+  BOOST_CHECK(!file.Read(content));
+}
+
+BOOST_AUTO_TEST_CASE(test_open_by_path) {
+  INIT_STDOUT_LOGGER();
+
+  MemFile file("test");
+  BOOST_REQUIRE(file.IsOpen());
+  BOOST_REQUIRE(file.Write("input"));
+
+  // Another process sees the file under its path, as scilla does
+  ifstream in(file.GetPath(), ios::binary);
+  BOOST_REQUIRE(in.is_open());
+  const string read = {istreambuf_iterator<char>(in),
+                       istreambuf_iterator<char>()};
+  BOOST_CHECK_EQUAL(read, "input");
+
+  ofstream out(file.GetPath(), ios::binary | ios::trunc);
+  out << "output";
+  out.close();
+
+  string content;
+  BOOST_CHECK(file.Read(content));
+  BOOST_CHECK_EQUAL(content, "output");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
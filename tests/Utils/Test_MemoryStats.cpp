@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+
+#include "libUtils/Logger.h"
+#include "libUtils/MemoryStats.h"
+
+#define BOOST_TEST_MODULE memorystats
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(memorystats)
+
+BOOST_AUTO_TEST_CASE(test_register_and_report) {
+  INIT_STDOUT_LOGGER();
+
+  MemoryStats& stats = MemoryStats::GetInstance();
+  atomic<uint64_t> poolBytes{100};
+  stats.Register("TestPool", [&poolBytes]() -> uint64_t { return poolBytes; });
+  stats.Register("TestCache", []() -> uint64_t { return 50; });
+
+  Json::Value current = stats.GetStats()["current"];
+  BOOST_CHECK_EQUAL(current["subsystems"]["TestPool"].asUInt64(), 100);
+  BOOST_CHECK_EQUAL(current["subsystems"]["TestCache"].asUInt64(), 50);
+  BOOST_CHECK_EQUAL(current["accounted_bytes"].asUInt64(), 150);
+
+  // The estimators are read again at each report
+  poolBytes = 300;
+  stats.Log(7);
+  const Json::Value result = stats.GetStats();
+  BOOST_CHECK_EQUAL(result["previous_epoch"].asUInt64(), 7);
+  BOOST_CHECK_EQUAL(
+      result["previous"]["subsystems"]["TestPool"].asUInt64(), 300);
+  BOOST_CHECK_EQUAL(result["previous"]["accounted_bytes"].asUInt64(), 350);
+
+  stats.Unregister("TestPool");
+  current = stats.GetStats()["current"];
+  BOOST_CHECK(!current["subsystems"].isMember("TestPool"));
+  BOOST_CHECK_EQUAL(current["accounted_bytes"].asUInt64(), 50);
+  stats.Unregister("TestCache");
+}
+
+BOOST_AUTO_TEST_CASE(test_resident_size) {
+  INIT_STDOUT_LOGGER();
+
+#if defined(__linux__)
+  BOOST_CHECK_GT(MemoryStats::GetResidentSizeInBytes(), 0);
+#endif
+  const Json::Value current = MemoryStats::GetInstance().GetStats()["current"];
+  BOOST_CHECK(current["resident_bytes"].isUInt64());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
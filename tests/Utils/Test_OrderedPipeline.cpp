@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <vector>
+
+#include "libUtils/Logger.h"
+#include "libUtils/OrderedPipeline.h"
+
+#define BOOST_TEST_MODULE orderedpipeline
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(orderedpipeline)
+
+BOOST_AUTO_TEST_CASE(test_apply_in_order) {
+  INIT_STDOUT_LOGGER();
+
+  for (const unsigned int numThreads : {0, 1, 4}) {
+    vector<size_t> appliedItems;
+    size_t applied = 0;
+    BOOST_CHECK(RunOrderedPipeline<size_t>(
+        "Test", 1000, numThreads, 8,
+        [](size_t i, size_t& item) {
+          item = i * i;
+          return true;
+        },
+        [&appliedItems](size_t i, size_t& item) {
+          BOOST_CHECK_EQUAL(item, i * i);
+          appliedItems.emplace_back(i);
+          return true;
+        },
+        applied));
+    BOOST_CHECK_EQUAL(applied, 1000);
+    BOOST_REQUIRE_EQUAL(appliedItems.size(), 1000);
+    for (size_t i = 0; i < appliedItems.size(); i++) {
+      BOOST_CHECK_EQUAL(appliedItems.at(i), i);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_stop) {
+  INIT_STDOUT_LOGGER();
+
+  for (const unsigned int numThreads : {0, 4}) {
+    // apply stops the pipeline without a failure
+    size_t applied = 0;
+    BOOST_CHECK(RunOrderedPipeline<size_t>(
+        "Test", 100, numThreads, 8,
+        [](size_t i, size_t& item) {
+          item = i;
+          return true;
+        },
+        [](size_t, size_t& item) { return item != 42; }, applied));
+    BOOST_CHECK_EQUAL(applied, 42);
+
+    // A failed produce fails the pipeline, but not the items before it
+    atomic<size_t> produced{0};
+    BOOST_CHECK(!RunOrderedPipeline<size_t>(
+        "Test", 100, numThreads, 8,
+        [&produced](size_t i, size_t&) {
+          produced++;
+          return i != 10;
+        },
+        [](size_t, size_t&) { return true; }, applied));
+    BOOST_CHECK_EQUAL(applied, 10);
+    // No more than the window is loaded past the failure
+    BOOST_CHECK_LE(produced, 10 + 1 + 8);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "libUtils/Logger.h"
+#include "libUtils/Profiler.h"
+
+#define BOOST_TEST_MODULE profiler
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(profiler)
+
+BOOST_AUTO_TEST_CASE(test_cpu_window) {
+  INIT_STDOUT_LOGGER();
+
+  Profiler& profiler = Profiler::GetInstance();
+  const string path = profiler.Start(Profiler::CPU, 7, 60);
+  BOOST_REQUIRE(!path.empty());
+  BOOST_CHECK(path.find("cpu_profile_7_") != string::npos);
+  BOOST_CHECK(profiler.IsRunning(Profiler::CPU));
+
+  // Only one window of a kind at a time
+  BOOST_CHECK(profiler.Start(Profiler::CPU, 7, 60).empty());
+
+  // Busy for long enough to be sampled
+  volatile uint64_t sum = 0;
+  const auto end = chrono::steady_clock::now() + chrono::milliseconds(500);
+  while (chrono::steady_clock::now() < end) {
+    for (unsigned int i = 0; i < 1000; i++) {
+      sum = sum + i;
+    }
+  }
+
+  BOOST_CHECK_EQUAL(profiler.Stop(Profiler::CPU), path);
+  BOOST_CHECK(!profiler.IsRunning(Profiler::CPU));
+  BOOST_CHECK(profiler.Stop(Profiler::CPU).empty());
+
+  // Each line is a folded stack and its count
+  ifstream in(path);
+  string line;
+  BOOST_REQUIRE(getline(in, line));
+  BOOST_CHECK(line.rfind(' ') != string::npos);
+  remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_heap_window_ends_on_its_own) {
+  INIT_STDOUT_LOGGER();
+
+  Profiler& profiler = Profiler::GetInstance();
+  const string path = profiler.Start(Profiler::HEAP, 8, 1);
+  BOOST_REQUIRE(!path.empty());
+
+  const auto end = chrono::steady_clock::now() + chrono::seconds(5);
+  while (profiler.IsRunning(Profiler::HEAP) &&
+         chrono::steady_clock::now() < end) {
+    this_thread::sleep_for(chrono::milliseconds(50));
+  }
+
+  BOOST_CHECK(!profiler.IsRunning(Profiler::HEAP));
+  const string startPath = path.substr(0, path.rfind('.')) + "_start.xml";
+  BOOST_CHECK(ifstream(path).good());
+  BOOST_CHECK(ifstream(startPath).good());
+  remove(path.c_str());
+  remove(startPath.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_kind_names) {
+  Profiler::Kind kind;
+  BOOST_CHECK(Profiler::GetKind("cpu", kind) && kind == Profiler::CPU);
+  BOOST_CHECK(Profiler::GetKind("heap", kind) && kind == Profiler::HEAP);
+  BOOST_CHECK(!Profiler::GetKind("disk", kind));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
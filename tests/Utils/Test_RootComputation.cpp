@@ -20,6 +20,7 @@
 #include "libData/AccountData/Transaction.h"
 #include "libUtils/RootComputation.h"
 
+#include <chrono>
 #include <cstdint>
 #include <vector>
 
@@ -79,4 +80,41 @@ BOOST_AUTO_TEST_CASE(compareAllThreeVersions) {
   BOOST_CHECK_EQUAL(hashRoot1, hashRoot3);
 }
 
+BOOST_AUTO_TEST_CASE(benchmarkHashVector) {
+  INIT_STDOUT_LOGGER();
+
+  std::vector<TxnHash> hashes(100000);
+  for (unsigned int i = 0; i < hashes.size(); i++) {
+    hashes[i] = TxnHash(i * 2654435761u);
+  }
+
+  // As the ids were hashed before, a copy for each one
+  auto start = std::chrono::steady_clock::now();
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  for (const auto& hash : hashes) {
+    sha2.Update(hash.asBytes());
+  }
+  const TxnHash expected{sha2.Finalize()};
+  const auto copyTime = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  const TxnHash root = ComputeRoot(hashes);
+  const auto rootTime = std::chrono::steady_clock::now() - start;
+
+  BOOST_CHECK_EQUAL(root, expected);
+  LOG_GENERAL(
+      INFO,
+      hashes.size() << " hashes: "
+                    << std::chrono::duration_cast<std::chrono::microseconds>(
+                           copyTime)
+                           .count()
+                    << " us with copies, "
+                    << std::chrono::duration_cast<std::chrono::microseconds>(
+                           rootTime)
+                           .count()
+                    << " us with ComputeRoot");
+
+  BOOST_CHECK_EQUAL(ComputeRoot(std::vector<TxnHash>()), TxnHash());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
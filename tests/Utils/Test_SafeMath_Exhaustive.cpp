@@ -75,6 +75,40 @@ void test_function_exhaustive(
   }
 }
 
+// All pairs of the 128-bit values next to each power of two, checked
+// against the exact result in 256 bits
+template <class Operator>
+void test_uint128_boundaries(
+    const function<bool(const uint128_t&, const uint128_t&, uint128_t&)>
+        safemath_operator,
+    const Operator& exact_operator, const OperatorType op) {
+  vector<uint128_t> values{0, numeric_limits<uint128_t>::max()};
+  for (unsigned int i = 0; i < 128; i++) {
+    const uint128_t power = uint128_t(1) << i;
+    values.emplace_back(power - 1);
+    values.emplace_back(power);
+    values.emplace_back(power + 1);
+  }
+
+  const uint256_t maxValue = numeric_limits<uint128_t>::max();
+  for (const auto& i : values) {
+    for (const auto& j : values) {
+      if (op == OperatorType::DIV && j == 0) {
+        continue;
+      }
+      const uint256_t exact = exact_operator(uint256_t(i), uint256_t(j));
+      uint128_t res = 7;
+      const bool success = safemath_operator(i, j, res);
+      BOOST_CHECK_MESSAGE(success == (exact <= maxValue),
+                          "SafeMath wrong status for " << i << " " << j);
+      if (success) {
+        BOOST_CHECK_MESSAGE(res == exact,
+                            "SafeMath wrong " << res << " " << exact);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE(safemath_exhaustive)
 
 BOOST_AUTO_TEST_CASE(test_uint8_addition) {
@@ -140,4 +174,28 @@ BOOST_AUTO_TEST_CASE(test_int8_pow) {
       OperatorType::EXP);
 }
 
+BOOST_AUTO_TEST_CASE(test_uint128_boundaries_native) {
+  INIT_STDOUT_LOGGER();
+  test_uint128_boundaries(SafeMath<uint128_t>::add, plus<uint256_t>(),
+                          OperatorType::OTHER);
+  test_uint128_boundaries(
+      SafeMath<uint128_t>::mul, multiplies<uint256_t>(), OperatorType::OTHER);
+  test_uint128_boundaries(SafeMath<uint128_t>::div, divides<uint256_t>(),
+                          OperatorType::DIV);
+
+  // Subtraction fails below zero, where the 256-bit result wraps
+  test_uint128_boundaries(
+      SafeMath<uint128_t>::sub,
+      [](const uint256_t& a, const uint256_t& b) {
+        return a >= b ? a - b : numeric_limits<uint256_t>::max();
+      },
+      OperatorType::OTHER);
+
+  // An overflowing add leaves the wrapped sum, as the generic code does
+  uint128_t res;
+  BOOST_CHECK(!SafeMath<uint128_t>::add(numeric_limits<uint128_t>::max(), 2,
+                                        res));
+  BOOST_CHECK_EQUAL(res, 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
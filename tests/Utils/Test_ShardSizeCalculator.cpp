@@ -138,4 +138,42 @@ BOOST_AUTO_TEST_CASE(test_shard_count_generation) {
   ShardCountTestMain(600, 100, 0, 490, 1810);
 }
 
+BOOST_AUTO_TEST_CASE(test_balanced_shard_count_generation) {
+  INIT_STDOUT_LOGGER();
+
+  const uint32_t shardSize = 600, toleranceLo = 100, toleranceHi = 50;
+  const uint32_t lo = shardSize - toleranceLo, hi = shardSize + toleranceHi;
+
+  vector<uint32_t> shardCounts;
+  ShardSizeCalculator::GenerateBalancedShardCounts(
+      shardSize, toleranceLo, toleranceHi, lo - 1, shardCounts);
+  BOOST_CHECK(shardCounts.empty());
+
+  // Between one and two full shards, the nodes past one full shard are left
+  ShardSizeCalculator::GenerateBalancedShardCounts(
+      shardSize, toleranceLo, toleranceHi, 2 * lo - 1, shardCounts);
+  BOOST_CHECK(shardCounts == vector<uint32_t>{hi});
+
+  for (uint32_t numNodes = lo; numNodes <= 100000; numNodes += 997) {
+    ShardSizeCalculator::GenerateBalancedShardCounts(
+        shardSize, toleranceLo, toleranceHi, numNodes, shardCounts);
+    BOOST_REQUIRE(!shardCounts.empty());
+
+    uint32_t totalSharded = 0;
+    for (const auto& shard : shardCounts) {
+      BOOST_CHECK(shard >= lo && shard <= hi);
+      BOOST_CHECK(shardCounts.front() - shard <= 1);
+      totalSharded += shard;
+    }
+    BOOST_CHECK(totalSharded <= numNodes);
+
+    // No fewer shards could take as many nodes
+    BOOST_CHECK((shardCounts.size() - 1) * hi < totalSharded);
+    if (totalSharded < numNodes) {
+      BOOST_CHECK(shardCounts.size() * hi == totalSharded);
+      BOOST_CHECK((shardCounts.size() + 1) * lo > numNodes);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
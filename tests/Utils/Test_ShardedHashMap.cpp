@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <thread>
+
+#include "libUtils/Logger.h"
+#include "libUtils/ShardedHashMap.h"
+
+#define BOOST_TEST_MODULE shardedhashmap
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(shardedhashmap)
+
+BOOST_AUTO_TEST_CASE(test_batch_insert_and_erase) {
+  INIT_STDOUT_LOGGER();
+
+  ShardedHashMap<unsigned int, unsigned int> map(8);
+  BOOST_CHECK(map.Empty());
+
+  vector<pair<unsigned int, unsigned int>> entries;
+  for (unsigned int i = 0; i < 1000; i++) {
+    entries.emplace_back(i, i * 2);
+  }
+  map.InsertBatch(entries);
+  BOOST_CHECK_EQUAL(map.Size(), 1000);
+
+  // Existing entries are kept
+  BOOST_CHECK(!map.Insert(10, 0));
+  unsigned int value = 0;
+  BOOST_CHECK(map.Find(10, value));
+  BOOST_CHECK_EQUAL(value, 20);
+
+  vector<unsigned int> keys;
+  for (unsigned int i = 0; i < 1000; i += 2) {
+    keys.emplace_back(i);
+  }
+  keys.emplace_back(5000);
+  BOOST_CHECK_EQUAL(map.EraseBatch(keys), 500);
+  BOOST_CHECK_EQUAL(map.Size(), 500);
+  BOOST_CHECK(!map.Find(10, value));
+  BOOST_CHECK(map.Find(11, value));
+
+  const auto snapshot = map.Snapshot();
+  BOOST_CHECK_EQUAL(snapshot.size(), 500);
+  BOOST_CHECK_EQUAL(snapshot.at(11), 22);
+
+  map.Clear();
+  BOOST_CHECK(map.Empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_readers) {
+  INIT_STDOUT_LOGGER();
+
+  ShardedHashMap<unsigned int, unsigned int> map;
+  const unsigned int numEntries = 10000;
+
+  thread writer([&map, numEntries]() {
+    for (unsigned int start = 0; start < numEntries; start += 100) {
+      vector<pair<unsigned int, unsigned int>> batch;
+      for (unsigned int i = start; i < start + 100; i++) {
+        batch.emplace_back(i, i + 1);
+      }
+      map.InsertBatch(batch);
+    }
+  });
+
+  vector<thread> readers;
+  for (unsigned int r = 0; r < 4; r++) {
+    readers.emplace_back([&map, numEntries]() {
+      for (unsigned int i = 0; i < numEntries; i++) {
+        unsigned int value = 0;
+        if (map.Find(i, value)) {
+          BOOST_CHECK_EQUAL(value, i + 1);
+        }
+      }
+    });
+  }
+
+  writer.join();
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  BOOST_CHECK_EQUAL(map.Size(), numEntries);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
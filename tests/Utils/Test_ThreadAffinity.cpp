@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "libUtils/Logger.h"
+#include "libUtils/ThreadAffinity.h"
+
+#define BOOST_TEST_MODULE threadaffinity
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(threadaffinity)
+
+BOOST_AUTO_TEST_CASE(test_parse_cores) {
+  INIT_STDOUT_LOGGER();
+
+  vector<unsigned int> cores;
+  BOOST_CHECK(ThreadAffinity::ParseCores("3", cores));
+  BOOST_CHECK((cores == vector<unsigned int>{3}));
+
+  // Sorted and without the cores listed twice
+  BOOST_CHECK(ThreadAffinity::ParseCores("8,0-3,2", cores));
+  BOOST_CHECK((cores == vector<unsigned int>{0, 1, 2, 3, 8}));
+
+  for (const auto& spec :
+       {"", ",", "1,", "a", "3-1", "1-", "-1", "1-2-3", "numa", "numax"}) {
+    BOOST_CHECK_MESSAGE(!ThreadAffinity::ParseCores(spec, cores), spec);
+    BOOST_CHECK(cores.empty());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_unlisted_group) {
+  INIT_STDOUT_LOGGER();
+
+  // A group that is not listed leaves the thread where it is
+  BOOST_CHECK(ThreadAffinity::GetCores("NoSuchGroup").empty());
+  BOOST_CHECK(ThreadAffinity::Apply("NoSuchGroup"));
+  BOOST_CHECK(ThreadAffinity::Apply("NoSuchGroup", 1));
+}
+
+BOOST_AUTO_TEST_CASE(test_pin_cores) {
+  INIT_STDOUT_LOGGER();
+
+  BOOST_CHECK(ThreadAffinity::PinCores({0}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "libUtils/Logger.h"
+#include "libUtils/ThreadPool.h"
+
+#define BOOST_TEST_MODULE threadpool
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(threadpool)
+
+BOOST_AUTO_TEST_CASE(test_run_all_jobs) {
+  INIT_STDOUT_LOGGER();
+
+  ThreadPool pool(4, "Test");
+  atomic<unsigned int> done{0};
+  for (unsigned int i = 0; i < 1000; i++) {
+    pool.AddJob([&done]() { done++; });
+  }
+  pool.WaitForJobsLeft(0);
+
+  BOOST_CHECK_EQUAL(done, 1000);
+  BOOST_CHECK_EQUAL(pool.GetQueueDepth(), 0);
+  const auto stats = pool.GetStats();
+  BOOST_CHECK_EQUAL(stats.m_jobsDone, 1000);
+  BOOST_CHECK_GE(stats.m_maxQueueDepth, 1);
+  BOOST_CHECK(stats.m_maxWait <= stats.m_totalWait);
+}
+
+BOOST_AUTO_TEST_CASE(test_steal_nested_jobs) {
+  INIT_STDOUT_LOGGER();
+
+  // The jobs are all added to the queue of the first thread, and the other
+  // threads take them from it
+  ThreadPool pool(4, "Test");
+  mutex mutexThreads;
+  set<thread::id> threads;
+  pool.AddJob([&]() {
+    for (unsigned int i = 0; i < 100; i++) {
+      pool.AddJob([&]() {
+        this_thread::sleep_for(chrono::milliseconds(1));
+        lock_guard<mutex> g(mutexThreads);
+        threads.insert(this_thread::get_id());
+      });
+    }
+  });
+  pool.WaitForJobsLeft(0);
+
+  BOOST_CHECK_EQUAL(pool.GetStats().m_jobsDone, 101);
+  BOOST_CHECK_GT(pool.GetStats().m_jobsStolen, 0);
+  BOOST_CHECK_GT(threads.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_high_priority_first) {
+  INIT_STDOUT_LOGGER();
+
+  ThreadPool pool(1, "Test");
+  mutex mutexBlocked;
+  condition_variable cvBlocked;
+  bool blocked = true;
+  pool.AddJob([&]() {
+    unique_lock<mutex> lock(mutexBlocked);
+    cvBlocked.wait(lock, [&]() { return !blocked; });
+  });
+
+  // Queued while the only thread is busy
+  vector<unsigned int> order;
+  for (unsigned int i = 0; i < 3; i++) {
+    pool.AddJob([&order, i]() { order.push_back(i); });
+  }
+  pool.AddJob([&order]() { order.push_back(10); },
+              ThreadPool::Priority::HIGH);
+  {
+    lock_guard<mutex> g(mutexBlocked);
+    blocked = false;
+  }
+  cvBlocked.notify_all();
+  pool.WaitForJobsLeft(0);
+
+  BOOST_CHECK((order == vector<unsigned int>{10, 0, 1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(test_wait_for_jobs_left) {
+  INIT_STDOUT_LOGGER();
+
+  ThreadPool pool(2, "Test");
+  mutex mutexBlocked;
+  condition_variable cvBlocked;
+  unsigned int released = 0;
+  for (unsigned int i = 0; i < 4; i++) {
+    pool.AddJob([&]() {
+      unique_lock<mutex> lock(mutexBlocked);
+      cvBlocked.wait(lock, [&]() { return released > 0; });
+      released--;
+    });
+  }
+
+  // Each released job wakes the waiter once the count is low enough
+  {
+    lock_guard<mutex> g(mutexBlocked);
+    released = 2;
+  }
+  cvBlocked.notify_all();
+  pool.WaitForJobsLeft(2);
+  BOOST_CHECK_LE(pool.GetJobsLeft(), 2);
+
+  {
+    lock_guard<mutex> g(mutexBlocked);
+    released += 2;
+  }
+  cvBlocked.notify_all();
+  pool.WaitForJobsLeft(0);
+  BOOST_CHECK_EQUAL(pool.GetJobsLeft(), 0);
+  BOOST_CHECK_EQUAL(pool.GetStats().m_jobsDone, 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "libUtils/Logger.h"
+#include "libUtils/Scheduler.h"
+#include "libUtils/TimerWheel.h"
+
+#define BOOST_TEST_MODULE timerwheel
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+template <class Predicate>
+bool WaitFor(Predicate predicate) {
+  for (unsigned int i = 0; i < 5000 && !predicate(); i++) {
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  return predicate();
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(timerwheel)
+
+BOOST_AUTO_TEST_CASE(test_fire_in_order) {
+  INIT_STDOUT_LOGGER();
+
+  // 8 slots of 5 ms, so that the longest delays take several turns
+  TimerWheel wheel(chrono::milliseconds(5), 8);
+  mutex mutexFired;
+  vector<unsigned int> fired;
+  atomic<bool> early{false};
+  const auto start = TimerWheel::Clock::now();
+  for (const unsigned int delay : {120, 10, 60, 0, 30}) {
+    wheel.ScheduleAfter(
+        [&, delay]() {
+          if (TimerWheel::Clock::now() - start <
+              chrono::milliseconds(delay)) {
+            early = true;
+          }
+          lock_guard<mutex> g(mutexFired);
+          fired.push_back(delay);
+        },
+        chrono::milliseconds(delay));
+  }
+
+  BOOST_REQUIRE(WaitFor([&]() {
+    lock_guard<mutex> g(mutexFired);
+    return fired.size() == 5;
+  }));
+  BOOST_CHECK((fired == vector<unsigned int>{0, 10, 30, 60, 120}));
+  BOOST_CHECK(!early);
+  BOOST_CHECK_EQUAL(wheel.GetPendingCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_cancel) {
+  INIT_STDOUT_LOGGER();
+
+  TimerWheel wheel(chrono::milliseconds(5), 8);
+  atomic<unsigned int> fired{0};
+  const auto handle = wheel.ScheduleAfter([&fired]() { fired++; },
+                                          chrono::milliseconds(20));
+  wheel.ScheduleAfter([&fired]() { fired += 10; }, chrono::milliseconds(30));
+  BOOST_CHECK_EQUAL(wheel.GetPendingCount(), 2);
+
+  BOOST_CHECK(wheel.Cancel(handle));
+  BOOST_CHECK(!wheel.Cancel(handle));
+  BOOST_CHECK(!wheel.Cancel(TimerWheel::INVALID_HANDLE));
+
+  BOOST_REQUIRE(WaitFor([&fired]() { return fired > 0; }));
+  this_thread::sleep_for(chrono::milliseconds(50));
+  BOOST_CHECK_EQUAL(fired, 10);
+}
+
+BOOST_AUTO_TEST_CASE(test_scheduler) {
+  INIT_STDOUT_LOGGER();
+
+  Scheduler scheduler;
+  atomic<unsigned int> fired{0};
+  scheduler.ScheduleAfter([&fired]() { fired++; }, 10);
+  const auto handle = scheduler.ScheduleAt(
+      [&fired]() { fired += 10; },
+      chrono::system_clock::now() + chrono::seconds(10));
+
+  BOOST_CHECK(WaitFor([&fired]() { return fired == 1; }));
+  BOOST_CHECK(scheduler.Cancel(handle));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
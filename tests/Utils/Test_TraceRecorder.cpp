@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "libUtils/Logger.h"
+#include "libUtils/TraceRecorder.h"
+
+#define BOOST_TEST_MODULE tracerecorder
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(tracerecorder)
+
+BOOST_AUTO_TEST_CASE(test_events) {
+  INIT_STDOUT_LOGGER();
+
+  TraceRecorder& tracer = TraceRecorder::GetInstance();
+  tracer.Clear();
+
+  tracer.SetProcessName(7, "Consensus 7 (block 1)");
+  tracer.SetThreadName(7, 0, "state");
+  tracer.Complete("ANNOUNCE_DONE", "state", 7, 0, 1000, 250);
+  Json::Value args;
+  args["state"] = "COLLECTIVESIG_DONE";
+  tracer.Instant("SUBSET_ENDED", "subset", 7, 2, 1300, args);
+
+  const Json::Value trace = tracer.GetTrace();
+  const Json::Value& events = trace["traceEvents"];
+  BOOST_REQUIRE_EQUAL(events.size(), 4);
+
+  BOOST_CHECK_EQUAL(events[0]["ph"].asString(), "M");
+  BOOST_CHECK_EQUAL(events[0]["name"].asString(), "process_name");
+  BOOST_CHECK_EQUAL(events[0]["args"]["name"].asString(),
+                    "Consensus 7 (block 1)");
+  BOOST_CHECK_EQUAL(events[1]["name"].asString(), "thread_name");
+
+  BOOST_CHECK_EQUAL(events[2]["ph"].asString(), "X");
+  BOOST_CHECK_EQUAL(events[2]["pid"].asUInt(), 7);
+  BOOST_CHECK_EQUAL(events[2]["ts"].asUInt64(), 1000);
+  BOOST_CHECK_EQUAL(events[2]["dur"].asUInt64(), 250);
+
+  BOOST_CHECK_EQUAL(events[3]["ph"].asString(), "i");
+  BOOST_CHECK_EQUAL(events[3]["tid"].asUInt(), 2);
+  BOOST_CHECK_EQUAL(events[3]["args"]["state"].asString(),
+                    "COLLECTIVESIG_DONE");
+
+  tracer.Clear();
+  BOOST_CHECK_EQUAL(tracer.GetTrace()["traceEvents"].size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_now) {
+  INIT_STDOUT_LOGGER();
+
+  const uint64_t first = TraceRecorder::NowInMicro();
+  const uint64_t second = TraceRecorder::NowInMicro();
+  BOOST_CHECK(first > 0);
+  BOOST_CHECK(second >= first);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -17,6 +17,8 @@
 
 #include <arpa/inet.h>
 #include <array>
+#include <map>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
@@ -666,6 +668,189 @@ void perfTestTrie(char const* _name) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(trieInsertBatch) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  using AddressTrie = SpecificTrieDB<GenericTrieDB<MemoryDB>, h160>;
+
+  MemoryDB serialDB;
+  MemoryDB batchDB;
+  EnforceRefs serialRefs(serialDB, true);
+  EnforceRefs batchRefs(batchDB, true);
+  AddressTrie serial(&serialDB);
+  AddressTrie batch(&batchDB);
+  serial.init();
+  batch.init();
+
+  // Second round updates half of the first round's keys and adds new ones
+  for (unsigned int round = 0; round < 2; round++) {
+    vector<pair<h160, bytes>> entries;
+    for (unsigned int i = round * 1000; i < round * 1000 + 2000; i++) {
+      h160 key;
+      h256 digest = sha3(to_string(i));
+      memcpy(key.data(), digest.data(), h160::size);
+      bytes value = asBytes(to_string(i * (round + 1)));
+      entries.emplace_back(key, value);
+      serial.insert(key, value);
+    }
+    batch.insertBatch(entries, 4);
+
+    BOOST_CHECK_EQUAL(serial.root(), batch.root());
+    for (const auto& entry : entries) {
+      BOOST_CHECK_EQUAL(batch.at(entry.first), asString(entry.second));
+    }
+    // Same live nodes as inserting one by one
+    BOOST_CHECK(serialDB.get() == batchDB.get());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(trieBuildSorted) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  using AddressTrie = SpecificTrieDB<GenericTrieDB<MemoryDB>, h160>;
+
+  for (unsigned int count : {1, 2, 17, 2000}) {
+    MemoryDB serialDB;
+    MemoryDB sortedDB;
+    EnforceRefs serialRefs(serialDB, true);
+    EnforceRefs sortedRefs(sortedDB, true);
+    AddressTrie serial(&serialDB);
+    AddressTrie sorted(&sortedDB);
+    serial.init();
+    sorted.init();
+
+    map<h160, bytes> accounts;
+    for (unsigned int i = 0; i < count; i++) {
+      h160 key;
+      h256 digest = sha3(to_string(i));
+      memcpy(key.data(), digest.data(), h160::size);
+      accounts[key] = asBytes(to_string(i));
+      serial.insert(key, accounts[key]);
+    }
+    const vector<pair<h160, bytes>> entries(accounts.begin(), accounts.end());
+    BOOST_REQUIRE(sorted.buildSorted(entries));
+
+    BOOST_CHECK_EQUAL(serial.root(), sorted.root());
+    BOOST_CHECK(serialDB.get() == sortedDB.get());
+    for (const auto& entry : entries) {
+      BOOST_CHECK_EQUAL(sorted.at(entry.first), asString(entry.second));
+    }
+
+    // Only an empty trie is built
+    BOOST_CHECK(!sorted.buildSorted(entries));
+  }
+
+  // Keys that are prefixes of others end up as branch values
+  MemoryDB serialDB;
+  MemoryDB sortedDB;
+  GenericTrieDB<MemoryDB> serial(&serialDB);
+  GenericTrieDB<MemoryDB> sorted(&sortedDB);
+  serial.init();
+  sorted.init();
+  const vector<bytes> keys = {asBytes("a"), asBytes("ab"), asBytes("abc"),
+                              asBytes("b"), asBytes("ba")};
+  vector<pair<bytesConstRef, bytesConstRef>> entries;
+  for (const auto& key : keys) {
+    serial.insert(key, key);
+    entries.emplace_back(&key, &key);
+  }
+  BOOST_REQUIRE(sorted.buildSorted(entries));
+  BOOST_CHECK_EQUAL(serial.root(), sorted.root());
+
+  // Unsorted entries are refused
+  MemoryDB unsortedDB;
+  GenericTrieDB<MemoryDB> unsorted(&unsortedDB);
+  unsorted.init();
+  swap(entries[0], entries[1]);
+  BOOST_CHECK(!unsorted.buildSorted(entries));
+  BOOST_CHECK(unsorted.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(trieChunkedIteration) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  using AddressTrie = SpecificTrieDB<GenericTrieDB<MemoryDB>, h160>;
+
+  MemoryDB db;
+  AddressTrie trie(&db);
+  trie.init();
+
+  set<h160> keys;
+  for (unsigned int i = 0; i < 1000; i++) {
+    h160 key;
+    h256 digest = sha3(to_string(i));
+    memcpy(key.data(), digest.data(), h160::size);
+    keys.insert(key);
+    trie.insert(key, asBytes(to_string(i)));
+  }
+
+  // Resuming from the first key not taken visits every key once, in order
+  vector<h160> visited;
+  h160 cursor;
+  for (bool more = true; more;) {
+    auto it = trie.lower_bound(cursor);
+    for (unsigned int i = 0; i < 64 && it != trie.end(); i++, ++it) {
+      visited.push_back((*it).first);
+    }
+    more = it != trie.end();
+    if (more) {
+      cursor = (*it).first;
+    }
+  }
+  BOOST_CHECK(visited == vector<h160>(keys.begin(), keys.end()));
+}
+
+BOOST_AUTO_TEST_CASE(trieProof) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  using AddressTrie = SpecificTrieDB<GenericTrieDB<MemoryDB>, h160>;
+
+  MemoryDB db;
+  AddressTrie trie(&db);
+  trie.init();
+
+  vector<h160> keys;
+  for (unsigned int i = 0; i < 500; i++) {
+    h160 key;
+    h256 digest = sha3(to_string(i));
+    memcpy(key.data(), digest.data(), h160::size);
+    keys.push_back(key);
+    // Short values keep some of the leaves inlined in their parents
+    trie.insert(key, asBytes(string(i % 2 ? 40 : 1, 'a' + i % 26)));
+  }
+
+  // A trie over just the nodes of a proof gives the same value
+  auto verify = [&trie](const h160& key, const vector<bytes>& proof) {
+    MemoryDB proofDB;
+    for (const auto& node : proof) {
+      proofDB.insert(sha3(node), &node);
+    }
+    AddressTrie proofTrie(&proofDB, trie.root(), Verification::Skip);
+    return proofTrie.at(key);
+  };
+
+  for (unsigned int i = 0; i < keys.size(); i += 7) {
+    const auto proof = trie.getProof(keys[i]);
+    BOOST_CHECK(!proof.empty());
+    BOOST_CHECK_EQUAL(sha3(proof.front()), trie.root());
+    BOOST_CHECK_EQUAL(verify(keys[i], proof), trie.at(keys[i]));
+  }
+
+  // Proof of absence
+  h160 missing;
+  missing[0] = 0xff;
+  BOOST_CHECK(trie.at(missing).empty());
+  BOOST_CHECK(verify(missing, trie.getProof(missing)).empty());
+}
+
 BOOST_AUTO_TEST_CASE(triePerf) {
   //    if (test::Options::get().all)
   //    {
@@ -23,7 +23,7 @@
 
 #define BOOST_TEST_MODULE trietest
 #define BOOST_TEST_DYN_LINK
-#include <boost/filesystem/path.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include "depends/common/CommonIO.h"
@@ -61,4 +61,55 @@ BOOST_AUTO_TEST_CASE(fat_trie) {
   LOG_GENERAL(INFO, m_testDB.Lookup((uint256_t)3));
 }
 
+BOOST_AUTO_TEST_CASE(decode_keys) {
+  INIT_STDOUT_LOGGER();
+
+  const h256 hash(
+      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+  h256 decodedHash;
+  BOOST_CHECK(LevelDB::DecodeKey(hash.hex(), decodedHash));
+  BOOST_CHECK_EQUAL(decodedHash, hash);
+  decodedHash = h256();
+  BOOST_CHECK(LevelDB::DecodeKey(
+      leveldb::Slice(reinterpret_cast<const char*>(hash.data()), hash.size),
+      decodedHash));
+  BOOST_CHECK_EQUAL(decodedHash, hash);
+  BOOST_CHECK(!LevelDB::DecodeKey(string("1234"), decodedHash));
+
+  uint64_t blockNum = 0;
+  BOOST_CHECK(LevelDB::DecodeKey(string("12345678"), blockNum));
+  BOOST_CHECK_EQUAL(blockNum, 12345678);
+  const string binaryKey = {0, 0, 0, 1, 0, 0, 0, 2};
+  BOOST_CHECK(LevelDB::DecodeKey(binaryKey, blockNum));
+  BOOST_CHECK_EQUAL(blockNum, 0x100000002);
+  BOOST_CHECK(!LevelDB::DecodeKey(hash.hex(), blockNum));
+}
+
+BOOST_AUTO_TEST_CASE(checkpoint) {
+  INIT_STDOUT_LOGGER();
+
+  LevelDB testDB("checkpointTest");
+  testDB.Insert((uint256_t)1, "before");
+
+  const string checkpointPath =
+      (boost::filesystem::temp_directory_path() / "Test_LevelDB_checkpoint")
+          .string();
+  boost::filesystem::remove_all(checkpointPath);
+  BOOST_REQUIRE(testDB.Checkpoint(checkpointPath));
+
+  // The checkpoint opens while the database stays open, and misses the
+  // writes made after it
+  testDB.Insert((uint256_t)2, "after");
+  {
+    LevelDB checkpointDB("checkpointTest", checkpointPath, string());
+    BOOST_REQUIRE(checkpointDB.GetDB());
+    BOOST_CHECK_EQUAL(checkpointDB.Lookup((uint256_t)1), "before");
+    BOOST_CHECK(!checkpointDB.Exists((uint256_t)2));
+  }
+  BOOST_CHECK_EQUAL(testDB.Lookup((uint256_t)2), "after");
+
+  boost::filesystem::remove_all(checkpointPath);
+  testDB.ResetDB();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
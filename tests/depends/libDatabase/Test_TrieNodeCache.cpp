@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+
+#define BOOST_TEST_MODULE trienodecache
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "depends/common/FixedHash.h"
+#include "depends/libDatabase/TrieNodeCache.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+using namespace dev;
+
+namespace {
+h256 MakeHash(unsigned int seed) {
+  h256 h;
+  h[0] = seed & 0xFF;
+  h[1] = (seed >> 8) & 0xFF;
+  return h;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(trienodecache)
+
+BOOST_AUTO_TEST_CASE(test_lookup_and_counters) {
+  INIT_STDOUT_LOGGER();
+
+  TrieNodeCache cache(1024 * 1024);
+  string node;
+
+  BOOST_CHECK(!cache.Lookup(MakeHash(1), node));
+  cache.Insert(MakeHash(1), "node1");
+  BOOST_CHECK(cache.Lookup(MakeHash(1), node));
+  BOOST_CHECK_EQUAL(node, "node1");
+
+  // Empty results from the database are not cached
+  cache.Insert(MakeHash(2), "");
+  BOOST_CHECK(!cache.Lookup(MakeHash(2), node));
+
+  BOOST_CHECK_EQUAL(cache.GetHits(), 1);
+  BOOST_CHECK_EQUAL(cache.GetMisses(), 2);
+
+  cache.Clear();
+  BOOST_CHECK(!cache.Lookup(MakeHash(1), node));
+  BOOST_CHECK_EQUAL(cache.GetSizeInBytes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_eviction) {
+  INIT_STDOUT_LOGGER();
+
+  const string value(1000, 'x');
+  TrieNodeCache cache(10 * 1024);
+
+  for (unsigned int i = 0; i < 100; i++) {
+    cache.Insert(MakeHash(i), value);
+    // Keep the first node in use so it is never the oldest
+    string node;
+    BOOST_CHECK(cache.Lookup(MakeHash(0), node));
+  }
+
+  BOOST_CHECK(cache.GetSizeInBytes() <= 10 * 1024);
+
+  string node;
+  BOOST_CHECK(cache.Lookup(MakeHash(0), node));
+  BOOST_CHECK(cache.Lookup(MakeHash(99), node));
+  BOOST_CHECK(!cache.Lookup(MakeHash(1), node));
+
+  // Nodes larger than the whole cache are ignored
+  cache.Insert(MakeHash(200), string(20 * 1024, 'y'));
+  BOOST_CHECK(!cache.Lookup(MakeHash(200), node));
+  BOOST_CHECK(cache.Lookup(MakeHash(99), node));
+}
+
+BOOST_AUTO_TEST_SUITE_END()